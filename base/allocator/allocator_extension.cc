@@ -4,7 +4,13 @@
 
 #include "base/allocator/allocator_extension.h"
 
+#include <string.h>
+
+#include <string>
+
 #include "base/logging.h"
+#include "base/memory/slab_allocator.h"
+#include "base/strings/string_util.h"
 
 namespace base {
 namespace allocator {
@@ -12,8 +18,13 @@ namespace allocator {
 bool GetAllocatorWasteSize(size_t* size) {
   thunks::GetAllocatorWasteSizeFunction get_allocator_waste_size_function =
       thunks::GetGetAllocatorWasteSizeFunction();
-  return get_allocator_waste_size_function != NULL &&
-         get_allocator_waste_size_function(size);
+  if (get_allocator_waste_size_function == NULL ||
+      !get_allocator_waste_size_function(size)) {
+    return false;
+  }
+  // Free slab blocks are allocated memory as far as the allocator knows.
+  *size += SlabAllocator::GetWasteSize();
+  return true;
 }
 
 void GetStats(char* buffer, int buffer_length) {
@@ -23,6 +34,14 @@ void GetStats(char* buffer, int buffer_length) {
     get_stats_function(buffer, buffer_length);
   else
     buffer[0] = '\0';
+
+  // The slab allocator statistics follow those of the allocator, so that the
+  // allocation rates of the objects it serves can be compared with the
+  // allocator's own.
+  std::string slab_stats;
+  SlabAllocator::AppendStats(&slab_stats);
+  size_t length = strlen(buffer);
+  base::strlcpy(buffer + length, slab_stats.c_str(), buffer_length - length);
 }
 
 void ReleaseFreeMemory() {
@@ -472,6 +472,7 @@
         'debug/leak_tracker_unittest.cc',
         'debug/proc_maps_linux_unittest.cc',
         'debug/stack_trace_unittest.cc',
+        'debug/trace_event_binary_unittest.cc',
         'debug/trace_event_memory_unittest.cc',
         'debug/trace_event_synthetic_delay_unittest.cc',
         'debug/trace_event_system_stats_monitor_unittest.cc',
@@ -532,6 +533,7 @@
         'memory/scoped_vector_unittest.cc',
         'memory/shared_memory_unittest.cc',
         'memory/singleton_unittest.cc',
+        'memory/slab_allocator_unittest.cc',
         'memory/weak_ptr_unittest.cc',
         'memory/weak_ptr_unittest.nc',
         'message_loop/message_loop_proxy_impl_unittest.cc',
@@ -540,11 +542,13 @@
         'message_loop/message_pump_glib_unittest.cc',
         'message_loop/message_pump_io_ios_unittest.cc',
         'message_loop/message_pump_libevent_unittest.cc',
+        'message_loop/mpsc_task_queue_unittest.cc',
         'metrics/sample_map_unittest.cc',
         'metrics/sample_vector_unittest.cc',
         'metrics/bucket_ranges_unittest.cc',
         'metrics/field_trial_unittest.cc',
         'metrics/histogram_base_unittest.cc',
+        'metrics/histogram_batch_unittest.cc',
         'metrics/histogram_delta_serialization_unittest.cc',
         'metrics/histogram_snapshot_manager_unittest.cc',
         'metrics/histogram_unittest.cc',
@@ -583,6 +587,7 @@
         'scoped_native_library_unittest.cc',
         'scoped_observer.h',
         'security_unittest.cc',
+        'segmented_pickle_unittest.cc',
         'sequence_checker_unittest.cc',
         'sha1_unittest.cc',
         'stl_util_unittest.cc',
@@ -819,6 +824,32 @@
         }],
       ],  # target_conditions
     },
+    {
+      'target_name': 'base_perftests',
+      'type': '<(gtest_target_type)',
+      'dependencies': [
+        'base',
+        'test_support_base',
+        'test_support_perf',
+        '../testing/gtest.gyp:gtest',
+        '../testing/perf/perf_test.gyp:perf_test',
+      ],
+      'sources': [
+        'files/file_path_watcher_perftest.cc',
+        'json/json_perftest.cc',
+        'strings/utf_string_conversions_perftest.cc',
+        'threading/sequenced_worker_pool_perftest.cc',
+        'values_perftest.cc',
+      ],
+      'conditions': [
+        ['OS == "mac" or OS == "ios"', {
+          'sources!': [
+            # Recursive watches are not supported there.
+            'files/file_path_watcher_perftest.cc',
+          ],
+        }],
+      ],
+    },
     {
       'target_name': 'base_i18n_perftests',
       'type': '<(gtest_target_type)',
@@ -13,6 +13,7 @@
 #include "base/base_export.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/slab_allocator.h"
 
 template <typename T>
 class ScopedVector;
@@ -26,7 +27,7 @@ namespace internal {
 // DoInvoke function to perform the function execution.  This allows
 // us to shield the Callback class from the types of the bound argument via
 // "type erasure."
-class BindStateBase : public RefCountedThreadSafe<BindStateBase> {
+class BindStateBase : public SlabAllocatedRefCountedThreadSafe<BindStateBase> {
  protected:
   friend class RefCountedThreadSafe<BindStateBase>;
   virtual ~BindStateBase() {}
@@ -36,6 +36,8 @@ CPU::CPU()
     has_sse41_(false),
     has_sse42_(false),
     has_avx_(false),
+    has_avx2_(false),
+    has_fma3_(false),
     has_avx_hardware_(false),
     has_aesni_(false),
     has_non_stop_time_stamp_counter_(false),
@@ -56,7 +58,7 @@ void __cpuid(int cpu_info[4], int info_type) {
     "cpuid\n"
     "xchg %%edi, %%ebx\n"
     : "=a"(cpu_info[0]), "=D"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
-    : "a"(info_type)
+    : "a"(info_type), "c"(0)
   );
 }
 
@@ -66,7 +68,7 @@ void __cpuid(int cpu_info[4], int info_type) {
   __asm__ volatile (
     "cpuid \n\t"
     : "=a"(cpu_info[0]), "=b"(cpu_info[1]), "=c"(cpu_info[2]), "=d"(cpu_info[3])
-    : "a"(info_type)
+    : "a"(info_type), "c"(0)
   );
 }
 
@@ -89,6 +91,7 @@ uint64 _xgetbv(uint32 xcr) {
 void CPU::Initialize() {
 #if defined(ARCH_CPU_X86_FAMILY)
   int cpu_info[4] = {-1};
+  int cpu_info7[4] = {0};
   char cpu_string[48];
 
   // __cpuid with an InfoType argument of 0 returns the number of
@@ -104,6 +107,10 @@ void CPU::Initialize() {
   memcpy(cpu_string, &cpu_info[1], 3 * sizeof(cpu_info[1]));
   cpu_vendor_.assign(cpu_string, 3 * sizeof(cpu_info[1]));
 
+  // Leaf 7 (subleaf 0, as __cpuid clears ECX) has the extended features.
+  if (num_ids >= 7)
+    __cpuid(cpu_info7, 7);
+
   // Interpret CPU feature information.
   if (num_ids > 0) {
     __cpuid(cpu_info, 1);
@@ -132,6 +139,10 @@ void CPU::Initialize() {
         has_avx_hardware_ &&
         (cpu_info[2] & 0x08000000) != 0 /* OSXSAVE */ &&
         (_xgetbv(0) & 6) == 6 /* XSAVE enabled by kernel */;
+    // AVX2 needs the same operating system support as AVX.
+    has_avx2_ = has_avx_ && (cpu_info7[1] & 0x00000020) != 0;
+    // As do the FMA3 instructions, which use the AVX registers.
+    has_fma3_ = has_avx_ && (cpu_info[2] & 0x00001000) != 0;
     has_aesni_ = (cpu_info[2] & 0x02000000) != 0;
   }
 
@@ -0,0 +1,656 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/debug/trace_event_binary.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/containers/hash_tables.h"
+#include "base/debug/trace_event.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/format_macros.h"
+#include "base/json/string_escape.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/stringprintf.h"
+#include "base/third_party/dynamic_annotations/dynamic_annotations.h"
+#include "base/threading/thread_local_storage.h"
+
+namespace base {
+namespace debug {
+
+namespace {
+
+const uint32 kTraceBinaryMagic = 0x42525443;  // "CTRB"
+const uint32 kTraceBinaryVersion = 1;
+
+// String ids with a fixed meaning. Strings that no longer fit in the string
+// table are recorded as kDroppedStringId.
+const uint32 kNullStringId = 0;
+const uint32 kDroppedStringId = 1;
+const char kDroppedString[] = "(dropped)";
+
+// Bounds the memory used by strings that are copied into events, such as
+// TRACE_EVENT_COPY_XXX names and convertable arguments.
+const size_t kMaxStringTableSize = 4 * 1024 * 1024;
+
+const char kMetadataCategory[] = "__metadata";
+
+COMPILE_ASSERT(sizeof(TraceBinaryRecord) == 72, trace_binary_record_size);
+COMPILE_ASSERT(sizeof(TraceBinaryFileHeader) % 8 == 0,
+               trace_binary_header_keeps_records_aligned);
+
+subtle::Atomic32 g_next_buffer_id = 0;
+
+}  // namespace
+
+namespace internal {
+
+// Holds each thread's ring. The slot is shared by all TraceBinaryBuffers; a
+// ring knows which buffer it belongs to.
+class TraceBinaryThreadSlot {
+ public:
+  TraceBinaryThreadSlot() : slot_(&TraceBinaryBuffer::OnThreadExit) {}
+
+  ThreadLocalStorage::Slot& slot() { return slot_; }
+
+ private:
+  ThreadLocalStorage::Slot slot_;
+
+  DISALLOW_COPY_AND_ASSIGN(TraceBinaryThreadSlot);
+};
+
+}  // namespace internal
+
+namespace {
+
+LazyInstance<internal::TraceBinaryThreadSlot>::Leaky g_thread_slot =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// TraceBinaryBuffer::StringTable
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Assigns consecutive ids to distinct strings. Thread safe.
+class TraceBinaryBuffer::StringTable {
+ public:
+  StringTable() : num_strings_(0) {
+    // kNullStringId. It isn't looked up, so it can't collide with "".
+    data_.push_back('\0');
+    ++num_strings_;
+    Intern(kDroppedString);
+  }
+
+  uint32 Intern(const char* str) {
+    if (!str)
+      return kNullStringId;
+    AutoLock lock(lock_);
+    hash_map<std::string, uint32>::const_iterator it = ids_.find(str);
+    if (it != ids_.end())
+      return it->second;
+    size_t length = strlen(str) + 1;
+    if (data_.size() + length > kMaxStringTableSize)
+      return kDroppedStringId;
+    uint32 id = num_strings_++;
+    data_.append(str, length);
+    ids_[str] = id;
+    return id;
+  }
+
+  // Appends all strings to |out|, NUL-terminated, and returns how many there
+  // are.
+  uint32 AppendTo(std::string* out) const {
+    AutoLock lock(lock_);
+    out->append(data_);
+    return num_strings_;
+  }
+
+ private:
+  mutable Lock lock_;
+  std::string data_;
+  uint32 num_strings_;
+  hash_map<std::string, uint32> ids_;
+
+  DISALLOW_COPY_AND_ASSIGN(StringTable);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// TraceBinaryBuffer::ThreadBuffer
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// A ring of records written by one thread and read by Snapshot() on any
+// thread. The writer publishes each record by incrementing |write_count_|;
+// a reader copies the published records without stopping the writer, then
+// drops those the writer may have overwritten in the meantime.
+//
+// Referenced by its TraceBinaryBuffer and by the thread writing to it, so
+// that a thread can drop the ring of a buffer that has been destroyed.
+class TraceBinaryBuffer::ThreadBuffer
+    : public RefCountedThreadSafe<ThreadBuffer> {
+ public:
+  ThreadBuffer(int owner_id, size_t capacity)
+      : owner_id_(owner_id),
+        capacity_(capacity),
+        records_(new TraceBinaryRecord[capacity]),
+        write_count_(0),
+        start_count_(0),
+        epoch_(0) {
+    ANNOTATE_BENIGN_RACE_SIZED(records_.get(),
+                               capacity * sizeof(TraceBinaryRecord),
+                               "trace binary records are copied while written");
+  }
+
+  int owner_id() const { return owner_id_; }
+
+  // Returns the slot to write the next record to. Records written before the
+  // last TraceBinaryBuffer::Clear(), whose epoch is |epoch|, are dropped.
+  TraceBinaryRecord* NextRecord(subtle::Atomic32 epoch) {
+    if (subtle::NoBarrier_Load(&epoch_) != epoch) {
+      subtle::NoBarrier_Store(&write_count_, 0);
+      subtle::NoBarrier_Store(&start_count_, 0);
+      subtle::Release_Store(&epoch_, epoch);
+    }
+    subtle::AtomicWord count = subtle::NoBarrier_Load(&write_count_);
+    // Announce the write before the slot is touched, so that a concurrent
+    // AppendRecords() knows which record it may have torn.
+    subtle::NoBarrier_Store(&start_count_, count + 1);
+    subtle::MemoryBarrier();
+    return &records_[static_cast<size_t>(count) % capacity_];
+  }
+
+  // Publishes the record returned by NextRecord().
+  void Commit() {
+    subtle::Release_Store(&write_count_,
+                          subtle::NoBarrier_Load(&write_count_) + 1);
+  }
+
+  // Drops all records, before the ring is given to another thread.
+  void Reset() {
+    subtle::NoBarrier_Store(&start_count_, 0);
+    subtle::Release_Store(&write_count_, 0);
+  }
+
+  // Returns the id of |str|, a string that lives as long as the process, such
+  // as a category group or an event name. Ids are cached by address, so only
+  // the first lookup of each string takes the string table's lock. Only
+  // called by the thread writing to this ring.
+  uint32 InternStatic(const char* str, StringTable* strings) {
+    if (!str)
+      return kNullStringId;
+    uintptr_t key = reinterpret_cast<uintptr_t>(str);
+    hash_map<uintptr_t, uint32>::const_iterator it = static_ids_.find(key);
+    if (it != static_ids_.end())
+      return it->second;
+    uint32 id = strings->Intern(str);
+    if (id != kDroppedStringId)
+      static_ids_[key] = id;
+    return id;
+  }
+
+  // Appends the records written since the last Clear() with epoch |epoch| to
+  // |out|, oldest first.
+  void AppendRecords(subtle::Atomic32 epoch, std::string* out) const {
+    if (subtle::Acquire_Load(&epoch_) != epoch)
+      return;
+    size_t end = static_cast<size_t>(subtle::Acquire_Load(&write_count_));
+    size_t begin = end > capacity_ ? end - capacity_ : 0;
+    size_t offset = out->size();
+    for (size_t i = begin; i < end; ++i) {
+      out->append(reinterpret_cast<const char*>(&records_[i % capacity_]),
+                  sizeof(TraceBinaryRecord));
+    }
+
+    // Every write started by the time the copy finished, up to record
+    // |started - 1|, may have overwritten the slot of the record |capacity_|
+    // before it, so those records may be torn.
+    subtle::MemoryBarrier();
+    size_t started = static_cast<size_t>(subtle::NoBarrier_Load(&start_count_));
+    if (started < end || subtle::NoBarrier_Load(&epoch_) != epoch) {
+      // The ring was reset or cleared while it was copied.
+      out->resize(offset);
+      return;
+    }
+    size_t first_intact = started > capacity_ ? started - capacity_ : 0;
+    if (first_intact > begin) {
+      size_t torn = std::min(first_intact, end) - begin;
+      out->erase(offset, torn * sizeof(TraceBinaryRecord));
+    }
+  }
+
+ private:
+  friend class RefCountedThreadSafe<ThreadBuffer>;
+
+  ~ThreadBuffer() {}
+
+  const int owner_id_;
+  const size_t capacity_;
+  scoped_ptr<TraceBinaryRecord[]> records_;
+  // The number of records published; the next one goes into slot
+  // |write_count_ % capacity_|.
+  subtle::AtomicWord write_count_;
+  // The number of records whose writing has started; one more than
+  // |write_count_| while a record is being written.
+  subtle::AtomicWord start_count_;
+  subtle::Atomic32 epoch_;
+
+  hash_map<uintptr_t, uint32> static_ids_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThreadBuffer);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// TraceBinaryBuffer
+//
+////////////////////////////////////////////////////////////////////////////////
+
+TraceBinaryBuffer::TraceBinaryBuffer(size_t records_per_thread,
+                                     size_t max_threads)
+    : id_(subtle::NoBarrier_AtomicIncrement(&g_next_buffer_id, 1)),
+      records_per_thread_(records_per_thread),
+      max_threads_(max_threads),
+      epoch_(0),
+      strings_(new StringTable),
+      shared_buffer_(new ThreadBuffer(id_, records_per_thread)) {
+  DCHECK_GT(records_per_thread, 0u);
+  buffers_.reserve(max_threads);
+}
+
+TraceBinaryBuffer::~TraceBinaryBuffer() {
+}
+
+void TraceBinaryBuffer::AddEvent(
+    int thread_id,
+    TimeTicks timestamp,
+    TimeTicks thread_timestamp,
+    char phase,
+    const char* category_group,
+    const char* name,
+    unsigned long long id,
+    int num_args,
+    const char** arg_names,
+    const unsigned char* arg_types,
+    const unsigned long long* arg_values,
+    const scoped_refptr<ConvertableToTraceFormat>* convertable_values,
+    unsigned char flags) {
+  DCHECK(phase != TRACE_EVENT_PHASE_COMPLETE);
+  ThreadBuffer* buffer = GetBufferForCurrentThread();
+  if (buffer == shared_buffer_.get()) {
+    AutoLock lock(shared_lock_);
+    WriteRecord(buffer, thread_id, timestamp, thread_timestamp, phase,
+                category_group, name, id, num_args, arg_names, arg_types,
+                arg_values, convertable_values, flags);
+    return;
+  }
+  WriteRecord(buffer, thread_id, timestamp, thread_timestamp, phase,
+              category_group, name, id, num_args, arg_names, arg_types,
+              arg_values, convertable_values, flags);
+}
+
+void TraceBinaryBuffer::SetMetadataEvent(int thread_id,
+                                         const char* name,
+                                         const char* arg_name,
+                                         const std::string& value) {
+  TraceBinaryRecord record;
+  memset(&record, 0, sizeof(record));
+  record.thread_id = thread_id;
+  record.phase = TRACE_EVENT_PHASE_METADATA;
+  record.category_id = strings_->Intern(kMetadataCategory);
+  record.name_id = strings_->Intern(name);
+  record.num_args = 1;
+  record.arg_name_ids[0] = strings_->Intern(arg_name);
+  record.arg_types[0] = TRACE_VALUE_TYPE_COPY_STRING;
+  record.arg_values[0] = strings_->Intern(value.c_str());
+
+  AutoLock lock(lock_);
+  for (size_t i = 0; i < metadata_.size(); ++i) {
+    if (metadata_[i].thread_id == thread_id &&
+        metadata_[i].name_id == record.name_id) {
+      metadata_[i] = record;
+      return;
+    }
+  }
+  metadata_.push_back(record);
+}
+
+void TraceBinaryBuffer::Clear() {
+  subtle::NoBarrier_AtomicIncrement(&epoch_, 1);
+  AutoLock lock(lock_);
+  metadata_.clear();
+}
+
+void TraceBinaryBuffer::Snapshot(int process_id, std::string* image) const {
+  image->assign(sizeof(TraceBinaryFileHeader), '\0');
+  subtle::Atomic32 epoch = subtle::NoBarrier_Load(&epoch_);
+  {
+    AutoLock lock(lock_);
+    if (!metadata_.empty()) {
+      image->append(reinterpret_cast<const char*>(&metadata_[0]),
+                    metadata_.size() * sizeof(TraceBinaryRecord));
+    }
+    for (size_t i = 0; i < buffers_.size(); ++i)
+      buffers_[i]->AppendRecords(epoch, image);
+  }
+  shared_buffer_->AppendRecords(epoch, image);
+  size_t records_size = image->size() - sizeof(TraceBinaryFileHeader);
+
+  // The strings go last, so that they include every string the records
+  // refer to.
+  uint32 num_strings = strings_->AppendTo(image);
+
+  TraceBinaryFileHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = kTraceBinaryMagic;
+  header.version = kTraceBinaryVersion;
+  header.process_id = process_id;
+  header.record_size = sizeof(TraceBinaryRecord);
+  header.num_records = records_size / sizeof(TraceBinaryRecord);
+  header.num_strings = num_strings;
+  header.string_data_size = static_cast<uint32>(
+      image->size() - sizeof(header) - records_size);
+  memcpy(&(*image)[0], &header, sizeof(header));
+}
+
+bool TraceBinaryBuffer::ExportToFile(int process_id,
+                                     const FilePath& path) const {
+  std::string image;
+  Snapshot(process_id, &image);
+  File file(path, File::FLAG_CREATE_ALWAYS | File::FLAG_WRITE);
+  if (!file.IsValid())
+    return false;
+  int size = static_cast<int>(image.size());
+  return file.Write(0, image.data(), size) == size;
+}
+
+// static
+void TraceBinaryBuffer::OnThreadExit(void* value) {
+  // The ring stays with its TraceBinaryBuffer, if that still exists, until
+  // another thread takes it over.
+  static_cast<ThreadBuffer*>(value)->Release();
+}
+
+TraceBinaryBuffer::ThreadBuffer*
+TraceBinaryBuffer::GetBufferForCurrentThread() {
+  ThreadLocalStorage::Slot& slot = g_thread_slot.Get().slot();
+  ThreadBuffer* buffer = static_cast<ThreadBuffer*>(slot.Get());
+  if (buffer && buffer->owner_id() == id_)
+    return buffer;
+
+  // |buffer| belonged to a TraceBinaryBuffer that has since been replaced.
+  if (buffer) {
+    slot.Set(NULL);
+    buffer->Release();
+  }
+  {
+    AutoLock lock(lock_);
+    buffer = AcquireBufferWhileLocked();
+    buffer->AddRef();
+  }
+  slot.Set(buffer);
+  return buffer;
+}
+
+TraceBinaryBuffer::ThreadBuffer*
+TraceBinaryBuffer::AcquireBufferWhileLocked() {
+  lock_.AssertAcquired();
+  if (buffers_.size() < max_threads_) {
+    buffers_.push_back(new ThreadBuffer(id_, records_per_thread_));
+    return buffers_.back().get();
+  }
+  // Take over the ring of a thread that has exited.
+  for (size_t i = 0; i < buffers_.size(); ++i) {
+    if (buffers_[i]->HasOneRef()) {
+      buffers_[i]->Reset();
+      return buffers_[i].get();
+    }
+  }
+  return shared_buffer_.get();
+}
+
+void TraceBinaryBuffer::WriteRecord(
+    ThreadBuffer* buffer,
+    int thread_id,
+    TimeTicks timestamp,
+    TimeTicks thread_timestamp,
+    char phase,
+    const char* category_group,
+    const char* name,
+    unsigned long long id,
+    int num_args,
+    const char** arg_names,
+    const unsigned char* arg_types,
+    const unsigned long long* arg_values,
+    const scoped_refptr<ConvertableToTraceFormat>* convertable_values,
+    unsigned char flags) {
+  StringTable* strings = strings_.get();
+  bool copy = !!(flags & TRACE_EVENT_FLAG_COPY);
+
+  TraceBinaryRecord* record =
+      buffer->NextRecord(subtle::NoBarrier_Load(&epoch_));
+  record->timestamp = timestamp.ToInternalValue();
+  record->thread_timestamp = thread_timestamp.ToInternalValue();
+  record->id = id;
+  record->category_id = buffer->InternStatic(category_group, strings);
+  record->name_id = copy ? strings->Intern(name) :
+                           buffer->InternStatic(name, strings);
+  record->thread_id = thread_id;
+  record->phase = phase;
+  record->flags = flags;
+
+  // Clamp num_args since it may have been set by a third_party library.
+  num_args = (num_args > kTraceMaxNumArgs) ? kTraceMaxNumArgs : num_args;
+  record->num_args = static_cast<uint8>(num_args);
+  int i = 0;
+  for (; i < num_args; ++i) {
+    record->arg_name_ids[i] = copy ? strings->Intern(arg_names[i]) :
+                                     buffer->InternStatic(arg_names[i],
+                                                          strings);
+    unsigned char type = arg_types[i];
+    if (type == TRACE_VALUE_TYPE_STRING && copy)
+      type = TRACE_VALUE_TYPE_COPY_STRING;
+    record->arg_types[i] = type;
+
+    // |arg_values| is not set for convertable arguments.
+    switch (type) {
+      case TRACE_VALUE_TYPE_STRING:
+        record->arg_values[i] = buffer->InternStatic(
+            reinterpret_cast<const char*>(arg_values[i]), strings);
+        break;
+      case TRACE_VALUE_TYPE_COPY_STRING:
+        record->arg_values[i] = strings->Intern(
+            reinterpret_cast<const char*>(arg_values[i]));
+        break;
+      case TRACE_VALUE_TYPE_CONVERTABLE: {
+        std::string json;
+        convertable_values[i]->AppendAsTraceFormat(&json);
+        record->arg_values[i] = strings->Intern(json.c_str());
+        break;
+      }
+      default:
+        record->arg_values[i] = arg_values[i];
+        break;
+    }
+  }
+  for (; i < kTraceMaxNumArgs; ++i) {
+    record->arg_name_ids[i] = kNullStringId;
+    record->arg_types[i] = TRACE_VALUE_TYPE_UINT;
+    record->arg_values[i] = 0;
+  }
+  memset(record->padding, 0, sizeof(record->padding));
+
+  buffer->Commit();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// TraceBinaryReader
+//
+////////////////////////////////////////////////////////////////////////////////
+
+TraceBinaryReader::TraceBinaryReader() : header_(NULL), records_(NULL) {
+}
+
+TraceBinaryReader::~TraceBinaryReader() {
+}
+
+bool TraceBinaryReader::InitializeFromFile(const FilePath& path) {
+  if (!file_.Initialize(path))
+    return false;
+  return Parse(file_.data(), file_.length());
+}
+
+bool TraceBinaryReader::InitializeFromString(std::string* image) {
+  image_.swap(*image);
+  return Parse(reinterpret_cast<const uint8*>(image_.data()), image_.size());
+}
+
+void TraceBinaryReader::AppendEventAsJSON(size_t index,
+                                          std::string* out) const {
+  DCHECK_LT(index, num_events());
+  const TraceBinaryRecord& record = records_[index];
+  const char* category = GetString(record.category_id);
+  const char* name = GetString(record.name_id);
+
+  // Names are escaped, unlike in TraceEvent::AppendAsJSON(), since a file may
+  // hold anything. Valid names come out the same.
+  *out += "{\"cat\":";
+  EscapeJSONString(category ? category : "", true, out);
+  StringAppendF(out, ",\"pid\":%i,\"tid\":%i,\"ts\":%" PRId64 ",\"ph\":",
+                process_id(), record.thread_id, record.timestamp);
+  EscapeJSONString(StringPiece(&record.phase, 1), true, out);
+  *out += ",\"name\":";
+  EscapeJSONString(name ? name : "", true, out);
+  *out += ",\"args\":{";
+
+  int num_args = record.num_args;
+  if (num_args > kTraceMaxNumArgs)
+    num_args = kTraceMaxNumArgs;
+  for (int i = 0; i < num_args; ++i) {
+    if (i > 0)
+      *out += ",";
+    const char* arg_name = GetString(record.arg_name_ids[i]);
+    EscapeJSONString(arg_name ? arg_name : "", true, out);
+    *out += ":";
+
+    TraceEvent::TraceValue value;
+    unsigned char type = record.arg_types[i];
+    switch (type) {
+      case TRACE_VALUE_TYPE_STRING:
+      case TRACE_VALUE_TYPE_COPY_STRING:
+        value.as_string =
+            GetString(static_cast<uint32>(record.arg_values[i]));
+        TraceEvent::AppendValueAsJSON(type, value, out);
+        break;
+      case TRACE_VALUE_TYPE_CONVERTABLE: {
+        const char* json =
+            GetString(static_cast<uint32>(record.arg_values[i]));
+        *out += json && *json ? json : "null";
+        break;
+      }
+      case TRACE_VALUE_TYPE_BOOL:
+        value.as_bool = !!record.arg_values[i];
+        TraceEvent::AppendValueAsJSON(type, value, out);
+        break;
+      case TRACE_VALUE_TYPE_UINT:
+      case TRACE_VALUE_TYPE_INT:
+      case TRACE_VALUE_TYPE_DOUBLE:
+      case TRACE_VALUE_TYPE_POINTER:
+        value.as_uint = record.arg_values[i];
+        TraceEvent::AppendValueAsJSON(type, value, out);
+        break;
+      default:
+        *out += "null";
+        break;
+    }
+  }
+  *out += "}";
+
+  if (record.thread_timestamp)
+    StringAppendF(out, ",\"tts\":%" PRId64, record.thread_timestamp);
+
+  if (record.flags & TRACE_EVENT_FLAG_HAS_ID)
+    StringAppendF(out, ",\"id\":\"0x%" PRIx64 "\"", record.id);
+
+  if (record.phase == TRACE_EVENT_PHASE_INSTANT) {
+    char scope = '?';
+    switch (record.flags & TRACE_EVENT_FLAG_SCOPE_MASK) {
+      case TRACE_EVENT_SCOPE_GLOBAL:
+        scope = TRACE_EVENT_SCOPE_NAME_GLOBAL;
+        break;
+
+      case TRACE_EVENT_SCOPE_PROCESS:
+        scope = TRACE_EVENT_SCOPE_NAME_PROCESS;
+        break;
+
+      case TRACE_EVENT_SCOPE_THREAD:
+        scope = TRACE_EVENT_SCOPE_NAME_THREAD;
+        break;
+    }
+    StringAppendF(out, ",\"s\":\"%c\"", scope);
+  }
+
+  *out += "}";
+}
+
+bool TraceBinaryReader::Parse(const uint8* data, size_t length) {
+  header_ = NULL;
+  records_ = NULL;
+  strings_.clear();
+
+  if (length < sizeof(TraceBinaryFileHeader))
+    return false;
+  const TraceBinaryFileHeader* header =
+      reinterpret_cast<const TraceBinaryFileHeader*>(data);
+  if (header->magic != kTraceBinaryMagic ||
+      header->version != kTraceBinaryVersion ||
+      header->record_size != sizeof(TraceBinaryRecord)) {
+    return false;
+  }
+  size_t available = length - sizeof(TraceBinaryFileHeader);
+  if (header->num_records > available / sizeof(TraceBinaryRecord))
+    return false;
+  size_t records_size =
+      static_cast<size_t>(header->num_records) * sizeof(TraceBinaryRecord);
+  if (header->string_data_size != available - records_size)
+    return false;
+
+  const char* string_data = reinterpret_cast<const char*>(
+      data + sizeof(TraceBinaryFileHeader) + records_size);
+  const char* string_end = string_data + header->string_data_size;
+  if (header->num_strings > header->string_data_size)
+    return false;
+  strings_.reserve(header->num_strings);
+  for (const char* str = string_data; strings_.size() < header->num_strings;) {
+    const char* nul = static_cast<const char*>(
+        memchr(str, '\0', string_end - str));
+    if (!nul)
+      return false;
+    strings_.push_back(str);
+    str = nul + 1;
+  }
+  if (!strings_.empty())
+    strings_[kNullStringId] = NULL;
+
+  header_ = header;
+  records_ = reinterpret_cast<const TraceBinaryRecord*>(
+      data + sizeof(TraceBinaryFileHeader));
+  return true;
+}
+
+const char* TraceBinaryReader::GetString(uint32 id) const {
+  return id < strings_.size() ? strings_[id] : NULL;
+}
+
+}  // namespace debug
+}  // namespace base
@@ -0,0 +1,221 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// TraceBinaryBuffer records trace events as fixed-size binary records in
+// per-thread ring buffers, for TraceLog's RECORD_AS_BINARY option. Category
+// groups, names, argument names and string arguments are interned into a
+// string table shared by all threads, so once an event's strings have been
+// seen recording it takes no lock and allocates nothing, and the memory used
+// is bounded by the size of the rings. Events are only converted to JSON when
+// they are read: by TraceLog::Flush(), or offline by TraceBinaryReader from a
+// file written by TraceBinaryBuffer::ExportToFile().
+//
+// The image written by Snapshot() and ExportToFile() is laid out as follows,
+// in host byte order:
+//
+//   TraceBinaryFileHeader
+//   |num_records| TraceBinaryRecords
+//   |num_strings| NUL-terminated strings, |string_data_size| bytes in all
+
+#ifndef BASE_DEBUG_TRACE_EVENT_BINARY_H_
+#define BASE_DEBUG_TRACE_EVENT_BINARY_H_
+
+#include <string>
+#include <vector>
+
+#include "base/atomicops.h"
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/debug/trace_event_impl.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace base {
+
+class FilePath;
+
+namespace debug {
+
+namespace internal {
+class TraceBinaryThreadSlot;
+}  // namespace internal
+
+// One trace event. Strings are stored as ids into the string table; string
+// and convertable arguments store their string's id in |arg_values|, the
+// latter holding the JSON the convertable produced when it was recorded.
+struct TraceBinaryRecord {
+  int64 timestamp;
+  int64 thread_timestamp;
+  uint64 id;
+  uint64 arg_values[kTraceMaxNumArgs];
+  uint32 category_id;
+  uint32 name_id;
+  uint32 arg_name_ids[kTraceMaxNumArgs];
+  int32 thread_id;
+  char phase;
+  uint8 flags;
+  uint8 num_args;
+  uint8 arg_types[kTraceMaxNumArgs];
+  uint8 padding[7];
+};
+
+struct TraceBinaryFileHeader {
+  uint32 magic;
+  uint32 version;
+  int32 process_id;
+  uint32 record_size;
+  uint64 num_records;
+  uint32 num_strings;
+  uint32 string_data_size;
+};
+
+class BASE_EXPORT TraceBinaryBuffer {
+ public:
+  // Each thread that records events gets its own ring of
+  // |records_per_thread| records, up to |max_threads| rings. The ring of a
+  // thread that has exited is kept, so that its events can still be read,
+  // until another thread needs it. Threads that find no ring share one,
+  // behind a lock.
+  TraceBinaryBuffer(size_t records_per_thread, size_t max_threads);
+  ~TraceBinaryBuffer();
+
+  // Records an event on the current thread's ring, overwriting the thread's
+  // oldest event once the ring is full. The arguments are the same as
+  // TraceEvent::Initialize()'s; TRACE_EVENT_PHASE_COMPLETE events should be
+  // recorded as a BEGIN and an END event, since records are never updated.
+  void AddEvent(
+      int thread_id,
+      TimeTicks timestamp,
+      TimeTicks thread_timestamp,
+      char phase,
+      const char* category_group,
+      const char* name,
+      unsigned long long id,
+      int num_args,
+      const char** arg_names,
+      const unsigned char* arg_types,
+      const unsigned long long* arg_values,
+      const scoped_refptr<ConvertableToTraceFormat>* convertable_values,
+      unsigned char flags);
+
+  // Records a metadata event, e.g. a thread name, with one string argument.
+  // Metadata events are kept outside the rings so they are never overwritten.
+  // An earlier event with the same |thread_id| and |name| is replaced.
+  void SetMetadataEvent(int thread_id,
+                        const char* name,
+                        const char* arg_name,
+                        const std::string& value);
+
+  // Discards all recorded events. Interned strings are kept.
+  void Clear();
+
+  // Writes the recorded events to |image|, in the layout described at the top
+  // of this file. Safe to call while other threads record events; an event
+  // being overwritten while it is copied is left out.
+  void Snapshot(int process_id, std::string* image) const;
+
+  // Writes Snapshot() to |path|. Returns false if the file couldn't be
+  // written.
+  bool ExportToFile(int process_id, const FilePath& path) const;
+
+ private:
+  class StringTable;
+  class ThreadBuffer;
+
+  friend class internal::TraceBinaryThreadSlot;
+
+  static void OnThreadExit(void* value);
+
+  // Returns the ring the current thread records to, which is
+  // |shared_buffer_| if there was no ring left for it.
+  ThreadBuffer* GetBufferForCurrentThread();
+  ThreadBuffer* AcquireBufferWhileLocked();
+
+  void WriteRecord(
+      ThreadBuffer* buffer,
+      int thread_id,
+      TimeTicks timestamp,
+      TimeTicks thread_timestamp,
+      char phase,
+      const char* category_group,
+      const char* name,
+      unsigned long long id,
+      int num_args,
+      const char** arg_names,
+      const unsigned char* arg_types,
+      const unsigned long long* arg_values,
+      const scoped_refptr<ConvertableToTraceFormat>* convertable_values,
+      unsigned char flags);
+
+  // Tells the rings of this buffer apart from those of an earlier one, which
+  // threads may still hold.
+  const int id_;
+  const size_t records_per_thread_;
+  const size_t max_threads_;
+
+  // Incremented by Clear(). A ring drops its events the next time it is
+  // written to with a new epoch, and is skipped by Snapshot() until then.
+  subtle::Atomic32 epoch_;
+
+  scoped_ptr<StringTable> strings_;
+
+  // Protects |buffers_| and |metadata_|.
+  mutable Lock lock_;
+  std::vector<scoped_refptr<ThreadBuffer> > buffers_;
+  std::vector<TraceBinaryRecord> metadata_;
+
+  // Protects writes to |shared_buffer_|.
+  mutable Lock shared_lock_;
+  scoped_refptr<ThreadBuffer> shared_buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(TraceBinaryBuffer);
+};
+
+// Reads the events of a TraceBinaryBuffer image and converts them to the JSON
+// format of TraceEvent::AppendAsJSON(). Events are converted one at a time,
+// so a large file can be converted in pieces.
+class BASE_EXPORT TraceBinaryReader {
+ public:
+  TraceBinaryReader();
+  ~TraceBinaryReader();
+
+  // Maps the file at |path|, written by TraceBinaryBuffer::ExportToFile().
+  // Returns false if it can't be read or isn't a valid image.
+  bool InitializeFromFile(const FilePath& path);
+
+  // Reads an image produced by TraceBinaryBuffer::Snapshot(), taking the
+  // contents of |image|. Returns false if it isn't a valid image.
+  bool InitializeFromString(std::string* image);
+
+  int process_id() const { return header_ ? header_->process_id : 0; }
+  size_t num_events() const {
+    return header_ ? static_cast<size_t>(header_->num_records) : 0;
+  }
+
+  // Appends event |index| to |out| as JSON.
+  void AppendEventAsJSON(size_t index, std::string* out) const;
+
+ private:
+  bool Parse(const uint8* data, size_t length);
+
+  // Returns string |id|, or NULL if |id| is the NULL string or out of range.
+  const char* GetString(uint32 id) const;
+
+  MemoryMappedFile file_;
+  std::string image_;
+
+  const TraceBinaryFileHeader* header_;
+  const TraceBinaryRecord* records_;
+  std::vector<const char*> strings_;
+
+  DISALLOW_COPY_AND_ASSIGN(TraceBinaryReader);
+};
+
+}  // namespace debug
+}  // namespace base
+
+#endif  // BASE_DEBUG_TRACE_EVENT_BINARY_H_
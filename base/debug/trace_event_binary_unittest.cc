@@ -0,0 +1,330 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/debug/trace_event_binary.h"
+
+#include <string>
+
+#include "base/debug/trace_event.h"
+#include "base/files/file_path.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_reader.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace debug {
+
+namespace {
+
+const char kCategory[] = "binary";
+const char kArgName[] = "value";
+
+// Records an instant event with one integer argument.
+void AddIntEvent(TraceBinaryBuffer* buffer, const char* name, int value) {
+  const char* arg_names[] = { kArgName };
+  unsigned char arg_types[] = { TRACE_VALUE_TYPE_INT };
+  unsigned long long arg_values[] = {
+    static_cast<unsigned long long>(value) };
+  buffer->AddEvent(42, TimeTicks::FromInternalValue(1000 + value),
+                   TimeTicks(), TRACE_EVENT_PHASE_INSTANT, kCategory, name,
+                   static_cast<unsigned long long>(value) * 2, 1, arg_names,
+                   arg_types, arg_values, NULL,
+                   TRACE_EVENT_FLAG_HAS_ID | TRACE_EVENT_SCOPE_THREAD);
+}
+
+// Returns the events recorded in |buffer|, parsed from their JSON.
+scoped_ptr<ListValue> ReadEvents(const TraceBinaryBuffer& buffer) {
+  std::string image;
+  buffer.Snapshot(7, &image);
+  TraceBinaryReader reader;
+  EXPECT_TRUE(reader.InitializeFromString(&image));
+  EXPECT_EQ(7, reader.process_id());
+
+  std::string json = "[";
+  for (size_t i = 0; i < reader.num_events(); ++i) {
+    if (i)
+      json += ",";
+    reader.AppendEventAsJSON(i, &json);
+  }
+  json += "]";
+  scoped_ptr<Value> root(JSONReader::Read(json));
+  if (!root || !root->IsType(Value::TYPE_LIST)) {
+    ADD_FAILURE() << json;
+    return scoped_ptr<ListValue>(new ListValue);
+  }
+  return scoped_ptr<ListValue>(static_cast<ListValue*>(root.release()));
+}
+
+int GetIntArg(const ListValue& events, size_t index) {
+  const DictionaryValue* event = NULL;
+  int value = -1;
+  EXPECT_TRUE(events.GetDictionary(index, &event));
+  EXPECT_TRUE(event && event->GetInteger("args.value", &value));
+  return value;
+}
+
+class JSONData : public ConvertableToTraceFormat {
+ public:
+  JSONData() {}
+
+  virtual void AppendAsTraceFormat(std::string* out) const OVERRIDE {
+    out->append("{\"x\":[1,2]}");
+  }
+
+ private:
+  virtual ~JSONData() {}
+  DISALLOW_COPY_AND_ASSIGN(JSONData);
+};
+
+// Records |count| events numbered from |first|.
+class RecordingDelegate : public DelegateSimpleThread::Delegate {
+ public:
+  RecordingDelegate(TraceBinaryBuffer* buffer, int first, int count)
+      : buffer_(buffer), first_(first), count_(count) {}
+
+  virtual void Run() OVERRIDE {
+    for (int i = first_; i < first_ + count_; ++i)
+      AddIntEvent(buffer_, "thread", i);
+  }
+
+ private:
+  TraceBinaryBuffer* buffer_;
+  const int first_;
+  const int count_;
+};
+
+}  // namespace
+
+TEST(TraceBinaryBufferTest, RecordAndRead) {
+  TraceBinaryBuffer buffer(16, 4);
+  AddIntEvent(&buffer, "int", 5);
+
+  const char* arg_names[] = { "static", "copy" };
+  unsigned char arg_types[] = {
+    TRACE_VALUE_TYPE_STRING, TRACE_VALUE_TYPE_COPY_STRING };
+  std::string copy("copied value");
+  unsigned long long arg_values[] = {
+    reinterpret_cast<unsigned long long>("static value"),
+    reinterpret_cast<unsigned long long>(copy.c_str()) };
+  buffer.AddEvent(43, TimeTicks::FromInternalValue(2000),
+                  TimeTicks::FromInternalValue(3000), TRACE_EVENT_PHASE_BEGIN,
+                  kCategory, "strings", 0, 2, arg_names, arg_types,
+                  arg_values, NULL, TRACE_EVENT_FLAG_NONE);
+  copy = "overwritten";
+
+  const char* convertable_names[] = { "data" };
+  unsigned char convertable_types[] = { TRACE_VALUE_TYPE_CONVERTABLE };
+  scoped_refptr<ConvertableToTraceFormat> convertables[] = {
+    new JSONData };
+  buffer.AddEvent(43, TimeTicks::FromInternalValue(4000), TimeTicks(),
+                  TRACE_EVENT_PHASE_END, kCategory, "strings", 0, 1,
+                  convertable_names, convertable_types, NULL, convertables,
+                  TRACE_EVENT_FLAG_NONE);
+
+  scoped_ptr<ListValue> events = ReadEvents(buffer);
+  ASSERT_EQ(3u, events->GetSize());
+
+  const DictionaryValue* event = NULL;
+  std::string str;
+  int integer = 0;
+  ASSERT_TRUE(events->GetDictionary(0, &event));
+  EXPECT_TRUE(event->GetString("cat", &str));
+  EXPECT_EQ(kCategory, str);
+  EXPECT_TRUE(event->GetString("name", &str));
+  EXPECT_EQ("int", str);
+  EXPECT_TRUE(event->GetString("ph", &str));
+  EXPECT_EQ("i", str);
+  EXPECT_TRUE(event->GetString("s", &str));
+  EXPECT_EQ("t", str);
+  EXPECT_TRUE(event->GetString("id", &str));
+  EXPECT_EQ("0xa", str);
+  EXPECT_TRUE(event->GetInteger("pid", &integer));
+  EXPECT_EQ(7, integer);
+  EXPECT_TRUE(event->GetInteger("tid", &integer));
+  EXPECT_EQ(42, integer);
+  EXPECT_TRUE(event->GetInteger("ts", &integer));
+  EXPECT_EQ(1005, integer);
+  EXPECT_EQ(5, GetIntArg(*events, 0));
+  EXPECT_FALSE(event->HasKey("tts"));
+
+  ASSERT_TRUE(events->GetDictionary(1, &event));
+  EXPECT_TRUE(event->GetString("args.static", &str));
+  EXPECT_EQ("static value", str);
+  EXPECT_TRUE(event->GetString("args.copy", &str));
+  EXPECT_EQ("copied value", str);
+  EXPECT_TRUE(event->GetInteger("tts", &integer));
+  EXPECT_EQ(3000, integer);
+  EXPECT_FALSE(event->HasKey("id"));
+
+  ASSERT_TRUE(events->GetDictionary(2, &event));
+  const ListValue* list = NULL;
+  EXPECT_TRUE(event->GetList("args.data.x", &list));
+  EXPECT_EQ(2u, list->GetSize());
+}
+
+TEST(TraceBinaryBufferTest, RingKeepsNewestEvents) {
+  TraceBinaryBuffer buffer(8, 4);
+  for (int i = 0; i < 20; ++i)
+    AddIntEvent(&buffer, "ring", i);
+
+  scoped_ptr<ListValue> events = ReadEvents(buffer);
+  ASSERT_EQ(8u, events->GetSize());
+  for (size_t i = 0; i < 8; ++i)
+    EXPECT_EQ(static_cast<int>(i) + 12, GetIntArg(*events, i));
+}
+
+TEST(TraceBinaryBufferTest, Clear) {
+  TraceBinaryBuffer buffer(8, 4);
+  AddIntEvent(&buffer, "before", 1);
+  buffer.SetMetadataEvent(1, "thread_name", "name", "old");
+  buffer.Clear();
+  EXPECT_EQ(0u, ReadEvents(buffer)->GetSize());
+
+  AddIntEvent(&buffer, "after", 2);
+  scoped_ptr<ListValue> events = ReadEvents(buffer);
+  ASSERT_EQ(1u, events->GetSize());
+  EXPECT_EQ(2, GetIntArg(*events, 0));
+}
+
+TEST(TraceBinaryBufferTest, MetadataEvents) {
+  TraceBinaryBuffer buffer(2, 4);
+  buffer.SetMetadataEvent(1, "thread_name", "name", "first");
+  buffer.SetMetadataEvent(2, "thread_name", "name", "second");
+  buffer.SetMetadataEvent(1, "thread_name", "name", "renamed");
+  // Metadata events are not overwritten by newer events.
+  for (int i = 0; i < 10; ++i)
+    AddIntEvent(&buffer, "event", i);
+
+  scoped_ptr<ListValue> events = ReadEvents(buffer);
+  ASSERT_EQ(4u, events->GetSize());
+  const DictionaryValue* event = NULL;
+  std::string str;
+  ASSERT_TRUE(events->GetDictionary(0, &event));
+  EXPECT_TRUE(event->GetString("ph", &str));
+  EXPECT_EQ("M", str);
+  EXPECT_TRUE(event->GetString("args.name", &str));
+  EXPECT_EQ("renamed", str);
+  ASSERT_TRUE(events->GetDictionary(1, &event));
+  EXPECT_TRUE(event->GetString("args.name", &str));
+  EXPECT_EQ("second", str);
+}
+
+TEST(TraceBinaryBufferTest, ThreadsShareRingWhenOutOfRings) {
+  // The main thread takes the only ring, so the other threads share one.
+  TraceBinaryBuffer buffer(64, 1);
+  AddIntEvent(&buffer, "main", 0);
+
+  DelegateSimpleThreadPool pool("binary", 2);
+  RecordingDelegate delegate(&buffer, 100, 10);
+  pool.AddWork(&delegate, 2);
+  pool.Start();
+  pool.JoinAll();
+
+  EXPECT_EQ(21u, ReadEvents(buffer)->GetSize());
+}
+
+TEST(TraceBinaryBufferTest, RingsOfExitedThreadsAreReused) {
+  TraceBinaryBuffer buffer(64, 1);
+
+  // The thread's ring outlives it.
+  RecordingDelegate first(&buffer, 0, 5);
+  DelegateSimpleThread first_thread(&first, "first");
+  first_thread.Start();
+  first_thread.Join();
+  EXPECT_EQ(5u, ReadEvents(buffer)->GetSize());
+
+  // Then it goes to the next thread that needs one.
+  RecordingDelegate second(&buffer, 10, 3);
+  DelegateSimpleThread second_thread(&second, "second");
+  second_thread.Start();
+  second_thread.Join();
+  scoped_ptr<ListValue> events = ReadEvents(buffer);
+  ASSERT_EQ(3u, events->GetSize());
+  EXPECT_EQ(10, GetIntArg(*events, 0));
+}
+
+TEST(TraceBinaryBufferTest, SnapshotWhileRecording) {
+  const int kNumEvents = 200000;
+  TraceBinaryBuffer buffer(256, 4);
+  RecordingDelegate delegate(&buffer, 0, kNumEvents);
+  DelegateSimpleThread thread(&delegate, "recording");
+  thread.Start();
+
+  // Every event that makes it into a snapshot is intact and in order.
+  for (int round = 0; round < 50; ++round) {
+    std::string image;
+    buffer.Snapshot(0, &image);
+    TraceBinaryReader reader;
+    ASSERT_TRUE(reader.InitializeFromString(&image));
+    ASSERT_LE(reader.num_events(), 256u);
+    int previous = -1;
+    for (size_t i = 0; i < reader.num_events(); ++i) {
+      std::string json;
+      reader.AppendEventAsJSON(i, &json);
+      scoped_ptr<Value> event(JSONReader::Read(json));
+      DictionaryValue* dictionary = NULL;
+      ASSERT_TRUE(event && event->GetAsDictionary(&dictionary));
+      int value = 0;
+      std::string id;
+      ASSERT_TRUE(dictionary->GetInteger("args.value", &value));
+      ASSERT_TRUE(dictionary->GetString("id", &id));
+      EXPECT_EQ(StringPrintf("0x%x", value * 2), id);
+      EXPECT_GT(value, previous);
+      previous = value;
+    }
+  }
+  thread.Join();
+}
+
+TEST(TraceBinaryBufferTest, ExportToFile) {
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  FilePath path = temp_dir.path().AppendASCII("trace.bin");
+
+  TraceBinaryBuffer buffer(16, 4);
+  AddIntEvent(&buffer, "exported", 3);
+  ASSERT_TRUE(buffer.ExportToFile(11, path));
+
+  TraceBinaryReader reader;
+  ASSERT_TRUE(reader.InitializeFromFile(path));
+  EXPECT_EQ(11, reader.process_id());
+  ASSERT_EQ(1u, reader.num_events());
+  std::string json;
+  reader.AppendEventAsJSON(0, &json);
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"exported\""));
+}
+
+TEST(TraceBinaryReaderTest, RejectsInvalidImages) {
+  TraceBinaryBuffer buffer(16, 4);
+  AddIntEvent(&buffer, "event", 1);
+  std::string image;
+  buffer.Snapshot(0, &image);
+
+  TraceBinaryReader reader;
+  std::string empty;
+  EXPECT_FALSE(reader.InitializeFromString(&empty));
+
+  std::string truncated = image.substr(0, image.size() - 1);
+  EXPECT_FALSE(reader.InitializeFromString(&truncated));
+
+  std::string bad_magic = image;
+  bad_magic[0] ^= 0xff;
+  EXPECT_FALSE(reader.InitializeFromString(&bad_magic));
+
+  // Strings that run past the end of the image.
+  std::string unterminated = image;
+  unterminated[unterminated.size() - 1] = 'x';
+  EXPECT_FALSE(reader.InitializeFromString(&unterminated));
+
+  EXPECT_TRUE(reader.InitializeFromString(&image));
+  EXPECT_EQ(1u, reader.num_events());
+}
+
+}  // namespace debug
+}  // namespace base
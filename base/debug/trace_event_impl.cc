@@ -11,6 +11,7 @@
 #include "base/command_line.h"
 #include "base/debug/leak_annotations.h"
 #include "base/debug/trace_event.h"
+#include "base/debug/trace_event_binary.h"
 #include "base/debug/trace_event_synthetic_delay.h"
 #include "base/float_util.h"
 #include "base/format_macros.h"
@@ -68,6 +69,10 @@ const size_t kTraceEventBatchChunks = 1000 / kTraceBufferChunkSize;
 const size_t kMonitorTraceEventBufferChunks = 30000 / kTraceBufferChunkSize;
 // ECHO_TO_CONSOLE needs a small buffer to hold the unfinished COMPLETE events.
 const size_t kEchoToConsoleTraceEventBufferChunks = 256;
+// RECORD_AS_BINARY keeps the last 8192 events of each thread, in 72 byte
+// records. Together with the string table this bounds recording to about 40MB.
+const size_t kTraceBinaryRecordsPerThread = 8192;
+const size_t kTraceBinaryMaxThreads = 64;
 
 const int kThreadFlushTimeoutMs = 3000;
 
@@ -1593,11 +1598,15 @@ void TraceLog::Flush(const TraceLog::OutputCallback& cb) {
 
 void TraceLog::ConvertTraceEventsToTraceFormat(
     scoped_ptr<TraceBuffer> logged_events,
+    scoped_ptr<TraceBinaryReader> binary_events,
     const TraceLog::OutputCallback& flush_output_callback) {
 
   if (flush_output_callback.is_null())
     return;
 
+  size_t num_binary_events = binary_events ? binary_events->num_events() : 0;
+  size_t binary_event_index = 0;
+
   // The callback need to be called at least once even if there is no events
   // to let the caller know the completion of flush.
   bool has_more_events = true;
@@ -1618,12 +1627,41 @@ void TraceLog::ConvertTraceEventsToTraceFormat(
       }
     }
 
+    // Binary events follow the TraceEvents, converted in batches of the same
+    // size as they are sent.
+    if (!has_more_events && binary_event_index < num_binary_events) {
+      size_t batch_end = std::min(
+          num_binary_events,
+          binary_event_index + kTraceEventBatchChunks * kTraceBufferChunkSize);
+      for (; binary_event_index < batch_end; ++binary_event_index) {
+        if (!json_events_str_ptr->data().empty())
+          json_events_str_ptr->data().append(",");
+        binary_events->AppendEventAsJSON(binary_event_index,
+                                         &(json_events_str_ptr->data()));
+      }
+      has_more_events = binary_event_index < num_binary_events;
+    }
+
     flush_output_callback.Run(json_events_str_ptr, has_more_events);
   } while (has_more_events);
 }
 
+scoped_ptr<TraceBinaryReader> TraceLog::SnapshotBinaryEventsWhileLocked() {
+  lock_.AssertAcquired();
+  if (!binary_events_ || !(trace_options() & RECORD_AS_BINARY))
+    return scoped_ptr<TraceBinaryReader>();
+
+  std::string image;
+  binary_events_->Snapshot(process_id_, &image);
+  scoped_ptr<TraceBinaryReader> reader(new TraceBinaryReader);
+  bool valid = reader->InitializeFromString(&image);
+  DCHECK(valid);
+  return reader.Pass();
+}
+
 void TraceLog::FinishFlush(int generation) {
   scoped_ptr<TraceBuffer> previous_logged_events;
+  scoped_ptr<TraceBinaryReader> previous_binary_events;
   OutputCallback flush_output_callback;
 
   if (!CheckGeneration(generation))
@@ -1633,6 +1671,7 @@ void TraceLog::FinishFlush(int generation) {
     AutoLock lock(lock_);
 
     previous_logged_events.swap(logged_events_);
+    previous_binary_events = SnapshotBinaryEventsWhileLocked();
     UseNextTraceBuffer();
     thread_message_loops_.clear();
 
@@ -1642,6 +1681,7 @@ void TraceLog::FinishFlush(int generation) {
   }
 
   ConvertTraceEventsToTraceFormat(previous_logged_events.Pass(),
+                                  previous_binary_events.Pass(),
                                   flush_output_callback);
 }
 
@@ -1693,6 +1733,7 @@ void TraceLog::OnFlushTimeout(int generation) {
 void TraceLog::FlushButLeaveBufferIntact(
     const TraceLog::OutputCallback& flush_output_callback) {
   scoped_ptr<TraceBuffer> previous_logged_events;
+  scoped_ptr<TraceBinaryReader> binary_events;
   {
     AutoLock lock(lock_);
     AddMetadataEventsWhileLocked();
@@ -1702,17 +1743,51 @@ void TraceLog::FlushButLeaveBufferIntact(
                                   thread_shared_chunk_.Pass());
     }
     previous_logged_events = logged_events_->CloneForIteration().Pass();
+    binary_events = SnapshotBinaryEventsWhileLocked();
   }  // release lock
 
   ConvertTraceEventsToTraceFormat(previous_logged_events.Pass(),
+                                  binary_events.Pass(),
                                   flush_output_callback);
 }
 
+bool TraceLog::ExportBinaryTrace(const FilePath& path) {
+  {
+    AutoLock lock(lock_);
+    if (!binary_events_)
+      return false;
+
+    if (process_name_.size()) {
+      binary_events_->SetMetadataEvent(
+          static_cast<int>(base::PlatformThread::CurrentId()),
+          "process_name", "name", process_name_);
+    }
+    AutoLock thread_info_lock(thread_info_lock_);
+    for (hash_map<int, std::string>::iterator it = thread_names_.begin();
+         it != thread_names_.end(); ++it) {
+      if (!it->second.empty()) {
+        binary_events_->SetMetadataEvent(it->first, "thread_name", "name",
+                                         it->second);
+      }
+    }
+  }
+  // |binary_events_| is never replaced once created, so the file can be
+  // written without holding |lock_|.
+  return binary_events_->ExportToFile(process_id_, path);
+}
+
 void TraceLog::UseNextTraceBuffer() {
   logged_events_.reset(CreateTraceBuffer());
   subtle::NoBarrier_AtomicIncrement(&generation_, 1);
   thread_shared_chunk_.reset();
   thread_shared_chunk_index_ = 0;
+
+  if (binary_events_) {
+    binary_events_->Clear();
+  } else if (trace_options() & RECORD_AS_BINARY) {
+    binary_events_.reset(new TraceBinaryBuffer(kTraceBinaryRecordsPerThread,
+                                               kTraceBinaryMaxThreads));
+  }
 }
 
 TraceEventHandle TraceLog::AddTraceEvent(
@@ -1768,13 +1843,19 @@ TraceEventHandle TraceLog::AddTraceEventWithThreadIdAndTimestamp(
   TimeTicks now = OffsetTimestamp(timestamp);
   TimeTicks thread_now = ThreadNow();
 
+  // Binary events go straight into the thread's own ring, which needs neither
+  // a message loop nor |lock_|.
+  TraceBinaryBuffer* binary_events =
+      (trace_options() & RECORD_AS_BINARY) ? binary_events_.get() : NULL;
+
   ThreadLocalEventBuffer* thread_local_event_buffer = NULL;
   // A ThreadLocalEventBuffer needs the message loop
   // - to know when the thread exits;
   // - to handle the final flush.
   // For a thread without a message loop or the message loop may be blocked, the
   // trace events will be added into the main buffer directly.
-  if (!thread_blocks_message_loop_.Get() && MessageLoop::current()) {
+  if (!binary_events && !thread_blocks_message_loop_.Get() &&
+      MessageLoop::current()) {
     thread_local_event_buffer = thread_local_event_buffer_.Get();
     if (thread_local_event_buffer &&
         !CheckGeneration(thread_local_event_buffer->generation())) {
@@ -1830,7 +1911,16 @@ TraceEventHandle TraceLog::AddTraceEventWithThreadIdAndTimestamp(
     OptionalAutoLock lock(lock_);
 
     TraceEvent* trace_event = NULL;
-    if (thread_local_event_buffer) {
+    if (binary_events) {
+      // Binary records are never updated, so a COMPLETE event is recorded as
+      // a BEGIN event, and UpdateTraceEventDuration() records the END event.
+      binary_events->AddEvent(
+          thread_id, now, thread_now,
+          phase == TRACE_EVENT_PHASE_COMPLETE ? TRACE_EVENT_PHASE_BEGIN : phase,
+          GetCategoryGroupName(category_group_enabled), name, id,
+          num_args, arg_names, arg_types, arg_values, convertable_values,
+          flags);
+    } else if (thread_local_event_buffer) {
       trace_event = thread_local_event_buffer->AddTraceEvent(&handle);
     } else {
       lock.EnsureAcquired();
@@ -1978,8 +2068,18 @@ void TraceLog::UpdateTraceEventDuration(
   TimeTicks thread_now = ThreadNow();
   TimeTicks now = OffsetNow();
 
+  TraceBinaryBuffer* binary_events =
+      (trace_options() & RECORD_AS_BINARY) ? binary_events_.get() : NULL;
+
   std::string console_message;
-  if (*category_group_enabled & ENABLED_FOR_RECORDING) {
+  if (binary_events && (*category_group_enabled &
+                        (ENABLED_FOR_RECORDING | ENABLED_FOR_MONITORING))) {
+    binary_events->AddEvent(
+        static_cast<int>(PlatformThread::CurrentId()), now, thread_now,
+        TRACE_EVENT_PHASE_END, GetCategoryGroupName(category_group_enabled),
+        name, trace_event_internal::kNoEventId, 0, NULL, NULL, NULL, NULL,
+        TRACE_EVENT_FLAG_NONE);
+  } else if (*category_group_enabled & ENABLED_FOR_RECORDING) {
     OptionalAutoLock lock(lock_);
 
     TraceEvent* trace_event = GetEventByHandleInternal(handle, &lock);
@@ -57,11 +57,15 @@ struct hash<base::MessageLoop*> {
 
 namespace base {
 
+class FilePath;
 class WaitableEvent;
 class MessageLoop;
 
 namespace debug {
 
+class TraceBinaryBuffer;
+class TraceBinaryReader;
+
 // For any argument of type TRACE_VALUE_TYPE_CONVERTABLE the provided
 // class must implement this interface.
 class ConvertableToTraceFormat : public RefCounted<ConvertableToTraceFormat> {
@@ -385,6 +389,13 @@ class BASE_EXPORT TraceLog {
 
     // Echo to console. Events are discarded.
     ECHO_TO_CONSOLE = 1 << 3,
+
+    // Record events as compact binary records in a fixed-size ring buffer per
+    // thread, see trace_event_binary.h. The buffers are never full; each
+    // thread's oldest events are overwritten. The events are converted to
+    // JSON when flushed, and can be exported with ExportBinaryTrace() without
+    // stopping the trace.
+    RECORD_AS_BINARY = 1 << 4,
   };
 
   // The pointer returned from GetCategoryGroupEnabledInternal() points to a
@@ -497,6 +508,13 @@ class BASE_EXPORT TraceLog {
   void Flush(const OutputCallback& cb);
   void FlushButLeaveBufferIntact(const OutputCallback& flush_output_callback);
 
+  // Writes the events recorded with RECORD_AS_BINARY, along with the process
+  // and thread names, to |path| in the format read by TraceBinaryReader.
+  // Unlike Flush(), this may be called while tracing is enabled, and leaves
+  // the recorded events in place. Returns false if binary recording has never
+  // been enabled or the file couldn't be written.
+  bool ExportBinaryTrace(const FilePath& path);
+
   // Called by TRACE_EVENT* macros, don't call this directly.
   // The name parameter is a category group for example:
   // TRACE_EVENT0("renderer,webkit", "WebViewImpl::HandleInputEvent")
@@ -648,7 +666,9 @@ class BASE_EXPORT TraceLog {
   // is called for the flush of the current |logged_events_|.
   void FlushCurrentThread(int generation);
   void ConvertTraceEventsToTraceFormat(scoped_ptr<TraceBuffer> logged_events,
+      scoped_ptr<TraceBinaryReader> binary_events,
       const TraceLog::OutputCallback& flush_output_callback);
+  scoped_ptr<TraceBinaryReader> SnapshotBinaryEventsWhileLocked();
   void FinishFlush(int generation);
   void OnFlushTimeout(int generation);
 
@@ -677,6 +697,10 @@ class BASE_EXPORT TraceLog {
   Mode mode_;
   int num_traces_recorded_;
   scoped_ptr<TraceBuffer> logged_events_;
+  // Created the first time RECORD_AS_BINARY is used, and kept from then on
+  // since threads record to it without holding |lock_|. With
+  // RECORD_AS_BINARY, |logged_events_| only holds metadata events.
+  scoped_ptr<TraceBinaryBuffer> binary_events_;
   subtle::AtomicWord /* EventCallback */ event_callback_;
   bool dispatching_to_observer_list_;
   std::vector<EnabledStateObserver*> enabled_state_observer_list_;
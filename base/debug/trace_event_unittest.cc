@@ -10,7 +10,9 @@
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/debug/trace_event.h"
+#include "base/debug/trace_event_binary.h"
 #include "base/debug/trace_event_synthetic_delay.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/memory/ref_counted_memory.h"
@@ -2732,6 +2734,92 @@ TEST_F(TraceEventTestFixture, EchoToConsoleTraceEventRecursion) {
   logging::SetLogMessageHandler(old_log_message_handler);
 }
 
+TEST_F(TraceEventTestFixture, RecordAsBinary) {
+  TraceLog::GetInstance()->SetEnabled(CategoryFilter("*"),
+                                      base::debug::TraceLog::RECORDING_MODE,
+                                      TraceLog::RECORD_AS_BINARY);
+  {
+    TRACE_EVENT1("all", "duration", "count", 3);
+    TRACE_EVENT_INSTANT1("all", "instant", TRACE_EVENT_SCOPE_THREAD,
+                         "str", "static");
+    std::string name("copied");
+    TRACE_EVENT_COPY_INSTANT1("all", name.c_str(), TRACE_EVENT_SCOPE_THREAD,
+                              "data", scoped_refptr<ConvertableToTraceFormat>(
+                                  new MyData()));
+  }
+  EndTraceAndFlush();
+
+  // The COMPLETE event is recorded as a BEGIN and an END event.
+  DictionaryValue* item = FindNamePhase("duration", "B");
+  ASSERT_TRUE(item);
+  int count = 0;
+  EXPECT_TRUE(item->GetInteger("args.count", &count));
+  EXPECT_EQ(3, count);
+  EXPECT_TRUE(FindNamePhase("duration", "E"));
+
+  item = FindNamePhase("instant", "i");
+  ASSERT_TRUE(item);
+  std::string str;
+  EXPECT_TRUE(item->GetString("args.str", &str));
+  EXPECT_EQ("static", str);
+  EXPECT_TRUE(item->GetString("s", &str));
+  EXPECT_EQ("t", str);
+
+  item = FindNamePhase("copied", "i");
+  ASSERT_TRUE(item);
+  int foo = 0;
+  EXPECT_TRUE(item->GetInteger("args.data.foo", &foo));
+  EXPECT_EQ(1, foo);
+
+  // Flushing discards the events.
+  Clear();
+  TraceLog::GetInstance()->SetEnabled(CategoryFilter("*"),
+                                      base::debug::TraceLog::RECORDING_MODE,
+                                      TraceLog::RECORD_AS_BINARY);
+  EndTraceAndFlush();
+  EXPECT_FALSE(FindNamePhase("instant", "i"));
+}
+
+TEST_F(TraceEventTestFixture, ExportBinaryTraceWhileEnabled) {
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  FilePath path = temp_dir.path().AppendASCII("trace.bin");
+
+  // Nothing to export before binary recording has been used.
+  EXPECT_FALSE(TraceLog::GetInstance()->ExportBinaryTrace(path));
+
+  PlatformThread::SetName("binary_export");
+  TraceLog::GetInstance()->SetEnabled(CategoryFilter("*"),
+                                      base::debug::TraceLog::RECORDING_MODE,
+                                      TraceLog::RECORD_AS_BINARY);
+  TRACE_EVENT_INSTANT0("all", "exported", TRACE_EVENT_SCOPE_THREAD);
+  ASSERT_TRUE(TraceLog::GetInstance()->ExportBinaryTrace(path));
+  EXPECT_TRUE(TraceLog::GetInstance()->IsEnabled());
+
+  TraceBinaryReader reader;
+  ASSERT_TRUE(reader.InitializeFromFile(path));
+  std::string json = "[";
+  for (size_t i = 0; i < reader.num_events(); ++i) {
+    if (i)
+      json += ",";
+    reader.AppendEventAsJSON(i, &json);
+  }
+  json += "]";
+  scoped_ptr<Value> root(JSONReader::Read(json));
+  ListValue* events = NULL;
+  ASSERT_TRUE(root && root->GetAsList(&events));
+  trace_parsed_.Swap(events);
+
+  EXPECT_TRUE(FindNamePhase("exported", "i"));
+  DictionaryValue* item = FindNamePhase("thread_name", "M");
+  ASSERT_TRUE(item);
+  std::string thread_name;
+  EXPECT_TRUE(item->GetString("args.name", &thread_name));
+  EXPECT_EQ("binary_export", thread_name);
+
+  TraceLog::GetInstance()->SetDisabled();
+}
+
 TEST_F(TraceEventTestFixture, TimeOffset) {
   BeginTrace();
   // Let TraceLog timer start from 0.
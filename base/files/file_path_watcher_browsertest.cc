@@ -484,7 +484,7 @@ TEST_F(FilePathWatcherTest, MoveParent) {
   DeleteDelegateOnFileThread(subdir_delegate.release());
 }
 
-#if defined(OS_WIN)
+#if defined(OS_WIN) || defined(OS_LINUX) || defined(OS_ANDROID)
 TEST_F(FilePathWatcherTest, RecursiveWatch) {
   FilePathWatcher watcher;
   FilePath dir(temp_dir_.path().AppendASCII("dir"));
@@ -524,9 +524,12 @@ TEST_F(FilePathWatcherTest, RecursiveWatch) {
   ASSERT_TRUE(WriteFile(child_dir_file1, "content"));
   ASSERT_TRUE(WaitForEvents());
 
+#if defined(OS_WIN)
   // Modify "$dir/subdir/subdir_child_dir/child_dir_file1" attributes.
+  // Linux implementation of FilePathWatcher doesn't catch attribute changes.
   ASSERT_TRUE(file_util::MakeFileUnreadable(child_dir_file1));
   ASSERT_TRUE(WaitForEvents());
+#endif
 
   // Delete "$dir/subdir/subdir_file1".
   ASSERT_TRUE(base::DeleteFile(subdir_file1, false));
@@ -542,7 +545,7 @@ TEST_F(FilePathWatcherTest, RecursiveWatch) {
   FilePathWatcher watcher;
   FilePath dir(temp_dir_.path().AppendASCII("dir"));
   scoped_ptr<TestDelegate> delegate(new TestDelegate(collector()));
-  // Non-Windows implementaion does not support recursive watching.
+  // Only the Windows and Linux implementations support recursive watching.
   ASSERT_FALSE(SetupWatch(dir, &watcher, delegate.get(), true));
   DeleteDelegateOnFileThread(delegate.release());
 }
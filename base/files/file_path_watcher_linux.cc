@@ -12,6 +12,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <map>
 #include <set>
 #include <utility>
 #include <vector>
@@ -20,6 +21,7 @@
 #include "base/containers/hash_tables.h"
 #include "base/debug/trace_event.h"
 #include "base/file_util.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/lazy_instance.h"
 #include "base/location.h"
@@ -28,6 +30,8 @@
 #include "base/message_loop/message_loop.h"
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/posix/eintr_wrapper.h"
+#include "base/stl_util.h"
+#include "base/strings/string_util.h"
 #include "base/synchronization/lock.h"
 #include "base/threading/thread.h"
 
@@ -37,7 +41,29 @@ namespace {
 
 class FilePathWatcherImpl;
 
-// Singleton to manage all inotify watches.
+// A single inotify event, as relevant to a FilePathWatcherImpl.
+struct InotifyChange {
+  InotifyChange(int watch,
+                const FilePath::StringType& child,
+                bool created,
+                bool is_dir)
+      : watch(watch), child(child), created(created), is_dir(is_dir) {}
+
+  bool operator==(const InotifyChange& other) const {
+    return watch == other.watch && child == other.child &&
+           created == other.created && is_dir == other.is_dir;
+  }
+
+  int watch;
+  FilePath::StringType child;
+  bool created;
+  bool is_dir;
+};
+typedef std::vector<InotifyChange> InotifyChangeList;
+
+// Singleton to manage all inotify watches. Watch descriptors are shared:
+// the kernel hands out one descriptor per watched directory, however many
+// watchers asked for it.
 // TODO(tony): It would be nice if this wasn't a singleton.
 // http://crbug.com/38174
 class InotifyReader {
@@ -52,8 +78,8 @@ class InotifyReader {
   // Remove |watch|. Returns true on success.
   bool RemoveWatch(Watch watch, FilePathWatcherImpl* watcher);
 
-  // Callback for InotifyReaderTask.
-  void OnInotifyEvent(const inotify_event* event);
+  // Callback for InotifyReaderTask, with all the events from one read().
+  void OnInotifyEvents(const std::vector<const inotify_event*>& events);
 
  private:
   friend struct DefaultLazyInstanceTraits<InotifyReader>;
@@ -89,13 +115,11 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate,
  public:
   FilePathWatcherImpl();
 
-  // Called for each event coming from the watch. |fired_watch| identifies the
-  // watch that fired, |child| indicates what has changed, and is relative to
-  // the currently watched path for |fired_watch|. The flag |created| is true if
-  // the object appears.
-  void OnFilePathChanged(InotifyReader::Watch fired_watch,
-                         const FilePath::StringType& child,
-                         bool created);
+  // Called with the events from one read of the inotify queue that concern
+  // this watcher, in order and without consecutive duplicates. |overflowed|
+  // is true if the kernel dropped events, in which case anything may have
+  // changed.
+  void OnFilePathsChanged(const InotifyChangeList& changes, bool overflowed);
 
   // Start watching |path| for changes and notify |delegate| on each change.
   // Returns true if watch for |path| has been added successfully.
@@ -133,10 +157,29 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate,
   };
   typedef std::vector<WatchEntry> WatchVector;
 
+  // Handles one change. Sets |*notify| if the callback should run. Returns
+  // false if the watches could not be updated.
+  bool OnFilePathChanged(const InotifyChange& change, bool* notify);
+
   // Reconfigure to watch for the most specific parent directory of |target_|
   // that exists. Updates |watched_path_|. Returns true on success.
   bool UpdateWatches() WARN_UNUSED_RESULT;
 
+  // For recursive watches: makes sure every directory below |target_| is
+  // watched, or that none is if |target_| is gone.
+  void UpdateRecursiveWatches();
+
+  // For recursive watches: watches |dir| and every directory below it.
+  void AddRecursiveWatches(const FilePath& dir);
+  void AddRecursiveWatch(const FilePath& dir);
+
+  // For recursive watches: stops watching |dir| and everything below it.
+  void RemoveRecursiveWatches(const FilePath& dir);
+
+  // Returns the directory below |target_| that |watch| stands for, or an
+  // empty path.
+  FilePath GetRecursiveWatchPath(InotifyReader::Watch watch) const;
+
   // Callback to notify upon changes.
   FilePathWatcher::Callback callback_;
 
@@ -148,6 +191,15 @@ class FilePathWatcherImpl : public FilePathWatcher::PlatformDelegate,
   // |target_| and always stores an empty next component name in |subdir_|.
   WatchVector watches_;
 
+  bool recursive_;
+
+  // The watch on |target_| for which |recursive_watches_| were set up.
+  InotifyReader::Watch recursive_root_watch_;
+
+  // Watches on the directories below |target_|, for recursive watches.
+  std::map<FilePath, InotifyReader::Watch> recursive_watches_;
+  std::map<InotifyReader::Watch, FilePath> recursive_paths_;
+
   DISALLOW_COPY_AND_ASSIGN(FilePathWatcherImpl);
 };
 
@@ -199,14 +251,16 @@ void InotifyReaderCallback(InotifyReader* reader, int inotify_fd,
       return;
     }
 
+    std::vector<const inotify_event*> events;
     ssize_t i = 0;
     while (i < bytes_read) {
       inotify_event* event = reinterpret_cast<inotify_event*>(&buffer[i]);
       size_t event_size = sizeof(inotify_event) + event->len;
       DCHECK(i + event_size <= static_cast<size_t>(bytes_read));
-      reader->OnInotifyEvent(event);
+      events.push_back(event);
       i += event_size;
     }
+    reader->OnInotifyEvents(events);
   }
 }
 
@@ -274,51 +328,141 @@ bool InotifyReader::RemoveWatch(Watch watch,
 
   AutoLock auto_lock(lock_);
 
-  watchers_[watch].erase(watcher);
+  hash_map<Watch, WatcherSet>::iterator it = watchers_.find(watch);
+  if (it == watchers_.end())
+    return true;
 
-  if (watchers_[watch].empty()) {
-    watchers_.erase(watch);
+  it->second.erase(watcher);
+
+  if (it->second.empty()) {
+    watchers_.erase(it);
     return (inotify_rm_watch(inotify_fd_, watch) == 0);
   }
 
   return true;
 }
 
-void InotifyReader::OnInotifyEvent(const inotify_event* event) {
-  if (event->mask & IN_IGNORED)
-    return;
+void InotifyReader::OnInotifyEvents(
+    const std::vector<const inotify_event*>& events) {
+  // Group the events by watcher, so that each watcher gets one task per read
+  // rather than one per event.
+  typedef std::map<FilePathWatcherImpl*, InotifyChangeList> ChangeMap;
+  ChangeMap changes;
+  bool overflowed = false;
 
-  FilePath::StringType child(event->len ? event->name : FILE_PATH_LITERAL(""));
   AutoLock auto_lock(lock_);
 
-  for (WatcherSet::iterator watcher = watchers_[event->wd].begin();
-       watcher != watchers_[event->wd].end();
-       ++watcher) {
-    (*watcher)->OnFilePathChanged(event->wd,
-                                  child,
-                                  event->mask & (IN_CREATE | IN_MOVED_TO));
+  for (size_t i = 0; i < events.size(); ++i) {
+    const inotify_event* event = events[i];
+    if (event->mask & IN_Q_OVERFLOW) {
+      overflowed = true;
+      continue;
+    }
+    if (event->mask & IN_IGNORED)
+      continue;
+
+    hash_map<Watch, WatcherSet>::const_iterator it = watchers_.find(event->wd);
+    if (it == watchers_.end())
+      continue;
+
+    InotifyChange change(
+        event->wd,
+        event->len ? event->name : FILE_PATH_LITERAL(""),
+        (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0,
+        (event->mask & IN_ISDIR) != 0);
+    for (WatcherSet::const_iterator watcher = it->second.begin();
+         watcher != it->second.end(); ++watcher) {
+      // A file being written usually shows up as a burst of identical
+      // events; one is enough.
+      InotifyChangeList& list = changes[*watcher];
+      if (list.empty() || !(list.back() == change))
+        list.push_back(change);
+    }
+  }
+
+  if (overflowed) {
+    // Every watcher may have missed something.
+    for (hash_map<Watch, WatcherSet>::const_iterator it = watchers_.begin();
+         it != watchers_.end(); ++it) {
+      for (WatcherSet::const_iterator watcher = it->second.begin();
+           watcher != it->second.end(); ++watcher) {
+        changes[*watcher];
+      }
+    }
+  }
+
+  for (ChangeMap::const_iterator it = changes.begin(); it != changes.end();
+       ++it) {
+    it->first->OnFilePathsChanged(it->second, overflowed);
   }
 }
 
-FilePathWatcherImpl::FilePathWatcherImpl() {
+FilePathWatcherImpl::FilePathWatcherImpl()
+    : recursive_(false),
+      recursive_root_watch_(InotifyReader::kInvalidWatch) {
 }
 
-void FilePathWatcherImpl::OnFilePathChanged(InotifyReader::Watch fired_watch,
-                                            const FilePath::StringType& child,
-                                            bool created) {
+void FilePathWatcherImpl::OnFilePathsChanged(const InotifyChangeList& changes,
+                                             bool overflowed) {
   if (!message_loop()->BelongsToCurrentThread()) {
     // Switch to message_loop_ to access watches_ safely.
     message_loop()->PostTask(FROM_HERE,
-        Bind(&FilePathWatcherImpl::OnFilePathChanged,
+        Bind(&FilePathWatcherImpl::OnFilePathsChanged,
                    this,
-                   fired_watch,
-                   child,
-                   created));
+                   changes,
+                   overflowed));
     return;
   }
 
   DCHECK(MessageLoopForIO::current());
 
+  if (callback_.is_null())
+    return;
+
+  if (overflowed) {
+    // Start over, as after Watch(), and assume the target changed.
+    recursive_root_watch_ = InotifyReader::kInvalidWatch;
+    if (!UpdateWatches()) {
+      callback_.Run(target_, true /* error */);
+      return;
+    }
+    callback_.Run(target_, false);
+    return;
+  }
+
+  bool notify = false;
+  for (InotifyChangeList::const_iterator change = changes.begin();
+       change != changes.end(); ++change) {
+    if (!OnFilePathChanged(*change, &notify)) {
+      callback_.Run(target_, true /* error */);
+      return;
+    }
+  }
+  if (notify)
+    callback_.Run(target_, false);
+}
+
+bool FilePathWatcherImpl::OnFilePathChanged(const InotifyChange& change,
+                                            bool* notify) {
+  const InotifyReader::Watch fired_watch = change.watch;
+  const FilePath::StringType& child = change.child;
+  const bool created = change.created;
+
+  if (recursive_) {
+    // Changes anywhere below |target_| are reported, and directories that
+    // come and go below it gain or lose their watches.
+    FilePath dir = GetRecursiveWatchPath(fired_watch);
+    if (dir.empty() && fired_watch == recursive_root_watch_)
+      dir = target_;
+    if (!dir.empty() && !child.empty()) {
+      if (change.is_dir && created)
+        AddRecursiveWatches(dir.Append(child));
+      else if (change.is_dir)
+        RemoveRecursiveWatches(dir.Append(child));
+      *notify = true;
+    }
+  }
+
   // Find the entry in |watches_| that corresponds to |fired_watch|.
   WatchVector::const_iterator watch_entry(watches_.begin());
   for ( ; watch_entry != watches_.end(); ++watch_entry) {
@@ -342,10 +486,8 @@ void FilePathWatcherImpl::OnFilePathChanged(InotifyReader::Watch fired_watch,
       // as changes to symlinks on the target path will not have
       // IN_ISDIR set in the event masks. As a result we may sometimes
       // call UpdateWatches() unnecessarily.
-      if (change_on_target_path && !UpdateWatches()) {
-        callback_.Run(target_, true /* error */);
-        return;
-      }
+      if (change_on_target_path && !UpdateWatches())
+        return false;
 
       // Report the following events:
       //  - The target or a direct child of the target got changed (in case the
@@ -358,11 +500,12 @@ void FilePathWatcherImpl::OnFilePathChanged(InotifyReader::Watch fired_watch,
       if (target_changed ||
           (change_on_target_path && !created) ||
           (change_on_target_path && PathExists(target_))) {
-        callback_.Run(target_, false);
-        return;
+        *notify = true;
+        return true;
       }
     }
   }
+  return true;
 }
 
 bool FilePathWatcherImpl::Watch(const FilePath& path,
@@ -370,15 +513,11 @@ bool FilePathWatcherImpl::Watch(const FilePath& path,
                                 const FilePathWatcher::Callback& callback) {
   DCHECK(target_.empty());
   DCHECK(MessageLoopForIO::current());
-  if (recursive) {
-    // Recursive watch is not supported on this platform.
-    NOTIMPLEMENTED();
-    return false;
-  }
 
   set_message_loop(MessageLoopProxy::current().get());
   callback_ = callback;
   target_ = path;
+  recursive_ = recursive;
   MessageLoop::current()->AddDestructionObserver(this);
 
   std::vector<FilePath::StringType> comps;
@@ -425,6 +564,14 @@ void FilePathWatcherImpl::CancelOnMessageLoopThread() {
       g_inotify_reader.Get().RemoveWatch(watch_entry->watch_, this);
   }
   watches_.clear();
+  for (std::map<FilePath, InotifyReader::Watch>::iterator it =
+           recursive_watches_.begin();
+       it != recursive_watches_.end(); ++it) {
+    g_inotify_reader.Get().RemoveWatch(it->second, this);
+  }
+  recursive_watches_.clear();
+  recursive_paths_.clear();
+  recursive_root_watch_ = InotifyReader::kInvalidWatch;
   target_.clear();
 }
 
@@ -481,9 +628,90 @@ bool FilePathWatcherImpl::UpdateWatches() {
     path = path.Append(watch_entry->subdir_);
   }
 
+  if (recursive_)
+    UpdateRecursiveWatches();
   return true;
 }
 
+void FilePathWatcherImpl::UpdateRecursiveWatches() {
+  const WatchEntry& target_entry = watches_.back();
+  if (target_entry.watch_ == InotifyReader::kInvalidWatch ||
+      !target_entry.linkname_.empty() || !DirectoryExists(target_)) {
+    RemoveRecursiveWatches(target_);
+    recursive_root_watch_ = InotifyReader::kInvalidWatch;
+    return;
+  }
+
+  // |target_| is still the same directory, and changes below it have been
+  // tracked as they happened.
+  if (target_entry.watch_ == recursive_root_watch_)
+    return;
+
+  RemoveRecursiveWatches(target_);
+  recursive_root_watch_ = target_entry.watch_;
+  AddRecursiveWatches(target_);
+}
+
+void FilePathWatcherImpl::AddRecursiveWatches(const FilePath& dir) {
+  if (dir != target_)
+    AddRecursiveWatch(dir);
+
+  FileEnumerator enumerator(dir, true, FileEnumerator::DIRECTORIES);
+  for (FilePath subdir = enumerator.Next(); !subdir.empty();
+       subdir = enumerator.Next()) {
+    AddRecursiveWatch(subdir);
+  }
+}
+
+void FilePathWatcherImpl::AddRecursiveWatch(const FilePath& dir) {
+  if (ContainsKey(recursive_watches_, dir))
+    return;
+
+  InotifyReader::Watch watch = g_inotify_reader.Get().AddWatch(dir, this);
+  if (watch == InotifyReader::kInvalidWatch) {
+    // Most likely the per-user watch limit; changes below |dir| are missed.
+    DPLOG(WARNING) << "Watch failed for " << dir.value();
+    return;
+  }
+
+  // The directory may already be watched under another name, e.g. through a
+  // symlink. Leave that watch to whoever owns it.
+  if (ContainsKey(recursive_paths_, watch) || watch == recursive_root_watch_)
+    return;
+  for (WatchVector::const_iterator it = watches_.begin();
+       it != watches_.end(); ++it) {
+    if (it->watch_ == watch)
+      return;
+  }
+
+  recursive_watches_[dir] = watch;
+  recursive_paths_[watch] = dir;
+}
+
+void FilePathWatcherImpl::RemoveRecursiveWatches(const FilePath& dir) {
+  // Paths below |dir| share its string prefix, so they are contiguous in
+  // |recursive_watches_|, possibly mixed with siblings like "dir-2".
+  std::map<FilePath, InotifyReader::Watch>::iterator it =
+      recursive_watches_.lower_bound(dir);
+  while (it != recursive_watches_.end() &&
+         StartsWithASCII(it->first.value(), dir.value(), true)) {
+    if (it->first != dir && !dir.IsParent(it->first)) {
+      ++it;
+      continue;
+    }
+    g_inotify_reader.Get().RemoveWatch(it->second, this);
+    recursive_paths_.erase(it->second);
+    recursive_watches_.erase(it++);
+  }
+}
+
+FilePath FilePathWatcherImpl::GetRecursiveWatchPath(
+    InotifyReader::Watch watch) const {
+  std::map<InotifyReader::Watch, FilePath>::const_iterator it =
+      recursive_paths_.find(watch);
+  return it == recursive_paths_.end() ? FilePath() : it->second;
+}
+
 }  // namespace
 
 FilePathWatcher::FilePathWatcher() {
@@ -0,0 +1,91 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures a recursive FilePathWatcher on a tree of 100k files: how long
+// Watch() takes to cover the tree, and how many notifications a burst of
+// writes inside it turns into.
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/files/file_path_watcher.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+const int kNumDirectories = 1000;
+const int kFilesPerDirectory = 100;
+const int kNumWrites = 10000;
+
+// How long the watcher has to stay quiet before the burst counts as fully
+// delivered.
+const int kQuietPeriodMs = 500;
+
+void CountNotification(int* count, const FilePath& path, bool error) {
+  EXPECT_FALSE(error);
+  ++*count;
+}
+
+FilePath FileInTree(const FilePath& root, int index) {
+  return root.AppendASCII(StringPrintf("dir%d", index / kFilesPerDirectory))
+      .AppendASCII(StringPrintf("file%d", index % kFilesPerDirectory));
+}
+
+}  // namespace
+
+TEST(FilePathWatcherPerfTest, RecursiveWatch) {
+  ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const FilePath root = temp_dir.path().AppendASCII("tree");
+  for (int i = 0; i < kNumDirectories; ++i) {
+    ASSERT_TRUE(base::CreateDirectory(
+        root.AppendASCII(StringPrintf("dir%d", i))));
+  }
+  for (int i = 0; i < kNumDirectories * kFilesPerDirectory; ++i)
+    ASSERT_EQ(1, file_util::WriteFile(FileInTree(root, i), "x", 1));
+
+  MessageLoopForIO message_loop;
+  FilePathWatcher watcher;
+  int notifications = 0;
+
+  TimeTicks start = TimeTicks::HighResNow();
+  ASSERT_TRUE(watcher.Watch(root, true,
+                            Bind(&CountNotification, &notifications)));
+  perf_test::PrintResult("watch_setup_time", "", "100k_files",
+                         (TimeTicks::HighResNow() - start).InMillisecondsF(),
+                         "ms", true);
+
+  start = TimeTicks::HighResNow();
+  for (int i = 0; i < kNumWrites; ++i) {
+    const int index = (i * 7919) % (kNumDirectories * kFilesPerDirectory);
+    ASSERT_EQ(1, file_util::WriteFile(FileInTree(root, index), "yy", 2));
+  }
+
+  // Deliver notifications until none arrives for a while.
+  int last_count = -1;
+  while (notifications != last_count) {
+    last_count = notifications;
+    PlatformThread::Sleep(TimeDelta::FromMilliseconds(kQuietPeriodMs));
+    RunLoop().RunUntilIdle();
+  }
+  const TimeDelta elapsed = TimeTicks::HighResNow() - start -
+      TimeDelta::FromMilliseconds(kQuietPeriodMs);
+
+  EXPECT_GT(notifications, 0);
+  perf_test::PrintResult("burst_delivery_time", "", "10k_writes",
+                         elapsed.InMillisecondsF(), "ms", true);
+  perf_test::PrintResult("notifications", "", "10k_writes",
+                         static_cast<size_t>(notifications), "count", true);
+}
+
+}  // namespace base
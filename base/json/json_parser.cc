@@ -186,6 +186,7 @@ class StackMarker {
 
 JSONParser::JSONParser(int options)
     : options_(options),
+      handler_(NULL),
       start_pos_(NULL),
       pos_(NULL),
       end_pos_(NULL),
@@ -208,28 +209,9 @@ Value* JSONParser::Parse(const StringPiece& input) {
   // be used anywhere.
   if (!(options_ & JSON_DETACHABLE_CHILDREN)) {
     input_copy.reset(new std::string(input.as_string()));
-    start_pos_ = input_copy->data();
+    StartInput(input_copy->data(), input_copy->length());
   } else {
-    start_pos_ = input.data();
-  }
-  pos_ = start_pos_;
-  end_pos_ = start_pos_ + input.length();
-  index_ = 0;
-  line_number_ = 1;
-  index_last_line_ = 0;
-
-  error_code_ = JSONReader::JSON_NO_ERROR;
-  error_line_ = 0;
-  error_column_ = 0;
-
-  // When the input JSON string starts with a UTF-8 Byte-Order-Mark
-  // <0xEF 0xBB 0xBF>, advance the start position to avoid the
-  // ParseNextToken function mis-treating a Unicode BOM as an invalid
-  // character and returning NULL.
-  if (CanConsume(3) && static_cast<uint8>(*pos_) == 0xEF &&
-      static_cast<uint8>(*(pos_ + 1)) == 0xBB &&
-      static_cast<uint8>(*(pos_ + 2)) == 0xBF) {
-    NextNChars(3);
+    StartInput(input.data(), input.length());
   }
 
   // Parse the first and any nested tokens.
@@ -238,12 +220,8 @@ Value* JSONParser::Parse(const StringPiece& input) {
     return NULL;
 
   // Make sure the input stream is at an end.
-  if (GetNextToken() != T_END_OF_INPUT) {
-    if (!CanConsume(1) || (NextChar() && GetNextToken() != T_END_OF_INPUT)) {
-      ReportError(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, 1);
-      return NULL;
-    }
-  }
+  if (!ConsumeEndOfInput())
+    return NULL;
 
   // Dictionaries and lists can contain JSONStringValues, so wrap them in a
   // hidden root.
@@ -264,6 +242,17 @@ Value* JSONParser::Parse(const StringPiece& input) {
   return root.release();
 }
 
+bool JSONParser::ParseWithHandler(const StringPiece& input,
+                                  JSONReader::Handler* handler) {
+  // Strings are handed out as pieces of |input| that only need to live until
+  // each callback returns, so unlike Parse() no copy is made.
+  StartInput(input.data(), input.length());
+  handler_ = handler;
+  bool result = StreamNextToken() && ConsumeEndOfInput();
+  handler_ = NULL;
+  return result;
+}
+
 JSONReader::JsonParseError JSONParser::error_code() const {
   return error_code_;
 }
@@ -336,6 +325,39 @@ const std::string& JSONParser::StringBuilder::AsString() {
 
 // JSONParser private //////////////////////////////////////////////////////////
 
+void JSONParser::StartInput(const char* start, size_t length) {
+  start_pos_ = start;
+  pos_ = start_pos_;
+  end_pos_ = start_pos_ + length;
+  index_ = 0;
+  line_number_ = 1;
+  index_last_line_ = 0;
+
+  error_code_ = JSONReader::JSON_NO_ERROR;
+  error_line_ = 0;
+  error_column_ = 0;
+
+  // When the input JSON string starts with a UTF-8 Byte-Order-Mark
+  // <0xEF 0xBB 0xBF>, advance the start position to avoid the
+  // ParseNextToken function mis-treating a Unicode BOM as an invalid
+  // character and returning NULL.
+  if (CanConsume(3) && static_cast<uint8>(*pos_) == 0xEF &&
+      static_cast<uint8>(*(pos_ + 1)) == 0xBB &&
+      static_cast<uint8>(*(pos_ + 2)) == 0xBF) {
+    NextNChars(3);
+  }
+}
+
+bool JSONParser::ConsumeEndOfInput() {
+  if (GetNextToken() != T_END_OF_INPUT) {
+    if (!CanConsume(1) || (NextChar() && GetNextToken() != T_END_OF_INPUT)) {
+      ReportError(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, 1);
+      return false;
+    }
+  }
+  return true;
+}
+
 inline bool JSONParser::CanConsume(int length) {
   return pos_ + length <= end_pos_;
 }
@@ -584,6 +606,151 @@ Value* JSONParser::ConsumeList() {
   return list.release();
 }
 
+bool JSONParser::StreamNextToken() {
+  return StreamToken(GetNextToken());
+}
+
+bool JSONParser::StreamToken(Token token) {
+  switch (token) {
+    case T_OBJECT_BEGIN:
+      return StreamDictionary();
+    case T_ARRAY_BEGIN:
+      return StreamList();
+    case T_STRING: {
+      StringBuilder string;
+      if (!ConsumeStringRaw(&string))
+        return false;
+      return handler_->OnString(string.CanBeStringPiece() ?
+          string.AsStringPiece() : StringPiece(string.AsString()));
+    }
+    case T_NUMBER: {
+      StringPiece num_string;
+      if (!ConsumeNumberRaw(&num_string))
+        return false;
+      int num_int;
+      if (StringToInt(num_string, &num_int))
+        return handler_->OnInteger(num_int);
+      double num_double;
+      if (base::StringToDouble(num_string.as_string(), &num_double) &&
+          IsFinite(num_double)) {
+        return handler_->OnDouble(num_double);
+      }
+      return false;
+    }
+    case T_BOOL_TRUE:
+    case T_BOOL_FALSE:
+    case T_NULL:
+      if (!ConsumeLiteralRaw())
+        return false;
+      if (token == T_NULL)
+        return handler_->OnNull();
+      return handler_->OnBoolean(token == T_BOOL_TRUE);
+    default:
+      ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
+      return false;
+  }
+}
+
+bool JSONParser::StreamDictionary() {
+  if (*pos_ != '{') {
+    ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
+    return false;
+  }
+
+  StackMarker depth_check(&stack_depth_);
+  if (depth_check.IsTooDeep()) {
+    ReportError(JSONReader::JSON_TOO_MUCH_NESTING, 1);
+    return false;
+  }
+
+  if (!handler_->OnDictionaryBegin())
+    return false;
+
+  NextChar();
+  Token token = GetNextToken();
+  while (token != T_OBJECT_END) {
+    if (token != T_STRING) {
+      ReportError(JSONReader::JSON_UNQUOTED_DICTIONARY_KEY, 1);
+      return false;
+    }
+
+    StringBuilder key;
+    if (!ConsumeStringRaw(&key))
+      return false;
+
+    NextChar();
+    token = GetNextToken();
+    if (token != T_OBJECT_PAIR_SEPARATOR) {
+      ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+      return false;
+    }
+
+    if (!handler_->OnDictionaryKey(key.CanBeStringPiece() ?
+            key.AsStringPiece() : StringPiece(key.AsString()))) {
+      return false;
+    }
+
+    NextChar();
+    if (!StreamNextToken())
+      return false;
+
+    NextChar();
+    token = GetNextToken();
+    if (token == T_LIST_SEPARATOR) {
+      NextChar();
+      token = GetNextToken();
+      if (token == T_OBJECT_END && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+        ReportError(JSONReader::JSON_TRAILING_COMMA, 1);
+        return false;
+      }
+    } else if (token != T_OBJECT_END) {
+      ReportError(JSONReader::JSON_SYNTAX_ERROR, 0);
+      return false;
+    }
+  }
+
+  return handler_->OnDictionaryEnd();
+}
+
+bool JSONParser::StreamList() {
+  if (*pos_ != '[') {
+    ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
+    return false;
+  }
+
+  StackMarker depth_check(&stack_depth_);
+  if (depth_check.IsTooDeep()) {
+    ReportError(JSONReader::JSON_TOO_MUCH_NESTING, 1);
+    return false;
+  }
+
+  if (!handler_->OnListBegin())
+    return false;
+
+  NextChar();
+  Token token = GetNextToken();
+  while (token != T_ARRAY_END) {
+    if (!StreamToken(token))
+      return false;
+
+    NextChar();
+    token = GetNextToken();
+    if (token == T_LIST_SEPARATOR) {
+      NextChar();
+      token = GetNextToken();
+      if (token == T_ARRAY_END && !(options_ & JSON_ALLOW_TRAILING_COMMAS)) {
+        ReportError(JSONReader::JSON_TRAILING_COMMA, 1);
+        return false;
+      }
+    } else if (token != T_ARRAY_END) {
+      ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
+      return false;
+    }
+  }
+
+  return handler_->OnListEnd();
+}
+
 Value* JSONParser::ConsumeString() {
   StringBuilder string;
   if (!ConsumeStringRaw(&string))
@@ -804,6 +971,24 @@ void JSONParser::DecodeUTF8(const int32& point, StringBuilder* dest) {
 }
 
 Value* JSONParser::ConsumeNumber() {
+  StringPiece num_string;
+  if (!ConsumeNumberRaw(&num_string))
+    return NULL;
+
+  int num_int;
+  if (StringToInt(num_string, &num_int))
+    return new FundamentalValue(num_int);
+
+  double num_double;
+  if (base::StringToDouble(num_string.as_string(), &num_double) &&
+      IsFinite(num_double)) {
+    return new FundamentalValue(num_double);
+  }
+
+  return NULL;
+}
+
+bool JSONParser::ConsumeNumberRaw(StringPiece* num_string) {
   const char* num_start = pos_;
   const int start_index = index_;
   int end_index = start_index;
@@ -813,7 +998,7 @@ Value* JSONParser::ConsumeNumber() {
 
   if (!ReadInt(false)) {
     ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-    return NULL;
+    return false;
   }
   end_index = index_;
 
@@ -821,12 +1006,12 @@ Value* JSONParser::ConsumeNumber() {
   if (*pos_ == '.') {
     if (!CanConsume(1)) {
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
     }
     NextChar();
     if (!ReadInt(true)) {
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
     }
     end_index = index_;
   }
@@ -838,7 +1023,7 @@ Value* JSONParser::ConsumeNumber() {
       NextChar();
     if (!ReadInt(true)) {
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
     }
     end_index = index_;
   }
@@ -858,25 +1043,14 @@ Value* JSONParser::ConsumeNumber() {
       break;
     default:
       ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-      return NULL;
+      return false;
   }
 
   pos_ = exit_pos;
   index_ = exit_index;
 
-  StringPiece num_string(num_start, end_index - start_index);
-
-  int num_int;
-  if (StringToInt(num_string, &num_int))
-    return new FundamentalValue(num_int);
-
-  double num_double;
-  if (base::StringToDouble(num_string.as_string(), &num_double) &&
-      IsFinite(num_double)) {
-    return new FundamentalValue(num_double);
-  }
-
-  return NULL;
+  *num_string = StringPiece(num_start, end_index - start_index);
+  return true;
 }
 
 bool JSONParser::ReadInt(bool allow_leading_zeros) {
@@ -899,6 +1073,21 @@ bool JSONParser::ReadInt(bool allow_leading_zeros) {
 }
 
 Value* JSONParser::ConsumeLiteral() {
+  char first = *pos_;
+  if (!ConsumeLiteralRaw())
+    return NULL;
+
+  switch (first) {
+    case 't':
+      return new FundamentalValue(true);
+    case 'f':
+      return new FundamentalValue(false);
+    default:
+      return Value::CreateNullValue();
+  }
+}
+
+bool JSONParser::ConsumeLiteralRaw() {
   switch (*pos_) {
     case 't': {
       const char* kTrueLiteral = "true";
@@ -906,10 +1095,10 @@ Value* JSONParser::ConsumeLiteral() {
       if (!CanConsume(kTrueLen - 1) ||
           !StringsAreEqual(pos_, kTrueLiteral, kTrueLen)) {
         ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-        return NULL;
+        return false;
       }
       NextNChars(kTrueLen - 1);
-      return new FundamentalValue(true);
+      return true;
     }
     case 'f': {
       const char* kFalseLiteral = "false";
@@ -917,10 +1106,10 @@ Value* JSONParser::ConsumeLiteral() {
       if (!CanConsume(kFalseLen - 1) ||
           !StringsAreEqual(pos_, kFalseLiteral, kFalseLen)) {
         ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-        return NULL;
+        return false;
       }
       NextNChars(kFalseLen - 1);
-      return new FundamentalValue(false);
+      return true;
     }
     case 'n': {
       const char* kNullLiteral = "null";
@@ -928,14 +1117,14 @@ Value* JSONParser::ConsumeLiteral() {
       if (!CanConsume(kNullLen - 1) ||
           !StringsAreEqual(pos_, kNullLiteral, kNullLen)) {
         ReportError(JSONReader::JSON_SYNTAX_ERROR, 1);
-        return NULL;
+        return false;
       }
       NextNChars(kNullLen - 1);
-      return Value::CreateNullValue();
+      return true;
     }
     default:
       ReportError(JSONReader::JSON_UNEXPECTED_TOKEN, 1);
-      return NULL;
+      return false;
   }
 }
 
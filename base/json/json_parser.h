@@ -66,6 +66,12 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // result as a Value owned by the caller.
   Value* Parse(const StringPiece& input);
 
+  // Parses the input string according to the set options, reporting each
+  // value to |handler| as it is consumed. No Values are created and the input
+  // is not copied. Returns false on a parse error or if |handler| asked to
+  // stop.
+  bool ParseWithHandler(const StringPiece& input, JSONReader::Handler* handler);
+
   // Returns the error code.
   JSONReader::JsonParseError error_code() const;
 
@@ -143,6 +149,14 @@ class BASE_EXPORT_PRIVATE JSONParser {
     std::string* string_;
   };
 
+  // Resets the parser state to the beginning of |length| bytes at |start|,
+  // skipping a UTF-8 byte-order mark if there is one.
+  void StartInput(const char* start, size_t length);
+
+  // Called after the root value has been consumed. Returns false and reports
+  // an error if anything but whitespace and comments follows it.
+  bool ConsumeEndOfInput();
+
   // Quick check that the stream has capacity to consume |length| more bytes.
   bool CanConsume(int length);
 
@@ -172,6 +186,15 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // caller owns.
   Value* ParseToken(Token token);
 
+  // Streaming counterparts of ParseNextToken(), ParseToken(),
+  // ConsumeDictionary() and ConsumeList(): they report to |handler_| instead
+  // of returning Values, and return false on error or if |handler_| asked to
+  // stop.
+  bool StreamNextToken();
+  bool StreamToken(Token token);
+  bool StreamDictionary();
+  bool StreamList();
+
   // Assuming that the parser is currently wound to '{', this parses a JSON
   // object into a DictionaryValue.
   Value* ConsumeDictionary();
@@ -202,6 +225,10 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // Assuming that the parser is wound to the start of a valid JSON number,
   // this parses and converts it to either an int or double value.
   Value* ConsumeNumber();
+  // Does the work of ConsumeNumber() up to the conversion: validates the
+  // number and places its text in |num_string|. Returns false on failure with
+  // error information set.
+  bool ConsumeNumberRaw(StringPiece* num_string);
   // Helper that reads characters that are ints. Returns true if a number was
   // read and false on error.
   bool ReadInt(bool allow_leading_zeros);
@@ -209,6 +236,9 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // Consumes the literal values of |true|, |false|, and |null|, assuming the
   // parser is wound to the first character of any of those.
   Value* ConsumeLiteral();
+  // Validates and skips over the literal ConsumeLiteral() would return.
+  // Returns false on failure with error information set.
+  bool ConsumeLiteralRaw();
 
   // Compares two string buffers of a given length.
   static bool StringsAreEqual(const char* left, const char* right, size_t len);
@@ -226,6 +256,9 @@ class BASE_EXPORT_PRIVATE JSONParser {
   // base::JSONParserOptions that control parsing.
   int options_;
 
+  // Receives the values during ParseWithHandler(). Weak; NULL otherwise.
+  JSONReader::Handler* handler_;
+
   // Pointer to the start of the input data.
   const char* start_pos_;
 
@@ -0,0 +1,193 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Compares parsing a large, Preferences-like JSON document into a Value tree
+// with streaming it through a JSONReader::Handler, and with converting it
+// straight into a struct with JSONValueConverter::ConvertFromJSON().
+
+#include <string>
+
+#include "base/json/json_reader.h"
+#include "base/json/json_value_converter.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+const int kNumSites = 20000;
+const int kIterations = 5;
+
+// Builds a document roughly shaped like a profile's Preferences file: a few
+// small settings dictionaries and one long list of per-site entries.
+std::string BuildDocument() {
+  std::string json =
+      "{\"browser\": {\"window_placement\": {\"left\": 10, \"top\": 20,"
+      " \"right\": 1000, \"bottom\": 800, \"maximized\": false}},"
+      " \"profile\": {\"name\": \"Person 1\", \"avatar_index\": 26,"
+      " \"exit_type\": \"Normal\"},"
+      " \"sites\": [";
+  for (int i = 0; i < kNumSites; ++i) {
+    if (i)
+      json += ",";
+    StringAppendF(&json,
+                  "{\"origin\": \"https://www.example%d.com:443\","
+                  " \"visits\": %d, \"score\": %d.25, \"pinned\": %s,"
+                  " \"settings\": {\"cookies\": 1, \"images\": 1,"
+                  " \"popups\": 2, \"notes\": \"site \\u00e9 %d\"},"
+                  " \"history\": [%d, %d, %d, %d]}",
+                  i, i * 3, i % 100, i % 7 ? "false" : "true", i,
+                  i, i + 1, i + 2, i + 3);
+  }
+  json += "]}";
+  return json;
+}
+
+struct SiteRecord {
+  std::string origin;
+  int visits;
+  double score;
+  bool pinned;
+  int popups;
+
+  SiteRecord() : visits(0), score(0), pinned(false), popups(0) {}
+
+  static void RegisterJSONConverter(JSONValueConverter<SiteRecord>* converter) {
+    converter->RegisterStringField("origin", &SiteRecord::origin);
+    converter->RegisterIntField("visits", &SiteRecord::visits);
+    converter->RegisterDoubleField("score", &SiteRecord::score);
+    converter->RegisterBoolField("pinned", &SiteRecord::pinned);
+    converter->RegisterIntField("settings.popups", &SiteRecord::popups);
+  }
+};
+
+struct PreferencesRecord {
+  std::string profile_name;
+  ScopedVector<SiteRecord> sites;
+
+  static void RegisterJSONConverter(
+      JSONValueConverter<PreferencesRecord>* converter) {
+    converter->RegisterStringField("profile.name",
+                                   &PreferencesRecord::profile_name);
+    converter->RegisterRepeatedMessage("sites", &PreferencesRecord::sites);
+  }
+};
+
+// Accepts every event and counts them.
+class CountingHandler : public JSONReader::Handler {
+ public:
+  CountingHandler() : count_(0) {}
+
+  size_t count() const { return count_; }
+
+  virtual bool OnNull() OVERRIDE { return Count(); }
+  virtual bool OnBoolean(bool value) OVERRIDE { return Count(); }
+  virtual bool OnInteger(int value) OVERRIDE { return Count(); }
+  virtual bool OnDouble(double value) OVERRIDE { return Count(); }
+  virtual bool OnString(const StringPiece& value) OVERRIDE { return Count(); }
+  virtual bool OnDictionaryBegin() OVERRIDE { return Count(); }
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    return true;
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE { return true; }
+  virtual bool OnListBegin() OVERRIDE { return Count(); }
+  virtual bool OnListEnd() OVERRIDE { return true; }
+
+ private:
+  bool Count() {
+    ++count_;
+    return true;
+  }
+
+  size_t count_;
+};
+
+// Returns the number of Values in the tree rooted at |value|.
+size_t CountValues(const Value& value) {
+  size_t count = 1;
+  const DictionaryValue* dictionary = NULL;
+  const ListValue* list = NULL;
+  if (value.GetAsDictionary(&dictionary)) {
+    for (DictionaryValue::Iterator it(*dictionary); !it.IsAtEnd();
+         it.Advance()) {
+      count += CountValues(it.value());
+    }
+  } else if (value.GetAsList(&list)) {
+    for (ListValue::const_iterator it = list->begin(); it != list->end();
+         ++it) {
+      count += CountValues(**it);
+    }
+  }
+  return count;
+}
+
+void PrintTime(const std::string& trace, TimeDelta elapsed) {
+  perf_test::PrintResult("json_parse_time", "", trace,
+                         elapsed.InMillisecondsF() / kIterations, "ms", true);
+}
+
+}  // namespace
+
+TEST(JSONPerfTest, ParsePreferences) {
+  const std::string json = BuildDocument();
+  perf_test::PrintResult("json_input_size", "", "preferences",
+                         json.size() / 1024, "KB", true);
+
+  // Read() allocates one Value per JSON value.
+  size_t values_allocated = 0;
+  TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    scoped_ptr<Value> root(JSONReader::Read(json));
+    ASSERT_TRUE(root);
+    values_allocated = CountValues(*root);
+  }
+  PrintTime("read_to_value", TimeTicks::Now() - start);
+  perf_test::PrintResult("json_values_allocated", "", "read_to_value",
+                         values_allocated, "values", true);
+
+  // A handler sees the same values without any being allocated.
+  size_t values_seen = 0;
+  start = TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    CountingHandler handler;
+    JSONReader reader;
+    ASSERT_TRUE(reader.ReadToHandler(json, &handler));
+    values_seen = handler.count();
+  }
+  PrintTime("read_to_handler", TimeTicks::Now() - start);
+  perf_test::PrintResult("json_values_allocated", "", "read_to_handler",
+                         static_cast<size_t>(0), "values", true);
+  EXPECT_EQ(values_allocated, values_seen);
+
+  // ConvertFromJSON() only builds Values for the small dictionaries that are
+  // read through a dotted path.
+  JSONValueConverter<PreferencesRecord> converter;
+  start = TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    PreferencesRecord record;
+    ASSERT_TRUE(converter.ConvertFromJSON(json, JSON_PARSE_RFC, &record));
+    ASSERT_EQ(static_cast<size_t>(kNumSites), record.sites.size());
+    EXPECT_EQ("Person 1", record.profile_name);
+    EXPECT_EQ(2, record.sites.back()->popups);
+  }
+  PrintTime("convert_from_json", TimeTicks::Now() - start);
+
+  // For comparison, Read() followed by Convert().
+  start = TimeTicks::Now();
+  for (int i = 0; i < kIterations; ++i) {
+    scoped_ptr<Value> root(JSONReader::Read(json));
+    PreferencesRecord record;
+    ASSERT_TRUE(converter.Convert(*root, &record));
+  }
+  PrintTime("read_then_convert", TimeTicks::Now() - start);
+}
+
+}  // namespace base
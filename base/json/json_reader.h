@@ -86,6 +86,29 @@ class BASE_EXPORT JSONReader {
   static const char* kUnsupportedEncoding;
   static const char* kUnquotedDictionaryKey;
 
+  // Receives the values of a JSON document as they are parsed, in document
+  // order, instead of as a Value tree. Returning false from any method stops
+  // the parse. StringPiece arguments are only valid for the duration of the
+  // call.
+  class BASE_EXPORT Handler {
+   public:
+    virtual ~Handler() {}
+
+    virtual bool OnNull() = 0;
+    virtual bool OnBoolean(bool value) = 0;
+    virtual bool OnInteger(int value) = 0;
+    virtual bool OnDouble(double value) = 0;
+    virtual bool OnString(const StringPiece& value) = 0;
+
+    // Every key is followed by the events for exactly one value.
+    virtual bool OnDictionaryBegin() = 0;
+    virtual bool OnDictionaryKey(const StringPiece& key) = 0;
+    virtual bool OnDictionaryEnd() = 0;
+
+    virtual bool OnListBegin() = 0;
+    virtual bool OnListEnd() = 0;
+  };
+
   // Constructs a reader with the default options, JSON_PARSE_RFC.
   JSONReader();
 
@@ -119,8 +142,13 @@ class BASE_EXPORT JSONReader {
   // Parses an input string into a Value that is owned by the caller.
   Value* ReadToValue(const std::string& json);
 
-  // Returns the error code if the last call to ReadToValue() failed.
-  // Returns JSON_NO_ERROR otherwise.
+  // Parses |json|, reporting its contents to |handler| without building any
+  // Values. Returns false if the input is malformed or |handler| stopped the
+  // parse; in the latter case error_code() is JSON_NO_ERROR.
+  bool ReadToHandler(const StringPiece& json, Handler* handler);
+
+  // Returns the error code if the last call to ReadToValue() or
+  // ReadToHandler() failed. Returns JSON_NO_ERROR otherwise.
   JsonParseError error_code() const;
 
   // Converts error_code_ to a human-readable string, including line and column
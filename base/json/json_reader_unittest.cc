@@ -10,6 +10,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/path_service.h"
 #include "base/strings/string_piece.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/values.h"
 #include "build/build_config.h"
@@ -17,6 +18,56 @@
 
 namespace base {
 
+namespace {
+
+// Records the events it receives as a compact string, and optionally stops
+// the parse after a given number of them.
+class RecordingHandler : public JSONReader::Handler {
+ public:
+  RecordingHandler() : events_left_(-1) {}
+
+  void set_events_left(int events_left) { events_left_ = events_left; }
+  const std::string& events() const { return events_; }
+
+  virtual bool OnNull() OVERRIDE { return Record("null"); }
+  virtual bool OnBoolean(bool value) OVERRIDE {
+    return Record(value ? "true" : "false");
+  }
+  virtual bool OnInteger(int value) OVERRIDE {
+    return Record(StringPrintf("i%d", value));
+  }
+  virtual bool OnDouble(double value) OVERRIDE {
+    return Record(StringPrintf("d%g", value));
+  }
+  virtual bool OnString(const StringPiece& value) OVERRIDE {
+    return Record("s:" + value.as_string());
+  }
+  virtual bool OnDictionaryBegin() OVERRIDE { return Record("{"); }
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    return Record("k:" + key.as_string());
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE { return Record("}"); }
+  virtual bool OnListBegin() OVERRIDE { return Record("["); }
+  virtual bool OnListEnd() OVERRIDE { return Record("]"); }
+
+ private:
+  bool Record(const std::string& event) {
+    if (events_left_ == 0)
+      return false;
+    if (events_left_ > 0)
+      --events_left_;
+    if (!events_.empty())
+      events_ += " ";
+    events_ += event;
+    return true;
+  }
+
+  int events_left_;
+  std::string events_;
+};
+
+}  // namespace
+
 TEST(JSONReaderTest, Reading) {
   // some whitespace checking
   scoped_ptr<Value> root;
@@ -653,4 +704,65 @@ TEST(JSONReaderTest, IllegalTrailingNull) {
   EXPECT_EQ(JSONReader::JSON_UNEXPECTED_DATA_AFTER_ROOT, reader.error_code());
 }
 
+TEST(JSONReaderTest, ReadToHandler) {
+  JSONReader reader;
+  RecordingHandler handler;
+  EXPECT_TRUE(reader.ReadToHandler(
+      "{\"a\": [1, -2.5, true, false, null], \"b\": {\"c\": \"d\"},"
+      " \"e\": []}",
+      &handler));
+  EXPECT_EQ(JSONReader::JSON_NO_ERROR, reader.error_code());
+  EXPECT_EQ("{ k:a [ i1 d-2.5 true false null ] k:b { k:c s:d } k:e [ ] }",
+            handler.events());
+
+  // Scalars are valid roots.
+  RecordingHandler scalar_handler;
+  EXPECT_TRUE(reader.ReadToHandler("  42  ", &scalar_handler));
+  EXPECT_EQ("i42", scalar_handler.events());
+}
+
+TEST(JSONReaderTest, ReadToHandlerEscapes) {
+  JSONReader reader;
+  RecordingHandler handler;
+  EXPECT_TRUE(reader.ReadToHandler(
+      "[\"plain\", \"tab\\there\", \"\\u00e9\", {\"k\\\"ey\": 1}]",
+      &handler));
+  EXPECT_EQ("[ s:plain s:tab\there s:\xc3\xa9 { k:k\"ey i1 } ]",
+            handler.events());
+}
+
+TEST(JSONReaderTest, ReadToHandlerMatchesReadErrors) {
+  const char* const invalid_json[] = {
+    "/* test *",
+    "{\"foo\"",
+    "{\"foo\":",
+    "[1, 2,]",
+    "{\"a\": 1,}",
+    "[\"\\q\"]",
+    "1 2",
+    "{foo: 1}",
+  };
+
+  for (size_t i = 0; i < arraysize(invalid_json); ++i) {
+    JSONReader value_reader(JSON_PARSE_RFC);
+    EXPECT_FALSE(value_reader.ReadToValue(invalid_json[i]));
+    JSONReader handler_reader(JSON_PARSE_RFC);
+    RecordingHandler handler;
+    EXPECT_FALSE(handler_reader.ReadToHandler(invalid_json[i], &handler));
+    EXPECT_EQ(value_reader.error_code(), handler_reader.error_code())
+        << invalid_json[i];
+    EXPECT_EQ(value_reader.GetErrorMessage(),
+              handler_reader.GetErrorMessage()) << invalid_json[i];
+  }
+}
+
+TEST(JSONReaderTest, ReadToHandlerAbort) {
+  JSONReader reader;
+  RecordingHandler handler;
+  handler.set_events_left(3);
+  EXPECT_FALSE(reader.ReadToHandler("[1, 2, 3, 4]", &handler));
+  EXPECT_EQ(JSONReader::JSON_NO_ERROR, reader.error_code());
+  EXPECT_EQ("[ i1 i2", handler.events());
+}
+
 }  // namespace base
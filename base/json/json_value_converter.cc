@@ -0,0 +1,275 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/json/json_value_converter.h"
+
+#include "base/lazy_instance.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+// Accepts, and ignores, any event.
+class IgnoringHandler : public JSONReader::Handler {
+ public:
+  IgnoringHandler() {}
+
+  virtual bool OnNull() OVERRIDE { return true; }
+  virtual bool OnBoolean(bool value) OVERRIDE { return true; }
+  virtual bool OnInteger(int value) OVERRIDE { return true; }
+  virtual bool OnDouble(double value) OVERRIDE { return true; }
+  virtual bool OnString(const StringPiece& value) OVERRIDE { return true; }
+  virtual bool OnDictionaryBegin() OVERRIDE { return true; }
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE {
+    return true;
+  }
+  virtual bool OnDictionaryEnd() OVERRIDE { return true; }
+  virtual bool OnListBegin() OVERRIDE { return true; }
+  virtual bool OnListEnd() OVERRIDE { return true; }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(IgnoringHandler);
+};
+
+LazyInstance<IgnoringHandler>::Leaky g_ignoring_handler =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+JSONEvent::JSONEvent(Type type)
+    : type(type),
+      bool_value(false),
+      int_value(0),
+      double_value(0) {
+}
+
+bool JSONEvent::DispatchTo(JSONReader::Handler* handler) const {
+  switch (type) {
+    case NULL_VALUE:
+      return handler->OnNull();
+    case BOOLEAN:
+      return handler->OnBoolean(bool_value);
+    case INTEGER:
+      return handler->OnInteger(int_value);
+    case DOUBLE:
+      return handler->OnDouble(double_value);
+    case STRING:
+      return handler->OnString(string_value);
+    case DICTIONARY_BEGIN:
+      return handler->OnDictionaryBegin();
+    case DICTIONARY_KEY:
+      return handler->OnDictionaryKey(string_value);
+    case DICTIONARY_END:
+      return handler->OnDictionaryEnd();
+    case LIST_BEGIN:
+      return handler->OnListBegin();
+    case LIST_END:
+      return handler->OnListEnd();
+  }
+  NOTREACHED();
+  return false;
+}
+
+Value* JSONEvent::CreateScalarValue() const {
+  switch (type) {
+    case NULL_VALUE:
+      return Value::CreateNullValue();
+    case BOOLEAN:
+      return new FundamentalValue(bool_value);
+    case INTEGER:
+      return new FundamentalValue(int_value);
+    case DOUBLE:
+      return new FundamentalValue(double_value);
+    case STRING:
+      return new StringValue(string_value.as_string());
+    default:
+      NOTREACHED();
+      return NULL;
+  }
+}
+
+JSONEventHandler::JSONEventHandler() : delegate_(NULL), delegate_depth_(0) {
+}
+
+JSONEventHandler::~JSONEventHandler() {
+}
+
+bool JSONEventHandler::OnNull() {
+  return Route(JSONEvent(JSONEvent::NULL_VALUE));
+}
+
+bool JSONEventHandler::OnBoolean(bool value) {
+  JSONEvent event(JSONEvent::BOOLEAN);
+  event.bool_value = value;
+  return Route(event);
+}
+
+bool JSONEventHandler::OnInteger(int value) {
+  JSONEvent event(JSONEvent::INTEGER);
+  event.int_value = value;
+  return Route(event);
+}
+
+bool JSONEventHandler::OnDouble(double value) {
+  JSONEvent event(JSONEvent::DOUBLE);
+  event.double_value = value;
+  return Route(event);
+}
+
+bool JSONEventHandler::OnString(const StringPiece& value) {
+  JSONEvent event(JSONEvent::STRING);
+  event.string_value = value;
+  return Route(event);
+}
+
+bool JSONEventHandler::OnDictionaryBegin() {
+  return Route(JSONEvent(JSONEvent::DICTIONARY_BEGIN));
+}
+
+bool JSONEventHandler::OnDictionaryKey(const StringPiece& key) {
+  JSONEvent event(JSONEvent::DICTIONARY_KEY);
+  event.string_value = key;
+  return Route(event);
+}
+
+bool JSONEventHandler::OnDictionaryEnd() {
+  return Route(JSONEvent(JSONEvent::DICTIONARY_END));
+}
+
+bool JSONEventHandler::OnListBegin() {
+  return Route(JSONEvent(JSONEvent::LIST_BEGIN));
+}
+
+bool JSONEventHandler::OnListEnd() {
+  return Route(JSONEvent(JSONEvent::LIST_END));
+}
+
+bool JSONEventHandler::OnDelegateDone(JSONReader::Handler* delegate) {
+  return true;
+}
+
+bool JSONEventHandler::Delegate(const JSONEvent& event,
+                                JSONReader::Handler* delegate) {
+  DCHECK(!delegate_);
+  DCHECK(event.type != JSONEvent::DICTIONARY_KEY &&
+         event.type != JSONEvent::DICTIONARY_END &&
+         event.type != JSONEvent::LIST_END);
+  delegate_ = delegate;
+  delegate_depth_ = 0;
+  return Route(event);
+}
+
+bool JSONEventHandler::Skip(const JSONEvent& event) {
+  return Delegate(event, g_ignoring_handler.Pointer());
+}
+
+bool JSONEventHandler::Route(const JSONEvent& event) {
+  if (!delegate_)
+    return HandleEvent(event);
+
+  if (!event.DispatchTo(delegate_))
+    return false;
+  switch (event.type) {
+    case JSONEvent::DICTIONARY_BEGIN:
+    case JSONEvent::LIST_BEGIN:
+      ++delegate_depth_;
+      break;
+    case JSONEvent::DICTIONARY_END:
+    case JSONEvent::LIST_END:
+      --delegate_depth_;
+      break;
+    default:
+      break;
+  }
+  if (delegate_depth_ > 0)
+    return true;
+
+  JSONReader::Handler* delegate = delegate_;
+  delegate_ = NULL;
+  return delegate == g_ignoring_handler.Pointer() || OnDelegateDone(delegate);
+}
+
+JSONValueBuilder::JSONValueBuilder() {
+}
+
+JSONValueBuilder::~JSONValueBuilder() {
+}
+
+Value* JSONValueBuilder::Release() {
+  DCHECK(open_containers_.empty());
+  return root_.release();
+}
+
+bool JSONValueBuilder::OnNull() {
+  Add(Value::CreateNullValue());
+  return true;
+}
+
+bool JSONValueBuilder::OnBoolean(bool value) {
+  Add(new FundamentalValue(value));
+  return true;
+}
+
+bool JSONValueBuilder::OnInteger(int value) {
+  Add(new FundamentalValue(value));
+  return true;
+}
+
+bool JSONValueBuilder::OnDouble(double value) {
+  Add(new FundamentalValue(value));
+  return true;
+}
+
+bool JSONValueBuilder::OnString(const StringPiece& value) {
+  Add(new StringValue(value.as_string()));
+  return true;
+}
+
+bool JSONValueBuilder::OnDictionaryBegin() {
+  DictionaryValue* dictionary = new DictionaryValue;
+  Add(dictionary);
+  open_containers_.push_back(dictionary);
+  return true;
+}
+
+bool JSONValueBuilder::OnDictionaryKey(const StringPiece& key) {
+  key.CopyToString(&key_);
+  return true;
+}
+
+bool JSONValueBuilder::OnDictionaryEnd() {
+  open_containers_.pop_back();
+  return true;
+}
+
+bool JSONValueBuilder::OnListBegin() {
+  ListValue* list = new ListValue;
+  Add(list);
+  open_containers_.push_back(list);
+  return true;
+}
+
+bool JSONValueBuilder::OnListEnd() {
+  open_containers_.pop_back();
+  return true;
+}
+
+void JSONValueBuilder::Add(Value* value) {
+  if (open_containers_.empty()) {
+    DCHECK(!root_);
+    root_.reset(value);
+    return;
+  }
+  Value* container = open_containers_.back();
+  if (container->IsType(Value::TYPE_DICTIONARY)) {
+    static_cast<DictionaryValue*>(container)->SetWithoutPathExpansion(key_,
+                                                                      value);
+  } else {
+    static_cast<ListValue*>(container)->Append(value);
+  }
+}
+
+}  // namespace internal
+}  // namespace base
@@ -8,7 +8,9 @@
 #include <string>
 #include <vector>
 
+#include "base/base_export.h"
 #include "base/basictypes.h"
+#include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
@@ -82,6 +84,14 @@
 //           "your_enum", &Message::ye, &ConvertFunc);
 //     }
 //   };
+//
+// If the input is JSON text rather than a Value, ConvertFromJSON() converts it
+// straight into the struct as it is parsed, without building a Value tree.
+// Keys with no registered field are skipped without allocating anything.
+// Nested and repeated message fields are streamed into as well; any other
+// field that holds a dictionary or list gets a Value built for that field
+// only.
+//   converter.ConvertFromJSON(json_text, base::JSON_PARSE_RFC, &message);
 
 namespace base {
 
@@ -90,6 +100,123 @@ class JSONValueConverter;
 
 namespace internal {
 
+// A single parse event, as reported to a JSONReader::Handler.
+struct BASE_EXPORT JSONEvent {
+  enum Type {
+    NULL_VALUE,
+    BOOLEAN,
+    INTEGER,
+    DOUBLE,
+    STRING,
+    DICTIONARY_BEGIN,
+    DICTIONARY_KEY,
+    DICTIONARY_END,
+    LIST_BEGIN,
+    LIST_END,
+  };
+
+  explicit JSONEvent(Type type);
+
+  // True for events that are a complete value on their own.
+  bool IsScalar() const { return type <= STRING; }
+
+  // Calls the method of |handler| that corresponds to this event.
+  bool DispatchTo(JSONReader::Handler* handler) const;
+
+  // Returns a Value for a scalar event. The caller owns the result.
+  Value* CreateScalarValue() const;
+
+  Type type;
+  bool bool_value;
+  int int_value;
+  double double_value;
+  // Used by STRING and DICTIONARY_KEY.
+  StringPiece string_value;
+};
+
+// Base class for the handlers behind JSONValueConverter::ConvertFromJSON().
+// Events arrive in HandleEvent(); a subclass can hand all the events of the
+// value that starts with the current event to another handler, and is told
+// when that value is complete.
+class BASE_EXPORT JSONEventHandler : public JSONReader::Handler {
+ public:
+  JSONEventHandler();
+  virtual ~JSONEventHandler();
+
+  // JSONReader::Handler:
+  virtual bool OnNull() OVERRIDE;
+  virtual bool OnBoolean(bool value) OVERRIDE;
+  virtual bool OnInteger(int value) OVERRIDE;
+  virtual bool OnDouble(double value) OVERRIDE;
+  virtual bool OnString(const StringPiece& value) OVERRIDE;
+  virtual bool OnDictionaryBegin() OVERRIDE;
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE;
+  virtual bool OnDictionaryEnd() OVERRIDE;
+  virtual bool OnListBegin() OVERRIDE;
+  virtual bool OnListEnd() OVERRIDE;
+
+ protected:
+  // Receives every event that is not routed to a delegate.
+  virtual bool HandleEvent(const JSONEvent& event) = 0;
+
+  // Called once the value routed to |delegate| is complete.
+  virtual bool OnDelegateDone(JSONReader::Handler* delegate);
+
+  // Routes |event|, which must start a value, and every following event up to
+  // the end of that value to |delegate|.
+  bool Delegate(const JSONEvent& event, JSONReader::Handler* delegate);
+
+  // Drops |event|, which must start a value, and the rest of that value.
+  bool Skip(const JSONEvent& event);
+
+ private:
+  bool Route(const JSONEvent& event);
+
+  // Weak. Non-NULL while a value is being routed elsewhere.
+  JSONReader::Handler* delegate_;
+  // How many dictionaries and lists are open in the value routed to
+  // |delegate_|.
+  int delegate_depth_;
+
+  DISALLOW_COPY_AND_ASSIGN(JSONEventHandler);
+};
+
+// Builds a Value out of the events for one JSON value.
+class BASE_EXPORT JSONValueBuilder : public JSONReader::Handler {
+ public:
+  JSONValueBuilder();
+  virtual ~JSONValueBuilder();
+
+  // Returns the value built so far and readies the builder for another one.
+  // The caller owns the result.
+  Value* Release();
+
+  // JSONReader::Handler:
+  virtual bool OnNull() OVERRIDE;
+  virtual bool OnBoolean(bool value) OVERRIDE;
+  virtual bool OnInteger(int value) OVERRIDE;
+  virtual bool OnDouble(double value) OVERRIDE;
+  virtual bool OnString(const StringPiece& value) OVERRIDE;
+  virtual bool OnDictionaryBegin() OVERRIDE;
+  virtual bool OnDictionaryKey(const StringPiece& key) OVERRIDE;
+  virtual bool OnDictionaryEnd() OVERRIDE;
+  virtual bool OnListBegin() OVERRIDE;
+  virtual bool OnListEnd() OVERRIDE;
+
+ private:
+  // Adds |value| to the innermost open container, or makes it the root.
+  // Takes ownership of |value|.
+  void Add(Value* value);
+
+  scoped_ptr<Value> root_;
+  // The open dictionaries and lists, innermost last. Owned by |root_|.
+  std::vector<Value*> open_containers_;
+  // The key for the next value added to a dictionary.
+  std::string key_;
+
+  DISALLOW_COPY_AND_ASSIGN(JSONValueBuilder);
+};
+
 template<typename StructType>
 class FieldConverterBase {
  public:
@@ -97,6 +224,12 @@ class FieldConverterBase {
   virtual ~FieldConverterBase() {}
   virtual bool ConvertField(const base::Value& value, StructType* obj)
       const = 0;
+  // Returns a handler that converts a dictionary or list straight into the
+  // field of |obj|, or NULL if the field can only be converted from a Value.
+  // The caller owns the result.
+  virtual JSONReader::Handler* CreateFieldHandler(StructType* obj) const {
+    return NULL;
+  }
   const std::string& field_path() const { return field_path_; }
 
  private:
@@ -109,6 +242,10 @@ class ValueConverter {
  public:
   virtual ~ValueConverter() {}
   virtual bool Convert(const base::Value& value, FieldType* field) const = 0;
+  // See FieldConverterBase::CreateFieldHandler().
+  virtual JSONReader::Handler* CreateHandler(FieldType* field) const {
+    return NULL;
+  }
 };
 
 template <typename StructType, typename FieldType>
@@ -127,12 +264,202 @@ class FieldConverter : public FieldConverterBase<StructType> {
     return value_converter_->Convert(value, &(dst->*field_pointer_));
   }
 
+  virtual JSONReader::Handler* CreateFieldHandler(
+      StructType* dst) const OVERRIDE {
+    return value_converter_->CreateHandler(&(dst->*field_pointer_));
+  }
+
  private:
   FieldType StructType::* field_pointer_;
   scoped_ptr<ValueConverter<FieldType> > value_converter_;
   DISALLOW_COPY_AND_ASSIGN(FieldConverter);
 };
 
+// Converts the events for one JSON dictionary straight into a StructType.
+template <typename StructType>
+class StructHandler : public JSONEventHandler {
+ public:
+  StructHandler(const JSONValueConverter<StructType>* converter,
+                StructType* output)
+      : converter_(converter),
+        output_(output),
+        state_(BEFORE_DICTIONARY),
+        key_length_(0) {
+  }
+
+  // Readies the handler for another dictionary, to be converted into
+  // |output|.
+  void Reset(StructType* output) {
+    output_ = output;
+    state_ = BEFORE_DICTIONARY;
+  }
+
+  // True once the whole dictionary has been converted.
+  bool done() const { return state_ == DONE; }
+
+ protected:
+  virtual bool HandleEvent(const JSONEvent& event) OVERRIDE {
+    switch (state_) {
+      case BEFORE_DICTIONARY:
+        if (event.type != JSONEvent::DICTIONARY_BEGIN)
+          return false;
+        state_ = IN_DICTIONARY;
+        return true;
+      case DONE:
+        return false;
+      case IN_DICTIONARY:
+        break;
+    }
+
+    if (event.type == JSONEvent::DICTIONARY_END) {
+      state_ = DONE;
+      return true;
+    }
+    if (event.type == JSONEvent::DICTIONARY_KEY) {
+      MatchFields(event.string_value);
+      return true;
+    }
+
+    // |event| starts the value for the last key.
+    if (fields_.empty())
+      return Skip(event);
+    if (fields_.size() == 1 &&
+        fields_[0]->field_path().size() == key_length_) {
+      const FieldConverterBase<StructType>* field = fields_[0];
+      if (event.IsScalar()) {
+        scoped_ptr<Value> value(event.CreateScalarValue());
+        if (!field->ConvertField(*value, output_)) {
+          DVLOG(1) << "failure at field " << field->field_path();
+          return false;
+        }
+        return true;
+      }
+      field_handler_.reset(field->CreateFieldHandler(output_));
+      if (field_handler_)
+        return Delegate(event, field_handler_.get());
+    }
+    return Delegate(event, &builder_);
+  }
+
+  virtual bool OnDelegateDone(JSONReader::Handler* delegate) OVERRIDE {
+    if (delegate != &builder_) {
+      field_handler_.reset();
+      return true;
+    }
+
+    // Convert every field under the last key from the Value just built.
+    scoped_ptr<Value> value(builder_.Release());
+    for (size_t i = 0; i < fields_.size(); ++i) {
+      const FieldConverterBase<StructType>* field = fields_[i];
+      const Value* field_value = value.get();
+      if (field->field_path().size() != key_length_) {
+        const DictionaryValue* dictionary = NULL;
+        if (!value->GetAsDictionary(&dictionary) ||
+            !dictionary->Get(field->field_path().substr(key_length_ + 1),
+                             &field_value)) {
+          continue;
+        }
+      }
+      if (!field->ConvertField(*field_value, output_)) {
+        DVLOG(1) << "failure at field " << field->field_path();
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  enum State {
+    BEFORE_DICTIONARY,
+    IN_DICTIONARY,
+    DONE,
+  };
+
+  // Collects the fields whose path is |key|, or starts with |key| followed
+  // by a '.'.
+  void MatchFields(const StringPiece& key) {
+    fields_.clear();
+    key_length_ = key.size();
+    const ScopedVector<FieldConverterBase<StructType> >& all_fields =
+        converter_->fields_;
+    for (size_t i = 0; i < all_fields.size(); ++i) {
+      const std::string& path = all_fields[i]->field_path();
+      if (path.size() >= key.size() &&
+          path.compare(0, key.size(), key.data(), key.size()) == 0 &&
+          (path.size() == key.size() || path[key.size()] == '.')) {
+        fields_.push_back(all_fields[i]);
+      }
+    }
+  }
+
+  const JSONValueConverter<StructType>* converter_;
+  StructType* output_;
+  State state_;
+
+  // The fields under the last key, and that key's length.
+  std::vector<const FieldConverterBase<StructType>*> fields_;
+  size_t key_length_;
+
+  // Converts the current dictionary or list value of a field, if it
+  // supports that.
+  scoped_ptr<JSONReader::Handler> field_handler_;
+
+  // Builds a Value for the current value when it cannot be streamed.
+  JSONValueBuilder builder_;
+
+  DISALLOW_COPY_AND_ASSIGN(StructHandler);
+};
+
+// Converts the events for a JSON list of dictionaries straight into a
+// ScopedVector<NestedType>.
+template <typename NestedType>
+class RepeatedMessageHandler : public JSONEventHandler {
+ public:
+  RepeatedMessageHandler(const JSONValueConverter<NestedType>* converter,
+                         ScopedVector<NestedType>* field)
+      : converter_(converter),
+        field_(field),
+        started_(false) {
+  }
+
+ protected:
+  virtual bool HandleEvent(const JSONEvent& event) OVERRIDE {
+    if (!started_) {
+      started_ = true;
+      return event.type == JSONEvent::LIST_BEGIN;
+    }
+    if (event.type == JSONEvent::LIST_END)
+      return true;
+    if (event.type != JSONEvent::DICTIONARY_BEGIN)
+      return false;
+
+    element_.reset(new NestedType);
+    if (element_handler_) {
+      element_handler_->Reset(element_.get());
+    } else {
+      element_handler_.reset(
+          new StructHandler<NestedType>(converter_, element_.get()));
+    }
+    return Delegate(event, element_handler_.get());
+  }
+
+  virtual bool OnDelegateDone(JSONReader::Handler* delegate) OVERRIDE {
+    field_->push_back(element_.release());
+    return true;
+  }
+
+ private:
+  const JSONValueConverter<NestedType>* converter_;
+  ScopedVector<NestedType>* field_;
+  bool started_;
+
+  // The element being converted, and the handler converting it.
+  scoped_ptr<NestedType> element_;
+  scoped_ptr<StructHandler<NestedType> > element_handler_;
+
+  DISALLOW_COPY_AND_ASSIGN(RepeatedMessageHandler);
+};
+
 template <typename FieldType>
 class BasicValueConverter;
 
@@ -253,6 +580,11 @@ class NestedValueConverter : public ValueConverter<NestedType> {
     return converter_.Convert(value, field);
   }
 
+  virtual JSONReader::Handler* CreateHandler(
+      NestedType* field) const OVERRIDE {
+    return converter_.CreateHandler(field);
+  }
+
  private:
   JSONValueConverter<NestedType> converter_;
   DISALLOW_COPY_AND_ASSIGN(NestedValueConverter);
@@ -322,6 +654,11 @@ class RepeatedMessageConverter
     return true;
   }
 
+  virtual JSONReader::Handler* CreateHandler(
+      ScopedVector<NestedType>* field) const OVERRIDE {
+    return new RepeatedMessageHandler<NestedType>(&converter_, field);
+  }
+
  private:
   JSONValueConverter<NestedType> converter_;
   DISALLOW_COPY_AND_ASSIGN(RepeatedMessageConverter);
@@ -516,7 +853,27 @@ class JSONValueConverter {
     return true;
   }
 
+  // Parses |json| with the given JSONParserOptions and converts it into
+  // |output| as it goes, without building a Value tree. Returns false if the
+  // input is malformed or any field fails to convert. Like Convert(), may
+  // modify |output| even when it fails.
+  bool ConvertFromJSON(const StringPiece& json,
+                       int options,
+                       StructType* output) const {
+    internal::StructHandler<StructType> handler(this, output);
+    JSONReader reader(options);
+    return reader.ReadToHandler(json, &handler) && handler.done();
+  }
+
+  // Returns a handler that converts the events for one JSON dictionary into
+  // |output|. The caller owns the result.
+  JSONReader::Handler* CreateHandler(StructType* output) const {
+    return new internal::StructHandler<StructType>(this, output);
+  }
+
  private:
+  friend class internal::StructHandler<StructType>;
+
   ScopedVector<internal::FieldConverterBase<StructType> > fields_;
 
   DISALLOW_COPY_AND_ASSIGN(JSONValueConverter);
@@ -253,4 +253,97 @@ TEST(JSONValueConverterTest, RepeatedValueErrorInTheMiddle) {
   // No check the values as mentioned above.
 }
 
+TEST(JSONValueConverterTest, ConvertFromJSON) {
+  const char data[] =
+      "{\n"
+      "  \"foo\": 1.0,\n"
+      "  \"unknown\": {\"deeply\": [{\"nested\": [1, 2, 3]}]},\n"
+      "  \"child\": {\n"
+      "    \"foo\": 1,\n"
+      "    \"bar\": \"bar\",\n"
+      "    \"bstruct\": {},\n"
+      "    \"string_values\": [{\"val\": \"value_1\"}],\n"
+      "    \"ints\": [1, 2]\n"
+      "  },\n"
+      "  \"children\": [{\"foo\": 2, \"simple_enum\": \"bar\"},\n"
+      "                 {\"foo\": 3, \"baz\": true}]\n"
+      "}\n";
+
+  NestedMessage message;
+  base::JSONValueConverter<NestedMessage> converter;
+  EXPECT_TRUE(converter.ConvertFromJSON(data, JSON_PARSE_RFC, &message));
+
+  EXPECT_EQ(1.0, message.foo);
+  EXPECT_EQ(1, message.child.foo);
+  EXPECT_EQ("bar", message.child.bar);
+  EXPECT_TRUE(message.child.bstruct);
+  ASSERT_EQ(1U, message.child.string_values.size());
+  EXPECT_EQ("value_1", *message.child.string_values[0]);
+  ASSERT_EQ(2U, message.child.ints.size());
+  EXPECT_EQ(2, *message.child.ints[1]);
+
+  ASSERT_EQ(2U, message.children.size());
+  EXPECT_EQ(2, message.children[0]->foo);
+  EXPECT_EQ(SimpleMessage::BAR, message.children[0]->simple_enum);
+  EXPECT_FALSE(message.children[0]->baz);
+  EXPECT_EQ(3, message.children[1]->foo);
+  EXPECT_TRUE(message.children[1]->baz);
+}
+
+namespace {
+
+// For fields registered under a dotted path.
+struct PathMessage {
+  int depth;
+  std::string name;
+
+  PathMessage() : depth(0) {}
+
+  static void RegisterJSONConverter(
+      base::JSONValueConverter<PathMessage>* converter) {
+    converter->RegisterIntField("a.b.depth", &PathMessage::depth);
+    converter->RegisterStringField("a.name", &PathMessage::name);
+  }
+};
+
+}  // namespace
+
+TEST(JSONValueConverterTest, ConvertFromJSONWithPaths) {
+  const char data[] =
+      "{\"a\": {\"name\": \"x\", \"b\": {\"depth\": 2}}, \"b\": 1}";
+
+  base::JSONValueConverter<PathMessage> converter;
+  PathMessage streamed;
+  EXPECT_TRUE(converter.ConvertFromJSON(data, JSON_PARSE_RFC, &streamed));
+  EXPECT_EQ(2, streamed.depth);
+  EXPECT_EQ("x", streamed.name);
+
+  scoped_ptr<Value> value(base::JSONReader::Read(data));
+  PathMessage converted;
+  EXPECT_TRUE(converter.Convert(*value.get(), &converted));
+  EXPECT_EQ(converted.depth, streamed.depth);
+  EXPECT_EQ(converted.name, streamed.name);
+}
+
+TEST(JSONValueConverterTest, ConvertFromJSONFails) {
+  base::JSONValueConverter<NestedMessage> converter;
+  const char* const bad_data[] = {
+    // Malformed JSON.
+    "{\"foo\": 1",
+    // The root is not a dictionary.
+    "[1, 2]",
+    // A field of the wrong type.
+    "{\"child\": {\"foo\": \"one\"}}",
+    // A repeated message with an element that is not a dictionary.
+    "{\"children\": [{\"foo\": 1}, 2]}",
+    // A failing custom field inside a repeated message.
+    "{\"children\": [{\"simple_enum\": \"baz\"}]}",
+  };
+  for (size_t i = 0; i < arraysize(bad_data); ++i) {
+    NestedMessage message;
+    EXPECT_FALSE(converter.ConvertFromJSON(bad_data[i], JSON_PARSE_RFC,
+                                           &message)) << bad_data[i];
+  }
+}
+
 }  // namespace base
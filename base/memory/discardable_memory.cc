@@ -6,6 +6,7 @@
 
 #include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/memory/discardable_memory_emulated.h"
 
 namespace base {
 namespace {
@@ -83,4 +84,9 @@ scoped_ptr<DiscardableMemory> DiscardableMemory::CreateLockedMemory(
   return CreateLockedMemoryWithType(GetPreferredType(), size);
 }
 
+// static
+void DiscardableMemory::SetEmulatedMemoryLimit(size_t bytes) {
+  internal::DiscardableMemoryEmulated::SetMemoryLimit(bytes);
+}
+
 }  // namespace base
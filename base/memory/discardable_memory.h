@@ -72,6 +72,12 @@ class BASE_EXPORT DiscardableMemory {
   // to memory pressure signals.
   static void UnregisterMemoryPressureListeners();
 
+  // Sets how many bytes of DISCARDABLE_MEMORY_TYPE_EMULATED memory this process
+  // may keep before the least recently used unlocked memory is purged. Lets an
+  // embedder balance the budgets of several processes; memory above a lowered
+  // limit is purged right away.
+  static void SetEmulatedMemoryLimit(size_t bytes);
+
   // Gets the discardable memory type with a given name.
   static DiscardableMemoryType GetNamedType(const std::string& name);
 
@@ -39,6 +39,13 @@ void DiscardableMemoryEmulated::UnregisterMemoryPressureListeners() {
   g_provider.Pointer()->UnregisterMemoryPressureListener();
 }
 
+// static
+void DiscardableMemoryEmulated::SetMemoryLimit(size_t bytes) {
+  // Keep the moderate pressure response proportional to the limit.
+  g_provider.Pointer()->SetBytesToReclaimUnderModeratePressure(3 * bytes / 4);
+  g_provider.Pointer()->SetDiscardableMemoryLimit(bytes);
+}
+
 // static
 void DiscardableMemoryEmulated::PurgeForTesting() {
   g_provider.Pointer()->PurgeAll();
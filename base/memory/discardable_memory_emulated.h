@@ -17,6 +17,7 @@ class DiscardableMemoryEmulated : public DiscardableMemory {
 
   static void RegisterMemoryPressureListeners();
   static void UnregisterMemoryPressureListeners();
+  static void SetMemoryLimit(size_t bytes);
 
   static void PurgeForTesting();
 
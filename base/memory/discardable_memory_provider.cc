@@ -8,6 +8,7 @@
 #include "base/containers/hash_tables.h"
 #include "base/containers/mru_cache.h"
 #include "base/debug/trace_event.h"
+#include "base/metrics/histogram.h"
 #include "base/synchronization/lock.h"
 #include "base/sys_info.h"
 
@@ -209,6 +210,7 @@ void DiscardableMemoryProvider::PurgeLRUWithLockAcquiredUntilUsageIsWithin(
 
   lock_.AssertAcquired();
 
+  const size_t bytes_allocated_before_purge = bytes_allocated_;
   for (AllocationMap::reverse_iterator it = allocations_.rbegin();
        it != allocations_.rend();
        ++it) {
@@ -223,6 +225,12 @@ void DiscardableMemoryProvider::PurgeLRUWithLockAcquiredUntilUsageIsWithin(
     free(it->second.memory);
     it->second.memory = NULL;
   }
+
+  if (bytes_allocated_ < bytes_allocated_before_purge) {
+    UMA_HISTOGRAM_MEMORY_KB(
+        "Memory.DiscardableMemoryPurged",
+        (bytes_allocated_before_purge - bytes_allocated_) / 1024);
+  }
 }
 
 void DiscardableMemoryProvider::EnforcePolicyWithLockAcquired() {
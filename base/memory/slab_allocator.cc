@@ -0,0 +1,387 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/slab_allocator.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/format_macros.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
+#include "base/third_party/dynamic_annotations/dynamic_annotations.h"
+#include "base/threading/thread_local_storage.h"
+
+namespace base {
+
+namespace {
+
+const size_t kNumSizeClasses =
+    SlabAllocator::kMaxBlockSize / SlabAllocator::kSizeClassGranularity;
+
+// Slabs hold a whole number of batches and are about this big, unless a
+// single batch is bigger.
+const size_t kTargetSlabSize = 64 * 1024;
+
+// A thread cache gives a batch back once it holds this many free blocks of a
+// size class, so that it is left with kBatchSize of them.
+const int kMaxCachedBlocks = 2 * SlabAllocator::kBatchSize;
+
+// The counters of a thread cache are added to the central ones after this
+// many operations.
+const int kStatsFlushInterval = 256;
+
+// Free blocks are chained through their first word.  The first block of a
+// batch in a central free list also chains the batches.
+struct FreeBlock {
+  FreeBlock* next;
+  FreeBlock* next_batch;
+};
+
+COMPILE_ASSERT(sizeof(FreeBlock) <= SlabAllocator::kSizeClassGranularity,
+               free_block_must_fit_in_the_smallest_size_class);
+
+struct SizeClass {
+  SizeClass()
+      : block_size(0),
+        batches(NULL),
+        partial_batch(NULL),
+        partial_batch_length(0),
+        free_batches(0),
+        allocations(0),
+        frees(0),
+        batch_transfers(0),
+        slab_bytes(0) {
+  }
+
+  size_t block_size;
+
+  Lock lock;
+  // Full batches of kBatchSize free blocks.
+  FreeBlock* batches;
+  // The blocks of exiting threads, one at a time, until they make a batch.
+  FreeBlock* partial_batch;
+  int partial_batch_length;
+  int free_batches;
+  int64 allocations;
+  int64 frees;
+  int64 batch_transfers;
+  size_t slab_bytes;
+};
+
+struct ThreadFreeList {
+  FreeBlock* head;
+  int length;
+  int allocations;
+  int frees;
+};
+
+struct ThreadCache {
+  ThreadCache() {
+    memset(lists, 0, sizeof(lists));
+  }
+
+  ThreadFreeList lists[kNumSizeClasses];
+};
+
+void OnThreadExit(void* value);
+
+bool ShouldUseSlabs() {
+#if defined(ADDRESS_SANITIZER) || defined(MEMORY_SANITIZER)
+  return false;
+#else
+  return !RunningOnValgrind();
+#endif
+}
+
+class SlabHeap {
+ public:
+  SlabHeap()
+      : thread_cache_(&OnThreadExit),
+        enabled_(ShouldUseSlabs()) {
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      size_classes_[i].block_size =
+          (i + 1) * SlabAllocator::kSizeClassGranularity;
+    }
+  }
+
+  bool enabled() const { return enabled_; }
+
+  void* Allocate(size_t index) {
+    ThreadFreeList* list = &GetThreadCache()->lists[index];
+    if (!list->head)
+      Refill(index, list);
+    FreeBlock* block = list->head;
+    list->head = block->next;
+    list->length--;
+    if (++list->allocations + list->frees >= kStatsFlushInterval)
+      FlushStats(index, list);
+    return block;
+  }
+
+  void Free(void* ptr, size_t index) {
+    ThreadFreeList* list = &GetThreadCache()->lists[index];
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = list->head;
+    list->head = block;
+    list->length++;
+    list->frees++;
+    if (list->length >= kMaxCachedBlocks)
+      ReleaseBatch(index, list);
+    else if (list->allocations + list->frees >= kStatsFlushInterval)
+      FlushStats(index, list);
+  }
+
+  // Returns every block of |cache| to the central free lists.
+  void ReleaseThreadCache(ThreadCache* cache) {
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      ThreadFreeList* list = &cache->lists[i];
+      SizeClass* size_class = &size_classes_[i];
+      AutoLock lock(size_class->lock);
+      while (list->head) {
+        FreeBlock* block = list->head;
+        list->head = block->next;
+        block->next = size_class->partial_batch;
+        size_class->partial_batch = block;
+        if (++size_class->partial_batch_length == SlabAllocator::kBatchSize) {
+          size_class->partial_batch->next_batch = size_class->batches;
+          size_class->batches = size_class->partial_batch;
+          size_class->free_batches++;
+          size_class->partial_batch = NULL;
+          size_class->partial_batch_length = 0;
+        }
+      }
+      list->length = 0;
+      FlushStatsLocked(size_class, list);
+    }
+  }
+
+  ThreadCache* current_thread_cache() const {
+    return static_cast<ThreadCache*>(thread_cache_.Get());
+  }
+
+  SlabAllocator::SizeClassStats GetStats(size_t index) {
+    SizeClass* size_class = &size_classes_[index];
+    SlabAllocator::SizeClassStats stats;
+    stats.block_size = size_class->block_size;
+    AutoLock lock(size_class->lock);
+    stats.allocations = size_class->allocations;
+    stats.frees = size_class->frees;
+    stats.batch_transfers = size_class->batch_transfers;
+    stats.slab_bytes = size_class->slab_bytes;
+    stats.central_free_bytes =
+        (size_class->free_batches * SlabAllocator::kBatchSize +
+         size_class->partial_batch_length) * size_class->block_size;
+    return stats;
+  }
+
+ private:
+  ThreadCache* GetThreadCache() {
+    ThreadCache* cache = current_thread_cache();
+    if (!cache) {
+      cache = new ThreadCache;
+      thread_cache_.Set(cache);
+    }
+    return cache;
+  }
+
+  // Moves a batch from the central free list to the empty |list|.
+  void Refill(size_t index, ThreadFreeList* list) {
+    DCHECK(!list->head);
+    SizeClass* size_class = &size_classes_[index];
+    AutoLock lock(size_class->lock);
+    if (!size_class->batches && size_class->partial_batch) {
+      list->head = size_class->partial_batch;
+      list->length = size_class->partial_batch_length;
+      size_class->partial_batch = NULL;
+      size_class->partial_batch_length = 0;
+    } else {
+      if (!size_class->batches)
+        AddSlab(size_class);
+      list->head = size_class->batches;
+      list->length = SlabAllocator::kBatchSize;
+      size_class->batches = size_class->batches->next_batch;
+      size_class->free_batches--;
+    }
+    size_class->batch_transfers++;
+    FlushStatsLocked(size_class, list);
+  }
+
+  // Moves kBatchSize blocks from |list| to the central free list.
+  void ReleaseBatch(size_t index, ThreadFreeList* list) {
+    DCHECK_GE(list->length, SlabAllocator::kBatchSize);
+    FreeBlock* batch = list->head;
+    FreeBlock* last = batch;
+    for (int i = 1; i < SlabAllocator::kBatchSize; ++i)
+      last = last->next;
+    list->head = last->next;
+    list->length -= SlabAllocator::kBatchSize;
+    last->next = NULL;
+
+    SizeClass* size_class = &size_classes_[index];
+    AutoLock lock(size_class->lock);
+    batch->next_batch = size_class->batches;
+    size_class->batches = batch;
+    size_class->free_batches++;
+    size_class->batch_transfers++;
+    FlushStatsLocked(size_class, list);
+  }
+
+  void FlushStats(size_t index, ThreadFreeList* list) {
+    SizeClass* size_class = &size_classes_[index];
+    AutoLock lock(size_class->lock);
+    FlushStatsLocked(size_class, list);
+  }
+
+  void FlushStatsLocked(SizeClass* size_class, ThreadFreeList* list) {
+    size_class->lock.AssertAcquired();
+    size_class->allocations += list->allocations;
+    size_class->frees += list->frees;
+    list->allocations = 0;
+    list->frees = 0;
+  }
+
+  // Carves a new slab into batches of free blocks.
+  void AddSlab(SizeClass* size_class) {
+    size_class->lock.AssertAcquired();
+    const size_t batch_bytes =
+        size_class->block_size * SlabAllocator::kBatchSize;
+    const size_t num_batches = std::max<size_t>(1,
+                                                kTargetSlabSize / batch_bytes);
+    char* slab = new char[num_batches * batch_bytes];
+    for (size_t i = 0; i < num_batches; ++i) {
+      char* batch = slab + i * batch_bytes;
+      for (int j = 0; j < SlabAllocator::kBatchSize; ++j) {
+        FreeBlock* block =
+            reinterpret_cast<FreeBlock*>(batch + j * size_class->block_size);
+        block->next = j + 1 < SlabAllocator::kBatchSize ?
+            reinterpret_cast<FreeBlock*>(batch +
+                                         (j + 1) * size_class->block_size) :
+            NULL;
+      }
+      FreeBlock* head = reinterpret_cast<FreeBlock*>(batch);
+      head->next_batch = size_class->batches;
+      size_class->batches = head;
+    }
+    size_class->free_batches += num_batches;
+    size_class->slab_bytes += num_batches * batch_bytes;
+  }
+
+  ThreadLocalStorage::Slot thread_cache_;
+  const bool enabled_;
+  SizeClass size_classes_[kNumSizeClasses];
+
+  DISALLOW_COPY_AND_ASSIGN(SlabHeap);
+};
+
+LazyInstance<SlabHeap>::Leaky g_slab_heap = LAZY_INSTANCE_INITIALIZER;
+
+void OnThreadExit(void* value) {
+  ThreadCache* cache = static_cast<ThreadCache*>(value);
+  g_slab_heap.Get().ReleaseThreadCache(cache);
+  delete cache;
+}
+
+size_t SizeClassIndex(size_t size) {
+  DCHECK_LE(size, SlabAllocator::kMaxBlockSize);
+  if (size == 0)
+    return 0;
+  return (size - 1) / SlabAllocator::kSizeClassGranularity;
+}
+
+}  // namespace
+
+const size_t SlabAllocator::kSizeClassGranularity;
+const size_t SlabAllocator::kMaxBlockSize;
+const int SlabAllocator::kBatchSize;
+
+SlabAllocator::SizeClassStats::SizeClassStats()
+    : block_size(0),
+      allocations(0),
+      frees(0),
+      batch_transfers(0),
+      slab_bytes(0),
+      central_free_bytes(0) {
+}
+
+// static
+bool SlabAllocator::IsEnabled() {
+  return g_slab_heap.Get().enabled();
+}
+
+// static
+void* SlabAllocator::Allocate(size_t size) {
+  SlabHeap* heap = g_slab_heap.Pointer();
+  if (size > kMaxBlockSize || !heap->enabled())
+    return ::operator new(size);
+  return heap->Allocate(SizeClassIndex(size));
+}
+
+// static
+void SlabAllocator::Free(void* ptr, size_t size) {
+  if (!ptr)
+    return;
+  SlabHeap* heap = g_slab_heap.Pointer();
+  if (size > kMaxBlockSize || !heap->enabled()) {
+    ::operator delete(ptr);
+    return;
+  }
+  heap->Free(ptr, SizeClassIndex(size));
+}
+
+// static
+SlabAllocator::SizeClassStats SlabAllocator::GetSizeClassStats(size_t size) {
+  return g_slab_heap.Get().GetStats(SizeClassIndex(size));
+}
+
+// static
+void SlabAllocator::AppendStats(std::string* output) {
+  SlabHeap* heap = g_slab_heap.Pointer();
+  if (!heap->enabled())
+    return;
+  output->append("------------------------------------------------\n");
+  output->append("Slab allocator\n");
+  output->append("------------------------------------------------\n");
+  StringAppendF(output, "%6s %12s %12s %10s %10s %10s\n", "size", "allocs",
+                "frees", "transfers", "slab", "free");
+  size_t total_slab_bytes = 0;
+  size_t total_free_bytes = 0;
+  for (size_t i = 0; i < kNumSizeClasses; ++i) {
+    SizeClassStats stats = heap->GetStats(i);
+    if (!stats.slab_bytes)
+      continue;
+    StringAppendF(output,
+                  "%6" PRIuS " %12" PRId64 " %12" PRId64 " %10" PRId64
+                  " %10" PRIuS " %10" PRIuS "\n",
+                  stats.block_size, stats.allocations, stats.frees,
+                  stats.batch_transfers, stats.slab_bytes,
+                  stats.central_free_bytes);
+    total_slab_bytes += stats.slab_bytes;
+    total_free_bytes += stats.central_free_bytes;
+  }
+  StringAppendF(output, "%6s %12s %12s %10s %10" PRIuS " %10" PRIuS "\n",
+                "total", "", "", "", total_slab_bytes, total_free_bytes);
+}
+
+// static
+size_t SlabAllocator::GetWasteSize() {
+  SlabHeap* heap = g_slab_heap.Pointer();
+  size_t waste = 0;
+  for (size_t i = 0; i < kNumSizeClasses; ++i)
+    waste += heap->GetStats(i).central_free_bytes;
+  return waste;
+}
+
+// static
+void SlabAllocator::FlushThreadCache() {
+  SlabHeap* heap = g_slab_heap.Pointer();
+  ThreadCache* cache = heap->current_thread_cache();
+  if (cache)
+    heap->ReleaseThreadCache(cache);
+}
+
+}  // namespace base
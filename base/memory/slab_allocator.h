@@ -0,0 +1,124 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// SlabAllocator hands out small fixed-size blocks for objects that are
+// allocated and released at a high rate, often on different threads (IO
+// buffers, bound callbacks, raster tasks).  Blocks are grouped in size classes
+// of kSizeClassGranularity bytes up to kMaxBlockSize bytes and are carved out
+// of slabs which are never returned to the system.
+//
+// Every thread keeps a small cache of free blocks per size class, so that the
+// common allocation and release take no lock.  Blocks move between the thread
+// caches and a central free list of each size class kBatchSize at a time,
+// which is how blocks freed on another thread than the one that allocated them
+// find their way back.
+//
+// A class opts in by deriving from SlabAllocatedRefCountedThreadSafe<T>
+// instead of RefCountedThreadSafe<T>:
+//
+//   class MyFoo : public base::SlabAllocatedRefCountedThreadSafe<MyFoo> {
+//    private:
+//     friend class base::RefCountedThreadSafe<MyFoo>;
+//     virtual ~MyFoo();
+//   };
+//
+// Subclasses bigger than kMaxBlockSize are simply allocated with operator
+// new.  The destructor of an opted in class must be virtual if subclasses are
+// released through a pointer to it, as the size of the object picks its size
+// class when it is released.
+//
+// The slabs are bypassed altogether when running under AddressSanitizer,
+// MemorySanitizer or Valgrind, so that those keep tracking every object.
+
+#ifndef BASE_MEMORY_SLAB_ALLOCATOR_H_
+#define BASE_MEMORY_SLAB_ALLOCATOR_H_
+
+#include <stddef.h>
+
+#include <string>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+
+namespace base {
+
+class BASE_EXPORT SlabAllocator {
+ public:
+  static const size_t kSizeClassGranularity = 16;
+  static const size_t kMaxBlockSize = 512;
+  static const int kBatchSize = 32;
+
+  struct BASE_EXPORT SizeClassStats {
+    SizeClassStats();
+
+    size_t block_size;
+    // The counters of each thread are added up every few hundred operations
+    // and when blocks move in or out of its cache, so they may lag behind.
+    int64 allocations;
+    int64 frees;
+    // Number of batches moved between the thread caches and the central free
+    // list.
+    int64 batch_transfers;
+    // Memory taken from the system for slabs of this size class.
+    size_t slab_bytes;
+    // Memory held by free blocks in the central free list.  Free blocks held
+    // by the thread caches are not included.
+    size_t central_free_bytes;
+  };
+
+  // Returns false if the slabs are bypassed, in which case Allocate() and
+  // Free() are the same as operator new and operator delete.
+  static bool IsEnabled();
+
+  // Returns a block of at least |size| bytes, which must be released with
+  // Free() and the same |size|.
+  static void* Allocate(size_t size);
+  static void Free(void* ptr, size_t size);
+
+  // Returns the statistics of the size class blocks of |size| bytes belong
+  // to.  |size| must be at most kMaxBlockSize.
+  static SizeClassStats GetSizeClassStats(size_t size);
+
+  // Appends a human-readable table of the statistics of every size class in
+  // use to |output|.
+  static void AppendStats(std::string* output);
+
+  // Returns the memory held by the central free lists.
+  static size_t GetWasteSize();
+
+  // Moves the free blocks of the calling thread's cache to the central free
+  // lists and flushes its counters.  This is done when a thread exits.
+  static void FlushThreadCache();
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(SlabAllocator);
+};
+
+// A RefCountedThreadSafe<T> whose instances (and those of its subclasses) are
+// allocated by the SlabAllocator.
+template <class T, typename Traits = DefaultRefCountedThreadSafeTraits<T> >
+class SlabAllocatedRefCountedThreadSafe
+    : public RefCountedThreadSafe<T, Traits> {
+ public:
+  SlabAllocatedRefCountedThreadSafe() {}
+
+  static void* operator new(size_t size) {
+    return SlabAllocator::Allocate(size);
+  }
+
+  static void operator delete(void* ptr, size_t size) {
+    SlabAllocator::Free(ptr, size);
+  }
+
+ protected:
+  ~SlabAllocatedRefCountedThreadSafe() {}
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(SlabAllocatedRefCountedThreadSafe);
+};
+
+}  // namespace base
+
+#endif  // BASE_MEMORY_SLAB_ALLOCATOR_H_
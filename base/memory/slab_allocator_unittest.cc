@@ -0,0 +1,158 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/memory/slab_allocator.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/memory/ref_counted.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/threading/thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+namespace {
+
+class SlabFoo : public SlabAllocatedRefCountedThreadSafe<SlabFoo> {
+ public:
+  SlabFoo() : value_(0) {}
+
+  int value() const { return value_; }
+
+ protected:
+  friend class RefCountedThreadSafe<SlabFoo>;
+  virtual ~SlabFoo() {}
+
+ private:
+  int value_;
+};
+
+class BigSlabFoo : public SlabFoo {
+ private:
+  virtual ~BigSlabFoo() {}
+
+  char padding_[200];
+};
+
+void FreeBlocks(const std::vector<void*>& blocks, size_t size) {
+  for (size_t i = 0; i < blocks.size(); ++i)
+    SlabAllocator::Free(blocks[i], size);
+}
+
+}  // namespace
+
+TEST(SlabAllocatorTest, ReusesBlocks) {
+  if (!SlabAllocator::IsEnabled())
+    return;
+
+  void* block = SlabAllocator::Allocate(40);
+  memset(block, 0xAB, 40);
+  SlabAllocator::Free(block, 40);
+  // Sizes of the same size class share the blocks.
+  EXPECT_EQ(block, SlabAllocator::Allocate(48));
+  SlabAllocator::Free(block, 48);
+
+  SlabAllocator::SizeClassStats stats = SlabAllocator::GetSizeClassStats(40);
+  EXPECT_EQ(48u, stats.block_size);
+  EXPECT_GT(stats.slab_bytes, 0u);
+}
+
+TEST(SlabAllocatorTest, LargeSizes) {
+  void* block = SlabAllocator::Allocate(SlabAllocator::kMaxBlockSize + 1);
+  ASSERT_TRUE(block);
+  memset(block, 0, SlabAllocator::kMaxBlockSize + 1);
+  SlabAllocator::Free(block, SlabAllocator::kMaxBlockSize + 1);
+  SlabAllocator::Free(NULL, 16);
+}
+
+TEST(SlabAllocatorTest, Stats) {
+  if (!SlabAllocator::IsEnabled())
+    return;
+
+  const size_t kSize = 100;
+  SlabAllocator::FlushThreadCache();
+  SlabAllocator::SizeClassStats before =
+      SlabAllocator::GetSizeClassStats(kSize);
+
+  std::vector<void*> blocks;
+  for (int i = 0; i < 3 * SlabAllocator::kBatchSize; ++i)
+    blocks.push_back(SlabAllocator::Allocate(kSize));
+  FreeBlocks(blocks, kSize);
+  SlabAllocator::FlushThreadCache();
+
+  SlabAllocator::SizeClassStats after =
+      SlabAllocator::GetSizeClassStats(kSize);
+  EXPECT_EQ(3 * SlabAllocator::kBatchSize,
+            after.allocations - before.allocations);
+  EXPECT_EQ(3 * SlabAllocator::kBatchSize, after.frees - before.frees);
+  EXPECT_GT(after.batch_transfers, before.batch_transfers);
+  EXPECT_GE(after.central_free_bytes,
+            3 * SlabAllocator::kBatchSize * after.block_size);
+  EXPECT_GE(SlabAllocator::GetWasteSize(), after.central_free_bytes);
+
+  std::string output;
+  SlabAllocator::AppendStats(&output);
+  EXPECT_NE(std::string::npos, output.find("Slab allocator"));
+}
+
+TEST(SlabAllocatorTest, CrossThreadFrees) {
+  if (!SlabAllocator::IsEnabled())
+    return;
+
+  const size_t kSize = 200;
+  const int kNumBlocks = 10 * SlabAllocator::kBatchSize + 5;
+  SlabAllocator::FlushThreadCache();
+  SlabAllocator::SizeClassStats before =
+      SlabAllocator::GetSizeClassStats(kSize);
+
+  std::vector<void*> blocks;
+  for (int i = 0; i < kNumBlocks; ++i)
+    blocks.push_back(SlabAllocator::Allocate(kSize));
+  SlabAllocator::FlushThreadCache();
+
+  {
+    Thread thread("SlabAllocatorTest");
+    ASSERT_TRUE(thread.Start());
+    thread.message_loop_proxy()->PostTask(
+        FROM_HERE, Bind(&FreeBlocks, blocks, kSize));
+    // Stopping the thread returns its cache to the central free lists.
+  }
+
+  SlabAllocator::SizeClassStats after =
+      SlabAllocator::GetSizeClassStats(kSize);
+  EXPECT_EQ(kNumBlocks, after.allocations - before.allocations);
+  EXPECT_EQ(kNumBlocks, after.frees - before.frees);
+  EXPECT_GE(after.central_free_bytes, kNumBlocks * after.block_size);
+
+  // The blocks freed by the other thread are handed out again.
+  std::vector<void*> reused;
+  for (int i = 0; i < kNumBlocks; ++i)
+    reused.push_back(SlabAllocator::Allocate(kSize));
+  EXPECT_EQ(after.slab_bytes,
+            SlabAllocator::GetSizeClassStats(kSize).slab_bytes);
+  FreeBlocks(reused, kSize);
+}
+
+TEST(SlabAllocatorTest, RefCountedThreadSafe) {
+  scoped_refptr<SlabFoo> foo(new SlabFoo);
+  EXPECT_EQ(0, foo->value());
+  EXPECT_TRUE(foo->HasOneRef());
+
+  // Subclasses are released with their own size.
+  scoped_refptr<SlabFoo> big(new BigSlabFoo);
+  EXPECT_TRUE(big->HasOneRef());
+  big = NULL;
+
+  if (SlabAllocator::IsEnabled()) {
+    void* block = foo.get();
+    foo = NULL;
+    EXPECT_EQ(block, SlabAllocator::Allocate(sizeof(SlabFoo)));
+    SlabAllocator::Free(block, sizeof(SlabFoo));
+  }
+}
+
+}  // namespace base
@@ -7,14 +7,21 @@
 #include "base/debug/trace_event.h"
 #include "base/location.h"
 #include "base/message_loop/message_loop.h"
+#include "base/message_loop/mpsc_task_queue.h"
 #include "base/synchronization/waitable_event.h"
+#include "base/threading/platform_thread.h"
 
 namespace base {
 namespace internal {
 
-IncomingTaskQueue::IncomingTaskQueue(MessageLoop* message_loop)
+IncomingTaskQueue::IncomingTaskQueue(MessageLoop* message_loop,
+                                     bool lock_free)
     : message_loop_(message_loop),
-      next_sequence_num_(0) {
+      next_sequence_num_(0),
+      lock_free_queue_(lock_free ? new MpscTaskQueue : NULL),
+      active_posters_(0),
+      detached_(0),
+      atomic_sequence_num_(0) {
 }
 
 bool IncomingTaskQueue::AddToIncomingQueue(
@@ -22,6 +29,22 @@ bool IncomingTaskQueue::AddToIncomingQueue(
     const Closure& task,
     TimeDelta delay,
     bool nestable) {
+  if (lock_free_queue_) {
+    // CalculateDelayedRuntime() touches |high_resolution_timer_expiration_|,
+    // which is only tracked on Windows and still needs the lock there.
+#if defined(OS_WIN)
+    TimeTicks delayed_run_time;
+    {
+      AutoLock locked(incoming_queue_lock_);
+      delayed_run_time = CalculateDelayedRuntime(delay);
+    }
+#else
+    TimeTicks delayed_run_time = CalculateDelayedRuntime(delay);
+#endif
+    PendingTask pending_task(from_here, task, delayed_run_time, nestable);
+    return PostPendingTaskLockFree(&pending_task);
+  }
+
   AutoLock locked(incoming_queue_lock_);
   PendingTask pending_task(
       from_here, task, CalculateDelayedRuntime(delay), nestable);
@@ -37,6 +60,9 @@ bool IncomingTaskQueue::IsHighResolutionTimerEnabledForTesting() {
 }
 
 bool IncomingTaskQueue::IsIdleForTesting() {
+  if (lock_free_queue_)
+    return lock_free_queue_->IsEmpty();
+
   AutoLock lock(incoming_queue_lock_);
   return incoming_queue_.empty();
 }
@@ -45,6 +71,15 @@ void IncomingTaskQueue::ReloadWorkQueue(TaskQueue* work_queue) {
   // Make sure no tasks are lost.
   DCHECK(work_queue->empty());
 
+  if (lock_free_queue_) {
+    // If a producer is halfway through a push its task cannot be dequeued yet,
+    // and it will not signal the pump because the queue was not empty when it
+    // started. Wake ourselves up so the task is picked up on the next pass.
+    if (lock_free_queue_->PopAll(work_queue) && message_loop_)
+      message_loop_->ScheduleWork(true);
+    return;
+  }
+
   // Acquire all we can from the inter-thread queue with one lock acquisition.
   AutoLock lock(incoming_queue_lock_);
   if (!incoming_queue_.empty())
@@ -64,6 +99,15 @@ void IncomingTaskQueue::WillDestroyCurrentMessageLoop() {
   }
 #endif
 
+  if (lock_free_queue_) {
+    // Stop new posters, then wait for those already past the check to leave
+    // PostPendingTaskLockFree() before |message_loop_| is cleared.
+    subtle::NoBarrier_Store(&detached_, 1);
+    subtle::MemoryBarrier();
+    while (subtle::Acquire_Load(&active_posters_) != 0)
+      PlatformThread::YieldCurrentThread();
+  }
+
   AutoLock lock(incoming_queue_lock_);
   message_loop_ = NULL;
 }
@@ -144,5 +188,33 @@ bool IncomingTaskQueue::PostPendingTask(PendingTask* pending_task) {
   return true;
 }
 
+bool IncomingTaskQueue::PostPendingTaskLockFree(PendingTask* pending_task) {
+  // The full barrier pairs with the one in WillDestroyCurrentMessageLoop(): a
+  // poster either observes |detached_| or is counted in |active_posters_|.
+  subtle::Barrier_AtomicIncrement(&active_posters_, 1);
+  if (subtle::Acquire_Load(&detached_)) {
+    subtle::Barrier_AtomicIncrement(&active_posters_, -1);
+    pending_task->task.Reset();
+    return false;
+  }
+
+  pending_task->sequence_num =
+      subtle::NoBarrier_AtomicIncrement(&atomic_sequence_num_, 1) - 1;
+
+  TRACE_EVENT_FLOW_BEGIN0(TRACE_DISABLED_BY_DEFAULT("toplevel.flow"),
+      "MessageLoop::PostTask",
+      TRACE_ID_MANGLE(message_loop_->GetTaskTraceID(*pending_task)));
+
+  bool was_empty = lock_free_queue_->Push(*pending_task);
+  pending_task->task.Reset();
+
+  // Wake up the pump. MessageLoop::ScheduleWork() only does so when
+  // |was_empty| is true, except where the pump asks for every notification.
+  message_loop_->ScheduleWork(was_empty);
+
+  subtle::Barrier_AtomicIncrement(&active_posters_, -1);
+  return true;
+}
+
 }  // namespace internal
 }  // namespace base
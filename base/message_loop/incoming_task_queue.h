@@ -5,8 +5,10 @@
 #ifndef BASE_MESSAGE_LOOP_INCOMING_TASK_QUEUE_H_
 #define BASE_MESSAGE_LOOP_INCOMING_TASK_QUEUE_H_
 
+#include "base/atomicops.h"
 #include "base/base_export.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/pending_task.h"
 #include "base/synchronization/lock.h"
 #include "base/time/time.h"
@@ -18,13 +20,20 @@ class WaitableEvent;
 
 namespace internal {
 
+class MpscTaskQueue;
+
 // Implements a queue of tasks posted to the message loop running on the current
 // thread. This class takes care of synchronizing posting tasks from different
 // threads and together with MessageLoop ensures clean shutdown.
+//
+// Two backends are available. By default every post and every reload takes
+// |incoming_queue_lock_|. When |lock_free| is passed to the constructor, tasks
+// are instead pushed onto an MpscTaskQueue and the pump is only signalled when
+// the queue goes from empty to non-empty.
 class BASE_EXPORT IncomingTaskQueue
     : public RefCountedThreadSafe<IncomingTaskQueue> {
  public:
-  explicit IncomingTaskQueue(MessageLoop* message_loop);
+  IncomingTaskQueue(MessageLoop* message_loop, bool lock_free);
 
   // Appends a task to the incoming queue. Posting of all tasks is routed though
   // AddToIncomingQueue() or TryAddToIncomingQueue() to make sure that posting
@@ -65,6 +74,10 @@ class BASE_EXPORT IncomingTaskQueue
   // does not retain |pending_task->task| beyond this function call.
   bool PostPendingTask(PendingTask* pending_task);
 
+  // Lock-free counterpart of PostPendingTask(), used when |lock_free_queue_|
+  // is set. Does not require |incoming_queue_lock_|.
+  bool PostPendingTaskLockFree(PendingTask* pending_task);
+
 #if defined(OS_WIN)
   TimeTicks high_resolution_timer_expiration_;
 #endif
@@ -84,6 +97,18 @@ class BASE_EXPORT IncomingTaskQueue
   // The next sequence number to use for delayed tasks.
   int next_sequence_num_;
 
+  // Non-NULL when the lock-free backend is in use, in which case
+  // |incoming_queue_| is unused.
+  scoped_ptr<MpscTaskQueue> lock_free_queue_;
+
+  // Lock-free backend only. Number of threads currently inside
+  // PostPendingTaskLockFree(), and a flag set once |message_loop_| is going
+  // away. Together they replace |incoming_queue_lock_| for guarding
+  // |message_loop_| against destruction.
+  volatile subtle::Atomic32 active_posters_;
+  volatile subtle::Atomic32 detached_;
+  volatile subtle::Atomic32 atomic_sequence_num_;
+
   DISALLOW_COPY_AND_ASSIGN(IncomingTaskQueue);
 };
 
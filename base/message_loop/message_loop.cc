@@ -86,6 +86,8 @@ const LinearHistogram::DescriptionPair event_descriptions_[] = {
 
 bool enable_histogrammer_ = false;
 
+bool enable_lock_free_incoming_queue_ = false;
+
 MessageLoop::MessagePumpFactory* message_pump_for_ui_factory_ = NULL;
 
 // Returns true if MessagePump::ScheduleWork() must be called one
@@ -189,6 +191,11 @@ void MessageLoop::EnableHistogrammer(bool enable) {
   enable_histogrammer_ = enable;
 }
 
+// static
+void MessageLoop::EnableLockFreeIncomingQueue(bool enable) {
+  enable_lock_free_incoming_queue_ = enable;
+}
+
 // static
 bool MessageLoop::InitMessagePumpForUIFactory(MessagePumpFactory* factory) {
   if (message_pump_for_ui_factory_)
@@ -374,7 +381,8 @@ void MessageLoop::Init() {
   DCHECK(!current()) << "should only have one message loop per thread";
   lazy_tls_ptr.Pointer()->Set(this);
 
-  incoming_task_queue_ = new internal::IncomingTaskQueue(this);
+  incoming_task_queue_ = new internal::IncomingTaskQueue(
+      this, enable_lock_free_incoming_queue_);
   message_loop_proxy_ =
       new internal::MessageLoopProxyImpl(incoming_task_queue_);
   thread_task_runner_handle_.reset(
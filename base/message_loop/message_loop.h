@@ -154,6 +154,12 @@ class BASE_EXPORT MessageLoop : public MessagePump::Delegate {
 
   static void EnableHistogrammer(bool enable_histogrammer);
 
+  // Selects the lock-free incoming task queue for MessageLoops created after
+  // this call. Posting then never blocks on a lock, and the pump is woken only
+  // when the incoming queue goes from empty to non-empty. Should be called
+  // early during startup, before other threads are created.
+  static void EnableLockFreeIncomingQueue(bool enable);
+
   typedef MessagePump* (MessagePumpFactory)();
   // Uses the given base::MessagePumpForUIFactory to override the default
   // MessagePump implementation for 'TYPE_UI'. Returns true if the factory
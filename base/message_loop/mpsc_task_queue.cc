@@ -0,0 +1,102 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/message_loop/mpsc_task_queue.h"
+
+#include "base/logging.h"
+
+namespace base {
+namespace internal {
+
+MpscTaskQueue::Node::Node()
+    : next(0),
+      task(tracked_objects::Location(), Closure()) {
+}
+
+MpscTaskQueue::Node::Node(const PendingTask& pending_task)
+    : next(0),
+      task(pending_task) {
+}
+
+MpscTaskQueue::MpscTaskQueue()
+    : head_(reinterpret_cast<subtle::AtomicWord>(&stub_)),
+      tail_(&stub_),
+      size_(0) {
+}
+
+MpscTaskQueue::~MpscTaskQueue() {
+  // Any task still queued is destroyed here, on the consumer thread.
+  Node* node;
+  while ((node = Pop()) != NULL)
+    delete node;
+}
+
+bool MpscTaskQueue::Push(const PendingTask& pending_task) {
+  Node* node = new Node(pending_task);
+  // Count the task before it becomes reachable, so the consumer can tell when
+  // a push is still in flight.
+  bool was_empty = subtle::Barrier_AtomicIncrement(&size_, 1) == 1;
+  Link(node);
+  return was_empty;
+}
+
+bool MpscTaskQueue::PopAll(TaskQueue* work_queue) {
+  subtle::Atomic32 popped = 0;
+  Node* node;
+  while ((node = Pop()) != NULL) {
+    work_queue->push(node->task);
+    delete node;
+    ++popped;
+  }
+  if (!popped)
+    return subtle::Acquire_Load(&size_) != 0;
+  return subtle::Barrier_AtomicIncrement(&size_, -popped) != 0;
+}
+
+bool MpscTaskQueue::IsEmpty() const {
+  return subtle::Acquire_Load(&size_) == 0;
+}
+
+void MpscTaskQueue::Link(Node* node) {
+  subtle::NoBarrier_Store(&node->next, 0);
+  Node* prev = reinterpret_cast<Node*>(subtle::NoBarrier_AtomicExchange(
+      &head_, reinterpret_cast<subtle::AtomicWord>(node)));
+  // Publishing the link with release semantics makes |node->task| visible to
+  // the consumer before the node itself is.
+  subtle::Release_Store(&prev->next, reinterpret_cast<subtle::AtomicWord>(node));
+}
+
+MpscTaskQueue::Node* MpscTaskQueue::Pop() {
+  Node* tail = tail_;
+  Node* next = reinterpret_cast<Node*>(subtle::Acquire_Load(&tail->next));
+  if (tail == &stub_) {
+    if (!next)
+      return NULL;
+    tail_ = next;
+    tail = next;
+    next = reinterpret_cast<Node*>(subtle::Acquire_Load(&next->next));
+  }
+  if (next) {
+    tail_ = next;
+    return tail;
+  }
+
+  // |tail| is the last linked node. If it is not also the head, a producer has
+  // swapped the head but not yet linked its node; try again later.
+  Node* head = reinterpret_cast<Node*>(subtle::Acquire_Load(&head_));
+  if (tail != head)
+    return NULL;
+
+  // Re-insert the stub so that |tail| can be detached.
+  Link(&stub_);
+  next = reinterpret_cast<Node*>(subtle::Acquire_Load(&tail->next));
+  if (next) {
+    tail_ = next;
+    return tail;
+  }
+  return NULL;
+}
+
+}  // namespace internal
+}  // namespace base
@@ -0,0 +1,82 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_MESSAGE_LOOP_MPSC_TASK_QUEUE_H_
+#define BASE_MESSAGE_LOOP_MPSC_TASK_QUEUE_H_
+
+#include "base/atomicops.h"
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/pending_task.h"
+
+namespace base {
+namespace internal {
+
+// An intrusive, lock-free, multi-producer/single-consumer queue of
+// PendingTasks. Any thread may call Push(); only one thread (the thread running
+// the owning MessageLoop) may call PopAll().
+//
+// The implementation is the classic linked list with a stub node: producers
+// atomically exchange the head pointer and then link the previous head to the
+// new node. A producer that has exchanged the head but not yet published the
+// link leaves the list briefly "inconsistent"; the consumer treats that as
+// temporarily empty and relies on the element count to notice that more work
+// is on the way.
+class BASE_EXPORT MpscTaskQueue {
+ public:
+  MpscTaskQueue();
+  ~MpscTaskQueue();
+
+  // Appends a copy of |pending_task| to the queue. Returns true if the queue
+  // was empty before this call, i.e. the caller is responsible for waking up
+  // the consumer. Safe to call from any thread.
+  bool Push(const PendingTask& pending_task);
+
+  // Moves every task that is currently reachable into |work_queue|, in FIFO
+  // order per producer. Returns true if tasks were pushed concurrently that
+  // could not yet be dequeued; the consumer must arrange to call PopAll()
+  // again. Must only be called from the consumer thread.
+  bool PopAll(TaskQueue* work_queue);
+
+  // Returns true if no tasks have been pushed that were not yet taken by
+  // PopAll(). The result is only a snapshot when producers are active.
+  bool IsEmpty() const;
+
+ private:
+  struct Node {
+    Node();
+    explicit Node(const PendingTask& pending_task);
+
+    // Really a Node*, accessed with atomic operations.
+    subtle::AtomicWord next;
+    PendingTask task;
+  };
+
+  // Links |node| at the head of the list. Safe to call from any thread.
+  void Link(Node* node);
+
+  // Returns the oldest linked node, or NULL if the list is empty or a producer
+  // has not finished linking its node yet. Consumer thread only.
+  Node* Pop();
+
+  // Most recently pushed node. Really a Node*; written by producers only.
+  subtle::AtomicWord head_;
+
+  // Oldest node not yet returned by Pop(). Consumer thread only.
+  Node* tail_;
+
+  // Placeholder node that keeps the list non-empty. Its |task| is never run.
+  Node stub_;
+
+  // Number of tasks pushed but not yet popped. Bumped before a node is linked
+  // so that it never under-counts.
+  volatile subtle::Atomic32 size_;
+
+  DISALLOW_COPY_AND_ASSIGN(MpscTaskQueue);
+};
+
+}  // namespace internal
+}  // namespace base
+
+#endif  // BASE_MESSAGE_LOOP_MPSC_TASK_QUEUE_H_
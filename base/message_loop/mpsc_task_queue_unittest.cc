@@ -0,0 +1,175 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/message_loop/mpsc_task_queue.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+namespace internal {
+
+namespace {
+
+void RecordValue(std::vector<int>* values, int value) {
+  values->push_back(value);
+}
+
+PendingTask MakeTask(std::vector<int>* values, int value) {
+  return PendingTask(FROM_HERE, Bind(&RecordValue, values, value));
+}
+
+// Runs and drops every task in |work_queue|.
+void RunAll(TaskQueue* work_queue) {
+  while (!work_queue->empty()) {
+    work_queue->front().task.Run();
+    work_queue->pop();
+  }
+}
+
+class PushingThread : public DelegateSimpleThread::Delegate {
+ public:
+  PushingThread(MpscTaskQueue* queue, int count)
+      : queue_(queue), count_(count), wakeups_(0) {}
+
+  virtual void Run() OVERRIDE {
+    for (int i = 0; i < count_; ++i) {
+      if (queue_->Push(PendingTask(FROM_HERE, Closure())))
+        ++wakeups_;
+    }
+  }
+
+  int wakeups() const { return wakeups_; }
+
+ private:
+  MpscTaskQueue* queue_;
+  const int count_;
+  int wakeups_;
+};
+
+}  // namespace
+
+TEST(MpscTaskQueueTest, Empty) {
+  MpscTaskQueue queue;
+  EXPECT_TRUE(queue.IsEmpty());
+
+  TaskQueue work_queue;
+  EXPECT_FALSE(queue.PopAll(&work_queue));
+  EXPECT_TRUE(work_queue.empty());
+}
+
+TEST(MpscTaskQueueTest, FifoOrder) {
+  MpscTaskQueue queue;
+  std::vector<int> values;
+
+  EXPECT_TRUE(queue.Push(MakeTask(&values, 1)));
+  EXPECT_FALSE(queue.Push(MakeTask(&values, 2)));
+  EXPECT_FALSE(queue.Push(MakeTask(&values, 3)));
+  EXPECT_FALSE(queue.IsEmpty());
+
+  TaskQueue work_queue;
+  EXPECT_FALSE(queue.PopAll(&work_queue));
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_EQ(3u, work_queue.size());
+
+  RunAll(&work_queue);
+  ASSERT_EQ(3u, values.size());
+  EXPECT_EQ(1, values[0]);
+  EXPECT_EQ(2, values[1]);
+  EXPECT_EQ(3, values[2]);
+}
+
+TEST(MpscTaskQueueTest, WakeupOnlyWhenEmpty) {
+  MpscTaskQueue queue;
+  std::vector<int> values;
+  TaskQueue work_queue;
+
+  EXPECT_TRUE(queue.Push(MakeTask(&values, 1)));
+  EXPECT_FALSE(queue.Push(MakeTask(&values, 2)));
+  queue.PopAll(&work_queue);
+
+  // Draining the queue makes the next push responsible for a wakeup again.
+  EXPECT_TRUE(queue.Push(MakeTask(&values, 3)));
+  queue.PopAll(&work_queue);
+  RunAll(&work_queue);
+  EXPECT_EQ(3u, values.size());
+}
+
+TEST(MpscTaskQueueTest, DestroyWithPendingTasks) {
+  std::vector<int> values;
+  {
+    MpscTaskQueue queue;
+    queue.Push(MakeTask(&values, 1));
+    queue.Push(MakeTask(&values, 2));
+  }
+  EXPECT_TRUE(values.empty());
+}
+
+TEST(MpscTaskQueueTest, ConcurrentProducers) {
+  const int kThreads = 8;
+  const int kTasksPerThread = 10000;
+
+  MpscTaskQueue queue;
+  ScopedVector<PushingThread> delegates;
+  ScopedVector<DelegateSimpleThread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    delegates.push_back(new PushingThread(&queue, kTasksPerThread));
+    threads.push_back(new DelegateSimpleThread(delegates.back(), "Pusher"));
+  }
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i]->Start();
+
+  // Drain concurrently with the producers.
+  size_t total = 0;
+  while (total < static_cast<size_t>(kThreads * kTasksPerThread)) {
+    TaskQueue work_queue;
+    queue.PopAll(&work_queue);
+    total += work_queue.size();
+  }
+
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i]->Join();
+
+  TaskQueue work_queue;
+  EXPECT_FALSE(queue.PopAll(&work_queue));
+  EXPECT_TRUE(work_queue.empty());
+  EXPECT_TRUE(queue.IsEmpty());
+
+  int wakeups = 0;
+  for (size_t i = 0; i < delegates.size(); ++i)
+    wakeups += delegates[i]->wakeups();
+  EXPECT_GE(wakeups, 1);
+  EXPECT_LE(wakeups, kThreads * kTasksPerThread);
+}
+
+// Run a MessageLoop end to end on top of the lock-free backend.
+TEST(MpscTaskQueueTest, MessageLoopBackend) {
+  MessageLoop::EnableLockFreeIncomingQueue(true);
+  {
+    MessageLoop loop;
+    std::vector<int> values;
+    loop.PostTask(FROM_HERE, Bind(&RecordValue, &values, 1));
+    loop.PostDelayedTask(FROM_HERE, Bind(&RecordValue, &values, 3),
+                         TimeDelta::FromMilliseconds(1));
+    loop.PostTask(FROM_HERE, Bind(&RecordValue, &values, 2));
+    loop.PostDelayedTask(FROM_HERE, MessageLoop::QuitClosure(),
+                         TimeDelta::FromMilliseconds(10));
+    RunLoop().Run();
+
+    ASSERT_EQ(3u, values.size());
+    EXPECT_EQ(1, values[0]);
+    EXPECT_EQ(2, values[1]);
+    EXPECT_EQ(3, values[2]);
+  }
+  MessageLoop::EnableLockFreeIncomingQueue(false);
+}
+
+}  // namespace internal
+}  // namespace base
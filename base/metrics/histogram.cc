@@ -17,6 +17,7 @@
 #include "base/compiler_specific.h"
 #include "base/debug/alias.h"
 #include "base/logging.h"
+#include "base/metrics/histogram_batch.h"
 #include "base/metrics/sample_vector.h"
 #include "base/metrics/statistics_recorder.h"
 #include "base/pickle.h"
@@ -262,6 +263,11 @@ void Histogram::Add(int value) {
     value = kSampleType_MAX - 1;
   if (value < 0)
     value = 0;
+  HistogramBatch* batch = HistogramBatch::GetForCurrentThread();
+  if (batch) {
+    batch->Add(this, value);
+    return;
+  }
   samples_->Accumulate(value, 1);
 }
 
@@ -0,0 +1,153 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/histogram_batch.h"
+
+#include <set>
+
+#include "base/atomicops.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/metrics/histogram.h"
+#include "base/metrics/sample_vector.h"
+#include "base/stl_util.h"
+#include "base/threading/thread_local_storage.h"
+
+namespace base {
+
+namespace {
+
+// Set once batching has been enabled on any thread, so that recording a
+// sample on a process that never batches costs one load, not a TLS lookup.
+subtle::Atomic32 g_batching_enabled = 0;
+
+}  // namespace
+
+namespace internal {
+
+// Tracks the batches of all threads.
+class HistogramBatchRegistry {
+ public:
+  HistogramBatchRegistry() : slot_(&OnThreadExit) {}
+
+  HistogramBatch* GetForCurrentThread() {
+    return static_cast<HistogramBatch*>(slot_.Get());
+  }
+
+  void SetForCurrentThread(HistogramBatch* batch) {
+    AutoLock auto_lock(lock_);
+    HistogramBatch* old_batch = GetForCurrentThread();
+    if (old_batch)
+      batches_.erase(old_batch);
+    if (batch)
+      batches_.insert(batch);
+    slot_.Set(batch);
+  }
+
+  void FlushAll() {
+    AutoLock auto_lock(lock_);
+    for (std::set<HistogramBatch*>::iterator it = batches_.begin();
+         it != batches_.end(); ++it) {
+      (*it)->Flush();
+    }
+  }
+
+ private:
+  static void OnThreadExit(void* value);
+
+  // Protects |batches_|. Held while flushing, so that a batch is not
+  // destroyed while another thread flushes it.
+  Lock lock_;
+  std::set<HistogramBatch*> batches_;
+  ThreadLocalStorage::Slot slot_;
+
+  DISALLOW_COPY_AND_ASSIGN(HistogramBatchRegistry);
+};
+
+}  // namespace internal
+
+namespace {
+
+LazyInstance<internal::HistogramBatchRegistry>::Leaky g_registry =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+namespace internal {
+
+// static
+void HistogramBatchRegistry::OnThreadExit(void* value) {
+  HistogramBatch* batch = static_cast<HistogramBatch*>(value);
+  HistogramBatchRegistry* registry = g_registry.Pointer();
+  {
+    AutoLock auto_lock(registry->lock_);
+    registry->batches_.erase(batch);
+  }
+  batch->Flush();
+  delete batch;
+}
+
+}  // namespace internal
+
+// static
+void HistogramBatch::EnableForCurrentThread() {
+  if (GetForCurrentThread())
+    return;
+  g_registry.Get().SetForCurrentThread(new HistogramBatch);
+  subtle::NoBarrier_Store(&g_batching_enabled, 1);
+}
+
+// static
+void HistogramBatch::DisableForCurrentThread() {
+  HistogramBatch* batch = GetForCurrentThread();
+  if (!batch)
+    return;
+  g_registry.Get().SetForCurrentThread(NULL);
+  batch->Flush();
+  delete batch;
+}
+
+// static
+HistogramBatch* HistogramBatch::GetForCurrentThread() {
+  if (!subtle::NoBarrier_Load(&g_batching_enabled))
+    return NULL;
+  return g_registry.Get().GetForCurrentThread();
+}
+
+// static
+void HistogramBatch::FlushAll() {
+  if (!subtle::NoBarrier_Load(&g_batching_enabled))
+    return;
+  g_registry.Get().FlushAll();
+}
+
+void HistogramBatch::Add(Histogram* histogram, HistogramBase::Sample value) {
+  AutoLock auto_lock(lock_);
+  SampleVector*& samples = samples_[histogram];
+  if (!samples)
+    samples = new SampleVector(histogram->bucket_ranges());
+  samples->Accumulate(value, 1);
+}
+
+HistogramBatch::HistogramBatch() {
+}
+
+HistogramBatch::~HistogramBatch() {
+  DCHECK(samples_.empty());
+}
+
+void HistogramBatch::Flush() {
+  // Take the samples so that the owning thread can keep recording while they
+  // are added to the histograms.
+  SamplesMap samples;
+  {
+    AutoLock auto_lock(lock_);
+    samples.swap(samples_);
+  }
+  for (SamplesMap::iterator it = samples.begin(); it != samples.end(); ++it)
+    it->first->AddSamples(*it->second);
+  STLDeleteValues(&samples);
+}
+
+}  // namespace base
@@ -0,0 +1,85 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// HistogramBatch buffers the samples that Histograms record on one thread, so
+// that a thread adding to hot histograms on nearly every task doesn't keep
+// pulling their bucket counts away from other threads' caches, nor lose counts
+// to the unsynchronized increments in SampleVector. Batching is enabled per
+// thread, e.g. on the IO thread:
+//
+//   base::HistogramBatch::EnableForCurrentThread();
+//
+// Buffered samples are only visible in their histograms once they have been
+// flushed. StatisticsRecorder::GetSnapshot() and
+// HistogramSnapshotManager::PrepareDeltas() call FlushAll() first, and a
+// thread's batch is flushed when batching is disabled or the thread exits.
+// Code that reads a histogram's samples directly, such as tests, must call
+// FlushAll() itself.
+//
+// Only bucketed histograms (Histogram and its subclasses) are batched;
+// SparseHistogram already serializes its samples with a lock.
+
+#ifndef BASE_METRICS_HISTOGRAM_BATCH_H_
+#define BASE_METRICS_HISTOGRAM_BATCH_H_
+
+#include <map>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/metrics/histogram_base.h"
+#include "base/synchronization/lock.h"
+
+namespace base {
+
+class Histogram;
+class SampleVector;
+
+namespace internal {
+class HistogramBatchRegistry;
+}  // namespace internal
+
+class BASE_EXPORT HistogramBatch {
+ public:
+  // Starts buffering the samples recorded on the current thread. Does nothing
+  // if batching is already enabled.
+  static void EnableForCurrentThread();
+
+  // Flushes the current thread's batch and stops buffering samples on it.
+  static void DisableForCurrentThread();
+
+  // Returns the current thread's batch, or NULL if batching is not enabled on
+  // it. Cheap when batching has never been enabled in the process.
+  static HistogramBatch* GetForCurrentThread();
+
+  // Moves the samples buffered on every thread into their histograms. Thread
+  // safe.
+  static void FlushAll();
+
+  // Buffers one sample of |value| for |histogram|. Must be called on the
+  // thread that owns this batch.
+  void Add(Histogram* histogram, HistogramBase::Sample value);
+
+ private:
+  typedef std::map<Histogram*, SampleVector*> SamplesMap;
+
+  friend class internal::HistogramBatchRegistry;
+
+  HistogramBatch();
+  ~HistogramBatch();
+
+  // Moves the buffered samples into their histograms.
+  void Flush();
+
+  // Protects |samples_|. Only contended while the batch is being flushed
+  // from another thread.
+  Lock lock_;
+  // Samples waiting to be flushed, each sized for its histogram's buckets.
+  SamplesMap samples_;
+
+  DISALLOW_COPY_AND_ASSIGN(HistogramBatch);
+};
+
+}  // namespace base
+
+#endif  // BASE_METRICS_HISTOGRAM_BATCH_H_
@@ -0,0 +1,149 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/metrics/histogram_batch.h"
+
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/metrics/histogram.h"
+#include "base/metrics/histogram_samples.h"
+#include "base/metrics/sparse_histogram.h"
+#include "base/metrics/statistics_recorder.h"
+#include "base/threading/simple_thread.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace base {
+
+class HistogramBatchTest : public testing::Test {
+ protected:
+  HistogramBatchTest() : statistics_recorder_(NULL) {}
+
+  virtual void SetUp() OVERRIDE {
+    statistics_recorder_ = new StatisticsRecorder;
+  }
+
+  virtual void TearDown() OVERRIDE {
+    HistogramBatch::DisableForCurrentThread();
+    delete statistics_recorder_;
+    statistics_recorder_ = NULL;
+  }
+
+  static HistogramBase::Count TotalCount(const HistogramBase* histogram) {
+    return histogram->SnapshotSamples()->TotalCount();
+  }
+
+ private:
+  StatisticsRecorder* statistics_recorder_;
+};
+
+namespace {
+
+// Records |count| samples into |histogram| on a thread with batching enabled,
+// then exits without flushing explicitly.
+class BatchingDelegate : public DelegateSimpleThread::Delegate {
+ public:
+  BatchingDelegate(HistogramBase* histogram, int count)
+      : histogram_(histogram), count_(count) {}
+
+  virtual void Run() OVERRIDE {
+    HistogramBatch::EnableForCurrentThread();
+    for (int i = 0; i < count_; ++i)
+      histogram_->Add(i % 10);
+  }
+
+ private:
+  HistogramBase* const histogram_;
+  const int count_;
+};
+
+}  // namespace
+
+TEST_F(HistogramBatchTest, DisabledByDefault) {
+  EXPECT_TRUE(HistogramBatch::GetForCurrentThread() == NULL);
+
+  HistogramBase* histogram = Histogram::FactoryGet(
+      "Batch.Unbatched", 1, 100, 10, HistogramBase::kNoFlags);
+  histogram->Add(5);
+  EXPECT_EQ(1, TotalCount(histogram));
+}
+
+TEST_F(HistogramBatchTest, FlushAll) {
+  HistogramBatch::EnableForCurrentThread();
+  HistogramBatch* batch = HistogramBatch::GetForCurrentThread();
+  ASSERT_TRUE(batch);
+  // Enabling again keeps the same batch.
+  HistogramBatch::EnableForCurrentThread();
+  EXPECT_EQ(batch, HistogramBatch::GetForCurrentThread());
+
+  HistogramBase* histogram = Histogram::FactoryGet(
+      "Batch.Counts", 1, 100, 10, HistogramBase::kNoFlags);
+  histogram->Add(1);
+  histogram->Add(50);
+  histogram->Add(50);
+  EXPECT_EQ(0, TotalCount(histogram));
+
+  HistogramBatch::FlushAll();
+  scoped_ptr<HistogramSamples> samples(histogram->SnapshotSamples());
+  EXPECT_EQ(3, samples->TotalCount());
+  EXPECT_EQ(1, samples->GetCount(1));
+  EXPECT_EQ(2, samples->GetCount(50));
+  EXPECT_EQ(101, samples->sum());
+  EXPECT_EQ(3, samples->redundant_count());
+
+  // Flushing again adds nothing new.
+  HistogramBatch::FlushAll();
+  EXPECT_EQ(3, TotalCount(histogram));
+}
+
+TEST_F(HistogramBatchTest, GetSnapshotFlushes) {
+  HistogramBatch::EnableForCurrentThread();
+  HistogramBase* histogram = Histogram::FactoryGet(
+      "Batch.Snapshot", 1, 100, 10, HistogramBase::kNoFlags);
+  histogram->Add(7);
+
+  StatisticsRecorder::Histograms snapshot;
+  StatisticsRecorder::GetSnapshot("Batch.Snapshot", &snapshot);
+  ASSERT_EQ(1u, snapshot.size());
+  EXPECT_EQ(1, TotalCount(snapshot[0]));
+}
+
+TEST_F(HistogramBatchTest, DisableFlushes) {
+  HistogramBatch::EnableForCurrentThread();
+  HistogramBase* histogram = Histogram::FactoryGet(
+      "Batch.Disable", 1, 100, 10, HistogramBase::kNoFlags);
+  histogram->Add(7);
+  HistogramBatch::DisableForCurrentThread();
+  EXPECT_TRUE(HistogramBatch::GetForCurrentThread() == NULL);
+  EXPECT_EQ(1, TotalCount(histogram));
+
+  // Samples are recorded directly again.
+  histogram->Add(7);
+  EXPECT_EQ(2, TotalCount(histogram));
+}
+
+TEST_F(HistogramBatchTest, SparseHistogramsAreNotBatched) {
+  HistogramBatch::EnableForCurrentThread();
+  HistogramBase* histogram =
+      SparseHistogram::FactoryGet("Batch.Sparse", HistogramBase::kNoFlags);
+  histogram->Add(3);
+  EXPECT_EQ(1, TotalCount(histogram));
+}
+
+TEST_F(HistogramBatchTest, ThreadsFlushOnExit) {
+  const int kNumThreads = 4;
+  const int kSamplesPerThread = 1000;
+  HistogramBase* histogram = Histogram::FactoryGet(
+      "Batch.Threads", 1, 100, 10, HistogramBase::kNoFlags);
+
+  DelegateSimpleThreadPool pool("Batching", kNumThreads);
+  BatchingDelegate delegate(histogram, kSamplesPerThread);
+  pool.AddWork(&delegate, kNumThreads);
+  pool.Start();
+  pool.JoinAll();
+
+  EXPECT_EQ(kNumThreads * kSamplesPerThread, TotalCount(histogram));
+}
+
+}  // namespace base
@@ -5,6 +5,7 @@
 #include "base/metrics/histogram_snapshot_manager.h"
 
 #include "base/memory/scoped_ptr.h"
+#include "base/metrics/histogram_batch.h"
 #include "base/metrics/histogram_flattener.h"
 #include "base/metrics/histogram_samples.h"
 #include "base/metrics/statistics_recorder.h"
@@ -28,6 +29,9 @@ HistogramSnapshotManager::~HistogramSnapshotManager() {
 void HistogramSnapshotManager::PrepareDeltas(
     HistogramBase::Flags flag_to_set,
     HistogramBase::Flags required_flags) {
+  // Include the samples still buffered on other threads.
+  HistogramBatch::FlushAll();
+
   StatisticsRecorder::Histograms histograms;
   StatisticsRecorder::GetHistograms(&histograms);
   for (StatisticsRecorder::Histograms::const_iterator it = histograms.begin();
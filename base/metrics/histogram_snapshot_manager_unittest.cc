@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "base/metrics/histogram.h"
+#include "base/metrics/histogram_batch.h"
 #include "base/metrics/histogram_delta_serialization.h"
 #include "base/metrics/statistics_recorder.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -103,4 +104,18 @@ TEST_F(HistogramSnapshotManagerTest,
   EXPECT_EQ("UmaStabilityHistogram", histograms[0]);
 }
 
+TEST_F(HistogramSnapshotManagerTest, PrepareDeltasIncludesBatchedSamples) {
+  HistogramBatch::EnableForCurrentThread();
+  UMA_HISTOGRAM_ENUMERATION("UmaHistogram", 1, 2);
+
+  histogram_snapshot_manager_.PrepareDeltas(HistogramBase::kNoFlags,
+                                            HistogramBase::kNoFlags);
+  HistogramBatch::DisableForCurrentThread();
+
+  const std::vector<std::string>& histograms =
+      histogram_flattener_delta_recorder_.GetRecordedDeltaHistogramNames();
+  ASSERT_EQ(1U, histograms.size());
+  EXPECT_EQ("UmaHistogram", histograms[0]);
+}
+
 }  // namespace base
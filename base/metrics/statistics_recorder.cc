@@ -4,12 +4,18 @@
 
 #include "base/metrics/statistics_recorder.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "base/at_exit.h"
 #include "base/debug/leak_annotations.h"
+#include "base/hash.h"
 #include "base/json/string_escape.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
+#include "base/metrics/histogram_batch.h"
 #include "base/strings/stringprintf.h"
 #include "base/synchronization/lock.h"
 #include "base/values.h"
@@ -21,10 +27,154 @@ namespace {
 // Initialize histogram statistics gathering system.
 base::LazyInstance<base::StatisticsRecorder>::Leaky g_statistics_recorder_ =
     LAZY_INSTANCE_INITIALIZER;
+
+// The number of slots each shard starts with. Must be a power of two.
+const size_t kInitialShardCapacity = 32;
+
+bool HistogramNameLess(const base::HistogramBase* a,
+                       const base::HistogramBase* b) {
+  return a->histogram_name() < b->histogram_name();
+}
+
 }  // namespace
 
 namespace base {
 
+// An open-addressed hash table of histograms. Lookups take no lock: slots are
+// only ever filled, never cleared, and each is published with a release store
+// after the slot's hash. Insertions are serialized by |lock_|. When the table
+// gets half full it is copied into one twice the size, which is then
+// published; the old table is kept until the shard is destroyed, since
+// lookups may still be reading it.
+class StatisticsRecorder::HistogramShard {
+ public:
+  HistogramShard() : table_(0), size_(0) {
+    subtle::Release_Store(
+        &table_, reinterpret_cast<subtle::AtomicWord>(
+            new Table(kInitialShardCapacity, NULL)));
+  }
+
+  ~HistogramShard() {
+    Table* table = current_table();
+    while (table) {
+      Table* previous = table->previous;
+      delete table;
+      table = previous;
+    }
+  }
+
+  // Returns the histogram named |name|, or NULL. Thread safe and lock free.
+  HistogramBase* Find(const std::string& name, uint32 name_hash) const {
+    const Table* table = current_table();
+    for (size_t i = FirstSlot(*table, name_hash); ; i = NextSlot(*table, i)) {
+      const Slot& slot = table->slots[i];
+      HistogramBase* histogram = reinterpret_cast<HistogramBase*>(
+          subtle::Acquire_Load(&slot.histogram));
+      if (!histogram)
+        return NULL;
+      if (static_cast<uint32>(subtle::NoBarrier_Load(&slot.hash)) ==
+              name_hash &&
+          histogram->histogram_name() == name) {
+        return histogram;
+      }
+    }
+  }
+
+  // Adds |histogram| unless one with the same name is already present.
+  // Returns whichever is in the shard afterwards, and sets |*inserted| to
+  // whether that is a new entry.
+  HistogramBase* FindOrInsert(HistogramBase* histogram,
+                              uint32 name_hash,
+                              bool* inserted) {
+    AutoLock auto_lock(lock_);
+    HistogramBase* existing = Find(histogram->histogram_name(), name_hash);
+    *inserted = !existing;
+    if (existing)
+      return existing;
+
+    Table* table = current_table();
+    if ((size_ + 1) * 2 > table->capacity) {
+      Table* grown = new Table(table->capacity * 2, table);
+      for (size_t i = 0; i < table->capacity; ++i) {
+        const Slot& slot = table->slots[i];
+        HistogramBase* moved = reinterpret_cast<HistogramBase*>(
+            subtle::NoBarrier_Load(&slot.histogram));
+        if (moved) {
+          Insert(grown, moved,
+                 static_cast<uint32>(subtle::NoBarrier_Load(&slot.hash)));
+        }
+      }
+      subtle::Release_Store(&table_,
+                            reinterpret_cast<subtle::AtomicWord>(grown));
+      table = grown;
+    }
+    Insert(table, histogram, name_hash);
+    ++size_;
+    return histogram;
+  }
+
+  // Appends every histogram in the shard to |output|.
+  void GetAll(Histograms* output) const {
+    AutoLock auto_lock(lock_);
+    const Table* table = current_table();
+    for (size_t i = 0; i < table->capacity; ++i) {
+      HistogramBase* histogram = reinterpret_cast<HistogramBase*>(
+          subtle::NoBarrier_Load(&table->slots[i].histogram));
+      if (histogram)
+        output->push_back(histogram);
+    }
+  }
+
+ private:
+  struct Slot {
+    subtle::Atomic32 hash;
+    subtle::AtomicWord histogram;
+  };
+
+  struct Table {
+    Table(size_t capacity, Table* previous)
+        : capacity(capacity),
+          previous(previous),
+          slots(new Slot[capacity]) {
+      memset(slots.get(), 0, capacity * sizeof(Slot));
+    }
+
+    const size_t capacity;
+    Table* const previous;
+    scoped_ptr<Slot[]> slots;
+  };
+
+  // The low bits of the hash pick the shard, so probe with the high ones.
+  static size_t FirstSlot(const Table& table, uint32 name_hash) {
+    return (name_hash / kNumShards) & (table.capacity - 1);
+  }
+  static size_t NextSlot(const Table& table, size_t slot) {
+    return (slot + 1) & (table.capacity - 1);
+  }
+
+  static void Insert(Table* table, HistogramBase* histogram, uint32 name_hash) {
+    size_t i = FirstSlot(*table, name_hash);
+    while (subtle::NoBarrier_Load(&table->slots[i].histogram))
+      i = NextSlot(*table, i);
+    subtle::NoBarrier_Store(&table->slots[i].hash,
+                            static_cast<subtle::Atomic32>(name_hash));
+    subtle::Release_Store(&table->slots[i].histogram,
+                          reinterpret_cast<subtle::AtomicWord>(histogram));
+  }
+
+  Table* current_table() const {
+    return reinterpret_cast<Table*>(subtle::Acquire_Load(&table_));
+  }
+
+  // Serializes insertions.
+  mutable Lock lock_;
+  subtle::AtomicWord table_;
+  // The number of histograms in the shard. Protected by |lock_|.
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(HistogramShard);
+};
+
 // static
 void StatisticsRecorder::Initialize() {
   // Ensure that an instance of the StatisticsRecorder object is created.
@@ -37,7 +187,7 @@ bool StatisticsRecorder::IsActive() {
   if (lock_ == NULL)
     return false;
   base::AutoLock auto_lock(*lock_);
-  return NULL != histograms_;
+  return 0 != subtle::NoBarrier_Load(&histogram_shards_);
 }
 
 // static
@@ -47,37 +197,29 @@ HistogramBase* StatisticsRecorder::RegisterOrDeleteDuplicate(
   // to annotate them. Because ANNOTATE_LEAKING_OBJECT_PTR may be used only once
   // for an object, the duplicates should not be annotated.
   // Callers are responsible for not calling RegisterOrDeleteDuplicate(ptr)
-  // twice if (lock_ == NULL) || (!histograms_).
+  // twice if (lock_ == NULL) || (!histogram_shards_).
   if (lock_ == NULL) {
     ANNOTATE_LEAKING_OBJECT_PTR(histogram);  // see crbug.com/79322
     return histogram;
   }
 
-  HistogramBase* histogram_to_delete = NULL;
-  HistogramBase* histogram_to_return = NULL;
-  {
-    base::AutoLock auto_lock(*lock_);
-    if (histograms_ == NULL) {
-      histogram_to_return = histogram;
-    } else {
-      const string& name = histogram->histogram_name();
-      HistogramMap::iterator it = histograms_->find(name);
-      if (histograms_->end() == it) {
-        (*histograms_)[name] = histogram;
-        ANNOTATE_LEAKING_OBJECT_PTR(histogram);  // see crbug.com/79322
-        histogram_to_return = histogram;
-      } else if (histogram == it->second) {
-        // The histogram was registered before.
-        histogram_to_return = histogram;
-      } else {
-        // We already have one histogram with this name.
-        histogram_to_return = it->second;
-        histogram_to_delete = histogram;
-      }
-    }
+  uint32 name_hash = Hash(histogram->histogram_name());
+  HistogramShard* shard = GetShard(name_hash);
+  if (!shard)
+    return histogram;
+
+  bool inserted = false;
+  HistogramBase* registered =
+      shard->FindOrInsert(histogram, name_hash, &inserted);
+  if (inserted)
+    ANNOTATE_LEAKING_OBJECT_PTR(histogram);  // see crbug.com/79322
+  if (registered == histogram) {
+    // Either newly registered, or registered before.
+    return histogram;
   }
-  delete histogram_to_delete;
-  return histogram_to_return;
+  // We already have one histogram with this name.
+  delete histogram;
+  return registered;
 }
 
 // static
@@ -196,18 +338,16 @@ std::string StatisticsRecorder::ToJSON(const std::string& query) {
 
 // static
 void StatisticsRecorder::GetHistograms(Histograms* output) {
-  if (lock_ == NULL)
-    return;
-  base::AutoLock auto_lock(*lock_);
-  if (histograms_ == NULL)
+  HistogramShard* shards = reinterpret_cast<HistogramShard*>(
+      subtle::Acquire_Load(&histogram_shards_));
+  if (!shards)
     return;
 
-  for (HistogramMap::iterator it = histograms_->begin();
-       histograms_->end() != it;
-       ++it) {
-    DCHECK_EQ(it->first, it->second->histogram_name());
-    output->push_back(it->second);
-  }
+  // Keep the name order the recorder has always reported.
+  size_t first_new = output->size();
+  for (size_t i = 0; i < kNumShards; ++i)
+    shards[i].GetAll(output);
+  std::sort(output->begin() + first_new, output->end(), &HistogramNameLess);
 }
 
 // static
@@ -234,40 +374,40 @@ void StatisticsRecorder::GetBucketRanges(
 
 // static
 HistogramBase* StatisticsRecorder::FindHistogram(const std::string& name) {
-  if (lock_ == NULL)
-    return NULL;
-  base::AutoLock auto_lock(*lock_);
-  if (histograms_ == NULL)
+  uint32 name_hash = Hash(name);
+  HistogramShard* shard = GetShard(name_hash);
+  if (!shard)
     return NULL;
-
-  HistogramMap::iterator it = histograms_->find(name);
-  if (histograms_->end() == it)
-    return NULL;
-  return it->second;
+  return shard->Find(name, name_hash);
 }
 
 // private static
 void StatisticsRecorder::GetSnapshot(const std::string& query,
                                      Histograms* snapshot) {
-  if (lock_ == NULL)
-    return;
-  base::AutoLock auto_lock(*lock_);
-  if (histograms_ == NULL)
-    return;
-
-  for (HistogramMap::iterator it = histograms_->begin();
-       histograms_->end() != it;
-       ++it) {
-    if (it->first.find(query) != std::string::npos)
-      snapshot->push_back(it->second);
+  HistogramBatch::FlushAll();
+
+  Histograms histograms;
+  GetHistograms(&histograms);
+  for (Histograms::const_iterator it = histograms.begin();
+       it != histograms.end(); ++it) {
+    if ((*it)->histogram_name().find(query) != std::string::npos)
+      snapshot->push_back(*it);
   }
 }
 
+// static
+StatisticsRecorder::HistogramShard* StatisticsRecorder::GetShard(
+    uint32 name_hash) {
+  HistogramShard* shards = reinterpret_cast<HistogramShard*>(
+      subtle::Acquire_Load(&histogram_shards_));
+  return shards ? &shards[name_hash % kNumShards] : NULL;
+}
+
 // This singleton instance should be started during the single threaded portion
 // of main(), and hence it is not thread safe.  It initializes globals to
 // provide support for all future calls.
 StatisticsRecorder::StatisticsRecorder() {
-  DCHECK(!histograms_);
+  DCHECK(!subtle::NoBarrier_Load(&histogram_shards_));
   if (lock_ == NULL) {
     // This will leak on purpose. It's the only way to make sure we won't race
     // against the static uninitialization of the module while one of our
@@ -278,7 +418,9 @@ StatisticsRecorder::StatisticsRecorder() {
     lock_ = new base::Lock;
   }
   base::AutoLock auto_lock(*lock_);
-  histograms_ = new HistogramMap;
+  subtle::Release_Store(
+      &histogram_shards_,
+      reinterpret_cast<subtle::AtomicWord>(new HistogramShard[kNumShards]));
   ranges_ = new RangesMap;
 
   if (VLOG_IS_ON(1))
@@ -296,18 +438,20 @@ void StatisticsRecorder::DumpHistogramsToVlog(void* instance) {
 }
 
 StatisticsRecorder::~StatisticsRecorder() {
-  DCHECK(histograms_ && ranges_ && lock_);
+  DCHECK(subtle::NoBarrier_Load(&histogram_shards_) && ranges_ && lock_);
 
-  // Clean up.
-  scoped_ptr<HistogramMap> histograms_deleter;
+  // Clean up. Nothing may be looking up histograms while the recorder is
+  // destroyed, which only happens in tests.
+  scoped_ptr<HistogramShard[]> histograms_deleter;
   scoped_ptr<RangesMap> ranges_deleter;
   // We don't delete lock_ on purpose to avoid having to properly protect
   // against it going away after we checked for NULL in the static methods.
   {
     base::AutoLock auto_lock(*lock_);
-    histograms_deleter.reset(histograms_);
+    histograms_deleter.reset(reinterpret_cast<HistogramShard*>(
+        subtle::NoBarrier_Load(&histogram_shards_)));
     ranges_deleter.reset(ranges_);
-    histograms_ = NULL;
+    subtle::Release_Store(&histogram_shards_, 0);
     ranges_ = NULL;
   }
   // We are going to leak the histograms and the ranges.
@@ -315,7 +459,9 @@ StatisticsRecorder::~StatisticsRecorder() {
 
 
 // static
-StatisticsRecorder::HistogramMap* StatisticsRecorder::histograms_ = NULL;
+const size_t StatisticsRecorder::kNumShards;
+// static
+subtle::AtomicWord StatisticsRecorder::histogram_shards_ = 0;
 // static
 StatisticsRecorder::RangesMap* StatisticsRecorder::ranges_ = NULL;
 // static
@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 
+#include "base/atomicops.h"
 #include "base/base_export.h"
 #include "base/basictypes.h"
 #include "base/gtest_prod_util.h"
@@ -66,18 +67,24 @@ class BASE_EXPORT StatisticsRecorder {
   static void GetBucketRanges(std::vector<const BucketRanges*>* output);
 
   // Find a histogram by name. It matches the exact name. This method is thread
-  // safe.  It returns NULL if a matching histogram is not found.
+  // safe and takes no lock.  It returns NULL if a matching histogram is not
+  // found.
   static HistogramBase* FindHistogram(const std::string& name);
 
   // GetSnapshot copies some of the pointers to registered histograms into the
   // caller supplied vector (Histograms). Only histograms which have |query| as
   // a substring are copied (an empty string will process all registered
-  // histograms).
+  // histograms). Samples batched by HistogramBatch are flushed first, so the
+  // histograms are up to date.
   static void GetSnapshot(const std::string& query, Histograms* snapshot);
 
  private:
-  // We keep all registered histograms in a map, from name to histogram.
-  typedef std::map<std::string, HistogramBase*> HistogramMap;
+  // Registered histograms are spread over kNumShards shards by a hash of their
+  // name, so that registering unrelated histograms does not contend on one
+  // lock. Each shard is an insert-only hash table that can be searched without
+  // locking.
+  class HistogramShard;
+  static const size_t kNumShards = 16;
 
   // We keep all |bucket_ranges_| in a map, from checksum to a list of
   // |bucket_ranges_|.  Checksum is calculated from the |ranges_| in
@@ -86,6 +93,7 @@ class BASE_EXPORT StatisticsRecorder {
 
   friend struct DefaultLazyInstanceTraits<StatisticsRecorder>;
   friend class HistogramBaseTest;
+  friend class HistogramBatchTest;
   friend class HistogramSnapshotManagerTest;
   friend class HistogramTest;
   friend class SparseHistogramTest;
@@ -102,10 +110,15 @@ class BASE_EXPORT StatisticsRecorder {
 
   static void DumpHistogramsToVlog(void* instance);
 
-  static HistogramMap* histograms_;
+  // Returns the shard that holds histograms with the given name hash.
+  static HistogramShard* GetShard(uint32 name_hash);
+
+  // An array of kNumShards shards, or NULL while no StatisticsRecorder exists.
+  // Read without holding |lock_|.
+  static subtle::AtomicWord histogram_shards_;
   static RangesMap* ranges_;
 
-  // Lock protects access to above maps.
+  // Lock protects access to |ranges_|, and to changes of |histogram_shards_|.
   static base::Lock* lock_;
 
   DISALLOW_COPY_AND_ASSIGN(StatisticsRecorder);
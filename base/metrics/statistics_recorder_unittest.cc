@@ -6,8 +6,11 @@
 
 #include "base/json/json_reader.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/metrics/histogram.h"
 #include "base/metrics/statistics_recorder.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/simple_thread.h"
 #include "base/values.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -325,4 +328,80 @@ TEST_F(StatisticsRecorderTest, ToJSON) {
   EXPECT_TRUE(json.empty());
 }
 
+// Enough histograms that every shard has to grow several times.
+TEST_F(StatisticsRecorderTest, ManyHistograms) {
+  const int kNumHistograms = 2000;
+  std::vector<HistogramBase*> histograms;
+  for (int i = kNumHistograms - 1; i >= 0; --i) {
+    histograms.push_back(Histogram::FactoryGet(
+        StringPrintf("Test.%04d", i), 1, 1000, 10, HistogramBase::kNoFlags));
+  }
+
+  for (int i = 0; i < kNumHistograms; ++i) {
+    EXPECT_EQ(histograms[kNumHistograms - 1 - i],
+              StatisticsRecorder::FindHistogram(StringPrintf("Test.%04d", i)));
+  }
+  EXPECT_TRUE(StatisticsRecorder::FindHistogram("Test.") == NULL);
+
+  // Histograms are reported in name order, whatever the registration order.
+  StatisticsRecorder::Histograms registered_histograms;
+  StatisticsRecorder::GetHistograms(&registered_histograms);
+  ASSERT_EQ(static_cast<size_t>(kNumHistograms), registered_histograms.size());
+  for (int i = 0; i < kNumHistograms; ++i) {
+    EXPECT_EQ(StringPrintf("Test.%04d", i),
+              registered_histograms[i]->histogram_name());
+  }
+}
+
+namespace {
+
+// Registers, and then looks up, its own set of histograms.
+class RegisteringDelegate : public DelegateSimpleThread::Delegate {
+ public:
+  explicit RegisteringDelegate(int id) : id_(id), failures_(0) {}
+
+  int failures() const { return failures_; }
+
+  virtual void Run() OVERRIDE {
+    const int kNumHistograms = 200;
+    for (int i = 0; i < kNumHistograms; ++i) {
+      std::string name = StringPrintf("Thread%d.%d", id_, i);
+      HistogramBase* histogram =
+          Histogram::FactoryGet(name, 1, 1000, 10, HistogramBase::kNoFlags);
+      if (StatisticsRecorder::FindHistogram(name) != histogram)
+        ++failures_;
+      // Every thread also races to create the same shared histogram.
+      HistogramBase* shared =
+          Histogram::FactoryGet("Shared", 1, 1000, 10, HistogramBase::kNoFlags);
+      if (StatisticsRecorder::FindHistogram("Shared") != shared)
+        ++failures_;
+    }
+  }
+
+ private:
+  const int id_;
+  int failures_;
+};
+
+}  // namespace
+
+TEST_F(StatisticsRecorderTest, ConcurrentRegistration) {
+  const int kNumThreads = 8;
+  DelegateSimpleThreadPool pool("Registration", kNumThreads);
+  ScopedVector<RegisteringDelegate> delegates;
+  for (int i = 0; i < kNumThreads; ++i) {
+    delegates.push_back(new RegisteringDelegate(i));
+    pool.AddWork(delegates.back());
+  }
+  pool.Start();
+  pool.JoinAll();
+
+  for (int i = 0; i < kNumThreads; ++i)
+    EXPECT_EQ(0, delegates[i]->failures());
+  StatisticsRecorder::Histograms registered_histograms;
+  StatisticsRecorder::GetHistograms(&registered_histograms);
+  EXPECT_EQ(static_cast<size_t>(kNumThreads * 200 + 1),
+            registered_histograms.size());
+}
+
 }  // namespace base
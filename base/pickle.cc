@@ -7,6 +7,7 @@
 #include <stdlib.h>
 
 #include <algorithm>  // for max()
+#include <limits>
 
 //------------------------------------------------------------------------------
 
@@ -307,6 +308,25 @@ const char* Pickle::FindNext(size_t header_size,
   return start + header_size + hdr->payload_size;
 }
 
+// static
+bool Pickle::PeekNext(size_t header_size,
+                      const char* start,
+                      const char* end,
+                      size_t* pickle_size) {
+  DCHECK_EQ(header_size, AlignInt(header_size, sizeof(uint32)));
+  DCHECK_LE(header_size, static_cast<size_t>(kPayloadUnit));
+
+  size_t length = static_cast<size_t>(end - start);
+  if (length < sizeof(Header))
+    return false;
+
+  const Header* hdr = reinterpret_cast<const Header*>(start);
+  if (hdr->payload_size > std::numeric_limits<size_t>::max() - header_size)
+    return false;
+  *pickle_size = header_size + hdr->payload_size;
+  return true;
+}
+
 template <size_t length> void Pickle::WriteBytesStatic(const void* data) {
   WriteBytesCommon(data, length);
 }
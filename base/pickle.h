@@ -314,11 +314,20 @@ class BASE_EXPORT Pickle {
                               const char* range_start,
                               const char* range_end);
 
+  // Sets |pickle_size| to the size of the pickle that starts at range_start,
+  // header included, and returns true. Returns false if the range does not
+  // hold enough of the header to tell.
+  static bool PeekNext(size_t header_size,
+                       const char* range_start,
+                       const char* range_end,
+                       size_t* pickle_size);
+
   // The allocation granularity of the payload.
   static const int kPayloadUnit;
 
  private:
   friend class PickleIterator;
+  friend class SegmentedPickle;
 
   Header* header_;
   size_t header_size_;  // Supports extra data between header and payload.
@@ -343,6 +352,7 @@ class BASE_EXPORT Pickle {
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNext);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNextWithIncompleteHeader);
   FRIEND_TEST_ALL_PREFIXES(PickleTest, FindNextOverflow);
+  FRIEND_TEST_ALL_PREFIXES(PickleTest, PeekNext);
 };
 
 #endif  // BASE_PICKLE_H__
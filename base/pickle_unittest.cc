@@ -185,6 +185,27 @@ TEST(PickleTest, FindNextWithIncompleteHeader) {
   EXPECT_TRUE(NULL == Pickle::FindNext(header_size, start, end));
 }
 
+TEST(PickleTest, PeekNext) {
+  Pickle pickle;
+  EXPECT_TRUE(pickle.WriteInt(1));
+  EXPECT_TRUE(pickle.WriteString("Domo"));
+
+  const char* start = reinterpret_cast<const char*>(pickle.data());
+  const char* end = start + pickle.size();
+
+  // Only the header is needed to tell the size.
+  size_t pickle_size = 0;
+  EXPECT_TRUE(Pickle::PeekNext(pickle.header_size_, start,
+                               start + sizeof(Pickle::Header), &pickle_size));
+  EXPECT_EQ(pickle.size(), pickle_size);
+  pickle_size = 0;
+  EXPECT_TRUE(Pickle::PeekNext(pickle.header_size_, start, end, &pickle_size));
+  EXPECT_EQ(pickle.size(), pickle_size);
+  EXPECT_FALSE(Pickle::PeekNext(pickle.header_size_, start,
+                                start + sizeof(Pickle::Header) - 1,
+                                &pickle_size));
+}
+
 #if defined(COMPILER_MSVC)
 #pragma warning(push)
 #pragma warning(disable: 4146)
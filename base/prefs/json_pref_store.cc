@@ -5,10 +5,13 @@
 #include "base/prefs/json_pref_store.h"
 
 #include <algorithm>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/callback.h"
+#include "base/critical_closure.h"
 #include "base/file_util.h"
+#include "base/files/important_file_writer.h"
 #include "base/json/json_file_value_serializer.h"
 #include "base/json/json_string_value_serializer.h"
 #include "base/memory/ref_counted.h"
@@ -23,6 +26,10 @@ namespace {
 // Some extensions we'll tack on to copies of the Preferences files.
 const base::FilePath::CharType* kBadExtension = FILE_PATH_LITERAL("bad");
 
+// Time to wait after a change before writing, so that changes made in quick
+// succession are written together. Same as ImportantFileWriter's default.
+const int kCommitIntervalMs = 10000;
+
 // Differentiates file loading between origin thread and passed
 // (aka file) thread.
 class FileThreadDeserializer
@@ -141,6 +148,53 @@ void FileThreadDeserializer::HandleErrors(
 
 }  // namespace
 
+// Keeps a copy of the preferences on the sequenced task runner, which is kept
+// up to date with the values changed on the origin thread, and serializes it
+// to disk from there.
+class JsonPrefStore::BackgroundWriter {
+ public:
+  explicit BackgroundWriter(const base::FilePath& path)
+      : path_(path),
+        contents_(new base::DictionaryValue()) {}
+
+  // Replaces the whole copy with |contents|, if not NULL. Then removes the
+  // |removed_paths| and sets the values in |changes|, which are keyed by their
+  // full path, and writes the result out.
+  void Write(scoped_ptr<base::DictionaryValue> contents,
+             scoped_ptr<base::DictionaryValue> changes,
+             const std::vector<std::string>& removed_paths) {
+    if (contents)
+      contents_ = contents.Pass();
+    for (std::vector<std::string>::const_iterator it = removed_paths.begin();
+         it != removed_paths.end(); ++it) {
+      contents_->RemovePath(*it, NULL);
+    }
+    while (!changes->empty()) {
+      const std::string path =
+          base::DictionaryValue::Iterator(*changes).key();
+      scoped_ptr<base::Value> value;
+      changes->RemoveWithoutPathExpansion(path, &value);
+      contents_->Set(path, value.release());
+    }
+
+    std::string data;
+    JSONStringValueSerializer serializer(&data);
+    serializer.set_pretty_print(true);
+    if (!serializer.Serialize(*contents_)) {
+      DLOG(WARNING) << "failed to serialize data to be saved in "
+                    << path_.value();
+      return;
+    }
+    base::ImportantFileWriter::WriteFileAtomically(path_, data);
+  }
+
+ private:
+  const base::FilePath path_;
+  scoped_ptr<base::DictionaryValue> contents_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundWriter);
+};
+
 scoped_refptr<base::SequencedTaskRunner> JsonPrefStore::GetTaskRunnerForFile(
     const base::FilePath& filename,
     base::SequencedWorkerPool* worker_pool) {
@@ -158,7 +212,8 @@ JsonPrefStore::JsonPrefStore(const base::FilePath& filename,
       sequenced_task_runner_(sequenced_task_runner),
       prefs_(new base::DictionaryValue()),
       read_only_(false),
-      writer_(filename, sequenced_task_runner),
+      all_paths_dirty_(true),
+      background_writer_(new BackgroundWriter(filename)),
       pref_filter_(pref_filter.Pass()),
       initialized_(false),
       read_error_(PREF_READ_ERROR_OTHER) {}
@@ -215,7 +270,7 @@ void JsonPrefStore::SetValueSilently(const std::string& key,
   if (!old_value || !value->Equals(old_value)) {
     prefs_->Set(key, new_value.release());
     if (!read_only_)
-      writer_.ScheduleWrite(this);
+      ScheduleWrite(key);
   }
 }
 
@@ -262,8 +317,10 @@ void JsonPrefStore::ReadPrefsAsync(ReadErrorDelegate *error_delegate) {
 }
 
 void JsonPrefStore::CommitPendingWrite() {
-  if (writer_.HasPendingWrite() && !read_only_)
-    writer_.DoScheduledWrite();
+  if (write_timer_.IsRunning() && !read_only_) {
+    write_timer_.Stop();
+    DoScheduledWrite();
+  }
 }
 
 void JsonPrefStore::ReportValueChanged(const std::string& key) {
@@ -273,7 +330,7 @@ void JsonPrefStore::ReportValueChanged(const std::string& key) {
   FOR_EACH_OBSERVER(PrefStore::Observer, observers_, OnPrefValueChanged(key));
 
   if (!read_only_)
-    writer_.ScheduleWrite(this);
+    ScheduleWrite(key);
 }
 
 void JsonPrefStore::OnFileRead(base::Value* value_owned,
@@ -290,6 +347,10 @@ void JsonPrefStore::OnFileRead(base::Value* value_owned,
   }
 
   initialized_ = true;
+  // The loaded values, and any changes made by |pref_filter_| while loading,
+  // haven't been seen by |background_writer_|.
+  all_paths_dirty_ = true;
+  dirty_paths_.clear();
 
   switch (error) {
     case PREF_READ_ERROR_ACCESS_DENIED:
@@ -327,13 +388,53 @@ void JsonPrefStore::OnFileRead(base::Value* value_owned,
 
 JsonPrefStore::~JsonPrefStore() {
   CommitPendingWrite();
+  // Runs after any write posted above.
+  if (!sequenced_task_runner_->DeleteSoon(FROM_HERE, background_writer_))
+    delete background_writer_;
 }
 
-bool JsonPrefStore::SerializeData(std::string* output) {
+void JsonPrefStore::ScheduleWrite(const std::string& key) {
+  if (!all_paths_dirty_)
+    dirty_paths_.insert(key);
+  if (!write_timer_.IsRunning()) {
+    write_timer_.Start(FROM_HERE,
+                       base::TimeDelta::FromMilliseconds(kCommitIntervalMs),
+                       this, &JsonPrefStore::DoScheduledWrite);
+  }
+}
+
+void JsonPrefStore::DoScheduledWrite() {
   if (pref_filter_)
     pref_filter_->FilterSerializeData(prefs_.get());
 
-  JSONStringValueSerializer serializer(output);
-  serializer.set_pretty_print(true);
-  return serializer.Serialize(*prefs_);
+  // Only the changed values are copied here; serializing the whole tree
+  // happens on |sequenced_task_runner_|.
+  scoped_ptr<base::DictionaryValue> contents;
+  scoped_ptr<base::DictionaryValue> changes(new base::DictionaryValue());
+  std::vector<std::string> removed_paths;
+  if (all_paths_dirty_) {
+    contents.reset(prefs_->DeepCopy());
+  } else {
+    for (std::set<std::string>::const_iterator it = dirty_paths_.begin();
+         it != dirty_paths_.end(); ++it) {
+      const base::Value* value = NULL;
+      if (prefs_->Get(*it, &value))
+        changes->SetWithoutPathExpansion(*it, value->DeepCopy());
+      else
+        removed_paths.push_back(*it);
+    }
+  }
+  all_paths_dirty_ = false;
+  dirty_paths_.clear();
+
+  const base::Closure write = base::Bind(
+      &BackgroundWriter::Write, base::Unretained(background_writer_),
+      base::Passed(&contents), base::Passed(&changes), removed_paths);
+  if (!sequenced_task_runner_->PostTask(FROM_HERE,
+                                        base::MakeCriticalClosure(write))) {
+    // Posting the task to the background sequence is not expected to fail,
+    // but if it does, avoid losing data and write on the current thread.
+    NOTREACHED();
+    write.Run();
+  }
 }
@@ -11,12 +11,12 @@
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/files/file_path.h"
-#include "base/files/important_file_writer.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/observer_list.h"
 #include "base/prefs/base_prefs_export.h"
 #include "base/prefs/persistent_pref_store.h"
+#include "base/timer/timer.h"
 
 class PrefFilter;
 
@@ -30,9 +30,12 @@ class Value;
 
 
 // A writable PrefStore implementation that is used for user preferences.
-class BASE_PREFS_EXPORT JsonPrefStore
-    : public PersistentPrefStore,
-      public base::ImportantFileWriter::DataSerializer {
+//
+// Writes are batched and serialized on |sequenced_task_runner|, which keeps
+// its own copy of the preferences. Each write only copies the values of the
+// preferences that changed since the previous one, so the cost on the calling
+// thread doesn't grow with the size of the whole file.
+class BASE_PREFS_EXPORT JsonPrefStore : public PersistentPrefStore {
  public:
   // Returns instance of SequencedTaskRunner which guarantees that file
   // operations on the same file will be executed in sequenced order.
@@ -75,10 +78,15 @@ class BASE_PREFS_EXPORT JsonPrefStore
   void OnFileRead(base::Value* value_owned, PrefReadError error, bool no_dir);
 
  private:
+  class BackgroundWriter;
+
   virtual ~JsonPrefStore();
 
-  // ImportantFileWriter::DataSerializer overrides:
-  virtual bool SerializeData(std::string* output) OVERRIDE;
+  // Records that the value at |key| must be written, and schedules a write.
+  void ScheduleWrite(const std::string& key);
+
+  // Sends the changed values to |background_writer_|, which writes them out.
+  void DoScheduledWrite();
 
   base::FilePath path_;
   const scoped_refptr<base::SequencedTaskRunner> sequenced_task_runner_;
@@ -87,8 +95,16 @@ class BASE_PREFS_EXPORT JsonPrefStore
 
   bool read_only_;
 
-  // Helper for safely writing pref data.
-  base::ImportantFileWriter writer_;
+  // Batches the writes requested within the commit interval.
+  base::OneShotTimer<JsonPrefStore> write_timer_;
+
+  // The paths of the preferences that changed since the last write, unless
+  // all of them must be written (e.g. after loading the file).
+  std::set<std::string> dirty_paths_;
+  bool all_paths_dirty_;
+
+  // Serializes and writes the preferences. Lives on |sequenced_task_runner_|.
+  BackgroundWriter* background_writer_;
 
   scoped_ptr<PrefFilter> pref_filter_;
   ObserverList<PrefStore::Observer, true> observers_;
@@ -257,6 +257,53 @@ TEST_F(JsonPrefStoreTest, PreserveEmptyValues) {
   EXPECT_TRUE(DictionaryValue().Equals(result));
 }
 
+// Writes after the first one only send the changed values to the background
+// sequence; the file must still reflect every change.
+TEST_F(JsonPrefStoreTest, IncrementalWrites) {
+  FilePath pref_file = temp_dir_.path().AppendASCII("incremental.json");
+
+  scoped_refptr<JsonPrefStore> pref_store = new JsonPrefStore(
+      pref_file,
+      message_loop_.message_loop_proxy(),
+      scoped_ptr<PrefFilter>());
+  pref_store->SetValue("unchanged", new base::StringValue("value"));
+  pref_store->SetValue("a.b", new base::FundamentalValue(1));
+  pref_store->SetValue("a.c", new base::FundamentalValue(2));
+  pref_store->CommitPendingWrite();
+  RunLoop().RunUntilIdle();
+
+  pref_store->SetValue("a.b", new base::FundamentalValue(3));
+  pref_store->RemoveValue("a.c");
+  pref_store->SetValue("d", new base::ListValue);
+  base::Value* mutable_value = NULL;
+  ASSERT_TRUE(pref_store->GetMutableValue("d", &mutable_value));
+  static_cast<base::ListValue*>(mutable_value)->AppendString("item");
+  pref_store->ReportValueChanged("d");
+  pref_store->CommitPendingWrite();
+  RunLoop().RunUntilIdle();
+
+  pref_store = new JsonPrefStore(
+      pref_file,
+      message_loop_.message_loop_proxy(),
+      scoped_ptr<PrefFilter>());
+  ASSERT_EQ(PersistentPrefStore::PREF_READ_ERROR_NONE, pref_store->ReadPrefs());
+
+  const Value* result = NULL;
+  std::string string_value;
+  ASSERT_TRUE(pref_store->GetValue("unchanged", &result));
+  EXPECT_TRUE(result->GetAsString(&string_value));
+  EXPECT_EQ("value", string_value);
+  int integer = 0;
+  ASSERT_TRUE(pref_store->GetValue("a.b", &result));
+  EXPECT_TRUE(result->GetAsInteger(&integer));
+  EXPECT_EQ(3, integer);
+  EXPECT_FALSE(pref_store->GetValue("a.c", NULL));
+  ListValue expected_list;
+  expected_list.AppendString("item");
+  ASSERT_TRUE(pref_store->GetValue("d", &result));
+  EXPECT_TRUE(expected_list.Equals(result));
+}
+
 // This test is just documenting some potentially non-obvious behavior. It
 // shouldn't be taken as normative.
 TEST_F(JsonPrefStoreTest, RemoveClearsEmptyParent) {
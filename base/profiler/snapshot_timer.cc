@@ -0,0 +1,42 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/profiler/snapshot_timer.h"
+
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/tracked_objects.h"
+
+namespace tracked_objects {
+
+SnapshotTimer::SnapshotTimer(base::TimeDelta interval,
+                             const SnapshotCallback& callback)
+    : interval_(interval),
+      callback_(callback) {
+  DCHECK(interval_ > base::TimeDelta());
+  DCHECK(!callback_.is_null());
+}
+
+SnapshotTimer::~SnapshotTimer() {
+}
+
+void SnapshotTimer::Start() {
+  timer_.Start(FROM_HERE, interval_, this, &SnapshotTimer::TakeSnapshot);
+}
+
+void SnapshotTimer::Stop() {
+  timer_.Stop();
+}
+
+bool SnapshotTimer::IsRunning() const {
+  return timer_.IsRunning();
+}
+
+void SnapshotTimer::TakeSnapshot() {
+  ProcessDataSnapshot process_data;
+  ThreadData::Snapshot(true, &process_data);
+  callback_.Run(process_data);
+}
+
+}  // namespace tracked_objects
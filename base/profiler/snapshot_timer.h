@@ -0,0 +1,51 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_PROFILER_SNAPSHOT_TIMER_H_
+#define BASE_PROFILER_SNAPSHOT_TIMER_H_
+
+//------------------------------------------------------------------------------
+// SnapshotTimer periodically takes a ThreadData::Snapshot() of the profiled
+// tasks and hands it to a callback, e.g. so that the profiles of sampled tasks
+// (see ThreadData::SetSampleRate()) can be reported from the field through
+// the same ProcessDataSnapshot path that about:profiler uses.  The max values
+// of each task are reset by every snapshot, so that they cover one interval.
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace tracked_objects {
+
+struct ProcessDataSnapshot;
+
+class BASE_EXPORT SnapshotTimer {
+ public:
+  typedef base::Callback<void(const ProcessDataSnapshot&)> SnapshotCallback;
+
+  // Snapshots are taken every |interval| on the thread that calls Start(),
+  // which must have a MessageLoop.
+  SnapshotTimer(base::TimeDelta interval, const SnapshotCallback& callback);
+  ~SnapshotTimer();
+
+  void Start();
+  void Stop();
+  bool IsRunning() const;
+
+  // Takes a snapshot and runs the callback with it right away.
+  void TakeSnapshot();
+
+ private:
+  const base::TimeDelta interval_;
+  const SnapshotCallback callback_;
+  base::RepeatingTimer<SnapshotTimer> timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(SnapshotTimer);
+};
+
+}  // namespace tracked_objects
+
+#endif  // BASE_PROFILER_SNAPSHOT_TIMER_H_
@@ -0,0 +1,200 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/segmented_pickle.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/lazy_instance.h"
+#include "base/threading/thread_local_storage.h"
+
+using base::char16;
+using base::string16;
+
+// static
+const size_t SegmentedPickle::kSegmentSize = 16 * 1024;
+
+namespace {
+
+// At most this many idle segments are kept around per thread. Anything beyond
+// that goes back to the allocator.
+const size_t kMaxFreeSegmentsPerThread = 32;
+
+size_t AlignInt(size_t i, int alignment) {
+  return i + (alignment - (i % alignment)) % alignment;
+}
+
+// A per-thread free list of segments. Segments may be allocated on one thread
+// and released on another; they simply migrate to the releasing thread's list.
+class SegmentArena {
+ public:
+  SegmentArena() {}
+
+  ~SegmentArena() {
+    for (size_t i = 0; i < free_segments_.size(); ++i)
+      free(free_segments_[i]);
+  }
+
+  char* Allocate() {
+    if (free_segments_.empty()) {
+      void* segment = malloc(SegmentedPickle::kSegmentSize);
+      CHECK(segment);
+      return static_cast<char*>(segment);
+    }
+    char* segment = free_segments_.back();
+    free_segments_.pop_back();
+    return segment;
+  }
+
+  void Release(char* segment) {
+    if (free_segments_.size() < kMaxFreeSegmentsPerThread)
+      free_segments_.push_back(segment);
+    else
+      free(segment);
+  }
+
+ private:
+  std::vector<char*> free_segments_;
+
+  DISALLOW_COPY_AND_ASSIGN(SegmentArena);
+};
+
+void DeleteArenaOnThreadExit(void* value) {
+  delete static_cast<SegmentArena*>(value);
+}
+
+struct ArenaSlot {
+  ArenaSlot() : slot(&DeleteArenaOnThreadExit) {}
+  base::ThreadLocalStorage::Slot slot;
+};
+
+base::LazyInstance<ArenaSlot>::Leaky g_arena_slot = LAZY_INSTANCE_INITIALIZER;
+
+SegmentArena* GetArenaForCurrentThread() {
+  base::ThreadLocalStorage::Slot& slot = g_arena_slot.Get().slot;
+  SegmentArena* arena = static_cast<SegmentArena*>(slot.Get());
+  if (!arena) {
+    arena = new SegmentArena;
+    slot.Set(arena);
+  }
+  return arena;
+}
+
+}  // namespace
+
+SegmentedPickle::SegmentedPickle()
+    : header_size_(sizeof(Pickle::Header)),
+      last_segment_used_(0),
+      write_offset_(0) {
+  AddSegment();
+  last_segment_used_ = header_size_;
+  header()->payload_size = 0;
+}
+
+SegmentedPickle::SegmentedPickle(int header_size)
+    : header_size_(AlignInt(header_size, sizeof(uint32))),
+      last_segment_used_(0),
+      write_offset_(0) {
+  DCHECK_GE(static_cast<size_t>(header_size), sizeof(Pickle::Header));
+  DCHECK_LE(header_size_, kSegmentSize);
+  AddSegment();
+  memset(segments_[0], 0, header_size_);
+  last_segment_used_ = header_size_;
+}
+
+SegmentedPickle::~SegmentedPickle() {
+  SegmentArena* arena = GetArenaForCurrentThread();
+  for (size_t i = 0; i < segments_.size(); ++i)
+    arena->Release(segments_[i]);
+}
+
+size_t SegmentedPickle::segment_size(size_t index) const {
+  DCHECK_LT(index, segments_.size());
+  if (index + 1 < segments_.size())
+    return kSegmentSize;
+  // Trim the padding after the last value; it is not part of size().
+  return last_segment_used_ - (write_offset_ - payload_size());
+}
+
+void SegmentedPickle::Flatten(Pickle* pickle) const {
+  DCHECK_EQ(header_size_, pickle->header_size_);
+  DCHECK_EQ(0u, pickle->write_offset_);
+  pickle->Resize(write_offset_);
+  char* dest = reinterpret_cast<char*>(pickle->header_);
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    size_t used = i + 1 < segments_.size() ? kSegmentSize : last_segment_used_;
+    memcpy(dest, segments_[i], used);
+    dest += used;
+  }
+  pickle->write_offset_ = write_offset_;
+}
+
+bool SegmentedPickle::WriteString(const std::string& value) {
+  if (!WriteInt(static_cast<int>(value.size())))
+    return false;
+
+  return WriteBytes(value.data(), static_cast<int>(value.size()));
+}
+
+bool SegmentedPickle::WriteWString(const std::wstring& value) {
+  if (!WriteInt(static_cast<int>(value.size())))
+    return false;
+
+  return WriteBytes(value.data(),
+                    static_cast<int>(value.size() * sizeof(wchar_t)));
+}
+
+bool SegmentedPickle::WriteString16(const string16& value) {
+  if (!WriteInt(static_cast<int>(value.size())))
+    return false;
+
+  return WriteBytes(value.data(),
+                    static_cast<int>(value.size()) * sizeof(char16));
+}
+
+bool SegmentedPickle::WriteData(const char* data, int length) {
+  return length >= 0 && WriteInt(length) && WriteBytes(data, length);
+}
+
+bool SegmentedPickle::WriteBytes(const void* data, int length) {
+  WriteBytesCommon(data, length);
+  return true;
+}
+
+void SegmentedPickle::WriteBytesCommon(const void* data, size_t length) {
+  size_t data_len = AlignInt(length, sizeof(uint32));
+  DCHECK_GE(data_len, length);
+#ifdef ARCH_CPU_64_BITS
+  DCHECK_LE(data_len, kuint32max);
+#endif
+  DCHECK_LE(write_offset_, kuint32max - data_len);
+
+  // Both the segment size and every write are multiples of 32 bits, so a
+  // value's padding always lands in the same segment as its last byte.
+  const char* source = static_cast<const char*>(data);
+  size_t remaining = length;
+  while (remaining > 0) {
+    if (last_segment_used_ == kSegmentSize)
+      AddSegment();
+    size_t chunk = std::min(remaining, kSegmentSize - last_segment_used_);
+    memcpy(segments_.back() + last_segment_used_, source, chunk);
+    last_segment_used_ += chunk;
+    source += chunk;
+    remaining -= chunk;
+  }
+  size_t padding = data_len - length;
+  memset(segments_.back() + last_segment_used_, 0, padding);
+  last_segment_used_ += padding;
+
+  header()->payload_size = static_cast<uint32>(write_offset_ + length);
+  write_offset_ += data_len;
+}
+
+void SegmentedPickle::AddSegment() {
+  segments_.push_back(GetArenaForCurrentThread()->Allocate());
+  last_segment_used_ = 0;
+}
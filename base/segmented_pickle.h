@@ -0,0 +1,134 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BASE_SEGMENTED_PICKLE_H_
+#define BASE_SEGMENTED_PICKLE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/base_export.h"
+#include "base/basictypes.h"
+#include "base/logging.h"
+#include "base/pickle.h"
+#include "base/strings/string16.h"
+
+// A write-only variant of Pickle whose data lives in a chain of fixed-size
+// segments instead of one contiguous, growing buffer. Segments are drawn from
+// a small per-thread free list, so building a large pickle never reallocates
+// or copies what has already been written, and building many of them on the
+// same thread reuses the same memory.
+//
+// The bytes produced are identical to those of a Pickle that had the same
+// values written to it: concatenating segment_data(i) for every segment yields
+// exactly what Pickle::data() would hold. Callers that can consume the data in
+// pieces (e.g. with writev()) should do so; callers that need a contiguous
+// view can call Flatten().
+class BASE_EXPORT SegmentedPickle {
+ public:
+  // The capacity of each segment, header included.
+  static const size_t kSegmentSize;
+
+  // Initializes using the default header size.
+  SegmentedPickle();
+
+  // Initializes with the specified header size in bytes, which must be
+  // greater-than-or-equal-to sizeof(Pickle::Header). As with Pickle, the
+  // header size is rounded up to a multiple of 32 bits.
+  explicit SegmentedPickle(int header_size);
+
+  // Returns all segments to the current thread's free list.
+  ~SegmentedPickle();
+
+  // Returns the header, cast to a user-specified type T. See Pickle::headerT.
+  template <class T>
+  T* headerT() {
+    DCHECK_EQ(header_size_, sizeof(T));
+    return reinterpret_cast<T*>(segments_[0]);
+  }
+  template <class T>
+  const T* headerT() const {
+    DCHECK_EQ(header_size_, sizeof(T));
+    return reinterpret_cast<const T*>(segments_[0]);
+  }
+
+  size_t header_size() const { return header_size_; }
+  size_t payload_size() const { return header()->payload_size; }
+
+  // The size of the header plus payload, i.e. what Pickle::size() would be.
+  size_t size() const { return header_size_ + payload_size(); }
+
+  // Returns the segments holding the data, in order. The first segment starts
+  // with the header. Sizes exclude the padding that follows the last value.
+  size_t segment_count() const { return segments_.size(); }
+  const char* segment_data(size_t index) const { return segments_[index]; }
+  size_t segment_size(size_t index) const;
+
+  // Copies the data into |pickle|, which must be empty and have been
+  // constructed with the same header size. Afterwards |pickle| is
+  // indistinguishable from one the values were written to directly.
+  void Flatten(Pickle* pickle) const;
+
+  // Methods for adding to the payload. These behave exactly like their
+  // counterparts in Pickle.
+  bool WriteBool(bool value) {
+    return WriteInt(value ? 1 : 0);
+  }
+  bool WriteInt(int value) {
+    return WritePOD(value);
+  }
+  bool WriteLongUsingDangerousNonPortableLessPersistableForm(long value) {
+    return WritePOD(value);
+  }
+  bool WriteUInt16(uint16 value) {
+    return WritePOD(value);
+  }
+  bool WriteUInt32(uint32 value) {
+    return WritePOD(value);
+  }
+  bool WriteInt64(int64 value) {
+    return WritePOD(value);
+  }
+  bool WriteUInt64(uint64 value) {
+    return WritePOD(value);
+  }
+  bool WriteFloat(float value) {
+    return WritePOD(value);
+  }
+  bool WriteString(const std::string& value);
+  bool WriteWString(const std::wstring& value);
+  bool WriteString16(const base::string16& value);
+  bool WriteData(const char* data, int length);
+  bool WriteBytes(const void* data, int length);
+
+ private:
+  Pickle::Header* header() {
+    return reinterpret_cast<Pickle::Header*>(segments_[0]);
+  }
+  const Pickle::Header* header() const {
+    return reinterpret_cast<const Pickle::Header*>(segments_[0]);
+  }
+
+  template <typename T> bool WritePOD(const T& data) {
+    WriteBytesCommon(&data, sizeof(data));
+    return true;
+  }
+  void WriteBytesCommon(const void* data, size_t length);
+
+  // Appends a fresh segment from the current thread's free list.
+  void AddSegment();
+
+  // Each points at a block of kSegmentSize bytes. Never empty.
+  std::vector<char*> segments_;
+  size_t header_size_;
+  // Bytes used in the last segment, including padding.
+  size_t last_segment_used_;
+  // The offset at which the next value will be written, not counting the
+  // header. Unlike payload_size(), includes the padding after the last value.
+  size_t write_offset_;
+
+  DISALLOW_COPY_AND_ASSIGN(SegmentedPickle);
+};
+
+#endif  // BASE_SEGMENTED_PICKLE_H_
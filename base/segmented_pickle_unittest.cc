@@ -0,0 +1,150 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/segmented_pickle.h"
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/pickle.h"
+#include "base/strings/string16.h"
+#include "base/strings/utf_string_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const int kTestInt = 2093847192;
+const std::string kTestString("Hello world");  // Non-aligned length.
+const char kTestData[] = "AAA\0BBB\0";
+const int kTestDataLen = arraysize(kTestData) - 1;
+
+struct CustomHeader : Pickle::Header {
+  int blah;
+};
+
+// Concatenates the segments of |pickle|.
+std::string Concatenate(const SegmentedPickle& pickle) {
+  std::string result;
+  for (size_t i = 0; i < pickle.segment_count(); ++i)
+    result.append(pickle.segment_data(i), pickle.segment_size(i));
+  return result;
+}
+
+std::string ToString(const Pickle& pickle) {
+  return std::string(static_cast<const char*>(pickle.data()), pickle.size());
+}
+
+// Writes the same sequence of values to |pickle|, which may be either a
+// Pickle or a SegmentedPickle.
+template <class PickleType>
+void WriteValues(PickleType* pickle) {
+  EXPECT_TRUE(pickle->WriteInt(kTestInt));
+  EXPECT_TRUE(pickle->WriteString(kTestString));
+  EXPECT_TRUE(pickle->WriteString16(base::ASCIIToUTF16(kTestString)));
+  EXPECT_TRUE(pickle->WriteBool(true));
+  EXPECT_TRUE(pickle->WriteUInt16(32123));
+  EXPECT_TRUE(pickle->WriteInt64(-1234567890123LL));
+  EXPECT_TRUE(pickle->WriteFloat(3.25f));
+  EXPECT_TRUE(pickle->WriteData(kTestData, kTestDataLen));
+  EXPECT_TRUE(pickle->WriteBytes(kTestData, 3));
+}
+
+}  // namespace
+
+TEST(SegmentedPickleTest, Empty) {
+  SegmentedPickle segmented;
+  EXPECT_EQ(0u, segmented.payload_size());
+  EXPECT_EQ(sizeof(Pickle::Header), segmented.size());
+  ASSERT_EQ(1u, segmented.segment_count());
+  EXPECT_EQ(segmented.size(), segmented.segment_size(0));
+
+  Pickle pickle;
+  EXPECT_EQ(ToString(pickle), Concatenate(segmented));
+}
+
+TEST(SegmentedPickleTest, MatchesPickle) {
+  Pickle pickle;
+  WriteValues(&pickle);
+  SegmentedPickle segmented;
+  WriteValues(&segmented);
+
+  EXPECT_EQ(pickle.size(), segmented.size());
+  EXPECT_EQ(pickle.payload_size(), segmented.payload_size());
+  EXPECT_EQ(ToString(pickle), Concatenate(segmented));
+}
+
+TEST(SegmentedPickleTest, CustomHeader) {
+  Pickle pickle(sizeof(CustomHeader));
+  pickle.headerT<CustomHeader>()->blah = 10;
+  WriteValues(&pickle);
+  SegmentedPickle segmented(sizeof(CustomHeader));
+  segmented.headerT<CustomHeader>()->blah = 10;
+  WriteValues(&segmented);
+
+  EXPECT_EQ(sizeof(CustomHeader), segmented.header_size());
+  EXPECT_EQ(ToString(pickle), Concatenate(segmented));
+}
+
+// Values larger than a segment, and values straddling segment boundaries, are
+// split without changing the resulting bytes.
+TEST(SegmentedPickleTest, SpansSegments) {
+  std::string big(SegmentedPickle::kSegmentSize * 2 + 5, 'x');
+  for (size_t i = 0; i < big.size(); ++i)
+    big[i] = static_cast<char>(i);
+
+  Pickle pickle;
+  SegmentedPickle segmented;
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(pickle.WriteString(big));
+    EXPECT_TRUE(segmented.WriteString(big));
+    EXPECT_TRUE(pickle.WriteInt(i));
+    EXPECT_TRUE(segmented.WriteInt(i));
+  }
+
+  EXPECT_GT(segmented.segment_count(), 6u);
+  for (size_t i = 0; i + 1 < segmented.segment_count(); ++i)
+    EXPECT_EQ(SegmentedPickle::kSegmentSize, segmented.segment_size(i));
+  EXPECT_EQ(pickle.size(), segmented.size());
+  EXPECT_EQ(ToString(pickle), Concatenate(segmented));
+}
+
+TEST(SegmentedPickleTest, Flatten) {
+  SegmentedPickle segmented(sizeof(CustomHeader));
+  segmented.headerT<CustomHeader>()->blah = 7;
+  std::string big(SegmentedPickle::kSegmentSize + 1, 'y');
+  EXPECT_TRUE(segmented.WriteString(big));
+  EXPECT_TRUE(segmented.WriteInt(kTestInt));
+
+  Pickle pickle(sizeof(CustomHeader));
+  segmented.Flatten(&pickle);
+  EXPECT_EQ(Concatenate(segmented), ToString(pickle));
+  EXPECT_EQ(7, pickle.headerT<CustomHeader>()->blah);
+
+  PickleIterator iter(pickle);
+  std::string out_string;
+  EXPECT_TRUE(pickle.ReadString(&iter, &out_string));
+  EXPECT_EQ(big, out_string);
+  int out_int;
+  EXPECT_TRUE(pickle.ReadInt(&iter, &out_int));
+  EXPECT_EQ(kTestInt, out_int);
+
+  // The flattened pickle remains writable.
+  EXPECT_TRUE(pickle.WriteInt(1));
+  PickleIterator iter2(pickle);
+  EXPECT_TRUE(pickle.ReadString(&iter2, &out_string));
+  EXPECT_TRUE(pickle.ReadInt(&iter2, &out_int));
+  EXPECT_TRUE(pickle.ReadInt(&iter2, &out_int));
+  EXPECT_EQ(1, out_int);
+}
+
+// Segments released to the free list are handed out again on the same thread.
+TEST(SegmentedPickleTest, ReusesSegments) {
+  const char* first_segment;
+  {
+    SegmentedPickle segmented;
+    first_segment = segmented.segment_data(0);
+  }
+  SegmentedPickle segmented;
+  EXPECT_EQ(first_segment, segmented.segment_data(0));
+}
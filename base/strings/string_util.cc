@@ -378,11 +378,11 @@ bool IsStringASCII(const std::wstring& str) {
 #endif
 
 bool IsStringASCII(const string16& str) {
-  return DoIsStringASCII(str);
+  return base::CountLeadingASCII(str.data(), str.length()) == str.length();
 }
 
 bool IsStringASCII(const base::StringPiece& str) {
-  return DoIsStringASCII(str);
+  return base::CountLeadingASCII(str.data(), str.length()) == str.length();
 }
 
 bool IsStringUTF8(const std::string& str) {
@@ -427,6 +427,29 @@ TEST(StringUtilTest, ConvertASCII) {
 
   EXPECT_FALSE(IsStringASCII("Google \x80Video"));
 
+  // IsStringASCII() tests several characters at a time, so put the non-ASCII
+  // character at every position, starting at every alignment.
+  const size_t kMaxLength = 40;
+  const size_t kMaxOffset = 8;
+  for (size_t length = 0; length <= kMaxLength; ++length) {
+    for (size_t offset = 0; offset < kMaxOffset; ++offset) {
+      std::string ascii(offset + length, 'A');
+      string16 ascii16(offset + length, 'A');
+      EXPECT_TRUE(IsStringASCII(StringPiece(ascii).substr(offset)));
+      EXPECT_TRUE(IsStringASCII(ascii16.substr(offset)));
+      for (size_t position = 0; position < length; ++position) {
+        std::string non_ascii(ascii);
+        non_ascii[offset + position] = '\x80';
+        EXPECT_FALSE(IsStringASCII(StringPiece(non_ascii).substr(offset)));
+        string16 non_ascii16(ascii16);
+        non_ascii16[offset + position] = 0x100;
+        EXPECT_FALSE(IsStringASCII(non_ascii16.substr(offset)));
+        non_ascii16[offset + position] = 0x80;
+        EXPECT_FALSE(IsStringASCII(non_ascii16.substr(offset)));
+      }
+    }
+  }
+
   // Convert empty strings.
   std::wstring wempty;
   std::string empty;
@@ -5,9 +5,69 @@
 #include "base/strings/utf_string_conversion_utils.h"
 
 #include "base/third_party/icu/icu_utf.h"
+#include "build/build_config.h"
+
+#if !defined(OS_NACL) && \
+    (defined(ARCH_CPU_X86_64) || (defined(ARCH_CPU_X86) && defined(__SSE2__)))
+#define UTF_CONVERSION_USE_SSE2
+#include <emmintrin.h>
+#elif !defined(OS_NACL) && defined(ARCH_CPU_ARM_FAMILY) && \
+    defined(__ARM_NEON__)
+#define UTF_CONVERSION_USE_NEON
+#include <arm_neon.h>
+#endif
 
 namespace base {
 
+namespace {
+
+// Widens |length| ASCII characters from |src| into |dest|.
+void WidenASCII(const char* src, size_t length, char16* dest) {
+  size_t i = 0;
+#if defined(UTF_CONVERSION_USE_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= length; i += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                     _mm_unpacklo_epi8(chunk, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i + 8),
+                     _mm_unpackhi_epi8(chunk, zero));
+  }
+#elif defined(UTF_CONVERSION_USE_NEON)
+  for (; i + 16 <= length; i += 16) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8*>(src + i));
+    uint16* out = reinterpret_cast<uint16*>(dest + i);
+    vst1q_u16(out, vmovl_u8(vget_low_u8(chunk)));
+    vst1q_u16(out + 8, vmovl_u8(vget_high_u8(chunk)));
+  }
+#endif
+  for (; i < length; ++i)
+    dest[i] = static_cast<char16>(src[i]);
+}
+
+// Narrows |length| ASCII characters from |src| into |dest|.
+void NarrowASCII(const char16* src, size_t length, char* dest) {
+  size_t i = 0;
+#if defined(UTF_CONVERSION_USE_SSE2)
+  for (; i + 16 <= length; i += 16) {
+    __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i high =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i),
+                     _mm_packus_epi16(low, high));
+  }
+#elif defined(UTF_CONVERSION_USE_NEON)
+  for (; i + 8 <= length; i += 8) {
+    uint16x8_t chunk = vld1q_u16(reinterpret_cast<const uint16*>(src + i));
+    vst1_u8(reinterpret_cast<uint8*>(dest + i), vmovn_u16(chunk));
+  }
+#endif
+  for (; i < length; ++i)
+    dest[i] = static_cast<char>(src[i]);
+}
+
+}  // namespace
+
 // ReadUnicodeCharacter --------------------------------------------------------
 
 bool ReadUnicodeCharacter(const char* src,
@@ -102,6 +162,82 @@ size_t WriteUnicodeCharacter(uint32 code_point, string16* output) {
   return CBU16_MAX_LENGTH;
 }
 
+// ASCII runs ------------------------------------------------------------------
+
+size_t CountLeadingASCII(const char* src, size_t src_len) {
+  size_t i = 0;
+#if defined(UTF_CONVERSION_USE_SSE2)
+  for (; i + 16 <= src_len; i += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    if (_mm_movemask_epi8(chunk))
+      break;
+  }
+#elif defined(UTF_CONVERSION_USE_NEON)
+  for (; i + 16 <= src_len; i += 16) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8*>(src + i));
+    uint8x8_t folded = vorr_u8(vget_low_u8(chunk), vget_high_u8(chunk));
+    if (vget_lane_u64(vreinterpret_u64_u8(folded), 0) &
+        GG_UINT64_C(0x8080808080808080))
+      break;
+  }
+#endif
+  while (i < src_len && static_cast<unsigned char>(src[i]) < 0x80)
+    ++i;
+  return i;
+}
+
+size_t CountLeadingASCII(const char16* src, size_t src_len) {
+  size_t i = 0;
+#if defined(UTF_CONVERSION_USE_SSE2)
+  const __m128i non_ascii_mask = _mm_set1_epi16(static_cast<short>(0xFF80));
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 8 <= src_len; i += 8) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i ascii =
+        _mm_cmpeq_epi16(_mm_and_si128(chunk, non_ascii_mask), zero);
+    if (_mm_movemask_epi8(ascii) != 0xFFFF)
+      break;
+  }
+#elif defined(UTF_CONVERSION_USE_NEON)
+  const uint16x8_t non_ascii_mask = vdupq_n_u16(0xFF80);
+  for (; i + 8 <= src_len; i += 8) {
+    uint16x8_t chunk = vld1q_u16(reinterpret_cast<const uint16*>(src + i));
+    uint16x8_t non_ascii = vandq_u16(chunk, non_ascii_mask);
+    uint16x4_t folded = vorr_u16(vget_low_u16(non_ascii),
+                                 vget_high_u16(non_ascii));
+    if (vget_lane_u64(vreinterpret_u64_u16(folded), 0))
+      break;
+  }
+#endif
+  while (i < src_len && src[i] < 0x80)
+    ++i;
+  return i;
+}
+
+size_t AppendLeadingASCII(const char* src,
+                          size_t src_len,
+                          string16* output) {
+  size_t length = CountLeadingASCII(src, src_len);
+  if (!length)
+    return 0;
+  size_t offset = output->size();
+  output->resize(offset + length);
+  WidenASCII(src, length, &(*output)[offset]);
+  return length;
+}
+
+size_t AppendLeadingASCII(const char16* src,
+                          size_t src_len,
+                          std::string* output) {
+  size_t length = CountLeadingASCII(src, src_len);
+  if (!length)
+    return 0;
+  size_t offset = output->size();
+  output->resize(offset + length);
+  NarrowASCII(src, length, &(*output)[offset]);
+  return length;
+}
+
 // Generalized Unicode converter -----------------------------------------------
 
 template<typename CHAR>
@@ -78,6 +78,24 @@ inline size_t WriteUnicodeCharacter(uint32 code_point, std::wstring* output) {
 }
 #endif  // defined(WCHAR_T_IS_UTF32)
 
+// ASCII runs ------------------------------------------------------------------
+
+// Returns the number of ASCII characters at the start of |src|.  Where SSE2 or
+// NEON is available, 16 bytes are tested at a time.
+BASE_EXPORT size_t CountLeadingASCII(const char* src, size_t src_len);
+BASE_EXPORT size_t CountLeadingASCII(const char16* src, size_t src_len);
+
+// Appends the ASCII characters at the start of |src| to |output|, widened or
+// narrowed to the output's character type, and returns how many there were.
+// Most text is mostly ASCII, so the converters copy it with these rather than
+// decoding it one code point at a time.
+BASE_EXPORT size_t AppendLeadingASCII(const char* src,
+                                      size_t src_len,
+                                      string16* output);
+BASE_EXPORT size_t AppendLeadingASCII(const char16* src,
+                                      size_t src_len,
+                                      std::string* output);
+
 // Generalized Unicode converter -----------------------------------------------
 
 // Guesses the length of the output in UTF-8 in bytes, clears that output
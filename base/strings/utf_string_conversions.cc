@@ -14,6 +14,28 @@ namespace {
 
 // Generalized Unicode converter -----------------------------------------------
 
+// Appends the run of ASCII characters at the start of |src| to |output|, and
+// returns its length.  The character types without a bulk version in
+// utf_string_conversion_utils.h are copied one at a time.
+template<typename SRC_CHAR, typename DEST_STRING>
+size_t AppendASCIIRun(const SRC_CHAR* src,
+                      size_t src_len,
+                      DEST_STRING* output) {
+  size_t length = 0;
+  while (length < src_len && static_cast<uint32>(src[length]) < 0x80)
+    ++length;
+  output->append(src, src + length);
+  return length;
+}
+
+size_t AppendASCIIRun(const char* src, size_t src_len, string16* output) {
+  return AppendLeadingASCII(src, src_len, output);
+}
+
+size_t AppendASCIIRun(const char16* src, size_t src_len, std::string* output) {
+  return AppendLeadingASCII(src, src_len, output);
+}
+
 // Converts the given source Unicode character type to the given destination
 // Unicode character type as a STL string. The given input buffer and size
 // determine the source, and the given output STL string will be replaced by
@@ -26,6 +48,12 @@ bool ConvertUnicode(const SRC_CHAR* src,
   bool success = true;
   int32 src_len32 = static_cast<int32>(src_len);
   for (int32 i = 0; i < src_len32; i++) {
+    if (static_cast<uint32>(src[i]) < 0x80) {
+      // Copy the whole run of ASCII, leaving |i| at its last character.
+      i += static_cast<int32>(AppendASCIIRun(src + i, src_len32 - i,
+                                             output)) - 1;
+      continue;
+    }
     uint32 code_point;
     if (ReadUnicodeCharacter(src, src_len32, &i, &code_point)) {
       WriteUnicodeCharacter(code_point, output);
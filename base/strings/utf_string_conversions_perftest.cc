@@ -0,0 +1,141 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures UTF8ToUTF16(), UTF16ToUTF8() and IsStringASCII() on URL-like ASCII
+// text and on mostly ASCII text with some accented letters.  Decoding one code
+// point at a time, which is how every string used to be converted, serves as
+// the baseline.
+
+#include <string>
+
+#include "base/strings/string16.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversion_utils.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+const int kNumStrings = 1000;
+const int kRounds = 200;
+
+// Builds |kNumStrings| strings, one after the other in |text|, like the URLs
+// and header values that cross IPC.  When |accented|, every word ends with
+// U+00E9.
+std::string MakeText(bool accented) {
+  std::string text;
+  for (int i = 0; i < kNumStrings; ++i) {
+    StringAppendF(&text, "https://www.example.com/path/to/resource%d", i);
+    if (accented)
+      text.append("\xc3\xa9");
+    text.append("?query=value&other=thing ");
+  }
+  return text;
+}
+
+template<typename SRC_CHAR, typename DEST_STRING>
+void ConvertOneCodePointAtATime(const SRC_CHAR* src,
+                                size_t src_len,
+                                DEST_STRING* output) {
+  output->clear();
+  int32 src_len32 = static_cast<int32>(src_len);
+  for (int32 i = 0; i < src_len32; i++) {
+    uint32 code_point;
+    if (ReadUnicodeCharacter(src, src_len32, &i, &code_point))
+      WriteUnicodeCharacter(code_point, output);
+    else
+      WriteUnicodeCharacter(0xFFFD, output);
+  }
+}
+
+void PrintTime(const std::string& measurement,
+               const std::string& trace,
+               size_t length,
+               TimeDelta elapsed) {
+  perf_test::PrintResult(measurement, "", trace,
+                         elapsed.InMicroseconds() * 1000.0 / (length * kRounds),
+                         "ns/char", true);
+}
+
+void RunConversions(const std::string& trace, const std::string& utf8) {
+  string16 utf16;
+  UTF8ToUTF16(utf8.data(), utf8.size(), &utf16);
+
+  string16 converted16;
+  TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kRounds; ++i)
+    ConvertOneCodePointAtATime(utf8.data(), utf8.size(), &converted16);
+  PrintTime("utf8_to_utf16", trace + "_baseline", utf8.size(),
+            TimeTicks::Now() - start);
+  EXPECT_EQ(utf16, converted16);
+
+  start = TimeTicks::Now();
+  for (int i = 0; i < kRounds; ++i)
+    UTF8ToUTF16(utf8.data(), utf8.size(), &converted16);
+  PrintTime("utf8_to_utf16", trace, utf8.size(), TimeTicks::Now() - start);
+  EXPECT_EQ(utf16, converted16);
+
+  std::string converted8;
+  start = TimeTicks::Now();
+  for (int i = 0; i < kRounds; ++i)
+    ConvertOneCodePointAtATime(utf16.data(), utf16.size(), &converted8);
+  PrintTime("utf16_to_utf8", trace + "_baseline", utf16.size(),
+            TimeTicks::Now() - start);
+  EXPECT_EQ(utf8, converted8);
+
+  start = TimeTicks::Now();
+  for (int i = 0; i < kRounds; ++i)
+    UTF16ToUTF8(utf16.data(), utf16.size(), &converted8);
+  PrintTime("utf16_to_utf8", trace, utf16.size(), TimeTicks::Now() - start);
+  EXPECT_EQ(utf8, converted8);
+}
+
+}  // namespace
+
+TEST(UTFStringConversionsPerfTest, ASCII) {
+  RunConversions("ascii", MakeText(false));
+}
+
+TEST(UTFStringConversionsPerfTest, MostlyASCII) {
+  RunConversions("mostly_ascii", MakeText(true));
+}
+
+TEST(UTFStringConversionsPerfTest, IsStringASCII) {
+  std::string ascii = MakeText(false);
+  string16 ascii16 = ASCIIToUTF16(ascii);
+
+  int count = 0;
+  TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kRounds; ++i) {
+    bool is_ascii = true;
+    for (size_t j = 0; j < ascii.size() && is_ascii; ++j)
+      is_ascii = static_cast<unsigned char>(ascii[j]) < 0x80;
+    count += is_ascii;
+  }
+  PrintTime("is_string_ascii", "baseline", ascii.size(),
+            TimeTicks::Now() - start);
+  EXPECT_EQ(kRounds, count);
+
+  count = 0;
+  start = TimeTicks::Now();
+  for (int i = 0; i < kRounds; ++i)
+    count += IsStringASCII(ascii);
+  PrintTime("is_string_ascii", "utf8", ascii.size(), TimeTicks::Now() - start);
+  EXPECT_EQ(kRounds, count);
+
+  count = 0;
+  start = TimeTicks::Now();
+  for (int i = 0; i < kRounds; ++i)
+    count += IsStringASCII(ascii16);
+  PrintTime("is_string_ascii", "utf16", ascii16.size(),
+            TimeTicks::Now() - start);
+  EXPECT_EQ(kRounds, count);
+}
+
+}  // namespace base
@@ -208,4 +208,46 @@ TEST(UTFStringConversionsTest, ConvertMultiString) {
   EXPECT_EQ(expected, converted);
 }
 
+// Runs of ASCII are converted in bulk, so put a non-ASCII character at every
+// position of strings long enough to take every path, starting at every
+// alignment.
+TEST(UTFStringConversionsTest, ConvertASCIIRuns) {
+  const size_t kMaxLength = 40;
+  const size_t kMaxOffset = 8;
+  for (size_t length = 1; length <= kMaxLength; ++length) {
+    for (size_t position = 0; position <= length; ++position) {
+      std::string utf8;
+      string16 utf16;
+      for (size_t i = 0; i < length; ++i) {
+        if (i == position) {
+          // U+00E9, LATIN SMALL LETTER E WITH ACUTE.
+          utf8.append("\xc3\xa9");
+          utf16.push_back(0xE9);
+        } else {
+          utf8.push_back(static_cast<char>('a' + i % 26));
+          utf16.push_back('a' + i % 26);
+        }
+      }
+      for (size_t offset = 0; offset < kMaxOffset; ++offset) {
+        std::string padded_utf8 = std::string(offset, 'x') + utf8;
+        string16 converted_utf16;
+        EXPECT_TRUE(UTF8ToUTF16(padded_utf8.data() + offset, utf8.size(),
+                                &converted_utf16));
+        EXPECT_EQ(utf16, converted_utf16);
+
+        string16 padded_utf16 = string16(offset, 'x') + utf16;
+        std::string converted_utf8;
+        EXPECT_TRUE(UTF16ToUTF8(padded_utf16.data() + offset, utf16.size(),
+                                &converted_utf8));
+        EXPECT_EQ(utf8, converted_utf8);
+      }
+    }
+  }
+
+  // Invalid input between runs of ASCII is still replaced.
+  EXPECT_EQ(ASCIIToUTF16("0123456789abcdef") + string16(1, 0xFFFD) +
+                ASCIIToUTF16("0123456789abcdef"),
+            UTF8ToUTF16("0123456789abcdef\xff" "0123456789abcdef"));
+}
+
 }  // base
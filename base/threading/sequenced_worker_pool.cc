@@ -4,6 +4,7 @@
 
 #include "base/threading/sequenced_worker_pool.h"
 
+#include <deque>
 #include <list>
 #include <map>
 #include <set>
@@ -11,6 +12,7 @@
 #include <vector>
 
 #include "base/atomic_sequence_num.h"
+#include "base/atomicops.h"
 #include "base/callback.h"
 #include "base/compiler_specific.h"
 #include "base/critical_closure.h"
@@ -18,6 +20,7 @@
 #include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/memory/linked_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/stl_util.h"
 #include "base/strings/stringprintf.h"
@@ -84,6 +87,73 @@ struct SequencedTaskLessThan {
   }
 };
 
+// WorkStealingQueue ---------------------------------------------------------
+
+// A unit of runnable work in WORK_STEALING mode. Unsequenced tasks are carried
+// directly. A sequenced item only names its sequence; the task itself is the
+// head of that sequence's queue and is looked up when the item is run. At most
+// one item per sequence exists at any time, which is what keeps the tasks of a
+// sequence serialized.
+struct WorkItem {
+  WorkItem() : sequence_token_id(0) {}
+
+  int sequence_token_id;
+  SequencedTask task;
+};
+
+// A deque of WorkItems owned by one worker thread. The owner takes items from
+// the front, so work posted to a worker runs roughly in FIFO order, while
+// other workers steal from the back.
+class WorkStealingQueue {
+ public:
+  explicit WorkStealingQueue(const void* pool) : pool_(pool) {}
+
+  void Push(const WorkItem& item) {
+    AutoLock lock(lock_);
+    items_.push_back(item);
+  }
+
+  bool Pop(WorkItem* item) {
+    AutoLock lock(lock_);
+    if (items_.empty())
+      return false;
+    *item = items_.front();
+    items_.pop_front();
+    return true;
+  }
+
+  bool Steal(WorkItem* item) {
+    AutoLock lock(lock_);
+    if (items_.empty())
+      return false;
+    *item = items_.back();
+    items_.pop_back();
+    return true;
+  }
+
+  // The pool this queue belongs to, used to recognize posts from a worker of
+  // the same pool.
+  const void* pool() const { return pool_; }
+
+ private:
+  const void* const pool_;
+
+  Lock lock_;
+  std::deque<WorkItem> items_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingQueue);
+};
+
+// The pending tasks of one sequence in WORK_STEALING mode.
+struct SequenceQueue {
+  SequenceQueue() : scheduled(false) {}
+
+  std::deque<SequencedTask> tasks;
+
+  // True while a WorkItem for this sequence is queued or running.
+  bool scheduled;
+};
+
 // SequencedWorkerPoolTaskRunner ---------------------------------------------
 // A TaskRunner which posts tasks to a SequencedWorkerPool with a
 // fixed ShutdownBehavior.
@@ -222,6 +292,10 @@ base::LazyInstance<base::ThreadLocalPointer<
     SequencedWorkerPool::SequenceToken> >::Leaky g_lazy_tls_ptr =
         LAZY_INSTANCE_INITIALIZER;
 
+// The WorkStealingQueue of the current worker thread, in WORK_STEALING mode.
+base::LazyInstance<base::ThreadLocalPointer<WorkStealingQueue> >::Leaky
+    g_lazy_tls_work_queue = LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 // Worker ---------------------------------------------------------------------
@@ -268,6 +342,7 @@ class SequencedWorkerPool::Inner {
   // by it).
   Inner(SequencedWorkerPool* worker_pool, size_t max_threads,
         const std::string& thread_name_prefix,
+        SchedulingMode scheduling_mode,
         TestingObserver* observer);
 
   ~Inner();
@@ -304,6 +379,12 @@ class SequencedWorkerPool::Inner {
   void ThreadLoop(Worker* this_worker);
 
  private:
+  enum PromoteStatus {
+    PROMOTE_FOUND,
+    PROMOTE_NOT_FOUND,
+    PROMOTE_WAIT,
+  };
+
   enum GetWorkStatus {
     GET_WORK_FOUND,
     GET_WORK_NOT_FOUND,
@@ -389,6 +470,48 @@ class SequencedWorkerPool::Inner {
   // called inside the lock.
   bool CanShutdown() const;
 
+  // WORK_STEALING mode counterparts of the functions above. See the comment
+  // above SequencedWorkerPool::Inner::PostTaskWorkStealing in the .cc file
+  // for how the lock-free counters interact with Shutdown().
+  bool PostTaskWorkStealing(const std::string* optional_token_name,
+                            SequencedTask* sequenced,
+                            TimeDelta delay);
+  void ThreadLoopWorkStealing(Worker* this_worker);
+  void CleanupForTestingWorkStealing();
+
+  // Makes |task| runnable: unsequenced tasks are pushed on |queue| directly,
+  // sequenced ones are appended to their sequence, which is pushed on |queue|
+  // if it was idle.
+  void EnqueueReadyTask(const SequencedTask& task, WorkStealingQueue* queue);
+
+  // Returns the queue a task posted from the current thread should go to.
+  WorkStealingQueue* QueueForCurrentThread();
+
+  // Takes an item from the queue of some worker other than |self_index|.
+  bool StealWork(size_t self_index, WorkItem* item);
+
+  // Runs (or, during shutdown, deletes) the task designated by |item|. The
+  // task's closure is released before this returns.
+  void RunWorkItem(Worker* this_worker,
+                   WorkStealingQueue* own_queue,
+                   WorkItem* item);
+
+  // Wakes an idle worker, or starts a new one, after work was queued.
+  void WakeUpWorkerIfHelpful();
+
+  // Called from within the lock. Moves delayed tasks that are due (all of
+  // them once shutdown has started) from |pending_tasks_| onto |queue|.
+  // Returns PROMOTE_WAIT with |wait_time| filled in if only tasks in the
+  // future remain.
+  PromoteStatus LockedPromoteDelayedTasks(WorkStealingQueue* queue,
+                                          TimeDelta* wait_time);
+
+  // Called after a task has left the pool, to wake up Shutdown() and
+  // FlushForTesting() if they are waiting.
+  void NotifyTaskDoneWorkStealing();
+
+  bool work_stealing() const { return scheduling_mode_ == WORK_STEALING; }
+
   SequencedWorkerPool* const worker_pool_;
 
   // The last sequence number used. Managed by GetSequenceToken, since this
@@ -471,6 +594,48 @@ class SequencedWorkerPool::Inner {
 
   TestingObserver* const testing_observer_;
 
+  const SchedulingMode scheduling_mode_;
+
+  // State used in WORK_STEALING mode only. None of it is guarded by |lock_|;
+  // |pending_tasks_| above still holds the delayed tasks and |lock_| still
+  // guards thread creation, waiting and shutdown admission.
+
+  // One queue per potential worker, indexed by thread number - 1. Created up
+  // front so that posting never has to synchronize with thread creation.
+  ScopedVector<WorkStealingQueue> work_queues_;
+
+  // Guards |sequences_|. Acquired after |lock_| when both are needed, and never
+  // held while acquiring a WorkStealingQueue lock.
+  Lock sequences_lock_;
+  std::map<int, SequenceQueue> sequences_;
+
+  // Number of WorkItems currently sitting in |work_queues_|.
+  volatile subtle::Atomic32 queued_items_;
+
+  // Number of tasks that were made runnable and have not run or been deleted
+  // yet. FlushForTesting() waits for this to drop to zero.
+  volatile subtle::Atomic32 outstanding_tasks_;
+
+  // Mirrors of |waiting_thread_count_|, |threads_.size()| and
+  // |shutdown_called_| that can be read without the lock.
+  volatile subtle::Atomic32 idle_worker_count_;
+  volatile subtle::Atomic32 worker_count_;
+  volatile subtle::Atomic32 shutdown_flag_;
+
+  // Nonzero while FlushForTesting() waits.
+  volatile subtle::Atomic32 flush_waiter_count_;
+
+  // Replace |blocking_shutdown_pending_task_count_| and
+  // |blocking_shutdown_thread_count_|.
+  volatile subtle::Atomic32 blocking_shutdown_pending_count_;
+  volatile subtle::Atomic32 blocking_shutdown_running_count_;
+
+  // Round-robin cursor for tasks posted from outside the pool.
+  volatile subtle::Atomic32 next_queue_index_;
+
+  // Replaces |trace_id_| and |next_sequence_task_number_| for immediate tasks.
+  volatile subtle::Atomic32 next_trace_id_;
+
   DISALLOW_COPY_AND_ASSIGN(Inner);
 };
 
@@ -511,6 +676,7 @@ SequencedWorkerPool::Inner::Inner(
     SequencedWorkerPool* worker_pool,
     size_t max_threads,
     const std::string& thread_name_prefix,
+    SchedulingMode scheduling_mode,
     TestingObserver* observer)
     : worker_pool_(worker_pool),
       lock_(),
@@ -529,7 +695,23 @@ SequencedWorkerPool::Inner::Inner(
       cleanup_state_(CLEANUP_DONE),
       cleanup_idlers_(0),
       cleanup_cv_(&lock_),
-      testing_observer_(observer) {}
+      testing_observer_(observer),
+      scheduling_mode_(scheduling_mode),
+      queued_items_(0),
+      outstanding_tasks_(0),
+      idle_worker_count_(0),
+      worker_count_(0),
+      shutdown_flag_(0),
+      flush_waiter_count_(0),
+      blocking_shutdown_pending_count_(0),
+      blocking_shutdown_running_count_(0),
+      next_queue_index_(0),
+      next_trace_id_(0) {
+  if (work_stealing()) {
+    for (size_t i = 0; i < max_threads_; ++i)
+      work_queues_.push_back(new WorkStealingQueue(this));
+  }
+}
 
 SequencedWorkerPool::Inner::~Inner() {
   // You must call Shutdown() before destroying the pool.
@@ -575,6 +757,9 @@ bool SequencedWorkerPool::Inner::PostTask(
       base::MakeCriticalClosure(task) : task;
   sequenced.time_to_run = TimeTicks::Now() + delay;
 
+  if (work_stealing())
+    return PostTaskWorkStealing(optional_token_name, &sequenced, delay);
+
   int create_thread_id = 0;
   {
     AutoLock lock(lock_);
@@ -621,6 +806,11 @@ bool SequencedWorkerPool::Inner::PostTask(
 }
 
 bool SequencedWorkerPool::Inner::RunsTasksOnCurrentThread() const {
+  if (work_stealing()) {
+    WorkStealingQueue* queue = g_lazy_tls_work_queue.Get().Get();
+    return queue && queue->pool() == this;
+  }
+
   AutoLock lock(lock_);
   return ContainsKey(threads_, PlatformThread::CurrentId());
 }
@@ -637,6 +827,11 @@ bool SequencedWorkerPool::Inner::IsRunningSequenceOnCurrentThread(
 // See https://code.google.com/p/chromium/issues/detail?id=168415
 void SequencedWorkerPool::Inner::CleanupForTesting() {
   DCHECK(!RunsTasksOnCurrentThread());
+  if (work_stealing()) {
+    CleanupForTestingWorkStealing();
+    return;
+  }
+
   base::ThreadRestrictions::ScopedAllowWait allow_wait;
   AutoLock lock(lock_);
   CHECK_EQ(CLEANUP_DONE, cleanup_state_);
@@ -667,6 +862,17 @@ void SequencedWorkerPool::Inner::Shutdown(
     shutdown_called_ = true;
     max_blocking_tasks_after_shutdown_ = max_new_blocking_tasks_after_shutdown;
 
+    if (work_stealing()) {
+      // Publish the flag before CanShutdown() reads the counters below; see
+      // PostTaskWorkStealing().
+      subtle::NoBarrier_Store(&shutdown_flag_, 1);
+      subtle::MemoryBarrier();
+
+      // Every idle worker has to wake up to either delete the non-blocking
+      // tasks it can reach or exit.
+      has_work_cv_.Broadcast();
+    }
+
     // Tickle the threads. This will wake up a waiting one so it will know that
     // it can exit, which in turn will wake up any other waiting ones.
     SignalHasWork();
@@ -704,6 +910,11 @@ bool SequencedWorkerPool::Inner::IsShutdownInProgress() {
 }
 
 void SequencedWorkerPool::Inner::ThreadLoop(Worker* this_worker) {
+  if (work_stealing()) {
+    ThreadLoopWorkStealing(this_worker);
+    return;
+  }
+
   {
     AutoLock lock(lock_);
     DCHECK(thread_being_created_);
@@ -1080,6 +1291,14 @@ int SequencedWorkerPool::Inner::PrepareToStartAdditionalThreadIfHelpful() {
       cleanup_state_ == CLEANUP_DONE &&
       threads_.size() < max_threads_ &&
       waiting_thread_count_ == 0) {
+    if (work_stealing()) {
+      // Everything in |work_queues_| is runnable.
+      if (subtle::Acquire_Load(&queued_items_) <= 0)
+        return 0;
+      thread_being_created_ = true;
+      return static_cast<int>(threads_.size() + 1);
+    }
+
     // We could use an additional thread if there's work to be done.
     for (PendingTaskSet::const_iterator i = pending_tasks_.begin();
          i != pending_tasks_.end(); ++i) {
@@ -1113,11 +1332,389 @@ void SequencedWorkerPool::Inner::SignalHasWork() {
 bool SequencedWorkerPool::Inner::CanShutdown() const {
   lock_.AssertAcquired();
   // See PrepareToStartAdditionalThreadIfHelpful for how thread creation works.
+  if (work_stealing()) {
+    return !thread_being_created_ &&
+           subtle::Acquire_Load(&blocking_shutdown_running_count_) == 0 &&
+           subtle::Acquire_Load(&blocking_shutdown_pending_count_) == 0;
+  }
   return !thread_being_created_ &&
          blocking_shutdown_thread_count_ == 0 &&
          blocking_shutdown_pending_task_count_ == 0;
 }
 
+// How WORK_STEALING mode keeps the shutdown guarantees without |lock_|:
+//
+// A BLOCK_SHUTDOWN post first increments |blocking_shutdown_pending_count_|
+// and only then reads |shutdown_flag_|, while Shutdown() sets the flag and only
+// then reads the counter (both sides with a full barrier in between). So
+// either the post sees the flag and falls back to the locked admission rules,
+// or Shutdown() sees the task and waits for it. Workers do the same with
+// |blocking_shutdown_running_count_| before deciding whether a SKIP_ON_SHUTDOWN
+// task still gets to run. Any decrement made after the flag is set wakes up
+// Shutdown() through NotifyTaskDoneWorkStealing().
+bool SequencedWorkerPool::Inner::PostTaskWorkStealing(
+    const std::string* optional_token_name,
+    SequencedTask* sequenced,
+    TimeDelta delay) {
+  const bool blocks_shutdown = sequenced->shutdown_behavior == BLOCK_SHUTDOWN;
+  if (blocks_shutdown)
+    subtle::Barrier_AtomicIncrement(&blocking_shutdown_pending_count_, 1);
+
+  if (subtle::Acquire_Load(&shutdown_flag_) || optional_token_name ||
+      delay > TimeDelta()) {
+    AutoLock lock(lock_);
+    if (shutdown_called_) {
+      if (!blocks_shutdown ||
+          LockedCurrentThreadShutdownBehavior() == CONTINUE_ON_SHUTDOWN ||
+          max_blocking_tasks_after_shutdown_ <= 0) {
+        if (blocks_shutdown) {
+          DLOG(WARNING) << "BLOCK_SHUTDOWN task disallowed";
+          subtle::Barrier_AtomicIncrement(&blocking_shutdown_pending_count_,
+                                          -1);
+          can_shutdown_cv_.Signal();
+        }
+        return false;
+      }
+      max_blocking_tasks_after_shutdown_ -= 1;
+    }
+
+    if (optional_token_name) {
+      sequenced->sequence_token_id =
+          LockedGetNamedTokenID(*optional_token_name);
+    }
+
+    if (delay > TimeDelta()) {
+      // Delayed tasks wait in |pending_tasks_| until a worker promotes them.
+      sequenced->trace_id = subtle::NoBarrier_AtomicIncrement(&next_trace_id_,
+                                                              1);
+      sequenced->sequence_task_number = LockedGetNextSequenceTaskNumber();
+      TRACE_EVENT_FLOW_BEGIN0(TRACE_DISABLED_BY_DEFAULT("toplevel.flow"),
+          "SequencedWorkerPool::PostTask",
+          TRACE_ID_MANGLE(GetTaskTraceID(*sequenced,
+                                         static_cast<void*>(this))));
+      pending_tasks_.insert(*sequenced);
+
+      // Let a waiting worker recompute how long it should sleep.
+      const bool has_idle_worker = waiting_thread_count_ > 0;
+      int create_thread_id = 0;
+      if (!has_idle_worker)
+        create_thread_id = PrepareToStartAdditionalThreadIfHelpful();
+      if (!create_thread_id && threads_.empty() && !thread_being_created_ &&
+          !shutdown_called_ && max_threads_ > 0) {
+        // Somebody has to be around to promote the task when it is due.
+        thread_being_created_ = true;
+        create_thread_id = 1;
+      }
+      if (has_idle_worker)
+        SignalHasWork();
+      if (create_thread_id) {
+        AutoUnlock unlock(lock_);
+        FinishStartingAdditionalThread(create_thread_id);
+      }
+      return true;
+    }
+  }
+
+  // The trace_id is used for identifying the task in about:tracing.
+  sequenced->trace_id = subtle::NoBarrier_AtomicIncrement(&next_trace_id_, 1);
+
+  TRACE_EVENT_FLOW_BEGIN0(TRACE_DISABLED_BY_DEFAULT("toplevel.flow"),
+      "SequencedWorkerPool::PostTask",
+      TRACE_ID_MANGLE(GetTaskTraceID(*sequenced, static_cast<void*>(this))));
+
+  subtle::Barrier_AtomicIncrement(&outstanding_tasks_, 1);
+  EnqueueReadyTask(*sequenced, QueueForCurrentThread());
+  WakeUpWorkerIfHelpful();
+  return true;
+}
+
+void SequencedWorkerPool::Inner::EnqueueReadyTask(const SequencedTask& task,
+                                                  WorkStealingQueue* queue) {
+  WorkItem item;
+  item.sequence_token_id = task.sequence_token_id;
+  if (task.sequence_token_id) {
+    AutoLock lock(sequences_lock_);
+    SequenceQueue& sequence = sequences_[task.sequence_token_id];
+    sequence.tasks.push_back(task);
+    // If the sequence already has an item in flight, whoever runs it will
+    // requeue the sequence for the task we just appended.
+    if (sequence.scheduled)
+      return;
+    sequence.scheduled = true;
+  } else {
+    item.task = task;
+  }
+  queue->Push(item);
+  subtle::Barrier_AtomicIncrement(&queued_items_, 1);
+}
+
+WorkStealingQueue* SequencedWorkerPool::Inner::QueueForCurrentThread() {
+  // Work posted from one of our own workers stays on that worker, which is
+  // both cheaper and friendlier to the cache.
+  WorkStealingQueue* queue = g_lazy_tls_work_queue.Get().Get();
+  if (queue && queue->pool() == this)
+    return queue;
+
+  // Otherwise spread the work over the workers that exist so far. Workers
+  // that don't exist yet will steal once they are started.
+  subtle::Atomic32 worker_count = subtle::NoBarrier_Load(&worker_count_);
+  if (worker_count <= 0)
+    return work_queues_[0];
+  subtle::Atomic32 index =
+      subtle::NoBarrier_AtomicIncrement(&next_queue_index_, 1) & 0x7fffffff;
+  return work_queues_[index % worker_count];
+}
+
+bool SequencedWorkerPool::Inner::StealWork(size_t self_index, WorkItem* item) {
+  if (subtle::Acquire_Load(&queued_items_) <= 0)
+    return false;
+  for (size_t i = 1; i < work_queues_.size(); ++i) {
+    if (work_queues_[(self_index + i) % work_queues_.size()]->Steal(item))
+      return true;
+  }
+  return false;
+}
+
+void SequencedWorkerPool::Inner::WakeUpWorkerIfHelpful() {
+  if (subtle::Acquire_Load(&idle_worker_count_) > 0) {
+    // Taking the lock guarantees the idle worker is actually waiting on
+    // |has_work_cv_| rather than about to, so the signal can't be lost.
+    AutoLock lock(lock_);
+    SignalHasWork();
+    return;
+  }
+
+  if (static_cast<size_t>(subtle::NoBarrier_Load(&worker_count_)) >=
+      max_threads_) {
+    return;
+  }
+
+  int create_thread_id = 0;
+  {
+    AutoLock lock(lock_);
+    create_thread_id = PrepareToStartAdditionalThreadIfHelpful();
+  }
+  if (create_thread_id)
+    FinishStartingAdditionalThread(create_thread_id);
+}
+
+SequencedWorkerPool::Inner::PromoteStatus
+SequencedWorkerPool::Inner::LockedPromoteDelayedTasks(
+    WorkStealingQueue* queue,
+    TimeDelta* wait_time) {
+  lock_.AssertAcquired();
+  PromoteStatus status = PROMOTE_NOT_FOUND;
+  const TimeTicks current_time = TimeTicks::Now();
+  while (!pending_tasks_.empty()) {
+    PendingTaskSet::iterator i = pending_tasks_.begin();
+    // Once shutting down, delayed (hence SKIP_ON_SHUTDOWN) tasks are promoted
+    // right away so that RunWorkItem() deletes them in sequence order.
+    if (!shutdown_called_ && i->time_to_run > current_time) {
+      if (status == PROMOTE_NOT_FOUND) {
+        *wait_time = i->time_to_run - current_time;
+        status = PROMOTE_WAIT;
+      }
+      break;
+    }
+    subtle::Barrier_AtomicIncrement(&outstanding_tasks_, 1);
+    EnqueueReadyTask(*i, queue);
+    pending_tasks_.erase(i);
+    status = PROMOTE_FOUND;
+  }
+  return status;
+}
+
+void SequencedWorkerPool::Inner::RunWorkItem(Worker* this_worker,
+                                             WorkStealingQueue* own_queue,
+                                             WorkItem* item) {
+  const int sequence_token_id = item->sequence_token_id;
+  SequencedTask task;
+  if (sequence_token_id) {
+    AutoLock lock(sequences_lock_);
+    SequenceQueue& sequence = sequences_[sequence_token_id];
+    DCHECK(sequence.scheduled);
+    DCHECK(!sequence.tasks.empty());
+    task = sequence.tasks.front();
+    sequence.tasks.pop_front();
+  } else {
+    task = item->task;
+    item->task.task.Reset();
+  }
+
+  // Count ourselves as running before looking at the shutdown flag, and only
+  // then stop counting the task as pending, so that Shutdown() never sees both
+  // counters at zero while a task that must block it is in flight.
+  const bool blocks_shutdown = task.shutdown_behavior != CONTINUE_ON_SHUTDOWN;
+  if (blocks_shutdown)
+    subtle::Barrier_AtomicIncrement(&blocking_shutdown_running_count_, 1);
+  if (task.shutdown_behavior == BLOCK_SHUTDOWN)
+    subtle::Barrier_AtomicIncrement(&blocking_shutdown_pending_count_, -1);
+
+  if (subtle::Acquire_Load(&shutdown_flag_) &&
+      task.shutdown_behavior != BLOCK_SHUTDOWN) {
+    // Like GetWork(), delete rather than run non-blocking tasks that were not
+    // started before shutdown. This happens outside of every lock.
+    task.task = Closure();
+  } else {
+    TRACE_EVENT_FLOW_END0(TRACE_DISABLED_BY_DEFAULT("toplevel.flow"),
+        "SequencedWorkerPool::PostTask",
+        TRACE_ID_MANGLE(GetTaskTraceID(task, static_cast<void*>(this))));
+    TRACE_EVENT2("toplevel", "SequencedWorkerPool::ThreadLoop",
+                 "src_file", task.posted_from.file_name(),
+                 "src_func", task.posted_from.function_name());
+
+    // More work may be waiting behind this task; make sure somebody picks it
+    // up while we are busy.
+    if (subtle::Acquire_Load(&queued_items_) > 0)
+      WakeUpWorkerIfHelpful();
+
+    this_worker->set_running_task_info(
+        SequenceToken(task.sequence_token_id), task.shutdown_behavior);
+
+    tracked_objects::TrackedTime start_time =
+        tracked_objects::ThreadData::NowForStartOfRun(task.birth_tally);
+
+    task.task.Run();
+
+    tracked_objects::ThreadData::TallyRunOnNamedThreadIfTracking(task,
+        start_time, tracked_objects::ThreadData::NowForEndOfRun());
+
+    // Destroy the closure while the sequence is still marked as running, for
+    // the same reason as in ThreadLoop().
+    task.task = Closure();
+
+    this_worker->set_running_task_info(SequenceToken(), CONTINUE_ON_SHUTDOWN);
+  }
+
+  if (blocks_shutdown)
+    subtle::Barrier_AtomicIncrement(&blocking_shutdown_running_count_, -1);
+
+  if (sequence_token_id) {
+    bool requeue = false;
+    {
+      AutoLock lock(sequences_lock_);
+      std::map<int, SequenceQueue>::iterator found =
+          sequences_.find(sequence_token_id);
+      DCHECK(found != sequences_.end());
+      if (found->second.tasks.empty())
+        sequences_.erase(found);
+      else
+        requeue = true;
+    }
+    // The sequence stays scheduled; hand the next task to ourselves.
+    if (requeue) {
+      WorkItem next;
+      next.sequence_token_id = sequence_token_id;
+      own_queue->Push(next);
+      subtle::Barrier_AtomicIncrement(&queued_items_, 1);
+    }
+  }
+
+  subtle::Barrier_AtomicIncrement(&outstanding_tasks_, -1);
+  NotifyTaskDoneWorkStealing();
+}
+
+void SequencedWorkerPool::Inner::NotifyTaskDoneWorkStealing() {
+  if (!subtle::Acquire_Load(&shutdown_flag_) &&
+      !subtle::Acquire_Load(&flush_waiter_count_)) {
+    return;
+  }
+  AutoLock lock(lock_);
+  can_shutdown_cv_.Signal();
+  cleanup_cv_.Broadcast();
+}
+
+void SequencedWorkerPool::Inner::ThreadLoopWorkStealing(Worker* this_worker) {
+  size_t self_index;
+  {
+    AutoLock lock(lock_);
+    DCHECK(thread_being_created_);
+    thread_being_created_ = false;
+    std::pair<ThreadMap::iterator, bool> result =
+        threads_.insert(
+            std::make_pair(this_worker->tid(), make_linked_ptr(this_worker)));
+    DCHECK(result.second);
+    // Threads are created one at a time, so the map size is our number.
+    self_index = threads_.size() - 1;
+    subtle::Barrier_AtomicIncrement(&worker_count_, 1);
+  }
+  WorkStealingQueue* own_queue = work_queues_[self_index];
+  g_lazy_tls_work_queue.Get().Set(own_queue);
+
+  while (true) {
+#if defined(OS_MACOSX)
+    base::mac::ScopedNSAutoreleasePool autorelease_pool;
+#endif
+
+    WorkItem item;
+    if (own_queue->Pop(&item) || StealWork(self_index, &item)) {
+      subtle::Barrier_AtomicIncrement(&queued_items_, -1);
+      RunWorkItem(this_worker, own_queue, &item);
+      continue;
+    }
+
+    AutoLock lock(lock_);
+    TimeDelta wait_time;
+    PromoteStatus status = LockedPromoteDelayedTasks(own_queue, &wait_time);
+    if (status == PROMOTE_FOUND)
+      continue;
+
+    // Same exit condition as ThreadLoop().
+    if (shutdown_called_ &&
+        subtle::Acquire_Load(&blocking_shutdown_pending_count_) == 0) {
+      break;
+    }
+
+    waiting_thread_count_++;
+    subtle::Barrier_AtomicIncrement(&idle_worker_count_, 1);
+    // Posters bump |queued_items_| before reading |idle_worker_count_|, so
+    // either we see their item here or they see us and signal.
+    if (subtle::Acquire_Load(&queued_items_) <= 0) {
+      if (status == PROMOTE_WAIT)
+        has_work_cv_.TimedWait(wait_time);
+      else
+        has_work_cv_.Wait();
+    }
+    subtle::Barrier_AtomicIncrement(&idle_worker_count_, -1);
+    waiting_thread_count_--;
+  }
+
+  // |g_lazy_tls_work_queue| is deliberately left set: the last reference to
+  // the pool may be released on this thread after the loop exits, and
+  // OnDestruct() relies on RunsTasksOnCurrentThread() to avoid joining
+  // ourselves.
+
+  // We noticed we should exit. Wake up the next worker so it knows it should
+  // exit as well (because the Shutdown() code only signals once).
+  SignalHasWork();
+
+  // Possibly unblock shutdown.
+  can_shutdown_cv_.Signal();
+}
+
+void SequencedWorkerPool::Inner::CleanupForTestingWorkStealing() {
+  base::ThreadRestrictions::ScopedAllowWait allow_wait;
+  std::vector<Closure> delete_these_outside_lock;
+  AutoLock lock(lock_);
+  if (shutdown_called_)
+    return;
+
+  // Delayed tasks are deleted rather than flushed, like in SHARED_QUEUE mode.
+  for (PendingTaskSet::iterator i = pending_tasks_.begin();
+       i != pending_tasks_.end(); ++i) {
+    delete_these_outside_lock.push_back(i->task);
+  }
+  pending_tasks_.clear();
+
+  subtle::Barrier_AtomicIncrement(&flush_waiter_count_, 1);
+  while (subtle::Acquire_Load(&outstanding_tasks_) != 0)
+    cleanup_cv_.Wait();
+  subtle::Barrier_AtomicIncrement(&flush_waiter_count_, -1);
+
+  AutoUnlock unlock(lock_);
+  delete_these_outside_lock.clear();
+}
+
 base::StaticAtomicSequenceNumber
 SequencedWorkerPool::Inner::g_last_sequence_number_;
 
@@ -1140,15 +1737,27 @@ SequencedWorkerPool::SequencedWorkerPool(
     size_t max_threads,
     const std::string& thread_name_prefix)
     : constructor_message_loop_(MessageLoopProxy::current()),
-      inner_(new Inner(this, max_threads, thread_name_prefix, NULL)) {
+      inner_(new Inner(this, max_threads, thread_name_prefix, SHARED_QUEUE,
+                       NULL)) {
+}
+
+SequencedWorkerPool::SequencedWorkerPool(
+    size_t max_threads,
+    const std::string& thread_name_prefix,
+    TestingObserver* observer)
+    : constructor_message_loop_(MessageLoopProxy::current()),
+      inner_(new Inner(this, max_threads, thread_name_prefix, SHARED_QUEUE,
+                       observer)) {
 }
 
 SequencedWorkerPool::SequencedWorkerPool(
     size_t max_threads,
     const std::string& thread_name_prefix,
+    SchedulingMode scheduling_mode,
     TestingObserver* observer)
     : constructor_message_loop_(MessageLoopProxy::current()),
-      inner_(new Inner(this, max_threads, thread_name_prefix, observer)) {
+      inner_(new Inner(this, max_threads, thread_name_prefix, scheduling_mode,
+                       observer)) {
 }
 
 SequencedWorkerPool::~SequencedWorkerPool() {}
@@ -118,6 +118,21 @@ class BASE_EXPORT SequencedWorkerPool : public TaskRunner {
     BLOCK_SHUTDOWN,
   };
 
+  // Selects how queued tasks are handed out to the worker threads.
+  enum SchedulingMode {
+    // All pending tasks live in a single time-ordered set guarded by one lock.
+    // Each worker scans the set for the first task whose sequence is not
+    // already running. This is the default.
+    SHARED_QUEUE,
+
+    // Each worker owns a deque of runnable work and idle workers steal from
+    // the others. Sequenced tasks are kept in per-sequence queues, so no
+    // scanning is needed to find runnable work and posting a task usually
+    // only takes the lock of the target deque. Delayed tasks and shutdown
+    // bookkeeping behave exactly as in SHARED_QUEUE mode.
+    WORK_STEALING,
+  };
+
   // Opaque identifier that defines sequencing of tasks posted to the worker
   // pool.
   class SequenceToken {
@@ -171,6 +186,13 @@ class BASE_EXPORT SequencedWorkerPool : public TaskRunner {
                       const std::string& thread_name_prefix,
                       TestingObserver* observer);
 
+  // Like above, but with an explicit |scheduling_mode|. |observer| may be
+  // NULL.
+  SequencedWorkerPool(size_t max_threads,
+                      const std::string& thread_name_prefix,
+                      SchedulingMode scheduling_mode,
+                      TestingObserver* observer);
+
   // Returns a unique token that can be used to sequence tasks posted to
   // PostSequencedWorkerTask(). Valid tokens are always nonzero.
   SequenceToken GetSequenceToken();
@@ -0,0 +1,116 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures how many short tasks per second a SequencedWorkerPool can run as
+// the number of worker threads grows, for each SchedulingMode.
+
+#include "base/threading/sequenced_worker_pool.h"
+
+#include <string>
+
+#include "base/atomicops.h"
+#include "base/bind.h"
+#include "base/format_macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+const int kNumTasks = 100000;
+const int kNumSequences = 16;
+const size_t kThreadCounts[] = {1, 2, 4, 8, 16, 32};
+
+// Counts completed tasks and signals |done_| when the last one finishes.
+class TaskCounter : public RefCountedThreadSafe<TaskCounter> {
+ public:
+  explicit TaskCounter(int expected)
+      : remaining_(expected), done_(false, false) {}
+
+  void Run() {
+    if (subtle::Barrier_AtomicIncrement(&remaining_, -1) == 0)
+      done_.Signal();
+  }
+
+  void Wait() { done_.Wait(); }
+
+ private:
+  friend class RefCountedThreadSafe<TaskCounter>;
+  ~TaskCounter() {}
+
+  volatile subtle::Atomic32 remaining_;
+  WaitableEvent done_;
+
+  DISALLOW_COPY_AND_ASSIGN(TaskCounter);
+};
+
+const char* ModeName(SequencedWorkerPool::SchedulingMode mode) {
+  return mode == SequencedWorkerPool::WORK_STEALING ? "work_stealing"
+                                                    : "shared_queue";
+}
+
+// Posts |kNumTasks| empty tasks, either unsequenced or spread round-robin over
+// |kNumSequences| sequences, and reports the throughput.
+void RunThroughputTest(SequencedWorkerPool::SchedulingMode mode,
+                       size_t num_threads,
+                       bool sequenced) {
+  MessageLoop message_loop;
+  scoped_refptr<SequencedWorkerPool> pool(
+      new SequencedWorkerPool(num_threads, "PerfTest", mode, NULL));
+  scoped_refptr<TaskCounter> counter(new TaskCounter(kNumTasks));
+
+  SequencedWorkerPool::SequenceToken tokens[kNumSequences];
+  for (int i = 0; i < kNumSequences; ++i)
+    tokens[i] = pool->GetSequenceToken();
+
+  Closure task = Bind(&TaskCounter::Run, counter);
+  TimeTicks start = TimeTicks::Now();
+  for (int i = 0; i < kNumTasks; ++i) {
+    if (sequenced) {
+      pool->PostSequencedWorkerTask(tokens[i % kNumSequences], FROM_HERE,
+                                    task);
+    } else {
+      pool->PostWorkerTask(FROM_HERE, task);
+    }
+  }
+  counter->Wait();
+  TimeDelta elapsed = TimeTicks::Now() - start;
+  pool->Shutdown();
+
+  perf_test::PrintResult(
+      sequenced ? "sequenced_tasks_per_second" : "tasks_per_second",
+      StringPrintf("_%s", ModeName(mode)),
+      StringPrintf("%" PRIuS "_threads", num_threads),
+      kNumTasks / elapsed.InSecondsF(),
+      "tasks/s",
+      true);
+}
+
+}  // namespace
+
+TEST(SequencedWorkerPoolPerfTest, UnsequencedThroughput) {
+  for (size_t i = 0; i < arraysize(kThreadCounts); ++i) {
+    RunThroughputTest(SequencedWorkerPool::SHARED_QUEUE, kThreadCounts[i],
+                      false);
+    RunThroughputTest(SequencedWorkerPool::WORK_STEALING, kThreadCounts[i],
+                      false);
+  }
+}
+
+TEST(SequencedWorkerPoolPerfTest, SequencedThroughput) {
+  for (size_t i = 0; i < arraysize(kThreadCounts); ++i) {
+    RunThroughputTest(SequencedWorkerPool::SHARED_QUEUE, kThreadCounts[i],
+                      true);
+    RunThroughputTest(SequencedWorkerPool::WORK_STEALING, kThreadCounts[i],
+                      true);
+  }
+}
+
+}  // namespace base
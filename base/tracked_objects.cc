@@ -54,6 +54,17 @@ const ThreadData::Status kInitialStartupState =
 // problem with its presence).
 static const bool kAllowAlternateTimeSourceHandling = true;
 
+// The largest supported ThreadData::SetSampleRate() value, which keeps the gaps
+// between samples, and the scaled up tallies, from overflowing.
+const int kMaxSampleRate = 1 << 20;
+
+// Scales a tally of sampled tasks up to an estimate of all tasks, clamping at
+// INT_MAX like DeathData does.
+int32 ScaleSampledTally(int32 tally, int sample_rate) {
+  int64 scaled = static_cast<int64>(tally) * sample_rate;
+  return scaled < INT_MAX ? static_cast<int32>(scaled) : INT_MAX;
+}
+
 inline bool IsProfilerTimingEnabled() {
   enum {
     UNDEFINED_TIMING,
@@ -265,10 +276,14 @@ base::LazyInstance<base::Lock>::Leaky
 // static
 ThreadData::Status ThreadData::status_ = ThreadData::UNINITIALIZED;
 
+// static
+int ThreadData::sample_rate_ = 1;
+
 ThreadData::ThreadData(const std::string& suggested_name)
     : next_(NULL),
       next_retired_worker_(NULL),
       worker_thread_number_(0),
+      births_until_sample_(0),
       incarnation_count_for_pool_(-1) {
   DCHECK_GE(suggested_name.size(), 0u);
   thread_name_ = suggested_name;
@@ -279,6 +294,7 @@ ThreadData::ThreadData(int thread_number)
     : next_(NULL),
       next_retired_worker_(NULL),
       worker_thread_number_(thread_number),
+      births_until_sample_(0),
       incarnation_count_for_pool_(-1)  {
   CHECK_GT(thread_number, 0);
   base::StringAppendF(&thread_name_, "WorkerThread-%d", thread_number);
@@ -401,6 +417,20 @@ void ThreadData::Snapshot(bool reset_max, ProcessDataSnapshot* process_data) {
           TaskSnapshot(*it->first, DeathData(it->second), "Still_Alive"));
     }
   }
+
+  int sample_rate = sample_rate_;
+  process_data->sample_rate = sample_rate;
+  if (sample_rate == 1)
+    return;
+  for (std::vector<TaskSnapshot>::iterator it = process_data->tasks.begin();
+       it != process_data->tasks.end(); ++it) {
+    DeathDataSnapshot* death_data = &it->death_data;
+    death_data->count = ScaleSampledTally(death_data->count, sample_rate);
+    death_data->run_duration_sum =
+        ScaleSampledTally(death_data->run_duration_sum, sample_rate);
+    death_data->queue_duration_sum =
+        ScaleSampledTally(death_data->queue_duration_sum, sample_rate);
+  }
 }
 
 Births* ThreadData::TallyABirth(const Location& location) {
@@ -432,6 +462,19 @@ Births* ThreadData::TallyABirth(const Location& location) {
   return child;
 }
 
+bool ThreadData::ShouldSampleBirth(int sample_rate) {
+  if (--births_until_sample_ > 0)
+    return false;
+  // Pick the gap until the next sample uniformly from [1, 2 * sample_rate - 1],
+  // so that one birth in |sample_rate| is sampled on average, but sampling
+  // doesn't lock step with tasks that are posted in a fixed pattern.
+  uint32 random = static_cast<uint32>(random_number_) * 1103515245u + 12345u;
+  random_number_ = static_cast<int32>(random);
+  births_until_sample_ =
+      1 + static_cast<int>((random >> 8) % (2 * sample_rate - 1));
+  return true;
+}
+
 void ThreadData::TallyADeath(const Births& birth,
                              int32 queue_duration,
                              int32 run_duration) {
@@ -475,6 +518,9 @@ Births* ThreadData::TallyABirthIfActive(const Location& location) {
   ThreadData* current_thread_data = Get();
   if (!current_thread_data)
     return NULL;
+  int sample_rate = sample_rate_;
+  if (sample_rate > 1 && !current_thread_data->ShouldSampleBirth(sample_rate))
+    return NULL;
   return current_thread_data->TallyABirth(location);
 }
 
@@ -757,8 +803,28 @@ bool ThreadData::TrackingParentChildStatus() {
   return status_ >= PROFILING_CHILDREN_ACTIVE;
 }
 
+// static
+void ThreadData::SetSampleRate(int sample_rate) {
+  DCHECK_GE(sample_rate, 1);
+  DCHECK_LE(sample_rate, kMaxSampleRate);
+  if (sample_rate < 1)
+    sample_rate = 1;
+  else if (sample_rate > kMaxSampleRate)
+    sample_rate = kMaxSampleRate;
+  sample_rate_ = sample_rate;
+}
+
+// static
+int ThreadData::sample_rate() {
+  return sample_rate_;
+}
+
 // static
 TrackedTime ThreadData::NowForStartOfRun(const Births* parent) {
+  // When sampling, a run without a birth wasn't sampled, so don't bother
+  // timing it.
+  if (!parent && sample_rate_ > 1)
+    return TrackedTime();
   if (kTrackParentChildLinks && parent && status_ > PROFILING_ACTIVE) {
     ThreadData* current_thread_data = Get();
     if (current_thread_data)
@@ -827,6 +893,7 @@ void ThreadData::ShutdownSingleThreadedCleanup(bool leak) {
   cleanup_count_ = 0;
   tls_index_.Set(NULL);
   status_ = DORMANT_DURING_TESTS;  // Almost UNINITIALIZED.
+  sample_rate_ = 1;
 
   // To avoid any chance of racing in unit tests, which is the only place we
   // call this function, we may sometimes leak all the data structures we
@@ -889,10 +956,11 @@ ParentChildPairSnapshot::~ParentChildPairSnapshot() {
 
 ProcessDataSnapshot::ProcessDataSnapshot()
 #if !defined(OS_NACL)
-    : process_id(base::GetCurrentProcId()) {
+    : process_id(base::GetCurrentProcId()),
 #else
-    : process_id(0) {
+    : process_id(0),
 #endif
+      sample_rate(1) {
 }
 
 ProcessDataSnapshot::~ProcessDataSnapshot() {
@@ -486,6 +486,16 @@ class BASE_EXPORT ThreadData {
   // threads.
   static void EnsureCleanupWasCalled(int major_threads_shutdown_count);
 
+  // Tallies only about one in |sample_rate| births, picked at random on each
+  // thread, so that tracking can be left on in the field at a small cost.
+  // Births that aren't sampled are neither tallied nor timed.  Snapshot()
+  // scales the counts and duration sums of the sampled tasks by |sample_rate|,
+  // to estimate the totals for each birth location.  The default rate of 1
+  // tallies every birth.  Tallies taken at different rates shouldn't be mixed,
+  // so ResetAllThreadData() should be called after changing the rate.
+  static void SetSampleRate(int sample_rate);
+  static int sample_rate();
+
  private:
   // Allow only tests to call ShutdownSingleThreadedCleanup.  We NEVER call it
   // in production code.
@@ -522,6 +532,10 @@ class BASE_EXPORT ThreadData {
   // In this thread's data, record a new birth.
   Births* TallyABirth(const Location& location);
 
+  // Returns true if the next birth on this thread should be tallied, when one
+  // birth in |sample_rate| is sampled.
+  bool ShouldSampleBirth(int sample_rate);
+
   // Find a place to record a death on this thread.
   void TallyADeath(const Births& birth, int32 queue_duration, int32 duration);
 
@@ -619,6 +633,9 @@ class BASE_EXPORT ThreadData {
   // We set status_ to SHUTDOWN when we shut down the tracking service.
   static Status status_;
 
+  // One in sample_rate_ births is tallied.  See SetSampleRate().
+  static int sample_rate_;
+
   // Link to next instance (null terminated list). Used to globally track all
   // registered instances (corresponds to all registered threads where we keep
   // data).
@@ -680,6 +697,10 @@ class BASE_EXPORT ThreadData {
   // we stir in more and more as we go.
   int32 random_number_;
 
+  // The number of births left on this thread until the next one is sampled,
+  // when sample_rate_ is greater than 1.
+  int births_until_sample_;
+
   // Record of what the incarnation_counter_ was when this instance was created.
   // If the incarnation_counter_ has changed, then we avoid pushing into the
   // pool (this is only critical in tests which go through multiple
@@ -715,6 +736,9 @@ struct BASE_EXPORT ProcessDataSnapshot {
   std::vector<TaskSnapshot> tasks;
   std::vector<ParentChildPairSnapshot> descendants;
   int process_id;
+  // The ThreadData::sample_rate() the tasks were sampled at.  Their counts
+  // and duration sums are already scaled up to estimate all tasks.
+  int sample_rate;
 };
 
 }  // namespace tracked_objects
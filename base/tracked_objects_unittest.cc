@@ -8,8 +8,12 @@
 
 #include <stddef.h>
 
+#include "base/bind.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/message_loop/message_loop.h"
 #include "base/process/process_handle.h"
+#include "base/profiler/snapshot_timer.h"
+#include "base/run_loop.h"
 #include "base/time/time.h"
 #include "base/tracking_info.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -581,4 +585,96 @@ TEST_F(TrackedObjectsTest, DifferentLives) {
   EXPECT_EQ(base::GetCurrentProcId(), process_data.process_id);
 }
 
+TEST_F(TrackedObjectsTest, SampledBirths) {
+  if (!ThreadData::InitializeAndSetTrackingStatus(
+          ThreadData::PROFILING_CHILDREN_ACTIVE))
+    return;
+
+  const int kSampleRate = 4;
+  ThreadData::SetSampleRate(kSampleRate);
+  EXPECT_EQ(kSampleRate, ThreadData::sample_rate());
+  // Runs that weren't sampled aren't timed.
+  EXPECT_TRUE(ThreadData::NowForStartOfRun(NULL).is_null());
+
+  ThreadData::InitializeThreadContext(kMainThreadName);
+  const char kFunction[] = "SampledBirths";
+  Location location(kFunction, kFile, kLineNumber, NULL);
+
+  const base::TimeTicks kTimePosted = base::TimeTicks() +
+      base::TimeDelta::FromMilliseconds(1);
+  const base::TimeTicks kDelayedStartTime = base::TimeTicks();
+  const TrackedTime kStartOfRun = TrackedTime() +
+      Duration::FromMilliseconds(5);
+  const TrackedTime kEndOfRun = TrackedTime() + Duration::FromMilliseconds(7);
+
+  const int kBirths = 4000;
+  int sampled = 0;
+  for (int i = 0; i < kBirths; ++i) {
+    // TrackingInfo will call TallyABirth() during construction.
+    base::TrackingInfo pending_task(location, kDelayedStartTime);
+    pending_task.time_posted = kTimePosted;  // Overwrite implied Now().
+    if (pending_task.birth_tally)
+      ++sampled;
+    ThreadData::TallyRunOnNamedThreadIfTracking(pending_task,
+        kStartOfRun, kEndOfRun);
+  }
+  // About one birth in kSampleRate is sampled.
+  EXPECT_GT(sampled, kBirths / kSampleRate / 2);
+  EXPECT_LT(sampled, kBirths / kSampleRate * 2);
+
+  // The snapshot estimates the tallies of all the births.
+  ProcessDataSnapshot process_data;
+  ThreadData::Snapshot(false, &process_data);
+  EXPECT_EQ(kSampleRate, process_data.sample_rate);
+  ExpectSimpleProcessData(process_data, kFunction, kMainThreadName,
+                          kMainThreadName, sampled * kSampleRate, 2, 4);
+
+  // Reset() restores tallying every birth.
+  Reset();
+  EXPECT_EQ(1, ThreadData::sample_rate());
+}
+
+namespace {
+
+void SaveSnapshotAndQuit(ProcessDataSnapshot* saved,
+                         base::RunLoop* run_loop,
+                         const ProcessDataSnapshot& process_data) {
+  *saved = process_data;
+  run_loop->Quit();
+}
+
+}  // namespace
+
+TEST_F(TrackedObjectsTest, SnapshotTimer) {
+  if (!ThreadData::InitializeAndSetTrackingStatus(
+          ThreadData::PROFILING_CHILDREN_ACTIVE))
+    return;
+
+  const char kFunction[] = "SnapshotTimer";
+  Location location(kFunction, kFile, kLineNumber, NULL);
+  TallyABirth(location, kMainThreadName);
+
+  base::MessageLoop message_loop;
+  base::RunLoop run_loop;
+  ProcessDataSnapshot process_data;
+  SnapshotTimer timer(base::TimeDelta::FromMilliseconds(1),
+                      base::Bind(&SaveSnapshotAndQuit, &process_data,
+                                 &run_loop));
+  timer.Start();
+  EXPECT_TRUE(timer.IsRunning());
+  run_loop.Run();
+  timer.Stop();
+  EXPECT_FALSE(timer.IsRunning());
+
+  // The timer's own task is tallied too.
+  const TaskSnapshot* task = NULL;
+  for (size_t i = 0; i < process_data.tasks.size(); ++i) {
+    if (process_data.tasks[i].birth.location.function_name == kFunction)
+      task = &process_data.tasks[i];
+  }
+  ASSERT_TRUE(task);
+  EXPECT_EQ(1, task->death_data.count);
+  EXPECT_EQ(kStillAlive, task->death_thread_name);
+}
+
 }  // namespace tracked_objects
@@ -357,6 +357,124 @@ bool BinaryValue::Equals(const Value* other) const {
   return !memcmp(GetBuffer(), other_binary->GetBuffer(), size_);
 }
 
+///////////////////// DictionaryStorage ////////////////////
+
+namespace internal {
+
+// static
+const size_t DictionaryStorage::kMaxFlatSize;
+
+DictionaryStorage::DictionaryStorage() {
+}
+
+DictionaryStorage::~DictionaryStorage() {
+}
+
+Value* DictionaryStorage::Find(const StringPiece& key) const {
+  if (map_) {
+    ValueMap::const_iterator it = map_->find(key.as_string());
+    return it == map_->end() ? NULL : it->second;
+  }
+  FlatEntries::const_iterator it = LowerBound(key);
+  if (it == flat_.end() || key != it->first)
+    return NULL;
+  DCHECK(it->second);
+  return it->second;
+}
+
+Value* DictionaryStorage::Insert(const std::string& key, Value* value) {
+  if (map_) {
+    std::pair<ValueMap::iterator, bool> result =
+        map_->insert(std::make_pair(key, value));
+    if (result.second)
+      return NULL;
+    Value* old_value = result.first->second;
+    result.first->second = value;
+    return old_value;
+  }
+
+  // Dictionaries are usually built in key order (e.g. when parsed from JSON
+  // written by JSONWriter), so check for an append first.
+  FlatEntries::iterator it =
+      flat_.empty() || flat_.back().first < key ? flat_.end() : LowerBound(key);
+  if (it != flat_.end() && it->first == key) {
+    Value* old_value = it->second;
+    it->second = value;
+    return old_value;
+  }
+  if (flat_.size() == kMaxFlatSize) {
+    ConvertToMap();
+    return Insert(key, value);
+  }
+  flat_.insert(it, FlatEntry(key, value));
+  return NULL;
+}
+
+Value* DictionaryStorage::Remove(const StringPiece& key) {
+  if (map_) {
+    ValueMap::iterator it = map_->find(key.as_string());
+    if (it == map_->end())
+      return NULL;
+    Value* value = it->second;
+    map_->erase(it);
+    return value;
+  }
+  FlatEntries::iterator it = LowerBound(key);
+  if (it == flat_.end() || key != it->first)
+    return NULL;
+  Value* value = it->second;
+  flat_.erase(it);
+  return value;
+}
+
+void DictionaryStorage::Clear() {
+  map_.reset();
+  FlatEntries().swap(flat_);
+}
+
+void DictionaryStorage::Swap(DictionaryStorage* other) {
+  flat_.swap(other->flat_);
+  map_.swap(other->map_);
+}
+
+DictionaryStorage::ConstIterator DictionaryStorage::begin() const {
+  return map_ ? ConstIterator(map_->begin()) : ConstIterator(flat_.begin());
+}
+
+DictionaryStorage::ConstIterator DictionaryStorage::end() const {
+  return map_ ? ConstIterator(map_->end()) : ConstIterator(flat_.end());
+}
+
+namespace {
+
+bool FlatEntryKeyLess(const DictionaryStorage::FlatEntry& entry,
+                      const StringPiece& key) {
+  return StringPiece(entry.first) < key;
+}
+
+}  // namespace
+
+DictionaryStorage::FlatEntries::iterator DictionaryStorage::LowerBound(
+    const StringPiece& key) {
+  return std::lower_bound(flat_.begin(), flat_.end(), key, &FlatEntryKeyLess);
+}
+
+DictionaryStorage::FlatEntries::const_iterator DictionaryStorage::LowerBound(
+    const StringPiece& key) const {
+  return std::lower_bound(flat_.begin(), flat_.end(), key, &FlatEntryKeyLess);
+}
+
+void DictionaryStorage::ConvertToMap() {
+  DCHECK(!map_);
+  map_.reset(new ValueMap);
+  // |flat_| is sorted, so every insertion is at the end.
+  for (FlatEntries::const_iterator it = flat_.begin(); it != flat_.end(); ++it)
+    map_->insert(map_->end(), *it);
+  FlatEntries().swap(flat_);
+}
+
+}  // namespace internal
+
 ///////////////////// DictionaryValue ////////////////////
 
 DictionaryValue::DictionaryValue()
@@ -381,43 +499,43 @@ bool DictionaryValue::GetAsDictionary(const DictionaryValue** out_value) const {
 
 bool DictionaryValue::HasKey(const std::string& key) const {
   DCHECK(IsStringUTF8(key));
-  ValueMap::const_iterator current_entry = dictionary_.find(key);
-  DCHECK((current_entry == dictionary_.end()) || current_entry->second);
-  return current_entry != dictionary_.end();
+  return dictionary_.Find(key) != NULL;
 }
 
 void DictionaryValue::Clear() {
-  ValueMap::iterator dict_iterator = dictionary_.begin();
-  while (dict_iterator != dictionary_.end()) {
-    delete dict_iterator->second;
-    ++dict_iterator;
+  for (internal::DictionaryStorage::ConstIterator it = dictionary_.begin();
+       it != dictionary_.end(); it.Advance()) {
+    delete it.value();
   }
 
-  dictionary_.clear();
+  dictionary_.Clear();
 }
 
 void DictionaryValue::Set(const std::string& path, Value* in_value) {
   DCHECK(IsStringUTF8(path));
   DCHECK(in_value);
 
-  std::string current_path(path);
+  // Walk the path in place; a key is only copied when a dictionary has to be
+  // created for it.
+  StringPiece current_path(path);
   DictionaryValue* current_dictionary = this;
   for (size_t delimiter_position = current_path.find('.');
-       delimiter_position != std::string::npos;
+       delimiter_position != StringPiece::npos;
        delimiter_position = current_path.find('.')) {
     // Assume that we're indexing into a dictionary.
-    std::string key(current_path, 0, delimiter_position);
-    DictionaryValue* child_dictionary = NULL;
-    if (!current_dictionary->GetDictionary(key, &child_dictionary)) {
-      child_dictionary = new DictionaryValue;
-      current_dictionary->SetWithoutPathExpansion(key, child_dictionary);
+    StringPiece key(current_path.substr(0, delimiter_position));
+    Value* child = current_dictionary->dictionary_.Find(key);
+    if (!child || !child->IsType(TYPE_DICTIONARY)) {
+      child = new DictionaryValue;
+      current_dictionary->SetWithoutPathExpansion(key.as_string(), child);
     }
 
-    current_dictionary = child_dictionary;
-    current_path.erase(0, delimiter_position + 1);
+    current_dictionary = static_cast<DictionaryValue*>(child);
+    current_path = current_path.substr(delimiter_position + 1);
   }
 
-  current_dictionary->SetWithoutPathExpansion(current_path, in_value);
+  current_dictionary->SetWithoutPathExpansion(current_path.as_string(),
+                                              in_value);
 }
 
 void DictionaryValue::SetBoolean(const std::string& path, bool in_value) {
@@ -446,12 +564,10 @@ void DictionaryValue::SetWithoutPathExpansion(const std::string& key,
                                               Value* in_value) {
   // If there's an existing value here, we need to delete it, because
   // we own all our children.
-  std::pair<ValueMap::iterator, bool> ins_res =
-      dictionary_.insert(std::make_pair(key, in_value));
-  if (!ins_res.second) {
-    DCHECK_NE(ins_res.first->second, in_value);  // This would be bogus
-    delete ins_res.first->second;
-    ins_res.first->second = in_value;
+  Value* old_value = dictionary_.Insert(key, in_value);
+  if (old_value) {
+    DCHECK_NE(old_value, in_value);  // This would be bogus
+    delete old_value;
   }
 }
 
@@ -483,21 +599,28 @@ void DictionaryValue::SetStringWithoutPathExpansion(
 bool DictionaryValue::Get(const std::string& path,
                           const Value** out_value) const {
   DCHECK(IsStringUTF8(path));
-  std::string current_path(path);
+  // Walk the path in place rather than copying each component out of it.
+  StringPiece current_path(path);
   const DictionaryValue* current_dictionary = this;
   for (size_t delimiter_position = current_path.find('.');
-       delimiter_position != std::string::npos;
+       delimiter_position != StringPiece::npos;
        delimiter_position = current_path.find('.')) {
-    const DictionaryValue* child_dictionary = NULL;
-    if (!current_dictionary->GetDictionary(
-            current_path.substr(0, delimiter_position), &child_dictionary))
+    const Value* child = current_dictionary->dictionary_.Find(
+        current_path.substr(0, delimiter_position));
+    if (!child || !child->IsType(TYPE_DICTIONARY))
       return false;
 
-    current_dictionary = child_dictionary;
-    current_path.erase(0, delimiter_position + 1);
+    current_dictionary = static_cast<const DictionaryValue*>(child);
+    current_path = current_path.substr(delimiter_position + 1);
   }
 
-  return current_dictionary->GetWithoutPathExpansion(current_path, out_value);
+  const Value* entry = current_dictionary->dictionary_.Find(current_path);
+  if (!entry)
+    return false;
+
+  if (out_value)
+    *out_value = entry;
+  return true;
 }
 
 bool DictionaryValue::Get(const std::string& path, Value** out_value)  {
@@ -628,11 +751,10 @@ bool DictionaryValue::GetList(const std::string& path, ListValue** out_value) {
 bool DictionaryValue::GetWithoutPathExpansion(const std::string& key,
                                               const Value** out_value) const {
   DCHECK(IsStringUTF8(key));
-  ValueMap::const_iterator entry_iterator = dictionary_.find(key);
-  if (entry_iterator == dictionary_.end())
+  const Value* entry = dictionary_.Find(key);
+  if (!entry)
     return false;
 
-  const Value* entry = entry_iterator->second;
   if (out_value)
     *out_value = entry;
   return true;
@@ -757,16 +879,14 @@ bool DictionaryValue::Remove(const std::string& path,
 bool DictionaryValue::RemoveWithoutPathExpansion(const std::string& key,
                                                  scoped_ptr<Value>* out_value) {
   DCHECK(IsStringUTF8(key));
-  ValueMap::iterator entry_iterator = dictionary_.find(key);
-  if (entry_iterator == dictionary_.end())
+  Value* entry = dictionary_.Remove(key);
+  if (!entry)
     return false;
 
-  Value* entry = entry_iterator->second;
   if (out_value)
     out_value->reset(entry);
   else
     delete entry;
-  dictionary_.erase(entry_iterator);
   return true;
 }
 
@@ -813,7 +933,7 @@ void DictionaryValue::MergeDictionary(const DictionaryValue* dictionary) {
 }
 
 void DictionaryValue::Swap(DictionaryValue* other) {
-  dictionary_.swap(other->dictionary_);
+  dictionary_.Swap(&other->dictionary_);
 }
 
 DictionaryValue::Iterator::Iterator(const DictionaryValue& target)
@@ -825,10 +945,9 @@ DictionaryValue::Iterator::~Iterator() {}
 DictionaryValue* DictionaryValue::DeepCopy() const {
   DictionaryValue* result = new DictionaryValue;
 
-  for (ValueMap::const_iterator current_entry(dictionary_.begin());
-       current_entry != dictionary_.end(); ++current_entry) {
-    result->SetWithoutPathExpansion(current_entry->first,
-                                    current_entry->second->DeepCopy());
+  for (internal::DictionaryStorage::ConstIterator it = dictionary_.begin();
+       it != dictionary_.end(); it.Advance()) {
+    result->SetWithoutPathExpansion(it.key(), it.value()->DeepCopy());
   }
 
   return result;
@@ -30,6 +30,7 @@
 #include "base/compiler_specific.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/strings/string16.h"
+#include "base/strings/string_piece.h"
 
 namespace base {
 
@@ -203,6 +204,100 @@ class BASE_EXPORT BinaryValue: public Value {
   DISALLOW_COPY_AND_ASSIGN(BinaryValue);
 };
 
+namespace internal {
+
+// The storage behind DictionaryValue. It does not own the Values it holds.
+//
+// Most dictionaries have only a handful of keys, so entries are kept in a
+// vector sorted by key: one allocation for the whole dictionary instead of a
+// tree node per key, and lookups that need no temporary std::string. Once a
+// dictionary grows past kMaxFlatSize entries it moves to a ValueMap, so that
+// inserting out-of-order keys into a large dictionary stays logarithmic.
+// Either way, entries are visited in key order. Any change to the storage
+// invalidates its iterators.
+class BASE_EXPORT DictionaryStorage {
+ public:
+  typedef std::pair<std::string, Value*> FlatEntry;
+  typedef std::vector<FlatEntry> FlatEntries;
+
+  static const size_t kMaxFlatSize = 64;
+
+  class BASE_EXPORT ConstIterator {
+   public:
+    explicit ConstIterator(FlatEntries::const_iterator it)
+        : is_flat_(true), flat_it_(it) {}
+    explicit ConstIterator(ValueMap::const_iterator it)
+        : is_flat_(false), map_it_(it) {}
+
+    const std::string& key() const {
+      return is_flat_ ? flat_it_->first : map_it_->first;
+    }
+    Value* value() const {
+      return is_flat_ ? flat_it_->second : map_it_->second;
+    }
+
+    void Advance() {
+      if (is_flat_)
+        ++flat_it_;
+      else
+        ++map_it_;
+    }
+
+    bool operator==(const ConstIterator& other) const {
+      return is_flat_ ? flat_it_ == other.flat_it_ : map_it_ == other.map_it_;
+    }
+    bool operator!=(const ConstIterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    bool is_flat_;
+    FlatEntries::const_iterator flat_it_;
+    ValueMap::const_iterator map_it_;
+  };
+
+  DictionaryStorage();
+  ~DictionaryStorage();
+
+  size_t size() const { return map_ ? map_->size() : flat_.size(); }
+  bool empty() const { return size() == 0; }
+
+  // Returns the value for |key|, or NULL if there is none.
+  Value* Find(const StringPiece& key) const;
+
+  // Associates |value| with |key|. Returns the value previously associated
+  // with |key|, if any, which the caller then owns.
+  Value* Insert(const std::string& key, Value* value);
+
+  // Removes |key|. Returns the value it was associated with, if any, which
+  // the caller then owns.
+  Value* Remove(const StringPiece& key);
+
+  // Removes every entry, without deleting the values.
+  void Clear();
+
+  void Swap(DictionaryStorage* other);
+
+  ConstIterator begin() const;
+  ConstIterator end() const;
+
+ private:
+  // Returns the first flat entry whose key is not less than |key|.
+  FlatEntries::iterator LowerBound(const StringPiece& key);
+  FlatEntries::const_iterator LowerBound(const StringPiece& key) const;
+
+  // Moves every entry from |flat_| into a newly created |map_|.
+  void ConvertToMap();
+
+  // Used while |map_| is NULL.
+  FlatEntries flat_;
+  scoped_ptr<ValueMap> map_;
+
+  DISALLOW_COPY_AND_ASSIGN(DictionaryStorage);
+};
+
+}  // namespace internal
+
 // DictionaryValue provides a key-value dictionary with (optional) "path"
 // parsing for recursive access; see the comment at the top of the file. Keys
 // are |std::string|s and should be UTF-8 encoded.
@@ -352,14 +447,14 @@ class BASE_EXPORT DictionaryValue : public Value {
     ~Iterator();
 
     bool IsAtEnd() const { return it_ == target_.dictionary_.end(); }
-    void Advance() { ++it_; }
+    void Advance() { it_.Advance(); }
 
-    const std::string& key() const { return it_->first; }
-    const Value& value() const { return *it_->second; }
+    const std::string& key() const { return it_.key(); }
+    const Value& value() const { return *it_.value(); }
 
    private:
     const DictionaryValue& target_;
-    ValueMap::const_iterator it_;
+    internal::DictionaryStorage::ConstIterator it_;
   };
 
   // Overridden from Value:
@@ -367,7 +462,7 @@ class BASE_EXPORT DictionaryValue : public Value {
   virtual bool Equals(const Value* other) const OVERRIDE;
 
  private:
-  ValueMap dictionary_;
+  internal::DictionaryStorage dictionary_;
 
   DISALLOW_COPY_AND_ASSIGN(DictionaryValue);
 };
@@ -0,0 +1,157 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures the memory held by, and lookup speed of, many small
+// DictionaryValues shaped like the per-extension and per-site entries that
+// PrefService keeps. A plain ValueMap with the same entries, which is how
+// DictionaryValue used to store them, serves as the baseline.
+
+#include <string>
+#include <vector>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/process/process_handle.h"
+#include "base/process/process_metrics.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace base {
+
+namespace {
+
+const int kNumDictionaries = 50000;
+const int kLookupRounds = 20;
+
+const char* const kKeys[] = {
+  "active_permissions", "creation_flags", "from_webstore", "install_time",
+  "location", "path", "state",
+};
+
+size_t GetCurrentWorkingSetSize() {
+  scoped_ptr<ProcessMetrics> metrics(
+      ProcessMetrics::CreateProcessMetrics(GetCurrentProcessHandle()));
+  return metrics->GetWorkingSetSize();
+}
+
+void FillDictionary(int index, DictionaryValue* dictionary) {
+  for (size_t i = 0; i < arraysize(kKeys); ++i)
+    dictionary->SetIntegerWithoutPathExpansion(kKeys[i], index);
+  dictionary->SetString("manifest.name", StringPrintf("Extension %d", index));
+}
+
+void FillValueMap(int index, ValueMap* map) {
+  for (size_t i = 0; i < arraysize(kKeys); ++i)
+    (*map)[kKeys[i]] = new FundamentalValue(index);
+}
+
+void ClearValueMap(ValueMap* map) {
+  for (ValueMap::iterator it = map->begin(); it != map->end(); ++it)
+    delete it->second;
+  map->clear();
+}
+
+void PrintLookupTime(const std::string& trace, TimeDelta elapsed) {
+  perf_test::PrintResult(
+      "dictionary_lookup_time", "", trace,
+      elapsed.InMicroseconds() * 1000.0 / (kNumDictionaries * kLookupRounds),
+      "ns", true);
+}
+
+}  // namespace
+
+TEST(ValuesPerfTest, DictionaryMemory) {
+  // Only the flat keys are compared; the baseline has no nested dictionary.
+  size_t before = GetCurrentWorkingSetSize();
+  std::vector<ValueMap> maps(kNumDictionaries);
+  for (int i = 0; i < kNumDictionaries; ++i)
+    FillValueMap(i, &maps[i]);
+  size_t after = GetCurrentWorkingSetSize();
+  perf_test::PrintResult("dictionary_memory", "", "value_map",
+                         (after - before) / 1024, "KB", true);
+
+  before = GetCurrentWorkingSetSize();
+  ScopedVector<DictionaryValue> dictionaries;
+  for (int i = 0; i < kNumDictionaries; ++i) {
+    DictionaryValue* dictionary = new DictionaryValue;
+    for (size_t j = 0; j < arraysize(kKeys); ++j)
+      dictionary->SetIntegerWithoutPathExpansion(kKeys[j], i);
+    dictionaries.push_back(dictionary);
+  }
+  after = GetCurrentWorkingSetSize();
+  perf_test::PrintResult("dictionary_memory", "", "dictionary_value",
+                         (after - before) / 1024, "KB", true);
+
+  for (int i = 0; i < kNumDictionaries; ++i)
+    ClearValueMap(&maps[i]);
+}
+
+TEST(ValuesPerfTest, DictionaryLookup) {
+  std::vector<ValueMap> maps(kNumDictionaries);
+  ScopedVector<DictionaryValue> dictionaries;
+  for (int i = 0; i < kNumDictionaries; ++i) {
+    FillValueMap(i, &maps[i]);
+    DictionaryValue* dictionary = new DictionaryValue;
+    FillDictionary(i, dictionary);
+    dictionaries.push_back(dictionary);
+  }
+
+  const std::string key("location");
+  int sum = 0;
+  TimeTicks start = TimeTicks::Now();
+  for (int round = 0; round < kLookupRounds; ++round) {
+    for (int i = 0; i < kNumDictionaries; ++i) {
+      ValueMap::const_iterator it = maps[i].find(key);
+      int value = 0;
+      if (it != maps[i].end() && it->second->GetAsInteger(&value))
+        sum += value;
+    }
+  }
+  PrintLookupTime("value_map", TimeTicks::Now() - start);
+
+  int dictionary_sum = 0;
+  start = TimeTicks::Now();
+  for (int round = 0; round < kLookupRounds; ++round) {
+    for (int i = 0; i < kNumDictionaries; ++i) {
+      int value = 0;
+      if (dictionaries[i]->GetIntegerWithoutPathExpansion(key, &value))
+        dictionary_sum += value;
+    }
+  }
+  PrintLookupTime("without_path_expansion", TimeTicks::Now() - start);
+  EXPECT_EQ(sum, dictionary_sum);
+
+  dictionary_sum = 0;
+  start = TimeTicks::Now();
+  for (int round = 0; round < kLookupRounds; ++round) {
+    for (int i = 0; i < kNumDictionaries; ++i) {
+      int value = 0;
+      if (dictionaries[i]->GetInteger(key, &value))
+        dictionary_sum += value;
+    }
+  }
+  PrintLookupTime("path", TimeTicks::Now() - start);
+  EXPECT_EQ(sum, dictionary_sum);
+
+  const std::string path("manifest.name");
+  size_t found = 0;
+  start = TimeTicks::Now();
+  for (int round = 0; round < kLookupRounds; ++round) {
+    for (int i = 0; i < kNumDictionaries; ++i) {
+      const Value* value = NULL;
+      if (dictionaries[i]->Get(path, &value))
+        ++found;
+    }
+  }
+  PrintLookupTime("nested_path", TimeTicks::Now() - start);
+  EXPECT_EQ(static_cast<size_t>(kNumDictionaries * kLookupRounds), found);
+
+  for (int i = 0; i < kNumDictionaries; ++i)
+    ClearValueMap(&maps[i]);
+}
+
+}  // namespace base
@@ -6,6 +6,7 @@
 
 #include "base/memory/scoped_ptr.h"
 #include "base/strings/string16.h"
+#include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/values.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -809,4 +810,88 @@ TEST(ValuesTest, DictionaryIterator) {
   EXPECT_TRUE(seen2);
 }
 
+// Dictionaries change representation once they grow large; nothing about
+// their behavior should.
+TEST(ValuesTest, LargeDictionary) {
+  const int kNumKeys =
+      static_cast<int>(internal::DictionaryStorage::kMaxFlatSize) * 3;
+
+  // Insert out of order, both below and above the size at which the storage
+  // changes.
+  DictionaryValue dict;
+  for (int i = 0; i < kNumKeys; ++i) {
+    int key = (i * 37) % kNumKeys;
+    dict.SetIntegerWithoutPathExpansion(StringPrintf("k%05d", key), key);
+    EXPECT_EQ(static_cast<size_t>(i + 1), dict.size());
+  }
+
+  // Replace a value.
+  dict.SetInteger("k00001", -1);
+  EXPECT_EQ(static_cast<size_t>(kNumKeys), dict.size());
+
+  // Iteration is in key order.
+  int expected = 0;
+  for (DictionaryValue::Iterator it(dict); !it.IsAtEnd(); it.Advance()) {
+    EXPECT_EQ(StringPrintf("k%05d", expected), it.key());
+    int value = 0;
+    EXPECT_TRUE(it.value().GetAsInteger(&value));
+    EXPECT_EQ(expected == 1 ? -1 : expected, value);
+    ++expected;
+  }
+  EXPECT_EQ(kNumKeys, expected);
+
+  EXPECT_TRUE(dict.HasKey("k00010"));
+  EXPECT_FALSE(dict.HasKey("k0001"));
+  EXPECT_TRUE(dict.RemoveWithoutPathExpansion("k00010", NULL));
+  EXPECT_FALSE(dict.HasKey("k00010"));
+  EXPECT_FALSE(dict.RemoveWithoutPathExpansion("k00010", NULL));
+
+  // Large and small dictionaries compare and swap with each other.
+  scoped_ptr<DictionaryValue> copy(dict.DeepCopy());
+  EXPECT_TRUE(dict.Equals(copy.get()));
+  DictionaryValue small;
+  small.SetInteger("a", 1);
+  small.Swap(&dict);
+  EXPECT_EQ(1u, dict.size());
+  EXPECT_TRUE(small.Equals(copy.get()));
+
+  small.Clear();
+  EXPECT_TRUE(small.empty());
+  small.SetInteger("b", 2);
+  EXPECT_EQ(1u, small.size());
+}
+
+TEST(ValuesTest, DictionaryPaths) {
+  DictionaryValue dict;
+  dict.SetString("a.b.c", "abc");
+  dict.SetInteger("a.b.d", 1);
+  dict.SetInteger("a.e", 2);
+
+  std::string string_value;
+  EXPECT_TRUE(dict.GetString("a.b.c", &string_value));
+  EXPECT_EQ("abc", string_value);
+  int int_value = 0;
+  EXPECT_TRUE(dict.GetInteger("a.e", &int_value));
+  EXPECT_EQ(2, int_value);
+
+  // A path through a non-dictionary, or with an empty or partial component,
+  // does not resolve.
+  EXPECT_FALSE(dict.Get("a.e.f", NULL));
+  EXPECT_FALSE(dict.Get("a..b", NULL));
+  EXPECT_FALSE(dict.Get("a.b.", NULL));
+  EXPECT_FALSE(dict.Get("a.bb.c", NULL));
+  EXPECT_FALSE(dict.Get("a.b.c.", NULL));
+
+  // Setting through a non-dictionary replaces it.
+  dict.SetInteger("a.e.f", 3);
+  EXPECT_TRUE(dict.GetInteger("a.e.f", &int_value));
+  EXPECT_EQ(3, int_value);
+
+  // Keys containing '.' are reachable without path expansion only.
+  dict.SetIntegerWithoutPathExpansion("x.y", 4);
+  EXPECT_FALSE(dict.Get("x.y", NULL));
+  EXPECT_TRUE(dict.GetIntegerWithoutPathExpansion("x.y", &int_value));
+  EXPECT_EQ(4, int_value);
+}
+
 }  // namespace base
@@ -79,6 +79,38 @@ const char kCompositeToMailbox[] = "composite-to-mailbox";
 const char kStrictLayerPropertyChangeChecking[] =
     "strict-layer-property-change-checking";
 
+// Only recompute the draw properties of compositor layer subtrees that changed
+// since the last frame.
+const char kEnableIncrementalDrawProperties[] =
+    "enable-incremental-draw-properties";
+
+// Check the draw properties computed with --enable-incremental-draw-properties
+// against a full computation every frame, and log the layers that differ.
+const char kVerifyIncrementalDrawProperties[] =
+    "verify-incremental-draw-properties";
+
+// Track occlusion while updating tile priorities, and don't raster tiles that
+// are hidden behind opaque layers.
+const char kEnableOcclusionForTilePrioritization[] =
+    "enable-occlusion-for-tile-prioritization";
+
+// Share the commands of identical recordings, such as the rows of a long list,
+// between the cells and layers that recorded them.
+const char kEnableRecordingSharing[] = "enable-recording-sharing";
+
+// Drop the recordings of a layer that are far from the viewport while they
+// take more than this many bytes, and record them again when needed.
+const char kMaxRecordedBytesPerLayer[] = "max-recorded-bytes-per-layer";
+
+// With impl-side painting, let the main thread start on the next frame while
+// the previous one is still waiting to activate.
+const char kEnableMainFrameBeforeActivation[] =
+    "enable-main-frame-before-activation";
+
+// Keep the contents of render surfaces from frame to frame, and only draw the
+// parts of them that changed.
+const char kEnableRenderPassCaching[] = "enable-render-pass-caching";
+
 // Virtual viewport for fixed-position elements, scrollbars during pinch.
 const char kEnablePinchVirtualViewport[] = "enable-pinch-virtual-viewport";
 
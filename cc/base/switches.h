@@ -37,6 +37,13 @@ CC_EXPORT extern const char kMaxTilesForInterestArea[];
 CC_EXPORT extern const char kMaxUnusedResourceMemoryUsagePercentage[];
 CC_EXPORT extern const char kEnablePinchVirtualViewport[];
 CC_EXPORT extern const char kStrictLayerPropertyChangeChecking[];
+CC_EXPORT extern const char kEnableIncrementalDrawProperties[];
+CC_EXPORT extern const char kVerifyIncrementalDrawProperties[];
+CC_EXPORT extern const char kEnableOcclusionForTilePrioritization[];
+CC_EXPORT extern const char kEnableRecordingSharing[];
+CC_EXPORT extern const char kMaxRecordedBytesPerLayer[];
+CC_EXPORT extern const char kEnableMainFrameBeforeActivation[];
+CC_EXPORT extern const char kEnableRenderPassCaching[];
 CC_EXPORT extern const char kEnableMapImage[];
 CC_EXPORT extern const char kDisableMapImage[];
 CC_EXPORT extern const char kDisable4444Textures[];
@@ -111,7 +111,7 @@ void PictureRecordBenchmark::RunOnLayer(PictureLayer* layer) {
         base::TimeTicks start = base::TimeTicks::HighResNow();
 
         scoped_refptr<Picture> picture =
-            Picture::Create(rect, painter, tile_grid_info, false, 0);
+            Picture::Create(rect, painter, tile_grid_info, false, 0, false);
 
         base::TimeTicks end = base::TimeTicks::HighResNow();
         base::TimeDelta duration = end - start;
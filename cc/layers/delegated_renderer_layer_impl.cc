@@ -261,6 +261,9 @@ void DelegatedRendererLayerImpl::AppendContributingRenderPasses(
         render_passes_in_draw_order_[i]->Copy(output_render_pass_id);
     copy_pass->transform_to_root_target.ConcatTransform(
         delegated_frame_to_root_transform);
+    // The child's damage is relative to the last frame it produced, which may
+    // never have been drawn here.
+    copy_pass->damage_rect = copy_pass->output_rect;
     render_pass_sink->AppendRenderPass(copy_pass.Pass());
   }
 }
@@ -457,7 +457,12 @@ SkRect HeadsUpDisplayLayerImpl::DrawMemoryDisplay(SkCanvas* canvas,
   const int kPadding = 4;
   const int kFontHeight = 13;
 
-  const int height = 3 * kFontHeight + 4 * kPadding;
+  const int64 raster_cache_lookup_count =
+      memory_entry_.raster_cache_hit_count +
+      memory_entry_.raster_cache_miss_count;
+  const int lines = raster_cache_lookup_count ? 4 : 3;
+
+  const int height = lines * kFontHeight + (lines + 1) * kPadding;
   const int left = bounds().width() - width - right;
   const SkRect area = SkRect::MakeXYWH(left, top, width, height);
 
@@ -496,6 +501,19 @@ SkRect HeadsUpDisplayLayerImpl::DrawMemoryDisplay(SkCanvas* canvas,
   }
   DrawText(canvas, &paint, text, SkPaint::kRight_Align, kFontHeight, stat2_pos);
 
+  if (raster_cache_lookup_count) {
+    SkPoint stat3_pos = SkPoint::Make(left + width - kPadding - 1,
+                                      top + 3 * kPadding + 4 * kFontHeight);
+    paint.setColor(DebugColors::MemoryDisplayTextColor());
+    text = base::StringPrintf(
+        "%3.0f%% reused %5.1f MP",
+        100.0 * memory_entry_.raster_cache_hit_count /
+            raster_cache_lookup_count,
+        memory_entry_.raster_cache_saved_pixel_count / 1000000.0);
+    DrawText(
+        canvas, &paint, text, SkPaint::kRight_Align, kFontHeight, stat3_pos);
+  }
+
   return area;
 }
 
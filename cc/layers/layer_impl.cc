@@ -37,14 +37,12 @@ LayerImpl::LayerImpl(LayerTreeImpl* tree_impl, int id)
     : parent_(NULL),
       scroll_parent_(NULL),
       clip_parent_(NULL),
-      mask_layer_id_(-1),
-      replica_layer_id_(-1),
       layer_id_(id),
       layer_tree_impl_(tree_impl),
       anchor_point_(0.5f, 0.5f),
       anchor_point_z_(0.f),
+      opacity_(1.0),
       scroll_offset_delegate_(NULL),
-      scroll_clip_layer_(NULL),
       should_scroll_on_main_thread_(false),
       have_wheel_event_handlers_(false),
       user_scrollable_horizontal_(true),
@@ -63,8 +61,10 @@ LayerImpl::LayerImpl(LayerTreeImpl* tree_impl, int id)
       force_render_surface_(false),
       is_container_for_fixed_position_layers_(false),
       is_3d_sorted_(false),
+      mask_layer_id_(-1),
+      replica_layer_id_(-1),
+      scroll_clip_layer_(NULL),
       background_color_(0),
-      opacity_(1.0),
       blend_mode_(SkXfermode::kSrcOver_Mode),
       draw_depth_(0.f),
       needs_push_properties_(false),
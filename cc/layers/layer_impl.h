@@ -47,6 +47,7 @@ namespace cc {
 class LayerTreeHostImpl;
 class LayerTreeImpl;
 class MicroBenchmarkImpl;
+template <typename LayerType, typename SurfaceType> class OcclusionTrackerBase;
 class QuadSink;
 class Renderer;
 class ScrollbarAnimationController;
@@ -179,7 +180,11 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
   virtual RenderPass::Id FirstContributingRenderPassId() const;
   virtual RenderPass::Id NextContributingRenderPassId(RenderPass::Id id) const;
 
-  virtual void UpdateTilePriorities() {}
+  // |occlusion_tracker| is null unless occlusion is used for tile priorities.
+  // Otherwise it has entered this layer in a front-to-back traversal.
+  virtual void UpdateTilePriorities(
+      const OcclusionTrackerBase<LayerImpl, RenderSurfaceImpl>*
+          occlusion_tracker) {}
 
   virtual ScrollbarLayerImplBase* ToScrollbarLayer();
 
@@ -547,27 +552,15 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
 
   virtual const char* LayerTypeAsString() const;
 
+  // The members read by every frame's draw property calculation and damage
+  // tracking come first, so that walking the tree touches as few cache lines
+  // of each layer as possible. Rarely used state follows them.
+
   // Properties internal to LayerImpl
   LayerImpl* parent_;
   OwnedLayerImplList children_;
-
   LayerImpl* scroll_parent_;
-
-  // Storing a pointer to a set rather than a set since this will be rarely
-  // used. If this pointer turns out to be too heavy, we could have this (and
-  // the scroll parent above) be stored in a LayerImpl -> scroll_info
-  // map somewhere.
-  scoped_ptr<std::set<LayerImpl*> > scroll_children_;
-
   LayerImpl* clip_parent_;
-  scoped_ptr<std::set<LayerImpl*> > clip_children_;
-
-  // mask_layer_ can be temporarily stolen during tree sync, we need this ID to
-  // confirm newly assigned layer is still the previous one
-  int mask_layer_id_;
-  scoped_ptr<LayerImpl> mask_layer_;
-  int replica_layer_id_;  // ditto
-  scoped_ptr<LayerImpl> replica_layer_;
   int layer_id_;
   LayerTreeImpl* layer_tree_impl_;
 
@@ -575,9 +568,11 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
   gfx::PointF anchor_point_;
   float anchor_point_z_;
   gfx::Size bounds_;
+  float opacity_;
+  gfx::PointF position_;
   gfx::Vector2d scroll_offset_;
   LayerScrollOffsetDelegate* scroll_offset_delegate_;
-  LayerImpl* scroll_clip_layer_;
+  gfx::Vector2dF scroll_delta_;
   bool scrollable_ : 1;
   bool should_scroll_on_main_thread_ : 1;
   bool have_wheel_event_handlers_ : 1;
@@ -603,14 +598,36 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
   // Set for the layer that other layers are fixed to.
   bool is_container_for_fixed_position_layers_ : 1;
   bool is_3d_sorted_ : 1;
+  gfx::Transform transform_;
+
+  // Rect indicating what was repainted/updated during update.
+  // Note that plugin layers bypass this and leave it empty.
+  // Uses layer (not content) space.
+  gfx::RectF update_rect_;
+
+  // Group of properties that need to be computed based on the layer tree
+  // hierarchy before layers can be drawn.
+  DrawProperties<LayerImpl> draw_properties_;
+
+  // Storing a pointer to a set rather than a set since this will be rarely
+  // used. If this pointer turns out to be too heavy, we could have this (and
+  // the scroll parent above) be stored in a LayerImpl -> scroll_info
+  // map somewhere.
+  scoped_ptr<std::set<LayerImpl*> > scroll_children_;
+  scoped_ptr<std::set<LayerImpl*> > clip_children_;
+
+  // mask_layer_ can be temporarily stolen during tree sync, we need this ID to
+  // confirm newly assigned layer is still the previous one
+  int mask_layer_id_;
+  scoped_ptr<LayerImpl> mask_layer_;
+  int replica_layer_id_;  // ditto
+  scoped_ptr<LayerImpl> replica_layer_;
+
+  LayerImpl* scroll_clip_layer_;
   Region non_fast_scrollable_region_;
   Region touch_event_handler_region_;
   SkColor background_color_;
-
-  float opacity_;
   SkXfermode::Mode blend_mode_;
-  gfx::PointF position_;
-  gfx::Transform transform_;
 
   // This property is effective when
   // is_container_for_fixed_position_layers_ == true,
@@ -618,7 +635,6 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
 
   LayerPositionConstraint position_constraint_;
 
-  gfx::Vector2dF scroll_delta_;
   gfx::Vector2d sent_scroll_delta_;
   gfx::Vector2dF last_scroll_offset_;
 
@@ -644,11 +660,6 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
   DrawMode current_draw_mode_;
 
  private:
-  // Rect indicating what was repainted/updated during update.
-  // Note that plugin layers bypass this and leave it empty.
-  // Uses layer (not content) space.
-  gfx::RectF update_rect_;
-
   // Manages animations for this layer.
   scoped_refptr<LayerAnimationController> layer_animation_controller_;
 
@@ -659,10 +670,6 @@ class CC_EXPORT LayerImpl : public LayerAnimationValueObserver,
 
   ScopedPtrVector<CopyOutputRequest> copy_requests_;
 
-  // Group of properties that need to be computed based on the layer tree
-  // hierarchy before layers can be drawn.
-  DrawProperties<LayerImpl> draw_properties_;
-
   scoped_refptr<base::debug::ConvertableToTraceFormat> debug_info_;
 
   DISALLOW_COPY_AND_ASSIGN(LayerImpl);
@@ -51,6 +51,9 @@ void PictureLayer::PushPropertiesTo(LayerImpl* base_layer) {
   }
 
   layer_impl->SetIsMask(is_mask_);
+  layer_impl->SetShouldUseGpuRasterization(
+      layer_tree_host()->settings().gpu_rasterization &&
+      pile_->is_suitable_for_gpu_rasterization());
   // Unlike other properties, invalidation must always be set on layer_impl.
   // See PictureLayerImpl::PushPropertiesTo for more details.
   layer_impl->invalidation_.Clear();
@@ -67,6 +70,12 @@ void PictureLayer::SetLayerTreeHost(LayerTreeHost* host) {
         host->debug_state().slow_down_raster_scale_factor);
     pile_->set_show_debug_picture_borders(
         host->debug_state().show_picture_borders);
+    pile_->set_analyze_for_gpu_rasterization(
+        host->settings().gpu_rasterization);
+    pile_->set_share_identical_recordings(
+        host->settings().share_identical_recordings);
+    pile_->set_max_recorded_bytes(
+        host->settings().max_recorded_bytes_per_layer);
   }
 }
 
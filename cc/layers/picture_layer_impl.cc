@@ -91,6 +91,8 @@ void PictureLayerImpl::PushPropertiesTo(LayerImpl* base_layer) {
 
   layer_impl->SetIsMask(is_mask_);
   layer_impl->pile_ = pile_;
+  // The tilings below were made for this layer's rasterizer.
+  layer_impl->should_use_gpu_rasterization_ = should_use_gpu_rasterization_;
 
   // Tilings would be expensive to push, so we swap.  This optimization requires
   // an extra invalidation in SyncFromActiveLayer.
@@ -303,7 +305,9 @@ void PictureLayerImpl::AppendQuads(QuadSink* quad_sink,
   CleanUpTilingsOnActiveLayer(seen_tilings);
 }
 
-void PictureLayerImpl::UpdateTilePriorities() {
+void PictureLayerImpl::UpdateTilePriorities(
+    const OcclusionTrackerBase<LayerImpl, RenderSurfaceImpl>*
+        occlusion_tracker) {
   DCHECK(!needs_post_commit_initialization_);
   CHECK(should_update_tile_priorities_);
 
@@ -353,7 +357,10 @@ void PictureLayerImpl::UpdateTilePriorities() {
   tilings_->UpdateTilePriorities(tree,
                                  visible_rect_in_content_space,
                                  contents_scale_x(),
-                                 current_frame_time_in_seconds);
+                                 current_frame_time_in_seconds,
+                                 occlusion_tracker,
+                                 render_target(),
+                                 draw_transform());
 
   if (layer_tree_impl()->IsPendingTree())
     MarkVisibleResourcesAsRequired();
@@ -634,8 +641,11 @@ void PictureLayerImpl::SyncTiling(
   // need update draw properties, then its transforms are up to date and
   // we can create tiles for this tiling immediately.
   if (!layer_tree_impl()->needs_update_draw_properties() &&
-      should_update_tile_priorities_)
-    UpdateTilePriorities();
+      should_update_tile_priorities_) {
+    // Occlusion is only tracked while updating draw properties, and the new
+    // tiles pick it up on the next update.
+    UpdateTilePriorities(NULL);
+  }
 }
 
 void PictureLayerImpl::SetIsMask(bool is_mask) {
@@ -794,6 +804,10 @@ bool PictureLayerImpl::MarkVisibleTilesAsRequired(
     if (!missing_region.Intersects(iter.geometry_rect()))
       continue;
 
+    // Occluded tiles are not drawn, so activation does not wait on them.
+    if (tile->priority(PENDING_TREE).is_occluded)
+      continue;
+
     // If the twin tile doesn't exist (i.e. missing recording or so far away
     // that it is outside the visible tile rect) or this tile is shared between
     // with the twin, then this tile isn't required to prevent flashing.
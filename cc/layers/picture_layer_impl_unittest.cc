@@ -311,7 +311,7 @@ TEST_F(PictureLayerImplTest, SuppressUpdateTilePriorities) {
                                         &dummy_content_bounds);
 
   EXPECT_TRUE(host_impl_.manage_tiles_needed());
-  active_layer_->UpdateTilePriorities();
+  active_layer_->UpdateTilePriorities(NULL);
   host_impl_.ManageTiles();
   EXPECT_FALSE(host_impl_.manage_tiles_needed());
 
@@ -324,7 +324,7 @@ TEST_F(PictureLayerImplTest, SuppressUpdateTilePriorities) {
                                         gfx::Rect(layer_bounds),
                                         gfx::Rect(layer_bounds),
                                         valid_for_tile_management);
-  active_layer_->UpdateTilePriorities();
+  active_layer_->UpdateTilePriorities(NULL);
   EXPECT_FALSE(host_impl_.manage_tiles_needed());
 
   time_ticks += base::TimeDelta::FromMilliseconds(200);
@@ -335,7 +335,7 @@ TEST_F(PictureLayerImplTest, SuppressUpdateTilePriorities) {
                                         gfx::Rect(layer_bounds),
                                         gfx::Rect(layer_bounds),
                                         valid_for_tile_management);
-  active_layer_->UpdateTilePriorities();
+  active_layer_->UpdateTilePriorities(NULL);
   EXPECT_TRUE(host_impl_.manage_tiles_needed());
 }
 
@@ -174,14 +174,20 @@ void DirectRenderer::DecideRenderPassAllocationsForFrame(
 
     bool size_appropriate = texture->size().width() >= required_size.width() &&
                             texture->size().height() >= required_size.height();
-    if (texture->id() && !size_appropriate)
+    if (texture->id() && !size_appropriate) {
+      DidChangeRenderPassContents(pass_iter->first);
+      complete_render_passes_.erase(pass_iter->first);
       texture->Free();
+    }
   }
 
   // Delete RenderPass textures from the previous frame that will not be used
   // again.
-  for (size_t i = 0; i < passes_to_delete.size(); ++i)
+  for (size_t i = 0; i < passes_to_delete.size(); ++i) {
+    DidChangeRenderPassContents(passes_to_delete[i]);
+    complete_render_passes_.erase(passes_to_delete[i]);
     render_pass_textures_.erase(passes_to_delete[i]);
+  }
 
   for (size_t i = 0; i < render_passes_in_draw_order.size(); ++i) {
     if (!render_pass_textures_.contains(render_passes_in_draw_order[i]->id)) {
@@ -334,11 +340,30 @@ void DirectRenderer::DrawRenderPass(DrawingFrame* frame,
                                     const RenderPass* render_pass,
                                     bool allow_partial_swap) {
   TRACE_EVENT0("cc", "DirectRenderer::DrawRenderPass");
+  // A render pass whose texture is kept is drawn in full the first time, and
+  // after that only where it is damaged.
+  bool cache_contents = settings_->cache_render_pass_contents &&
+                        render_pass != frame->root_render_pass;
+  bool has_complete_contents =
+      cache_contents && HasCompleteRenderPassContents(render_pass);
+  if (has_complete_contents && render_pass->damage_rect.IsEmpty() &&
+      render_pass->copy_requests.empty()) {
+    TRACE_EVENT_INSTANT0("cc",
+                         "DirectRenderer::ReusedRenderPassContents",
+                         TRACE_EVENT_SCOPE_THREAD);
+    return;
+  }
+
+  DidChangeRenderPassContents(render_pass->id);
+  if (cache_contents)
+    complete_render_passes_.erase(render_pass->id);
   if (!UseRenderPass(frame, render_pass))
     return;
 
   bool using_scissor_as_optimization =
-      Capabilities().using_partial_swap && allow_partial_swap;
+      cache_contents
+          ? has_complete_contents
+          : Capabilities().using_partial_swap && allow_partial_swap;
   gfx::RectF render_pass_scissor;
   bool draw_rect_covers_full_surface = true;
   if (frame->current_render_pass == frame->root_render_pass &&
@@ -347,7 +372,12 @@ void DirectRenderer::DrawRenderPass(DrawingFrame* frame,
     draw_rect_covers_full_surface = false;
 
   if (using_scissor_as_optimization) {
-    render_pass_scissor = ComputeScissorRectForRenderPass(frame);
+    if (cache_contents) {
+      render_pass_scissor = gfx::IntersectRects(render_pass->damage_rect,
+                                                render_pass->output_rect);
+    } else {
+      render_pass_scissor = ComputeScissorRectForRenderPass(frame);
+    }
     SetScissorTestRectInDrawSpace(frame, render_pass_scissor);
     if (!render_pass_scissor.Contains(frame->current_render_pass->output_rect))
       draw_rect_covers_full_surface = false;
@@ -388,6 +418,20 @@ void DirectRenderer::DrawRenderPass(DrawingFrame* frame,
       DoDrawQuad(frame, *it);
   }
   FinishDrawingQuadList();
+
+  if (cache_contents)
+    complete_render_passes_[render_pass->id] = render_pass->output_rect;
+}
+
+bool DirectRenderer::HasCompleteRenderPassContents(
+    const RenderPass* render_pass) const {
+  const ScopedResource* texture = render_pass_textures_.get(render_pass->id);
+  if (!texture || !texture->id())
+    return false;
+  base::hash_map<RenderPass::Id, gfx::Rect>::const_iterator it =
+      complete_render_passes_.find(render_pass->id);
+  return it != complete_render_passes_.end() &&
+         it->second == render_pass->output_rect;
 }
 
 bool DirectRenderer::UseRenderPass(DrawingFrame* frame,
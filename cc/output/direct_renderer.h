@@ -7,6 +7,7 @@
 
 #include "base/basictypes.h"
 #include "base/callback.h"
+#include "base/containers/hash_tables.h"
 #include "base/containers/scoped_ptr_hash_map.h"
 #include "cc/base/cc_export.h"
 #include "cc/output/renderer.h"
@@ -118,6 +119,8 @@ class CC_EXPORT DirectRenderer : public Renderer {
   virtual void EnsureScissorTestDisabled() = 0;
   virtual void DiscardBackbuffer() {}
   virtual void EnsureBackbuffer() {}
+  // Called before the texture of a render pass is drawn into or dropped.
+  virtual void DidChangeRenderPassContents(RenderPass::Id id) {}
 
   virtual void CopyCurrentRenderPassToBitmap(
       DrawingFrame* frame,
@@ -137,8 +140,16 @@ class CC_EXPORT DirectRenderer : public Renderer {
   gfx::Size current_surface_size_;
 
  private:
+  // Returns true if the texture of |render_pass| holds all of the contents it
+  // was last drawn with, for the same output rect.
+  bool HasCompleteRenderPassContents(const RenderPass* render_pass) const;
+
   gfx::Vector2d enlarge_pass_texture_amount_;
 
+  // The output rects of the render passes whose textures hold all of their
+  // contents, when settings_->cache_render_pass_contents is set.
+  base::hash_map<RenderPass::Id, gfx::Rect> complete_render_passes_;
+
   internal::NamespaceToken on_demand_task_namespace_;
 
   DISALLOW_COPY_AND_ASSIGN(DirectRenderer);
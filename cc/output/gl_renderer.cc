@@ -12,6 +12,7 @@
 
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
@@ -175,6 +176,13 @@ struct GLRenderer::PendingAsyncReadPixels {
   DISALLOW_COPY_AND_ASSIGN(PendingAsyncReadPixels);
 };
 
+struct GLRenderer::FilteredRenderPassContents {
+  FilterOperations filters;
+  gfx::Point origin;
+  scoped_refptr<ContextProvider> offscreen_context_provider;
+  SkBitmap bitmap;
+};
+
 scoped_ptr<GLRenderer> GLRenderer::Create(
     RendererClient* client,
     const LayerTreeSettings* settings,
@@ -210,6 +218,7 @@ GLRenderer::GLRenderer(RendererClient* client,
       blend_shadow_(false),
       highp_threshold_min_(highp_threshold_min),
       highp_threshold_cache_(0),
+      draw_calls_in_frame_(0),
       on_demand_tile_raster_resource_id_(0) {
   DCHECK(gl_);
   DCHECK(context_support_);
@@ -293,7 +302,14 @@ void GLRenderer::SendManagedMemoryStats(size_t bytes_visible,
   context_support_->SendManagedMemoryStats(stats);
 }
 
-void GLRenderer::ReleaseRenderPassTextures() { render_pass_textures_.clear(); }
+void GLRenderer::ReleaseRenderPassTextures() {
+  filtered_render_pass_contents_.clear();
+  render_pass_textures_.clear();
+}
+
+void GLRenderer::DidChangeRenderPassContents(RenderPass::Id id) {
+  filtered_render_pass_contents_.erase(id);
+}
 
 void GLRenderer::DiscardPixels(bool has_external_stencil_test,
                                bool draw_rect_covers_full_surface) {
@@ -338,6 +354,7 @@ void GLRenderer::ClearFramebuffer(DrawingFrame* frame,
 }
 
 void GLRenderer::BeginDrawingFrame(DrawingFrame* frame) {
+  draw_calls_in_frame_ = 0;
   if (frame->device_viewport_rect.IsEmpty())
     return;
 
@@ -357,6 +374,8 @@ void GLRenderer::DoDrawQuad(DrawingFrame* frame, const DrawQuad* quad) {
   if (quad->material != DrawQuad::TEXTURE_CONTENT) {
     FlushTextureQuadCache();
   }
+  if (quad->material != DrawQuad::SOLID_COLOR)
+    FlushSolidColorQuadCache();
 
   switch (quad->material) {
     case DrawQuad::INVALID:
@@ -480,6 +499,7 @@ void GLRenderer::DrawDebugBorderQuad(const DrawingFrame* frame,
   // The indices for the line are stored in the same array as the triangle
   // indices.
   GLC(gl_, gl_->DrawElements(GL_LINE_LOOP, 4, GL_UNSIGNED_SHORT, 0));
+  ++draw_calls_in_frame_;
 }
 
 static SkBitmap ApplyImageFilter(GLRenderer* renderer,
@@ -870,8 +890,7 @@ void GLRenderer::DrawRenderPassQuad(DrawingFrame* frame,
       SetBlendEnabled(true);
   }
 
-  // TODO(senorblanco): Cache this value so that we don't have to do it for both
-  // the surface and its replica.  Apply filters to the contents texture.
+  // Apply filters to the contents texture.
   SkBitmap filter_bitmap;
   SkScalar color_matrix[20];
   bool use_color_matrix = false;
@@ -894,11 +913,29 @@ void GLRenderer::DrawRenderPassQuad(DrawingFrame* frame,
         // in the compositor.
         use_color_matrix = true;
       } else {
-        filter_bitmap = ApplyImageFilter(this,
-                                         frame->offscreen_context_provider,
-                                         quad->rect.origin(),
-                                         filter.get(),
-                                         contents_texture);
+        FilteredRenderPassContents* filtered =
+            filtered_render_pass_contents_.get(quad->render_pass_id);
+        if (!filtered || filtered->filters != quad->filters ||
+            filtered->origin != quad->rect.origin() ||
+            filtered->offscreen_context_provider.get() !=
+                frame->offscreen_context_provider) {
+          scoped_ptr<FilteredRenderPassContents> new_filtered(
+              new FilteredRenderPassContents);
+          new_filtered->filters = quad->filters;
+          new_filtered->origin = quad->rect.origin();
+          new_filtered->offscreen_context_provider =
+              frame->offscreen_context_provider;
+          new_filtered->bitmap =
+              ApplyImageFilter(this,
+                               frame->offscreen_context_provider,
+                               quad->rect.origin(),
+                               filter.get(),
+                               contents_texture);
+          filtered = new_filtered.get();
+          filtered_render_pass_contents_.set(quad->render_pass_id,
+                                             new_filtered.Pass());
+        }
+        filter_bitmap = filtered->bitmap;
       }
     }
   }
@@ -1351,6 +1388,17 @@ void GLRenderer::DrawSolidColorQuad(const DrawingFrame* frame,
       settings_->allow_antialiasing && !quad->force_anti_aliasing_off &&
       SetupQuadForAntialiasing(device_transform, quad, &local_quad, edge);
 
+  if (!use_aa) {
+    Float4 premultiplied_color = {
+        {(SkColorGetR(color) * (1.0f / 255.0f)) * alpha,
+         (SkColorGetG(color) * (1.0f / 255.0f)) * alpha,
+         (SkColorGetB(color) * (1.0f / 255.0f)) * alpha,
+         alpha}};
+    EnqueueSolidColorQuad(frame, quad, premultiplied_color);
+    return;
+  }
+  FlushSolidColorQuadCache();
+
   SolidColorProgramUniforms uniforms;
   if (use_aa)
     SolidColorUniformLocation(GetSolidColorProgramAA(), &uniforms);
@@ -1871,6 +1919,7 @@ void GLRenderer::FlushTextureQuadCache() {
                         6 * draw_cache_.matrix_data.size(),
                         GL_UNSIGNED_SHORT,
                         0));
+  ++draw_calls_in_frame_;
 
   // Clear the cache.
   draw_cache_.program_id = 0;
@@ -1944,6 +1993,73 @@ void GLRenderer::EnqueueTextureQuad(const DrawingFrame* frame,
   draw_cache_.matrix_data.push_back(m);
 }
 
+void GLRenderer::FlushSolidColorQuadCache() {
+  if (solid_color_draw_cache_.color_data.empty())
+    return;
+
+  SetBlendEnabled(solid_color_draw_cache_.needs_blending);
+  SetUseProgram(solid_color_draw_cache_.program_id);
+
+  GLC(gl_,
+      gl_->UniformMatrix4fv(
+          solid_color_draw_cache_.matrix_location,
+          static_cast<int>(solid_color_draw_cache_.matrix_data.size()),
+          false,
+          reinterpret_cast<float*>(
+              &solid_color_draw_cache_.matrix_data.front())));
+  GLC(gl_,
+      gl_->Uniform4fv(
+          solid_color_draw_cache_.color_location,
+          static_cast<int>(solid_color_draw_cache_.color_data.size()),
+          reinterpret_cast<float*>(
+              &solid_color_draw_cache_.color_data.front())));
+
+  GLC(gl_,
+      gl_->DrawElements(GL_TRIANGLES,
+                        6 * solid_color_draw_cache_.color_data.size(),
+                        GL_UNSIGNED_SHORT,
+                        0));
+  ++draw_calls_in_frame_;
+
+  solid_color_draw_cache_.matrix_data.resize(0);
+  solid_color_draw_cache_.color_data.resize(0);
+}
+
+void GLRenderer::EnqueueSolidColorQuad(const DrawingFrame* frame,
+                                       const SolidColorDrawQuad* quad,
+                                       const Float4& color) {
+  if (solid_color_draw_cache_.needs_blending !=
+          quad->ShouldDrawWithBlending() ||
+      solid_color_draw_cache_.color_data.size() >= 8) {
+    FlushSolidColorQuadCache();
+  }
+  if (solid_color_draw_cache_.color_data.empty()) {
+    const SolidColorBatchProgram* program = GetSolidColorBatchProgram();
+    solid_color_draw_cache_.needs_blending = quad->ShouldDrawWithBlending();
+    solid_color_draw_cache_.program_id = program->program();
+    solid_color_draw_cache_.matrix_location =
+        program->vertex_shader().matrix_location();
+    solid_color_draw_cache_.color_location =
+        program->vertex_shader().color_location();
+  }
+
+  solid_color_draw_cache_.color_data.push_back(color);
+
+  gfx::Transform quad_rect_matrix;
+  QuadRectTransform(
+      &quad_rect_matrix, quad->quadTransform(), quad->visible_rect);
+  quad_rect_matrix = frame->projection_matrix * quad_rect_matrix;
+
+  Float16 m;
+  quad_rect_matrix.matrix().asColMajorf(m.data);
+  solid_color_draw_cache_.matrix_data.push_back(m);
+}
+
+void GLRenderer::FlushDrawCaches() {
+  FlushTextureQuadCache();
+  FlushSolidColorQuadCache();
+}
+
 void GLRenderer::DrawIOSurfaceQuad(const DrawingFrame* frame,
                                    const IOSurfaceDrawQuad* quad) {
   SetBlendEnabled(quad->ShouldDrawWithBlending());
@@ -1991,6 +2107,10 @@ void GLRenderer::DrawIOSurfaceQuad(const DrawingFrame* frame,
 }
 
 void GLRenderer::FinishDrawingFrame(DrawingFrame* frame) {
+  UMA_HISTOGRAM_COUNTS_10000("Renderer4.GLDrawCallsPerFrame",
+                             draw_calls_in_frame_);
+  TRACE_COUNTER1("cc", "DrawCallsPerFrame", draw_calls_in_frame_);
+
   current_framebuffer_lock_.reset();
   swap_buffer_rect_.Union(gfx::ToEnclosingRect(frame->root_damage_rect));
 
@@ -1998,7 +2118,7 @@ void GLRenderer::FinishDrawingFrame(DrawingFrame* frame) {
   blend_shadow_ = false;
 }
 
-void GLRenderer::FinishDrawingQuadList() { FlushTextureQuadCache(); }
+void GLRenderer::FinishDrawingQuadList() { FlushDrawCaches(); }
 
 bool GLRenderer::FlippedFramebuffer() const { return true; }
 
@@ -2006,7 +2126,7 @@ void GLRenderer::EnsureScissorTestEnabled() {
   if (is_scissor_enabled_)
     return;
 
-  FlushTextureQuadCache();
+  FlushDrawCaches();
   GLC(gl_, gl_->Enable(GL_SCISSOR_TEST));
   is_scissor_enabled_ = true;
 }
@@ -2015,7 +2135,7 @@ void GLRenderer::EnsureScissorTestDisabled() {
   if (!is_scissor_enabled_)
     return;
 
-  FlushTextureQuadCache();
+  FlushDrawCaches();
   GLC(gl_, gl_->Disable(GL_SCISSOR_TEST));
   is_scissor_enabled_ = false;
 }
@@ -2094,6 +2214,7 @@ void GLRenderer::DrawQuadGeometry(const DrawingFrame* frame,
   GLC(gl_, gl_->UniformMatrix4fv(matrix_location, 1, false, &gl_matrix[0]));
 
   GLC(gl_, gl_->DrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, 0));
+  ++draw_calls_in_frame_;
 }
 
 void GLRenderer::CopyTextureToFramebuffer(const DrawingFrame* frame,
@@ -2580,7 +2701,7 @@ void GLRenderer::SetScissorTestRect(const gfx::Rect& scissor_rect) {
     return;
 
   scissor_rect_ = scissor_rect;
-  FlushTextureQuadCache();
+  FlushDrawCaches();
   GLC(gl_,
       gl_->Scissor(scissor_rect.x(),
                    scissor_rect.y(),
@@ -2650,6 +2771,17 @@ const GLRenderer::SolidColorProgramAA* GLRenderer::GetSolidColorProgramAA() {
   return &solid_color_program_aa_;
 }
 
+const GLRenderer::SolidColorBatchProgram*
+GLRenderer::GetSolidColorBatchProgram() {
+  if (!solid_color_batch_program_.initialized()) {
+    TRACE_EVENT0("cc", "GLRenderer::solidColorBatchProgram::initialize");
+    solid_color_batch_program_.Initialize(output_surface_->context_provider(),
+                                          TexCoordPrecisionNA,
+                                          SamplerTypeNA);
+  }
+  return &solid_color_batch_program_;
+}
+
 const GLRenderer::RenderPassProgram* GLRenderer::GetRenderPassProgram(
     TexCoordPrecision precision) {
   DCHECK_GE(precision, 0);
@@ -3008,6 +3140,7 @@ void GLRenderer::CleanupSharedObjects() {
   debug_border_program_.Cleanup(gl_);
   solid_color_program_.Cleanup(gl_);
   solid_color_program_aa_.Cleanup(gl_);
+  solid_color_batch_program_.Cleanup(gl_);
 
   if (offscreen_framebuffer_id_)
     GLC(gl_, gl_->DeleteFramebuffers(1, &offscreen_framebuffer_id_));
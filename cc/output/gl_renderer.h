@@ -6,6 +6,7 @@
 #define CC_OUTPUT_GL_RENDERER_H_
 
 #include "base/cancelable_callback.h"
+#include "base/containers/scoped_ptr_hash_map.h"
 #include "cc/base/cc_export.h"
 #include "cc/base/scoped_ptr_vector.h"
 #include "cc/output/direct_renderer.h"
@@ -162,6 +163,11 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   void EnqueueTextureQuad(const DrawingFrame* frame,
                           const TextureDrawQuad* quad);
   void FlushTextureQuadCache();
+  void EnqueueSolidColorQuad(const DrawingFrame* frame,
+                             const SolidColorDrawQuad* quad,
+                             const Float4& color);
+  void FlushSolidColorQuadCache();
+  void FlushDrawCaches();
   void DrawIOSurfaceQuad(const DrawingFrame* frame,
                          const IOSurfaceDrawQuad* quad);
   void DrawTileQuad(const DrawingFrame* frame, const TileDrawQuad* quad);
@@ -218,6 +224,7 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
 
   virtual void DiscardBackbuffer() OVERRIDE;
   virtual void EnsureBackbuffer() OVERRIDE;
+  virtual void DidChangeRenderPassContents(RenderPass::Id id) OVERRIDE;
   void EnforceMemoryPolicy();
 
   RendererCapabilitiesImpl capabilities_;
@@ -298,6 +305,8 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
       SolidColorProgram;
   typedef ProgramBinding<VertexShaderQuadAA, FragmentShaderColorAA>
       SolidColorProgramAA;
+  typedef ProgramBinding<VertexShaderPosColor, FragmentShaderVaryingColor>
+      SolidColorBatchProgram;
 
   const TileProgram* GetTileProgram(
       TexCoordPrecision precision, SamplerType sampler);
@@ -352,6 +361,7 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   const DebugBorderProgram* GetDebugBorderProgram();
   const SolidColorProgram* GetSolidColorProgram();
   const SolidColorProgramAA* GetSolidColorProgramAA();
+  const SolidColorBatchProgram* GetSolidColorBatchProgram();
 
   TileProgram tile_program_[NumTexCoordPrecisions][NumSamplerTypes];
   TileProgramOpaque
@@ -395,6 +405,7 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   DebugBorderProgram debug_border_program_;
   SolidColorProgram solid_color_program_;
   SolidColorProgramAA solid_color_program_aa_;
+  SolidColorBatchProgram solid_color_batch_program_;
 
   gpu::gles2::GLES2Interface* gl_;
   gpu::ContextSupport* context_support_;
@@ -416,12 +427,22 @@ class CC_EXPORT GLRenderer : public DirectRenderer {
   bool blend_shadow_;
   unsigned program_shadow_;
   TexturedQuadDrawCache draw_cache_;
+  SolidColorQuadDrawCache solid_color_draw_cache_;
+  // The number of draw calls made since the frame began.
+  int draw_calls_in_frame_;
   int highp_threshold_min_;
   int highp_threshold_cache_;
 
   struct PendingAsyncReadPixels;
   ScopedPtrVector<PendingAsyncReadPixels> pending_async_read_pixels_;
 
+  // The render pass contents with image filters applied, kept until the
+  // contents change so that a surface and its replica, and the frames after
+  // it, filter them only once.
+  struct FilteredRenderPassContents;
+  base::ScopedPtrHashMap<RenderPass::Id, FilteredRenderPassContents>
+      filtered_render_pass_contents_;
+
   scoped_ptr<ResourceProvider::ScopedWriteLockGL> current_framebuffer_lock_;
 
   scoped_refptr<ResourceProvider::Fence> last_swap_fence_;
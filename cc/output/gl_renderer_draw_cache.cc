@@ -11,4 +11,12 @@ TexturedQuadDrawCache::TexturedQuadDrawCache()
 
 TexturedQuadDrawCache::~TexturedQuadDrawCache() {}
 
+SolidColorQuadDrawCache::SolidColorQuadDrawCache()
+    : needs_blending(false),
+      program_id(0),
+      matrix_location(-1),
+      color_location(-1) {}
+
+SolidColorQuadDrawCache::~SolidColorQuadDrawCache() {}
+
 }  // namespace cc
@@ -65,6 +65,7 @@ class GLRendererShaderPixelTest : public GLRendererPixelTest {
     EXPECT_PROGRAM_VALID(renderer()->GetDebugBorderProgram());
     EXPECT_PROGRAM_VALID(renderer()->GetSolidColorProgram());
     EXPECT_PROGRAM_VALID(renderer()->GetSolidColorProgramAA());
+    EXPECT_PROGRAM_VALID(renderer()->GetSolidColorBatchProgram());
     TestShadersWithTexCoordPrecision(TexCoordPrecisionMedium);
     TestShadersWithTexCoordPrecision(TexCoordPrecisionHigh);
     ASSERT_FALSE(renderer()->IsContextLost());
@@ -952,6 +953,121 @@ TEST_F(GLRendererTest, ShouldClearRootRenderPass) {
   Mock::VerifyAndClearExpectations(&mock_context);
 }
 
+class DrawCountingContext : public TestWebGraphicsContext3D {
+ public:
+  DrawCountingContext() : draw_count_(0) {}
+
+  virtual void drawElements(GLenum mode,
+                            GLsizei count,
+                            GLenum type,
+                            GLintptr offset) OVERRIDE {
+    ++draw_count_;
+  }
+
+  int draw_count() const { return draw_count_; }
+
+ private:
+  int draw_count_;
+};
+
+TEST_F(GLRendererTest, CachedRenderPassContents) {
+  scoped_ptr<DrawCountingContext> context_owned(new DrawCountingContext);
+  DrawCountingContext* context = context_owned.get();
+
+  FakeOutputSurfaceClient output_surface_client;
+  scoped_ptr<OutputSurface> output_surface(FakeOutputSurface::Create3d(
+      context_owned.PassAs<TestWebGraphicsContext3D>()));
+  CHECK(output_surface->BindToClient(&output_surface_client));
+
+  scoped_ptr<ResourceProvider> resource_provider(
+      ResourceProvider::Create(output_surface.get(), NULL, 0, false, 1));
+
+  LayerTreeSettings settings;
+  settings.cache_render_pass_contents = true;
+
+  FakeRendererClient renderer_client;
+  FakeRendererGL renderer(&renderer_client,
+                          &settings,
+                          output_surface.get(),
+                          resource_provider.get());
+
+  gfx::Rect viewport_rect(10, 10);
+  RenderPass::Id root_pass_id(1, 0);
+  RenderPass::Id child_pass_id(2, 0);
+
+  // The child pass is damaged everywhere, then nowhere, then in part.
+  gfx::RectF child_damage[] = {
+      gfx::RectF(10, 10), gfx::RectF(), gfx::RectF(5, 5)};
+  // The root pass draws the child pass's quad each frame, and the child pass
+  // draws its own quad whenever it is damaged.
+  int expected_draws[] = {2, 1, 2};
+  for (size_t i = 0; i < arraysize(expected_draws); ++i) {
+    TestRenderPass* child_pass = AddRenderPass(&render_passes_in_draw_order_,
+                                               child_pass_id,
+                                               viewport_rect,
+                                               gfx::Transform());
+    child_pass->damage_rect = child_damage[i];
+    AddQuad(child_pass, viewport_rect, SK_ColorBLUE);
+
+    TestRenderPass* root_pass = AddRenderPass(&render_passes_in_draw_order_,
+                                              root_pass_id,
+                                              viewport_rect,
+                                              gfx::Transform());
+    AddRenderPassQuad(root_pass, child_pass);
+
+    int draws_before = context->draw_count();
+    renderer.DecideRenderPassAllocationsForFrame(render_passes_in_draw_order_);
+    renderer.DrawFrame(&render_passes_in_draw_order_,
+                       NULL,
+                       1.f,
+                       viewport_rect,
+                       viewport_rect,
+                       true,
+                       false);
+    EXPECT_EQ(expected_draws[i], context->draw_count() - draws_before) << i;
+  }
+}
+
+TEST_F(GLRendererTest, SolidColorQuadsAreBatched) {
+  scoped_ptr<DrawCountingContext> context_owned(new DrawCountingContext);
+  DrawCountingContext* context = context_owned.get();
+
+  FakeOutputSurfaceClient output_surface_client;
+  scoped_ptr<OutputSurface> output_surface(FakeOutputSurface::Create3d(
+      context_owned.PassAs<TestWebGraphicsContext3D>()));
+  CHECK(output_surface->BindToClient(&output_surface_client));
+
+  scoped_ptr<ResourceProvider> resource_provider(
+      ResourceProvider::Create(output_surface.get(), NULL, 0, false, 1));
+
+  LayerTreeSettings settings;
+  FakeRendererClient renderer_client;
+  FakeRendererGL renderer(&renderer_client,
+                          &settings,
+                          output_surface.get(),
+                          resource_provider.get());
+
+  gfx::Rect viewport_rect(20, 20);
+  RenderPass::Id root_pass_id(1, 0);
+  TestRenderPass* root_pass = AddRenderPass(&render_passes_in_draw_order_,
+                                            root_pass_id,
+                                            viewport_rect,
+                                            gfx::Transform());
+  AddQuad(root_pass, gfx::Rect(0, 0, 10, 10), SK_ColorRED);
+  AddQuad(root_pass, gfx::Rect(10, 0, 10, 10), SK_ColorGREEN);
+  AddQuad(root_pass, gfx::Rect(0, 10, 10, 10), SK_ColorBLUE);
+
+  renderer.DecideRenderPassAllocationsForFrame(render_passes_in_draw_order_);
+  renderer.DrawFrame(&render_passes_in_draw_order_,
+                     NULL,
+                     1.f,
+                     viewport_rect,
+                     viewport_rect,
+                     true,
+                     false);
+  EXPECT_EQ(1, context->draw_count());
+}
+
 class ScissorTestOnClearCheckingContext : public TestWebGraphicsContext3D {
  public:
   ScissorTestOnClearCheckingContext() : scissor_enabled_(false) {}
@@ -299,6 +299,44 @@ std::string VertexShaderPosTexTransform::GetShaderString() const {
   );  // NOLINT(whitespace/parens)
 }
 
+VertexShaderPosColor::VertexShaderPosColor()
+    : matrix_location_(-1),
+      color_location_(-1) {}
+
+void VertexShaderPosColor::Init(GLES2Interface* context,
+                                unsigned program,
+                                int* base_uniform_index) {
+  static const char* uniforms[] = {
+    "matrix",
+    "color",
+  };
+  int locations[arraysize(uniforms)];
+
+  GetProgramUniformLocations(context,
+                             program,
+                             arraysize(uniforms),
+                             uniforms,
+                             locations,
+                             base_uniform_index);
+  matrix_location_ = locations[0];
+  color_location_ = locations[1];
+}
+
+std::string VertexShaderPosColor::GetShaderString() const {
+  return VERTEX_SHADER(
+    attribute vec4 a_position;
+    attribute float a_index;
+    uniform mat4 matrix[8];
+    uniform vec4 color[8];
+    varying vec4 v_color;
+    void main() {
+      int quad_index = int(a_index * 0.25);  // NOLINT
+      gl_Position = matrix[quad_index] * a_position;
+      v_color = color[quad_index];
+    }
+  );  // NOLINT(whitespace/parens)
+}
+
 std::string VertexShaderPosTexIdentity::GetShaderString() const {
   return VERTEX_SHADER(
     attribute vec4 a_position;
@@ -1483,6 +1521,17 @@ std::string FragmentShaderColorAA::GetShaderString(
   );  // NOLINT(whitespace/parens)
 }
 
+std::string FragmentShaderVaryingColor::GetShaderString(
+    TexCoordPrecision precision, SamplerType sampler) const {
+  return FRAGMENT_SHADER(
+    precision mediump float;
+    varying vec4 v_color;
+    void main() {
+      gl_FragColor = v_color;
+    }
+  );  // NOLINT(whitespace/parens)
+}
+
 FragmentShaderCheckerboard::FragmentShaderCheckerboard()
     : alpha_location_(-1),
       tex_transform_location_(-1),
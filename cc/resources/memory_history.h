@@ -24,12 +24,20 @@ class MemoryHistory {
         : total_budget_in_bytes(0),
           bytes_allocated(0),
           bytes_unreleasable(0),
-          bytes_over(0) {}
+          bytes_over(0),
+          raster_cache_hit_count(0),
+          raster_cache_miss_count(0),
+          raster_cache_saved_pixel_count(0) {}
 
     size_t total_budget_in_bytes;
     size_t bytes_allocated;
     size_t bytes_unreleasable;
     size_t bytes_over;
+    // Totals since the tile manager was created. A hit is a tile that got the
+    // resource of an earlier tile with the same content instead of a raster.
+    int64 raster_cache_hit_count;
+    int64 raster_cache_miss_count;
+    int64 raster_cache_saved_pixel_count;
     size_t bytes_total() const {
       return bytes_allocated + bytes_unreleasable + bytes_over;
     }
@@ -8,8 +8,13 @@
 #include <limits>
 #include <set>
 
+#include "base/atomic_sequence_num.h"
 #include "base/base64.h"
+#include "base/containers/mru_cache.h"
 #include "base/debug/trace_event.h"
+#include "base/sha1.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/lock.h"
 #include "base/values.h"
 #include "cc/base/math_util.h"
 #include "cc/base/util.h"
@@ -32,6 +37,74 @@ namespace cc {
 
 namespace {
 
+base::StaticAtomicSequenceNumber g_next_picture_id;
+
+// Ganesh draws antialiased concave paths by rendering them in software, or
+// through the stencil buffer, at several times the cost of doing so on the
+// CPU. Past this many, a recording is left to the software rasterizer.
+const int kMaxAntialiasedConcavePathsForGpuRasterization = 5;
+
+// Number of distinct recordings kept around to share with later pictures.
+// Repeated content, such as the rows of a long list, is recorded close
+// together in time, so a small cache finds most of it.
+const size_t kMaxSharedRecordings = 256;
+
+// Recordings that later pictures with the same content can share the commands
+// of, keyed by a hash of the serialized recording. The cache holds clones that
+// are never played back, so that cloning them cannot race with a raster
+// thread playing back the picture they came from.
+class SharedRecordings {
+ public:
+  SharedRecordings() : recordings_(kMaxSharedRecordings) {}
+
+  // Returns a clone of the recording cached under |key|, or NULL after
+  // caching a clone of |picture| under it.
+  SkPicture* CloneOrAdd(const std::string& key, SkPicture* picture) {
+    base::AutoLock lock(lock_);
+    RecordingCache::iterator it = recordings_.Get(key);
+    if (it != recordings_.end())
+      return it->second->clone();
+    recordings_.Put(key, skia::AdoptRef(picture->clone()));
+    return NULL;
+  }
+
+ private:
+  typedef base::MRUCache<std::string, skia::RefPtr<SkPicture> > RecordingCache;
+
+  base::Lock lock_;
+  RecordingCache recordings_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedRecordings);
+};
+
+base::LazyInstance<SharedRecordings>::Leaky g_shared_recordings =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Replays a recording without drawing anything, and counts the operations
+// that rasterize poorly on the GPU.
+class GpuRasterizationAnalysisCanvas : public SkCanvas {
+ public:
+  explicit GpuRasterizationAnalysisCanvas(const SkBitmap& bitmap)
+      : SkCanvas(bitmap), num_antialiased_concave_paths_(0) {}
+
+  virtual void drawPath(const SkPath& path, const SkPaint& paint) OVERRIDE {
+    // Hairlines are drawn as lines whatever the shape of the path.
+    bool is_hairline = paint.getStyle() == SkPaint::kStroke_Style &&
+                       !paint.getStrokeWidth();
+    if (paint.isAntiAlias() && !is_hairline && !path.isConvex())
+      num_antialiased_concave_paths_++;
+  }
+
+  int num_antialiased_concave_paths() const {
+    return num_antialiased_concave_paths_;
+  }
+
+ private:
+  int num_antialiased_concave_paths_;
+
+  DISALLOW_COPY_AND_ASSIGN(GpuRasterizationAnalysisCanvas);
+};
+
 SkData* EncodeBitmap(size_t* offset, const SkBitmap& bm) {
   const int kJpegQuality = 80;
   std::vector<unsigned char> data;
@@ -63,6 +136,13 @@ SkData* EncodeBitmap(size_t* offset, const SkBitmap& bm) {
   return NULL;
 }
 
+// Decoded images are owned by the image cache rather than the recording, so
+// they are left out when measuring or comparing recordings.
+SkData* OmitBitmap(size_t* offset, const SkBitmap& bm) {
+  *offset = 0;
+  return SkData::NewEmpty();
+}
+
 bool DecodeBitmap(const void* buffer, size_t size, SkBitmap* bm) {
   const unsigned char* data = static_cast<const unsigned char *>(buffer);
 
@@ -86,10 +166,13 @@ scoped_refptr<Picture> Picture::Create(
     ContentLayerClient* client,
     const SkTileGridPicture::TileGridInfo& tile_grid_info,
     bool gather_pixel_refs,
-    int num_raster_threads) {
+    int num_raster_threads,
+    bool share_identical_recording) {
   scoped_refptr<Picture> picture = make_scoped_refptr(new Picture(layer_rect));
 
   picture->Record(client, tile_grid_info);
+  if (share_identical_recording)
+    picture->ShareIdenticalRecording(tile_grid_info);
   if (gather_pixel_refs)
     picture->GatherPixelRefs(tile_grid_info);
   picture->CloneForDrawing(num_raster_threads);
@@ -98,7 +181,10 @@ scoped_refptr<Picture> Picture::Create(
 }
 
 Picture::Picture(const gfx::Rect& layer_rect)
-  : layer_rect_(layer_rect),
+  : id_(g_next_picture_id.GetNext()),
+    layer_rect_(layer_rect),
+    recording_bytes_(0),
+    shares_recording_(false),
     cell_size_(layer_rect.size()) {
   // Instead of recording a trace event for object creation here, we wait for
   // the picture to be recorded in Picture::Record.
@@ -166,9 +252,12 @@ scoped_refptr<Picture> Picture::CreateFromValue(const base::Value* raw_value) {
 Picture::Picture(SkPicture* picture,
                  const gfx::Rect& layer_rect,
                  const gfx::Rect& opaque_rect) :
+    id_(g_next_picture_id.GetNext()),
     layer_rect_(layer_rect),
     opaque_rect_(opaque_rect),
     picture_(skia::AdoptRef(picture)),
+    recording_bytes_(0),
+    shares_recording_(false),
     cell_size_(layer_rect.size()) {
 }
 
@@ -176,9 +265,12 @@ Picture::Picture(const skia::RefPtr<SkPicture>& picture,
                  const gfx::Rect& layer_rect,
                  const gfx::Rect& opaque_rect,
                  const PixelRefMap& pixel_refs) :
+    id_(g_next_picture_id.GetNext()),
     layer_rect_(layer_rect),
     opaque_rect_(opaque_rect),
     picture_(picture),
+    recording_bytes_(0),
+    shares_recording_(false),
     pixel_refs_(pixel_refs),
     cell_size_(layer_rect.size()) {
 }
@@ -260,6 +352,37 @@ void Picture::Record(ContentLayerClient* painter,
   EmitTraceSnapshot();
 }
 
+void Picture::ShareIdenticalRecording(
+    const SkTileGridPicture::TileGridInfo& tile_grid_info) {
+  TRACE_EVENT0("cc", "Picture::ShareIdenticalRecording");
+  DCHECK(picture_);
+
+  SkDynamicMemoryWStream stream;
+  picture_->serialize(&stream, &OmitBitmap);
+  recording_bytes_ = stream.bytesWritten();
+  if (WillPlayBackBitmaps())
+    return;
+
+  std::string serialized(recording_bytes_, '\0');
+  if (recording_bytes_)
+    stream.copyTo(&serialized[0]);
+  // The tile grid is not serialized, but is shared by the clones.
+  std::string key = base::SHA1HashString(serialized) +
+      base::StringPrintf("%dx%d+%dx%d@%d,%d",
+                         tile_grid_info.fTileInterval.width(),
+                         tile_grid_info.fTileInterval.height(),
+                         tile_grid_info.fMargin.width(),
+                         tile_grid_info.fMargin.height(),
+                         tile_grid_info.fOffset.x(),
+                         tile_grid_info.fOffset.y());
+
+  SkPicture* shared = g_shared_recordings.Get().CloneOrAdd(key, picture_.get());
+  if (!shared)
+    return;
+  picture_ = skia::AdoptRef(shared);
+  shares_recording_ = true;
+}
+
 void Picture::GatherPixelRefs(
     const SkTileGridPicture::TileGridInfo& tile_grid_info) {
   TRACE_EVENT2("cc", "Picture::GatherPixelRefs",
@@ -347,6 +470,21 @@ int Picture::Raster(
   return bounds.width() * bounds.height();
 }
 
+bool Picture::IsSuitableForGpuRasterization() {
+  TRACE_EVENT0("cc", "Picture::IsSuitableForGpuRasterization");
+  DCHECK(picture_);
+
+  // The bitmap has no pixels; it only gives the canvas the clip that the
+  // recording's tile grid needs to play back every operation.
+  SkBitmap empty_bitmap;
+  empty_bitmap.setConfig(
+      SkBitmap::kNo_Config, layer_rect_.width(), layer_rect_.height());
+  GpuRasterizationAnalysisCanvas canvas(empty_bitmap);
+  picture_->draw(&canvas);
+  return canvas.num_antialiased_concave_paths() <=
+         kMaxAntialiasedConcavePathsForGpuRasterization;
+}
+
 void Picture::Replay(SkCanvas* canvas) {
   DCHECK(raster_thread_checker_.CalledOnValidThread());
   TRACE_EVENT_BEGIN0("cc", "Picture::Replay");
@@ -49,19 +49,36 @@ class CC_EXPORT Picture
       ContentLayerClient* client,
       const SkTileGridPicture::TileGridInfo& tile_grid_info,
       bool gather_pixels_refs,
-      int num_raster_threads);
+      int num_raster_threads,
+      bool share_identical_recording);
   static scoped_refptr<Picture> CreateFromValue(const base::Value* value);
   static scoped_refptr<Picture> CreateFromSkpValue(const base::Value* value);
 
   gfx::Rect LayerRect() const { return layer_rect_; }
   gfx::Rect OpaqueRect() const { return opaque_rect_; }
 
+  // Identifies this recording. Unlike the address of the picture, it is never
+  // reused by another picture, so it can key caches of raster output that
+  // outlive the picture.
+  int id() const { return id_; }
+
   // Get thread-safe clone for rasterizing with on a specific thread.
   Picture* GetCloneForDrawingOnThread(unsigned thread_index);
 
   // Has Record() been called yet?
   bool HasRecording() const { return picture_.get() != NULL; }
 
+  // Approximate size of the recording, without the images it draws. This is
+  // only measured for pictures created with |share_identical_recording|, and
+  // is 0 for those that share the recording of an earlier identical picture.
+  size_t ApproximateRecordingBytes() const {
+    return shares_recording_ ? 0 : recording_bytes_;
+  }
+
+  // True if the commands of the recording are shared with an earlier picture
+  // that recorded the same content.
+  bool shares_recording() const { return shares_recording_; }
+
   // Apply this scale and raster the negated region into the canvas. See comment
   // in PicturePileImpl::RasterCommon for explanation on negated content region.
   int Raster(SkCanvas* canvas,
@@ -73,6 +90,12 @@ class CC_EXPORT Picture
   // clip/scale/layer transformations.
   void Replay(SkCanvas* canvas);
 
+  // Returns false if the recording has content that Ganesh rasterizes much
+  // more slowly than the software rasterizer does. This replays the recording,
+  // so it is best called once, before the picture is shared with raster
+  // threads.
+  bool IsSuitableForGpuRasterization();
+
   scoped_ptr<base::Value> AsValue() const;
 
   class CC_EXPORT PixelRefIterator {
@@ -138,9 +161,19 @@ class CC_EXPORT Picture
   // Gather pixel refs from recording.
   void GatherPixelRefs(const SkTileGridPicture::TileGridInfo& tile_grid_info);
 
+  // Measures the recording and, if an earlier picture recorded the same
+  // content, replaces it with a clone of that recording, which shares its
+  // commands. Recordings that draw images are not shared, since their pixel
+  // refs are gathered per layer rect.
+  void ShareIdenticalRecording(
+      const SkTileGridPicture::TileGridInfo& tile_grid_info);
+
+  const int id_;
   gfx::Rect layer_rect_;
   gfx::Rect opaque_rect_;
   skia::RefPtr<SkPicture> picture_;
+  size_t recording_bytes_;
+  bool shares_recording_;
 
   typedef std::vector<scoped_refptr<Picture> > PictureVector;
   PictureVector clones_;
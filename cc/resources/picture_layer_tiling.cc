@@ -10,6 +10,7 @@
 
 #include "base/debug/trace_event.h"
 #include "cc/base/math_util.h"
+#include "cc/trees/occlusion_tracker.h"
 #include "ui/gfx/point_conversions.h"
 #include "ui/gfx/rect_conversions.h"
 #include "ui/gfx/safe_integer_conversions.h"
@@ -391,7 +392,11 @@ void PictureLayerTiling::UpdateTilePriorities(
     WhichTree tree,
     const gfx::Rect& visible_layer_rect,
     float layer_contents_scale,
-    double current_frame_time_in_seconds) {
+    double current_frame_time_in_seconds,
+    const OcclusionTrackerBase<LayerImpl, RenderSurfaceImpl>*
+        occlusion_tracker,
+    const LayerImpl* render_target,
+    const gfx::Transform& draw_transform) {
   if (!NeedsUpdateForFrameAtTime(current_frame_time_in_seconds)) {
     // This should never be zero for the purposes of has_ever_been_updated().
     DCHECK_NE(current_frame_time_in_seconds, 0.0);
@@ -431,7 +436,8 @@ void PictureLayerTiling::UpdateTilePriorities(
   last_visible_rect_in_content_space_ = visible_rect_in_content_space;
 
   // Assign now priority to all visible tiles.
-  TilePriority now_priority(resolution_, TilePriority::NOW, 0);
+  float content_to_layer_content_scale =
+      layer_contents_scale / contents_scale_;
   for (TilingData::Iterator iter(&tiling_data_, visible_rect_in_content_space);
        iter;
        ++iter) {
@@ -440,6 +446,19 @@ void PictureLayerTiling::UpdateTilePriorities(
       continue;
     Tile* tile = find->second.get();
 
+    TilePriority now_priority(resolution_, TilePriority::NOW, 0);
+    if (occlusion_tracker) {
+      gfx::Rect visible_tile_rect = gfx::ScaleToEnclosingRect(
+          gfx::IntersectRects(tile->content_rect(),
+                              visible_rect_in_content_space),
+          content_to_layer_content_scale);
+      bool impl_draw_transform_is_unknown = false;
+      now_priority.is_occluded =
+          occlusion_tracker->Occluded(render_target,
+                                      visible_tile_rect,
+                                      draw_transform,
+                                      impl_draw_transform_is_unknown);
+    }
     tile->SetPriority(tree, now_priority);
   }
 
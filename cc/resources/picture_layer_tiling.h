@@ -18,9 +18,16 @@
 #include "cc/resources/tile_priority.h"
 #include "ui/gfx/rect.h"
 
+namespace gfx {
+class Transform;
+}
+
 namespace cc {
 
+class LayerImpl;
 class PictureLayerTiling;
+class RenderSurfaceImpl;
+template <typename LayerType, typename SurfaceType> class OcclusionTrackerBase;
 
 class CC_EXPORT PictureLayerTilingClient {
  public:
@@ -136,10 +143,18 @@ class CC_EXPORT PictureLayerTiling {
 
   void Reset();
 
-  void UpdateTilePriorities(WhichTree tree,
-                            const gfx::Rect& visible_layer_rect,
-                            float layer_contents_scale,
-                            double current_frame_time_in_seconds);
+  // If |occlusion_tracker| is not null, visible tiles that it reports as
+  // occluded in the layer's content space are marked as such in their
+  // priority. |render_target| and |draw_transform| are the layer's.
+  void UpdateTilePriorities(
+      WhichTree tree,
+      const gfx::Rect& visible_layer_rect,
+      float layer_contents_scale,
+      double current_frame_time_in_seconds,
+      const OcclusionTrackerBase<LayerImpl, RenderSurfaceImpl>*
+          occlusion_tracker,
+      const LayerImpl* render_target,
+      const gfx::Transform& draw_transform);
 
   // Copies the src_tree priority into the dst_tree priority for all tiles.
   // The src_tree priority is reset to the lowest priority possible.  This
@@ -7,6 +7,7 @@
 
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/perf/perf_test.h"
+#include "ui/gfx/transform.h"
 
 namespace cc {
 
@@ -71,7 +72,10 @@ class PictureLayerTilingPerfTest : public testing::Test {
     gfx::Rect viewport_rect(0, 0, 1024, 768);
     do {
       picture_layer_tiling_->UpdateTilePriorities(
-          ACTIVE_TREE, viewport_rect, 1.f, num_runs_ + 1);
+          ACTIVE_TREE, viewport_rect, 1.f, num_runs_ + 1,
+          NULL,
+          NULL,
+          gfx::Transform());
     } while (DidRun());
 
     perf_test::PrintResult("update_tile_priorities_stationary",
@@ -97,7 +101,10 @@ class PictureLayerTilingPerfTest : public testing::Test {
     const int maxOffsetCount = 1000;
     do {
       picture_layer_tiling_->UpdateTilePriorities(
-          ACTIVE_TREE, viewport_rect, 1.f, num_runs_ + 1);
+          ACTIVE_TREE, viewport_rect, 1.f, num_runs_ + 1,
+          NULL,
+          NULL,
+          gfx::Transform());
 
       viewport_rect = gfx::Rect(viewport_rect.x() + xoffsets[offsetIndex],
                                 viewport_rect.y() + yoffsets[offsetIndex],
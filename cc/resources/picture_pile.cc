@@ -5,7 +5,11 @@
 #include "cc/resources/picture_pile.h"
 
 #include <algorithm>
+#include <functional>
 #include <limits>
+#include <map>
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "cc/base/region.h"
@@ -141,7 +145,10 @@ float ClusterTiles(const std::vector<gfx::Rect>& invalid_tiles,
 
 namespace cc {
 
-PicturePile::PicturePile() {
+PicturePile::PicturePile()
+    : analyze_for_gpu_rasterization_(false),
+      share_identical_recordings_(false),
+      max_recorded_bytes_(0) {
 }
 
 PicturePile::~PicturePile() {
@@ -236,7 +243,9 @@ bool PicturePile::Update(
                                   painter,
                                   tile_grid_info_,
                                   gather_pixel_refs,
-                                  num_raster_threads);
+                                  num_raster_threads,
+                                  share_identical_recordings_ ||
+                                      max_recorded_bytes_ > 0);
         base::TimeDelta duration =
             stats_instrumentation->EndRecording(start_time);
         best_duration = std::min(duration, best_duration);
@@ -246,6 +255,11 @@ bool PicturePile::Update(
       stats_instrumentation->AddRecord(best_duration, recorded_pixel_count);
     }
 
+    if (analyze_for_gpu_rasterization_ && is_suitable_for_gpu_rasterization_) {
+      is_suitable_for_gpu_rasterization_ =
+          picture->IsSuitableForGpuRasterization();
+    }
+
     for (TilingData::Iterator it(&tiling_, record_rect);
         it; ++it) {
       const PictureMapKey& key = it.index();
@@ -257,8 +271,70 @@ bool PicturePile::Update(
     }
   }
 
+  if (max_recorded_bytes_)
+    DropFarRecordings(interest_rect, visible_layer_rect);
+
   UpdateRecordedRegion();
   return true;
 }
 
+void PicturePile::DropFarRecordings(const gfx::Rect& interest_rect,
+                                    const gfx::Rect& visible_layer_rect) {
+  // A picture can span several cells. It is kept if any of them is in the
+  // interest rect, and is otherwise as far as its nearest cell.
+  std::set<Picture*> counted_pictures;
+  std::set<Picture*> interesting_pictures;
+  std::map<Picture*, int> far_pictures;
+  size_t recorded_bytes = 0;
+  for (PictureMap::iterator it = picture_map_.begin();
+       it != picture_map_.end();
+       ++it) {
+    Picture* picture = it->second.GetPicture();
+    if (!picture)
+      continue;
+    if (counted_pictures.insert(picture).second)
+      recorded_bytes += picture->ApproximateRecordingBytes();
+
+    const PictureMapKey& key = it->first;
+    if (tiling_.TileBounds(key.first, key.second).Intersects(interest_rect)) {
+      interesting_pictures.insert(picture);
+      continue;
+    }
+    int distance =
+        PaddedRect(key).ManhattanInternalDistance(visible_layer_rect);
+    std::map<Picture*, int>::iterator far_it = far_pictures.find(picture);
+    if (far_it == far_pictures.end())
+      far_pictures[picture] = distance;
+    else
+      far_it->second = std::min(far_it->second, distance);
+  }
+  if (recorded_bytes <= max_recorded_bytes_)
+    return;
+
+  std::vector<std::pair<int, Picture*> > drop_candidates;
+  for (std::map<Picture*, int>::iterator it = far_pictures.begin();
+       it != far_pictures.end();
+       ++it) {
+    if (!interesting_pictures.count(it->first))
+      drop_candidates.push_back(std::make_pair(it->second, it->first));
+  }
+  std::sort(drop_candidates.begin(),
+            drop_candidates.end(),
+            std::greater<std::pair<int, Picture*> >());
+
+  std::set<Picture*> dropped_pictures;
+  for (size_t i = 0; i < drop_candidates.size() &&
+                     recorded_bytes > max_recorded_bytes_; ++i) {
+    Picture* picture = drop_candidates[i].second;
+    recorded_bytes -= picture->ApproximateRecordingBytes();
+    dropped_pictures.insert(picture);
+  }
+  for (PictureMap::iterator it = picture_map_.begin();
+       it != picture_map_.end();
+       ++it) {
+    if (dropped_pictures.count(it->second.GetPicture()))
+      it->second.SetPicture(NULL);
+  }
+}
+
 }  // namespace cc
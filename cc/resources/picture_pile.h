@@ -37,12 +37,43 @@ class CC_EXPORT PicturePile : public PicturePileBase {
     show_debug_picture_borders_ = show;
   }
 
+  // When set, new recordings are checked for content that rasterizes poorly
+  // on the GPU, and the first one found makes the pile unsuitable for GPU
+  // rasterization for good, so that layers do not flip between rasterizers.
+  void set_analyze_for_gpu_rasterization(bool analyze) {
+    analyze_for_gpu_rasterization_ = analyze;
+  }
+
+  // When set, new recordings share the commands of earlier identical ones,
+  // from this or other piles. See Picture::ShareIdenticalRecording.
+  void set_share_identical_recordings(bool share) {
+    share_identical_recordings_ = share;
+  }
+
+  // When not 0, the recordings of cells outside the area that Update()
+  // records are dropped, farthest from the visible rect first, while the pile
+  // holds more than this many bytes of recordings. Dropped cells are recorded
+  // again when they come near the visible rect. Measuring recordings costs
+  // about as much as comparing them, so a budget also turns on sharing.
+  void set_max_recorded_bytes(size_t max_recorded_bytes) {
+    max_recorded_bytes_ = max_recorded_bytes;
+  }
+
  protected:
   virtual ~PicturePile();
 
  private:
   friend class PicturePileImpl;
 
+  // Drops recordings outside |interest_rect| to stay within
+  // |max_recorded_bytes_|.
+  void DropFarRecordings(const gfx::Rect& interest_rect,
+                         const gfx::Rect& visible_layer_rect);
+
+  bool analyze_for_gpu_rasterization_;
+  bool share_identical_recordings_;
+  size_t max_recorded_bytes_;
+
   DISALLOW_COPY_AND_ASSIGN(PicturePile);
 };
 
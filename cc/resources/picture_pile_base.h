@@ -48,6 +48,12 @@ class CC_EXPORT PicturePileBase : public base::RefCounted<PicturePileBase> {
   void SetTileGridSize(const gfx::Size& tile_grid_size);
   TilingData& tiling() { return tiling_; }
 
+  // False once any recording of the pile was found to rasterize poorly on the
+  // GPU. See Picture::IsSuitableForGpuRasterization.
+  bool is_suitable_for_gpu_rasterization() const {
+    return is_suitable_for_gpu_rasterization_;
+  }
+
   scoped_ptr<base::Value> AsValue() const;
 
  protected:
@@ -106,6 +112,7 @@ class CC_EXPORT PicturePileBase : public base::RefCounted<PicturePileBase> {
   bool contents_opaque_;
   bool show_debug_picture_borders_;
   bool clear_canvas_with_debug_color_;
+  bool is_suitable_for_gpu_rasterization_;
 
  private:
   void SetBufferPixels(int buffer_pixels);
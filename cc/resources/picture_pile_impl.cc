@@ -19,6 +19,15 @@
 
 namespace cc {
 
+namespace {
+
+template <typename T>
+void AppendToKey(const T& value, std::string* key) {
+  key->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+}  // namespace
+
 PicturePileImpl::ClonesForDrawing::ClonesForDrawing(
     const PicturePileImpl* pile, int num_threads) {
   for (int i = 0; i < num_threads; i++) {
@@ -343,6 +352,46 @@ void PicturePileImpl::AnalyzeInRect(
   analysis->has_text = canvas.HasText();
 }
 
+void PicturePileImpl::AppendContentKey(const gfx::Rect& content_rect,
+                                       float contents_scale,
+                                       std::string* key) const {
+  AppendToKey(content_rect.x(), key);
+  AppendToKey(content_rect.y(), key);
+  AppendToKey(content_rect.width(), key);
+  AppendToKey(content_rect.height(), key);
+  AppendToKey(contents_scale, key);
+
+  // These decide the background drawn past the edge of the layer, and which
+  // layer rect each entry of |picture_map_| covers.
+  AppendToKey(tiling_.total_size().width(), key);
+  AppendToKey(tiling_.total_size().height(), key);
+  AppendToKey(tiling_.max_texture_size().width(), key);
+  AppendToKey(tiling_.max_texture_size().height(), key);
+  AppendToKey(tiling_.border_texels(), key);
+  AppendToKey(background_color_, key);
+  AppendToKey(contents_opaque_, key);
+  AppendToKey(clear_canvas_with_debug_color_, key);
+  AppendToKey(show_debug_picture_borders_, key);
+
+  // Same walk as CoalesceRasters().
+  gfx::Rect layer_rect =
+      gfx::ScaleToEnclosingRect(content_rect, 1.f / contents_scale);
+  for (TilingData::Iterator tile_iter(&tiling_, layer_rect);
+       tile_iter; ++tile_iter) {
+    PictureMap::const_iterator map_iter =
+        picture_map_.find(tile_iter.index());
+    if (map_iter == picture_map_.end())
+      continue;
+    const Picture* picture = map_iter->second.GetPicture();
+    if (!picture)
+      continue;
+
+    AppendToKey(tile_iter.index_x(), key);
+    AppendToKey(tile_iter.index_y(), key);
+    AppendToKey(picture->id(), key);
+  }
+}
+
 PicturePileImpl::Analysis::Analysis()
     : is_solid_color(false),
       has_text(false) {
@@ -8,6 +8,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "base/time/time.h"
@@ -80,6 +81,14 @@ class CC_EXPORT PicturePileImpl : public PicturePileBase {
                      Analysis* analysis,
                      RenderingStatsInstrumentation* stats_instrumentation);
 
+  // Appends to |key| a description of everything rastering |content_rect| at
+  // |contents_scale| depends on: the recordings that cover the rect and the
+  // pile state that affects the output. Rastering the same rect of two piles
+  // that append the same key produces the same pixels.
+  void AppendContentKey(const gfx::Rect& content_rect,
+                        float contents_scale,
+                        std::string* key) const;
+
   class CC_EXPORT PixelRefIterator {
    public:
     PixelRefIterator(const gfx::Rect& content_rect,
@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <string>
+
 #include "base/memory/scoped_ptr.h"
 #include "cc/test/fake_picture_pile_impl.h"
 #include "cc/test/fake_rendering_stats_instrumentation.h"
@@ -147,6 +149,41 @@ TEST(PicturePileImplTest, AnalyzeIsSolidEmpty) {
   EXPECT_EQ(analysis.solid_color, SkColorSetARGB(0, 0, 0, 0));
 }
 
+TEST(PicturePileImplTest, ContentKeyFollowsRecordings) {
+  gfx::Size tile_size(100, 100);
+  gfx::Size layer_bounds(400, 400);
+  gfx::Rect content_rect(0, 0, 100, 100);
+
+  scoped_refptr<FakePicturePileImpl> pile =
+      FakePicturePileImpl::CreateFilledPile(tile_size, layer_bounds);
+
+  std::string key;
+  pile->AppendContentKey(content_rect, 1.f, &key);
+  std::string same_key;
+  pile->AppendContentKey(content_rect, 1.f, &same_key);
+  EXPECT_EQ(key, same_key);
+
+  // Recording a cell the rect does not touch leaves its key alone.
+  pile->AddRecordingAt(3, 3);
+  same_key.clear();
+  pile->AppendContentKey(content_rect, 1.f, &same_key);
+  EXPECT_EQ(key, same_key);
+
+  std::string other_scale_key;
+  pile->AppendContentKey(content_rect, 2.f, &other_scale_key);
+  EXPECT_NE(key, other_scale_key);
+
+  pile->AddRecordingAt(0, 0);
+  std::string rerecorded_key;
+  pile->AppendContentKey(content_rect, 1.f, &rerecorded_key);
+  EXPECT_NE(key, rerecorded_key);
+
+  pile->set_background_color(SK_ColorRED);
+  std::string background_key;
+  pile->AppendContentKey(content_rect, 1.f, &background_key);
+  EXPECT_NE(rerecorded_key, background_key);
+}
+
 TEST(PicturePileImplTest, PixelRefIteratorEmpty) {
   gfx::Size tile_size(128, 128);
   gfx::Size layer_bounds(256, 256);
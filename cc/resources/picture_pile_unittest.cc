@@ -299,5 +299,63 @@ TEST(PicturePileTest, StopRecordingOffscreenInvalidations) {
   }
 }
 
+TEST(PicturePileTest, DropFarRecordingsOverBudget) {
+  FakeContentLayerClient client;
+  FakeRenderingStatsInstrumentation stats_instrumentation;
+  scoped_refptr<TestPicturePile> pile = new TestPicturePile;
+  SkColor background_color = SK_ColorBLUE;
+
+  gfx::Size base_picture_size = pile->tiling().max_texture_size();
+  gfx::Size layer_size(base_picture_size.width(),
+                       base_picture_size.height() * 50);
+  pile->Resize(layer_size);
+  pile->SetTileGridSize(gfx::Size(1000, 1000));
+  pile->set_max_recorded_bytes(1);
+
+  // Record around the top of the layer.
+  gfx::Rect top_viewport(0, 0, layer_size.width(), 1);
+  pile->Update(&client,
+               background_color,
+               false,
+               gfx::Rect(layer_size),
+               top_viewport,
+               0,
+               &stats_instrumentation);
+  TestPicturePile::PictureInfo& top_picture_info =
+      pile->picture_map().find(TestPicturePile::PictureMapKey(0, 0))->second;
+  EXPECT_TRUE(top_picture_info.GetPicture());
+  EXPECT_TRUE(pile->recorded_region().Contains(top_viewport));
+
+  // Scroll to the bottom. The recordings around the top are now far enough
+  // to be dropped to make room.
+  int last_row = pile->tiling().num_tiles_y() - 1;
+  gfx::Rect bottom_viewport(
+      0, layer_size.height() - 1, layer_size.width(), 1);
+  pile->Update(&client,
+               background_color,
+               false,
+               gfx::Rect(),
+               bottom_viewport,
+               1,
+               &stats_instrumentation);
+  EXPECT_FALSE(top_picture_info.GetPicture());
+  EXPECT_FALSE(pile->recorded_region().Contains(top_viewport));
+  TestPicturePile::PictureInfo& bottom_picture_info = pile->picture_map().find(
+      TestPicturePile::PictureMapKey(0, last_row))->second;
+  EXPECT_TRUE(bottom_picture_info.GetPicture());
+  EXPECT_TRUE(pile->recorded_region().Contains(bottom_viewport));
+
+  // Scrolling back records the top again.
+  pile->Update(&client,
+               background_color,
+               false,
+               gfx::Rect(),
+               top_viewport,
+               2,
+               &stats_instrumentation);
+  EXPECT_TRUE(top_picture_info.GetPicture());
+  EXPECT_FALSE(bottom_picture_info.GetPicture());
+}
+
 }  // namespace
 }  // namespace cc
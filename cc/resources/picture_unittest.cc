@@ -13,6 +13,7 @@
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkDevice.h"
 #include "third_party/skia/include/core/SkGraphics.h"
+#include "third_party/skia/include/core/SkPath.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
 #include "third_party/skia/include/core/SkTileGridPicture.h"
 #include "ui/gfx/rect.h"
@@ -49,7 +50,7 @@ TEST(PictureTest, AsBase64String) {
   // Single full-size rect picture.
   content_layer_client.add_draw_rect(layer_rect, red_paint);
   scoped_refptr<Picture> one_rect_picture = Picture::Create(
-      layer_rect, &content_layer_client, tile_grid_info, false, 0);
+      layer_rect, &content_layer_client, tile_grid_info, false, 0, false);
   scoped_ptr<base::Value> serialized_one_rect(
       one_rect_picture->AsValue());
 
@@ -74,7 +75,7 @@ TEST(PictureTest, AsBase64String) {
   // Two rect picture.
   content_layer_client.add_draw_rect(gfx::Rect(25, 25, 50, 50), green_paint);
   scoped_refptr<Picture> two_rect_picture = Picture::Create(
-      layer_rect, &content_layer_client, tile_grid_info, false, 0);
+      layer_rect, &content_layer_client, tile_grid_info, false, 0, false);
 
   scoped_ptr<base::Value> serialized_two_rect(
       two_rect_picture->AsValue());
@@ -133,7 +134,7 @@ TEST(PictureTest, PixelRefIterator) {
   }
 
   scoped_refptr<Picture> picture = Picture::Create(
-      layer_rect, &content_layer_client, tile_grid_info, true, 0);
+      layer_rect, &content_layer_client, tile_grid_info, true, 0, false);
 
   // Default iterator does not have any pixel refs
   {
@@ -230,7 +231,7 @@ TEST(PictureTest, PixelRefIteratorNonZeroLayer) {
   }
 
   scoped_refptr<Picture> picture = Picture::Create(
-      layer_rect, &content_layer_client, tile_grid_info, true, 0);
+      layer_rect, &content_layer_client, tile_grid_info, true, 0, false);
 
   // Default iterator does not have any pixel refs
   {
@@ -350,7 +351,7 @@ TEST(PictureTest, PixelRefIteratorOnePixelQuery) {
   }
 
   scoped_refptr<Picture> picture = Picture::Create(
-      layer_rect, &content_layer_client, tile_grid_info, true, 0);
+      layer_rect, &content_layer_client, tile_grid_info, true, 0, false);
 
   for (int y = 0; y < 4; ++y) {
     for (int x = 0; x < 4; ++x) {
@@ -395,7 +396,7 @@ TEST(PictureTest, CreateFromSkpValue) {
   // Single full-size rect picture.
   content_layer_client.add_draw_rect(layer_rect, red_paint);
   scoped_refptr<Picture> one_rect_picture = Picture::Create(
-      layer_rect, &content_layer_client, tile_grid_info, false, 0);
+      layer_rect, &content_layer_client, tile_grid_info, false, 0, false);
   scoped_ptr<base::Value> serialized_one_rect(
       one_rect_picture->AsValue());
 
@@ -416,5 +417,123 @@ TEST(PictureTest, CreateFromSkpValue) {
   EXPECT_EQ(100, one_rect_picture_check->OpaqueRect().width());
   EXPECT_EQ(200, one_rect_picture_check->OpaqueRect().height());
 }
+
+class ConcavePathContentLayerClient : public FakeContentLayerClient {
+ public:
+  explicit ConcavePathContentLayerClient(int num_paths)
+      : num_paths_(num_paths) {}
+
+  virtual void PaintContents(SkCanvas* canvas,
+                             const gfx::Rect& rect,
+                             gfx::RectF* opaque_rect) OVERRIDE {
+    SkPath path;
+    path.moveTo(0, 0);
+    path.lineTo(50, 50);
+    path.lineTo(100, 0);
+    path.lineTo(50, 100);
+    path.close();
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < num_paths_; ++i)
+      canvas->drawPath(path, paint);
+  }
+
+ private:
+  int num_paths_;
+};
+
+TEST(PictureTest, IsSuitableForGpuRasterization) {
+  gfx::Rect layer_rect(100, 100);
+
+  SkTileGridPicture::TileGridInfo tile_grid_info;
+  tile_grid_info.fTileInterval = SkISize::Make(100, 100);
+  tile_grid_info.fMargin.setEmpty();
+  tile_grid_info.fOffset.setZero();
+
+  FakeContentLayerClient rect_client;
+  SkPaint paint;
+  rect_client.add_draw_rect(layer_rect, paint);
+  scoped_refptr<Picture> rect_picture = Picture::Create(
+      layer_rect, &rect_client, tile_grid_info, false, 0, false);
+  EXPECT_TRUE(rect_picture->IsSuitableForGpuRasterization());
+
+  ConcavePathContentLayerClient few_paths_client(1);
+  scoped_refptr<Picture> few_paths_picture = Picture::Create(
+      layer_rect, &few_paths_client, tile_grid_info, false, 0, false);
+  EXPECT_TRUE(few_paths_picture->IsSuitableForGpuRasterization());
+
+  ConcavePathContentLayerClient many_paths_client(100);
+  scoped_refptr<Picture> many_paths_picture = Picture::Create(
+      layer_rect, &many_paths_client, tile_grid_info, false, 0, false);
+  EXPECT_FALSE(many_paths_picture->IsSuitableForGpuRasterization());
+}
+
+TEST(PictureTest, IdenticalRecordingsAreShared) {
+  gfx::Rect layer_rect(100, 100);
+
+  SkTileGridPicture::TileGridInfo tile_grid_info;
+  tile_grid_info.fTileInterval = SkISize::Make(100, 100);
+  tile_grid_info.fMargin.setEmpty();
+  tile_grid_info.fOffset.setZero();
+
+  // Use a color no other test records with, since shared recordings outlive
+  // the pictures that made them.
+  SkPaint paint;
+  paint.setColor(SkColorSetARGB(255, 12, 34, 56));
+  FakeContentLayerClient client;
+  client.add_draw_rect(gfx::Rect(10, 10, 50, 50), paint);
+
+  scoped_refptr<Picture> first_picture = Picture::Create(
+      layer_rect, &client, tile_grid_info, false, 2, true);
+  EXPECT_FALSE(first_picture->shares_recording());
+  EXPECT_LT(0u, first_picture->ApproximateRecordingBytes());
+
+  scoped_refptr<Picture> second_picture = Picture::Create(
+      layer_rect, &client, tile_grid_info, false, 2, true);
+  EXPECT_TRUE(second_picture->shares_recording());
+  EXPECT_EQ(0u, second_picture->ApproximateRecordingBytes());
+
+  // Pictures that are not asked to share measure nothing.
+  scoped_refptr<Picture> unshared_picture = Picture::Create(
+      layer_rect, &client, tile_grid_info, false, 2, false);
+  EXPECT_FALSE(unshared_picture->shares_recording());
+  EXPECT_EQ(0u, unshared_picture->ApproximateRecordingBytes());
+
+  // Different content is not shared.
+  client.add_draw_rect(gfx::Rect(20, 20, 50, 50), paint);
+  scoped_refptr<Picture> other_picture = Picture::Create(
+      layer_rect, &client, tile_grid_info, false, 2, true);
+  EXPECT_FALSE(other_picture->shares_recording());
+
+  // The shared recording draws the same pixels, on every raster thread.
+  SkBitmap first_bitmap;
+  first_bitmap.setConfig(SkBitmap::kARGB_8888_Config,
+                         layer_rect.width(),
+                         layer_rect.height());
+  first_bitmap.allocPixels();
+  first_bitmap.eraseColor(SK_ColorTRANSPARENT);
+  SkCanvas first_canvas(first_bitmap);
+  first_picture->Replay(&first_canvas);
+
+  for (unsigned thread_index = 0; thread_index < 2; ++thread_index) {
+    SkBitmap second_bitmap;
+    second_bitmap.setConfig(SkBitmap::kARGB_8888_Config,
+                            layer_rect.width(),
+                            layer_rect.height());
+    second_bitmap.allocPixels();
+    second_bitmap.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas second_canvas(second_bitmap);
+    second_picture->GetCloneForDrawingOnThread(thread_index)->Replay(
+        &second_canvas);
+
+    SkAutoLockPixels first_lock(first_bitmap);
+    SkAutoLockPixels second_lock(second_bitmap);
+    EXPECT_EQ(0, memcmp(first_bitmap.getPixels(),
+                        second_bitmap.getPixels(),
+                        first_bitmap.getSize()))
+        << "thread " << thread_index;
+  }
+}
+
 }  // namespace
 }  // namespace cc
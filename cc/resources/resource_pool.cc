@@ -4,6 +4,8 @@
 
 #include "cc/resources/resource_pool.h"
 
+#include <algorithm>
+
 #include "cc/resources/resource_provider.h"
 #include "cc/resources/scoped_resource.h"
 
@@ -33,6 +35,7 @@ ResourcePool::~ResourcePool() {
   DCHECK_EQ(0u, memory_usage_bytes_);
   DCHECK_EQ(0u, unused_memory_usage_bytes_);
   DCHECK_EQ(0u, resource_count_);
+  DCHECK(content_keys_.empty());
 }
 
 scoped_ptr<ScopedResource> ResourcePool::AcquireResource(
@@ -46,6 +49,7 @@ scoped_ptr<ScopedResource> ResourcePool::AcquireResource(
     if (resource->size() != size)
       continue;
 
+    ForgetContent(resource);
     unused_resources_.erase(it);
     unused_memory_usage_bytes_ -= resource->bytes();
     return make_scoped_ptr(resource);
@@ -70,6 +74,44 @@ void ResourcePool::ReleaseResource(scoped_ptr<ScopedResource> resource) {
   busy_resources_.push_back(resource.release());
 }
 
+void ResourcePool::ReleaseResourceWithContent(
+    scoped_ptr<ScopedResource> resource,
+    const std::string& content_key) {
+  base::hash_map<std::string, ScopedResource*>::iterator it =
+      resources_by_content_.find(content_key);
+  if (it != resources_by_content_.end())
+    ForgetContent(it->second);
+
+  resources_by_content_[content_key] = resource.get();
+  content_keys_[resource.get()] = content_key;
+  ReleaseResource(resource.Pass());
+}
+
+scoped_ptr<ScopedResource> ResourcePool::AcquireResourceWithContent(
+    const std::string& content_key) {
+  base::hash_map<std::string, ScopedResource*>::iterator content_it =
+      resources_by_content_.find(content_key);
+  if (content_it == resources_by_content_.end())
+    return scoped_ptr<ScopedResource>();
+
+  ScopedResource* resource = content_it->second;
+  ForgetContent(resource);
+
+  ResourceList::iterator it =
+      std::find(unused_resources_.begin(), unused_resources_.end(), resource);
+  if (it != unused_resources_.end()) {
+    unused_resources_.erase(it);
+    unused_memory_usage_bytes_ -= resource->bytes();
+    return make_scoped_ptr(resource);
+  }
+
+  // Busy resources are still counted as acquired.
+  it = std::find(busy_resources_.begin(), busy_resources_.end(), resource);
+  DCHECK(it != busy_resources_.end());
+  busy_resources_.erase(it);
+  return make_scoped_ptr(resource);
+}
+
 void ResourcePool::SetResourceUsageLimits(size_t max_memory_usage_bytes,
                                           size_t max_unused_memory_usage_bytes,
                                           size_t max_resource_count) {
@@ -94,6 +136,7 @@ void ResourcePool::ReduceResourceUsage() {
     // memory is necessarily returned to the OS.
     ScopedResource* resource = unused_resources_.front();
     unused_resources_.pop_front();
+    ForgetContent(resource);
     memory_usage_bytes_ -= resource->bytes();
     unused_memory_usage_bytes_ -= resource->bytes();
     --resource_count_;
@@ -131,4 +174,14 @@ void ResourcePool::DidFinishUsingResource(ScopedResource* resource) {
   unused_resources_.push_back(resource);
 }
 
+void ResourcePool::ForgetContent(ScopedResource* resource) {
+  std::map<ScopedResource*, std::string>::iterator it =
+      content_keys_.find(resource);
+  if (it == content_keys_.end())
+    return;
+
+  resources_by_content_.erase(it->second);
+  content_keys_.erase(it);
+}
+
 }  // namespace cc
@@ -6,7 +6,10 @@
 #define CC_RESOURCES_RESOURCE_POOL_H_
 
 #include <list>
+#include <map>
+#include <string>
 
+#include "base/containers/hash_tables.h"
 #include "base/memory/scoped_ptr.h"
 #include "cc/base/cc_export.h"
 #include "cc/output/renderer.h"
@@ -29,6 +32,18 @@ class CC_EXPORT ResourcePool {
   scoped_ptr<ScopedResource> AcquireResource(const gfx::Size& size);
   void ReleaseResource(scoped_ptr<ScopedResource>);
 
+  // Like ReleaseResource(), but remembers that |resource| holds the content
+  // identified by |content_key|. Until the resource is reused for something
+  // else or evicted, AcquireResourceWithContent() can hand it back as is.
+  void ReleaseResourceWithContent(scoped_ptr<ScopedResource> resource,
+                                  const std::string& content_key);
+  // Returns the released resource holding the content identified by
+  // |content_key|, or NULL if there is none. The resource may still be read
+  // by the compositor, so it must not be written to.
+  scoped_ptr<ScopedResource> AcquireResourceWithContent(
+      const std::string& content_key);
+  bool HasResourcesWithContent() const { return !content_keys_.empty(); }
+
   void SetResourceUsageLimits(size_t max_memory_usage_bytes,
                               size_t max_unused_memory_usage_bytes,
                               size_t max_resource_count);
@@ -53,6 +68,7 @@ class CC_EXPORT ResourcePool {
 
  private:
   void DidFinishUsingResource(ScopedResource* resource);
+  void ForgetContent(ScopedResource* resource);
 
   ResourceProvider* resource_provider_;
   const GLenum target_;
@@ -68,6 +84,10 @@ class CC_EXPORT ResourcePool {
   ResourceList unused_resources_;
   ResourceList busy_resources_;
 
+  // Released resources that hold known content, in both directions.
+  base::hash_map<std::string, ScopedResource*> resources_by_content_;
+  std::map<ScopedResource*, std::string> content_keys_;
+
   DISALLOW_COPY_AND_ASSIGN(ResourcePool);
 };
 
@@ -1568,10 +1568,8 @@ void ResourceProvider::TransferResource(GLES2Interface* gl,
     GLC(gl,
         gl->BindTexture(resource->mailbox_holder.texture_target,
                         source->gl_id));
-    if (source->image_id) {
-      DCHECK(source->dirty_image);
+    if (source->image_id && source->dirty_image)
       BindImageForSampling(source);
-    }
     // This is a resource allocated by the compositor, we need to produce it.
     // Don't set a sync point, the caller will do it.
     GLC(gl, gl->GenMailboxCHROMIUM(resource->mailbox_holder.mailbox.name));
@@ -1720,6 +1718,17 @@ void ResourceProvider::UnmapImageRasterBuffer(ResourceId id) {
   Resource* resource = GetResource(id);
   resource->image_raster_buffer->UnlockForWrite();
   resource->dirty_image = true;
+
+  // Bind the image right away instead of when the resource is first drawn.
+  // Images backed by shared memory are copied into the texture when bound,
+  // and this moves that copy off the frame that draws the tile.
+  if (resource->image_id) {
+    LazyCreate(resource);
+    GLES2Interface* gl = ContextGL();
+    DCHECK(gl);
+    GLC(gl, gl->BindTexture(resource->target, resource->gl_id));
+    BindImageForSampling(resource);
+  }
 }
 
 void ResourceProvider::AcquirePixelRasterBuffer(ResourceId id) {
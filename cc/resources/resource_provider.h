@@ -325,7 +325,7 @@ class CC_EXPORT ResourceProvider {
 
   // Returns a canvas backed by an image buffer.
   // Rasterizing to the canvas writes the content into the image buffer,
-  // which is internally bound to the underlying resource when read.
+  // which is bound to the underlying resource when unmapped.
   // Call Unmap before the resource can be read or used for compositing.
   // It is used by ImageRasterWorkerPool.
   SkCanvas* MapImageRasterBuffer(ResourceId id);
@@ -5,6 +5,7 @@
 #include "cc/resources/task_graph_runner.h"
 
 #include <algorithm>
+#include <set>
 
 #include "base/debug/trace_event.h"
 #include "base/strings/stringprintf.h"
@@ -14,58 +15,6 @@ namespace cc {
 namespace internal {
 namespace {
 
-// Helper class for iterating over all dependents of a task.
-class DependentIterator {
- public:
-  DependentIterator(TaskGraph* graph, const Task* task)
-      : graph_(graph), task_(task), current_index_(-1), current_node_(NULL) {
-    ++(*this);
-  }
-
-  TaskGraph::Node& operator->() const {
-    DCHECK_LT(current_index_, graph_->edges.size());
-    DCHECK_EQ(graph_->edges[current_index_].task, task_);
-    DCHECK(current_node_);
-    return *current_node_;
-  }
-
-  TaskGraph::Node& operator*() const {
-    DCHECK_LT(current_index_, graph_->edges.size());
-    DCHECK_EQ(graph_->edges[current_index_].task, task_);
-    DCHECK(current_node_);
-    return *current_node_;
-  }
-
-  // Note: Performance can be improved by keeping edges sorted.
-  DependentIterator& operator++() {
-    // Find next dependency edge for |task_|.
-    do {
-      ++current_index_;
-      if (current_index_ == graph_->edges.size())
-        return *this;
-    } while (graph_->edges[current_index_].task != task_);
-
-    // Now find the node for the dependent of this edge.
-    TaskGraph::Node::Vector::iterator it =
-        std::find_if(graph_->nodes.begin(),
-                     graph_->nodes.end(),
-                     TaskGraph::Node::TaskComparator(
-                         graph_->edges[current_index_].dependent));
-    DCHECK(it != graph_->nodes.end());
-    current_node_ = &(*it);
-
-    return *this;
-  }
-
-  operator bool() const { return current_index_ < graph_->edges.size(); }
-
- private:
-  TaskGraph* graph_;
-  const Task* task_;
-  size_t current_index_;
-  TaskGraph::Node* current_node_;
-};
-
 class DependencyMismatchComparator {
  public:
   explicit DependencyMismatchComparator(const TaskGraph* graph)
@@ -95,6 +44,8 @@ class DependencyMismatchComparator {
   const TaskGraph* graph_;
 };
 
+typedef std::map<const Task*, TaskGraph::Node*> NodeMap;
+
 }  // namespace
 
 Task::Task() : did_run_(false) {}
@@ -123,22 +74,31 @@ void TaskGraph::Reset() {
   edges.clear();
 }
 
-TaskGraphRunner::TaskNamespace::TaskNamespace() : num_running_tasks(0u) {}
+
+TaskGraphRunner::TaskNamespace::TaskNamespace() : num_pending_tasks(0u) {}
 
 TaskGraphRunner::TaskNamespace::~TaskNamespace() {}
 
+TaskGraphRunner::WorkerQueue::WorkerQueue() {}
+
+TaskGraphRunner::WorkerQueue::~WorkerQueue() {}
+
 TaskGraphRunner::TaskGraphRunner(size_t num_threads,
                                  const std::string& thread_name_prefix)
     : lock_(),
       has_ready_to_run_tasks_cv_(&lock_),
       has_namespaces_with_finished_running_tasks_cv_(&lock_),
       next_namespace_id_(1),
+      next_worker_queue_index_(0u),
       next_thread_index_(0u),
       // |num_threads| can be 0 for test.
       running_tasks_(std::max(num_threads, static_cast<size_t>(1)), NULL),
       shutdown_(false) {
   base::AutoLock lock(lock_);
 
+  while (worker_queues_.size() < running_tasks_.size())
+    worker_queues_.push_back(make_scoped_ptr(new WorkerQueue));
+
   while (workers_.size() < num_threads) {
     scoped_ptr<base::DelegateSimpleThread> worker =
         make_scoped_ptr(new base::DelegateSimpleThread(
@@ -159,7 +119,6 @@ TaskGraphRunner::~TaskGraphRunner() {
   {
     base::AutoLock lock(lock_);
 
-    DCHECK_EQ(0u, ready_to_run_namespaces_.size());
     DCHECK_EQ(0u, namespaces_.size());
 
     DCHECK(!shutdown_);
@@ -176,6 +135,11 @@ TaskGraphRunner::~TaskGraphRunner() {
     base::ThreadRestrictions::ScopedAllowIO allow_io;
     worker->Join();
   }
+
+#ifndef NDEBUG
+  for (size_t i = 0; i < worker_queues_.size(); ++i)
+    DCHECK_EQ(0u, worker_queues_[i]->ready_to_run_tasks.size());
+#endif
 }
 
 NamespaceToken TaskGraphRunner::GetNamespaceToken() {
@@ -223,6 +187,22 @@ void TaskGraphRunner::SetTaskGraph(NamespaceToken token, TaskGraph* graph) {
                       DependencyMismatchComparator(graph)) ==
          graph->nodes.end());
 
+  // Index the new graph. This doesn't need |lock_|.
+  NodeMap nodes;
+  for (TaskGraph::Node::Vector::iterator it = graph->nodes.begin();
+       it != graph->nodes.end();
+       ++it) {
+    nodes[it->task] = &(*it);
+  }
+  TaskNamespace::DependentMap dependents;
+  for (TaskGraph::Edge::Vector::const_iterator it = graph->edges.begin();
+       it != graph->edges.end();
+       ++it) {
+    NodeMap::iterator node_it = nodes.find(it->dependent);
+    DCHECK(node_it != nodes.end());
+    dependents[it->task].push_back(node_it->second);
+  }
+
   {
     base::AutoLock lock(lock_);
 
@@ -234,32 +214,67 @@ void TaskGraphRunner::SetTaskGraph(NamespaceToken token, TaskGraph* graph) {
     for (Task::Vector::iterator it = task_namespace.completed_tasks.begin();
          it != task_namespace.completed_tasks.end();
          ++it) {
-      for (DependentIterator node_it(graph, it->get()); node_it; ++node_it) {
-        TaskGraph::Node& node = *node_it;
-        DCHECK_LT(0u, node.dependencies);
-        node.dependencies--;
+      TaskNamespace::DependentMap::iterator dependents_it =
+          dependents.find(it->get());
+      if (dependents_it == dependents.end())
+        continue;
+      std::vector<TaskGraph::Node*>& task_dependents = dependents_it->second;
+      for (size_t i = 0; i < task_dependents.size(); ++i) {
+        DCHECK_LT(0u, task_dependents[i]->dependencies);
+        task_dependents[i]->dependencies--;
       }
     }
 
-    // Build new "ready to run" queue and remove nodes from old graph.
-    task_namespace.ready_to_run_tasks.clear();
+    // Update the worker queues in place rather than rebuilding them: tasks
+    // that are still ready keep their place and only get their new priority,
+    // and tasks that are no longer ready are taken out. Queues are only
+    // re-heapified when they changed.
+    std::set<const Task*> queued_tasks;
+    for (size_t i = 0; i < worker_queues_.size(); ++i)
+      worker_queues_[i]->lock.Acquire();
+    for (size_t i = 0; i < worker_queues_.size(); ++i) {
+      PrioritizedTask::Vector& ready_to_run_tasks =
+          worker_queues_[i]->ready_to_run_tasks;
+      bool changed = false;
+      size_t j = 0;
+      while (j < ready_to_run_tasks.size()) {
+        PrioritizedTask& ready_task = ready_to_run_tasks[j];
+        if (ready_task.task_namespace != &task_namespace) {
+          ++j;
+          continue;
+        }
+
+        NodeMap::iterator node_it = nodes.find(ready_task.task);
+        if (node_it == nodes.end() || node_it->second->dependencies) {
+          std::swap(ready_task, ready_to_run_tasks.back());
+          ready_to_run_tasks.pop_back();
+          DCHECK_LT(0u, task_namespace.num_pending_tasks);
+          task_namespace.num_pending_tasks--;
+          changed = true;
+          continue;
+        }
+
+        queued_tasks.insert(ready_task.task);
+        if (ready_task.priority != node_it->second->priority) {
+          ready_task.priority = node_it->second->priority;
+          changed = true;
+        }
+        ++j;
+      }
+      if (changed) {
+        std::make_heap(ready_to_run_tasks.begin(),
+                       ready_to_run_tasks.end(),
+                       CompareTaskPriority);
+      }
+    }
+
+    // Find the tasks that just became ready to run.
+    PrioritizedTask::Vector new_ready_to_run_tasks;
     for (TaskGraph::Node::Vector::iterator it = graph->nodes.begin();
          it != graph->nodes.end();
          ++it) {
       TaskGraph::Node& node = *it;
 
-      // Remove any old nodes that are associated with this task. The result is
-      // that the old graph is left all nodes not present in this graph, which
-      // we use below to determine what tasks need to be canceled.
-      TaskGraph::Node::Vector::iterator old_it =
-          std::find_if(task_namespace.graph.nodes.begin(),
-                       task_namespace.graph.nodes.end(),
-                       TaskGraph::Node::TaskComparator(node.task));
-      if (old_it != task_namespace.graph.nodes.end()) {
-        std::swap(*old_it, task_namespace.graph.nodes.back());
-        task_namespace.graph.nodes.pop_back();
-      }
-
       // Task is not ready to run if dependencies are not yet satisfied.
       if (node.dependencies)
         continue;
@@ -273,25 +288,47 @@ void TaskGraphRunner::SetTaskGraph(NamespaceToken token, TaskGraph* graph) {
           running_tasks_.end())
         continue;
 
-      task_namespace.ready_to_run_tasks.push_back(
-          PrioritizedTask(node.task, node.priority));
-    }
+      // Skip if already in a worker queue.
+      if (queued_tasks.count(node.task))
+        continue;
 
-    // Rearrange the elements in |ready_to_run_tasks| in such a way that
-    // they form a heap.
-    std::make_heap(task_namespace.ready_to_run_tasks.begin(),
-                   task_namespace.ready_to_run_tasks.end(),
-                   CompareTaskPriority);
+      new_ready_to_run_tasks.push_back(
+          PrioritizedTask(node.task, &task_namespace, node.priority));
+    }
 
-    // Swap task graph.
-    task_namespace.graph.Swap(graph);
+    // Deal the new tasks out to the worker queues in order of priority, so
+    // that the most important ones are spread across workers. Sorting with
+    // the heap comparator puts the most important task last.
+    std::sort(new_ready_to_run_tasks.begin(),
+              new_ready_to_run_tasks.end(),
+              CompareTaskPriority);
+    for (PrioritizedTask::Vector::reverse_iterator it =
+             new_ready_to_run_tasks.rbegin();
+         it != new_ready_to_run_tasks.rend();
+         ++it) {
+      PrioritizedTask::Vector& ready_to_run_tasks =
+          worker_queues_[next_worker_queue_index_]->ready_to_run_tasks;
+      next_worker_queue_index_ =
+          (next_worker_queue_index_ + 1) % worker_queues_.size();
+
+      ready_to_run_tasks.push_back(*it);
+      std::push_heap(ready_to_run_tasks.begin(),
+                     ready_to_run_tasks.end(),
+                     CompareTaskPriority);
+    }
+    task_namespace.num_pending_tasks += new_ready_to_run_tasks.size();
 
     // Determine what tasks in old graph need to be canceled.
-    for (TaskGraph::Node::Vector::iterator it = graph->nodes.begin();
-         it != graph->nodes.end();
+    for (TaskGraph::Node::Vector::iterator it =
+             task_namespace.graph.nodes.begin();
+         it != task_namespace.graph.nodes.end();
          ++it) {
       TaskGraph::Node& node = *it;
 
+      // Skip if still part of the graph.
+      if (nodes.count(node.task))
+        continue;
+
       // Skip if already finished running task.
       if (node.task->HasFinishedRunning())
         continue;
@@ -307,23 +344,18 @@ void TaskGraphRunner::SetTaskGraph(NamespaceToken token, TaskGraph* graph) {
       task_namespace.completed_tasks.push_back(node.task);
     }
 
-    // Build new "ready to run" task namespaces queue.
-    ready_to_run_namespaces_.clear();
-    for (TaskNamespaceMap::iterator it = namespaces_.begin();
-         it != namespaces_.end();
-         ++it) {
-      if (!it->second.ready_to_run_tasks.empty())
-        ready_to_run_namespaces_.push_back(&it->second);
-    }
+    for (size_t i = worker_queues_.size(); i > 0; --i)
+      worker_queues_[i - 1]->lock.Release();
 
-    // Rearrange the task namespaces in |ready_to_run_namespaces_|
-    // in such a way that they form a heap.
-    std::make_heap(ready_to_run_namespaces_.begin(),
-                   ready_to_run_namespaces_.end(),
-                   CompareTaskNamespacePriority);
+    // Swap task graph. Swapping keeps the addresses of the nodes, which
+    // |dependents| refers to.
+    task_namespace.graph.Swap(graph);
+    task_namespace.dependents.swap(dependents);
 
-    // If there is more work available, wake up worker thread.
-    if (!ready_to_run_namespaces_.empty())
+    // Wake up a worker thread for each task that became ready.
+    size_t num_workers_to_wake =
+        std::min(new_ready_to_run_tasks.size(), worker_queues_.size());
+    for (size_t i = 0; i < num_workers_to_wake; ++i)
       has_ready_to_run_tasks_cv_.Signal();
   }
 }
@@ -350,144 +382,143 @@ void TaskGraphRunner::CollectCompletedTasks(NamespaceToken token,
 
     // Remove namespace if finished running tasks.
     DCHECK_EQ(0u, task_namespace.completed_tasks.size());
-    DCHECK_EQ(0u, task_namespace.ready_to_run_tasks.size());
-    DCHECK_EQ(0u, task_namespace.num_running_tasks);
+    DCHECK_EQ(0u, task_namespace.num_pending_tasks);
     namespaces_.erase(it);
   }
 }
 
 bool TaskGraphRunner::RunTaskForTesting() {
-  base::AutoLock lock(lock_);
-
-  if (ready_to_run_namespaces_.empty())
+  PrioritizedTask task;
+  if (!TakeReadyToRunTask(0u, &task))
     return false;
 
-  RunTaskWithLockAcquired(0);
+  RunTask(0u, task);
   return true;
 }
 
 void TaskGraphRunner::Run() {
-  base::AutoLock lock(lock_);
+  unsigned thread_index;
+  {
+    base::AutoLock lock(lock_);
 
-  // Get a unique thread index.
-  int thread_index = next_thread_index_++;
+    // Get a unique thread index.
+    thread_index = next_thread_index_++;
+  }
 
   while (true) {
-    if (ready_to_run_namespaces_.empty()) {
-      // Exit when shutdown is set and no more tasks are pending.
-      if (shutdown_)
-        break;
-
-      // Wait for more tasks.
-      has_ready_to_run_tasks_cv_.Wait();
-      continue;
+    PrioritizedTask task;
+    if (!TakeReadyToRunTask(thread_index, &task)) {
+      base::AutoLock lock(lock_);
+
+      // Tasks are only added to the queues while |lock_| is held, so if
+      // there are none now, the next one added will signal a worker.
+      if (!TakeReadyToRunTask(thread_index, &task)) {
+        // Exit when shutdown is set and no more tasks are pending.
+        if (shutdown_) {
+          // Wake up the next worker so it knows it should exit as well
+          // (because the Shutdown() code only signals once).
+          has_ready_to_run_tasks_cv_.Signal();
+          return;
+        }
+
+        // Wait for more tasks.
+        has_ready_to_run_tasks_cv_.Wait();
+        continue;
+      }
     }
 
-    RunTaskWithLockAcquired(thread_index);
+    RunTask(thread_index, task);
   }
-
-  // We noticed we should exit. Wake up the next worker so it knows it should
-  // exit as well (because the Shutdown() code only signals once).
-  has_ready_to_run_tasks_cv_.Signal();
 }
 
-void TaskGraphRunner::RunTaskWithLockAcquired(int thread_index) {
-  TRACE_EVENT1("cc", "TaskGraphRunner::RunTask", "thread_index", thread_index);
+bool TaskGraphRunner::TakeReadyToRunTask(unsigned thread_index,
+                                         PrioritizedTask* task) {
+  DCHECK_LT(thread_index, worker_queues_.size());
 
-  lock_.AssertAcquired();
-  DCHECK(!ready_to_run_namespaces_.empty());
-
-  // Take top priority TaskNamespace from |ready_to_run_namespaces_|.
-  std::pop_heap(ready_to_run_namespaces_.begin(),
-                ready_to_run_namespaces_.end(),
-                CompareTaskNamespacePriority);
-  TaskNamespace* task_namespace = ready_to_run_namespaces_.back();
-  ready_to_run_namespaces_.pop_back();
-  DCHECK(!task_namespace->ready_to_run_tasks.empty());
-
-  // Take top priority task from |ready_to_run_tasks|.
-  std::pop_heap(task_namespace->ready_to_run_tasks.begin(),
-                task_namespace->ready_to_run_tasks.end(),
-                CompareTaskPriority);
-  scoped_refptr<Task> task(task_namespace->ready_to_run_tasks.back().task);
-  task_namespace->ready_to_run_tasks.pop_back();
-
-  // Add task namespace back to |ready_to_run_namespaces_| if not
-  // empty after taking top priority task.
-  if (!task_namespace->ready_to_run_tasks.empty()) {
-    ready_to_run_namespaces_.push_back(task_namespace);
-    std::push_heap(ready_to_run_namespaces_.begin(),
-                   ready_to_run_namespaces_.end(),
-                   CompareTaskNamespacePriority);
+  // Try the queue of this thread first, then steal from the others.
+  for (size_t i = 0; i < worker_queues_.size(); ++i) {
+    WorkerQueue* queue =
+        worker_queues_[(thread_index + i) % worker_queues_.size()];
+    base::AutoLock lock(queue->lock);
+
+    if (queue->ready_to_run_tasks.empty())
+      continue;
+
+    // Take top priority task from |ready_to_run_tasks|.
+    std::pop_heap(queue->ready_to_run_tasks.begin(),
+                  queue->ready_to_run_tasks.end(),
+                  CompareTaskPriority);
+    *task = queue->ready_to_run_tasks.back();
+    queue->ready_to_run_tasks.pop_back();
+
+    // Add task to |running_tasks_| before the task can be found by
+    // SetTaskGraph() neither queued nor running.
+    DCHECK(!running_tasks_[thread_index]);
+    running_tasks_[thread_index] = task->task;
+    return true;
   }
 
-  // Add task to |running_tasks_|.
-  DCHECK_LT(static_cast<size_t>(thread_index), running_tasks_.size());
-  DCHECK(!running_tasks_[thread_index]);
-  running_tasks_[thread_index] = task.get();
+  return false;
+}
 
-  // Increment running task count for task namespace.
-  task_namespace->num_running_tasks++;
+void TaskGraphRunner::RunTask(unsigned thread_index,
+                              const PrioritizedTask& prioritized_task) {
+  TRACE_EVENT1("cc", "TaskGraphRunner::RunTask", "thread_index", thread_index);
 
-  // There may be more work available, so wake up another worker thread.
-  has_ready_to_run_tasks_cv_.Signal();
+  scoped_refptr<Task> task(prioritized_task.task);
+  TaskNamespace* task_namespace = prioritized_task.task_namespace;
 
-  // Call WillRun() before releasing |lock_| and running task.
   task->WillRun();
+  task->RunOnWorkerThread(thread_index);
 
-  {
-    base::AutoUnlock unlock(lock_);
-
-    task->RunOnWorkerThread(thread_index);
-  }
+  base::AutoLock lock(lock_);
 
   // This will mark task as finished running.
   task->DidRun();
 
-  // Decrement running task count for task namespace.
-  DCHECK_LT(0u, task_namespace->num_running_tasks);
-  task_namespace->num_running_tasks--;
-
   // Remove task from |running_tasks_|.
+  DCHECK_EQ(task.get(), running_tasks_[thread_index]);
   running_tasks_[thread_index] = NULL;
 
-  // Now iterate over all dependents to decrement dependencies and check if they
-  // are ready to run.
-  bool ready_to_run_namespaces_has_heap_properties = true;
-  for (DependentIterator it(&task_namespace->graph, task.get()); it; ++it) {
-    TaskGraph::Node& dependent_node = *it;
-
-    DCHECK_LT(0u, dependent_node.dependencies);
-    dependent_node.dependencies--;
-    // Task is ready if it has no dependencies. Add it to |ready_to_run_tasks_|.
-    if (!dependent_node.dependencies) {
-      bool was_empty = task_namespace->ready_to_run_tasks.empty();
-      task_namespace->ready_to_run_tasks.push_back(
-          PrioritizedTask(dependent_node.task, dependent_node.priority));
-      std::push_heap(task_namespace->ready_to_run_tasks.begin(),
-                     task_namespace->ready_to_run_tasks.end(),
+  // Now iterate over all dependents to decrement dependencies and check if
+  // they are ready to run. Ready dependents go to the queue of this thread.
+  size_t num_new_ready_to_run_tasks = 0;
+  TaskNamespace::DependentMap::iterator dependents_it =
+      task_namespace->dependents.find(task.get());
+  if (dependents_it != task_namespace->dependents.end()) {
+    WorkerQueue* queue = worker_queues_[thread_index];
+    base::AutoLock queue_lock(queue->lock);
+
+    std::vector<TaskGraph::Node*>& task_dependents = dependents_it->second;
+    for (size_t i = 0; i < task_dependents.size(); ++i) {
+      TaskGraph::Node& dependent_node = *task_dependents[i];
+
+      DCHECK_LT(0u, dependent_node.dependencies);
+      dependent_node.dependencies--;
+      if (dependent_node.dependencies)
+        continue;
+
+      queue->ready_to_run_tasks.push_back(PrioritizedTask(
+          dependent_node.task, task_namespace, dependent_node.priority));
+      std::push_heap(queue->ready_to_run_tasks.begin(),
+                     queue->ready_to_run_tasks.end(),
                      CompareTaskPriority);
-      // Task namespace is ready if it has at least one ready to run task. Add
-      // it to |ready_to_run_namespaces_| if it just become ready.
-      if (was_empty) {
-        DCHECK(std::find(ready_to_run_namespaces_.begin(),
-                         ready_to_run_namespaces_.end(),
-                         task_namespace) == ready_to_run_namespaces_.end());
-        ready_to_run_namespaces_.push_back(task_namespace);
-      }
-      ready_to_run_namespaces_has_heap_properties = false;
+      ++num_new_ready_to_run_tasks;
     }
   }
+  task_namespace->num_pending_tasks += num_new_ready_to_run_tasks;
 
-  // Rearrange the task namespaces in |ready_to_run_namespaces_| in such a way
-  // that they yet again form a heap.
-  if (!ready_to_run_namespaces_has_heap_properties) {
-    std::make_heap(ready_to_run_namespaces_.begin(),
-                   ready_to_run_namespaces_.end(),
-                   CompareTaskNamespacePriority);
+  // This thread takes the first new task itself. Wake up other workers to
+  // steal the rest.
+  for (size_t i = 1;
+       i < std::min(num_new_ready_to_run_tasks, worker_queues_.size());
+       ++i) {
+    has_ready_to_run_tasks_cv_.Signal();
   }
 
   // Finally add task to |completed_tasks_|.
+  DCHECK_LT(0u, task_namespace->num_pending_tasks);
+  task_namespace->num_pending_tasks--;
   task_namespace->completed_tasks.push_back(task);
 
   // If namespace has finished running all tasks, wake up origin thread.
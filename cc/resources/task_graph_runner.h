@@ -10,15 +10,18 @@
 #include <vector>
 
 #include "base/memory/ref_counted.h"
+#include "base/memory/slab_allocator.h"
 #include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
 #include "base/threading/simple_thread.h"
 #include "cc/base/cc_export.h"
 #include "cc/base/scoped_ptr_deque.h"
+#include "cc/base/scoped_ptr_vector.h"
 
 namespace cc {
 namespace internal {
 
-class CC_EXPORT Task : public base::RefCountedThreadSafe<Task> {
+class CC_EXPORT Task : public base::SlabAllocatedRefCountedThreadSafe<Task> {
  public:
   typedef std::vector<scoped_refptr<Task> > Vector;
 
@@ -131,18 +134,24 @@ class CC_EXPORT TaskGraphRunner : public base::DelegateSimpleThread::Delegate {
   bool RunTaskForTesting();
 
  private:
+  struct TaskNamespace;
+
   struct PrioritizedTask {
     typedef std::vector<PrioritizedTask> Vector;
 
-    PrioritizedTask(Task* task, unsigned priority)
-        : task(task), priority(priority) {}
+    PrioritizedTask() : task(NULL), task_namespace(NULL), priority(0u) {}
+    PrioritizedTask(Task* task,
+                    TaskNamespace* task_namespace,
+                    unsigned priority)
+        : task(task), task_namespace(task_namespace), priority(priority) {}
 
     Task* task;
+    TaskNamespace* task_namespace;
     unsigned priority;
   };
 
   struct TaskNamespace {
-    typedef std::vector<TaskNamespace*> Vector;
+    typedef std::map<const Task*, std::vector<TaskGraph::Node*> > DependentMap;
 
     TaskNamespace();
     ~TaskNamespace();
@@ -150,52 +159,61 @@ class CC_EXPORT TaskGraphRunner : public base::DelegateSimpleThread::Delegate {
     // Current task graph.
     TaskGraph graph;
 
-    // Ordered set of tasks that are ready to run.
-    PrioritizedTask::Vector ready_to_run_tasks;
+    // Nodes of the tasks in |graph| that depend on each task, so that a
+    // finished task finds its dependents without searching the graph.
+    DependentMap dependents;
 
     // Completed tasks not yet collected by origin thread.
     Task::Vector completed_tasks;
 
-    // Number of currently running tasks.
-    size_t num_running_tasks;
+    // Number of tasks that are ready to run in a worker queue or running.
+    size_t num_pending_tasks;
   };
 
   typedef std::map<int, TaskNamespace> TaskNamespaceMap;
 
+  // Every worker has a queue of ready to run tasks that it takes tasks from
+  // first. Tasks that become ready when a worker finishes a task are added to
+  // its own queue, and a worker with an empty queue steals from the others.
+  // This keeps workers from contending on |lock_| to find their next task.
+  struct WorkerQueue {
+    WorkerQueue();
+    ~WorkerQueue();
+
+    // Protects |ready_to_run_tasks|. When |lock_| is also needed, it must be
+    // acquired first.
+    base::Lock lock;
+
+    // Heap of ready to run tasks from all namespaces.
+    PrioritizedTask::Vector ready_to_run_tasks;
+  };
+
   static bool CompareTaskPriority(const PrioritizedTask& a,
                                   const PrioritizedTask& b) {
     // In this system, numerically lower priority is run first.
     return a.priority > b.priority;
   }
 
-  static bool CompareTaskNamespacePriority(const TaskNamespace* a,
-                                           const TaskNamespace* b) {
-    DCHECK(!a->ready_to_run_tasks.empty());
-    DCHECK(!b->ready_to_run_tasks.empty());
-
-    // Compare based on task priority of the ready_to_run_tasks heap
-    // .front() will hold the max element of the heap,
-    // except after pop_heap, when max element is moved to .back().
-    return CompareTaskPriority(a->ready_to_run_tasks.front(),
-                               b->ready_to_run_tasks.front());
-  }
-
   static bool HasFinishedRunningTasksInNamespace(
       const TaskNamespace* task_namespace) {
-    return !task_namespace->num_running_tasks &&
-           task_namespace->ready_to_run_tasks.empty();
+    return !task_namespace->num_pending_tasks;
   }
 
   // Overridden from base::DelegateSimpleThread:
   virtual void Run() OVERRIDE;
 
-  // Run next task. Caller must acquire |lock_| prior to calling this
-  // function and make sure at least one task is ready to run.
-  void RunTaskWithLockAcquired(int thread_index);
+  // Takes the top priority task from the queue of |thread_index|, or from
+  // another queue if that one is empty, and marks it as running on
+  // |thread_index|. Returns false if no tasks are ready to run.
+  bool TakeReadyToRunTask(unsigned thread_index, PrioritizedTask* task);
+
+  // Run |task|, which was taken by TakeReadyToRunTask(). Caller must not
+  // hold |lock_|.
+  void RunTask(unsigned thread_index, const PrioritizedTask& task);
 
-  // This lock protects all members of this class. Do not read or modify
-  // anything without holding this lock. Do not block while holding this
-  // lock.
+  // This lock protects all members of this class except the contents of
+  // |worker_queues_|, which are protected by their own locks. Do not block
+  // while holding this lock.
   mutable base::Lock lock_;
 
   // Condition variable that is waited on by worker threads until new
@@ -213,14 +231,20 @@ class CC_EXPORT TaskGraphRunner : public base::DelegateSimpleThread::Delegate {
   // tasks not yet collected.
   TaskNamespaceMap namespaces_;
 
-  // Ordered set of task namespaces that have ready to run tasks.
-  TaskNamespace::Vector ready_to_run_namespaces_;
+  // One queue per worker thread. Tasks are only added to the queues while
+  // |lock_| is held.
+  ScopedPtrVector<WorkerQueue> worker_queues_;
+
+  // Queue that SetTaskGraph() adds the next newly ready task to.
+  size_t next_worker_queue_index_;
 
   // Provides each running thread loop with a unique index. First thread
   // loop index is 0.
   unsigned next_thread_index_;
 
-  // This set contains all currently running tasks.
+  // The task running on each thread, or NULL. An entry is set while the
+  // worker queue the task is taken from is locked, and cleared while |lock_|
+  // is held.
   typedef std::vector<const Task*> TaskVector;
   TaskVector running_tasks_;
 
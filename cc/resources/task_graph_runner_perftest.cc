@@ -211,6 +211,98 @@ class TaskGraphRunnerPerfTest : public testing::Test {
                            true);
   }
 
+  void RunScheduleReprioritizedTasksTest(const std::string& test_name,
+                                         int num_top_level_tasks,
+                                         int num_tasks,
+                                         int num_leaf_tasks) {
+    PerfTaskImpl::Vector top_level_tasks;
+    PerfTaskImpl::Vector tasks;
+    PerfTaskImpl::Vector leaf_tasks;
+    CreateTasks(num_top_level_tasks, &top_level_tasks);
+    CreateTasks(num_tasks, &tasks);
+    CreateTasks(num_leaf_tasks, &leaf_tasks);
+
+    // Avoid unnecessary heap allocations by reusing the same graph and
+    // completed tasks vector.
+    internal::TaskGraph graph;
+    internal::Task::Vector completed_tasks;
+
+    size_t count = 0;
+    timer_.Reset();
+    do {
+      graph.Reset();
+      BuildTaskGraph(top_level_tasks, tasks, leaf_tasks, &graph);
+      // Reverse the order of the tasks every other time, like the tile
+      // manager does when tile priorities change while scrolling.
+      for (size_t i = 0; i < graph.nodes.size(); ++i) {
+        graph.nodes[i].priority = count % 2 ? i : graph.nodes.size() - i;
+      }
+      task_graph_runner_->SetTaskGraph(namespace_token_, &graph);
+      // Shouldn't be any tasks to collect as we reschedule the same set
+      // of tasks.
+      DCHECK_EQ(0u, CollectCompletedTasks(&completed_tasks));
+      ++count;
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    internal::TaskGraph empty;
+    task_graph_runner_->SetTaskGraph(namespace_token_, &empty);
+    CollectCompletedTasks(&completed_tasks);
+
+    perf_test::PrintResult("schedule_reprioritized_tasks",
+                           TestModifierString(),
+                           test_name,
+                           timer_.LapsPerSecond(),
+                           "runs/s",
+                           true);
+  }
+
+  void RunScheduleAndExecuteTasksOnWorkersTest(const std::string& test_name,
+                                               int num_workers,
+                                               int num_top_level_tasks,
+                                               int num_tasks,
+                                               int num_leaf_tasks) {
+    // Tasks are run by |num_workers| threads, which take tasks from each
+    // other's queues as they finish.
+    internal::TaskGraphRunner task_graph_runner(num_workers, "PerfTest");
+    internal::NamespaceToken namespace_token =
+        task_graph_runner.GetNamespaceToken();
+
+    PerfTaskImpl::Vector top_level_tasks;
+    PerfTaskImpl::Vector tasks;
+    PerfTaskImpl::Vector leaf_tasks;
+    CreateTasks(num_top_level_tasks, &top_level_tasks);
+    CreateTasks(num_tasks, &tasks);
+    CreateTasks(num_leaf_tasks, &leaf_tasks);
+
+    // Avoid unnecessary heap allocations by reusing the same graph and
+    // completed tasks vector.
+    internal::TaskGraph graph;
+    internal::Task::Vector completed_tasks;
+
+    timer_.Reset();
+    do {
+      graph.Reset();
+      BuildTaskGraph(top_level_tasks, tasks, leaf_tasks, &graph);
+      task_graph_runner.SetTaskGraph(namespace_token, &graph);
+      task_graph_runner.WaitForTasksToFinishRunning(namespace_token);
+      task_graph_runner.CollectCompletedTasks(namespace_token,
+                                              &completed_tasks);
+      completed_tasks.clear();
+      ResetTasks(&top_level_tasks);
+      ResetTasks(&tasks);
+      ResetTasks(&leaf_tasks);
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PrintResult("execute_tasks_on_workers",
+                           TestModifierString(),
+                           test_name,
+                           timer_.LapsPerSecond(),
+                           "runs/s",
+                           true);
+  }
+
  private:
   static std::string TestModifierString() {
     return std::string("_task_graph_runner");
@@ -320,5 +412,23 @@ TEST_F(TaskGraphRunnerPerfTest, ScheduleAndExecuteTasks) {
   RunScheduleAndExecuteTasksTest("2_32_1", 2, 32, 1);
 }
 
+TEST_F(TaskGraphRunnerPerfTest, ScheduleReprioritizedTasks) {
+  RunScheduleReprioritizedTasksTest("0_1_0", 0, 1, 0);
+  RunScheduleReprioritizedTasksTest("0_32_0", 0, 32, 0);
+  RunScheduleReprioritizedTasksTest("2_1_0", 2, 1, 0);
+  RunScheduleReprioritizedTasksTest("2_32_0", 2, 32, 0);
+  RunScheduleReprioritizedTasksTest("2_1_1", 2, 1, 1);
+  RunScheduleReprioritizedTasksTest("2_32_1", 2, 32, 1);
+}
+
+TEST_F(TaskGraphRunnerPerfTest, ScheduleAndExecuteTasksOnWorkers) {
+  RunScheduleAndExecuteTasksOnWorkersTest("1_0_32_0", 1, 0, 32, 0);
+  RunScheduleAndExecuteTasksOnWorkersTest("4_0_32_0", 4, 0, 32, 0);
+  RunScheduleAndExecuteTasksOnWorkersTest("8_0_32_0", 8, 0, 32, 0);
+  RunScheduleAndExecuteTasksOnWorkersTest("4_2_32_1", 4, 2, 32, 1);
+  RunScheduleAndExecuteTasksOnWorkersTest("8_2_32_1", 8, 2, 32, 1);
+  RunScheduleAndExecuteTasksOnWorkersTest("8_0_256_0", 8, 0, 256, 0);
+}
+
 }  // namespace
 }  // namespace cc
@@ -292,5 +292,45 @@ TEST_F(TaskGraphRunnerSingleThreadTest, Priority) {
   }
 }
 
+class TaskGraphRunnerNoThreadTest : public TaskGraphRunnerTestBase,
+                                    public testing::Test {
+ public:
+  // Overridden from testing::Test:
+  virtual void SetUp() OVERRIDE {
+    task_graph_runner_ =
+        make_scoped_ptr(new internal::TaskGraphRunner(0, "Test"));
+    for (int i = 0; i < kNamespaceCount; ++i)
+      namespace_token_[i] = task_graph_runner_->GetNamespaceToken();
+  }
+  virtual void TearDown() OVERRIDE { task_graph_runner_.reset(); }
+};
+
+TEST_F(TaskGraphRunnerNoThreadTest, RescheduleWithNewPriorities) {
+  scoped_refptr<FakeTaskImpl> tasks[] = {new FakeTaskImpl(this, 0, 0u),
+                                         new FakeTaskImpl(this, 0, 1u)};
+
+  internal::TaskGraph graph;
+  graph.nodes.push_back(internal::TaskGraph::Node(tasks[0].get(), 0u, 0u));
+  graph.nodes.push_back(internal::TaskGraph::Node(tasks[1].get(), 1u, 0u));
+  task_graph_runner_->SetTaskGraph(namespace_token_[0], &graph);
+
+  // Schedule the same tasks with their priorities swapped.
+  graph.Reset();
+  graph.nodes.push_back(internal::TaskGraph::Node(tasks[0].get(), 1u, 0u));
+  graph.nodes.push_back(internal::TaskGraph::Node(tasks[1].get(), 0u, 0u));
+  task_graph_runner_->SetTaskGraph(namespace_token_[0], &graph);
+
+  while (task_graph_runner_->RunTaskForTesting())
+    continue;
+  RunAllTasks(0);
+
+  // Neither task should have been canceled, and they should have run in
+  // order of their new priorities.
+  ASSERT_EQ(2u, run_task_ids(0).size());
+  EXPECT_EQ(1u, run_task_ids(0)[0]);
+  EXPECT_EQ(0u, run_task_ids(0)[1]);
+  ASSERT_EQ(2u, on_task_completed_ids(0).size());
+}
+
 }  // namespace
 }  // namespace cc
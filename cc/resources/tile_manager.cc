@@ -12,6 +12,7 @@
 #include "base/json/json_writer.h"
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
+#include "base/strings/stringprintf.h"
 #include "cc/debug/traced_value.h"
 #include "cc/resources/direct_raster_worker_pool.h"
 #include "cc/resources/image_raster_worker_pool.h"
@@ -23,6 +24,12 @@
 namespace cc {
 namespace {
 
+// GPU raster tasks run on the compositor thread, one batch at a time, and hold
+// up drawing and input handling until the batch is done. This bounds the
+// number of pixels in a batch; the tiles past it are scheduled once the batch
+// has finished. It is about eight 256x256 tiles.
+const int kMaxGpuRasterPixelsPerBatch = 256 * 256 * 8;
+
 // Memory limit policy works by mapping some bin states to the NEVER bin.
 const ManagedTileBin kBinPolicyMap[NUM_TILE_MEMORY_LIMIT_POLICIES][NUM_BINS] = {
     // [ALLOW_NOTHING]
@@ -190,6 +197,7 @@ TileManager::TileManager(
       all_tiles_required_for_activation_have_memory_(true),
       memory_required_bytes_(0),
       memory_nice_to_have_bytes_(0),
+      occluded_tile_count_(0),
       bytes_releasable_(0),
       resources_releasable_(0),
       max_raster_usage_bytes_(max_raster_usage_bytes),
@@ -197,7 +205,9 @@ TileManager::TileManager(
       rendering_stats_instrumentation_(rendering_stats_instrumentation),
       did_initialize_visible_tile_(false),
       did_check_for_completed_tasks_since_last_schedule_tasks_(true),
-      use_rasterize_on_demand_(use_rasterize_on_demand) {
+      use_rasterize_on_demand_(use_rasterize_on_demand),
+      has_deferred_gpu_raster_tasks_(false),
+      has_deferred_gpu_raster_tasks_required_for_activation_(false) {
   RasterWorkerPool* raster_worker_pools[NUM_RASTER_WORKER_POOL_TYPES] = {
       raster_worker_pool_.get(),        // RASTER_WORKER_POOL_TYPE_DEFAULT
       direct_raster_worker_pool_.get()  // RASTER_WORKER_POOL_TYPE_DIRECT
@@ -279,8 +289,10 @@ void TileManager::DidFinishRunningTasks() {
   TRACE_EVENT0("cc", "TileManager::DidFinishRunningTasks");
 
   // When OOM, keep re-assigning memory until we reach a steady state
-  // where top-priority tiles are initialized.
-  if (all_tiles_that_need_to_be_rasterized_have_memory_)
+  // where top-priority tiles are initialized. Likewise, keep scheduling
+  // until all GPU raster batches have run.
+  if (all_tiles_that_need_to_be_rasterized_have_memory_ &&
+      !has_deferred_gpu_raster_tasks_)
     return;
 
   raster_worker_pool_delegate_->CheckForCompletedTasks();
@@ -297,6 +309,9 @@ void TileManager::DidFinishRunningTasks() {
     return;
   }
 
+  has_deferred_gpu_raster_tasks_ = false;
+  has_deferred_gpu_raster_tasks_required_for_activation_ = false;
+
   // We don't reserve memory for required-for-activation tiles during
   // accelerated gestures, so we just postpone activation when we don't
   // have these tiles, and activate after the accelerated gesture.
@@ -333,6 +348,11 @@ void TileManager::DidFinishRunningTasksRequiredForActivation() {
   if (!all_tiles_required_for_activation_have_memory_)
     return;
 
+  // Some tiles required for activation are waiting for a later GPU raster
+  // batch.
+  if (has_deferred_gpu_raster_tasks_required_for_activation_)
+    return;
+
   client_->NotifyReadyToActivate();
 }
 
@@ -342,6 +362,7 @@ void TileManager::GetTilesWithAssignedBins(PrioritizedTileSet* tiles) {
   // Compute new stats to be return by GetMemoryStats().
   memory_required_bytes_ = 0;
   memory_nice_to_have_bytes_ = 0;
+  occluded_tile_count_ = 0;
 
   const TileMemoryLimitPolicy memory_policy = global_state_.memory_limit_policy;
   const TreePriority tree_priority = global_state_.tree_priority;
@@ -392,6 +413,14 @@ void TileManager::GetTilesWithAssignedBins(PrioritizedTileSet* tiles) {
     if (!tile_is_ready_to_draw && pending_is_non_ideal)
       pending_bin = NEVER_BIN;
 
+    // Nor do we want to paint tiles that are hidden behind opaque content.
+    bool active_is_occluded = active_priority.is_occluded;
+    bool pending_is_occluded = pending_priority.is_occluded;
+    if (!tile_is_ready_to_draw && active_is_occluded)
+      active_bin = NEVER_BIN;
+    if (!tile_is_ready_to_draw && pending_is_occluded)
+      pending_bin = NEVER_BIN;
+
     // Compute combined bin.
     ManagedTileBin combined_bin = std::min(active_bin, pending_bin);
 
@@ -444,6 +473,8 @@ void TileManager::GetTilesWithAssignedBins(PrioritizedTileSet* tiles) {
         tree_bin[ACTIVE_TREE] == NOW_AND_READY_TO_DRAW_BIN;
 
     if (mts.bin == NEVER_BIN) {
+      if (active_is_occluded || pending_is_occluded)
+        ++occluded_tile_count_;
       FreeResourcesForTile(tile);
       continue;
     }
@@ -498,11 +529,24 @@ void TileManager::ManageTiles(const GlobalStateThatImpactsTilePriority& state) {
                        "state",
                        TracedValue::FromValue(BasicStateAsValue().release()));
 
+  TRACE_COUNTER_ID1("cc", "occluded_tiles", this, occluded_tile_count_);
   TRACE_COUNTER_ID1("cc",
                     "unused_memory_bytes",
                     this,
                     resource_pool_->total_memory_usage_bytes() -
                         resource_pool_->acquired_memory_usage_bytes());
+  TRACE_COUNTER_ID2("cc",
+                    "raster_cache",
+                    this,
+                    "hits",
+                    memory_stats_from_last_assign_.raster_cache_hit_count,
+                    "misses",
+                    memory_stats_from_last_assign_.raster_cache_miss_count);
+  TRACE_COUNTER_ID1(
+      "cc",
+      "raster_cache_saved_pixels",
+      this,
+      memory_stats_from_last_assign_.raster_cache_saved_pixel_count);
 }
 
 bool TileManager::UpdateVisibleTiles() {
@@ -589,6 +633,54 @@ RasterMode TileManager::DetermineRasterMode(const Tile* tile) const {
   return std::min(raster_mode, current_mode);
 }
 
+std::string TileManager::RasterContentKey(const Tile* tile,
+                                          RasterMode mode) const {
+  std::string key = base::StringPrintf("%d %d %d %d ",
+                                       mode,
+                                       tile->use_gpu_rasterization(),
+                                       tile->size().width(),
+                                       tile->size().height());
+  tile->picture_pile()->AppendContentKey(
+      tile->content_rect(), tile->contents_scale(), &key);
+  return key;
+}
+
+bool TileManager::ReuseCachedRasterForTile(Tile* tile) {
+  ManagedTileState& mts = tile->managed_state();
+  ManagedTileState::TileVersion& tile_version =
+      mts.tile_versions[mts.raster_mode];
+  DCHECK(!tile_version.resource_);
+
+  scoped_ptr<ScopedResource> resource;
+  if (resource_pool_->HasResourcesWithContent()) {
+    resource = resource_pool_->AcquireResourceWithContent(
+        RasterContentKey(tile, mts.raster_mode));
+  }
+  if (!resource) {
+    ++memory_stats_from_last_assign_.raster_cache_miss_count;
+    return false;
+  }
+
+  ++memory_stats_from_last_assign_.raster_cache_hit_count;
+  memory_stats_from_last_assign_.raster_cache_saved_pixel_count +=
+      tile->content_rect().size().GetArea();
+
+  // Whether the content has text is not kept with the resource. Assuming it
+  // does at worst re-rasters the tile without LCD text once LCD text can no
+  // longer be used for it.
+  tile_version.set_has_text(true);
+  tile_version.set_use_resource();
+  tile_version.resource_ = resource.Pass();
+
+  bytes_releasable_ += BytesConsumedIfAllocated(tile);
+  ++resources_releasable_;
+
+  FreeUnusedResourcesForTile(tile);
+  if (tile->priority(ACTIVE_TREE).distance_to_visible == 0.f)
+    did_initialize_visible_tile_ = true;
+  return true;
+}
+
 void TileManager::AssignGpuMemoryToTiles(
     PrioritizedTileSet* tiles,
     TileVector* tiles_that_need_to_be_rasterized) {
@@ -733,6 +825,9 @@ void TileManager::AssignGpuMemoryToTiles(
       continue;
     }
 
+    if (!tile_version.raster_task_ && ReuseCachedRasterForTile(tile))
+      continue;
+
     raster_bytes = raster_bytes_if_rastered;
     tiles_that_need_to_be_rasterized->push_back(tile);
   }
@@ -760,7 +855,11 @@ void TileManager::AssignGpuMemoryToTiles(
 void TileManager::FreeResourceForTile(Tile* tile, RasterMode mode) {
   ManagedTileState& mts = tile->managed_state();
   if (mts.tile_versions[mode].resource_) {
-    resource_pool_->ReleaseResource(mts.tile_versions[mode].resource_.Pass());
+    // Keep track of what the resource holds, so that a tile with the same
+    // content can take it back instead of rasterizing again.
+    resource_pool_->ReleaseResourceWithContent(
+        mts.tile_versions[mode].resource_.Pass(),
+        RasterContentKey(tile, mode));
 
     DCHECK_GE(bytes_releasable_, BytesConsumedIfAllocated(tile));
     DCHECK_GE(resources_releasable_, 1u);
@@ -805,6 +904,10 @@ void TileManager::ScheduleTasks(
   for (size_t i = 0; i < NUM_RASTER_WORKER_POOL_TYPES; ++i)
     raster_queue_[i].Reset();
 
+  has_deferred_gpu_raster_tasks_ = false;
+  has_deferred_gpu_raster_tasks_required_for_activation_ = false;
+  int gpu_raster_pixels = 0;
+
   // Build a new task queue containing all task currently needed. Tasks
   // are added in order of priority, highest priority task first.
   for (TileVector::const_iterator it = tiles_that_need_to_be_rasterized.begin();
@@ -818,6 +921,19 @@ void TileManager::ScheduleTasks(
     DCHECK(tile_version.requires_resource());
     DCHECK(!tile_version.resource_);
 
+    if (tile->use_gpu_rasterization()) {
+      // The first tile is always scheduled, so that progress is made.
+      int tile_pixels = tile->size().GetArea();
+      if (gpu_raster_pixels &&
+          gpu_raster_pixels + tile_pixels > kMaxGpuRasterPixelsPerBatch) {
+        has_deferred_gpu_raster_tasks_ = true;
+        if (tile->required_for_activation())
+          has_deferred_gpu_raster_tasks_required_for_activation_ = true;
+        continue;
+      }
+      gpu_raster_pixels += tile_pixels;
+    }
+
     if (!tile_version.raster_task_)
       tile_version.raster_task_ = CreateRasterTask(tile);
 
@@ -7,6 +7,7 @@
 
 #include <queue>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "base/containers/hash_tables.h"
@@ -87,6 +88,9 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
     return memory_stats_from_last_assign_;
   }
 
+  // The number of tiles that are not rastered because they are occluded.
+  size_t occluded_tile_count() const { return occluded_tile_count_; }
+
   void InitializeTilesWithResourcesForTesting(
       const std::vector<Tile*>& tiles,
       ResourceProvider* resource_provider) {
@@ -173,6 +177,8 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
   }
 
   RasterMode DetermineRasterMode(const Tile* tile) const;
+  std::string RasterContentKey(const Tile* tile, RasterMode mode) const;
+  bool ReuseCachedRasterForTile(Tile* tile);
   void FreeResourceForTile(Tile* tile, RasterMode mode);
   void FreeResourcesForTile(Tile* tile);
   void FreeUnusedResourcesForTile(Tile* tile);
@@ -202,6 +208,7 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
 
   size_t memory_required_bytes_;
   size_t memory_nice_to_have_bytes_;
+  size_t occluded_tile_count_;
 
   size_t bytes_releasable_;
   size_t resources_releasable_;
@@ -229,6 +236,10 @@ class CC_EXPORT TileManager : public RasterWorkerPoolClient,
 
   bool use_rasterize_on_demand_;
 
+  // Whether the last ScheduleTasks() left GPU raster tasks for a later batch.
+  bool has_deferred_gpu_raster_tasks_;
+  bool has_deferred_gpu_raster_tasks_required_for_activation_;
+
   // Queues used when scheduling raster tasks.
   RasterTaskQueue raster_queue_[NUM_RASTER_WORKER_POOL_TYPES];
 
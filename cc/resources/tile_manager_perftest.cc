@@ -163,6 +163,49 @@ class TileManagerPerfTest : public testing::Test {
         "manage_tiles", "", test_name, timer_.LapsPerSecond(), "runs/s", true);
   }
 
+  void RunAssignOccludedTilesTest(const std::string& test_name,
+                                  unsigned tile_count,
+                                  int occluded_percent) {
+    DCHECK_GE(occluded_percent, 0);
+    DCHECK_LE(occluded_percent, 100);
+    TileBinVector tiles;
+    CreateBinTiles(tile_count, NOW_BIN, &tiles);
+    if (occluded_percent > 0) {
+      TilePriority occluded_priority = TilePriorityForNowBin();
+      occluded_priority.is_occluded = true;
+      for (unsigned i = 0; i < tile_count; i += 100 / occluded_percent) {
+        Tile* tile = tiles[i].first.get();
+        tile->SetPriority(ACTIVE_TREE, occluded_priority);
+        tile->SetPriority(PENDING_TREE, occluded_priority);
+      }
+    }
+
+    timer_.Reset();
+    do {
+      tile_manager_->AssignMemoryToTiles(GlobalStateForTest());
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    perf_test::PrintResult("assign_occluded_tiles",
+                           "",
+                           test_name,
+                           timer_.LapsPerSecond(),
+                           "runs/s",
+                           true);
+    perf_test::PrintResult("occluded_tiles_skipped",
+                           "",
+                           test_name,
+                           tile_manager_->occluded_tile_count(),
+                           "tiles",
+                           true);
+    perf_test::PrintResult("tiles_for_raster",
+                           "",
+                           test_name,
+                           tile_manager_->tiles_for_raster.size(),
+                           "tiles",
+                           true);
+  }
+
  private:
   FakeTileManagerClient tile_manager_client_;
   LayerTreeSettings settings_;
@@ -186,6 +229,13 @@ TEST_F(TileManagerPerfTest, ManageTiles) {
   RunManageTilesTest("10000_100", 10000, 100);
 }
 
+TEST_F(TileManagerPerfTest, AssignOccludedTiles) {
+  RunAssignOccludedTilesTest("1000_0", 1000, 0);
+  RunAssignOccludedTilesTest("1000_10", 1000, 10);
+  RunAssignOccludedTilesTest("1000_50", 1000, 50);
+  RunAssignOccludedTilesTest("1000_100", 1000, 100);
+}
+
 }  // namespace
 
 }  // namespace cc
@@ -166,6 +166,25 @@ TEST_P(TileManagerTest, EnoughMemoryAllowAnything) {
   EXPECT_EQ(0, AssignedMemoryCount(never_bin));
 }
 
+TEST_P(TileManagerTest, OccludedTilesAreNotRastered) {
+  Initialize(10, ALLOW_ANYTHING, SAME_PRIORITY_FOR_BOTH_TREES);
+  TilePriority occluded_now = TilePriorityForNowBin();
+  occluded_now.is_occluded = true;
+
+  TileVector occluded_on_both = CreateTiles(3, occluded_now, occluded_now);
+  TileVector occluded_on_active =
+      CreateTiles(3, occluded_now, TilePriorityForNowBin());
+  TileVector occluded_on_pending =
+      CreateTiles(3, TilePriorityForNowBin(), occluded_now);
+
+  tile_manager()->AssignMemoryToTiles(global_state_);
+
+  EXPECT_EQ(0, AssignedMemoryCount(occluded_on_both));
+  EXPECT_EQ(3, AssignedMemoryCount(occluded_on_active));
+  EXPECT_EQ(3, AssignedMemoryCount(occluded_on_pending));
+  EXPECT_EQ(3u, tile_manager()->occluded_tile_count());
+}
+
 TEST_P(TileManagerTest, EnoughMemoryAllowPrepaintOnly) {
   // A few tiles of each type of priority, with enough memory for all tiles,
   // with the exception of never bin.
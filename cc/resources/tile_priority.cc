@@ -59,6 +59,7 @@ scoped_ptr<base::Value> TilePriority::AsValue() const {
   state->Set("priority_bin", TilePriorityBinAsValue(priority_bin).release());
   state->Set("distance_to_visible",
              MathUtil::AsValueSafely(distance_to_visible).release());
+  state->SetBoolean("is_occluded", is_occluded);
   return state.PassAs<base::Value>();
 }
 
@@ -47,7 +47,8 @@ struct CC_EXPORT TilePriority {
       : resolution(NON_IDEAL_RESOLUTION),
         required_for_activation(false),
         priority_bin(EVENTUALLY),
-        distance_to_visible(std::numeric_limits<float>::infinity()) {}
+        distance_to_visible(std::numeric_limits<float>::infinity()),
+        is_occluded(false) {}
 
   TilePriority(TileResolution resolution,
                PriorityBin bin,
@@ -55,7 +56,8 @@ struct CC_EXPORT TilePriority {
       : resolution(resolution),
         required_for_activation(false),
         priority_bin(bin),
-        distance_to_visible(distance_to_visible) {}
+        distance_to_visible(distance_to_visible),
+        is_occluded(false) {}
 
   TilePriority(const TilePriority& active, const TilePriority& pending) {
     if (active.resolution == HIGH_RESOLUTION ||
@@ -70,6 +72,8 @@ struct CC_EXPORT TilePriority {
     required_for_activation =
         active.required_for_activation || pending.required_for_activation;
 
+    is_occluded = active.is_occluded && pending.is_occluded;
+
     if (active.priority_bin < pending.priority_bin) {
       priority_bin = active.priority_bin;
       distance_to_visible = active.distance_to_visible;
@@ -89,7 +93,8 @@ struct CC_EXPORT TilePriority {
     return resolution == other.resolution &&
            priority_bin == other.priority_bin &&
            distance_to_visible == other.distance_to_visible &&
-           required_for_activation == other.required_for_activation;
+           required_for_activation == other.required_for_activation &&
+           is_occluded == other.is_occluded;
   }
 
   bool operator !=(const TilePriority& other) const {
@@ -100,6 +105,8 @@ struct CC_EXPORT TilePriority {
   bool required_for_activation;
   PriorityBin priority_bin;
   float distance_to_visible;
+  // True if the visible part of the tile is hidden behind opaque content.
+  bool is_occluded;
 };
 
 scoped_ptr<base::Value> TilePriorityBinAsValue(TilePriority::PriorityBin bin);
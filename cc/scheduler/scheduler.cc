@@ -223,6 +223,15 @@ void Scheduler::BeginImplFrame(const BeginFrameArgs& args) {
             CanCommitAndActivateBeforeDeadline());
   }
 
+  if (settings_.main_frame_before_activation_enabled) {
+    // Starting the next main frame while the pending tree activates only
+    // helps if the main thread would still be busy once the activation is
+    // done. Otherwise it would sit blocked on a frame with older input.
+    state_machine_.SetSkipBeginMainFrameBeforeActivation(
+        client_->BeginMainFrameToCommitDurationEstimate() <
+        client_->CommitToActivateDurationEstimate());
+  }
+
   ProcessScheduledActions();
 
   if (!state_machine_.HasInitializedOutputSurface())
@@ -12,7 +12,8 @@ SchedulerSettings::SchedulerSettings()
       maximum_number_of_failed_draws_before_draw_is_forced_(3),
       using_synchronous_renderer_compositor(false),
       throttle_frame_production(true),
-      switch_to_low_latency_if_possible(false) {}
+      switch_to_low_latency_if_possible(false),
+      main_frame_before_activation_enabled(false) {}
 
 SchedulerSettings::~SchedulerSettings() {}
 
@@ -20,6 +20,7 @@ class CC_EXPORT SchedulerSettings {
   bool using_synchronous_renderer_compositor;
   bool throttle_frame_production;
   bool switch_to_low_latency_if_possible;
+  bool main_frame_before_activation_enabled;
 };
 
 }  // namespace cc
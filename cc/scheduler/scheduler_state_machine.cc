@@ -43,7 +43,8 @@ SchedulerStateMachine::SchedulerStateMachine(const SchedulerSettings& settings)
       draw_if_possible_failed_(false),
       did_create_and_initialize_first_output_surface_(false),
       smoothness_takes_priority_(false),
-      skip_begin_main_frame_to_reduce_latency_(false) {}
+      skip_begin_main_frame_to_reduce_latency_(false),
+      skip_begin_main_frame_before_activation_(false) {}
 
 const char* SchedulerStateMachine::OutputSurfaceStateToString(
     OutputSurfaceState state) {
@@ -266,6 +267,8 @@ scoped_ptr<base::Value> SchedulerStateMachine::AsValue() const  {
                           MainThreadIsInHighLatencyMode());
   minor_state->SetBoolean("skip_begin_main_frame_to_reduce_latency",
                           skip_begin_main_frame_to_reduce_latency_);
+  minor_state->SetBoolean("skip_begin_main_frame_before_activation",
+                          skip_begin_main_frame_before_activation_);
   state->Set("minor_state", minor_state.release());
 
   return state.PassAs<base::Value>();
@@ -456,8 +459,9 @@ bool SchedulerStateMachine::ShouldSendBeginMainFrame() const {
   if (commit_state_ != COMMIT_STATE_IDLE)
     return false;
 
-  // We can't accept a commit if we have a pending tree.
-  if (has_pending_tree_)
+  // We can't accept a commit if we have a pending tree, but the main thread
+  // may start on the next one while the pending tree activates.
+  if (has_pending_tree_ && !CanBeginMainFrameBeforeActivation())
     return false;
 
   // We want to handle readback commits immediately to unblock the main thread.
@@ -505,7 +509,30 @@ bool SchedulerStateMachine::ShouldSendBeginMainFrame() const {
 }
 
 bool SchedulerStateMachine::ShouldCommit() const {
-  return commit_state_ == COMMIT_STATE_READY_TO_COMMIT;
+  if (commit_state_ != COMMIT_STATE_READY_TO_COMMIT)
+    return false;
+
+  // A BeginMainFrame sent before the pending tree activated can only commit
+  // once the pending tree is gone.
+  if (has_pending_tree_) {
+    DCHECK(settings_.main_frame_before_activation_enabled);
+    return false;
+  }
+
+  return true;
+}
+
+bool SchedulerStateMachine::CanBeginMainFrameBeforeActivation() const {
+  if (!settings_.main_frame_before_activation_enabled)
+    return false;
+
+  if (skip_begin_main_frame_before_activation_)
+    return false;
+
+  // Readbacks and forced redraws need the commit they wait for to be drawn
+  // before the next one starts.
+  return readback_state_ == READBACK_STATE_IDLE &&
+         forced_redraw_state_ == FORCED_REDRAW_STATE_IDLE;
 }
 
 bool SchedulerStateMachine::IsCommitStateWaiting() const {
@@ -578,7 +605,7 @@ void SchedulerStateMachine::UpdateState(Action action) {
       return;
 
     case ACTION_SEND_BEGIN_MAIN_FRAME:
-      DCHECK(!has_pending_tree_);
+      DCHECK(!has_pending_tree_ || CanBeginMainFrameBeforeActivation());
       DCHECK(visible_ ||
              readback_state_ == READBACK_STATE_NEEDS_BEGIN_MAIN_FRAME);
       commit_state_ = COMMIT_STATE_FRAME_IN_PROGRESS;
@@ -636,8 +663,13 @@ void SchedulerStateMachine::UpdateStateOnCommit(bool commit_was_aborted) {
   commit_count_++;
 
   // If we are impl-side-painting but the commit was aborted, then we behave
-  // mostly as if we are not impl-side-painting since there is no pending tree.
-  has_pending_tree_ = settings_.impl_side_painting && !commit_was_aborted;
+  // mostly as if we are not impl-side-painting since there is no new pending
+  // tree. An aborted BeginMainFrame that was sent before the pending tree
+  // activated leaves that tree alone.
+  if (!commit_was_aborted)
+    has_pending_tree_ = settings_.impl_side_painting;
+  else if (!settings_.main_frame_before_activation_enabled)
+    has_pending_tree_ = false;
 
   // Update state related to readbacks.
   if (readback_state_ == READBACK_STATE_WAITING_FOR_COMMIT) {
@@ -681,10 +713,17 @@ void SchedulerStateMachine::UpdateStateOnCommit(bool commit_was_aborted) {
   }
 
   // Update the commit state. We expect and wait for a draw if the commit
-  // was not aborted or if we are in a readback or forced draw.
+  // was not aborted or if we are in a readback or forced draw. When the next
+  // BeginMainFrame may be sent before activation, the new pending tree does
+  // not hold it back.
   if (!commit_was_aborted) {
     DCHECK(commit_state_ == COMMIT_STATE_READY_TO_COMMIT);
-    commit_state_ = COMMIT_STATE_WAITING_FOR_FIRST_DRAW;
+    if (has_pending_tree_ && settings_.main_frame_before_activation_enabled &&
+        readback_state_ == READBACK_STATE_IDLE &&
+        forced_redraw_state_ == FORCED_REDRAW_STATE_IDLE)
+      commit_state_ = COMMIT_STATE_IDLE;
+    else
+      commit_state_ = COMMIT_STATE_WAITING_FOR_FIRST_DRAW;
   } else if (readback_state_ != READBACK_STATE_IDLE ||
              forced_redraw_state_ != FORCED_REDRAW_STATE_IDLE) {
     commit_state_ = COMMIT_STATE_WAITING_FOR_FIRST_DRAW;
@@ -702,8 +741,11 @@ void SchedulerStateMachine::UpdateStateOnCommit(bool commit_was_aborted) {
     active_tree_needs_first_draw_ = true;
   }
 
-  // This post-commit work is common to both completed and aborted commits.
-  pending_tree_is_ready_for_activation_ = false;
+  // This post-commit work is common to both completed and aborted commits,
+  // except that an aborted commit keeps the readiness of the pending tree it
+  // left alone.
+  if (!has_pending_tree_ || !commit_was_aborted)
+    pending_tree_is_ready_for_activation_ = false;
 
   if (draw_if_possible_failed_)
     last_frame_number_swap_performed_ = -1;
@@ -783,6 +825,10 @@ void SchedulerStateMachine::SetSkipBeginMainFrameToReduceLatency(bool skip) {
   skip_begin_main_frame_to_reduce_latency_ = skip;
 }
 
+void SchedulerStateMachine::SetSkipBeginMainFrameBeforeActivation(bool skip) {
+  skip_begin_main_frame_before_activation_ = skip;
+}
+
 bool SchedulerStateMachine::BeginImplFrameNeeded() const {
   // Proactive BeginImplFrames are bad for the synchronous compositor because we
   // have to draw when we get the BeginImplFrame and could end up drawing many
@@ -216,6 +216,11 @@ class CC_EXPORT SchedulerStateMachine {
 
   void SetSkipBeginMainFrameToReduceLatency(bool skip);
 
+  // With main_frame_before_activation_enabled, indicates whether to hold
+  // the next BeginMainFrame until the pending tree activates, rather than
+  // letting the main thread work on it in the meantime.
+  void SetSkipBeginMainFrameBeforeActivation(bool skip);
+
   // Indicates whether drawing would, at this time, make sense.
   // CanDraw can be used to suppress flashes or checkerboarding
   // when such behavior would be undesirable.
@@ -255,6 +260,10 @@ class CC_EXPORT SchedulerStateMachine {
   bool ShouldCommit() const;
   bool ShouldManageTiles() const;
 
+  // True if the next BeginMainFrame may be sent while there is a pending
+  // tree. Its commit still waits for the pending tree to activate.
+  bool CanBeginMainFrameBeforeActivation() const;
+
   void AdvanceCurrentFrameNumber();
   bool HasSentBeginMainFrameThisFrame() const;
   bool HasScheduledManageTilesThisFrame() const;
@@ -305,6 +314,7 @@ class CC_EXPORT SchedulerStateMachine {
   bool did_create_and_initialize_first_output_surface_;
   bool smoothness_takes_priority_;
   bool skip_begin_main_frame_to_reduce_latency_;
+  bool skip_begin_main_frame_before_activation_;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(SchedulerStateMachine);
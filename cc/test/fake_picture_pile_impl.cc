@@ -76,7 +76,7 @@ void FakePicturePileImpl::AddRecordingAt(int x, int y) {
   bounds.Inset(-buffer_pixels(), -buffer_pixels());
 
   scoped_refptr<Picture> picture(
-      Picture::Create(bounds, &client_, tile_grid_info_, true, 0));
+      Picture::Create(bounds, &client_, tile_grid_info_, true, 0, false));
   picture_map_[std::pair<int, int>(x, y)].SetPicture(picture);
   EXPECT_TRUE(HasRecordingAt(x, y));
 
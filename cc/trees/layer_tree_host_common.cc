@@ -1123,6 +1123,7 @@ struct SubtreeGlobals {
   const LayerType* page_scale_application_layer;
   bool can_adjust_raster_scales;
   bool can_render_to_separate_surface;
+  DrawPropertiesCache* draw_properties_cache;
 };
 
 template<typename LayerType>
@@ -1165,6 +1166,627 @@ struct DataForRecursion {
   bool subtree_is_visible_from_ancestor;
 };
 
+// What CalculateDrawPropertiesInternal reads from a LayerImpl itself, as of
+// the last computation that used a DrawPropertiesCache.
+struct CachedLayerInputs {
+  CachedLayerInputs()
+      : anchor_point_z(0.f),
+        opacity(0.f),
+        blend_mode(SkXfermode::kSrcOver_Mode),
+        mask_layer(NULL),
+        replica_layer(NULL),
+        replica_mask_layer(NULL),
+        num_descendants_that_draw_content(0),
+        num_unclipped_descendants(0),
+        opacity_is_animating(false),
+        transform_is_animating(false),
+        scrollable(false),
+        is_container_for_fixed_position_layers(false),
+        hide_layer_and_subtree(false),
+        draws_content(false),
+        has_delegated_content(false),
+        can_accept_input(false),
+        double_sided(false),
+        use_parent_backface_visibility(false),
+        should_flatten_transform(false),
+        is_3d_sorted(false),
+        masks_to_bounds(false),
+        force_render_surface(false),
+        is_root_for_isolated_group(false) {}
+
+  gfx::Size bounds;
+  gfx::PointF position;
+  gfx::PointF anchor_point;
+  float anchor_point_z;
+  gfx::Transform transform;
+  gfx::Vector2dF total_scroll_offset;
+  gfx::Vector2dF scroll_delta;
+  float opacity;
+  SkXfermode::Mode blend_mode;
+  FilterOperations filters;
+  FilterOperations background_filters;
+  LayerPositionConstraint position_constraint;
+  LayerImpl* mask_layer;
+  LayerImpl* replica_layer;
+  LayerImpl* replica_mask_layer;
+  gfx::PointF replica_position;
+  gfx::PointF replica_anchor_point;
+  gfx::Transform replica_transform;
+  int num_descendants_that_draw_content;
+  int num_unclipped_descendants;
+  bool opacity_is_animating;
+  bool transform_is_animating;
+  bool scrollable;
+  bool is_container_for_fixed_position_layers;
+  bool hide_layer_and_subtree;
+  bool draws_content;
+  bool has_delegated_content;
+  bool can_accept_input;
+  bool double_sided;
+  bool use_parent_backface_visibility;
+  bool should_flatten_transform;
+  bool is_3d_sorted;
+  bool masks_to_bounds;
+  bool force_render_surface;
+  bool is_root_for_isolated_group;
+  std::vector<LayerImpl*> children;
+};
+
+struct DrawPropertiesCache::Entry {
+  Entry()
+      : subtree_can_be_reused(false),
+        subtree_size(0),
+        has_result(false),
+        updated_contents_scale(false),
+        visited_children(false),
+        ideal_contents_scale(0.f),
+        page_scale_factor(0.f),
+        animating_transform_to_screen(false),
+        parent_draw_opacity(0.f),
+        parent_draw_opacity_is_animating(false),
+        parent_screen_space_opacity_is_animating(false),
+        parent_draw_transform_is_animating(false),
+        parent_screen_space_transform_is_animating(false),
+        render_target(NULL),
+        render_target_is_clipped(false) {
+    data_from_ancestor.fixed_container = NULL;
+    data_from_ancestor.ancestor_clips_subtree = false;
+    data_from_ancestor.nearest_occlusion_immune_ancestor_surface = NULL;
+    data_from_ancestor.in_subtree_of_page_scale_application_layer = false;
+    data_from_ancestor.subtree_can_use_lcd_text = false;
+    data_from_ancestor.subtree_is_visible_from_ancestor = false;
+  }
+
+  CachedLayerInputs inputs;
+
+  // Whether the current computation can replay the subtree, and how many
+  // layers that saves visiting. Set before the computation starts.
+  bool subtree_can_be_reused;
+  size_t subtree_size;
+
+  // Whether the rest of the entry holds the last computation of the subtree,
+  // and neither the layer nor its ancestors have changed since.
+  bool has_result;
+
+  // How far the last computation of the layer itself got, and what it
+  // computed the contents scale from.
+  bool updated_contents_scale;
+  bool visited_children;
+  float ideal_contents_scale;
+  float page_scale_factor;
+  bool animating_transform_to_screen;
+
+  // What the subtree's ancestors passed down to it.
+  DataForRecursion<LayerImpl> data_from_ancestor;
+  float parent_draw_opacity;
+  bool parent_draw_opacity_is_animating;
+  bool parent_screen_space_opacity_is_animating;
+  bool parent_draw_transform_is_animating;
+  bool parent_screen_space_transform_is_animating;
+  LayerImpl* render_target;
+  bool render_target_is_clipped;
+  gfx::Rect render_target_clip_rect;
+  // Only kept when the render target is clipped; see BeginRecordingSubtree.
+  gfx::Rect accumulated_rect_before;
+
+  // What the subtree added to the layer lists, and the drawable content rect
+  // accumulated for its render target afterwards.
+  LayerImplList descendants_added;
+  LayerImplList render_surfaces_added;
+  gfx::Rect accumulated_rect_after;
+};
+
+struct DrawPropertiesCache::Globals {
+  Globals()
+      : has_values(false),
+        can_reuse_results(false),
+        max_texture_size(0),
+        device_scale_factor(0.f),
+        page_scale_factor(0.f),
+        page_scale_application_layer(NULL),
+        can_adjust_raster_scales(false),
+        can_render_to_separate_surface(false),
+        is_pending_tree(false) {}
+
+  bool has_values;
+  // Whether the current computation has the same globals as the last one.
+  bool can_reuse_results;
+
+  int max_texture_size;
+  float device_scale_factor;
+  float page_scale_factor;
+  const LayerImpl* page_scale_application_layer;
+  bool can_adjust_raster_scales;
+  bool can_render_to_separate_surface;
+  bool is_pending_tree;
+};
+
+DrawPropertiesCache::Stats::Stats()
+    : layers_computed(0), layers_reused(0), verification_failures(0) {}
+
+DrawPropertiesCache::DrawPropertiesCache()
+    : globals_(new Globals), verify_against_full_computation_(false) {}
+
+DrawPropertiesCache::~DrawPropertiesCache() {}
+
+void DrawPropertiesCache::RemoveLayer(int layer_id) {
+  entries_.erase(layer_id);
+}
+
+DrawPropertiesCache::Entry* DrawPropertiesCache::GetOrCreateEntry(
+    int layer_id) {
+  Entry* entry = entries_.get(layer_id);
+  if (!entry) {
+    entry = new Entry;
+    entries_.add(layer_id, make_scoped_ptr(entry));
+  }
+  return entry;
+}
+
+template <typename T>
+static inline void UpdateCachedValue(const T& value,
+                                     T* cached_value,
+                                     bool* changed) {
+  if (*cached_value == value)
+    return;
+  *cached_value = value;
+  *changed = true;
+}
+
+// Brings |inputs| up to date with |layer|, and returns true if anything
+// changed.
+static bool UpdateCachedLayerInputs(LayerImpl* layer,
+                                    CachedLayerInputs* inputs) {
+  bool changed = false;
+  UpdateCachedValue(layer->bounds(), &inputs->bounds, &changed);
+  UpdateCachedValue(layer->position(), &inputs->position, &changed);
+  UpdateCachedValue(layer->anchor_point(), &inputs->anchor_point, &changed);
+  UpdateCachedValue(
+      layer->anchor_point_z(), &inputs->anchor_point_z, &changed);
+  UpdateCachedValue(layer->transform(), &inputs->transform, &changed);
+  UpdateCachedValue(
+      layer->TotalScrollOffset(), &inputs->total_scroll_offset, &changed);
+  UpdateCachedValue(layer->ScrollDelta(), &inputs->scroll_delta, &changed);
+  UpdateCachedValue(layer->opacity(), &inputs->opacity, &changed);
+  UpdateCachedValue(layer->blend_mode(), &inputs->blend_mode, &changed);
+  UpdateCachedValue(layer->filters(), &inputs->filters, &changed);
+  UpdateCachedValue(
+      layer->background_filters(), &inputs->background_filters, &changed);
+  UpdateCachedValue(
+      layer->position_constraint(), &inputs->position_constraint, &changed);
+  UpdateCachedValue(layer->mask_layer(), &inputs->mask_layer, &changed);
+
+  LayerImpl* replica_layer = layer->replica_layer();
+  UpdateCachedValue(replica_layer, &inputs->replica_layer, &changed);
+  if (replica_layer) {
+    UpdateCachedValue(
+        replica_layer->mask_layer(), &inputs->replica_mask_layer, &changed);
+    UpdateCachedValue(
+        replica_layer->position(), &inputs->replica_position, &changed);
+    UpdateCachedValue(replica_layer->anchor_point(),
+                      &inputs->replica_anchor_point,
+                      &changed);
+    UpdateCachedValue(
+        replica_layer->transform(), &inputs->replica_transform, &changed);
+  }
+
+  UpdateCachedValue(layer->draw_properties().num_descendants_that_draw_content,
+                    &inputs->num_descendants_that_draw_content,
+                    &changed);
+  UpdateCachedValue(layer->draw_properties().num_unclipped_descendants,
+                    &inputs->num_unclipped_descendants,
+                    &changed);
+  UpdateCachedValue(
+      layer->OpacityIsAnimating(), &inputs->opacity_is_animating, &changed);
+  UpdateCachedValue(
+      layer->TransformIsAnimating(), &inputs->transform_is_animating, &changed);
+  UpdateCachedValue(layer->scrollable(), &inputs->scrollable, &changed);
+  UpdateCachedValue(layer->IsContainerForFixedPositionLayers(),
+                    &inputs->is_container_for_fixed_position_layers,
+                    &changed);
+  UpdateCachedValue(layer->hide_layer_and_subtree(),
+                    &inputs->hide_layer_and_subtree,
+                    &changed);
+  UpdateCachedValue(layer->DrawsContent(), &inputs->draws_content, &changed);
+  UpdateCachedValue(
+      layer->HasDelegatedContent(), &inputs->has_delegated_content, &changed);
+  bool can_accept_input = !layer->touch_event_handler_region().IsEmpty() ||
+                          layer->have_wheel_event_handlers();
+  UpdateCachedValue(can_accept_input, &inputs->can_accept_input, &changed);
+  UpdateCachedValue(layer->double_sided(), &inputs->double_sided, &changed);
+  UpdateCachedValue(layer->use_parent_backface_visibility(),
+                    &inputs->use_parent_backface_visibility,
+                    &changed);
+  UpdateCachedValue(layer->should_flatten_transform(),
+                    &inputs->should_flatten_transform,
+                    &changed);
+  UpdateCachedValue(layer->is_3d_sorted(), &inputs->is_3d_sorted, &changed);
+  UpdateCachedValue(
+      layer->masks_to_bounds(), &inputs->masks_to_bounds, &changed);
+  UpdateCachedValue(
+      layer->force_render_surface(), &inputs->force_render_surface, &changed);
+  UpdateCachedValue(layer->is_root_for_isolated_group(),
+                    &inputs->is_root_for_isolated_group,
+                    &changed);
+
+  const OwnedLayerImplList& children = layer->children();
+  if (inputs->children.size() != children.size()) {
+    inputs->children.resize(children.size());
+    changed = true;
+  }
+  for (size_t i = 0; i < children.size(); ++i)
+    UpdateCachedValue(children[i], &inputs->children[i], &changed);
+  return changed;
+}
+
+// Layers whose draw properties depend on layers outside of their subtree, or
+// that add to lists kept outside of it, are always recomputed, and so are
+// their ancestors.
+static bool LayerPreventsSubtreeReuse(LayerImpl* layer) {
+  if (layer->scroll_parent() || layer->scroll_children() ||
+      layer->clip_parent() || layer->clip_children())
+    return true;
+
+  if (layer->draw_properties().layer_or_descendant_has_copy_request)
+    return true;
+
+  if (layer->HasContributingDelegatedRenderPasses())
+    return true;
+
+  // These move with the size of their container.
+  const LayerPositionConstraint& constraint = layer->position_constraint();
+  return constraint.is_fixed_position() &&
+         (constraint.is_fixed_to_right_edge() ||
+          constraint.is_fixed_to_bottom_edge());
+}
+
+// Brings the cache entries of |layer|'s subtree up to date with the layers,
+// and decides which subtrees the coming computation can replay. Returns the
+// entry of |layer|.
+static DrawPropertiesCache::Entry* UpdateCachedSubtrees(
+    LayerImpl* layer,
+    bool ancestor_changed,
+    DrawPropertiesCache* cache) {
+  DrawPropertiesCache::Entry* entry = cache->GetOrCreateEntry(layer->id());
+  bool changed = UpdateCachedLayerInputs(layer, &entry->inputs) ||
+                 ancestor_changed;
+  if (changed)
+    entry->has_result = false;
+  entry->subtree_can_be_reused =
+      entry->has_result && !LayerPreventsSubtreeReuse(layer);
+  entry->subtree_size = 1;
+
+  for (size_t i = 0; i < layer->children().size(); ++i) {
+    DrawPropertiesCache::Entry* child_entry =
+        UpdateCachedSubtrees(layer->children()[i], changed, cache);
+    // Children that the last computation did not get to do not affect what
+    // it computed.
+    if (!entry->visited_children)
+      continue;
+    entry->subtree_can_be_reused =
+        entry->subtree_can_be_reused && child_entry->subtree_can_be_reused;
+    entry->subtree_size += child_entry->subtree_size;
+  }
+  return entry;
+}
+
+static void PrepareDrawPropertiesCache(
+    LayerImpl* root_layer,
+    const SubtreeGlobals<LayerImpl>& globals) {
+  DrawPropertiesCache* cache = globals.draw_properties_cache;
+  DrawPropertiesCache::Globals* cached_globals = cache->globals();
+  bool changed = !cached_globals->has_values;
+  UpdateCachedValue(
+      globals.max_texture_size, &cached_globals->max_texture_size, &changed);
+  UpdateCachedValue(globals.device_scale_factor,
+                    &cached_globals->device_scale_factor,
+                    &changed);
+  UpdateCachedValue(
+      globals.page_scale_factor, &cached_globals->page_scale_factor, &changed);
+  UpdateCachedValue(globals.page_scale_application_layer,
+                    &cached_globals->page_scale_application_layer,
+                    &changed);
+  UpdateCachedValue(globals.can_adjust_raster_scales,
+                    &cached_globals->can_adjust_raster_scales,
+                    &changed);
+  UpdateCachedValue(globals.can_render_to_separate_surface,
+                    &cached_globals->can_render_to_separate_surface,
+                    &changed);
+  UpdateCachedValue(root_layer->layer_tree_impl()->IsPendingTree(),
+                    &cached_globals->is_pending_tree,
+                    &changed);
+  cached_globals->has_values = true;
+  cached_globals->can_reuse_results = !changed;
+
+  cache->mutable_stats()->layers_computed = 0;
+  cache->mutable_stats()->layers_reused = 0;
+  UpdateCachedSubtrees(root_layer, false, cache);
+}
+
+static inline DrawPropertiesCache::Entry* BeginCachedLayer(
+    Layer* layer,
+    const SubtreeGlobals<Layer>& globals) {
+  return NULL;
+}
+
+static inline DrawPropertiesCache::Entry* BeginCachedLayer(
+    LayerImpl* layer,
+    const SubtreeGlobals<LayerImpl>& globals) {
+  DrawPropertiesCache* cache = globals.draw_properties_cache;
+  if (!cache)
+    return NULL;
+  DrawPropertiesCache::Entry* entry = cache->GetEntry(layer->id());
+  DCHECK(entry);
+  entry->updated_contents_scale = false;
+  entry->visited_children = false;
+  cache->mutable_stats()->layers_computed++;
+  return entry;
+}
+
+// Brings what |entry| holds about the state |layer|'s ancestors pass down to
+// it up to date, and returns true if anything changed.
+static bool UpdateCachedAncestorState(
+    LayerImpl* layer,
+    const DataForRecursion<LayerImpl>& data_from_ancestor,
+    const AccumulatedSurfaceState<LayerImpl>& target_state,
+    DrawPropertiesCache::Entry* entry) {
+  bool changed = false;
+  DataForRecursion<LayerImpl>* cached_data = &entry->data_from_ancestor;
+  UpdateCachedValue(data_from_ancestor.parent_matrix,
+                    &cached_data->parent_matrix,
+                    &changed);
+  UpdateCachedValue(data_from_ancestor.full_hierarchy_matrix,
+                    &cached_data->full_hierarchy_matrix,
+                    &changed);
+  UpdateCachedValue(data_from_ancestor.scroll_compensation_matrix,
+                    &cached_data->scroll_compensation_matrix,
+                    &changed);
+  UpdateCachedValue(data_from_ancestor.fixed_container,
+                    &cached_data->fixed_container,
+                    &changed);
+  UpdateCachedValue(data_from_ancestor.clip_rect_in_target_space,
+                    &cached_data->clip_rect_in_target_space,
+                    &changed);
+  UpdateCachedValue(
+      data_from_ancestor.clip_rect_of_target_surface_in_target_space,
+      &cached_data->clip_rect_of_target_surface_in_target_space,
+      &changed);
+  UpdateCachedValue(data_from_ancestor.ancestor_clips_subtree,
+                    &cached_data->ancestor_clips_subtree,
+                    &changed);
+  UpdateCachedValue(
+      data_from_ancestor.nearest_occlusion_immune_ancestor_surface,
+      &cached_data->nearest_occlusion_immune_ancestor_surface,
+      &changed);
+  UpdateCachedValue(
+      data_from_ancestor.in_subtree_of_page_scale_application_layer,
+      &cached_data->in_subtree_of_page_scale_application_layer,
+      &changed);
+  UpdateCachedValue(data_from_ancestor.subtree_can_use_lcd_text,
+                    &cached_data->subtree_can_use_lcd_text,
+                    &changed);
+  UpdateCachedValue(data_from_ancestor.subtree_is_visible_from_ancestor,
+                    &cached_data->subtree_is_visible_from_ancestor,
+                    &changed);
+
+  LayerImpl* parent = layer->parent();
+  UpdateCachedValue(
+      parent->draw_opacity(), &entry->parent_draw_opacity, &changed);
+  UpdateCachedValue(parent->draw_opacity_is_animating(),
+                    &entry->parent_draw_opacity_is_animating,
+                    &changed);
+  UpdateCachedValue(parent->screen_space_opacity_is_animating(),
+                    &entry->parent_screen_space_opacity_is_animating,
+                    &changed);
+  UpdateCachedValue(parent->draw_transform_is_animating(),
+                    &entry->parent_draw_transform_is_animating,
+                    &changed);
+  UpdateCachedValue(parent->screen_space_transform_is_animating(),
+                    &entry->parent_screen_space_transform_is_animating,
+                    &changed);
+
+  LayerImpl* render_target = parent->render_target();
+  DCHECK_EQ(render_target, target_state.render_target);
+  UpdateCachedValue(render_target, &entry->render_target, &changed);
+  UpdateCachedValue(render_target->is_clipped(),
+                    &entry->render_target_is_clipped,
+                    &changed);
+  UpdateCachedValue(render_target->clip_rect(),
+                    &entry->render_target_clip_rect,
+                    &changed);
+  if (entry->render_target_is_clipped) {
+    UpdateCachedValue(target_state.drawable_content_rect,
+                      &entry->accumulated_rect_before,
+                      &changed);
+  }
+  return changed;
+}
+
+// Calls CalculateContentsScale again for the layers of a subtree that is being
+// replayed, as picture layers rely on that to manage their tilings every
+// frame. Returns false if any layer's contents scale or content bounds
+// changed, in which case the subtree has to be recomputed.
+static bool UpdateContentsScalesForReplay(
+    LayerImpl* layer,
+    const SubtreeGlobals<LayerImpl>& globals) {
+  DrawPropertiesCache::Entry* entry =
+      globals.draw_properties_cache->GetEntry(layer->id());
+  if (!entry->updated_contents_scale)
+    return true;
+
+  float contents_scale_x = layer->contents_scale_x();
+  float contents_scale_y = layer->contents_scale_y();
+  gfx::Size content_bounds = layer->content_bounds();
+  UpdateLayerContentsScale(layer,
+                           globals.can_adjust_raster_scales,
+                           entry->ideal_contents_scale,
+                           globals.device_scale_factor,
+                           entry->page_scale_factor,
+                           entry->animating_transform_to_screen);
+  if (layer->contents_scale_x() != contents_scale_x ||
+      layer->contents_scale_y() != contents_scale_y ||
+      layer->content_bounds() != content_bounds)
+    return false;
+
+  if (!entry->visited_children)
+    return true;
+  for (size_t i = 0; i < layer->children().size(); ++i) {
+    if (!UpdateContentsScalesForReplay(layer->children()[i], globals))
+      return false;
+  }
+  return true;
+}
+
+static inline bool ReuseCachedSubtree(
+    Layer* layer,
+    const SubtreeGlobals<Layer>& globals,
+    const DataForRecursion<Layer>& data_from_ancestor,
+    RenderSurfaceLayerList* render_surface_layer_list,
+    RenderSurfaceLayerList* descendants,
+    std::vector<AccumulatedSurfaceState<Layer> >* accumulated_surface_state) {
+  return false;
+}
+
+// Replays the last computation of |layer|'s subtree if that is still valid,
+// and returns true if it did.
+static bool ReuseCachedSubtree(
+    LayerImpl* layer,
+    const SubtreeGlobals<LayerImpl>& globals,
+    const DataForRecursion<LayerImpl>& data_from_ancestor,
+    LayerImplList* render_surface_layer_list,
+    LayerImplList* descendants,
+    std::vector<AccumulatedSurfaceState<LayerImpl> >*
+        accumulated_surface_state) {
+  DrawPropertiesCache* cache = globals.draw_properties_cache;
+  if (!cache || !cache->globals()->can_reuse_results)
+    return false;
+
+  DrawPropertiesCache::Entry* entry = cache->GetEntry(layer->id());
+  if (!entry->subtree_can_be_reused)
+    return false;
+
+  AccumulatedSurfaceState<LayerImpl>& target_state =
+      accumulated_surface_state->back();
+  if (UpdateCachedAncestorState(
+          layer, data_from_ancestor, target_state, entry))
+    return false;
+
+  // An ancestor that was dropped from the render surface layer list since
+  // took the render surfaces of its subtree with it.
+  for (size_t i = 0; i < entry->render_surfaces_added.size(); ++i) {
+    if (!entry->render_surfaces_added[i]->render_surface())
+      return false;
+  }
+
+  if (!UpdateContentsScalesForReplay(layer, globals))
+    return false;
+
+  descendants->insert(descendants->end(),
+                      entry->descendants_added.begin(),
+                      entry->descendants_added.end());
+  render_surface_layer_list->insert(render_surface_layer_list->end(),
+                                    entry->render_surfaces_added.begin(),
+                                    entry->render_surfaces_added.end());
+  if (entry->render_target_is_clipped)
+    target_state.drawable_content_rect = entry->accumulated_rect_after;
+  else
+    target_state.drawable_content_rect.Union(entry->accumulated_rect_after);
+
+  cache->mutable_stats()->layers_reused += entry->subtree_size;
+  return true;
+}
+
+static inline void BeginRecordingSubtree(
+    Layer* layer,
+    const SubtreeGlobals<Layer>& globals,
+    const DataForRecursion<Layer>& data_from_ancestor,
+    std::vector<AccumulatedSurfaceState<Layer> >* accumulated_surface_state,
+    gfx::Rect* accumulated_rect_before) {}
+
+static void BeginRecordingSubtree(
+    LayerImpl* layer,
+    const SubtreeGlobals<LayerImpl>& globals,
+    const DataForRecursion<LayerImpl>& data_from_ancestor,
+    std::vector<AccumulatedSurfaceState<LayerImpl> >*
+        accumulated_surface_state,
+    gfx::Rect* accumulated_rect_before) {
+  DrawPropertiesCache* cache = globals.draw_properties_cache;
+  if (!cache)
+    return;
+
+  DrawPropertiesCache::Entry* entry = cache->GetEntry(layer->id());
+  AccumulatedSurfaceState<LayerImpl>& target_state =
+      accumulated_surface_state->back();
+  UpdateCachedAncestorState(layer, data_from_ancestor, target_state, entry);
+
+  // When the render target does not clip, what the subtree adds to the rect
+  // accumulated for it does not depend on what is there already, so that is
+  // set aside and the subtree's part is recorded on its own. Otherwise, the
+  // replay is keyed on the rect the subtree started from.
+  if (!entry->render_target_is_clipped) {
+    *accumulated_rect_before = target_state.drawable_content_rect;
+    target_state.drawable_content_rect = gfx::Rect();
+  }
+}
+
+static inline void EndRecordingSubtree(
+    Layer* layer,
+    const SubtreeGlobals<Layer>& globals,
+    const gfx::Rect& accumulated_rect_before,
+    const RenderSurfaceLayerList& render_surface_layer_list,
+    const RenderSurfaceLayerList& descendants,
+    std::vector<AccumulatedSurfaceState<Layer> >* accumulated_surface_state) {}
+
+static void EndRecordingSubtree(
+    LayerImpl* layer,
+    const SubtreeGlobals<LayerImpl>& globals,
+    const gfx::Rect& accumulated_rect_before,
+    const LayerImplList& render_surface_layer_list,
+    const LayerImplList& descendants,
+    std::vector<AccumulatedSurfaceState<LayerImpl> >*
+        accumulated_surface_state) {
+  DrawPropertiesCache* cache = globals.draw_properties_cache;
+  if (!cache)
+    return;
+
+  DrawPropertiesCache::Entry* entry = cache->GetEntry(layer->id());
+  const DrawProperties<LayerImpl>& draw_properties = layer->draw_properties();
+  entry->descendants_added.assign(
+      descendants.begin() + draw_properties.index_of_first_descendants_addition,
+      descendants.end());
+  entry->render_surfaces_added.assign(
+      render_surface_layer_list.begin() +
+          draw_properties.index_of_first_render_surface_layer_list_addition,
+      render_surface_layer_list.end());
+
+  AccumulatedSurfaceState<LayerImpl>& target_state =
+      accumulated_surface_state->back();
+  entry->accumulated_rect_after = target_state.drawable_content_rect;
+  if (!entry->render_target_is_clipped)
+    target_state.drawable_content_rect.Union(accumulated_rect_before);
+  entry->has_result = true;
+}
+
 template <typename LayerType>
 static LayerType* GetChildContainingLayer(const LayerType& parent,
                                           LayerType* layer) {
@@ -1414,6 +2036,8 @@ static void CalculateDrawPropertiesInternal(
   DCHECK(globals.page_scale_application_layer ||
          (globals.page_scale_factor == 1.f));
 
+  DrawPropertiesCache::Entry* cache_entry = BeginCachedLayer(layer, globals);
+
   DataForRecursion<LayerType> data_for_children;
   typename LayerType::RenderSurfaceType*
       nearest_occlusion_immune_ancestor_surface =
@@ -1544,14 +2168,22 @@ static void CalculateDrawPropertiesInternal(
       ? std::max(combined_transform_scales.x(),
                  combined_transform_scales.y())
       : layer_scale_factors;
+  float page_scale_factor_for_layer =
+      data_from_ancestor.in_subtree_of_page_scale_application_layer ?
+          globals.page_scale_factor : 1.f;
   UpdateLayerContentsScale(
       layer,
       globals.can_adjust_raster_scales,
       ideal_contents_scale,
       globals.device_scale_factor,
-      data_from_ancestor.in_subtree_of_page_scale_application_layer ?
-          globals.page_scale_factor : 1.f,
+      page_scale_factor_for_layer,
       animating_transform_to_screen);
+  if (cache_entry) {
+    cache_entry->updated_contents_scale = true;
+    cache_entry->ideal_contents_scale = ideal_contents_scale;
+    cache_entry->page_scale_factor = page_scale_factor_for_layer;
+    cache_entry->animating_transform_to_screen = animating_transform_to_screen;
+  }
 
   // The draw_transform that gets computed below is effectively the layer's
   // draw_transform, unless the layer itself creates a render_surface. In that
@@ -1894,6 +2526,9 @@ static void CalculateDrawPropertiesInternal(
     data_for_children.subtree_is_visible_from_ancestor = layer_is_drawn;
   }
 
+  if (cache_entry)
+    cache_entry->visited_children = true;
+
   std::vector<LayerType*> sorted_children;
   bool child_order_changed = false;
   if (layer_draw_properties.has_child_with_a_scroll_parent)
@@ -1914,12 +2549,31 @@ static void CalculateDrawPropertiesInternal(
     child->draw_properties().index_of_first_render_surface_layer_list_addition =
         render_surface_layer_list->size();
 
-    CalculateDrawPropertiesInternal<LayerType>(child,
-                                               globals,
-                                               data_for_children,
-                                               render_surface_layer_list,
-                                               &descendants,
-                                               accumulated_surface_state);
+    if (!ReuseCachedSubtree(child,
+                            globals,
+                            data_for_children,
+                            render_surface_layer_list,
+                            &descendants,
+                            accumulated_surface_state)) {
+      gfx::Rect accumulated_rect_before_child;
+      BeginRecordingSubtree(child,
+                            globals,
+                            data_for_children,
+                            accumulated_surface_state,
+                            &accumulated_rect_before_child);
+      CalculateDrawPropertiesInternal<LayerType>(child,
+                                                 globals,
+                                                 data_for_children,
+                                                 render_surface_layer_list,
+                                                 &descendants,
+                                                 accumulated_surface_state);
+      EndRecordingSubtree(child,
+                          globals,
+                          accumulated_rect_before_child,
+                          *render_surface_layer_list,
+                          descendants,
+                          accumulated_surface_state);
+    }
     if (child->render_surface() &&
         !child->render_surface()->content_rect().IsEmpty()) {
       descendants.push_back(child);
@@ -2105,6 +2759,186 @@ static void CalculateDrawPropertiesInternal(
   }
 }
 
+// The draw properties of a layer and of its render surface, as compared
+// between a computation that used a DrawPropertiesCache and a full one.
+struct VerifiedDrawProperties {
+  explicit VerifiedDrawProperties(LayerImpl* layer)
+      : layer(layer),
+        target_space_transform(layer->draw_transform()),
+        screen_space_transform(layer->screen_space_transform()),
+        opacity(layer->draw_opacity()),
+        opacity_is_animating(layer->draw_opacity_is_animating()),
+        screen_space_opacity_is_animating(
+            layer->screen_space_opacity_is_animating()),
+        target_space_transform_is_animating(
+            layer->draw_transform_is_animating()),
+        screen_space_transform_is_animating(
+            layer->screen_space_transform_is_animating()),
+        can_use_lcd_text(layer->can_use_lcd_text()),
+        is_clipped(layer->is_clipped()),
+        render_target(layer->render_target()),
+        visible_content_rect(layer->visible_content_rect()),
+        drawable_content_rect(layer->drawable_content_rect()),
+        clip_rect(layer->clip_rect()),
+        contents_scale_x(layer->contents_scale_x()),
+        contents_scale_y(layer->contents_scale_y()),
+        content_bounds(layer->content_bounds()),
+        has_render_surface(!!layer->render_surface()),
+        surface_draw_opacity(0.f),
+        surface_is_clipped(false),
+        surface_contributes_to_drawn_surface(false),
+        surface_nearest_occlusion_immune_ancestor(NULL) {
+    RenderSurfaceImpl* surface = layer->render_surface();
+    if (!surface)
+      return;
+    surface_content_rect = surface->content_rect();
+    surface_draw_transform = surface->draw_transform();
+    surface_screen_space_transform = surface->screen_space_transform();
+    surface_replica_draw_transform = surface->replica_draw_transform();
+    surface_replica_screen_space_transform =
+        surface->replica_screen_space_transform();
+    surface_draw_opacity = surface->draw_opacity();
+    surface_is_clipped = surface->is_clipped();
+    surface_clip_rect = surface->clip_rect();
+    surface_contributes_to_drawn_surface =
+        surface->contributes_to_drawn_surface();
+    surface_nearest_occlusion_immune_ancestor =
+        surface->nearest_occlusion_immune_ancestor();
+    surface_layer_list = surface->layer_list();
+  }
+
+  bool Equals(const VerifiedDrawProperties& other) const {
+    DCHECK_EQ(layer, other.layer);
+    return target_space_transform == other.target_space_transform &&
+           screen_space_transform == other.screen_space_transform &&
+           opacity == other.opacity &&
+           opacity_is_animating == other.opacity_is_animating &&
+           screen_space_opacity_is_animating ==
+               other.screen_space_opacity_is_animating &&
+           target_space_transform_is_animating ==
+               other.target_space_transform_is_animating &&
+           screen_space_transform_is_animating ==
+               other.screen_space_transform_is_animating &&
+           can_use_lcd_text == other.can_use_lcd_text &&
+           is_clipped == other.is_clipped &&
+           render_target == other.render_target &&
+           visible_content_rect == other.visible_content_rect &&
+           drawable_content_rect == other.drawable_content_rect &&
+           clip_rect == other.clip_rect &&
+           contents_scale_x == other.contents_scale_x &&
+           contents_scale_y == other.contents_scale_y &&
+           content_bounds == other.content_bounds &&
+           has_render_surface == other.has_render_surface &&
+           surface_content_rect == other.surface_content_rect &&
+           surface_draw_transform == other.surface_draw_transform &&
+           surface_screen_space_transform ==
+               other.surface_screen_space_transform &&
+           surface_replica_draw_transform ==
+               other.surface_replica_draw_transform &&
+           surface_replica_screen_space_transform ==
+               other.surface_replica_screen_space_transform &&
+           surface_draw_opacity == other.surface_draw_opacity &&
+           surface_is_clipped == other.surface_is_clipped &&
+           surface_clip_rect == other.surface_clip_rect &&
+           surface_contributes_to_drawn_surface ==
+               other.surface_contributes_to_drawn_surface &&
+           surface_nearest_occlusion_immune_ancestor ==
+               other.surface_nearest_occlusion_immune_ancestor &&
+           surface_layer_list == other.surface_layer_list;
+  }
+
+  LayerImpl* layer;
+  gfx::Transform target_space_transform;
+  gfx::Transform screen_space_transform;
+  float opacity;
+  bool opacity_is_animating;
+  bool screen_space_opacity_is_animating;
+  bool target_space_transform_is_animating;
+  bool screen_space_transform_is_animating;
+  bool can_use_lcd_text;
+  bool is_clipped;
+  LayerImpl* render_target;
+  gfx::Rect visible_content_rect;
+  gfx::Rect drawable_content_rect;
+  gfx::Rect clip_rect;
+  float contents_scale_x;
+  float contents_scale_y;
+  gfx::Size content_bounds;
+
+  bool has_render_surface;
+  gfx::Rect surface_content_rect;
+  gfx::Transform surface_draw_transform;
+  gfx::Transform surface_screen_space_transform;
+  gfx::Transform surface_replica_draw_transform;
+  gfx::Transform surface_replica_screen_space_transform;
+  float surface_draw_opacity;
+  bool surface_is_clipped;
+  gfx::Rect surface_clip_rect;
+  bool surface_contributes_to_drawn_surface;
+  const RenderSurfaceImpl* surface_nearest_occlusion_immune_ancestor;
+  LayerImplList surface_layer_list;
+};
+
+static void CollectDrawPropertiesForVerification(
+    LayerImpl* layer,
+    std::vector<VerifiedDrawProperties>* draw_properties) {
+  draw_properties->push_back(VerifiedDrawProperties(layer));
+  if (layer->mask_layer())
+    draw_properties->push_back(VerifiedDrawProperties(layer->mask_layer()));
+  if (layer->replica_layer() && layer->replica_layer()->mask_layer()) {
+    draw_properties->push_back(
+        VerifiedDrawProperties(layer->replica_layer()->mask_layer()));
+  }
+  for (size_t i = 0; i < layer->children().size(); ++i) {
+    CollectDrawPropertiesForVerification(layer->children()[i],
+                                         draw_properties);
+  }
+}
+
+// Recomputes the draw properties of the whole tree without replaying any
+// subtree, and reports the layers for which that gives a different result
+// than the computation that just used the cache.
+static void VerifyDrawPropertiesCache(
+    LayerImpl* root_layer,
+    const SubtreeGlobals<LayerImpl>& globals,
+    const DataForRecursion<LayerImpl>& data_for_recursion,
+    LayerImplList* render_surface_layer_list) {
+  DrawPropertiesCache* cache = globals.draw_properties_cache;
+  std::vector<VerifiedDrawProperties> cached_draw_properties;
+  CollectDrawPropertiesForVerification(root_layer, &cached_draw_properties);
+  LayerImplList cached_render_surface_layer_list;
+  cached_render_surface_layer_list.swap(*render_surface_layer_list);
+
+  DrawPropertiesCache::Stats stats = cache->stats();
+  cache->globals()->can_reuse_results = false;
+  LayerImplList dummy_layer_list;
+  std::vector<AccumulatedSurfaceState<LayerImpl> > accumulated_surface_state;
+  CalculateDrawPropertiesInternal<LayerImpl>(root_layer,
+                                             globals,
+                                             data_for_recursion,
+                                             render_surface_layer_list,
+                                             &dummy_layer_list,
+                                             &accumulated_surface_state);
+
+  std::vector<VerifiedDrawProperties> full_draw_properties;
+  CollectDrawPropertiesForVerification(root_layer, &full_draw_properties);
+  DCHECK_EQ(cached_draw_properties.size(), full_draw_properties.size());
+  for (size_t i = 0; i < full_draw_properties.size(); ++i) {
+    if (cached_draw_properties[i].Equals(full_draw_properties[i]))
+      continue;
+    LOG(ERROR) << "Cached draw properties of layer "
+               << full_draw_properties[i].layer->id()
+               << " differ from a full computation";
+    stats.verification_failures++;
+  }
+  if (cached_render_surface_layer_list != *render_surface_layer_list) {
+    LOG(ERROR) << "Cached render surface layer list differs from a full "
+               << "computation";
+    stats.verification_failures++;
+  }
+  *cache->mutable_stats() = stats;
+}
+
 void LayerTreeHostCommon::CalculateDrawProperties(
     CalcDrawPropsMainInputs* inputs) {
   DCHECK(inputs->root_layer);
@@ -2129,6 +2963,7 @@ void LayerTreeHostCommon::CalculateDrawProperties(
   globals.can_render_to_separate_surface =
       inputs->can_render_to_separate_surface;
   globals.can_adjust_raster_scales = inputs->can_adjust_raster_scales;
+  globals.draw_properties_cache = NULL;
 
   DataForRecursion<Layer> data_for_recursion;
   data_for_recursion.parent_matrix = scaled_device_transform;
@@ -2187,6 +3022,7 @@ void LayerTreeHostCommon::CalculateDrawProperties(
   globals.can_render_to_separate_surface =
       inputs->can_render_to_separate_surface;
   globals.can_adjust_raster_scales = inputs->can_adjust_raster_scales;
+  globals.draw_properties_cache = inputs->draw_properties_cache;
 
   DataForRecursion<LayerImpl> data_for_recursion;
   data_for_recursion.parent_matrix = scaled_device_transform;
@@ -2204,6 +3040,8 @@ void LayerTreeHostCommon::CalculateDrawProperties(
 
   PreCalculateMetaInformationRecursiveData recursive_data;
   PreCalculateMetaInformation(inputs->root_layer, &recursive_data);
+  if (globals.draw_properties_cache)
+    PrepareDrawPropertiesCache(inputs->root_layer, globals);
   std::vector<AccumulatedSurfaceState<LayerImpl> >
       accumulated_surface_state;
   CalculateDrawPropertiesInternal<LayerImpl>(inputs->root_layer,
@@ -2212,6 +3050,14 @@ void LayerTreeHostCommon::CalculateDrawProperties(
                                              inputs->render_surface_layer_list,
                                              &dummy_layer_list,
                                              &accumulated_surface_state);
+  if (globals.draw_properties_cache &&
+      globals.draw_properties_cache->verify_against_full_computation() &&
+      globals.draw_properties_cache->globals()->can_reuse_results) {
+    VerifyDrawPropertiesCache(inputs->root_layer,
+                              globals,
+                              data_for_recursion,
+                              inputs->render_surface_layer_list);
+  }
 
   // The dummy layer list should not have been used.
   DCHECK_EQ(0u, dummy_layer_list.size());
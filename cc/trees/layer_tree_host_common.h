@@ -9,7 +9,9 @@
 #include <vector>
 
 #include "base/bind.h"
+#include "base/containers/scoped_ptr_hash_map.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "cc/base/cc_export.h"
 #include "cc/base/scoped_ptr_vector.h"
 #include "cc/layers/layer_lists.h"
@@ -19,6 +21,7 @@
 
 namespace cc {
 
+class DrawPropertiesCache;
 class LayerImpl;
 class Layer;
 
@@ -52,7 +55,8 @@ class CC_EXPORT LayerTreeHostCommon {
           can_use_lcd_text(can_use_lcd_text),
           can_render_to_separate_surface(can_render_to_separate_surface),
           can_adjust_raster_scales(can_adjust_raster_scales),
-          render_surface_layer_list(render_surface_layer_list) {}
+          render_surface_layer_list(render_surface_layer_list),
+          draw_properties_cache(NULL) {}
 
     LayerType* root_layer;
     gfx::Size device_viewport_size;
@@ -65,6 +69,10 @@ class CC_EXPORT LayerTreeHostCommon {
     bool can_render_to_separate_surface;
     bool can_adjust_raster_scales;
     RenderSurfaceLayerListType* render_surface_layer_list;
+    // When set, subtrees that are unchanged since the last computation that
+    // used the cache are replayed instead of recomputed. Only used for
+    // LayerImpl trees.
+    DrawPropertiesCache* draw_properties_cache;
   };
 
   template <typename LayerType, typename RenderSurfaceLayerListType>
@@ -148,6 +156,65 @@ struct CC_EXPORT ScrollAndScaleSet {
   float page_scale_delta;
 };
 
+// Remembers, for each layer of a LayerImpl tree, what CalculateDrawProperties
+// computed for its subtree and from which inputs. When neither the layers of a
+// subtree nor what its ancestors pass down to it have changed since, the
+// subtree's draw properties and render surfaces are left as they are and its
+// contributions to the layer lists are replayed. Only the paths from changed
+// layers to the root, and the subtrees below them, are recomputed.
+//
+// Layers are identified by id, so the cache must only be used with one tree,
+// and must be told when a layer of that tree is destroyed.
+class CC_EXPORT DrawPropertiesCache {
+ public:
+  // These are only used by LayerTreeHostCommon.
+  struct Entry;
+  struct Globals;
+
+  struct Stats {
+    Stats();
+
+    // The number of layers visited by the last computation, and the number
+    // of layers in the subtrees it replayed instead.
+    size_t layers_computed;
+    size_t layers_reused;
+    // The number of layers, over all computations so far, whose replayed
+    // draw properties differed from a full computation.
+    size_t verification_failures;
+  };
+
+  DrawPropertiesCache();
+  ~DrawPropertiesCache();
+
+  // When set, every computation that uses the cache is followed by a full
+  // computation, and the layers whose results differ are logged and counted.
+  // This is a debugging aid, and more than doubles the cost of computing draw
+  // properties.
+  void set_verify_against_full_computation(bool verify) {
+    verify_against_full_computation_ = verify;
+  }
+  bool verify_against_full_computation() const {
+    return verify_against_full_computation_;
+  }
+
+  void RemoveLayer(int layer_id);
+
+  Entry* GetEntry(int layer_id) { return entries_.get(layer_id); }
+  Entry* GetOrCreateEntry(int layer_id);
+  Globals* globals() { return globals_.get(); }
+
+  const Stats& stats() const { return stats_; }
+  Stats* mutable_stats() { return &stats_; }
+
+ private:
+  base::ScopedPtrHashMap<int, Entry> entries_;
+  scoped_ptr<Globals> globals_;
+  bool verify_against_full_computation_;
+  Stats stats_;
+
+  DISALLOW_COPY_AND_ASSIGN(DrawPropertiesCache);
+};
+
 template <typename LayerType>
 bool LayerTreeHostCommon::RenderSurfaceContributesToTarget(
     LayerType* layer,
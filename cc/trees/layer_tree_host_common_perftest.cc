@@ -146,6 +146,64 @@ class CalcDrawPropsImplTest : public LayerTreeHostCommonPerfTest {
   }
 };
 
+// Moves one leaf layer back and forth every lap, and computes draw properties
+// either from scratch or with a DrawPropertiesCache that only recomputes the
+// path to the leaf.
+class CalcDrawPropsImplMovingLeafTest : public LayerTreeHostCommonPerfTest {
+ public:
+  CalcDrawPropsImplMovingLeafTest() : use_cache_(false) {}
+
+  void RunCalcDrawProps(bool use_cache) {
+    use_cache_ = use_cache;
+    RunTestWithImplSidePainting();
+  }
+
+  virtual void BeginTest() OVERRIDE {
+    PostSetNeedsCommitToMainThread();
+  }
+
+  virtual void DrawLayersOnThread(LayerTreeHostImpl* host_impl) OVERRIDE {
+    timer_.Reset();
+    LayerTreeImpl* active_tree = host_impl->active_tree();
+    DrawPropertiesCache cache;
+
+    LayerImpl* leaf = active_tree->root_layer();
+    while (!leaf->children().empty())
+      leaf = leaf->children()[0];
+    gfx::PointF position = leaf->position();
+
+    do {
+      leaf->SetPosition(position + gfx::Vector2dF(timer_.NumLaps() % 2, 0.f));
+
+      bool can_render_to_separate_surface = true;
+      int max_texture_size = 8096;
+      LayerImplList update_list;
+      LayerTreeHostCommon::CalcDrawPropsImplInputs inputs(
+          active_tree->root_layer(),
+          active_tree->DrawViewportSize(),
+          host_impl->DrawTransform(),
+          active_tree->device_scale_factor(),
+          active_tree->total_page_scale_factor(),
+          active_tree->RootContainerLayer(),
+          max_texture_size,
+          host_impl->settings().can_use_lcd_text,
+          can_render_to_separate_surface,
+          host_impl->settings().layer_transforms_should_scale_layer_contents,
+          &update_list);
+      if (use_cache_)
+        inputs.draw_properties_cache = &cache;
+      LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+
+      timer_.NextLap();
+    } while (!timer_.HasTimeLimitExpired());
+
+    EndTest();
+  }
+
+ private:
+  bool use_cache_;
+};
+
 TEST_F(CalcDrawPropsMainTest, TenTen) {
   SetTestName("10_10_main_thread");
   ReadTestFile("10_10_layer_tree");
@@ -194,5 +252,17 @@ TEST_F(CalcDrawPropsImplTest, TouchRegionHeavy) {
   RunCalcDrawProps();
 }
 
+TEST_F(CalcDrawPropsImplMovingLeafTest, HeavyPageFull) {
+  SetTestName("heavy_page_moving_leaf_full");
+  ReadTestFile("heavy_layer_tree");
+  RunCalcDrawProps(false);
+}
+
+TEST_F(CalcDrawPropsImplMovingLeafTest, HeavyPageIncremental) {
+  SetTestName("heavy_page_moving_leaf_incremental");
+  ReadTestFile("heavy_layer_tree");
+  RunCalcDrawProps(true);
+}
+
 }  // namespace
 }  // namespace cc
@@ -9607,5 +9607,130 @@ TEST_F(LayerTreeHostCommonTest, ScrollCompensationWithRounding) {
   }
 }
 
+TEST_F(LayerTreeHostCommonTest, DrawPropertiesCacheReplaysUnchangedSubtrees) {
+  // + root
+  //   + child_a
+  //     + leaf_a
+  //   + child_b (render surface)
+  //     + leaf_b
+  //
+  FakeImplProxy proxy;
+  FakeLayerTreeHostImpl host_impl(&proxy);
+  scoped_ptr<LayerImpl> root = LayerImpl::Create(host_impl.active_tree(), 1);
+  scoped_ptr<LayerImpl> child_a = LayerImpl::Create(host_impl.active_tree(), 2);
+  scoped_ptr<LayerImpl> leaf_a = LayerImpl::Create(host_impl.active_tree(), 3);
+  LayerImpl* leaf_a_layer = leaf_a.get();
+  scoped_ptr<LayerImpl> child_b = LayerImpl::Create(host_impl.active_tree(), 4);
+  LayerImpl* child_b_layer = child_b.get();
+  scoped_ptr<LayerImpl> leaf_b = LayerImpl::Create(host_impl.active_tree(), 5);
+
+  gfx::Transform identity_matrix;
+  SetLayerPropertiesForTesting(root.get(),
+                               identity_matrix,
+                               gfx::PointF(),
+                               gfx::PointF(),
+                               gfx::Size(100, 100),
+                               true,
+                               false);
+  SetLayerPropertiesForTesting(child_a.get(),
+                               identity_matrix,
+                               gfx::PointF(),
+                               gfx::PointF(10.f, 10.f),
+                               gfx::Size(50, 50),
+                               true,
+                               false);
+  SetLayerPropertiesForTesting(leaf_a.get(),
+                               identity_matrix,
+                               gfx::PointF(),
+                               gfx::PointF(5.f, 5.f),
+                               gfx::Size(20, 20),
+                               true,
+                               false);
+  SetLayerPropertiesForTesting(child_b.get(),
+                               identity_matrix,
+                               gfx::PointF(),
+                               gfx::PointF(60.f, 10.f),
+                               gfx::Size(30, 30),
+                               true,
+                               false);
+  SetLayerPropertiesForTesting(leaf_b.get(),
+                               identity_matrix,
+                               gfx::PointF(),
+                               gfx::PointF(),
+                               gfx::Size(20, 20),
+                               true,
+                               false);
+  leaf_a->SetDrawsContent(true);
+  leaf_b->SetDrawsContent(true);
+  child_b->SetForceRenderSurface(true);
+  child_b->SetOpacity(0.5f);
+
+  child_a->AddChild(leaf_a.Pass());
+  child_b->AddChild(leaf_b.Pass());
+  root->AddChild(child_a.Pass());
+  root->AddChild(child_b.Pass());
+
+  DrawPropertiesCache cache;
+  cache.set_verify_against_full_computation(true);
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.draw_properties_cache = &cache;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+
+    EXPECT_EQ(5u, cache.stats().layers_computed);
+    EXPECT_EQ(0u, cache.stats().layers_reused);
+    EXPECT_EQ(2u, render_surface_layer_list.size());
+  }
+
+  // Nothing changed, so only the root is visited.
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.draw_properties_cache = &cache;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+
+    EXPECT_EQ(1u, cache.stats().layers_computed);
+    EXPECT_EQ(4u, cache.stats().layers_reused);
+    ASSERT_EQ(2u, render_surface_layer_list.size());
+    EXPECT_EQ(child_b_layer, render_surface_layer_list[1]);
+    EXPECT_EQ(0u, cache.stats().verification_failures);
+  }
+
+  // Moving a leaf recomputes the path to it, and replays the other subtree.
+  leaf_a_layer->SetPosition(gfx::PointF(7.f, 5.f));
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.draw_properties_cache = &cache;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+
+    EXPECT_EQ(3u, cache.stats().layers_computed);
+    EXPECT_EQ(2u, cache.stats().layers_reused);
+    EXPECT_VECTOR_EQ(gfx::Vector2dF(17.f, 15.f),
+                     leaf_a_layer->screen_space_transform().To2dTranslation());
+    EXPECT_EQ(2u, render_surface_layer_list.size());
+    EXPECT_EQ(0u, cache.stats().verification_failures);
+  }
+
+  // Changing the render surface recomputes its subtree.
+  child_b_layer->SetOpacity(0.25f);
+  {
+    LayerImplList render_surface_layer_list;
+    LayerTreeHostCommon::CalcDrawPropsImplInputsForTesting inputs(
+        root.get(), root->bounds(), &render_surface_layer_list);
+    inputs.draw_properties_cache = &cache;
+    LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+
+    EXPECT_EQ(3u, cache.stats().layers_computed);
+    EXPECT_EQ(2u, cache.stats().layers_reused);
+    EXPECT_FLOAT_EQ(0.25f, child_b_layer->render_surface()->draw_opacity());
+    EXPECT_EQ(0u, cache.stats().verification_failures);
+  }
+}
+
 }  // namespace
 }  // namespace cc
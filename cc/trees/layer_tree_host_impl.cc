@@ -752,6 +752,10 @@ DrawSwapReadbackResult::DrawResult LayerTreeHostImpl::CalculateRenderPasses(
       record_metrics_for_frame);
   occlusion_tracker.set_minimum_tracking_size(
       settings_.minimum_occlusion_tracking_size);
+  // The renderer keeps the contents of render surfaces from frame to frame,
+  // so they have to be drawn whole.
+  occlusion_tracker.set_use_occlusion_from_outside_target(
+      !settings_.cache_render_pass_contents);
 
   if (debug_state_.show_occluding_rects) {
     occlusion_tracker.set_occluding_screen_space_rects_container(
@@ -870,6 +874,18 @@ DrawSwapReadbackResult::DrawResult LayerTreeHostImpl::CalculateRenderPasses(
             DrawSwapReadbackResult::DRAW_ABORTED_MISSING_HIGH_RES_CONTENT;
     }
 
+    // Tiles that finish rasterizing later do not damage the surface they are
+    // in, so a surface the renderer keeps is drawn again until it is complete.
+    if (settings_.cache_render_pass_contents &&
+        (append_quads_data.had_incomplete_tile ||
+         append_quads_data.num_missing_tiles) &&
+        it.target_render_surface_layer()->parent()) {
+      RenderSurfaceImpl* target_surface =
+          it.target_render_surface_layer()->render_surface();
+      target_surface->damage_tracker()->AddDamageNextUpdate(
+          target_surface->content_rect());
+    }
+
     occlusion_tracker.LeaveLayer(it);
   }
 
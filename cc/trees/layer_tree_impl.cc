@@ -17,6 +17,7 @@
 #include "cc/resources/ui_resource_request.h"
 #include "cc/trees/layer_tree_host_common.h"
 #include "cc/trees/layer_tree_host_impl.h"
+#include "cc/trees/occlusion_tracker.h"
 #include "ui/gfx/size_conversions.h"
 #include "ui/gfx/vector2d_conversions.h"
 
@@ -94,7 +95,13 @@ LayerTreeImpl::LayerTreeImpl(LayerTreeHostImpl* layer_tree_host_impl)
       viewport_size_invalid_(false),
       needs_update_draw_properties_(true),
       needs_full_tree_sync_(true),
-      next_activation_forces_redraw_(false) {}
+      next_activation_forces_redraw_(false) {
+  if (settings().incremental_draw_properties) {
+    draw_properties_cache_.reset(new DrawPropertiesCache);
+    draw_properties_cache_->set_verify_against_full_computation(
+        settings().verify_incremental_draw_properties);
+  }
+}
 
 LayerTreeImpl::~LayerTreeImpl() {
   // Need to explicitly clear the tree prior to destroying this so that
@@ -469,7 +476,18 @@ void LayerTreeImpl::UpdateDrawProperties() {
         can_render_to_separate_surface,
         settings().layer_transforms_should_scale_layer_contents,
         &render_surface_layer_list_);
+    inputs.draw_properties_cache = draw_properties_cache_.get();
     LayerTreeHostCommon::CalculateDrawProperties(&inputs);
+    if (draw_properties_cache_) {
+      const DrawPropertiesCache::Stats& stats = draw_properties_cache_->stats();
+      TRACE_COUNTER_ID2("cc",
+                        "DrawPropertiesCache",
+                        this,
+                        "computed",
+                        stats.layers_computed,
+                        "reused",
+                        stats.layers_reused);
+    }
   }
 
   {
@@ -481,22 +499,37 @@ void LayerTreeImpl::UpdateDrawProperties() {
                  source_frame_number_);
     // LayerIterator is used here instead of CallFunctionForSubtree to only
     // UpdateTilePriorities on layers that will be visible (and thus have valid
-    // draw properties) and not because any ordering is required.
+    // draw properties). Its front-to-back order also lets occlusion be
+    // tracked, so that tiles hidden behind opaque layers are not rastered.
+    scoped_ptr<OcclusionTrackerImpl> occlusion_tracker;
+    if (settings().use_occlusion_for_tile_prioritization) {
+      occlusion_tracker.reset(new OcclusionTrackerImpl(
+          root_layer()->render_surface()->content_rect(), false));
+      occlusion_tracker->set_minimum_tracking_size(
+          settings().minimum_occlusion_tracking_size);
+    }
+
     typedef LayerIterator<LayerImpl> LayerIteratorType;
     LayerIteratorType end = LayerIteratorType::End(&render_surface_layer_list_);
     for (LayerIteratorType it =
              LayerIteratorType::Begin(&render_surface_layer_list_);
          it != end;
          ++it) {
-      if (!it.represents_itself())
-        continue;
-      LayerImpl* layer = *it;
+      if (occlusion_tracker)
+        occlusion_tracker->EnterLayer(it);
 
-      layer->UpdateTilePriorities();
-      if (layer->mask_layer())
-        layer->mask_layer()->UpdateTilePriorities();
-      if (layer->replica_layer() && layer->replica_layer()->mask_layer())
-        layer->replica_layer()->mask_layer()->UpdateTilePriorities();
+      LayerImpl* layer = *it;
+      if (it.represents_itself()) {
+        layer->UpdateTilePriorities(occlusion_tracker.get());
+        // Masks are not in the layer list, so occlusion isn't known for them.
+        if (layer->mask_layer())
+          layer->mask_layer()->UpdateTilePriorities(NULL);
+        if (layer->replica_layer() && layer->replica_layer()->mask_layer())
+          layer->replica_layer()->mask_layer()->UpdateTilePriorities(NULL);
+      }
+
+      if (occlusion_tracker)
+        occlusion_tracker->LeaveLayer(it);
     }
   }
 
@@ -532,6 +565,8 @@ void LayerTreeImpl::RegisterLayer(LayerImpl* layer) {
 void LayerTreeImpl::UnregisterLayer(LayerImpl* layer) {
   DCHECK(LayerById(layer->id()));
   layer_id_map_.erase(layer->id());
+  if (draw_properties_cache_)
+    draw_properties_cache_->RemoveLayer(layer->id());
 }
 
 void LayerTreeImpl::PushPersistedState(LayerTreeImpl* pending_tree) {
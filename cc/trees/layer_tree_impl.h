@@ -32,6 +32,7 @@ namespace cc {
 
 class ContextProvider;
 class DebugRectHistory;
+class DrawPropertiesCache;
 class FrameRateCounter;
 class HeadsUpDisplayLayerImpl;
 class LayerScrollOffsetDelegateProxy;
@@ -283,6 +284,9 @@ class CC_EXPORT LayerTreeImpl {
   // frame. Used for rendering and input event hit testing.
   LayerImplList render_surface_layer_list_;
 
+  // Null unless LayerTreeSettings::incremental_draw_properties is set.
+  scoped_ptr<DrawPropertiesCache> draw_properties_cache_;
+
   bool contents_textures_purged_;
   bool requires_high_res_to_draw_;
   bool viewport_size_invalid_;
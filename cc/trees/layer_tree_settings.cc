@@ -59,7 +59,14 @@ LayerTreeSettings::LayerTreeSettings()
       ignore_root_layer_flings(false),
       use_rgba_4444_textures(false),
       touch_hit_testing(true),
-      texture_id_allocation_chunk_size(64) {}
+      texture_id_allocation_chunk_size(64),
+      incremental_draw_properties(false),
+      verify_incremental_draw_properties(false),
+      use_occlusion_for_tile_prioritization(false),
+      share_identical_recordings(false),
+      max_recorded_bytes_per_layer(0),
+      main_frame_before_activation_enabled(false),
+      cache_render_pass_contents(false) {}
 
 LayerTreeSettings::~LayerTreeSettings() {}
 
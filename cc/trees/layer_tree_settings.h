@@ -70,6 +70,13 @@ class CC_EXPORT LayerTreeSettings {
   bool use_rgba_4444_textures;
   bool touch_hit_testing;
   size_t texture_id_allocation_chunk_size;
+  bool incremental_draw_properties;
+  bool verify_incremental_draw_properties;
+  bool use_occlusion_for_tile_prioritization;
+  bool share_identical_recordings;
+  size_t max_recorded_bytes_per_layer;
+  bool main_frame_before_activation_enabled;
+  bool cache_render_pass_contents;
 
   LayerTreeDebugState initial_debug_state;
 };
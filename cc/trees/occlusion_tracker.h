@@ -86,6 +86,12 @@ class CC_EXPORT OcclusionTrackerBase {
     minimum_tracking_size_ = size;
   }
 
+  // When false, nothing outside of a render surface culls the contents of the
+  // surface, so that the contents stay valid if what covers the surface moves.
+  void set_use_occlusion_from_outside_target(bool use) {
+    use_occlusion_from_outside_target_ = use;
+  }
+
   // The following is used for visualization purposes.
   void set_occluding_screen_space_rects_container(
       std::vector<gfx::Rect>* rects) {
@@ -144,6 +150,7 @@ class CC_EXPORT OcclusionTrackerBase {
   gfx::Rect screen_space_clip_rect_;
   scoped_ptr<class OverdrawMetrics> overdraw_metrics_;
   gfx::Size minimum_tracking_size_;
+  bool use_occlusion_from_outside_target_;
 
   // This is used for visualizing the occlusion tracking process.
   std::vector<gfx::Rect>* occluding_screen_space_rects_;
@@ -41,15 +41,28 @@ void ProxyTimingHistory::DidBeginMainFrame() {
   begin_main_frame_sent_time_ = base::TimeTicks::HighResNow();
 }
 
+void ProxyTimingHistory::DidFinishBeginMainFrame() {
+  begin_main_frame_finish_time_ = base::TimeTicks::HighResNow();
+}
+
 void ProxyTimingHistory::DidCommit() {
   commit_complete_time_ = base::TimeTicks::HighResNow();
-  begin_main_frame_to_commit_duration_history_.InsertSample(
-      commit_complete_time_ - begin_main_frame_sent_time_);
+  base::TimeDelta duration =
+      commit_complete_time_ - begin_main_frame_sent_time_;
+  // Leave out the time a frame finished early spent waiting for the previous
+  // pending tree to activate, so that it does not count as main thread work.
+  if (begin_main_frame_finish_time_ > begin_main_frame_sent_time_ &&
+      activate_time_ > begin_main_frame_finish_time_)
+    duration -= activate_time_ - begin_main_frame_finish_time_;
+  begin_main_frame_to_commit_duration_history_.InsertSample(duration);
+  pending_tree_begin_main_frame_sent_time_ = begin_main_frame_sent_time_;
 }
 
-void ProxyTimingHistory::DidActivatePendingTree() {
+base::TimeDelta ProxyTimingHistory::DidActivatePendingTree() {
+  activate_time_ = base::TimeTicks::HighResNow();
   commit_to_activate_duration_history_.InsertSample(
-      base::TimeTicks::HighResNow() - commit_complete_time_);
+      activate_time_ - commit_complete_time_);
+  return activate_time_ - pending_tree_begin_main_frame_sent_time_;
 }
 
 void ProxyTimingHistory::DidStartDrawing() {
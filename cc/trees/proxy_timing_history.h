@@ -19,8 +19,12 @@ class ProxyTimingHistory {
   base::TimeDelta CommitToActivateDurationEstimate() const;
 
   void DidBeginMainFrame();
+  // The main thread is done with the frame, which may still have to wait for
+  // the previous pending tree to activate before it commits.
+  void DidFinishBeginMainFrame();
   void DidCommit();
-  void DidActivatePendingTree();
+  // Returns the time since the BeginMainFrame that produced the tree.
+  base::TimeDelta DidActivatePendingTree();
   void DidStartDrawing();
   // Returns draw duration.
   base::TimeDelta DidFinishDrawing();
@@ -31,7 +35,10 @@ class ProxyTimingHistory {
   RollingTimeDeltaHistory commit_to_activate_duration_history_;
 
   base::TimeTicks begin_main_frame_sent_time_;
+  base::TimeTicks begin_main_frame_finish_time_;
   base::TimeTicks commit_complete_time_;
+  base::TimeTicks pending_tree_begin_main_frame_sent_time_;
+  base::TimeTicks activate_time_;
   base::TimeTicks start_draw_time_;
 };
 
@@ -996,6 +996,8 @@ void ThreadProxy::StartCommitOnImplThread(
   DCHECK(impl().scheduler);
   DCHECK(impl().scheduler->CommitPending());
 
+  impl().timing_history.DidFinishBeginMainFrame();
+
   if (!impl().layer_tree_host_impl) {
     TRACE_EVENT_INSTANT0(
         "cc", "EarlyOut_NoLayerTree", TRACE_EVENT_SCOPE_THREAD);
@@ -1397,6 +1399,11 @@ void ThreadProxy::PostBeginImplFrameDeadline(const base::Closure& closure,
 
 void ThreadProxy::DidBeginImplFrameDeadline() {
   impl().layer_tree_host_impl->ResetCurrentFrameTimeForNextFrame();
+
+  // Counts the frames whose deadline passed while the main thread was behind,
+  // which are the frames that show stale content from the main thread.
+  UMA_HISTOGRAM_BOOLEAN("Renderer.MainThreadMissedImplFrameDeadline",
+                        impl().scheduler->MainThreadIsInHighLatencyMode());
 }
 
 void ThreadProxy::ReadyToFinalizeTextureUpdates() {
@@ -1479,6 +1486,9 @@ void ThreadProxy::InitializeImplOnImplThread(CompletionEvent* completion) {
       settings.using_synchronous_renderer_compositor;
   scheduler_settings.throttle_frame_production =
       settings.throttle_frame_production;
+  scheduler_settings.main_frame_before_activation_enabled =
+      settings.impl_side_painting &&
+      settings.main_frame_before_activation_enabled;
   impl().scheduler =
       Scheduler::Create(this, scheduler_settings, impl().layer_tree_host_id);
   impl().scheduler->SetVisible(impl().layer_tree_host_impl->visible());
@@ -1726,7 +1736,13 @@ void ThreadProxy::DidActivatePendingTree() {
 
   UpdateBackgroundAnimateTicking();
 
-  impl().timing_history.DidActivatePendingTree();
+  base::TimeDelta begin_main_frame_to_activate_duration =
+      impl().timing_history.DidActivatePendingTree();
+  UMA_HISTOGRAM_CUSTOM_TIMES("Renderer.BeginMainFrameToActivateDuration",
+                             begin_main_frame_to_activate_duration,
+                             base::TimeDelta::FromMilliseconds(1),
+                             base::TimeDelta::FromMilliseconds(1000),
+                             50);
 }
 
 void ThreadProxy::DidManageTiles() {
@@ -8,6 +8,7 @@
 #include <string>
 
 #include "base/command_line.h"
+#include "base/debug/trace_event.h"
 #include "base/format_macros.h"
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
@@ -143,6 +144,10 @@ bool IsTrivialAutocompletion(const AutocompleteMatch& match) {
       match.type == AutocompleteMatchType::SEARCH_OTHER_ENGINE;
 }
 
+// Updates from asynchronous providers that arrive within this long of each
+// other are folded into a single result update, roughly one per frame.
+const int kCoalesceUpdatesMilliseconds = 16;
+
 // Whether this autocomplete match type supports custom descriptions.
 bool AutocompleteMatchHasCustomDescription(const AutocompleteMatch& match) {
   return match.type == AutocompleteMatchType::SEARCH_SUGGEST_ENTITY ||
@@ -253,6 +258,7 @@ void AutocompleteController::Start(const AutocompleteInput& input) {
 
   expire_timer_.Stop();
   stop_timer_.Stop();
+  update_timer_.Stop();
 
   // Start the new query.
   in_zero_suggest_ = false;
@@ -263,6 +269,8 @@ void AutocompleteController::Start(const AutocompleteInput& input) {
     // TODO(mpearson): Remove timing code once bugs 178705 / 237703 / 168933
     // are resolved.
     base::TimeTicks provider_start_time = base::TimeTicks::Now();
+    TRACE_EVENT1("omnibox", "AutocompleteProvider::Start",
+                 "provider", (*i)->GetName());
     (*i)->Start(input_, minimal_changes);
     if (input.matches_requested() != AutocompleteInput::ALL_MATCHES)
       DCHECK((*i)->done());
@@ -313,6 +321,7 @@ void AutocompleteController::Stop(bool clear_result) {
 
   expire_timer_.Stop();
   stop_timer_.Stop();
+  update_timer_.Stop();
   done_ = true;
   if (clear_result && !result_.empty()) {
     result_.Reset();
@@ -371,8 +380,21 @@ void AutocompleteController::OnProviderUpdate(bool updated_matches) {
     CheckIfDone();
     // Multiple providers may provide synchronous results, so we only update the
     // results if we're not in Start().
-    if (!in_start_ && (updated_matches || done_))
+    if (in_start_ || !(updated_matches || done_))
+      return;
+    if (done_) {
+      update_timer_.Stop();
       UpdateResult(false, false);
+    } else if (!update_timer_.IsRunning()) {
+      // Several asynchronous providers tend to report within a few
+      // milliseconds of each other; merging and repainting once for all of
+      // them keeps the popup from redrawing for each.
+      update_timer_.Start(
+          FROM_HERE,
+          base::TimeDelta::FromMilliseconds(kCoalesceUpdatesMilliseconds),
+          base::Bind(&AutocompleteController::UpdateResult,
+                     base::Unretained(this), false, false));
+    }
   }
 }
 
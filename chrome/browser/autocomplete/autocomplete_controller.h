@@ -221,6 +221,10 @@ class AutocompleteController : public AutocompleteProviderListener {
   // Timer used to tell the providers to Stop() searching for matches.
   base::OneShotTimer<AutocompleteController> stop_timer_;
 
+  // Timer used to coalesce the updates of asynchronous providers into one
+  // UpdateResult() call.
+  base::OneShotTimer<AutocompleteController> update_timer_;
+
   // Amount of time (in ms) between when the user stops typing and
   // when we send Stop() to every provider.  This is intended to avoid
   // the disruptive effect of belated omnibox updates, updates that
@@ -867,7 +867,11 @@ void BrowsingDataRemover::DoClearCache(int rv) {
 
         next_cache_state_ = (next_cache_state_ == STATE_CREATE_MAIN) ?
                                 STATE_DELETE_MAIN : STATE_DELETE_MEDIA;
-        rv = factory->GetCache()->GetBackend(
+        // The responses and entries held in memory are dropped along with the
+        // backend entries below.
+        net::HttpCache* http_cache = factory->GetCache();
+        http_cache->ClearInMemoryEntries();
+        rv = http_cache->GetBackend(
             &cache_, base::Bind(&BrowsingDataRemover::DoClearCache,
                                 base::Unretained(this)));
         break;
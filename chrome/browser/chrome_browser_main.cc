@@ -19,6 +19,8 @@
 #include "base/debug/debugger.h"
 #include "base/debug/trace_event.h"
 #include "base/file_util.h"
+#include "base/files/file.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
@@ -36,6 +38,7 @@
 #include "base/strings/sys_string_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/sys_info.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "base/threading/platform_thread.h"
 #include "base/time/time.h"
 #include "base/values.h"
@@ -90,6 +93,7 @@
 #include "chrome/browser/profiles/profile_manager.h"
 #include "chrome/browser/profiles/profiles_state.h"
 #include "chrome/browser/shell_integration.h"
+#include "chrome/browser/startup_task_graph.h"
 #include "chrome/browser/three_d_api_observer.h"
 #include "chrome/browser/translate/translate_service.h"
 #include "chrome/browser/ui/app_list/app_list_service.h"
@@ -119,6 +123,7 @@
 #include "components/rappor/rappor_service.h"
 #include "components/startup_metric_utils/startup_metric_utils.h"
 #include "components/translate/core/browser/translate_download_manager.h"
+#include "components/webdata/common/webdata_constants.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/notification_observer.h"
 #include "content/public/browser/notification_registrar.h"
@@ -484,6 +489,27 @@ void LaunchDevToolsHandlerIfNeeded(const CommandLine& command_line) {
   }
 }
 
+// Size of the reads that warm files.
+const int kWarmFileReadSize = 64 * 1024;
+
+// Reads the files in |dir| whose names start with |name|, such as a database
+// and its journal, so that the code that opens them later reads them from the
+// page cache instead of waiting on the disk.
+void WarmFiles(const base::FilePath& dir,
+               const base::FilePath::StringType& name) {
+  base::FileEnumerator files(dir, false, base::FileEnumerator::FILES,
+                             name + FILE_PATH_LITERAL("*"));
+  scoped_ptr<char[]> buffer(new char[kWarmFileReadSize]);
+  for (base::FilePath path = files.Next(); !path.empty();
+       path = files.Next()) {
+    base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+    if (!file.IsValid())
+      continue;
+    while (file.ReadAtCurrentPos(buffer.get(), kWarmFileReadSize) > 0) {
+    }
+  }
+}
+
 // Heap allocated class that listens for first page load, kicks off stat
 // recording and then deletes itself.
 class LoadCompleteListener : public content::NotificationObserver {
@@ -714,6 +740,42 @@ void ChromeBrowserMainParts::RecordBrowserStartupTime() {
   new LoadCompleteListener();
 }
 
+void ChromeBrowserMainParts::StartWarmingProfileFiles() {
+  TRACE_EVENT0("startup", "ChromeBrowserMainParts::StartWarmingProfileFiles");
+  const base::FilePath profile_dir =
+      ProfileManager::GetLastUsedProfileDir(user_data_dir_);
+
+  // The preferences are read first, when the profile is created. The other
+  // files wait for them, so that they don't compete for the disk with the
+  // one read that blocks startup. Safe Browsing is independent of the
+  // profile.
+  const std::vector<std::string> no_dependencies;
+  const std::vector<std::string> after_preferences(1, "Preferences");
+  startup_task_graph_.reset(new StartupTaskGraph(
+      BrowserThread::GetBlockingPool()->GetTaskRunnerWithShutdownBehavior(
+          base::SequencedWorkerPool::CONTINUE_ON_SHUTDOWN)));
+  startup_task_graph_->AddTask(
+      "Preferences", no_dependencies,
+      base::Bind(&WarmFiles, profile_dir, chrome::kPreferencesFilename));
+  startup_task_graph_->AddTask(
+      "History", after_preferences,
+      base::Bind(&WarmFiles, profile_dir, chrome::kHistoryFilename));
+  startup_task_graph_->AddTask(
+      "Cookies", after_preferences,
+      base::Bind(&WarmFiles, profile_dir, chrome::kCookieFilename));
+  startup_task_graph_->AddTask(
+      "WebData", after_preferences,
+      base::Bind(&WarmFiles, profile_dir, kWebDataFilename));
+  startup_task_graph_->AddTask(
+      "Favicons", std::vector<std::string>(1, "History"),
+      base::Bind(&WarmFiles, profile_dir, chrome::kFaviconsFilename));
+  startup_task_graph_->AddTask(
+      "SafeBrowsing", no_dependencies,
+      base::Bind(&WarmFiles, user_data_dir_,
+                 chrome::kSafeBrowsingBaseFilename));
+  startup_task_graph_->Start();
+}
+
 // -----------------------------------------------------------------------------
 // TODO(viettrungluu): move more/rest of BrowserMain() into BrowserMainParts.
 
@@ -841,6 +903,13 @@ int ChromeBrowserMainParts::PreCreateThreadsImpl() {
   local_state_ = InitializeLocalState(
       local_state_task_runner.get(), parsed_command_line());
 
+#if !defined(OS_ANDROID) && !defined(OS_CHROMEOS)
+  // The files to read are known as soon as local state names the last used
+  // profile, long before the profile is created.
+  if (!parsed_command_line().HasSwitch(switches::kDisableStartupFileWarming))
+    StartWarmingProfileFiles();
+#endif
+
 #if !defined(OS_ANDROID)
   // These members must be initialized before returning from this function.
   master_prefs_.reset(new first_run::MasterPrefs);
@@ -25,6 +25,7 @@ class MetricsService;
 class PrefService;
 class Profile;
 class StartupBrowserCreator;
+class StartupTaskGraph;
 class StartupTimeBomb;
 class ShutdownWatcherHelper;
 class ThreeDAPIObserver;
@@ -118,6 +119,12 @@ class ChromeBrowserMainParts : public content::BrowserMainParts {
   // sub-histogram (_PreRead(Enabled|Disabled)).
   void RecordPreReadExperimentTime(const char* name, base::TimeDelta time);
 
+  // Starts reading the files that the last used profile and the Safe
+  // Browsing database open during startup on the blocking pool, so that
+  // these reads come from the page cache. Call only after local state is
+  // loaded.
+  void StartWarmingProfileFiles();
+
   // Methods for Main Message Loop -------------------------------------------
 
   int PreCreateThreadsImpl();
@@ -177,6 +184,7 @@ class ChromeBrowserMainParts : public content::BrowserMainParts {
   bool run_message_loop_;
   ProcessSingleton::NotifyResult notify_result_;
   scoped_ptr<ThreeDAPIObserver> three_d_observer_;
+  scoped_ptr<StartupTaskGraph> startup_task_graph_;
 
   // Initialized in SetupMetricsAndFieldTrials.
   scoped_refptr<FieldTrialSynchronizer> field_trial_synchronizer_;
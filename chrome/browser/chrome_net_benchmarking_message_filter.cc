@@ -69,8 +69,10 @@ void ChromeNetBenchmarkingMessageFilter::OnClearCache(IPC::Message* reply_msg) {
   }
   int rv = -1;
 
-  disk_cache::Backend* backend = request_context_->GetURLRequestContext()->
-      http_transaction_factory()->GetCache()->GetCurrentBackend();
+  net::HttpCache* http_cache = request_context_->GetURLRequestContext()->
+      http_transaction_factory()->GetCache();
+  http_cache->ClearInMemoryEntries();
+  disk_cache::Backend* backend = http_cache->GetCurrentBackend();
   if (backend) {
     net::CompletionCallback callback =
         base::Bind(&ClearCacheCallback, make_scoped_refptr(this), reply_msg);
@@ -17,6 +17,7 @@
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/process/process.h"
+#include "base/process/process_metrics.h"
 #include "base/strings/string16.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
@@ -28,6 +29,7 @@
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/browser_process_platform_part_chromeos.h"
 #include "chrome/browser/memory_details.h"
+#include "chrome/browser/memory_purger.h"
 #include "chrome/browser/ui/browser.h"
 #include "chrome/browser/ui/browser_iterator.h"
 #include "chrome/browser/ui/browser_list.h"
@@ -80,6 +82,22 @@ const int kSuspendThresholdSeconds = kAdjustmentIntervalSeconds * 4;
 // a little while before doing the adjustment.
 const int kFocusedTabScoreAdjustIntervalMs = 500;
 
+// The interval in seconds after which to check the available memory, if
+// proactive tab purging is enabled.
+const int kMemoryPressureCheckIntervalSeconds = 5;
+
+// Memory is under moderate pressure when less than this percentage of it is
+// available, and under critical pressure below the second percentage.
+const int kModeratePressureAvailablePercent = 15;
+const int kCriticalPressureAvailablePercent = 5;
+
+// Number of renderers asked to purge their memory per check. Purging pages
+// in the caches it frees, so spread the work out.
+const size_t kMaxPurgesPerCheck = 2;
+
+// Time after a purge request at which to measure how much memory it freed.
+const int kPurgeReclaimDelaySeconds = 10;
+
 // Returns a unique ID for a WebContents.  Do not cast back to a pointer, as
 // the WebContents could be deleted if the user closed the tab.
 int64 IdFromWebContents(WebContents* web_contents) {
@@ -103,6 +121,29 @@ void RecordLinearHistogram(const std::string& name,
   counter->Add(sample);
 }
 
+int BytesToMegabytes(size_t bytes) {
+  return static_cast<int>(bytes / 1024 / 1024);
+}
+
+// Returns the resident size of the process |handle|, in bytes.
+size_t GetProcessSize(base::ProcessHandle handle) {
+  scoped_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(handle));
+  return metrics->GetWorkingSetSize();
+}
+
+// Records how much memory the renderer |handle| freed since it was asked to
+// purge, when it was |size_before| bytes large.
+void RecordPurgeReclaimedOnFileThread(base::ProcessHandle handle,
+                                      size_t size_before) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  const size_t size_after = GetProcessSize(handle);
+  HISTOGRAM_MEGABYTES(
+      "Tabs.Purge.ReclaimedMB",
+      size_after < size_before ? BytesToMegabytes(size_before - size_after)
+                               : 0);
+}
+
 }  // namespace
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -164,6 +205,7 @@ OomPriorityManager::TabStats::TabStats()
     is_selected(false),
     is_discarded(false),
     renderer_handle(0),
+    child_process_id(0),
     tab_contents_id(0) {
 }
 
@@ -204,6 +246,15 @@ void OomPriorityManager::Start() {
         this,
         &OomPriorityManager::RecordRecentTabDiscard);
   }
+  if (CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableProactiveTabPurging) &&
+      !memory_pressure_timer_.IsRunning()) {
+    memory_pressure_timer_.Start(
+        FROM_HERE,
+        TimeDelta::FromSeconds(kMemoryPressureCheckIntervalSeconds),
+        this,
+        &OomPriorityManager::CheckMemoryPressure);
+  }
   if (low_memory_listener_.get())
     low_memory_listener_->Start();
   start_time_ = TimeTicks::Now();
@@ -212,6 +263,7 @@ void OomPriorityManager::Start() {
 void OomPriorityManager::Stop() {
   timer_.Stop();
   recent_tab_discard_timer_.Stop();
+  memory_pressure_timer_.Stop();
   if (low_memory_listener_.get())
     low_memory_listener_->Stop();
 }
@@ -409,6 +461,155 @@ void OomPriorityManager::PurgeBrowserMemory() {
   // TODO(jamescook): Are there other things we could flush? Drive metadata?
 }
 
+// static
+bool OomPriorityManager::GetMemoryPressureLevel(
+    const base::SystemMemoryInfoKB& memory,
+    base::MemoryPressureListener::MemoryPressureLevel* level) {
+  if (memory.total <= 0)
+    return false;
+  // Available as in Tabs.Discard.MemAvailableMB.
+  const int64 available_percent =
+      static_cast<int64>(memory.active_file + memory.inactive_file +
+                         memory.free) * 100 / memory.total;
+  if (available_percent < kCriticalPressureAvailablePercent) {
+    *level = base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL;
+    return true;
+  }
+  if (available_percent < kModeratePressureAvailablePercent) {
+    *level = base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE;
+    return true;
+  }
+  return false;
+}
+
+// static
+OomPriorityManager::TabStatsList OomPriorityManager::GetPurgeCandidates(
+    const TabStatsList& stats_list,
+    const PurgeTimeMap& last_purge_times) {
+  // Renderers that the user is looking at or listening to stay untouched.
+  std::set<base::ProcessHandle> protected_renderers;
+  PurgeTimeMap last_active_times;
+  for (TabStatsList::const_iterator it = stats_list.begin();
+       it != stats_list.end(); ++it) {
+    if (it->is_selected || it->is_playing_audio)
+      protected_renderers.insert(it->renderer_handle);
+    TimeTicks& last_active = last_active_times[it->renderer_handle];
+    last_active = std::max(last_active, it->last_active);
+  }
+
+  TabStatsList candidates;
+  std::set<base::ProcessHandle> already_seen;
+  for (TabStatsList::const_reverse_iterator it = stats_list.rbegin();
+       it != stats_list.rend(); ++it) {
+    // Discarded tabs have no renderer.
+    if (it->renderer_handle == 0 || it->is_discarded ||
+        protected_renderers.count(it->renderer_handle) ||
+        !already_seen.insert(it->renderer_handle).second) {
+      continue;
+    }
+    // Purging again only helps if the renderer was used since.
+    PurgeTimeMap::const_iterator last_purge =
+        last_purge_times.find(it->renderer_handle);
+    if (last_purge != last_purge_times.end() &&
+        last_purge->second >= last_active_times[it->renderer_handle]) {
+      continue;
+    }
+    candidates.push_back(*it);
+  }
+  return candidates;
+}
+
+void OomPriorityManager::CheckMemoryPressure() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (BrowserList::GetInstance(chrome::HOST_DESKTOP_TYPE_ASH)->empty())
+    return;
+
+  BrowserThread::PostTask(
+      BrowserThread::FILE, FROM_HERE,
+      base::Bind(&OomPriorityManager::CheckMemoryPressureOnFileThread,
+                 base::Unretained(this), GetTabStatsOnUIThread()));
+}
+
+void OomPriorityManager::CheckMemoryPressureOnFileThread(
+    TabStatsList stats_list) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  base::SystemMemoryInfoKB memory;
+  base::MemoryPressureListener::MemoryPressureLevel level;
+  if (!base::GetSystemMemoryInfo(&memory) ||
+      !GetMemoryPressureLevel(memory, &level)) {
+    return;
+  }
+
+  ProcessSizeMap process_sizes;
+  for (TabStatsList::iterator it = stats_list.begin();
+       it != stats_list.end(); ++it) {
+    if (it->renderer_handle != 0 && !process_sizes.count(it->renderer_handle))
+      process_sizes[it->renderer_handle] = GetProcessSize(it->renderer_handle);
+  }
+
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&OomPriorityManager::ReclaimMemory,
+                 base::Unretained(this), level, stats_list, process_sizes));
+}
+
+void OomPriorityManager::ReclaimMemory(
+    base::MemoryPressureListener::MemoryPressureLevel level,
+    const TabStatsList& stats_list,
+    const ProcessSizeMap& process_sizes) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  // Let the browser's own caches go first.
+  base::MemoryPressureListener::NotifyMemoryPressure(level);
+
+  TabStatsList candidates = GetPurgeCandidates(stats_list, last_purge_times_);
+  if (!candidates.empty()) {
+    for (size_t i = 0; i < candidates.size() && i < kMaxPurgesPerCheck; ++i) {
+      const base::ProcessHandle handle = candidates[i].renderer_handle;
+      content::RenderProcessHost* host =
+          content::RenderProcessHost::FromID(candidates[i].child_process_id);
+      if (!host || host->GetHandle() != handle)
+        continue;
+      // The renderer drops its caches, collects garbage and releases its
+      // discardable memory.
+      MemoryPurger::PurgeRendererForHost(host);
+      last_purge_times_[handle] = TimeTicks::Now();
+
+      ProcessSizeMap::const_iterator size = process_sizes.find(handle);
+      if (size == process_sizes.end())
+        continue;
+      BrowserThread::PostDelayedTask(
+          BrowserThread::FILE, FROM_HERE,
+          base::Bind(&RecordPurgeReclaimedOnFileThread, handle, size->second),
+          TimeDelta::FromSeconds(kPurgeReclaimDelaySeconds));
+    }
+    return;
+  }
+
+  // All background renderers have purged what they could since they were
+  // last used. Discard a tab only if that was not enough.
+  if (level != base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL)
+    return;
+
+  std::map<base::ProcessHandle, int> tab_counts;
+  for (TabStatsList::const_iterator it = stats_list.begin();
+       it != stats_list.end(); ++it) {
+    ++tab_counts[it->renderer_handle];
+  }
+  for (TabStatsList::const_reverse_iterator it = stats_list.rbegin();
+       it != stats_list.rend(); ++it) {
+    if (!DiscardTabById(it->tab_contents_id))
+      continue;
+    // The renderer only goes away with the tab if it hosted no other.
+    ProcessSizeMap::const_iterator size =
+        process_sizes.find(it->renderer_handle);
+    if (tab_counts[it->renderer_handle] == 1 && size != process_sizes.end()) {
+      HISTOGRAM_MEGABYTES("Tabs.Discard.ReclaimedMB",
+                          BytesToMegabytes(size->second));
+    }
+    return;
+  }
+}
+
 int OomPriorityManager::GetTabCount() const {
   int tab_count = 0;
   for (chrome::BrowserIterator it; !it.done(); it.Next())
@@ -479,12 +680,14 @@ void OomPriorityManager::Observe(int type,
           content::Details<content::RenderProcessHost::RendererClosedDetails>(
               details)->handle;
       pid_to_oom_score_.erase(handle);
+      last_purge_times_.erase(handle);
       break;
     }
     case content::NOTIFICATION_RENDERER_PROCESS_TERMINATED: {
       handle = content::Source<content::RenderProcessHost>(source)->
           GetHandle();
       pid_to_oom_score_.erase(handle);
+      last_purge_times_.erase(handle);
       break;
     }
     case content::NOTIFICATION_RENDER_WIDGET_VISIBILITY_CHANGED: {
@@ -580,6 +783,7 @@ OomPriorityManager::TabStatsList OomPriorityManager::GetTabStatsOnUIThread() {
         stats.is_discarded = model->IsTabDiscarded(i);
         stats.last_active = contents->GetLastActiveTime();
         stats.renderer_handle = contents->GetRenderProcessHost()->GetHandle();
+        stats.child_process_id = contents->GetRenderProcessHost()->GetID();
         stats.title = contents->GetTitle();
         stats.tab_contents_id = IdFromWebContents(contents);
         stats_list.push_back(stats);
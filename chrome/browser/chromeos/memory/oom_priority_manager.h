@@ -5,11 +5,13 @@
 #ifndef CHROME_BROWSER_CHROMEOS_MEMORY_OOM_PRIORITY_MANAGER_H_
 #define CHROME_BROWSER_CHROMEOS_MEMORY_OOM_PRIORITY_MANAGER_H_
 
+#include <map>
 #include <vector>
 
 #include "base/compiler_specific.h"
 #include "base/containers/hash_tables.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/process/process.h"
 #include "base/strings/string16.h"
@@ -22,6 +24,10 @@
 
 class GURL;
 
+namespace base {
+struct SystemMemoryInfoKB;
+}
+
 namespace chromeos {
 
 class LowMemoryListener;
@@ -35,6 +41,11 @@ class LowMemoryListener;
 //
 // The algorithm used favors killing tabs that are not selected, not pinned,
 // and have been idle for longest, in that order of priority.
+//
+// With --enable-proactive-tab-purging it also checks the amount of available
+// memory, and while it is low, asks the renderers of background tabs to purge
+// their caches, in the same order. Only if that is not enough and memory is
+// critically low, it discards tabs before the kernel's low memory signal.
 class OomPriorityManager : public content::NotificationObserver,
                            public LowMemoryListenerDelegate {
  public:
@@ -68,6 +79,8 @@ class OomPriorityManager : public content::NotificationObserver,
   friend class OomMemoryDetails;
   FRIEND_TEST_ALL_PREFIXES(OomPriorityManagerTest, Comparator);
   FRIEND_TEST_ALL_PREFIXES(OomPriorityManagerTest, IsReloadableUI);
+  FRIEND_TEST_ALL_PREFIXES(OomPriorityManagerTest, GetMemoryPressureLevel);
+  FRIEND_TEST_ALL_PREFIXES(OomPriorityManagerTest, GetPurgeCandidates);
 
   struct TabStats {
     TabStats();
@@ -80,11 +93,18 @@ class OomPriorityManager : public content::NotificationObserver,
     bool is_discarded;
     base::TimeTicks last_active;
     base::ProcessHandle renderer_handle;
+    int child_process_id;  // ID of the renderer's RenderProcessHost.
     base::string16 title;
     int64 tab_contents_id;  // unique ID per WebContents
   };
   typedef std::vector<TabStats> TabStatsList;
 
+  // Resident size of each renderer, in bytes.
+  typedef std::map<base::ProcessHandle, size_t> ProcessSizeMap;
+
+  // When each renderer was last asked to purge its memory.
+  typedef std::map<base::ProcessHandle, base::TimeTicks> PurgeTimeMap;
+
   // Returns true if the |url| represents an internal Chrome web UI page that
   // can be easily reloaded and hence makes a good choice to discard.
   static bool IsReloadableUI(const GURL& url);
@@ -104,6 +124,31 @@ class OomPriorityManager : public content::NotificationObserver,
   // Purges data structures in the browser that can be easily recomputed.
   void PurgeBrowserMemory();
 
+  // Sets |*level| to the memory pressure |memory| indicates. Returns false if
+  // there is enough available memory.
+  static bool GetMemoryPressureLevel(
+      const base::SystemMemoryInfoKB& memory,
+      base::MemoryPressureListener::MemoryPressureLevel* level);
+
+  // Returns the tabs in |stats_list|, which is sorted by CompareTabStats,
+  // whose renderers should purge their memory, least important first. That
+  // is one tab for each renderer that hosts no selected or audible tab, and
+  // wasn't purged since any of its tabs was last active.
+  static TabStatsList GetPurgeCandidates(const TabStatsList& stats_list,
+                                         const PurgeTimeMap& last_purge_times);
+
+  // Called when the timer fires, checks for memory pressure.
+  void CheckMemoryPressure();
+
+  // Called by CheckMemoryPressure. Measures the renderers if memory is low.
+  void CheckMemoryPressureOnFileThread(TabStatsList stats_list);
+
+  // Purges renderers of background tabs, or discards a tab if that is not
+  // enough, to relieve memory pressure of |level|.
+  void ReclaimMemory(base::MemoryPressureListener::MemoryPressureLevel level,
+                     const TabStatsList& stats_list,
+                     const ProcessSizeMap& process_sizes);
+
   // Returns the number of tabs open in all browser instances.
   int GetTabCount() const;
 
@@ -134,6 +179,7 @@ class OomPriorityManager : public content::NotificationObserver,
   base::RepeatingTimer<OomPriorityManager> timer_;
   base::OneShotTimer<OomPriorityManager> focus_tab_score_adjust_timer_;
   base::RepeatingTimer<OomPriorityManager> recent_tab_discard_timer_;
+  base::RepeatingTimer<OomPriorityManager> memory_pressure_timer_;
   content::NotificationRegistrar registrar_;
 
   // This lock is for pid_to_oom_score_ and focus_tab_pid_.
@@ -143,6 +189,9 @@ class OomPriorityManager : public content::NotificationObserver,
   ProcessScoreMap pid_to_oom_score_;
   base::ProcessHandle focused_tab_pid_;
 
+  // Renderers purged by ReclaimMemory(). Only used on the UI thread.
+  PurgeTimeMap last_purge_times_;
+
   // Observer for the kernel low memory signal.
   scoped_ptr<LowMemoryListener> low_memory_listener_;
 
@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "base/logging.h"
+#include "base/process/process_metrics.h"
 #include "base/strings/string16.h"
 #include "base/time/time.h"
 #include "chrome/browser/chromeos/memory/oom_priority_manager.h"
@@ -142,4 +143,100 @@ TEST_F(OomPriorityManagerTest, IsReloadableUI) {
       GURL("chrome://settings/fakeSetting")));
 }
 
+TEST_F(OomPriorityManagerTest, GetMemoryPressureLevel) {
+  base::SystemMemoryInfoKB memory;
+  base::MemoryPressureListener::MemoryPressureLevel level;
+  memory.total = 1000;
+  memory.free = 100;
+  memory.active_file = 50;
+  memory.inactive_file = 50;
+  EXPECT_FALSE(OomPriorityManager::GetMemoryPressureLevel(memory, &level));
+
+  memory.free = 10;
+  ASSERT_TRUE(OomPriorityManager::GetMemoryPressureLevel(memory, &level));
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE, level);
+
+  memory.active_file = 10;
+  memory.inactive_file = 10;
+  ASSERT_TRUE(OomPriorityManager::GetMemoryPressureLevel(memory, &level));
+  EXPECT_EQ(base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL, level);
+
+  // Unknown totals never count as pressure.
+  memory.total = 0;
+  EXPECT_FALSE(OomPriorityManager::GetMemoryPressureLevel(memory, &level));
+}
+
+// Tests that only renderers in the background which were used since their
+// last purge are purged, once each, least important first.
+TEST_F(OomPriorityManagerTest, GetPurgeCandidates) {
+  OomPriorityManager::TabStatsList test_list;
+  const base::TimeTicks now = base::TimeTicks::Now();
+
+  // Already sorted, most important first.
+  {
+    OomPriorityManager::TabStats stats;
+    stats.is_selected = true;
+    stats.renderer_handle = 1;
+    test_list.push_back(stats);
+  }
+
+  {
+    OomPriorityManager::TabStats stats;
+    stats.is_playing_audio = true;
+    stats.renderer_handle = 2;
+    test_list.push_back(stats);
+  }
+
+  {
+    OomPriorityManager::TabStats stats;
+    stats.last_active = now - base::TimeDelta::FromMinutes(1);
+    stats.renderer_handle = 3;
+    test_list.push_back(stats);
+  }
+
+  // Shares a renderer with the selected tab.
+  {
+    OomPriorityManager::TabStats stats;
+    stats.last_active = now - base::TimeDelta::FromMinutes(5);
+    stats.renderer_handle = 1;
+    test_list.push_back(stats);
+  }
+
+  {
+    OomPriorityManager::TabStats stats;
+    stats.last_active = now - base::TimeDelta::FromMinutes(10);
+    stats.renderer_handle = 4;
+    test_list.push_back(stats);
+  }
+
+  // Shares a renderer with the previous tab.
+  {
+    OomPriorityManager::TabStats stats;
+    stats.last_active = now - base::TimeDelta::FromMinutes(20);
+    stats.renderer_handle = 4;
+    test_list.push_back(stats);
+  }
+
+  {
+    OomPriorityManager::TabStats stats;
+    stats.is_discarded = true;
+    test_list.push_back(stats);
+  }
+
+  OomPriorityManager::PurgeTimeMap last_purge_times;
+  OomPriorityManager::TabStatsList candidates =
+      OomPriorityManager::GetPurgeCandidates(test_list, last_purge_times);
+  ASSERT_EQ(2u, candidates.size());
+  EXPECT_EQ(4, candidates[0].renderer_handle);
+  EXPECT_EQ(3, candidates[1].renderer_handle);
+
+  // Renderers unused since their purge are left alone.
+  last_purge_times[3] = now;
+  last_purge_times[4] = now - base::TimeDelta::FromMinutes(15);
+  candidates =
+      OomPriorityManager::GetPurgeCandidates(test_list, last_purge_times);
+  ASSERT_EQ(1u, candidates.size());
+  EXPECT_EQ(4, candidates[0].renderer_handle);
+}
+
 }  // namespace chromeos
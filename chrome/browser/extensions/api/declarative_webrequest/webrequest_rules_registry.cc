@@ -33,6 +33,20 @@ const char kAllURLsPermissionNeeded[] =
     "To execute the action '*', you need to request host permission for all "
     "hosts.";
 
+// Returns the request stages in which at least one of the conditions of |rule|
+// can be evaluated.
+int GetRuleStages(const extensions::WebRequestRule* rule) {
+  int stages = 0;
+  const extensions::WebRequestConditionSet::Conditions& conditions =
+      rule->conditions().conditions();
+  for (extensions::WebRequestConditionSet::const_iterator it =
+           conditions.begin();
+       it != conditions.end(); ++it) {
+    stages |= (*it)->stages();
+  }
+  return stages;
+}
+
 }  // namespace
 
 namespace extensions {
@@ -62,11 +76,16 @@ std::set<const WebRequestRule*> WebRequestRulesRegistry::GetMatches(
       request_data.data->request->first_party_for_cookies());
 
   // 1st phase -- add all rules with some conditions without UrlFilter
-  // attributes.
-  for (RuleSet::const_iterator it = rules_with_untriggered_conditions_.begin();
-       it != rules_with_untriggered_conditions_.end(); ++it) {
-    if ((*it)->conditions().IsFulfilled(-1, request_data))
-      result.insert(*it);
+  // attributes. Rules whose conditions can't be evaluated in the current stage
+  // would fail IsFulfilled() anyway, so they are not even looked at.
+  RulesByStage::const_iterator untriggered_rules =
+      untriggered_rules_by_stage_.find(request_data.data->stage);
+  if (untriggered_rules != untriggered_rules_by_stage_.end()) {
+    const RuleSet& rules = untriggered_rules->second;
+    for (RuleSet::const_iterator it = rules.begin(); it != rules.end(); ++it) {
+      if ((*it)->conditions().IsFulfilled(-1, request_data))
+        result.insert(*it);
+    }
   }
 
   // 2nd phase -- add all rules with some conditions triggered by URL matches.
@@ -223,8 +242,16 @@ std::string WebRequestRulesRegistry::AddRulesImpl(
   for (RulesVector::const_iterator i = new_webrequest_rules.begin();
        i != new_webrequest_rules.end(); ++i) {
     i->second->conditions().GetURLMatcherConditionSets(&all_new_condition_sets);
-    if (i->second->conditions().HasConditionsWithoutUrls())
+    if (i->second->conditions().HasConditionsWithoutUrls()) {
       rules_with_untriggered_conditions_.insert(i->second.get());
+      int stages = GetRuleStages(i->second.get());
+      for (unsigned int stage = 1; stage <= ON_ERROR; stage <<= 1) {
+        if (stages & stage) {
+          untriggered_rules_by_stage_[static_cast<RequestStage>(stage)].insert(
+              i->second.get());
+        }
+      }
+    }
   }
   url_matcher_.AddConditionSets(all_new_condition_sets);
 
@@ -300,7 +327,16 @@ void WebRequestRulesRegistry::CleanUpAfterRule(
     remove_from_url_matcher->push_back((*j)->id());
     rule_triggers_.erase((*j)->id());
   }
-  rules_with_untriggered_conditions_.erase(rule);
+  if (rules_with_untriggered_conditions_.erase(rule)) {
+    for (RulesByStage::iterator it = untriggered_rules_by_stage_.begin();
+         it != untriggered_rules_by_stage_.end();) {
+      it->second.erase(rule);
+      if (it->second.empty())
+        untriggered_rules_by_stage_.erase(it++);
+      else
+        ++it;
+    }
+  }
 }
 
 bool WebRequestRulesRegistry::IsEmpty() const {
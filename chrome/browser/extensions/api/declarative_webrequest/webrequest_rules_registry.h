@@ -133,6 +133,7 @@ class WebRequestRulesRegistry : public RulesRegistry {
       RulesMap;
   typedef std::set<url_matcher::URLMatcherConditionSet::ID> URLMatches;
   typedef std::set<const WebRequestRule*> RuleSet;
+  typedef std::map<RequestStage, RuleSet> RulesByStage;
 
   // This bundles all consistency checkers. Returns true in case of consistency
   // and MUST set |error| otherwise.
@@ -155,10 +156,10 @@ class WebRequestRulesRegistry : public RulesRegistry {
 
   // Helper for RemoveRulesImpl and RemoveAllRulesImpl. Call this before
   // deleting |rule| from one of the maps in |webrequest_rules_|. It will erase
-  // the rule from |rule_triggers_| and |rules_with_untriggered_conditions_|,
-  // and add every of the rule's URLMatcherConditionSet to
-  // |remove_from_url_matcher|, so that the caller can remove them from the
-  // matcher later.
+  // the rule from |rule_triggers_|, |rules_with_untriggered_conditions_| and
+  // |untriggered_rules_by_stage_|, and add every of the rule's
+  // URLMatcherConditionSet to |remove_from_url_matcher|, so that the caller can
+  // remove them from the matcher later.
   void CleanUpAfterRule(const WebRequestRule* rule,
                         std::vector<url_matcher::URLMatcherConditionSet::ID>*
                             remove_from_url_matcher);
@@ -179,6 +180,11 @@ class WebRequestRulesRegistry : public RulesRegistry {
   // separately.
   std::set<const WebRequestRule*> rules_with_untriggered_conditions_;
 
+  // |rules_with_untriggered_conditions_| again, filed under every request
+  // stage in which at least one of the rule's conditions can be evaluated.
+  // GetMatches() only tests the rules filed under the current stage.
+  RulesByStage untriggered_rules_by_stage_;
+
   std::map<WebRequestRule::ExtensionId, RulesMap> webrequest_rules_;
 
   url_matcher::URLMatcher url_matcher_;
@@ -665,6 +665,50 @@ TEST_F(WebRequestRulesRegistryTest, GetMatchesDifferentUrls) {
   }
 }
 
+// Test that rules without URL conditions are only evaluated, and only returned,
+// in the request stages their conditions apply to, including after removal.
+TEST_F(WebRequestRulesRegistryTest, GetMatchesUntriggeredRulesByStage) {
+  scoped_refptr<TestWebRequestRulesRegistry> registry(
+      new TestWebRequestRulesRegistry(extension_info_map_));
+  const std::string kNoAttributes;
+  const std::string kHeadersReceivedOnly(
+      ""stages": ["onHeadersReceived"], 
+");
+  std::vector<const std::string*> attributes;
+  std::vector<linked_ptr<RulesRegistry::Rule> > rules;
+
+  attributes.push_back(&kHeadersReceivedOnly);
+  rules.push_back(CreateCancellingRule(kRuleId1, attributes));
+  attributes.clear();
+  attributes.push_back(&kNoAttributes);
+  rules.push_back(CreateCancellingRule(kRuleId2, attributes));
+  EXPECT_EQ("", registry->AddRules(kExtensionId, rules));
+  EXPECT_EQ(2u, registry->RulesWithoutTriggers());
+
+  GURL http_url("http://www.example.com");
+  net::TestURLRequestContext context;
+  net::TestURLRequest http_request(
+      http_url, net::DEFAULT_PRIORITY, NULL, &context);
+
+  std::set<const WebRequestRule*> matches = registry->GetMatches(
+      WebRequestData(&http_request, ON_BEFORE_REQUEST));
+  ASSERT_EQ(1u, matches.size());
+  EXPECT_EQ(WebRequestRule::GlobalRuleId(std::make_pair(kExtensionId,
+                                                        kRuleId2)),
+            (*matches.begin())->id());
+
+  matches = registry->GetMatches(
+      WebRequestData(&http_request, ON_HEADERS_RECEIVED));
+  EXPECT_EQ(2u, matches.size());
+
+  std::vector<std::string> rules_to_remove(1, kRuleId2);
+  EXPECT_EQ("", registry->RemoveRules(kExtensionId, rules_to_remove));
+  EXPECT_TRUE(registry->GetMatches(
+      WebRequestData(&http_request, ON_BEFORE_REQUEST)).empty());
+  EXPECT_EQ(1u, registry->GetMatches(
+      WebRequestData(&http_request, ON_HEADERS_RECEIVED)).size());
+}
+
 TEST(WebRequestRulesRegistrySimpleTest, StageChecker) {
   // The contentType condition can only be evaluated during ON_HEADERS_RECEIVED
   // but the redirect action can only be executed during ON_BEFORE_REQUEST.
@@ -236,13 +236,26 @@ void InstalledLoader::LoadAllExtensions() {
     }
   }
 
+  // Split Extensions.LoadAllTime into its phases: reading manifests from disk
+  // where the copy in the preferences can't be used, creating and validating
+  // the Extension objects, and notifying about the loaded extensions.
+  base::TimeTicks create_start_time = base::TimeTicks::Now();
+  UMA_HISTOGRAM_TIMES("Extensions.LoadAllTime.ManifestReload",
+                      create_start_time - start_time);
+
   for (size_t i = 0; i < extensions_info->size(); ++i) {
     if (extensions_info->at(i)->extension_location == Manifest::COMMAND_LINE)
       continue;
     Load(*extensions_info->at(i), should_write_prefs);
   }
 
+  base::TimeTicks create_done_time = base::TimeTicks::Now();
+  UMA_HISTOGRAM_TIMES("Extensions.LoadAllTime.Create",
+                      create_done_time - create_start_time);
+
   extension_service_->OnLoadedInstalledExtensions();
+  UMA_HISTOGRAM_TIMES("Extensions.LoadAllTime.Notify",
+                      base::TimeTicks::Now() - create_done_time);
 
   // The histograms Extensions.ManifestReload* allow us to validate
   // the assumption that reloading manifest is a rare event.
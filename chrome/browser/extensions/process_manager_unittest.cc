@@ -41,6 +41,21 @@ class ProcessManagerTest : public testing::Test {
     return manager->registrar_.IsRegistered(
         manager, type, content::Source<Profile>(profile));
   }
+
+  static void UpdateAdaptiveIdleTime(ProcessManager* manager,
+                                     const std::string& extension_id,
+                                     base::TimeDelta suspended_time) {
+    manager->UpdateAdaptiveIdleTime(extension_id, suspended_time);
+  }
+
+  static base::TimeDelta GetEventPageIdleTime(ProcessManager* manager,
+                                              const std::string& extension_id) {
+    return manager->GetEventPageIdleTime(extension_id);
+  }
+
+  static base::TimeDelta GetDefaultEventPageIdleTime(ProcessManager* manager) {
+    return manager->event_page_idle_time_;
+  }
 };
 
 // Test that notification registration works properly.
@@ -140,4 +155,40 @@ TEST_F(ProcessManagerTest, ProcessGrouping) {
   EXPECT_NE(site11, other_profile_site);
 }
 
+// Test that event pages woken up soon after suspending get a longer idle time,
+// and that it decays back to the default once they stay suspended.
+TEST_F(ProcessManagerTest, AdaptiveEventPageIdleTime) {
+  TestingProfile profile;
+  scoped_ptr<ProcessManager> manager(ProcessManager::Create(&profile));
+  const std::string kExtensionId("ext1_id");
+  const base::TimeDelta default_idle_time =
+      GetDefaultEventPageIdleTime(manager.get());
+  EXPECT_EQ(default_idle_time,
+            GetEventPageIdleTime(manager.get(), kExtensionId));
+
+  // Quick re-wakes double the idle time, up to a cap.
+  UpdateAdaptiveIdleTime(manager.get(), kExtensionId, default_idle_time / 2);
+  EXPECT_EQ(default_idle_time * 2,
+            GetEventPageIdleTime(manager.get(), kExtensionId));
+  UpdateAdaptiveIdleTime(manager.get(), kExtensionId, default_idle_time);
+  EXPECT_EQ(default_idle_time * 4,
+            GetEventPageIdleTime(manager.get(), kExtensionId));
+  for (int i = 0; i < 20; ++i)
+    UpdateAdaptiveIdleTime(manager.get(), kExtensionId, base::TimeDelta());
+  EXPECT_EQ(base::TimeDelta::FromMinutes(5),
+            GetEventPageIdleTime(manager.get(), kExtensionId));
+
+  // Other extensions are not affected.
+  EXPECT_EQ(default_idle_time,
+            GetEventPageIdleTime(manager.get(), "ext2_id"));
+
+  // Long suspensions halve it again, but never below the default.
+  for (int i = 0; i < 20; ++i) {
+    UpdateAdaptiveIdleTime(manager.get(), kExtensionId,
+                           base::TimeDelta::FromHours(1));
+  }
+  EXPECT_EQ(default_idle_time,
+            GetEventPageIdleTime(manager.get(), kExtensionId));
+}
+
 }  // namespace extensions
@@ -33,7 +33,8 @@
 //
 // icon_mapping
 //   id               Unique ID.
-//   page_url         Page URL which has one or more associated favicons.
+//   page_url         Page URL which has one or more associated favicons,
+//                    prefix coded (see EncodeURL() below).
 //   icon_id          The ID of favicon that this mapping maps to.
 //
 // favicons           This table associates a row to each favicon for a
@@ -44,7 +45,8 @@
 //                    row in the icon_mapping table.
 //
 //   id               Unique ID.
-//   url              The URL at which the favicon file is located.
+//   url              The URL at which the favicon file is located, prefix
+//                    coded like |icon_mapping.page_url|.
 //   icon_type        The type of the favicon specified in the rel attribute of
 //                    the link tag. The FAVICON type is used for the default
 //                    favicon.ico favicon.
@@ -75,6 +77,7 @@ namespace {
 // fatal (in fact, very old data may be expired immediately at startup
 // anyhow).
 
+// Version 8: page and favicon URLs are stored prefix coded.
 // Version 7: 911a634d/r209424 by qsr@chromium.org on 2013-07-01
 // Version 6: 610f923b/r152367 by pkotwicz@chromium.org on 2012-08-20
 // Version 5: e2ee8ae9/r105004 by groby@chromium.org on 2011-10-12
@@ -84,10 +87,59 @@ namespace {
 // Version number of the database.
 // NOTE(shess): When changing the version, add a new golden file for
 // the new version and a test to verify that Init() works with it.
-const int kCurrentVersionNumber = 7;
-const int kCompatibleVersionNumber = 7;
+const int kCurrentVersionNumber = 8;
+const int kCompatibleVersionNumber = 8;
 const int kDeprecatedVersionNumber = 4;  // and earlier.
 
+// Nearly every stored URL starts with one of these. The URL columns store the
+// prefix as a single control byte, |kURLPrefixes[i]| being coded as |i + 1|,
+// which a valid URL spec can never start with. Most URLs in this database are
+// stored twice, in the table and in its index, so this saves a good fraction
+// of the file. Longer prefixes must come first. Entries must never be
+// reordered or removed, as they are part of the on-disk format.
+const char* const kURLPrefixes[] = {
+  "https://www.",
+  "http://www.",
+  "https://",
+  "http://",
+};
+
+std::string EncodeURL(const GURL& url) {
+  const std::string spec = history::URLDatabase::GURLToDatabaseURL(url);
+  for (size_t i = 0; i < arraysize(kURLPrefixes); ++i) {
+    if (StartsWithASCII(spec, kURLPrefixes[i], true))
+      return std::string(1, static_cast<char>(i + 1)) +
+          spec.substr(strlen(kURLPrefixes[i]));
+  }
+  return spec;
+}
+
+GURL DecodeURL(const std::string& coded_url) {
+  if (!coded_url.empty() && coded_url[0] > 0 &&
+      static_cast<size_t>(coded_url[0]) <= arraysize(kURLPrefixes)) {
+    return GURL(kURLPrefixes[coded_url[0] - 1] + coded_url.substr(1));
+  }
+  return GURL(coded_url);
+}
+
+// Prefix codes every value of |table.column| which is not coded yet.
+bool EncodeURLColumn(sql::Connection* db,
+                     const char* table,
+                     const char* column) {
+  std::string coded_column("CASE");
+  for (size_t i = 0; i < arraysize(kURLPrefixes); ++i) {
+    const size_t length = strlen(kURLPrefixes[i]);
+    base::StringAppendF(&coded_column,
+                        " WHEN substr(%s, 1, %" PRIuS ") = '%s'"
+                        " THEN CAST(X'%02x' AS TEXT) || substr(%s, %" PRIuS ")",
+                        column, length, kURLPrefixes[i],
+                        static_cast<unsigned>(i + 1), column, length + 1);
+  }
+  base::StringAppendF(&coded_column, " ELSE %s END", column);
+  return db->Execute(base::StringPrintf("UPDATE %s SET %s = %s", table, column,
+                                        coded_column.c_str()).c_str());
+}
+
 void FillIconMapping(const sql::Statement& statement,
                      const GURL& page_url,
                      history::IconMapping* icon_mapping) {
@@ -95,7 +147,7 @@ void FillIconMapping(const sql::Statement& statement,
   icon_mapping->icon_id = statement.ColumnInt64(1);
   icon_mapping->icon_type =
       static_cast<chrome::IconType>(statement.ColumnInt(2));
-  icon_mapping->icon_url = GURL(statement.ColumnString(3));
+  icon_mapping->icon_url = DecodeURL(statement.ColumnString(3));
   icon_mapping->page_url = page_url;
 }
 
@@ -394,7 +446,7 @@ void RecoverDatabaseOrRaze(sql::Connection* db, const base::FilePath& db_path) {
   // NOTE(shess): This code is currently specific to the version
   // number.  I am working on simplifying things to loosen the
   // dependency, meanwhile contact me if you need to bump the version.
-  DCHECK_EQ(7, kCurrentVersionNumber);
+  DCHECK_EQ(8, kCurrentVersionNumber);
 
   // TODO(shess): Reset back after?
   db->reset_error_callback();
@@ -448,7 +500,7 @@ void RecoverDatabaseOrRaze(sql::Connection* db, const base::FilePath& db_path) {
 
   // Earlier versions have been handled or deprecated, later versions should be
   // impossible.
-  if (version != 7) {
+  if (version != 7 && version != 8) {
     sql::Recovery::Unrecoverable(recovery.Pass());
     RecordRecoveryEvent(RECOVERY_EVENT_FAILED_META_WRONG_VERSION);
     return;
@@ -498,6 +550,15 @@ void RecoverDatabaseOrRaze(sql::Connection* db, const base::FilePath& db_path) {
     return;
   }
 
+  // Version 8 only changed how URLs are stored.
+  if (version == 7 &&
+      (!EncodeURLColumn(recovery->db(), "icon_mapping", "page_url") ||
+       !EncodeURLColumn(recovery->db(), "favicons", "url"))) {
+    sql::Recovery::Rollback(recovery.Pass());
+    RecordRecoveryEvent(RECOVERY_EVENT_FAILED_AUTORECOVER_ICON_MAPPING);
+    return;
+  }
+
   // TODO(shess): Is it possible/likely to have broken foreign-key
   // issues with the tables?
   // - icon_mapping.icon_id maps to no favicons.id
@@ -584,7 +645,8 @@ bool ThumbnailDatabase::IconMappingEnumerator::GetNextIconMapping(
     IconMapping* icon_mapping) {
   if (!statement_.Step())
     return false;
-  FillIconMapping(statement_, GURL(statement_.ColumnString(4)), icon_mapping);
+  FillIconMapping(statement_, DecodeURL(statement_.ColumnString(4)),
+                  icon_mapping);
   return true;
 }
 
@@ -808,7 +870,7 @@ chrome::FaviconID ThumbnailDatabase::GetFaviconIDForFaviconURL(
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
       "SELECT id, icon_type FROM favicons WHERE url=? AND (icon_type & ? > 0) "
       "ORDER BY icon_type DESC"));
-  statement.BindString(0, URLDatabase::GURLToDatabaseURL(icon_url));
+  statement.BindString(0, EncodeURL(icon_url));
   statement.BindInt(1, required_icon_type);
 
   if (!statement.Step())
@@ -832,7 +894,7 @@ bool ThumbnailDatabase::GetFaviconHeader(chrome::FaviconID icon_id,
     return false;  // No entry for the id.
 
   if (icon_url)
-    *icon_url = GURL(statement.ColumnString(0));
+    *icon_url = DecodeURL(statement.ColumnString(0));
   if (icon_type)
     *icon_type = static_cast<chrome::IconType>(statement.ColumnInt(1));
 
@@ -845,7 +907,7 @@ chrome::FaviconID ThumbnailDatabase::AddFavicon(
 
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
       "INSERT INTO favicons (url, icon_type) VALUES (?, ?)"));
-  statement.BindString(0, URLDatabase::GURLToDatabaseURL(icon_url));
+  statement.BindString(0, EncodeURL(icon_url));
   statement.BindInt(1, icon_type);
 
   if (!statement.Run())
@@ -918,7 +980,7 @@ bool ThumbnailDatabase::GetIconMappingsForPageURL(
       "ON icon_mapping.icon_id = favicons.id "
       "WHERE icon_mapping.page_url=? "
       "ORDER BY favicons.icon_type DESC"));
-  statement.BindString(0, URLDatabase::GURLToDatabaseURL(page_url));
+  statement.BindString(0, EncodeURL(page_url));
 
   bool result = false;
   while (statement.Step()) {
@@ -938,7 +1000,7 @@ IconMappingID ThumbnailDatabase::AddIconMapping(const GURL& page_url,
   const char kSql[] =
       "INSERT INTO icon_mapping (page_url, icon_id) VALUES (?, ?)";
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE, kSql));
-  statement.BindString(0, URLDatabase::GURLToDatabaseURL(page_url));
+  statement.BindString(0, EncodeURL(page_url));
   statement.BindInt64(1, icon_id);
 
   if (!statement.Run())
@@ -960,7 +1022,7 @@ bool ThumbnailDatabase::UpdateIconMapping(IconMappingID mapping_id,
 bool ThumbnailDatabase::DeleteIconMappings(const GURL& page_url) {
   sql::Statement statement(db_.GetCachedStatement(SQL_FROM_HERE,
       "DELETE FROM icon_mapping WHERE page_url = ?"));
-  statement.BindString(0, URLDatabase::GURLToDatabaseURL(page_url));
+  statement.BindString(0, EncodeURL(page_url));
 
   return statement.Run();
 }
@@ -991,7 +1053,7 @@ bool ThumbnailDatabase::CloneIconMappings(const GURL& old_page_url,
     return false;
 
   // Do nothing if there are existing bindings
-  statement.BindString(0, URLDatabase::GURLToDatabaseURL(new_page_url));
+  statement.BindString(0, EncodeURL(new_page_url));
   if (statement.Step())
     return true;
 
@@ -1000,8 +1062,8 @@ bool ThumbnailDatabase::CloneIconMappings(const GURL& old_page_url,
         "SELECT ?, icon_id FROM icon_mapping "
         "WHERE page_url = ?"));
 
-  statement.BindString(0, URLDatabase::GURLToDatabaseURL(new_page_url));
-  statement.BindString(1, URLDatabase::GURLToDatabaseURL(old_page_url));
+  statement.BindString(0, EncodeURL(new_page_url));
+  statement.BindString(1, EncodeURL(old_page_url));
   return statement.Run();
 }
 
@@ -1045,7 +1107,7 @@ bool ThumbnailDatabase::RetainDataForPageUrls(
     sql::Statement statement(db_.GetUniqueStatement(kIconMappingSql));
     for (std::vector<GURL>::const_iterator
              i = urls_to_keep.begin(); i != urls_to_keep.end(); ++i) {
-      statement.BindString(0, URLDatabase::GURLToDatabaseURL(*i));
+      statement.BindString(0, EncodeURL(*i));
       if (!statement.Run())
         return false;
       statement.Reset(true);
@@ -1237,6 +1299,12 @@ sql::InitStatus ThumbnailDatabase::InitImpl(const base::FilePath& db_name) {
       return CantUpgradeToVersion(cur_version);
   }
 
+  if (cur_version == 7) {
+    ++cur_version;
+    if (!UpgradeToVersion8())
+      return CantUpgradeToVersion(cur_version);
+  }
+
   LOG_IF(WARNING, cur_version < kCurrentVersionNumber) <<
       "Thumbnail database version " << cur_version << " is too old to handle.";
 
@@ -1317,6 +1385,18 @@ bool ThumbnailDatabase::UpgradeToVersion7() {
   return true;
 }
 
+bool ThumbnailDatabase::UpgradeToVersion8() {
+  // Prefix code the stored URLs.  The indices are updated in place.
+  if (!EncodeURLColumn(&db_, "icon_mapping", "page_url") ||
+      !EncodeURLColumn(&db_, "favicons", "url")) {
+    return false;
+  }
+
+  meta_table_.SetVersionNumber(8);
+  meta_table_.SetCompatibleVersionNumber(std::min(8, kCompatibleVersionNumber));
+  return true;
+}
+
 bool ThumbnailDatabase::IsFaviconDBStructureIncorrect() {
   return !db_.IsSQLValid("SELECT id, url, icon_type FROM favicons");
 }
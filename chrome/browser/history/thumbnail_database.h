@@ -230,6 +230,7 @@ class ThumbnailDatabase {
   bool RetainDataForPageUrls(const std::vector<GURL>& urls_to_keep);
 
  private:
+  FRIEND_TEST_ALL_PREFIXES(ThumbnailDatabaseTest, PrefixCodedURLs);
   FRIEND_TEST_ALL_PREFIXES(ThumbnailDatabaseTest, RetainDataForPageUrls);
   FRIEND_TEST_ALL_PREFIXES(ThumbnailDatabaseTest, Version3);
   FRIEND_TEST_ALL_PREFIXES(ThumbnailDatabaseTest, Version4);
@@ -259,6 +260,9 @@ class ThumbnailDatabase {
   // Removes sizes column.
   bool UpgradeToVersion7();
 
+  // Prefix codes page and favicon URLs.
+  bool UpgradeToVersion8();
+
   // Returns true if the |favicons| database is missing a column.
   bool IsFaviconDBStructureIncorrect();
 
@@ -15,6 +15,7 @@
 #include "chrome/common/chrome_paths.h"
 #include "sql/connection.h"
 #include "sql/recovery.h"
+#include "sql/statement.h"
 #include "sql/test/scoped_error_ignorer.h"
 #include "sql/test/test_helpers.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -217,6 +218,41 @@ TEST_F(ThumbnailDatabaseTest, AddIconMapping) {
   EXPECT_EQ(id, icon_mappings.front().icon_id);
 }
 
+// URLs are stored with their common prefix coded, and read back unchanged.
+TEST_F(ThumbnailDatabaseTest, PrefixCodedURLs) {
+  ThumbnailDatabase db;
+  ASSERT_EQ(sql::INIT_OK, db.Init(file_name_));
+
+  std::vector<unsigned char> data(kBlob1, kBlob1 + sizeof(kBlob1));
+  scoped_refptr<base::RefCountedBytes> favicon(new base::RefCountedBytes(data));
+  chrome::FaviconID id = db.AddFavicon(kIconUrl1, chrome::FAVICON, favicon,
+                                       base::Time::Now(), kSmallSize);
+  ASSERT_NE(0, id);
+  EXPECT_NE(0, db.AddIconMapping(kPageUrl1, id));
+  const GURL file_url("file:///home/user/page.html");
+  EXPECT_NE(0, db.AddIconMapping(file_url, id));
+
+  sql::Statement statement(db.db_.GetUniqueStatement(
+      "SELECT page_url FROM icon_mapping ORDER BY id"));
+  ASSERT_TRUE(statement.Step());
+  EXPECT_EQ(std::string("\x04google.com/"), statement.ColumnString(0));
+  ASSERT_TRUE(statement.Step());
+  EXPECT_EQ(file_url.spec(), statement.ColumnString(0));
+
+  statement.Assign(db.db_.GetUniqueStatement("SELECT url FROM favicons"));
+  ASSERT_TRUE(statement.Step());
+  EXPECT_EQ(std::string("\x02google.com/favicon.ico"),
+            statement.ColumnString(0));
+
+  EXPECT_TRUE(CheckPageHasIcon(&db, kPageUrl1, chrome::FAVICON, kIconUrl1,
+                               kSmallSize, sizeof(kBlob1), kBlob1));
+  EXPECT_TRUE(CheckPageHasIcon(&db, file_url, chrome::FAVICON, kIconUrl1,
+                               kSmallSize, sizeof(kBlob1), kBlob1));
+  GURL icon_url;
+  EXPECT_TRUE(db.GetFaviconHeader(id, &icon_url, NULL));
+  EXPECT_EQ(kIconUrl1, icon_url);
+}
+
 TEST_F(ThumbnailDatabaseTest, UpdateIconMapping) {
   ThumbnailDatabase db;
   ASSERT_EQ(sql::INIT_OK, db.Init(file_name_));
@@ -745,8 +781,10 @@ TEST_F(ThumbnailDatabaseTest, Recovery) {
     ASSERT_EQ("ok", sql::test::IntegrityCheck(&raw_db));
   }
   const char kIndexName[] = "icon_mapping_page_url_idx";
+  // Opening the database prefix coded its URLs.
   const char kDeleteSql[] =
-      "DELETE FROM icon_mapping WHERE page_url = 'http://yahoo.com/'";
+      "DELETE FROM icon_mapping "
+      "WHERE page_url = CAST(X'04' AS TEXT) || 'yahoo.com/'";
   EXPECT_TRUE(
       sql::test::CorruptTableOrIndex(file_name_, kIndexName, kDeleteSql));
 
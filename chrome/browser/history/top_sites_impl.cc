@@ -157,6 +157,15 @@ bool TopSitesImpl::SetPageThumbnail(const GURL& url,
   if (!HistoryService::CanAddURL(url))
     return false;  // It's not a real webpage.
 
+  // Most captures of a known URL are not better than the thumbnail already
+  // cached, so check before paying for the JPEG encode.
+  if (!add_temp_thumbnail) {
+    bool should_replace = false;
+    GetScoreForKnownURL(url, score, &should_replace);
+    if (!should_replace)
+      return false;
+  }
+
   scoped_refptr<base::RefCountedBytes> thumbnail_data;
   if (!EncodeBitmap(thumbnail, &thumbnail_data))
     return false;
@@ -492,9 +501,27 @@ bool TopSitesImpl::SetPageThumbnailNoDB(
   // This should only be invoked when we know about the url.
   DCHECK(cache_->IsKnownURL(url));
 
+  bool should_replace = false;
+  const ThumbnailScore new_score_with_redirects =
+      GetScoreForKnownURL(url, score, &should_replace);
+  if (!should_replace)
+    return false;  // The one we already have is better.
+
+  Images* image = cache_->GetImage(url);
+  image->thumbnail = const_cast<base::RefCountedMemory*>(thumbnail_data);
+  image->thumbnail_score = new_score_with_redirects;
+
+  ResetThreadSafeImageCache();
+  return true;
+}
+
+ThumbnailScore TopSitesImpl::GetScoreForKnownURL(const GURL& url,
+                                                 const ThumbnailScore& score,
+                                                 bool* should_replace) {
+  DCHECK(cache_->IsKnownURL(url));
+
   const MostVisitedURL& most_visited =
       cache_->top_sites()[cache_->GetURLIndex(url)];
-  Images* image = cache_->GetImage(url);
 
   // When comparing the thumbnail scores, we need to take into account the
   // redirect hops, which are not generated when the thumbnail is because the
@@ -503,16 +530,14 @@ bool TopSitesImpl::SetPageThumbnailNoDB(
   new_score_with_redirects.redirect_hops_from_dest =
       GetRedirectDistanceForURL(most_visited, url);
 
-  if (!ShouldReplaceThumbnailWith(image->thumbnail_score,
-                                  new_score_with_redirects) &&
-      image->thumbnail.get())
-    return false;  // The one we already have is better.
-
-  image->thumbnail = const_cast<base::RefCountedMemory*>(thumbnail_data);
-  image->thumbnail_score = new_score_with_redirects;
-
-  ResetThreadSafeImageCache();
-  return true;
+  // Look the current thumbnail up without GetImage(), which would add an
+  // empty entry for |url|.
+  scoped_refptr<base::RefCountedMemory> current_thumbnail;
+  ThumbnailScore current_score;
+  *should_replace = !cache_->GetPageThumbnail(url, &current_thumbnail) ||
+      !cache_->GetPageThumbnailScore(url, &current_score) ||
+      ShouldReplaceThumbnailWith(current_score, new_score_with_redirects);
+  return new_score_with_redirects;
 }
 
 bool TopSitesImpl::SetPageThumbnailEncoded(
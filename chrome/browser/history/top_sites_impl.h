@@ -125,6 +125,13 @@ class TopSitesImpl : public TopSites {
                             const base::RefCountedMemory* thumbnail_data,
                             const ThumbnailScore& score);
 
+  // Returns |score| adjusted for the redirect distance of |url|, which must
+  // be known, and sets |*should_replace| to whether a thumbnail with that
+  // score would replace the cached one.
+  ThumbnailScore GetScoreForKnownURL(const GURL& url,
+                                     const ThumbnailScore& score,
+                                     bool* should_replace);
+
   // A version of SetPageThumbnail that takes RefCountedBytes as
   // returned by HistoryService.
   bool SetPageThumbnailEncoded(const GURL& url,
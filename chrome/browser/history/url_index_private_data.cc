@@ -245,22 +245,15 @@ ScoredHistoryMatches URLIndexPrivateData::HistoryItemsForTerms(
     // but this is such a rare edge case that it's not worth the time.
     return scored_items;
   }
-  scored_items = std::for_each(history_id_set.begin(), history_id_set.end(),
+  // Only the top kMaxMatches results are kept while scoring, so that the
+  // candidates which do not make the cut are never stored or copied.
+  scored_items.reserve(AutocompleteProvider::kMaxMatches);
+  std::for_each(history_id_set.begin(), history_id_set.end(),
       AddHistoryMatch(*this, languages, bookmark_service, lower_raw_string,
-                      lower_raw_terms, base::Time::Now())).ScoredMatches();
-
-  // Select and sort only the top kMaxMatches results.
-  if (scored_items.size() > AutocompleteProvider::kMaxMatches) {
-    std::partial_sort(scored_items.begin(),
-                      scored_items.begin() +
-                          AutocompleteProvider::kMaxMatches,
-                      scored_items.end(),
-                      ScoredHistoryMatch::MatchScoreGreater);
-      scored_items.resize(AutocompleteProvider::kMaxMatches);
-  } else {
-    std::sort(scored_items.begin(), scored_items.end(),
-              ScoredHistoryMatch::MatchScoreGreater);
-  }
+                      lower_raw_terms, base::Time::Now(),
+                      AutocompleteProvider::kMaxMatches, &scored_items));
+  std::sort(scored_items.begin(), scored_items.end(),
+            ScoredHistoryMatch::MatchScoreGreater);
   post_scoring_item_count_ = scored_items.size();
 
   if (was_trimmed) {
@@ -959,9 +952,12 @@ void URLIndexPrivateData::SaveCharWordMap(
     map_entry->set_char_16(iter->first);
     const WordIDSet& word_id_set(iter->second);
     map_entry->set_item_count(word_id_set.size());
+    WordID previous_word_id = 0;
     for (WordIDSet::const_iterator set_iter = word_id_set.begin();
-         set_iter != word_id_set.end(); ++set_iter)
-      map_entry->add_word_id(*set_iter);
+         set_iter != word_id_set.end(); ++set_iter) {
+      map_entry->add_word_id(*set_iter - previous_word_id);
+      previous_word_id = *set_iter;
+    }
   }
 }
 
@@ -978,9 +974,12 @@ void URLIndexPrivateData::SaveWordIDHistoryMap(
     map_entry->set_word_id(iter->first);
     const HistoryIDSet& history_id_set(iter->second);
     map_entry->set_item_count(history_id_set.size());
+    HistoryID previous_history_id = 0;
     for (HistoryIDSet::const_iterator set_iter = history_id_set.begin();
-         set_iter != history_id_set.end(); ++set_iter)
-      map_entry->add_history_id(*set_iter);
+         set_iter != history_id_set.end(); ++set_iter) {
+      map_entry->add_history_id(*set_iter - previous_history_id);
+      previous_history_id = *set_iter;
+    }
   }
 }
 
@@ -1120,12 +1119,17 @@ bool URLIndexPrivateData::RestoreCharWordMap(
     if (actual_item_count == 0 || actual_item_count != expected_item_count)
       return false;
     base::char16 uni_char = static_cast<base::char16>(iter->char_16());
-    WordIDSet word_id_set;
+    WordIDSet& word_id_set(char_word_map_[uni_char]);
     const RepeatedField<int32>& word_ids(iter->word_id());
+    WordID word_id = 0;
     for (RepeatedField<int32>::const_iterator jiter = word_ids.begin();
-         jiter != word_ids.end(); ++jiter)
-      word_id_set.insert(*jiter);
-    char_word_map_[uni_char] = word_id_set;
+         jiter != word_ids.end(); ++jiter) {
+      if (*jiter < 0)
+        return false;
+      // The IDs arrive in ascending order, so hint the insertion at the end.
+      word_id += *jiter;
+      word_id_set.insert(word_id_set.end(), word_id);
+    }
   }
   return true;
 }
@@ -1148,14 +1152,17 @@ bool URLIndexPrivateData::RestoreWordIDHistoryMap(
     if (actual_item_count == 0 || actual_item_count != expected_item_count)
       return false;
     WordID word_id = iter->word_id();
-    HistoryIDSet history_id_set;
+    HistoryIDSet& history_id_set(word_id_history_map_[word_id]);
     const RepeatedField<int64>& history_ids(iter->history_id());
+    HistoryID history_id = 0;
     for (RepeatedField<int64>::const_iterator jiter = history_ids.begin();
          jiter != history_ids.end(); ++jiter) {
-      history_id_set.insert(*jiter);
-      AddToHistoryIDWordMap(*jiter, word_id);
+      if (*jiter < 0)
+        return false;
+      history_id += *jiter;
+      history_id_set.insert(history_id_set.end(), history_id);
+      AddToHistoryIDWordMap(history_id, word_id);
     }
-    word_id_history_map_[word_id] = history_id_set;
   }
   return true;
 }
@@ -1277,10 +1284,14 @@ URLIndexPrivateData::AddHistoryMatch::AddHistoryMatch(
     BookmarkService* bookmark_service,
     const base::string16& lower_string,
     const String16Vector& lower_terms,
-    const base::Time now)
+    const base::Time now,
+    size_t max_matches,
+    ScoredHistoryMatches* scored_matches)
   : private_data_(private_data),
     languages_(languages),
     bookmark_service_(bookmark_service),
+    max_matches_(max_matches),
+    scored_matches_(scored_matches),
     lower_string_(lower_string),
     lower_terms_(lower_terms),
     now_(now) {}
@@ -1300,8 +1311,22 @@ void URLIndexPrivateData::AddHistoryMatch::operator()(
     ScoredHistoryMatch match(hist_item, visits, languages_, lower_string_,
                              lower_terms_, starts_pos->second, now_,
                              bookmark_service_);
-    if (match.raw_score() > 0)
-      scored_matches_.push_back(match);
+    if (match.raw_score() <= 0)
+      return;
+    if (scored_matches_->size() < max_matches_) {
+      scored_matches_->push_back(match);
+      std::push_heap(scored_matches_->begin(), scored_matches_->end(),
+                     ScoredHistoryMatch::MatchScoreGreater);
+    } else if (max_matches_ > 0 &&
+               ScoredHistoryMatch::MatchScoreGreater(
+                   match, scored_matches_->front())) {
+      // Replace the weakest match kept so far.
+      std::pop_heap(scored_matches_->begin(), scored_matches_->end(),
+                    ScoredHistoryMatch::MatchScoreGreater);
+      scored_matches_->back() = match;
+      std::push_heap(scored_matches_->begin(), scored_matches_->end(),
+                     ScoredHistoryMatch::MatchScoreGreater);
+    }
   }
 }
 
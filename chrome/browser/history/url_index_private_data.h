@@ -33,8 +33,9 @@ class HistoryDatabase;
 class InMemoryURLIndex;
 class RefCountedBool;
 
-// Current version of the cache file.
-static const int kCurrentCacheFileVersion = 4;
+// Current version of the cache file. Version 5 delta encodes the posting
+// lists of the char/word and word/history maps.
+static const int kCurrentCacheFileVersion = 5;
 
 // A structure private to InMemoryURLIndex describing its internal data and
 // providing for restoring, rebuilding and updating that internal data. As
@@ -192,7 +193,8 @@ class URLIndexPrivateData
   typedef std::map<base::string16, SearchTermCacheItem> SearchTermCacheMap;
 
   // A helper class which performs the final filter on each candidate
-  // history URL match, inserting accepted matches into |scored_matches_|.
+  // history URL match, inserting accepted matches into |scored_matches_|
+  // if they rank among the best seen so far.
   class AddHistoryMatch : public std::unary_function<HistoryID, void> {
    public:
     AddHistoryMatch(const URLIndexPrivateData& private_data,
@@ -200,18 +202,22 @@ class URLIndexPrivateData
                     BookmarkService* bookmark_service,
                     const base::string16& lower_string,
                     const String16Vector& lower_terms,
-                    const base::Time now);
+                    const base::Time now,
+                    size_t max_matches,
+                    ScoredHistoryMatches* scored_matches);
     ~AddHistoryMatch();
 
     void operator()(const HistoryID history_id);
 
-    ScoredHistoryMatches ScoredMatches() const { return scored_matches_; }
-
    private:
     const URLIndexPrivateData& private_data_;
     const std::string& languages_;
     BookmarkService* bookmark_service_;
-    ScoredHistoryMatches scored_matches_;
+    // Only the best |max_matches_| are kept. |scored_matches_| is a heap
+    // ordered by ScoredHistoryMatch::MatchScoreGreater, so its front is the
+    // weakest match kept so far.
+    const size_t max_matches_;
+    ScoredHistoryMatches* scored_matches_;
     const base::string16& lower_string_;
     const String16Vector& lower_terms_;
     const base::Time now_;
@@ -234,6 +234,21 @@ HttpServerPropertiesManager::GetServerNetworkStats(
   return http_server_properties_impl_->GetServerNetworkStats(host_port_pair);
 }
 
+void HttpServerPropertiesManager::SetPreferredAddressFamily(
+    const net::HostPortPair& host_port_pair,
+    net::AddressFamily address_family) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  http_server_properties_impl_->SetPreferredAddressFamily(host_port_pair,
+                                                          address_family);
+}
+
+net::AddressFamily HttpServerPropertiesManager::GetPreferredAddressFamily(
+    const net::HostPortPair& host_port_pair) const {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  return http_server_properties_impl_->GetPreferredAddressFamily(
+      host_port_pair);
+}
+
 net::HttpPipelinedHostCapability
 HttpServerPropertiesManager::GetPipelineCapability(
     const net::HostPortPair& origin) {
@@ -261,6 +276,33 @@ HttpServerPropertiesManager::GetPipelineCapabilityMap() const {
   return http_server_properties_impl_->GetPipelineCapabilityMap();
 }
 
+const net::ConnectionHistory*
+HttpServerPropertiesManager::GetConnectionHistory(
+    const net::HostPortPair& origin) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  return http_server_properties_impl_->GetConnectionHistory(origin);
+}
+
+void HttpServerPropertiesManager::SetConnectionHistory(
+    const net::HostPortPair& origin,
+    const net::ConnectionHistory& history) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  http_server_properties_impl_->SetConnectionHistory(origin, history);
+  ScheduleUpdatePrefsOnIO();
+}
+
+void HttpServerPropertiesManager::ClearConnectionHistory() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  http_server_properties_impl_->ClearConnectionHistory();
+  ScheduleUpdatePrefsOnIO();
+}
+
+net::ConnectionHistoryMap
+HttpServerPropertiesManager::GetConnectionHistoryMap() const {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  return http_server_properties_impl_->GetConnectionHistoryMap();
+}
+
 //
 // Update the HttpServerPropertiesImpl's cache with data from preferences.
 //
@@ -321,6 +363,8 @@ void HttpServerPropertiesManager::UpdateCacheFromPrefsOnUI() {
       new net::PipelineCapabilityMap);
   scoped_ptr<net::AlternateProtocolMap> alternate_protocol_map(
       new net::AlternateProtocolMap);
+  scoped_ptr<net::ConnectionHistoryMap> connection_history_map(
+      new net::ConnectionHistoryMap);
 
   for (base::DictionaryValue::Iterator it(*servers_dict); !it.IsAtEnd();
        it.Advance()) {
@@ -385,6 +429,26 @@ void HttpServerPropertiesManager::UpdateCacheFromPrefsOnUI() {
           static_cast<net::HttpPipelinedHostCapability>(pipeline_capability);
     }
 
+    // Get the connections used to load pages from the server.
+    const base::DictionaryValue* connection_history_dict = NULL;
+    if (server_pref_dict->GetDictionaryWithoutPathExpansion(
+        "connection_history", &connection_history_dict)) {
+      net::ConnectionHistory history;
+      int time_to_first_request_ms = 0;
+      if (connection_history_dict->GetIntegerWithoutPathExpansion(
+              "sockets_needed", &history.sockets_needed) &&
+          connection_history_dict->GetIntegerWithoutPathExpansion(
+              "time_to_first_request_ms", &time_to_first_request_ms) &&
+          history.sockets_needed > 0 && time_to_first_request_ms >= 0) {
+        history.time_to_first_request =
+            base::TimeDelta::FromMilliseconds(time_to_first_request_ms);
+        (*connection_history_map)[server] = history;
+      } else {
+        DVLOG(1) << "Malformed connection history for server: " << server_str;
+        detected_corrupted_prefs = true;
+      }
+    }
+
     // Get alternate_protocol server.
     DCHECK(!ContainsKey(*alternate_protocol_map, server));
     const base::DictionaryValue* port_alternate_protocol_dict = NULL;
@@ -434,6 +498,7 @@ void HttpServerPropertiesManager::UpdateCacheFromPrefsOnUI() {
                  base::Owned(spdy_settings_map.release()),
                  base::Owned(alternate_protocol_map.release()),
                  base::Owned(pipeline_capability_map.release()),
+                 base::Owned(connection_history_map.release()),
                  detected_corrupted_prefs));
 }
 
@@ -442,6 +507,7 @@ void HttpServerPropertiesManager::UpdateCacheFromPrefsOnIO(
     net::SpdySettingsMap* spdy_settings_map,
     net::AlternateProtocolMap* alternate_protocol_map,
     net::PipelineCapabilityMap* pipeline_capability_map,
+    net::ConnectionHistoryMap* connection_history_map,
     bool detected_corrupted_prefs) {
   // Preferences have the master data because admins might have pushed new
   // preferences. Update the cached data with new data from preferences.
@@ -467,6 +533,11 @@ void HttpServerPropertiesManager::UpdateCacheFromPrefsOnIO(
   http_server_properties_impl_->InitializePipelineCapabilities(
       pipeline_capability_map);
 
+  UMA_HISTOGRAM_COUNTS("Net.CountOfConnectionHistoryServers",
+                       connection_history_map->size());
+  http_server_properties_impl_->InitializeConnectionHistory(
+      connection_history_map);
+
   // Update the prefs with what we have read (delete all corrupted prefs).
   if (detected_corrupted_prefs)
     ScheduleUpdatePrefsOnIO();
@@ -518,6 +589,11 @@ void HttpServerPropertiesManager::UpdatePrefsFromCacheOnIO(
   *pipeline_capability_map =
       http_server_properties_impl_->GetPipelineCapabilityMap();
 
+  net::ConnectionHistoryMap* connection_history_map =
+      new net::ConnectionHistoryMap;
+  *connection_history_map =
+      http_server_properties_impl_->GetConnectionHistoryMap();
+
   // Update the preferences on the UI thread.
   BrowserThread::PostTask(
       BrowserThread::UI,
@@ -528,18 +604,20 @@ void HttpServerPropertiesManager::UpdatePrefsFromCacheOnIO(
                  base::Owned(spdy_settings_map),
                  base::Owned(alternate_protocol_map),
                  base::Owned(pipeline_capability_map),
+                 base::Owned(connection_history_map),
                  completion));
 }
 
 // A local or temporary data structure to hold |supports_spdy|, SpdySettings,
-// PortAlternateProtocolPair, and |pipeline_capability| preferences for a
-// server. This is used only in UpdatePrefsOnUI.
+// PortAlternateProtocolPair, |pipeline_capability| and ConnectionHistory
+// preferences for a server. This is used only in UpdatePrefsOnUI.
 struct ServerPref {
   ServerPref()
       : supports_spdy(false),
         settings_map(NULL),
         alternate_protocol(NULL),
-        pipeline_capability(net::PIPELINE_UNKNOWN) {
+        pipeline_capability(net::PIPELINE_UNKNOWN),
+        connection_history(NULL) {
   }
   ServerPref(bool supports_spdy,
              const net::SettingsMap* settings_map,
@@ -547,12 +625,14 @@ struct ServerPref {
       : supports_spdy(supports_spdy),
         settings_map(settings_map),
         alternate_protocol(alternate_protocol),
-        pipeline_capability(net::PIPELINE_UNKNOWN) {
+        pipeline_capability(net::PIPELINE_UNKNOWN),
+        connection_history(NULL) {
   }
   bool supports_spdy;
   const net::SettingsMap* settings_map;
   const net::PortAlternateProtocolPair* alternate_protocol;
   net::HttpPipelinedHostCapability pipeline_capability;
+  const net::ConnectionHistory* connection_history;
 };
 
 void HttpServerPropertiesManager::UpdatePrefsOnUI(
@@ -560,6 +640,7 @@ void HttpServerPropertiesManager::UpdatePrefsOnUI(
     net::SpdySettingsMap* spdy_settings_map,
     net::AlternateProtocolMap* alternate_protocol_map,
     net::PipelineCapabilityMap* pipeline_capability_map,
+    net::ConnectionHistoryMap* connection_history_map,
     const base::Closure& completion) {
 
   typedef std::map<net::HostPortPair, ServerPref> ServerPrefMap;
@@ -636,6 +717,21 @@ void HttpServerPropertiesManager::UpdatePrefsOnUI(
     }
   }
 
+  for (net::ConnectionHistoryMap::const_iterator map_it =
+           connection_history_map->begin();
+       map_it != connection_history_map->end(); ++map_it) {
+    const net::HostPortPair& server = map_it->first;
+
+    ServerPrefMap::iterator it = server_pref_map.find(server);
+    if (it == server_pref_map.end()) {
+      ServerPref server_pref;
+      server_pref.connection_history = &map_it->second;
+      server_pref_map[server] = server_pref;
+    } else {
+      it->second.connection_history = &map_it->second;
+    }
+  }
+
   // Persist the prefs::kHttpServerProperties.
   base::DictionaryValue http_server_properties_dict;
   base::DictionaryValue* servers_dict = new base::DictionaryValue;
@@ -684,6 +780,19 @@ void HttpServerPropertiesManager::UpdatePrefsOnUI(
                                    server_pref.pipeline_capability);
     }
 
+    if (server_pref.connection_history) {
+      base::DictionaryValue* connection_history_dict =
+          new base::DictionaryValue;
+      connection_history_dict->SetInteger(
+          "sockets_needed", server_pref.connection_history->sockets_needed);
+      connection_history_dict->SetInteger(
+          "time_to_first_request_ms",
+          static_cast<int>(server_pref.connection_history->
+                               time_to_first_request.InMilliseconds()));
+      server_pref_dict->SetWithoutPathExpansion("connection_history",
+                                                connection_history_dict);
+    }
+
     servers_dict->SetWithoutPathExpansion(server.ToString(), server_pref_dict);
   }
 
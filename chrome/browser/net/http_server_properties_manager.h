@@ -147,6 +147,13 @@ class HttpServerPropertiesManager
   virtual const NetworkStats* GetServerNetworkStats(
       const net::HostPortPair& host_port_pair) const OVERRIDE;
 
+  virtual void SetPreferredAddressFamily(
+      const net::HostPortPair& host_port_pair,
+      net::AddressFamily address_family) OVERRIDE;
+
+  virtual net::AddressFamily GetPreferredAddressFamily(
+      const net::HostPortPair& host_port_pair) const OVERRIDE;
+
   virtual net::HttpPipelinedHostCapability GetPipelineCapability(
       const net::HostPortPair& origin) OVERRIDE;
 
@@ -158,6 +165,17 @@ class HttpServerPropertiesManager
 
   virtual net::PipelineCapabilityMap GetPipelineCapabilityMap() const OVERRIDE;
 
+  virtual const net::ConnectionHistory* GetConnectionHistory(
+      const net::HostPortPair& origin) OVERRIDE;
+
+  virtual void SetConnectionHistory(
+      const net::HostPortPair& origin,
+      const net::ConnectionHistory& history) OVERRIDE;
+
+  virtual void ClearConnectionHistory() OVERRIDE;
+
+  virtual net::ConnectionHistoryMap GetConnectionHistoryMap() const OVERRIDE;
+
  protected:
   // --------------------
   // SPDY related methods
@@ -183,6 +201,7 @@ class HttpServerPropertiesManager
       net::SpdySettingsMap* spdy_settings_map,
       net::AlternateProtocolMap* alternate_protocol_map,
       net::PipelineCapabilityMap* pipeline_capability_map,
+      net::ConnectionHistoryMap* connection_history_map,
       bool detected_corrupted_prefs);
 
   // These are used to delay updating the preferences when cached data in
@@ -210,6 +229,7 @@ class HttpServerPropertiesManager
       net::SpdySettingsMap* spdy_settings_map,
       net::AlternateProtocolMap* alternate_protocol_map,
       net::PipelineCapabilityMap* pipeline_capability_map,
+      net::ConnectionHistoryMap* connection_history_map,
       const base::Closure& completion);
 
  private:
@@ -61,17 +61,19 @@ class TestingHttpServerPropertiesManager : public HttpServerPropertiesManager {
 
   MOCK_METHOD0(UpdateCacheFromPrefsOnUI, void());
   MOCK_METHOD1(UpdatePrefsFromCacheOnIO, void(const base::Closure&));
-  MOCK_METHOD5(UpdateCacheFromPrefsOnIO,
+  MOCK_METHOD6(UpdateCacheFromPrefsOnIO,
                void(std::vector<std::string>* spdy_servers,
                     net::SpdySettingsMap* spdy_settings_map,
                     net::AlternateProtocolMap* alternate_protocol_map,
                     net::PipelineCapabilityMap* pipeline_capability_map,
+                    net::ConnectionHistoryMap* connection_history_map,
                     bool detected_corrupted_prefs));
-  MOCK_METHOD4(UpdatePrefsOnUI,
+  MOCK_METHOD5(UpdatePrefsOnUI,
                void(base::ListValue* spdy_server_list,
                     net::SpdySettingsMap* spdy_settings_map,
                     net::AlternateProtocolMap* alternate_protocol_map,
-                    net::PipelineCapabilityMap* pipeline_capability_map));
+                    net::PipelineCapabilityMap* pipeline_capability_map,
+                    net::ConnectionHistoryMap* connection_history_map));
 
  private:
   DISALLOW_COPY_AND_ASSIGN(TestingHttpServerPropertiesManager);
@@ -159,6 +161,13 @@ TEST_F(HttpServerPropertiesManagerTest,
   // Set pipeline capability for www.google.com:80.
   server_pref_dict->SetInteger("pipeline_capability", net::PIPELINE_CAPABLE);
 
+  // Set up connection_history for www.google.com:80.
+  base::DictionaryValue* connection_history = new base::DictionaryValue;
+  connection_history->SetInteger("sockets_needed", 4);
+  connection_history->SetInteger("time_to_first_request_ms", 120);
+  server_pref_dict->SetWithoutPathExpansion(
+      "connection_history", connection_history);
+
   // Set the server preference for www.google.com:80.
   base::DictionaryValue* servers_dict = new base::DictionaryValue;
   servers_dict->SetWithoutPathExpansion(
@@ -232,6 +241,16 @@ TEST_F(HttpServerPropertiesManagerTest,
   EXPECT_EQ(net::PIPELINE_INCAPABLE,
             http_server_props_manager_->GetPipelineCapability(
                 net::HostPortPair::FromString("mail.google.com:80")));
+
+  // Verify connection history.
+  const net::ConnectionHistory* history =
+      http_server_props_manager_->GetConnectionHistory(
+          net::HostPortPair::FromString("www.google.com:80"));
+  ASSERT_TRUE(history);
+  EXPECT_EQ(4, history->sockets_needed);
+  EXPECT_EQ(120, history->time_to_first_request.InMilliseconds());
+  EXPECT_EQ(NULL, http_server_props_manager_->GetConnectionHistory(
+      net::HostPortPair::FromString("mail.google.com:80")));
 }
 
 TEST_F(HttpServerPropertiesManagerTest, SupportsSpdy) {
@@ -401,6 +420,29 @@ TEST_F(HttpServerPropertiesManagerTest, PipelineCapability) {
   Mock::VerifyAndClearExpectations(http_server_props_manager_.get());
 }
 
+TEST_F(HttpServerPropertiesManagerTest, ConnectionHistory) {
+  ExpectPrefsUpdate();
+
+  net::HostPortPair server("www.google.com", 80);
+  EXPECT_EQ(NULL, http_server_props_manager_->GetConnectionHistory(server));
+
+  // Post an update task to the IO thread. SetConnectionHistory calls
+  // ScheduleUpdatePrefsOnIO.
+  net::ConnectionHistory history;
+  history.sockets_needed = 3;
+  history.time_to_first_request = base::TimeDelta::FromMilliseconds(250);
+  http_server_props_manager_->SetConnectionHistory(server, history);
+
+  // Run the task.
+  loop_.RunUntilIdle();
+
+  const net::ConnectionHistory* history_ret =
+      http_server_props_manager_->GetConnectionHistory(server);
+  ASSERT_TRUE(history_ret);
+  EXPECT_TRUE(history.Equals(*history_ret));
+  Mock::VerifyAndClearExpectations(http_server_props_manager_.get());
+}
+
 TEST_F(HttpServerPropertiesManagerTest, Clear) {
   ExpectPrefsUpdate();
 
@@ -106,11 +106,12 @@ class Predictor::LookupRequest {
 
     // Make a note that this is a speculative resolve request. This allows us
     // to separate it from real navigations in the observer's callback, and
-    // lets the HostResolver know it can de-prioritize it.
+    // lets the HostResolver run it at IDLE priority, behind real requests,
+    // while sharing any job already in flight for the same host.
     resolve_info.set_is_speculative(true);
     return resolver_.Resolve(
         resolve_info,
-        net::DEFAULT_PRIORITY,
+        net::IDLE,
         &addresses_,
         base::Bind(&LookupRequest::OnLookupFinished, base::Unretained(this)),
         net::BoundNetLog());
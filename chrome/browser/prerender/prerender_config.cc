@@ -7,6 +7,8 @@
 namespace prerender {
 
 Config::Config() : max_bytes(150 * 1024 * 1024),
+                   max_cpu_time(base::TimeDelta::FromSeconds(10)),
+                   max_network_bytes(25 * 1024 * 1024),
                    max_link_concurrency(1),
                    max_link_concurrency_per_launcher(1),
                    rate_limit_enabled(true),
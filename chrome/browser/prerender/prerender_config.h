@@ -19,6 +19,14 @@ struct Config {
   // Maximum memory use for a prerendered page until it is killed.
   size_t max_bytes;
 
+  // Maximum CPU time the render process of a prerendered page may use until
+  // it is killed.
+  base::TimeDelta max_cpu_time;
+
+  // Maximum number of bytes a prerendered page may fetch over the network
+  // until it is killed.
+  int64 max_network_bytes;
+
   // Number of simultaneous prerender pages from link elements allowed. Enforced
   // by PrerenderLinkManager.
   size_t max_link_concurrency;
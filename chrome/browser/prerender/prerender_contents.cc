@@ -712,15 +712,35 @@ base::ProcessMetrics* PrerenderContents::MaybeGetProcessMetrics() {
 }
 
 void PrerenderContents::DestroyWhenUsingTooManyResources() {
+  const Config& config = prerender_manager_->config();
+  if (network_bytes_ > config.max_network_bytes) {
+    Destroy(FINAL_STATUS_NETWORK_LIMIT_EXCEEDED);
+    return;
+  }
+
   base::ProcessMetrics* metrics = MaybeGetProcessMetrics();
   if (metrics == NULL)
     return;
 
   size_t private_bytes, shared_bytes;
   if (metrics->GetMemoryBytes(&private_bytes, &shared_bytes) &&
-      private_bytes > prerender_manager_->config().max_bytes) {
+      private_bytes > config.max_bytes) {
     Destroy(FINAL_STATUS_MEMORY_LIMIT_EXCEEDED);
+    return;
+  }
+
+  // GetCPUUsage() returns the usage since it was last called, so scale it by
+  // the time since then to accumulate the CPU time used. The first call only
+  // starts the measurement.
+  const base::TimeTicks now = base::TimeTicks::Now();
+  const double cpu_usage = metrics->GetCPUUsage();
+  if (!last_cpu_sample_time_.is_null()) {
+    cpu_time_ += base::TimeDelta::FromMicroseconds(static_cast<int64>(
+        (now - last_cpu_sample_time_).InMicroseconds() * cpu_usage / 100));
   }
+  last_cpu_sample_time_ = now;
+  if (cpu_time_ > config.max_cpu_time)
+    Destroy(FINAL_STATUS_CPU_LIMIT_EXCEEDED);
 }
 
 WebContents* PrerenderContents::ReleasePrerenderContents() {
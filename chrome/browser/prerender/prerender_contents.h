@@ -153,8 +153,8 @@ class PrerenderContents : public content::NotificationObserver,
       const gfx::Size& size,
       content::SessionStorageNamespace* session_storage_namespace);
 
-  // Verifies that the prerendering is not using too many resources, and kills
-  // it if not.
+  // Verifies that the prerendering is not using too much memory, CPU time or
+  // network bandwidth, and kills it if it is.
   void DestroyWhenUsingTooManyResources();
 
   content::RenderViewHost* GetRenderViewHostMutable();
@@ -426,6 +426,12 @@ class PrerenderContents : public content::NotificationObserver,
   // RenderViewHost for this object.
   scoped_ptr<base::ProcessMetrics> process_metrics_;
 
+  // CPU time used by the render process so far, as sampled from
+  // |process_metrics_| by DestroyWhenUsingTooManyResources(), and when it
+  // was last sampled.
+  base::TimeDelta cpu_time_;
+  base::TimeTicks last_cpu_sample_time_;
+
   scoped_ptr<WebContentsDelegateImpl> web_contents_delegate_;
 
   // These are -1 before a RenderView is created.
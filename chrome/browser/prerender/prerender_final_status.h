@@ -60,6 +60,8 @@ enum FinalStatus {
   FINAL_STATUS_BAD_DEFERRED_REDIRECT = 45,
   FINAL_STATUS_NAVIGATION_UNCOMMITTED = 46,
   FINAL_STATUS_NEW_NAVIGATION_ENTRY = 47,
+  FINAL_STATUS_CPU_LIMIT_EXCEEDED = 48,
+  FINAL_STATUS_NETWORK_LIMIT_EXCEEDED = 49,
   FINAL_STATUS_MAX,
 };
 
@@ -50,13 +50,40 @@ const int kMaxRasterSizeInPixels = 16*1024*1024;
 
 namespace printing {
 
+#if defined(OS_WIN)
+// A page whose metafile is rasterized on the blocking pool. Pages are
+// rasterized concurrently, bounded by the pool's thread count; the print job
+// worker already waits for pages that haven't arrived yet.
+struct PrintViewManagerBase::RasterPage {
+  RasterPage(const PrintHostMsg_DidPrintPage_Params& params,
+             scoped_ptr<NativeMetafile> metafile,
+             bool big_emf)
+      : page_number(params.page_number),
+        actual_shrink(params.actual_shrink),
+        page_size(params.page_size),
+        content_area(params.content_area),
+        big_emf(big_emf),
+        metafile(metafile.Pass()) {}
+
+  int page_number;
+  double actual_shrink;
+  gfx::Size page_size;
+  gfx::Rect content_area;
+  // Whether the page is too big to be printed as an EMF if rasterizing fails.
+  bool big_emf;
+  scoped_ptr<NativeMetafile> metafile;
+  scoped_ptr<NativeMetafile> raster_metafile;
+};
+#endif
+
 PrintViewManagerBase::PrintViewManagerBase(content::WebContents* web_contents)
     : content::WebContentsObserver(web_contents),
       number_pages_(0),
       printing_succeeded_(false),
       inside_inner_message_loop_(false),
       cookie_(0),
-      queue_(g_browser_process->print_job_manager()->queue()) {
+      queue_(g_browser_process->print_job_manager()->queue()),
+      weak_ptr_factory_(this) {
   DCHECK(queue_);
 #if defined(OS_POSIX) && !defined(OS_MACOSX)
   expecting_first_page_ = true;
@@ -167,17 +194,17 @@ void PrintViewManagerBase::OnDidPrintPage(
   int raster_size = std::min(params.page_size.GetArea(),
                              kMaxRasterSizeInPixels);
   if (big_emf || (cmdline && cmdline->HasSwitch(switches::kPrintRaster))) {
-    scoped_ptr<NativeMetafile> raster_metafile(
-        metafile->RasterizeMetafile(raster_size));
-    if (raster_metafile.get()) {
-      metafile.swap(raster_metafile);
-    } else if (big_emf) {
-      // Don't fall back to emf here.
-      NOTREACHED() << "size:" << params.data_size;
-      TerminatePrintJob(true);
-      web_contents()->Stop();
-      return;
-    }
+    // Rasterizing takes long for big pages, so do it off the UI thread. The
+    // page is added to |document| once done.
+    RasterPage* page = new RasterPage(params, metafile.Pass(), big_emf);
+    BrowserThread::GetBlockingPool()->PostTaskAndReply(
+        FROM_HERE,
+        base::Bind(&RasterizePage, page, raster_size),
+        base::Bind(&PrintViewManagerBase::OnPageRasterized,
+                   weak_ptr_factory_.GetWeakPtr(),
+                   make_scoped_refptr(document),
+                   base::Owned(page)));
+    return;
   }
 #endif
 
@@ -191,6 +218,41 @@ void PrintViewManagerBase::OnDidPrintPage(
   ShouldQuitFromInnerMessageLoop();
 }
 
+#if defined(OS_WIN)
+// static
+void PrintViewManagerBase::RasterizePage(RasterPage* page, int raster_size) {
+  page->raster_metafile.reset(page->metafile->RasterizeMetafile(raster_size));
+}
+
+void PrintViewManagerBase::OnPageRasterized(
+    scoped_refptr<PrintedDocument> document,
+    RasterPage* page) {
+  const bool is_current_document =
+      print_job_.get() && print_job_->document() == document.get();
+
+  if (page->raster_metafile) {
+    page->metafile.swap(page->raster_metafile);
+  } else if (page->big_emf) {
+    // Don't fall back to emf here.
+    NOTREACHED() << "page:" << page->page_number;
+    if (is_current_document) {
+      TerminatePrintJob(true);
+      web_contents()->Stop();
+    }
+    return;
+  }
+
+  document->SetPage(page->page_number,
+                    page->metafile.release(),
+                    page->actual_shrink,
+                    page->page_size,
+                    page->content_area);
+
+  if (is_current_document)
+    ShouldQuitFromInnerMessageLoop();
+}
+#endif
+
 void PrintViewManagerBase::OnPrintingFailed(int cookie) {
   if (cookie != cookie_) {
     NOTREACHED();
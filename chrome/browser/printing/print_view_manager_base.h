@@ -6,6 +6,7 @@
 #define CHROME_BROWSER_PRINTING_PRINT_VIEW_MANAGER_BASE_H_
 
 #include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
 #include "base/prefs/pref_member.h"
 #include "base/strings/string16.h"
 #include "content/public/browser/notification_observer.h"
@@ -23,6 +24,7 @@ class RenderViewHost;
 namespace printing {
 
 class JobEventDetails;
+class PrintedDocument;
 class PrintJob;
 class PrintJobWorkerOwner;
 class PrintQueriesQueue;
@@ -78,6 +80,18 @@ class PrintViewManagerBase : public content::NotificationObserver,
   void OnDidGetDocumentCookie(int cookie);
   void OnDidPrintPage(const PrintHostMsg_DidPrintPage_Params& params);
 
+#if defined(OS_WIN)
+  struct RasterPage;
+
+  // Rasterizes |page|'s metafile. Runs on the blocking pool.
+  static void RasterizePage(RasterPage* page, int raster_size);
+
+  // Called on the UI thread once |page|'s metafile has been rasterized on the
+  // blocking pool. Adds the page to |document|.
+  void OnPageRasterized(scoped_refptr<PrintedDocument> document,
+                        RasterPage* page);
+#endif
+
   // Processes a NOTIFY_PRINT_JOB_EVENT notification.
   void OnNotifyPrintJobEvent(const JobEventDetails& event_details);
 
@@ -158,6 +172,9 @@ class PrintViewManagerBase : public content::NotificationObserver,
 
   scoped_refptr<printing::PrintQueriesQueue> queue_;
 
+  // Used for replies from tasks posted to other threads.
+  base::WeakPtrFactory<PrintViewManagerBase> weak_ptr_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(PrintViewManagerBase);
 };
 
@@ -486,6 +486,7 @@ Profile* ProfileManager::GetLastUsedProfile(
   return GetProfile(GetLastUsedProfileDir(user_data_dir));
 }
 
+// static
 base::FilePath ProfileManager::GetLastUsedProfileDir(
     const base::FilePath& user_data_dir) {
   base::FilePath last_used_profile_dir(user_data_dir);
@@ -104,7 +104,8 @@ class ProfileManager : public base::NonThreadSafe,
 
   // Get the path of the last used profile, or if that's undefined, the default
   // profile.
-  base::FilePath GetLastUsedProfileDir(const base::FilePath& user_data_dir);
+  static base::FilePath GetLastUsedProfileDir(
+      const base::FilePath& user_data_dir);
 
   // Get the Profiles which are currently open, i.e., have open browsers, or
   // were open the last time Chrome was running. The Profiles appear in the
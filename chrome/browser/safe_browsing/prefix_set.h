@@ -45,16 +45,23 @@
 //     n * 8 byte |&index_[0]..&index_[n]|
 //     m * 2 byte |&deltas_[0]..&deltas_[m]|
 //        16 byte digest
+//
+// Sets loaded from disk map the file rather than copying it to the
+// heap, so the pages are clean and can be discarded under memory
+// pressure.  |WriteFile()| writes to a temporary file and renames it
+// into place, so an existing mapping of the same file stays valid.
 
 #ifndef CHROME_BROWSER_SAFE_BROWSING_PREFIX_SET_H_
 #define CHROME_BROWSER_SAFE_BROWSING_PREFIX_SET_H_
 
 #include <vector>
 
+#include "base/memory/scoped_ptr.h"
 #include "chrome/browser/safe_browsing/safe_browsing_util.h"
 
 namespace base {
 class FilePath;
+class MemoryMappedFile;
 }
 
 namespace safe_browsing {
@@ -90,6 +97,16 @@ class PrefixSet {
   // |deltas| using |swap()|.
   PrefixSet(IndexVector* index, std::vector<uint16>* deltas);
 
+  // Helper for |LoadFile()|.  Takes ownership of |mapped_file|, and
+  // serves lookups from the |index_size| pairs at |index| and the
+  // |deltas_size| deltas at |deltas|, both of which point into it.
+  PrefixSet(base::MemoryMappedFile* mapped_file,
+            const IndexPair* index, size_t index_size,
+            const uint16* deltas, size_t deltas_size);
+
+  // Point the views below at |index_| and |deltas_|.
+  void UseVectors();
+
   // Top-level index of prefix to offset in |deltas_|.  Each pair
   // indicates a base prefix and where the deltas from that prefix
   // begin in |deltas_|.  The deltas for a pair end at the next pair's
@@ -101,6 +118,17 @@ class PrefixSet {
   // |index_|, or the end of |deltas_| for the last |index_| pair.
   std::vector<uint16> deltas_;
 
+  // When loaded from disk, the file the views below point into.
+  // |index_| and |deltas_| are empty in that case.
+  scoped_ptr<base::MemoryMappedFile> mapped_file_;
+
+  // The data all accessors use, either from the vectors above or from
+  // |mapped_file_|.
+  const IndexPair* index_data_;
+  size_t index_size_;
+  const uint16* deltas_data_;
+  size_t deltas_size_;
+
   DISALLOW_COPY_AND_ASSIGN(PrefixSet);
 };
 
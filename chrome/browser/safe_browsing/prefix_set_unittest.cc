@@ -367,6 +367,30 @@ TEST_F(PrefixSetTest, ReadWrite) {
   }
 }
 
+// Rewriting the file under a loaded set should not disturb the set.
+TEST_F(PrefixSetTest, RewriteWhileLoaded) {
+  base::FilePath filename;
+  ASSERT_TRUE(GetPrefixSetFile(&filename));
+
+  scoped_ptr<safe_browsing::PrefixSet>
+      prefix_set(safe_browsing::PrefixSet::LoadFile(filename));
+  ASSERT_TRUE(prefix_set.get());
+
+  std::vector<SBPrefix> prefixes;
+  prefixes.push_back(17);
+  prefixes.push_back(100042);
+  safe_browsing::PrefixSet prefix_set_to_write(prefixes);
+  ASSERT_TRUE(prefix_set_to_write.WriteFile(filename));
+
+  CheckPrefixes(*prefix_set, shared_prefixes_);
+
+  // A set loaded from disk can itself be written out.
+  ASSERT_TRUE(prefix_set->WriteFile(filename));
+  prefix_set.reset(safe_browsing::PrefixSet::LoadFile(filename));
+  ASSERT_TRUE(prefix_set.get());
+  CheckPrefixes(*prefix_set, shared_prefixes_);
+}
+
 // Check that |CleanChecksum()| makes an acceptable checksum.
 TEST_F(PrefixSetTest, CorruptionHelpers) {
   base::FilePath filename;
@@ -1462,6 +1462,10 @@ void SafeBrowsingDatabaseNew::UpdateBrowseStore() {
     browse_prefix_set_.swap(prefix_set);
   }
 
+  // The old set may have the file mapped, which prevents replacing it on
+  // some platforms.
+  prefix_set.reset();
+
   DVLOG(1) << "SafeBrowsingDatabaseImpl built prefix set in "
            << (base::TimeTicks::Now() - before).InMilliseconds()
            << " ms total.  prefix count: " << add_prefixes.size();
@@ -1532,6 +1536,7 @@ void SafeBrowsingDatabaseNew::UpdateSideEffectFreeWhitelistStore() {
     base::AutoLock locked(lookup_lock_);
     side_effect_free_whitelist_prefix_set_.swap(prefix_set);
   }
+  prefix_set.reset();
 
   const base::TimeTicks before = base::TimeTicks::Now();
   const bool write_ok = side_effect_free_whitelist_prefix_set_->WriteFile(
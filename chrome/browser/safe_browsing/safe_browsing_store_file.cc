@@ -6,6 +6,7 @@
 
 #include "base/md5.h"
 #include "base/metrics/histogram.h"
+#include "base/time/time.h"
 
 namespace {
 
@@ -28,6 +29,11 @@ struct ChunkHeader {
   uint32 add_hash_count, sub_hash_count;
 };
 
+// Containers are read and written this many items at a time, which
+// amortizes the stdio and checksum overhead while keeping the staging
+// buffer small.
+const size_t kIOBatchItems = 1024;
+
 // Rewind the file.  Using fseek(2) because rewind(3) errors are
 // weird.
 bool FileRewind(FILE* fp) {
@@ -89,14 +95,26 @@ bool ReadToContainer(CT* values, size_t count, FILE* fp,
   if (!count)
     return true;
 
-  for (size_t i = 0; i < count; ++i) {
-    typename CT::value_type value;
-    if (!ReadItem(&value, fp, context))
+  typedef typename CT::value_type ValueType;
+  std::vector<ValueType> batch(std::min(count, kIOBatchItems));
+  while (count) {
+    const size_t batch_count = std::min(count, batch.size());
+    const size_t ret = fread(&batch[0], sizeof(ValueType), batch_count, fp);
+    if (ret != batch_count)
       return false;
 
+    if (context) {
+      base::MD5Update(context,
+                      base::StringPiece(reinterpret_cast<char*>(&batch[0]),
+                                        batch_count * sizeof(ValueType)));
+    }
+
     // push_back() is more obvious, but coded this way std::set can
     // also be read.
-    values->insert(values->end(), value);
+    for (size_t i = 0; i < batch_count; ++i) {
+      values->insert(values->end(), batch[i]);
+    }
+    count -= batch_count;
   }
 
   return true;
@@ -110,10 +128,26 @@ bool WriteContainer(const CT& values, FILE* fp,
   if (values.empty())
     return true;
 
-  for (typename CT::const_iterator iter = values.begin();
-       iter != values.end(); ++iter) {
-    if (!WriteItem(*iter, fp, context))
+  typedef typename CT::value_type ValueType;
+  std::vector<ValueType> batch;
+  batch.reserve(std::min(values.size(), kIOBatchItems));
+  typename CT::const_iterator iter = values.begin();
+  while (iter != values.end()) {
+    batch.clear();
+    for (; iter != values.end() && batch.size() < kIOBatchItems; ++iter) {
+      batch.push_back(*iter);
+    }
+
+    const size_t ret = fwrite(&batch[0], sizeof(ValueType), batch.size(), fp);
+    if (ret != batch.size())
       return false;
+
+    if (context) {
+      base::MD5Update(context,
+                      base::StringPiece(
+                          reinterpret_cast<const char*>(&batch[0]),
+                          batch.size() * sizeof(ValueType)));
+    }
   }
   return true;
 }
@@ -483,11 +517,59 @@ bool SafeBrowsingStoreFile::DoUpdate(
   CHECK(add_prefixes_result);
   CHECK(add_full_hashes_result);
 
+  const base::TimeTicks before = base::TimeTicks::Now();
+
   SBAddPrefixes add_prefixes;
   SBSubPrefixes sub_prefixes;
   std::vector<SBAddFullHash> add_full_hashes;
   std::vector<SBSubFullHash> sub_full_hashes;
 
+  // Rewind the temporary storage.
+  if (!FileRewind(new_file_.get()))
+    return false;
+
+  // Get chunk file's size for validating counts.
+  int64 size = 0;
+  if (!base::GetFileSize(TemporaryFileForFilename(filename_), &size))
+    return OnCorruptDatabase();
+
+  // Track update size to answer questions at http://crbug.com/72216 .
+  // Log small updates as 1k so that the 0 (underflow) bucket can be
+  // used for "empty" in SafeBrowsingDatabase.
+  UMA_HISTOGRAM_COUNTS("SB2.DatabaseUpdateKilobytes",
+                       std::max(static_cast<int>(size / 1024), 1));
+
+  // Total up the full hashes in the accumulated chunks, so that the
+  // vectors can be sized once rather than repeatedly growing (and
+  // briefly holding two copies) as data is appended.
+  size_t add_hash_count = pending_adds.size();
+  size_t sub_hash_count = 0;
+  for (int i = 0; i < chunks_written_; ++i) {
+    ChunkHeader header;
+
+    int64 ofs = ftell(new_file_.get());
+    if (ofs == -1)
+      return false;
+
+    if (!ReadItem(&header, new_file_.get(), NULL))
+      return false;
+
+    // As a safety measure, make sure that the header describes a sane
+    // chunk, given the remaining file size.
+    const size_t payload_size =
+        header.add_prefix_count * sizeof(SBAddPrefix) +
+        header.sub_prefix_count * sizeof(SBSubPrefix) +
+        header.add_hash_count * sizeof(SBAddFullHash) +
+        header.sub_hash_count * sizeof(SBSubFullHash);
+    if (ofs + static_cast<int64>(sizeof(ChunkHeader) + payload_size) > size)
+      return false;
+
+    add_hash_count += header.add_hash_count;
+    sub_hash_count += header.sub_hash_count;
+    if (!FileSkip(payload_size, new_file_.get()))
+      return false;
+  }
+
   // Read original data into the vectors.
   if (!empty_) {
     DCHECK(file_.get());
@@ -512,6 +594,13 @@ bool SafeBrowsingStoreFile::DoUpdate(
                          file_.get(), &context))
       return OnCorruptDatabase();
 
+    // The header was checked against the file size, so these counts
+    // are sane.
+    add_hash_count += header.add_hash_count;
+    sub_hash_count += header.sub_hash_count;
+    add_full_hashes.reserve(add_hash_count);
+    sub_full_hashes.reserve(sub_hash_count);
+
     if (!ReadToContainer(&add_prefixes, header.add_prefix_count,
                          file_.get(), &context) ||
         !ReadToContainer(&sub_prefixes, header.sub_prefix_count,
@@ -541,42 +630,19 @@ bool SafeBrowsingStoreFile::DoUpdate(
   }
   DCHECK(!file_.get());
 
-  // Rewind the temporary storage.
+  // Rewind the temporary storage again, the counts were validated
+  // above.
   if (!FileRewind(new_file_.get()))
     return false;
-
-  // Get chunk file's size for validating counts.
-  int64 size = 0;
-  if (!base::GetFileSize(TemporaryFileForFilename(filename_), &size))
-    return OnCorruptDatabase();
-
-  // Track update size to answer questions at http://crbug.com/72216 .
-  // Log small updates as 1k so that the 0 (underflow) bucket can be
-  // used for "empty" in SafeBrowsingDatabase.
-  UMA_HISTOGRAM_COUNTS("SB2.DatabaseUpdateKilobytes",
-                       std::max(static_cast<int>(size / 1024), 1));
+  add_full_hashes.reserve(add_hash_count);
+  sub_full_hashes.reserve(sub_hash_count);
 
   // Append the accumulated chunks onto the vectors read from |file_|.
   for (int i = 0; i < chunks_written_; ++i) {
     ChunkHeader header;
-
-    int64 ofs = ftell(new_file_.get());
-    if (ofs == -1)
-      return false;
-
     if (!ReadItem(&header, new_file_.get(), NULL))
       return false;
 
-    // As a safety measure, make sure that the header describes a sane
-    // chunk, given the remaining file size.
-    int64 expected_size = ofs + sizeof(ChunkHeader);
-    expected_size += header.add_prefix_count * sizeof(SBAddPrefix);
-    expected_size += header.sub_prefix_count * sizeof(SBSubPrefix);
-    expected_size += header.add_hash_count * sizeof(SBAddFullHash);
-    expected_size += header.sub_hash_count * sizeof(SBSubFullHash);
-    if (expected_size > size)
-      return false;
-
     // TODO(shess): If the vectors were kept sorted, then this code
     // could use std::inplace_merge() to merge everything together in
     // sorted order.  That might still be slower than just sorting at
@@ -599,6 +665,16 @@ bool SafeBrowsingStoreFile::DoUpdate(
   add_full_hashes.insert(add_full_hashes.end(),
                          pending_adds.begin(), pending_adds.end());
 
+  // Everything is in memory at this point, which is the high-water mark
+  // for the update.
+  const size_t peak_bytes =
+      add_prefixes.size() * sizeof(SBAddPrefix) +
+      sub_prefixes.size() * sizeof(SBSubPrefix) +
+      add_full_hashes.capacity() * sizeof(SBAddFullHash) +
+      sub_full_hashes.capacity() * sizeof(SBSubFullHash);
+  UMA_HISTOGRAM_COUNTS("SB2.StoreUpdatePeakKilobytes",
+                       static_cast<int>(peak_bytes / 1024));
+
   // Knock the subs from the adds and process deleted chunks.
   SBProcessSubs(&add_prefixes, &sub_prefixes,
                 &add_full_hashes, &sub_full_hashes,
@@ -660,6 +736,7 @@ bool SafeBrowsingStoreFile::DoUpdate(
   // Record counts before swapping to caller.
   UMA_HISTOGRAM_COUNTS("SB2.AddPrefixes", add_prefixes.size());
   UMA_HISTOGRAM_COUNTS("SB2.SubPrefixes", sub_prefixes.size());
+  UMA_HISTOGRAM_LONG_TIMES("SB2.StoreUpdate", base::TimeTicks::Now() - before);
 
   // Pass the resulting data off to the caller.
   add_prefixes_result->swap(add_prefixes);
@@ -306,42 +306,48 @@ bool SessionBackend::ReadCurrentSessionCommandsImpl(
 
 bool SessionBackend::AppendCommandsToFile(net::FileStream* file,
     const std::vector<SessionCommand*>& commands) {
+  // Serialize all of the commands first so that they are written with a
+  // single write, rather than three writes per command. A snapshot of a large
+  // session holds thousands of commands.
+  std::string buffer;
+  size_t buffer_size = 0;
+  for (std::vector<SessionCommand*>::const_iterator i = commands.begin();
+       i != commands.end(); ++i) {
+    buffer_size += sizeof(size_type) + sizeof(id_type) + (*i)->size();
+  }
+  buffer.reserve(buffer_size);
+
   for (std::vector<SessionCommand*>::const_iterator i = commands.begin();
        i != commands.end(); ++i) {
-    int wrote;
     const size_type content_size = static_cast<size_type>((*i)->size());
     const size_type total_size =  content_size + sizeof(id_type);
     if (type_ == BaseSessionService::TAB_RESTORE)
       UMA_HISTOGRAM_COUNTS("TabRestore.command_size", total_size);
     else
       UMA_HISTOGRAM_COUNTS("SessionRestore.command_size", total_size);
-    wrote = file->WriteSync(reinterpret_cast<const char*>(&total_size),
-                            sizeof(total_size));
-    if (wrote != sizeof(total_size)) {
-      NOTREACHED() << "error writing";
-      return false;
-    }
-    id_type command_id = (*i)->id();
-    wrote = file->WriteSync(reinterpret_cast<char*>(&command_id),
-                            sizeof(command_id));
-    if (wrote != sizeof(command_id)) {
-      NOTREACHED() << "error writing";
-      return false;
-    }
-    if (content_size > 0) {
-      wrote = file->WriteSync(reinterpret_cast<char*>((*i)->contents()),
-                              content_size);
-      if (wrote != content_size) {
-        NOTREACHED() << "error writing";
-        return false;
-      }
-    }
+    buffer.append(reinterpret_cast<const char*>(&total_size),
+                  sizeof(total_size));
+    const id_type command_id = (*i)->id();
+    buffer.append(reinterpret_cast<const char*>(&command_id),
+                  sizeof(command_id));
+    if (content_size > 0)
+      buffer.append((*i)->contents(), content_size);
+  }
+
+  if (buffer.empty())
+    return true;
+
+  const int wrote = file->WriteSync(buffer.data(),
+                                    static_cast<int>(buffer.size()));
+  if (wrote != static_cast<int>(buffer.size())) {
+    NOTREACHED() << "error writing";
+    return false;
+  }
 #if defined(OS_CHROMEOS)
-    // TODO(gspencer): Remove this once we find a better place to do it.
-    // See issue http://crbug.com/245015
-    file->FlushSync();
+  // TODO(gspencer): Remove this once we find a better place to do it.
+  // See issue http://crbug.com/245015
+  file->FlushSync();
 #endif
-  }
   return true;
 }
 
@@ -83,7 +83,10 @@ static const SessionCommand::id_type kCommandSetTabUserAgentOverride = 18;
 static const SessionCommand::id_type kCommandSessionStorageAssociated = 19;
 static const SessionCommand::id_type kCommandSetActiveWindow = 20;
 
-// Every kWritesPerReset commands triggers recreating the file.
+// Every kWritesPerReset commands triggers recreating the file. For sessions
+// whose snapshot is larger than this, the snapshot size is used instead, which
+// bounds both the file size and the bytes written to about twice the
+// snapshot.
 static const int kWritesPerReset = 250;
 
 namespace {
@@ -187,6 +190,7 @@ SessionService::SessionService(Profile* profile)
     : BaseSessionService(SESSION_RESTORE, profile, base::FilePath()),
       has_open_trackable_browsers_(false),
       move_on_new_browser_(false),
+      commands_per_reset_(kWritesPerReset),
       save_delay_in_millis_(base::TimeDelta::FromMilliseconds(2500)),
       save_delay_in_mins_(base::TimeDelta::FromMinutes(10)),
       save_delay_in_hrs_(base::TimeDelta::FromHours(8)),
@@ -198,6 +202,7 @@ SessionService::SessionService(const base::FilePath& save_path)
     : BaseSessionService(SESSION_RESTORE, NULL, save_path),
       has_open_trackable_browsers_(false),
       move_on_new_browser_(false),
+      commands_per_reset_(kWritesPerReset),
       save_delay_in_millis_(base::TimeDelta::FromMilliseconds(2500)),
       save_delay_in_mins_(base::TimeDelta::FromMinutes(10)),
       save_delay_in_hrs_(base::TimeDelta::FromHours(8)),
@@ -1409,6 +1414,8 @@ void SessionService::ScheduleReset() {
   windows_tracking_.clear();
   BuildCommandsFromBrowsers(&pending_commands(), &tab_to_available_range_,
                             &windows_tracking_);
+  commands_per_reset_ = std::max(kWritesPerReset,
+                                 static_cast<int>(pending_commands().size()));
   if (!windows_tracking_.empty()) {
     // We're lazily created on startup and won't get an initial batch of
     // SetWindowType messages. Set these here to make sure our state is correct.
@@ -1481,7 +1488,7 @@ void SessionService::ScheduleCommand(SessionCommand* command) {
   // Don't schedule a reset on tab closed/window closed. Otherwise we may
   // lose tabs/windows we want to restore from if we exit right after this.
   if (!pending_reset() && pending_window_close_ids_.empty() &&
-      commands_since_reset() >= kWritesPerReset &&
+      commands_since_reset() >= commands_per_reset_ &&
       (command->id() != kCommandTabClosed &&
        command->id() != kCommandWindowClosed)) {
     ScheduleReset();
@@ -491,6 +491,11 @@ class SessionService : public BaseSessionService,
   // current/last session.
   bool move_on_new_browser_;
 
+  // Number of commands appended after a reset before the file is rewritten
+  // again. This is at least the size of the last snapshot, so that large
+  // sessions aren't rewritten more often than their changes justify.
+  int commands_per_reset_;
+
   // Used for reporting frequency of session altering operations.
   base::TimeTicks last_updated_tab_closed_time_;
   base::TimeTicks last_updated_nav_list_pruned_time_;
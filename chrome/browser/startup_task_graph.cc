@@ -0,0 +1,155 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/startup_task_graph.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/debug/trace_event.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/task_runner.h"
+#include "components/startup_metric_utils/startup_metric_utils.h"
+
+namespace {
+
+// Prefix of the slow startup histograms recorded for the critical path.
+const char kCriticalPathHistogramPrefix[] =
+    "Startup.SlowStartupTaskGraphCriticalPath.";
+
+// Runs |task|, and stores how long it took in |*run_time|.
+void RunTask(const std::string& name,
+             const base::Closure& task,
+             base::TimeDelta* run_time) {
+  TRACE_EVENT1("startup", "StartupTaskGraph::RunTask", "name", name);
+  const base::TimeTicks start_time = base::TimeTicks::Now();
+  task.Run();
+  *run_time = base::TimeTicks::Now() - start_time;
+}
+
+}  // namespace
+
+StartupTaskGraph::Task::Task()
+    : num_pending_dependencies(0),
+      finish_order(0) {
+}
+
+StartupTaskGraph::Task::~Task() {
+}
+
+StartupTaskGraph::StartupTaskGraph(
+    const scoped_refptr<base::TaskRunner>& task_runner)
+    : task_runner_(task_runner),
+      started_(false),
+      num_finished_(0),
+      weak_factory_(this) {
+}
+
+StartupTaskGraph::~StartupTaskGraph() {
+  DCHECK(CalledOnValidThread());
+}
+
+void StartupTaskGraph::AddTask(const std::string& name,
+                               const std::vector<std::string>& dependencies,
+                               const base::Closure& task) {
+  DCHECK(CalledOnValidThread());
+  DCHECK(!started_);
+  DCHECK(!tasks_.count(name)) << name;
+  for (std::vector<std::string>::const_iterator it = dependencies.begin();
+       it != dependencies.end(); ++it) {
+    TaskMap::iterator dependency = tasks_.find(*it);
+    DCHECK(dependency != tasks_.end()) << "Unknown dependency " << *it;
+    dependency->second.dependents.push_back(name);
+  }
+
+  Task& new_task = tasks_[name];
+  new_task.closure = task;
+  new_task.dependencies = dependencies;
+  new_task.num_pending_dependencies = dependencies.size();
+}
+
+void StartupTaskGraph::Start() {
+  DCHECK(CalledOnValidThread());
+  DCHECK(!started_);
+  started_ = true;
+  for (TaskMap::const_iterator it = tasks_.begin(); it != tasks_.end(); ++it) {
+    if (!it->second.num_pending_dependencies)
+      PostTask(it->first);
+  }
+}
+
+bool StartupTaskGraph::IsComplete() const {
+  DCHECK(CalledOnValidThread());
+  return started_ && num_finished_ == tasks_.size();
+}
+
+std::vector<std::string> StartupTaskGraph::GetCriticalPath() const {
+  DCHECK(CalledOnValidThread());
+  std::vector<std::string> critical_path;
+  if (!IsComplete())
+    return critical_path;
+
+  // Start from the task that finished last, and follow each task back to the
+  // dependency it waited for longest, the one that finished last.
+  TaskMap::const_iterator last = tasks_.end();
+  for (TaskMap::const_iterator it = tasks_.begin(); it != tasks_.end(); ++it) {
+    if (last == tasks_.end() ||
+        it->second.finish_order > last->second.finish_order) {
+      last = it;
+    }
+  }
+  while (last != tasks_.end()) {
+    critical_path.push_back(last->first);
+    const std::vector<std::string>& dependencies = last->second.dependencies;
+    last = tasks_.end();
+    for (std::vector<std::string>::const_iterator it = dependencies.begin();
+         it != dependencies.end(); ++it) {
+      TaskMap::const_iterator dependency = tasks_.find(*it);
+      if (last == tasks_.end() ||
+          dependency->second.finish_order > last->second.finish_order) {
+        last = dependency;
+      }
+    }
+  }
+  std::reverse(critical_path.begin(), critical_path.end());
+  return critical_path;
+}
+
+void StartupTaskGraph::PostTask(const std::string& name) {
+  base::TimeDelta* run_time = new base::TimeDelta;
+  task_runner_->PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&RunTask, name, tasks_[name].closure, run_time),
+      base::Bind(&StartupTaskGraph::OnTaskFinished,
+                 weak_factory_.GetWeakPtr(), name, base::Owned(run_time)));
+}
+
+void StartupTaskGraph::OnTaskFinished(const std::string& name,
+                                      base::TimeDelta* run_time) {
+  DCHECK(CalledOnValidThread());
+  Task& task = tasks_[name];
+  task.closure.Reset();
+  task.finish_order = ++num_finished_;
+  task.run_time = *run_time;
+
+  for (std::vector<std::string>::const_iterator it = task.dependents.begin();
+       it != task.dependents.end(); ++it) {
+    Task& dependent = tasks_[*it];
+    DCHECK_GT(dependent.num_pending_dependencies, 0u);
+    if (!--dependent.num_pending_dependencies)
+      PostTask(*it);
+  }
+
+  if (!IsComplete())
+    return;
+
+  const std::vector<std::string> critical_path = GetCriticalPath();
+  for (std::vector<std::string>::const_iterator it = critical_path.begin();
+       it != critical_path.end(); ++it) {
+    startup_metric_utils::RecordSlowStartupTime(
+        kCriticalPathHistogramPrefix + *it, tasks_[*it].run_time);
+  }
+}
@@ -0,0 +1,86 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CHROME_BROWSER_STARTUP_TASK_GRAPH_H_
+#define CHROME_BROWSER_STARTUP_TASK_GRAPH_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/threading/non_thread_safe.h"
+#include "base/time/time.h"
+
+namespace base {
+class TaskRunner;
+}
+
+// Runs blocking startup work that does not need the UI thread on a task
+// runner, typically the blocking pool. Each task names the tasks it depends
+// on, and is posted as soon as all of them have finished, so that independent
+// work overlaps instead of running one piece after the other.
+//
+// Once every task has run, the tasks on the critical path, the chain of
+// dependencies that finished last, are recorded as slow startup stages
+// through startup_metric_utils. Lives on the thread it was created on.
+class StartupTaskGraph : public base::NonThreadSafe {
+ public:
+  explicit StartupTaskGraph(
+      const scoped_refptr<base::TaskRunner>& task_runner);
+  ~StartupTaskGraph();
+
+  // Adds the task |name|, which runs |task| once the tasks in
+  // |dependencies| have finished. The dependencies must have been added
+  // before. Must be called before Start().
+  void AddTask(const std::string& name,
+               const std::vector<std::string>& dependencies,
+               const base::Closure& task);
+
+  // Posts the tasks without dependencies.
+  void Start();
+
+  // Returns true once every task has finished.
+  bool IsComplete() const;
+
+  // Returns the names of the tasks on the critical path, in the order they
+  // ran. Empty until the graph is complete.
+  std::vector<std::string> GetCriticalPath() const;
+
+ private:
+  struct Task {
+    Task();
+    ~Task();
+
+    base::Closure closure;
+    std::vector<std::string> dependencies;
+    std::vector<std::string> dependents;
+    size_t num_pending_dependencies;
+
+    // Set once the task finished. |finish_order| counts from 1.
+    size_t finish_order;
+    base::TimeDelta run_time;
+  };
+  typedef std::map<std::string, Task> TaskMap;
+
+  void PostTask(const std::string& name);
+
+  // Called back on the graph's thread when the task |name| has run for
+  // |*run_time|.
+  void OnTaskFinished(const std::string& name, base::TimeDelta* run_time);
+
+  scoped_refptr<base::TaskRunner> task_runner_;
+  TaskMap tasks_;
+  bool started_;
+  size_t num_finished_;
+
+  base::WeakPtrFactory<StartupTaskGraph> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupTaskGraph);
+};
+
+#endif  // CHROME_BROWSER_STARTUP_TASK_GRAPH_H_
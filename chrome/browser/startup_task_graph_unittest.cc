@@ -0,0 +1,66 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "chrome/browser/startup_task_graph.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/run_loop.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+void RecordRun(std::vector<std::string>* runs, const std::string& name) {
+  runs->push_back(name);
+}
+
+}  // namespace
+
+// Tests that tasks run once their dependencies have finished, and that the
+// critical path follows the dependencies that finished last.
+TEST(StartupTaskGraphTest, RunsInDependencyOrder) {
+  base::MessageLoop message_loop;
+  std::vector<std::string> runs;
+  StartupTaskGraph graph(message_loop.message_loop_proxy());
+
+  const std::vector<std::string> no_dependencies;
+  graph.AddTask("a", no_dependencies, base::Bind(&RecordRun, &runs, "a"));
+  graph.AddTask("b", no_dependencies, base::Bind(&RecordRun, &runs, "b"));
+  graph.AddTask("c", std::vector<std::string>(1, "a"),
+                base::Bind(&RecordRun, &runs, "c"));
+  std::vector<std::string> b_and_c;
+  b_and_c.push_back("b");
+  b_and_c.push_back("c");
+  graph.AddTask("d", b_and_c, base::Bind(&RecordRun, &runs, "d"));
+  EXPECT_FALSE(graph.IsComplete());
+  EXPECT_TRUE(graph.GetCriticalPath().empty());
+
+  graph.Start();
+  base::RunLoop().RunUntilIdle();
+  EXPECT_TRUE(graph.IsComplete());
+
+  ASSERT_EQ(4u, runs.size());
+  EXPECT_EQ("a", runs[0]);
+  EXPECT_EQ("b", runs[1]);
+  EXPECT_EQ("c", runs[2]);
+  EXPECT_EQ("d", runs[3]);
+
+  const std::vector<std::string> critical_path = graph.GetCriticalPath();
+  ASSERT_EQ(3u, critical_path.size());
+  EXPECT_EQ("a", critical_path[0]);
+  EXPECT_EQ("c", critical_path[1]);
+  EXPECT_EQ("d", critical_path[2]);
+}
+
+TEST(StartupTaskGraphTest, Empty) {
+  base::MessageLoop message_loop;
+  StartupTaskGraph graph(message_loop.message_loop_proxy());
+  graph.Start();
+  EXPECT_TRUE(graph.IsComplete());
+  EXPECT_TRUE(graph.GetCriticalPath().empty());
+}
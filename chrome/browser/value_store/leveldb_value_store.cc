@@ -13,6 +13,7 @@
 #include "base/strings/sys_string_conversions.h"
 #include "chrome/browser/value_store/value_store_util.h"
 #include "content/public/browser/browser_thread.h"
+#include "third_party/leveldatabase/src/include/leveldb/filter_policy.h"
 #include "third_party/leveldatabase/src/include/leveldb/iterator.h"
 #include "third_party/leveldatabase/src/include/leveldb/write_batch.h"
 
@@ -23,6 +24,9 @@ namespace {
 
 const char kInvalidJson[] = "Invalid JSON";
 
+// ~1% false positive rate, as recommended by leveldb.
+const int kBloomFilterBitsPerKey = 10;
+
 // Scoped leveldb snapshot which releases the snapshot on destruction.
 class ScopedSnapshot {
  public:
@@ -275,9 +279,15 @@ scoped_ptr<ValueStore::Error> LeveldbValueStore::EnsureDbIsOpen() {
   if (db_)
     return util::NoError();
 
+  // Most reads are for settings which were never written; a bloom
+  // filter lets those skip reading table blocks.
+  if (!filter_policy_)
+    filter_policy_.reset(leveldb::NewBloomFilterPolicy(kBloomFilterBitsPerKey));
+
   leveldb::Options options;
   options.max_open_files = 0;  // Use minimum.
   options.create_if_missing = true;
+  options.filter_policy = filter_policy_.get();
 
   leveldb::DB* db = NULL;
   leveldb::Status status =
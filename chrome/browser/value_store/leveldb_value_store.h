@@ -85,6 +85,8 @@ class LeveldbValueStore : public ValueStore {
   const base::FilePath db_path_;
 
   // leveldb backend.
+  // Must outlive |db_|.
+  scoped_ptr<const leveldb::FilterPolicy> filter_policy_;
   scoped_ptr<leveldb::DB> db_;
 
   DISALLOW_COPY_AND_ASSIGN(LeveldbValueStore);
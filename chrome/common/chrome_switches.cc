@@ -439,6 +439,10 @@ const char kDisableSearchButtonInOmnibox[]  =
 // Disable SPDY/3.1. This is a temporary testing flag.
 const char kDisableSpdy31[]                 = "disable-spdy31";
 
+// Disables reading the files of the last used profile ahead of time on the
+// blocking pool during startup.
+const char kDisableStartupFileWarming[]     = "disable-startup-file-warming";
+
 // Disables syncing browser data to a Google Account.
 const char kDisableSync[]                   = "disable-sync";
 
@@ -129,6 +129,7 @@ extern const char kDisableRestoreSessionState[];
 extern const char kDisableSearchButtonInOmnibox[];
 extern const char kDisableScriptedPrintThrottling[];
 extern const char kDisableSpdy31[];
+extern const char kDisableStartupFileWarming[];
 extern const char kDisableSync[];
 extern const char kDisableSyncAppSettings[];
 extern const char kDisableSyncApps[];
@@ -5,18 +5,22 @@
 #include "chrome/common/extensions/extension_file_util.h"
 
 #include <map>
+#include <utility>
 #include <vector>
 
+#include "base/containers/mru_cache.h"
 #include "base/file_util.h"
 #include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/json/json_file_value_serializer.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
 #include "base/path_service.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/synchronization/lock.h"
 #include "base/threading/thread_restrictions.h"
 #include "chrome/common/chrome_paths.h"
 #include "chrome/common/extensions/api/extension_action/action_info.h"
@@ -40,6 +44,7 @@
 using extensions::Extension;
 using extensions::ExtensionResource;
 using extensions::Manifest;
+using extensions::MessageBundle;
 
 namespace errors = extensions::manifest_errors;
 
@@ -58,6 +63,97 @@ void AddPathsFromIconSet(const ExtensionIconSet& icon_set,
   }
 }
 
+// The modification time and size of each file a message bundle is built from,
+// used to tell whether a cached bundle is still current.
+typedef std::vector<std::pair<base::Time, int64> > CatalogStamps;
+
+// Returns the stamps of the _locales folder of |extension_path| and of every
+// messages.json LoadMessageBundle() may read from it. Files that do not exist
+// get a null stamp, so adding one later also invalidates the cache.
+CatalogStamps GetCatalogStamps(const base::FilePath& extension_path,
+                               const std::string& default_locale,
+                               const std::string& application_locale) {
+  std::vector<base::FilePath> paths;
+  base::FilePath locale_path = extension_path.Append(extensions::kLocaleFolder);
+  paths.push_back(locale_path);
+
+  std::vector<std::string> locales;
+  extension_l10n_util::GetAllFallbackLocales(
+      application_locale, default_locale, &locales);
+  for (size_t i = 0; i < locales.size(); ++i) {
+    paths.push_back(locale_path.AppendASCII(locales[i])
+                        .Append(extensions::kMessagesFilename));
+  }
+
+  CatalogStamps stamps;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    base::File::Info info;
+    if (base::GetFileInfo(paths[i], &info))
+      stamps.push_back(std::make_pair(info.last_modified, info.size));
+    else
+      stamps.push_back(std::make_pair(base::Time(), -1));
+  }
+  return stamps;
+}
+
+// Keeps the message bundles built by LoadMessageBundleSubstitutionMap(), so
+// that each renderer asking for an extension's messages, and each user script
+// reload, does not list, read and parse the extension's catalogs again.
+// Entries are keyed by extension path and locales, and are dropped as soon as
+// any of the catalog files changes. Callers are on whichever thread is
+// allowed to do the file IO, hence the lock.
+class SubstitutionMapCache {
+ public:
+  SubstitutionMapCache() : entries_(kMaxEntries) {}
+
+  bool Get(const base::FilePath& extension_path,
+           const std::string& locales,
+           const CatalogStamps& stamps,
+           MessageBundle::SubstitutionMap* messages) {
+    base::AutoLock lock(lock_);
+    Entries::iterator it =
+        entries_.Get(std::make_pair(extension_path, locales));
+    if (it == entries_.end())
+      return false;
+    if (it->second.stamps != stamps) {
+      entries_.Erase(it);
+      return false;
+    }
+    *messages = it->second.messages;
+    return true;
+  }
+
+  void Put(const base::FilePath& extension_path,
+           const std::string& locales,
+           const CatalogStamps& stamps,
+           const MessageBundle::SubstitutionMap& messages) {
+    base::AutoLock lock(lock_);
+    Entry entry;
+    entry.stamps = stamps;
+    entry.messages = messages;
+    entries_.Put(std::make_pair(extension_path, locales), entry);
+  }
+
+ private:
+  // Enough for every extension of a heavily customized profile.
+  static const size_t kMaxEntries = 100;
+
+  struct Entry {
+    CatalogStamps stamps;
+    MessageBundle::SubstitutionMap messages;
+  };
+  typedef base::MRUCache<std::pair<base::FilePath, std::string>, Entry>
+      Entries;
+
+  base::Lock lock_;
+  Entries entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(SubstitutionMapCache);
+};
+
+base::LazyInstance<SubstitutionMapCache>::Leaky g_substitution_map_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 namespace extension_file_util {
@@ -440,13 +536,25 @@ SubstitutionMap* LoadMessageBundleSubstitutionMap(
     const std::string& default_locale) {
   SubstitutionMap* returnValue = new SubstitutionMap();
   if (!default_locale.empty()) {
-    // Touch disk only if extension is localized.
-    std::string error;
-    scoped_ptr<extensions::MessageBundle> bundle(
-        LoadMessageBundle(extension_path, default_locale, &error));
-
-    if (bundle.get())
-      *returnValue = *bundle->dictionary();
+    // Touch disk only if extension is localized. Checking whether the cached
+    // bundle is still current only needs a few stat() calls.
+    const std::string application_locale =
+        extension_l10n_util::CurrentLocaleOrDefault();
+    const std::string locales = default_locale + "/" + application_locale;
+    const CatalogStamps stamps =
+        GetCatalogStamps(extension_path, default_locale, application_locale);
+    if (!g_substitution_map_cache.Get().Get(
+            extension_path, locales, stamps, returnValue)) {
+      std::string error;
+      scoped_ptr<extensions::MessageBundle> bundle(
+          LoadMessageBundle(extension_path, default_locale, &error));
+
+      if (bundle.get()) {
+        *returnValue = *bundle->dictionary();
+        g_substitution_map_cache.Get().Put(
+            extension_path, locales, stamps, *returnValue);
+      }
+    }
   }
 
   // Add @@extension_id reserved message here, so it's available to
@@ -11,6 +11,8 @@
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
 #include "chrome/common/chrome_paths.h"
+#include "chrome/common/extensions/extension_l10n_util.h"
+#include "chrome/common/extensions/message_bundle.h"
 #include "extensions/common/constants.h"
 #include "extensions/common/extension.h"
 #include "extensions/common/manifest.h"
@@ -464,6 +466,43 @@ TEST_F(ExtensionFileUtilTest, CheckZeroLengthImageFile) {
                error.c_str());
 }
 
+TEST_F(ExtensionFileUtilTest, MessageBundleSubstitutionMapTracksChanges) {
+  extension_l10n_util::ScopedLocaleForTest locale("en");
+  base::ScopedTempDir temp;
+  ASSERT_TRUE(temp.CreateUniqueTempDir());
+
+  base::FilePath locale_path = temp.path()
+      .Append(extensions::kLocaleFolder)
+      .AppendASCII("en");
+  ASSERT_TRUE(base::CreateDirectory(locale_path));
+  base::FilePath messages_path =
+      locale_path.Append(extensions::kMessagesFilename);
+
+  const char messages[] = "{ \"greeting\": { \"message\": \"Hello\" } }";
+  ASSERT_TRUE(file_util::WriteFile(messages_path, messages, strlen(messages)));
+
+  scoped_ptr<extensions::MessageBundle::SubstitutionMap> map(
+      extension_file_util::LoadMessageBundleSubstitutionMap(
+          temp.path(), "the_id", "en"));
+  EXPECT_EQ("Hello", (*map)["greeting"]);
+  EXPECT_EQ("the_id", (*map)[extensions::MessageBundle::kExtensionIdKey]);
+
+  // Served again, possibly from the cache.
+  map.reset(extension_file_util::LoadMessageBundleSubstitutionMap(
+      temp.path(), "the_id", "en"));
+  EXPECT_EQ("Hello", (*map)["greeting"]);
+
+  // A changed catalog is picked up, even within the same second.
+  const char new_messages[] =
+      "{ \"greeting\": { \"message\": \"Good morning\" } }";
+  ASSERT_TRUE(file_util::WriteFile(messages_path, new_messages,
+                                   strlen(new_messages)));
+  map.reset(extension_file_util::LoadMessageBundleSubstitutionMap(
+      temp.path(), "other_id", "en"));
+  EXPECT_EQ("Good morning", (*map)["greeting"]);
+  EXPECT_EQ("other_id", (*map)[extensions::MessageBundle::kExtensionIdKey]);
+}
+
 // TODO(aa): More tests as motivation allows. Maybe steal some from
 // ExtensionService? Many of them could probably be tested here without the
 // MessageLoop shenanigans.
@@ -11,6 +11,7 @@
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/file_util.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/weak_ptr.h"
 #include "base/message_loop/message_loop.h"
 #include "base/metrics/field_trial.h"
@@ -432,6 +433,10 @@ void ChromeRenderProcessObserver::OnPurgeMemory() {
 
   v8::V8::LowMemoryNotification();
 
+  // Let the other caches, and discardable memory, go too.
+  base::MemoryPressureListener::NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL);
+
   // Tell our allocator to release any free pages it's still holding.
   base::allocator::ReleaseFreeMemory();
 
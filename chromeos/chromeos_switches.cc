@@ -108,6 +108,10 @@ const char kEnabledStubNetworkTypes[] = "enabled-stub-network-types";
 // than the kiosk app mode.
 const char kEnableKioskMode[]               = "enable-kiosk-mode";
 
+// Frees memory from background tabs before memory runs out, first by asking
+// their renderers to purge caches, and only then by discarding tabs.
+const char kEnableProactiveTabPurging[]     = "enable-proactive-tab-purging";
+
 // Enables request of tablet site (via user agent override).
 const char kEnableRequestTabletSite[]       = "enable-request-tablet-site";
 
@@ -342,13 +342,116 @@ time_t GetEndTime(const base::Time& end) {
   return end.ToTimeT();
 }
 
+// The number of field names whose values are kept in the suggestion index.
+// Forms rarely have more fields than this, so the index stays warm while the
+// user works through a form.
+const size_t kMaxIndexedNames = 64;
+
 }  // namespace
 
+// The autofill rows of a bounded set of field names, ordered by lowercased
+// value so that a case insensitive prefix query is a range lookup.
+class AutofillTable::SuggestionIndex {
+ public:
+  SuggestionIndex() {}
+
+  bool HasName(const base::string16& name) const {
+    return names_.find(name) != names_.end();
+  }
+
+  // Starts indexing |name|.  The caller adds its rows with Insert().
+  void AddName(const base::string16& name) {
+    if (names_.size() >= kMaxIndexedNames)
+      Clear();
+    names_[name];
+  }
+
+  // Adds a row, if its name is indexed.
+  void Insert(const base::string16& name,
+              int64 pair_id,
+              const base::string16& value,
+              int count) {
+    std::map<base::string16, Values>::iterator name_it = names_.find(name);
+    if (name_it == names_.end())
+      return;
+    Remove(pair_id);
+    Value row = { pair_id, value, count };
+    pairs_[pair_id] = std::make_pair(
+        &name_it->second,
+        name_it->second.insert(std::make_pair(base::i18n::ToLower(value),
+                                              row)));
+  }
+
+  void SetCount(int64 pair_id, int count) {
+    std::map<int64, Location>::iterator it = pairs_.find(pair_id);
+    if (it != pairs_.end())
+      it->second.second->second.count = count;
+  }
+
+  void Remove(int64 pair_id) {
+    std::map<int64, Location>::iterator it = pairs_.find(pair_id);
+    if (it == pairs_.end())
+      return;
+    it->second.first->erase(it->second.second);
+    pairs_.erase(it);
+  }
+
+  void Clear() {
+    names_.clear();
+    pairs_.clear();
+  }
+
+  // Fills |values| like GetFormValuesForElementName(), for an indexed |name|.
+  void GetValues(const base::string16& name,
+                 const base::string16& prefix,
+                 size_t limit,
+                 std::vector<base::string16>* values) const {
+    std::map<base::string16, Values>::const_iterator name_it =
+        names_.find(name);
+    DCHECK(name_it != names_.end());
+    const base::string16 prefix_lower = base::i18n::ToLower(prefix);
+
+    std::vector<const Value*> matches;
+    for (Values::const_iterator it =
+             name_it->second.lower_bound(prefix_lower);
+         it != name_it->second.end() &&
+             it->first.compare(0, prefix_lower.size(), prefix_lower) == 0;
+         ++it) {
+      matches.push_back(&it->second);
+    }
+
+    std::stable_sort(matches.begin(), matches.end(), &HasHigherCount);
+    values->clear();
+    for (size_t i = 0; i < matches.size() && i < limit; ++i)
+      values->push_back(matches[i]->value);
+  }
+
+ private:
+  struct Value {
+    int64 pair_id;
+    base::string16 value;
+    int count;
+  };
+  // Keyed by lowercased value.
+  typedef std::multimap<base::string16, Value> Values;
+  typedef std::pair<Values*, Values::iterator> Location;
+
+  static bool HasHigherCount(const Value* a, const Value* b) {
+    return a->count > b->count;
+  }
+
+  std::map<base::string16, Values> names_;
+  std::map<int64, Location> pairs_;
+
+  DISALLOW_COPY_AND_ASSIGN(SuggestionIndex);
+};
+
 // The maximum length allowed for form data.
 const size_t AutofillTable::kMaxDataLength = 1024;
 
 AutofillTable::AutofillTable(const std::string& app_locale)
-    : app_locale_(app_locale) {
+    : app_locale_(app_locale),
+      suggestion_index_(new SuggestionIndex) {
 }
 
 AutofillTable::~AutofillTable() {
@@ -444,38 +547,31 @@ bool AutofillTable::GetFormValuesForElementName(
     std::vector<base::string16>* values,
     int limit) {
   DCHECK(values);
-  sql::Statement s;
-
-  if (prefix.empty()) {
-    s.Assign(db_->GetUniqueStatement(
-        "SELECT value FROM autofill "
-        "WHERE name = ? "
-        "ORDER BY count DESC "
-        "LIMIT ?"));
-    s.BindString16(0, name);
-    s.BindInt(1, limit);
-  } else {
-    base::string16 prefix_lower = base::i18n::ToLower(prefix);
-    base::string16 next_prefix = prefix_lower;
-    next_prefix[next_prefix.length() - 1]++;
-
-    s.Assign(db_->GetUniqueStatement(
-        "SELECT value FROM autofill "
-        "WHERE name = ? AND "
-        "value_lower >= ? AND "
-        "value_lower < ? "
-        "ORDER BY count DESC "
-        "LIMIT ?"));
-    s.BindString16(0, name);
-    s.BindString16(1, prefix_lower);
-    s.BindString16(2, next_prefix);
-    s.BindInt(3, limit);
-  }
-
-  values->clear();
-  while (s.Step())
-    values->push_back(s.ColumnString16(0));
-  return s.Succeeded();
+  if (!LoadSuggestionsForName(name))
+    return false;
+
+  suggestion_index_->GetValues(name, prefix, std::max(limit, 0), values);
+  return true;
+}
+
+bool AutofillTable::LoadSuggestionsForName(const base::string16& name) {
+  if (suggestion_index_->HasName(name))
+    return true;
+
+  sql::Statement s(db_->GetCachedStatement(SQL_FROM_HERE,
+      "SELECT pair_id, value, count FROM autofill WHERE name = ?"));
+  s.BindString16(0, name);
+
+  suggestion_index_->AddName(name);
+  while (s.Step()) {
+    suggestion_index_->Insert(name, s.ColumnInt64(0), s.ColumnString16(1),
+                              s.ColumnInt(2));
+  }
+  if (!s.Succeeded()) {
+    suggestion_index_->Clear();
+    return false;
+  }
+  return true;
 }
 
 bool AutofillTable::HasFormElements() {
@@ -577,6 +673,7 @@ bool AutofillTable::RemoveExpiredFormElements(
   delete_times_statement.BindInt64(0, delete_end.ToTimeT());
   if (!delete_times_statement.Run())
     return false;
+  suggestion_index_->Clear();
 
   // Cull remaining entries' timestamps.
   std::vector<AutofillEntry> entries;
@@ -668,7 +765,7 @@ bool AutofillTable::GetIDAndCountOfFormElement(
   DCHECK(pair_id);
   DCHECK(count);
 
-  sql::Statement s(db_->GetUniqueStatement(
+  sql::Statement s(db_->GetCachedStatement(SQL_FROM_HERE,
       "SELECT pair_id, count FROM autofill "
       "WHERE name = ? AND value = ?"));
   s.BindString16(0, element.name);
@@ -702,18 +799,21 @@ bool AutofillTable::GetCountOfFormElement(int64 pair_id, int* count) {
 }
 
 bool AutofillTable::SetCountOfFormElement(int64 pair_id, int count) {
-  sql::Statement s(db_->GetUniqueStatement(
+  sql::Statement s(db_->GetCachedStatement(SQL_FROM_HERE,
       "UPDATE autofill SET count = ? WHERE pair_id = ?"));
   s.BindInt(0, count);
   s.BindInt64(1, pair_id);
 
-  return s.Run();
+  if (!s.Run())
+    return false;
+  suggestion_index_->SetCount(pair_id, count);
+  return true;
 }
 
 bool AutofillTable::InsertFormElement(const FormFieldData& element,
                                       int64* pair_id) {
   DCHECK(pair_id);
-  sql::Statement s(db_->GetUniqueStatement(
+  sql::Statement s(db_->GetCachedStatement(SQL_FROM_HERE,
       "INSERT INTO autofill (name, value, value_lower) VALUES (?,?,?)"));
   s.BindString16(0, element.name);
   s.BindString16(1, element.value);
@@ -723,12 +823,13 @@ bool AutofillTable::InsertFormElement(const FormFieldData& element,
     return false;
 
   *pair_id = db_->GetLastInsertRowId();
+  suggestion_index_->Insert(element.name, *pair_id, element.value, 0);
   return true;
 }
 
 bool AutofillTable::InsertPairIDAndDate(int64 pair_id,
                                         const Time& date_created) {
-  sql::Statement s(db_->GetUniqueStatement(
+  sql::Statement s(db_->GetCachedStatement(SQL_FROM_HERE,
       "INSERT INTO autofill_dates "
       "(pair_id, date_created) VALUES (?, ?)"));
   s.BindInt64(0, pair_id);
@@ -740,7 +841,7 @@ bool AutofillTable::InsertPairIDAndDate(int64 pair_id,
 bool AutofillTable::DeleteLastAccess(int64 pair_id) {
   // Inner SELECT selects the newest |date_created| for a given |pair_id|.
   // DELETE deletes only that entry.
-  sql::Statement s(db_->GetUniqueStatement(
+  sql::Statement s(db_->GetCachedStatement(SQL_FROM_HERE,
       "DELETE FROM autofill_dates WHERE pair_id = ? and date_created IN "
       "(SELECT date_created FROM autofill_dates WHERE pair_id = ? "
       "ORDER BY date_created DESC LIMIT 1)"));
@@ -758,17 +859,32 @@ bool AutofillTable::AddFormFieldValuesTime(
   // track this.  Add up to |kMaximumUniqueNames| unique entries per form.
   const size_t kMaximumUniqueNames = 256;
   std::set<base::string16> seen_names;
-  bool result = true;
+
+  // Record the whole form in one transaction, so that a submission costs a
+  // single journal sync and is never left half written.
+  sql::Transaction transaction(db_);
+  if (!transaction.Begin())
+    return false;
+
   for (std::vector<FormFieldData>::const_iterator itr = elements.begin();
        itr != elements.end(); ++itr) {
     if (seen_names.size() >= kMaximumUniqueNames)
       break;
     if (seen_names.find(itr->name) != seen_names.end())
       continue;
-    result = result && AddFormFieldValueTime(*itr, changes, time);
+    if (!AddFormFieldValueTime(*itr, changes, time)) {
+      // The rollback undoes rows the index has already seen.
+      suggestion_index_->Clear();
+      return false;
+    }
     seen_names.insert(itr->name);
   }
-  return result;
+
+  if (!transaction.Commit()) {
+    suggestion_index_->Clear();
+    return false;
+  }
+  return true;
 }
 
 bool AutofillTable::ClearAutofillEmptyValueElements() {
@@ -906,6 +1022,8 @@ bool AutofillTable::InsertAutofillEntry(const AutofillEntry& entry) {
     return false;
 
   int64 pair_id = db_->GetLastInsertRowId();
+  suggestion_index_->Insert(entry.key().name(), pair_id, entry.key().value(),
+                            entry.timestamps().size());
   for (size_t i = 0; i < entry.timestamps().size(); i++) {
     if (!InsertPairIDAndDate(pair_id, entry.timestamps()[i]))
       return false;
@@ -1360,8 +1478,10 @@ bool AutofillTable::RemoveFormElementForID(int64 pair_id) {
       "DELETE FROM autofill WHERE pair_id = ?"));
   s.BindInt64(0, pair_id);
 
-  if (s.Run())
+  if (s.Run()) {
+    suggestion_index_->Remove(pair_id);
     return RemoveFormElementForTimeRange(pair_id, Time(), Time(), NULL);
+  }
 
   return false;
 }
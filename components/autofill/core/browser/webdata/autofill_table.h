@@ -9,6 +9,7 @@
 
 #include "base/compiler_specific.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
 #include "base/strings/string16.h"
 #include "components/webdata/common/web_database_table.h"
@@ -138,8 +139,8 @@ class AutofillTable : public WebDatabaseTable {
                                 bool* update_compatible_version) OVERRIDE;
 
   // Records the form elements in |elements| in the database in the
-  // autofill table.  A list of all added and updated autofill entries
-  // is returned in the changes out parameter.
+  // autofill table, in a single transaction.  A list of all added and
+  // updated autofill entries is returned in the changes out parameter.
   bool AddFormFieldValues(const std::vector<FormFieldData>& elements,
                           std::vector<AutofillChange>* changes);
 
@@ -151,7 +152,8 @@ class AutofillTable : public WebDatabaseTable {
 
   // Retrieves a vector of all values which have been recorded in the autofill
   // table as the value in a form element with name |name| and which start with
-  // |prefix|.  The comparison of the prefix is case insensitive.
+  // |prefix|.  The comparison of the prefix is case insensitive.  The values
+  // recorded for |name| are read once and then served from memory.
   bool GetFormValuesForElementName(const base::string16& name,
                                    const base::string16& prefix,
                                    std::vector<base::string16>* values,
@@ -328,6 +330,8 @@ class AutofillTable : public WebDatabaseTable {
   static const size_t kMaxDataLength;
 
  private:
+  class SuggestionIndex;
+
   FRIEND_TEST_ALL_PREFIXES(AutofillTableTest, Autofill);
   FRIEND_TEST_ALL_PREFIXES(AutofillTableTest, Autofill_AddChanges);
   FRIEND_TEST_ALL_PREFIXES(AutofillTableTest, Autofill_RemoveBetweenChanges);
@@ -377,12 +381,21 @@ class AutofillTable : public WebDatabaseTable {
   bool InitProfilePhonesTable();
   bool InitProfileTrashTable();
 
+  // Reads the values recorded for |name| into |suggestion_index_|, unless
+  // they are there already.
+  bool LoadSuggestionsForName(const base::string16& name);
+
   // The application locale.  The locale is needed for the migration to version
   // 35. Since it must be read on the UI thread, it is set when the table is
   // created (on the UI thread), and cached here so that it can be used for
   // migrations (on the DB thread).
   std::string app_locale_;
 
+  // The autocomplete values of the most recently queried field names, kept in
+  // sync with the autofill table so that suggestions do not need a query for
+  // each keystroke.
+  scoped_ptr<SuggestionIndex> suggestion_index_;
+
   DISALLOW_COPY_AND_ASSIGN(AutofillTable);
 };
 
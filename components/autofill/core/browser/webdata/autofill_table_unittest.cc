@@ -513,6 +513,45 @@ TEST_F(AutofillTableTest, Autofill_AddFormFieldValues) {
   ASSERT_EQ(2U, all_entries.size());
 }
 
+// Suggestions are served from memory once a name has been queried, so check
+// that they follow the writes made after that.
+TEST_F(AutofillTableTest, Autofill_SuggestionsFollowChanges) {
+  AutofillChangeList changes;
+  FormFieldData field;
+  field.name = ASCIIToUTF16("Email");
+  field.value = ASCIIToUTF16("joe@example.com");
+  EXPECT_TRUE(table_->AddFormFieldValue(field, &changes));
+
+  std::vector<base::string16> v;
+  EXPECT_TRUE(table_->GetFormValuesForElementName(
+      ASCIIToUTF16("Email"), ASCIIToUTF16("J"), &v, 6));
+  ASSERT_EQ(1U, v.size());
+
+  // A new value, and a second use of an existing one, after the first query.
+  field.value = ASCIIToUTF16("jane@example.com");
+  std::vector<FormFieldData> elements(1, field);
+  EXPECT_TRUE(table_->AddFormFieldValues(elements, &changes));
+  EXPECT_TRUE(table_->AddFormFieldValues(elements, &changes));
+
+  EXPECT_TRUE(table_->GetFormValuesForElementName(
+      ASCIIToUTF16("Email"), ASCIIToUTF16("j"), &v, 6));
+  ASSERT_EQ(2U, v.size());
+  EXPECT_EQ(ASCIIToUTF16("jane@example.com"), v[0]);
+  EXPECT_EQ(ASCIIToUTF16("joe@example.com"), v[1]);
+
+  EXPECT_TRUE(table_->GetFormValuesForElementName(
+      ASCIIToUTF16("Email"), ASCIIToUTF16("jo"), &v, 6));
+  ASSERT_EQ(1U, v.size());
+  EXPECT_EQ(ASCIIToUTF16("joe@example.com"), v[0]);
+
+  EXPECT_TRUE(table_->RemoveFormElement(ASCIIToUTF16("Email"),
+                                        ASCIIToUTF16("jane@example.com")));
+  EXPECT_TRUE(table_->GetFormValuesForElementName(
+      ASCIIToUTF16("Email"), base::string16(), &v, 6));
+  ASSERT_EQ(1U, v.size());
+  EXPECT_EQ(ASCIIToUTF16("joe@example.com"), v[0]);
+}
+
 TEST_F(AutofillTableTest, AutofillProfile) {
   // Add a 'Home' profile.
   AutofillProfile home_profile;
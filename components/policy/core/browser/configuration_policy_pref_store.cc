@@ -10,6 +10,7 @@
 #include "base/bind.h"
 #include "base/logging.h"
 #include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "base/prefs/pref_value_map.h"
 #include "base/strings/string16.h"
 #include "base/strings/utf_string_conversions.h"
@@ -79,6 +80,16 @@ void ConfigurationPolicyPrefStore::OnPolicyUpdated(
     const PolicyMap& current) {
   DCHECK_EQ(POLICY_DOMAIN_CHROME, ns.domain);
   DCHECK(ns.component_id.empty());
+  // There is one store per level, and a change at another level can't affect
+  // the prefs of this one. Skip rebuilding every pref in that case.
+  PolicyMap previous_at_level;
+  previous_at_level.CopyFrom(previous);
+  previous_at_level.FilterLevel(level_);
+  PolicyMap current_at_level;
+  current_at_level.CopyFrom(current);
+  current_at_level.FilterLevel(level_);
+  if (previous_at_level.Equals(current_at_level))
+    return;
   Refresh();
 }
 
@@ -95,10 +106,13 @@ ConfigurationPolicyPrefStore::~ConfigurationPolicyPrefStore() {
 }
 
 void ConfigurationPolicyPrefStore::Refresh() {
+  const base::TimeTicks start = base::TimeTicks::Now();
   scoped_ptr<PrefValueMap> new_prefs(CreatePreferencesFromPolicies());
   std::vector<std::string> changed_prefs;
   new_prefs->GetDifferingKeys(prefs_.get(), &changed_prefs);
   prefs_.swap(new_prefs);
+  UMA_HISTOGRAM_TIMES("Enterprise.PolicyPrefStoreRefreshTime",
+                      base::TimeTicks::Now() - start);
 
   // Send out change notifications.
   for (std::vector<std::string>::const_iterator pref(changed_prefs.begin());
@@ -6,6 +6,7 @@
 
 #include "base/bind.h"
 #include "base/location.h"
+#include "base/metrics/histogram.h"
 #include "base/sequenced_task_runner.h"
 #include "components/policy/core/common/policy_bundle.h"
 
@@ -49,6 +50,7 @@ void AsyncPolicyLoader::Reload(bool force) {
     return;
   }
 
+  const base::TimeTicks load_start = base::TimeTicks::Now();
   scoped_ptr<PolicyBundle> bundle(Load());
 
   // Check if there was a modification while reading.
@@ -59,8 +61,22 @@ void AsyncPolicyLoader::Reload(bool force) {
 
   // Filter out mismatching policies.
   schema_map_->FilterBundle(bundle.get());
-
-  update_callback_.Run(bundle.Pass());
+  UMA_HISTOGRAM_TIMES("Enterprise.PolicyReloadTime",
+                      base::TimeTicks::Now() - load_start);
+
+  // Periodic polls and file notifications usually find the same policies.
+  // Passing them on anyway would make the PolicyService merge and compare
+  // every namespace again. Forced reloads must always notify, see
+  // AsyncPolicyProvider::RefreshPolicies().
+  const bool unchanged = last_bundle_ && last_bundle_->Equals(*bundle);
+  if (!force)
+    UMA_HISTOGRAM_BOOLEAN("Enterprise.PolicyReloadUnchanged", unchanged);
+  if (force || !unchanged) {
+    if (!last_bundle_)
+      last_bundle_.reset(new PolicyBundle());
+    last_bundle_->CopyFrom(*bundle);
+    update_callback_.Run(bundle.Pass());
+  }
   ScheduleNextReload(TimeDelta::FromSeconds(kReloadIntervalSeconds));
 }
 
@@ -74,6 +90,8 @@ scoped_ptr<PolicyBundle> AsyncPolicyLoader::InitialLoad(
   scoped_ptr<PolicyBundle> bundle(Load());
   // Filter out mismatching policies.
   schema_map_->FilterBundle(bundle.get());
+  last_bundle_.reset(new PolicyBundle());
+  last_bundle_->CopyFrom(*bundle);
   return bundle.Pass();
 }
 
@@ -67,6 +67,8 @@ class POLICY_EXPORT AsyncPolicyLoader {
   // currently being written to, and whose contents are incomplete.
   // A reload is posted periodically, if it hasn't been triggered recently. This
   // makes sure the policies are reloaded if the update events aren't triggered.
+  // Reloads that aren't forced only notify the provider when the loaded
+  // policies differ from the last ones passed on.
   void Reload(bool force);
 
   const scoped_refptr<SchemaMap>& schema_map() const { return schema_map_; }
@@ -114,6 +116,10 @@ class POLICY_EXPORT AsyncPolicyLoader {
   // The current policy schemas that this provider should load.
   scoped_refptr<SchemaMap> schema_map_;
 
+  // The policies last passed to |update_callback_|, used to skip the
+  // notification when a reload finds nothing new.
+  scoped_ptr<PolicyBundle> last_bundle_;
+
   DISALLOW_COPY_AND_ASSIGN(AsyncPolicyLoader);
 };
 
@@ -30,6 +30,11 @@ const base::FilePath::CharType kMandatoryConfigDir[] =
 const base::FilePath::CharType kRecommendedConfigDir[] =
     FILE_PATH_LITERAL("recommended");
 
+// Files modified more recently than this aren't cached after parsing, since a
+// further write within the file system's timestamp granularity could go
+// unnoticed.
+const int kMinCacheableAgeSeconds = 2;
+
 PolicyLoadStatus JsonErrorToPolicyLoadStatus(int status) {
   switch (status) {
     case JSONFileValueSerializer::JSON_ACCESS_DENIED:
@@ -57,13 +62,23 @@ PolicyLoadStatus JsonErrorToPolicyLoadStatus(int status) {
 
 }  // namespace
 
+struct ConfigDirPolicyLoader::ParsedFile {
+  ParsedFile() : size(0) {}
+
+  base::Time last_modified;
+  int64 size;
+  PolicyBundle policies;
+};
+
 ConfigDirPolicyLoader::ConfigDirPolicyLoader(
     scoped_refptr<base::SequencedTaskRunner> task_runner,
     const base::FilePath& config_dir,
     PolicyScope scope)
     : AsyncPolicyLoader(task_runner), config_dir_(config_dir), scope_(scope) {}
 
-ConfigDirPolicyLoader::~ConfigDirPolicyLoader() {}
+ConfigDirPolicyLoader::~ConfigDirPolicyLoader() {
+  STLDeleteValues(&parsed_files_);
+}
 
 void ConfigDirPolicyLoader::InitOnBackgroundThread() {
   base::FilePathWatcher::Callback callback =
@@ -76,12 +91,26 @@ void ConfigDirPolicyLoader::InitOnBackgroundThread() {
 
 scoped_ptr<PolicyBundle> ConfigDirPolicyLoader::Load() {
   scoped_ptr<PolicyBundle> bundle(new PolicyBundle());
+  std::set<base::FilePath> files_seen;
   LoadFromPath(config_dir_.Append(kMandatoryConfigDir),
                POLICY_LEVEL_MANDATORY,
-               bundle.get());
+               bundle.get(),
+               &files_seen);
   LoadFromPath(config_dir_.Append(kRecommendedConfigDir),
                POLICY_LEVEL_RECOMMENDED,
-               bundle.get());
+               bundle.get(),
+               &files_seen);
+
+  // Forget the files that are gone.
+  ParsedFileMap::iterator it = parsed_files_.begin();
+  while (it != parsed_files_.end()) {
+    if (ContainsKey(files_seen, it->first)) {
+      ++it;
+    } else {
+      delete it->second;
+      parsed_files_.erase(it++);
+    }
+  }
   return bundle.Pass();
 }
 
@@ -117,7 +146,8 @@ base::Time ConfigDirPolicyLoader::LastModificationTime() {
 
 void ConfigDirPolicyLoader::LoadFromPath(const base::FilePath& path,
                                          PolicyLevel level,
-                                         PolicyBundle* bundle) {
+                                         PolicyBundle* bundle,
+                                         std::set<base::FilePath>* files_seen) {
   // Enumerate the files and sort them lexicographically.
   std::set<base::FilePath> files;
   base::FileEnumerator file_enumerator(path, false,
@@ -125,6 +155,7 @@ void ConfigDirPolicyLoader::LoadFromPath(const base::FilePath& path,
   for (base::FilePath config_file_path = file_enumerator.Next();
        !config_file_path.empty(); config_file_path = file_enumerator.Next())
     files.insert(config_file_path);
+  files_seen->insert(files.begin(), files.end());
 
   PolicyLoadStatusSample status;
   if (files.empty()) {
@@ -132,43 +163,73 @@ void ConfigDirPolicyLoader::LoadFromPath(const base::FilePath& path,
     return;
   }
 
-  // Start with an empty dictionary and merge the files' contents.
+  // Start with an empty bundle and merge the files' contents.
   // The files are processed in reverse order because |MergeFrom| gives priority
   // to existing keys, but the ConfigDirPolicyProvider gives priority to the
   // last file in lexicographic order.
   for (std::set<base::FilePath>::reverse_iterator config_file_iter =
            files.rbegin(); config_file_iter != files.rend();
        ++config_file_iter) {
-    JSONFileValueSerializer deserializer(*config_file_iter);
-    deserializer.set_allow_trailing_comma(true);
-    int error_code = 0;
-    std::string error_msg;
-    scoped_ptr<base::Value> value(
-        deserializer.Deserialize(&error_code, &error_msg));
-    if (!value.get()) {
-      LOG(WARNING) << "Failed to read configuration file "
-                   << config_file_iter->value() << ": " << error_msg;
-      status.Add(JsonErrorToPolicyLoadStatus(error_code));
-      continue;
-    }
-    base::DictionaryValue* dictionary_value = NULL;
-    if (!value->GetAsDictionary(&dictionary_value)) {
-      LOG(WARNING) << "Expected JSON dictionary in configuration file "
-                   << config_file_iter->value();
-      status.Add(POLICY_LOAD_STATUS_PARSE_ERROR);
-      continue;
+    LoadFromFile(*config_file_iter, level, bundle, &status);
+  }
+}
+
+void ConfigDirPolicyLoader::LoadFromFile(const base::FilePath& path,
+                                         PolicyLevel level,
+                                         PolicyBundle* bundle,
+                                         PolicyLoadStatusSample* status) {
+  base::File::Info info;
+  const bool have_info = base::GetFileInfo(path, &info);
+  ParsedFileMap::iterator it = parsed_files_.find(path);
+  if (it != parsed_files_.end()) {
+    if (have_info && it->second->last_modified == info.last_modified &&
+        it->second->size == info.size) {
+      bundle->MergeFrom(it->second->policies);
+      return;
     }
+    delete it->second;
+    parsed_files_.erase(it);
+  }
 
-    // Detach the "3rdparty" node.
-    scoped_ptr<base::Value> third_party;
-    if (dictionary_value->Remove("3rdparty", &third_party))
-      Merge3rdPartyPolicy(third_party.get(), level, bundle);
+  JSONFileValueSerializer deserializer(path);
+  deserializer.set_allow_trailing_comma(true);
+  int error_code = 0;
+  std::string error_msg;
+  scoped_ptr<base::Value> value(
+      deserializer.Deserialize(&error_code, &error_msg));
+  if (!value.get()) {
+    LOG(WARNING) << "Failed to read configuration file "
+                 << path.value() << ": " << error_msg;
+    status->Add(JsonErrorToPolicyLoadStatus(error_code));
+    return;
+  }
+  base::DictionaryValue* dictionary_value = NULL;
+  if (!value->GetAsDictionary(&dictionary_value)) {
+    LOG(WARNING) << "Expected JSON dictionary in configuration file "
+                 << path.value();
+    status->Add(POLICY_LOAD_STATUS_PARSE_ERROR);
+    return;
+  }
 
-    // Add chrome policy.
-    PolicyMap policy_map;
-    policy_map.LoadFrom(dictionary_value, level, scope_);
-    bundle->Get(PolicyNamespace(POLICY_DOMAIN_CHROME, std::string()))
-        .MergeFrom(policy_map);
+  scoped_ptr<ParsedFile> parsed(new ParsedFile);
+  parsed->last_modified = info.last_modified;
+  parsed->size = info.size;
+
+  // Detach the "3rdparty" node.
+  scoped_ptr<base::Value> third_party;
+  if (dictionary_value->Remove("3rdparty", &third_party))
+    Merge3rdPartyPolicy(third_party.get(), level, &parsed->policies);
+
+  // Add chrome policy.
+  parsed->policies.Get(PolicyNamespace(POLICY_DOMAIN_CHROME, std::string()))
+      .LoadFrom(dictionary_value, level, scope_);
+  bundle->MergeFrom(parsed->policies);
+
+  // Only cache the result if the file can't be modified again without also
+  // changing its timestamp.
+  if (have_info && base::Time::Now() - info.last_modified >=
+                       base::TimeDelta::FromSeconds(kMinCacheableAgeSeconds)) {
+    parsed_files_[path] = parsed.release();
   }
 }
 
@@ -5,6 +5,9 @@
 #ifndef COMPONENTS_POLICY_CORE_COMMON_CONFIG_DIR_POLICY_LOADER_H_
 #define COMPONENTS_POLICY_CORE_COMMON_CONFIG_DIR_POLICY_LOADER_H_
 
+#include <map>
+#include <set>
+
 #include "base/files/file_path.h"
 #include "base/files/file_path_watcher.h"
 #include "components/policy/core/common/async_policy_loader.h"
@@ -17,6 +20,8 @@ class Value;
 
 namespace policy {
 
+class PolicyLoadStatusSample;
+
 // A policy loader implementation backed by a set of files in a given
 // directory. The files should contain JSON-formatted policy settings. They are
 // merged together and the result is returned in a PolicyBundle.
@@ -35,10 +40,25 @@ class POLICY_EXPORT ConfigDirPolicyLoader : public AsyncPolicyLoader {
   virtual base::Time LastModificationTime() OVERRIDE;
 
  private:
+  // The policies parsed from one file, and the file attributes they were
+  // parsed from.
+  struct ParsedFile;
+  typedef std::map<base::FilePath, ParsedFile*> ParsedFileMap;
+
   // Loads the policy files at |path| into the |bundle|, with the given |level|.
+  // The paths of the files found are added to |files_seen|.
   void LoadFromPath(const base::FilePath& path,
                     PolicyLevel level,
-                    PolicyBundle* bundle);
+                    PolicyBundle* bundle,
+                    std::set<base::FilePath>* files_seen);
+
+  // Merges the policies in the file at |path| into the |bundle|, with the
+  // given |level|. The file is only parsed again if it changed since the last
+  // time it was loaded.
+  void LoadFromFile(const base::FilePath& path,
+                    PolicyLevel level,
+                    PolicyBundle* bundle,
+                    PolicyLoadStatusSample* status);
 
   // Merges the 3rd party |policies| into the |bundle|, with the given |level|.
   void Merge3rdPartyPolicy(const base::Value* policies,
@@ -59,6 +79,10 @@ class POLICY_EXPORT ConfigDirPolicyLoader : public AsyncPolicyLoader {
   base::FilePathWatcher mandatory_watcher_;
   base::FilePathWatcher recommended_watcher_;
 
+  // Files that haven't changed since the previous Load() aren't parsed again.
+  // Large deployments ship thousands of extension policies in these files.
+  ParsedFileMap parsed_files_;
+
   DISALLOW_COPY_AND_ASSIGN(ConfigDirPolicyLoader);
 };
 
@@ -233,4 +233,46 @@ TEST_F(ConfigDirPolicyLoaderTest, ReadPrefsMergePrefs) {
   EXPECT_TRUE(bundle->Equals(expected_bundle));
 }
 
+// Files that haven't changed since the previous load aren't parsed again, and
+// files that were removed stop contributing policies.
+TEST_F(ConfigDirPolicyLoaderTest, ReloadsOnlyModifiedFiles) {
+  const base::FilePath config_file = harness_.test_dir()
+      .Append(kMandatoryPath).AppendASCII("policy");
+  const base::Time kOldTime = base::Time::Now() - base::TimeDelta::FromHours(1);
+  base::DictionaryValue test_dict_foo;
+  test_dict_foo.SetString("HomepageLocation", "http://foo.com");
+  harness_.WriteConfigFile(test_dict_foo, "policy");
+  ASSERT_TRUE(base::TouchFile(config_file, kOldTime, kOldTime));
+
+  ConfigDirPolicyLoader loader(
+      loop_.message_loop_proxy(), harness_.test_dir(), POLICY_SCOPE_USER);
+  scoped_ptr<PolicyBundle> bundle(loader.Load());
+  PolicyBundle expected_foo;
+  expected_foo.Get(PolicyNamespace(POLICY_DOMAIN_CHROME, std::string()))
+      .LoadFrom(&test_dict_foo, POLICY_LEVEL_MANDATORY, POLICY_SCOPE_USER);
+  EXPECT_TRUE(bundle->Equals(expected_foo));
+
+  // Same size and timestamp: the cached policies are used.
+  base::DictionaryValue test_dict_bar;
+  test_dict_bar.SetString("HomepageLocation", "http://bar.com");
+  harness_.WriteConfigFile(test_dict_bar, "policy");
+  ASSERT_TRUE(base::TouchFile(config_file, kOldTime, kOldTime));
+  bundle = loader.Load();
+  EXPECT_TRUE(bundle->Equals(expected_foo));
+
+  // A new timestamp makes the file be parsed again.
+  const base::Time kNewTime = kOldTime + base::TimeDelta::FromMinutes(1);
+  ASSERT_TRUE(base::TouchFile(config_file, kNewTime, kNewTime));
+  bundle = loader.Load();
+  PolicyBundle expected_bar;
+  expected_bar.Get(PolicyNamespace(POLICY_DOMAIN_CHROME, std::string()))
+      .LoadFrom(&test_dict_bar, POLICY_LEVEL_MANDATORY, POLICY_SCOPE_USER);
+  EXPECT_TRUE(bundle->Equals(expected_bar));
+
+  ASSERT_TRUE(base::DeleteFile(config_file, false));
+  bundle = loader.Load();
+  const PolicyBundle kEmptyBundle;
+  EXPECT_TRUE(bundle->Equals(kEmptyBundle));
+}
+
 }  // namespace policy
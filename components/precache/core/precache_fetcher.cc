@@ -26,6 +26,12 @@ namespace precache {
 
 namespace {
 
+// Maximum number of resource fetches in progress at once. Resources are
+// fetched in parallel so that the latency of each fetch doesn't dominate the
+// time spent precaching, while staying well below the per-host connection
+// limit of the network stack.
+const size_t kMaxParallelResourceFetches = 4;
+
 GURL GetConfigURL() {
   const CommandLine& command_line = *CommandLine::ForCurrentProcess();
   if (command_line.HasSwitch(switches::kPrecacheConfigSettingsURL)) {
@@ -108,6 +114,8 @@ class PrecacheFetcher::Fetcher : public net::URLFetcherDelegate {
   virtual ~Fetcher() {}
   virtual void OnURLFetchComplete(const URLFetcher* source) OVERRIDE;
 
+  const URLFetcher* url_fetcher() const { return url_fetcher_.get(); }
+
  private:
   const base::Callback<void(const URLFetcher&)> callback_;
   scoped_ptr<URLFetcher> url_fetcher_;
@@ -161,19 +169,23 @@ void PrecacheFetcher::Start() {
 }
 
 void PrecacheFetcher::StartNextFetch() {
-  if (!resource_urls_to_fetch_.empty()) {
+  while (!resource_urls_to_fetch_.empty() &&
+         resource_fetchers_.size() < kMaxParallelResourceFetches) {
     // Fetch the next resource URL.
-    fetcher_.reset(
+    resource_fetchers_.push_back(
         new Fetcher(request_context_, resource_urls_to_fetch_.front(),
                     base::Bind(&PrecacheFetcher::OnResourceFetchComplete,
                                base::Unretained(this))));
 
     resource_urls_to_fetch_.pop_front();
-    return;
   }
 
+  if (!resource_urls_to_fetch_.empty() || fetcher_)
+    return;
+
   if (!manifest_urls_to_fetch_.empty()) {
-    // Fetch the next manifest URL.
+    // Fetch the next manifest URL while the last of the previous manifest's
+    // resources are still being fetched.
     fetcher_.reset(
         new Fetcher(request_context_, manifest_urls_to_fetch_.front(),
                     base::Bind(&PrecacheFetcher::OnManifestFetchComplete,
@@ -183,6 +195,9 @@ void PrecacheFetcher::StartNextFetch() {
     return;
   }
 
+  if (!resource_fetchers_.empty())
+    return;
+
   // There are no more URLs to fetch, so end the precache cycle.
   precache_delegate_->OnDone();
   // OnDone may have deleted this PrecacheFetcher, so don't do anything after it
@@ -226,6 +241,8 @@ void PrecacheFetcher::OnConfigFetchComplete(const URLFetcher& source) {
     }
   }
 
+  // |source| is owned by |fetcher_|, so don't use it after this point.
+  fetcher_.reset();
   StartNextFetch();
 }
 
@@ -240,12 +257,22 @@ void PrecacheFetcher::OnManifestFetchComplete(const URLFetcher& source) {
     }
   }
 
+  // |source| is owned by |fetcher_|, so don't use it after this point.
+  fetcher_.reset();
   StartNextFetch();
 }
 
 void PrecacheFetcher::OnResourceFetchComplete(const URLFetcher& source) {
   // The resource has already been put in the cache during the fetch process, so
-  // nothing more needs to be done for the resource.
+  // nothing more needs to be done for the resource other than releasing its
+  // Fetcher.
+  for (ScopedVector<Fetcher>::iterator it = resource_fetchers_.begin();
+       it != resource_fetchers_.end(); ++it) {
+    if ((*it)->url_fetcher() == &source) {
+      resource_fetchers_.erase(it);
+      break;
+    }
+  }
   StartNextFetch();
 }
 
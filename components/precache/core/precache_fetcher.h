@@ -10,6 +10,7 @@
 #include "base/basictypes.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "url/gurl.h"
 
 namespace net {
@@ -76,18 +77,21 @@ class PrecacheFetcher {
 
   virtual ~PrecacheFetcher();
 
-  // Starts fetching resources to precache. URLs are fetched sequentially. Can
-  // be called from any thread. Start should only be called once on a
-  // PrecacheFetcher instance.
+  // Starts fetching resources to precache. Manifests are fetched
+  // sequentially, and up to a small fixed number of resources are fetched in
+  // parallel. Can be called from any thread. Start should only be called once
+  // on a PrecacheFetcher instance.
   void Start();
 
  private:
   class Fetcher;
 
-  // Fetches the next resource or manifest URL, if any remain. Fetching is done
-  // sequentially and depth-first: all resources are fetched for a manifest
-  // before the next manifest is fetched. This is done to limit the length of
-  // the |resource_urls_to_fetch_| list, reducing the memory usage.
+  // Starts fetching resource URLs until the parallel fetch limit is reached,
+  // and then the next manifest URL once no resource URLs are waiting. Fetching
+  // is depth-first: a manifest's resources are all started before the next
+  // manifest is fetched. This is done to limit the length of the
+  // |resource_urls_to_fetch_| list, reducing the memory usage. Calls OnDone on
+  // the delegate once nothing remains to be fetched.
   void StartNextFetch();
 
   // Called when the precache configuration settings have been fetched.
@@ -114,8 +118,12 @@ class PrecacheFetcher {
   // Non-owning pointer. Should not be NULL.
   PrecacheDelegate* precache_delegate_;
 
+  // The config or manifest fetch in progress, if any.
   scoped_ptr<Fetcher> fetcher_;
 
+  // The resource fetches in progress.
+  ScopedVector<Fetcher> resource_fetchers_;
+
   std::list<GURL> manifest_urls_to_fetch_;
   std::list<GURL> resource_urls_to_fetch_;
 
@@ -14,6 +14,7 @@
 #include "base/command_line.h"
 #include "base/compiler_specific.h"
 #include "base/message_loop/message_loop.h"
+#include "base/strings/string_number_conversions.h"
 #include "components/precache/core/precache_switches.h"
 #include "components/precache/core/proto/precache.pb.h"
 #include "net/http/http_response_headers.h"
@@ -165,6 +166,55 @@ TEST_F(PrecacheFetcherTest, FullPrecache) {
   EXPECT_TRUE(precache_delegate_.was_on_done_called());
 }
 
+TEST_F(PrecacheFetcherTest, ManyResourcesFetchedInParallel) {
+  CommandLine::ForCurrentProcess()->AppendSwitchASCII(
+      switches::kPrecacheConfigSettingsURL, kConfigURL);
+  CommandLine::ForCurrentProcess()->AppendSwitchASCII(
+      switches::kPrecacheManifestURLPrefix, kManfiestURLPrefix);
+
+  std::list<GURL> starting_urls;
+  starting_urls.push_back(GURL("http://good-manifest.com"));
+  starting_urls.push_back(GURL("http://forced-starting-url.com"));
+
+  PrecacheConfigurationSettings config;
+  config.set_top_sites_count(2);
+
+  std::multiset<GURL> expected_requested_urls;
+  expected_requested_urls.insert(GURL(kConfigURL));
+  expected_requested_urls.insert(GURL(kGoodManifestURL));
+  expected_requested_urls.insert(GURL(kForcedStartingURLManifestURL));
+
+  // Use more resources than can be fetched at once, so that resource fetches
+  // have to be queued.
+  PrecacheManifest good_manifest;
+  for (int i = 0; i < 10; ++i) {
+    GURL resource_url("http://good-resource.com/" + base::IntToString(i));
+    good_manifest.add_resource()->set_url(resource_url.spec());
+    factory_.SetFakeResponse(resource_url, "good", net::HTTP_OK,
+                             net::URLRequestStatus::SUCCESS);
+    expected_requested_urls.insert(resource_url);
+  }
+
+  factory_.SetFakeResponse(GURL(kConfigURL), config.SerializeAsString(),
+                           net::HTTP_OK, net::URLRequestStatus::SUCCESS);
+  factory_.SetFakeResponse(GURL(kGoodManifestURL),
+                           good_manifest.SerializeAsString(), net::HTTP_OK,
+                           net::URLRequestStatus::SUCCESS);
+  factory_.SetFakeResponse(GURL(kForcedStartingURLManifestURL),
+                           PrecacheManifest().SerializeAsString(), net::HTTP_OK,
+                           net::URLRequestStatus::SUCCESS);
+
+  PrecacheFetcher precache_fetcher(starting_urls, request_context_.get(),
+                                   &precache_delegate_);
+  precache_fetcher.Start();
+
+  base::MessageLoop::current()->RunUntilIdle();
+
+  EXPECT_EQ(expected_requested_urls, url_callback_.requested_urls());
+
+  EXPECT_TRUE(precache_delegate_.was_on_done_called());
+}
+
 TEST_F(PrecacheFetcherTest, ConfigFetchFailure) {
   CommandLine::ForCurrentProcess()->AppendSwitchASCII(
       switches::kPrecacheConfigSettingsURL, kConfigURL);
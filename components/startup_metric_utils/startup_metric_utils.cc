@@ -228,18 +228,22 @@ void OnInitialPageLoadComplete() {
   g_startup_stats_collection_finished = true;
 }
 
-ScopedSlowStartupUMA::~ScopedSlowStartupUMA() {
+void RecordSlowStartupTime(const std::string& histogram_name,
+                           const base::TimeDelta& elapsed) {
   if (g_startup_stats_collection_finished)
     return;
 
   base::AutoLock locker(*GetSubsystemStartupTimeHashLock());
   SubsystemStartupTimeHash* hash = GetSubsystemStartupTimeHash();
   // Only record the initial sample for a given histogram.
-  if (hash->find(histogram_name_) !=  hash->end())
+  if (hash->find(histogram_name) !=  hash->end())
     return;
 
-  (*hash)[histogram_name_] =
-      base::TimeTicks::Now() - start_time_;
+  (*hash)[histogram_name] = elapsed;
+}
+
+ScopedSlowStartupUMA::~ScopedSlowStartupUMA() {
+  RecordSlowStartupTime(histogram_name_, base::TimeTicks::Now() - start_time_);
 }
 
 }  // namespace startup_metric_utils
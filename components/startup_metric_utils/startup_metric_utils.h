@@ -52,6 +52,12 @@ void OnBrowserStartupComplete(bool is_first_run);
 // stats.
 void OnInitialPageLoadComplete();
 
+// Records |elapsed| as the time the startup stage |histogram_name| took, like
+// ScopedSlowStartupUMA does, for stages that are not timed by a scope, such
+// as work that runs on other threads.
+void RecordSlowStartupTime(const std::string& histogram_name,
+                           const base::TimeDelta& elapsed);
+
 // Scoper that records the time period before it's destructed in a histogram
 // with the given name. The histogram is only recorded for slow chrome startups.
 // Useful for trying to figure out what parts of Chrome cause slow startup.
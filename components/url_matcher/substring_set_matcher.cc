@@ -19,6 +19,12 @@ bool ComparePatterns(const StringPattern* a, const StringPattern* b) {
   return a->pattern() < b->pattern();
 }
 
+// Compare Aho-Corasick edges based on their labels.
+bool CompareEdgeLabels(const std::pair<char, uint32>& a,
+                       const std::pair<char, uint32>& b) {
+  return a.first < b.first;
+}
+
 // Given the set of patterns, compute how many nodes will the corresponding
 // Aho-Corasick tree have. Note that |patterns| need to be sorted.
 uint32 TreeSize(const std::vector<const StringPattern*>& patterns) {
@@ -115,16 +121,27 @@ bool SubstringSetMatcher::Match(const std::string& text,
 
   uint32 current_node = 0;
   for (std::string::const_iterator i = text.begin(); i != text.end(); ++i) {
-    uint32 edge_from_current = tree_[current_node].GetEdge(*i);
+    if (current_node == 0) {
+      // Skip over characters which do not start any pattern.
+      while (root_edges_[static_cast<unsigned char>(*i)] ==
+             AhoCorasickNode::kNoSuchEdge) {
+        if (++i == text.end())
+          return old_number_of_matches != matches->size();
+      }
+    }
+
+    uint32 edge_from_current = GetEdge(current_node, *i);
     while (edge_from_current == AhoCorasickNode::kNoSuchEdge &&
            current_node != 0) {
       current_node = tree_[current_node].failure();
-      edge_from_current = tree_[current_node].GetEdge(*i);
+      edge_from_current = GetEdge(current_node, *i);
     }
     if (edge_from_current != AhoCorasickNode::kNoSuchEdge) {
       current_node = edge_from_current;
-      matches->insert(tree_[current_node].matches().begin(),
-                      tree_[current_node].matches().end());
+      const AhoCorasickNode::Matches& node_matches =
+          tree_[current_node].matches();
+      if (!node_matches.empty())
+        matches->insert(node_matches.begin(), node_matches.end());
     } else {
       DCHECK_EQ(0u, current_node);
     }
@@ -155,6 +172,7 @@ void SubstringSetMatcher::RebuildAhoCorasickTree(
   }
 
   CreateFailureEdges();
+  CreateRootEdges();
 }
 
 void SubstringSetMatcher::InsertPatternIntoAhoCorasickTree(
@@ -229,6 +247,16 @@ void SubstringSetMatcher::CreateFailureEdges() {
   }
 }
 
+void SubstringSetMatcher::CreateRootEdges() {
+  std::fill(root_edges_, root_edges_ + arraysize(root_edges_),
+            AhoCorasickNode::kNoSuchEdge);
+  const AhoCorasickNode::Edges& edges = tree_[0].edges();
+  for (AhoCorasickNode::Edges::const_iterator e = edges.begin();
+       e != edges.end(); ++e) {
+    root_edges_[static_cast<unsigned char>(e->first)] = e->second;
+  }
+}
+
 const uint32 SubstringSetMatcher::AhoCorasickNode::kNoSuchEdge = ~0;
 
 SubstringSetMatcher::AhoCorasickNode::AhoCorasickNode()
@@ -252,12 +280,25 @@ SubstringSetMatcher::AhoCorasickNode::operator=(
 }
 
 uint32 SubstringSetMatcher::AhoCorasickNode::GetEdge(char c) const {
-  Edges::const_iterator i = edges_.find(c);
-  return i == edges_.end() ? kNoSuchEdge : i->second;
+  // Most nodes have very few edges, for which a linear scan beats a
+  // binary search.
+  for (Edges::const_iterator i = edges_.begin(); i != edges_.end(); ++i) {
+    if (i->first == c)
+      return i->second;
+    if (i->first > c)
+      break;
+  }
+  return kNoSuchEdge;
 }
 
 void SubstringSetMatcher::AhoCorasickNode::SetEdge(char c, uint32 node) {
-  edges_[c] = node;
+  const Edges::value_type edge(c, node);
+  Edges::iterator i =
+      std::lower_bound(edges_.begin(), edges_.end(), edge, CompareEdgeLabels);
+  if (i != edges_.end() && i->first == c)
+    i->second = node;
+  else
+    edges_.insert(i, edge);
 }
 
 void SubstringSetMatcher::AhoCorasickNode::AddMatch(StringPattern::ID id) {
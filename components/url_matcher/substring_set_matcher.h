@@ -79,10 +79,17 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
   // If your brain thinks "Forget it, let's go shopping.", don't worry.
   // Take a nap and read an introductory text on the Aho Corasick algorithm.
   // It will make sense. Eventually.
+  //
+  // Edges are kept in a vector sorted by label, which is much more compact
+  // than a map for the typical node with one or two children. The root,
+  // which is visited after every failed partial match, additionally has a
+  // dense transition table (|root_edges_|). That table also lets Match()
+  // skip quickly over bytes which cannot start any pattern.
   class AhoCorasickNode {
    public:
-    // Key: label of the edge, value: node index in |tree_| of parent class.
-    typedef std::map<char, uint32> Edges;
+    // First: label of the edge, second: node index in |tree_| of parent
+    // class. Sorted by label.
+    typedef std::vector<std::pair<char, uint32> > Edges;
     typedef std::set<StringPattern::ID> Matches;
 
     static const uint32 kNoSuchEdge;  // Represents an invalid node index.
@@ -126,6 +133,16 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
   void InsertPatternIntoAhoCorasickTree(const StringPattern* pattern);
   void CreateFailureEdges();
 
+  // Fills |root_edges_| from the edges of the root node.
+  void CreateRootEdges();
+
+  // Returns the node reached from |node| by an edge labeled |c|, or
+  // AhoCorasickNode::kNoSuchEdge.
+  uint32 GetEdge(uint32 node, char c) const {
+    return node == 0 ? root_edges_[static_cast<unsigned char>(c)]
+                     : tree_[node].GetEdge(c);
+  }
+
   // Set of all registered StringPatterns. Used to regenerate the
   // Aho-Corasick tree in case patterns are registered or unregistered.
   SubstringPatternMap patterns_;
@@ -133,6 +150,9 @@ class URL_MATCHER_EXPORT SubstringSetMatcher {
   // The nodes of a Aho-Corasick tree.
   std::vector<AhoCorasickNode> tree_;
 
+  // Dense copy of the root node's edges, indexed by unsigned label.
+  uint32 root_edges_[std::numeric_limits<unsigned char>::max() + 1];
+
   DISALLOW_COPY_AND_ASSIGN(SubstringSetMatcher);
 };
 
@@ -167,4 +167,12 @@ TEST(SubstringSetMatcherTest, TestEmptyMatcher) {
   EXPECT_TRUE(matches.empty());
 }
 
+// Labels outside of 7-bit ASCII must work with the dense root edge table.
+TEST(SubstringSetMatcherTest, TestNonASCII) {
+  TestOnePattern("a\xc3\xa4b", "\xc3\xa4", true);
+  TestOnePattern("a\xc3\xa4b", "\xa4b", true);
+  TestOnePattern("a\xc3\xa4b", "\xa4\xc3", false);
+  TestTwoPatterns("\xff\x80\xff\x81", "\xff\x81", "\x80\xff", true, true);
+}
+
 }  // namespace url_matcher
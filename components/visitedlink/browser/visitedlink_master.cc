@@ -127,10 +127,12 @@ void AsyncClose(FILE** file) {
 // will be called on the history thread by the history system for every URL
 // in the database.
 //
-// The builder will store the fingerprints for those URLs, and then marshalls
+// The builder will store the fingerprints for those URLs and, still on the
+// history thread, build a complete hash table from them. It then marshalls
 // back to the main thread where the VisitedLinkMaster will be notified. The
-// master then replaces its table with a new table containing the computed
-// fingerprints.
+// master then adopts that table, so that the main thread only has to apply
+// the changes made while the rebuild was running. For very large histories
+// filling the table is the slow part, and this keeps it off the main thread.
 //
 // The builder must remain active while the history system is using it.
 // Sometimes, the master will be deleted before the rebuild is complete, in
@@ -159,6 +161,9 @@ class VisitedLinkMaster::TableBuilder
   // notification.
   void OnCompleteMainThread();
 
+  // Fills |table_| from |fingerprints_|. Called on the history thread.
+  void BuildTable();
+
   // Owner of this object. MAY ONLY BE ACCESSED ON THE MAIN THREAD!
   VisitedLinkMaster* master_;
 
@@ -171,6 +176,11 @@ class VisitedLinkMaster::TableBuilder
   // Stores the fingerprints we computed on the background thread.
   VisitedLinkCommon::Fingerprints fingerprints_;
 
+  // The hash table built from |fingerprints_|, and the number of entries
+  // used in it. NULL if the table could not be built.
+  scoped_ptr<base::SharedMemory> table_;
+  int32 table_used_items_;
+
   DISALLOW_COPY_AND_ASSIGN(TableBuilder);
 };
 
@@ -699,6 +709,21 @@ bool VisitedLinkMaster::CreateURLTable(int32 num_entries, bool init_to_empty) {
   return true;
 }
 
+void VisitedLinkMaster::AdoptURLTable(base::SharedMemory* shared_memory,
+                                      int32 used_items) {
+  shared_memory_ = shared_memory;
+  const SharedHeader* header =
+      static_cast<const SharedHeader*>(shared_memory_->memory());
+  table_length_ = header->length;
+  used_items_ = used_items;
+  hash_table_ = reinterpret_cast<Fingerprint*>(
+      static_cast<char*>(shared_memory_->memory()) + sizeof(SharedHeader));
+
+#ifndef NDEBUG
+  DebugValidate();
+#endif
+}
+
 bool VisitedLinkMaster::BeginReplaceURLTable(int32 num_entries) {
   base::SharedMemory *old_shared_memory = shared_memory_;
   Fingerprint* old_hash_table = hash_table_;
@@ -793,7 +818,8 @@ void VisitedLinkMaster::ResizeTable(int32 new_size) {
     WriteFullTable();
 }
 
-uint32 VisitedLinkMaster::NewTableSizeForCount(int32 item_count) const {
+// static
+uint32 VisitedLinkMaster::NewTableSizeForCount(int32 item_count) {
   // These table sizes are selected to be the maximum prime number less than
   // a "convenient" multiple of 1K.
   static const int table_sizes[] = {
@@ -838,24 +864,38 @@ bool VisitedLinkMaster::RebuildTableFromDelegate() {
 // See the TableBuilder declaration above for how this works.
 void VisitedLinkMaster::OnTableRebuildComplete(
     bool success,
-    const std::vector<Fingerprint>& fingerprints) {
+    const std::vector<Fingerprint>& fingerprints,
+    scoped_ptr<base::SharedMemory> table,
+    int32 table_used_items) {
   if (success) {
-    // Replace the old table with a new blank one.
+    // Replace the old table with the new one.
     shared_memory_serial_++;
 
     // We are responsible for freeing it AFTER it has been replaced if
     // replacement succeeds.
     base::SharedMemory* old_shared_memory = shared_memory_;
 
-    int new_table_size = NewTableSizeForCount(
+    uint32 new_table_size = NewTableSizeForCount(
         static_cast<int>(fingerprints.size() + added_since_rebuild_.size()));
-    if (BeginReplaceURLTable(new_table_size)) {
-      // Free the old table.
-      delete old_shared_memory;
-
+    bool replaced = false;
+    if (table.get() &&
+        static_cast<uint32>(
+            static_cast<const SharedHeader*>(table->memory())->length) >=
+            new_table_size) {
+      // The builder's table already has room for everything added during
+      // the rebuild.
+      AdoptURLTable(table.release(), table_used_items);
+      replaced = true;
+    } else if (BeginReplaceURLTable(new_table_size)) {
       // Add the stored fingerprints to the hash table.
       for (size_t i = 0; i < fingerprints.size(); i++)
         AddFingerprint(fingerprints[i], false);
+      replaced = true;
+    }
+
+    if (replaced) {
+      // Free the old table.
+      delete old_shared_memory;
 
       // Also add anything that was added while we were asynchronously
       // generating the new table.
@@ -950,7 +990,8 @@ VisitedLinkMaster::TableBuilder::TableBuilder(
     VisitedLinkMaster* master,
     const uint8 salt[LINK_SALT_LENGTH])
     : master_(master),
-      success_(true) {
+      success_(true),
+      table_used_items_(0) {
   fingerprints_.reserve(4096);
   memcpy(salt_, salt, LINK_SALT_LENGTH * sizeof(uint8));
 }
@@ -972,6 +1013,9 @@ void VisitedLinkMaster::TableBuilder::OnComplete(bool success) {
   success_ = success;
   DLOG_IF(WARNING, !success) << "Unable to rebuild visited links";
 
+  if (success_)
+    BuildTable();
+
   // Marshal to the main thread to notify the VisitedLinkMaster that the
   // rebuild is complete.
   BrowserThread::PostTask(
@@ -980,8 +1024,50 @@ void VisitedLinkMaster::TableBuilder::OnComplete(bool success) {
 }
 
 void VisitedLinkMaster::TableBuilder::OnCompleteMainThread() {
-  if (master_)
-    master_->OnTableRebuildComplete(success_, fingerprints_);
+  if (master_) {
+    master_->OnTableRebuildComplete(success_, fingerprints_, table_.Pass(),
+                                    table_used_items_);
+  }
+}
+
+// See VisitedLinkMaster::AddFingerprint, which this must stay in sync with.
+void VisitedLinkMaster::TableBuilder::BuildTable() {
+  const int32 table_length = static_cast<int32>(
+      NewTableSizeForCount(static_cast<int32>(fingerprints_.size())));
+  const uint32 alloc_size =
+      table_length * sizeof(Fingerprint) + sizeof(SharedHeader);
+
+  scoped_ptr<base::SharedMemory> shared_memory(new base::SharedMemory());
+  if (!shared_memory->CreateAndMapAnonymous(alloc_size))
+    return;
+  memset(shared_memory->memory(), 0, alloc_size);
+
+  SharedHeader* header = static_cast<SharedHeader*>(shared_memory->memory());
+  header->length = table_length;
+  memcpy(header->salt, salt_, LINK_SALT_LENGTH);
+
+  Fingerprint* hash_table = reinterpret_cast<Fingerprint*>(
+      static_cast<char*>(shared_memory->memory()) + sizeof(SharedHeader));
+  int32 used_items = 0;
+  for (size_t i = 0; i < fingerprints_.size(); ++i) {
+    const Fingerprint fingerprint = fingerprints_[i];
+    if (fingerprint == null_fingerprint_)
+      continue;
+
+    // The table is at most a third full, so the probe always terminates.
+    Hash hash = HashFingerprint(fingerprint, table_length);
+    while (hash_table[hash] != null_fingerprint_ &&
+           hash_table[hash] != fingerprint) {
+      hash = (hash >= table_length - 1) ? 0 : hash + 1;
+    }
+    if (hash_table[hash] == null_fingerprint_) {
+      hash_table[hash] = fingerprint;
+      used_items++;
+    }
+  }
+
+  table_.swap(shared_memory);
+  table_used_items_ = used_items;
 }
 
 }  // namespace visitedlink
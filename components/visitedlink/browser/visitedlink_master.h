@@ -15,6 +15,7 @@
 #include "base/callback_forward.h"
 #include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/shared_memory.h"
 #include "base/threading/sequenced_worker_pool.h"
 #include "components/visitedlink/common/visitedlink_common.h"
@@ -287,6 +288,13 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // caller should not attemp to release the pointer/handle in this case.
   bool BeginReplaceURLTable(int32 num_entries);
 
+  // Replaces the current table with |shared_memory|, which must already
+  // contain a complete table (header included) holding |used_items|
+  // fingerprints. Takes ownership of |shared_memory|. As with
+  // BeginReplaceURLTable(), the caller is responsible for releasing the old
+  // table.
+  void AdoptURLTable(base::SharedMemory* shared_memory, int32 used_items);
+
   // unallocates the Fingerprint table
   void FreeURLTable();
 
@@ -300,7 +308,7 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   void ResizeTable(int32 new_size);
 
   // Returns the desired table size for |item_count| URLs.
-  uint32 NewTableSizeForCount(int32 item_count) const;
+  static uint32 NewTableSizeForCount(int32 item_count);
 
   // Computes the table load as fraction. For example, if 1/4 of the entries are
   // full, this value will be 0.25
@@ -320,9 +328,13 @@ class VisitedLinkMaster : public VisitedLinkCommon {
   // Callback that the table rebuilder uses when the rebuild is complete.
   // |success| is true if the fingerprint generation succeeded, in which case
   // |fingerprints| will contain the computed fingerprints. On failure, there
-  // will be no fingerprints.
+  // will be no fingerprints. |table| is the hash table the builder made from
+  // |fingerprints| on the history thread, or NULL if it could not make one;
+  // it holds |table_used_items| fingerprints.
   void OnTableRebuildComplete(bool success,
-                              const std::vector<Fingerprint>& fingerprints);
+                              const std::vector<Fingerprint>& fingerprints,
+                              scoped_ptr<base::SharedMemory> table,
+                              int32 table_used_items);
 
   // Increases or decreases the given hash value by one, wrapping around as
   // necessary. Used for probing.
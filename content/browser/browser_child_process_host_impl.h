@@ -85,6 +85,13 @@ class CONTENT_EXPORT BrowserChildProcessHostImpl
 
   BrowserChildProcessHostDelegate* delegate() const { return delegate_; }
 
+  // Hands this host, and the process it launched, over to a new delegate.
+  // The caller is responsible for deleting the previous delegate without
+  // deleting this host.
+  void set_delegate(BrowserChildProcessHostDelegate* delegate) {
+    delegate_ = delegate;
+  }
+
   typedef std::list<BrowserChildProcessHostImpl*> BrowserChildProcessList;
  private:
   friend class BrowserChildProcessHostIterator;
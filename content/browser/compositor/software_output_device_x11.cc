@@ -7,6 +7,7 @@
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
 
+#include "base/metrics/histogram.h"
 #include "content/public/browser/browser_thread.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkDevice.h"
@@ -49,6 +50,12 @@ void SoftwareOutputDeviceX11::EndPaint(cc::SoftwareFrameData* frame_data) {
   if (rect.IsEmpty())
     return;
 
+  UMA_HISTOGRAM_CUSTOM_COUNTS("Compositing.Browser.SoftwareUploadKBPerFrame",
+                              rect.size().GetArea() * 4 / 1024,
+                              1,
+                              64 * 1024,
+                              50);
+
   // TODO(jbauman): Switch to XShmPutImage since it's async.
   const SkBitmap& bitmap = device_->accessBitmap(false);
   gfx::PutARGBImage(display_,
@@ -27,8 +27,14 @@ namespace content {
 
 static const int kCommitTimerSeconds = 1;
 
+// Batches larger than this are committed without waiting for the
+// timer, bounding both the memory held by a batch and the time the
+// commit sequence spends writing it.
+static const size_t kMaxCommitBatchBytes = 1024 * 1024;
+
 DOMStorageArea::CommitBatch::CommitBatch()
-  : clear_all_first(false) {
+  : clear_all_first(false),
+    bytes(0) {
 }
 DOMStorageArea::CommitBatch::~CommitBatch() {}
 
@@ -140,6 +146,8 @@ bool DOMStorageArea::SetItem(const base::string16& key,
   if (success && backing_) {
     CommitBatch* commit_batch = CreateCommitBatchIfNeeded();
     commit_batch->changed_values[key] = base::NullableString16(value, false);
+    commit_batch->bytes += (key.size() + value.size()) * sizeof(base::char16);
+    CommitBatchIfFull();
   }
   return success;
 }
@@ -155,6 +163,8 @@ bool DOMStorageArea::RemoveItem(const base::string16& key,
   if (success && backing_) {
     CommitBatch* commit_batch = CreateCommitBatchIfNeeded();
     commit_batch->changed_values[key] = base::NullableString16();
+    commit_batch->bytes += key.size() * sizeof(base::char16);
+    CommitBatchIfFull();
   }
   return success;
 }
@@ -173,6 +183,7 @@ bool DOMStorageArea::Clear() {
     CommitBatch* commit_batch = CreateCommitBatchIfNeeded();
     commit_batch->clear_all_first = true;
     commit_batch->changed_values.clear();
+    commit_batch->bytes = 0;
   }
 
   return true;
@@ -195,6 +206,7 @@ void DOMStorageArea::FastClear() {
     CommitBatch* commit_batch = CreateCommitBatchIfNeeded();
     commit_batch->clear_all_first = true;
     commit_batch->changed_values.clear();
+    commit_batch->bytes = 0;
   }
 }
 
@@ -335,6 +347,13 @@ DOMStorageArea::CommitBatch* DOMStorageArea::CreateCommitBatchIfNeeded() {
   return commit_batch_.get();
 }
 
+void DOMStorageArea::CommitBatchIfFull() {
+  if (commit_batch_ && !commit_batches_in_flight_ &&
+      commit_batch_->bytes >= kMaxCommitBatchBytes) {
+    OnCommitTimer();
+  }
+}
+
 void DOMStorageArea::OnCommitTimer() {
   if (is_shutdown_)
     return;
@@ -377,6 +396,10 @@ void DOMStorageArea::OnCommitComplete() {
   if (is_shutdown_)
     return;
   if (commit_batch_.get() && !commit_batches_in_flight_) {
+    if (commit_batch_->bytes >= kMaxCommitBatchBytes) {
+      OnCommitTimer();
+      return;
+    }
     // More changes have accrued, restart the timer.
     task_runner_->PostDelayedTask(
         FROM_HERE,
@@ -89,6 +89,7 @@ class CONTENT_EXPORT DOMStorageArea
   FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, BackingDatabaseOpened);
   FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, TestDatabaseFilePath);
   FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, CommitTasks);
+  FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, CommitLargeBatchEarly);
   FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, CommitChangesAtShutdown);
   FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, DeleteOrigin);
   FRIEND_TEST_ALL_PREFIXES(DOMStorageAreaTest, PurgeMemory);
@@ -98,6 +99,9 @@ class CONTENT_EXPORT DOMStorageArea
   struct CommitBatch {
     bool clear_all_first;
     DOMStorageValuesMap changed_values;
+    // Approximate size of |changed_values|, counting overwritten keys
+    // more than once.
+    size_t bytes;
     CommitBatch();
     ~CommitBatch();
   };
@@ -113,6 +117,9 @@ class CONTENT_EXPORT DOMStorageArea
   // disk on the commit sequence, and to call back on the primary
   // task sequence when complete.
   CommitBatch* CreateCommitBatchIfNeeded();
+  // Commits the pending batch without waiting for the timer if it has
+  // grown past kMaxCommitBatchBytes and no commit is in flight.
+  void CommitBatchIfFull();
   void OnCommitTimer();
   void CommitChanges(const CommitBatch* commit_batch);
   void OnCommitComplete();
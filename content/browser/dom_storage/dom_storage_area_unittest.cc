@@ -281,6 +281,41 @@ TEST_F(DOMStorageAreaTest, CommitTasks) {
   EXPECT_EQ(kValue2, values[kKey2].string());
 }
 
+TEST_F(DOMStorageAreaTest, CommitLargeBatchEarly) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+
+  scoped_refptr<DOMStorageArea> area(new DOMStorageArea(
+      kOrigin,
+      temp_dir.path(),
+      new MockDOMStorageTaskRunner(base::MessageLoopProxy::current().get())));
+  // Inject an in-memory db to speed up the test.
+  area->backing_.reset(new LocalStorageDatabaseAdapter());
+  EXPECT_EQ(0u, area->Length());
+
+  // A small change waits for the timer.
+  base::NullableString16 old_value;
+  EXPECT_TRUE(area->SetItem(kKey, kValue, &old_value));
+  EXPECT_TRUE(area->commit_batch_.get());
+  EXPECT_EQ(0, area->commit_batches_in_flight_);
+
+  // A change which takes the batch past the limit (1MB) is committed
+  // right away, together with the earlier change.
+  const size_t kLargeValueBytes = 1024 * 1024;
+  const base::string16 large_value(kLargeValueBytes / sizeof(base::char16),
+                                   'x');
+  EXPECT_TRUE(area->SetItem(kKey2, large_value, &old_value));
+  EXPECT_FALSE(area->commit_batch_.get());
+  EXPECT_EQ(1, area->commit_batches_in_flight_);
+
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_FALSE(area->HasUncommittedChanges());
+  DOMStorageValuesMap values;
+  area->backing_->ReadAllValues(&values);
+  EXPECT_EQ(2u, values.size());
+  EXPECT_EQ(large_value, values[kKey2].string());
+}
+
 TEST_F(DOMStorageAreaTest, CommitChangesAtShutdown) {
   base::ScopedTempDir temp_dir;
   ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
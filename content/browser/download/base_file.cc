@@ -4,8 +4,11 @@
 
 #include "content/browser/download/base_file.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/file_util.h"
+#include "base/files/file.h"
 #include "base/format_macros.h"
 #include "base/logging.h"
 #include "base/pickle.h"
@@ -38,6 +41,7 @@ BaseFile::BaseFile(const base::FilePath& full_path,
       referrer_url_(referrer_url),
       file_stream_(file_stream.Pass()),
       bytes_so_far_(received_bytes),
+      written_end_(0),
       start_tick_(base::TimeTicks::Now()),
       calculate_hash_(calculate_hash),
       detached_(false),
@@ -148,6 +152,84 @@ DownloadInterruptReason BaseFile::AppendDataToFile(const char* data,
   return DOWNLOAD_INTERRUPT_REASON_NONE;
 }
 
+DownloadInterruptReason BaseFile::WriteDataToFileAtOffset(int64 offset,
+                                                          const char* data,
+                                                          size_t data_len) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  DCHECK(!detached_);
+  DCHECK_GE(offset, bytes_so_far_);
+
+  if (!file_stream_)
+    return LogInterruptReason("No file stream on write", 0,
+                              DOWNLOAD_INTERRUPT_REASON_FILE_FAILED);
+
+  if (data_len == 0)
+    return DOWNLOAD_INTERRUPT_REASON_NONE;
+
+  int64 seek_result = file_stream_->SeekSync(net::FROM_BEGIN, offset);
+  if (seek_result < 0)
+    return LogNetError("Seek", static_cast<net::Error>(seek_result));
+
+  size_t len = data_len;
+  const char* current_data = data;
+  while (len > 0) {
+    int write_result = file_stream_->WriteSync(current_data, len);
+    DCHECK_NE(0, write_result);
+    DCHECK_NE(net::ERR_IO_PENDING, write_result);
+    if (write_result < 0)
+      return LogNetError("Write", static_cast<net::Error>(write_result));
+    len -= write_result;
+    current_data += write_result;
+  }
+  written_end_ = std::max(written_end_, offset + static_cast<int64>(data_len));
+
+  // Put the stream back where the next appended data goes.
+  seek_result = file_stream_->SeekSync(net::FROM_BEGIN, bytes_so_far_);
+  if (seek_result < 0)
+    return LogNetError("Seek", static_cast<net::Error>(seek_result));
+
+  RecordDownloadWriteSize(data_len);
+  return DOWNLOAD_INTERRUPT_REASON_NONE;
+}
+
+DownloadInterruptReason BaseFile::AppendWrittenData(int64 length) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+  DCHECK(!detached_);
+  DCHECK_LE(bytes_so_far_ + length, written_end_);
+
+  if (!file_stream_)
+    return LogInterruptReason("No file stream on append", 0,
+                              DOWNLOAD_INTERRUPT_REASON_FILE_FAILED);
+
+  if (calculate_hash_) {
+    base::File file(full_path_, base::File::FLAG_OPEN | base::File::FLAG_READ);
+    if (!file.IsValid())
+      return LogInterruptReason("Unable to read back", 0,
+                                DOWNLOAD_INTERRUPT_REASON_FILE_FAILED);
+
+    const int kReadSize = 64 * 1024;
+    char buffer[kReadSize];
+    int64 offset = bytes_so_far_;
+    const int64 end = bytes_so_far_ + length;
+    while (offset < end) {
+      int read_result = file.Read(
+          offset, buffer,
+          static_cast<int>(std::min<int64>(kReadSize, end - offset)));
+      if (read_result <= 0)
+        return LogInterruptReason("Unable to read back", 0,
+                                  DOWNLOAD_INTERRUPT_REASON_FILE_FAILED);
+      secure_hash_->Update(buffer, read_result);
+      offset += read_result;
+    }
+  }
+  bytes_so_far_ += length;
+
+  int64 seek_result = file_stream_->SeekSync(net::FROM_BEGIN, bytes_so_far_);
+  if (seek_result < 0)
+    return LogNetError("Seek", static_cast<net::Error>(seek_result));
+  return DOWNLOAD_INTERRUPT_REASON_NONE;
+}
+
 DownloadInterruptReason BaseFile::Rename(const base::FilePath& new_path) {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
   DownloadInterruptReason rename_result = DOWNLOAD_INTERRUPT_REASON_NONE;
@@ -295,24 +377,32 @@ DownloadInterruptReason BaseFile::Open() {
     file_stream_->SetBoundNetLogSource(bound_net_log_);
   }
 
+  // Data written out of order past |bytes_so_far_| is kept.
+  const int64 data_end = std::max(bytes_so_far_, written_end_);
   int64 file_size = file_stream_->SeekSync(net::FROM_END, 0);
-  if (file_size > bytes_so_far_) {
+  if (file_size > data_end) {
     // The file is larger than we expected.
     // This is OK, as long as we don't use the extra.
     // Truncate the file.
-    int64 truncate_result = file_stream_->Truncate(bytes_so_far_);
+    int64 truncate_result = file_stream_->Truncate(data_end);
     if (truncate_result < 0)
       return LogNetError("Truncate", static_cast<net::Error>(truncate_result));
 
     // If if wasn't an error, it should have truncated to the size
     // specified.
-    DCHECK_EQ(bytes_so_far_, truncate_result);
+    DCHECK_EQ(data_end, truncate_result);
   } else if (file_size < bytes_so_far_) {
     // The file is shorter than we expected.  Our hashes won't be valid.
     return LogInterruptReason("Unable to seek to last written point", 0,
                               DOWNLOAD_INTERRUPT_REASON_FILE_TOO_SHORT);
   }
 
+  if (data_end > bytes_so_far_) {
+    int64 seek_result = file_stream_->SeekSync(net::FROM_BEGIN, bytes_so_far_);
+    if (seek_result < 0)
+      return LogNetError("Seek", static_cast<net::Error>(seek_result));
+  }
+
   return DOWNLOAD_INTERRUPT_REASON_NONE;
 }
 
@@ -57,6 +57,17 @@ class CONTENT_EXPORT BaseFile {
   // indicating the result of the operation.
   DownloadInterruptReason AppendDataToFile(const char* data, size_t data_len);
 
+  // Writes a chunk of data at |offset|, which must be past the appended
+  // data. Used for data that arrives out of order; it does not count in
+  // bytes_so_far() or the hash until AppendWrittenData() takes it in.
+  DownloadInterruptReason WriteDataToFileAtOffset(int64 offset,
+                                                  const char* data,
+                                                  size_t data_len);
+
+  // Appends the |length| bytes that WriteDataToFileAtOffset() already wrote
+  // right after the appended data, reading them back to update the hash.
+  DownloadInterruptReason AppendWrittenData(int64 length);
+
   // Rename the download file. Returns a DownloadInterruptReason indicating the
   // result of the operation.
   virtual DownloadInterruptReason Rename(const base::FilePath& full_path);
@@ -157,6 +168,10 @@ class CONTENT_EXPORT BaseFile {
   // Amount of data received up so far, in bytes.
   int64 bytes_so_far_;
 
+  // End of the furthest data written by WriteDataToFileAtOffset(), or 0.
+  // The file is not truncated below it when reopened.
+  int64 written_end_;
+
   // Start time for calculating speed.
   base::TimeTicks start_tick_;
 
@@ -0,0 +1,101 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/download/base_file.h"
+
+#include <string>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/message_loop/message_loop.h"
+#include "base/test/perf_time_logger.h"
+#include "content/browser/browser_thread_impl.h"
+#include "content/public/browser/download_interrupt_reasons.h"
+#include "net/base/file_stream.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace content {
+
+namespace {
+
+const int64 kFileSize = 64 * 1024 * 1024;
+
+// The size of the buffers DownloadResourceHandler reads into.
+const size_t kChunkSize = 32 * 1024;
+
+// Number of streams a parallel download writes, including the initial one.
+const int kStreamCount = 4;
+
+}  // namespace
+
+class BaseFilePerfTest : public testing::Test {
+ public:
+  BaseFilePerfTest()
+      : chunk_(kChunkSize, 'x'),
+        file_thread_(BrowserThread::FILE, &message_loop_) {
+  }
+
+  virtual void SetUp() {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    base_file_.reset(new BaseFile(base::FilePath(),
+                                  GURL(),
+                                  GURL(),
+                                  0,
+                                  true,
+                                  std::string(),
+                                  scoped_ptr<net::FileStream>(),
+                                  net::BoundNetLog()));
+    ASSERT_EQ(DOWNLOAD_INTERRUPT_REASON_NONE,
+              base_file_->Initialize(temp_dir_.path()));
+  }
+
+  virtual void TearDown() {
+    base_file_->Finish();
+    EXPECT_EQ(kFileSize, base_file_->bytes_so_far());
+    base_file_.reset();
+  }
+
+ protected:
+  const std::string chunk_;
+  scoped_ptr<BaseFile> base_file_;
+
+ private:
+  base::ScopedTempDir temp_dir_;
+  base::MessageLoop message_loop_;
+  BrowserThreadImpl file_thread_;
+};
+
+// The single stream download.
+TEST_F(BaseFilePerfTest, SequentialWrites) {
+  base::PerfTimeLogger timer("Download_64MB_sequential");
+  for (int64 offset = 0; offset < kFileSize; offset += kChunkSize) {
+    ASSERT_EQ(DOWNLOAD_INTERRUPT_REASON_NONE,
+              base_file_->AppendDataToFile(chunk_.data(), chunk_.size()));
+  }
+  timer.Done();
+}
+
+// The streams of a parallel download arrive interleaved; the data past the
+// first one is taken in, and read back for the hash, as it becomes
+// contiguous.
+TEST_F(BaseFilePerfTest, ParallelWrites) {
+  const int64 part_size = kFileSize / kStreamCount;
+  base::PerfTimeLogger timer("Download_64MB_parallel");
+  for (int64 offset = 0; offset < part_size; offset += kChunkSize) {
+    ASSERT_EQ(DOWNLOAD_INTERRUPT_REASON_NONE,
+              base_file_->AppendDataToFile(chunk_.data(), chunk_.size()));
+    for (int i = 1; i < kStreamCount; ++i) {
+      ASSERT_EQ(DOWNLOAD_INTERRUPT_REASON_NONE,
+                base_file_->WriteDataToFileAtOffset(
+                    i * part_size + offset, chunk_.data(), chunk_.size()));
+    }
+  }
+  for (int i = 1; i < kStreamCount; ++i) {
+    ASSERT_EQ(DOWNLOAD_INTERRUPT_REASON_NONE,
+              base_file_->AppendWrittenData(part_size));
+  }
+  timer.Done();
+}
+
+}  // namespace content
@@ -366,6 +366,36 @@ TEST_F(BaseFileTest, MultipleWritesWithHash) {
   EXPECT_EQ(expected_hash_hex, base::HexEncode(hash.data(), hash.size()));
 }
 
+// Write data out of order, renaming the file in between, and take it in
+// afterwards. The hash is the same as for the data written in order.
+TEST_F(BaseFileTest, WriteAtOffsetWithHash) {
+  MakeFileWithHash();
+  ASSERT_TRUE(InitializeFile());
+  ASSERT_TRUE(AppendDataToFile(kTestData1));
+  EXPECT_EQ(DOWNLOAD_INTERRUPT_REASON_NONE,
+            base_file_->WriteDataToFileAtOffset(
+                kTestDataLength1 + kTestDataLength2,
+                kTestData3, kTestDataLength3));
+  EXPECT_EQ(kTestDataLength1, base_file_->bytes_so_far());
+
+  base::FilePath new_path(temp_dir_.path().AppendASCII("NewFile"));
+  EXPECT_EQ(DOWNLOAD_INTERRUPT_REASON_NONE, base_file_->Rename(new_path));
+
+  EXPECT_EQ(DOWNLOAD_INTERRUPT_REASON_NONE,
+            base_file_->WriteDataToFileAtOffset(
+                kTestDataLength1, kTestData2, kTestDataLength2));
+  EXPECT_EQ(DOWNLOAD_INTERRUPT_REASON_NONE,
+            base_file_->AppendWrittenData(kTestDataLength2 +
+                                          kTestDataLength3));
+  set_expected_data(std::string(kTestData1) + kTestData2 + kTestData3);
+  base_file_->Finish();
+
+  std::string hash;
+  EXPECT_TRUE(base_file_->GetHash(&hash));
+  EXPECT_EQ("CBF68BF10F8003DB86B31343AFAC8C7175BD03FB5FC905650F8C80AF087443A8",
+            base::HexEncode(hash.data(), hash.size()));
+}
+
 // Write data to the file multiple times, interrupt it, and continue using
 // another file.  Calculate the resulting combined sha256 hash.
 TEST_F(BaseFileTest, MultipleWritesInterruptedWithHash) {
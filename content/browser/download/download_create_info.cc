@@ -22,6 +22,7 @@ DownloadCreateInfo::DownloadCreateInfo(const base::Time& start_time,
       download_id(DownloadItem::kInvalidId),
       has_user_gesture(has_user_gesture),
       transition_type(transition_type),
+      accepts_ranges(false),
       save_info(save_info.Pass()),
       request_bound_net_log(bound_net_log) {}
 
@@ -30,6 +31,7 @@ DownloadCreateInfo::DownloadCreateInfo()
       download_id(DownloadItem::kInvalidId),
       has_user_gesture(false),
       transition_type(PAGE_TRANSITION_LINK),
+      accepts_ranges(false),
       save_info(new DownloadSaveInfo()) {
 }
 
@@ -78,6 +78,9 @@ struct CONTENT_EXPORT DownloadCreateInfo {
   // For continuing a download, the ETAG of the file.
   std::string etag;
 
+  // True if the server announced that it serves byte ranges of the file.
+  bool accepts_ranges;
+
   // The download file save info.
   scoped_ptr<DownloadSaveInfo> save_info;
 
@@ -10,11 +10,13 @@
 #include "base/basictypes.h"
 #include "base/callback_forward.h"
 #include "base/files/file_path.h"
+#include "base/memory/scoped_ptr.h"
 #include "content/common/content_export.h"
 #include "content/public/browser/download_interrupt_reasons.h"
 
 namespace content {
 
+class ByteStreamReader;
 class DownloadManager;
 
 // These objects live exclusively on the file thread and handle the writing
@@ -78,6 +80,13 @@ class CONTENT_EXPORT DownloadFile {
   // before RenameAndAnnotate() to take effect.
   virtual void SetClientGuid(const std::string& guid) = 0;
 
+  // Adds |stream|, the response to a request for the file from |offset| on,
+  // to be written in parallel with the initial stream. Each stream is
+  // written up to the start of the next one, so the streams together cover
+  // the file. Ignored if the data at |offset| is already being written.
+  virtual void AddByteStream(scoped_ptr<ByteStreamReader> stream,
+                             int64 offset) = 0;
+
   // For testing.  Must be called on FILE thread.
   // TODO(rdsmith): Replace use of EnsureNoPendingDownloads()
   // on the DownloadManager with a test-specific DownloadFileFactory
@@ -4,6 +4,7 @@
 
 #include "content/browser/download/download_file_impl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "base/bind.h"
@@ -48,6 +49,7 @@ DownloadFileImpl::DownloadFileImpl(
                 bound_net_log),
           default_download_directory_(default_download_directory),
           stream_reader_(stream.Pass()),
+          stream_reached_parallel_stream_(false),
           bytes_seen_(0),
           bound_net_log_(bound_net_log),
           observer_(observer),
@@ -55,6 +57,19 @@ DownloadFileImpl::DownloadFileImpl(
           power_save_blocker_(power_save_blocker.Pass()) {
 }
 
+DownloadFileImpl::ParallelStream::ParallelStream(
+    int64 offset,
+    scoped_ptr<ByteStreamReader> stream_reader)
+    : offset(offset),
+      bytes_written(0),
+      reached_next_stream(false),
+      completed(false),
+      stream_reader(stream_reader.Pass()) {
+}
+
+DownloadFileImpl::ParallelStream::~ParallelStream() {
+}
+
 DownloadFileImpl::~DownloadFileImpl() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
   --number_active_objects_;
@@ -97,12 +112,25 @@ DownloadInterruptReason DownloadFileImpl::AppendDataToFile(
   if (!update_timer_->IsRunning()) {
     update_timer_->Start(FROM_HERE,
                          base::TimeDelta::FromMilliseconds(kUpdatePeriodMs),
-                         this, &DownloadFileImpl::SendUpdate);
+                         this, &DownloadFileImpl::OnUpdateTimer);
   }
   rate_estimator_.Increment(data_len);
   return file_.AppendDataToFile(data, data_len);
 }
 
+DownloadInterruptReason DownloadFileImpl::WriteDataToFileAtOffset(
+    int64 offset, const char* data, size_t data_len) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+
+  if (!update_timer_->IsRunning()) {
+    update_timer_->Start(FROM_HERE,
+                         base::TimeDelta::FromMilliseconds(kUpdatePeriodMs),
+                         this, &DownloadFileImpl::OnUpdateTimer);
+  }
+  rate_estimator_.Increment(data_len);
+  return file_.WriteDataToFileAtOffset(offset, data, data_len);
+}
+
 void DownloadFileImpl::RenameAndUniquify(
     const base::FilePath& full_path,
     const RenameCompletionCallback& callback) {
@@ -123,8 +151,8 @@ void DownloadFileImpl::RenameAndUniquify(
     // error out.
     SendUpdate();
 
-    // Null out callback so that we don't do any more stream processing.
-    stream_reader_->RegisterCallback(base::Closure());
+    // Null out callbacks so that we don't do any more stream processing.
+    ClearStreamCallbacks();
 
     new_path.clear();
   }
@@ -161,8 +189,8 @@ void DownloadFileImpl::RenameAndAnnotate(
     // error out.
     SendUpdate();
 
-    // Null out callback so that we don't do any more stream processing.
-    stream_reader_->RegisterCallback(base::Closure());
+    // Null out callbacks so that we don't do any more stream processing.
+    ClearStreamCallbacks();
 
     new_path.clear();
   }
@@ -204,6 +232,41 @@ void DownloadFileImpl::SetClientGuid(const std::string& guid) {
   file_.SetClientGuid(guid);
 }
 
+void DownloadFileImpl::AddByteStream(scoped_ptr<ByteStreamReader> stream,
+                                     int64 offset) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::FILE));
+
+  // Not yet initialized, or already done.
+  if (!update_timer_)
+    return;
+
+  ScopedVector<ParallelStream>::iterator next = parallel_streams_.begin();
+  while (next != parallel_streams_.end() && (*next)->offset < offset)
+    ++next;
+  if (next != parallel_streams_.end() && (*next)->offset == offset)
+    return;
+
+  // The stream before the new one must not have written past |offset|, nor
+  // have stopped already.
+  if (next == parallel_streams_.begin()) {
+    if (stream_reached_parallel_stream_ || file_.bytes_so_far() >= offset)
+      return;
+  } else {
+    const ParallelStream* previous = *(next - 1);
+    if (previous->finished() ||
+        previous->offset + previous->bytes_written >= offset) {
+      return;
+    }
+  }
+
+  ParallelStream* parallel_stream = new ParallelStream(offset, stream.Pass());
+  parallel_streams_.insert(next, parallel_stream);
+  parallel_stream->stream_reader->RegisterCallback(
+      base::Bind(&DownloadFileImpl::ParallelStreamActive,
+                 weak_factory_.GetWeakPtr(), parallel_stream));
+  ParallelStreamActive(parallel_stream);
+}
+
 void DownloadFileImpl::StreamActive() {
   base::TimeTicks start(base::TimeTicks::Now());
   base::TimeTicks now;
@@ -226,11 +289,19 @@ void DownloadFileImpl::StreamActive() {
       case ByteStreamReader::STREAM_HAS_DATA:
         {
           ++num_buffers;
+          // Data from the first parallel stream on is written by that
+          // stream.
+          size_t data_len = incoming_data_size;
+          const int64 limit = NextStreamOffset(file_.bytes_so_far());
+          if (limit >= 0 &&
+              file_.bytes_so_far() + static_cast<int64>(data_len) >= limit) {
+            data_len = static_cast<size_t>(limit - file_.bytes_so_far());
+            stream_reached_parallel_stream_ = true;
+          }
           base::TimeTicks write_start(base::TimeTicks::Now());
-          reason = AppendDataToFile(
-              incoming_data.get()->data(), incoming_data_size);
+          reason = AppendDataToFile(incoming_data.get()->data(), data_len);
           disk_writes_time_ += (base::TimeTicks::Now() - write_start);
-          bytes_seen_ += incoming_data_size;
+          bytes_seen_ += data_len;
           total_incoming_data_size += incoming_data_size;
         }
         break;
@@ -238,14 +309,12 @@ void DownloadFileImpl::StreamActive() {
         {
           reason = static_cast<DownloadInterruptReason>(
               stream_reader_->GetStatus());
-          SendUpdate();
-          base::TimeTicks close_start(base::TimeTicks::Now());
-          file_.Finish();
-          base::TimeTicks now(base::TimeTicks::Now());
-          disk_writes_time_ += (now - close_start);
-          RecordFileBandwidth(
-              bytes_seen_, disk_writes_time_, now - download_start_);
-          update_timer_.reset();
+          if (parallel_streams_.empty()) {
+            FinishFile();
+          } else if (reason == DOWNLOAD_INTERRUPT_REASON_NONE) {
+            // The response ended short of the first parallel stream.
+            reason = DOWNLOAD_INTERRUPT_REASON_NETWORK_FAILED;
+          }
         }
         break;
       default:
@@ -255,10 +324,12 @@ void DownloadFileImpl::StreamActive() {
     now = base::TimeTicks::Now();
   } while (state == ByteStreamReader::STREAM_HAS_DATA &&
            reason == DOWNLOAD_INTERRUPT_REASON_NONE &&
+           !stream_reached_parallel_stream_ &&
            now - start <= delta);
 
   // If we're stopping to yield the thread, post a task so we come back.
   if (state == ByteStreamReader::STREAM_HAS_DATA &&
+      !stream_reached_parallel_stream_ &&
       now - start > delta) {
     BrowserThread::PostTask(
         BrowserThread::FILE, FROM_HERE,
@@ -274,28 +345,13 @@ void DownloadFileImpl::StreamActive() {
   // Take care of communication with our observer.
   if (reason != DOWNLOAD_INTERRUPT_REASON_NONE) {
     // Error case for both upstream source and file write.
-    // Shut down processing and signal an error to our observer.
-    // Our observer will clean us up.
-    stream_reader_->RegisterCallback(base::Closure());
-    weak_factory_.InvalidateWeakPtrs();
-    SendUpdate();                       // Make info up to date before error.
-    BrowserThread::PostTask(
-        BrowserThread::UI, FROM_HERE,
-        base::Bind(&DownloadDestinationObserver::DestinationError,
-                   observer_, reason));
+    OnStreamError(reason);
   } else if (state == ByteStreamReader::STREAM_COMPLETE) {
-    // Signal successful completion and shut down processing.
+    NotifyCompleted();
+  } else if (stream_reached_parallel_stream_) {
+    // The rest of the response is not needed.
     stream_reader_->RegisterCallback(base::Closure());
-    weak_factory_.InvalidateWeakPtrs();
-    std::string hash;
-    if (!GetHash(&hash) || file_.IsEmptyHash(hash))
-      hash.clear();
-    SendUpdate();
-    BrowserThread::PostTask(
-        BrowserThread::UI, FROM_HERE,
-        base::Bind(
-            &DownloadDestinationObserver::DestinationCompleted,
-            observer_, hash));
+    MaybeCompleteParallelDownload();
   }
   if (bound_net_log_.IsLoggingAllEvents()) {
     bound_net_log_.AddEvent(
@@ -305,11 +361,208 @@ void DownloadFileImpl::StreamActive() {
   }
 }
 
+void DownloadFileImpl::ParallelStreamActive(ParallelStream* stream) {
+  base::TimeTicks start(base::TimeTicks::Now());
+  base::TimeTicks now;
+  scoped_refptr<net::IOBuffer> incoming_data;
+  size_t incoming_data_size = 0;
+  ByteStreamReader::StreamState state(ByteStreamReader::STREAM_EMPTY);
+  DownloadInterruptReason reason = DOWNLOAD_INTERRUPT_REASON_NONE;
+  base::TimeDelta delta(
+      base::TimeDelta::FromMilliseconds(kMaxTimeBlockingFileThreadMs));
+
+  do {
+    state = stream->stream_reader->Read(&incoming_data, &incoming_data_size);
+
+    switch (state) {
+      case ByteStreamReader::STREAM_EMPTY:
+        break;
+      case ByteStreamReader::STREAM_HAS_DATA:
+        {
+          const int64 write_offset = stream->offset + stream->bytes_written;
+          const int64 limit = NextStreamOffset(stream->offset);
+          size_t data_len = incoming_data_size;
+          if (limit >= 0 &&
+              write_offset + static_cast<int64>(data_len) >= limit) {
+            data_len = static_cast<size_t>(limit - write_offset);
+            stream->reached_next_stream = true;
+          }
+          base::TimeTicks write_start(base::TimeTicks::Now());
+          reason = WriteDataToFileAtOffset(
+              write_offset, incoming_data.get()->data(), data_len);
+          disk_writes_time_ += (base::TimeTicks::Now() - write_start);
+          bytes_seen_ += data_len;
+          stream->bytes_written += data_len;
+        }
+        break;
+      case ByteStreamReader::STREAM_COMPLETE:
+        {
+          reason = static_cast<DownloadInterruptReason>(
+              stream->stream_reader->GetStatus());
+          if (reason != DOWNLOAD_INTERRUPT_REASON_NONE)
+            break;
+          // Only the last stream runs to the end of the file.
+          if (NextStreamOffset(stream->offset) >= 0)
+            reason = DOWNLOAD_INTERRUPT_REASON_NETWORK_FAILED;
+          else
+            stream->completed = true;
+        }
+        break;
+      default:
+        NOTREACHED();
+        break;
+    }
+    now = base::TimeTicks::Now();
+  } while (state == ByteStreamReader::STREAM_HAS_DATA &&
+           reason == DOWNLOAD_INTERRUPT_REASON_NONE &&
+           !stream->finished() &&
+           now - start <= delta);
+
+  // If we're stopping to yield the thread, post a task so we come back.
+  if (state == ByteStreamReader::STREAM_HAS_DATA &&
+      !stream->finished() &&
+      now - start > delta) {
+    BrowserThread::PostTask(
+        BrowserThread::FILE, FROM_HERE,
+        base::Bind(&DownloadFileImpl::ParallelStreamActive,
+                   weak_factory_.GetWeakPtr(), stream));
+  }
+
+  if (reason != DOWNLOAD_INTERRUPT_REASON_NONE) {
+    OnStreamError(reason);
+  } else if (stream->finished()) {
+    stream->stream_reader->RegisterCallback(base::Closure());
+    MaybeCompleteParallelDownload();
+  }
+}
+
+int64 DownloadFileImpl::NextStreamOffset(int64 offset) const {
+  for (ScopedVector<ParallelStream>::const_iterator it =
+           parallel_streams_.begin();
+       it != parallel_streams_.end(); ++it) {
+    if ((*it)->offset > offset)
+      return (*it)->offset;
+  }
+  return -1;
+}
+
+int64 DownloadFileImpl::BytesWritten() const {
+  const int64 contiguous_bytes = file_.bytes_so_far();
+  int64 bytes = contiguous_bytes;
+  for (ScopedVector<ParallelStream>::const_iterator it =
+           parallel_streams_.begin();
+       it != parallel_streams_.end(); ++it) {
+    const int64 stream_end = (*it)->offset + (*it)->bytes_written;
+    bytes += std::max<int64>(
+        0, stream_end - std::max((*it)->offset, contiguous_bytes));
+  }
+  return bytes;
+}
+
+DownloadInterruptReason DownloadFileImpl::AppendParallelStreamData() {
+  DCHECK(stream_reached_parallel_stream_);
+  for (ScopedVector<ParallelStream>::const_iterator it =
+           parallel_streams_.begin();
+       it != parallel_streams_.end(); ++it) {
+    const int64 stream_end = (*it)->offset + (*it)->bytes_written;
+    if (stream_end <= file_.bytes_so_far()) {
+      // Already taken in, or nothing written yet.
+      if (!(*it)->reached_next_stream)
+        break;
+      continue;
+    }
+    DownloadInterruptReason reason =
+        file_.AppendWrittenData(stream_end - file_.bytes_so_far());
+    if (reason != DOWNLOAD_INTERRUPT_REASON_NONE)
+      return reason;
+    if (!(*it)->reached_next_stream)
+      break;
+  }
+  return DOWNLOAD_INTERRUPT_REASON_NONE;
+}
+
+void DownloadFileImpl::MaybeCompleteParallelDownload() {
+  if (!stream_reached_parallel_stream_)
+    return;
+  for (ScopedVector<ParallelStream>::const_iterator it =
+           parallel_streams_.begin();
+       it != parallel_streams_.end(); ++it) {
+    if (!(*it)->finished())
+      return;
+  }
+
+  DownloadInterruptReason reason = AppendParallelStreamData();
+  if (reason != DOWNLOAD_INTERRUPT_REASON_NONE) {
+    OnStreamError(reason);
+    return;
+  }
+  FinishFile();
+  NotifyCompleted();
+}
+
+void DownloadFileImpl::FinishFile() {
+  SendUpdate();
+  base::TimeTicks close_start(base::TimeTicks::Now());
+  file_.Finish();
+  base::TimeTicks now(base::TimeTicks::Now());
+  disk_writes_time_ += (now - close_start);
+  RecordFileBandwidth(bytes_seen_, disk_writes_time_, now - download_start_);
+  update_timer_.reset();
+}
+
+void DownloadFileImpl::NotifyCompleted() {
+  // Signal successful completion and shut down processing.
+  ClearStreamCallbacks();
+  weak_factory_.InvalidateWeakPtrs();
+  std::string hash;
+  if (!GetHash(&hash) || file_.IsEmptyHash(hash))
+    hash.clear();
+  SendUpdate();
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(
+          &DownloadDestinationObserver::DestinationCompleted,
+          observer_, hash));
+}
+
+void DownloadFileImpl::OnStreamError(DownloadInterruptReason reason) {
+  // Shut down processing and signal an error to our observer.
+  // Our observer will clean us up.
+  ClearStreamCallbacks();
+  weak_factory_.InvalidateWeakPtrs();
+  SendUpdate();                       // Make info up to date before error.
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&DownloadDestinationObserver::DestinationError,
+                 observer_, reason));
+}
+
+void DownloadFileImpl::ClearStreamCallbacks() {
+  stream_reader_->RegisterCallback(base::Closure());
+  for (ScopedVector<ParallelStream>::iterator it = parallel_streams_.begin();
+       it != parallel_streams_.end(); ++it) {
+    (*it)->stream_reader->RegisterCallback(base::Closure());
+  }
+}
+
+void DownloadFileImpl::OnUpdateTimer() {
+  // Checkpoint the hash over the parallel stream data that is now in order.
+  if (stream_reached_parallel_stream_) {
+    DownloadInterruptReason reason = AppendParallelStreamData();
+    if (reason != DOWNLOAD_INTERRUPT_REASON_NONE) {
+      update_timer_.reset();
+      OnStreamError(reason);
+      return;
+    }
+  }
+  SendUpdate();
+}
+
 void DownloadFileImpl::SendUpdate() {
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
       base::Bind(&DownloadDestinationObserver::DestinationUpdate,
-                 observer_, file_.bytes_so_far(), CurrentSpeed(),
+                 observer_, BytesWritten(), CurrentSpeed(),
                  GetHashState()));
 }
 
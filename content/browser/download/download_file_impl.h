@@ -9,6 +9,7 @@
 
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
 #include "base/timer/timer.h"
@@ -64,6 +65,8 @@ class CONTENT_EXPORT DownloadFileImpl : virtual public DownloadFile {
   virtual bool GetHash(std::string* hash) OVERRIDE;
   virtual std::string GetHashState() OVERRIDE;
   virtual void SetClientGuid(const std::string& guid) OVERRIDE;
+  virtual void AddByteStream(scoped_ptr<ByteStreamReader> stream,
+                             int64 offset) OVERRIDE;
 
  protected:
   // For test class overrides.
@@ -71,13 +74,70 @@ class CONTENT_EXPORT DownloadFileImpl : virtual public DownloadFile {
       const char* data, size_t data_len);
 
  private:
+  // A stream added by AddByteStream(), written from |offset| on until it
+  // reaches the next stream.
+  struct ParallelStream {
+    ParallelStream(int64 offset, scoped_ptr<ByteStreamReader> stream_reader);
+    ~ParallelStream();
+
+    bool finished() const { return reached_next_stream || completed; }
+
+    int64 offset;
+    int64 bytes_written;
+    bool reached_next_stream;
+    // Set when the stream ended successfully.
+    bool completed;
+    scoped_ptr<ByteStreamReader> stream_reader;
+  };
+
   // Send an update on our progress.
   void SendUpdate();
 
+  // Called by |update_timer_|.
+  void OnUpdateTimer();
+
   // Called when there's some activity on stream_reader_ that needs to be
   // handled.
   void StreamActive();
 
+  // Same for a parallel stream.
+  void ParallelStreamActive(ParallelStream* stream);
+
+  // Writes parallel stream data at |offset|.
+  DownloadInterruptReason WriteDataToFileAtOffset(int64 offset,
+                                                  const char* data,
+                                                  size_t data_len);
+
+  // Returns the offset of the first parallel stream after |offset|, where
+  // the stream writing at |offset| has to stop, or -1 if there is none.
+  int64 NextStreamOffset(int64 offset) const;
+
+  // Bytes written so far, including parallel stream data that is not yet
+  // contiguous with the rest.
+  int64 BytesWritten() const;
+
+  // Takes the parallel stream data that now directly follows the contiguous
+  // data of the file into it, so that the hash is checkpointed as the
+  // parallel streams progress rather than all at the end.
+  DownloadInterruptReason AppendParallelStreamData();
+
+  // Completes the download once the initial and all parallel streams have
+  // written their part.
+  void MaybeCompleteParallelDownload();
+
+  // Closes the file once all the data is in, and records statistics.
+  void FinishFile();
+
+  // Shuts down processing and signals successful completion.
+  void NotifyCompleted();
+
+  // Stops the processing of all streams and notifies the observer of the
+  // error.
+  void OnStreamError(DownloadInterruptReason reason);
+
+  // Stops listening to all streams.
+  void ClearStreamCallbacks();
+
   // The base file instance.
   BaseFile file_;
 
@@ -90,6 +150,12 @@ class CONTENT_EXPORT DownloadFileImpl : virtual public DownloadFile {
   // with DownloadFile and get rid of BaseFile.
   scoped_ptr<ByteStreamReader> stream_reader_;
 
+  // Set once |stream_reader_| reached the first parallel stream.
+  bool stream_reached_parallel_stream_;
+
+  // Sorted by offset.
+  ScopedVector<ParallelStream> parallel_streams_;
+
   // Used to trigger progress updates.
   scoped_ptr<base::RepeatingTimer<DownloadFileImpl> > update_timer_;
 
@@ -27,6 +27,7 @@ using ::testing::AnyNumber;
 using ::testing::DoAll;
 using ::testing::InSequence;
 using ::testing::Return;
+using ::testing::SaveArg;
 using ::testing::SetArgPointee;
 using ::testing::StrictMock;
 
@@ -60,6 +61,12 @@ class MockDownloadDestinationObserver : public DownloadDestinationObserver {
 
 MATCHER(IsNullCallback, "") { return (arg.is_null()); }
 
+scoped_refptr<net::IOBuffer> MakeBuffer(const std::string& data) {
+  scoped_refptr<net::IOBuffer> buffer = new net::IOBuffer(data.size());
+  memcpy(buffer->data(), data.data(), data.size());
+  return buffer;
+}
+
 }  // namespace
 
 class DownloadFileTest : public testing::Test {
@@ -602,4 +609,70 @@ TEST_F(DownloadFileTest, ConfirmUpdate) {
   DestroyDownloadFile(0);
 }
 
+// A parallel stream writes the end of the file, and the initial stream
+// stops where it begins.
+TEST_F(DownloadFileTest, ParallelStream) {
+  ASSERT_TRUE(CreateDownloadFile(0, true));
+  const std::string data1(kTestData1);
+  const std::string data2(kTestData2);
+  const std::string data3(kTestData3);
+
+  StrictMock<MockByteStreamReader>* parallel_stream =
+      new StrictMock<MockByteStreamReader>();
+  base::Closure parallel_callback;
+  EXPECT_CALL(*parallel_stream, RegisterCallback(_))
+      .WillOnce(SaveArg<0>(&parallel_callback))
+      .RetiresOnSaturation();
+  EXPECT_CALL(*parallel_stream, Read(_, _))
+      .WillOnce(Return(ByteStreamReader::STREAM_EMPTY))
+      .RetiresOnSaturation();
+  download_file_->AddByteStream(
+      scoped_ptr<ByteStreamReader>(parallel_stream),
+      data1.size() + data2.size());
+  ::testing::Mock::VerifyAndClearExpectations(parallel_stream);
+
+  // The parallel stream ends first.
+  ::testing::Sequence s1;
+  EXPECT_CALL(*parallel_stream, Read(_, _))
+      .InSequence(s1)
+      .WillOnce(DoAll(SetArgPointee<0>(MakeBuffer(data3)),
+                      SetArgPointee<1>(data3.size()),
+                      Return(ByteStreamReader::STREAM_HAS_DATA)))
+      .WillOnce(Return(ByteStreamReader::STREAM_COMPLETE));
+  EXPECT_CALL(*parallel_stream, GetStatus())
+      .InSequence(s1)
+      .WillOnce(Return(DOWNLOAD_INTERRUPT_REASON_NONE));
+  EXPECT_CALL(*parallel_stream, RegisterCallback(IsNullCallback()))
+      .Times(2);
+  parallel_callback.Run();
+
+  // The initial stream sends more than its part.
+  ::testing::Sequence s2;
+  const std::string data2_and_more(data2 + data3);
+  EXPECT_CALL(*input_stream_, Read(_, _))
+      .InSequence(s2)
+      .WillOnce(DoAll(SetArgPointee<0>(MakeBuffer(data1)),
+                      SetArgPointee<1>(data1.size()),
+                      Return(ByteStreamReader::STREAM_HAS_DATA)))
+      .WillOnce(DoAll(SetArgPointee<0>(MakeBuffer(data2_and_more)),
+                      SetArgPointee<1>(data2_and_more.size()),
+                      Return(ByteStreamReader::STREAM_HAS_DATA)));
+  EXPECT_CALL(*input_stream_, RegisterCallback(IsNullCallback()))
+      .Times(2);
+  std::string hash;
+  EXPECT_CALL(*(observer_.get()), DestinationCompleted(_))
+      .WillOnce(SaveArg<0>(&hash));
+  sink_callback_.Run();
+  loop_.RunUntilIdle();
+
+  EXPECT_EQ(kDataHash, base::HexEncode(hash.data(), hash.size()));
+  EXPECT_EQ(static_cast<int64>(data1.size() + data2.size() + data3.size()),
+            bytes_);
+  EXPECT_FALSE(download_file_->InProgress());
+  std::string disk_data;
+  EXPECT_TRUE(base::ReadFileToString(download_file_->FullPath(), &disk_data));
+  EXPECT_EQ(data1 + data2 + data3, disk_data);
+  download_file_.reset();
+}
+
 }  // namespace content
@@ -35,6 +35,7 @@
 #include "base/stl_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "content/browser/byte_stream.h"
 #include "content/browser/download/download_create_info.h"
 #include "content/browser/download/download_file.h"
 #include "content/browser/download/download_interrupt_reasons_impl.h"
@@ -97,6 +98,20 @@ bool IsDownloadResumptionEnabled() {
       switches::kEnableDownloadResumption);
 }
 
+// Number of requests a parallel download is split over, including the
+// initial one.
+const int kParallelRequestCount = 4;
+
+// Smaller downloads are not worth the extra requests.
+const int64 kMinParallelDownloadBytes = 8 * 1024 * 1024;
+
+bool IsParallelDownloadingEnabled() {
+  // The file has holes until all the requests are done, so there is nothing
+  // to resume from.
+  return CommandLine::ForCurrentProcess()->HasSwitch(
+      switches::kEnableParallelDownloading) && !IsDownloadResumptionEnabled();
+}
+
 }  // namespace
 
 const uint32 DownloadItem::kInvalidId = 0;
@@ -138,6 +153,8 @@ DownloadItemImpl::DownloadItemImpl(DownloadItemImplDelegate* delegate,
       bytes_per_sec_(0),
       last_modified_time_(last_modified),
       etag_(etag),
+      accepts_ranges_(false),
+      pending_parallel_requests_(0),
       last_reason_(interrupt_reason),
       start_tick_(base::TimeTicks()),
       state_(ExternalToInternalState(state)),
@@ -188,6 +205,8 @@ DownloadItemImpl::DownloadItemImpl(
       bytes_per_sec_(0),
       last_modified_time_(info.last_modified),
       etag_(info.etag),
+      accepts_ranges_(info.accepts_ranges),
+      pending_parallel_requests_(0),
       last_reason_(DOWNLOAD_INTERRUPT_REASON_NONE),
       start_tick_(base::TimeTicks::Now()),
       state_(IN_PROGRESS_INTERNAL),
@@ -243,6 +262,8 @@ DownloadItemImpl::DownloadItemImpl(
       total_bytes_(0),
       received_bytes_(0),
       bytes_per_sec_(0),
+      accepts_ranges_(false),
+      pending_parallel_requests_(0),
       last_reason_(DOWNLOAD_INTERRUPT_REASON_NONE),
       start_tick_(base::TimeTicks::Now()),
       state_(IN_PROGRESS_INTERNAL),
@@ -346,6 +367,8 @@ void DownloadItemImpl::Pause() {
     return;
 
   request_handle_->PauseRequest();
+  for (size_t i = 0; i < parallel_request_handles_.size(); ++i)
+    parallel_request_handles_[i]->PauseRequest();
   is_paused_ = true;
   UpdateObservers();
 }
@@ -357,6 +380,8 @@ void DownloadItemImpl::Resume() {
       if (!is_paused_)
         return;
       request_handle_->ResumeRequest();
+      for (size_t i = 0; i < parallel_request_handles_.size(); ++i)
+        parallel_request_handles_[i]->ResumeRequest();
       is_paused_ = false;
       UpdateObservers();
       return;
@@ -412,6 +437,7 @@ void DownloadItemImpl::Cancel(bool user_cancel) {
     // Cancel the originating URL request unless it's already been cancelled
     // by interrupt.
     request_handle_->CancelRequest();
+    CancelParallelRequests();
   }
 
   // Remove the intermediate file if we are cancelling an interrupted download.
@@ -965,6 +991,38 @@ void DownloadItemImpl::MergeOriginInfoOnResume(
   // notified when the download transitions to the IN_PROGRESS state.
 }
 
+bool DownloadItemImpl::HasPendingParallelRequests() const {
+  return pending_parallel_requests_ > 0;
+}
+
+void DownloadItemImpl::AddParallelStream(
+    int64 offset,
+    scoped_ptr<ByteStreamReader> stream,
+    scoped_ptr<DownloadRequestHandleInterface> req_handle) {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  DCHECK_GT(pending_parallel_requests_, 0);
+  --pending_parallel_requests_;
+
+  // An |offset| of 0 means that the server sent the whole file instead of the
+  // range.
+  if (state_ != IN_PROGRESS_INTERNAL || !download_file_ || all_data_saved_ ||
+      offset == 0) {
+    req_handle->CancelRequest();
+    return;
+  }
+
+  if (is_paused_)
+    req_handle->PauseRequest();
+  parallel_request_handles_.push_back(req_handle.release());
+
+  BrowserThread::PostTask(
+      BrowserThread::FILE, FROM_HERE,
+      base::Bind(&DownloadFile::AddByteStream,
+                 // Safe because we control download file lifetime.
+                 base::Unretained(download_file_.get()),
+                 base::Passed(&stream), offset));
+}
+
 void DownloadItemImpl::NotifyRemoved() {
   FOR_EACH_OBSERVER(Observer, observers_, OnDownloadRemoved(this));
 }
@@ -1062,6 +1120,12 @@ void DownloadItemImpl::DestinationCompleted(const std::string& final_hash) {
   VLOG(20) << __FUNCTION__ << " download=" << DebugString(true);
   if (GetState() != IN_PROGRESS)
     return;
+  if (!parallel_request_handles_.empty()) {
+    // The initial request is still stalled on the data the parallel ones
+    // wrote.
+    request_handle_->CancelRequest();
+    CancelParallelRequests();
+  }
   OnAllDataSaved(final_hash);
   MaybeCompleteDownload();
 }
@@ -1150,6 +1214,8 @@ void DownloadItemImpl::OnDownloadFileInitialized(
     return;
   }
 
+  MaybeStartParallelRequests();
+
   delegate_->DetermineDownloadTarget(
       this, base::Bind(&DownloadItemImpl::OnDownloadTargetDetermined,
                        weak_ptr_factory_.GetWeakPtr()));
@@ -1419,6 +1485,52 @@ void DownloadItemImpl::OnResumeRequestStarted(
   Interrupt(interrupt_reason);
 }
 
+void DownloadItemImpl::MaybeStartParallelRequests() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
+  if (!IsParallelDownloadingEnabled() || !accepts_ranges_ ||
+      total_bytes_ < kMinParallelDownloadBytes) {
+    return;
+  }
+
+  // The range requests must not get parts of a different version of the
+  // file.
+  if (etag_.empty() && last_modified_time_.empty())
+    return;
+
+  if (!GetWebContents())
+    return;
+
+  // Each request gets the file from its offset on; the DownloadFile stops
+  // writing each response where the next one starts.
+  for (int i = 1; i < kParallelRequestCount; ++i) {
+    scoped_ptr<DownloadUrlParameters> download_params(
+        DownloadUrlParameters::FromWebContents(GetWebContents(), GetURL()));
+    download_params->set_offset(total_bytes_ * i / kParallelRequestCount);
+    download_params->set_last_modified(GetLastModifiedTime());
+    download_params->set_etag(GetETag());
+    download_params->set_callback(
+        base::Bind(&DownloadItemImpl::OnParallelRequestStarted,
+                   weak_ptr_factory_.GetWeakPtr()));
+    ++pending_parallel_requests_;
+    delegate_->StartParallelRequest(download_params.Pass(), GetId());
+  }
+}
+
+void DownloadItemImpl::OnParallelRequestStarted(
+    DownloadItem* item,
+    DownloadInterruptReason interrupt_reason) {
+  // If |item| is not NULL, then AddParallelStream() has been called already.
+  // Otherwise the request failed, which the initial request makes up for.
+  if (!item)
+    --pending_parallel_requests_;
+}
+
+void DownloadItemImpl::CancelParallelRequests() {
+  for (size_t i = 0; i < parallel_request_handles_.size(); ++i)
+    parallel_request_handles_[i]->CancelRequest();
+  parallel_request_handles_.clear();
+}
+
 // **** End of Download progression cascade
 
 // An error occurred somewhere.
@@ -1452,6 +1564,7 @@ void DownloadItemImpl::Interrupt(DownloadInterruptReason reason) {
 
     // Cancel the originating URL request.
     request_handle_->CancelRequest();
+    CancelParallelRequests();
   } else {
     DCHECK(!download_file_.get());
   }
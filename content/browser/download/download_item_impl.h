@@ -11,6 +11,7 @@
 #include "base/callback_forward.h"
 #include "base/files/file_path.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
 #include "base/time/time.h"
@@ -25,6 +26,7 @@
 #include "url/gurl.h"
 
 namespace content {
+class ByteStreamReader;
 class DownloadFile;
 class DownloadItemImplDelegate;
 
@@ -168,6 +170,17 @@ class CONTENT_EXPORT DownloadItemImpl
   virtual void MergeOriginInfoOnResume(
       const DownloadCreateInfo& new_create_info);
 
+  // True while parallel range requests started by this download have not
+  // responded yet. Their responses are passed to AddParallelStream().
+  virtual bool HasPendingParallelRequests() const;
+
+  // Adds |stream|, the response to a parallel range request for the file
+  // from |offset| on, to the download.
+  virtual void AddParallelStream(
+      int64 offset,
+      scoped_ptr<ByteStreamReader> stream,
+      scoped_ptr<DownloadRequestHandleInterface> req_handle);
+
   // State transition operations on regular downloads --------------------------
 
   // Start the download.
@@ -343,6 +356,17 @@ class CONTENT_EXPORT DownloadItemImpl
   void OnResumeRequestStarted(DownloadItem* item,
                               DownloadInterruptReason interrupt_reason);
 
+  // If enabled and the server supports it, requests the later parts of a
+  // large file in parallel with the initial request.
+  void MaybeStartParallelRequests();
+
+  // Callback invoked when a parallel range request has started.
+  void OnParallelRequestStarted(DownloadItem* item,
+                                DownloadInterruptReason interrupt_reason);
+
+  // Cancels the parallel range requests that have responded.
+  void CancelParallelRequests();
+
   // Helper routines -----------------------------------------------------------
 
   // Indicate that an error has occurred on the download.
@@ -391,6 +415,9 @@ class CONTENT_EXPORT DownloadItemImpl
   // download system.
   scoped_ptr<DownloadRequestHandleInterface> request_handle_;
 
+  // The handles to the parallel range requests.
+  ScopedVector<DownloadRequestHandleInterface> parallel_request_handles_;
+
   uint32 download_id_;
 
   // Display name for the download. If this is empty, then the display name is
@@ -472,6 +499,12 @@ class CONTENT_EXPORT DownloadItemImpl
   // Server's ETAG for the file.
   std::string etag_;
 
+  // True if the server serves byte ranges of the file.
+  bool accepts_ranges_;
+
+  // Number of parallel range requests that have not responded yet.
+  int pending_parallel_requests_;
+
   // Last reason.
   DownloadInterruptReason last_reason_;
 
@@ -59,6 +59,9 @@ void DownloadItemImplDelegate::CheckForFileRemoval(
 void DownloadItemImplDelegate::ResumeInterruptedDownload(
     scoped_ptr<DownloadUrlParameters> params, uint32 id) {}
 
+void DownloadItemImplDelegate::StartParallelRequest(
+    scoped_ptr<DownloadUrlParameters> params, uint32 id) {}
+
 BrowserContext* DownloadItemImplDelegate::GetBrowserContext() const {
   return NULL;
 }
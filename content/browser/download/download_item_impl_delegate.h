@@ -71,6 +71,12 @@ class CONTENT_EXPORT DownloadItemImplDelegate {
       scoped_ptr<content::DownloadUrlParameters> params,
       uint32 id);
 
+  // Called to request part of the file of an in-progress download. The
+  // response is passed to the download item with id |id|.
+  virtual void StartParallelRequest(
+      scoped_ptr<content::DownloadUrlParameters> params,
+      uint32 id);
+
   // For contextual issues like language and prefs.
   virtual BrowserContext* GetBrowserContext() const;
 
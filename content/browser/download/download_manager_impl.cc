@@ -397,6 +397,16 @@ void DownloadManagerImpl::StartDownloadWithId(
       return;
     }
     download = item_iterator->second;
+    if (download->HasPendingParallelRequests()) {
+      // The response to a range request for part of an in-progress download.
+      download->AddParallelStream(
+          info->save_info->offset, stream.Pass(),
+          scoped_ptr<DownloadRequestHandleInterface>(
+              new DownloadRequestHandle(info->request_handle)));
+      if (!on_started.is_null())
+        on_started.Run(download, DOWNLOAD_INTERRUPT_REASON_NONE);
+      return;
+    }
     DCHECK_EQ(DownloadItem::INTERRUPTED, download->GetState());
     download->MergeOriginInfoOnResume(*info);
   }
@@ -537,6 +547,15 @@ void DownloadManagerImpl::ResumeInterruptedDownload(
       base::Bind(&BeginDownload, base::Passed(&params), id));
 }
 
+void DownloadManagerImpl::StartParallelRequest(
+    scoped_ptr<content::DownloadUrlParameters> params,
+    uint32 id) {
+  BrowserThread::PostTask(
+      BrowserThread::IO,
+      FROM_HERE,
+      base::Bind(&BeginDownload, base::Passed(&params), id));
+}
+
 void DownloadManagerImpl::SetDownloadItemFactoryForTesting(
     scoped_ptr<DownloadItemFactory> item_factory) {
   item_factory_ = item_factory.Pass();
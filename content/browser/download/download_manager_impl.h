@@ -154,6 +154,9 @@ class CONTENT_EXPORT DownloadManagerImpl : public DownloadManager,
   virtual void ResumeInterruptedDownload(
       scoped_ptr<content::DownloadUrlParameters> params,
       uint32 id) OVERRIDE;
+  virtual void StartParallelRequest(
+      scoped_ptr<content::DownloadUrlParameters> params,
+      uint32 id) OVERRIDE;
   virtual void OpenDownload(DownloadItemImpl* download) OVERRIDE;
   virtual void ShowDownloadInShell(DownloadItemImpl* download) OVERRIDE;
   virtual void DownloadRemoved(DownloadItemImpl* download) OVERRIDE;
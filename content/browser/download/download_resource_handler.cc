@@ -177,6 +177,7 @@ bool DownloadResourceHandler::OnResponseStarted(
       if (!headers->EnumerateHeader(NULL, "ETag", &info->etag))
         info->etag.clear();
     }
+    info->accepts_ranges = headers->HasHeaderValue("Accept-Ranges", "bytes");
 
     int status = headers->response_code();
     if (2 == status / 100  && status != net::HTTP_PARTIAL_CONTENT) {
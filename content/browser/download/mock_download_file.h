@@ -10,6 +10,7 @@
 
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
+#include "content/browser/byte_stream.h"
 #include "content/browser/download/download_file.h"
 #include "content/public/browser/download_manager.h"
 #include "testing/gmock/include/gmock/gmock.h"
@@ -49,6 +50,13 @@ class MockDownloadFile : virtual public DownloadFile {
   MOCK_METHOD0(GetDownloadManager, DownloadManager*());
   MOCK_CONST_METHOD0(DebugString, std::string());
   MOCK_METHOD1(SetClientGuid, void(const std::string&));
+
+  // gmock does not handle move-only arguments.
+  virtual void AddByteStream(scoped_ptr<ByteStreamReader> stream,
+                             int64 offset) OVERRIDE {
+    DoAddByteStream(stream.get(), offset);
+  }
+  MOCK_METHOD2(DoAddByteStream, void(ByteStreamReader*, int64));
 };
 
 }  // namespace content
@@ -77,11 +77,12 @@ class CONTENT_EXPORT IndexedDBCallbacks
                          const IndexedDBKey& primary_key,
                          std::string* value);
 
-  // IndexedDBCursor::PrefetchContinue
+  // IndexedDBCursor::PrefetchContinue.  |values| is swapped into the
+  // outgoing message rather than copied.
   virtual void OnSuccessWithPrefetch(
       const std::vector<IndexedDBKey>& keys,
       const std::vector<IndexedDBKey>& primary_keys,
-      const std::vector<std::string>& values);
+      std::vector<std::string>* values);
 
   // IndexedDBDatabase::Get (with key injection)
   virtual void OnSuccess(std::string* data,
@@ -48,6 +48,12 @@ static const base::FilePath::CharType kIndexedDBExtension[] =
 static const base::FilePath::CharType kLevelDBExtension[] =
     FILE_PATH_LITERAL(".leveldb");
 
+// Usage scans after committed transactions are rate limited to one per
+// interval, unless the origin is close enough to its quota that an exact
+// figure matters.
+static const int kMinUsageScanIntervalMilliseconds = 1000;
+static const int64 kNearQuotaBytes = 10 * 1024 * 1024;
+
 namespace {
 
 // This may be called after the IndexedDBContext is destroyed.
@@ -289,6 +295,8 @@ int64 IndexedDBContextImpl::GetOriginDiskUsage(const GURL& origin_url) {
   DCHECK(TaskRunner()->RunsTasksOnCurrentThread());
   if (data_path_.empty() || !IsInOriginSet(origin_url))
     return 0;
+  if (pending_usage_updates_.count(origin_url))
+    QueryDiskAndUpdateQuotaUsage(origin_url);
   EnsureDiskUsageCacheInitialized(origin_url);
   return origin_size_map_[origin_url];
 }
@@ -329,6 +337,7 @@ void IndexedDBContextImpl::DeleteForOrigin(const GURL& origin_url) {
     RemoveFromOriginSet(origin_url);
     origin_size_map_.erase(origin_url);
     space_available_map_.erase(origin_url);
+    usage_scan_times_.erase(origin_url);
   }
 }
 
@@ -402,6 +411,27 @@ void IndexedDBContextImpl::ConnectionClosed(const GURL& origin_url,
 
 void IndexedDBContextImpl::TransactionComplete(const GURL& origin_url) {
   DCHECK(!factory_ || factory_->GetConnectionCount(origin_url) > 0);
+  OriginToSizeMap::const_iterator space = space_available_map_.find(origin_url);
+  if (space != space_available_map_.end() && space->second < kNearQuotaBytes) {
+    QueryDiskAndUpdateQuotaUsage(origin_url);
+    QueryAvailableQuota(origin_url);
+    return;
+  }
+
+  // Walking the origin's directory after every commit is expensive for
+  // pages that issue many small transactions. Within a burst of commits,
+  // only remember that the usage is stale; the next scan accounts for the
+  // whole burst. That scan happens on a later commit, when the last
+  // connection closes, or when the quota client asks for the usage.
+  std::map<GURL, base::TimeTicks>::const_iterator last_scan =
+      usage_scan_times_.find(origin_url);
+  if (last_scan != usage_scan_times_.end() &&
+      base::TimeTicks::Now() - last_scan->second <
+          base::TimeDelta::FromMilliseconds(
+              kMinUsageScanIntervalMilliseconds)) {
+    pending_usage_updates_.insert(origin_url);
+    return;
+  }
   QueryDiskAndUpdateQuotaUsage(origin_url);
   QueryAvailableQuota(origin_url);
 }
@@ -480,6 +510,8 @@ void IndexedDBContextImpl::EnsureDiskUsageCacheInitialized(
 
 void IndexedDBContextImpl::QueryDiskAndUpdateQuotaUsage(
     const GURL& origin_url) {
+  pending_usage_updates_.erase(origin_url);
+  usage_scan_times_[origin_url] = base::TimeTicks::Now();
   int64 former_disk_usage = origin_size_map_[origin_url];
   int64 current_disk_usage = ReadUsageFromDisk(origin_url);
   int64 difference = current_disk_usage - former_disk_usage;
@@ -561,6 +593,8 @@ void IndexedDBContextImpl::ResetCaches() {
   origin_set_.reset();
   origin_size_map_.clear();
   space_available_map_.clear();
+  pending_usage_updates_.clear();
+  usage_scan_times_.clear();
 }
 
 base::TaskRunner* IndexedDBContextImpl::TaskRunner() const {
@@ -13,6 +13,7 @@
 #include "base/files/file_path.h"
 #include "base/gtest_prod_util.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
 #include "content/browser/browser_main_loop.h"
 #include "content/browser/indexed_db/indexed_db_factory.h"
 #include "content/public/browser/indexed_db_context.h"
@@ -137,6 +138,10 @@ class CONTENT_EXPORT IndexedDBContextImpl
   scoped_ptr<std::set<GURL> > origin_set_;
   OriginToSizeMap origin_size_map_;
   OriginToSizeMap space_available_map_;
+  // Origins with committed changes that are not yet reflected in
+  // |origin_size_map_|, and when each origin's usage was last read from disk.
+  std::set<GURL> pending_usage_updates_;
+  std::map<GURL, base::TimeTicks> usage_scan_times_;
 
   DISALLOW_COPY_AND_ASSIGN(IndexedDBContextImpl);
 };
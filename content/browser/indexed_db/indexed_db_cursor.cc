@@ -4,6 +4,8 @@
 
 #include "content/browser/indexed_db/indexed_db_cursor.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/logging.h"
 #include "content/browser/indexed_db/indexed_db_callbacks.h"
@@ -108,6 +110,13 @@ void IndexedDBCursor::CursorPrefetchIterationOperation(
   std::vector<IndexedDBKey> found_primary_keys;
   std::vector<std::string> found_values;
 
+  // |number_to_fetch| comes from the renderer; bound the reservation.
+  const int kMaxReserve = 1000;
+  const size_t reserve = std::max(0, std::min(number_to_fetch, kMaxReserve));
+  found_keys.reserve(reserve);
+  found_primary_keys.reserve(reserve);
+  found_values.reserve(reserve);
+
   saved_cursor_.reset();
   const size_t max_size_estimate = 10 * 1024 * 1024;
   size_t size_estimate = 0;
@@ -132,10 +141,10 @@ void IndexedDBCursor::CursorPrefetchIterationOperation(
         found_values.push_back(std::string());
         break;
       case indexed_db::CURSOR_KEY_AND_VALUE: {
-        std::string value;
-        value.swap(*cursor_->value());
-        size_estimate += value.size();
-        found_values.push_back(value);
+        // Swap rather than copy; values may be large.
+        found_values.push_back(std::string());
+        found_values.back().swap(*cursor_->value());
+        size_estimate += found_values.back().size();
         break;
       }
       default:
@@ -154,7 +163,7 @@ void IndexedDBCursor::CursorPrefetchIterationOperation(
   }
 
   callbacks->OnSuccessWithPrefetch(
-      found_keys, found_primary_keys, found_values);
+      found_keys, found_primary_keys, &found_values);
 }
 
 void IndexedDBCursor::PrefetchReset(int used_prefetches,
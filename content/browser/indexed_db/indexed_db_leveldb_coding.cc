@@ -4,6 +4,7 @@
 
 #include "content/browser/indexed_db/indexed_db_leveldb_coding.h"
 
+#include <algorithm>
 #include <iterator>
 #include <limits>
 
@@ -426,17 +427,16 @@ bool DecodeString(StringPiece* slice, base::string16* value) {
     return true;
   }
 
-  // Backing store is UTF-16BE, convert to host endianness.
+  // Backing store is UTF-16BE, convert to host endianness.  Decode
+  // straight into |value| to avoid a temporary string per key.
   DCHECK(!(slice->size() % sizeof(base::char16)));
   size_t length = slice->size() / sizeof(base::char16);
-  base::string16 decoded;
-  decoded.reserve(length);
+  value->resize(length);
   const base::char16* encoded =
       reinterpret_cast<const base::char16*>(slice->begin());
-  for (unsigned i = 0; i < length; ++i)
-    decoded.push_back(ntohs(*encoded++));
+  for (size_t i = 0; i < length; ++i)
+    (*value)[i] = ntohs(*encoded++);
 
-  *value = decoded;
   slice->remove_prefix(length * sizeof(base::char16));
   return true;
 }
@@ -493,6 +493,9 @@ bool DecodeIDBKey(StringPiece* slice, scoped_ptr<IndexedDBKey>* value) {
       if (!DecodeVarInt(slice, &length) || length < 0)
         return false;
       IndexedDBKey::KeyArray array;
+      // Each element takes at least one byte, which bounds |length|
+      // for corrupt data.
+      array.reserve(std::min(static_cast<size_t>(length), slice->size()));
       while (length--) {
         scoped_ptr<IndexedDBKey> key;
         if (!DecodeIDBKey(slice, &key))
@@ -20,6 +20,12 @@ namespace content {
 
 const int64 kInactivityTimeoutPeriodSeconds = 60;
 
+// All transactions of an origin share one task runner.  A transaction
+// which has run its tasks for this long yields, so that other started
+// transactions (e.g. read-only ones serving the UI while a large
+// read-write transaction is syncing) get a turn.
+const int64 kTaskQueueTimeSliceMilliseconds = 10;
+
 IndexedDBTransaction::TaskQueue::TaskQueue() {}
 IndexedDBTransaction::TaskQueue::~TaskQueue() { clear(); }
 
@@ -290,6 +296,9 @@ void IndexedDBTransaction::ProcessTaskQueue() {
   // the loop termination conditions can be checked.
   scoped_refptr<IndexedDBTransaction> protect(this);
 
+  const base::TimeTicks slice_end =
+      base::TimeTicks::Now() +
+      base::TimeDelta::FromMilliseconds(kTaskQueueTimeSliceMilliseconds);
   TaskQueue* task_queue =
       pending_preemptive_events_ ? &preemptive_task_queue_ : &task_queue_;
   while (!task_queue->empty() && state_ != FINISHED) {
@@ -304,6 +313,14 @@ void IndexedDBTransaction::ProcessTaskQueue() {
     // Event itself may change which queue should be processed next.
     task_queue =
         pending_preemptive_events_ ? &preemptive_task_queue_ : &task_queue_;
+
+    if (!task_queue->empty() && state_ != FINISHED &&
+        base::TimeTicks::Now() >= slice_end) {
+      should_process_queue_ = true;
+      base::MessageLoop::current()->PostTask(
+          FROM_HERE, base::Bind(&IndexedDBTransaction::ProcessTaskQueue, this));
+      return;
+    }
   }
 
   // If there are no pending tasks, we haven't already committed/aborted,
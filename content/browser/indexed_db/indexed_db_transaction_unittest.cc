@@ -4,10 +4,13 @@
 
 #include "content/browser/indexed_db/indexed_db_transaction.h"
 
+#include <vector>
+
 #include "base/bind.h"
 #include "base/logging.h"
 #include "base/message_loop/message_loop.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/platform_thread.h"
 #include "content/browser/indexed_db/indexed_db_fake_backing_store.h"
 #include "content/browser/indexed_db/mock_indexed_db_database_callbacks.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -120,6 +123,59 @@ TEST_F(IndexedDBTransactionTest, AbortTasks) {
   EXPECT_TRUE(observer.abort_task_called());
 }
 
+void RecordOperation(std::vector<int>* order,
+                     int id,
+                     base::TimeDelta duration,
+                     IndexedDBTransaction* transaction) {
+  if (duration > base::TimeDelta())
+    base::PlatformThread::Sleep(duration);
+  order->push_back(id);
+}
+
+// A transaction with a long-running task yields to other started
+// transactions before running its remaining tasks.
+TEST_F(IndexedDBTransactionTest, LongTaskQueueYields) {
+  const std::set<int64> scope;
+  const bool commit_success = true;
+  scoped_refptr<IndexedDBTransaction> long_running = new IndexedDBTransaction(
+      0,
+      new MockIndexedDBDatabaseCallbacks(),
+      scope,
+      indexed_db::TRANSACTION_READ_ONLY,
+      db_,
+      new IndexedDBFakeBackingStore::FakeTransaction(commit_success));
+  scoped_refptr<IndexedDBTransaction> other = new IndexedDBTransaction(
+      1,
+      new MockIndexedDBDatabaseCallbacks(),
+      scope,
+      indexed_db::TRANSACTION_READ_ONLY,
+      db_,
+      new IndexedDBFakeBackingStore::FakeTransaction(commit_success));
+  db_->TransactionCreated(long_running);
+  db_->TransactionCreated(other);
+  EXPECT_EQ(IndexedDBTransaction::STARTED, long_running->state());
+  EXPECT_EQ(IndexedDBTransaction::STARTED, other->state());
+
+  // Longer than the time slice.
+  const base::TimeDelta kLongTask = base::TimeDelta::FromMilliseconds(50);
+  std::vector<int> order;
+  long_running->ScheduleTask(
+      base::Bind(&RecordOperation, &order, 1, kLongTask));
+  long_running->ScheduleTask(
+      base::Bind(&RecordOperation, &order, 3, base::TimeDelta()));
+  other->ScheduleTask(
+      base::Bind(&RecordOperation, &order, 2, base::TimeDelta()));
+
+  RunPostedTasks();
+  ASSERT_EQ(3u, order.size());
+  EXPECT_EQ(1, order[0]);
+  EXPECT_EQ(2, order[1]);
+  EXPECT_EQ(3, order[2]);
+
+  long_running->Abort();
+  other->Abort();
+}
+
 }  // namespace
 
 }  // namespace content
@@ -4,10 +4,12 @@
 
 #include "content/browser/indexed_db/leveldb/leveldb_database.h"
 
+#include <algorithm>
 #include <cerrno>
 
 #include "base/basictypes.h"
 #include "base/files/file.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/metrics/histogram.h"
@@ -22,6 +24,7 @@
 #include "third_party/leveldatabase/env_chromium.h"
 #include "third_party/leveldatabase/env_idb.h"
 #include "third_party/leveldatabase/src/helpers/memenv/memenv.h"
+#include "third_party/leveldatabase/src/include/leveldb/cache.h"
 #include "third_party/leveldatabase/src/include/leveldb/comparator.h"
 #include "third_party/leveldatabase/src/include/leveldb/db.h"
 #include "third_party/leveldatabase/src/include/leveldb/env.h"
@@ -91,6 +94,29 @@ LevelDBDatabase::~LevelDBDatabase() {
   env_.reset();
 }
 
+// All databases share one block cache, sized from physical memory, so
+// that an origin with many databases cannot pin 8MB (leveldb's default
+// per-database cache) for each of them, while a single large database
+// on a well-provisioned machine gets more than that.
+// No FilterPolicy is set: bloom filters hash raw key bytes, and
+// LevelDBComparator can consider keys with different encodings equal.
+static size_t BlockCacheBytes() {
+  const int64 kMinBytes = 8 * 1024 * 1024;
+  const int64 kMaxBytes = 32 * 1024 * 1024;
+  int64 bytes = base::SysInfo::AmountOfPhysicalMemory() / 512;
+  return static_cast<size_t>(std::max(kMinBytes, std::min(bytes, kMaxBytes)));
+}
+
+namespace {
+struct SharedBlockCache {
+  SharedBlockCache() : cache(leveldb::NewLRUCache(BlockCacheBytes())) {}
+  scoped_ptr<leveldb::Cache> cache;
+};
+
+base::LazyInstance<SharedBlockCache>::Leaky g_block_cache =
+    LAZY_INSTANCE_INITIALIZER;
+}  // namespace
+
 static leveldb::Status OpenDB(leveldb::Comparator* comparator,
                               leveldb::Env* env,
                               const base::FilePath& path,
@@ -105,6 +131,7 @@ static leveldb::Status OpenDB(leveldb::Comparator* comparator,
   // https://code.google.com/p/chromium/issues/detail?id=227313#c11
   options.max_open_files = 80;
   options.env = env;
+  options.block_cache = g_block_cache.Get().cache.get();
 
   // ChromiumEnv assumes UTF8, converts back to FilePath before using.
   return leveldb::DB::Open(options, path.AsUTF8Unsafe(), db);
@@ -40,6 +40,18 @@ static int kBufferSize = 1024 * 512;
 static int kMinAllocationSize = 1024 * 4;
 static int kMaxAllocationSize = 1024 * 32;
 
+// Responses larger than the buffer are read in allocations this many times
+// larger, so that they take fewer DataReceived messages.
+const int kLargeResponseAllocationMultiplier = 4;
+
+// The renderer acknowledges data once half of the buffer is waiting to be
+// recycled, so a buffer must be big enough that the other half plus rounding
+// still leaves room to allocate.
+const int kMinBufferSizeInAllocations = 8;
+
+// Responses smaller than this do not say much about IPCs per megabyte.
+const int64 kMinBytesForDataMessageMetrics = 64 * 1024;
+
 void GetNumericArg(const std::string& name, int* result) {
   const std::string& value =
       CommandLine::ForCurrentProcess()->GetSwitchValueASCII(name);
@@ -88,7 +100,10 @@ AsyncResourceHandler::AsyncResourceHandler(
       has_checked_for_sufficient_resources_(false),
       sent_received_response_msg_(false),
       sent_first_data_msg_(false),
-      reported_transfer_size_(0) {
+      reported_transfer_size_(0),
+      total_read_bytes_(0),
+      num_data_messages_(0),
+      num_data_acks_(0) {
   InitializeResourceBufferConstants();
 }
 
@@ -123,14 +138,18 @@ void AsyncResourceHandler::OnFollowRedirect(
   ResumeIfDeferred();
 }
 
-void AsyncResourceHandler::OnDataReceivedACK(int request_id) {
-  if (pending_data_count_) {
-    --pending_data_count_;
+void AsyncResourceHandler::OnDataReceivedACK(int request_id,
+                                             int num_data_messages) {
+  if (!pending_data_count_)
+    return;
+  ++num_data_acks_;
 
+  for (; num_data_messages > 0 && pending_data_count_; --num_data_messages) {
+    --pending_data_count_;
     buffer_->RecycleLeastRecentlyAllocated();
-    if (buffer_->CanAllocate())
-      ResumeIfDeferred();
   }
+  if (buffer_->CanAllocate())
+    ResumeIfDeferred();
 }
 
 bool AsyncResourceHandler::OnUploadProgress(int request_id,
@@ -290,6 +309,8 @@ bool AsyncResourceHandler::OnReadCompleted(int request_id, int bytes_read,
   filter->Send(new ResourceMsg_DataReceived(
       request_id, data_offset, bytes_read, encoded_data_length));
   ++pending_data_count_;
+  ++num_data_messages_;
+  total_read_bytes_ += bytes_read;
   UMA_HISTOGRAM_CUSTOM_COUNTS(
       "Net.AsyncResourceHandler_PendingDataCount",
       pending_data_count_, 0, 100, 100);
@@ -341,6 +362,18 @@ void AsyncResourceHandler::OnResponseCompleted(
   CHECK(status.status() != net::URLRequestStatus::SUCCESS ||
         sent_received_response_msg_);
 
+  if (total_read_bytes_ >= kMinBytesForDataMessageMetrics) {
+    // The body goes from the network straight into shared memory, so these
+    // messages are the only per-chunk cost between the processes.
+    double megabytes = static_cast<double>(total_read_bytes_) / (1024 * 1024);
+    UMA_HISTOGRAM_COUNTS_10000(
+        "Net.AsyncResourceHandler_DataMessagesPerMB",
+        static_cast<int>(num_data_messages_ / megabytes + 0.5));
+    UMA_HISTOGRAM_COUNTS_10000(
+        "Net.AsyncResourceHandler_DataACKsPerMB",
+        static_cast<int>(num_data_acks_ / megabytes + 0.5));
+  }
+
   int error_code = status.error();
   bool was_ignored_by_handler = info->WasIgnoredByHandler();
 
@@ -384,10 +417,32 @@ bool AsyncResourceHandler::EnsureResourceBufferIsInitialized() {
     }
   }
 
+  // The response has started, so the body size is known if the server sent
+  // it. Small bodies get a buffer of their own size rather than the full one,
+  // and large ones are read in bigger chunks.
+  int buffer_size = kBufferSize;
+  int max_allocation_size = kMaxAllocationSize;
+  int64 expected_size = request()->GetExpectedContentSize();
+  int min_buffer_size = kMinBufferSizeInAllocations * kMinAllocationSize;
+  if (expected_size > kBufferSize) {
+    // Keep at least four allocations' worth of room in the buffer.
+    max_allocation_size = std::min(
+        kMaxAllocationSize * kLargeResponseAllocationMultiplier,
+        kBufferSize / 4);
+    max_allocation_size -= max_allocation_size % kMinAllocationSize;
+    max_allocation_size = std::max(max_allocation_size, kMaxAllocationSize);
+  } else if (expected_size >= 0 && expected_size < kBufferSize &&
+             min_buffer_size < kBufferSize) {
+    int rounded_size = static_cast<int>(expected_size) + kMinAllocationSize -
+        static_cast<int>(expected_size % kMinAllocationSize);
+    buffer_size = std::min(kBufferSize, std::max(min_buffer_size,
+                                                 rounded_size));
+  }
+
   buffer_ = new ResourceBuffer();
-  return buffer_->Initialize(kBufferSize,
+  return buffer_->Initialize(buffer_size,
                              kMinAllocationSize,
-                             kMaxAllocationSize);
+                             max_allocation_size);
 }
 
 void AsyncResourceHandler::ResumeIfDeferred() {
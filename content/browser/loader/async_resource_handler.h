@@ -71,7 +71,7 @@ class AsyncResourceHandler : public ResourceHandler,
   void OnFollowRedirect(int request_id,
                         bool has_new_first_party_for_cookies,
                         const GURL& new_first_party_for_cookies);
-  void OnDataReceivedACK(int request_id);
+  void OnDataReceivedACK(int request_id, int num_data_messages);
 
   bool EnsureResourceBufferIsInitialized();
   void ResumeIfDeferred();
@@ -94,6 +94,11 @@ class AsyncResourceHandler : public ResourceHandler,
 
   int64_t reported_transfer_size_;
 
+  // For the IPC metrics recorded when the response completes.
+  int64 total_read_bytes_;
+  int num_data_messages_;
+  int num_data_acks_;
+
   DISALLOW_COPY_AND_ASSIGN(AsyncResourceHandler);
 };
 
@@ -0,0 +1,226 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/loader/preload_scanner.h"
+
+#include <vector>
+
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+
+namespace content {
+
+namespace {
+
+// Tags longer than this are dropped rather than buffered without bound.
+const size_t kMaxTagLength = 4096;
+
+bool IsTagWhitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+// Reads the next attribute of |tag| starting at |*pos|. Returns false when
+// there are no more.
+bool NextAttribute(const std::string& tag,
+                   size_t* pos,
+                   std::string* name,
+                   std::string* value) {
+  size_t i = *pos;
+  while (i < tag.size() && (IsTagWhitespace(tag[i]) || tag[i] == '/'))
+    ++i;
+  if (i == tag.size())
+    return false;
+
+  size_t name_start = i;
+  while (i < tag.size() && !IsTagWhitespace(tag[i]) && tag[i] != '=' &&
+         tag[i] != '/') {
+    ++i;
+  }
+  *name = StringToLowerASCII(tag.substr(name_start, i - name_start));
+  value->clear();
+
+  while (i < tag.size() && IsTagWhitespace(tag[i]))
+    ++i;
+  if (i < tag.size() && tag[i] == '=') {
+    ++i;
+    while (i < tag.size() && IsTagWhitespace(tag[i]))
+      ++i;
+    if (i < tag.size() && (tag[i] == '"' || tag[i] == '\'')) {
+      size_t end = tag.find(tag[i], i + 1);
+      if (end == std::string::npos)
+        end = tag.size();
+      *value = tag.substr(i + 1, end - i - 1);
+      i = end == tag.size() ? end : end + 1;
+    } else {
+      size_t value_start = i;
+      while (i < tag.size() && !IsTagWhitespace(tag[i]))
+        ++i;
+      *value = tag.substr(value_start, i - value_start);
+    }
+  }
+  *pos = i;
+  return true;
+}
+
+// Returns true if |tag| ends in '=' and optional whitespace, so that a quote
+// would start an attribute value.
+bool FollowsEquals(const std::string& tag) {
+  size_t i = tag.size();
+  while (i > 0 && IsTagWhitespace(tag[i - 1]))
+    --i;
+  return i > 0 && tag[i - 1] == '=';
+}
+
+bool HasStylesheetRel(const std::string& rel) {
+  std::vector<std::string> tokens;
+  base::SplitStringAlongWhitespace(rel, &tokens);
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    if (LowerCaseEqualsASCII(tokens[i], "stylesheet"))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+PreloadScanner::PreloadScanner(const GURL& document_url)
+    : state_(STATE_TEXT),
+      quote_(0),
+      match_length_(0),
+      base_url_(document_url),
+      has_base_element_(false) {
+}
+
+PreloadScanner::~PreloadScanner() {
+}
+
+void PreloadScanner::Scan(const char* data,
+                          size_t length,
+                          std::vector<GURL>* urls) {
+  for (size_t i = 0; i < length; ++i) {
+    char c = data[i];
+    switch (state_) {
+      case STATE_TEXT:
+        if (c == '<') {
+          state_ = STATE_TAG;
+          tag_.clear();
+          quote_ = 0;
+        }
+        break;
+
+      case STATE_TAG:
+        if (quote_) {
+          if (c == quote_)
+            quote_ = 0;
+        } else if (c == '>') {
+          ProcessTag(urls);
+          break;
+        } else if ((c == '"' || c == '\'') && FollowsEquals(tag_)) {
+          quote_ = c;
+        }
+        tag_.push_back(c);
+        if (tag_ == "!--") {
+          state_ = STATE_COMMENT;
+          match_length_ = 0;
+        } else if (tag_.size() > kMaxTagLength) {
+          state_ = STATE_TEXT;
+        }
+        break;
+
+      case STATE_COMMENT:
+        // |match_length_| counts the dashes before a possible "-->".
+        if (c == '-') {
+          ++match_length_;
+        } else {
+          if (c == '>' && match_length_ >= 2)
+            state_ = STATE_TEXT;
+          match_length_ = 0;
+        }
+        break;
+
+      case STATE_RAW_TEXT: {
+        c = base::ToLowerASCII(c);
+        if (c == tag_[match_length_]) {
+          if (++match_length_ == tag_.size()) {
+            // The end tag takes the place of the '<' that starts a tag.
+            state_ = STATE_TAG;
+            tag_ = tag_.substr(1);
+            quote_ = 0;
+          }
+        } else {
+          match_length_ = c == tag_[0] ? 1 : 0;
+        }
+        break;
+      }
+    }
+  }
+}
+
+void PreloadScanner::ProcessTag(std::vector<GURL>* urls) {
+  state_ = STATE_TEXT;
+
+  size_t pos = 0;
+  while (pos < tag_.size() && !IsTagWhitespace(tag_[pos]) &&
+         (tag_[pos] != '/' || pos == 0)) {
+    ++pos;
+  }
+  std::string name = StringToLowerASCII(tag_.substr(0, pos));
+  if (name.empty() || name[0] == '/' || name[0] == '!' || name[0] == '?')
+    return;
+
+  std::string src;
+  std::string href;
+  std::string rel;
+  std::string attribute_name;
+  std::string attribute_value;
+  while (NextAttribute(tag_, &pos, &attribute_name, &attribute_value)) {
+    if (attribute_name == "src")
+      src = attribute_value;
+    else if (attribute_name == "href")
+      href = attribute_value;
+    else if (attribute_name == "rel")
+      rel = attribute_value;
+  }
+
+  if (name == "script") {
+    AddURL(src, urls);
+    // Raw text and escapable raw text elements cannot contain tags.
+    state_ = STATE_RAW_TEXT;
+    tag_ = "</script";
+    match_length_ = 0;
+  } else if (name == "style" || name == "textarea" || name == "title") {
+    state_ = STATE_RAW_TEXT;
+    tag_ = "</" + name;
+    match_length_ = 0;
+  } else if (name == "img") {
+    AddURL(src, urls);
+  } else if (name == "link") {
+    if (HasStylesheetRel(rel))
+      AddURL(href, urls);
+  } else if (name == "base") {
+    // Only the first <base> counts, and only for URLs after it.
+    if (!has_base_element_ && !href.empty()) {
+      has_base_element_ = true;
+      GURL base_url = base_url_.Resolve(href);
+      if (base_url.is_valid())
+        base_url_ = base_url;
+    }
+  }
+}
+
+void PreloadScanner::AddURL(const std::string& value,
+                            std::vector<GURL>* urls) {
+  std::string trimmed;
+  TrimWhitespaceASCII(value, TRIM_ALL, &trimmed);
+  if (trimmed.empty())
+    return;
+  // Query strings commonly have their ampersands escaped.
+  ReplaceSubstringsAfterOffset(&trimmed, 0, "&amp;", "&");
+
+  GURL url = base_url_.Resolve(trimmed);
+  if (url.is_valid() && url.SchemeIsHTTPOrHTTPS())
+    urls->push_back(url);
+}
+
+}  // namespace content
@@ -0,0 +1,63 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_LOADER_PRELOAD_SCANNER_H_
+#define CONTENT_BROWSER_LOADER_PRELOAD_SCANNER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "content/common/content_export.h"
+#include "url/gurl.h"
+
+namespace content {
+
+// Finds the external scripts, stylesheets and images an HTML document refers
+// to, so that they can be requested before the renderer parses the document.
+// The document is fed in as it arrives; tags split between chunks are found.
+//
+// This is a much simpler tokenizer than the renderer's, and may miss URLs,
+// such as those written by scripts, but never reads URLs out of comments or
+// out of the contents of <script> and <style> elements.
+class CONTENT_EXPORT PreloadScanner {
+ public:
+  explicit PreloadScanner(const GURL& document_url);
+  ~PreloadScanner();
+
+  // Scans the next |length| bytes of the document, and appends the HTTP(S)
+  // URLs found in them to |urls|.
+  void Scan(const char* data, size_t length, std::vector<GURL>* urls);
+
+ private:
+  enum State {
+    STATE_TEXT,
+    STATE_TAG,
+    STATE_COMMENT,
+    STATE_RAW_TEXT,
+  };
+
+  // Handles the tag in |tag_|, which holds the text between '<' and '>'.
+  void ProcessTag(std::vector<GURL>* urls);
+
+  void AddURL(const std::string& value, std::vector<GURL>* urls);
+
+  State state_;
+  // The text of the tag being read, or in STATE_RAW_TEXT, the end tag being
+  // looked for.
+  std::string tag_;
+  // The quote character of the attribute value being read, or 0.
+  char quote_;
+  // How much of the end of a comment or of |tag_| has been matched.
+  size_t match_length_;
+
+  GURL base_url_;
+  bool has_base_element_;
+
+  DISALLOW_COPY_AND_ASSIGN(PreloadScanner);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_LOADER_PRELOAD_SCANNER_H_
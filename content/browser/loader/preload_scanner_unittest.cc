@@ -0,0 +1,95 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/loader/preload_scanner.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+
+namespace {
+
+const char kDocumentURL[] = "http://example.com/dir/page.html";
+
+// Scans |html| in chunks of |chunk_size| bytes and returns the URLs found,
+// separated by spaces.
+std::string ScanInChunks(const std::string& html, size_t chunk_size) {
+  PreloadScanner scanner((GURL(kDocumentURL)));
+  std::vector<GURL> urls;
+  for (size_t i = 0; i < html.size(); i += chunk_size) {
+    scanner.Scan(html.data() + i, std::min(chunk_size, html.size() - i),
+                 &urls);
+  }
+  std::string result;
+  for (size_t i = 0; i < urls.size(); ++i) {
+    if (i)
+      result += " ";
+    result += urls[i].spec();
+  }
+  return result;
+}
+
+std::string Scan(const std::string& html) {
+  return ScanInChunks(html, html.size());
+}
+
+TEST(PreloadScannerTest, FindsSubresources) {
+  EXPECT_EQ("http://example.com/dir/a.js http://example.com/b.css "
+            "http://other.com/c.png",
+            Scan("<html><head><script src=\"a.js\"></script>"
+                 "<link rel='stylesheet' href=/b.css>"
+                 "</head><body><IMG SRC=\"http://other.com/c.png\" alt=x>"
+                 "</body></html>"));
+}
+
+TEST(PreloadScannerTest, IgnoresOtherLinksAndSchemes) {
+  EXPECT_EQ("",
+            Scan("<link rel=icon href=favicon.ico><a href=next.html>"
+                 "<img src=\"data:image/png;base64,AAAA\"><script></script>"
+                 "<img src=\"javascript:void(0)\">"));
+  EXPECT_EQ("http://example.com/dir/s.css",
+            Scan("<link rel=\"alternate stylesheet\" href=s.css>"));
+}
+
+TEST(PreloadScannerTest, SkipsCommentsAndRawText) {
+  EXPECT_EQ("http://example.com/dir/after.js",
+            Scan("<!-- <script src=comment.js></script> -->"
+                 "<script>document.write('<img src=\"written.png\">');"
+                 "</SCRIPT >"
+                 "<style>/* <img src=style.png> */</style>"
+                 "<title><img src=title.png></title>"
+                 "<script src=after.js></script>"));
+}
+
+TEST(PreloadScannerTest, UsesBaseElement) {
+  EXPECT_EQ("http://example.com/dir/a.js http://cdn.com/static/b.js",
+            Scan("<script src=a.js></script>"
+                 "<base href=\"http://cdn.com/static/\">"
+                 "<base href=\"http://ignored.com/\">"
+                 "<script src=b.js></script>"));
+}
+
+TEST(PreloadScannerTest, UnescapesAmpersands) {
+  EXPECT_EQ("http://example.com/dir/a.js?x=1&y=2",
+            Scan("<script src=\" a.js?x=1&amp;y=2 \"></script>"));
+}
+
+TEST(PreloadScannerTest, TagsSplitAcrossChunks) {
+  std::string html =
+      "<!-- <img src=no.png> --><img alt=\"a > b\" src=\"a.png\">"
+      "<script>var s = '</scrip';</script><img src='b.png'>";
+  std::string expected =
+      "http://example.com/dir/a.png http://example.com/dir/b.png";
+  EXPECT_EQ(expected, Scan(html));
+  for (size_t chunk_size = 1; chunk_size < 8; ++chunk_size)
+    EXPECT_EQ(expected, ScanInChunks(html, chunk_size)) << chunk_size;
+}
+
+}  // namespace
+
+}  // namespace content
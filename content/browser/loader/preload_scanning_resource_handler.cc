@@ -0,0 +1,95 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/loader/preload_scanning_resource_handler.h"
+
+#include <vector>
+
+#include "base/metrics/histogram.h"
+#include "content/browser/loader/preload_scanner.h"
+#include "content/browser/loader/resource_dispatcher_host_impl.h"
+#include "content/browser/loader/resource_request_info_impl.h"
+#include "content/public/common/resource_response.h"
+#include "net/base/io_buffer.h"
+#include "net/url_request/url_request.h"
+
+namespace content {
+
+namespace {
+
+// Subresources referred to past this point are left to the renderer, which
+// will have the start of the document by then.
+const int kMaxScannedBytes = 256 * 1024;
+
+// Limits the load a single page can put on the network before the renderer
+// has had a say in what it needs first.
+const size_t kMaxPreloadsPerPage = 32;
+
+}  // namespace
+
+PreloadScanningResourceHandler::PreloadScanningResourceHandler(
+    scoped_ptr<ResourceHandler> next_handler,
+    net::URLRequest* request,
+    ResourceDispatcherHostImpl* host)
+    : LayeredResourceHandler(request, next_handler.Pass()),
+      host_(host),
+      scanned_bytes_(0) {
+}
+
+PreloadScanningResourceHandler::~PreloadScanningResourceHandler() {
+  UMA_HISTOGRAM_COUNTS_100("Net.PreloadScanner.RequestsPerPage",
+                           requested_urls_.size());
+}
+
+bool PreloadScanningResourceHandler::OnResponseStarted(
+    int request_id,
+    ResourceResponse* response,
+    bool* defer) {
+  if (response->head.mime_type == "text/html")
+    scanner_.reset(new PreloadScanner(request()->url()));
+  return next_handler_->OnResponseStarted(request_id, response, defer);
+}
+
+bool PreloadScanningResourceHandler::OnWillRead(
+    int request_id,
+    scoped_refptr<net::IOBuffer>* buf,
+    int* buf_size,
+    int min_size) {
+  if (!next_handler_->OnWillRead(request_id, buf, buf_size, min_size))
+    return false;
+  read_buffer_ = *buf;
+  return true;
+}
+
+bool PreloadScanningResourceHandler::OnReadCompleted(int request_id,
+                                                     int bytes_read,
+                                                     bool* defer) {
+  if (scanner_.get() && read_buffer_.get() && bytes_read > 0) {
+    std::vector<GURL> urls;
+    scanner_->Scan(read_buffer_->data(), bytes_read, &urls);
+
+    const ResourceRequestInfoImpl* info = GetRequestInfo();
+    for (size_t i = 0; i < urls.size() &&
+                       requested_urls_.size() < kMaxPreloadsPerPage; ++i) {
+      if (urls[i] == request()->url() ||
+          !requested_urls_.insert(urls[i]).second) {
+        continue;
+      }
+      host_->BeginSpeculativeRequest(urls[i], request()->url(),
+                                     info->GetChildID(), info->GetRouteID(),
+                                     info->GetContext());
+    }
+
+    scanned_bytes_ += bytes_read;
+    if (scanned_bytes_ >= kMaxScannedBytes ||
+        requested_urls_.size() >= kMaxPreloadsPerPage) {
+      scanner_.reset();
+    }
+  }
+  read_buffer_ = NULL;
+
+  return next_handler_->OnReadCompleted(request_id, bytes_read, defer);
+}
+
+}  // namespace content
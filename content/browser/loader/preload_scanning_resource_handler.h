@@ -0,0 +1,64 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_LOADER_PRELOAD_SCANNING_RESOURCE_HANDLER_H_
+#define CONTENT_BROWSER_LOADER_PRELOAD_SCANNING_RESOURCE_HANDLER_H_
+
+#include <set>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "content/browser/loader/layered_resource_handler.h"
+#include "url/gurl.h"
+
+namespace net {
+class IOBuffer;
+class URLRequest;
+}
+
+namespace content {
+class PreloadScanner;
+class ResourceDispatcherHostImpl;
+
+// Scans an HTML main frame response as it streams through, and starts low
+// priority requests for the scripts, stylesheets and images it refers to. The
+// responses only go into the HTTP cache: when the renderer's preload scanner
+// asks for the same URLs, they are served from the cache, or wait on the cache
+// entry if the speculative request is still in flight. This saves the time the
+// response takes to reach the renderer and be parsed there.
+class PreloadScanningResourceHandler : public LayeredResourceHandler {
+ public:
+  PreloadScanningResourceHandler(scoped_ptr<ResourceHandler> next_handler,
+                                 net::URLRequest* request,
+                                 ResourceDispatcherHostImpl* host);
+  virtual ~PreloadScanningResourceHandler();
+
+  // ResourceHandler implementation:
+  virtual bool OnResponseStarted(int request_id,
+                                 ResourceResponse* response,
+                                 bool* defer) OVERRIDE;
+  virtual bool OnWillRead(int request_id,
+                          scoped_refptr<net::IOBuffer>* buf,
+                          int* buf_size,
+                          int min_size) OVERRIDE;
+  virtual bool OnReadCompleted(int request_id,
+                               int bytes_read,
+                               bool* defer) OVERRIDE;
+
+ private:
+  ResourceDispatcherHostImpl* host_;
+
+  // Null unless the response is HTML that is still being scanned.
+  scoped_ptr<PreloadScanner> scanner_;
+  // The buffer handed to the next handler by the last OnWillRead.
+  scoped_refptr<net::IOBuffer> read_buffer_;
+  int scanned_bytes_;
+  std::set<GURL> requested_urls_;
+
+  DISALLOW_COPY_AND_ASSIGN(PreloadScanningResourceHandler);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_LOADER_PRELOAD_SCANNING_RESOURCE_HANDLER_H_
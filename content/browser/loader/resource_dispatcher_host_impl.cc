@@ -36,6 +36,7 @@
 #include "content/browser/loader/cross_site_resource_handler.h"
 #include "content/browser/loader/detachable_resource_handler.h"
 #include "content/browser/loader/power_save_block_resource_throttle.h"
+#include "content/browser/loader/preload_scanning_resource_handler.h"
 #include "content/browser/loader/redirect_to_file_resource_handler.h"
 #include "content/browser/loader/resource_message_filter.h"
 #include "content/browser/loader/resource_request_info_impl.h"
@@ -1176,6 +1177,16 @@ scoped_ptr<ResourceHandler> ResourceDispatcherHostImpl::CreateResourceHandler(
   if (is_swappable_navigation && process_type == PROCESS_TYPE_RENDERER)
     handler.reset(new CrossSiteResourceHandler(handler.Pass(), request));
 
+  // Inside the BufferedResourceHandler, so that it only sees responses which
+  // will be rendered, with their sniffed MIME type.
+  if (request_data.resource_type == ResourceType::MAIN_FRAME &&
+      process_type == PROCESS_TYPE_RENDERER &&
+      CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableBrowserPreloadScanner)) {
+    handler.reset(
+        new PreloadScanningResourceHandler(handler.Pass(), request, this));
+  }
+
   // Insert a buffered event handler before the actual one.
   handler.reset(
       new BufferedResourceHandler(handler.Pass(), this, request));
@@ -1321,6 +1332,13 @@ void ResourceDispatcherHostImpl::OnRenderViewHostDeleted(
   CancelRequestsForRoute(child_id, route_id);
 }
 
+void ResourceDispatcherHostImpl::OnRenderViewHostVisibilityChanged(
+    int child_id,
+    int route_id,
+    bool is_visible) {
+  scheduler_->OnVisibilityChanged(child_id, route_id, is_visible);
+}
+
 // This function is only used for saving feature.
 void ResourceDispatcherHostImpl::BeginSaveFile(
     const GURL& url,
@@ -1378,6 +1396,43 @@ void ResourceDispatcherHostImpl::BeginSaveFile(
   BeginRequestInternal(request.Pass(), handler.Pass());
 }
 
+void ResourceDispatcherHostImpl::BeginSpeculativeRequest(
+    const GURL& url,
+    const GURL& referrer,
+    int child_id,
+    int route_id,
+    ResourceContext* context) {
+  if (is_shutdown_)
+    return;
+  DCHECK(ContainsKey(active_resource_contexts_, context));
+
+  const net::URLRequestContext* request_context = context->GetRequestContext();
+  if (!request_context->job_factory()->IsHandledURL(url))
+    return;
+
+  request_id_--;
+
+  scoped_ptr<net::URLRequest> request(
+      request_context->CreateRequest(url, net::IDLE, NULL));
+  request->set_method("GET");
+  SetReferrerForRequest(request.get(),
+                        Referrer(referrer, blink::WebReferrerPolicyDefault));
+
+  ResourceRequestInfoImpl* extra_info =
+      CreateRequestInfo(child_id, route_id, false, context);
+  extra_info->AssociateWithRequest(request.get());  // Request takes ownership.
+
+  // A detachable handler without a next handler reads the response to the end
+  // and drops it, so that it lands in the HTTP cache. It is not canceled along
+  // with the page, since the renderer will likely want the response.
+  scoped_ptr<ResourceHandler> handler(new DetachableResourceHandler(
+      request.get(),
+      base::TimeDelta::FromMilliseconds(kDefaultDetachableCancelDelayMs),
+      scoped_ptr<ResourceHandler>()));
+
+  BeginRequestInternal(request.Pass(), handler.Pass());
+}
+
 void ResourceDispatcherHostImpl::MarkAsTransferredNavigation(
     const GlobalRequestID& id) {
   GetLoader(id)->MarkAsTransferring();
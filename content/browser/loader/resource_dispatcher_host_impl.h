@@ -123,6 +123,15 @@ class CONTENT_EXPORT ResourceDispatcherHostImpl
                      int route_id,
                      ResourceContext* context);
 
+  // Starts a low priority request for |url|, a subresource found in the main
+  // frame document at |referrer| before the renderer asked for it. Nothing is
+  // done with the response other than caching it.
+  void BeginSpeculativeRequest(const GURL& url,
+                               const GURL& referrer,
+                               int child_id,
+                               int route_id,
+                               ResourceContext* context);
+
   // Cancels the given request if it still exists.
   void CancelRequest(int child_id, int request_id);
 
@@ -167,6 +176,11 @@ class CONTENT_EXPORT ResourceDispatcherHostImpl
   // Called when a RenderViewHost is deleted.
   void OnRenderViewHostDeleted(int child_id, int route_id);
 
+  // Called when a RenderViewHost is hidden or shown.
+  void OnRenderViewHostVisibilityChanged(int child_id,
+                                         int route_id,
+                                         bool is_visible);
+
   // Force cancels any pending requests for the given process.
   void CancelRequestsForProcess(int child_id);
 
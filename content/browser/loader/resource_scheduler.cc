@@ -4,15 +4,19 @@
 
 #include "content/browser/loader/resource_scheduler.h"
 
+#include "base/command_line.h"
+#include "base/metrics/histogram.h"
 #include "base/stl_util.h"
 #include "content/common/resource_messages.h"
 #include "content/browser/loader/resource_message_delegate.h"
 #include "content/public/browser/resource_controller.h"
 #include "content/public/browser/resource_request_info.h"
 #include "content/public/browser/resource_throttle.h"
+#include "content/public/common/content_switches.h"
 #include "ipc/ipc_message_macros.h"
 #include "net/base/host_port_pair.h"
 #include "net/base/load_flags.h"
+#include "net/base/load_timing_info.h"
 #include "net/base/request_priority.h"
 #include "net/http/http_server_properties.h"
 #include "net/url_request/url_request.h"
@@ -22,6 +26,7 @@ namespace content {
 
 static const size_t kMaxNumDelayableRequestsPerClient = 10;
 static const size_t kMaxNumDelayableRequestsPerHost = 6;
+static const size_t kMaxNumDelayableRequestsPerHiddenClient = 1;
 
 // A thin wrapper around net::PriorityQueue that deals with
 // ScheduledResourceRequests instead of PriorityQueue::Pointers.
@@ -178,16 +183,21 @@ class ResourceScheduler::ScheduledResourceRequest
 
 // Each client represents a tab.
 struct ResourceScheduler::Client {
-  Client() : has_body(false), using_spdy_proxy(false) {}
+  Client() : has_body(false), using_spdy_proxy(false), is_visible(true) {}
   ~Client() {}
 
   bool has_body;
   bool using_spdy_proxy;
+  bool is_visible;
   RequestQueue pending_requests;
   RequestSet in_flight_requests;
+  ThroughputEstimator estimate;
+  base::TimeTicks navigation_time;
 };
 
-ResourceScheduler::ResourceScheduler() {
+ResourceScheduler::ResourceScheduler()
+    : adaptive_scheduling_(CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableAdaptiveResourceScheduling)) {
 }
 
 ResourceScheduler::~ResourceScheduler() {
@@ -245,6 +255,9 @@ void ResourceScheduler::RemoveRequest(ScheduledResourceRequest* request) {
     size_t erased = client->in_flight_requests.erase(request);
     DCHECK(erased);
 
+    if (adaptive_scheduling_)
+      RecordCompletedRequest(request, client);
+
     // Removing this request may have freed up another to load.
     LoadAnyStartablePendingRequests(client);
   }
@@ -281,6 +294,24 @@ void ResourceScheduler::OnClientDeleted(int child_id, int route_id) {
   client_map_.erase(it);
 }
 
+void ResourceScheduler::OnVisibilityChanged(int child_id,
+                                            int route_id,
+                                            bool is_visible) {
+  DCHECK(CalledOnValidThread());
+  ClientId client_id = MakeClientId(child_id, route_id);
+
+  ClientMap::iterator it = client_map_.find(client_id);
+  if (it == client_map_.end()) {
+    // The client was likely deleted shortly before we received this task.
+    return;
+  }
+
+  Client* client = it->second;
+  client->is_visible = is_visible;
+  if (is_visible)
+    LoadAnyStartablePendingRequests(client);
+}
+
 void ResourceScheduler::OnNavigate(int child_id, int route_id) {
   DCHECK(CalledOnValidThread());
   ClientId client_id = MakeClientId(child_id, route_id);
@@ -293,6 +324,7 @@ void ResourceScheduler::OnNavigate(int child_id, int route_id) {
 
   Client* client = it->second;
   client->has_body = false;
+  client->navigation_time = base::TimeTicks::Now();
 }
 
 void ResourceScheduler::OnWillInsertBody(int child_id, int route_id) {
@@ -306,6 +338,18 @@ void ResourceScheduler::OnWillInsertBody(int child_id, int route_id) {
   }
 
   Client* client = it->second;
+  // Inserting the body is as close as the scheduler gets to first paint.
+  if (!client->has_body && !client->navigation_time.is_null()) {
+    base::TimeDelta time_to_body =
+        base::TimeTicks::Now() - client->navigation_time;
+    if (adaptive_scheduling_) {
+      UMA_HISTOGRAM_MEDIUM_TIMES("ResourceScheduler.NavigateToBody.Adaptive",
+                                 time_to_body);
+    } else {
+      UMA_HISTOGRAM_MEDIUM_TIMES("ResourceScheduler.NavigateToBody.Static",
+                                 time_to_body);
+    }
+  }
   client->has_body = true;
   LoadAnyStartablePendingRequests(client);
 }
@@ -329,6 +373,35 @@ void ResourceScheduler::OnReceivedSpdyProxiedHttpResponse(
   }
 }
 
+void ResourceScheduler::RecordCompletedRequest(
+    ScheduledResourceRequest* request,
+    Client* client) {
+  const net::URLRequest& url_request = *request->url_request();
+  if (url_request.is_pending() ||
+      url_request.status().status() != net::URLRequestStatus::SUCCESS ||
+      url_request.was_cached()) {
+    return;
+  }
+
+  net::LoadTimingInfo load_timing_info;
+  url_request.GetLoadTimingInfo(&load_timing_info);
+  if (load_timing_info.send_start.is_null() ||
+      load_timing_info.receive_headers_end.is_null()) {
+    return;
+  }
+
+  base::TimeDelta round_trip_time =
+      load_timing_info.receive_headers_end - load_timing_info.send_start;
+  client->estimate.AddRoundTripTime(round_trip_time);
+  global_estimate_.AddRoundTripTime(round_trip_time);
+
+  int64 bytes = url_request.GetTotalReceivedBytes();
+  base::TimeDelta transfer_time =
+      base::TimeTicks::Now() - load_timing_info.receive_headers_end;
+  client->estimate.AddTransfer(bytes, transfer_time);
+  global_estimate_.AddTransfer(bytes, transfer_time);
+}
+
 void ResourceScheduler::StartRequest(ScheduledResourceRequest* request,
                                      Client* client) {
   client->in_flight_requests.insert(request);
@@ -457,6 +530,10 @@ void ResourceScheduler::GetNumDelayableRequestsInFlight(
 //   * Never exceed 10 delayable requests in flight per client.
 //   * Never exceed 6 delayable requests for a given host.
 //   * Prior to <body>, allow one delayable request to load at a time.
+//
+// With adaptive scheduling, stylesheets and scripts requested before <body>
+// are issued immediately, the limit of 10 follows the measured bandwidth-delay
+// product instead, and hidden clients get one delayable request at a time.
 ResourceScheduler::ShouldStartReqResult ResourceScheduler::ShouldStartRequest(
     ScheduledResourceRequest* request,
     Client* client) const {
@@ -480,6 +557,14 @@ ResourceScheduler::ShouldStartReqResult ResourceScheduler::ShouldStartRequest(
     return START_REQUEST;
   }
 
+  if (adaptive_scheduling_ && !client->has_body) {
+    // These hold up the first paint, so delaying them never pays off.
+    ResourceType::Type type =
+        ResourceRequestInfo::ForRequest(&url_request)->GetResourceType();
+    if (type == ResourceType::STYLESHEET || type == ResourceType::SCRIPT)
+      return START_REQUEST;
+  }
+
   net::HostPortPair host_port_pair =
       net::HostPortPair::FromURL(url_request.url());
 
@@ -496,7 +581,7 @@ ResourceScheduler::ShouldStartReqResult ResourceScheduler::ShouldStartRequest(
                                   &num_delayable_requests_in_flight,
                                   &num_requests_in_flight_for_host);
 
-  if (num_delayable_requests_in_flight >= kMaxNumDelayableRequestsPerClient) {
+  if (num_delayable_requests_in_flight >= GetMaxDelayableRequests(client)) {
     return DO_NOT_START_REQUEST_AND_STOP_SEARCHING;
   }
 
@@ -515,6 +600,16 @@ ResourceScheduler::ShouldStartReqResult ResourceScheduler::ShouldStartRequest(
   return START_REQUEST;
 }
 
+size_t ResourceScheduler::GetMaxDelayableRequests(Client* client) const {
+  if (!adaptive_scheduling_)
+    return kMaxNumDelayableRequestsPerClient;
+  if (!client->is_visible)
+    return kMaxNumDelayableRequestsPerHiddenClient;
+  const ThroughputEstimator& estimate =
+      client->estimate.HasEstimate() ? client->estimate : global_estimate_;
+  return estimate.GetMaxDelayableRequests(kMaxNumDelayableRequestsPerClient);
+}
+
 ResourceScheduler::ClientId ResourceScheduler::MakeClientId(
     int child_id, int route_id) {
   return (static_cast<ResourceScheduler::ClientId>(child_id) << 32) | route_id;
@@ -12,6 +12,7 @@
 #include "base/compiler_specific.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/threading/non_thread_safe.h"
+#include "content/browser/loader/throughput_estimator.h"
 #include "content/common/content_export.h"
 #include "net/base/priority_queue.h"
 #include "net/base/request_priority.h"
@@ -50,6 +51,11 @@ class ResourceThrottle;
 // The scheduler may defer issuing the request via the ResourceThrottle
 // interface or it may alter the request's priority by calling set_priority() on
 // the URLRequest.
+//
+// With --enable-adaptive-resource-scheduling, the number of delayable requests
+// in flight follows the throughput and round trip time measured on completed
+// loads, hidden clients are held to a single delayable request, and
+// stylesheets and scripts requested before <body> are never delayed.
 class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
  public:
   ResourceScheduler();
@@ -69,6 +75,9 @@ class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
   // Called when a renderer is destroyed.
   void OnClientDeleted(int child_id, int route_id);
 
+  // Called when a renderer is hidden or shown.
+  void OnVisibilityChanged(int child_id, int route_id, bool is_visible);
+
   // Signals from IPC messages directly from the renderers:
 
   // Called when a client navigates to a new main document.
@@ -84,6 +93,10 @@ class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
   // from a proxy using SPDY.
   void OnReceivedSpdyProxiedHttpResponse(int child_id, int route_id);
 
+  void SetAdaptiveSchedulingForTesting(bool enabled) {
+    adaptive_scheduling_ = enabled;
+  }
+
  private:
   class RequestQueue;
   class ScheduledResourceRequest;
@@ -96,6 +109,11 @@ class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
   // Called when a ScheduledResourceRequest is destroyed.
   void RemoveRequest(ScheduledResourceRequest* request);
 
+  // Feeds the timing of the finished |request| to the estimates used for
+  // |client|.
+  void RecordCompletedRequest(ScheduledResourceRequest* request,
+                              Client* client);
+
   // Unthrottles the |request| and adds it to |client|.
   void StartRequest(ScheduledResourceRequest* request, Client* client);
 
@@ -126,6 +144,9 @@ class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
     START_REQUEST = 1,
   };
 
+  // Returns the number of delayable requests |client| may have in flight.
+  size_t GetMaxDelayableRequests(Client* client) const;
+
   // Returns true if the request should start. This is the core scheduling
   // algorithm.
   ShouldStartReqResult ShouldStartRequest(ScheduledResourceRequest* request,
@@ -136,6 +157,11 @@ class CONTENT_EXPORT ResourceScheduler : public base::NonThreadSafe {
 
   ClientMap client_map_;
   RequestSet unowned_requests_;
+
+  bool adaptive_scheduling_;
+  // Covers the loads of all clients, for clients without estimates of their
+  // own.
+  ThroughputEstimator global_estimate_;
 };
 
 }  // namespace content
@@ -134,10 +134,11 @@ class ResourceSchedulerTest : public testing::Test {
     scheduler_.OnClientDeleted(kChildId, kRouteId);
   }
 
-  scoped_ptr<net::URLRequest> NewURLRequestWithRoute(
+  scoped_ptr<net::URLRequest> NewURLRequestWithRouteAndType(
       const char* url,
       net::RequestPriority priority,
-      int route_id) {
+      int route_id,
+      ResourceType::Type resource_type) {
     scoped_ptr<net::URLRequest> url_request(
         context_.CreateRequest(GURL(url), priority, NULL));
     ResourceRequestInfoImpl* info = new ResourceRequestInfoImpl(
@@ -151,7 +152,7 @@ class ResourceSchedulerTest : public testing::Test {
         0,                                 // frame_id
         false,                             // parent_is_main_frame
         0,                                 // parent_frame_id
-        ResourceType::SUB_RESOURCE,        // resource_type
+        resource_type,                     // resource_type
         PAGE_TRANSITION_LINK,              // transition_type
         false,                             // should_replace_current_entry
         false,                             // is_download
@@ -167,6 +168,14 @@ class ResourceSchedulerTest : public testing::Test {
     return url_request.Pass();
   }
 
+  scoped_ptr<net::URLRequest> NewURLRequestWithRoute(
+      const char* url,
+      net::RequestPriority priority,
+      int route_id) {
+    return NewURLRequestWithRouteAndType(url, priority, route_id,
+                                         ResourceType::SUB_RESOURCE);
+  }
+
   scoped_ptr<net::URLRequest> NewURLRequest(const char* url,
                                             net::RequestPriority priority) {
     return NewURLRequestWithRoute(url, priority, kRouteId);
@@ -188,6 +197,18 @@ class ResourceSchedulerTest : public testing::Test {
     return NewRequestWithRoute(url, priority, kRouteId);
   }
 
+  TestRequest* NewRequestWithType(const char* url,
+                                  net::RequestPriority priority,
+                                  ResourceType::Type resource_type) {
+    scoped_ptr<net::URLRequest> url_request(NewURLRequestWithRouteAndType(
+        url, priority, kRouteId, resource_type));
+    scoped_ptr<ResourceThrottle> throttle(scheduler_.ScheduleRequest(
+        kChildId, kRouteId, url_request.get()));
+    TestRequest* request = new TestRequest(throttle.Pass(), url_request.Pass());
+    request->Start();
+    return request;
+  }
+
   void ChangeRequestPriority(TestRequest* request,
                              net::RequestPriority new_priority) {
     scoped_refptr<FakeResourceMessageFilter> filter(
@@ -478,6 +499,35 @@ TEST_F(ResourceSchedulerTest, SpdyProxySchedulesImmediately) {
   EXPECT_TRUE(after->started());
 }
 
+TEST_F(ResourceSchedulerTest, AdaptiveHiddenClientLoadsOneLowAtATime) {
+  scheduler_.SetAdaptiveSchedulingForTesting(true);
+  scheduler_.OnWillInsertBody(kChildId, kRouteId);
+  scheduler_.OnVisibilityChanged(kChildId, kRouteId, false);
+  scoped_ptr<TestRequest> low(NewRequest("http://host/low", net::LOWEST));
+  scoped_ptr<TestRequest> low2(NewRequest("http://host/low2", net::LOWEST));
+  EXPECT_TRUE(low->started());
+  EXPECT_FALSE(low2->started());
+
+  scheduler_.OnVisibilityChanged(kChildId, kRouteId, true);
+  EXPECT_TRUE(low2->started());
+}
+
+TEST_F(ResourceSchedulerTest, AdaptiveStylesheetsAndScriptsBeforeBody) {
+  scoped_ptr<TestRequest> high(NewRequest("http://host/high", net::HIGHEST));
+  scoped_ptr<TestRequest> low(NewRequest("http://host/low", net::LOWEST));
+  scoped_ptr<TestRequest> css(NewRequestWithType(
+      "http://host/css", net::LOWEST, ResourceType::STYLESHEET));
+  EXPECT_FALSE(css->started());
+
+  scheduler_.SetAdaptiveSchedulingForTesting(true);
+  scoped_ptr<TestRequest> js(NewRequestWithType(
+      "http://host/js", net::LOWEST, ResourceType::SCRIPT));
+  scoped_ptr<TestRequest> image(NewRequestWithType(
+      "http://host/image", net::LOWEST, ResourceType::IMAGE));
+  EXPECT_TRUE(js->started());
+  EXPECT_FALSE(image->started());
+}
+
 }  // unnamed namespace
 
 }  // namespace content
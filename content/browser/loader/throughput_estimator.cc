@@ -0,0 +1,85 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/loader/throughput_estimator.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+namespace content {
+
+namespace {
+
+// Weight of a new sample in the moving averages.
+const double kSampleWeight = 0.25;
+
+// The size of a typical delayable resource. Keeping the bandwidth-delay
+// product in flight takes about one request per this many bytes.
+const double kTypicalResourceBytes = 32 * 1024;
+
+double AddSample(double average, int num_samples, double sample) {
+  if (num_samples == 0)
+    return sample;
+  return average + kSampleWeight * (sample - average);
+}
+
+}  // namespace
+
+const int64 ThroughputEstimator::kMinTransferBytes;
+const size_t ThroughputEstimator::kMinDelayableRequests;
+const size_t ThroughputEstimator::kMaxDelayableRequests;
+
+ThroughputEstimator::ThroughputEstimator()
+    : num_round_trip_samples_(0),
+      num_transfer_samples_(0),
+      round_trip_seconds_(0),
+      bytes_per_second_(0) {
+}
+
+ThroughputEstimator::~ThroughputEstimator() {
+}
+
+void ThroughputEstimator::AddRoundTripTime(base::TimeDelta round_trip_time) {
+  if (round_trip_time <= base::TimeDelta())
+    return;
+  round_trip_seconds_ = AddSample(round_trip_seconds_,
+                                  num_round_trip_samples_,
+                                  round_trip_time.InSecondsF());
+  ++num_round_trip_samples_;
+}
+
+void ThroughputEstimator::AddTransfer(int64 bytes, base::TimeDelta duration) {
+  if (bytes < kMinTransferBytes || duration <= base::TimeDelta())
+    return;
+  bytes_per_second_ = AddSample(bytes_per_second_, num_transfer_samples_,
+                                bytes / duration.InSecondsF());
+  ++num_transfer_samples_;
+}
+
+bool ThroughputEstimator::HasEstimate() const {
+  return num_round_trip_samples_ > 0 && num_transfer_samples_ > 0;
+}
+
+size_t ThroughputEstimator::GetMaxDelayableRequests(
+    size_t default_limit) const {
+  if (!HasEstimate())
+    return default_limit;
+
+  // One request beyond the bandwidth-delay product covers the round trip of
+  // the next request while the others finish.
+  double bandwidth_delay_product = bytes_per_second_ * round_trip_seconds_;
+  double limit = 1 + ceil(bandwidth_delay_product / kTypicalResourceBytes);
+  limit = std::max(limit, static_cast<double>(kMinDelayableRequests));
+  limit = std::min(limit, static_cast<double>(kMaxDelayableRequests));
+  return static_cast<size_t>(limit);
+}
+
+base::TimeDelta ThroughputEstimator::round_trip_time() const {
+  return base::TimeDelta::FromMicroseconds(
+      static_cast<int64>(round_trip_seconds_ *
+                         base::Time::kMicrosecondsPerSecond));
+}
+
+}  // namespace content
@@ -0,0 +1,61 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_LOADER_THROUGHPUT_ESTIMATOR_H_
+#define CONTENT_BROWSER_LOADER_THROUGHPUT_ESTIMATOR_H_
+
+#include "base/basictypes.h"
+#include "base/time/time.h"
+#include "content/common/content_export.h"
+
+namespace content {
+
+// Keeps moving averages of the round trip time and the throughput seen by
+// completed loads, and from them sizes how many delayable requests the
+// ResourceScheduler keeps in flight: enough to fill the bandwidth-delay
+// product of the connection, but no more, so that requests which are in flight
+// do not just compete with each other for the link.
+class CONTENT_EXPORT ThroughputEstimator {
+ public:
+  // Bodies smaller than this finish within a few round trips, so their
+  // transfer time says more about latency than about bandwidth.
+  static const int64 kMinTransferBytes = 16 * 1024;
+
+  // Bounds of GetMaxDelayableRequests().
+  static const size_t kMinDelayableRequests = 2;
+  static const size_t kMaxDelayableRequests = 32;
+
+  ThroughputEstimator();
+  ~ThroughputEstimator();
+
+  // Adds the time from sending a request to receiving its response headers.
+  void AddRoundTripTime(base::TimeDelta round_trip_time);
+
+  // Adds a response body of |bytes| bytes which took |duration| to receive.
+  // Bodies smaller than kMinTransferBytes are ignored.
+  void AddTransfer(int64 bytes, base::TimeDelta duration);
+
+  // Returns true once both the round trip time and the throughput have been
+  // sampled.
+  bool HasEstimate() const;
+
+  // Returns the number of delayable requests to keep in flight, or
+  // |default_limit| if there is no estimate yet.
+  size_t GetMaxDelayableRequests(size_t default_limit) const;
+
+  base::TimeDelta round_trip_time() const;
+  double bytes_per_second() const { return bytes_per_second_; }
+
+ private:
+  int num_round_trip_samples_;
+  int num_transfer_samples_;
+  double round_trip_seconds_;
+  double bytes_per_second_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThroughputEstimator);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_LOADER_THROUGHPUT_ESTIMATOR_H_
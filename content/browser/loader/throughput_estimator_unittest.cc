@@ -0,0 +1,76 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/loader/throughput_estimator.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+
+namespace {
+
+const size_t kDefaultLimit = 10;
+
+base::TimeDelta Milliseconds(int64 ms) {
+  return base::TimeDelta::FromMilliseconds(ms);
+}
+
+TEST(ThroughputEstimatorTest, NoEstimateUsesDefault) {
+  ThroughputEstimator estimator;
+  EXPECT_FALSE(estimator.HasEstimate());
+  EXPECT_EQ(kDefaultLimit, estimator.GetMaxDelayableRequests(kDefaultLimit));
+
+  estimator.AddRoundTripTime(Milliseconds(100));
+  EXPECT_FALSE(estimator.HasEstimate());
+  EXPECT_EQ(kDefaultLimit, estimator.GetMaxDelayableRequests(kDefaultLimit));
+}
+
+TEST(ThroughputEstimatorTest, SmallTransfersAreIgnored) {
+  ThroughputEstimator estimator;
+  estimator.AddRoundTripTime(Milliseconds(100));
+  estimator.AddTransfer(ThroughputEstimator::kMinTransferBytes - 1,
+                        Milliseconds(1));
+  EXPECT_FALSE(estimator.HasEstimate());
+  estimator.AddTransfer(ThroughputEstimator::kMinTransferBytes,
+                        Milliseconds(0));
+  EXPECT_FALSE(estimator.HasEstimate());
+}
+
+TEST(ThroughputEstimatorTest, LimitFollowsBandwidthDelayProduct) {
+  // 1MB/s with a 100ms round trip keeps 100KB, about three 32KB resources, in
+  // flight.
+  ThroughputEstimator estimator;
+  estimator.AddRoundTripTime(Milliseconds(100));
+  estimator.AddTransfer(1024 * 1024, Milliseconds(1000));
+  ASSERT_TRUE(estimator.HasEstimate());
+  EXPECT_EQ(100, estimator.round_trip_time().InMilliseconds());
+  EXPECT_DOUBLE_EQ(1024 * 1024, estimator.bytes_per_second());
+  EXPECT_EQ(5u, estimator.GetMaxDelayableRequests(kDefaultLimit));
+}
+
+TEST(ThroughputEstimatorTest, LimitIsClamped) {
+  ThroughputEstimator slow;
+  slow.AddRoundTripTime(Milliseconds(10));
+  slow.AddTransfer(32 * 1024, Milliseconds(1000));
+  EXPECT_EQ(ThroughputEstimator::kMinDelayableRequests,
+            slow.GetMaxDelayableRequests(kDefaultLimit));
+
+  ThroughputEstimator fast;
+  fast.AddRoundTripTime(Milliseconds(500));
+  fast.AddTransfer(100 * 1024 * 1024, Milliseconds(1000));
+  EXPECT_EQ(ThroughputEstimator::kMaxDelayableRequests,
+            fast.GetMaxDelayableRequests(kDefaultLimit));
+}
+
+TEST(ThroughputEstimatorTest, SamplesAreAveraged) {
+  ThroughputEstimator estimator;
+  estimator.AddRoundTripTime(Milliseconds(100));
+  estimator.AddRoundTripTime(Milliseconds(500));
+  // The newer sample moves the average a quarter of the way towards it.
+  EXPECT_EQ(200, estimator.round_trip_time().InMilliseconds());
+}
+
+}  // namespace
+
+}  // namespace content
@@ -46,6 +46,13 @@ using base::Time;
 
 namespace content {
 
+namespace {
+
+// Default time for which cookie changes are batched before being committed.
+const int kDefaultCommitIntervalMs = 30 * 1000;
+
+}  // namespace
+
 // This class is designed to be shared between any client thread and the
 // background task runner. It batches operations and commits them on a timer.
 //
@@ -66,8 +73,9 @@ namespace content {
 //
 // Subsequent to loading, mutations may be queued by any thread using
 // AddCookie, UpdateCookieAccessTime, and DeleteCookie. These are flushed to
-// disk on the BG runner every 30 seconds, 512 operations, or call to Flush(),
-// whichever occurs first.
+// disk on the BG runner every commit interval (30 seconds by default), 512
+// operations, or call to Flush(), whichever occurs first. Only the last access
+// time update for each cookie in a batch is written.
 class SQLitePersistentCookieStore::Backend
     : public base::RefCountedThreadSafe<SQLitePersistentCookieStore::Backend> {
  public:
@@ -80,6 +88,8 @@ class SQLitePersistentCookieStore::Backend
       CookieCryptoDelegate* crypto_delegate)
       : path_(path),
         num_pending_(0),
+        commit_interval_(
+            base::TimeDelta::FromMilliseconds(kDefaultCommitIntervalMs)),
         force_keep_session_state_(false),
         initialized_(false),
         corruption_detected_(false),
@@ -111,6 +121,10 @@ class SQLitePersistentCookieStore::Backend
   // Commit pending operations as soon as possible.
   void Flush(const base::Closure& callback);
 
+  void set_commit_interval(const base::TimeDelta& commit_interval) {
+    commit_interval_ = commit_interval;
+  }
+
   // Commit any pending operations and close the database.  This must be called
   // before the object is destructed.
   void Close();
@@ -220,6 +234,8 @@ class SQLitePersistentCookieStore::Backend
   typedef std::list<PendingOperation*> PendingOperationsList;
   PendingOperationsList pending_;
   PendingOperationsList::size_type num_pending_;
+  // How long operations are batched before they are committed.
+  base::TimeDelta commit_interval_;
   // True if the persistent store should skip delete on exit rules.
   bool force_keep_session_state_;
   // Guard |cookies_|, |pending_|, |num_pending_|, |force_keep_session_state_|
@@ -923,8 +939,6 @@ void SQLitePersistentCookieStore::Backend::DeleteCookie(
 void SQLitePersistentCookieStore::Backend::BatchOperation(
     PendingOperation::OperationType op,
     const net::CanonicalCookie& cc) {
-  // Commit every 30 seconds.
-  static const int kCommitIntervalMs = 30 * 1000;
   // Commit right away if we have more than 512 outstanding operations.
   static const size_t kCommitAfterBatchSize = 512;
   DCHECK(!background_task_runner_->RunsTasksOnCurrentThread());
@@ -943,7 +957,7 @@ void SQLitePersistentCookieStore::Backend::BatchOperation(
     // We've gotten our first entry for this batch, fire off the timer.
     if (!background_task_runner_->PostDelayedTask(
             FROM_HERE, base::Bind(&Backend::Commit, this),
-            base::TimeDelta::FromMilliseconds(kCommitIntervalMs))) {
+            commit_interval_)) {
       NOTREACHED() << "background_task_runner_ is not running.";
     }
   } else if (num_pending == kCommitAfterBatchSize) {
@@ -984,6 +998,19 @@ void SQLitePersistentCookieStore::Backend::Commit() {
   if (!del_smt.is_valid())
     return;
 
+  // An access time update is redundant if the same cookie (identified by its
+  // creation time, as in the statements above) is updated again or deleted
+  // later in the batch.
+  std::set<PendingOperation*> superseded_ops;
+  std::set<int64> later_ops;
+  for (PendingOperationsList::reverse_iterator it = ops.rbegin();
+       it != ops.rend(); ++it) {
+    bool is_last_op = later_ops.insert(
+        (*it)->cc().CreationDate().ToInternalValue()).second;
+    if (!is_last_op && (*it)->op() == PendingOperation::COOKIE_UPDATEACCESS)
+      superseded_ops.insert(*it);
+  }
+
   sql::Transaction transaction(db_.get());
   if (!transaction.Begin())
     return;
@@ -992,6 +1019,8 @@ void SQLitePersistentCookieStore::Backend::Commit() {
        it != ops.end(); ++it) {
     // Free the cookies as we commit them to the database.
     scoped_ptr<PendingOperation> po(*it);
+    if (superseded_ops.count(po.get()))
+      continue;
     switch (po->op()) {
       case PendingOperation::COOKIE_ADD:
         cookies_per_origin_[
@@ -1246,6 +1275,11 @@ void SQLitePersistentCookieStore::Flush(const base::Closure& callback) {
   backend_->Flush(callback);
 }
 
+void SQLitePersistentCookieStore::SetCommitInterval(
+    const base::TimeDelta& commit_interval) {
+  backend_->set_commit_interval(commit_interval);
+}
+
 SQLitePersistentCookieStore::~SQLitePersistentCookieStore() {
   backend_->Close();
   // We release our reference to the Backend, though it will probably still have
@@ -1306,6 +1340,8 @@ net::CookieStore* CreateCookieStore(const CookieStoreConfig& config) {
              CookieStoreConfig::RESTORED_SESSION_COOKIES),
             config.storage_policy,
             config.crypto_delegate);
+    if (config.commit_interval != base::TimeDelta())
+      persistent_store->SetCommitInterval(config.commit_interval);
 
     cookie_monster =
         new net::CookieMonster(persistent_store, config.cookie_delegate);
@@ -21,6 +21,7 @@ class Task;
 namespace base {
 class FilePath;
 class SequencedTaskRunner;
+class TimeDelta;
 }
 
 namespace net {
@@ -63,6 +64,10 @@ class CONTENT_EXPORT SQLitePersistentCookieStore
   virtual void SetForceKeepSessionState() OVERRIDE;
   virtual void Flush(const base::Closure& callback) OVERRIDE;
 
+  // Sets how long changes may be batched before they are committed to the
+  // database. Must be called before any cookies are changed.
+  void SetCommitInterval(const base::TimeDelta& commit_interval);
+
  protected:
    virtual ~SQLitePersistentCookieStore();
 
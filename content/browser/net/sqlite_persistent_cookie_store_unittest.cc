@@ -358,6 +358,40 @@ TEST_F(SQLitePersistentCookieStoreTest, TestFlush) {
   ASSERT_GT(info.size, base_size);
 }
 
+// Test that only the last of several access time updates in a batch is
+// written, and that updates to a cookie deleted later in the batch are dropped.
+TEST_F(SQLitePersistentCookieStoreTest, TestCoalesceAccessTimeUpdates) {
+  InitializeStore(false, false);
+  base::Time creation = base::Time::Now();
+  AddCookie("A", "B", "foo.bar", "/", creation);
+  AddCookie("C", "D", "foo.bar", "/",
+            creation + base::TimeDelta::FromMicroseconds(1));
+  Flush();
+
+  base::Time last_access;
+  for (int i = 1; i <= 3; ++i) {
+    last_access = creation + base::TimeDelta::FromSeconds(i);
+    store_->UpdateCookieAccessTime(
+        net::CanonicalCookie(GURL(), "A", "B", "foo.bar", "/", creation,
+                             creation, last_access, false, false,
+                             net::COOKIE_PRIORITY_DEFAULT));
+  }
+  net::CanonicalCookie deleted(
+      GURL(), "C", "D", "foo.bar", "/",
+      creation + base::TimeDelta::FromMicroseconds(1), creation, last_access,
+      false, false, net::COOKIE_PRIORITY_DEFAULT);
+  store_->UpdateCookieAccessTime(deleted);
+  store_->DeleteCookie(deleted);
+  DestroyStore();
+
+  CanonicalCookieVector cookies;
+  CreateAndLoad(false, false, &cookies);
+  ASSERT_EQ(1U, cookies.size());
+  EXPECT_EQ("A", cookies[0]->Name());
+  EXPECT_EQ(last_access, cookies[0]->LastAccessDate());
+  STLDeleteElements(&cookies);
+}
+
 // Test loading old session cookies from the disk.
 TEST_F(SQLitePersistentCookieStoreTest, TestLoadOldSessionCookies) {
   InitializeStore(false, true);
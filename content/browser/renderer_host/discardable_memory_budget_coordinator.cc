@@ -0,0 +1,146 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/discardable_memory_budget_coordinator.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/sys_info.h"
+#include "content/common/view_messages.h"
+#include "content/public/browser/render_process_host.h"
+
+namespace content {
+namespace {
+
+const size_t kMinTotalBudget = 128 * 1024 * 1024;
+const size_t kMaxTotalBudget = 1024 * 1024 * 1024;
+const size_t kMaxProcessBudget = 64 * 1024 * 1024;
+const size_t kMinHiddenProcessBudget = 4 * 1024 * 1024;
+
+// How long a memory pressure signal keeps the total budget reduced.
+const int kPressureRecoverySeconds = 60;
+
+size_t DefaultTotalBudget() {
+  const int64 budget = base::SysInfo::AmountOfPhysicalMemory() / 8;
+  return static_cast<size_t>(
+      std::max<int64>(kMinTotalBudget,
+                      std::min<int64>(kMaxTotalBudget, budget)));
+}
+
+}  // namespace
+
+DiscardableMemoryBudgetCoordinator*
+DiscardableMemoryBudgetCoordinator::GetInstance() {
+  return Singleton<DiscardableMemoryBudgetCoordinator>::get();
+}
+
+void DiscardableMemoryBudgetCoordinator::ProcessLaunched(int render_process_id,
+                                                         bool backgrounded) {
+  ProcessBackgrounded(render_process_id, backgrounded);
+}
+
+void DiscardableMemoryBudgetCoordinator::ProcessBackgrounded(
+    int render_process_id,
+    bool backgrounded) {
+  const bool was_visible =
+      std::find(visible_processes_.begin(), visible_processes_.end(),
+                render_process_id) != visible_processes_.end();
+  const bool was_hidden =
+      std::find(hidden_processes_.begin(), hidden_processes_.end(),
+                render_process_id) != hidden_processes_.end();
+  if ((was_visible && !backgrounded) || (was_hidden && backgrounded))
+    return;
+
+  visible_processes_.remove(render_process_id);
+  hidden_processes_.remove(render_process_id);
+  if (backgrounded)
+    hidden_processes_.push_front(render_process_id);
+  else
+    visible_processes_.push_back(render_process_id);
+  Rebalance();
+}
+
+void DiscardableMemoryBudgetCoordinator::ProcessGone(int render_process_id) {
+  const size_t count = visible_processes_.size() + hidden_processes_.size();
+  visible_processes_.remove(render_process_id);
+  hidden_processes_.remove(render_process_id);
+  sent_budgets_.erase(render_process_id);
+  if (visible_processes_.size() + hidden_processes_.size() != count)
+    Rebalance();
+}
+
+// static
+void DiscardableMemoryBudgetCoordinator::ComputeBudgets(
+    size_t total_budget,
+    size_t visible_count,
+    size_t hidden_count,
+    std::vector<size_t>* budgets) {
+  budgets->clear();
+
+  size_t remaining = total_budget;
+  if (visible_count) {
+    const size_t visible_budget =
+        std::min(kMaxProcessBudget, total_budget / 2 / visible_count);
+    budgets->assign(visible_count, visible_budget);
+    remaining -= visible_budget * visible_count;
+  }
+
+  for (size_t i = 0; i < hidden_count; ++i) {
+    size_t budget = std::min(kMaxProcessBudget, remaining / 2);
+    remaining -= budget;
+    budgets->push_back(std::max(kMinHiddenProcessBudget, budget));
+  }
+}
+
+DiscardableMemoryBudgetCoordinator::DiscardableMemoryBudgetCoordinator()
+    : default_total_budget_(DefaultTotalBudget()),
+      total_budget_(default_total_budget_) {
+  memory_pressure_listener_.reset(new base::MemoryPressureListener(
+      base::Bind(&DiscardableMemoryBudgetCoordinator::OnMemoryPressure,
+                 base::Unretained(this))));
+}
+
+DiscardableMemoryBudgetCoordinator::~DiscardableMemoryBudgetCoordinator() {}
+
+void DiscardableMemoryBudgetCoordinator::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  total_budget_ =
+      level == base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL ?
+          default_total_budget_ / 4 : default_total_budget_ / 2;
+  restore_timer_.Start(
+      FROM_HERE, base::TimeDelta::FromSeconds(kPressureRecoverySeconds),
+      this, &DiscardableMemoryBudgetCoordinator::RestoreTotalBudget);
+  Rebalance();
+}
+
+void DiscardableMemoryBudgetCoordinator::RestoreTotalBudget() {
+  total_budget_ = default_total_budget_;
+  Rebalance();
+}
+
+void DiscardableMemoryBudgetCoordinator::Rebalance() {
+  std::vector<size_t> budgets;
+  ComputeBudgets(total_budget_, visible_processes_.size(),
+                 hidden_processes_.size(), &budgets);
+
+  std::vector<size_t>::const_iterator budget = budgets.begin();
+  std::list<int> processes(visible_processes_);
+  processes.insert(processes.end(), hidden_processes_.begin(),
+                   hidden_processes_.end());
+  for (std::list<int>::const_iterator it = processes.begin();
+       it != processes.end(); ++it, ++budget) {
+    std::map<int, size_t>::iterator sent = sent_budgets_.find(*it);
+    if (sent != sent_budgets_.end() && sent->second == *budget)
+      continue;
+    RenderProcessHost* host = RenderProcessHost::FromID(*it);
+    if (!host)
+      continue;
+    sent_budgets_[*it] = *budget;
+    host->Send(new ViewMsg_SetDiscardableMemoryLimit(*budget));
+  }
+}
+
+}  // namespace content
@@ -0,0 +1,75 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_BROWSER_RENDERER_HOST_DISCARDABLE_MEMORY_BUDGET_COORDINATOR_H_
+#define CONTENT_BROWSER_RENDERER_HOST_DISCARDABLE_MEMORY_BUDGET_COORDINATOR_H_
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/singleton.h"
+#include "base/timer/timer.h"
+#include "content/common/content_export.h"
+
+namespace content {
+
+// Splits a browser-wide budget for emulated discardable memory between the
+// renderer processes, so that a renderer holding decoded images for a
+// background tab gives them up before the one the user is looking at. Each
+// renderer purges its own memory in LRU order once it exceeds the limit it
+// was sent; this class only decides what those limits are. Lives on the UI
+// thread.
+class CONTENT_EXPORT DiscardableMemoryBudgetCoordinator {
+ public:
+  static DiscardableMemoryBudgetCoordinator* GetInstance();
+
+  void ProcessLaunched(int render_process_id, bool backgrounded);
+  void ProcessBackgrounded(int render_process_id, bool backgrounded);
+  void ProcessGone(int render_process_id);
+
+  // Fills |budgets| with |visible_count| budgets for the foreground processes
+  // followed by |hidden_count| budgets for the background processes, most
+  // recently hidden first. Foreground processes share half of |total_budget|;
+  // each background process gets half of what the more recently hidden ones
+  // left over, but never less than a small floor.
+  static void ComputeBudgets(size_t total_budget,
+                             size_t visible_count,
+                             size_t hidden_count,
+                             std::vector<size_t>* budgets);
+
+ private:
+  friend struct DefaultSingletonTraits<DiscardableMemoryBudgetCoordinator>;
+
+  DiscardableMemoryBudgetCoordinator();
+  ~DiscardableMemoryBudgetCoordinator();
+
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+  void RestoreTotalBudget();
+
+  // Recomputes every budget and sends the ones that changed.
+  void Rebalance();
+
+  std::list<int> visible_processes_;
+  // Most recently hidden first.
+  std::list<int> hidden_processes_;
+  // The last budget sent to each process.
+  std::map<int, size_t> sent_budgets_;
+
+  size_t default_total_budget_;
+  size_t total_budget_;
+
+  scoped_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+  base::OneShotTimer<DiscardableMemoryBudgetCoordinator> restore_timer_;
+
+  DISALLOW_COPY_AND_ASSIGN(DiscardableMemoryBudgetCoordinator);
+};
+
+}  // namespace content
+
+#endif  // CONTENT_BROWSER_RENDERER_HOST_DISCARDABLE_MEMORY_BUDGET_COORDINATOR_H_
@@ -0,0 +1,45 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/browser/renderer_host/discardable_memory_budget_coordinator.h"
+
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace content {
+
+const size_t kMB = 1024 * 1024;
+
+TEST(DiscardableMemoryBudgetCoordinatorTest, VisibleShareHalf) {
+  std::vector<size_t> budgets;
+  DiscardableMemoryBudgetCoordinator::ComputeBudgets(256 * kMB, 2, 0,
+                                                     &budgets);
+  ASSERT_EQ(2u, budgets.size());
+  EXPECT_EQ(64 * kMB, budgets[0]);
+  EXPECT_EQ(64 * kMB, budgets[1]);
+
+  // A single visible process is capped.
+  DiscardableMemoryBudgetCoordinator::ComputeBudgets(256 * kMB, 1, 0,
+                                                     &budgets);
+  ASSERT_EQ(1u, budgets.size());
+  EXPECT_EQ(64 * kMB, budgets[0]);
+}
+
+TEST(DiscardableMemoryBudgetCoordinatorTest, HiddenDecayByRecency) {
+  std::vector<size_t> budgets;
+  DiscardableMemoryBudgetCoordinator::ComputeBudgets(128 * kMB, 1, 6,
+                                                     &budgets);
+  ASSERT_EQ(7u, budgets.size());
+  EXPECT_EQ(64 * kMB, budgets[0]);
+  EXPECT_EQ(32 * kMB, budgets[1]);
+  EXPECT_EQ(16 * kMB, budgets[2]);
+  EXPECT_EQ(8 * kMB, budgets[3]);
+  EXPECT_EQ(4 * kMB, budgets[4]);
+  // The least recently hidden processes keep the floor.
+  EXPECT_EQ(4 * kMB, budgets[5]);
+  EXPECT_EQ(4 * kMB, budgets[6]);
+}
+
+}  // namespace content
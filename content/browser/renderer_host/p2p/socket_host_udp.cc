@@ -22,6 +22,9 @@ namespace {
 const int kReadBufferSize = 65536;
 // Socket receive buffer size.
 const int kRecvSocketBufferSize = 65536;  // 64K
+// Maximum number of packets forwarded to the renderer in one IPC message.
+// Bounds the delay added to the first packet of a burst.
+const size_t kMaxPacketsPerBatch = 32;
 
 // Defines set of transient errors. These errors are ignored when we get them
 // from sendto() or recvfrom() calls.
@@ -73,6 +76,19 @@ P2PSocketHostUdp::PendingPacket::PendingPacket(
 P2PSocketHostUdp::PendingPacket::~PendingPacket() {
 }
 
+P2PSocketHostUdp::ReceivedPacket::ReceivedPacket(
+    const net::IPEndPoint& from,
+    const char* data,
+    int size,
+    const base::TimeTicks& timestamp)
+    : from(from),
+      data(data, data + size),
+      timestamp(timestamp) {
+}
+
+P2PSocketHostUdp::ReceivedPacket::~ReceivedPacket() {
+}
+
 P2PSocketHostUdp::P2PSocketHostUdp(IPC::Sender* message_sender,
                                    int id,
                                    P2PMessageThrottler* throttler)
@@ -128,6 +144,12 @@ bool P2PSocketHostUdp::Init(const net::IPEndPoint& local_address,
 }
 
 void P2PSocketHostUdp::OnError() {
+  // Deliver what was read before the error, while the renderer still
+  // considers the socket open.
+  if (state_ == STATE_OPEN)
+    FlushReceivedPackets();
+  received_packets_.clear();
+
   socket_.reset();
   send_queue_.clear();
 
@@ -138,6 +160,8 @@ void P2PSocketHostUdp::OnError() {
 }
 
 void P2PSocketHostUdp::DoRead() {
+  // Drain the packets that are already queued on the socket, forwarding them
+  // to the renderer in as few messages as possible.
   int result;
   do {
     result = socket_->RecvFrom(
@@ -146,9 +170,13 @@ void P2PSocketHostUdp::DoRead() {
         &recv_address_,
         base::Bind(&P2PSocketHostUdp::OnRecv, base::Unretained(this)));
     if (result == net::ERR_IO_PENDING)
-      return;
+      break;
     HandleReadResult(result);
+    if (received_packets_.size() >= kMaxPacketsPerBatch)
+      FlushReceivedPackets();
   } while (state_ == STATE_OPEN);
+
+  FlushReceivedPackets();
 }
 
 void P2PSocketHostUdp::OnRecv(int result) {
@@ -162,11 +190,9 @@ void P2PSocketHostUdp::HandleReadResult(int result) {
   DCHECK_EQ(STATE_OPEN, state_);
 
   if (result > 0) {
-    std::vector<char> data(recv_buffer_->data(), recv_buffer_->data() + result);
-
     if (!ContainsKey(connected_peers_, recv_address_)) {
       P2PSocketHost::StunMessageType type;
-      bool stun = GetStunPacketType(&*data.begin(), data.size(), &type);
+      bool stun = GetStunPacketType(recv_buffer_->data(), result, &type);
       if ((stun && IsRequestOrResponse(type)) || AllowUDPWithoutSTUN()) {
         connected_peers_.insert(recv_address_);
       } else if (!stun || type == STUN_DATA_INDICATION) {
@@ -177,14 +203,34 @@ void P2PSocketHostUdp::HandleReadResult(int result) {
       }
     }
 
-    message_sender_->Send(new P2PMsg_OnDataReceived(
-        id_, recv_address_, data, base::TimeTicks::Now()));
+    received_packets_.push_back(ReceivedPacket(
+        recv_address_, recv_buffer_->data(), result, base::TimeTicks::Now()));
   } else if (result < 0 && !IsTransientError(result)) {
     LOG(ERROR) << "Error when reading from UDP socket: " << result;
     OnError();
   }
 }
 
+void P2PSocketHostUdp::FlushReceivedPackets() {
+  if (received_packets_.empty())
+    return;
+
+  if (received_packets_.size() == 1) {
+    const ReceivedPacket& packet = received_packets_.front();
+    message_sender_->Send(new P2PMsg_OnDataReceived(
+        id_, packet.from, packet.data, packet.timestamp));
+  } else {
+    std::vector<P2PMsg_ReceivedPacket> packets(received_packets_.size());
+    for (size_t i = 0; i < received_packets_.size(); ++i) {
+      packets[i].address = received_packets_[i].from;
+      packets[i].data.swap(received_packets_[i].data);
+      packets[i].timestamp = received_packets_[i].timestamp;
+    }
+    message_sender_->Send(new P2PMsg_OnDataReceivedBatch(id_, packets));
+  }
+  received_packets_.clear();
+}
+
 void P2PSocketHostUdp::Send(const net::IPEndPoint& to,
                             const std::vector<char>& data,
                             const talk_base::PacketOptions& options,
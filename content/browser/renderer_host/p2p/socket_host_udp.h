@@ -13,6 +13,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop.h"
+#include "base/time/time.h"
 #include "content/browser/renderer_host/p2p/socket_host.h"
 #include "content/common/content_export.h"
 #include "content/public/common/p2p_socket_type.h"
@@ -59,12 +60,26 @@ class CONTENT_EXPORT P2PSocketHostUdp : public P2PSocketHost {
     uint64 id;
   };
 
+  struct ReceivedPacket {
+    ReceivedPacket(const net::IPEndPoint& from,
+                   const char* data,
+                   int size,
+                   const base::TimeTicks& timestamp);
+    ~ReceivedPacket();
+    net::IPEndPoint from;
+    std::vector<char> data;
+    base::TimeTicks timestamp;
+  };
+
   void OnError();
 
   void DoRead();
   void OnRecv(int result);
   void HandleReadResult(int result);
 
+  // Sends the packets collected by HandleReadResult() to the renderer.
+  void FlushReceivedPackets();
+
   void DoSend(const PendingPacket& packet);
   void OnSend(uint64 packet_id, int result);
   void HandleSendResult(uint64 packet_id, int result);
@@ -72,6 +87,8 @@ class CONTENT_EXPORT P2PSocketHostUdp : public P2PSocketHost {
   scoped_ptr<net::DatagramServerSocket> socket_;
   scoped_refptr<net::IOBuffer> recv_buffer_;
   net::IPEndPoint recv_address_;
+  // Packets read since the last FlushReceivedPackets().
+  std::vector<ReceivedPacket> received_packets_;
 
   std::deque<PendingPacket> send_queue_;
   bool send_pending_;
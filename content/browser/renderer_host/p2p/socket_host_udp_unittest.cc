@@ -116,6 +116,12 @@ class FakeDatagramServerSocket : public net::DatagramServerSocket {
     }
   }
 
+  // Queues a packet that is returned by a later RecvFrom(), without
+  // completing a pending one.
+  void QueuePacket(const net::IPEndPoint& address, std::vector<char> data) {
+    incoming_packets_.push_back(UDPPacket(address, data));
+  }
+
   virtual const net::BoundNetLog& NetLog() const OVERRIDE {
     return net_log_;
   }
@@ -172,6 +178,14 @@ class FakeDatagramServerSocket : public net::DatagramServerSocket {
   net::CompletionCallback recv_callback_;
 };
 
+MATCHER_P(MatchPacketBatchMessage, packet_count, "") {
+  if (arg->type() != P2PMsg_OnDataReceivedBatch::ID)
+    return false;
+  P2PMsg_OnDataReceivedBatch::Param params;
+  P2PMsg_OnDataReceivedBatch::Read(arg, &params);
+  return params.b.size() == packet_count;
+}
+
 }  // namespace
 
 namespace content {
@@ -382,4 +396,24 @@ TEST_F(P2PSocketHostUdpTest, ThrottleAfterLimitAfterReceive) {
   ASSERT_EQ(sent_packets_.size(), 4U);
 }
 
+// Verify that packets that are already queued on the socket reach the
+// renderer in a single message.
+TEST_F(P2PSocketHostUdpTest, ReceiveBatch) {
+  std::vector<char> packet1;
+  CreateStunRequest(&packet1);
+  std::vector<char> packet2;
+  CreateStunResponse(&packet2);
+  socket_->QueuePacket(dest1_, packet1);
+  socket_->QueuePacket(dest2_, packet2);
+
+  EXPECT_CALL(sender_, Send(MatchPacketBatchMessage(3U)))
+      .WillOnce(DoAll(DeleteArg<0>(), Return(true)));
+  socket_->ReceivePacket(dest1_, packet2);
+
+  // A packet that arrives on its own is forwarded on its own.
+  EXPECT_CALL(sender_, Send(MatchPacketMessage(packet1)))
+      .WillOnce(DoAll(DeleteArg<0>(), Return(true)));
+  socket_->ReceivePacket(dest2_, packet1);
+}
+
 }  // namespace content
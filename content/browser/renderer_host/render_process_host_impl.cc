@@ -69,6 +69,7 @@
 #include "content/browser/quota_dispatcher_host.h"
 #include "content/browser/renderer_host/clipboard_message_filter.h"
 #include "content/browser/renderer_host/database_message_filter.h"
+#include "content/browser/renderer_host/discardable_memory_budget_coordinator.h"
 #include "content/browser/renderer_host/file_utilities_message_filter.h"
 #include "content/browser/renderer_host/gamepad_browser_message_filter.h"
 #include "content/browser/renderer_host/gpu_message_filter.h"
@@ -109,6 +110,7 @@
 #include "content/common/child_process_messages.h"
 #include "content/common/content_switches_internal.h"
 #include "content/common/gpu/gpu_messages.h"
+#include "content/common/input/ipc_priority_lanes.h"
 #include "content/common/resource_messages.h"
 #include "content/common/view_messages.h"
 #include "content/port/browser/render_widget_host_view_frame_subscriber.h"
@@ -521,6 +523,7 @@ bool RenderProcessHostImpl::Init() {
                                 this,
                                 BrowserThread::GetMessageLoopProxyForThread(
                                     BrowserThread::IO).get()));
+  AddIPCPriorityLanes(channel_.get());
 
   // Call the embedder first so that their IPC filters have priority.
   GetContentClient()->browser()->RenderProcessWillLaunch(this);
@@ -1025,8 +1028,10 @@ void RenderProcessHostImpl::PropagateBrowserCommandLineToRenderer(
     switches::kEnableHighDpiCompositingForFixedPosition,
     switches::kEnableHTMLImports,
     switches::kEnableInbandTextTracks,
+    switches::kEnableIPCPriorityLanes,
     switches::kEnableLayerSquashing,
     switches::kEnableLogging,
+    switches::kEnableLowLatencyAudioRendering,
     switches::kEnableMP3StreamParser,
     switches::kEnableMemoryBenchmarking,
     switches::kEnableOverlayFullscreenVideo,
@@ -1101,10 +1106,16 @@ void RenderProcessHostImpl::PropagateBrowserCommandLineToRenderer(
     cc::switches::kEnableGpuBenchmarking,
     cc::switches::kEnableGPURasterization,
     cc::switches::kEnableImplSidePainting,
+    cc::switches::kEnableIncrementalDrawProperties,
     cc::switches::kEnableLCDText,
+    cc::switches::kEnableMainFrameBeforeActivation,
     cc::switches::kEnableMapImage,
+    cc::switches::kEnableOcclusionForTilePrioritization,
     cc::switches::kEnablePinchVirtualViewport,
+    cc::switches::kEnableRecordingSharing,
+    cc::switches::kEnableRenderPassCaching,
     cc::switches::kEnableTopControlsPositionCalculation,
+    cc::switches::kMaxRecordedBytesPerLayer,
     cc::switches::kMaxTilesForInterestArea,
     cc::switches::kMaxUnusedResourceMemoryUsagePercentage,
     cc::switches::kShowCompositedLayerBorders,
@@ -1122,6 +1133,7 @@ void RenderProcessHostImpl::PropagateBrowserCommandLineToRenderer(
     cc::switches::kTopControlsHideThreshold,
     cc::switches::kTopControlsShowThreshold,
     cc::switches::kTraceOverdraw,
+    cc::switches::kVerifyIncrementalDrawProperties,
 #if defined(ENABLE_PLUGINS)
     switches::kEnablePepperTesting,
 #endif
@@ -1452,6 +1464,7 @@ void RenderProcessHostImpl::Cleanup() {
     DCHECK(!deleting_soon_);
 
     DCHECK_EQ(0, pending_views_);
+    DiscardableMemoryBudgetCoordinator::GetInstance()->ProcessGone(GetID());
     FOR_EACH_OBSERVER(RenderProcessHostObserver,
                       observers_,
                       RenderProcessHostDestroyed(this));
@@ -1856,6 +1869,7 @@ void RenderProcessHostImpl::ProcessDied(bool already_dead) {
                     RenderProcessExited(this, GetHandle(), status, exit_code));
   within_process_died_observer_ = false;
 
+  DiscardableMemoryBudgetCoordinator::GetInstance()->ProcessGone(GetID());
   child_process_launcher_.reset();
   channel_.reset();
   gpu_message_filter_ = NULL;
@@ -1970,6 +1984,8 @@ void RenderProcessHostImpl::SetBackgrounded(bool backgrounded) {
 #endif  // OS_WIN
 
   child_process_launcher_->SetProcessBackgrounded(backgrounded);
+  DiscardableMemoryBudgetCoordinator::GetInstance()->ProcessBackgrounded(
+      GetID(), backgrounded);
 }
 
 void RenderProcessHostImpl::OnProcessLaunched() {
@@ -1989,6 +2005,13 @@ void RenderProcessHostImpl::OnProcessLaunched() {
     child_process_launcher_->SetProcessBackgrounded(backgrounded_);
   }
 
+  // Renderers sharing the browser process also share its discardable memory,
+  // so there is nothing to balance for them.
+  if (!run_renderer_in_process()) {
+    DiscardableMemoryBudgetCoordinator::GetInstance()->ProcessLaunched(
+        GetID(), backgrounded_);
+  }
+
   // NOTE: This needs to be before sending queued messages because
   // ExtensionService uses this notification to initialize the renderer process
   // with state that must be there before any JavaScript executes.
@@ -234,6 +234,14 @@ RenderViewHostImpl::RenderViewHostImpl(
         base::Bind(&ResourceDispatcherHostImpl::OnRenderViewHostCreated,
                    base::Unretained(ResourceDispatcherHostImpl::Get()),
                    GetProcess()->GetID(), GetRoutingID()));
+    if (hidden) {
+      BrowserThread::PostTask(
+          BrowserThread::IO, FROM_HERE,
+          base::Bind(
+              &ResourceDispatcherHostImpl::OnRenderViewHostVisibilityChanged,
+              base::Unretained(ResourceDispatcherHostImpl::Get()),
+              GetProcess()->GetID(), GetRoutingID(), false));
+    }
   }
 
 #if defined(OS_ANDROID)
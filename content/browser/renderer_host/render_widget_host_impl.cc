@@ -30,6 +30,7 @@
 #include "content/browser/gpu/gpu_process_host.h"
 #include "content/browser/gpu/gpu_process_host_ui_shim.h"
 #include "content/browser/gpu/gpu_surface_tracker.h"
+#include "content/browser/loader/resource_dispatcher_host_impl.h"
 #include "content/browser/renderer_host/backing_store.h"
 #include "content/browser/renderer_host/backing_store_manager.h"
 #include "content/browser/renderer_host/dip_util.h"
@@ -62,6 +63,7 @@
 #include "third_party/WebKit/public/web/WebCompositionUnderline.h"
 #include "ui/events/event.h"
 #include "ui/events/keycodes/keyboard_codes.h"
+#include "ui/gfx/rect_conversions.h"
 #include "ui/gfx/size_conversions.h"
 #include "ui/gfx/skbitmap_operations.h"
 #include "ui/gfx/vector2d_conversions.h"
@@ -555,6 +557,8 @@ void RenderWidgetHostImpl::WasHidden() {
   // Tell the RenderProcessHost we were hidden.
   process_->WidgetHidden();
 
+  NotifyResourceSchedulerOfVisibility(false);
+
   bool is_visible = false;
   NotificationService::current()->Notify(
       NOTIFICATION_RENDER_WIDGET_VISIBILITY_CHANGED,
@@ -562,6 +566,18 @@ void RenderWidgetHostImpl::WasHidden() {
       Details<bool>(&is_visible));
 }
 
+void RenderWidgetHostImpl::NotifyResourceSchedulerOfVisibility(
+    bool is_visible) {
+  // The ResourceScheduler tracks a client per view, not per widget.
+  if (!IsRenderView() || !ResourceDispatcherHostImpl::Get())
+    return;
+  BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&ResourceDispatcherHostImpl::OnRenderViewHostVisibilityChanged,
+                 base::Unretained(ResourceDispatcherHostImpl::Get()),
+                 process_->GetID(), routing_id_, is_visible));
+}
+
 void RenderWidgetHostImpl::WasShown() {
   if (!is_hidden_)
     return;
@@ -586,6 +602,8 @@ void RenderWidgetHostImpl::WasShown() {
 
   process_->WidgetRestored();
 
+  NotifyResourceSchedulerOfVisibility(true);
+
   bool is_visible = true;
   NotificationService::current()->Notify(
       NOTIFICATION_RENDER_WIDGET_VISIBILITY_CHANGED,
@@ -1514,12 +1532,34 @@ bool RenderWidgetHostImpl::OnSwapCompositorFrame(
   uint32 output_surface_id = param.a;
   param.b.AssignTo(frame.get());
 
-  for (size_t i = 0; i < frame->metadata.latency_info.size(); i++)
-    AddLatencyInfoComponentIds(&frame->metadata.latency_info[i]);
+  base::TimeTicks now = base::TimeTicks::Now();
+  for (size_t i = 0; i < frame->metadata.latency_info.size(); i++) {
+    ui::LatencyInfo* latency_info = &frame->metadata.latency_info[i];
+    AddLatencyInfoComponentIds(latency_info);
+
+    // This UMA metric tracks the time from when an input event is forwarded
+    // to the renderer to when a frame it caused gets back to the browser,
+    // which includes the time both spent in IPC queues.
+    ui::LatencyInfo::LatencyComponent rwh_component;
+    if (latency_info->FindLatency(ui::INPUT_EVENT_LATENCY_BEGIN_RWH_COMPONENT,
+                                  GetLatencyComponentId(),
+                                  &rwh_component)) {
+      UMA_HISTOGRAM_CUSTOM_COUNTS(
+          "Event.Latency.Browser.InputToFrame",
+          (now - rwh_component.event_time).InMicroseconds(),
+          1,
+          1000000,
+          100);
+    }
+  }
 
   input_router_->OnViewUpdated(
       GetInputRouterViewFlagsFromCompositorFrameMetadata(frame->metadata));
 
+  // Once the renderer composites, the views draw its frames instead of the
+  // backing store, so keeping it around only holds on to memory.
+  BackingStoreManager::RemoveBackingStore(this);
+
   if (view_) {
     view_->OnSwapCompositorFrame(output_surface_id, frame.Pass());
     view_->DidReceiveRendererFrame();
@@ -1903,6 +1943,17 @@ bool RenderWidgetHostImpl::PaintBackingStoreRect(
     return false;
   }
 
+  size_t bytes_copied = 0;
+  for (size_t i = 0; i < copy_rects.size(); ++i) {
+    bytes_copied += gfx::ToEnclosingRect(
+        gfx::ScaleRect(copy_rects[i], scale_factor)).size().GetArea() * 4;
+  }
+  UMA_HISTOGRAM_CUSTOM_COUNTS("MPArch.RWH_BackingStoreCopiedKBPerFrame",
+                              bytes_copied / 1024,
+                              1,
+                              64 * 1024,
+                              50);
+
   bool needs_full_paint = false;
   bool scheduled_completion_callback = false;
   BackingStoreManager::PrepareBackingStore(this, view_size, bitmap, bitmap_rect,
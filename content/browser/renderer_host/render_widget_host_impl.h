@@ -654,6 +654,10 @@ class CONTENT_EXPORT RenderWidgetHostImpl : virtual public RenderWidgetHost,
   // NotifyRendererResponsive.
   void RendererIsResponsive();
 
+  // Tells the ResourceScheduler on the IO thread whether this view is visible,
+  // so that hidden tabs load fewer resources at once.
+  void NotifyResourceSchedulerOfVisibility(bool is_visible);
+
   // IPC message handlers
   void OnRenderViewReady();
   void OnRenderProcessGone(int status, int error_code);
@@ -9,6 +9,7 @@
 #include "base/command_line.h"
 #include "base/lazy_instance.h"
 #include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram.h"
 #include "base/run_loop.h"
 #include "base/sequenced_task_runner.h"
 #include "base/strings/utf_string_conversions.h"
@@ -51,6 +52,24 @@ private:
 };
 #endif
 
+namespace {
+
+#if defined(OS_LINUX)
+const int kDefaultChildFlags = ChildProcessHost::CHILD_ALLOW_SELF;
+#else
+const int kDefaultChildFlags = ChildProcessHost::CHILD_NORMAL;
+#endif
+
+// How long after a spare-compatible utility process starts before the spare
+// is replaced, so that the replacement launch does not compete with the task
+// the previous spare was just given.
+const int kSpareProcessRefillDelayMs = 2000;
+
+// The warm utility process waiting to be adopted. Only touched on the IO
+// thread.
+UtilityProcessHostImpl* g_spare_utility_process = NULL;
+
+}  // namespace
 
 UtilityMainThreadFactoryFunction g_utility_main_thread_factory = NULL;
 
@@ -76,16 +95,14 @@ UtilityProcessHostImpl::UtilityProcessHostImpl(
 #if defined(OS_WIN)
       run_elevated_(false),
 #endif
-#if defined(OS_LINUX)
-      child_flags_(ChildProcessHost::CHILD_ALLOW_SELF),
-#else
-      child_flags_(ChildProcessHost::CHILD_NORMAL),
-#endif
+      child_flags_(kDefaultChildFlags),
       started_(false) {
 }
 
 UtilityProcessHostImpl::~UtilityProcessHostImpl() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (g_spare_utility_process == this)
+    g_spare_utility_process = NULL;
   if (is_batch_mode_)
     EndBatchMode();
 }
@@ -141,6 +158,23 @@ void UtilityProcessHostImpl::SetEnv(const base::EnvironmentMap& env) {
 
 #endif  // OS_POSIX
 
+// static
+void UtilityProcessHostImpl::LaunchSpareProcess() {
+  DCHECK(BrowserThread::CurrentlyOn(BrowserThread::IO));
+  if (g_spare_utility_process)
+    return;
+
+  // The spare has no client, so it never tries to adopt a spare itself. If the
+  // launch fails later on, BrowserChildProcessHostImpl deletes the spare,
+  // which clears |g_spare_utility_process|.
+  UtilityProcessHostImpl* spare = new UtilityProcessHostImpl(NULL, NULL);
+  if (!spare->StartProcess()) {
+    delete spare;
+    return;
+  }
+  g_spare_utility_process = spare;
+}
+
 bool UtilityProcessHostImpl::StartProcess() {
   if (started_)
     return true;
@@ -149,6 +183,22 @@ bool UtilityProcessHostImpl::StartProcess() {
   if (is_batch_mode_)
     return true;
 
+  start_time_ = base::TimeTicks::Now();
+
+  if (CanUseSpareProcess()) {
+    bool adopted = AdoptSpareProcess();
+    UMA_HISTOGRAM_BOOLEAN("ChildProcess.UtilitySpareProcessUsed", adopted);
+
+    // Refill the pool in the background, whether or not there was a spare to
+    // take this time.
+    BrowserThread::PostDelayedTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&UtilityProcessHostImpl::LaunchSpareProcess),
+        base::TimeDelta::FromMilliseconds(kSpareProcessRefillDelayMs));
+    if (adopted)
+      return true;
+  }
+
   // Name must be set or metrics_service will crash in any test which
   // launches a UtilityProcessHost.
   process_.reset(new BrowserChildProcessHostImpl(PROCESS_TYPE_UTILITY, this));
@@ -248,7 +298,45 @@ bool UtilityProcessHostImpl::StartProcess() {
   return true;
 }
 
+bool UtilityProcessHostImpl::CanUseSpareProcess() const {
+  if (!client_.get() || RenderProcessHost::run_renderer_in_process())
+    return false;
+
+  const CommandLine& browser_command_line = *CommandLine::ForCurrentProcess();
+  if (!browser_command_line.HasSwitch(switches::kEnableSpareUtilityProcess))
+    return false;
+#if defined(OS_POSIX)
+  if (browser_command_line.HasSwitch(switches::kUtilityCmdPrefix) ||
+      !env_.empty()) {
+    return false;
+  }
+#endif
+
+  // ElevatePrivileges() also sets |no_sandbox_|.
+  return exposed_dir_.empty() && !is_mdns_enabled_ && !no_sandbox_ &&
+      child_flags_ == kDefaultChildFlags;
+}
+
+bool UtilityProcessHostImpl::AdoptSpareProcess() {
+  UtilityProcessHostImpl* spare = g_spare_utility_process;
+  if (!spare)
+    return false;
+
+  process_ = spare->process_.Pass();
+  process_->set_delegate(this);
+  delete spare;
+
+  // The spare may have finished launching before it was needed, in which case
+  // no OnProcessLaunched() is coming for this host.
+  if (process_->GetData().handle != base::kNullProcessHandle)
+    OnProcessLaunched();
+  return true;
+}
+
 bool UtilityProcessHostImpl::OnMessageReceived(const IPC::Message& message) {
+  if (!client_.get())
+    return false;
+
   client_task_runner_->PostTask(
       FROM_HERE,
       base::Bind(base::IgnoreResult(
@@ -257,7 +345,20 @@ bool UtilityProcessHostImpl::OnMessageReceived(const IPC::Message& message) {
   return true;
 }
 
+void UtilityProcessHostImpl::OnProcessLaunched() {
+  if (!client_.get())
+    return;
+
+  // Covers the whole wait from StartProcess(), so a host that adopted an
+  // already running spare records (close to) zero.
+  UMA_HISTOGRAM_TIMES("ChildProcess.UtilityLaunchTime",
+                      base::TimeTicks::Now() - start_time_);
+}
+
 void UtilityProcessHostImpl::OnProcessLaunchFailed() {
+  if (!client_.get())
+    return;
+
   client_task_runner_->PostTask(
       FROM_HERE,
       base::Bind(&UtilityProcessHostClient::OnProcessLaunchFailed,
@@ -265,6 +366,9 @@ void UtilityProcessHostImpl::OnProcessLaunchFailed() {
 }
 
 void UtilityProcessHostImpl::OnProcessCrashed(int exit_code) {
+  if (!client_.get())
+    return;
+
   client_task_runner_->PostTask(
       FROM_HERE,
       base::Bind(&UtilityProcessHostClient::OnProcessCrashed, client_.get(),
@@ -14,6 +14,7 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "content/public/browser/browser_child_process_host_delegate.h"
 #include "content/public/browser/utility_process_host.h"
 
@@ -51,12 +52,26 @@ class CONTENT_EXPORT UtilityProcessHostImpl
   void set_child_flags(int flags) { child_flags_ = flags; }
 
  private:
+  // Launches a utility process with default settings and no client, to be
+  // taken over by the next host that can use it. See CanUseSpareProcess().
+  static void LaunchSpareProcess();
+
   // Starts a process if necessary.  Returns true if it succeeded or a process
   // has already been started via StartBatchMode().
   bool StartProcess();
 
+  // Returns true if --enable-spare-utility-process is on and this host would
+  // launch exactly the kind of process the spare is, i.e. none of the sandbox,
+  // environment or child flag settings were changed.
+  bool CanUseSpareProcess() const;
+
+  // Takes over the spare utility process, if there is one. Returns false if
+  // there was no spare.
+  bool AdoptSpareProcess();
+
   // BrowserChildProcessHost:
   virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE;
+  virtual void OnProcessLaunched() OVERRIDE;
   virtual void OnProcessLaunchFailed() OVERRIDE;
   virtual void OnProcessCrashed(int exit_code) OVERRIDE;
 
@@ -88,6 +103,9 @@ class CONTENT_EXPORT UtilityProcessHostImpl
 
   bool started_;
 
+  // When StartProcess() first ran, for the launch time histogram.
+  base::TimeTicks start_time_;
+
   scoped_ptr<BrowserChildProcessHostImpl> process_;
 
   // Used in single-process mode instead of process_.
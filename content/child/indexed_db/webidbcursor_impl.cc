@@ -4,6 +4,7 @@
 
 #include "content/child/indexed_db/webidbcursor_impl.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "content/child/indexed_db/indexed_db_dispatcher.h"
@@ -129,6 +130,20 @@ void WebIDBCursorImpl::SetPrefetchData(
 
   used_prefetches_ = 0;
   pending_onsuccess_callbacks_ = 0;
+
+  // Scale the next request to the observed value size, so that cursors
+  // over large records don't tie up memory (and the IPC channel) with
+  // batches of values the page may never use.
+  size_t value_bytes = 0;
+  for (size_t i = 0; i < values.size(); ++i)
+    value_bytes += values[i].size();
+  if (value_bytes) {
+    size_t average = std::max<size_t>(value_bytes / values.size(), 1);
+    int cap = static_cast<int>(std::min<size_t>(
+        kPrefetchTargetBytes / average, kMaxPrefetchAmount));
+    prefetch_amount_ = std::max<int>(std::min(prefetch_amount_, cap),
+                                     kMinPrefetchAmount);
+  }
 }
 
 void WebIDBCursorImpl::CachedAdvance(unsigned long count,
@@ -55,6 +55,7 @@ class CONTENT_EXPORT WebIDBCursorImpl
   FRIEND_TEST_ALL_PREFIXES(IndexedDBDispatcherTest, CursorTransactionId);
   FRIEND_TEST_ALL_PREFIXES(WebIDBCursorImplTest, AdvancePrefetchTest);
   FRIEND_TEST_ALL_PREFIXES(WebIDBCursorImplTest, PrefetchReset);
+  FRIEND_TEST_ALL_PREFIXES(WebIDBCursorImplTest, PrefetchAdaptsToValueSize);
   FRIEND_TEST_ALL_PREFIXES(WebIDBCursorImplTest, PrefetchTest);
 
   int32 ipc_cursor_id_;
@@ -83,6 +84,9 @@ class CONTENT_EXPORT WebIDBCursorImpl
   enum { kPrefetchContinueThreshold = 2 };
   enum { kMinPrefetchAmount = 5 };
   enum { kMaxPrefetchAmount = 100 };
+  // Once values have been seen, the prefetch amount is also capped so
+  // that a batch holds about this many bytes of values.
+  enum { kPrefetchTargetBytes = 1024 * 1024 };
 };
 
 }  // namespace content
@@ -266,6 +266,45 @@ TEST_F(WebIDBCursorImplTest, AdvancePrefetchTest) {
             dispatcher_->continue_calls());
 }
 
+TEST_F(WebIDBCursorImplTest, PrefetchAdaptsToValueSize) {
+  const int64 transaction_id = 1;
+  WebIDBCursorImpl cursor(WebIDBCursorImpl::kInvalidCursorId,
+                          transaction_id,
+                          thread_safe_sender_.get());
+
+  for (int i = 0; i < WebIDBCursorImpl::kPrefetchContinueThreshold; ++i)
+    cursor.continueFunction(null_key_, new MockContinueCallbacks());
+
+  // Initiate the prefetch.
+  cursor.continueFunction(null_key_, new MockContinueCallbacks());
+  EXPECT_EQ(1, dispatcher_->prefetch_calls());
+  const int prefetch_count = dispatcher_->last_prefetch_count();
+  EXPECT_EQ(static_cast<int>(WebIDBCursorImpl::kMinPrefetchAmount),
+            prefetch_count);
+
+  // Return values so large that only two fit in the target batch size.
+  const std::string large_value(WebIDBCursorImpl::kPrefetchTargetBytes / 2,
+                                'x');
+  std::vector<IndexedDBKey> keys;
+  std::vector<IndexedDBKey> primary_keys(prefetch_count);
+  std::vector<WebData> values;
+  for (int i = 0; i < prefetch_count; ++i) {
+    keys.push_back(IndexedDBKey(i, WebIDBKeyTypeNumber));
+    values.push_back(WebData(large_value.data(), large_value.size()));
+  }
+  cursor.SetPrefetchData(keys, primary_keys, values);
+
+  for (int i = 0; i < prefetch_count; ++i)
+    cursor.continueFunction(null_key_, new MockContinueCallbacks());
+  EXPECT_EQ(1, dispatcher_->prefetch_calls());
+
+  // The next prefetch does not grow, and stays at the minimum.
+  cursor.continueFunction(null_key_, new MockContinueCallbacks());
+  EXPECT_EQ(2, dispatcher_->prefetch_calls());
+  EXPECT_EQ(static_cast<int>(WebIDBCursorImpl::kMinPrefetchAmount),
+            dispatcher_->last_prefetch_count());
+}
+
 TEST_F(WebIDBCursorImplTest, PrefetchReset) {
   const int64 transaction_id = 1;
   WebIDBCursorImpl cursor(WebIDBCursorImpl::kInvalidCursorId,
@@ -454,10 +454,34 @@ void ResourceDispatcher::OnReceivedData(int request_id,
 
     UMA_HISTOGRAM_TIMES("ResourceDispatcher.OnReceivedDataTime",
                         base::TimeTicks::Now() - time_start);
+
+    // The request may have been canceled by the peer.
+    request_info = GetPendingRequestInfo(request_id);
+  }
+
+  if (!request_info) {
+    message_sender()->Send(new ResourceHostMsg_DataReceived_ACK(request_id, 1));
+    return;
   }
 
-  // Acknowledge the reception of this data.
-  message_sender()->Send(new ResourceHostMsg_DataReceived_ACK(request_id));
+  // The browser allocates from its buffer in order, so the unacknowledged data
+  // spans from the first unacknowledged message to the end of this one.
+  // Acknowledging once that is half the buffer keeps the browser from running
+  // out of room, with far fewer ACKs than one per message.
+  if (request_info->first_unacked_data_offset == -1)
+    request_info->first_unacked_data_offset = data_offset;
+  ++request_info->num_unacked_data_messages;
+  int unacked_data_size =
+      data_offset + data_length - request_info->first_unacked_data_offset;
+  if (unacked_data_size <= 0)
+    unacked_data_size += request_info->buffer_size;
+  if (unacked_data_size * 2 < request_info->buffer_size)
+    return;
+
+  message_sender()->Send(new ResourceHostMsg_DataReceived_ACK(
+      request_id, request_info->num_unacked_data_messages));
+  request_info->first_unacked_data_offset = -1;
+  request_info->num_unacked_data_messages = 0;
 }
 
 void ResourceDispatcher::OnDownloadedData(int request_id,
@@ -627,7 +651,9 @@ ResourceDispatcher::PendingRequestInfo::PendingRequestInfo()
     : peer(NULL),
       resource_type(ResourceType::SUB_RESOURCE),
       is_deferred(false),
-      buffer_size(0) {
+      buffer_size(0),
+      first_unacked_data_offset(-1),
+      num_unacked_data_messages(0) {
 }
 
 ResourceDispatcher::PendingRequestInfo::PendingRequestInfo(
@@ -643,7 +669,10 @@ ResourceDispatcher::PendingRequestInfo::PendingRequestInfo(
       url(request_url),
       frame_origin(frame_origin),
       response_url(request_url),
-      request_start(base::TimeTicks::Now()) {
+      request_start(base::TimeTicks::Now()),
+      buffer_size(0),
+      first_unacked_data_offset(-1),
+      num_unacked_data_messages(0) {
 }
 
 ResourceDispatcher::PendingRequestInfo::~PendingRequestInfo() {}
@@ -115,6 +115,10 @@ class CONTENT_EXPORT ResourceDispatcher : public IPC::Listener {
     base::TimeTicks completion_time;
     linked_ptr<base::SharedMemory> buffer;
     int buffer_size;
+    // The data received but not yet acknowledged to the browser starts at
+    // |first_unacked_data_offset| in |buffer|, or is empty if that is -1.
+    int first_unacked_data_offset;
+    int num_unacked_data_messages;
   };
   typedef base::hash_map<int, PendingRequestInfo> PendingRequestList;
 
@@ -143,11 +143,12 @@ class ResourceDispatcherTest : public testing::Test, public IPC::Sender {
       message_queue_.erase(message_queue_.begin());
 
       // read the ack message.
-      Tuple1<int> request_ack;
+      Tuple2<int, int> request_ack;
       ASSERT_TRUE(ResourceHostMsg_DataReceived_ACK::Read(
           &message_queue_[0], &request_ack));
 
       ASSERT_EQ(request_ack.a, request_id);
+      ASSERT_EQ(1, request_ack.b);
 
       message_queue_.erase(message_queue_.begin());
     }
@@ -209,6 +210,62 @@ TEST_F(ResourceDispatcherTest, RoundTrip) {
   delete bridge;
 }
 
+// Tests that data is acknowledged once half of the shared buffer is used.
+TEST_F(ResourceDispatcherTest, DataReceivedACKsAreBatched) {
+  TestRequestCallback callback;
+  scoped_ptr<ResourceLoaderBridge> bridge(CreateBridge());
+  bridge->Start(&callback);
+
+  ASSERT_EQ(1u, message_queue_.size());
+  int request_id;
+  ResourceHostMsg_Request request;
+  ASSERT_TRUE(ResourceHostMsg_RequestResource::Read(
+      &message_queue_[0], &request_id, &request));
+  message_queue_.clear();
+
+  ResourceResponseHead response;
+  std::string raw_headers(test_page_headers);
+  std::replace(raw_headers.begin(), raw_headers.end(), '\n', '\0');
+  response.headers = new net::HttpResponseHeaders(raw_headers);
+  dispatcher_->OnMessageReceived(
+      ResourceMsg_ReceivedResponse(request_id, response));
+
+  const int kBufferSize = 4096;
+  const int kChunkSize = kBufferSize / 4;
+  base::SharedMemory shared_mem;
+  ASSERT_TRUE(shared_mem.CreateAndMapAnonymous(kBufferSize));
+  base::SharedMemoryHandle dup_handle;
+  ASSERT_TRUE(shared_mem.GiveToProcess(
+      base::Process::Current().handle(), &dup_handle));
+  dispatcher_->OnMessageReceived(
+      ResourceMsg_SetDataBuffer(request_id, dup_handle, kBufferSize, 0));
+
+  dispatcher_->OnMessageReceived(
+      ResourceMsg_DataReceived(request_id, 0, kChunkSize, kChunkSize));
+  EXPECT_TRUE(message_queue_.empty());
+  dispatcher_->OnMessageReceived(
+      ResourceMsg_DataReceived(request_id, kChunkSize, kChunkSize, kChunkSize));
+  ASSERT_EQ(1u, message_queue_.size());
+  Tuple2<int, int> request_ack;
+  ASSERT_TRUE(ResourceHostMsg_DataReceived_ACK::Read(
+      &message_queue_[0], &request_ack));
+  EXPECT_EQ(request_id, request_ack.a);
+  EXPECT_EQ(2, request_ack.b);
+  message_queue_.clear();
+
+  // Data that wraps around the end of the buffer counts up to the end.
+  dispatcher_->OnMessageReceived(ResourceMsg_DataReceived(
+      request_id, 3 * kChunkSize, kChunkSize, kChunkSize));
+  EXPECT_TRUE(message_queue_.empty());
+  dispatcher_->OnMessageReceived(
+      ResourceMsg_DataReceived(request_id, 0, kChunkSize, kChunkSize));
+  ASSERT_EQ(1u, message_queue_.size());
+  ASSERT_TRUE(ResourceHostMsg_DataReceived_ACK::Read(
+      &message_queue_[0], &request_ack));
+  EXPECT_EQ(2, request_ack.b);
+  message_queue_.clear();
+}
+
 // Tests that the request IDs are straight when there are multiple requests.
 TEST_F(ResourceDispatcherTest, MultipleRequests) {
   // FIXME
@@ -54,6 +54,7 @@ IPC_STRUCT_TRAITS_BEGIN(tracked_objects::ProcessDataSnapshot)
   IPC_STRUCT_TRAITS_MEMBER(tasks)
   IPC_STRUCT_TRAITS_MEMBER(descendants)
   IPC_STRUCT_TRAITS_MEMBER(process_id)
+  IPC_STRUCT_TRAITS_MEMBER(sample_rate)
 IPC_STRUCT_TRAITS_END()
 
 IPC_ENUM_TRAITS_MAX_VALUE(gfx::GpuMemoryBufferType,
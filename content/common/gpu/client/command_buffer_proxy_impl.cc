@@ -205,10 +205,20 @@ void CommandBufferProxyImpl::Flush(int32 put_offset) {
     return;
 
   last_put_offset_ = put_offset;
+  ++flush_count_;
+
+  // While the service is processing this command buffer it picks up new put
+  // offsets from the shared state, which saves an IPC per flush when
+  // commands are streamed.
+  if (shared_state()->PostPutOffset(put_offset, flush_count_)) {
+    TRACE_EVENT_INSTANT0("gpu", "CommandBufferProxyImpl::Flush posted",
+                         TRACE_EVENT_SCOPE_THREAD);
+    return;
+  }
 
   Send(new GpuCommandBufferMsg_AsyncFlush(route_id_,
                                           put_offset,
-                                          ++flush_count_));
+                                          flush_count_));
 }
 
 void CommandBufferProxyImpl::SetLatencyInfo(
@@ -557,6 +557,39 @@ void GpuChannel::StubSchedulingChanged(bool scheduled) {
   }
 }
 
+void GpuChannel::UpdateSchedulingPriorities() {
+  bool has_surface = false;
+  bool has_visible_surface = false;
+  for (StubMap::Iterator<GpuCommandBufferStub> it(&stubs_);
+       !it.IsAtEnd(); it.Advance()) {
+    GpuCommandBufferStub* stub = it.GetCurrentValue();
+    if (stub->surface_id()) {
+      has_surface = true;
+      has_visible_surface |= stub->surface_visible();
+    }
+  }
+
+  for (StubMap::Iterator<GpuCommandBufferStub> it(&stubs_);
+       !it.IsAtEnd(); it.Advance()) {
+    GpuCommandBufferStub* stub = it.GetCurrentValue();
+    GpuCommandBufferStub::SchedulingPriority priority =
+        GpuCommandBufferStub::SCHEDULING_PRIORITY_NORMAL;
+    if (stub->surface_id()) {
+      priority = stub->surface_visible() ?
+          GpuCommandBufferStub::SCHEDULING_PRIORITY_HIGH :
+          GpuCommandBufferStub::SCHEDULING_PRIORITY_LOW;
+    } else if (has_surface && !has_visible_surface) {
+      priority = GpuCommandBufferStub::SCHEDULING_PRIORITY_LOW;
+    }
+    if (priority != stub->scheduling_priority()) {
+      TRACE_EVENT2("gpu", "GpuChannel::UpdateSchedulingPriorities",
+                   "route_id", stub->route_id(),
+                   "priority", priority);
+      stub->SetSchedulingPriority(priority);
+    }
+  }
+}
+
 void GpuChannel::CreateViewCommandBuffer(
     const gfx::GLSurfaceHandle& window,
     int32 surface_id,
@@ -600,6 +633,7 @@ void GpuChannel::CreateViewCommandBuffer(
     stub->SetPreemptByFlag(preempted_flag_);
   router_.AddRoute(*route_id, stub.get());
   stubs_.AddWithID(stub.release(), *route_id);
+  UpdateSchedulingPriorities();
 }
 
 GpuCommandBufferStub* GpuChannel::LookupCommandBuffer(int32 route_id) {
@@ -821,6 +855,7 @@ void GpuChannel::OnCreateOffscreenCommandBuffer(
     stub->SetPreemptByFlag(preempted_flag_);
   router_.AddRoute(*route_id, stub.get());
   stubs_.AddWithID(stub.release(), *route_id);
+  UpdateSchedulingPriorities();
   TRACE_EVENT1("gpu", "GpuChannel::OnCreateOffscreenCommandBuffer",
                "route_id", route_id);
 }
@@ -835,6 +870,7 @@ void GpuChannel::OnDestroyCommandBuffer(int32 route_id) {
   bool need_reschedule = (stub && !stub->IsScheduled());
   router_.RemoveRoute(route_id);
   stubs_.Remove(route_id);
+  UpdateSchedulingPriorities();
   // In case the renderer is currently blocked waiting for a sync reply from the
   // stub, we need to make sure to reschedule the GpuChannel here.
   if (need_reschedule) {
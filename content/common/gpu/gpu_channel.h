@@ -103,6 +103,12 @@ class GpuChannel : public IPC::Listener,
   // other channels.
   void StubSchedulingChanged(bool scheduled);
 
+  // Gives each stub a scheduling priority from what is visible: stubs drawing
+  // to a visible surface come first, then offscreen stubs of a channel with
+  // something visible, then everything on a channel that is all hidden. Called
+  // when stubs are added or removed, or their surfaces shown or hidden.
+  void UpdateSchedulingPriorities();
+
   void CreateViewCommandBuffer(
       const gfx::GLSurfaceHandle& window,
       int32 surface_id,
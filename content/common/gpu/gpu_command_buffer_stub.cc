@@ -8,6 +8,8 @@
 #include "base/debug/trace_event.h"
 #include "base/hash.h"
 #include "base/memory/shared_memory.h"
+#include "base/process/process_handle.h"
+#include "base/strings/stringprintf.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
 #include "content/common/gpu/devtools_gpu_instrumentation.h"
@@ -25,14 +27,18 @@
 #include "gpu/command_buffer/common/constants.h"
 #include "gpu/command_buffer/common/gles2_cmd_utils.h"
 #include "gpu/command_buffer/common/mailbox.h"
+#include "gpu/command_buffer/service/command_buffer_recorder.h"
 #include "gpu/command_buffer/service/gl_context_virtual.h"
 #include "gpu/command_buffer/service/gl_state_restorer_impl.h"
 #include "gpu/command_buffer/service/gpu_control_service.h"
+#include "gpu/command_buffer/service/gpu_switches.h"
 #include "gpu/command_buffer/service/image_manager.h"
 #include "gpu/command_buffer/service/logger.h"
 #include "gpu/command_buffer/service/memory_tracking.h"
+#include "gpu/command_buffer/service/program_cache.h"
 #include "gpu/command_buffer/service/query_manager.h"
 #include "ui/gl/gl_bindings.h"
+#include "ui/gl/gl_fence.h"
 #include "ui/gl/gl_switches.h"
 
 #if defined(OS_WIN)
@@ -100,6 +106,13 @@ const int64 kHandleMoreWorkPeriodBusyMs = 1;
 // Prevents idle work from being starved.
 const int64 kMaxTimeSinceIdleMs = 10;
 
+// Offscreen contexts yield after this long, so that a busy WebGL page cannot
+// hold up the compositors for more than half a frame at a time.
+const int64 kNormalPriorityTimeSliceMs = 8;
+
+// Contexts with nothing on screen only get short turns.
+const int64 kLowPriorityTimeSliceMs = 2;
+
 }  // namespace
 
 GpuCommandBufferStub::GpuCommandBufferStub(
@@ -127,6 +140,8 @@ GpuCommandBufferStub::GpuCommandBufferStub(
       use_virtualized_gl_context_(use_virtualized_gl_context),
       route_id_(route_id),
       surface_id_(surface_id),
+      surface_visible_(true),
+      scheduling_priority_(SCHEDULING_PRIORITY_NORMAL),
       software_(software),
       last_flush_count_(0),
       last_memory_allocation_valid_(false),
@@ -406,6 +421,17 @@ void GpuCommandBufferStub::OnInitialize(
     return;
   }
 
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+  if (command_line->HasSwitch(switches::kRecordCommandBuffers)) {
+    base::FilePath path =
+        command_line->GetSwitchValuePath(switches::kRecordCommandBuffers)
+            .AppendASCII(base::StringPrintf("gpu_%d_%d.cmdbuf",
+                                            base::GetCurrentProcId(),
+                                            route_id_));
+    command_buffer_->SetRecorder(gpu::CommandBufferRecorder::Create(
+        path, context_group_->transfer_buffer_manager()));
+  }
+
   decoder_.reset(::gpu::gles2::GLES2Decoder::Create(context_group_.get()));
 
   scheduler_.reset(new gpu::GpuScheduler(command_buffer_.get(),
@@ -413,6 +439,7 @@ void GpuCommandBufferStub::OnInitialize(
                                          decoder_.get()));
   if (preemption_flag_.get())
     scheduler_->SetPreemptByFlag(preemption_flag_);
+  SetSchedulingPriority(scheduling_priority_);
 
   decoder_->set_engine(scheduler_.get());
 
@@ -491,8 +518,16 @@ void GpuCommandBufferStub::OnInitialize(
     total_gpu_memory_ = 0;
 
   if (!context_group_->has_program_cache()) {
-    context_group_->set_program_cache(
-        channel_->gpu_channel_manager()->program_cache());
+    gpu::gles2::ProgramCache* program_cache =
+        channel_->gpu_channel_manager()->program_cache();
+    if (program_cache) {
+      // Shaders translated by another build, and binaries from another
+      // driver, may be in the disk cache.
+      program_cache->set_translator_version(GetContentClient()->GetProduct());
+      program_cache->set_driver_version(
+          context->GetGLVersion() + context->GetGLRenderer());
+    }
+    context_group_->set_program_cache(program_cache);
   }
 
   // Initialize the decoder with either the view or pbuffer GLContext.
@@ -581,6 +616,26 @@ void GpuCommandBufferStub::OnCreateStreamTexture(uint32 texture_id,
 #endif
 }
 
+void GpuCommandBufferStub::SetSchedulingPriority(
+    SchedulingPriority priority) {
+  scheduling_priority_ = priority;
+  if (!scheduler_)
+    return;
+  switch (priority) {
+    case SCHEDULING_PRIORITY_HIGH:
+      scheduler_->SetTimeSlice(base::TimeDelta());
+      break;
+    case SCHEDULING_PRIORITY_NORMAL:
+      scheduler_->SetTimeSlice(
+          base::TimeDelta::FromMilliseconds(kNormalPriorityTimeSliceMs));
+      break;
+    case SCHEDULING_PRIORITY_LOW:
+      scheduler_->SetTimeSlice(
+          base::TimeDelta::FromMilliseconds(kLowPriorityTimeSliceMs));
+      break;
+  }
+}
+
 void GpuCommandBufferStub::SetLatencyInfoCallback(
     const LatencyInfoCallback& callback) {
   latency_info_callback_ = callback;
@@ -664,7 +719,10 @@ void GpuCommandBufferStub::OnAsyncFlush(int32 put_offset,
   DCHECK(command_buffer_.get());
   if (flush_count - last_flush_count_ < 0x8000000U) {
     last_flush_count_ = flush_count;
-    command_buffer_->Flush(put_offset);
+    // The client also posts put offsets to the shared state, and the command
+    // buffer may have picked up this one, and later ones, already.
+    if (flush_count - command_buffer_->posted_flush_count() < 0x80000000U)
+      command_buffer_->Flush(put_offset);
   } else {
     // We received this message out-of-order. This should not happen but is here
     // to catch regressions. Ignore the message.
@@ -764,6 +822,10 @@ void GpuCommandBufferStub::OnSetSurfaceVisible(bool visible) {
   TRACE_EVENT0("gpu", "GpuCommandBufferStub::OnSetSurfaceVisible");
   if (memory_manager_client_state_)
     memory_manager_client_state_->SetVisible(visible);
+  if (visible != surface_visible_) {
+    surface_visible_ = visible;
+    channel_->UpdateSchedulingPriorities();
+  }
 }
 
 void GpuCommandBufferStub::AddSyncPoint(uint32 sync_point) {
@@ -773,14 +835,31 @@ void GpuCommandBufferStub::AddSyncPoint(uint32 sync_point) {
 void GpuCommandBufferStub::OnRetireSyncPoint(uint32 sync_point) {
   DCHECK(!sync_points_.empty() && sync_points_.front() == sync_point);
   sync_points_.pop_front();
+
+  // Where the GPU can wait on fences from other contexts, follow the commands
+  // issued before the sync point with a fence, so that the contexts waiting
+  // on it are ordered after them on the GPU.
+  scoped_ptr<gfx::GLFence> fence;
+  if (decoder_ && gfx::GLFence::IsServerWaitSupportedAcrossContexts() &&
+      command_buffer_->GetLastState().error == gpu::error::kNoError &&
+      decoder_->MakeCurrent()) {
+    fence.reset(gfx::GLFence::Create());
+  }
+
   GpuChannelManager* manager = channel_->gpu_channel_manager();
-  manager->sync_point_manager()->RetireSyncPoint(sync_point);
+  manager->sync_point_manager()->RetireSyncPointWithFence(sync_point,
+                                                          fence.Pass());
 }
 
 bool GpuCommandBufferStub::OnWaitSyncPoint(uint32 sync_point) {
   GpuChannelManager* manager = channel_->gpu_channel_manager();
-  if (manager->sync_point_manager()->IsSyncPointRetired(sync_point))
+  if (manager->sync_point_manager()->IsSyncPointRetired(sync_point)) {
+    gfx::GLFence* fence =
+        manager->sync_point_manager()->GetSyncPointFence(sync_point);
+    if (fence)
+      fence->ServerWait();
     return true;
+  }
 
   if (sync_point_wait_count_ == 0) {
     TRACE_EVENT_ASYNC_BEGIN1("gpu", "WaitSyncPoint", this,
@@ -64,6 +64,18 @@ class GpuCommandBufferStub
   typedef base::Callback<void(const std::vector<ui::LatencyInfo>&)>
       LatencyInfoCallback;
 
+  // How long the stub may process commands before other stubs get a turn.
+  enum SchedulingPriority {
+    // Contexts drawing to a visible surface, such as the browser and the
+    // renderer compositors. They run until their commands are done.
+    SCHEDULING_PRIORITY_HIGH,
+    // Offscreen contexts of a channel with something visible, such as WebGL
+    // and accelerated canvas in a visible tab.
+    SCHEDULING_PRIORITY_NORMAL,
+    // Contexts of a channel whose surfaces are all hidden.
+    SCHEDULING_PRIORITY_LOW
+  };
+
   GpuCommandBufferStub(
       GpuChannel* channel,
       GpuCommandBufferStub* share_group,
@@ -115,6 +127,14 @@ class GpuCommandBufferStub
   // Identifies the target surface.
   int32 surface_id() const { return surface_id_; }
 
+  // Whether the renderer last said the target surface is visible.
+  bool surface_visible() const { return surface_visible_; }
+
+  SchedulingPriority scheduling_priority() const {
+    return scheduling_priority_;
+  }
+  void SetSchedulingPriority(SchedulingPriority priority);
+
   // Identifies the various GpuCommandBufferStubs in the GPU process belonging
   // to the same renderer process.
   int32 route_id() const { return route_id_; }
@@ -230,6 +250,8 @@ class GpuCommandBufferStub
   bool use_virtualized_gl_context_;
   int32 route_id_;
   int32 surface_id_;
+  bool surface_visible_;
+  SchedulingPriority scheduling_priority_;
   bool software_;
   uint32 last_flush_count_;
 
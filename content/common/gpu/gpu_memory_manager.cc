@@ -30,6 +30,8 @@ const int kDelayedScheduleManageTimeoutMs = 67;
 
 const uint64 kBytesAllocatedUnmanagedStep = 16 * 1024 * 1024;
 
+const uint64 kBytesGradualEvictionStep = 8 * 1024 * 1024;
+
 void TrackValueChanged(uint64 old_size, uint64 new_size, uint64* total_size) {
   DCHECK(new_size > old_size || *total_size >= (old_size - new_size));
   *total_size += (new_size - old_size);
@@ -65,6 +67,7 @@ GpuMemoryManager::GpuMemoryManager(
       bytes_allocated_unmanaged_high_(0),
       bytes_allocated_unmanaged_low_(0),
       bytes_unmanaged_limit_step_(kBytesAllocatedUnmanagedStep),
+      bytes_gradual_eviction_step_(kBytesGradualEvictionStep),
       disable_schedule_manage_(false)
 {
   CommandLine* command_line = CommandLine::ForCurrentProcess();
@@ -468,7 +471,7 @@ uint64 GpuMemoryManager::ComputeClientAllocationWhenVisible(
   bytes_required = std::min(bytes_required, GetMaximumClientAllocation());
   bytes_required = std::max(bytes_required, GetMinimumClientAllocation());
 
-  uint64 bytes_nicetohave = 4 * stats->bytes_nice_to_have / 3;
+  uint64 bytes_nicetohave = 4 * client_state->bytes_nicetohave_predicted_ / 3;
   bytes_nicetohave = std::min(bytes_nicetohave, GetMaximumClientAllocation());
   bytes_nicetohave = std::max(bytes_nicetohave, GetMinimumClientAllocation());
   bytes_nicetohave = std::max(bytes_nicetohave, bytes_required);
@@ -642,13 +645,117 @@ void GpuMemoryManager::DistributeRemainingMemoryToVisibleSurfaces() {
   }
 }
 
+bool GpuMemoryManager::UpdatePredictedNiceToHave() {
+  ClientStateList clients = clients_visible_mru_;
+  clients.insert(clients.end(),
+                 clients_nonvisible_mru_.begin(),
+                 clients_nonvisible_mru_.end());
+  bool prediction_above_stats = false;
+  for (ClientStateList::const_iterator it = clients.begin();
+       it != clients.end();
+       ++it) {
+    GpuMemoryManagerClientState* client_state = *it;
+    uint64 bytes_reported =
+        client_state->managed_memory_stats_.bytes_nice_to_have;
+    uint64 bytes_predicted = client_state->bytes_nicetohave_predicted_;
+
+    // Drop a quarter of the way towards the reported level each time.
+    if (bytes_predicted > bytes_reported + bytes_gradual_eviction_step_) {
+      bytes_predicted -= (bytes_predicted - bytes_reported) / 4;
+      prediction_above_stats = true;
+    } else {
+      bytes_predicted = bytes_reported;
+    }
+    client_state->bytes_nicetohave_predicted_ = bytes_predicted;
+  }
+  return prediction_above_stats;
+}
+
+bool GpuMemoryManager::LimitVisibleSurfacesEviction() {
+  uint64 bytes_available_total = GetAvailableGpuMemory();
+  uint64 bytes_allocated_total = 0;
+  uint64 bytes_wanted_total = 0;
+  for (ClientStateList::const_iterator it = clients_visible_mru_.begin();
+       it != clients_visible_mru_.end();
+       ++it) {
+    GpuMemoryManagerClientState* client_state = *it;
+    uint64 bytes_allocation = client_state->bytes_allocation_when_visible_;
+    uint64 bytes_sent = std::min(client_state->bytes_allocation_sent_,
+                                 GetMaximumClientAllocation());
+    bytes_allocated_total += bytes_allocation;
+    if (bytes_sent > bytes_allocation + bytes_gradual_eviction_step_)
+      bytes_wanted_total += (bytes_sent - bytes_allocation) / 2;
+  }
+  if (!bytes_wanted_total)
+    return false;
+
+  // Take the memory to hand back from unallocated memory first, and then from
+  // clients whose allocations grew, without cutting into their requirements.
+  uint64 bytes_unallocated = 0;
+  if (bytes_available_total > bytes_allocated_total)
+    bytes_unallocated = bytes_available_total - bytes_allocated_total;
+  uint64 bytes_to_take_back = 0;
+  if (bytes_wanted_total > bytes_unallocated)
+    bytes_to_take_back = bytes_wanted_total - bytes_unallocated;
+  uint64 bytes_taken_back = 0;
+  for (ClientStateList::const_iterator it = clients_visible_mru_.begin();
+       it != clients_visible_mru_.end() &&
+           bytes_taken_back < bytes_to_take_back;
+       ++it) {
+    GpuMemoryManagerClientState* client_state = *it;
+    uint64 bytes_floor = std::max(
+        client_state->bytes_allocation_sent_,
+        client_state->bytes_allocation_ideal_required_);
+    if (client_state->bytes_allocation_when_visible_ <= bytes_floor)
+      continue;
+    uint64 bytes_taken = std::min(
+        client_state->bytes_allocation_when_visible_ - bytes_floor,
+        bytes_to_take_back - bytes_taken_back);
+    client_state->bytes_allocation_when_visible_ -= bytes_taken;
+    bytes_taken_back += bytes_taken;
+  }
+
+  // Hand that memory to the clients whose allocations dropped.
+  uint64 bytes_to_hand_back = std::min(bytes_wanted_total,
+                                       bytes_unallocated + bytes_taken_back);
+  bool eviction_limited = false;
+  for (ClientStateList::const_iterator it = clients_visible_mru_.begin();
+       it != clients_visible_mru_.end() && bytes_to_hand_back;
+       ++it) {
+    GpuMemoryManagerClientState* client_state = *it;
+    uint64 bytes_allocation = client_state->bytes_allocation_when_visible_;
+    uint64 bytes_sent = std::min(client_state->bytes_allocation_sent_,
+                                 GetMaximumClientAllocation());
+    if (bytes_sent <= bytes_allocation + bytes_gradual_eviction_step_)
+      continue;
+    uint64 bytes_kept = std::min((bytes_sent - bytes_allocation) / 2,
+                                 bytes_to_hand_back);
+    client_state->bytes_allocation_when_visible_ += bytes_kept;
+    bytes_to_hand_back -= bytes_kept;
+    eviction_limited = true;
+  }
+  return eviction_limited;
+}
+
 void GpuMemoryManager::AssignSurfacesAllocations() {
+  // Update the usage predictions that the allocations are computed from.
+  bool needs_manage = UpdatePredictedNiceToHave();
+
   // Compute allocation when for all clients.
   ComputeVisibleSurfacesAllocations();
 
   // Distribute the remaining memory to visible clients.
   DistributeRemainingMemoryToVisibleSurfaces();
 
+  // Evict gradually from the visible clients whose allocations dropped, so
+  // that they do not discard content they are about to draw all at once.
+  if (LimitVisibleSurfacesEviction())
+    needs_manage = true;
+
+  // Keep converging on the computed allocations.
+  if (needs_manage)
+    ScheduleManage(kScheduleManageLater);
+
   // Send that allocation to the clients.
   ClientStateList clients = clients_visible_mru_;
   clients.insert(clients.end(),
@@ -672,6 +779,15 @@ void GpuMemoryManager::AssignSurfacesAllocations() {
     allocation.bytes_limit_when_visible =
         client_state->bytes_allocation_when_visible_;
     allocation.priority_cutoff_when_visible = priority_cutoff_;
+    client_state->bytes_allocation_sent_ =
+        client_state->bytes_allocation_when_visible_;
+    TRACE_COUNTER_ID2("gpu",
+                      "GpuMemoryManager::ClientAllocation",
+                      client_state,
+                      "allocation",
+                      client_state->bytes_allocation_when_visible_,
+                      "predicted_nicetohave",
+                      client_state->bytes_nicetohave_predicted_);
 
     client_state->client_->SetMemoryAllocation(allocation);
     client_state->client_->SuggestHaveFrontBuffer(!client_state->hibernated_);
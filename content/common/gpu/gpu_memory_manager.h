@@ -101,6 +101,10 @@ class CONTENT_EXPORT GpuMemoryManager :
                            UnmanagedTracking);
   FRIEND_TEST_ALL_PREFIXES(GpuMemoryManagerTest,
                            DefaultAllocation);
+  FRIEND_TEST_ALL_PREFIXES(GpuMemoryManagerTest,
+                           PredictedNiceToHaveDecaysGradually);
+  FRIEND_TEST_ALL_PREFIXES(GpuMemoryManagerTest,
+                           GradualEviction);
 
   typedef std::map<gpu::gles2::MemoryTracker*, GpuMemoryTrackingGroup*>
       TrackingGroupMap;
@@ -120,6 +124,17 @@ class CONTENT_EXPORT GpuMemoryManager :
   void ComputeVisibleSurfacesAllocations();
   void DistributeRemainingMemoryToVisibleSurfaces();
 
+  // Move each client's predicted "nice to have" level towards what the client
+  // last reported. Returns true if a prediction is still above the report.
+  bool UpdatePredictedNiceToHave();
+
+  // Limit how far the allocations of visible clients drop below what was last
+  // sent to them, by taking back memory from visible clients whose allocations
+  // grew, down to their required level, or from memory that is not allocated.
+  // This never over-commits the available memory. Returns true if an
+  // allocation was held above its computed value.
+  bool LimitVisibleSurfacesEviction();
+
   // Compute the budget for a client. Allow at most bytes_above_required_cap
   // bytes above client_state's required level. Allow at most
   // bytes_above_minimum_cap bytes above client_state's minimum level. Allow
@@ -209,6 +224,10 @@ class CONTENT_EXPORT GpuMemoryManager :
     bytes_unmanaged_limit_step_ = bytes;
   }
 
+  void TestingSetGradualEvictionStep(uint64 bytes) {
+    bytes_gradual_eviction_step_ = bytes;
+  }
+
   GpuChannelManager* channel_manager_;
 
   // A list of all visible and nonvisible clients, in most-recently-used
@@ -251,6 +270,10 @@ class CONTENT_EXPORT GpuMemoryManager :
   // Update bytes_allocated_unmanaged_low/high_ in intervals of step_.
   uint64 bytes_unmanaged_limit_step_;
 
+  // Decreases in predicted usage and allocations that are no larger than this
+  // are applied at once rather than gradually.
+  uint64 bytes_gradual_eviction_step_;
+
   // Used to disable automatic changes to Manage() in testing.
   bool disable_schedule_manage_;
 
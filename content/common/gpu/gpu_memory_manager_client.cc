@@ -23,6 +23,8 @@ GpuMemoryManagerClientState::GpuMemoryManagerClientState(
       managed_memory_stats_received_(false),
       bytes_nicetohave_limit_low_(0),
       bytes_nicetohave_limit_high_(0),
+      bytes_nicetohave_predicted_(0),
+      bytes_allocation_sent_(0),
       bytes_allocation_when_visible_(0),
       bytes_allocation_ideal_nicetohave_(0),
       bytes_allocation_ideal_required_(0),
@@ -90,6 +90,15 @@ class CONTENT_EXPORT GpuMemoryManagerClientState {
   uint64 bytes_nicetohave_limit_low_;
   uint64 bytes_nicetohave_limit_high_;
 
+  // The "nice to have" level used to compute allocations. It follows
+  // increases in managed_memory_stats_.bytes_nice_to_have immediately, and
+  // decreases towards it over several calls to Manage, so that a momentary
+  // drop in the client's request does not take its budget away.
+  uint64 bytes_nicetohave_predicted_;
+
+  // The allocation last sent to this client, or 0 if none was sent.
+  uint64 bytes_allocation_sent_;
+
   // The allocation for this client, used transiently during memory policy
   // calculation.
   uint64 bytes_allocation_when_visible_;
@@ -609,4 +609,73 @@ TEST_F(GpuMemoryManagerTest, DefaultAllocation) {
             memmgr_.GetDefaultClientAllocation());
 }
 
+// Test that a drop in a client's "nice to have" level lowers its allocation
+// over several calls to Manage rather than at once.
+TEST_F(GpuMemoryManagerTest, PredictedNiceToHaveDecaysGradually) {
+  // Set memory manager constants for this test
+  memmgr_.TestingSetAvailableGpuMemory(64);
+  memmgr_.TestingSetMinimumClientAllocation(8);
+  memmgr_.TestingSetGradualEvictionStep(4);
+
+  FakeClient stub1(&memmgr_, GenerateUniqueSurfaceId(), true),
+             stub2(&memmgr_, GenerateUniqueSurfaceId(), true),
+             stub3(&memmgr_, GenerateUniqueSurfaceId(), true);
+  SetClientStats(&stub1, 8, 24);
+  SetClientStats(&stub2, 8, 24);
+  SetClientStats(&stub3, 8, 24);
+  Manage();
+  uint64 bytes_shared = stub1.BytesWhenVisible();
+  EXPECT_EQ(bytes_shared, stub2.BytesWhenVisible());
+  EXPECT_EQ(bytes_shared, stub3.BytesWhenVisible());
+
+  // Expect the first client to keep its share right after it asks for less.
+  SetClientStats(&stub1, 8, 0);
+  Manage();
+  EXPECT_EQ(bytes_shared, stub1.BytesWhenVisible());
+  EXPECT_EQ(bytes_shared, stub2.BytesWhenVisible());
+
+  // Expect the other clients to get that memory eventually.
+  for (int i = 0; i < 20; ++i)
+    Manage();
+  EXPECT_LT(stub1.BytesWhenVisible(), bytes_shared);
+  EXPECT_GT(stub2.BytesWhenVisible(), bytes_shared);
+  EXPECT_EQ(stub2.BytesWhenVisible(), stub3.BytesWhenVisible());
+  EXPECT_LE(stub1.BytesWhenVisible() + stub2.BytesWhenVisible() +
+                stub3.BytesWhenVisible(),
+            64u);
+}
+
+// Test that the allocations of visible clients shrink gradually when another
+// client becomes visible, without over-committing the available memory.
+TEST_F(GpuMemoryManagerTest, GradualEviction) {
+  // Set memory manager constants for this test
+  memmgr_.TestingSetAvailableGpuMemory(64);
+  memmgr_.TestingSetMinimumClientAllocation(8);
+  memmgr_.TestingSetGradualEvictionStep(4);
+
+  FakeClient stub1(&memmgr_, GenerateUniqueSurfaceId(), true),
+             stub2(&memmgr_, GenerateUniqueSurfaceId(), true);
+  SetClientStats(&stub1, 8, 8);
+  SetClientStats(&stub2, 8, 8);
+  Manage();
+  uint64 bytes_before = stub1.BytesWhenVisible();
+  EXPECT_EQ(bytes_before, stub2.BytesWhenVisible());
+
+  FakeClient stub3(&memmgr_, GenerateUniqueSurfaceId(), true);
+  SetClientStats(&stub3, 8, 8);
+  Manage();
+  EXPECT_LT(stub1.BytesWhenVisible(), bytes_before);
+  EXPECT_GT(stub1.BytesWhenVisible(), stub3.BytesWhenVisible());
+  EXPECT_EQ(stub1.BytesWhenVisible(), stub2.BytesWhenVisible());
+  EXPECT_LE(stub1.BytesWhenVisible() + stub2.BytesWhenVisible() +
+                stub3.BytesWhenVisible(),
+            64u);
+
+  // Expect the allocations to even out.
+  for (int i = 0; i < 5; ++i)
+    Manage();
+  EXPECT_EQ(stub1.BytesWhenVisible(), stub3.BytesWhenVisible());
+  EXPECT_EQ(stub2.BytesWhenVisible(), stub3.BytesWhenVisible());
+}
+
 }  // namespace content
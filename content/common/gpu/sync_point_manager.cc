@@ -5,9 +5,14 @@
 #include "content/common/gpu/sync_point_manager.h"
 
 #include "base/logging.h"
+#include "ui/gl/gl_fence.h"
 
 namespace content {
 
+// The number of retired sync point fences kept, even if the GPU has not passed
+// them yet. Waits on older sync points are not ordered on the GPU.
+static const size_t kMaxRetiredFences = 64;
+
 SyncPointManager::SyncPointManager()
     : next_sync_point_(1) {
 }
@@ -30,7 +35,25 @@ uint32 SyncPointManager::GenerateSyncPoint() {
 }
 
 void SyncPointManager::RetireSyncPoint(uint32 sync_point) {
+  RetireSyncPointWithFence(sync_point, scoped_ptr<gfx::GLFence>());
+}
+
+void SyncPointManager::RetireSyncPointWithFence(
+    uint32 sync_point,
+    scoped_ptr<gfx::GLFence> fence) {
   DCHECK(thread_checker_.CalledOnValidThread());
+
+  // Drop the fences the GPU has passed, so that waiting on them is skipped.
+  while (!retired_fences_.empty() &&
+         (retired_fences_.size() >= kMaxRetiredFences ||
+          retired_fences_.front().second->HasCompleted())) {
+    retired_fences_.pop_front();
+  }
+  if (fence) {
+    retired_fences_.push_back(
+        std::make_pair(sync_point, make_linked_ptr(fence.release())));
+  }
+
   ClosureList list;
   {
     base::AutoLock lock(lock_);
@@ -57,6 +80,18 @@ void SyncPointManager::AddSyncPointCallback(uint32 sync_point,
   callback.Run();
 }
 
+gfx::GLFence* SyncPointManager::GetSyncPointFence(uint32 sync_point) {
+  DCHECK(thread_checker_.CalledOnValidThread());
+  // Waits are usually on recently retired sync points.
+  for (FenceQueue::reverse_iterator it = retired_fences_.rbegin();
+       it != retired_fences_.rend();
+       ++it) {
+    if (it->first == sync_point)
+      return it->second.get();
+  }
+  return NULL;
+}
+
 bool SyncPointManager::IsSyncPointRetired(uint32 sync_point) {
   DCHECK(thread_checker_.CalledOnValidThread());
   {
@@ -5,14 +5,22 @@
 #ifndef CONTENT_COMMON_GPU_SYNC_POINT_MANAGER_H_
 #define CONTENT_COMMON_GPU_SYNC_POINT_MANAGER_H_
 
+#include <deque>
+#include <utility>
 #include <vector>
 
 #include "base/callback.h"
 #include "base/containers/hash_tables.h"
+#include "base/memory/linked_ptr.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/synchronization/lock.h"
 #include "base/threading/thread_checker.h"
 
+namespace gfx {
+class GLFence;
+}
+
 namespace content {
 
 // This class manages the sync points, which allow cross-channel
@@ -29,6 +37,18 @@ class SyncPointManager : public base::RefCountedThreadSafe<SyncPointManager> {
   // sync point. This can only be called on the main thread.
   void RetireSyncPoint(uint32 sync_point);
 
+  // Same as RetireSyncPoint, but also keeps |fence|, which follows the GL
+  // commands issued before the sync point, so that contexts waiting on the
+  // sync point can have the GPU wait on it. This can only be called on the
+  // main thread.
+  void RetireSyncPointWithFence(uint32 sync_point,
+                                scoped_ptr<gfx::GLFence> fence);
+
+  // Returns the fence the sync point was retired with, or NULL if it had none
+  // or it has already been passed by the GPU. This can only be called on the
+  // main thread.
+  gfx::GLFence* GetSyncPointFence(uint32 sync_point);
+
   // Adds a callback to the sync point. The callback will be called when the
   // sync point is retired, or immediately (from within that function) if the
   // sync point was already retired (or not created yet). This can only be
@@ -41,6 +61,7 @@ class SyncPointManager : public base::RefCountedThreadSafe<SyncPointManager> {
   friend class base::RefCountedThreadSafe<SyncPointManager>;
   typedef std::vector<base::Closure> ClosureList;
   typedef base::hash_map<uint32, ClosureList > SyncPointMap;
+  typedef std::deque<std::pair<uint32, linked_ptr<gfx::GLFence> > > FenceQueue;
 
   ~SyncPointManager();
 
@@ -52,6 +73,10 @@ class SyncPointManager : public base::RefCountedThreadSafe<SyncPointManager> {
   SyncPointMap sync_point_map_;
   uint32 next_sync_point_;
 
+  // Fences of recently retired sync points, in the order they were retired.
+  // Only used on the main thread.
+  FenceQueue retired_fences_;
+
   DISALLOW_COPY_AND_ASSIGN(SyncPointManager);
 };
 
@@ -0,0 +1,25 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "content/common/input/ipc_priority_lanes.h"
+
+#include "base/command_line.h"
+#include "content/common/input_messages.h"
+#include "content/common/view_messages.h"
+#include "content/public/common/content_switches.h"
+#include "ipc/ipc_channel_proxy.h"
+
+namespace content {
+
+void AddIPCPriorityLanes(IPC::ChannelProxy* channel) {
+  if (!CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableIPCPriorityLanes)) {
+    return;
+  }
+  channel->AddPriorityMessageClass(InputMsgStart);
+  channel->AddPriorityMessageType(ViewHostMsg_SwapCompositorFrame::ID);
+  channel->AddPriorityMessageType(ViewMsg_SwapCompositorFrameAck::ID);
+}
+
+}  // namespace content
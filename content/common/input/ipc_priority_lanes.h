@@ -0,0 +1,25 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef CONTENT_COMMON_INPUT_IPC_PRIORITY_LANES_H_
+#define CONTENT_COMMON_INPUT_IPC_PRIORITY_LANES_H_
+
+#include "content/common/content_export.h"
+
+namespace IPC {
+class ChannelProxy;
+}
+
+namespace content {
+
+// With --enable-ipc-priority-lanes, puts input event messages and compositor
+// frame swaps and their acks in the priority lane of |channel|, a channel
+// between the browser and a renderer. Call it on both ends, so that the
+// messages are both sent and dispatched ahead of bulk traffic such as
+// resource data.
+CONTENT_EXPORT void AddIPCPriorityLanes(IPC::ChannelProxy* channel);
+
+}  // namespace content
+
+#endif  // CONTENT_COMMON_INPUT_IPC_PRIORITY_LANES_H_
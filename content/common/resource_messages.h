@@ -323,10 +323,12 @@ IPC_SYNC_MESSAGE_ROUTED2_1(ResourceHostMsg_SyncLoad,
                            ResourceHostMsg_Request,
                            content::SyncLoadResult)
 
-// Sent when the renderer process is done processing a DataReceived
-// message.
-IPC_MESSAGE_CONTROL1(ResourceHostMsg_DataReceived_ACK,
-                     int /* request_id */)
+// Sent when the renderer process is done processing one or more DataReceived
+// messages, oldest first. The renderer may hold back ACKs until up to half of
+// the shared memory buffer is waiting to be recycled.
+IPC_MESSAGE_CONTROL2(ResourceHostMsg_DataReceived_ACK,
+                     int /* request_id */,
+                     int /* num_data_messages */)
 
 // Sent when the renderer has processed a DataDownloaded message.
 IPC_MESSAGE_CONTROL1(ResourceHostMsg_DataDownloaded_ACK,
@@ -1001,6 +1001,12 @@ IPC_MESSAGE_ROUTED1(ViewMsg_PpapiBrokerPermissionResult,
 IPC_MESSAGE_CONTROL1(ViewMsg_PurgePluginListCache,
                      bool /* reload_pages */)
 
+// Sets the amount of discardable memory (e.g. decoded images) the renderer may
+// keep before purging the least recently used. The browser balances these
+// budgets between renderers by visibility and memory pressure.
+IPC_MESSAGE_CONTROL1(ViewMsg_SetDiscardableMemoryLimit,
+                     uint64 /* bytes */)
+
 // Used to instruct the RenderView to go into "view source" mode.
 IPC_MESSAGE_ROUTED0(ViewMsg_EnableViewSourceMode)
 
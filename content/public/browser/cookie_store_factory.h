@@ -7,6 +7,7 @@
 
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
+#include "base/time/time.h"
 #include "content/common/content_export.h"
 
 namespace base {
@@ -87,6 +88,13 @@ struct CONTENT_EXPORT CookieStoreConfig {
   //
   // Only used for persistent cookie stores.
   scoped_refptr<base::SequencedTaskRunner> background_task_runner;
+
+  // How long changes to cookies may be held in memory before they are written
+  // to the database in a single transaction. If zero, the store's default is
+  // used.
+  //
+  // Only used for persistent cookie stores.
+  base::TimeDelta commit_interval;
 };
 
 CONTENT_EXPORT net::CookieStore* CreateCookieStore(
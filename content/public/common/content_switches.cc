@@ -372,6 +372,11 @@ const char kEnableAcceleratedScrollableFrames[] =
 // Turns on extremely verbose logging of accessibility events.
 const char kEnableAccessibilityLogging[]    = "enable-accessibility-logging";
 
+// Sizes the number of delayable resource requests in flight from the measured
+// throughput and round trip time, instead of using fixed limits.
+const char kEnableAdaptiveResourceScheduling[] =
+    "enable-adaptive-resource-scheduling";
+
 // Use a BeginImplFrame signal from browser to renderer to schedule rendering.
 const char kEnableBeginFrameScheduling[]    = "enable-begin-frame-scheduling";
 
@@ -383,6 +388,10 @@ const char kEnableBrowserPluginForAllViewTypes[] =
 // kEnableBrowserPluginGuestViews must also be set at this time.
 const char kEnableBrowserPluginDragDrop[]   = "enable-browser-plugin-drag-drop";
 
+// Scans main frame HTML in the browser process and requests the scripts,
+// stylesheets and images it refers to before the renderer asks for them.
+const char kEnableBrowserPreloadScanner[]   = "enable-browser-preload-scanner";
+
 // Enables accelerated scrolling by the compositor for frames. Requires
 // kForceCompositingMode and kEnableAcceleratedScrollableFrames.
 const char kEnableCompositedScrollingForFrames[] =
@@ -471,6 +480,10 @@ extern const char kEnableHTMLImports[]      = "enable-html-imports";
 // Enables support for inband text tracks in media content.
 const char kEnableInbandTextTracks[]        = "enable-inband-text-tracks";
 
+// Dispatches and sends input events and compositor frame messages between
+// the browser and renderers ahead of other queued IPC messages.
+const char kEnableIPCPriorityLanes[]        = "enable-ipc-priority-lanes";
+
 // Force logging to be enabled.  Logging is disabled by default in release
 // builds.
 const char kEnableLogging[]                 = "enable-logging";
@@ -499,6 +512,9 @@ const char kEnableOverlayScrollbar[]        = "enable-overlay-scrollbar";
 // Forward overscroll event data from the renderer to the browser.
 const char kEnableOverscrollNotifications[] = "enable-overscroll-notifications";
 
+// Enables fetching large downloads over several parallel range requests.
+const char kEnableParallelDownloading[]     = "enable-parallel-downloading";
+
 // Enables compositor-accelerated touch-screen pinch gestures.
 const char kEnablePinch[]                   = "enable-pinch";
 
@@ -539,6 +555,11 @@ const char kEnableSmoothScrolling[]         = "enable-smooth-scrolling";
 // Allow the compositor to use its software implementation if GL fails.
 const char kEnableSoftwareCompositing[]     = "enable-software-compositing";
 
+// Keeps one sandboxed utility process launched ahead of time, so that the next
+// utility task (unpacking, safe JSON parsing, image decoding) does not wait
+// for a process launch.
+const char kEnableSpareUtilityProcess[]     = "enable-spare-utility-process";
+
 // Enable spatial navigation
 const char kEnableSpatialNavigation[]       = "enable-spatial-navigation";
 
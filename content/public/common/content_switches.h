@@ -116,9 +116,11 @@ CONTENT_EXPORT extern const char kEnableAcceleratedOverflowScroll[];
 CONTENT_EXPORT extern const char kEnableLayerSquashing[];
 CONTENT_EXPORT extern const char kEnableAcceleratedScrollableFrames[];
 extern const char kEnableAccessibilityLogging[];
+CONTENT_EXPORT extern const char kEnableAdaptiveResourceScheduling[];
 CONTENT_EXPORT extern const char kEnableBeginFrameScheduling[];
 CONTENT_EXPORT extern const char kEnableBrowserPluginForAllViewTypes[];
 CONTENT_EXPORT extern const char kEnableBrowserPluginDragDrop[];
+CONTENT_EXPORT extern const char kEnableBrowserPreloadScanner[];
 CONTENT_EXPORT extern const char kEnableCompositedScrollingForFrames[];
 CONTENT_EXPORT extern const char kEnableCompositingForFixedPosition[];
 CONTENT_EXPORT extern const char kEnableCompositingForTransition[];
@@ -142,6 +144,7 @@ CONTENT_EXPORT extern const char kEnableHighResolutionTime[];
 #endif
 CONTENT_EXPORT extern const char kEnableHTMLImports[];
 CONTENT_EXPORT extern const char kEnableInbandTextTracks[];
+CONTENT_EXPORT extern const char kEnableIPCPriorityLanes[];
 CONTENT_EXPORT extern const char kEnableLogging[];
 extern const char kEnableMemoryBenchmarking[];
 extern const char kEnableMonitorProfile[];
@@ -150,6 +153,7 @@ CONTENT_EXPORT extern const char kEnableOverlayFullscreenVideo[];
 extern const char kEnableOverlayFullscreenVideoSubtitle[];
 CONTENT_EXPORT extern const char kEnableOverlayScrollbar[];
 CONTENT_EXPORT extern const char kEnableOverscrollNotifications[];
+CONTENT_EXPORT extern const char kEnableParallelDownloading[];
 CONTENT_EXPORT extern const char kEnablePinch[];
 extern const char kEnablePreparsedJsCaching[];
 CONTENT_EXPORT extern const char kEnablePrivilegedWebGLExtensions[];
@@ -160,6 +164,7 @@ CONTENT_EXPORT extern const char kEnableSandboxLogging[];
 extern const char kEnableSkiaBenchmarking[];
 CONTENT_EXPORT extern const char kEnableSmoothScrolling[];
 CONTENT_EXPORT extern const char kEnableSoftwareCompositing[];
+CONTENT_EXPORT extern const char kEnableSpareUtilityProcess[];
 CONTENT_EXPORT extern const char kEnableSpatialNavigation[];
 CONTENT_EXPORT extern const char kEnableSpeechSynthesis[];
 CONTENT_EXPORT extern const char kEnableStatsTable[];
@@ -4,7 +4,10 @@
 
 #include "content/renderer/gpu/compositor_software_output_device.h"
 
+#include <string.h>
+
 #include "base/logging.h"
+#include "base/metrics/histogram.h"
 #include "cc/output/software_frame_data.h"
 #include "content/renderer/render_process.h"
 #include "third_party/skia/include/core/SkBitmapDevice.h"
@@ -15,6 +18,29 @@
 
 namespace content {
 
+namespace {
+
+// Copies |rect| of a |stride| bytes per row 32-bit bitmap from |src| to
+// |dst|, and returns the number of bytes copied. Unlike drawing through a
+// canvas, this reads each source pixel once and never reads |dst|.
+size_t CopyRect(const void* src,
+                void* dst,
+                size_t stride,
+                const SkIRect& rect) {
+  const size_t offset = rect.y() * stride + rect.x() * 4;
+  const size_t row_bytes = rect.width() * 4;
+  const char* src_row = static_cast<const char*>(src) + offset;
+  char* dst_row = static_cast<char*>(dst) + offset;
+  for (int y = 0; y < rect.height(); ++y) {
+    memcpy(dst_row, src_row, row_bytes);
+    src_row += stride;
+    dst_row += stride;
+  }
+  return row_bytes * rect.height();
+}
+
+}  // namespace
+
 CompositorSoftwareOutputDevice::Buffer::Buffer(
     unsigned id, scoped_ptr<base::SharedMemory> mem)
     : id_(id),
@@ -163,21 +189,18 @@ SkCanvas* CompositorSoftwareOutputDevice::BeginPaint(
     if (!found)
       region = SkRegion(RectToSkIRect(gfx::Rect(viewport_size_)));
     region.op(RectToSkIRect(damage_rect), SkRegion::kDifference_Op);
+    // Unlike drawing, copying the pixels directly is not clipped for us.
+    region.op(RectToSkIRect(gfx::Rect(viewport_size_)),
+              SkRegion::kIntersect_Op);
 
     // Copy over the damage region.
-    if (!region.isEmpty()) {
-      SkBitmap back_bitmap;
-      back_bitmap.setConfig(SkBitmap::kARGB_8888_Config,
-                            viewport_size_.width(),
-                            viewport_size_.height());
-      back_bitmap.setPixels(previous->memory());
-
-      for (SkRegion::Iterator it(region); !it.done(); it.next()) {
-        const SkIRect& src_rect = it.rect();
-        SkRect dst_rect = SkRect::Make(src_rect);
-        canvas_->drawBitmapRect(back_bitmap, &src_rect, dst_rect, NULL);
-      }
+    size_t bytes_copied = 0;
+    for (SkRegion::Iterator it(region); !it.done(); it.next()) {
+      bytes_copied += CopyRect(previous->memory(), current->memory(),
+                               bitmap_.rowBytes(), it.rect());
     }
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Renderer4.SoftwareCompositorCopiedKBPerFrame",
+                                bytes_copied / 1024, 1, 64 * 1024, 50);
   }
 
   // Make |current| child of |previous| and orphan all of |current|'s children.
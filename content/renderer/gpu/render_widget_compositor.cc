@@ -234,6 +234,28 @@ scoped_ptr<RenderWidgetCompositor> RenderWidgetCompositor::Create(
 
   settings.strict_layer_property_change_checking =
       cmd->HasSwitch(cc::switches::kStrictLayerPropertyChangeChecking);
+  settings.incremental_draw_properties =
+      cmd->HasSwitch(cc::switches::kEnableIncrementalDrawProperties);
+  settings.verify_incremental_draw_properties =
+      cmd->HasSwitch(cc::switches::kVerifyIncrementalDrawProperties);
+  settings.use_occlusion_for_tile_prioritization =
+      cmd->HasSwitch(cc::switches::kEnableOcclusionForTilePrioritization);
+  settings.share_identical_recordings =
+      cmd->HasSwitch(cc::switches::kEnableRecordingSharing);
+
+  if (cmd->HasSwitch(cc::switches::kMaxRecordedBytesPerLayer)) {
+    int max_recorded_bytes_per_layer;
+    if (GetSwitchValueAsInt(*cmd,
+                            cc::switches::kMaxRecordedBytesPerLayer,
+                            0, std::numeric_limits<int>::max(),
+                            &max_recorded_bytes_per_layer))
+      settings.max_recorded_bytes_per_layer = max_recorded_bytes_per_layer;
+  }
+
+  settings.main_frame_before_activation_enabled =
+      cmd->HasSwitch(cc::switches::kEnableMainFrameBeforeActivation);
+  settings.cache_render_pass_contents =
+      cmd->HasSwitch(cc::switches::kEnableRenderPassCaching);
 
   settings.use_map_image = cc::switches::IsMapImageEnabled();
 
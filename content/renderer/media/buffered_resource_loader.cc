@@ -51,16 +51,21 @@ static const int kMaxBufferCapacity = 20 * kMegabyte;
 // location and will instead reset the request.
 static const int kForwardWaitThreshold = 2 * kMegabyte;
 
+// Minimum duration of a download throughput sample.
+static const int kThroughputSampleSeconds = 1;
+
 // Computes the suggested backward and forward capacity for the buffer
 // if one wants to play at |playback_rate| * the natural playback speed.
-// Use a value of 0 for |bitrate| if it is unknown.
+// Use a value of 0 for |bitrate| or |throughput| if it is unknown.
 static void ComputeTargetBufferWindow(float playback_rate, int bitrate,
+                                      int throughput,
                                       int* out_backward_capacity,
                                       int* out_forward_capacity) {
   static const int kDefaultBitrate = 200 * 1024 * 8;  // 200 Kbps.
   static const int kMaxBitrate = 20 * kMegabyte * 8;  // 20 Mbps.
   static const float kMaxPlaybackRate = 25.0;
   static const int kTargetSecondsBufferedAhead = 10;
+  static const int kMaxTargetSecondsBufferedAhead = 30;
   static const int kTargetSecondsBufferedBehind = 2;
 
   // Use a default bit rate if unknown and clamp to prevent overflow.
@@ -79,16 +84,25 @@ static void ComputeTargetBufferWindow(float playback_rate, int bitrate,
   playback_rate = std::max(playback_rate, 1.0f);
   playback_rate = std::min(playback_rate, kMaxPlaybackRate);
 
-  int bytes_per_second = (bitrate / 8.0) * playback_rate;
+  int64 bytes_per_second = (bitrate / 8.0) * playback_rate;
 
-  // Clamp between kMinBufferCapacity and kMaxBufferCapacity.
-  *out_forward_capacity = std::max(
-      kTargetSecondsBufferedAhead * bytes_per_second, kMinBufferCapacity);
-  *out_backward_capacity = std::max(
-      kTargetSecondsBufferedBehind * bytes_per_second, kMinBufferCapacity);
+  // Buffer further ahead when the network delivers the media less than twice
+  // as fast as it plays, so throughput dips don't stall playback. A network
+  // slower than playback gets the largest window.
+  int64 seconds_ahead = kTargetSecondsBufferedAhead;
+  if (throughput > 0) {
+    seconds_ahead = std::max(seconds_ahead, std::min<int64>(
+        2 * kTargetSecondsBufferedAhead * bytes_per_second * 8 / throughput,
+        kMaxTargetSecondsBufferedAhead));
+  }
 
-  *out_forward_capacity = std::min(*out_forward_capacity, kMaxBufferCapacity);
-  *out_backward_capacity = std::min(*out_backward_capacity, kMaxBufferCapacity);
+  // Clamp between kMinBufferCapacity and kMaxBufferCapacity.
+  *out_forward_capacity = std::max<int64>(std::min<int64>(
+      seconds_ahead * bytes_per_second, kMaxBufferCapacity),
+      kMinBufferCapacity);
+  *out_backward_capacity = std::max<int64>(std::min<int64>(
+      kTargetSecondsBufferedBehind * bytes_per_second, kMaxBufferCapacity),
+      kMinBufferCapacity);
 
   if (backward_playback)
     std::swap(*out_forward_capacity, *out_backward_capacity);
@@ -124,6 +138,8 @@ BufferedResourceLoader::BufferedResourceLoader(
       last_offset_(0),
       bitrate_(bitrate),
       playback_rate_(playback_rate),
+      throughput_(0),
+      throughput_sample_bytes_(0),
       media_log_(media_log) {
 
   // Set the initial capacity of |buffer_| based on |bitrate_| and
@@ -446,6 +462,7 @@ void BufferedResourceLoader::didReceiveData(
   DCHECK_GT(data_length, 0);
 
   buffer_.Append(reinterpret_cast<const uint8*>(data), data_length);
+  UpdateThroughput(data_length);
 
   // If there is an active read request, try to fulfill the request.
   if (HasPendingRead() && CanFulfillRead())
@@ -588,8 +605,8 @@ void BufferedResourceLoader::SetBitrate(int bitrate) {
 void BufferedResourceLoader::UpdateBufferWindow() {
   int backward_capacity;
   int forward_capacity;
-  ComputeTargetBufferWindow(
-      playback_rate_, bitrate_, &backward_capacity, &forward_capacity);
+  ComputeTargetBufferWindow(playback_rate_, bitrate_, throughput_,
+                            &backward_capacity, &forward_capacity);
 
   // This does not evict data from the buffer if the new capacities are less
   // than the current capacities; the new limits will be enforced after the
@@ -598,6 +615,35 @@ void BufferedResourceLoader::UpdateBufferWindow() {
   buffer_.set_forward_capacity(forward_capacity);
 }
 
+void BufferedResourceLoader::UpdateThroughput(int bytes_received) {
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  // The first chunk after a (re)start mostly measures request latency, so only
+  // use it to start the sample.
+  if (throughput_sample_start_.is_null()) {
+    throughput_sample_start_ = now;
+    throughput_sample_bytes_ = 0;
+    return;
+  }
+
+  throughput_sample_bytes_ += bytes_received;
+  base::TimeDelta elapsed = now - throughput_sample_start_;
+  if (elapsed < base::TimeDelta::FromSeconds(kThroughputSampleSeconds))
+    return;
+
+  int64 sample = throughput_sample_bytes_ * 8 *
+      base::Time::kMicrosecondsPerSecond / elapsed.InMicroseconds();
+  sample = std::min<int64>(sample, kint32max);
+
+  // Smooth out short term fluctuations.
+  throughput_ = static_cast<int>(
+      throughput_ ? (throughput_ + sample) / 2 : sample);
+  throughput_sample_start_ = now;
+  throughput_sample_bytes_ = 0;
+
+  UpdateBufferWindow();
+}
+
 void BufferedResourceLoader::UpdateDeferBehavior() {
   if (!active_loader_)
     return;
@@ -610,6 +656,7 @@ void BufferedResourceLoader::SetDeferred(bool deferred) {
     return;
 
   active_loader_->SetDeferred(deferred);
+  throughput_sample_start_ = base::TimeTicks();
   loading_cb_.Run(deferred ? kLoadingDeferred : kLoading);
 }
 
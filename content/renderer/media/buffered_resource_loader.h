@@ -9,6 +9,7 @@
 
 #include "base/callback.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
 #include "base/timer/timer.h"
 #include "content/common/content_export.h"
 #include "content/renderer/media/active_loader.h"
@@ -213,6 +214,10 @@ class CONTENT_EXPORT BufferedResourceLoader
   // Updates the |buffer_|'s forward and backward capacities.
   void UpdateBufferWindow();
 
+  // Accounts |bytes_received| towards the current throughput sample and
+  // updates |throughput_| once the sample is long enough.
+  void UpdateThroughput(int bytes_received);
+
   // Updates deferring behavior based on current buffering scheme.
   void UpdateDeferBehavior();
 
@@ -316,6 +321,14 @@ class CONTENT_EXPORT BufferedResourceLoader
   // Playback rate of the media.
   float playback_rate_;
 
+  // Measured download throughput in bits per second. Set to 0 if unknown.
+  int throughput_;
+
+  // Start time and byte count of the throughput sample in progress. The sample
+  // is restarted whenever loading is deferred or resumed.
+  base::TimeTicks throughput_sample_start_;
+  int64 throughput_sample_bytes_;
+
   scoped_refptr<media::MediaLog> media_log_;
 
   DISALLOW_COPY_AND_ASSIGN(BufferedResourceLoader);
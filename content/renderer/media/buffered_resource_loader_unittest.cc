@@ -1047,6 +1047,25 @@ TEST_F(BufferedResourceLoaderTest, BufferWindow_Bitrate_AboveUpperBound) {
   StopWhenLoad();
 }
 
+TEST_F(BufferedResourceLoaderTest, BufferWindow_Throughput) {
+  Initialize(kHttpUrl, -1, -1);
+  Start();
+  loader_->SetBitrate(2 * 1024 * 1024);  // 2 Mbps.
+  int forward_capacity = loader_->buffer_.forward_capacity();
+
+  // A network barely keeping up with the media should buffer further ahead.
+  loader_->throughput_ = 2 * 1024 * 1024;
+  loader_->UpdateBufferWindow();
+  EXPECT_GT(loader_->buffer_.forward_capacity(), forward_capacity);
+  CheckBufferWindowBounds();
+
+  // A fast network needs no more than the default window.
+  loader_->throughput_ = 100 * 1024 * 1024;
+  loader_->UpdateBufferWindow();
+  ConfirmLoaderBufferForwardCapacity(forward_capacity);
+  StopWhenLoad();
+}
+
 TEST_F(BufferedResourceLoaderTest, BufferWindow_PlaybackRate_Negative) {
   Initialize(kHttpUrl, -1, -1);
   Start();
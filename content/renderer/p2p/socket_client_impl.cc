@@ -244,6 +244,17 @@ void P2PSocketClientImpl::OnDataReceived(const net::IPEndPoint& address,
                  timestamp));
 }
 
+void P2PSocketClientImpl::OnDataReceivedBatch(
+    const std::vector<P2PMsg_ReceivedPacket>& packets) {
+  DCHECK(ipc_message_loop_->BelongsToCurrentThread());
+  DCHECK_EQ(STATE_OPEN, state_);
+  delegate_message_loop_->PostTask(
+      FROM_HERE,
+      base::Bind(&P2PSocketClientImpl::DeliverOnDataReceivedBatch,
+                 this,
+                 packets));
+}
+
 void P2PSocketClientImpl::DeliverOnDataReceived(
   const net::IPEndPoint& address, const std::vector<char>& data,
   const base::TimeTicks& timestamp) {
@@ -252,6 +263,16 @@ void P2PSocketClientImpl::DeliverOnDataReceived(
     delegate_->OnDataReceived(address, data, timestamp);
 }
 
+void P2PSocketClientImpl::DeliverOnDataReceivedBatch(
+    const std::vector<P2PMsg_ReceivedPacket>& packets) {
+  DCHECK(delegate_message_loop_->BelongsToCurrentThread());
+  // The delegate may close the socket while handling a packet.
+  for (size_t i = 0; i < packets.size() && delegate_; ++i) {
+    delegate_->OnDataReceived(packets[i].address, packets[i].data,
+                              packets[i].timestamp);
+  }
+}
+
 void P2PSocketClientImpl::Detach() {
   DCHECK(ipc_message_loop_->BelongsToCurrentThread());
   dispatcher_ = NULL;
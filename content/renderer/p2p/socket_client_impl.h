@@ -12,6 +12,8 @@
 #include "content/public/renderer/p2p_socket_client.h"
 #include "net/base/ip_endpoint.h"
 
+struct P2PMsg_ReceivedPacket;
+
 namespace base {
 class MessageLoopProxy;
 }  // namespace base
@@ -82,6 +84,7 @@ class P2PSocketClientImpl : public P2PSocketClient {
   void OnDataReceived(const net::IPEndPoint& address,
                       const std::vector<char>& data,
                       const base::TimeTicks& timestamp);
+  void OnDataReceivedBatch(const std::vector<P2PMsg_ReceivedPacket>& packets);
 
   // Proxy methods that deliver messages to the delegate thread.
   void DeliverOnSocketCreated(const net::IPEndPoint& address);
@@ -93,6 +96,8 @@ class P2PSocketClientImpl : public P2PSocketClient {
   void DeliverOnDataReceived(const net::IPEndPoint& address,
                              const std::vector<char>& data,
                              const base::TimeTicks& timestamp);
+  void DeliverOnDataReceivedBatch(
+      const std::vector<P2PMsg_ReceivedPacket>& packets);
 
   // Scheduled on the IPC thread to finish initialization.
   void DoInit(P2PSocketType type,
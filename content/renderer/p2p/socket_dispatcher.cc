@@ -66,6 +66,7 @@ bool P2PSocketDispatcher::OnMessageReceived(const IPC::Message& message) {
     IPC_MESSAGE_HANDLER(P2PMsg_OnSendComplete, OnSendComplete)
     IPC_MESSAGE_HANDLER(P2PMsg_OnError, OnError)
     IPC_MESSAGE_HANDLER(P2PMsg_OnDataReceived, OnDataReceived)
+    IPC_MESSAGE_HANDLER(P2PMsg_OnDataReceivedBatch, OnDataReceivedBatch)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
   return handled;
@@ -177,6 +178,14 @@ void P2PSocketDispatcher::OnDataReceived(
   }
 }
 
+void P2PSocketDispatcher::OnDataReceivedBatch(
+    int socket_id, const std::vector<P2PMsg_ReceivedPacket>& packets) {
+  P2PSocketClientImpl* client = GetClient(socket_id);
+  if (client) {
+    client->OnDataReceivedBatch(packets);
+  }
+}
+
 P2PSocketClientImpl* P2PSocketDispatcher::GetClient(int socket_id) {
   P2PSocketClientImpl* client = clients_.Lookup(socket_id);
   if (client == NULL) {
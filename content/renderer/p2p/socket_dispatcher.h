@@ -33,6 +33,8 @@
 #include "ipc/ipc_channel_proxy.h"
 #include "net/base/net_util.h"
 
+struct P2PMsg_ReceivedPacket;
+
 namespace base {
 class MessageLoopProxy;
 }  // namespace base
@@ -102,6 +104,8 @@ class CONTENT_EXPORT P2PSocketDispatcher
   void OnDataReceived(int socket_id, const net::IPEndPoint& address,
                       const std::vector<char>& data,
                       const base::TimeTicks& timestamp);
+  void OnDataReceivedBatch(int socket_id,
+                           const std::vector<P2PMsg_ReceivedPacket>& packets);
 
   P2PSocketClientImpl* GetClient(int socket_id);
 
@@ -4,6 +4,7 @@
 
 #include "content/renderer/pepper/pepper_url_loader_host.h"
 
+#include "content/public/renderer/render_thread.h"
 #include "content/renderer/pepper/pepper_plugin_instance_impl.h"
 #include "content/renderer/pepper/renderer_ppapi_host_impl.h"
 #include "content/renderer/pepper/url_request_info_util.h"
@@ -15,6 +16,7 @@
 #include "ppapi/host/ppapi_host.h"
 #include "ppapi/proxy/ppapi_messages.h"
 #include "ppapi/shared_impl/ppapi_globals.h"
+#include "ppapi/shared_impl/shared_memory_ring.h"
 #include "third_party/WebKit/public/platform/WebURLError.h"
 #include "third_party/WebKit/public/platform/WebURLLoader.h"
 #include "third_party/WebKit/public/platform/WebURLRequest.h"
@@ -43,6 +45,19 @@ using blink::WebURLResponse;
 
 namespace content {
 
+namespace {
+
+// Chunks of load data at least this large are sent through shared memory.
+// Smaller ones are cheaper to copy into the IPC message than to set up a ring
+// for.
+const int kMinDataRingChunkSize = 32 * 1024;
+
+// The data ring holds several chunks so the plugin can fall behind a little
+// before chunks have to be sent inline again.
+const uint32_t kDataRingCapacity = 1024 * 1024;
+
+}  // namespace
+
 PepperURLLoaderHost::PepperURLLoaderHost(RendererPpapiHostImpl* host,
                                          bool main_document_loader,
                                          PP_Instance instance,
@@ -56,6 +71,7 @@ PepperURLLoaderHost::PepperURLLoaderHost(RendererPpapiHostImpl* host,
       bytes_received_(0),
       total_bytes_to_be_received_(-1),
       pending_response_(false),
+      data_ring_failed_(false),
       weak_factory_(this) {
   DCHECK((main_document_loader && !resource) ||
          (!main_document_loader && resource));
@@ -166,6 +182,13 @@ void PepperURLLoaderHost::didReceiveData(WebURLLoader* loader,
   bytes_received_ += data_length;
   UpdateProgress();
 
+  uint32_t position = 0;
+  if (WriteToDataRing(data, data_length, &position)) {
+    SendUpdateToPlugin(new PpapiPluginMsg_URLLoader_SendDataInRing(
+        position, static_cast<uint32_t>(data_length)));
+    return;
+  }
+
   PpapiPluginMsg_URLLoader_SendData* message =
       new PpapiPluginMsg_URLLoader_SendData;
   message->WriteData(data, data_length);
@@ -330,6 +353,7 @@ void PepperURLLoaderHost::SendUpdateToPlugin(IPC::Message* message) {
   //   - {ReceivedResponse, SendData (zero or more times), FinishedLoading}
   //   - {FinishedLoading (when status != PP_OK)}
   if (message->type() == PpapiPluginMsg_URLLoader_SendData::ID ||
+      message->type() == PpapiPluginMsg_URLLoader_SendDataInRing::ID ||
       message->type() == PpapiPluginMsg_URLLoader_FinishedLoading::ID) {
     // Messages that must be sent after ReceivedResponse.
     if (pending_response_) {
@@ -429,4 +453,52 @@ void PepperURLLoaderHost::UpdateProgress() {
   }
 }
 
+bool PepperURLLoaderHost::WriteToDataRing(const char* data,
+                                          int data_length,
+                                          uint32_t* position) {
+  if (data_length < kMinDataRingChunkSize ||
+      data_length > static_cast<int>(kDataRingCapacity)) {
+    return false;
+  }
+
+  if (!data_ring_) {
+    // The ring is handed to the plugin outside the ordered message queue, so
+    // it can only be set up once the plugin resource is connected.
+    if (data_ring_failed_ || pp_resource() == 0)
+      return false;
+    data_ring_failed_ = true;
+
+    uint32_t size =
+        ppapi::SharedMemoryRing::GetSharedMemorySize(kDataRingCapacity);
+    scoped_ptr<base::SharedMemory> shm(
+        RenderThread::Get()->HostAllocateSharedMemoryBuffer(size).Pass());
+    if (!shm)
+      return false;
+    base::SharedMemoryHandle shm_handle = shm->handle();
+    scoped_ptr<ppapi::SharedMemoryRing> ring(new ppapi::SharedMemoryRing);
+    if (!ring->Init(shm.Pass(), size))
+      return false;
+
+    base::PlatformFile platform_file =
+#if defined(OS_WIN)
+        shm_handle;
+#elif defined(OS_POSIX)
+        shm_handle.fd;
+#else
+#error Not implemented.
+#endif
+    ppapi::proxy::SerializedHandle handle(
+        renderer_ppapi_host_->ShareHandleWithRemote(platform_file, false),
+        size);
+    host()->SendUnsolicitedReplyWithHandles(
+        pp_resource(),
+        PpapiPluginMsg_URLLoader_InitDataRing(size),
+        std::vector<ppapi::proxy::SerializedHandle>(1, handle));
+    data_ring_ = ring.Pass();
+    data_ring_failed_ = false;
+  }
+
+  return data_ring_->Write(data, static_cast<uint32_t>(data_length), position);
+}
+
 }  // namespace content
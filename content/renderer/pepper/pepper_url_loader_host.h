@@ -7,6 +7,7 @@
 
 #include <vector>
 
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/scoped_vector.h"
 #include "base/memory/weak_ptr.h"
 #include "content/common/content_export.h"
@@ -21,6 +22,10 @@ class WebFrame;
 class WebURLLoader;
 }
 
+namespace ppapi {
+class SharedMemoryRing;
+}
+
 namespace content {
 
 class RendererPpapiHostImpl;
@@ -110,6 +115,10 @@ class PepperURLLoaderHost
   // Sends the UpdateProgress message (if necessary) to the plugin.
   void UpdateProgress();
 
+  // Copies |data| into |data_ring_|, setting the ring up first if needed.
+  // Returns false if the data should be sent inline instead.
+  bool WriteToDataRing(const char* data, int data_length, uint32_t* position);
+
   // Non-owning pointer.
   RendererPpapiHostImpl* renderer_ppapi_host_;
 
@@ -148,6 +157,12 @@ class PepperURLLoaderHost
   // ordering constraints on following messages to the plugin.
   bool pending_response_;
 
+  // Shared memory through which large chunks of load data are sent to the
+  // plugin, avoiding copying them into IPC messages. Set up on the first
+  // large chunk.
+  scoped_ptr<ppapi::SharedMemoryRing> data_ring_;
+  bool data_ring_failed_;
+
   base::WeakPtrFactory<PepperURLLoaderHost> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(PepperURLLoaderHost);
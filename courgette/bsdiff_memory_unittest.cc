@@ -107,6 +107,18 @@ TEST_F(BSDiffMemoryTest, TestNearPageArrayPageSize) {
   GenerateAndTestPatch(file1c, file2);
 }
 
+TEST_F(BSDiffMemoryTest, TestRepetitiveInputs) {
+  // Long runs and short periods give the suffix sort many equal LMS
+  // substrings and so several levels of recursion.
+  std::string file1(10000, 'a');
+  std::string file2;
+  for (int i = 0;  i < 2500;  ++i)
+    file2 += "abab";
+  GenerateAndTestPatch(file1, file2);
+  GenerateAndTestPatch(file2, file1);
+  GenerateAndTestPatch(file2, file2 + "abc" + file2);
+}
+
 TEST_F(BSDiffMemoryTest, TestIndenticalDlls) {
   std::string file1 = FileContents("en-US.dll");
   GenerateAndTestPatch(file1, file1);
@@ -10,10 +10,12 @@
 #include "base/command_line.h"
 #include "base/file_util.h"
 #include "base/files/file_path.h"
+#include "base/format_macros.h"
 #include "base/logging.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
 #include "courgette/courgette.h"
 #include "courgette/streams.h"
 #include "courgette/third_party/bsdiff.h"
@@ -27,6 +29,7 @@ void PrintHelp() {
     "  courgette -asm <binary_assembly_file> <executable_file>\n"
     "  courgette -disadj <executable_file> <reference> <binary_assembly_file>\n"
     "  courgette -gen <v1> <v2> <patch>\n"
+    "  courgette -genbench <v1> <v2> [-repeat=N]\n"
     "  courgette -apply <v1> <patch> <v2>\n"
     "\n");
 }
@@ -327,6 +330,30 @@ void GenerateEnsemblePatch(const base::FilePath& old_file,
   WriteSinkToFile(&patch_stream, patch_file);
 }
 
+// Times patch generation without writing the patch, for measuring changes to
+// the generator.  Use with '-repeat=N' to collect several samples.
+void BenchmarkEnsemblePatch(const base::FilePath& old_file,
+                            const base::FilePath& new_file) {
+  std::string old_buffer = ReadOrFail(old_file, "'old' input");
+  std::string new_buffer = ReadOrFail(new_file, "'new' input");
+
+  courgette::SourceStream old_stream;
+  courgette::SourceStream new_stream;
+  old_stream.Init(old_buffer);
+  new_stream.Init(new_buffer);
+
+  courgette::SinkStream patch_stream;
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  courgette::Status status =
+      courgette::GenerateEnsemblePatch(&old_stream, &new_stream, &patch_stream);
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start_time;
+
+  if (status != courgette::C_OK) Problem("-genbench failed.");
+
+  fprintf(stderr, "GenerateEnsemblePatch: %.3fs, %" PRIuS " byte patch\n",
+          elapsed.InSecondsF(), patch_stream.Length());
+}
+
 void ApplyEnsemblePatch(const base::FilePath& old_file,
                         const base::FilePath& patch_file,
                         const base::FilePath& new_file) {
@@ -440,6 +467,7 @@ int main(int argc, const char* argv[]) {
   bool cmd_asm = command_line.HasSwitch("asm");
   bool cmd_disadj = command_line.HasSwitch("disadj");
   bool cmd_make_patch = command_line.HasSwitch("gen");
+  bool cmd_bench_patch = command_line.HasSwitch("genbench");
   bool cmd_apply_patch = command_line.HasSwitch("apply");
   bool cmd_make_bsdiff_patch = command_line.HasSwitch("genbsdiff");
   bool cmd_apply_bsdiff_patch = command_line.HasSwitch("applybsdiff");
@@ -461,13 +489,13 @@ int main(int argc, const char* argv[]) {
       repeat_count = 1;
 
   if (cmd_sup + cmd_dis + cmd_asm + cmd_disadj + cmd_make_patch +
-      cmd_apply_patch + cmd_make_bsdiff_patch + cmd_apply_bsdiff_patch +
-      cmd_spread_1_adjusted + cmd_spread_1_unadjusted
+      cmd_bench_patch + cmd_apply_patch + cmd_make_bsdiff_patch +
+      cmd_apply_bsdiff_patch + cmd_spread_1_adjusted + cmd_spread_1_unadjusted
       != 1)
     UsageProblem(
         "Must have exactly one of:\n"
-        "  -supported -asm, -dis, -disadj, -gen or -apply, -genbsdiff"
-        " or -applybsdiff.");
+        "  -supported -asm, -dis, -disadj, -gen, -genbench or -apply,"
+        " -genbsdiff or -applybsdiff.");
 
   while (repeat_count-- > 0) {
     if (cmd_sup) {
@@ -490,6 +518,10 @@ int main(int argc, const char* argv[]) {
       if (values.size() != 3)
         UsageProblem("-gen <old_file> <new_file> <patch_file>");
       GenerateEnsemblePatch(values[0], values[1], values[2]);
+    } else if (cmd_bench_patch) {
+      if (values.size() != 2)
+        UsageProblem("-genbench <old_file> <new_file>");
+      BenchmarkEnsemblePatch(values[0], values[1]);
     } else if (cmd_apply_patch) {
       if (values.size() != 3)
         UsageProblem("-apply <old_file> <patch_file> <new_file>");
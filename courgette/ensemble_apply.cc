@@ -216,6 +216,10 @@ Status EnsemblePatchApplication::TransformUp(
 
   if (!parameters->Empty())
     return C_STREAM_NOT_CONSUMED;
+  // We have totally consumed the parameters, so can free the storage to which
+  // they referred before the transformed elements are patched and reformed.
+  corrected_parameters_storage_.Retire();
+
   return C_OK;
 }
 
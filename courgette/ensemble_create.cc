@@ -14,11 +14,16 @@
 
 #include "courgette/ensemble.h"
 
+#include <algorithm>
 #include <limits>
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/compiler_specific.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
+#include "base/sys_info.h"
+#include "base/threading/simple_thread.h"
 #include "base/time/time.h"
 
 #include "courgette/crc.h"
@@ -238,6 +243,66 @@ void FreeGenerators(std::vector<TransformationPatchGenerator*>* generators) {
   generators->clear();
 }
 
+// TransformTask runs the Transform step (disassembly, adjustment and encoding)
+// of one TransformationPatchGenerator.  Each generator only reads the regions
+// of its own pair of elements, so the tasks for different elements can run on
+// separate threads.  The results are collected afterwards in element order so
+// the patch is identical to one produced serially.
+class TransformTask : public base::DelegateSimpleThread::Delegate {
+ public:
+  explicit TransformTask(TransformationPatchGenerator* generator)
+      : generator_(generator),
+        status_(C_OK) {
+  }
+
+  virtual void Run() OVERRIDE {
+    status_ = generator_->Transform(&parameters_,
+                                    &predicted_transformed_element_,
+                                    &corrected_transformed_element_);
+  }
+
+  SourceStreamSet* parameters() { return &parameters_; }
+  SinkStreamSet* predicted_transformed_element() {
+    return &predicted_transformed_element_;
+  }
+  SinkStreamSet* corrected_transformed_element() {
+    return &corrected_transformed_element_;
+  }
+  Status status() const { return status_; }
+
+ private:
+  TransformationPatchGenerator* generator_;
+  SourceStreamSet parameters_;
+  SinkStreamSet predicted_transformed_element_;
+  SinkStreamSet corrected_transformed_element_;
+  Status status_;
+
+  DISALLOW_COPY_AND_ASSIGN(TransformTask);
+};
+
+// Runs all |tasks|, using up to one thread per processor.  Every transform
+// holds two disassembled programs in memory, so the thread count also bounds
+// the peak memory use of patch generation.
+void RunTransformTasks(const ScopedVector<TransformTask>& tasks) {
+  int thread_count = std::min(base::SysInfo::NumberOfProcessors(),
+                              static_cast<int>(tasks.size()));
+  if (thread_count <= 1) {
+    for (size_t i = 0;  i < tasks.size();  ++i)
+      tasks[i]->Run();
+    return;
+  }
+
+  base::Time start_time = base::Time::Now();
+  base::DelegateSimpleThreadPool pool("CourgetteTransform", thread_count);
+  for (size_t i = 0;  i < tasks.size();  ++i)
+    pool.AddWork(tasks[i]);
+  pool.Start();
+  pool.JoinAll();
+  VLOG(1) << "done " << tasks.size() << " transforms on " << thread_count
+          << " threads in " << (base::Time::Now() - start_time).InSecondsF()
+          << "s";
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Status GenerateEnsemblePatch(SourceStream* base,
@@ -335,30 +400,33 @@ Status GenerateEnsemblePatch(SourceStream* base,
   SinkStreamSet predicted_transformed_elements;
   SinkStreamSet corrected_transformed_elements;
 
+  ScopedVector<TransformTask> transform_tasks;
   for (size_t i = 0;  i < number_of_transformations;  ++i) {
-    SourceStreamSet single_parameters;
-    if (!corrected_parameters_source_set.ReadSet(&single_parameters))
+    TransformTask* task = new TransformTask(generators[i]);
+    transform_tasks.push_back(task);
+    if (!corrected_parameters_source_set.ReadSet(task->parameters()))
       return C_STREAM_ERROR;
-    SinkStreamSet single_predicted_transformed_element;
-    SinkStreamSet single_corrected_transformed_element;
-    Status status = generators[i]->Transform(
-        &single_parameters,
-        &single_predicted_transformed_element,
-        &single_corrected_transformed_element);
-    if (status != C_OK)
-      return status;
-    if (!single_parameters.Empty())
+  }
+
+  if (!corrected_parameters_source_set.Empty())
+    return C_STREAM_NOT_CONSUMED;
+
+  RunTransformTasks(transform_tasks);
+
+  for (size_t i = 0;  i < number_of_transformations;  ++i) {
+    TransformTask* task = transform_tasks[i];
+    if (task->status() != C_OK)
+      return task->status();
+    if (!task->parameters()->Empty())
       return C_STREAM_NOT_CONSUMED;
     if (!predicted_transformed_elements.WriteSet(
-            &single_predicted_transformed_element))
+            task->predicted_transformed_element()))
       return C_STREAM_ERROR;
     if (!corrected_transformed_elements.WriteSet(
-            &single_corrected_transformed_element))
+            task->corrected_transformed_element()))
       return C_STREAM_ERROR;
   }
-
-  if (!corrected_parameters_source_set.Empty())
-    return C_STREAM_NOT_CONSUMED;
+  transform_tasks.clear();
 
   SinkStream linearized_predicted_transformed_elements;
   SinkStream linearized_corrected_transformed_elements;
@@ -20,6 +20,7 @@
   2010-05-26 - Use a paged array for V and I. The address space may be too
                fragmented for these big arrays to be contiguous.
                  --Stephen Adams <sra@chromium.org>
+  2014-04-30 - Replace qsufsort with a linear-time SA-IS suffix sort.
 */
 
 #include "courgette/third_party/bsdiff.h"
@@ -45,110 +46,8 @@ namespace courgette {
 // replacing tabs with spaces, (2) indentation, (3) using 'const', and (4)
 // changing the V and I parameters from int* to PagedArray<int>&.
 //
-// The code appears to be a rewritten version of the suffix array algorithm
-// presented in "Faster Suffix Sorting" by N. Jesper Larsson and Kunihiko
-// Sadakane, special cased for bytes.
-
-static void
-split(PagedArray<int>& I,PagedArray<int>& V,int start,int len,int h)
-{
-  int i,j,k,x,tmp,jj,kk;
-
-  if(len<16) {
-    for(k=start;k<start+len;k+=j) {
-      j=1;x=V[I[k]+h];
-      for(i=1;k+i<start+len;i++) {
-        if(V[I[k+i]+h]<x) {
-          x=V[I[k+i]+h];
-          j=0;
-        };
-        if(V[I[k+i]+h]==x) {
-          tmp=I[k+j];I[k+j]=I[k+i];I[k+i]=tmp;
-          j++;
-        };
-      };
-      for(i=0;i<j;i++) V[I[k+i]]=k+j-1;
-      if(j==1) I[k]=-1;
-    };
-    return;
-  };
-
-  x=V[I[start+len/2]+h];
-  jj=0;kk=0;
-  for(i=start;i<start+len;i++) {
-    if(V[I[i]+h]<x) jj++;
-    if(V[I[i]+h]==x) kk++;
-  };
-  jj+=start;kk+=jj;
-
-  i=start;j=0;k=0;
-  while(i<jj) {
-    if(V[I[i]+h]<x) {
-      i++;
-    } else if(V[I[i]+h]==x) {
-      tmp=I[i];I[i]=I[jj+j];I[jj+j]=tmp;
-      j++;
-    } else {
-      tmp=I[i];I[i]=I[kk+k];I[kk+k]=tmp;
-      k++;
-    };
-  };
-
-  while(jj+j<kk) {
-    if(V[I[jj+j]+h]==x) {
-      j++;
-    } else {
-      tmp=I[jj+j];I[jj+j]=I[kk+k];I[kk+k]=tmp;
-      k++;
-    };
-  };
-
-  if(jj>start) split(I,V,start,jj-start,h);
-
-  for(i=0;i<kk-jj;i++) V[I[jj+i]]=kk-1;
-  if(jj==kk-1) I[jj]=-1;
-
-  if(start+len>kk) split(I,V,kk,start+len-kk,h);
-}
-
-static void
-qsufsort(PagedArray<int>& I, PagedArray<int>& V,const unsigned char *old,int oldsize)
-{
-  int buckets[256];
-  int i,h,len;
-
-  for(i=0;i<256;i++) buckets[i]=0;
-  for(i=0;i<oldsize;i++) buckets[old[i]]++;
-  for(i=1;i<256;i++) buckets[i]+=buckets[i-1];
-  for(i=255;i>0;i--) buckets[i]=buckets[i-1];
-  buckets[0]=0;
-
-  for(i=0;i<oldsize;i++) I[++buckets[old[i]]]=i;
-  I[0]=oldsize;
-  for(i=0;i<oldsize;i++) V[i]=buckets[old[i]];
-  V[oldsize]=0;
-  for(i=1;i<256;i++) if(buckets[i]==buckets[i-1]+1) I[buckets[i]]=-1;
-  I[0]=-1;
-
-  for(h=1;I[0]!=-(oldsize+1);h+=h) {
-    len=0;
-    for(i=0;i<oldsize+1;) {
-      if(I[i]<0) {
-        len-=I[i];
-        i-=I[i];
-      } else {
-        if(len) I[i-len]=-len;
-        len=V[I[i]]+1-i;
-        split(I,V,i,len,h);
-        i+=len;
-        len=0;
-      };
-    };
-    if(len) I[i-len]=-len;
-  };
-
-  for(i=0;i<oldsize+1;i++) I[V[i]]=i;
-}
+// The suffix sort (qsufsort and split) has been replaced by the SA-IS
+// implementation below, which produces the same suffix array.
 
 static int
 matchlen(const unsigned char *old,int oldsize,const unsigned char *newbuf,int newsize)
@@ -191,6 +90,150 @@ search(PagedArray<int>& I,const unsigned char *old,int oldsize,
 //  End of 'verbatim' code.
 // ------------------------------------------------------------------------
 
+// Suffix sorting by induced sorting (SA-IS), from "Linear Suffix Array
+// Construction by Almost Pure Induced-Sorting" by Ge Nong, Sen Zhang and Wai
+// Hong Chan.  The string is treated as having a virtual sentinel at position
+// |n| that is smaller than every character, so |sa| has n + 1 entries and
+// sa[0] == n, exactly as qsufsort left I[].  A suffix array is unique, so the
+// patches are byte-for-byte the same as before; this is just much faster and
+// touches memory in a few sequential sweeps instead of ~log(n) random ones.
+
+// Sets |bucket|[c] to the first (or one past the last, if |end|) slot of the
+// bucket for character c.  Slot 0 belongs to the sentinel.
+static void GetBuckets(const std::vector<int>& counts, bool end,
+                       std::vector<int>* bucket) {
+  int sum = 1;
+  for (size_t c = 0;  c < counts.size();  ++c) {
+    sum += counts[c];
+    (*bucket)[c] = end ? sum : sum - counts[c];
+  }
+}
+
+// Returns true if |i| is a leftmost S-type position.  |n| always is.
+static bool IsLMS(const std::vector<bool>& s_type, int i) {
+  return i > 0 && s_type[i] && !s_type[i - 1];
+}
+
+// Induces the order of the L-type and then the S-type suffixes from the
+// suffixes already placed in |sa|.
+template <typename String>
+static void InduceSort(String& s, int n, const std::vector<bool>& s_type,
+                       const std::vector<int>& counts,
+                       std::vector<int>* bucket, PagedArray<int>& sa) {
+  GetBuckets(counts, false, bucket);
+  for (int i = 0;  i <= n;  ++i) {
+    int j = sa[i] - 1;
+    if (j >= 0 && !s_type[j])
+      sa[(*bucket)[s[j]]++] = j;
+  }
+  GetBuckets(counts, true, bucket);
+  for (int i = n;  i > 0;  --i) {
+    int j = sa[i] - 1;
+    if (j >= 0 && s_type[j])
+      sa[--(*bucket)[s[j]]] = j;
+  }
+}
+
+// Computes the suffix array of |s|[0, n), whose characters are in [0, k), into
+// |sa|[0, n].  Returns false if memory for the reduced problem is unavailable.
+template <typename String>
+static bool SuffixSort(String& s, int n, int k, PagedArray<int>& sa) {
+  sa[0] = n;
+  if (n == 0)
+    return true;
+
+  // Classify suffixes.  The sentinel is S-type and smaller than s[n - 1].
+  std::vector<bool> s_type(n + 1);
+  s_type[n] = true;
+  for (int i = n - 2;  i >= 0;  --i) {
+    s_type[i] = s[i] < s[i + 1] || (s[i] == s[i + 1] && s_type[i + 1]);
+  }
+
+  std::vector<int> counts(k, 0);
+  for (int i = 0;  i < n;  ++i)
+    ++counts[s[i]];
+  std::vector<int> bucket(k);
+
+  // Stage 1: sort the LMS substrings by inducing from their bucket ends.
+  for (int i = 1;  i <= n;  ++i)
+    sa[i] = -1;
+  GetBuckets(counts, true, &bucket);
+  for (int i = n - 1;  i > 0;  --i) {
+    if (IsLMS(s_type, i))
+      sa[--bucket[s[i]]] = i;
+  }
+  InduceSort(s, n, s_type, counts, &bucket, sa);
+
+  // Move the sorted LMS positions to the front; sa[0] == n stays first.
+  int n1 = 0;
+  for (int i = 0;  i <= n;  ++i) {
+    if (IsLMS(s_type, sa[i]))
+      sa[n1++] = sa[i];
+  }
+
+  // Name the LMS substrings by rank.  LMS positions are at least two apart, so
+  // sa[n1 + pos / 2] is a distinct free slot for each of them.
+  for (int i = n1;  i <= n;  ++i)
+    sa[i] = -1;
+  int name = 0;
+  int prev = -1;
+  for (int i = 0;  i < n1;  ++i) {
+    int pos = sa[i];
+    bool diff = prev < 0;
+    for (int d = 0;  !diff;  ++d) {
+      if (pos + d == n || prev + d == n ||
+          s[pos + d] != s[prev + d] ||
+          s_type[pos + d] != s_type[prev + d]) {
+        diff = true;
+      } else if (d > 0 && IsLMS(s_type, pos + d)) {
+        break;
+      }
+    }
+    if (diff) {
+      ++name;
+      prev = pos;
+    }
+    sa[n1 + pos / 2] = name - 1;
+  }
+
+  // Build the reduced string from the names of the LMS substrings in text
+  // order, leaving out the sentinel's, and sort it.
+  int m = n1 - 1;
+  PagedArray<int> s1;
+  PagedArray<int> sa1;
+  if (!s1.Allocate(m) || !sa1.Allocate(m + 1))
+    return false;
+  for (int i = n1, j = 0;  i <= n;  ++i) {
+    if (sa[i] > 0)
+      s1[j++] = sa[i] - 1;
+  }
+  if (name - 1 < m) {
+    if (!SuffixSort(s1, m, name - 1, sa1))
+      return false;
+  } else {
+    sa1[0] = m;
+    for (int i = 0;  i < m;  ++i)
+      sa1[s1[i] + 1] = i;
+  }
+
+  // Stage 2: place the LMS suffixes in sorted order and induce the rest.
+  for (int i = 1, j = 0;  i < n;  ++i) {
+    if (IsLMS(s_type, i))
+      s1[j++] = i;
+  }
+  for (int i = 1;  i <= n;  ++i)
+    sa[i] = -1;
+  GetBuckets(counts, true, &bucket);
+  for (int i = m;  i > 0;  --i) {
+    int pos = s1[sa1[i]];
+    sa[--bucket[s[pos]]] = pos;
+  }
+  s1.clear();
+  sa1.clear();
+  InduceSort(s, n, s_type, counts, &bucket, sa);
+  return true;
+}
+
 static CheckBool WriteHeader(SinkStream* stream, MBSPatchHeader* header) {
   bool ok = stream->Write(header->tag, sizeof(header->tag));
   ok &= stream->WriteVarint32(header->slen);
@@ -221,7 +264,6 @@ BSDiffStatus CreateBinaryPatch(SourceStream* old_stream,
   uint32 pending_diff_zeros = 0;
 
   PagedArray<int> I;
-  PagedArray<int> V;
 
   if (!I.Allocate(oldsize + 1)) {
     LOG(ERROR) << "Could not allocate I[], " << ((oldsize + 1) * sizeof(int))
@@ -229,17 +271,13 @@ BSDiffStatus CreateBinaryPatch(SourceStream* old_stream,
     return MEM_ERROR;
   }
 
-  if (!V.Allocate(oldsize + 1)) {
-    LOG(ERROR) << "Could not allocate V[], " << ((oldsize + 1) * sizeof(int))
-               << " bytes";
+  base::Time q_start_time = base::Time::Now();
+  if (!SuffixSort(old, oldsize, 256, I)) {
+    LOG(ERROR) << "Could not allocate suffix sort work space";
     return MEM_ERROR;
   }
-
-  base::Time q_start_time = base::Time::Now();
-  qsufsort(I, V, old, oldsize);
-  VLOG(1) << " done qsufsort "
+  VLOG(1) << " done SuffixSort "
           << (base::Time::Now() - q_start_time).InSecondsF();
-  V.clear();
 
   const uint8* newbuf = new_stream->Buffer();
   const int newsize = static_cast<int>(new_stream->Remaining());
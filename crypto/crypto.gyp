@@ -316,6 +316,26 @@
         }],
       ],
     },
+    {
+      'target_name': 'crypto_perftests',
+      'type': 'executable',
+      'sources': [
+        'hash_perftest.cc',
+      ],
+      'dependencies': [
+        'crypto',
+        '../base/base.gyp:base',
+        '../base/base.gyp:test_support_perf',
+        '../testing/gtest.gyp:gtest',
+        '../testing/perf/perf_test.gyp:perf_test',
+      ],
+      'conditions': [
+        [ 'OS == "win"', {
+          # TODO(jschuh): crbug.com/167187 fix size_t to int truncations.
+          'msvs_disabled_warnings': [4267, ],
+        }],
+      ],
+    },
   ],
   'conditions': [
     ['OS == "win" and target_arch=="ia32"', {
@@ -8,6 +8,9 @@
 #ifndef CRYPTO_HMAC_H_
 #define CRYPTO_HMAC_H_
 
+#include <string>
+#include <vector>
+
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/memory/scoped_ptr.h"
@@ -65,6 +68,14 @@ class CRYPTO_EXPORT HMAC {
   bool Sign(const base::StringPiece& data, unsigned char* digest,
             size_t digest_length) const WARN_UNUSED_RESULT;
 
+  // Calculates the full-length HMAC of every message in |data| and stores the
+  // results, in order, in |digests|. The keyed state is set up once and
+  // reused for the whole batch, so this is preferable to calling Sign() in a
+  // loop when there are many short messages. Returns false if any message
+  // could not be signed, in which case |digests| is unspecified.
+  bool SignBatch(const std::vector<base::StringPiece>& data,
+                 std::vector<std::string>* digests) const WARN_UNUSED_RESULT;
+
   // Verifies that the HMAC for the message in |data| equals the HMAC provided
   // in |digest|, using the algorithm supplied to the constructor and the key
   // supplied to the Init method. Use of this method is strongly recommended
@@ -114,4 +114,48 @@ bool HMAC::Sign(const base::StringPiece& data,
   return true;
 }
 
+bool HMAC::SignBatch(const std::vector<base::StringPiece>& data,
+                     std::vector<std::string>* digests) const {
+  if (!plat_->sym_key_.get()) {
+    // Init has not been called before SignBatch.
+    NOTREACHED();
+    return false;
+  }
+
+  digests->resize(data.size());
+  if (data.empty())
+    return true;
+
+  // A single context is restarted with PK11_DigestBegin() for each message,
+  // so the key schedule is only set up once per batch.
+  SECItem param = { siBuffer, NULL, 0 };
+  ScopedPK11Context context(PK11_CreateContextBySymKey(plat_->mechanism_,
+                                                       CKA_SIGN,
+                                                       plat_->sym_key_.get(),
+                                                       &param));
+  if (!context.get()) {
+    NOTREACHED();
+    return false;
+  }
+
+  const size_t digest_length = DigestLength();
+  for (size_t i = 0; i < data.size(); ++i) {
+    std::string& digest = (*digests)[i];
+    digest.resize(digest_length);
+    unsigned int len = 0;
+    if (PK11_DigestBegin(context.get()) != SECSuccess ||
+        PK11_DigestOp(context.get(),
+                      reinterpret_cast<const unsigned char*>(data[i].data()),
+                      data[i].length()) != SECSuccess ||
+        PK11_DigestFinal(context.get(),
+                         reinterpret_cast<unsigned char*>(&digest[0]),
+                         &len, digest_length) != SECSuccess) {
+      NOTREACHED();
+      return false;
+    }
+  }
+
+  return true;
+}
+
 }  // namespace crypto
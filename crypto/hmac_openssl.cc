@@ -53,4 +53,34 @@ bool HMAC::Sign(const base::StringPiece& data,
                 result.safe_buffer(), NULL);
 }
 
+bool HMAC::SignBatch(const std::vector<base::StringPiece>& data,
+                     std::vector<std::string>* digests) const {
+  DCHECK(!plat_->key.empty());  // Init must be called before SignBatch.
+
+  digests->resize(data.size());
+  if (data.empty())
+    return true;
+
+  // Keying the context hashes the inner and outer pads once; re-initializing
+  // it with a NULL key afterwards reuses them for every message.
+  HMAC_CTX ctx;
+  HMAC_CTX_init(&ctx);
+  bool ok = !!HMAC_Init_ex(&ctx, &plat_->key[0], plat_->key.size(),
+                           hash_alg_ == SHA1 ? EVP_sha1() : EVP_sha256(),
+                           NULL);
+  for (size_t i = 0; ok && i < data.size(); ++i) {
+    unsigned char result[EVP_MAX_MD_SIZE];
+    unsigned int result_length = 0;
+    ok = (i == 0 || HMAC_Init_ex(&ctx, NULL, 0, NULL, NULL)) &&
+         HMAC_Update(&ctx,
+                     reinterpret_cast<const unsigned char*>(data[i].data()),
+                     data[i].size()) &&
+         HMAC_Final(&ctx, result, &result_length);
+    if (ok)
+      (*digests)[i].assign(reinterpret_cast<char*>(result), result_length);
+  }
+  HMAC_CTX_cleanup(&ctx);
+  return ok;
+}
+
 }  // namespace crypto
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <string>
+#include <vector>
 
 #include "crypto/hmac.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -275,3 +276,27 @@ TEST(HMACTest, Verify) {
         base::StringPiece(empty_digest, kSHA1DigestSize)));
   }
 }
+
+TEST(HMACTest, SignBatch) {
+  crypto::HMAC hmac(crypto::HMAC::SHA1);
+  ASSERT_TRUE(
+      hmac.Init(reinterpret_cast<const unsigned char*>(kSimpleKey),
+                kSimpleKeyLength));
+  std::vector<base::StringPiece> data;
+  for (size_t i = 0; i < ARRAYSIZE_UNSAFE(kSimpleHmacCases); ++i) {
+    data.push_back(base::StringPiece(kSimpleHmacCases[i].data,
+                                     kSimpleHmacCases[i].data_len));
+  }
+
+  std::vector<std::string> digests;
+  EXPECT_TRUE(hmac.SignBatch(data, &digests));
+  ASSERT_EQ(data.size(), digests.size());
+  for (size_t i = 0; i < digests.size(); ++i) {
+    EXPECT_EQ(std::string(kSimpleHmacCases[i].digest, kSHA1DigestSize),
+              digests[i]);
+  }
+
+  // An empty batch succeeds and clears any previous results.
+  EXPECT_TRUE(hmac.SignBatch(std::vector<base::StringPiece>(), &digests));
+  EXPECT_TRUE(digests.empty());
+}
@@ -206,4 +206,21 @@ bool HMAC::Sign(const base::StringPiece& data,
   return !!CryptGetHashParam(hash, HP_HASHVAL, digest, &sha1_size, 0);
 }
 
+bool HMAC::SignBatch(const std::vector<base::StringPiece>& data,
+                     std::vector<std::string>* digests) const {
+  // CryptoAPI has no way to rewind a keyed HMAC hash object, so each message
+  // is signed separately.
+  const size_t digest_length = DigestLength();
+  digests->resize(data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    std::string& digest = (*digests)[i];
+    digest.resize(digest_length);
+    if (!Sign(data[i], reinterpret_cast<unsigned char*>(&digest[0]),
+              digest_length)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace crypto
@@ -27,6 +27,11 @@ class CRYPTO_EXPORT SecureHash {
   virtual void Update(const void* input, size_t len) = 0;
   virtual void Finish(void* output, size_t len) = 0;
 
+  // Returns the context to its freshly created state so it can hash a new
+  // input without another allocation. Callers hashing many small inputs
+  // should keep one SecureHash and Reset() it between them.
+  virtual void Reset() = 0;
+
   // Serialize the context, so it can be restored at a later time.
   // |pickle| will contain the serialized data.
   // Returns whether or not |pickle| was filled.
@@ -37,6 +37,10 @@ class SecureHashSHA256NSS : public SecureHash {
                static_cast<unsigned int>(len));
   }
 
+  virtual void Reset() OVERRIDE {
+    SHA256_Begin(&ctx_);
+  }
+
   virtual bool Serialize(Pickle* pickle) OVERRIDE;
   virtual bool Deserialize(PickleIterator* data_iterator) OVERRIDE;
 
@@ -40,6 +40,10 @@ class SecureHashSHA256OpenSSL : public SecureHash {
     SHA256_Final(result.safe_buffer(), &ctx_);
   }
 
+  virtual void Reset() OVERRIDE {
+    SHA256_Init(&ctx_);
+  }
+
   virtual bool Serialize(Pickle* pickle) OVERRIDE;
   virtual bool Deserialize(PickleIterator* data_iterator) OVERRIDE;
 
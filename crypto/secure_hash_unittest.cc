@@ -71,3 +71,30 @@ TEST(SecureHashTest, TestSerialization) {
 
   EXPECT_EQ(0, memcmp(output1, output2, crypto::kSHA256Length));
 }
+
+TEST(SecureHashTest, TestReset) {
+  // Example B.1 from FIPS 180-2: one-block message.
+  std::string input1 = "abc";
+  uint8 expected1[crypto::kSHA256Length];
+  crypto::SHA256HashString(input1, expected1, sizeof(expected1));
+
+  scoped_ptr<crypto::SecureHash> ctx(crypto::SecureHash::Create(
+      crypto::SecureHash::SHA256));
+  uint8 output1[crypto::kSHA256Length];
+
+  // Reset after a finished hash.
+  ctx->Update(input1.data(), input1.size());
+  ctx->Finish(output1, sizeof(output1));
+  ctx->Reset();
+  ctx->Update(input1.data(), input1.size());
+  ctx->Finish(output1, sizeof(output1));
+  EXPECT_EQ(0, memcmp(expected1, output1, sizeof(output1)));
+
+  // Reset discards input that was never finished.
+  ctx->Reset();
+  ctx->Update("garbage", 7);
+  ctx->Reset();
+  ctx->Update(input1.data(), input1.size());
+  ctx->Finish(output1, sizeof(output1));
+  EXPECT_EQ(0, memcmp(expected1, output1, sizeof(output1)));
+}
@@ -22,4 +22,21 @@ std::string SHA256HashString(const base::StringPiece& str) {
   return output;
 }
 
+void SHA256HashStrings(const std::vector<base::StringPiece>& inputs,
+                       std::vector<std::string>* outputs) {
+  outputs->resize(inputs.size());
+  if (inputs.empty())
+    return;
+
+  scoped_ptr<SecureHash> ctx(SecureHash::Create(SecureHash::SHA256));
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    std::string& output = (*outputs)[i];
+    output.resize(kSHA256Length);
+    if (i > 0)
+      ctx->Reset();
+    ctx->Update(inputs[i].data(), inputs[i].length());
+    ctx->Finish(string_as_array(&output), output.size());
+  }
+}
+
 }  // namespace crypto
@@ -6,6 +6,7 @@
 #define CRYPTO_SHA2_H_
 
 #include <string>
+#include <vector>
 
 #include "base/strings/string_piece.h"
 #include "crypto/crypto_export.h"
@@ -28,6 +29,14 @@ CRYPTO_EXPORT void SHA256HashString(const base::StringPiece& str,
 // string.
 CRYPTO_EXPORT std::string SHA256HashString(const base::StringPiece& str);
 
+// Computes the SHA-256 hash of each string in |inputs| and stores the 32-byte
+// results, in order, in |outputs|. A single hashing context is reused for
+// the whole batch, which is noticeably cheaper than calling
+// SHA256HashString() in a loop when the inputs are short.
+CRYPTO_EXPORT void SHA256HashStrings(
+    const std::vector<base::StringPiece>& inputs,
+    std::vector<std::string>* outputs);
+
 }  // namespace crypto
 
 #endif  // CRYPTO_SHA2_H_
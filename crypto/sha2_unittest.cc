@@ -4,6 +4,9 @@
 
 #include "crypto/sha2.h"
 
+#include <string>
+#include <vector>
+
 #include "base/basictypes.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -98,3 +101,20 @@ TEST(Sha256Test, Test3) {
   for (size_t i = 0; i < sizeof(output_truncated3); i++)
     EXPECT_EQ(expected3[i], static_cast<int>(output_truncated3[i]));
 }
+
+TEST(Sha256Test, HashStrings) {
+  // Each result must match hashing the input on its own, so state from an
+  // earlier input never leaks into a later one.
+  std::vector<base::StringPiece> inputs;
+  inputs.push_back("abc");
+  inputs.push_back("");
+  inputs.push_back("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+  inputs.push_back("abc");
+
+  std::vector<std::string> outputs;
+  crypto::SHA256HashStrings(inputs, &outputs);
+  ASSERT_EQ(inputs.size(), outputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i)
+    EXPECT_EQ(crypto::SHA256HashString(inputs[i]), outputs[i]);
+  EXPECT_EQ(outputs[0], outputs[3]);
+}
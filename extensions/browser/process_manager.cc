@@ -4,6 +4,8 @@
 
 #include "extensions/browser/process_manager.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/lazy_instance.h"
@@ -115,6 +117,10 @@ static void CreateBackgroundHostForExtensionLoad(
                                   BackgroundInfo::GetBackgroundURL(extension));
 }
 
+// Upper bound for the idle time of an event page that keeps getting woken up
+// soon after it is suspended.
+const int kMaxAdaptiveEventPageIdleTimeSeconds = 5 * 60;
+
 }  // namespace
 
 class RenderViewHostDestructionObserver
@@ -163,6 +169,10 @@ struct ProcessManager::BackgroundPageData {
   // Keeps track of when this page was last suspended. Used for perf metrics.
   linked_ptr<base::ElapsedTimer> since_suspended;
 
+  // The time to wait after the page becomes idle before suspending it, when
+  // adaptive idle times are enabled. Zero means event_page_idle_time_.
+  base::TimeDelta idle_time;
+
   BackgroundPageData()
       : lazy_keepalive_count(0),
         keepalive_impulse(false),
@@ -233,6 +243,8 @@ ProcessManager::ProcessManager(BrowserContext* context,
     event_page_suspending_time_ =
         base::TimeDelta::FromMilliseconds(suspending_time_msec);
   }
+  adaptive_event_page_idle_time_ = CommandLine::ForCurrentProcess()->HasSwitch(
+      extensions::switches::kEnableAdaptiveEventPageIdleTime);
 
   content::DevToolsManager::GetInstance()->AddAgentStateCallback(
       devtools_callback_);
@@ -405,7 +417,7 @@ void ProcessManager::DecrementLazyKeepaliveCount(
         base::Bind(&ProcessManager::OnLazyBackgroundPageIdle,
                    weak_ptr_factory_.GetWeakPtr(), extension_id,
                    ++background_page_data_[extension_id].close_sequence_id),
-        event_page_idle_time_);
+        GetEventPageIdleTime(extension_id));
   }
 }
 
@@ -640,9 +652,13 @@ void ProcessManager::Observe(int type,
     case chrome::NOTIFICATION_EXTENSION_HOST_DESTROYED: {
       ExtensionHost* host = content::Details<ExtensionHost>(details).ptr();
       if (background_hosts_.erase(host)) {
-        ClearBackgroundPageData(host->extension()->id());
-        background_page_data_[host->extension()->id()].since_suspended.reset(
+        const std::string& extension_id = host->extension()->id();
+        base::TimeDelta idle_time =
+            background_page_data_[extension_id].idle_time;
+        ClearBackgroundPageData(extension_id);
+        background_page_data_[extension_id].since_suspended.reset(
             new base::ElapsedTimer());
+        background_page_data_[extension_id].idle_time = idle_time;
       }
       break;
     }
@@ -786,10 +802,41 @@ void ProcessManager::OnBackgroundHostCreated(ExtensionHost* host) {
     if (since_suspended.get()) {
       UMA_HISTOGRAM_LONG_TIMES("Extensions.EventPageIdleTime",
                                since_suspended->Elapsed());
+      if (adaptive_event_page_idle_time_) {
+        UpdateAdaptiveIdleTime(host->extension()->id(),
+                               since_suspended->Elapsed());
+      }
     }
   }
 }
 
+base::TimeDelta ProcessManager::GetEventPageIdleTime(
+    const std::string& extension_id) {
+  return std::max(background_page_data_[extension_id].idle_time,
+                  event_page_idle_time_);
+}
+
+void ProcessManager::UpdateAdaptiveIdleTime(const std::string& extension_id,
+                                            base::TimeDelta suspended_time) {
+  base::TimeDelta idle_time = GetEventPageIdleTime(extension_id);
+
+  // A page that is woken up again within one idle period of being suspended
+  // paid for a full reload where staying alive would have been cheaper, so
+  // double its idle time. A page that stayed suspended for much longer than
+  // its idle time has its idle time halved back towards the default.
+  bool quick_rewake = suspended_time < idle_time;
+  UMA_HISTOGRAM_BOOLEAN("Extensions.EventPageQuickRewake", quick_rewake);
+  if (quick_rewake) {
+    idle_time = std::min(
+        idle_time * 2,
+        base::TimeDelta::FromSeconds(kMaxAdaptiveEventPageIdleTimeSeconds));
+  } else if (suspended_time > idle_time * 4) {
+    idle_time = std::max(idle_time / 2, event_page_idle_time_);
+  }
+  background_page_data_[extension_id].idle_time = idle_time;
+  UMA_HISTOGRAM_LONG_TIMES("Extensions.EventPageAdaptiveIdleTime", idle_time);
+}
+
 void ProcessManager::CloseBackgroundHost(ExtensionHost* host) {
   CHECK(host->extension_host_type() ==
         VIEW_TYPE_EXTENSION_BACKGROUND_PAGE);
@@ -173,6 +173,15 @@ class ProcessManager : public content::NotificationObserver {
   // Close the given |host| iff it's a background page.
   void CloseBackgroundHost(ExtensionHost* host);
 
+  // Returns how long |extension_id|'s event page may stay idle before it is
+  // asked to suspend.
+  base::TimeDelta GetEventPageIdleTime(const std::string& extension_id);
+
+  // Adjusts the idle time of |extension_id|'s event page based on how long
+  // it stayed suspended before being woken up again.
+  void UpdateAdaptiveIdleTime(const std::string& extension_id,
+                              base::TimeDelta suspended_time);
+
   // Internal implementation of DecrementLazyKeepaliveCount with an
   // |extension_id| known to have a lazy background page.
   void DecrementLazyKeepaliveCount(const std::string& extension_id);
@@ -221,6 +230,10 @@ class ProcessManager : public content::NotificationObserver {
   // sending a Suspend message; read from command-line switch.
   base::TimeDelta event_page_suspending_time_;
 
+  // True if event pages that are woken up again shortly after suspending
+  // should get a longer idle time; read from command-line switch.
+  bool adaptive_event_page_idle_time_;
+
   // True if we have created the startup set of background hosts.
   bool startup_background_hosts_created_;
 
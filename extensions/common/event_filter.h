@@ -17,7 +17,9 @@ namespace extensions {
 
 // Matches incoming events against a collection of EventMatchers. Each added
 // EventMatcher is given an id which is returned by MatchEvent() when it is
-// passed a matching event.
+// passed a matching event. The URL filters of each event are compiled into a
+// URLMatcher of their own, so matching one event never evaluates the filters
+// registered for other events.
 class EventFilter {
  public:
   typedef int MatcherID;
@@ -50,9 +52,7 @@ class EventFilter {
   int GetMatcherCountForEvent(const std::string& event_name);
 
   // For testing.
-  bool IsURLMatcherEmpty() const {
-    return url_matcher_.IsEmpty();
-  }
+  bool IsURLMatcherEmpty() const;
 
  private:
   class EventMatcherEntry {
@@ -92,18 +92,27 @@ class EventFilter {
   // Maps from event name to the map of matchers that are registered for it.
   typedef std::map<std::string, EventMatcherMap> EventMatcherMultiMap;
 
-  // Adds the list of URL filters in |matcher| to the URL matcher, having
-  // matches for those URLs map to |id|.
+  // Maps from event name to the URL matcher holding the condition sets of all
+  // the matchers registered for it.
+  typedef std::map<std::string, linked_ptr<url_matcher::URLMatcher> >
+      URLMatcherMap;
+
+  // Creates condition sets in |url_matcher| for the list of URL filters in
+  // |matcher|, having matches for those URLs map to |id|.
   bool CreateConditionSets(
       MatcherID id,
+      url_matcher::URLMatcher* url_matcher,
       EventMatcher* matcher,
       url_matcher::URLMatcherConditionSet::Vector* condition_sets);
 
   bool AddDictionaryAsConditionSet(
+      url_matcher::URLMatcher* url_matcher,
       base::DictionaryValue* url_filter,
       url_matcher::URLMatcherConditionSet::Vector* condition_sets);
 
-  url_matcher::URLMatcher url_matcher_;
+  // Must outlive |event_matchers_|, whose entries remove their condition sets
+  // from these matchers.
+  URLMatcherMap url_matchers_;
   EventMatcherMultiMap event_matchers_;
 
   // The next id to assign to an EventMatcher.
@@ -182,6 +182,24 @@ TEST_F(EventFilterUnittest, TestMatchesOnlyAgainstPatternsForCorrectEvent) {
   }
 }
 
+TEST_F(EventFilterUnittest, RemovingLastMatcherForEventKeepsOtherEvents) {
+  int id1 = event_filter_.AddEventMatcher("event1",
+                                          HostSuffixMatcher("google.com"));
+  int id2 = event_filter_.AddEventMatcher("event2",
+                                          HostSuffixMatcher("google.com"));
+
+  event_filter_.RemoveEventMatcher(id1);
+  EXPECT_TRUE(event_filter_.MatchEvent("event1", google_event_,
+                                       MSG_ROUTING_NONE).empty());
+  std::set<int> matches = event_filter_.MatchEvent("event2",
+      google_event_, MSG_ROUTING_NONE);
+  ASSERT_EQ(1u, matches.size());
+  ASSERT_EQ(1u, matches.count(id2));
+
+  event_filter_.RemoveEventMatcher(id2);
+  EXPECT_TRUE(event_filter_.IsURLMatcherEmpty());
+}
+
 TEST_F(EventFilterUnittest, TestGetMatcherCountForEvent) {
   ASSERT_EQ(0, event_filter_.GetMatcherCountForEvent("event1"));
   int id1 = event_filter_.AddEventMatcher("event1", AllURLs());
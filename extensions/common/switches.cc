@@ -26,6 +26,11 @@ const char kAllowScriptingGallery[] = "allow-scripting-gallery";
 // dragged onto chrome://extensions/.
 const char kEasyOffStoreExtensionInstall[] = "easy-off-store-extension-install";
 
+// Lets event pages that keep being woken up shortly after suspending stay
+// alive for longer than the event page idle time before being shut down.
+const char kEnableAdaptiveEventPageIdleTime[] =
+    "enable-adaptive-event-page-idle-time";
+
 // Enables extension APIs that are in development.
 const char kEnableExperimentalExtensionApis[] =
     "enable-experimental-extension-apis";
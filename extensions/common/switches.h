@@ -15,6 +15,7 @@ extern const char kAllowHTTPBackgroundPage[];
 extern const char kAllowLegacyExtensionManifests[];
 extern const char kAllowScriptingGallery[];
 extern const char kEasyOffStoreExtensionInstall[];
+extern const char kEnableAdaptiveEventPageIdleTime[];
 extern const char kEnableExperimentalExtensionApis[];
 extern const char kEnableOverrideBookmarksUI[];
 extern const char kErrorConsole[];
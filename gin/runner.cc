@@ -6,6 +6,7 @@
 
 #include "gin/converter.h"
 #include "gin/per_context_data.h"
+#include "gin/script_cache.h"
 #include "gin/try_catch.h"
 
 using v8::Context;
@@ -61,8 +62,8 @@ Runner::~Runner() {
 
 void Runner::Run(const std::string& source, const std::string& resource_name) {
   TryCatch try_catch;
-  v8::Handle<Script> script = Script::New(StringToV8(isolate(), source),
-                                          StringToV8(isolate(), resource_name));
+  v8::Handle<Script> script =
+      ScriptCache::GetInstance()->Compile(isolate(), source, resource_name);
   if (try_catch.HasCaught()) {
     delegate_->UnhandledException(this, try_catch);
     return;
@@ -0,0 +1,118 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gin/script_cache.h"
+
+#include "base/file_util.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include "gin/converter.h"
+
+namespace gin {
+
+namespace {
+
+// Pre-parsing a script costs about as much as the work it saves, so only
+// scripts large enough for V8 to compile their functions lazily benefit.
+const size_t kMinSourceSizeForCaching = 1024;
+
+base::LazyInstance<ScriptCache>::Leaky g_script_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+// static
+ScriptCache* ScriptCache::GetInstance() {
+  return g_script_cache.Pointer();
+}
+
+ScriptCache::ScriptCache() {
+}
+
+ScriptCache::~ScriptCache() {
+}
+
+void ScriptCache::SetDirectory(const base::FilePath& directory) {
+  base::AutoLock auto_lock(lock_);
+  directory_ = directory;
+}
+
+v8::Handle<v8::Script> ScriptCache::Compile(v8::Isolate* isolate,
+                                            const std::string& source,
+                                            const std::string& resource_name) {
+  v8::Handle<v8::String> v8_source = StringToV8(isolate, source);
+  v8::ScriptOrigin origin(StringToV8(isolate, resource_name));
+  if (source.size() < kMinSourceSizeForCaching)
+    return v8::Script::New(v8_source, &origin);
+
+  const std::string hash = base::SHA1HashString(source);
+  const std::string key = base::HexEncode(hash.data(), hash.size());
+
+  // V8 sanity-checks the data it is handed and ignores it if it is corrupt or
+  // was produced by a different V8 version, so stale entries are harmless.
+  scoped_ptr<v8::ScriptData> script_data;
+  std::string data;
+  if (Lookup(key, &data)) {
+    script_data.reset(
+        v8::ScriptData::New(data.data(), static_cast<int>(data.size())));
+  } else {
+    script_data.reset(v8::ScriptData::PreCompile(v8_source));
+    if (script_data->HasError()) {
+      script_data.reset();
+    } else {
+      Store(key, std::string(script_data->Data(), script_data->Length()));
+    }
+  }
+  return v8::Script::New(v8_source, &origin, script_data.get());
+}
+
+size_t ScriptCache::size() {
+  base::AutoLock auto_lock(lock_);
+  return entries_.size();
+}
+
+void ScriptCache::Clear() {
+  base::AutoLock auto_lock(lock_);
+  entries_.clear();
+}
+
+bool ScriptCache::Lookup(const std::string& key, std::string* data) {
+  base::FilePath directory;
+  {
+    base::AutoLock auto_lock(lock_);
+    EntryMap::const_iterator it = entries_.find(key);
+    if (it != entries_.end()) {
+      *data = it->second;
+      return true;
+    }
+    directory = directory_;
+  }
+
+  if (directory.empty() ||
+      !base::ReadFileToString(directory.AppendASCII(key), data) ||
+      data->empty()) {
+    return false;
+  }
+
+  base::AutoLock auto_lock(lock_);
+  entries_[key] = *data;
+  return true;
+}
+
+void ScriptCache::Store(const std::string& key, const std::string& data) {
+  base::FilePath directory;
+  {
+    base::AutoLock auto_lock(lock_);
+    entries_[key] = data;
+    directory = directory_;
+  }
+
+  if (!directory.empty()) {
+    file_util::WriteFile(directory.AppendASCII(key), data.data(),
+                         static_cast<int>(data.size()));
+  }
+}
+
+}  // namespace gin
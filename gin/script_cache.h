@@ -0,0 +1,65 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GIN_SCRIPT_CACHE_H_
+#define GIN_SCRIPT_CACHE_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/files/file_path.h"
+#include "base/lazy_instance.h"
+#include "base/synchronization/lock.h"
+#include "gin/gin_export.h"
+#include "v8/include/v8.h"
+
+namespace gin {
+
+// ScriptCache remembers the pre-compilation data V8 produces for a script,
+// keyed by a hash of the script's source, so that compiling the same source
+// again (for example, the same module in another context or isolate) can skip
+// pre-parsing it. The cache is shared by every isolate in the process. If a
+// directory is set, entries are also written there so they survive restarts.
+class GIN_EXPORT ScriptCache {
+ public:
+  static ScriptCache* GetInstance();
+
+  // Persists cache entries in |directory|, which must already exist. Reading
+  // and writing entries then happens on the thread that compiles the script.
+  void SetDirectory(const base::FilePath& directory);
+
+  // Compiles |source| in the current context of |isolate|, using and
+  // populating the cache.
+  v8::Handle<v8::Script> Compile(v8::Isolate* isolate,
+                                 const std::string& source,
+                                 const std::string& resource_name);
+
+  // Returns the number of entries held in memory.
+  size_t size();
+
+  // Drops the in-memory entries. Entries on disk are kept.
+  void Clear();
+
+ private:
+  friend struct base::DefaultLazyInstanceTraits<ScriptCache>;
+
+  typedef std::map<std::string, std::string> EntryMap;
+
+  ScriptCache();
+  ~ScriptCache();
+
+  bool Lookup(const std::string& key, std::string* data);
+  void Store(const std::string& key, const std::string& data);
+
+  base::Lock lock_;
+  EntryMap entries_;  // Protected by |lock_|.
+  base::FilePath directory_;  // Protected by |lock_|.
+
+  DISALLOW_COPY_AND_ASSIGN(ScriptCache);
+};
+
+}  // namespace gin
+
+#endif  // GIN_SCRIPT_CACHE_H_
@@ -0,0 +1,82 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gin/script_cache.h"
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/string_number_conversions.h"
+#include "gin/converter.h"
+#include "gin/public/isolate_holder.h"
+#include "gin/runner.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace gin {
+
+namespace {
+
+// Returns a script that is large enough to be cached and that sets
+// |this.result| to |value|.
+std::string MakeSource(const std::string& value) {
+  std::string source;
+  for (int i = 0; i < 100; ++i)
+    source += "function unused" + base::IntToString(i) + "() { return 1; }\n";
+  return source + "this.result = '" + value + "';\n";
+}
+
+std::string RunAndGetResult(Runner* runner, const std::string& source) {
+  Runner::Scope scope(runner);
+  runner->Run(source, "test_data.js");
+  std::string result;
+  EXPECT_TRUE(Converter<std::string>::FromV8(runner->isolate(),
+      runner->global()->Get(StringToV8(runner->isolate(), "result")),
+      &result));
+  return result;
+}
+
+}  // namespace
+
+TEST(ScriptCacheTest, ReusesEntriesAcrossContexts) {
+  ScriptCache* cache = ScriptCache::GetInstance();
+  cache->Clear();
+
+  gin::IsolateHolder instance;
+  RunnerDelegate delegate;
+  Runner runner1(&delegate, instance.isolate());
+  Runner runner2(&delegate, instance.isolate());
+
+  EXPECT_EQ("PASS", RunAndGetResult(&runner1, MakeSource("PASS")));
+  EXPECT_EQ(1u, cache->size());
+  EXPECT_EQ("PASS", RunAndGetResult(&runner2, MakeSource("PASS")));
+  EXPECT_EQ(1u, cache->size());
+
+  // Different sources get different entries, and small ones aren't cached.
+  EXPECT_EQ("OTHER", RunAndGetResult(&runner1, MakeSource("OTHER")));
+  EXPECT_EQ(2u, cache->size());
+  EXPECT_EQ("SMALL", RunAndGetResult(&runner1, "this.result = 'SMALL';"));
+  EXPECT_EQ(2u, cache->size());
+}
+
+TEST(ScriptCacheTest, PersistsEntriesInDirectory) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  ScriptCache* cache = ScriptCache::GetInstance();
+  cache->Clear();
+  cache->SetDirectory(temp_dir.path());
+
+  gin::IsolateHolder instance;
+  RunnerDelegate delegate;
+  Runner runner(&delegate, instance.isolate());
+  EXPECT_EQ("PASS", RunAndGetResult(&runner, MakeSource("PASS")));
+
+  // Entries dropped from memory are read back from disk.
+  cache->Clear();
+  EXPECT_EQ(0u, cache->size());
+  EXPECT_EQ("PASS", RunAndGetResult(&runner, MakeSource("PASS")));
+  EXPECT_EQ(1u, cache->size());
+
+  cache->SetDirectory(base::FilePath());
+  cache->Clear();
+}
+
+}  // namespace gin
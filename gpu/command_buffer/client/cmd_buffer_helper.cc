@@ -28,7 +28,8 @@ CommandBufferHelper::CommandBufferHelper(CommandBuffer* command_buffer)
       usable_(true),
       context_lost_(false),
       flush_automatically_(true),
-      last_flush_time_(0) {
+      last_flush_time_(0),
+      token_wait_count_(0) {
 }
 
 void CommandBufferHelper::SetAutomaticFlushes(bool enabled) {
@@ -239,16 +240,23 @@ void CommandBufferHelper::WaitForToken(int32 token) {
   if (token < 0)
     return;
   if (token > token_) return;  // we wrapped
+  if (last_token_read() >= token)
+    return;
+
+  TRACE_EVENT0("gpu", "CommandBufferHelper::WaitForToken");
+  base::TimeTicks begin_time = base::TimeTicks::Now();
+  ++token_wait_count_;
   while (last_token_read() < token) {
     if (get_offset() == put_) {
       LOG(FATAL) << "Empty command buffer while waiting on a token.";
-      return;
+      break;
     }
     // Do not loop forever if the flush fails, meaning the command buffer reader
     // has shutdown.
     if (!FlushSync())
-      return;
+      break;
   }
+  token_wait_time_ += base::TimeTicks::Now() - begin_time;
 }
 
 // Waits for available entries, basically waiting until get >= put + count + 1.
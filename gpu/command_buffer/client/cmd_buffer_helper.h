@@ -10,6 +10,7 @@
 #include <string.h>
 #include <time.h>
 
+#include "base/time/time.h"
 #include "gpu/command_buffer/common/cmd_buffer_common.h"
 #include "gpu/command_buffer/common/command_buffer.h"
 #include "gpu/command_buffer/common/constants.h"
@@ -99,6 +100,16 @@ class GPU_EXPORT CommandBufferHelper {
   //   the value of the token to wait for.
   void WaitForToken(int32 token);
 
+  // The number of WaitForToken calls that had to block, and the total time
+  // spent blocked in them.
+  int token_wait_count() const {
+    return token_wait_count_;
+  }
+
+  base::TimeDelta token_wait_time() const {
+    return token_wait_time_;
+  }
+
   // Called prior to each command being issued. Waits for a certain amount of
   // space to be available. Returns address of space.
   CommandBufferEntry* GetSpace(int32 entries) {
@@ -311,6 +322,9 @@ class GPU_EXPORT CommandBufferHelper {
   // Using C runtime instead of base because this file cannot depend on base.
   clock_t last_flush_time_;
 
+  int token_wait_count_;
+  base::TimeDelta token_wait_time_;
+
   friend class CommandBufferHelperTest;
   DISALLOW_COPY_AND_ASSIGN(CommandBufferHelper);
 };
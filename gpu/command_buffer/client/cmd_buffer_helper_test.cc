@@ -557,9 +557,14 @@ TEST_F(CommandBufferHelperTest, TestToken) {
                       Return(error::kNoError)));
   // Add another command.
   AddCommandWithExpect(error::kNoError, kUnusedCommandId + 4, 2, args);
+  EXPECT_EQ(0, helper_->token_wait_count());
   helper_->WaitForToken(token);
   // check that the get pointer is beyond the first command.
   EXPECT_LE(command1_put, GetGetOffset());
+  EXPECT_EQ(1, helper_->token_wait_count());
+  // The token has passed, so waiting again does not block.
+  helper_->WaitForToken(token);
+  EXPECT_EQ(1, helper_->token_wait_count());
   helper_->Finish();
 
   // Check that the commands did happen.
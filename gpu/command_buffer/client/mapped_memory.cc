@@ -43,19 +43,28 @@ void* MappedMemoryManager::Alloc(
   DCHECK(shm_offset);
   if (size <= allocated_memory_) {
     size_t total_bytes_in_use = 0;
-    // See if any of the chunks can satisfy this request.
+    // See if any of the chunks can satisfy this request. Use the chunk with
+    // the smallest free block that fits, so that large free blocks are kept
+    // for large uploads instead of being split up by small ones.
+    MemoryChunk* best_chunk = NULL;
+    unsigned int best_free_size = 0;
     for (size_t ii = 0; ii < chunks_.size(); ++ii) {
       MemoryChunk* chunk = chunks_[ii];
       chunk->FreeUnused();
       total_bytes_in_use += chunk->bytes_in_use();
-      if (chunk->GetLargestFreeSizeWithoutWaiting() >= size) {
-        void* mem = chunk->Alloc(size);
-        DCHECK(mem);
-        *shm_id = chunk->shm_id();
-        *shm_offset = chunk->GetOffset(mem);
-        return mem;
+      unsigned int free_size = chunk->GetLargestFreeSizeWithoutWaiting();
+      if (free_size >= size && (!best_chunk || free_size < best_free_size)) {
+        best_chunk = chunk;
+        best_free_size = free_size;
       }
     }
+    if (best_chunk) {
+      void* mem = best_chunk->Alloc(size);
+      DCHECK(mem);
+      *shm_id = best_chunk->shm_id();
+      *shm_offset = best_chunk->GetOffset(mem);
+      return mem;
+    }
 
     // If there is a memory limit being enforced and total free
     // memory (allocated_memory_ - total_bytes_in_use) is larger than
@@ -307,6 +307,38 @@ TEST_F(MappedMemoryManagerTest, ChunkSizeMultiple) {
   EXPECT_EQ(0u, offset3);
 }
 
+TEST_F(MappedMemoryManagerTest, AllocUsesBestFittingChunk) {
+  const unsigned int kSize = 1024;
+  manager_->set_chunk_size_multiple(kSize * 2);
+  int32 id1 = -1;
+  int32 id2 = -1;
+  int32 id3 = -1;
+  unsigned int offset = 0xFFFFFFFFU;
+  void* mem1 = manager_->Alloc(kSize * 2, &id1, &offset);
+  void* mem2 = manager_->Alloc(kSize, &id2, &offset);
+  void* mem3 = manager_->Alloc(kSize, &id3, &offset);
+  ASSERT_TRUE(mem1);
+  ASSERT_TRUE(mem2);
+  ASSERT_TRUE(mem3);
+  EXPECT_NE(id1, id2);
+  EXPECT_EQ(id2, id3);
+
+  // Leave the whole of the first chunk free, and half of the second.
+  manager_->Free(mem1);
+  manager_->Free(mem3);
+
+  // A small allocation goes in the chunk with the smallest block that fits,
+  // which keeps the first chunk whole for a large one.
+  int32 id = -1;
+  mem3 = manager_->Alloc(kSize / 2, &id, &offset);
+  ASSERT_TRUE(mem3);
+  EXPECT_EQ(id2, id);
+  mem1 = manager_->Alloc(kSize * 2, &id, &offset);
+  ASSERT_TRUE(mem1);
+  EXPECT_EQ(id1, id);
+  EXPECT_EQ(2u, manager_->num_chunks());
+}
+
 TEST_F(MappedMemoryManagerTest, UnusedMemoryLimit) {
   const unsigned int kChunkSize = 2048;
   // Reset the manager with a memory limit.
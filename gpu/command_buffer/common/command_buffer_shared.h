@@ -56,7 +56,56 @@ public:
   }
 };
 
-typedef SharedState<CommandBuffer::State> CommandBufferSharedState;
+// The service's state, plus a way for the client to pass new put offsets to
+// the service while the service is processing commands, without sending a
+// flush message for each. The client posts every put offset and then checks
+// whether the service is busy; the service clears the busy flag and then
+// checks for posted put offsets. The barriers in between make sure that at
+// least one of them sees what the other wrote, so a posted put offset is
+// never missed by both.
+class CommandBufferSharedState : public SharedState<CommandBuffer::State> {
+ public:
+  void Initialize() {
+    base::subtle::NoBarrier_Store(&posted_put_offset_, 0);
+    base::subtle::NoBarrier_Store(&posted_flush_count_, 0);
+    base::subtle::NoBarrier_Store(&service_busy_, 0);
+    SharedState<CommandBuffer::State>::Initialize();
+  }
+
+  // Called by the client, with the number it would give the flush message
+  // for |put_offset|. Returns true if the service is processing commands and
+  // will see |put_offset| before it stops, so that no flush message needs to
+  // be sent.
+  bool PostPutOffset(int32 put_offset, uint32 flush_count) {
+    base::subtle::NoBarrier_Store(&posted_put_offset_, put_offset);
+    base::subtle::Release_Store(&posted_flush_count_, flush_count);
+    base::subtle::MemoryBarrier();
+    return !!base::subtle::NoBarrier_Load(&service_busy_);
+  }
+
+  // Called by the service before and after it processes commands.
+  void SetServiceBusy(bool busy) {
+    base::subtle::NoBarrier_Store(&service_busy_, busy);
+    base::subtle::MemoryBarrier();
+  }
+
+  // Called by the service. Returns true, and updates |flush_count| and
+  // |put_offset|, if the client posted a put offset since |flush_count| was
+  // last updated.
+  bool GetPostedPutOffset(uint32* flush_count, int32* put_offset) {
+    uint32 count = base::subtle::Acquire_Load(&posted_flush_count_);
+    if (count == *flush_count)
+      return false;
+    *flush_count = count;
+    *put_offset = base::subtle::NoBarrier_Load(&posted_put_offset_);
+    return true;
+  }
+
+ private:
+  base::subtle::Atomic32 posted_put_offset_;
+  base::subtle::Atomic32 posted_flush_count_;
+  base::subtle::Atomic32 service_busy_;
+};
 
 }  // namespace gpu
 
@@ -6,6 +6,7 @@
 
 #include "base/command_line.h"
 #include "base/debug/trace_event.h"
+#include "base/memory/scoped_ptr.h"
 #include "gpu/command_buffer/service/async_pixel_transfer_manager_idle.h"
 #include "gpu/command_buffer/service/async_pixel_transfer_manager_share_group.h"
 #include "gpu/command_buffer/service/async_pixel_transfer_manager_stub.h"
@@ -17,11 +18,20 @@ namespace gpu {
 AsyncPixelTransferManager* AsyncPixelTransferManager::Create(
     gfx::GLContext* context) {
   TRACE_EVENT0("gpu", "AsyncPixelTransferManager::Create");
-  if (CommandLine::ForCurrentProcess()->HasSwitch(
-          switches::kEnableShareGroupAsyncTextureUpload)) {
-    DCHECK(context);
-    return static_cast<AsyncPixelTransferManager*> (
-        new AsyncPixelTransferManagerShareGroup(context));
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+  // Desktop GL uploads on a thread unless told not to, so that large uploads
+  // do not hold up the commands of other contexts.
+  bool use_share_group =
+      command_line->HasSwitch(switches::kEnableShareGroupAsyncTextureUpload) ||
+      (gfx::GetGLImplementation() == gfx::kGLImplementationDesktopGL &&
+       !command_line->HasSwitch(
+           switches::kDisableShareGroupAsyncTextureUpload));
+  if (use_share_group && context) {
+    scoped_ptr<AsyncPixelTransferManagerShareGroup> manager(
+        new AsyncPixelTransferManagerShareGroup);
+    if (manager->Initialize(context))
+      return manager.release();
+    LOG(WARNING) << "Falling back to async texture uploads on the GPU thread.";
   }
 
   switch (gfx::GetGLImplementation()) {
@@ -22,6 +22,7 @@
 #include "gpu/command_buffer/service/safe_shared_memory_pool.h"
 #include "ui/gl/gl_bindings.h"
 #include "ui/gl/gl_context.h"
+#include "ui/gl/gl_share_group.h"
 #include "ui/gl/gl_surface.h"
 #include "ui/gl/gpu_preference.h"
 #include "ui/gl/scoped_binders.h"
@@ -48,7 +49,8 @@ class TransferThread : public base::Thread {
  public:
   TransferThread()
       : base::Thread(kAsyncTransferThreadName),
-        initialized_(false) {
+        initialized_(false),
+        share_group_(NULL) {
     Start();
 #if defined(OS_ANDROID) || defined(OS_LINUX)
     SetPriority(base::kThreadPriority_Background);
@@ -60,10 +62,18 @@ class TransferThread : public base::Thread {
     NOTREACHED();
   }
 
-  void InitializeOnMainThread(gfx::GLContext* parent_context) {
+  // Returns true if the upload context shares textures with |parent_context|.
+  bool InitializeOnMainThread(gfx::GLContext* parent_context) {
     TRACE_EVENT0("gpu", "TransferThread::InitializeOnMainThread");
+    DCHECK(parent_context);
     if (initialized_)
-      return;
+      return share_group_ == parent_context->share_group();
+
+    // Without a share group, the upload context would not see the textures.
+    if (!parent_context->share_group()) {
+      LOG(ERROR) << "Parent context has no share group.";
+      return false;
+    }
 
     base::WaitableEvent wait_for_init(true, false);
     message_loop_proxy()->PostTask(
@@ -73,6 +83,9 @@ class TransferThread : public base::Thread {
                  base::Unretained(parent_context),
                  &wait_for_init));
     wait_for_init.Wait();
+    if (initialized_)
+      share_group_ = parent_context->share_group();
+    return initialized_;
   }
 
   virtual void CleanUp() OVERRIDE {
@@ -86,6 +99,9 @@ class TransferThread : public base::Thread {
 
  private:
   bool initialized_;
+  // The share group of the upload context, only used on the main thread. The
+  // upload context keeps it alive.
+  gfx::GLShareGroup* share_group_;
 
   scoped_refptr<gfx::GLSurface> surface_;
   scoped_refptr<gfx::GLContext> context_;
@@ -121,7 +137,12 @@ class TransferThread : public base::Thread {
       return;
     }
 
-    context_->MakeCurrent(surface_.get());
+    if (!context_->MakeCurrent(surface_.get())) {
+      LOG(ERROR) << "Unable to make the upload context current.";
+      context_ = NULL;
+      caller_wait->Signal();
+      return;
+    }
     initialized_ = true;
     caller_wait->Signal();
   }
@@ -504,9 +525,11 @@ AsyncPixelTransferManagerShareGroup::SharedState::SharedState()
 
 AsyncPixelTransferManagerShareGroup::SharedState::~SharedState() {}
 
-AsyncPixelTransferManagerShareGroup::AsyncPixelTransferManagerShareGroup(
-    gfx::GLContext* context) {
-  g_transfer_thread.Pointer()->InitializeOnMainThread(context);
+AsyncPixelTransferManagerShareGroup::AsyncPixelTransferManagerShareGroup() {
+}
+
+bool AsyncPixelTransferManagerShareGroup::Initialize(gfx::GLContext* context) {
+  return g_transfer_thread.Pointer()->InitializeOnMainThread(context);
 }
 
 AsyncPixelTransferManagerShareGroup::~AsyncPixelTransferManagerShareGroup() {}
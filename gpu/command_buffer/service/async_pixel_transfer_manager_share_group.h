@@ -19,9 +19,15 @@ class AsyncPixelTransferUploadStats;
 
 class AsyncPixelTransferManagerShareGroup : public AsyncPixelTransferManager {
  public:
-  explicit AsyncPixelTransferManagerShareGroup(gfx::GLContext* context);
+  AsyncPixelTransferManagerShareGroup();
   virtual ~AsyncPixelTransferManagerShareGroup();
 
+  // Sets up the upload thread with a context in the share group of |context|.
+  // There is one upload thread per process, so this fails if the thread
+  // already uploads for another share group, as well as if its context cannot
+  // be created. The manager must not be used if this returns false.
+  bool Initialize(gfx::GLContext* context);
+
   // AsyncPixelTransferManager implementation:
   virtual void BindCompletedAsyncTransfers() OVERRIDE;
   virtual void AsyncNotifyCompletion(
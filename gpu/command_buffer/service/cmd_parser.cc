@@ -80,6 +80,30 @@ error::Error CommandParser::ProcessCommand() {
   return result;
 }
 
+error::Error CommandParser::ProcessCommands(int num_commands) {
+  CommandBufferOffset get = get_;
+  if (get == put_)
+    return error::kNoError;
+
+  // Commands are never split across the end of the buffer, so a run only goes
+  // as far as the put pointer or the end of the buffer, whichever is first.
+  int num_entries = put_ < get ? entry_count_ - get : put_ - get;
+  int entries_processed = 0;
+  error::Error result = handler_->DoCommands(
+      num_commands, buffer_ + get, num_entries, &entries_processed);
+
+  if (error::IsError(result)) {
+    DVLOG(1) << "Error: " << result << " after " << entries_processed
+             << " entries";
+  }
+
+  // If get was not set somewhere else advance it.
+  if (get == get_)
+    get_ = (get + entries_processed) % entry_count_;
+
+  return result;
+}
+
 void CommandParser::ReportError(unsigned int command_id,
                                 error::Error result) {
   DVLOG(1) << "Error: " << result << " for Command "
@@ -97,4 +121,47 @@ error::Error CommandParser::ProcessAllCommands() {
   return error::kNoError;
 }
 
+error::Error AsyncAPIInterface::DoCommands(unsigned int num_commands,
+                                           const void* buffer,
+                                           int num_entries,
+                                           int* entries_processed) {
+  DCHECK(entries_processed);
+  const CommandBufferEntry* cmd_data =
+      static_cast<const CommandBufferEntry*>(buffer);
+  int process_pos = 0;
+  error::Error result = error::kNoError;
+
+  for (unsigned int ii = 0;
+       ii < num_commands && process_pos < num_entries; ++ii) {
+    CommandHeader header = cmd_data[process_pos].value_header;
+    if (header.size == 0) {
+      result = error::kInvalidSize;
+      break;
+    }
+    if (static_cast<int>(header.size) + process_pos > num_entries) {
+      result = error::kOutOfBounds;
+      break;
+    }
+
+    TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("cb_command"),
+                 GetCommandName(header.command));
+
+    result = DoCommand(header.command, header.size - 1,
+                       cmd_data + process_pos);
+    if (result == error::kDeferCommandUntilLater)
+      break;
+
+    process_pos += header.size;
+    if (result != error::kNoError || !CanBatchCommand(header.command))
+      break;
+  }
+
+  *entries_processed = process_pos;
+  return result;
+}
+
+bool AsyncAPIInterface::CanBatchCommand(unsigned int command) const {
+  return false;
+}
+
 }  // namespace gpu
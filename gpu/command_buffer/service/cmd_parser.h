@@ -57,6 +57,15 @@ class GPU_EXPORT CommandParser {
   // if there are no commands in the buffer.
   error::Error ProcessCommand();
 
+  // The largest number of commands ProcessCommands() is asked to run between
+  // checks for preemption and the end of the time slice.
+  static const int kParseCommandsSlice = 20;
+
+  // Processes up to |num_commands| commands in one go, updating the get
+  // pointer. Stops early at the put pointer, on an error, or after a command
+  // the handler does not let through in a batch.
+  error::Error ProcessCommands(int num_commands);
+
   // Processes all commands until get == put.
   error::Error ProcessAllCommands();
 
@@ -91,6 +100,26 @@ class AsyncAPIInterface {
       unsigned int arg_count,
       const void* cmd_data) = 0;
 
+  // Executes up to |num_commands| commands from |buffer|, which holds
+  // |num_entries| entries. The run stops after the first error or after the
+  // first command that CanBatchCommand() rejects.
+  // Parameters:
+  //    num_commands: the maximum number of commands to execute.
+  //    buffer: the first command.
+  //    num_entries: the number of CommandBufferEntry available in |buffer|.
+  //    entries_processed: set to the number of entries executed.
+  // Returns:
+  //   the result of the last command executed.
+  error::Error DoCommands(unsigned int num_commands,
+                          const void* buffer,
+                          int num_entries,
+                          int* entries_processed);
+
+  // Returns true if |command| can be followed by more commands in the same
+  // DoCommands() run. Commands that may unschedule the handler or move the
+  // get pointer must return false. The default batches nothing.
+  virtual bool CanBatchCommand(unsigned int command) const;
+
   // Returns a name for a command. Useful for logging / debuging.
   virtual const char* GetCommandName(unsigned int command_id) const = 0;
 };
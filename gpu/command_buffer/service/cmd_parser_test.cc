@@ -316,4 +316,37 @@ TEST_F(CommandParserTest, SetBuffer) {
   EXPECT_EQ(0, parser->put());
 }
 
+// Tests that ProcessCommands() runs commands the handler batches together, and
+// stops after the first one it does not.
+TEST_F(CommandParserTest, ProcessCommandsStopsAfterUnbatchedCommand) {
+  scoped_ptr<CommandParser> parser(MakeParser(10));
+  CommandBufferOffset put = parser->put();
+  CommandHeader header;
+
+  header.size = 1;
+  header.command = 1;
+  buffer()[put++].value_header = header;
+  header.command = 2;
+  buffer()[put++].value_header = header;
+  CommandBufferOffset put_after_unbatched = put;
+  header.command = 1;
+  buffer()[put++].value_header = header;
+
+  parser->set_put(put);
+  ON_CALL(*api_mock(), CanBatchCommand(1)).WillByDefault(Return(true));
+  ON_CALL(*api_mock(), CanBatchCommand(2)).WillByDefault(Return(false));
+
+  AddDoCommandExpect(error::kNoError, 1, 0, NULL);
+  AddDoCommandExpect(error::kNoError, 2, 0, NULL);
+  EXPECT_EQ(error::kNoError, parser->ProcessCommands(10));
+  EXPECT_EQ(put_after_unbatched, parser->get());
+  Mock::VerifyAndClearExpectations(api_mock());
+
+  // The run also ends at the put pointer.
+  AddDoCommandExpect(error::kNoError, 1, 0, NULL);
+  EXPECT_EQ(error::kNoError, parser->ProcessCommands(10));
+  EXPECT_EQ(put, parser->get());
+  Mock::VerifyAndClearExpectations(api_mock());
+}
+
 }  // namespace gpu
@@ -0,0 +1,190 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gpu/command_buffer/service/command_buffer_recorder.h"
+
+#include <string.h>
+
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "gpu/command_buffer/common/cmd_buffer_common.h"
+#include "gpu/command_buffer/service/transfer_buffer_manager.h"
+
+namespace gpu {
+
+namespace {
+
+const uint32 kRecordingMagic = 0x52425047;  // "GPBR"
+const uint32 kRecordingVersion = 1;
+
+// Records larger than this are taken to be corrupt.
+const uint32 kMaxRecordSize = 256 * 1024 * 1024;
+
+}  // namespace
+
+// static
+scoped_ptr<CommandBufferRecorder> CommandBufferRecorder::Create(
+    const base::FilePath& path,
+    TransferBufferManagerInterface* transfer_buffer_manager) {
+  FILE* file = base::OpenFile(path, "wb");
+  if (!file) {
+    LOG(ERROR) << "Could not open " << path.value() << " for recording.";
+    return scoped_ptr<CommandBufferRecorder>();
+  }
+  uint32 header[] = { kRecordingMagic, kRecordingVersion };
+  if (fwrite(header, sizeof(header), 1, file) != 1) {
+    base::CloseFile(file);
+    return scoped_ptr<CommandBufferRecorder>();
+  }
+  return make_scoped_ptr(
+      new CommandBufferRecorder(file, transfer_buffer_manager));
+}
+
+CommandBufferRecorder::CommandBufferRecorder(
+    FILE* file,
+    TransferBufferManagerInterface* transfer_buffer_manager)
+    : file_(file),
+      transfer_buffer_manager_(transfer_buffer_manager),
+      ring_buffer_id_(-1) {
+}
+
+CommandBufferRecorder::~CommandBufferRecorder() {
+  base::CloseFile(file_);
+}
+
+void CommandBufferRecorder::RecordSetGetBuffer(int32 id) {
+  // The ring buffer is recorded one flush at a time instead.
+  transfer_buffers_.erase(id);
+  ring_buffer_id_ = id;
+  WriteRecord(kCommandBufferRecordSetGetBuffer, id, NULL, 0);
+}
+
+void CommandBufferRecorder::RecordRegisterTransferBuffer(int32 id) {
+  // Recorded with the next flush that follows a change to its contents.
+  transfer_buffers_[id].clear();
+}
+
+void CommandBufferRecorder::RecordDestroyTransferBuffer(int32 id) {
+  transfer_buffers_.erase(id);
+  if (id == ring_buffer_id_)
+    ring_buffer_id_ = -1;
+  WriteRecord(kCommandBufferRecordDestroyTransferBuffer, id, NULL, 0);
+}
+
+void CommandBufferRecorder::RecordFlush(const Buffer& ring_buffer,
+                                        int32 begin,
+                                        int32 end) {
+  if (begin == end)
+    return;
+  RecordChangedTransferBuffers();
+
+  const CommandBufferEntry* entries =
+      static_cast<const CommandBufferEntry*>(ring_buffer.ptr);
+  int32 num_entries = ring_buffer.size / sizeof(CommandBufferEntry);
+  DCHECK(begin >= 0 && begin < num_entries);
+  DCHECK(end >= 0 && end <= num_entries);
+
+  // The client pads the end of the ring buffer with noops when it wraps, so
+  // the two parts can be replayed back to back.
+  int32 count = end >= begin ? end - begin : num_entries - begin + end;
+  uint32 header[] = {
+    kCommandBufferRecordCommands,
+    0,
+    static_cast<uint32>(count * sizeof(CommandBufferEntry))
+  };
+  WriteData(header, sizeof(header));
+  if (end >= begin) {
+    WriteData(entries + begin, (end - begin) * sizeof(CommandBufferEntry));
+  } else {
+    WriteData(entries + begin,
+              (num_entries - begin) * sizeof(CommandBufferEntry));
+    WriteData(entries, end * sizeof(CommandBufferEntry));
+  }
+  fflush(file_);
+}
+
+void CommandBufferRecorder::RecordChangedTransferBuffers() {
+  for (TransferBufferMap::iterator it = transfer_buffers_.begin();
+       it != transfer_buffers_.end();
+       ++it) {
+    Buffer buffer = transfer_buffer_manager_->GetTransferBuffer(it->first);
+    if (!buffer.ptr)
+      continue;
+    std::vector<uint8>& recorded = it->second;
+    if (recorded.size() == buffer.size &&
+        (!buffer.size || !memcmp(&recorded[0], buffer.ptr, buffer.size))) {
+      continue;
+    }
+    const uint8* contents = static_cast<const uint8*>(buffer.ptr);
+    recorded.assign(contents, contents + buffer.size);
+    WriteRecord(kCommandBufferRecordTransferBuffer,
+                it->first,
+                buffer.ptr,
+                buffer.size);
+  }
+}
+
+void CommandBufferRecorder::WriteRecord(CommandBufferRecordType type,
+                                        int32 id,
+                                        const void* data,
+                                        size_t size) {
+  uint32 header[] = {
+    type,
+    static_cast<uint32>(id),
+    static_cast<uint32>(size)
+  };
+  WriteData(header, sizeof(header));
+  WriteData(data, size);
+}
+
+void CommandBufferRecorder::WriteData(const void* data, size_t size) {
+  if (size && fwrite(data, size, 1, file_) != 1)
+    DLOG(ERROR) << "Failed to write command buffer recording.";
+}
+
+// static
+scoped_ptr<CommandBufferRecordingReader> CommandBufferRecordingReader::Create(
+    const base::FilePath& path) {
+  FILE* file = base::OpenFile(path, "rb");
+  if (!file)
+    return scoped_ptr<CommandBufferRecordingReader>();
+  uint32 header[2];
+  if (fread(header, sizeof(header), 1, file) != 1 ||
+      header[0] != kRecordingMagic ||
+      header[1] != kRecordingVersion) {
+    base::CloseFile(file);
+    return scoped_ptr<CommandBufferRecordingReader>();
+  }
+  return make_scoped_ptr(new CommandBufferRecordingReader(file));
+}
+
+CommandBufferRecordingReader::CommandBufferRecordingReader(FILE* file)
+    : file_(file) {
+}
+
+CommandBufferRecordingReader::~CommandBufferRecordingReader() {
+  base::CloseFile(file_);
+}
+
+bool CommandBufferRecordingReader::ReadRecord(CommandBufferRecordType* type,
+                                              int32* id,
+                                              std::vector<uint8>* data) {
+  uint32 header[3];
+  if (fread(header, sizeof(header), 1, file_) != 1)
+    return false;
+  if (header[0] < kCommandBufferRecordSetGetBuffer ||
+      header[0] > kCommandBufferRecordCommands ||
+      header[2] > kMaxRecordSize) {
+    return false;
+  }
+  *type = static_cast<CommandBufferRecordType>(header[0]);
+  *id = static_cast<int32>(header[1]);
+  data->resize(header[2]);
+  if (header[2] && fread(&(*data)[0], header[2], 1, file_) != 1)
+    return false;
+  return true;
+}
+
+}  // namespace gpu
@@ -0,0 +1,108 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef GPU_COMMAND_BUFFER_SERVICE_COMMAND_BUFFER_RECORDER_H_
+#define GPU_COMMAND_BUFFER_SERVICE_COMMAND_BUFFER_RECORDER_H_
+
+#include <stdio.h>
+
+#include <map>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "gpu/command_buffer/common/buffer.h"
+#include "gpu/gpu_export.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace gpu {
+
+class TransferBufferManagerInterface;
+
+// The records of a command buffer recording. Each record is the type, an id
+// and the size of the data that follows, as uint32s.
+enum CommandBufferRecordType {
+  // The ring buffer was set to the transfer buffer |id|. No data.
+  kCommandBufferRecordSetGetBuffer = 1,
+  // The contents of transfer buffer |id| were set to the data.
+  kCommandBufferRecordTransferBuffer = 2,
+  // Transfer buffer |id| was destroyed. No data.
+  kCommandBufferRecordDestroyTransferBuffer = 3,
+  // The data is the command buffer entries of a flush, in order. |id| is 0.
+  kCommandBufferRecordCommands = 4,
+};
+
+// Records the commands flushed to a CommandBufferService, and the contents of
+// the transfer buffers they refer to, to a file that command_buffer_replay can
+// replay without a browser. The transfer buffers are compared with their last
+// recorded contents on each flush, which makes flushes much slower; this is
+// meant for capturing reproductions of problems only.
+class GPU_EXPORT CommandBufferRecorder {
+ public:
+  // Returns NULL if |path| cannot be written.
+  static scoped_ptr<CommandBufferRecorder> Create(
+      const base::FilePath& path,
+      TransferBufferManagerInterface* transfer_buffer_manager);
+  ~CommandBufferRecorder();
+
+  void RecordSetGetBuffer(int32 id);
+  void RecordRegisterTransferBuffer(int32 id);
+  void RecordDestroyTransferBuffer(int32 id);
+
+  // Records the entries of |ring_buffer| from |begin| up to |end|, wrapping
+  // around its end, after the transfer buffers that changed since the last
+  // flush.
+  void RecordFlush(const Buffer& ring_buffer, int32 begin, int32 end);
+
+ private:
+  CommandBufferRecorder(
+      FILE* file,
+      TransferBufferManagerInterface* transfer_buffer_manager);
+
+  void RecordChangedTransferBuffers();
+  void WriteRecord(CommandBufferRecordType type,
+                   int32 id,
+                   const void* data,
+                   size_t size);
+  void WriteData(const void* data, size_t size);
+
+  FILE* file_;
+  TransferBufferManagerInterface* transfer_buffer_manager_;
+  int32 ring_buffer_id_;
+
+  // The contents of the transfer buffers as last recorded.
+  typedef std::map<int32, std::vector<uint8> > TransferBufferMap;
+  TransferBufferMap transfer_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(CommandBufferRecorder);
+};
+
+// Reads the records written by a CommandBufferRecorder.
+class GPU_EXPORT CommandBufferRecordingReader {
+ public:
+  // Returns NULL if |path| cannot be read or is not a recording.
+  static scoped_ptr<CommandBufferRecordingReader> Create(
+      const base::FilePath& path);
+  ~CommandBufferRecordingReader();
+
+  // Reads the next record. Returns false at the end of the recording, or if
+  // the rest of it is truncated.
+  bool ReadRecord(CommandBufferRecordType* type,
+                  int32* id,
+                  std::vector<uint8>* data);
+
+ private:
+  explicit CommandBufferRecordingReader(FILE* file);
+
+  FILE* file_;
+
+  DISALLOW_COPY_AND_ASSIGN(CommandBufferRecordingReader);
+};
+
+}  // namespace gpu
+
+#endif  // GPU_COMMAND_BUFFER_SERVICE_COMMAND_BUFFER_RECORDER_H_
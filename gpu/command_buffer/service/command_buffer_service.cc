@@ -10,6 +10,7 @@
 #include "base/debug/trace_event.h"
 #include "gpu/command_buffer/common/cmd_buffer_common.h"
 #include "gpu/command_buffer/common/command_buffer_shared.h"
+#include "gpu/command_buffer/service/command_buffer_recorder.h"
 #include "gpu/command_buffer/service/transfer_buffer_manager.h"
 
 using ::base::SharedMemory;
@@ -23,6 +24,7 @@ CommandBufferService::CommandBufferService(
       num_entries_(0),
       get_offset_(0),
       put_offset_(0),
+      posted_flush_count_(0),
       transfer_buffer_manager_(transfer_buffer_manager),
       token_(0),
       generation_(0),
@@ -72,7 +74,7 @@ CommandBufferService::State CommandBufferService::FlushSync(
     return GetState();
   }
 
-  put_offset_ = put_offset;
+  SetPutOffset(put_offset);
 
   if (!put_offset_change_callback_.is_null())
     put_offset_change_callback_.Run();
@@ -86,10 +88,43 @@ void CommandBufferService::Flush(int32 put_offset) {
     return;
   }
 
-  put_offset_ = put_offset;
+  SetPutOffset(put_offset);
 
-  if (!put_offset_change_callback_.is_null())
+  if (put_offset_change_callback_.is_null())
+    return;
+  if (!shared_state_) {
     put_offset_change_callback_.Run();
+    return;
+  }
+
+  shared_state_->SetServiceBusy(true);
+  put_offset_change_callback_.Run();
+  for (;;) {
+    shared_state_->SetServiceBusy(false);
+    int32 posted_put_offset;
+    if (error_ != error::kNoError ||
+        !shared_state_->GetPostedPutOffset(&posted_flush_count_,
+                                           &posted_put_offset)) {
+      break;
+    }
+    if (posted_put_offset < 0 || posted_put_offset > num_entries_) {
+      error_ = gpu::error::kOutOfBounds;
+      break;
+    }
+    // The client also posts the put offsets it sends in flush messages.
+    if (posted_put_offset == put_offset_)
+      continue;
+    TRACE_EVENT1("gpu", "CommandBufferService::Flush posted",
+                 "put_offset", posted_put_offset);
+    bool caught_up = get_offset_ == put_offset_;
+    SetPutOffset(posted_put_offset);
+    // If the callback stopped early, it is called again for the rest, posted
+    // commands included, when the command buffer is rescheduled.
+    if (!caught_up)
+      break;
+    shared_state_->SetServiceBusy(true);
+    put_offset_change_callback_.Run();
+  }
 }
 
 void CommandBufferService::SetGetBuffer(int32 transfer_buffer_id) {
@@ -99,6 +134,8 @@ void CommandBufferService::SetGetBuffer(int32 transfer_buffer_id) {
   DCHECK(ring_buffer_.ptr);
   ring_buffer_id_ = transfer_buffer_id;
   num_entries_ = ring_buffer_.size / sizeof(CommandBufferEntry);
+  if (recorder_)
+    recorder_->RecordSetGetBuffer(transfer_buffer_id);
   put_offset_ = 0;
   SetGetOffset(0);
   if (!get_buffer_change_callback_.is_null()) {
@@ -147,6 +184,8 @@ Buffer CommandBufferService::CreateTransferBuffer(size_t size,
 
 void CommandBufferService::DestroyTransferBuffer(int32 id) {
   transfer_buffer_manager_->DestroyTransferBuffer(id);
+  if (recorder_)
+    recorder_->RecordDestroyTransferBuffer(id);
   if (id == ring_buffer_id_) {
     ring_buffer_id_ = -1;
     ring_buffer_ = Buffer();
@@ -164,9 +203,25 @@ bool CommandBufferService::RegisterTransferBuffer(
     int32 id,
     base::SharedMemory* shared_memory,
     size_t size) {
-  return transfer_buffer_manager_->RegisterTransferBuffer(id,
-                                                          shared_memory,
-                                                          size);
+  if (!transfer_buffer_manager_->RegisterTransferBuffer(id,
+                                                        shared_memory,
+                                                        size)) {
+    return false;
+  }
+  if (recorder_)
+    recorder_->RecordRegisterTransferBuffer(id);
+  return true;
+}
+
+void CommandBufferService::SetRecorder(
+    scoped_ptr<CommandBufferRecorder> recorder) {
+  recorder_ = recorder.Pass();
+}
+
+void CommandBufferService::SetPutOffset(int32 put_offset) {
+  if (recorder_)
+    recorder_->RecordFlush(ring_buffer_, put_offset_, put_offset);
+  put_offset_ = put_offset;
 }
 
 void CommandBufferService::SetToken(int32 token) {
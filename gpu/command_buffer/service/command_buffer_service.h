@@ -6,12 +6,14 @@
 #define GPU_COMMAND_BUFFER_SERVICE_COMMAND_BUFFER_SERVICE_H_
 
 #include "base/callback.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/shared_memory.h"
 #include "gpu/command_buffer/common/command_buffer.h"
 #include "gpu/command_buffer/common/command_buffer_shared.h"
 
 namespace gpu {
 
+class CommandBufferRecorder;
 class TransferBufferManagerInterface;
 
 // An object that implements a shared memory command buffer and a synchronous
@@ -28,6 +30,9 @@ class GPU_EXPORT CommandBufferService : public CommandBuffer {
   virtual State GetState() OVERRIDE;
   virtual State GetLastState() OVERRIDE;
   virtual int32 GetLastToken() OVERRIDE;
+  // While the put offset change callback runs, the client can post further
+  // put offsets to the shared state instead of flushing again. They are
+  // picked up before Flush returns.
   virtual void Flush(int32 put_offset) OVERRIDE;
   virtual State FlushSync(int32 put_offset, int32 last_known_get) OVERRIDE;
   virtual void SetGetBuffer(int32 transfer_buffer_id) OVERRIDE;
@@ -53,6 +58,10 @@ class GPU_EXPORT CommandBufferService : public CommandBuffer {
       const GetBufferChangedCallback& callback);
   virtual void SetParseErrorCallback(const base::Closure& callback);
 
+  // The number of the last flush whose put offset was posted to the shared
+  // state and picked up. Flush messages up to it are out of date.
+  uint32 posted_flush_count() const { return posted_flush_count_; }
+
   // Setup the shared memory that shared state should be copied into.
   bool SetSharedStateBuffer(scoped_ptr<base::SharedMemory> shared_state_shm);
 
@@ -66,7 +75,14 @@ class GPU_EXPORT CommandBufferService : public CommandBuffer {
                               base::SharedMemory* shared_memory,
                               size_t size);
 
+  // Records everything flushed from now on with |recorder|. Call before the
+  // get buffer and transfer buffers are set.
+  void SetRecorder(scoped_ptr<CommandBufferRecorder> recorder);
+
  private:
+  // Sets the put offset, recording the commands up to it.
+  void SetPutOffset(int32 put_offset);
+
   int32 ring_buffer_id_;
   Buffer ring_buffer_;
   scoped_ptr<base::SharedMemory> shared_state_shm_;
@@ -74,6 +90,7 @@ class GPU_EXPORT CommandBufferService : public CommandBuffer {
   int32 num_entries_;
   int32 get_offset_;
   int32 put_offset_;
+  uint32 posted_flush_count_;
   base::Closure put_offset_change_callback_;
   GetBufferChangedCallback get_buffer_change_callback_;
   base::Closure parse_error_callback_;
@@ -82,6 +99,7 @@ class GPU_EXPORT CommandBufferService : public CommandBuffer {
   uint32 generation_;
   error::Error error_;
   error::ContextLostReason context_lost_reason_;
+  scoped_ptr<CommandBufferRecorder> recorder_;
 
   DISALLOW_COPY_AND_ASSIGN(CommandBufferService);
 };
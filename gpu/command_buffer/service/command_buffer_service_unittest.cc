@@ -4,8 +4,13 @@
 
 #include "base/bind.h"
 #include "base/bind_helpers.h"
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/process/process_handle.h"
 #include "base/threading/thread.h"
 #include "gpu/command_buffer/common/cmd_buffer_common.h"
+#include "gpu/command_buffer/common/command_buffer_shared.h"
+#include "gpu/command_buffer/service/command_buffer_recorder.h"
 #include "gpu/command_buffer/service/command_buffer_service.h"
 #include "gpu/command_buffer/service/transfer_buffer_manager.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -57,8 +62,26 @@ class CommandBufferServiceTest : public testing::Test {
     return true;
   }
 
+  // Shares a state buffer with the service, and returns the client's view of
+  // it.
+  CommandBufferSharedState* InitializeSharedState() {
+    shared_state_shm_.reset(new SharedMemory);
+    EXPECT_TRUE(shared_state_shm_->CreateAndMapAnonymous(
+        sizeof(CommandBufferSharedState)));
+    CommandBufferSharedState* shared_state =
+        static_cast<CommandBufferSharedState*>(shared_state_shm_->memory());
+    shared_state->Initialize();
+    base::SharedMemoryHandle handle;
+    EXPECT_TRUE(shared_state_shm_->ShareToProcess(
+        base::GetCurrentProcessHandle(), &handle));
+    EXPECT_TRUE(command_buffer_->SetSharedStateBuffer(
+        make_scoped_ptr(new SharedMemory(handle, false))));
+    return shared_state;
+  }
+
   scoped_ptr<TransferBufferManagerInterface> transfer_buffer_manager_;
   scoped_ptr<CommandBufferService> command_buffer_;
+  scoped_ptr<SharedMemory> shared_state_shm_;
 };
 
 TEST_F(CommandBufferServiceTest, InitializesCommandBuffer) {
@@ -84,8 +107,78 @@ class MockCallbackTest : public CallbackTest {
    MOCK_METHOD1(GetBufferChanged, bool(int32));
 };
 
+// Processes commands up to the put offset, or none if |catch_up| is false,
+// and the first time, posts a new put offset from the client as if it had
+// written more commands in the meantime.
+class StreamingClient {
+ public:
+  StreamingClient(CommandBufferService* command_buffer,
+                  CommandBufferSharedState* shared_state,
+                  bool catch_up)
+      : command_buffer_(command_buffer),
+        shared_state_(shared_state),
+        catch_up_(catch_up),
+        put_offset_changes_(0),
+        posted_while_busy_(false) {}
+
+  void PutOffsetChanged() {
+    if (catch_up_)
+      command_buffer_->SetGetOffset(command_buffer_->GetState().put_offset);
+    if (++put_offset_changes_ == 1)
+      posted_while_busy_ = shared_state_->PostPutOffset(4, 1);
+  }
+
+  int put_offset_changes() const { return put_offset_changes_; }
+  bool posted_while_busy() const { return posted_while_busy_; }
+
+ private:
+  CommandBufferService* command_buffer_;
+  CommandBufferSharedState* shared_state_;
+  bool catch_up_;
+  int put_offset_changes_;
+  bool posted_while_busy_;
+};
+
 }  // anonymous namespace
 
+TEST_F(CommandBufferServiceTest, FlushPicksUpPostedPutOffsets) {
+  Initialize(1024);
+  CommandBufferSharedState* shared_state = InitializeSharedState();
+  StreamingClient client(command_buffer_.get(), shared_state, true);
+  command_buffer_->SetPutOffsetChangeCallback(
+      base::Bind(&StreamingClient::PutOffsetChanged,
+                 base::Unretained(&client)));
+
+  command_buffer_->Flush(2);
+  EXPECT_TRUE(client.posted_while_busy());
+  EXPECT_EQ(2, client.put_offset_changes());
+  EXPECT_EQ(4, GetGetOffset());
+  EXPECT_EQ(4, GetPutOffset());
+
+  // Once the service is idle, the client has to flush.
+  EXPECT_FALSE(shared_state->PostPutOffset(6, 2));
+  command_buffer_->Flush(6);
+  EXPECT_EQ(3, client.put_offset_changes());
+  EXPECT_EQ(6, GetPutOffset());
+}
+
+TEST_F(CommandBufferServiceTest, PostedPutOffsetWaitsForReschedule) {
+  Initialize(1024);
+  CommandBufferSharedState* shared_state = InitializeSharedState();
+  StreamingClient client(command_buffer_.get(), shared_state, false);
+  command_buffer_->SetPutOffsetChangeCallback(
+      base::Bind(&StreamingClient::PutOffsetChanged,
+                 base::Unretained(&client)));
+
+  // The commands were not all processed, so the posted put offset is only
+  // recorded, for when the command buffer is rescheduled.
+  command_buffer_->Flush(2);
+  EXPECT_TRUE(client.posted_while_busy());
+  EXPECT_EQ(1, client.put_offset_changes());
+  EXPECT_EQ(0, GetGetOffset());
+  EXPECT_EQ(4, GetPutOffset());
+}
+
 TEST_F(CommandBufferServiceTest, CanSyncGetAndPutOffset) {
   Initialize(1024);
 
@@ -153,4 +246,54 @@ TEST_F(CommandBufferServiceTest, CanSetParseError) {
   command_buffer_->SetParseError(error::kInvalidSize);
   EXPECT_EQ(1, GetError());
 }
+
+TEST_F(CommandBufferServiceTest, RecordsFlushes) {
+  base::FilePath path;
+  ASSERT_TRUE(base::CreateTemporaryFile(&path));
+  command_buffer_->SetRecorder(
+      CommandBufferRecorder::Create(path, transfer_buffer_manager_.get()));
+
+  int32 ring_buffer_id;
+  command_buffer_->CreateTransferBuffer(1024, &ring_buffer_id);
+  command_buffer_->SetGetBuffer(ring_buffer_id);
+  int32 transfer_buffer_id;
+  Buffer transfer_buffer =
+      command_buffer_->CreateTransferBuffer(16, &transfer_buffer_id);
+  memset(transfer_buffer.ptr, 7, transfer_buffer.size);
+  command_buffer_->Flush(200);
+
+  // Expect unchanged transfer buffers not to be recorded again, and the
+  // commands to be recorded across the end of the ring buffer.
+  command_buffer_->SetGetOffset(200);
+  command_buffer_->Flush(10);
+
+  // Destroying the recorder closes the file.
+  command_buffer_->SetRecorder(scoped_ptr<CommandBufferRecorder>());
+
+  scoped_ptr<CommandBufferRecordingReader> reader =
+      CommandBufferRecordingReader::Create(path);
+  ASSERT_TRUE(reader);
+  CommandBufferRecordType type;
+  int32 id;
+  std::vector<uint8> data;
+  ASSERT_TRUE(reader->ReadRecord(&type, &id, &data));
+  EXPECT_EQ(kCommandBufferRecordSetGetBuffer, type);
+  EXPECT_EQ(ring_buffer_id, id);
+  ASSERT_TRUE(reader->ReadRecord(&type, &id, &data));
+  EXPECT_EQ(kCommandBufferRecordTransferBuffer, type);
+  EXPECT_EQ(transfer_buffer_id, id);
+  ASSERT_EQ(16u, data.size());
+  EXPECT_EQ(7, data[15]);
+  ASSERT_TRUE(reader->ReadRecord(&type, &id, &data));
+  EXPECT_EQ(kCommandBufferRecordCommands, type);
+  EXPECT_EQ(200 * sizeof(CommandBufferEntry), data.size());
+  ASSERT_TRUE(reader->ReadRecord(&type, &id, &data));
+  EXPECT_EQ(kCommandBufferRecordCommands, type);
+  EXPECT_EQ(66 * sizeof(CommandBufferEntry), data.size());
+  EXPECT_FALSE(reader->ReadRecord(&type, &id, &data));
+
+  reader.reset();
+  base::DeleteFile(path, false);
+}
+
 }  // namespace gpu
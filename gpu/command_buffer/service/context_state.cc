@@ -4,6 +4,8 @@
 
 #include "gpu/command_buffer/service/context_state.h"
 
+#include <string.h>
+
 #include "gpu/command_buffer/common/gles2_cmd_utils.h"
 #include "gpu/command_buffer/service/buffer_manager.h"
 #include "gpu/command_buffer/service/error_state.h"
@@ -46,6 +48,47 @@ GLuint GetArbServiceId(const TextureUnit& unit) {
       ? unit.bound_texture_rectangle_arb->service_id() : 0;
 }
 
+GLuint GetBufferServiceId(const Buffer* buffer) {
+  return buffer ? buffer->service_id() : 0;
+}
+
+GLuint GetProgramServiceId(const ContextState* state) {
+  return state->current_program.get() ? state->current_program->service_id()
+                                      : 0;
+}
+
+GLuint GetRenderbufferServiceId(const ContextState* state) {
+  return state->bound_renderbuffer.get()
+      ? state->bound_renderbuffer->service_id() : 0;
+}
+
+// Returns true if vertex attribute |index| is set up the same way in |state|
+// and |prev_state|.
+bool AttribMatches(const ContextState* state,
+                   const ContextState* prev_state,
+                   GLuint index) {
+  if (!prev_state->vertex_attrib_manager.get() ||
+      index >= prev_state->vertex_attrib_manager->num_attribs()) {
+    return false;
+  }
+  const VertexAttrib* attrib =
+      state->vertex_attrib_manager->GetVertexAttrib(index);
+  const VertexAttrib* prev_attrib =
+      prev_state->vertex_attrib_manager->GetVertexAttrib(index);
+  return GetBufferServiceId(attrib->buffer()) ==
+             GetBufferServiceId(prev_attrib->buffer()) &&
+         attrib->offset() == prev_attrib->offset() &&
+         attrib->size() == prev_attrib->size() &&
+         attrib->type() == prev_attrib->type() &&
+         attrib->normalized() == prev_attrib->normalized() &&
+         attrib->gl_stride() == prev_attrib->gl_stride() &&
+         attrib->divisor() == prev_attrib->divisor() &&
+         attrib->enabled() == prev_attrib->enabled() &&
+         memcmp(state->attrib_values[index].v,
+                prev_state->attrib_values[index].v,
+                sizeof(state->attrib_values[index].v)) == 0;
+}
+
 }  // anonymous namespace.
 
 TextureUnit::TextureUnit()
@@ -172,9 +215,9 @@ void ContextState::RestoreAttribute(GLuint attrib_index) const {
   glVertexAttrib4fv(attrib_index, attrib_values[attrib_index].v);
 }
 
-void ContextState::RestoreGlobalState() const {
-  InitCapabilities();
-  InitState();
+void ContextState::RestoreGlobalState(const ContextState* prev_state) const {
+  InitCapabilities(prev_state);
+  InitState(prev_state);
 }
 
 void ContextState::RestoreState(const ContextState* prev_state) const {
@@ -187,14 +230,23 @@ void ContextState::RestoreState(const ContextState* prev_state) const {
     // TODO(gman): Move this restoration to VertexAttribManager.
     for (size_t attrib = 0; attrib < vertex_attrib_manager->num_attribs();
          ++attrib) {
-      RestoreAttribute(attrib);
+      if (!prev_state || !AttribMatches(this, prev_state, attrib))
+        RestoreAttribute(attrib);
     }
   }
 
+  // Restoring an attribute changes the array buffer binding, so the buffer
+  // bindings are always restored.
   RestoreBufferBindings();
-  RestoreRenderbufferBindings();
-  RestoreProgramBindings();
-  RestoreGlobalState();
+  if (!prev_state ||
+      GetRenderbufferServiceId(this) != GetRenderbufferServiceId(prev_state)) {
+    RestoreRenderbufferBindings();
+  }
+  if (!prev_state ||
+      GetProgramServiceId(this) != GetProgramServiceId(prev_state)) {
+    RestoreProgramBindings();
+  }
+  RestoreGlobalState(prev_state);
 }
 
 ErrorState* ContextState::GetErrorState() {
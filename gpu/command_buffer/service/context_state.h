@@ -98,15 +98,17 @@ struct GPU_EXPORT ContextState {
 
   void Initialize();
 
+  // Sets the GL state to this state. If |prev_state| is not NULL, the GL state
+  // is assumed to be |prev_state|, and only what differs from it is set.
   void RestoreState(const ContextState* prev_state) const;
-  void InitCapabilities() const;
-  void InitState() const;
+  void InitCapabilities(const ContextState* prev_state) const;
+  void InitState(const ContextState* prev_state) const;
 
   void RestoreActiveTexture() const;
   void RestoreAllTextureUnitBindings(const ContextState* prev_state) const;
   void RestoreAttribute(GLuint index) const;
   void RestoreBufferBindings() const;
-  void RestoreGlobalState() const;
+  void RestoreGlobalState(const ContextState* prev_state) const;
   void RestoreProgramBindings() const;
   void RestoreRenderbufferBindings() const;
   void RestoreTextureUnitBindings(
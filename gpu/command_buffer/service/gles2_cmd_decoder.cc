@@ -521,6 +521,9 @@ class GLES2DecoderImpl : public GLES2Decoder,
   // Overridden from AsyncAPIInterface.
   virtual const char* GetCommandName(unsigned int command_id) const OVERRIDE;
 
+  // Overridden from AsyncAPIInterface.
+  virtual bool CanBatchCommand(unsigned int command) const OVERRIDE;
+
   // Overridden from GLES2Decoder.
   virtual bool Initialize(const scoped_refptr<gfx::GLSurface>& surface,
                           const scoped_refptr<gfx::GLContext>& context,
@@ -555,7 +558,7 @@ class GLES2DecoderImpl : public GLES2Decoder,
     state_.RestoreBufferBindings();
   }
   virtual void RestoreGlobalState() const OVERRIDE {
-    state_.RestoreGlobalState();
+    state_.RestoreGlobalState(NULL);
   }
   virtual void RestoreProgramBindings() const OVERRIDE {
     state_.RestoreProgramBindings();
@@ -2502,8 +2505,8 @@ bool GLES2DecoderImpl::Initialize(
   state_.scissor_height = state_.viewport_height;
 
   // Set all the default state because some GL drivers get it wrong.
-  state_.InitCapabilities();
-  state_.InitState();
+  state_.InitCapabilities(NULL);
+  state_.InitState(NULL);
   glActiveTexture(GL_TEXTURE0 + state_.active_texture_unit);
 
   DoBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -3524,6 +3527,63 @@ const char* GLES2DecoderImpl::GetCommandName(unsigned int command_id) const {
 // Note: args is a pointer to the command buffer. As such, it could be changed
 // by a (malicious) client at any time, so if validation has to happen, it
 // should operate on a copy of them.
+bool GLES2DecoderImpl::CanBatchCommand(unsigned int command) const {
+  // Draw-call-heavy content sends long runs of these between draws. They only
+  // set state, so they never unschedule the decoder or move the get pointer,
+  // and the scheduler does not need to look at each one.
+  switch (command) {
+    case cmds::ActiveTexture::kCmdId:
+    case cmds::BindBuffer::kCmdId:
+    case cmds::BindFramebuffer::kCmdId:
+    case cmds::BindRenderbuffer::kCmdId:
+    case cmds::BindTexture::kCmdId:
+    case cmds::BindVertexArrayOES::kCmdId:
+    case cmds::BlendFunc::kCmdId:
+    case cmds::BlendFuncSeparate::kCmdId:
+    case cmds::ColorMask::kCmdId:
+    case cmds::DepthMask::kCmdId:
+    case cmds::Disable::kCmdId:
+    case cmds::DisableVertexAttribArray::kCmdId:
+    case cmds::Enable::kCmdId:
+    case cmds::EnableVertexAttribArray::kCmdId:
+    case cmds::Scissor::kCmdId:
+    case cmds::Uniform1f::kCmdId:
+    case cmds::Uniform1fvImmediate::kCmdId:
+    case cmds::Uniform1i::kCmdId:
+    case cmds::Uniform1ivImmediate::kCmdId:
+    case cmds::Uniform2f::kCmdId:
+    case cmds::Uniform2fvImmediate::kCmdId:
+    case cmds::Uniform2i::kCmdId:
+    case cmds::Uniform2ivImmediate::kCmdId:
+    case cmds::Uniform3f::kCmdId:
+    case cmds::Uniform3fvImmediate::kCmdId:
+    case cmds::Uniform3i::kCmdId:
+    case cmds::Uniform3ivImmediate::kCmdId:
+    case cmds::Uniform4f::kCmdId:
+    case cmds::Uniform4fvImmediate::kCmdId:
+    case cmds::Uniform4i::kCmdId:
+    case cmds::Uniform4ivImmediate::kCmdId:
+    case cmds::UniformMatrix2fvImmediate::kCmdId:
+    case cmds::UniformMatrix3fvImmediate::kCmdId:
+    case cmds::UniformMatrix4fvImmediate::kCmdId:
+    case cmds::UseProgram::kCmdId:
+    case cmds::VertexAttrib1f::kCmdId:
+    case cmds::VertexAttrib1fvImmediate::kCmdId:
+    case cmds::VertexAttrib2f::kCmdId:
+    case cmds::VertexAttrib2fvImmediate::kCmdId:
+    case cmds::VertexAttrib3f::kCmdId:
+    case cmds::VertexAttrib3fvImmediate::kCmdId:
+    case cmds::VertexAttrib4f::kCmdId:
+    case cmds::VertexAttrib4fvImmediate::kCmdId:
+    case cmds::VertexAttribDivisorANGLE::kCmdId:
+    case cmds::VertexAttribPointer::kCmdId:
+    case cmds::Viewport::kCmdId:
+      return true;
+    default:
+      return false;
+  }
+}
+
 error::Error GLES2DecoderImpl::DoCommand(
     unsigned int command,
     unsigned int arg_count,
@@ -3755,6 +3815,7 @@ void GLES2DecoderImpl::RestoreState(const ContextState* prev_state) const {
   // the size of the current framebuffer object.
   RestoreFramebufferBindings();
   state_.RestoreState(prev_state);
+  gpu_state_tracer_->RecordStateRestore(prev_state != NULL);
 }
 
 void GLES2DecoderImpl::RestoreFramebufferBindings() const {
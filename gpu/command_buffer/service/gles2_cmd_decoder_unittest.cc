@@ -8731,6 +8731,40 @@ TEST_F(GLES2DecoderRestoreStateTest, WithPreviousState) {
   GetDecoder()->RestoreAllTextureUnitBindings(&prev_state);
 }
 
+TEST_F(GLES2DecoderRestoreStateTest, GlobalStateWithPreviousState) {
+  InitDecoder(
+      "",      // extensions
+      "3.0",   // gl version
+      false,   // has alpha
+      false,   // has depth
+      false,   // has stencil
+      false,   // request alpha
+      false,   // request depth
+      false,   // request stencil
+      false);  // bind generates resource
+
+  // Construct a previous ContextState that only differs from the decoder's
+  // default state in blending and the depth function.
+  ContextState prev_state(NULL, NULL);
+  prev_state.enable_flags.blend = true;
+  prev_state.depth_func = GL_ALWAYS;
+  const ContextState* state = GetDecoder()->GetContextState();
+  prev_state.viewport_width = state->viewport_width;
+  prev_state.viewport_height = state->viewport_height;
+  prev_state.scissor_width = state->scissor_width;
+  prev_state.scissor_height = state->scissor_height;
+
+  // Expect only the state that differs to be restored.
+  EXPECT_CALL(*gl_, Disable(GL_BLEND))
+      .Times(1)
+      .RetiresOnSaturation();
+  EXPECT_CALL(*gl_, DepthFunc(GL_LESS))
+      .Times(1)
+      .RetiresOnSaturation();
+
+  state->RestoreGlobalState(&prev_state);
+}
+
 TEST_F(GLES2DecoderRestoreStateTest, ActiveUnit1) {
   InitDecoder(
       "",      // extensions
@@ -78,7 +78,7 @@ void GpuScheduler::PutChanged() {
     DCHECK(IsScheduled());
     DCHECK(unschedule_fences_.empty());
 
-    error = parser_->ProcessCommand();
+    error = parser_->ProcessCommands(CommandParser::kParseCommandsSlice);
 
     if (error == error::kDeferCommandUntilLater) {
       DCHECK_GT(unscheduled_count_, 0);
@@ -103,6 +103,13 @@ void GpuScheduler::PutChanged() {
 
     if (unscheduled_count_ > 0)
       break;
+
+    if (time_slice_ != base::TimeDelta() &&
+        base::TimeTicks::HighResNow() - begin_time >= time_slice_) {
+      TRACE_EVENT_INSTANT0("gpu", "GpuScheduler:TimeSliceExpired",
+                           TRACE_EVENT_SCOPE_THREAD);
+      break;
+    }
   }
 
   if (decoder_) {
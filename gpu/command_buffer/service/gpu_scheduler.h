@@ -15,6 +15,7 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/shared_memory.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "gpu/command_buffer/common/command_buffer.h"
 #include "gpu/command_buffer/service/cmd_buffer_engine.h"
 #include "gpu/command_buffer/service/cmd_parser.h"
@@ -64,6 +65,13 @@ class GPU_EXPORT GpuScheduler
     preemption_flag_ = flag;
   }
 
+  // Makes PutChanged return once it has spent |time_slice| processing
+  // commands, leaving the rest for a later call so that other command buffers
+  // get a turn. A zero time slice processes everything that was flushed.
+  void SetTimeSlice(base::TimeDelta time_slice) {
+    time_slice_ = time_slice;
+  }
+
   // Sets whether commands should be processed by this scheduler. Setting to
   // false unschedules. Setting to true reschedules. Whether or not the
   // scheduler is currently scheduled is "reference counted". Every call with
@@ -160,6 +168,8 @@ class GPU_EXPORT GpuScheduler
   scoped_refptr<PreemptionFlag> preemption_flag_;
   bool was_preempted_;
 
+  base::TimeDelta time_slice_;
+
   DISALLOW_COPY_AND_ASSIGN(GpuScheduler);
 };
 
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "base/message_loop/message_loop.h"
+#include "base/threading/platform_thread.h"
 #include "gpu/command_buffer/common/command_buffer_mock.h"
 #include "gpu/command_buffer/service/gles2_cmd_decoder.h"
 #include "gpu/command_buffer/service/gles2_cmd_decoder_mock.h"
@@ -18,6 +19,7 @@
 using testing::_;
 using testing::DoAll;
 using testing::Invoke;
+using testing::InvokeWithoutArgs;
 using testing::NiceMock;
 using testing::Return;
 using testing::SetArgumentPointee;
@@ -157,6 +159,40 @@ TEST_F(GpuSchedulerTest, ProcessesTwoCommands) {
   scheduler_->PutChanged();
 }
 
+void SleepForTwoMilliseconds() {
+  base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(2));
+}
+
+TEST_F(GpuSchedulerTest, StopsProcessingWhenTimeSliceExpires) {
+  CommandHeader* header = reinterpret_cast<CommandHeader*>(&buffer_[0]);
+  header[0].command = 7;
+  header[0].size = 2;
+  buffer_[1] = 123;
+  header[2].command = 8;
+  header[2].size = 1;
+
+  CommandBuffer::State state;
+
+  state.put_offset = 3;
+  EXPECT_CALL(*command_buffer_, GetState())
+    .WillRepeatedly(Return(state));
+
+  scheduler_->SetTimeSlice(base::TimeDelta::FromMilliseconds(1));
+
+  // The first command uses up the time slice, so the second one is left for
+  // the next call.
+  EXPECT_CALL(*decoder_, DoCommand(7, 1, &buffer_[0]))
+    .WillOnce(DoAll(InvokeWithoutArgs(SleepForTwoMilliseconds),
+                    Return(error::kNoError)));
+  EXPECT_CALL(*command_buffer_, SetGetOffset(2));
+  scheduler_->PutChanged();
+
+  EXPECT_CALL(*decoder_, DoCommand(8, 0, &buffer_[2]))
+    .WillOnce(Return(error::kNoError));
+  EXPECT_CALL(*command_buffer_, SetGetOffset(3));
+  scheduler_->PutChanged();
+}
+
 TEST_F(GpuSchedulerTest, SetsErrorCodeOnCommandBuffer) {
   CommandHeader* header = reinterpret_cast<CommandHeader*>(&buffer_[0]);
   header[0].command = 7;
@@ -101,7 +101,10 @@ scoped_ptr<GPUStateTracer> GPUStateTracer::Create(const ContextState* state) {
   return scoped_ptr<GPUStateTracer>(new GPUStateTracer(state));
 }
 
-GPUStateTracer::GPUStateTracer(const ContextState* state) : state_(state) {
+GPUStateTracer::GPUStateTracer(const ContextState* state)
+    : state_(state),
+      full_state_restores_(0),
+      partial_state_restores_(0) {
   TRACE_EVENT_OBJECT_CREATED_WITH_ID(
       TRACE_DISABLED_BY_DEFAULT("gpu.debug"), "gpu::State", state_);
 }
@@ -128,5 +131,19 @@ void GPUStateTracer::TakeSnapshotWithCurrentFramebuffer(const gfx::Size& size) {
       scoped_refptr<base::debug::ConvertableToTraceFormat>(snapshot));
 }
 
+void GPUStateTracer::RecordStateRestore(bool partial) {
+  if (partial)
+    ++partial_state_restores_;
+  else
+    ++full_state_restores_;
+  TRACE_COUNTER_ID2(TRACE_DISABLED_BY_DEFAULT("gpu.debug"),
+                    "gpu::StateRestores",
+                    state_,
+                    "full",
+                    full_state_restores_,
+                    "partial",
+                    partial_state_restores_);
+}
+
 }  // namespace gles2
 }  // namespace gpu
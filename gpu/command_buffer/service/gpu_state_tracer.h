@@ -26,10 +26,17 @@ class GPUStateTracer {
   // Take a state snapshot with a screenshot of the currently bound framebuffer.
   void TakeSnapshotWithCurrentFramebuffer(const gfx::Size& size);
 
+  // Counts a restore of the state when switching to this context. |partial|
+  // is true when only the state that differs from the previous context's is
+  // set.
+  void RecordStateRestore(bool partial);
+
  private:
   explicit GPUStateTracer(const ContextState* state);
 
   const ContextState* state_;
+  int full_state_restores_;
+  int partial_state_restores_;
   DISALLOW_COPY_AND_ASSIGN(GPUStateTracer);
 };
 
@@ -64,6 +64,15 @@ const char kDisableGpuShaderDiskCache[]     = "disable-gpu-shader-disk-cache";
 const char kEnableShareGroupAsyncTextureUpload[] =
     "enable-share-group-async-texture-upload";
 
+// Makes desktop GL do async texture uploads on the GPU main thread, when it
+// would otherwise do them on a thread via GL context sharing.
+const char kDisableShareGroupAsyncTextureUpload[] =
+    "disable-share-group-async-texture-upload";
+
+// Records the commands of each command buffer to a file in the given
+// directory, for replay with command_buffer_replay. Needs --no-sandbox.
+const char kRecordCommandBuffers[] = "record-command-buffers";
+
 const char* kGpuSwitches[] = {
   kCompileShaderAlwaysSucceeds,
   kDisableGLErrorLimit,
@@ -82,6 +91,8 @@ const char* kGpuSwitches[] = {
   kGpuProgramCacheSizeKb,
   kDisableGpuShaderDiskCache,
   kEnableShareGroupAsyncTextureUpload,
+  kDisableShareGroupAsyncTextureUpload,
+  kRecordCommandBuffers,
 };
 
 const int kNumGpuSwitches = arraysize(kGpuSwitches);
@@ -32,6 +32,10 @@ size_t GetCacheSizeBytes() {
   return gpu::kDefaultMaxProgramCacheMemoryBytes;
 }
 
+// Translations are a few kilobytes at most, so this many is far less than
+// the program binaries they go with.
+const size_t kMaxTranslatedShaders = 256;
+
 }  // anonymous namespace
 
 namespace gpu {
@@ -81,11 +85,22 @@ void RetrieveShaderInfo(const ShaderInfoProto& proto,
 }
 
 void FillShaderProto(ShaderProto* proto, const char* sha,
-                     const Shader* shader) {
+                     const Shader* shader,
+                     const ProgramCache::TranslatedShader* translated_shader) {
   proto->set_sha(sha, gpu::gles2::ProgramCache::kHashLength);
   StoreShaderInfo(ATTRIB_MAP, proto, shader->attrib_map());
   StoreShaderInfo(UNIFORM_MAP, proto, shader->uniform_map());
   StoreShaderInfo(VARYING_MAP, proto, shader->varying_map());
+  if (translated_shader) {
+    proto->set_translated_source(translated_shader->source);
+    ShaderTranslator::NameMap::const_iterator iter;
+    for (iter = translated_shader->name_map.begin();
+         iter != translated_shader->name_map.end(); ++iter) {
+      NameMapEntryProto* entry = proto->add_name_map();
+      entry->set_hashed_name(iter->first);
+      entry->set_original_name(iter->second);
+    }
+  }
 }
 
 void RunShaderCallback(const ShaderCacheCallback& callback,
@@ -104,22 +119,61 @@ void RunShaderCallback(const ShaderCacheCallback& callback,
 MemoryProgramCache::MemoryProgramCache()
     : max_size_bytes_(GetCacheSizeBytes()),
       curr_size_bytes_(0),
-      store_(ProgramMRUCache::NO_AUTO_EVICT) {
+      store_(ProgramMRUCache::NO_AUTO_EVICT),
+      translated_shaders_(kMaxTranslatedShaders) {
 }
 
 MemoryProgramCache::MemoryProgramCache(const size_t max_cache_size_bytes)
     : max_size_bytes_(max_cache_size_bytes),
       curr_size_bytes_(0),
-      store_(ProgramMRUCache::NO_AUTO_EVICT) {
+      store_(ProgramMRUCache::NO_AUTO_EVICT),
+      translated_shaders_(kMaxTranslatedShaders) {
 }
 
 MemoryProgramCache::~MemoryProgramCache() {}
 
 void MemoryProgramCache::ClearBackend() {
   store_.Clear();
+  translated_shaders_.Clear();
   DCHECK_EQ(0U, curr_size_bytes_);
 }
 
+const ProgramCache::TranslatedShader* MemoryProgramCache::PeekTranslatedShader(
+    const char* sha) const {
+  TranslatedShaderMRUCache::const_iterator found =
+      translated_shaders_.Peek(std::string(sha, kHashLength));
+  return found == translated_shaders_.end() ? NULL : &found->second;
+}
+
+bool MemoryProgramCache::LoadTranslatedShader(
+    const std::string& shader,
+    const ShaderTranslatorInterface* translator,
+    TranslatedShader* translated_shader) {
+  char sha[kHashLength];
+  ComputeShaderHash(shader, translator, sha);
+  TranslatedShaderMRUCache::iterator found =
+      translated_shaders_.Get(std::string(sha, kHashLength));
+  if (found == translated_shaders_.end())
+    return false;
+  *translated_shader = found->second;
+  return true;
+}
+
+void MemoryProgramCache::SaveTranslatedShader(
+    const std::string& shader,
+    const ShaderTranslatorInterface* translator) {
+  DCHECK(translator);
+  char sha[kHashLength];
+  ComputeShaderHash(shader, translator, sha);
+  TranslatedShader translated_shader;
+  translated_shader.source = translator->translated_shader();
+  translated_shader.attrib_map = translator->attrib_map();
+  translated_shader.uniform_map = translator->uniform_map();
+  translated_shader.varying_map = translator->varying_map();
+  translated_shader.name_map = translator->name_map();
+  translated_shaders_.Put(std::string(sha, kHashLength), translated_shader);
+}
+
 ProgramCache::ProgramLoadResult MemoryProgramCache::LoadLinkedProgram(
     GLuint program,
     Shader* shader_a,
@@ -174,8 +228,10 @@ ProgramCache::ProgramLoadResult MemoryProgramCache::LoadLinkedProgram(
     proto->set_format(value->format());
     proto->set_program(value->data(), value->length());
 
-    FillShaderProto(proto->mutable_vertex_shader(), a_sha, shader_a);
-    FillShaderProto(proto->mutable_fragment_shader(), b_sha, shader_b);
+    FillShaderProto(proto->mutable_vertex_shader(), a_sha, shader_a,
+                    PeekTranslatedShader(a_sha));
+    FillShaderProto(proto->mutable_fragment_shader(), b_sha, shader_b,
+                    PeekTranslatedShader(b_sha));
     RunShaderCallback(shader_callback, proto.get(), sha_string);
   }
 
@@ -243,8 +299,10 @@ void MemoryProgramCache::SaveLinkedProgram(
     proto->set_format(format);
     proto->set_program(binary.get(), length);
 
-    FillShaderProto(proto->mutable_vertex_shader(), a_sha, shader_a);
-    FillShaderProto(proto->mutable_fragment_shader(), b_sha, shader_b);
+    FillShaderProto(proto->mutable_vertex_shader(), a_sha, shader_a,
+                    PeekTranslatedShader(a_sha));
+    FillShaderProto(proto->mutable_fragment_shader(), b_sha, shader_b,
+                    PeekTranslatedShader(b_sha));
     RunShaderCallback(shader_callback, proto.get(), sha_string);
   }
 
@@ -305,6 +363,17 @@ void MemoryProgramCache::LoadProgram(const std::string& program) {
                          &fragment_varyings);
     }
 
+    // Translations saved with the program are usable even if the binary no
+    // longer loads, for example after a driver update.
+    if (proto->vertex_shader().has_translated_source()) {
+      RetrieveTranslatedShader(proto->vertex_shader(), vertex_attribs,
+                               vertex_uniforms, vertex_varyings);
+    }
+    if (proto->fragment_shader().has_translated_source()) {
+      RetrieveTranslatedShader(proto->fragment_shader(), fragment_attribs,
+                               fragment_uniforms, fragment_varyings);
+    }
+
     scoped_ptr<char[]> binary(new char[proto->program().length()]);
     memcpy(binary.get(), proto->program().c_str(), proto->program().length());
 
@@ -330,6 +399,23 @@ void MemoryProgramCache::LoadProgram(const std::string& program) {
   }
 }
 
+void MemoryProgramCache::RetrieveTranslatedShader(
+    const ShaderProto& proto,
+    const ShaderTranslator::VariableMap& attrib_map,
+    const ShaderTranslator::VariableMap& uniform_map,
+    const ShaderTranslator::VariableMap& varying_map) {
+  TranslatedShader translated_shader;
+  translated_shader.source = proto.translated_source();
+  translated_shader.attrib_map = attrib_map;
+  translated_shader.uniform_map = uniform_map;
+  translated_shader.varying_map = varying_map;
+  for (int i = 0; i < proto.name_map_size(); i++) {
+    translated_shader.name_map[proto.name_map(i).hashed_name()] =
+        proto.name_map(i).original_name();
+  }
+  translated_shaders_.Put(proto.sha(), translated_shader);
+}
+
 MemoryProgramCache::ProgramCacheValue::ProgramCacheValue(
     GLsizei length,
     GLenum format,
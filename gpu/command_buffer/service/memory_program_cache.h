@@ -16,6 +16,8 @@
 #include "gpu/command_buffer/service/program_cache.h"
 #include "gpu/command_buffer/service/shader_translator.h"
 
+class ShaderProto;
+
 namespace gpu {
 namespace gles2 {
 
@@ -45,9 +47,27 @@ class GPU_EXPORT MemoryProgramCache : public ProgramCache {
 
   virtual void LoadProgram(const std::string& program) OVERRIDE;
 
+  virtual bool LoadTranslatedShader(
+      const std::string& shader,
+      const ShaderTranslatorInterface* translator,
+      TranslatedShader* translated_shader) OVERRIDE;
+  virtual void SaveTranslatedShader(
+      const std::string& shader,
+      const ShaderTranslatorInterface* translator) OVERRIDE;
+
  private:
   virtual void ClearBackend() OVERRIDE;
 
+  // Returns the translation of the shader with hash |sha|, or NULL.
+  const TranslatedShader* PeekTranslatedShader(const char* sha) const;
+
+  // Adds the translation saved in |proto| to |translated_shaders_|.
+  void RetrieveTranslatedShader(
+      const ShaderProto& proto,
+      const ShaderTranslator::VariableMap& attrib_map,
+      const ShaderTranslator::VariableMap& uniform_map,
+      const ShaderTranslator::VariableMap& varying_map);
+
   class ProgramCacheValue : public base::RefCounted<ProgramCacheValue> {
    public:
     ProgramCacheValue(GLsizei length,
@@ -134,10 +154,15 @@ class GPU_EXPORT MemoryProgramCache : public ProgramCache {
 
   typedef base::MRUCache<std::string,
                          scoped_refptr<ProgramCacheValue> > ProgramMRUCache;
+  typedef base::MRUCache<std::string,
+                         TranslatedShader> TranslatedShaderMRUCache;
 
   const size_t max_size_bytes_;
   size_t curr_size_bytes_;
   ProgramMRUCache store_;
+  // Keyed by shader hash.  Translations are small next to program binaries,
+  // so they are only limited in number.
+  TranslatedShaderMRUCache translated_shaders_;
 
   DISALLOW_COPY_AND_ASSIGN(MemoryProgramCache);
 };
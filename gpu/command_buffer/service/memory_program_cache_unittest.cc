@@ -7,6 +7,7 @@
 #include "base/bind.h"
 #include "gpu/command_buffer/common/gles2_cmd_format.h"
 #include "gpu/command_buffer/service/gl_utils.h"
+#include "gpu/command_buffer/service/mocks.h"
 #include "gpu/command_buffer/service/shader_manager.h"
 #include "gpu/command_buffer/service/shader_translator.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -16,6 +17,9 @@
 using ::testing::_;
 using ::testing::ElementsAreArray;
 using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::ReturnRef;
 using ::testing::SetArgPointee;
 using ::testing::SetArrayArgument;
 
@@ -642,5 +646,101 @@ TEST_F(MemoryProgramCacheTest, OverwriteOnNewSave) {
                  base::Unretained(this))));
 }
 
+TEST_F(MemoryProgramCacheTest, TranslatedShaderSaveAndLoad) {
+  VariableMap attrib_map;
+  attrib_map["a"] = ShaderTranslatorInterface::VariableInfo(
+      GL_FLOAT_VEC4, 1, SH_PRECISION_HIGHP, 1, "a");
+  VariableMap empty_map;
+  ShaderTranslator::NameMap name_map;
+  name_map["webgl_1"] = "a";
+  NiceMock<MockShaderTranslator> translator;
+  ON_CALL(translator, GetStringForOptionsThatWouldEffectCompilation())
+      .WillByDefault(Return("options"));
+  ON_CALL(translator, translated_shader())
+      .WillByDefault(Return("translated"));
+  ON_CALL(translator, attrib_map()).WillByDefault(ReturnRef(attrib_map));
+  ON_CALL(translator, uniform_map()).WillByDefault(ReturnRef(empty_map));
+  ON_CALL(translator, varying_map()).WillByDefault(ReturnRef(empty_map));
+  ON_CALL(translator, name_map()).WillByDefault(ReturnRef(name_map));
+
+  ProgramCache::TranslatedShader translated_shader;
+  EXPECT_FALSE(cache_->LoadTranslatedShader(
+      *vertex_shader_->source(), &translator, &translated_shader));
+  cache_->SaveTranslatedShader(*vertex_shader_->source(), &translator);
+
+  EXPECT_FALSE(cache_->LoadTranslatedShader(
+      *fragment_shader_->source(), &translator, &translated_shader));
+  EXPECT_FALSE(cache_->LoadTranslatedShader(
+      *vertex_shader_->source(), NULL, &translated_shader));
+  EXPECT_TRUE(cache_->LoadTranslatedShader(
+      *vertex_shader_->source(), &translator, &translated_shader));
+  EXPECT_EQ("translated", translated_shader.source);
+  EXPECT_EQ(1u, translated_shader.attrib_map.size());
+  EXPECT_EQ("a", translated_shader.name_map["webgl_1"]);
+
+  // A translation made by another version of the translator is not used.
+  cache_->set_translator_version("other");
+  EXPECT_FALSE(cache_->LoadTranslatedShader(
+      *vertex_shader_->source(), &translator, &translated_shader));
+}
+
+TEST_F(MemoryProgramCacheTest, TranslatedShaderSavedWithProgram) {
+  const GLenum kFormat = 1;
+  const int kProgramId = 10;
+  const int kBinaryLength = 20;
+  char test_binary[kBinaryLength];
+  for (int i = 0; i < kBinaryLength; ++i) {
+    test_binary[i] = i;
+  }
+  ProgramBinaryEmulator emulator(kBinaryLength, kFormat, test_binary);
+
+  ShaderTranslator::NameMap name_map;
+  name_map["webgl_1"] = "a";
+  NiceMock<MockShaderTranslator> translator;
+  ON_CALL(translator, GetStringForOptionsThatWouldEffectCompilation())
+      .WillByDefault(Return("options"));
+  ON_CALL(translator, translated_shader())
+      .WillByDefault(Return("translated"));
+  ON_CALL(translator, attrib_map())
+      .WillByDefault(ReturnRef(vertex_shader_->attrib_map()));
+  ON_CALL(translator, uniform_map())
+      .WillByDefault(ReturnRef(vertex_shader_->uniform_map()));
+  ON_CALL(translator, varying_map())
+      .WillByDefault(ReturnRef(vertex_shader_->varying_map()));
+  ON_CALL(translator, name_map()).WillByDefault(ReturnRef(name_map));
+  cache_->SaveTranslatedShader(*vertex_shader_->source(), &translator);
+
+  SetExpectationsForSaveLinkedProgram(kProgramId, &emulator);
+  cache_->SaveLinkedProgram(kProgramId, vertex_shader_, &translator,
+                            fragment_shader_, NULL, NULL,
+                            base::Bind(&MemoryProgramCacheTest::ShaderCacheCb,
+                                       base::Unretained(this)));
+  EXPECT_EQ(1, shader_cache_count());
+
+  // The program comes back from disk with a new cache, and its binary is no
+  // use to another driver, but the translation still is.
+  cache_.reset(new MemoryProgramCache(kCacheSizeBytes));
+  cache_->set_driver_version("other");
+  cache_->LoadProgram(shader_cache_shader());
+  EXPECT_EQ(ProgramCache::LINK_UNKNOWN, cache_->GetLinkedProgramStatus(
+      *vertex_shader_->signature_source(),
+      &translator,
+      *fragment_shader_->signature_source(),
+      NULL,
+      NULL));
+
+  ProgramCache::TranslatedShader translated_shader;
+  EXPECT_TRUE(cache_->LoadTranslatedShader(
+      *vertex_shader_->source(), &translator, &translated_shader));
+  EXPECT_EQ("translated", translated_shader.source);
+  EXPECT_EQ("a", translated_shader.name_map["webgl_1"]);
+#if !defined(OS_ANDROID)
+  EXPECT_EQ(vertex_shader_->attrib_map(), translated_shader.attrib_map);
+  EXPECT_EQ(vertex_shader_->uniform_map(), translated_shader.uniform_map);
+#endif
+  EXPECT_FALSE(cache_->LoadTranslatedShader(
+      *fragment_shader_->source(), NULL, &translated_shader));
+}
+
 }  // namespace gles2
 }  // namespace gpu
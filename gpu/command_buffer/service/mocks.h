@@ -56,6 +56,8 @@ class AsyncAPIMock : public AsyncAPIInterface {
       unsigned int arg_count,
       const void* cmd_data));
 
+  MOCK_CONST_METHOD1(CanBatchCommand, bool(unsigned int command));
+
   const char* GetCommandName(unsigned int command_id) const {
     return "";
   };
@@ -119,6 +121,13 @@ class MockProgramCache : public ProgramCache {
       const LocationMap* bind_attrib_location_map,
       const ShaderCacheCallback& callback));
   MOCK_METHOD1(LoadProgram, void(const std::string&));
+  MOCK_METHOD3(LoadTranslatedShader, bool(
+      const std::string& shader,
+      const ShaderTranslatorInterface* translator,
+      TranslatedShader* translated_shader));
+  MOCK_METHOD2(SaveTranslatedShader, void(
+      const std::string& shader,
+      const ShaderTranslatorInterface* translator));
 
  private:
   MOCK_METHOD0(ClearBackend, void());
@@ -11,6 +11,9 @@
 namespace gpu {
 namespace gles2 {
 
+ProgramCache::TranslatedShader::TranslatedShader() {}
+ProgramCache::TranslatedShader::~TranslatedShader() {}
+
 ProgramCache::ProgramCache() {}
 ProgramCache::~ProgramCache() {}
 
@@ -75,7 +78,7 @@ void ProgramCache::ComputeShaderHash(
     char* result) const {
   std::string s((
       translator ? translator->GetStringForOptionsThatWouldEffectCompilation() :
-                   std::string()) + str);
+                   std::string()) + translator_version_ + str);
   base::SHA1HashBytes(reinterpret_cast<const unsigned char*>(s.c_str()),
                       s.length(), reinterpret_cast<unsigned char*>(result));
 }
@@ -106,7 +109,9 @@ void ProgramCache::ComputeProgramHash(
   const size_t shader0_size = kHashLength;
   const size_t shader1_size = kHashLength;
   const size_t map_size = CalculateMapSize(bind_attrib_location_map);
-  const size_t total_size = shader0_size + shader1_size + map_size;
+  const size_t driver_size = driver_version_.length();
+  const size_t total_size =
+      shader0_size + shader1_size + map_size + driver_size;
 
   scoped_ptr<unsigned char[]> buffer(new unsigned char[total_size]);
   memcpy(buffer.get(), hashed_shader_0, shader0_size);
@@ -128,6 +133,10 @@ void ProgramCache::ComputeProgramHash(
       buffer[current_pos++] = value;
     }
   }
+  if (driver_size != 0) {
+    memcpy(&buffer[shader0_size + shader1_size + map_size],
+           driver_version_.c_str(), driver_size);
+  }
   base::SHA1HashBytes(buffer.get(),
                       total_size, reinterpret_cast<unsigned char*>(result));
 }
@@ -37,6 +37,18 @@ class GPU_EXPORT ProgramCache {
     PROGRAM_LOAD_SUCCESS
   };
 
+  // What the shader translator made of one shader.
+  struct GPU_EXPORT TranslatedShader {
+    TranslatedShader();
+    ~TranslatedShader();
+
+    std::string source;
+    ShaderTranslator::VariableMap attrib_map;
+    ShaderTranslator::VariableMap uniform_map;
+    ShaderTranslator::VariableMap varying_map;
+    ShaderTranslator::NameMap name_map;
+  };
+
   ProgramCache();
   virtual ~ProgramCache();
 
@@ -71,6 +83,30 @@ class GPU_EXPORT ProgramCache {
 
   virtual void LoadProgram(const std::string& program) = 0;
 
+  // Finds the translation of |shader| that a translator with the options of
+  // |translator| made earlier, possibly in an earlier session, so that the
+  // shader need not be translated again.  Returns false if there is none.
+  virtual bool LoadTranslatedShader(
+      const std::string& shader,
+      const ShaderTranslatorInterface* translator,
+      TranslatedShader* translated_shader) = 0;
+
+  // Saves the translation |translator| just made of |shader|.  It is written
+  // to disk along with the programs the shader is linked into.
+  virtual void SaveTranslatedShader(
+      const std::string& shader,
+      const ShaderTranslatorInterface* translator) = 0;
+
+  // Identify the shader translator and the GL driver in the cache keys, so
+  // that translations made by another translator, and binaries made by
+  // another driver, are never loaded.
+  void set_translator_version(const std::string& version) {
+    translator_version_ = version;
+  }
+  void set_driver_version(const std::string& version) {
+    driver_version_ = version;
+  }
+
   // clears the cache
   void Clear();
 
@@ -108,6 +144,8 @@ class GPU_EXPORT ProgramCache {
   virtual void ClearBackend() = 0;
 
   LinkStatusMap link_status_;
+  std::string translator_version_;
+  std::string driver_version_;
 
   DISALLOW_COPY_AND_ASSIGN(ProgramCache);
 };
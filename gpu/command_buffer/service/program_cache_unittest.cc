@@ -36,6 +36,16 @@ class NoBackendProgramCache : public ProgramCache {
 
   virtual void LoadProgram(const std::string& /* program */) OVERRIDE {}
 
+  virtual bool LoadTranslatedShader(
+      const std::string& /* shader */,
+      const ShaderTranslatorInterface* /* translator */,
+      TranslatedShader* /* translated_shader */) OVERRIDE {
+    return false;
+  }
+  virtual void SaveTranslatedShader(
+      const std::string& /* shader */,
+      const ShaderTranslatorInterface* /* translator */) OVERRIDE {}
+
   virtual void ClearBackend() OVERRIDE {}
 
   void SaySuccessfullyCached(const std::string& shader1,
@@ -468,7 +468,18 @@ void ProgramManager::DoCompileShader(
   // glShaderSource and then glCompileShader.
   const std::string* source = shader->source();
   const char* shader_src = source ? source->c_str() : "";
-  if (translator) {
+  // A shader that was translated before, in this or an earlier session, is
+  // not translated again.
+  ProgramCache::TranslatedShader cached_translation;
+  const bool use_cached_translation =
+      translator && program_cache_ &&
+      program_cache_->LoadTranslatedShader(
+          source ? *source : std::string(), translator, &cached_translation);
+  if (use_cached_translation) {
+    shader_src = cached_translation.source.c_str();
+    if (translated_shader_source_type != kANGLE)
+      shader->UpdateTranslatedSource(shader_src);
+  } else if (translator) {
     if (!translator->Translate(shader_src)) {
       shader->SetStatus(false, translator->info_log(), NULL);
       return;
@@ -496,8 +507,18 @@ void ProgramManager::DoCompileShader(
 
   GLint status = GL_FALSE;
   glGetShaderiv(shader->service_id(), GL_COMPILE_STATUS, &status);
-  if (status) {
+  if (status && use_cached_translation) {
+    shader->SetStatus(true, "", NULL);
+    shader->set_attrib_map(cached_translation.attrib_map);
+    shader->set_uniform_map(cached_translation.uniform_map);
+    shader->set_varying_map(cached_translation.varying_map);
+    shader->set_name_map(cached_translation.name_map);
+  } else if (status) {
     shader->SetStatus(true, "", translator);
+    if (translator && program_cache_) {
+      program_cache_->SaveTranslatedShader(
+          source ? *source : std::string(), translator);
+    }
   } else {
     // We cannot reach here if we are using the shader translator.
     // All invalid shaders must be rejected by the translator.
@@ -120,6 +120,11 @@ class GPU_EXPORT Shader : public base::RefCounted<Shader> {
     varying_map_ = ShaderTranslator::VariableMap(varying_map);
   }
 
+  // Used by program cache.
+  void set_name_map(const ShaderTranslator::NameMap& name_map) {
+    name_map_ = name_map;
+  }
+
  private:
   typedef ShaderTranslator::VariableMap VariableMap;
   typedef ShaderTranslator::NameMap NameMap;
@@ -361,6 +361,25 @@
         'command_buffer/client/gles2_interface_stub.h',
       ],
     },
+    {
+      'target_name': 'command_buffer_replay',
+      'type': 'executable',
+      'dependencies': [
+        '../base/base.gyp:base',
+        '../ui/gfx/gfx.gyp:gfx_geometry',
+        '../ui/gl/gl.gyp:gl',
+        'command_buffer/command_buffer.gyp:gles2_utils',
+        'command_buffer_common',
+        'command_buffer_service',
+        'gpu',
+      ],
+      'include_dirs': [
+        '..',
+      ],
+      'sources': [
+        'tools/command_buffer_replay/command_buffer_replay.cc',
+      ],
+    },
   ],
   'conditions': [
     ['component=="static_library"', {
@@ -0,0 +1,327 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Replays a command buffer recorded by the GPU process with
+// --record-command-buffers=<dir> through a GLES2 decoder on an offscreen
+// surface, and reports how long each type of command took.
+//
+// Usage: command_buffer_replay [--iterations=N] [--finish] [--size=WxH]
+//            <recording>
+//
+// Without --finish, the times are those of decoding the commands and of
+// issuing them to the driver. With --finish, glFinish is called after each
+// command, so that the times include the GPU executing them.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/basictypes.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/memory/linked_ptr.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "gpu/command_buffer/common/cmd_buffer_common.h"
+#include "gpu/command_buffer/common/gles2_cmd_utils.h"
+#include "gpu/command_buffer/service/cmd_buffer_engine.h"
+#include "gpu/command_buffer/service/command_buffer_recorder.h"
+#include "gpu/command_buffer/service/context_group.h"
+#include "gpu/command_buffer/service/gles2_cmd_decoder.h"
+#include "gpu/command_buffer/service/mailbox_manager.h"
+#include "ui/gfx/size.h"
+#include "ui/gl/gl_bindings.h"
+#include "ui/gl/gl_context.h"
+#include "ui/gl/gl_share_group.h"
+#include "ui/gl/gl_surface.h"
+
+namespace {
+
+const char kIterations[] = "iterations";
+const char kFinish[] = "finish";
+const char kSize[] = "size";
+
+struct CommandStats {
+  CommandStats() : count(0) {}
+
+  int64 count;
+  base::TimeDelta time;
+};
+
+typedef std::map<unsigned int, CommandStats> CommandStatsMap;
+
+// Serves the transfer buffers of the recording to the decoder.
+class ReplayEngine : public gpu::CommandBufferEngine {
+ public:
+  ReplayEngine() {}
+  virtual ~ReplayEngine() {}
+
+  void SetTransferBuffer(int32 id, std::vector<uint8>* contents) {
+    linked_ptr<std::vector<uint8> >& buffer = buffers_[id];
+    if (!buffer.get())
+      buffer.reset(new std::vector<uint8>);
+    // Keep the address of the buffer stable if its size does not change.
+    if (buffer->size() == contents->size())
+      std::copy(contents->begin(), contents->end(), buffer->begin());
+    else
+      buffer->swap(*contents);
+  }
+
+  void DestroyTransferBuffer(int32 id) {
+    buffers_.erase(id);
+  }
+
+  // gpu::CommandBufferEngine implementation:
+  virtual gpu::Buffer GetSharedMemoryBuffer(int32 shm_id) OVERRIDE {
+    gpu::Buffer buffer;
+    BufferMap::iterator it = buffers_.find(shm_id);
+    if (it != buffers_.end() && !it->second->empty()) {
+      buffer.ptr = &(*it->second)[0];
+      buffer.size = it->second->size();
+    }
+    return buffer;
+  }
+  virtual void set_token(int32 token) OVERRIDE {}
+  virtual bool SetGetBuffer(int32 transfer_buffer_id) OVERRIDE {
+    return true;
+  }
+  virtual bool SetGetOffset(int32 offset) OVERRIDE { return true; }
+  virtual int32 GetGetOffset() OVERRIDE { return 0; }
+
+ private:
+  typedef std::map<int32, linked_ptr<std::vector<uint8> > > BufferMap;
+  BufferMap buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReplayEngine);
+};
+
+bool RetireSyncPointImmediately(uint32 sync_point) {
+  // The commands the sync point waits for were recorded earlier, or in
+  // another command buffer that is not replayed.
+  return true;
+}
+
+class Replayer {
+ public:
+  Replayer(const gfx::Size& size, bool finish)
+      : size_(size),
+        finish_(finish),
+        deferred_commands_(0) {}
+
+  bool Initialize() {
+    scoped_refptr<gpu::gles2::ContextGroup> group(
+        new gpu::gles2::ContextGroup(new gpu::gles2::MailboxManager,
+                                     NULL,
+                                     NULL,
+                                     NULL,
+                                     true));
+    decoder_.reset(gpu::gles2::GLES2Decoder::Create(group.get()));
+    decoder_->set_engine(&engine_);
+    decoder_->SetWaitSyncPointCallback(
+        base::Bind(&RetireSyncPointImmediately));
+
+    surface_ = gfx::GLSurface::CreateOffscreenGLSurface(size_);
+    if (!surface_.get())
+      return false;
+    context_ = gfx::GLContext::CreateGLContext(
+        new gfx::GLShareGroup, surface_.get(), gfx::PreferDiscreteGpu);
+    if (!context_.get() || !context_->MakeCurrent(surface_.get()))
+      return false;
+
+    std::vector<int32> attribs;
+    gpu::gles2::ContextCreationAttribHelper attrib_helper;
+    attrib_helper.alpha_size_ = 8;
+    attrib_helper.depth_size_ = 24;
+    attrib_helper.stencil_size_ = 8;
+    attrib_helper.Serialize(&attribs);
+    return decoder_->Initialize(surface_,
+                                context_,
+                                true,
+                                size_,
+                                gpu::gles2::DisallowedFeatures(),
+                                attribs);
+  }
+
+  void Destroy() {
+    if (decoder_)
+      decoder_->Destroy(true);
+    decoder_.reset();
+    context_ = NULL;
+    surface_ = NULL;
+  }
+
+  // Returns false if the recording could not be read, or the decoder failed.
+  bool Replay(const base::FilePath& path) {
+    scoped_ptr<gpu::CommandBufferRecordingReader> reader =
+        gpu::CommandBufferRecordingReader::Create(path);
+    if (!reader) {
+      fprintf(stderr, "Could not read a recording from %s.\n",
+              path.MaybeAsASCII().c_str());
+      return false;
+    }
+
+    gpu::CommandBufferRecordType type;
+    int32 id;
+    std::vector<uint8> data;
+    while (reader->ReadRecord(&type, &id, &data)) {
+      switch (type) {
+        case gpu::kCommandBufferRecordTransferBuffer:
+          engine_.SetTransferBuffer(id, &data);
+          break;
+        case gpu::kCommandBufferRecordDestroyTransferBuffer:
+          engine_.DestroyTransferBuffer(id);
+          break;
+        case gpu::kCommandBufferRecordSetGetBuffer:
+          break;
+        case gpu::kCommandBufferRecordCommands:
+          if (!ReplayCommands(data))
+            return false;
+          break;
+      }
+    }
+    glFinish();
+    return true;
+  }
+
+  void PrintStats() const {
+    std::vector<std::pair<base::TimeDelta, unsigned int> > commands;
+    base::TimeDelta total;
+    for (CommandStatsMap::const_iterator it = stats_.begin();
+         it != stats_.end();
+         ++it) {
+      commands.push_back(std::make_pair(it->second.time, it->first));
+      total += it->second.time;
+    }
+    std::sort(commands.rbegin(), commands.rend());
+
+    printf("%-40s %10s %12s %10s\n", "command", "count", "total (ms)",
+           "avg (us)");
+    for (size_t i = 0; i < commands.size(); ++i) {
+      const CommandStats& stats = stats_.find(commands[i].second)->second;
+      printf("%-40s %10ld %12.3f %10.2f\n",
+             decoder_->GetCommandName(commands[i].second),
+             static_cast<long>(stats.count),
+             stats.time.InMillisecondsF(),
+             stats.time.InMicroseconds() / static_cast<double>(stats.count));
+    }
+    printf("%-40s %10s %12.3f\n", "total", "", total.InMillisecondsF());
+    if (deferred_commands_)
+      printf("%ld commands were deferred and skipped.\n",
+             static_cast<long>(deferred_commands_));
+  }
+
+ private:
+  bool ReplayCommands(const std::vector<uint8>& data) {
+    // Copy the entries so that they are suitably aligned.
+    std::vector<gpu::CommandBufferEntry> entries(
+        data.size() / sizeof(gpu::CommandBufferEntry));
+    if (!entries.empty())
+      memcpy(&entries[0], &data[0], data.size());
+
+    for (size_t i = 0; i < entries.size();) {
+      gpu::CommandHeader header = entries[i].value_header;
+      if (!header.size || i + header.size > entries.size()) {
+        fprintf(stderr, "Malformed command at entry %lu.\n",
+                static_cast<unsigned long>(i));
+        return false;
+      }
+
+      base::TimeTicks start = base::TimeTicks::HighResNow();
+      gpu::error::Error error =
+          decoder_->DoCommand(header.command, header.size - 1, &entries[i]);
+      if (finish_)
+        glFinish();
+      CommandStats& stats = stats_[header.command];
+      stats.time += base::TimeTicks::HighResNow() - start;
+      ++stats.count;
+
+      if (error == gpu::error::kDeferCommandUntilLater) {
+        ++deferred_commands_;
+      } else if (gpu::error::IsError(error)) {
+        fprintf(stderr, "%s failed with error %d.\n",
+                decoder_->GetCommandName(header.command), error);
+        return false;
+      }
+      i += header.size;
+    }
+    return true;
+  }
+
+  gfx::Size size_;
+  bool finish_;
+  ReplayEngine engine_;
+  scoped_refptr<gfx::GLSurface> surface_;
+  scoped_refptr<gfx::GLContext> context_;
+  scoped_ptr<gpu::gles2::GLES2Decoder> decoder_;
+  CommandStatsMap stats_;
+  int64 deferred_commands_;
+
+  DISALLOW_COPY_AND_ASSIGN(Replayer);
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::AtExitManager exit_manager;
+  CommandLine::Init(argc, argv);
+  const CommandLine* command_line = CommandLine::ForCurrentProcess();
+  if (command_line->GetArgs().size() != 1) {
+    fprintf(stderr,
+            "Usage: %s [--iterations=N] [--finish] [--size=WxH] "
+            "<recording>\n",
+            argv[0]);
+    return 1;
+  }
+  base::FilePath path(command_line->GetArgs()[0]);
+
+  int iterations = 1;
+  if (command_line->HasSwitch(kIterations) &&
+      (!base::StringToInt(command_line->GetSwitchValueASCII(kIterations),
+                          &iterations) ||
+       iterations < 1)) {
+    fprintf(stderr, "Invalid --%s.\n", kIterations);
+    return 1;
+  }
+  int width = 1024;
+  int height = 1024;
+  if (command_line->HasSwitch(kSize) &&
+      (sscanf(command_line->GetSwitchValueASCII(kSize).c_str(), "%dx%d",
+              &width, &height) != 2 ||
+       width < 1 || height < 1)) {
+    fprintf(stderr, "Invalid --%s.\n", kSize);
+    return 1;
+  }
+
+  base::MessageLoop message_loop;
+  if (!gfx::GLSurface::InitializeOneOff()) {
+    fprintf(stderr, "Could not initialize GL.\n");
+    return 1;
+  }
+
+  // Each iteration replays the recording from the start with a new decoder,
+  // since the recording creates its resources from scratch.
+  for (int i = 0; i < iterations; ++i) {
+    Replayer replayer(gfx::Size(width, height),
+                      command_line->HasSwitch(kFinish));
+    if (!replayer.Initialize()) {
+      fprintf(stderr, "Could not initialize the decoder.\n");
+      return 1;
+    }
+    bool replayed = replayer.Replay(path);
+    printf("Iteration %d:\n", i + 1);
+    replayer.PrintStats();
+    replayer.Destroy();
+    if (!replayed)
+      return 1;
+  }
+  return 0;
+}
@@ -51,6 +51,10 @@ class IPC_EXPORT Channel : public Sender {
     MODE_NAMED_FLAG = 0x4,
 #if defined(OS_POSIX)
     MODE_OPEN_ACCESS_FLAG = 0x8, // Don't restrict access based on client UID.
+    // Move message data through ring buffers in shared memory, set up when
+    // the channel connects, and use the socket only to wake the peer and to
+    // pass file descriptors. Both ends of the channel must set it.
+    MODE_SHARED_MEMORY_FLAG = 0x10,
 #endif
   };
 
@@ -71,7 +75,11 @@ class IPC_EXPORT Channel : public Sender {
     // The caller must then implement their own access-control based on the
     // client process' user Id.
     MODE_OPEN_NAMED_SERVER = MODE_OPEN_ACCESS_FLAG | MODE_SERVER_FLAG |
-                             MODE_NAMED_FLAG
+                             MODE_NAMED_FLAG,
+    // Anonymous channels which move message data through shared memory. See
+    // MODE_SHARED_MEMORY_FLAG.
+    MODE_SHARED_MEMORY_SERVER = MODE_SHARED_MEMORY_FLAG | MODE_SERVER_FLAG,
+    MODE_SHARED_MEMORY_CLIENT = MODE_SHARED_MEMORY_FLAG | MODE_CLIENT_FLAG
 #endif
   };
 
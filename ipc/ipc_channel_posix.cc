@@ -10,13 +10,10 @@
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <unistd.h>
 
-#if defined(OS_OPENBSD)
-#include <sys/uio.h>
-#endif
-
 #include <map>
 #include <string>
 
@@ -31,6 +28,7 @@
 #include "base/posix/global_descriptors.h"
 #include "base/process/process_handle.h"
 #include "base/rand_util.h"
+#include "base/segmented_pickle.h"
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
 #include "base/synchronization/lock.h"
@@ -181,6 +179,9 @@ Channel::ChannelImpl::ChannelImpl(const IPC::ChannelHandle& channel_handle,
       remote_fd_pipe_(-1),
 #endif  // IPC_USES_READWRITE
       pipe_name_(channel_handle.name),
+      message_fds_sent_(false),
+      ring_pipe_drained_(false),
+      ring_peer_closed_(false),
       must_unlink_(false) {
   memset(input_cmsg_buf_, 0, sizeof(input_cmsg_buf_));
   if (!CreatePipe(channel_handle)) {
@@ -308,8 +309,9 @@ bool Channel::ChannelImpl::CreatePipe(
 
 #if defined(IPC_USES_READWRITE)
   // Create a dedicated socketpair() for exchanging file descriptors.
-  // See comments for IPC_USES_READWRITE for details.
-  if (mode_ & MODE_CLIENT_FLAG) {
+  // See comments for IPC_USES_READWRITE for details. With shared memory the
+  // pipe is only read after a wakeup anyway, so descriptors go on it.
+  if ((mode_ & MODE_CLIENT_FLAG) && !(mode_ & MODE_SHARED_MEMORY_FLAG)) {
     if (!SocketPair(&fd_pipe_, &remote_fd_pipe_)) {
       return false;
     }
@@ -377,20 +379,15 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
   if (pipe_ == -1)
     return false;
 
+  if (outbound_ring_.get())
+    return ProcessOutgoingMessagesToRing();
+
   // Write out all the messages we can till the write blocks or there are no
   // more outgoing messages.
   while (!output_queue_.empty()) {
     Message* msg = output_queue_.front();
 
-    size_t amt_to_write = msg->size() - message_send_bytes_written_;
-    DCHECK_NE(0U, amt_to_write);
-    const char* out_bytes = reinterpret_cast<const char*>(msg->data()) +
-        message_send_bytes_written_;
-
     struct msghdr msgh = {0};
-    struct iovec iov = {const_cast<char*>(out_bytes), amt_to_write};
-    msgh.msg_iov = &iov;
-    msgh.msg_iovlen = 1;
     char buf[CMSG_SPACE(
         sizeof(int) * FileDescriptorSet::kMaxDescriptorsPerMessage)];
 
@@ -437,7 +434,6 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
         msgh.msg_iov = &fd_pipe_iov;
         fd_written = fd_pipe_;
         bytes_written = HANDLE_EINTR(sendmsg(fd_pipe_, &msgh, MSG_DONTWAIT));
-        msgh.msg_iov = &iov;
         msgh.msg_controllen = 0;
         if (bytes_written > 0) {
           CloseFileDescriptors(msg);
@@ -446,6 +442,15 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
 #endif  // IPC_USES_READWRITE
     }
 
+    // Filled in after the descriptors above, since they update num_fds.
+    Message::Header wire_header;
+    struct iovec iov[kMaxIOVecsPerWrite];
+    size_t amt_to_write = 0;
+    msgh.msg_iov = iov;
+    msgh.msg_iovlen = FillOutgoingIOVecs(msg, message_send_bytes_written_,
+                                         &wire_header, iov, &amt_to_write);
+    DCHECK_NE(0U, amt_to_write);
+
     if (bytes_written == 1) {
       fd_written = pipe_;
 #if defined(IPC_USES_READWRITE)
@@ -453,7 +458,7 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
         DCHECK_EQ(msg->file_descriptor_set()->size(), 1U);
       }
       if (!msgh.msg_controllen) {
-        bytes_written = HANDLE_EINTR(write(pipe_, out_bytes, amt_to_write));
+        bytes_written = HANDLE_EINTR(writev(pipe_, iov, msgh.msg_iovlen));
       } else
 #endif  // IPC_USES_READWRITE
       {
@@ -482,7 +487,7 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
       PLOG(ERROR) << "pipe error on "
                   << fd_written
                   << " Currently writing message of size: "
-                  << msg->size();
+                  << OutgoingMessageSize(*msg);
       return false;
     }
 
@@ -502,18 +507,204 @@ bool Channel::ChannelImpl::ProcessOutgoingMessages() {
           this);
       return true;
     } else {
+      // A message with a segmented payload may need more than one write even
+      // when the socket takes everything it is given.
+      message_send_bytes_written_ += bytes_written;
+      if (message_send_bytes_written_ < OutgoingMessageSize(*msg))
+        continue;
       message_send_bytes_written_ = 0;
 
       // Message sent OK!
       DVLOG(2) << "sent message @" << msg << " on channel @" << this
                << " with type " << msg->type() << " on fd " << pipe_;
       delete output_queue_.front();
-      output_queue_.pop();
+      output_queue_.pop_front();
     }
   }
   return true;
 }
 
+bool Channel::ChannelImpl::ProcessOutgoingMessagesToRing() {
+  bool wrote_data = false;
+  bool blocked = false;
+  while (!output_queue_.empty() && !blocked) {
+    Message* msg = output_queue_.front();
+
+    if (!message_fds_sent_ && !msg->file_descriptor_set()->empty()) {
+      // The descriptors go ahead of the data, so that the peer has them by
+      // the time it reads the message from the ring.
+      const unsigned num_fds = msg->file_descriptor_set()->size();
+      DCHECK(num_fds <= FileDescriptorSet::kMaxDescriptorsPerMessage);
+      if (msg->file_descriptor_set()->ContainsDirectoryDescriptor()) {
+        LOG(FATAL) << "Panic: attempting to transport directory descriptor over"
+                      " IPC. Aborting to maintain sandbox isolation.";
+      }
+      int fds[FileDescriptorSet::kMaxDescriptorsPerMessage];
+      msg->file_descriptor_set()->GetDescriptors(fds);
+      if (SendOnRingPipe(fds, num_fds) < 0) {
+        if (!SocketWriteErrorIsRecoverable()) {
+          if (errno != EPIPE)
+            PLOG(ERROR) << "pipe error on " << pipe_;
+          return false;
+        }
+        is_blocked_on_write_ = true;
+        base::MessageLoopForIO::current()->WatchFileDescriptor(
+            pipe_,
+            false,  // One shot
+            base::MessageLoopForIO::WATCH_WRITE,
+            &write_watcher_,
+            this);
+        break;
+      }
+      msg->header()->num_fds = static_cast<uint16>(num_fds);
+      CloseFileDescriptors(msg);
+      message_fds_sent_ = true;
+    }
+
+    Message::Header wire_header;
+    struct iovec iov[kMaxIOVecsPerWrite];
+    size_t amt_to_write = 0;
+    size_t iov_count = FillOutgoingIOVecs(msg, message_send_bytes_written_,
+                                          &wire_header, iov, &amt_to_write);
+    size_t bytes_written = 0;
+    for (size_t i = 0; i < iov_count; ++i) {
+      int written = outbound_ring_->Write(
+          static_cast<const char*>(iov[i].iov_base), iov[i].iov_len);
+      if (written < 0) {
+        LOG(ERROR) << "Corrupt shared memory ring on " << pipe_name_;
+        return false;
+      }
+      bytes_written += written;
+      if (static_cast<size_t>(written) < iov[i].iov_len)
+        break;
+    }
+    wrote_data |= bytes_written > 0;
+    message_send_bytes_written_ += bytes_written;
+
+    if (message_send_bytes_written_ < OutgoingMessageSize(*msg)) {
+      // Out of space. The peer wakes us once it has made room, unless it
+      // already has.
+      if (bytes_written < amt_to_write && outbound_ring_->WaitForSpace())
+        blocked = true;
+      continue;
+    }
+    message_send_bytes_written_ = 0;
+    message_fds_sent_ = false;
+
+    // Message sent OK!
+    DVLOG(2) << "sent message @" << msg << " on channel @" << this
+             << " with type " << msg->type() << " through shared memory";
+    delete output_queue_.front();
+    output_queue_.pop_front();
+  }
+
+  // Waking the peer once per batch of messages keeps the pipe quiet while
+  // it is busy reading.
+  if (wrote_data && outbound_ring_->TakeReaderWakeup())
+    return WakeRingPeer();
+  return true;
+}
+
+bool Channel::ChannelImpl::SendRingHandle() {
+  outbound_ring_.reset(new internal::SharedMemoryRing);
+  if (!outbound_ring_->Create()) {
+    LOG(ERROR) << "Unable to create shared memory ring for " << pipe_name_;
+    outbound_ring_.reset();
+    return false;
+  }
+  int fd = outbound_ring_->handle().fd;
+  if (SendOnRingPipe(&fd, 1) < 0) {
+    PLOG(ERROR) << "Unable to send shared memory ring on " << pipe_;
+    return false;
+  }
+  return true;
+}
+
+ssize_t Channel::ChannelImpl::SendOnRingPipe(const int* fds, size_t num_fds) {
+  struct iovec iov = { const_cast<char*>(""), 1 };
+  struct msghdr msgh = {0};
+  msgh.msg_iov = &iov;
+  msgh.msg_iovlen = 1;
+
+  char buf[CMSG_SPACE(
+      sizeof(int) * FileDescriptorSet::kMaxDescriptorsPerMessage)];
+  if (num_fds) {
+    DCHECK_LE(num_fds, FileDescriptorSet::kMaxDescriptorsPerMessage);
+    msgh.msg_control = buf;
+    msgh.msg_controllen = CMSG_SPACE(sizeof(int) * num_fds);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msgh);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * num_fds);
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * num_fds);
+    msgh.msg_controllen = cmsg->cmsg_len;
+  }
+  return HANDLE_EINTR(sendmsg(pipe_, &msgh, MSG_DONTWAIT));
+}
+
+bool Channel::ChannelImpl::WakeRingPeer() {
+  // A full pipe wakes the peer as well as another byte would.
+  if (SendOnRingPipe(NULL, 0) >= 0 || SocketWriteErrorIsRecoverable())
+    return true;
+  if (errno != EPIPE)
+    PLOG(ERROR) << "pipe error on " << pipe_;
+  return false;
+}
+
+// static
+size_t Channel::ChannelImpl::OutgoingMessageSize(const Message& msg) {
+  const SegmentedPickle* payload = msg.segmented_payload();
+  return msg.size() + (payload ? payload->payload_size() : 0);
+}
+
+// static
+size_t Channel::ChannelImpl::FillOutgoingIOVecs(Message* msg,
+                                                size_t offset,
+                                                Message::Header* wire_header,
+                                                struct iovec* iov,
+                                                size_t* length) {
+  const SegmentedPickle* payload = msg->segmented_payload();
+  if (!payload) {
+    iov[0].iov_base = static_cast<char*>(const_cast<void*>(msg->data())) +
+        offset;
+    iov[0].iov_len = msg->size() - offset;
+    *length = iov[0].iov_len;
+    return 1;
+  }
+
+  // The message itself holds just the header; the payload size on the wire
+  // comes from the segments, which follow it without their own header.
+  DCHECK_EQ(sizeof(Message::Header), msg->size());
+  *wire_header = *msg->header();
+  wire_header->payload_size = payload->payload_size();
+
+  size_t count = 0;
+  *length = 0;
+  for (size_t i = 0;
+       i <= payload->segment_count() && count < kMaxIOVecsPerWrite; ++i) {
+    const char* piece;
+    size_t piece_size;
+    if (i == 0) {
+      piece = reinterpret_cast<const char*>(wire_header);
+      piece_size = sizeof(*wire_header);
+    } else {
+      size_t skip = i == 1 ? payload->header_size() : 0;
+      piece = payload->segment_data(i - 1) + skip;
+      piece_size = payload->segment_size(i - 1) - skip;
+    }
+    if (offset >= piece_size) {
+      offset -= piece_size;
+      continue;
+    }
+    iov[count].iov_base = const_cast<char*>(piece) + offset;
+    iov[count].iov_len = piece_size - offset;
+    *length += iov[count].iov_len;
+    offset = 0;
+    ++count;
+  }
+  return count;
+}
+
 bool Channel::ChannelImpl::Send(Message* message) {
   DVLOG(2) << "sending message @" << message << " on channel @" << this
            << " with type " << message->type()
@@ -524,7 +715,17 @@ bool Channel::ChannelImpl::Send(Message* message) {
 #endif  // IPC_MESSAGE_LOG_ENABLED
 
   message->TraceMessageBegin();
-  output_queue_.push(message);
+  if (message->priority() == Message::PRIORITY_HIGH &&
+      output_queue_.size() > 1) {
+    std::deque<Message*>::iterator it = output_queue_.begin() + 1;
+    while (it != output_queue_.end() &&
+           (*it)->priority() == Message::PRIORITY_HIGH) {
+      ++it;
+    }
+    output_queue_.insert(it, message);
+  } else {
+    output_queue_.push_back(message);
+  }
   if (!is_blocked_on_write_ && !waiting_connect_) {
     return ProcessOutgoingMessages();
   }
@@ -594,7 +795,7 @@ void Channel::ChannelImpl::ResetToAcceptingConnectionState() {
 
   while (!output_queue_.empty()) {
     Message* m = output_queue_.front();
-    output_queue_.pop();
+    output_queue_.pop_front();
     delete m;
   }
 
@@ -611,6 +812,12 @@ void Channel::ChannelImpl::ResetToAcceptingConnectionState() {
   }
   fds_to_close_.clear();
 #endif
+
+  outbound_ring_.reset();
+  inbound_ring_.reset();
+  message_fds_sent_ = false;
+  ring_pipe_drained_ = false;
+  ring_peer_closed_ = false;
 }
 
 // static
@@ -704,6 +911,8 @@ void Channel::ChannelImpl::OnFileCanWriteWithoutBlocking(int fd) {
 bool Channel::ChannelImpl::AcceptConnection() {
   base::MessageLoopForIO::current()->WatchFileDescriptor(
       pipe_, true, base::MessageLoopForIO::WATCH_READ, &read_watcher_, this);
+  if ((mode_ & MODE_SHARED_MEMORY_FLAG) && !SendRingHandle())
+    return false;
   QueueHelloMessage();
 
   if (mode_ & MODE_CLIENT_FLAG) {
@@ -764,7 +973,7 @@ void Channel::ChannelImpl::QueueHelloMessage() {
     DCHECK_EQ(msg->file_descriptor_set()->size(), 1U);
   }
 #endif  // IPC_USES_READWRITE
-  output_queue_.push(msg.release());
+  output_queue_.push_back(msg.release());
 }
 
 Channel::ChannelImpl::ReadState Channel::ChannelImpl::ReadData(
@@ -774,6 +983,9 @@ Channel::ChannelImpl::ReadState Channel::ChannelImpl::ReadData(
   if (pipe_ == -1)
     return READ_FAILED;
 
+  if (mode_ & MODE_SHARED_MEMORY_FLAG)
+    return ReadDataFromRing(buffer, buffer_len, bytes_read);
+
   struct msghdr msg = {0};
 
   struct iovec iov = {buffer, static_cast<size_t>(buffer_len)};
@@ -824,6 +1036,103 @@ Channel::ChannelImpl::ReadState Channel::ChannelImpl::ReadData(
   return READ_SUCCEEDED;
 }
 
+Channel::ChannelImpl::ReadState Channel::ChannelImpl::ReadDataFromRing(
+    char* buffer,
+    int buffer_len,
+    int* bytes_read) {
+  // The pipe is only drained once per wakeup; until the reader sleeps again
+  // the data comes from the ring alone.
+  if (!ring_pipe_drained_) {
+    if (!DrainRingPipe())
+      return READ_FAILED;
+    ring_pipe_drained_ = true;
+  }
+
+  if (!inbound_ring_.get()) {
+    ring_pipe_drained_ = false;
+    return ring_peer_closed_ ? READ_FAILED : READ_PENDING;
+  }
+
+  while (true) {
+    *bytes_read = inbound_ring_->Read(buffer, buffer_len);
+    if (*bytes_read < 0) {
+      LOG(ERROR) << "Corrupt shared memory ring on " << pipe_name_;
+      return READ_FAILED;
+    }
+    if (*bytes_read > 0) {
+      if (inbound_ring_->TakeWriterWakeup() && !WakeRingPeer())
+        return READ_FAILED;
+      return READ_SUCCEEDED;
+    }
+    if (ring_peer_closed_)
+      return READ_FAILED;
+    if (inbound_ring_->WaitForData()) {
+      ring_pipe_drained_ = false;
+      return READ_PENDING;
+    }
+  }
+}
+
+bool Channel::ChannelImpl::DrainRingPipe() {
+  char wakeups[64];
+  while (true) {
+    struct msghdr msg = {0};
+    struct iovec iov = {wakeups, sizeof(wakeups)};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = input_cmsg_buf_;
+    msg.msg_controllen = sizeof(input_cmsg_buf_);
+
+    ssize_t bytes_received = HANDLE_EINTR(recvmsg(pipe_, &msg, MSG_DONTWAIT));
+    if (bytes_received < 0) {
+      if (errno == EAGAIN)
+        return true;
+#if defined(OS_MACOSX)
+      if (errno == EPERM) {
+        ring_peer_closed_ = true;
+        return true;
+      }
+#endif  // OS_MACOSX
+      if (errno == ECONNRESET || errno == EPIPE) {
+        ring_peer_closed_ = true;
+        return true;
+      }
+      PLOG(ERROR) << "pipe error (" << pipe_ << ")";
+      return false;
+    }
+    if (bytes_received == 0) {
+      // The pipe has closed...
+      ring_peer_closed_ = true;
+      return true;
+    }
+
+    CloseClientFileDescriptor();
+
+    if (!ExtractFileDescriptorsFromMsghdr(&msg))
+      return false;
+    if (!inbound_ring_.get() && !input_fds_.empty()) {
+      // The first descriptor from the peer is its ring.
+      inbound_ring_.reset(new internal::SharedMemoryRing);
+      bool opened = inbound_ring_->Open(
+          base::FileDescriptor(input_fds_.front(), true));
+      input_fds_.erase(input_fds_.begin());
+      if (!opened) {
+        LOG(ERROR) << "Invalid shared memory ring on " << pipe_name_;
+        inbound_ring_.reset();
+        return false;
+      }
+    }
+
+    // Descriptors normally wait for no more than the messages in the ring,
+    // so a peer sending many more is trying to fill our descriptor table.
+    if (input_fds_.size() > kMaxReadFDs) {
+      LOG(ERROR) << "Too many file descriptors pending on " << pipe_name_;
+      ClearInputFDs();
+      return false;
+    }
+  }
+}
+
 #if defined(IPC_USES_READWRITE)
 bool Channel::ChannelImpl::ReadFileDescriptorsFromFDPipe() {
   char dummy;
@@ -860,11 +1169,16 @@ bool Channel::ChannelImpl::WillDispatchInputMessage(Message* msg) {
   if (header_fds > input_fds_.size()) {
     // The message has been completely received, but we didn't get
     // enough file descriptors.
+    if (inbound_ring_.get()) {
+      // They were sent on the pipe ahead of the message, so they are there.
+      if (!DrainRingPipe())
+        return false;
+    }
 #if defined(IPC_USES_READWRITE)
     if (!ReadFileDescriptorsFromFDPipe())
       return false;
-    if (header_fds > input_fds_.size())
 #endif  // IPC_USES_READWRITE
+    if (header_fds > input_fds_.size())
       error = "Message needs unreceived descriptors";
   }
 
@@ -894,7 +1208,9 @@ bool Channel::ChannelImpl::DidEmptyInputBuffers() {
   // When the input data buffer is empty, the fds should be too. If this is
   // not the case, we probably have a rogue renderer which is trying to fill
   // our descriptor table.
-  return input_fds_.empty();
+  // With shared memory, descriptors arrive ahead of their messages, and
+  // DrainRingPipe() limits how many may be waiting instead.
+  return inbound_ring_.get() != NULL || input_fds_.empty();
 }
 
 bool Channel::ChannelImpl::ExtractFileDescriptorsFromMsghdr(msghdr* msg) {
@@ -949,7 +1265,7 @@ void Channel::ChannelImpl::QueueCloseFDMessage(int fd, int hops) {
         NOTREACHED() << "Unable to pickle close fd.";
       }
       // Send(msg.release());
-      output_queue_.push(msg.release());
+      output_queue_.push_back(msg.release());
       break;
     }
 
@@ -974,7 +1290,7 @@ void Channel::ChannelImpl::HandleInternalMessage(const Message& msg) {
         NOTREACHED();
 
 #if defined(IPC_USES_READWRITE)
-      if (mode_ & MODE_SERVER_FLAG) {
+      if ((mode_ & MODE_SERVER_FLAG) && !(mode_ & MODE_SHARED_MEMORY_FLAG)) {
         // With IPC_USES_READWRITE, the Hello message from the client to the
         // server also contains the fd_pipe_, which  will be used for all
         // subsequent file descriptor passing.
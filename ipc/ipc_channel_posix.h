@@ -9,15 +9,17 @@
 
 #include <sys/socket.h>  // for CMSG macros
 
-#include <queue>
+#include <deque>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop.h"
 #include "base/process/process.h"
 #include "ipc/file_descriptor_set_posix.h"
 #include "ipc/ipc_channel_reader.h"
+#include "ipc/shared_memory_ring_posix.h"
 
 #if !defined(OS_MACOSX)
 // On Linux, the seccomp sandbox makes it very expensive to call
@@ -77,6 +79,44 @@ class Channel::ChannelImpl : public internal::ChannelReader,
 
   bool ProcessOutgoingMessages();
 
+  // Returns the number of bytes |msg| takes on the wire, including any
+  // segmented payload.
+  static size_t OutgoingMessageSize(const Message& msg);
+
+  // Fills |iov| with up to kMaxIOVecsPerWrite pieces of |msg|'s wire form,
+  // skipping the first |offset| bytes, and sets |length| to their total size.
+  // |wire_header| provides storage for the header of a message with a
+  // segmented payload and must outlive the write. Returns the number of
+  // entries used.
+  static size_t FillOutgoingIOVecs(Message* msg,
+                                   size_t offset,
+                                   Message::Header* wire_header,
+                                   struct iovec* iov,
+                                   size_t* length);
+
+  // With MODE_SHARED_MEMORY_FLAG, writes queued messages to |outbound_ring_|
+  // instead of the pipe, which only gets their file descriptors.
+  bool ProcessOutgoingMessagesToRing();
+
+  // Creates |outbound_ring_| and sends its handle to the peer, ahead of
+  // anything else.
+  bool SendRingHandle();
+
+  // Sends one byte on the pipe, along with the |num_fds| descriptors in
+  // |fds|. Returns the result of sendmsg().
+  ssize_t SendOnRingPipe(const int* fds, size_t num_fds);
+
+  // Wakes the peer after it announced in a ring that it is going to sleep.
+  // Returns false on a pipe error.
+  bool WakeRingPeer();
+
+  // Reads all waiting wakeups and file descriptors off the pipe, opening
+  // |inbound_ring_| from the first descriptor. Returns false on error.
+  bool DrainRingPipe();
+
+  // ReadData() with MODE_SHARED_MEMORY_FLAG.
+  ReadState ReadDataFromRing(char* buffer, int buffer_len, int* bytes_read);
+
   bool AcceptConnection();
   void ClosePipeOnError();
   int GetHelloMessageProcId();
@@ -156,8 +196,33 @@ class Channel::ChannelImpl : public internal::ChannelReader,
   // the pipe.  On POSIX it's used as a key in a local map of file descriptors.
   std::string pipe_name_;
 
-  // Messages to be sent are queued here.
-  std::queue<Message*> output_queue_;
+  // Messages to be sent are queued here. PRIORITY_HIGH messages are queued
+  // ahead of the others, though never ahead of the message at the front, which
+  // may have been partly written.
+  std::deque<Message*> output_queue_;
+
+  // With MODE_SHARED_MEMORY_FLAG, message data is written to
+  // |outbound_ring_| and read from |inbound_ring_|, which each side creates
+  // for its outgoing data when it connects. A side which runs out of data or
+  // space in a ring sleeps until the peer wakes it with a byte on the pipe.
+  // File descriptors go on the pipe ahead of the data of their message.
+  scoped_ptr<internal::SharedMemoryRing> outbound_ring_;
+  scoped_ptr<internal::SharedMemoryRing> inbound_ring_;
+
+  // Whether the file descriptors of the message being written to
+  // |outbound_ring_| have been sent.
+  bool message_fds_sent_;
+
+  // Whether the pipe has been drained since the reader last went to sleep.
+  bool ring_pipe_drained_;
+
+  // Whether the peer has closed the pipe. Whatever it wrote to
+  // |inbound_ring_| before is still read.
+  bool ring_peer_closed_;
+
+  // The most iovecs handed to a single sendmsg() call. Longer segment chains
+  // take several writes.
+  static const size_t kMaxIOVecsPerWrite = 64;
 
   // We assume a worst case: kReadBufferSize bytes of messages, where each
   // message has no payload and a full complement of descriptors.
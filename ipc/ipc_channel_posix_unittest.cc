@@ -19,6 +19,7 @@
 #include "base/path_service.h"
 #include "base/posix/eintr_wrapper.h"
 #include "base/process/kill.h"
+#include "base/segmented_pickle.h"
 #include "base/test/multiprocess_test.h"
 #include "base/test/test_timeouts.h"
 #include "ipc/ipc_listener.h"
@@ -234,6 +235,77 @@ TEST_F(IPCChannelPosixTest, BasicConnected) {
   ASSERT_FALSE(channel2.AcceptsConnections());
 }
 
+// Keeps the last message received.
+class SegmentedPayloadListener : public IPC::Listener {
+ public:
+  SegmentedPayloadListener() {}
+  virtual ~SegmentedPayloadListener() {}
+
+  virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE {
+    message_.reset(new IPC::Message(message));
+    base::MessageLoopForIO::current()->QuitNow();
+    return true;
+  }
+
+  virtual void OnChannelError() OVERRIDE {
+    base::MessageLoopForIO::current()->QuitNow();
+  }
+
+  const IPC::Message* message() const { return message_.get(); }
+
+ private:
+  scoped_ptr<IPC::Message> message_;
+};
+
+// A message whose payload is much larger than the socket buffer goes out in
+// several scatter-gather writes and arrives as an ordinary message.
+TEST_F(IPCChannelPosixTest, SegmentedPayload) {
+  int pipe_fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, pipe_fds));
+  ASSERT_GE(fcntl(pipe_fds[0], F_SETFL, O_NONBLOCK), 0);
+  ASSERT_GE(fcntl(pipe_fds[1], F_SETFL, O_NONBLOCK), 0);
+
+  SegmentedPayloadListener server_listener;
+  SegmentedPayloadListener client_listener;
+  IPC::ChannelHandle server_handle("IPCChannelPosixTest_SegmentedPayload",
+                                   base::FileDescriptor(pipe_fds[0], true));
+  IPC::ChannelHandle client_handle("IPCChannelPosixTest_SegmentedPayload",
+                                   base::FileDescriptor(pipe_fds[1], true));
+  IPC::Channel server(server_handle, IPC::Channel::MODE_SERVER,
+                      &server_listener);
+  IPC::Channel client(client_handle, IPC::Channel::MODE_CLIENT,
+                      &client_listener);
+  ASSERT_TRUE(server.Connect());
+  ASSERT_TRUE(client.Connect());
+
+  const int kNumStrings = 64;
+  std::string big(SegmentedPickle::kSegmentSize + 3, 'x');
+  scoped_ptr<SegmentedPickle> payload(new SegmentedPickle);
+  for (int i = 0; i < kNumStrings; ++i) {
+    big[0] = static_cast<char>(i);
+    ASSERT_TRUE(payload->WriteString(big));
+  }
+  IPC::Message* message = new IPC::Message(0,  // routing_id
+                                           kQuitMessage,  // message type
+                                           IPC::Message::PRIORITY_NORMAL);
+  message->SetSegmentedPayload(payload.Pass());
+  ASSERT_TRUE(server.Send(message));
+  SpinRunLoop(TestTimeouts::action_max_timeout());
+
+  const IPC::Message* received = client_listener.message();
+  ASSERT_TRUE(received);
+  EXPECT_EQ(kQuitMessage, received->type());
+  PickleIterator iter(*received);
+  for (int i = 0; i < kNumStrings; ++i) {
+    std::string out;
+    ASSERT_TRUE(received->ReadString(&iter, &out));
+    big[0] = static_cast<char>(i);
+    EXPECT_EQ(big, out);
+  }
+  std::string extra;
+  EXPECT_FALSE(received->ReadString(&iter, &extra));
+}
+
 // If a connection closes right before a Send() call, we may end up closing
 // the connection without notifying the listener, which can cause hangs in
 // sync_message_filter and others. Make sure the listener is notified.
@@ -9,12 +9,14 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/single_thread_task_runner.h"
+#include "base/stl_util.h"
 #include "base/thread_task_runner_handle.h"
 #include "ipc/ipc_channel_proxy.h"
 #include "ipc/ipc_listener.h"
 #include "ipc/ipc_logging.h"
 #include "ipc/ipc_message_macros.h"
 #include "ipc/ipc_message_utils.h"
+#include "ipc/message_filter_router.h"
 
 namespace IPC {
 
@@ -36,6 +38,11 @@ bool ChannelProxy::MessageFilter::OnMessageReceived(const Message& message) {
   return false;
 }
 
+bool ChannelProxy::MessageFilter::GetSupportedMessageClasses(
+    std::vector<uint32>* supported_message_classes) const {
+  return false;
+}
+
 ChannelProxy::MessageFilter::~MessageFilter() {}
 
 //------------------------------------------------------------------------------
@@ -44,13 +51,17 @@ ChannelProxy::Context::Context(Listener* listener,
                                base::SingleThreadTaskRunner* ipc_task_runner)
     : listener_task_runner_(base::ThreadTaskRunnerHandle::Get()),
       listener_(listener),
+      message_filter_router_(new MessageFilterRouter()),
       ipc_task_runner_(ipc_task_runner),
       channel_connected_called_(false),
+      dispatch_task_pending_(false),
       peer_pid_(base::kNullProcessId) {
   DCHECK(ipc_task_runner_.get());
 }
 
 ChannelProxy::Context::~Context() {
+  STLDeleteElements(&priority_incoming_messages_);
+  STLDeleteElements(&incoming_messages_);
 }
 
 void ChannelProxy::Context::ClearIPCTaskRunner() {
@@ -71,14 +82,12 @@ bool ChannelProxy::Context::TryFilters(const Message& message) {
     logger->OnPreDispatchMessage(message);
 #endif
 
-  for (size_t i = 0; i < filters_.size(); ++i) {
-    if (filters_[i]->OnMessageReceived(message)) {
+  if (message_filter_router_->TryFilters(message)) {
 #ifdef IPC_MESSAGE_LOG_ENABLED
-      if (logger->Enabled())
-        logger->OnPostDispatchMessage(message, channel_id_);
+    if (logger->Enabled())
+      logger->OnPostDispatchMessage(message, channel_id_);
 #endif
-      return true;
-    }
+    return true;
   }
   return false;
 }
@@ -93,8 +102,22 @@ bool ChannelProxy::Context::OnMessageReceived(const Message& message) {
 
 // Called on the IPC::Channel thread
 bool ChannelProxy::Context::OnMessageReceivedNoFilter(const Message& message) {
-  listener_task_runner_->PostTask(
-      FROM_HERE, base::Bind(&Context::OnDispatchMessage, this, message));
+  // Messages which arrive while a dispatch task is pending join its batch
+  // instead of each posting a task of its own.
+  bool post_task;
+  {
+    base::AutoLock auto_lock(incoming_messages_lock_);
+    if (IsPriorityMessage(message))
+      priority_incoming_messages_.push_back(new Message(message));
+    else
+      incoming_messages_.push_back(new Message(message));
+    post_task = !dispatch_task_pending_;
+    dispatch_task_pending_ = true;
+  }
+  if (post_task) {
+    listener_task_runner_->PostTask(
+        FROM_HERE, base::Bind(&Context::OnDispatchMessages, this));
+  }
   return true;
 }
 
@@ -156,6 +179,7 @@ void ChannelProxy::Context::OnChannelClosed() {
   }
 
   // We don't need the filters anymore.
+  message_filter_router_->Clear();
   filters_.clear();
 
   channel_.reset();
@@ -175,6 +199,8 @@ void ChannelProxy::Context::OnSendMessage(scoped_ptr<Message> message) {
     OnChannelClosed();
     return;
   }
+  if (IsPriorityMessage(*message))
+    message->set_priority(Message::PRIORITY_HIGH);
   if (!channel_->Send(message.release()))
     OnChannelError();
 }
@@ -189,6 +215,7 @@ void ChannelProxy::Context::OnAddFilter() {
 
   for (size_t i = 0; i < new_filters.size(); ++i) {
     filters_.push_back(new_filters[i]);
+    message_filter_router_->AddFilter(new_filters[i].get());
 
     // If the channel has already been created, then we need to send this
     // message so that the filter gets access to the Channel.
@@ -208,6 +235,7 @@ void ChannelProxy::Context::OnRemoveFilter(MessageFilter* filter) {
   for (size_t i = 0; i < filters_.size(); ++i) {
     if (filters_[i].get() == filter) {
       filter->OnFilterRemoved();
+      message_filter_router_->RemoveFilter(filter);
       filters_.erase(filters_.begin() + i);
       return;
     }
@@ -216,6 +244,24 @@ void ChannelProxy::Context::OnRemoveFilter(MessageFilter* filter) {
   NOTREACHED() << "filter to be removed not found";
 }
 
+// Called on the IPC::Channel thread
+void ChannelProxy::Context::OnAddPriorityMessageClass(uint32 message_class) {
+  priority_message_classes_.insert(message_class);
+}
+
+// Called on the IPC::Channel thread
+void ChannelProxy::Context::OnAddPriorityMessageType(uint32 type) {
+  priority_message_types_.insert(type);
+}
+
+// Called on the IPC::Channel thread
+bool ChannelProxy::Context::IsPriorityMessage(const Message& message) const {
+  if (message.is_sync() || message.is_reply())
+    return false;
+  return priority_message_types_.count(message.type()) ||
+         priority_message_classes_.count(IPC_MESSAGE_ID_CLASS(message.type()));
+}
+
 // Called on the listener's thread
 void ChannelProxy::Context::AddFilter(MessageFilter* filter) {
   base::AutoLock auto_lock(pending_filters_lock_);
@@ -224,6 +270,40 @@ void ChannelProxy::Context::AddFilter(MessageFilter* filter) {
       FROM_HERE, base::Bind(&Context::OnAddFilter, this));
 }
 
+// Called on the listener's thread
+void ChannelProxy::Context::OnDispatchMessages() {
+  {
+    base::AutoLock auto_lock(incoming_messages_lock_);
+    dispatch_task_pending_ = false;
+  }
+  while (true) {
+    scoped_ptr<Message> message;
+    bool post_task = false;
+    {
+      base::AutoLock auto_lock(incoming_messages_lock_);
+      std::deque<Message*>* queue = &priority_incoming_messages_;
+      if (queue->empty())
+        queue = &incoming_messages_;
+      if (queue->empty())
+        return;
+      message.reset(queue->front());
+      queue->pop_front();
+      // The listener may run a nested message loop while handling the
+      // message, which should still get to dispatch the messages after it.
+      if ((!priority_incoming_messages_.empty() ||
+           !incoming_messages_.empty()) && !dispatch_task_pending_) {
+        dispatch_task_pending_ = true;
+        post_task = true;
+      }
+    }
+    if (post_task) {
+      listener_task_runner_->PostTask(
+          FROM_HERE, base::Bind(&Context::OnDispatchMessages, this));
+    }
+    OnDispatchMessage(*message);
+  }
+}
+
 // Called on the listener's thread
 void ChannelProxy::Context::OnDispatchMessage(const Message& message) {
 #ifdef IPC_MESSAGE_LOG_ENABLED
@@ -273,6 +353,9 @@ void ChannelProxy::Context::OnDispatchConnected() {
 
 // Called on the listener's thread
 void ChannelProxy::Context::OnDispatchError() {
+  // Messages received before the error are dispatched before it, even when a
+  // nested message loop runs this ahead of the task for them.
+  OnDispatchMessages();
   if (listener_)
     listener_->OnChannelError();
 }
@@ -378,6 +461,22 @@ void ChannelProxy::RemoveFilter(MessageFilter* filter) {
                             make_scoped_refptr(filter)));
 }
 
+void ChannelProxy::AddPriorityMessageClass(uint32 message_class) {
+  DCHECK(CalledOnValidThread());
+
+  context_->ipc_task_runner()->PostTask(
+      FROM_HERE, base::Bind(&Context::OnAddPriorityMessageClass,
+                            context_.get(), message_class));
+}
+
+void ChannelProxy::AddPriorityMessageType(uint32 type) {
+  DCHECK(CalledOnValidThread());
+
+  context_->ipc_task_runner()->PostTask(
+      FROM_HERE, base::Bind(&Context::OnAddPriorityMessageType,
+                            context_.get(), type));
+}
+
 void ChannelProxy::ClearIPCTaskRunner() {
   DCHECK(CalledOnValidThread());
 
@@ -5,6 +5,8 @@
 #ifndef IPC_IPC_CHANNEL_PROXY_H_
 #define IPC_IPC_CHANNEL_PROXY_H_
 
+#include <deque>
+#include <set>
 #include <vector>
 
 #include "base/memory/ref_counted.h"
@@ -22,6 +24,7 @@ class SingleThreadTaskRunner;
 
 namespace IPC {
 
+class MessageFilterRouter;
 class SendCallbackHelper;
 
 //-----------------------------------------------------------------------------
@@ -88,6 +91,15 @@ class IPC_EXPORT ChannelProxy : public Sender, public base::NonThreadSafe {
     // the message be handled in the default way.
     virtual bool OnMessageReceived(const Message& message);
 
+    // Filters which only handle messages of a few message classes (the
+    // IPCMessageStart of their messages) can return true after adding the
+    // classes to |supported_message_classes|. OnMessageReceived is then only
+    // called for messages of those classes, so the other messages do not pay
+    // for the filter. The classes are asked for once, when the filter is
+    // added. The default of false means the filter gets every message.
+    virtual bool GetSupportedMessageClasses(
+        std::vector<uint32>* supported_message_classes) const;
+
    protected:
     virtual ~MessageFilter();
 
@@ -143,6 +155,16 @@ class IPC_EXPORT ChannelProxy : public Sender, public base::NonThreadSafe {
   void AddFilter(MessageFilter* filter);
   void RemoveFilter(MessageFilter* filter);
 
+  // Puts messages of the given class (an IPCMessageStart value) or type in
+  // the priority lane. Received priority messages are dispatched to the
+  // listener ahead of other received messages still waiting for it, and sent
+  // ones are marked PRIORITY_HIGH, so that the channel writes them ahead of
+  // other queued messages. Order is kept within each lane. Synchronous
+  // messages and replies always stay in the normal lane, as do messages which
+  // arrive before the IPC thread has seen this call.
+  void AddPriorityMessageClass(uint32 message_class);
+  void AddPriorityMessageType(uint32 type);
+
   // Called to clear the pointer to the IPC task runner when it's going away.
   void ClearIPCTaskRunner();
 
@@ -214,9 +236,13 @@ class IPC_EXPORT ChannelProxy : public Sender, public base::NonThreadSafe {
     void OnSendMessage(scoped_ptr<Message> message_ptr);
     void OnAddFilter();
     void OnRemoveFilter(MessageFilter* filter);
+    void OnAddPriorityMessageClass(uint32 message_class);
+    void OnAddPriorityMessageType(uint32 type);
+    bool IsPriorityMessage(const Message& message) const;
 
     // Methods called on the listener thread.
     void AddFilter(MessageFilter* filter);
+    void OnDispatchMessages();
     void OnDispatchConnected();
     void OnDispatchError();
 
@@ -225,6 +251,8 @@ class IPC_EXPORT ChannelProxy : public Sender, public base::NonThreadSafe {
 
     // List of filters.  This is only accessed on the IPC thread.
     std::vector<scoped_refptr<MessageFilter> > filters_;
+    // Routes messages to the filters in |filters_| by message class.
+    scoped_ptr<MessageFilterRouter> message_filter_router_;
     scoped_refptr<base::SingleThreadTaskRunner> ipc_task_runner_;
     scoped_ptr<Channel> channel_;
     std::string channel_id_;
@@ -236,6 +264,20 @@ class IPC_EXPORT ChannelProxy : public Sender, public base::NonThreadSafe {
     // Lock for pending_filters_.
     base::Lock pending_filters_lock_;
 
+    // The classes and types of the messages in the priority lane. These are
+    // only accessed on the IPC thread.
+    std::set<uint32> priority_message_classes_;
+    std::set<uint32> priority_message_types_;
+
+    // Messages received on the IPC thread waiting to be dispatched on the
+    // listener thread, and whether a task to dispatch them has been posted
+    // and not yet started. Priority messages wait in their own queue, which
+    // is dispatched first. Guarded by incoming_messages_lock_.
+    std::deque<Message*> priority_incoming_messages_;
+    std::deque<Message*> incoming_messages_;
+    bool dispatch_task_pending_;
+    base::Lock incoming_messages_lock_;
+
     // Cached copy of the peer process ID. Set on IPC but read on both IPC and
     // listener threads.
     base::ProcessId peer_pid_;
@@ -4,6 +4,8 @@
 
 #include "ipc/ipc_channel_reader.h"
 
+#include <algorithm>
+
 #include "ipc/ipc_listener.h"
 #include "ipc/ipc_logging.h"
 #include "ipc/ipc_message_macros.h"
@@ -11,7 +13,18 @@
 namespace IPC {
 namespace internal {
 
-ChannelReader::ChannelReader(Listener* listener) : listener_(listener) {
+namespace {
+
+// The most read at once into the end of a large message. This is about as
+// much as a socket buffers, while a bogus message size in a header does not
+// make us reserve much more memory than has arrived.
+const size_t kMaxMessageRemainderRead = 256 * 1024;
+
+}  // namespace
+
+ChannelReader::ChannelReader(Listener* listener)
+    : listener_(listener),
+      overflow_read_size_(0) {
   memset(input_buf_, 0, sizeof(input_buf_));
 }
 
@@ -20,22 +33,25 @@ ChannelReader::~ChannelReader() {
 
 bool ChannelReader::ProcessIncomingMessages() {
   while (true) {
+    char* buffer;
+    int buffer_len;
+    GetReadBuffer(&buffer, &buffer_len);
+
     int bytes_read = 0;
-    ReadState read_state = ReadData(input_buf_, Channel::kReadBufferSize,
-                                    &bytes_read);
+    ReadState read_state = ReadData(buffer, buffer_len, &bytes_read);
     if (read_state == READ_FAILED)
       return false;
     if (read_state == READ_PENDING)
       return true;
 
     DCHECK(bytes_read > 0);
-    if (!DispatchInputData(input_buf_, bytes_read))
+    if (!DidReadData(bytes_read))
       return false;
   }
 }
 
 bool ChannelReader::AsyncReadComplete(int bytes_read) {
-  return DispatchInputData(input_buf_, bytes_read);
+  return DidReadData(bytes_read);
 }
 
 bool ChannelReader::IsInternalMessage(const Message& m) const {
@@ -49,6 +65,51 @@ bool ChannelReader::IsHelloMessage(const Message& m) const {
       m.type() == Channel::HELLO_MESSAGE_TYPE;
 }
 
+void ChannelReader::GetReadBuffer(char** buffer, int* buffer_len) {
+  // Give back the room reserved for a read which did not happen.
+  input_overflow_buf_.resize(input_overflow_buf_.size() - overflow_read_size_);
+  overflow_read_size_ = 0;
+
+  *buffer = input_buf_;
+  *buffer_len = Channel::kReadBufferSize;
+
+  // Once the header of a large message is in, the rest of it is read straight
+  // into place, rather than in pieces of kReadBufferSize which are then
+  // copied over. The overflow buffer always starts at a message.
+  size_t message_size;
+  if (!Message::PeekNext(input_overflow_buf_.data(),
+                         input_overflow_buf_.data() +
+                             input_overflow_buf_.size(),
+                         &message_size) ||
+      message_size > Channel::kMaximumMessageSize ||
+      message_size <= input_overflow_buf_.size()) {
+    return;
+  }
+  size_t remainder = message_size - input_overflow_buf_.size();
+  if (remainder <= Channel::kReadBufferSize)
+    return;
+
+  overflow_read_size_ = std::min(remainder, kMaxMessageRemainderRead);
+  size_t data_size = input_overflow_buf_.size();
+  input_overflow_buf_.resize(data_size + overflow_read_size_);
+  *buffer = &input_overflow_buf_[data_size];
+  *buffer_len = static_cast<int>(overflow_read_size_);
+}
+
+bool ChannelReader::DidReadData(int bytes_read) {
+  if (!overflow_read_size_)
+    return DispatchInputData(input_buf_, bytes_read);
+
+  // The data is in place at the end of the overflow buffer already.
+  DCHECK_LE(static_cast<size_t>(bytes_read), overflow_read_size_);
+  input_overflow_buf_.resize(
+      input_overflow_buf_.size() - overflow_read_size_ + bytes_read);
+  overflow_read_size_ = 0;
+  return DispatchMessages(input_overflow_buf_.data(),
+                          input_overflow_buf_.data() +
+                              input_overflow_buf_.size());
+}
+
 bool ChannelReader::DispatchInputData(const char* input_data,
                                       int input_data_len) {
   const char* p;
@@ -70,6 +131,10 @@ bool ChannelReader::DispatchInputData(const char* input_data,
     end = p + input_overflow_buf_.size();
   }
 
+  return DispatchMessages(p, end);
+}
+
+bool ChannelReader::DispatchMessages(const char* p, const char* end) {
   // Dispatch all complete messages in the data buffer.
   while (p < end) {
     const char* message_tail = Message::FindNext(p, end);
@@ -102,8 +167,12 @@ bool ChannelReader::DispatchInputData(const char* input_data,
     }
   }
 
-  // Save any partial data in the overflow buffer.
-  input_overflow_buf_.assign(p, end - p);
+  // Save any partial data in the overflow buffer, unless it is all there is
+  // in the overflow buffer already.
+  if (p != input_overflow_buf_.data() ||
+      end != p + input_overflow_buf_.size()) {
+    input_overflow_buf_.assign(p, end - p);
+  }
 
   if (input_overflow_buf_.empty() && !DidEmptyInputBuffers())
     return false;
@@ -84,12 +84,26 @@ class ChannelReader {
   virtual void HandleInternalMessage(const Message& msg) = 0;
 
  private:
+  // Picks where the next read goes: into |input_buf_|, or, when the header
+  // of a large message has been received, straight to the end of
+  // |input_overflow_buf_| with room for the rest of the message.
+  void GetReadBuffer(char** buffer, int* buffer_len);
+
+  // Dispatches the |bytes_read| bytes read into the buffer from
+  // GetReadBuffer(). Returns true on success. False means channel error.
+  bool DidReadData(int bytes_read);
+
   // Takes the given data received from the IPC channel and dispatches any
   // fully completed messages.
   //
   // Returns true on success. False means channel error.
   bool DispatchInputData(const char* input_data, int input_data_len);
 
+  // Dispatches the complete messages in [p, end), which is either input data
+  // or the whole of |input_overflow_buf_|, and keeps the partial message at
+  // the end in |input_overflow_buf_|.
+  bool DispatchMessages(const char* p, const char* end);
+
   Listener* listener_;
 
   // We read from the pipe into this buffer. Managed by DispatchInputData, do
@@ -100,6 +114,10 @@ class ChannelReader {
   // this buffer.
   std::string input_overflow_buf_;
 
+  // The room at the end of |input_overflow_buf_| which the last read from
+  // GetReadBuffer() went to, or 0 if it went to |input_buf_|.
+  size_t overflow_read_size_;
+
   DISALLOW_COPY_AND_ASSIGN(ChannelReader);
 };
 
@@ -209,6 +209,32 @@ TEST_F(IPCChannelTest, ChannelProxyTest) {
   thread.Stop();
 }
 
+#if defined(OS_POSIX)
+// The same exchange through shared memory, which it wraps around several
+// times.
+TEST_F(IPCChannelTest, SharedMemoryChannelTest) {
+  Init("SharedMemoryClient");
+
+  // Set up IPC channel and start client.
+  GenericChannelListener listener;
+  CreateChannelWithMode(&listener, IPC::Channel::MODE_SHARED_MEMORY_SERVER);
+  listener.Init(sender());
+  ASSERT_TRUE(ConnectChannel());
+  ASSERT_TRUE(StartClient());
+
+  Send(sender(), "hello from parent");
+
+  // Run message loop.
+  base::MessageLoop::current()->Run();
+
+  // Close the channel so the client's OnChannelError() gets fired.
+  channel()->Close();
+
+  EXPECT_TRUE(WaitForClientShutdown());
+  DestroyChannel();
+}
+#endif  // defined(OS_POSIX)
+
 class ChannelListenerWithOnConnectedSend : public GenericChannelListener {
  public:
   ChannelListenerWithOnConnectedSend() {}
@@ -265,4 +291,22 @@ MULTIPROCESS_IPC_TEST_CLIENT_MAIN(GenericClient) {
   return 0;
 }
 
+#if defined(OS_POSIX)
+MULTIPROCESS_IPC_TEST_CLIENT_MAIN(SharedMemoryClient) {
+  base::MessageLoopForIO main_message_loop;
+  GenericChannelListener listener;
+
+  // Set up IPC channel.
+  IPC::Channel channel(IPCTestBase::GetChannelName("SharedMemoryClient"),
+                       IPC::Channel::MODE_SHARED_MEMORY_CLIENT,
+                       &listener);
+  CHECK(channel.Connect());
+  listener.Init(&channel);
+  Send(&channel, "hello from child");
+
+  base::MessageLoop::current()->Run();
+  return 0;
+}
+#endif  // defined(OS_POSIX)
+
 }  // namespace
@@ -90,6 +90,8 @@ bool Channel::ChannelImpl::Send(Message* message) {
   Logging::GetInstance()->OnSendMessage(message, "");
 #endif
 
+  // Writes here need the message in one buffer.
+  message->FlattenSegmentedPayload();
   message->TraceMessageBegin();
   output_queue_.push(message);
   // ensure waiting to write
@@ -4,8 +4,11 @@
 
 #include "ipc/ipc_forwarding_message_filter.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/location.h"
+#include "ipc/ipc_message_macros.h"
 
 namespace IPC {
 
@@ -50,6 +53,23 @@ bool ForwardingMessageFilter::OnMessageReceived(const Message& message) {
   return true;
 }
 
+bool ForwardingMessageFilter::GetSupportedMessageClasses(
+    std::vector<uint32>* supported_message_classes) const {
+  for (std::set<int>::const_iterator it = message_ids_to_filter_.begin();
+       it != message_ids_to_filter_.end(); ++it) {
+    uint32 message_class = IPC_MESSAGE_ID_CLASS(static_cast<uint32>(*it));
+    // Ids which are not of any message class still get every message.
+    if (message_class >= LastIPCMsgStart)
+      return false;
+    if (std::find(supported_message_classes->begin(),
+                  supported_message_classes->end(),
+                  message_class) == supported_message_classes->end()) {
+      supported_message_classes->push_back(message_class);
+    }
+  }
+  return true;
+}
+
 ForwardingMessageFilter::~ForwardingMessageFilter() {
 }
 
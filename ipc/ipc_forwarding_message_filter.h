@@ -7,6 +7,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/callback_forward.h"
@@ -46,6 +47,8 @@ class IPC_EXPORT ForwardingMessageFilter : public ChannelProxy::MessageFilter {
 
   // ChannelProxy::MessageFilter methods:
   virtual bool OnMessageReceived(const Message& message) OVERRIDE;
+  virtual bool GetSupportedMessageClasses(
+      std::vector<uint32>* supported_message_classes) const OVERRIDE;
 
  private:
   friend class ChannelProxy::MessageFilter;
@@ -6,6 +6,7 @@
 
 #include "base/atomicops.h"
 #include "base/logging.h"
+#include "base/segmented_pickle.h"
 #include "build/build_config.h"
 
 #if defined(OS_POSIX)
@@ -69,6 +70,8 @@ Message::Message(const char* data, int data_len) : Pickle(data, data_len) {
 
 Message::Message(const Message& other) : Pickle(other) {
   InitLoggingVariables();
+  if (other.segmented_payload_)
+    AppendSegmentedPayload(*other.segmented_payload_);
 #if defined(OS_POSIX)
   file_descriptor_set_ = other.file_descriptor_set_;
 #endif
@@ -84,6 +87,9 @@ void Message::InitLoggingVariables() {
 
 Message& Message::operator=(const Message& other) {
   *static_cast<Pickle*>(this) = other;
+  segmented_payload_.reset();
+  if (other.segmented_payload_)
+    AppendSegmentedPayload(*other.segmented_payload_);
 #if defined(OS_POSIX)
   file_descriptor_set_ = other.file_descriptor_set_;
 #endif
@@ -99,9 +105,37 @@ void Message::SetHeaderValues(int32 routing, uint32 type, uint32 flags) {
   header()->flags = flags;
 }
 
+void Message::SetSegmentedPayload(scoped_ptr<SegmentedPickle> payload) {
+  DCHECK_EQ(0u, payload_size());
+  DCHECK(!segmented_payload_);
+  DCHECK_EQ(sizeof(Pickle::Header), payload->header_size());
+  segmented_payload_ = payload.Pass();
+}
+
+void Message::FlattenSegmentedPayload() {
+  if (!segmented_payload_)
+    return;
+  scoped_ptr<SegmentedPickle> payload(segmented_payload_.Pass());
+  AppendSegmentedPayload(*payload);
+}
+
+void Message::AppendSegmentedPayload(const SegmentedPickle& payload) {
+  Reserve(payload.payload_size());
+  size_t offset = payload.header_size();
+  for (size_t i = 0; i < payload.segment_count(); ++i) {
+    // Every segment but the last holds a multiple of 32 bits, so writing them
+    // one at a time reproduces the original alignment.
+    WriteBytes(payload.segment_data(i) + offset,
+               static_cast<int>(payload.segment_size(i) - offset));
+    offset = 0;
+  }
+}
+
 #ifdef IPC_MESSAGE_LOG_ENABLED
 void Message::set_sent_time(int64 time) {
   DCHECK((header()->flags & HAS_SENT_TIME_BIT) == 0);
+  // The time goes after the payload, so the payload must be in place first.
+  FlattenSegmentedPayload();
   header()->flags |= HAS_SENT_TIME_BIT;
   WriteInt64(time);
 }
@@ -9,6 +9,7 @@
 
 #include "base/basictypes.h"
 #include "base/debug/trace_event.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/pickle.h"
 #include "ipc/ipc_export.h"
 
@@ -25,6 +26,7 @@ struct FileDescriptor;
 }
 
 class FileDescriptorSet;
+class SegmentedPickle;
 
 namespace IPC {
 
@@ -73,6 +75,10 @@ class IPC_EXPORT Message : public Pickle {
     return static_cast<PriorityValue>(header()->flags & PRIORITY_MASK);
   }
 
+  void set_priority(PriorityValue priority) {
+    header()->flags = (header()->flags & ~PRIORITY_MASK) | priority;
+  }
+
   // True if this is a synchronous message.
   void set_sync() {
     header()->flags |= SYNC_BIT;
@@ -141,6 +147,20 @@ class IPC_EXPORT Message : public Pickle {
   // call.
   void SetHeaderValues(int32 routing, uint32 type, uint32 flags);
 
+  // Makes |payload| the payload of this message, which must be empty. The
+  // payload stays in its segments: channels that support scatter-gather I/O
+  // send it without ever copying it into one buffer. Until
+  // FlattenSegmentedPayload() is called, size() and payload() only describe
+  // the header, and nothing else may be written to the message.
+  void SetSegmentedPayload(scoped_ptr<SegmentedPickle> payload);
+  bool has_segmented_payload() const {
+    return segmented_payload_.get() != NULL;
+  }
+
+  // Copies the segmented payload, if any, into the message's own buffer, for
+  // code that needs a contiguous view of the message.
+  void FlattenSegmentedPayload();
+
   template<class T, class S>
   static bool Dispatch(const Message* msg, T* obj, S* sender,
                        void (T::*func)()) {
@@ -179,6 +199,16 @@ class IPC_EXPORT Message : public Pickle {
     return Pickle::FindNext(sizeof(Header), range_start, range_end);
   }
 
+  // Sets |message_size| to the size of the message data that starts at
+  // range_start, and returns true. Returns false if the given data range does
+  // not hold enough of the message to tell.
+  static bool PeekNext(const char* range_start,
+                       const char* range_end,
+                       size_t* message_size) {
+    return Pickle::PeekNext(sizeof(Header), range_start, range_end,
+                            message_size);
+  }
+
 #if defined(OS_POSIX)
   // On POSIX, a message supports reading / writing FileDescriptor objects.
   // This is used to pass a file descriptor to the peer of an IPC channel.
@@ -252,6 +282,16 @@ class IPC_EXPORT Message : public Pickle {
 
   void InitLoggingVariables();
 
+  // Appends the payload of |payload| to this message's own buffer.
+  void AppendSegmentedPayload(const SegmentedPickle& payload);
+
+  const SegmentedPickle* segmented_payload() const {
+    return segmented_payload_.get();
+  }
+
+  // Set by SetSegmentedPayload(); NULL once flattened.
+  scoped_ptr<SegmentedPickle> segmented_payload_;
+
 #if defined(OS_POSIX)
   // The set of file descriptors associated with this message.
   scoped_refptr<FileDescriptorSet> file_descriptor_set_;
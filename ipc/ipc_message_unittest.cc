@@ -7,6 +7,7 @@
 #include <string.h>
 
 #include "base/memory/scoped_ptr.h"
+#include "base/segmented_pickle.h"
 #include "base/values.h"
 #include "ipc/ipc_message_utils.h"
 #include "testing/gtest/include/gtest/gtest.h"
@@ -70,4 +71,44 @@ TEST(IPCMessageTest, DictionaryValue) {
   EXPECT_FALSE(IPC::ReadParam(&bad_msg, &iter, &output));
 }
 
+TEST(IPCMessageTest, SegmentedPayload) {
+  std::string big(SegmentedPickle::kSegmentSize * 3 + 1, 'x');
+  scoped_ptr<SegmentedPickle> payload(new SegmentedPickle);
+  EXPECT_TRUE(payload->WriteInt(42));
+  EXPECT_TRUE(payload->WriteString(big));
+  EXPECT_TRUE(payload->WriteInt(43));
+
+  IPC::Message expected(1, 2, IPC::Message::PRIORITY_NORMAL);
+  EXPECT_TRUE(expected.WriteInt(42));
+  EXPECT_TRUE(expected.WriteString(big));
+  EXPECT_TRUE(expected.WriteInt(43));
+
+  IPC::Message msg(1, 2, IPC::Message::PRIORITY_NORMAL);
+  msg.SetSegmentedPayload(payload.Pass());
+  EXPECT_TRUE(msg.has_segmented_payload());
+
+  // Copies are always flat.
+  IPC::Message copy(msg);
+  EXPECT_FALSE(copy.has_segmented_payload());
+  ASSERT_EQ(expected.payload_size(), copy.payload_size());
+  EXPECT_EQ(0, memcmp(expected.payload(), copy.payload(),
+                      expected.payload_size()));
+
+  msg.FlattenSegmentedPayload();
+  EXPECT_FALSE(msg.has_segmented_payload());
+  ASSERT_EQ(expected.payload_size(), msg.payload_size());
+  EXPECT_EQ(0, memcmp(expected.payload(), msg.payload(),
+                      expected.payload_size()));
+
+  PickleIterator iter(msg);
+  int value;
+  std::string out;
+  EXPECT_TRUE(msg.ReadInt(&iter, &value));
+  EXPECT_EQ(42, value);
+  EXPECT_TRUE(msg.ReadString(&iter, &out));
+  EXPECT_EQ(big, out);
+  EXPECT_TRUE(msg.ReadInt(&iter, &value));
+  EXPECT_EQ(43, value);
+}
+
 }  // namespace
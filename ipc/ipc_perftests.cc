@@ -6,9 +6,11 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/pickle.h"
 #include "base/strings/stringprintf.h"
@@ -18,9 +20,11 @@
 #include "ipc/ipc_channel.h"
 #include "ipc/ipc_channel_proxy.h"
 #include "ipc/ipc_descriptors.h"
+#include "ipc/ipc_message_macros.h"
 #include "ipc/ipc_message_utils.h"
 #include "ipc/ipc_sender.h"
 #include "ipc/ipc_test_base.h"
+#include "ipc/message_filter_router.h"
 
 namespace {
 
@@ -29,6 +33,13 @@ namespace {
 // TODO(brettw): Make this test run by default.
 
 class IPCChannelPerfTest : public IPCTestBase {
+ protected:
+  // Times the roundtrips of messages of increasing sizes, with the client
+  // |client_name| at the other end of a channel in |mode|. |label| prefixes
+  // the names of the results.
+  void RunPerformanceTest(const std::string& client_name,
+                          IPC::Channel::Mode mode,
+                          const char* label);
 };
 
 // This class simply collects stats about abstract "events" (each of which has a
@@ -137,8 +148,9 @@ class ChannelReflectorListener : public IPC::Listener {
 
 class PerformanceChannelListener : public IPC::Listener {
  public:
-  PerformanceChannelListener()
-      : channel_(NULL),
+  explicit PerformanceChannelListener(const char* label)
+      : label_(label),
+        channel_(NULL),
         msg_count_(0),
         msg_size_(0),
         count_down_(0),
@@ -183,7 +195,7 @@ class PerformanceChannelListener : public IPC::Listener {
       latency_tracker_.Reset();
       DCHECK(!perf_logger_.get());
       std::string test_name = base::StringPrintf(
-          "IPC_Perf_%dx_%u", msg_count_, static_cast<unsigned>(msg_size_));
+          "%s_%dx_%u", label_, msg_count_, static_cast<unsigned>(msg_size_));
       perf_logger_.reset(new base::PerfTimeLogger(test_name.c_str()));
     } else {
       DCHECK_EQ(payload_.size(), reflected_payload.size());
@@ -210,6 +222,7 @@ class PerformanceChannelListener : public IPC::Listener {
   }
 
  private:
+  const char* label_;
   IPC::Channel* channel_;
   int msg_count_;
   size_t msg_size_;
@@ -220,12 +233,14 @@ class PerformanceChannelListener : public IPC::Listener {
   scoped_ptr<base::PerfTimeLogger> perf_logger_;
 };
 
-TEST_F(IPCChannelPerfTest, Performance) {
-  Init("PerformanceClient");
+void IPCChannelPerfTest::RunPerformanceTest(const std::string& client_name,
+                                            IPC::Channel::Mode mode,
+                                            const char* label) {
+  Init(client_name);
 
   // Set up IPC channel and start client.
-  PerformanceChannelListener listener;
-  CreateChannel(&listener);
+  PerformanceChannelListener listener(label);
+  CreateChannelWithMode(&listener, mode);
   listener.Init(channel());
   ASSERT_TRUE(ConnectChannel());
   ASSERT_TRUE(StartClient());
@@ -262,12 +277,82 @@ TEST_F(IPCChannelPerfTest, Performance) {
   DestroyChannel();
 }
 
+TEST_F(IPCChannelPerfTest, Performance) {
+  RunPerformanceTest("PerformanceClient", IPC::Channel::MODE_SERVER,
+                     "IPC_Perf");
+}
+
+#if defined(OS_POSIX)
+// The same roundtrips through shared memory instead of the socket.
+TEST_F(IPCChannelPerfTest, SharedMemoryPerformance) {
+  RunPerformanceTest("SharedMemoryPerformanceClient",
+                     IPC::Channel::MODE_SHARED_MEMORY_SERVER,
+                     "IPC_SharedMemory_Perf");
+}
+#endif  // defined(OS_POSIX)
+
+// A filter which handles the messages of one message class, and may or may
+// not tell the router which class that is.
+class ClassMessageFilter : public IPC::ChannelProxy::MessageFilter {
+ public:
+  ClassMessageFilter(uint32 message_class, bool declare_message_class)
+      : message_class_(message_class),
+        declare_message_class_(declare_message_class) {
+  }
+
+  virtual bool OnMessageReceived(const IPC::Message& message) OVERRIDE {
+    return IPC_MESSAGE_ID_CLASS(message.type()) == message_class_;
+  }
+
+  virtual bool GetSupportedMessageClasses(
+      std::vector<uint32>* supported_message_classes) const OVERRIDE {
+    if (!declare_message_class_)
+      return false;
+    supported_message_classes->push_back(message_class_);
+    return true;
+  }
+
+ private:
+  virtual ~ClassMessageFilter() {}
+
+  uint32 message_class_;
+  bool declare_message_class_;
+};
+
+// Times handing messages to the filters of a ChannelProxy, with as many
+// filters as a browser has, and the message for the last one of them.
+void RunFilterDispatchTest(bool declare_message_classes, const char* label) {
+  const int kFilterCount = 24;
+  const int kMsgCount = 1000000;
+
+  std::vector<scoped_refptr<ClassMessageFilter> > filters;
+  IPC::MessageFilterRouter router;
+  for (int i = 0; i < kFilterCount; ++i) {
+    filters.push_back(new ClassMessageFilter(i, declare_message_classes));
+    router.AddFilter(filters.back().get());
+  }
+
+  IPC::Message message(0, (kFilterCount - 1) << 16,
+                       IPC::Message::PRIORITY_NORMAL);
+  std::string test_name = base::StringPrintf(
+      "%s_%dfilters_%dx", label, kFilterCount, kMsgCount);
+  base::PerfTimeLogger perf_logger(test_name.c_str());
+  for (int i = 0; i < kMsgCount; ++i)
+    CHECK(router.TryFilters(message));
+}
+
+TEST(IPCFilterDispatchPerfTest, Performance) {
+  RunFilterDispatchTest(false, "IPC_FilterDispatch_AllFilters");
+  RunFilterDispatchTest(true, "IPC_FilterDispatch_ByMessageClass");
+}
+
 // This message loop bounces all messages back to the sender.
-MULTIPROCESS_IPC_TEST_CLIENT_MAIN(PerformanceClient) {
+int RunReflectorClient(const std::string& client_name,
+                       IPC::Channel::Mode mode) {
   base::MessageLoopForIO main_message_loop;
   ChannelReflectorListener listener;
-  IPC::Channel channel(IPCTestBase::GetChannelName("PerformanceClient"),
-                       IPC::Channel::MODE_CLIENT,
+  IPC::Channel channel(IPCTestBase::GetChannelName(client_name),
+                       mode,
                        &listener);
   listener.Init(&channel);
   CHECK(channel.Connect());
@@ -276,4 +361,15 @@ MULTIPROCESS_IPC_TEST_CLIENT_MAIN(PerformanceClient) {
   return 0;
 }
 
+MULTIPROCESS_IPC_TEST_CLIENT_MAIN(PerformanceClient) {
+  return RunReflectorClient("PerformanceClient", IPC::Channel::MODE_CLIENT);
+}
+
+#if defined(OS_POSIX)
+MULTIPROCESS_IPC_TEST_CLIENT_MAIN(SharedMemoryPerformanceClient) {
+  return RunReflectorClient("SharedMemoryPerformanceClient",
+                            IPC::Channel::MODE_SHARED_MEMORY_CLIENT);
+}
+#endif  // defined(OS_POSIX)
+
 }  // namespace
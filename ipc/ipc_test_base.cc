@@ -76,6 +76,15 @@ void IPCTestBase::CreateChannelFromChannelHandle(
                                   listener));
 }
 
+void IPCTestBase::CreateChannelWithMode(IPC::Listener* listener,
+                                        IPC::Channel::Mode mode) {
+  CHECK(!channel_.get());
+  CHECK(!channel_proxy_.get());
+  channel_.reset(new IPC::Channel(GetChannelName(test_client_name_),
+                                  mode,
+                                  listener));
+}
+
 void IPCTestBase::CreateChannelProxy(
     IPC::Listener* listener,
     base::SingleThreadTaskRunner* ipc_task_runner) {
@@ -52,6 +52,10 @@ class IPCTestBase : public base::MultiProcessTest {
   void CreateChannelFromChannelHandle(const IPC::ChannelHandle& channel_handle,
                                       IPC::Listener* listener);
 
+  // Use this instead of CreateChannel() to create the channel in a mode other
+  // than MODE_SERVER, such as MODE_SHARED_MEMORY_SERVER.
+  void CreateChannelWithMode(IPC::Listener* listener, IPC::Channel::Mode mode);
+
   // Creates a channel proxy with the given listener and task runner. (The
   // channel proxy will automatically create and connect a channel.) You must
   // (manually) destroy the channel proxy before the task runner's thread is
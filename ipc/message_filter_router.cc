@@ -0,0 +1,76 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/message_filter_router.h"
+
+#include <algorithm>
+
+#include "ipc/ipc_message_macros.h"
+
+namespace IPC {
+
+namespace {
+
+void RemoveFilterFrom(std::vector<MessageFilterRouter::MessageFilter*>* filters,
+                      MessageFilterRouter::MessageFilter* filter) {
+  filters->erase(std::remove(filters->begin(), filters->end(), filter),
+                 filters->end());
+}
+
+}  // namespace
+
+MessageFilterRouter::MessageFilterRouter() {}
+
+MessageFilterRouter::~MessageFilterRouter() {}
+
+void MessageFilterRouter::AddFilter(MessageFilter* filter) {
+  std::vector<uint32> supported_message_classes;
+  bool supports_all_classes =
+      !filter->GetSupportedMessageClasses(&supported_message_classes);
+  for (size_t i = 0; i < supported_message_classes.size(); ++i) {
+    if (supported_message_classes[i] >= LastIPCMsgStart) {
+      NOTREACHED() << "Invalid message class " << supported_message_classes[i];
+      supports_all_classes = true;
+    }
+  }
+
+  if (supports_all_classes) {
+    global_filters_.push_back(filter);
+    for (size_t i = 0; i < arraysize(message_class_filters_); ++i)
+      message_class_filters_[i].push_back(filter);
+    return;
+  }
+
+  for (size_t i = 0; i < supported_message_classes.size(); ++i) {
+    MessageFilters& filters =
+        message_class_filters_[supported_message_classes[i]];
+    if (std::find(filters.begin(), filters.end(), filter) == filters.end())
+      filters.push_back(filter);
+  }
+}
+
+void MessageFilterRouter::RemoveFilter(MessageFilter* filter) {
+  RemoveFilterFrom(&global_filters_, filter);
+  for (size_t i = 0; i < arraysize(message_class_filters_); ++i)
+    RemoveFilterFrom(&message_class_filters_[i], filter);
+}
+
+bool MessageFilterRouter::TryFilters(const Message& message) {
+  uint32 message_class = IPC_MESSAGE_ID_CLASS(message.type());
+  const MessageFilters& filters = message_class < LastIPCMsgStart ?
+      message_class_filters_[message_class] : global_filters_;
+  for (size_t i = 0; i < filters.size(); ++i) {
+    if (filters[i]->OnMessageReceived(message))
+      return true;
+  }
+  return false;
+}
+
+void MessageFilterRouter::Clear() {
+  global_filters_.clear();
+  for (size_t i = 0; i < arraysize(message_class_filters_); ++i)
+    message_class_filters_[i].clear();
+}
+
+}  // namespace IPC
@@ -0,0 +1,52 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_MESSAGE_FILTER_ROUTER_H_
+#define IPC_MESSAGE_FILTER_ROUTER_H_
+
+#include <vector>
+
+#include "base/basictypes.h"
+#include "ipc/ipc_channel_proxy.h"
+#include "ipc/ipc_export.h"
+#include "ipc/ipc_message_start.h"
+
+namespace IPC {
+
+// Routes each message to the MessageFilters which can handle its message
+// class, in the order the filters were added. A filter which does not tell
+// its message classes is offered every message. The router does not own the
+// filters, which must be removed before they go away.
+class IPC_EXPORT MessageFilterRouter {
+ public:
+  typedef ChannelProxy::MessageFilter MessageFilter;
+
+  MessageFilterRouter();
+  ~MessageFilterRouter();
+
+  void AddFilter(MessageFilter* filter);
+  void RemoveFilter(MessageFilter* filter);
+
+  // Offers |message| to the filters for its message class until one handles
+  // it. Returns true if one did.
+  bool TryFilters(const Message& message);
+
+  void Clear();
+
+ private:
+  typedef std::vector<MessageFilter*> MessageFilters;
+
+  // Filters offered messages of every class, which also get the messages of
+  // classes past LastIPCMsgStart, such as replies to sync messages.
+  MessageFilters global_filters_;
+
+  // The filters for each message class, global or not, in the order added.
+  MessageFilters message_class_filters_[LastIPCMsgStart];
+
+  DISALLOW_COPY_AND_ASSIGN(MessageFilterRouter);
+};
+
+}  // namespace IPC
+
+#endif  // IPC_MESSAGE_FILTER_ROUTER_H_
@@ -0,0 +1,145 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/message_filter_router.h"
+
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "ipc/ipc_message.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace IPC {
+
+namespace {
+
+// Handles the messages of the classes it is given, or of every class if it
+// is given none, and remembers the order the filters were tried in.
+class TestFilter : public ChannelProxy::MessageFilter {
+ public:
+  TestFilter(const std::vector<uint32>& message_classes,
+             bool handle_messages,
+             std::vector<TestFilter*>* tried_filters)
+      : message_classes_(message_classes),
+        handle_messages_(handle_messages),
+        tried_filters_(tried_filters) {
+  }
+
+  virtual bool OnMessageReceived(const Message& message) OVERRIDE {
+    tried_filters_->push_back(this);
+    return handle_messages_;
+  }
+
+  virtual bool GetSupportedMessageClasses(
+      std::vector<uint32>* supported_message_classes) const OVERRIDE {
+    if (message_classes_.empty())
+      return false;
+    *supported_message_classes = message_classes_;
+    return true;
+  }
+
+ private:
+  virtual ~TestFilter() {}
+
+  std::vector<uint32> message_classes_;
+  bool handle_messages_;
+  std::vector<TestFilter*>* tried_filters_;
+};
+
+Message MessageOfClass(uint32 message_class) {
+  return Message(MSG_ROUTING_CONTROL, message_class << 16,
+                 Message::PRIORITY_NORMAL);
+}
+
+class MessageFilterRouterTest : public testing::Test {
+ protected:
+  TestFilter* AddFilter(uint32 message_class, bool handle_messages) {
+    std::vector<uint32> message_classes;
+    message_classes.push_back(message_class);
+    return AddFilterForClasses(message_classes, handle_messages);
+  }
+
+  TestFilter* AddFilterForClasses(const std::vector<uint32>& message_classes,
+                                  bool handle_messages) {
+    scoped_refptr<TestFilter> filter(
+        new TestFilter(message_classes, handle_messages, &tried_filters_));
+    filters_.push_back(filter);
+    router_.AddFilter(filter.get());
+    return filter.get();
+  }
+
+  MessageFilterRouter router_;
+  std::vector<scoped_refptr<TestFilter> > filters_;
+  std::vector<TestFilter*> tried_filters_;
+};
+
+TEST_F(MessageFilterRouterTest, RoutesByMessageClass) {
+  TestFilter* view_filter = AddFilter(ViewMsgStart, false);
+  TestFilter* test_filter = AddFilter(TestMsgStart, true);
+
+  EXPECT_TRUE(router_.TryFilters(MessageOfClass(TestMsgStart)));
+  ASSERT_EQ(1u, tried_filters_.size());
+  EXPECT_EQ(test_filter, tried_filters_[0]);
+
+  tried_filters_.clear();
+  EXPECT_FALSE(router_.TryFilters(MessageOfClass(ViewMsgStart)));
+  ASSERT_EQ(1u, tried_filters_.size());
+  EXPECT_EQ(view_filter, tried_filters_[0]);
+
+  tried_filters_.clear();
+  EXPECT_FALSE(router_.TryFilters(MessageOfClass(FrameMsgStart)));
+  EXPECT_TRUE(tried_filters_.empty());
+}
+
+// Filters for every class and filters for some classes are tried in the order
+// they were added, and only until one handles the message.
+TEST_F(MessageFilterRouterTest, KeepsFilterOrder) {
+  TestFilter* first = AddFilter(TestMsgStart, false);
+  TestFilter* global = AddFilterForClasses(std::vector<uint32>(), false);
+  TestFilter* last = AddFilter(TestMsgStart, true);
+  AddFilterForClasses(std::vector<uint32>(), true);
+
+  EXPECT_TRUE(router_.TryFilters(MessageOfClass(TestMsgStart)));
+  ASSERT_EQ(3u, tried_filters_.size());
+  EXPECT_EQ(first, tried_filters_[0]);
+  EXPECT_EQ(global, tried_filters_[1]);
+  EXPECT_EQ(last, tried_filters_[2]);
+}
+
+// Messages outside of any class, like sync message replies, go to the
+// filters for every class.
+TEST_F(MessageFilterRouterTest, RepliesGoToGlobalFilters) {
+  AddFilter(TestMsgStart, true);
+  TestFilter* global = AddFilterForClasses(std::vector<uint32>(), true);
+
+  Message reply(MSG_ROUTING_CONTROL, IPC_REPLY_ID, Message::PRIORITY_NORMAL);
+  EXPECT_TRUE(router_.TryFilters(reply));
+  ASSERT_EQ(1u, tried_filters_.size());
+  EXPECT_EQ(global, tried_filters_[0]);
+}
+
+TEST_F(MessageFilterRouterTest, RemoveFilter) {
+  std::vector<uint32> message_classes;
+  message_classes.push_back(ViewMsgStart);
+  message_classes.push_back(TestMsgStart);
+  TestFilter* filter = AddFilterForClasses(message_classes, true);
+  TestFilter* global = AddFilterForClasses(std::vector<uint32>(), true);
+
+  router_.RemoveFilter(filter);
+  EXPECT_TRUE(router_.TryFilters(MessageOfClass(ViewMsgStart)));
+  EXPECT_TRUE(router_.TryFilters(MessageOfClass(TestMsgStart)));
+  ASSERT_EQ(2u, tried_filters_.size());
+  EXPECT_EQ(global, tried_filters_[0]);
+  EXPECT_EQ(global, tried_filters_[1]);
+
+  router_.RemoveFilter(global);
+  EXPECT_FALSE(router_.TryFilters(MessageOfClass(ViewMsgStart)));
+  EXPECT_FALSE(router_.TryFilters(Message(MSG_ROUTING_CONTROL, IPC_REPLY_ID,
+                                          Message::PRIORITY_NORMAL)));
+  EXPECT_EQ(2u, tried_filters_.size());
+}
+
+}  // namespace
+
+}  // namespace IPC
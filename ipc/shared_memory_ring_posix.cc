@@ -0,0 +1,174 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/shared_memory_ring_posix.h"
+
+#include <string.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+
+#include "base/atomicops.h"
+#include "base/logging.h"
+
+namespace IPC {
+namespace internal {
+
+namespace {
+
+// The fields written by each side are kept on cache lines of their own.
+const size_t kCacheLineSize = 64;
+
+}  // namespace
+
+// Positions count bytes from the creation of the ring and wrap around at
+// 2^32, which kCapacity divides.
+struct SharedMemoryRing::Header {
+  // Written by the writer, except that the reader clears |writer_waiting|.
+  base::subtle::Atomic32 write_position;
+  base::subtle::Atomic32 writer_waiting;
+  char writer_padding[kCacheLineSize - 2 * sizeof(base::subtle::Atomic32)];
+
+  // Written by the reader, except that the writer clears |reader_waiting|.
+  base::subtle::Atomic32 read_position;
+  base::subtle::Atomic32 reader_waiting;
+  char reader_padding[kCacheLineSize - 2 * sizeof(base::subtle::Atomic32)];
+};
+
+SharedMemoryRing::SharedMemoryRing() : position_(0) {
+  COMPILE_ASSERT((kCapacity & (kCapacity - 1)) == 0,
+                 ring_capacity_must_be_a_power_of_two);
+}
+
+SharedMemoryRing::~SharedMemoryRing() {
+}
+
+bool SharedMemoryRing::Create() {
+  DCHECK(!is_open());
+  scoped_ptr<base::SharedMemory> shared_memory(new base::SharedMemory);
+  // Anonymous shared memory starts out zeroed, which is an empty ring.
+  if (!shared_memory->CreateAndMapAnonymous(sizeof(Header) + kCapacity))
+    return false;
+  shared_memory_.swap(shared_memory);
+  position_ = 0;
+  return true;
+}
+
+bool SharedMemoryRing::Open(const base::SharedMemoryHandle& handle) {
+  DCHECK(!is_open());
+  scoped_ptr<base::SharedMemory> shared_memory(
+      new base::SharedMemory(handle, false));
+  // Mapping past the end of the memory would fault on access.
+  struct stat st;
+  if (fstat(handle.fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(Header) + kCapacity) {
+    DLOG(ERROR) << "Shared memory is too small for a ring";
+    return false;
+  }
+  if (!shared_memory->Map(sizeof(Header) + kCapacity))
+    return false;
+  shared_memory_.swap(shared_memory);
+  position_ = 0;
+  return true;
+}
+
+base::SharedMemoryHandle SharedMemoryRing::handle() const {
+  DCHECK(is_open());
+  return shared_memory_->handle();
+}
+
+int SharedMemoryRing::Write(const char* data, size_t length) {
+  // Acquire, so the reader is done with the bytes about to be overwritten.
+  uint32 used = position_ - static_cast<uint32>(
+      base::subtle::Acquire_Load(&header()->read_position));
+  if (used > kCapacity)
+    return -1;
+
+  size_t count = std::min(length, kCapacity - used);
+  size_t offset = position_ & (kCapacity - 1);
+  size_t first = std::min(count, kCapacity - offset);
+  memcpy(this->data() + offset, data, first);
+  memcpy(this->data(), data + first, count - first);
+
+  if (count) {
+    position_ += count;
+    base::subtle::Release_Store(&header()->write_position,
+                                static_cast<base::subtle::Atomic32>(position_));
+  }
+  return static_cast<int>(count);
+}
+
+bool SharedMemoryRing::TakeReaderWakeup() {
+  // Pairs with the barrier in WaitForData(): either the reader sees the data
+  // written last, or this sees the reader waiting.
+  base::subtle::MemoryBarrier();
+  if (!base::subtle::NoBarrier_Load(&header()->reader_waiting))
+    return false;
+  return base::subtle::NoBarrier_AtomicExchange(&header()->reader_waiting,
+                                                0) != 0;
+}
+
+bool SharedMemoryRing::WaitForSpace() {
+  base::subtle::NoBarrier_Store(&header()->writer_waiting, 1);
+  base::subtle::MemoryBarrier();
+  uint32 used = position_ - static_cast<uint32>(
+      base::subtle::NoBarrier_Load(&header()->read_position));
+  if (used >= kCapacity)
+    return true;
+  base::subtle::NoBarrier_Store(&header()->writer_waiting, 0);
+  return false;
+}
+
+int SharedMemoryRing::Read(char* buffer, size_t length) {
+  // Acquire, so the data up to the write position is visible.
+  uint32 available = static_cast<uint32>(
+      base::subtle::Acquire_Load(&header()->write_position)) - position_;
+  if (available > kCapacity)
+    return -1;
+
+  size_t count = std::min(length, static_cast<size_t>(available));
+  size_t offset = position_ & (kCapacity - 1);
+  size_t first = std::min(count, kCapacity - offset);
+  memcpy(buffer, data() + offset, first);
+  memcpy(buffer + first, data(), count - first);
+
+  if (count) {
+    position_ += count;
+    base::subtle::Release_Store(&header()->read_position,
+                                static_cast<base::subtle::Atomic32>(position_));
+  }
+  return static_cast<int>(count);
+}
+
+bool SharedMemoryRing::TakeWriterWakeup() {
+  // Pairs with the barrier in WaitForSpace().
+  base::subtle::MemoryBarrier();
+  if (!base::subtle::NoBarrier_Load(&header()->writer_waiting))
+    return false;
+  return base::subtle::NoBarrier_AtomicExchange(&header()->writer_waiting,
+                                                0) != 0;
+}
+
+bool SharedMemoryRing::WaitForData() {
+  base::subtle::NoBarrier_Store(&header()->reader_waiting, 1);
+  base::subtle::MemoryBarrier();
+  if (static_cast<uint32>(
+          base::subtle::NoBarrier_Load(&header()->write_position)) ==
+      position_) {
+    return true;
+  }
+  base::subtle::NoBarrier_Store(&header()->reader_waiting, 0);
+  return false;
+}
+
+SharedMemoryRing::Header* SharedMemoryRing::header() const {
+  return static_cast<Header*>(shared_memory_->memory());
+}
+
+char* SharedMemoryRing::data() const {
+  return static_cast<char*>(shared_memory_->memory()) + sizeof(Header);
+}
+
+}  // namespace internal
+}  // namespace IPC
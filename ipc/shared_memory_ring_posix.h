@@ -0,0 +1,101 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef IPC_SHARED_MEMORY_RING_POSIX_H_
+#define IPC_SHARED_MEMORY_RING_POSIX_H_
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
+#include "ipc/ipc_export.h"
+
+namespace IPC {
+namespace internal {
+
+// SharedMemoryRing is a byte stream from one process to another through a
+// ring buffer in shared memory, with a single writer and a single reader. Data
+// moves without system calls; the two sides only have to signal each other,
+// by some other means, when one of them has run out of data or space and is
+// going to sleep. A side announces in the ring that it is going to sleep, and
+// the other side learns from the ring whether it has to wake it:
+//
+//   Writer                                 Reader
+//   Write(data)                            Read(buffer)
+//   if (TakeReaderWakeup())                if (TakeWriterWakeup())
+//     <wake the reader>                      <wake the writer>
+//   if (out of space && WaitForSpace())    if (out of data && WaitForData())
+//     <sleep>                                <sleep>
+//
+// The peer can write anything to the shared memory, so neither side trusts
+// the position of the other, and a ring found inconsistent fails.
+class IPC_EXPORT SharedMemoryRing {
+ public:
+  // The number of bytes the ring holds. A power of two.
+  static const size_t kCapacity = 256 * 1024;
+
+  SharedMemoryRing();
+  ~SharedMemoryRing();
+
+  // Creates a new, empty ring. Returns false on failure.
+  bool Create();
+
+  // Maps the ring created by another SharedMemoryRing, whose handle() has
+  // been passed to this process as |handle|. Takes ownership of |handle|.
+  // Returns false if |handle| is not large enough to be a ring.
+  bool Open(const base::SharedMemoryHandle& handle);
+
+  bool is_open() const { return shared_memory_.get() != NULL; }
+
+  // The handle to pass to the peer. It remains owned by this object.
+  base::SharedMemoryHandle handle() const;
+
+  // Writer side.
+
+  // Copies as much of |data| as fits into the ring. Returns the number of
+  // bytes copied, or -1 if the ring is corrupt.
+  int Write(const char* data, size_t length);
+
+  // Returns true if the reader has gone to sleep waiting for data since the
+  // last call. The caller must then wake it.
+  bool TakeReaderWakeup();
+
+  // Announces that the writer goes to sleep until the reader makes room, and
+  // returns true. Returns false instead if there is room already, in which
+  // case the writer should write more rather than sleep.
+  bool WaitForSpace();
+
+  // Reader side.
+
+  // Copies up to |length| bytes out of the ring into |buffer|. Returns the
+  // number of bytes copied, or -1 if the ring is corrupt.
+  int Read(char* buffer, size_t length);
+
+  // Returns true if the writer has gone to sleep waiting for space since the
+  // last call. The caller must then wake it.
+  bool TakeWriterWakeup();
+
+  // Announces that the reader goes to sleep until the writer adds data, and
+  // returns true. Returns false instead if there is data already, in which
+  // case the reader should read more rather than sleep.
+  bool WaitForData();
+
+ private:
+  struct Header;
+
+  Header* header() const;
+  char* data() const;
+
+  scoped_ptr<base::SharedMemory> shared_memory_;
+
+  // The write position of a writer, or the read position of a reader. It is
+  // kept here as well as in the ring so the peer cannot move it.
+  uint32 position_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedMemoryRing);
+};
+
+}  // namespace internal
+}  // namespace IPC
+
+#endif  // IPC_SHARED_MEMORY_RING_POSIX_H_
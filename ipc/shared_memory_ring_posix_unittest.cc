@@ -0,0 +1,140 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ipc/shared_memory_ring_posix.h"
+
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "base/posix/eintr_wrapper.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace IPC {
+namespace internal {
+
+namespace {
+
+// Returns a new handle to the memory behind |handle|, as the peer would get.
+base::SharedMemoryHandle DuplicateHandle(
+    const base::SharedMemoryHandle& handle) {
+  return base::FileDescriptor(HANDLE_EINTR(dup(handle.fd)), true);
+}
+
+class SharedMemoryRingTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(writer_.Create());
+    ASSERT_TRUE(reader_.Open(DuplicateHandle(writer_.handle())));
+  }
+
+  std::string Read(size_t length) {
+    std::string buffer(length, '\0');
+    int bytes_read = reader_.Read(&buffer[0], length);
+    EXPECT_LE(0, bytes_read);
+    buffer.resize(bytes_read > 0 ? bytes_read : 0);
+    return buffer;
+  }
+
+  SharedMemoryRing writer_;
+  SharedMemoryRing reader_;
+};
+
+TEST_F(SharedMemoryRingTest, WriteAndRead) {
+  EXPECT_EQ("", Read(10));
+  EXPECT_EQ(5, writer_.Write("hello", 5));
+  EXPECT_EQ(6, writer_.Write(" world", 6));
+  EXPECT_EQ("hello w", Read(7));
+  EXPECT_EQ("orld", Read(10));
+  EXPECT_EQ("", Read(10));
+}
+
+TEST_F(SharedMemoryRingTest, FillAndWrapAround) {
+  const size_t kChunkSize = SharedMemoryRing::kCapacity / 3;
+  std::string data(SharedMemoryRing::kCapacity, 'a');
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>(i % 251);
+
+  // Only as much as fits is written.
+  EXPECT_EQ(static_cast<int>(SharedMemoryRing::kCapacity),
+            writer_.Write(data.data(), data.size()));
+  EXPECT_EQ(0, writer_.Write(data.data(), data.size()));
+
+  // Data written after reading some goes to the start of the memory.
+  EXPECT_EQ(data.substr(0, kChunkSize), Read(kChunkSize));
+  EXPECT_EQ(static_cast<int>(kChunkSize), writer_.Write(data.data(),
+                                                        data.size()));
+  EXPECT_EQ(data.substr(kChunkSize), Read(data.size() - kChunkSize));
+  EXPECT_EQ(data.substr(0, kChunkSize), Read(data.size()));
+
+  // Reads and writes across the end of the memory.
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(static_cast<int>(kChunkSize + i),
+              writer_.Write(data.data() + i, kChunkSize + i));
+    EXPECT_EQ(data.substr(i, kChunkSize + i), Read(kChunkSize + i));
+  }
+}
+
+TEST_F(SharedMemoryRingTest, WakeReader) {
+  // The reader only has to be woken once it has announced it is waiting.
+  EXPECT_EQ(1, writer_.Write("a", 1));
+  EXPECT_FALSE(writer_.TakeReaderWakeup());
+
+  // The reader does not wait while there is data.
+  EXPECT_FALSE(reader_.WaitForData());
+  EXPECT_EQ("a", Read(10));
+  EXPECT_TRUE(reader_.WaitForData());
+
+  EXPECT_EQ(1, writer_.Write("b", 1));
+  EXPECT_TRUE(writer_.TakeReaderWakeup());
+  EXPECT_FALSE(writer_.TakeReaderWakeup());
+  EXPECT_EQ("b", Read(10));
+}
+
+TEST_F(SharedMemoryRingTest, WakeWriter) {
+  std::string data(SharedMemoryRing::kCapacity, 'a');
+
+  // The writer does not wait while there is room.
+  EXPECT_EQ(static_cast<int>(data.size() - 1),
+            writer_.Write(data.data(), data.size() - 1));
+  EXPECT_FALSE(writer_.WaitForSpace());
+  EXPECT_EQ(1, writer_.Write(data.data(), data.size()));
+  EXPECT_TRUE(writer_.WaitForSpace());
+
+  EXPECT_EQ(data.substr(0, 10), Read(10));
+  EXPECT_TRUE(reader_.TakeWriterWakeup());
+  EXPECT_FALSE(reader_.TakeWriterWakeup());
+  EXPECT_EQ(10, writer_.Write(data.data(), data.size()));
+}
+
+// Positions which a misbehaving peer puts in the memory are not trusted.
+TEST(SharedMemoryRingCorruptionTest, PositionsAreChecked) {
+  SharedMemoryRing writer;
+  SharedMemoryRing reader;
+  base::SharedMemory shared_memory;
+  ASSERT_TRUE(shared_memory.CreateAndMapAnonymous(
+      SharedMemoryRing::kCapacity + 4096));
+  ASSERT_TRUE(writer.Open(DuplicateHandle(shared_memory.handle())));
+  ASSERT_TRUE(reader.Open(DuplicateHandle(shared_memory.handle())));
+
+  // Scribble over the positions, which are at the start of the memory.
+  memset(shared_memory.memory(), 0x7f, 4096);
+  char buffer[10];
+  EXPECT_EQ(-1, reader.Read(buffer, sizeof(buffer)));
+  EXPECT_EQ(-1, writer.Write(buffer, sizeof(buffer)));
+}
+
+TEST(SharedMemoryRingOpenTest, RejectsSmallMemory) {
+  base::SharedMemory shared_memory;
+  ASSERT_TRUE(shared_memory.CreateAndMapAnonymous(4096));
+  SharedMemoryRing ring;
+  EXPECT_FALSE(ring.Open(DuplicateHandle(shared_memory.handle())));
+  EXPECT_FALSE(ring.is_open());
+}
+
+}  // namespace
+
+}  // namespace internal
+}  // namespace IPC
@@ -10,6 +10,7 @@
 #include "base/strings/string_number_conversions.h"
 #include "build/build_config.h"
 #include "media/audio/audio_output_dispatcher_impl.h"
+#include "media/audio/audio_output_mixer.h"
 #include "media/audio/audio_output_proxy.h"
 #include "media/audio/audio_output_resampler.h"
 #include "media/audio/fake_audio_input_stream.h"
@@ -283,6 +284,15 @@ AudioOutputStream* AudioManagerBase::MakeAudioOutputStreamProxy(
     dispatcher = new AudioOutputResampler(this, params, output_params,
                                           output_device_id,
                                           kCloseDelay);
+
+    // Every stream with these parameters is mixed into one stream of the
+    // resampler.
+    if (params.format() == AudioParameters::AUDIO_PCM_LOW_LATENCY &&
+        CommandLine::ForCurrentProcess()->HasSwitch(
+            switches::kEnableAudioOutputMixer)) {
+      dispatcher = new AudioOutputMixer(this, params, output_device_id,
+                                        dispatcher);
+    }
   } else {
     dispatcher = new AudioOutputDispatcherImpl(this, output_params,
                                                output_device_id,
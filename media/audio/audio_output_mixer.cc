@@ -0,0 +1,208 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/audio/audio_output_mixer.h"
+
+#include "base/logging.h"
+#include "base/single_thread_task_runner.h"
+#include "media/audio/audio_output_proxy.h"
+#include "media/base/audio_bus.h"
+
+namespace media {
+
+// Provides the data of one of the mixer's streams to its AudioConverter.
+class MixerInput : public AudioConverter::InputCallback {
+ public:
+  MixerInput(AudioOutputStream::AudioSourceCallback* callback,
+             int bytes_per_second,
+             double volume)
+      : callback_(callback),
+        bytes_per_second_(bytes_per_second),
+        volume_(volume) {}
+  virtual ~MixerInput() {}
+
+  AudioOutputStream::AudioSourceCallback* callback() const {
+    return callback_;
+  }
+  void set_volume(double volume) { volume_ = volume; }
+
+  // AudioConverter::InputCallback implementation.
+  virtual double ProvideInput(AudioBus* audio_bus,
+                              base::TimeDelta buffer_delay) OVERRIDE {
+    // The delay of the mixed stream, which the mixer passes to the converter.
+    AudioBuffersState buffers_state(
+        buffer_delay.InSecondsF() * bytes_per_second_, 0);
+    const int frames = callback_->OnMoreIOData(NULL, audio_bus, buffers_state);
+
+    // Zero any unfilled frames if anything was filled, otherwise the converter
+    // skips this input.
+    if (frames > 0 && frames < audio_bus->frames())
+      audio_bus->ZeroFramesPartial(frames, audio_bus->frames() - frames);
+    return frames > 0 ? volume_ : 0;
+  }
+
+ private:
+  AudioOutputStream::AudioSourceCallback* const callback_;
+  const int bytes_per_second_;
+  double volume_;
+
+  DISALLOW_COPY_AND_ASSIGN(MixerInput);
+};
+
+AudioOutputMixer::AudioOutputMixer(
+    AudioManager* audio_manager,
+    const AudioParameters& params,
+    const std::string& output_device_id,
+    const scoped_refptr<AudioOutputDispatcher>& dispatcher)
+    : AudioOutputDispatcher(audio_manager, params, output_device_id),
+      dispatcher_(dispatcher),
+      stream_(NULL),
+      open_streams_(0),
+      converter_(params, params, true) {
+}
+
+AudioOutputMixer::~AudioOutputMixer() {
+  DCHECK(!stream_);
+  DCHECK(inputs_.empty());
+}
+
+bool AudioOutputMixer::OpenStream() {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+  if (!stream_) {
+    AudioOutputProxy* stream = new AudioOutputProxy(dispatcher_.get());
+    if (!stream->Open()) {
+      stream->Close();
+      return false;
+    }
+    stream_ = stream;
+  }
+  ++open_streams_;
+  return true;
+}
+
+bool AudioOutputMixer::StartStream(
+    AudioOutputStream::AudioSourceCallback* callback,
+    AudioOutputProxy* stream_proxy) {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+  DCHECK(stream_);
+
+  double volume = 0;
+  stream_proxy->GetVolume(&volume);
+  MixerInput* input =
+      new MixerInput(callback, params_.GetBytesPerSecond(), volume);
+  bool start_mixed_stream = false;
+  {
+    base::AutoLock auto_lock(lock_);
+    DCHECK(inputs_.find(stream_proxy) == inputs_.end());
+    start_mixed_stream = inputs_.empty();
+    inputs_[stream_proxy] = input;
+    converter_.AddInput(input);
+  }
+
+  if (start_mixed_stream)
+    stream_->Start(this);
+  return true;
+}
+
+void AudioOutputMixer::StopStream(AudioOutputProxy* stream_proxy) {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+
+  bool stop_mixed_stream = false;
+  {
+    base::AutoLock auto_lock(lock_);
+    InputMap::iterator it = inputs_.find(stream_proxy);
+    DCHECK(it != inputs_.end());
+    converter_.RemoveInput(it->second);
+    delete it->second;
+    inputs_.erase(it);
+    stop_mixed_stream = inputs_.empty();
+  }
+
+  // Stopping waits for OnMoreData() to return, so |lock_| must not be held.
+  if (stop_mixed_stream)
+    stream_->Stop();
+}
+
+void AudioOutputMixer::StreamVolumeSet(AudioOutputProxy* stream_proxy,
+                                       double volume) {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+  base::AutoLock auto_lock(lock_);
+  InputMap::iterator it = inputs_.find(stream_proxy);
+  if (it != inputs_.end())
+    it->second->set_volume(volume);
+}
+
+void AudioOutputMixer::CloseStream(AudioOutputProxy* stream_proxy) {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+  DCHECK_GT(open_streams_, 0);
+  if (--open_streams_ > 0)
+    return;
+
+  // |dispatcher_| keeps the physical stream open for a while in case another
+  // stream is opened soon.
+  stream_->Close();
+  stream_ = NULL;
+}
+
+void AudioOutputMixer::Shutdown() {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+
+  // No AudioOutputProxy objects should hold a reference to us when we get
+  // to this stage.
+  if (!HasOneRef())
+    LOG(WARNING) << "AudioOutputMixer has outstanding references on shutdown!";
+
+  if (stream_) {
+    if (!inputs_.empty())
+      stream_->Stop();
+    stream_->Close();
+    stream_ = NULL;
+  }
+  for (InputMap::iterator it = inputs_.begin(); it != inputs_.end(); ++it) {
+    converter_.RemoveInput(it->second);
+    delete it->second;
+  }
+  inputs_.clear();
+  dispatcher_->Shutdown();
+}
+
+void AudioOutputMixer::CloseStreamsForWedgeFix() {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+  dispatcher_->CloseStreamsForWedgeFix();
+}
+
+void AudioOutputMixer::RestartStreamsForWedgeFix() {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+  dispatcher_->RestartStreamsForWedgeFix();
+}
+
+int AudioOutputMixer::OnMoreData(AudioBus* dest,
+                                 AudioBuffersState buffers_state) {
+  return OnMoreIOData(NULL, dest, buffers_state);
+}
+
+int AudioOutputMixer::OnMoreIOData(AudioBus* source,
+                                   AudioBus* dest,
+                                   AudioBuffersState buffers_state) {
+  // Note: As with AudioOutputResampler, the input portion of OnMoreIOData() is
+  // not supported; downstream clients prefer silence to split apart input.
+  const base::TimeDelta delay = base::TimeDelta::FromMicroseconds(
+      buffers_state.total_bytes() * base::Time::kMicrosecondsPerSecond /
+      params_.GetBytesPerSecond());
+
+  base::AutoLock auto_lock(lock_);
+  converter_.ConvertWithDelay(delay, dest);
+
+  // The converter outputs silence for inputs that provided no data.
+  return dest->frames();
+}
+
+void AudioOutputMixer::OnError(AudioOutputStream* stream) {
+  // Each stream reports the error on its proxy.
+  base::AutoLock auto_lock(lock_);
+  for (InputMap::iterator it = inputs_.begin(); it != inputs_.end(); ++it)
+    it->second->callback()->OnError(it->first);
+}
+
+}  // namespace media
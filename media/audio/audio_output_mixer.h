@@ -0,0 +1,91 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MEDIA_AUDIO_AUDIO_OUTPUT_MIXER_H_
+#define MEDIA_AUDIO_AUDIO_OUTPUT_MIXER_H_
+
+#include <map>
+
+#include "base/basictypes.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "media/audio/audio_io.h"
+#include "media/audio/audio_output_dispatcher.h"
+#include "media/audio/audio_parameters.h"
+#include "media/base/audio_converter.h"
+
+namespace media {
+
+class MixerInput;
+
+// AudioOutputMixer is a browser-side mixer which plays every stream started
+// through it on one output stream, so that many renderers playing audio at the
+// same parameters hold one physical stream and cause one wakeup per buffer
+// instead of one each.
+//
+// The mixed stream is an AudioOutputProxy of |dispatcher|, normally an
+// AudioOutputResampler, so fallback, resampling to the hardware parameters and
+// closing of idle physical streams all work as they do for a single stream.
+// The mixed stream plays while any of the mixer's streams is playing.
+//
+// Each stream's AudioSourceCallback is an input of an AudioConverter, which
+// sums them at their own volumes.  The callbacks are called one after another
+// on the audio device thread, so a stream which is slow to provide data delays
+// every stream mixed with it.
+class MEDIA_EXPORT AudioOutputMixer
+    : public AudioOutputDispatcher,
+      public AudioOutputStream::AudioSourceCallback {
+ public:
+  AudioOutputMixer(AudioManager* audio_manager,
+                   const AudioParameters& params,
+                   const std::string& output_device_id,
+                   const scoped_refptr<AudioOutputDispatcher>& dispatcher);
+
+  // AudioOutputDispatcher interface.
+  virtual bool OpenStream() OVERRIDE;
+  virtual bool StartStream(AudioOutputStream::AudioSourceCallback* callback,
+                           AudioOutputProxy* stream_proxy) OVERRIDE;
+  virtual void StopStream(AudioOutputProxy* stream_proxy) OVERRIDE;
+  virtual void StreamVolumeSet(AudioOutputProxy* stream_proxy,
+                               double volume) OVERRIDE;
+  virtual void CloseStream(AudioOutputProxy* stream_proxy) OVERRIDE;
+  virtual void Shutdown() OVERRIDE;
+  virtual void CloseStreamsForWedgeFix() OVERRIDE;
+  virtual void RestartStreamsForWedgeFix() OVERRIDE;
+
+  // AudioSourceCallback interface, called for the mixed stream.
+  virtual int OnMoreData(AudioBus* dest,
+                         AudioBuffersState buffers_state) OVERRIDE;
+  virtual int OnMoreIOData(AudioBus* source,
+                           AudioBus* dest,
+                           AudioBuffersState buffers_state) OVERRIDE;
+  virtual void OnError(AudioOutputStream* stream) OVERRIDE;
+
+ private:
+  friend class base::RefCountedThreadSafe<AudioOutputMixer>;
+  virtual ~AudioOutputMixer();
+
+  // Dispatcher of the mixed stream.
+  scoped_refptr<AudioOutputDispatcher> dispatcher_;
+
+  // The mixed stream, open while any of the mixer's streams is.
+  AudioOutputStream* stream_;
+  int open_streams_;
+
+  // Guards |inputs_| and |converter_|, which are used on the audio device
+  // thread by OnMoreData().
+  base::Lock lock_;
+
+  // The playing streams and their inputs to |converter_|.
+  typedef std::map<AudioOutputProxy*, MixerInput*> InputMap;
+  InputMap inputs_;
+
+  AudioConverter converter_;
+
+  DISALLOW_COPY_AND_ASSIGN(AudioOutputMixer);
+};
+
+}  // namespace media
+
+#endif  // MEDIA_AUDIO_AUDIO_OUTPUT_MIXER_H_
@@ -0,0 +1,208 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+
+#include "base/message_loop/message_loop.h"
+#include "media/audio/audio_output_mixer.h"
+#include "media/audio/audio_output_proxy.h"
+#include "media/audio/mock_audio_manager.h"
+#include "media/base/audio_bus.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace media {
+
+static const int kFrames = 128;
+
+// Records the stream the mixer starts, instead of playing it.
+class FakeAudioOutputDispatcher : public AudioOutputDispatcher {
+ public:
+  FakeAudioOutputDispatcher(AudioManager* audio_manager,
+                            const AudioParameters& params)
+      : AudioOutputDispatcher(audio_manager, params, std::string()),
+        open_streams_(0),
+        callback_(NULL),
+        shutdown_(false) {}
+
+  virtual bool OpenStream() OVERRIDE {
+    ++open_streams_;
+    return true;
+  }
+  virtual bool StartStream(AudioOutputStream::AudioSourceCallback* callback,
+                           AudioOutputProxy* stream_proxy) OVERRIDE {
+    EXPECT_FALSE(callback_);
+    callback_ = callback;
+    return true;
+  }
+  virtual void StopStream(AudioOutputProxy* stream_proxy) OVERRIDE {
+    EXPECT_TRUE(callback_);
+    callback_ = NULL;
+  }
+  virtual void StreamVolumeSet(AudioOutputProxy* stream_proxy,
+                               double volume) OVERRIDE {}
+  virtual void CloseStream(AudioOutputProxy* stream_proxy) OVERRIDE {
+    --open_streams_;
+  }
+  virtual void Shutdown() OVERRIDE { shutdown_ = true; }
+  virtual void CloseStreamsForWedgeFix() OVERRIDE {}
+  virtual void RestartStreamsForWedgeFix() OVERRIDE {}
+
+  int open_streams() const { return open_streams_; }
+  AudioOutputStream::AudioSourceCallback* callback() const {
+    return callback_;
+  }
+  bool shutdown() const { return shutdown_; }
+
+ private:
+  virtual ~FakeAudioOutputDispatcher() {}
+
+  int open_streams_;
+  AudioOutputStream::AudioSourceCallback* callback_;
+  bool shutdown_;
+
+  DISALLOW_COPY_AND_ASSIGN(FakeAudioOutputDispatcher);
+};
+
+// Fills every frame it is asked for with |value|.
+class ConstantSource : public AudioOutputStream::AudioSourceCallback {
+ public:
+  explicit ConstantSource(float value) : value_(value) {}
+
+  virtual int OnMoreData(AudioBus* dest,
+                         AudioBuffersState buffers_state) OVERRIDE {
+    for (int ch = 0; ch < dest->channels(); ++ch)
+      std::fill(dest->channel(ch), dest->channel(ch) + dest->frames(), value_);
+    return dest->frames();
+  }
+  virtual int OnMoreIOData(AudioBus* source,
+                           AudioBus* dest,
+                           AudioBuffersState buffers_state) OVERRIDE {
+    return OnMoreData(dest, buffers_state);
+  }
+  MOCK_METHOD1(OnError, void(AudioOutputStream* stream));
+
+ private:
+  const float value_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConstantSource);
+};
+
+class AudioOutputMixerTest : public testing::Test {
+ public:
+  AudioOutputMixerTest()
+      : audio_manager_(
+            new MockAudioManager(message_loop_.message_loop_proxy())),
+        params_(AudioParameters::AUDIO_PCM_LOW_LATENCY, CHANNEL_LAYOUT_STEREO,
+                48000, 16, kFrames),
+        dispatcher_(new FakeAudioOutputDispatcher(audio_manager_.get(),
+                                                  params_)),
+        mixer_(new AudioOutputMixer(audio_manager_.get(), params_,
+                                    std::string(), dispatcher_)),
+        dest_(AudioBus::Create(params_)) {}
+
+  virtual ~AudioOutputMixerTest() {
+    mixer_->Shutdown();
+    EXPECT_TRUE(dispatcher_->shutdown());
+    mixer_ = NULL;
+    dispatcher_ = NULL;
+  }
+
+ protected:
+  // Pulls a buffer of the mixed stream and returns its first sample.
+  float PullMixedStream() {
+    EXPECT_TRUE(dispatcher_->callback());
+    EXPECT_EQ(kFrames, dispatcher_->callback()->OnMoreData(
+        dest_.get(), AudioBuffersState()));
+    return dest_->channel(0)[0];
+  }
+
+  base::MessageLoop message_loop_;
+  scoped_ptr<AudioManager> audio_manager_;
+  AudioParameters params_;
+  scoped_refptr<FakeAudioOutputDispatcher> dispatcher_;
+  scoped_refptr<AudioOutputMixer> mixer_;
+  scoped_ptr<AudioBus> dest_;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(AudioOutputMixerTest);
+};
+
+// Streams share one stream of the underlying dispatcher, which is open while
+// any of them is.
+TEST_F(AudioOutputMixerTest, OpenAndClose) {
+  AudioOutputProxy* proxy1 = new AudioOutputProxy(mixer_.get());
+  AudioOutputProxy* proxy2 = new AudioOutputProxy(mixer_.get());
+  EXPECT_TRUE(proxy1->Open());
+  EXPECT_TRUE(proxy2->Open());
+  EXPECT_EQ(1, dispatcher_->open_streams());
+
+  proxy1->Close();
+  EXPECT_EQ(1, dispatcher_->open_streams());
+  proxy2->Close();
+  EXPECT_EQ(0, dispatcher_->open_streams());
+}
+
+// The mixed stream plays the sum of the playing streams at their volumes.
+TEST_F(AudioOutputMixerTest, MixesPlayingStreams) {
+  ConstantSource source1(0.25f);
+  ConstantSource source2(0.125f);
+  AudioOutputProxy* proxy1 = new AudioOutputProxy(mixer_.get());
+  AudioOutputProxy* proxy2 = new AudioOutputProxy(mixer_.get());
+  ASSERT_TRUE(proxy1->Open());
+  ASSERT_TRUE(proxy2->Open());
+
+  proxy1->Start(&source1);
+  EXPECT_FLOAT_EQ(0.25f, PullMixedStream());
+  proxy2->Start(&source2);
+  EXPECT_FLOAT_EQ(0.375f, PullMixedStream());
+
+  proxy2->SetVolume(0.5);
+  EXPECT_FLOAT_EQ(0.3125f, PullMixedStream());
+
+  proxy1->Stop();
+  EXPECT_FLOAT_EQ(0.0625f, PullMixedStream());
+
+  // The mixed stream stops with the last stream.
+  proxy2->Stop();
+  EXPECT_FALSE(dispatcher_->callback());
+
+  proxy1->Close();
+  proxy2->Close();
+}
+
+// A volume set before Start() applies once the stream plays.
+TEST_F(AudioOutputMixerTest, VolumeBeforeStart) {
+  ConstantSource source(0.5f);
+  AudioOutputProxy* proxy = new AudioOutputProxy(mixer_.get());
+  ASSERT_TRUE(proxy->Open());
+  proxy->SetVolume(0.5);
+  proxy->Start(&source);
+  EXPECT_FLOAT_EQ(0.25f, PullMixedStream());
+  proxy->Stop();
+  proxy->Close();
+}
+
+// An error on the mixed stream is reported to each playing stream.
+TEST_F(AudioOutputMixerTest, ErrorReachesEveryStream) {
+  ConstantSource source1(0.25f);
+  ConstantSource source2(0.25f);
+  AudioOutputProxy* proxy1 = new AudioOutputProxy(mixer_.get());
+  AudioOutputProxy* proxy2 = new AudioOutputProxy(mixer_.get());
+  ASSERT_TRUE(proxy1->Open());
+  ASSERT_TRUE(proxy2->Open());
+  proxy1->Start(&source1);
+  proxy2->Start(&source2);
+
+  EXPECT_CALL(source1, OnError(proxy1));
+  EXPECT_CALL(source2, OnError(proxy2));
+  dispatcher_->callback()->OnError(NULL);
+
+  proxy1->Stop();
+  proxy2->Stop();
+  proxy1->Close();
+  proxy2->Close();
+}
+
+}  // namespace media
@@ -33,12 +33,21 @@ class ClocklessAudioSinkThread : public base::DelegateSimpleThread::Delegate {
     return playback_time_;
   }
 
+  base::TimeDelta render_cpu_time() const { return render_cpu_time_; }
+
  private:
    // Call Render() repeatedly, keeping track of the rendering time.
    virtual void Run() OVERRIDE {
      base::TimeTicks start;
+     const bool measure_cpu = base::TimeTicks::IsThreadNowSupported();
      while (!stop_event_->IsSignaled()) {
+       base::TimeTicks cpu_start;
+       if (measure_cpu)
+         cpu_start = base::TimeTicks::ThreadNow();
        int frames_received = callback_->Render(audio_bus_.get(), 0);
+       if (measure_cpu && frames_received > 0)
+         render_cpu_time_ += base::TimeTicks::ThreadNow() - cpu_start;
+
        if (frames_received <= 0) {
          // No data received, so let other threads run to provide data.
          base::PlatformThread::YieldCurrentThread();
@@ -57,6 +66,7 @@ class ClocklessAudioSinkThread : public base::DelegateSimpleThread::Delegate {
   scoped_ptr<base::WaitableEvent> stop_event_;
   scoped_ptr<base::DelegateSimpleThread> thread_;
   base::TimeDelta playback_time_;
+  base::TimeDelta render_cpu_time_;
 };
 
 ClocklessAudioSink::ClocklessAudioSink()
@@ -83,6 +93,7 @@ void ClocklessAudioSink::Stop() {
     return;
 
   playback_time_ = thread_->Stop();
+  render_cpu_time_ = thread_->render_cpu_time();
 }
 
 void ClocklessAudioSink::Play() {
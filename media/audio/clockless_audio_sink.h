@@ -36,6 +36,10 @@ class MEDIA_EXPORT ClocklessAudioSink
   // Returns the time taken to consume all the audio.
   base::TimeDelta render_time() { return playback_time_; }
 
+  // Returns the thread CPU time spent in Render() calls that produced audio.
+  // Always zero if base::TimeTicks::IsThreadNowSupported() is false.
+  base::TimeDelta render_cpu_time() { return render_cpu_time_; }
+
  protected:
   virtual ~ClocklessAudioSink();
 
@@ -47,6 +51,9 @@ class MEDIA_EXPORT ClocklessAudioSink
   // Time taken in last set of Render() calls.
   base::TimeDelta playback_time_;
 
+  // CPU time taken in last set of Render() calls.
+  base::TimeDelta render_cpu_time_;
+
   DISALLOW_COPY_AND_ASSIGN(ClocklessAudioSink);
 };
 
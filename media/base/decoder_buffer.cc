@@ -5,19 +5,23 @@
 #include "media/base/decoder_buffer.h"
 
 #include "base/logging.h"
+#include "media/base/decoder_buffer_slab.h"
 #include "media/base/decrypt_config.h"
 
 namespace media {
 
 DecoderBuffer::DecoderBuffer(int size)
     : size_(size),
+      data_(NULL),
       side_data_size_(0) {
-  Initialize();
+  Initialize(NULL);
 }
 
 DecoderBuffer::DecoderBuffer(const uint8* data, int size,
-                             const uint8* side_data, int side_data_size)
+                             const uint8* side_data, int side_data_size,
+                             DecoderBufferSlabAllocator* allocator)
     : size_(size),
+      data_(NULL),
       side_data_size_(side_data_size) {
   if (!data) {
     CHECK_EQ(size_, 0);
@@ -25,19 +29,24 @@ DecoderBuffer::DecoderBuffer(const uint8* data, int size,
     return;
   }
 
-  Initialize();
-  memcpy(data_.get(), data, size_);
+  Initialize(allocator);
+  memcpy(data_, data, size_);
   if (side_data)
     memcpy(side_data_.get(), side_data, side_data_size_);
 }
 
 DecoderBuffer::~DecoderBuffer() {}
 
-void DecoderBuffer::Initialize() {
+void DecoderBuffer::Initialize(DecoderBufferSlabAllocator* allocator) {
   CHECK_GE(size_, 0);
-  data_.reset(reinterpret_cast<uint8*>(
-      base::AlignedAlloc(size_ + kPaddingSize, kAlignmentSize)));
-  memset(data_.get() + size_, 0, kPaddingSize);
+  if (allocator)
+    data_ = allocator->Allocate(size_, &slab_);
+  if (!data_) {
+    owned_data_.reset(reinterpret_cast<uint8*>(
+        base::AlignedAlloc(size_ + kPaddingSize, kAlignmentSize)));
+    data_ = owned_data_.get();
+  }
+  memset(data_ + size_, 0, kPaddingSize);
   if (side_data_size_ > 0) {
     side_data_.reset(reinterpret_cast<uint8*>(
         base::AlignedAlloc(side_data_size_ + kPaddingSize, kAlignmentSize)));
@@ -50,7 +59,7 @@ scoped_refptr<DecoderBuffer> DecoderBuffer::CopyFrom(const uint8* data,
                                                      int data_size) {
   // If you hit this CHECK you likely have a bug in a demuxer. Go fix it.
   CHECK(data);
-  return make_scoped_refptr(new DecoderBuffer(data, data_size, NULL, 0));
+  return make_scoped_refptr(new DecoderBuffer(data, data_size, NULL, 0, NULL));
 }
 
 // static
@@ -62,12 +71,21 @@ scoped_refptr<DecoderBuffer> DecoderBuffer::CopyFrom(const uint8* data,
   CHECK(data);
   CHECK(side_data);
   return make_scoped_refptr(new DecoderBuffer(data, data_size,
-                                              side_data, side_data_size));
+                                              side_data, side_data_size, NULL));
+}
+
+// static
+scoped_refptr<DecoderBuffer> DecoderBuffer::CopyFrom(
+    const uint8* data, int data_size, DecoderBufferSlabAllocator* allocator) {
+  // If you hit this CHECK you likely have a bug in a demuxer. Go fix it.
+  CHECK(data);
+  return make_scoped_refptr(
+      new DecoderBuffer(data, data_size, NULL, 0, allocator));
 }
 
 // static
 scoped_refptr<DecoderBuffer> DecoderBuffer::CreateEOSBuffer() {
-  return make_scoped_refptr(new DecoderBuffer(NULL, 0, NULL, 0));
+  return make_scoped_refptr(new DecoderBuffer(NULL, 0, NULL, 0, NULL));
 }
 
 std::string DecoderBuffer::AsHumanReadableString() {
@@ -18,6 +18,9 @@
 
 namespace media {
 
+class DecoderBufferSlab;
+class DecoderBufferSlabAllocator;
+
 // A specialized buffer for interfacing with audio / video decoders.
 //
 // Specifically ensures that data is aligned and padded as necessary by the
@@ -54,6 +57,12 @@ class MEDIA_EXPORT DecoderBuffer
                                                const uint8* side_data,
                                                int side_data_size);
 
+  // Create a DecoderBuffer whose |data_| is copied from |data| into a slice of
+  // a slab from |allocator|, instead of memory allocated for this buffer.
+  // |data| must not be NULL and |size| >= 0.
+  static scoped_refptr<DecoderBuffer> CopyFrom(
+      const uint8* data, int size, DecoderBufferSlabAllocator* allocator);
+
   // Create a DecoderBuffer indicating we've reached end of stream.
   //
   // Calling any method other than end_of_stream() on the resulting buffer
@@ -82,12 +91,12 @@ class MEDIA_EXPORT DecoderBuffer
 
   const uint8* data() const {
     DCHECK(!end_of_stream());
-    return data_.get();
+    return data_;
   }
 
   uint8* writable_data() const {
     DCHECK(!end_of_stream());
-    return data_.get();
+    return data_;
   }
 
   int data_size() const {
@@ -138,9 +147,11 @@ class MEDIA_EXPORT DecoderBuffer
 
   // Allocates a buffer of size |size| >= 0 and copies |data| into it.  Buffer
   // will be padded and aligned as necessary.  If |data| is NULL then |data_| is
-  // set to NULL and |buffer_size_| to 0.
+  // set to NULL and |buffer_size_| to 0.  If |allocator| is not NULL, |data_|
+  // is a slice of one of its slabs when it has one to spare.
   DecoderBuffer(const uint8* data, int size,
-                const uint8* side_data, int side_data_size);
+                const uint8* side_data, int side_data_size,
+                DecoderBufferSlabAllocator* allocator);
   virtual ~DecoderBuffer();
 
  private:
@@ -148,14 +159,18 @@ class MEDIA_EXPORT DecoderBuffer
   base::TimeDelta duration_;
 
   int size_;
-  scoped_ptr<uint8, base::AlignedFreeDeleter> data_;
+  // Points into |owned_data_|, or into |slab_| when the buffer was created with
+  // a DecoderBufferSlabAllocator.
+  uint8* data_;
+  scoped_ptr<uint8, base::AlignedFreeDeleter> owned_data_;
+  scoped_refptr<DecoderBufferSlab> slab_;
   int side_data_size_;
   scoped_ptr<uint8, base::AlignedFreeDeleter> side_data_;
   scoped_ptr<DecryptConfig> decrypt_config_;
   base::TimeDelta discard_padding_;
 
   // Constructor helper method for memory allocations.
-  void Initialize();
+  void Initialize(DecoderBufferSlabAllocator* allocator);
 
   DISALLOW_COPY_AND_ASSIGN(DecoderBuffer);
 };
@@ -0,0 +1,60 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/decoder_buffer_slab.h"
+
+#include "base/logging.h"
+#include "media/base/decoder_buffer.h"
+
+namespace media {
+
+static int AlignSize(int size) {
+  return (size + DecoderBuffer::kAlignmentSize - 1) &
+      ~(DecoderBuffer::kAlignmentSize - 1);
+}
+
+DecoderBufferSlab::DecoderBufferSlab(int capacity)
+    : capacity_(AlignSize(capacity)),
+      used_(0),
+      data_(reinterpret_cast<uint8*>(
+          base::AlignedAlloc(capacity_, DecoderBuffer::kAlignmentSize))) {
+  CHECK_GT(capacity_, 0);
+}
+
+DecoderBufferSlab::~DecoderBufferSlab() {}
+
+uint8* DecoderBufferSlab::Allocate(int size) {
+  DCHECK_GE(size, 0);
+  const int slice_size = AlignSize(size + DecoderBuffer::kPaddingSize);
+  if (slice_size > capacity_ - used_)
+    return NULL;
+
+  uint8* slice = data_.get() + used_;
+  used_ += slice_size;
+  return slice;
+}
+
+DecoderBufferSlabAllocator::DecoderBufferSlabAllocator(int slab_size)
+    : slab_size_(slab_size) {
+  DCHECK_GT(slab_size_, 0);
+}
+
+DecoderBufferSlabAllocator::~DecoderBufferSlabAllocator() {}
+
+uint8* DecoderBufferSlabAllocator::Allocate(
+    int size, scoped_refptr<DecoderBufferSlab>* slab) {
+  if (size + DecoderBuffer::kPaddingSize > slab_size_ / 4)
+    return NULL;
+
+  uint8* slice = current_slab_ ? current_slab_->Allocate(size) : NULL;
+  if (!slice) {
+    current_slab_ = new DecoderBufferSlab(slab_size_);
+    slice = current_slab_->Allocate(size);
+    DCHECK(slice);
+  }
+  *slab = current_slab_;
+  return slice;
+}
+
+}  // namespace media
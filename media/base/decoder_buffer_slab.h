@@ -0,0 +1,69 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MEDIA_BASE_DECODER_BUFFER_SLAB_H_
+#define MEDIA_BASE_DECODER_BUFFER_SLAB_H_
+
+#include "base/basictypes.h"
+#include "base/memory/aligned_memory.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "media/base/media_export.h"
+
+namespace media {
+
+// A block of memory which is shared by many DecoderBuffers, so that demuxers
+// can create a buffer for each frame they parse without an allocation each.
+// Slices are aligned and padded as DecoderBuffer requires.  The block is freed
+// once the allocator and every buffer using it have released it.
+class MEDIA_EXPORT DecoderBufferSlab
+    : public base::RefCountedThreadSafe<DecoderBufferSlab> {
+ public:
+  explicit DecoderBufferSlab(int capacity);
+
+  // Returns a slice of |size| bytes followed by DecoderBuffer::kPaddingSize
+  // bytes of padding, or NULL if the slab doesn't have room for it.
+  uint8* Allocate(int size);
+
+  int capacity() const { return capacity_; }
+  int used() const { return used_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<DecoderBufferSlab>;
+  ~DecoderBufferSlab();
+
+  const int capacity_;
+  int used_;
+  scoped_ptr<uint8, base::AlignedFreeDeleter> data_;
+
+  DISALLOW_COPY_AND_ASSIGN(DecoderBufferSlab);
+};
+
+// Hands out slices of DecoderBufferSlabs of |slab_size| bytes, starting a new
+// slab whenever the current one is full.  Buffers larger than a quarter of a
+// slab are not worth packing and are left to allocate their own memory, which
+// also bounds the space wasted at the end of each slab.
+//
+// A slab is only freed when all of its buffers are, so an allocator should
+// only be shared by buffers which are freed in roughly the order they were
+// created, e.g. the buffers of one track.  Not thread safe.
+class MEDIA_EXPORT DecoderBufferSlabAllocator {
+ public:
+  explicit DecoderBufferSlabAllocator(int slab_size);
+  ~DecoderBufferSlabAllocator();
+
+  // Returns a slice of |size| bytes plus padding and sets |slab| to the slab
+  // which holds it, or returns NULL if |size| is too large to share a slab.
+  uint8* Allocate(int size, scoped_refptr<DecoderBufferSlab>* slab);
+
+ private:
+  const int slab_size_;
+  scoped_refptr<DecoderBufferSlab> current_slab_;
+
+  DISALLOW_COPY_AND_ASSIGN(DecoderBufferSlabAllocator);
+};
+
+}  // namespace media
+
+#endif  // MEDIA_BASE_DECODER_BUFFER_SLAB_H_
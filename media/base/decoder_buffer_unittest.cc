@@ -4,6 +4,7 @@
 
 #include "base/strings/string_util.h"
 #include "media/base/decoder_buffer.h"
+#include "media/base/decoder_buffer_slab.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace media {
@@ -48,6 +49,59 @@ TEST(DecoderBufferTest, CopyFrom) {
   EXPECT_FALSE(buffer3->end_of_stream());
 }
 
+TEST(DecoderBufferTest, CopyFromSlab) {
+  const uint8 kData[] = "hello";
+  const int kDataSize = arraysize(kData);
+  scoped_refptr<DecoderBuffer> buffer1;
+  scoped_refptr<DecoderBuffer> buffer2;
+  {
+    DecoderBufferSlabAllocator allocator(1024);
+    buffer1 = DecoderBuffer::CopyFrom(kData, kDataSize, &allocator);
+    buffer2 = DecoderBuffer::CopyFrom(kData, kDataSize, &allocator);
+  }
+
+  // The buffers are packed next to each other, aligned and padded, and keep
+  // their slab alive after the allocator is gone.  Each takes 32 bytes: its 6
+  // bytes of data and 16 of padding, rounded up to the alignment.
+  EXPECT_EQ(buffer1->data() + 32, buffer2->data());
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(
+      buffer1->data()) & (DecoderBuffer::kAlignmentSize - 1));
+  EXPECT_FALSE(buffer2->end_of_stream());
+  EXPECT_EQ(kDataSize, buffer2->data_size());
+  EXPECT_EQ(0, memcmp(buffer2->data(), kData, kDataSize));
+  for (int i = 0; i < DecoderBuffer::kPaddingSize; i++)
+    EXPECT_EQ(0, (buffer1->data() + kDataSize)[i]);
+}
+
+TEST(DecoderBufferTest, CopyFromSlab_LargeBuffer) {
+  const int kSlabSize = 1024;
+  DecoderBufferSlabAllocator allocator(kSlabSize);
+  uint8 data[kSlabSize / 2] = { 0 };
+  data[kSlabSize / 4] = 1;
+
+  // Buffers too large to share a slab get memory of their own.
+  scoped_refptr<DecoderBuffer> small_buffer(
+      DecoderBuffer::CopyFrom(data, 1, &allocator));
+  scoped_refptr<DecoderBuffer> large_buffer(
+      DecoderBuffer::CopyFrom(data, arraysize(data), &allocator));
+  EXPECT_EQ(0, memcmp(large_buffer->data(), data, arraysize(data)));
+  EXPECT_FALSE(large_buffer->data() > small_buffer->data() &&
+               large_buffer->data() < small_buffer->data() + kSlabSize);
+}
+
+TEST(DecoderBufferTest, SlabAllocate) {
+  scoped_refptr<DecoderBufferSlab> slab(new DecoderBufferSlab(256));
+  EXPECT_EQ(256, slab->capacity());
+
+  // Each slice is rounded up to the alignment, including its padding.
+  uint8* slice = slab->Allocate(DecoderBuffer::kAlignmentSize);
+  ASSERT_TRUE(slice);
+  EXPECT_EQ(2 * DecoderBuffer::kAlignmentSize, slab->used());
+  EXPECT_FALSE(slab->Allocate(256));
+  const int used = slab->used();
+  EXPECT_EQ(slice + used, slab->Allocate(0));
+}
+
 #if !defined(OS_ANDROID)
 TEST(DecoderBufferTest, PaddingAlignment) {
   const uint8 kData[] = "hello";
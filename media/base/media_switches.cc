@@ -9,6 +9,15 @@ namespace switches {
 // Allow users to specify a custom buffer size for debugging purpose.
 const char kAudioBufferSize[] = "audio-buffer-size";
 
+// Mixes all low latency output streams with the same parameters into one
+// stream per output device in the browser.
+const char kEnableAudioOutputMixer[] = "enable-audio-output-mixer";
+
+// Starts media element audio with a queue a few hardware buffers long and
+// adapts its size to the underflows observed during playback.
+const char kEnableLowLatencyAudioRendering[] =
+    "enable-low-latency-audio-rendering";
+
 // Disables Opus playback in media elements.
 const char kDisableOpusPlayback[] = "disable-opus-playback";
 
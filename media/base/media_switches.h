@@ -14,6 +14,10 @@ namespace switches {
 
 MEDIA_EXPORT extern const char kAudioBufferSize[];
 
+MEDIA_EXPORT extern const char kEnableAudioOutputMixer[];
+
+MEDIA_EXPORT extern const char kEnableLowLatencyAudioRendering[];
+
 MEDIA_EXPORT extern const char kDisableOpusPlayback[];
 
 MEDIA_EXPORT extern const char kDisableVp8AlphaPlayback[];
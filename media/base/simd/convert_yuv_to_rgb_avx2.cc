@@ -0,0 +1,155 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string.h>
+
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+
+#include "media/base/simd/convert_yuv_to_rgb.h"
+#include "media/base/simd/yuv_to_rgb_table.h"
+#include "media/base/yuv_convert.h"
+
+// Built into the media library like the SSE2 intrinsics, rather than with
+// -mavx2, so that only these functions may use AVX2. They are only called
+// when base::CPU reports AVX2.
+#if defined(_MSC_VER)
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace media {
+
+// Converts four pixels. Each index is a row of kCoefficientsRgbY, whose four
+// int16 are summed with saturation, shifted and packed as in
+// ConvertYUVToRGB32Row_C(), so the result is identical.
+AVX2_TARGET static inline __m128i ConvertFourPixels(__m128i y_index,
+                                                    __m128i u_index,
+                                                    __m128i v_index) {
+  const long long* table =
+      reinterpret_cast<const long long*>(kCoefficientsRgbY);
+  __m256i rgb = _mm256_adds_epi16(_mm256_i32gather_epi64(table, u_index, 8),
+                                  _mm256_i32gather_epi64(table, v_index, 8));
+  rgb = _mm256_adds_epi16(rgb, _mm256_i32gather_epi64(table, y_index, 8));
+  rgb = _mm256_srai_epi16(rgb, 6);
+
+  // Packing works within each 128-bit lane, so gather the low halves of the
+  // two lanes: the first two pixels, then the last two.
+  rgb = _mm256_packus_epi16(rgb, rgb);
+  rgb = _mm256_permute4x64_epi64(rgb, 0x08);
+  return _mm256_castsi256_si128(rgb);
+}
+
+AVX2_TARGET void ConvertYUVToRGB32Row_AVX2(const uint8* y_buf,
+                                           const uint8* u_buf,
+                                           const uint8* v_buf,
+                                           uint8* rgb_buf,
+                                           ptrdiff_t width) {
+  const __m128i u_offset = _mm_set1_epi32(256);
+  const __m128i v_offset = _mm_set1_epi32(512);
+  ptrdiff_t x = 0;
+  for (; x + 4 <= width; x += 4) {
+    int y_bytes;
+    memcpy(&y_bytes, y_buf + x, sizeof(y_bytes));
+    __m128i y_index = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(y_bytes));
+
+    // Each chroma sample covers two pixels.
+    __m128i u = _mm_cvtepu8_epi32(
+        _mm_cvtsi32_si128(u_buf[x >> 1] | (u_buf[(x >> 1) + 1] << 8)));
+    __m128i v = _mm_cvtepu8_epi32(
+        _mm_cvtsi32_si128(v_buf[x >> 1] | (v_buf[(x >> 1) + 1] << 8)));
+    __m128i u_index = _mm_add_epi32(_mm_unpacklo_epi32(u, u), u_offset);
+    __m128i v_index = _mm_add_epi32(_mm_unpacklo_epi32(v, v), v_offset);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb_buf + x * 4),
+                     ConvertFourPixels(y_index, u_index, v_index));
+  }
+
+  int remaining = static_cast<int>(width - x);
+  if (!remaining)
+    return;
+  // Convert the last one to three pixels, repeating the first of them in
+  // place of the pixels past the end of the row, which must not be read.
+  int y[4], u[4], v[4];
+  for (int i = 0; i < 4; ++i) {
+    ptrdiff_t pixel = x + (i < remaining ? i : 0);
+    y[i] = y_buf[pixel];
+    u[i] = 256 + u_buf[pixel >> 1];
+    v[i] = 512 + v_buf[pixel >> 1];
+  }
+  __m128i rgb = ConvertFourPixels(_mm_setr_epi32(y[0], y[1], y[2], y[3]),
+                                  _mm_setr_epi32(u[0], u[1], u[2], u[3]),
+                                  _mm_setr_epi32(v[0], v[1], v[2], v[3]));
+  uint8 pixels[16];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels), rgb);
+  memcpy(rgb_buf + x * 4, pixels, remaining * 4);
+}
+
+AVX2_TARGET void ScaleYUVToRGB32Row_AVX2(const uint8* y_buf,
+                                         const uint8* u_buf,
+                                         const uint8* v_buf,
+                                         uint8* rgb_buf,
+                                         ptrdiff_t width,
+                                         ptrdiff_t source_dx) {
+  // 16.16 fixed point, as in ScaleYUVToRGB32Row_C(). Each pair of pixels
+  // takes its chroma from the position of the first of them.
+  int dx = static_cast<int>(source_dx);
+  int source_x = 0;
+  for (ptrdiff_t i = 0; i < width; i += 4) {
+    int remaining = static_cast<int>(std::min<ptrdiff_t>(width - i, 4));
+    int y[4], u[4], v[4];
+    for (int j = 0; j < 4; ++j) {
+      // Repeat the first pixel past the end of the row.
+      int x = source_x + (j < remaining ? j : 0) * dx;
+      int uv_x = source_x + (j < remaining ? j & ~1 : 0) * dx;
+      y[j] = y_buf[x >> 16];
+      u[j] = 256 + u_buf[uv_x >> 17];
+      v[j] = 512 + v_buf[uv_x >> 17];
+    }
+    __m128i rgb = ConvertFourPixels(_mm_setr_epi32(y[0], y[1], y[2], y[3]),
+                                    _mm_setr_epi32(u[0], u[1], u[2], u[3]),
+                                    _mm_setr_epi32(v[0], v[1], v[2], v[3]));
+    if (remaining == 4) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb_buf + i * 4), rgb);
+    } else {
+      uint8 pixels[16];
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels), rgb);
+      memcpy(rgb_buf + i * 4, pixels, remaining * 4);
+    }
+    source_x += 4 * dx;
+  }
+}
+
+void ConvertYUVToRGB32_AVX2(const uint8* yplane,
+                            const uint8* uplane,
+                            const uint8* vplane,
+                            uint8* rgbframe,
+                            int width,
+                            int height,
+                            int ystride,
+                            int uvstride,
+                            int rgbstride,
+                            YUVType yuv_type) {
+  unsigned int y_shift = yuv_type;
+  for (int y = 0; y < height; ++y) {
+    uint8* rgb_row = rgbframe + y * rgbstride;
+    const uint8* y_ptr = yplane + y * ystride;
+    const uint8* u_ptr = uplane + (y >> y_shift) * uvstride;
+    const uint8* v_ptr = vplane + (y >> y_shift) * uvstride;
+
+    ConvertYUVToRGB32Row_AVX2(y_ptr,
+                              u_ptr,
+                              v_ptr,
+                              rgb_row,
+                              width);
+  }
+}
+
+}  // namespace media
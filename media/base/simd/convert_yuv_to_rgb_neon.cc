@@ -0,0 +1,93 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <arm_neon.h>
+
+#include "media/base/simd/convert_yuv_to_rgb.h"
+#include "media/base/simd/yuv_to_rgb_table.h"
+#include "media/base/yuv_convert.h"
+
+namespace media {
+
+// Converts two pixels that share |u| and |v|, summing, shifting and packing
+// the rows of kCoefficientsRgbY as ConvertYUVToRGB32Row_C() does, so the
+// result is identical. NEON has no gather, so the rows are loaded one by one,
+// as the MMX version does.
+static inline uint8x8_t ConvertTwoPixels(int y0, int y1, int u, int v) {
+  int16x4_t uv = vqadd_s16(vld1_s16(kCoefficientsRgbY[256 + u]),
+                           vld1_s16(kCoefficientsRgbY[512 + v]));
+  int16x8_t rgb = vcombine_s16(vqadd_s16(uv, vld1_s16(kCoefficientsRgbY[y0])),
+                               vqadd_s16(uv, vld1_s16(kCoefficientsRgbY[y1])));
+  return vqmovun_s16(vshrq_n_s16(rgb, 6));
+}
+
+void ConvertYUVToRGB32Row_NEON(const uint8* y_buf,
+                               const uint8* u_buf,
+                               const uint8* v_buf,
+                               uint8* rgb_buf,
+                               ptrdiff_t width) {
+  ptrdiff_t x = 0;
+  for (; x + 2 <= width; x += 2) {
+    vst1_u8(rgb_buf + x * 4,
+            ConvertTwoPixels(y_buf[x], y_buf[x + 1],
+                             u_buf[x >> 1], v_buf[x >> 1]));
+  }
+  if (x < width) {
+    uint8x8_t rgb =
+        ConvertTwoPixels(y_buf[x], y_buf[x], u_buf[x >> 1], v_buf[x >> 1]);
+    vst1_lane_u32(reinterpret_cast<uint32*>(rgb_buf + x * 4),
+                  vreinterpret_u32_u8(rgb), 0);
+  }
+}
+
+void ScaleYUVToRGB32Row_NEON(const uint8* y_buf,
+                             const uint8* u_buf,
+                             const uint8* v_buf,
+                             uint8* rgb_buf,
+                             ptrdiff_t width,
+                             ptrdiff_t source_dx) {
+  // 16.16 fixed point, as in ScaleYUVToRGB32Row_C().
+  int dx = static_cast<int>(source_dx);
+  int x = 0;
+  ptrdiff_t i = 0;
+  for (; i + 2 <= width; i += 2) {
+    vst1_u8(rgb_buf + i * 4,
+            ConvertTwoPixels(y_buf[x >> 16], y_buf[(x + dx) >> 16],
+                             u_buf[x >> 17], v_buf[x >> 17]));
+    x += 2 * dx;
+  }
+  if (i < width) {
+    uint8x8_t rgb = ConvertTwoPixels(y_buf[x >> 16], y_buf[x >> 16],
+                                     u_buf[x >> 17], v_buf[x >> 17]);
+    vst1_lane_u32(reinterpret_cast<uint32*>(rgb_buf + i * 4),
+                  vreinterpret_u32_u8(rgb), 0);
+  }
+}
+
+void ConvertYUVToRGB32_NEON(const uint8* yplane,
+                            const uint8* uplane,
+                            const uint8* vplane,
+                            uint8* rgbframe,
+                            int width,
+                            int height,
+                            int ystride,
+                            int uvstride,
+                            int rgbstride,
+                            YUVType yuv_type) {
+  unsigned int y_shift = yuv_type;
+  for (int y = 0; y < height; ++y) {
+    uint8* rgb_row = rgbframe + y * rgbstride;
+    const uint8* y_ptr = yplane + y * ystride;
+    const uint8* u_ptr = uplane + (y >> y_shift) * uvstride;
+    const uint8* v_ptr = vplane + (y >> y_shift) * uvstride;
+
+    ConvertYUVToRGB32Row_NEON(y_ptr,
+                              u_ptr,
+                              v_ptr,
+                              rgb_row,
+                              width);
+  }
+}
+
+}  // namespace media
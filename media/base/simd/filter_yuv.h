@@ -31,6 +31,18 @@ MEDIA_EXPORT void FilterYUVRows_SSE2(uint8* ybuf,
                                      int source_width,
                                      int source_y_fraction);
 
+MEDIA_EXPORT void FilterYUVRows_AVX2(uint8* ybuf,
+                                     const uint8* y0_ptr,
+                                     const uint8* y1_ptr,
+                                     int source_width,
+                                     int source_y_fraction);
+
+MEDIA_EXPORT void FilterYUVRows_NEON(uint8* ybuf,
+                                     const uint8* y0_ptr,
+                                     const uint8* y1_ptr,
+                                     int source_width,
+                                     int source_y_fraction);
+
 }  // namespace media
 
 #endif  // MEDIA_BASE_SIMD_FILTER_YUV_H_
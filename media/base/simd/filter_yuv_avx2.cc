@@ -0,0 +1,65 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+
+#include "media/base/simd/filter_yuv.h"
+
+// See convert_yuv_to_rgb_avx2.cc.
+#if defined(_MSC_VER)
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace media {
+
+AVX2_TARGET void FilterYUVRows_AVX2(uint8* dest,
+                                    const uint8* src0,
+                                    const uint8* src1,
+                                    int width,
+                                    int fraction) {
+  int pixel = 0;
+
+  __m256i zero = _mm256_setzero_si256();
+  __m256i src1_fraction = _mm256_set1_epi16(fraction);
+  __m256i src0_fraction = _mm256_set1_epi16(256 - fraction);
+
+  // Unaligned loads and stores are as fast as aligned ones on AVX2 hardware,
+  // so there is no need to align |dest| first.
+  for (; pixel + 32 <= width; pixel += 32) {
+    __m256i src0_256 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src0 + pixel));
+    __m256i src1_256 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src1 + pixel));
+    // The unpacks and the pack work within each 128-bit lane, so the bytes
+    // end up back in order.
+    __m256i src2 = _mm256_unpackhi_epi8(src0_256, zero);
+    __m256i src3 = _mm256_unpackhi_epi8(src1_256, zero);
+    src0_256 = _mm256_unpacklo_epi8(src0_256, zero);
+    src1_256 = _mm256_unpacklo_epi8(src1_256, zero);
+    src0_256 = _mm256_mullo_epi16(src0_256, src0_fraction);
+    src1_256 = _mm256_mullo_epi16(src1_256, src1_fraction);
+    src2 = _mm256_mullo_epi16(src2, src0_fraction);
+    src3 = _mm256_mullo_epi16(src3, src1_fraction);
+    src0_256 = _mm256_add_epi16(src0_256, src1_256);
+    src2 = _mm256_add_epi16(src2, src3);
+    src0_256 = _mm256_srli_epi16(src0_256, 8);
+    src2 = _mm256_srli_epi16(src2, 8);
+    src0_256 = _mm256_packus_epi16(src0_256, src2);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + pixel), src0_256);
+  }
+
+  while (pixel < width) {
+    dest[pixel] = (src0[pixel] * (256 - fraction) +
+                   src1[pixel] * fraction) >> 8;
+    ++pixel;
+  }
+}
+
+}  // namespace media
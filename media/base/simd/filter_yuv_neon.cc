@@ -0,0 +1,46 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <arm_neon.h>
+#include <string.h>
+
+#include "media/base/simd/filter_yuv.h"
+
+namespace media {
+
+void FilterYUVRows_NEON(uint8* dest,
+                        const uint8* src0,
+                        const uint8* src1,
+                        int width,
+                        int fraction) {
+  // A |fraction| of 0 leaves |src0| a weight of 256, which does not fit in a
+  // byte, and the result is |src0| anyway.
+  if (!fraction) {
+    memcpy(dest, src0, width);
+    return;
+  }
+
+  int pixel = 0;
+  uint8x8_t src1_fraction = vdup_n_u8(fraction);
+  uint8x8_t src0_fraction = vdup_n_u8(256 - fraction);
+
+  for (; pixel + 16 <= width; pixel += 16) {
+    uint8x16_t src0_16 = vld1q_u8(src0 + pixel);
+    uint8x16_t src1_16 = vld1q_u8(src1 + pixel);
+    uint16x8_t lo = vmull_u8(vget_low_u8(src0_16), src0_fraction);
+    uint16x8_t hi = vmull_u8(vget_high_u8(src0_16), src0_fraction);
+    lo = vmlal_u8(lo, vget_low_u8(src1_16), src1_fraction);
+    hi = vmlal_u8(hi, vget_high_u8(src1_16), src1_fraction);
+    vst1q_u8(dest + pixel, vcombine_u8(vshrn_n_u16(lo, 8),
+                                       vshrn_n_u16(hi, 8)));
+  }
+
+  while (pixel < width) {
+    dest[pixel] = (src0[pixel] * (256 - fraction) +
+                   src1[pixel] * fraction) >> 8;
+    ++pixel;
+  }
+}
+
+}  // namespace media
@@ -0,0 +1,70 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/sinc_resampler.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+
+// Only these functions may use AVX and FMA; they are only called when
+// base::CPU reports them.
+#if defined(_MSC_VER)
+#define AVX_TARGET
+#define FMA_TARGET
+#else
+#define AVX_TARGET __attribute__((target("avx")))
+#define FMA_TARGET __attribute__((target("avx,fma")))
+#endif
+
+namespace media {
+
+// Linearly interpolates the two "convolutions" and sums the components.
+AVX_TARGET static inline float InterpolateAndSum(
+    __m256 m_sums1, __m256 m_sums2, double kernel_interpolation_factor) {
+  m_sums1 = _mm256_mul_ps(
+      m_sums1, _mm256_set1_ps(1.0 - kernel_interpolation_factor));
+  m_sums2 = _mm256_mul_ps(m_sums2, _mm256_set1_ps(kernel_interpolation_factor));
+  m_sums1 = _mm256_add_ps(m_sums1, m_sums2);
+
+  __m128 m_sums = _mm_add_ps(_mm256_castps256_ps128(m_sums1),
+                             _mm256_extractf128_ps(m_sums1, 1));
+  m_sums = _mm_add_ps(_mm_movehl_ps(m_sums, m_sums), m_sums);
+  return _mm_cvtss_f32(
+      _mm_add_ss(m_sums, _mm_shuffle_ps(m_sums, m_sums, 1)));
+}
+
+// |k1| and |k2| are 32-byte aligned, but |input_ptr| may not be even 16-byte
+// aligned; unaligned loads cost nothing extra on aligned data with AVX.
+AVX_TARGET float SincResampler::Convolve_AVX(
+    const float* input_ptr, const float* k1, const float* k2,
+    double kernel_interpolation_factor) {
+  __m256 m_sums1 = _mm256_setzero_ps();
+  __m256 m_sums2 = _mm256_setzero_ps();
+  for (int i = 0; i < kKernelSize; i += 8) {
+    __m256 m_input = _mm256_loadu_ps(input_ptr + i);
+    m_sums1 = _mm256_add_ps(
+        m_sums1, _mm256_mul_ps(m_input, _mm256_load_ps(k1 + i)));
+    m_sums2 = _mm256_add_ps(
+        m_sums2, _mm256_mul_ps(m_input, _mm256_load_ps(k2 + i)));
+  }
+  return InterpolateAndSum(m_sums1, m_sums2, kernel_interpolation_factor);
+}
+
+FMA_TARGET float SincResampler::Convolve_FMA(
+    const float* input_ptr, const float* k1, const float* k2,
+    double kernel_interpolation_factor) {
+  __m256 m_sums1 = _mm256_setzero_ps();
+  __m256 m_sums2 = _mm256_setzero_ps();
+  for (int i = 0; i < kKernelSize; i += 8) {
+    __m256 m_input = _mm256_loadu_ps(input_ptr + i);
+    m_sums1 = _mm256_fmadd_ps(m_input, _mm256_load_ps(k1 + i), m_sums1);
+    m_sums2 = _mm256_fmadd_ps(m_input, _mm256_load_ps(k2 + i), m_sums2);
+  }
+  return InterpolateAndSum(m_sums1, m_sums2, kernel_interpolation_factor);
+}
+
+}  // namespace media
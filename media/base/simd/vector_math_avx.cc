@@ -0,0 +1,76 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "media/base/vector_math_testing.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>  // NOLINT
+#endif
+
+// Only these functions may use AVX and FMA; they are only called when
+// base::CPU reports them.
+#if defined(_MSC_VER)
+#define AVX_TARGET
+#define FMA_TARGET
+#else
+#define AVX_TARGET __attribute__((target("avx")))
+#define FMA_TARGET __attribute__((target("avx,fma")))
+#endif
+
+namespace media {
+namespace vector_math {
+
+// |src| and |dest| are only guaranteed kRequiredAlignment, so unaligned loads
+// and stores are used; they cost nothing extra on 32-byte aligned data.
+
+AVX_TARGET void FMUL_AVX(const float src[], float scale, int len,
+                         float dest[]) {
+  const int rem = len % 8;
+  const int last_index = len - rem;
+  __m256 m_scale = _mm256_set1_ps(scale);
+  for (int i = 0; i < last_index; i += 8) {
+    _mm256_storeu_ps(dest + i,
+                     _mm256_mul_ps(_mm256_loadu_ps(src + i), m_scale));
+  }
+
+  // Handle any remaining values that wouldn't fit in an AVX pass.
+  for (int i = last_index; i < len; ++i)
+    dest[i] = src[i] * scale;
+}
+
+AVX_TARGET void FMAC_AVX(const float src[], float scale, int len,
+                         float dest[]) {
+  const int rem = len % 8;
+  const int last_index = len - rem;
+  __m256 m_scale = _mm256_set1_ps(scale);
+  for (int i = 0; i < last_index; i += 8) {
+    _mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i),
+                     _mm256_mul_ps(_mm256_loadu_ps(src + i), m_scale)));
+  }
+
+  // Handle any remaining values that wouldn't fit in an AVX pass.
+  for (int i = last_index; i < len; ++i)
+    dest[i] += src[i] * scale;
+}
+
+FMA_TARGET void FMAC_FMA(const float src[], float scale, int len,
+                         float dest[]) {
+  const int rem = len % 8;
+  const int last_index = len - rem;
+  __m256 m_scale = _mm256_set1_ps(scale);
+  for (int i = 0; i < last_index; i += 8) {
+    _mm256_storeu_ps(dest + i, _mm256_fmadd_ps(_mm256_loadu_ps(src + i),
+                                               m_scale,
+                                               _mm256_loadu_ps(dest + i)));
+  }
+
+  // Handle any remaining values that wouldn't fit in an AVX pass.
+  for (int i = last_index; i < len; ++i)
+    dest[i] += src[i] * scale;
+}
+
+}  // namespace vector_math
+}  // namespace media
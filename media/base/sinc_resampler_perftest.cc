@@ -69,6 +69,22 @@ TEST(SincResamplerPerfTest, Convolve) {
   RunConvolveBenchmark(
       &resampler, SincResampler::CONVOLVE_FUNC, false, "optimized_unaligned");
 #endif
+
+#if defined(ARCH_CPU_X86_FAMILY)
+  base::CPU cpu;
+  if (cpu.has_avx()) {
+    RunConvolveBenchmark(
+        &resampler, SincResampler::Convolve_AVX, true, "avx_aligned");
+    RunConvolveBenchmark(
+        &resampler, SincResampler::Convolve_AVX, false, "avx_unaligned");
+  }
+  if (cpu.has_fma3()) {
+    RunConvolveBenchmark(
+        &resampler, SincResampler::Convolve_FMA, true, "fma_aligned");
+    RunConvolveBenchmark(
+        &resampler, SincResampler::Convolve_FMA, false, "fma_unaligned");
+  }
+#endif
 }
 
 #undef CONVOLVE_FUNC
@@ -153,6 +153,32 @@ TEST(SincResamplerTest, Convolve) {
       resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
       resampler.kernel_storage_.get(), kKernelInterpolationFactor);
   EXPECT_NEAR(result2, result, kEpsilon);
+
+#if defined(ARCH_CPU_X86_FAMILY)
+  // The AVX and FMA versions need 32-byte aligned kernels, which
+  // |kernel_storage_| is; the input may be unaligned.
+  base::CPU cpu;
+  for (int offset = 0; offset < 2; ++offset) {
+    result = resampler.Convolve_C(
+        resampler.kernel_storage_.get() + offset,
+        resampler.kernel_storage_.get(),
+        resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    if (cpu.has_avx()) {
+      result2 = resampler.Convolve_AVX(
+          resampler.kernel_storage_.get() + offset,
+          resampler.kernel_storage_.get(),
+          resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+      EXPECT_NEAR(result2, result, kEpsilon);
+    }
+    if (cpu.has_fma3()) {
+      result2 = resampler.Convolve_FMA(
+          resampler.kernel_storage_.get() + offset,
+          resampler.kernel_storage_.get(),
+          resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+      EXPECT_NEAR(result2, result, kEpsilon);
+    }
+  }
+#endif
 }
 #endif
 
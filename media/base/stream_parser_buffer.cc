@@ -20,7 +20,8 @@ static bool HasNestedFadeOutPreroll(
 
 scoped_refptr<StreamParserBuffer> StreamParserBuffer::CreateEOSBuffer() {
   return make_scoped_refptr(new StreamParserBuffer(NULL, 0, NULL, 0, false,
-                                                   DemuxerStream::UNKNOWN, 0));
+                                                   DemuxerStream::UNKNOWN, 0,
+                                                   NULL));
 }
 
 scoped_refptr<StreamParserBuffer> StreamParserBuffer::CopyFrom(
@@ -28,7 +29,7 @@ scoped_refptr<StreamParserBuffer> StreamParserBuffer::CopyFrom(
     TrackId track_id) {
   return make_scoped_refptr(
       new StreamParserBuffer(data, data_size, NULL, 0, is_keyframe, type,
-                             track_id));
+                             track_id, NULL));
 }
 
 scoped_refptr<StreamParserBuffer> StreamParserBuffer::CopyFrom(
@@ -37,7 +38,17 @@ scoped_refptr<StreamParserBuffer> StreamParserBuffer::CopyFrom(
     bool is_keyframe, Type type, TrackId track_id) {
   return make_scoped_refptr(
       new StreamParserBuffer(data, data_size, side_data, side_data_size,
-                             is_keyframe, type, track_id));
+                             is_keyframe, type, track_id, NULL));
+}
+
+scoped_refptr<StreamParserBuffer> StreamParserBuffer::CopyFrom(
+    const uint8* data, int data_size,
+    const uint8* side_data, int side_data_size,
+    bool is_keyframe, Type type, TrackId track_id,
+    DecoderBufferSlabAllocator* allocator) {
+  return make_scoped_refptr(
+      new StreamParserBuffer(data, data_size, side_data, side_data_size,
+                             is_keyframe, type, track_id, allocator));
 }
 
 base::TimeDelta StreamParserBuffer::GetDecodeTimestamp() const {
@@ -53,8 +64,9 @@ void StreamParserBuffer::SetDecodeTimestamp(const base::TimeDelta& timestamp) {
 StreamParserBuffer::StreamParserBuffer(const uint8* data, int data_size,
                                        const uint8* side_data,
                                        int side_data_size, bool is_keyframe,
-                                       Type type, TrackId track_id)
-    : DecoderBuffer(data, data_size, side_data, side_data_size),
+                                       Type type, TrackId track_id,
+                                       DecoderBufferSlabAllocator* allocator)
+    : DecoderBuffer(data, data_size, side_data, side_data_size, allocator),
       is_keyframe_(is_keyframe),
       decode_timestamp_(kNoTimestamp()),
       config_id_(kInvalidConfigId),
@@ -28,6 +28,11 @@ class MEDIA_EXPORT StreamParserBuffer : public DecoderBuffer {
       const uint8* data, int data_size,
       const uint8* side_data, int side_data_size, bool is_keyframe, Type type,
       TrackId track_id);
+  // As above, but copies |data| into a slice of a slab from |allocator|.
+  static scoped_refptr<StreamParserBuffer> CopyFrom(
+      const uint8* data, int data_size,
+      const uint8* side_data, int side_data_size, bool is_keyframe, Type type,
+      TrackId track_id, DecoderBufferSlabAllocator* allocator);
   bool IsKeyframe() const { return is_keyframe_; }
 
   // Decode timestamp. If not explicitly set, or set to kNoTimestamp(), the
@@ -58,7 +63,7 @@ class MEDIA_EXPORT StreamParserBuffer : public DecoderBuffer {
   StreamParserBuffer(const uint8* data, int data_size,
                      const uint8* side_data, int side_data_size,
                      bool is_keyframe, Type type,
-                     TrackId track_id);
+                     TrackId track_id, DecoderBufferSlabAllocator* allocator);
   virtual ~StreamParserBuffer();
 
   bool is_keyframe_;
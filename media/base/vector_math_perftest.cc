@@ -107,6 +107,21 @@ TEST_F(VectorMathPerfTest, FMAC) {
   RunBenchmark(
       vector_math::FMAC_FUNC, true, "vector_math_fmac", "optimized_aligned");
 #endif
+
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (base::CPU().has_avx()) {
+    RunBenchmark(vector_math::FMAC_AVX, false, "vector_math_fmac",
+                 "avx_unaligned");
+    RunBenchmark(vector_math::FMAC_AVX, true, "vector_math_fmac",
+                 "avx_aligned");
+  }
+  if (base::CPU().has_fma3()) {
+    RunBenchmark(vector_math::FMAC_FMA, false, "vector_math_fmac",
+                 "fma_unaligned");
+    RunBenchmark(vector_math::FMAC_FMA, true, "vector_math_fmac",
+                 "fma_aligned");
+  }
+#endif
 }
 
 #undef FMAC_FUNC
@@ -138,6 +153,15 @@ TEST_F(VectorMathPerfTest, FMUL) {
   RunBenchmark(
       vector_math::FMUL_FUNC, true, "vector_math_fmul", "optimized_aligned");
 #endif
+
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (base::CPU().has_avx()) {
+    RunBenchmark(vector_math::FMUL_AVX, false, "vector_math_fmul",
+                 "avx_unaligned");
+    RunBenchmark(vector_math::FMUL_AVX, true, "vector_math_fmul",
+                 "avx_aligned");
+  }
+#endif
 }
 
 #undef FMUL_FUNC
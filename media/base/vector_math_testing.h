@@ -26,6 +26,12 @@ MEDIA_EXPORT void FMUL_SSE(const float src[], float scale, int len,
                            float dest[]);
 MEDIA_EXPORT std::pair<float, float> EWMAAndMaxPower_SSE(
     float initial_value, const float src[], int len, float smoothing_factor);
+MEDIA_EXPORT void FMAC_AVX(const float src[], float scale, int len,
+                           float dest[]);
+MEDIA_EXPORT void FMAC_FMA(const float src[], float scale, int len,
+                           float dest[]);
+MEDIA_EXPORT void FMUL_AVX(const float src[], float scale, int len,
+                           float dest[]);
 #endif
 
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
@@ -83,6 +83,22 @@ TEST_F(VectorMathTest, FMAC) {
         input_vector_.get(), kScale, kVectorSize, output_vector_.get());
     VerifyOutput(kResult);
   }
+
+  if (base::CPU().has_avx()) {
+    SCOPED_TRACE("FMAC_AVX");
+    FillTestVectors(kInputFillValue, kOutputFillValue);
+    vector_math::FMAC_AVX(
+        input_vector_.get(), kScale, kVectorSize, output_vector_.get());
+    VerifyOutput(kResult);
+  }
+
+  if (base::CPU().has_fma3()) {
+    SCOPED_TRACE("FMAC_FMA");
+    FillTestVectors(kInputFillValue, kOutputFillValue);
+    vector_math::FMAC_FMA(
+        input_vector_.get(), kScale, kVectorSize, output_vector_.get());
+    VerifyOutput(kResult);
+  }
 #endif
 
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
@@ -125,6 +141,14 @@ TEST_F(VectorMathTest, FMUL) {
         input_vector_.get(), kScale, kVectorSize, output_vector_.get());
     VerifyOutput(kResult);
   }
+
+  if (base::CPU().has_avx()) {
+    SCOPED_TRACE("FMUL_AVX");
+    FillTestVectors(kInputFillValue, kOutputFillValue);
+    vector_math::FMUL_AVX(
+        input_vector_.get(), kScale, kVectorSize, output_vector_.get());
+    VerifyOutput(kResult);
+  }
 #endif
 
 #if defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
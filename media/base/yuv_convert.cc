@@ -179,6 +179,19 @@ void InitializeCPUSpecificYUVConversions() {
     // TODO(hclam): Add ConvertRGB32ToYUV_SSSE3 when the cyan problem is solved.
     // See: crbug.com/100462
   }
+
+  if (cpu.has_avx2()) {
+    g_filter_yuv_rows_proc_ = FilterYUVRows_AVX2;
+    g_convert_yuv_to_rgb32_row_proc_ = ConvertYUVToRGB32Row_AVX2;
+    g_scale_yuv_to_rgb32_row_proc_ = ScaleYUVToRGB32Row_AVX2;
+    g_convert_yuv_to_rgb32_proc_ = ConvertYUVToRGB32_AVX2;
+  }
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+  // NEON is known at build time on ARM; base::CPU cannot detect it.
+  g_filter_yuv_rows_proc_ = FilterYUVRows_NEON;
+  g_convert_yuv_to_rgb32_row_proc_ = ConvertYUVToRGB32Row_NEON;
+  g_scale_yuv_to_rgb32_row_proc_ = ScaleYUVToRGB32Row_NEON;
+  g_convert_yuv_to_rgb32_proc_ = ConvertYUVToRGB32_NEON;
 #endif
 }
 
@@ -0,0 +1,137 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/cpu.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
+#include "media/base/simd/convert_yuv_to_rgb.h"
+#include "media/base/simd/filter_yuv.h"
+#include "media/base/yuv_convert.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+using base::TimeTicks;
+
+namespace media {
+
+static const int kBenchmarkIterations = 10000;
+static const int kSourceWidth = 1920;
+static const int kSourceDx = 80000;  // This value means a scale down.
+static const int kFilterFraction = 100;
+
+typedef void (*ConvertRowProc)(const uint8*, const uint8*, const uint8*,
+                               uint8*, ptrdiff_t);
+typedef void (*ScaleRowProc)(const uint8*, const uint8*, const uint8*,
+                             uint8*, ptrdiff_t, ptrdiff_t);
+typedef void (*FilterRowsProc)(uint8*, const uint8*, const uint8*, int, int);
+
+class YUVConvertPerfTest : public testing::Test {
+ public:
+  YUVConvertPerfTest()
+      : y_row_(new uint8[kSourceWidth]),
+        u_row_(new uint8[kSourceWidth / 2]),
+        v_row_(new uint8[kSourceWidth / 2]),
+        rgb_row_(new uint8[kSourceWidth * 4]) {
+    for (int i = 0; i < kSourceWidth; ++i)
+      y_row_[i] = i * 7;
+    for (int i = 0; i < kSourceWidth / 2; ++i) {
+      u_row_[i] = i * 3;
+      v_row_[i] = i * 5;
+    }
+  }
+
+  void RunConvertBenchmark(ConvertRowProc fn, const std::string& trace_name) {
+    TimeTicks start = TimeTicks::HighResNow();
+    for (int i = 0; i < kBenchmarkIterations; ++i) {
+      fn(y_row_.get(), u_row_.get(), v_row_.get(), rgb_row_.get(),
+         kSourceWidth);
+    }
+    EmptyRegisterState();
+    PrintResult("yuv_convert_row", trace_name, start);
+  }
+
+  void RunScaleBenchmark(ScaleRowProc fn, const std::string& trace_name) {
+    // Scale down so that the source row is not read past its end.
+    const int width = kSourceWidth * 65536 / kSourceDx;
+    TimeTicks start = TimeTicks::HighResNow();
+    for (int i = 0; i < kBenchmarkIterations; ++i) {
+      fn(y_row_.get(), u_row_.get(), v_row_.get(), rgb_row_.get(), width,
+         kSourceDx);
+    }
+    EmptyRegisterState();
+    PrintResult("yuv_scale_row", trace_name, start);
+  }
+
+  void RunFilterBenchmark(FilterRowsProc fn, const std::string& trace_name) {
+    TimeTicks start = TimeTicks::HighResNow();
+    for (int i = 0; i < kBenchmarkIterations; ++i) {
+      fn(rgb_row_.get(), y_row_.get(), rgb_row_.get() + kSourceWidth,
+         kSourceWidth, kFilterFraction);
+    }
+    EmptyRegisterState();
+    PrintResult("yuv_filter_rows", trace_name, start);
+  }
+
+ private:
+  void PrintResult(const std::string& test_name,
+                   const std::string& trace_name,
+                   TimeTicks start) {
+    double total_time_milliseconds =
+        (TimeTicks::HighResNow() - start).InMillisecondsF();
+    perf_test::PrintResult(test_name,
+                           "",
+                           trace_name,
+                           kBenchmarkIterations / total_time_milliseconds,
+                           "runs/ms",
+                           true);
+  }
+
+  scoped_ptr<uint8[]> y_row_;
+  scoped_ptr<uint8[]> u_row_;
+  scoped_ptr<uint8[]> v_row_;
+  scoped_ptr<uint8[]> rgb_row_;
+
+  DISALLOW_COPY_AND_ASSIGN(YUVConvertPerfTest);
+};
+
+TEST_F(YUVConvertPerfTest, ConvertYUVToRGB32Row) {
+  RunConvertBenchmark(ConvertYUVToRGB32Row_C, "c");
+#if defined(ARCH_CPU_X86_FAMILY)
+  base::CPU cpu;
+  ASSERT_TRUE(cpu.has_sse());
+  RunConvertBenchmark(ConvertYUVToRGB32Row_SSE, "sse");
+  if (cpu.has_avx2())
+    RunConvertBenchmark(ConvertYUVToRGB32Row_AVX2, "avx2");
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+  RunConvertBenchmark(ConvertYUVToRGB32Row_NEON, "neon");
+#endif
+}
+
+TEST_F(YUVConvertPerfTest, ScaleYUVToRGB32Row) {
+  RunScaleBenchmark(ScaleYUVToRGB32Row_C, "c");
+#if defined(ARCH_CPU_X86_FAMILY)
+  base::CPU cpu;
+  ASSERT_TRUE(cpu.has_sse());
+  RunScaleBenchmark(ScaleYUVToRGB32Row_SSE, "sse");
+  if (cpu.has_avx2())
+    RunScaleBenchmark(ScaleYUVToRGB32Row_AVX2, "avx2");
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+  RunScaleBenchmark(ScaleYUVToRGB32Row_NEON, "neon");
+#endif
+}
+
+TEST_F(YUVConvertPerfTest, FilterYUVRows) {
+  RunFilterBenchmark(FilterYUVRows_C, "c");
+#if defined(ARCH_CPU_X86_FAMILY)
+  base::CPU cpu;
+  ASSERT_TRUE(cpu.has_sse2());
+  RunFilterBenchmark(FilterYUVRows_SSE2, "sse2");
+  if (cpu.has_avx2())
+    RunFilterBenchmark(FilterYUVRows_AVX2, "avx2");
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(USE_NEON)
+  RunFilterBenchmark(FilterYUVRows_NEON, "neon");
+#endif
+}
+
+}  // namespace media
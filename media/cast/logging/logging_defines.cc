@@ -56,6 +56,8 @@ std::string CastLoggingToString(CastLoggingEvent event) {
     ENUM_TO_STRING(VideoFrameReceived);
     ENUM_TO_STRING(VideoFrameSentToEncoder);
     ENUM_TO_STRING(VideoFrameEncoded);
+    ENUM_TO_STRING(VideoEncodeLatencyMs);
+    ENUM_TO_STRING(VideoEncodeCpuUs);
     ENUM_TO_STRING(VideoFrameDecoded);
     ENUM_TO_STRING(VideoRenderDelay);
     ENUM_TO_STRING(PacketSentToPacer);
@@ -100,6 +102,8 @@ EventMediaType GetEventMediaType(CastLoggingEvent event) {
     case kVideoFrameReceived:
     case kVideoFrameSentToEncoder:
     case kVideoFrameEncoded:
+    case kVideoEncodeLatencyMs:
+    case kVideoEncodeCpuUs:
     case kVideoFrameDecoded:
     case kVideoRenderDelay:
     case kVideoPacketReceived:
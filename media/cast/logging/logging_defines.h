@@ -59,6 +59,8 @@ enum CastLoggingEvent {
   kVideoFrameReceived,
   kVideoFrameSentToEncoder,
   kVideoFrameEncoded,
+  kVideoEncodeLatencyMs,
+  kVideoEncodeCpuUs,
   // Video receiver.
   kVideoFrameDecoded,
   kVideoRenderDelay,
@@ -127,6 +129,10 @@ struct GenericEvent {
   //  kRembBitrate - Receiver Estimated Maximum Bitrate
   //  kAudioAckSent - Frame ID
   //  kVideoAckSent - Frame ID
+  //  kVideoEncodeLatencyMs - Time from sending a frame to the encoder until
+  //      it was encoded, in milliseconds
+  //  kVideoEncodeCpuUs - CPU time the encoder thread spent on a frame, in
+  //      microseconds
   int value;
 
   // Time of event logged.
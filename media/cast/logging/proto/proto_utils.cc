@@ -32,6 +32,8 @@ media::cast::proto::EventType ToProtoEventType(CastLoggingEvent event) {
     TO_PROTO_ENUM(kVideoFrameReceived, VIEDO_FRAME_RECEIVED);
     TO_PROTO_ENUM(kVideoFrameSentToEncoder, VIDEO_FRAME_SENT_TO_ENCODER);
     TO_PROTO_ENUM(kVideoFrameEncoded, VIDEO_FRAME_ENCODED);
+    TO_PROTO_ENUM(kVideoEncodeLatencyMs, VIDEO_ENCODE_LATENCY_MS);
+    TO_PROTO_ENUM(kVideoEncodeCpuUs, VIDEO_ENCODE_CPU_US);
     TO_PROTO_ENUM(kVideoFrameDecoded, VIDEO_FRAME_DECODED);
     TO_PROTO_ENUM(kVideoRenderDelay, VIDEO_RENDER_DELAY);
     TO_PROTO_ENUM(kPacketSentToPacer, PACKET_SENT_TO_PACER);
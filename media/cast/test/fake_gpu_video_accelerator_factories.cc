@@ -13,15 +13,16 @@ namespace test {
 
 FakeGpuVideoAcceleratorFactories::FakeGpuVideoAcceleratorFactories(
     const scoped_refptr<base::SingleThreadTaskRunner>& fake_task_runner)
-    : fake_task_runner_(fake_task_runner) {}
+    : fake_task_runner_(fake_task_runner),
+      last_video_encode_accelerator_(NULL) {}
 
 FakeGpuVideoAcceleratorFactories::~FakeGpuVideoAcceleratorFactories() {}
 
 scoped_ptr<VideoEncodeAccelerator>
 FakeGpuVideoAcceleratorFactories::CreateVideoEncodeAccelerator(
     VideoEncodeAccelerator::Client* client) {
-  return scoped_ptr<VideoEncodeAccelerator>(
-      new FakeVideoEncodeAccelerator(client));
+  last_video_encode_accelerator_ = new FakeVideoEncodeAccelerator(client);
+  return scoped_ptr<VideoEncodeAccelerator>(last_video_encode_accelerator_);
 }
 
 base::SharedMemory* FakeGpuVideoAcceleratorFactories::CreateSharedMemory(
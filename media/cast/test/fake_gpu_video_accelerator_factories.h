@@ -14,6 +14,8 @@ namespace media {
 namespace cast {
 namespace test {
 
+class FakeVideoEncodeAccelerator;
+
 class FakeGpuVideoAcceleratorFactories : public GpuVideoAcceleratorFactories {
  public:
   explicit FakeGpuVideoAcceleratorFactories(
@@ -26,6 +28,11 @@ class FakeGpuVideoAcceleratorFactories : public GpuVideoAcceleratorFactories {
 
   virtual scoped_refptr<base::SingleThreadTaskRunner>
       GetTaskRunner() OVERRIDE;
+
+  // The encoder last created, valid until it is destroyed.
+  FakeVideoEncodeAccelerator* last_video_encode_accelerator() const {
+    return last_video_encode_accelerator_;
+  }
   //
   //  The following functions are no-op.
   //
@@ -52,6 +59,7 @@ class FakeGpuVideoAcceleratorFactories : public GpuVideoAcceleratorFactories {
   virtual ~FakeGpuVideoAcceleratorFactories();
 
   const scoped_refptr<base::SingleThreadTaskRunner> fake_task_runner_;
+  FakeVideoEncodeAccelerator* last_video_encode_accelerator_;
 
   DISALLOW_COPY_AND_ASSIGN(FakeGpuVideoAcceleratorFactories);
 };
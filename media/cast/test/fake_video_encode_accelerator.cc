@@ -15,7 +15,11 @@ static const size_t kMinimumOutputBufferSize = 123456;
 
 FakeVideoEncodeAccelerator::FakeVideoEncodeAccelerator(
     VideoEncodeAccelerator::Client* client)
-    : client_(client), first_(true) {
+    : client_(client),
+      first_(true),
+      last_requested_bitrate_(0),
+      last_requested_framerate_(0),
+      last_frame_data_(NULL) {
   DCHECK(client);
 }
 
@@ -42,6 +46,7 @@ void FakeVideoEncodeAccelerator::Encode(const scoped_refptr<VideoFrame>& frame,
                                         bool force_keyframe) {
   DCHECK(client_);
   DCHECK(!available_buffer_ids_.empty());
+  last_frame_data_ = frame->data(VideoFrame::kYPlane);
 
   // Fake that we have encoded the frame; resulting in using the full output
   // buffer.
@@ -64,7 +69,8 @@ void FakeVideoEncodeAccelerator::UseOutputBitstreamBuffer(
 void FakeVideoEncodeAccelerator::RequestEncodingParametersChange(
     uint32 bitrate,
     uint32 framerate) {
-  // No-op.
+  last_requested_bitrate_ = bitrate;
+  last_requested_framerate_ = framerate;
 }
 
 void FakeVideoEncodeAccelerator::Destroy() { delete this; }
@@ -34,11 +34,20 @@ class FakeVideoEncodeAccelerator : public VideoEncodeAccelerator {
 
   virtual void Destroy() OVERRIDE;
 
+  uint32 last_requested_bitrate() const { return last_requested_bitrate_; }
+  uint32 last_requested_framerate() const { return last_requested_framerate_; }
+
+  // The Y plane of the last frame given to Encode().
+  const uint8* last_frame_data() const { return last_frame_data_; }
+
  private:
   virtual ~FakeVideoEncodeAccelerator();
 
   VideoEncodeAccelerator::Client* client_;
   bool first_;
+  uint32 last_requested_bitrate_;
+  uint32 last_requested_framerate_;
+  const uint8* last_frame_data_;
 
   std::list<int32> available_buffer_ids_;
 
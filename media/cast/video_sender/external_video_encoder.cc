@@ -4,6 +4,9 @@
 
 #include "media/cast/video_sender/external_video_encoder.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "base/bind.h"
 #include "base/logging.h"
 #include "base/memory/scoped_vector.h"
@@ -21,6 +24,11 @@ namespace {
 static const int kInputBufferExtraCount = 1;
 static const int kOutputBufferCount = 3;
 
+// Weight of the newest frame interval in the frame rate estimate, and how far
+// the estimate must move before the encoder is told about it.
+static const double kFrameIntervalWeight = 0.1;
+static const double kFrameRateChangeThreshold = 0.1;
+
 void LogFrameEncodedEvent(media::cast::CastEnvironment* const cast_environment,
                           const base::TimeTicks& capture_time) {
   cast_environment->Logging()->InsertFrameEvent(
@@ -29,6 +37,45 @@ void LogFrameEncodedEvent(media::cast::CastEnvironment* const cast_environment,
       media::cast::GetVideoRtpTimestamp(capture_time),
       media::cast::kFrameIdUnknown);
 }
+
+// |cpu_time| is null when thread CPU time isn't supported.
+void LogEncodeStats(media::cast::CastEnvironment* const cast_environment,
+                    base::TimeDelta latency,
+                    base::TimeDelta cpu_time) {
+  base::TimeTicks now = cast_environment->Clock()->NowTicks();
+  cast_environment->Logging()->InsertGenericEvent(
+      now, media::cast::kVideoEncodeLatencyMs, latency.InMilliseconds());
+  if (cpu_time != base::TimeDelta()) {
+    cast_environment->Logging()->InsertGenericEvent(
+        now, media::cast::kVideoEncodeCpuUs, cpu_time.InMicroseconds());
+  }
+}
+
+base::TimeTicks ThreadNow() {
+  return base::TimeTicks::IsThreadNowSupported() ?
+      base::TimeTicks::ThreadNow() : base::TimeTicks();
+}
+
+// Returns true if |frame| can be handed to the encoder as it is: an I420 frame
+// of |coded_size| whose planes are packed in shared memory, such as the frames
+// from video capture.
+bool CanEncodeWithoutCopy(const scoped_refptr<media::VideoFrame>& frame,
+                          const gfx::Size& coded_size) {
+  if (frame->format() != media::VideoFrame::I420 ||
+      frame->coded_size() != coded_size ||
+      !base::SharedMemory::IsHandleValid(frame->shared_memory_handle())) {
+    return false;
+  }
+  const uint8* plane_start = frame->data(media::VideoFrame::kYPlane);
+  for (size_t i = 0; i < media::VideoFrame::NumPlanes(frame->format()); ++i) {
+    if (frame->data(i) != plane_start ||
+        frame->stride(i) != frame->row_bytes(i)) {
+      return false;
+    }
+    plane_start += frame->stride(i) * frame->rows(i);
+  }
+  return true;
+}
 }  // namespace
 
 namespace media {
@@ -37,12 +84,20 @@ namespace cast {
 // Container for the associated data of a video frame being processed.
 struct EncodedFrameReturnData {
   EncodedFrameReturnData(base::TimeTicks c_time,
-                         VideoEncoder::FrameEncodedCallback callback) {
+                         VideoEncoder::FrameEncodedCallback callback,
+                         base::TimeTicks start_time,
+                         base::TimeDelta cpu) {
     capture_time = c_time;
     frame_encoded_callback = callback;
+    encode_start_time = start_time;
+    cpu_time = cpu;
   }
   base::TimeTicks capture_time;
   VideoEncoder::FrameEncodedCallback frame_encoded_callback;
+  // When the frame was given to the encoder, and the encoder thread CPU time
+  // spent on it so far.
+  base::TimeTicks encode_start_time;
+  base::TimeDelta cpu_time;
 };
 
 // The ExternalVideoEncoder class can be deleted directly by cast, while
@@ -60,6 +115,9 @@ class LocalVideoEncodeAcceleratorClient
         gpu_factories_(gpu_factories),
         encoder_task_runner_(gpu_factories->GetTaskRunner()),
         weak_owner_(weak_owner),
+        max_frame_rate_(0),
+        requested_frame_rate_(0),
+        bit_rate_(0),
         last_encoded_frame_id_(kStartFrameId) {
     DCHECK(encoder_task_runner_);
   }
@@ -87,6 +145,9 @@ class LocalVideoEncodeAcceleratorClient
     }
     codec_ = video_config.codec;
     max_frame_rate_ = video_config.max_frame_rate;
+    requested_frame_rate_ = max_frame_rate_;
+    frame_interval_ = base::TimeDelta::FromSeconds(1) / max_frame_rate_;
+    bit_rate_ = video_config.start_bitrate;
 
     // Asynchronous initialization call; NotifyInitializeDone or NotifyError
     // will be called once the HW is initialized.
@@ -111,8 +172,11 @@ class LocalVideoEncodeAcceleratorClient
     DCHECK(encoder_task_runner_);
     DCHECK(encoder_task_runner_->RunsTasksOnCurrentThread());
 
-    video_encode_accelerator_->RequestEncodingParametersChange(bit_rate,
-                                                               max_frame_rate_);
+    bit_rate_ = bit_rate;
+    if (video_encode_accelerator_) {
+      video_encode_accelerator_->RequestEncodingParametersChange(
+          bit_rate_, requested_frame_rate_);
+    }
   }
 
   void EncodeVideoFrame(
@@ -123,6 +187,23 @@ class LocalVideoEncodeAcceleratorClient
     DCHECK(encoder_task_runner_);
     DCHECK(encoder_task_runner_->RunsTasksOnCurrentThread());
 
+    if (!video_encode_accelerator_)
+      return;
+
+    const base::TimeTicks start_time = cast_environment_->Clock()->NowTicks();
+    const base::TimeTicks start_cpu_time = ThreadNow();
+    UpdateFrameRate(capture_time);
+
+    // Frames from video capture are already in shared memory the encoder can
+    // read.
+    if (CanEncodeWithoutCopy(video_frame, input_coded_size_)) {
+      encoded_frame_data_storage_.push_back(EncodedFrameReturnData(
+          capture_time, frame_encoded_callback, start_time,
+          ThreadNow() - start_cpu_time));
+      video_encode_accelerator_->Encode(video_frame, key_frame_requested);
+      return;
+    }
+
     if (input_buffers_free_.empty()) {
       NOTREACHED();
       VLOG(2) << "EncodeVideoFrame(): drop frame due to no hw buffers";
@@ -167,8 +248,9 @@ class LocalVideoEncodeAcceleratorClient
                       video_frame->natural_size().height(),
                       frame.get());
 
-    encoded_frame_data_storage_.push_back(
-        EncodedFrameReturnData(capture_time, frame_encoded_callback));
+    encoded_frame_data_storage_.push_back(EncodedFrameReturnData(
+        capture_time, frame_encoded_callback, start_time,
+        ThreadNow() - start_cpu_time));
 
     // BitstreamBufferReady will be called once the encoder is done.
     video_encode_accelerator_->Encode(frame, key_frame_requested);
@@ -207,6 +289,7 @@ class LocalVideoEncodeAcceleratorClient
     DCHECK(encoder_task_runner_->RunsTasksOnCurrentThread());
     DCHECK(video_encode_accelerator_);
 
+    input_coded_size_ = input_coded_size;
     for (unsigned int i = 0; i < input_count + kInputBufferExtraCount; ++i) {
       base::SharedMemory* shm =
           gpu_factories_->CreateSharedMemory(media::VideoFrame::AllocationSize(
@@ -244,6 +327,7 @@ class LocalVideoEncodeAcceleratorClient
                                     bool key_frame) OVERRIDE {
     DCHECK(encoder_task_runner_);
     DCHECK(encoder_task_runner_->RunsTasksOnCurrentThread());
+    const base::TimeTicks start_cpu_time = ThreadNow();
     if (bitstream_buffer_id < 0 ||
         bitstream_buffer_id >= static_cast<int32>(output_buffers_.size())) {
       NOTREACHED();
@@ -297,6 +381,17 @@ class LocalVideoEncodeAcceleratorClient
                    base::Passed(&encoded_frame),
                    encoded_frame_data_storage_.front().capture_time));
 
+    const EncodedFrameReturnData& frame_data =
+        encoded_frame_data_storage_.front();
+    cast_environment_->PostTask(
+        CastEnvironment::MAIN,
+        FROM_HERE,
+        base::Bind(LogEncodeStats,
+                   cast_environment_,
+                   cast_environment_->Clock()->NowTicks() -
+                       frame_data.encode_start_time,
+                   frame_data.cpu_time + (ThreadNow() - start_cpu_time)));
+
     encoded_frame_data_storage_.pop_front();
 
     // We need to re-add the output buffer to the encoder after we are done
@@ -308,6 +403,30 @@ class LocalVideoEncodeAcceleratorClient
   }
 
  private:
+  // Tracks the rate frames are captured at, and tells the encoder when it
+  // moves, since the encoder spreads |bit_rate_| over the frames it expects.
+  // Mirroring an idle tab delivers frames well below |max_frame_rate_|, which
+  // would otherwise be encoded far below the target bitrate.
+  void UpdateFrameRate(const base::TimeTicks& capture_time) {
+    if (!last_capture_time_.is_null() && capture_time > last_capture_time_) {
+      const base::TimeDelta interval = capture_time - last_capture_time_;
+      const int64 error_us = (interval - frame_interval_).InMicroseconds();
+      frame_interval_ += base::TimeDelta::FromMicroseconds(
+          static_cast<int64>(error_us * kFrameIntervalWeight));
+    }
+    last_capture_time_ = capture_time;
+
+    const double frame_rate = std::max(1.0, std::min<double>(
+        max_frame_rate_, 1.0 / frame_interval_.InSecondsF()));
+    if (std::abs(frame_rate - requested_frame_rate_) <=
+        requested_frame_rate_ * kFrameRateChangeThreshold) {
+      return;
+    }
+    requested_frame_rate_ = static_cast<uint32>(frame_rate + 0.5);
+    video_encode_accelerator_->RequestEncodingParametersChange(
+        bit_rate_, requested_frame_rate_);
+  }
+
   // Encoder is done with the provided input buffer.
   void FinishedWithInBuffer(int input_index) {
     DCHECK(encoder_task_runner_);
@@ -330,6 +449,14 @@ class LocalVideoEncodeAcceleratorClient
   scoped_ptr<media::VideoEncodeAccelerator> video_encode_accelerator_;
   int max_frame_rate_;
   transport::VideoCodec codec_;
+  gfx::Size input_coded_size_;
+
+  // Bitrate from congestion control, and the frame rate last given to the
+  // encoder, estimated from |frame_interval_|.
+  uint32 requested_frame_rate_;
+  uint32 bit_rate_;
+  base::TimeDelta frame_interval_;
+  base::TimeTicks last_capture_time_;
   uint32 last_encoded_frame_id_;
 
   // Shared memory buffers for input/output with the VideoAccelerator.
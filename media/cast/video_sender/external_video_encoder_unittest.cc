@@ -7,9 +7,11 @@
 #include "base/bind.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
 #include "media/base/video_frame.h"
 #include "media/cast/cast_defines.h"
 #include "media/cast/cast_environment.h"
+#include "media/cast/logging/simple_event_subscriber.h"
 #include "media/cast/test/fake_gpu_video_accelerator_factories.h"
 #include "media/cast/test/fake_single_thread_task_runner.h"
 #include "media/cast/test/fake_video_encode_accelerator.h"
@@ -96,14 +98,22 @@ class ExternalVideoEncoderTest : public ::testing::Test {
                             task_runner_,
                             task_runner_,
                             task_runner_,
-                            GetDefaultCastSenderLoggingConfig());
+                            GetLoggingConfigWithRawEventsAndStatsEnabled());
+    cast_environment_->Logging()->AddRawEventSubscriber(&event_subscriber_);
+    gpu_factories_ = new test::FakeGpuVideoAcceleratorFactories(task_runner_);
     video_encoder_.reset(new ExternalVideoEncoder(
         cast_environment_,
         video_config_,
-        new test::FakeGpuVideoAcceleratorFactories(task_runner_)));
+        gpu_factories_));
   }
 
-  virtual ~ExternalVideoEncoderTest() {}
+  virtual ~ExternalVideoEncoderTest() {
+    cast_environment_->Logging()->RemoveRawEventSubscriber(&event_subscriber_);
+  }
+
+  test::FakeVideoEncodeAccelerator* fake_encoder() {
+    return gpu_factories_->last_video_encode_accelerator();
+  }
 
   base::SimpleTestTickClock* testing_clock_;  // Owned by CastEnvironment.
   scoped_refptr<TestVideoEncoderCallback> test_video_encoder_callback_;
@@ -112,6 +122,8 @@ class ExternalVideoEncoderTest : public ::testing::Test {
   scoped_ptr<VideoEncoder> video_encoder_;
   scoped_refptr<media::VideoFrame> video_frame_;
   scoped_refptr<CastEnvironment> cast_environment_;
+  scoped_refptr<test::FakeGpuVideoAcceleratorFactories> gpu_factories_;
+  SimpleEventSubscriber event_subscriber_;
 
   DISALLOW_COPY_AND_ASSIGN(ExternalVideoEncoderTest);
 };
@@ -143,5 +155,103 @@ TEST_F(ExternalVideoEncoderTest, EncodePattern30fpsRunningOutOfAck) {
   task_runner_->RunTasks();
 }
 
+TEST_F(ExternalVideoEncoderTest, FrameRateFollowsCapture) {
+  task_runner_->RunTasks();  // Run the initializer on the correct thread.
+
+  VideoEncoder::FrameEncodedCallback frame_encoded_callback =
+      base::Bind(&TestVideoEncoderCallback::DeliverEncodedVideoFrame,
+                 test_video_encoder_callback_.get());
+
+  // Capture at 10fps; the encoder is told to expect that rate instead of the
+  // configured maximum.
+  base::TimeTicks capture_time;
+  for (int i = 0; i < 40; ++i) {
+    capture_time += base::TimeDelta::FromMilliseconds(100);
+    test_video_encoder_callback_->SetExpectedResult(
+        i == 0, i, i == 0 ? 0 : i - 1, capture_time);
+    EXPECT_TRUE(video_encoder_->EncodeVideoFrame(
+        video_frame_, capture_time, frame_encoded_callback));
+    task_runner_->RunTasks();
+  }
+  EXPECT_LE(9u, fake_encoder()->last_requested_framerate());
+  EXPECT_GE(11u, fake_encoder()->last_requested_framerate());
+
+  // Bitrate changes from congestion control keep the measured frame rate.
+  const uint32 framerate = fake_encoder()->last_requested_framerate();
+  video_encoder_->SetBitRate(3000000);
+  task_runner_->RunTasks();
+  EXPECT_EQ(3000000u, fake_encoder()->last_requested_bitrate());
+  EXPECT_EQ(framerate, fake_encoder()->last_requested_framerate());
+
+  video_encoder_.reset(NULL);
+  task_runner_->RunTasks();
+}
+
+TEST_F(ExternalVideoEncoderTest, EncodesSharedMemoryFramesWithoutCopy) {
+  task_runner_->RunTasks();  // Run the initializer on the correct thread.
+
+  VideoEncoder::FrameEncodedCallback frame_encoded_callback =
+      base::Bind(&TestVideoEncoderCallback::DeliverEncodedVideoFrame,
+                 test_video_encoder_callback_.get());
+
+  // Frames in ordinary memory are copied into the encoder's input buffers.
+  base::TimeTicks capture_time;
+  capture_time += base::TimeDelta::FromMilliseconds(33);
+  test_video_encoder_callback_->SetExpectedResult(true, 0, 0, capture_time);
+  EXPECT_TRUE(video_encoder_->EncodeVideoFrame(
+      video_frame_, capture_time, frame_encoded_callback));
+  task_runner_->RunTasks();
+  EXPECT_NE(video_frame_->data(VideoFrame::kYPlane),
+            fake_encoder()->last_frame_data());
+
+  // Frames in shared memory, like those from video capture, are encoded as
+  // they are.
+  gfx::Size size(video_config_.width, video_config_.height);
+  base::SharedMemory shared_memory;
+  const size_t frame_size = VideoFrame::AllocationSize(VideoFrame::I420, size);
+  ASSERT_TRUE(shared_memory.CreateAndMapAnonymous(frame_size));
+  scoped_refptr<VideoFrame> shared_frame = VideoFrame::WrapExternalPackedMemory(
+      VideoFrame::I420, size, gfx::Rect(size), size,
+      static_cast<uint8*>(shared_memory.memory()), frame_size,
+      shared_memory.handle(), base::TimeDelta(), base::Closure());
+  ASSERT_TRUE(shared_frame);
+
+  capture_time += base::TimeDelta::FromMilliseconds(33);
+  test_video_encoder_callback_->SetExpectedResult(false, 1, 0, capture_time);
+  EXPECT_TRUE(video_encoder_->EncodeVideoFrame(
+      shared_frame, capture_time, frame_encoded_callback));
+  task_runner_->RunTasks();
+  EXPECT_EQ(shared_frame->data(VideoFrame::kYPlane),
+            fake_encoder()->last_frame_data());
+
+  video_encoder_.reset(NULL);
+  task_runner_->RunTasks();
+}
+
+TEST_F(ExternalVideoEncoderTest, LogsEncodeLatency) {
+  task_runner_->RunTasks();  // Run the initializer on the correct thread.
+
+  base::TimeTicks capture_time;
+  capture_time += base::TimeDelta::FromMilliseconds(33);
+  test_video_encoder_callback_->SetExpectedResult(true, 0, 0, capture_time);
+  EXPECT_TRUE(video_encoder_->EncodeVideoFrame(
+      video_frame_, capture_time,
+      base::Bind(&TestVideoEncoderCallback::DeliverEncodedVideoFrame,
+                 test_video_encoder_callback_.get())));
+  task_runner_->RunTasks();
+
+  std::vector<GenericEvent> generic_events;
+  event_subscriber_.GetGenericEventsAndReset(&generic_events);
+  int latency_events = 0;
+  for (size_t i = 0; i < generic_events.size(); ++i) {
+    if (generic_events[i].type == kVideoEncodeLatencyMs)
+      ++latency_events;
+  }
+  EXPECT_EQ(1, latency_events);
+
+  video_encoder_.reset(NULL);
+  task_runner_->RunTasks();
+}
+
 }  // namespace cast
 }  // namespace media
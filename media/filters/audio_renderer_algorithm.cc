@@ -79,6 +79,7 @@ AudioRendererAlgorithm::AudioRendererAlgorithm()
       muted_(false),
       muted_partial_frame_(0),
       capacity_(kStartingBufferSizeInFrames),
+      min_capacity_(kStartingBufferSizeInFrames),
       output_time_(0.0),
       search_block_center_offset_(0),
       search_block_index_(0),
@@ -215,7 +216,7 @@ void AudioRendererAlgorithm::FlushBuffers() {
 
   // Reset |capacity_| so growth triggered by underflows doesn't penalize
   // seek time.
-  capacity_ = kStartingBufferSizeInFrames;
+  capacity_ = min_capacity_;
 }
 
 base::TimeDelta AudioRendererAlgorithm::GetTime() {
@@ -239,6 +240,17 @@ void AudioRendererAlgorithm::IncreaseQueueCapacity() {
   capacity_ = std::min(2 * capacity_, max_capacity);
 }
 
+void AudioRendererAlgorithm::DecreaseQueueCapacity() {
+  capacity_ = std::max(capacity_ / 2, min_capacity_);
+}
+
+void AudioRendererAlgorithm::SetMinimumQueueCapacity(int frames) {
+  DCHECK_GT(frames, 0);
+  DCHECK_LE(frames, kMaxCapacityInSeconds * samples_per_second_);
+  min_capacity_ = frames;
+  capacity_ = frames;
+}
+
 bool AudioRendererAlgorithm::CanPerformWsola() const {
   const int search_block_size = num_candidate_blocks_ + (ola_window_size_ - 1);
   const int frames = audio_buffer_.frames();
@@ -76,6 +76,14 @@ class MEDIA_EXPORT AudioRendererAlgorithm {
   // Increase the capacity of |audio_buffer_| if possible.
   void IncreaseQueueCapacity();
 
+  // Halve the capacity of |audio_buffer_|, but never below the minimum set by
+  // SetMinimumQueueCapacity().
+  void DecreaseQueueCapacity();
+
+  // Sets the capacity of |audio_buffer_| used after FlushBuffers() and the
+  // floor for DecreaseQueueCapacity(). Also resets the current capacity.
+  void SetMinimumQueueCapacity(int frames);
+
   // Returns the number of frames left in |audio_buffer_|, which may be larger
   // than QueueCapacity() in the event that EnqueueBuffer() delivered more data
   // than |audio_buffer_| was intending to hold.
@@ -149,6 +157,9 @@ class MEDIA_EXPORT AudioRendererAlgorithm {
   // How many frames to have in the queue before we report the queue is full.
   int capacity_;
 
+  // Starting value and lower bound of |capacity_|.
+  int min_capacity_;
+
   // Book keeping of the current time of generated audio, in frames. This
   // should be appropriately updated when out samples are generated, regardless
   // of whether we push samples out when FillBuffer() is called or we store
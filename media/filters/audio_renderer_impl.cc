@@ -34,6 +34,18 @@ void HistogramRendererEvent(AudioRendererEvent event) {
   UMA_HISTOGRAM_ENUMERATION("Media.AudioRendererEvents", event, MAX_EVENTS);
 }
 
+// In low latency mode the queue holds at least this many hardware buffers, but
+// never less than kLowLatencyMinimumQueueMs of audio.
+const int kLowLatencyQueuedHardwareBuffers = 4;
+const int kLowLatencyMinimumQueueMs = 50;
+
+// Amount of playback without underflow after which the low latency queue is
+// shrunk again.
+const int kLowLatencyShrinkIntervalSeconds = 10;
+
+// Amount of playback between samples of the output latency histograms.
+const int kLatencySampleIntervalMs = 1000;
+
 }  // namespace
 
 AudioRendererImpl::AudioRendererImpl(
@@ -55,7 +67,9 @@ AudioRendererImpl::AudioRendererImpl(
       audio_time_buffered_(kNoTimestamp()),
       current_time_(kNoTimestamp()),
       underflow_disabled_(false),
-      preroll_aborted_(false) {
+      preroll_aborted_(false),
+      frames_since_underflow_(0),
+      frames_since_latency_sample_(0) {
 }
 
 AudioRendererImpl::~AudioRendererImpl() {
@@ -174,6 +188,7 @@ void AudioRendererImpl::ResetDecoderDone() {
     received_end_of_stream_ = false;
     rendered_end_of_stream_ = false;
     preroll_aborted_ = false;
+    frames_since_underflow_ = 0;
 
     earliest_end_time_ = now_cb_.Run();
     splicer_->Reset();
@@ -339,6 +354,17 @@ void AudioRendererImpl::OnDecoderSelected(
   algorithm_.reset(new AudioRendererAlgorithm());
   algorithm_->Initialize(0, audio_parameters_);
 
+  if (low_latency_hardware_params_.IsValid()) {
+    // The sink resamples to the hardware rate, so express the hardware buffer
+    // in frames at the decoder's rate.
+    int hardware_buffer_frames = static_cast<int>(
+        static_cast<int64>(low_latency_hardware_params_.frames_per_buffer()) *
+        sample_rate / low_latency_hardware_params_.sample_rate());
+    algorithm_->SetMinimumQueueCapacity(std::max(
+        kLowLatencyQueuedHardwareBuffers * hardware_buffer_frames,
+        sample_rate * kLowLatencyMinimumQueueMs / 1000));
+  }
+
   ChangeState_Locked(kPaused);
 
   HistogramRendererEvent(INITIALIZED);
@@ -571,6 +597,7 @@ int AudioRendererImpl::Render(AudioBus* audio_bus,
 
   int frames_written = 0;
   base::Closure underflow_cb;
+  base::TimeDelta output_latency = kNoTimestamp();
   {
     base::AutoLock auto_lock(lock_);
 
@@ -620,6 +647,34 @@ int AudioRendererImpl::Render(AudioBus* audio_bus,
       }
     }
 
+    const int sample_rate = audio_parameters_.sample_rate();
+    if (low_latency_hardware_params_.IsValid()) {
+      // Shrink the queue back towards the device minimum once playback has
+      // gone long enough without underflowing.
+      if (frames_written < requested_frames)
+        frames_since_underflow_ = 0;
+      else
+        frames_since_underflow_ += frames_written;
+
+      if (frames_since_underflow_ >=
+          kLowLatencyShrinkIntervalSeconds * sample_rate) {
+        algorithm_->DecreaseQueueCapacity();
+        frames_since_underflow_ = 0;
+      }
+    }
+
+    // Sample the end-to-end output latency: audio queued by |algorithm_| plus
+    // the delay reported by the sink.
+    frames_since_latency_sample_ += requested_frames;
+    if (frames_since_latency_sample_ >=
+        sample_rate * kLatencySampleIntervalMs / 1000) {
+      frames_since_latency_sample_ = 0;
+      output_latency = playback_delay + base::TimeDelta::FromMicroseconds(
+          static_cast<int64>(algorithm_->frames_buffered() *
+                             base::Time::kMicrosecondsPerSecond /
+                             (sample_rate * playback_rate)));
+    }
+
     if (CanRead_Locked()) {
       task_runner_->PostTask(FROM_HERE, base::Bind(
           &AudioRendererImpl::AttemptRead, weak_this_));
@@ -674,6 +729,15 @@ int AudioRendererImpl::Render(AudioBus* audio_bus,
   if (!underflow_cb.is_null())
     underflow_cb.Run();
 
+  if (output_latency != kNoTimestamp()) {
+    if (low_latency_hardware_params_.IsValid()) {
+      UMA_HISTOGRAM_TIMES("Media.AudioRenderer.LowLatencyOutputLatency",
+                          output_latency);
+    } else {
+      UMA_HISTOGRAM_TIMES("Media.AudioRenderer.OutputLatency", output_latency);
+    }
+  }
+
   DCHECK_LE(frames_written, requested_frames);
   return frames_written;
 }
@@ -701,6 +765,13 @@ void AudioRendererImpl::DisableUnderflowForTesting() {
   underflow_disabled_ = true;
 }
 
+void AudioRendererImpl::EnableLowLatencyMode(
+    const AudioParameters& hardware_params) {
+  DCHECK_EQ(kUninitialized, state_);
+  DCHECK(hardware_params.IsValid());
+  low_latency_hardware_params_ = hardware_params;
+}
+
 void AudioRendererImpl::HandleAbortedReadOrDecodeError(bool is_decode_error) {
   lock_.AssertAcquired();
 
@@ -85,6 +85,12 @@ class MEDIA_EXPORT AudioRendererImpl
   // Initialize().
   void DisableUnderflowForTesting();
 
+  // Enables low latency rendering for an output device described by
+  // |hardware_params|. The internal queue starts out a few hardware buffers
+  // long, grows on underflow and shrinks back towards that size after a period
+  // of playback without underflow. Must be called prior to Initialize().
+  void EnableLowLatencyMode(const AudioParameters& hardware_params);
+
   // Allows injection of a custom time callback for non-realtime testing.
   typedef base::Callback<base::TimeTicks()> NowCB;
   void set_now_cb_for_testing(const NowCB& now_cb) {
@@ -207,6 +213,10 @@ class MEDIA_EXPORT AudioRendererImpl
   // AudioParameters constructed during Initialize() based on |decoder_|.
   AudioParameters audio_parameters_;
 
+  // Output device parameters passed to EnableLowLatencyMode(). Invalid unless
+  // low latency mode is enabled.
+  AudioParameters low_latency_hardware_params_;
+
   // Callbacks provided during Initialize().
   PipelineStatusCB init_cb_;
   StatisticsCB statistics_cb_;
@@ -278,6 +288,13 @@ class MEDIA_EXPORT AudioRendererImpl
   // false otherwise. This flag is cleared on the next Preroll() call.
   bool preroll_aborted_;
 
+  // Frames rendered since the last underflow or queue shrink. Only tracked in
+  // low latency mode.
+  int frames_since_underflow_;
+
+  // Frames rendered since the output latency histogram was last sampled.
+  int frames_since_latency_sample_;
+
   // End variables which must be accessed under |lock_|. ----------------------
 
   DISALLOW_COPY_AND_ASSIGN(AudioRendererImpl);
@@ -394,6 +394,12 @@ class AudioRendererImplTest : public ::testing::Test {
     renderer_->ResumeAfterUnderflow();
   }
 
+  void EnableLowLatencyMode(int hardware_buffer_size) {
+    renderer_->EnableLowLatencyMode(AudioParameters(
+        AudioParameters::AUDIO_PCM_LOW_LATENCY, kChannelLayout,
+        kSamplesPerSecond, 16, hardware_buffer_size));
+  }
+
   TimeDelta CalculatePlayTime(int frames_filled) {
     return TimeDelta::FromMicroseconds(
         frames_filled * Time::kMicrosecondsPerSecond /
@@ -772,6 +778,48 @@ TEST_F(AudioRendererImplTest, Underflow_PausePlay) {
   EXPECT_EQ(FakeAudioRendererSink::kPlaying, sink_->state());
 }
 
+TEST_F(AudioRendererImplTest, LowLatency_Initialize) {
+  EnableLowLatencyMode(kDataSize);
+  Initialize();
+  Preroll();
+
+  // The queue should hold a few hardware buffers instead of the default.
+  EXPECT_EQ(4 * kDataSize, buffer_capacity());
+  EXPECT_EQ(4 * kDataSize, frames_buffered());
+}
+
+TEST_F(AudioRendererImplTest, LowLatency_UnderflowThenShrink) {
+  EnableLowLatencyMode(kDataSize);
+  Initialize();
+  Preroll();
+
+  int initial_capacity = buffer_capacity();
+
+  Play();
+
+  // Drain internal buffer and underflow.
+  EXPECT_TRUE(ConsumeBufferedData(frames_buffered(), NULL));
+  WaitForPendingRead();
+  EXPECT_CALL(*this, OnUnderflow());
+  EXPECT_FALSE(ConsumeBufferedData(kDataSize, NULL));
+  renderer_->ResumeAfterUnderflow();
+  EXPECT_GT(buffer_capacity(), initial_capacity);
+  DeliverRemainingAudio();
+
+  // Play ten seconds without underflowing; the queue should shrink back.
+  int frames_rendered = 0;
+  while (frames_rendered < 10 * kSamplesPerSecond) {
+    EXPECT_GT(buffer_capacity(), initial_capacity);
+    EXPECT_TRUE(ConsumeBufferedData(kDataSize, NULL));
+    frames_rendered += kDataSize;
+
+    base::RunLoop().RunUntilIdle();
+    if (IsReadPending())
+      SatisfyPendingRead(kDataSize);
+  }
+  EXPECT_EQ(initial_capacity, buffer_capacity());
+}
+
 TEST_F(AudioRendererImplTest, AbortPendingRead_Preroll) {
   Initialize();
 
@@ -4,12 +4,19 @@
 
 #include "media/filters/blocking_url_protocol.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "media/base/data_source.h"
 #include "media/ffmpeg/ffmpeg_common.h"
 
 namespace media {
 
+// Bounds of the read-ahead size. The size starts at the minimum on the first
+// sequential read and doubles with every sequential read-ahead read.
+static const int kMinReadAheadSize = 64 * 1024;
+static const int kMaxReadAheadSize = 1024 * 1024;
+
 BlockingUrlProtocol::BlockingUrlProtocol(
     DataSource* data_source,
     const base::Closure& error_cb)
@@ -18,7 +25,11 @@ BlockingUrlProtocol::BlockingUrlProtocol(
       aborted_(true, false),  // We never want to reset |aborted_|.
       read_complete_(false, false),
       last_read_bytes_(0),
-      read_position_(0) {
+      read_position_(0),
+      read_ahead_position_(0),
+      read_ahead_bytes_(0),
+      read_ahead_size_(0),
+      next_sequential_position_(-1) {
 }
 
 BlockingUrlProtocol::~BlockingUrlProtocol() {}
@@ -35,13 +46,61 @@ int BlockingUrlProtocol::Read(int size, uint8* data) {
   // Even though FFmpeg defines AVERROR_EOF, it's not to be used with I/O
   // routines. Instead return 0 for any read at or past EOF.
   int64 file_size;
-  if (data_source_->GetSize(&file_size) && read_position_ >= file_size)
+  bool size_known = data_source_->GetSize(&file_size);
+  if (size_known && read_position_ >= file_size)
     return 0;
 
+  // Serve the read from previously read-ahead data if possible.
+  int64 offset = read_position_ - read_ahead_position_;
+  if (offset >= 0 && offset < read_ahead_bytes_) {
+    int bytes = std::min(size, read_ahead_bytes_ - static_cast<int>(offset));
+    memcpy(data, read_ahead_buffer_.get() + offset, bytes);
+    read_position_ += bytes;
+    return bytes;
+  }
+
+  if (read_position_ == next_sequential_position_) {
+    read_ahead_size_ = read_ahead_size_ ?
+        std::min(2 * read_ahead_size_, kMaxReadAheadSize) : kMinReadAheadSize;
+  } else {
+    read_ahead_size_ = 0;
+  }
+  read_ahead_bytes_ = 0;
+
+  int read_ahead_size = read_ahead_size_;
+  if (size_known && file_size - read_position_ < read_ahead_size)
+    read_ahead_size = file_size - read_position_;
+
+  // Large and non-sequential reads go straight to |data|.
+  if (read_ahead_size <= size) {
+    int bytes = ReadFromDataSource(read_position_, size, data);
+    if (bytes > 0)
+      read_position_ += bytes;
+    return bytes;
+  }
+
+  if (!read_ahead_buffer_)
+    read_ahead_buffer_.reset(new uint8[kMaxReadAheadSize]);
+
+  int bytes = ReadFromDataSource(
+      read_position_, read_ahead_size, read_ahead_buffer_.get());
+  if (bytes <= 0)
+    return bytes;
+
+  read_ahead_position_ = read_position_;
+  read_ahead_bytes_ = bytes;
+  bytes = std::min(size, bytes);
+  memcpy(data, read_ahead_buffer_.get(), bytes);
+  read_position_ += bytes;
+  return bytes;
+}
+
+int BlockingUrlProtocol::ReadFromDataSource(int64 position, int size,
+                                            uint8* data) {
   // Blocking read from data source until either:
   //   1) |last_read_bytes_| is set and |read_complete_| is signalled
   //   2) |aborted_| is signalled
-  data_source_->Read(read_position_, size, data, base::Bind(
+  data_source_->Read(position, size, data, base::Bind(
       &BlockingUrlProtocol::SignalReadCompleted, base::Unretained(this)));
 
   base::WaitableEvent* events[] = { &aborted_, &read_complete_ };
@@ -56,7 +115,7 @@ int BlockingUrlProtocol::Read(int size, uint8* data) {
     return AVERROR(EIO);
   }
 
-  read_position_ += last_read_bytes_;
+  next_sequential_position_ = position + last_read_bytes_;
   return last_read_bytes_;
 }
 
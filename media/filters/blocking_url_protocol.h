@@ -7,6 +7,7 @@
 
 #include "base/basictypes.h"
 #include "base/callback.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/synchronization/waitable_event.h"
 #include "media/filters/ffmpeg_glue.h"
 
@@ -16,6 +17,11 @@ class DataSource;
 
 // An implementation of FFmpegURLProtocol that blocks until the underlying
 // asynchronous DataSource::Read() operation completes.
+//
+// Once FFmpeg reads sequentially, small reads are coalesced into larger
+// read-ahead reads to save a round trip to the DataSource per read. The
+// read-ahead size grows while reads stay sequential and is reset by seeks so
+// startup and seeking only fetch what FFmpeg asks for.
 class MEDIA_EXPORT BlockingUrlProtocol : public FFmpegURLProtocol {
  public:
   // Implements FFmpegURLProtocol using the given |data_source|. |error_cb| is
@@ -38,6 +44,10 @@ class MEDIA_EXPORT BlockingUrlProtocol : public FFmpegURLProtocol {
   virtual bool IsStreaming() OVERRIDE;
 
  private:
+  // Performs a blocking read of |size| bytes at |position| from
+  // |data_source_|. Returns the number of bytes read or AVERROR(EIO).
+  int ReadFromDataSource(int64 position, int size, uint8* data);
+
   // Sets |last_read_bytes_| and signals the blocked thread that the read
   // has completed.
   void SignalReadCompleted(int size);
@@ -55,6 +65,17 @@ class MEDIA_EXPORT BlockingUrlProtocol : public FFmpegURLProtocol {
   // Cached position within the data source.
   int64 read_position_;
 
+  // Data read ahead of FFmpeg, starting at |read_ahead_position_|.
+  scoped_ptr<uint8[]> read_ahead_buffer_;
+  int64 read_ahead_position_;
+  int read_ahead_bytes_;
+
+  // Size of the next read-ahead read, 0 if reads aren't sequential.
+  int read_ahead_size_;
+
+  // Position immediately after the last read from |data_source_|.
+  int64 next_sequential_position_;
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(BlockingUrlProtocol);
 };
 
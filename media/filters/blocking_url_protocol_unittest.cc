@@ -2,6 +2,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <vector>
+
 #include "base/bind.h"
 #include "base/files/file_path.h"
 #include "base/synchronization/waitable_event.h"
@@ -75,6 +77,35 @@ TEST_F(BlockingUrlProtocolTest, Read) {
   EXPECT_EQ(size, position);
 }
 
+TEST_F(BlockingUrlProtocolTest, ReadAhead) {
+  int64 size = 0;
+  EXPECT_TRUE(url_protocol_.GetSize(&size));
+
+  // Read the whole file sequentially in small chunks, which should be served
+  // from read-ahead data after the first read.
+  std::vector<uint8> expected(size);
+  EXPECT_TRUE(url_protocol_.SetPosition(0));
+  for (int64 position = 0; position < size;) {
+    int bytes = url_protocol_.Read(100, &expected[position]);
+    ASSERT_GT(bytes, 0);
+    position += bytes;
+    int64 read_position = 0;
+    EXPECT_TRUE(url_protocol_.GetPosition(&read_position));
+    EXPECT_EQ(position, read_position);
+  }
+  EXPECT_EQ(0, url_protocol_.Read(100, &expected[0]));
+
+  // Seeks backwards, into and outside of the read-ahead data, must return the
+  // same bytes as the sequential reads.
+  const int64 kPositions[] = { size / 2, 0, size - 100, 4096, size / 3 };
+  for (size_t i = 0; i < arraysize(kPositions); ++i) {
+    uint8 buffer[32];
+    EXPECT_TRUE(url_protocol_.SetPosition(kPositions[i]));
+    ASSERT_EQ(32, url_protocol_.Read(32, buffer));
+    EXPECT_EQ(0, memcmp(&expected[kPositions[i]], buffer, 32));
+  }
+}
+
 TEST_F(BlockingUrlProtocolTest, ReadError) {
   data_source_.force_read_errors_for_testing();
 
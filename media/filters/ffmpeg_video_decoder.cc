@@ -13,6 +13,7 @@
 #include "base/location.h"
 #include "base/single_thread_task_runner.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/sys_info.h"
 #include "media/base/bind_to_current_loop.h"
 #include "media/base/decoder_buffer.h"
 #include "media/base/limits.h"
@@ -38,16 +39,33 @@ namespace media {
 static const int kDecodeThreads = 2;
 static const int kMaxDecodeThreads = 16;
 
-// Returns the number of threads given the FFmpeg CodecID. Also inspects the
-// command line for a valid --video-threads flag.
-static int GetThreadCount(AVCodecID codec_id) {
+// Streams at least this wide use frame threading as well as slice threading.
+// Frame threading scales with the thread count regardless of how the stream
+// was sliced, but delays the output by a frame per thread, which only pays off
+// for large frames.
+static const int kFrameThreadingMinWidth = 1280;
+
+// Returns the number of threads for |config|: more for larger frames, up to
+// the number of cores. Also inspects the command line for a valid
+// --video-threads flag.
+static int GetThreadCount(const VideoDecoderConfig& config) {
   // Refer to http://crbug.com/93932 for tsan suppressions on decoding.
   int decode_threads = kDecodeThreads;
 
   const CommandLine* cmd_line = CommandLine::ForCurrentProcess();
   std::string threads(cmd_line->GetSwitchValueASCII(switches::kVideoThreads));
-  if (threads.empty() || !base::StringToInt(threads, &decode_threads))
-    return decode_threads;
+  if (threads.empty() || !base::StringToInt(threads, &decode_threads)) {
+    int width = config.coded_size().width();
+    if (width >= 3840)
+      decode_threads = 16;
+    else if (width >= 1920)
+      decode_threads = 8;
+    else if (width >= kFrameThreadingMinWidth)
+      decode_threads = 4;
+    return std::max(kDecodeThreads,
+                    std::min(decode_threads,
+                             base::SysInfo::NumberOfProcessors()));
+  }
 
   decode_threads = std::max(decode_threads, 0);
   decode_threads = std::min(decode_threads, kMaxDecodeThreads);
@@ -368,7 +386,10 @@ bool FFmpegVideoDecoder::ConfigureDecoder() {
   // Enable motion vector search (potentially slow), strong deblocking filter
   // for damaged macroblocks, and set our error detection sensitivity.
   codec_context_->error_concealment = FF_EC_GUESS_MVS | FF_EC_DEBLOCK;
-  codec_context_->thread_count = GetThreadCount(codec_context_->codec_id);
+  codec_context_->thread_count = GetThreadCount(config_);
+  codec_context_->thread_type = FF_THREAD_SLICE;
+  if (config_.coded_size().width() >= kFrameThreadingMinWidth)
+    codec_context_->thread_type |= FF_THREAD_FRAME;
   codec_context_->opaque = this;
   codec_context_->flags |= CODEC_FLAG_EMU_EDGE;
   codec_context_->get_buffer = GetVideoBufferImpl;
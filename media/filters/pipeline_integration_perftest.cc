@@ -2,7 +2,21 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/process/process_handle.h"
+#include "base/process/process_metrics.h"
+#include "base/run_loop.h"
+#include "base/timer/timer.h"
+#include "media/base/demuxer_stream.h"
+#include "media/base/media_log.h"
 #include "media/base/test_data_util.h"
+#include "media/base/yuv_convert.h"
+#include "media/filters/ffmpeg_demuxer.h"
+#include "media/filters/file_data_source.h"
 #include "media/filters/pipeline_integration_test_base.h"
 #include "testing/perf/perf_test.h"
 
@@ -11,26 +25,214 @@ namespace media {
 static const int kBenchmarkIterationsAudio = 200;
 static const int kBenchmarkIterationsVideo = 20;
 
+// Interval at which the process working set is sampled during playback.
+static const int kMemorySampleIntervalMs = 10;
+
+static base::TimeTicks ThreadNow() {
+  return base::TimeTicks::IsThreadNowSupported() ?
+      base::TimeTicks::ThreadNow() : base::TimeTicks();
+}
+
+// Returns the CPU time used by the process since the previous call to
+// GetPlatformIndependentCPUUsage() on |metrics|, given the wall clock time
+// |elapsed| since that call.
+static double GetProcessCpuSeconds(base::ProcessMetrics* metrics,
+                                   base::TimeDelta elapsed) {
+  return metrics->GetPlatformIndependentCPUUsage() / 100.0 *
+      elapsed.InSecondsF();
+}
+
+// Tracks the resources used by clockless playback outside of the pipeline's
+// own statistics: the CPU time spent converting painted frames to RGB as the
+// compositor would, and the high water mark of the process working set.
+class PlaybackProbe {
+ public:
+  PlaybackProbe()
+      : process_metrics_(base::ProcessMetrics::CreateProcessMetrics(
+            base::GetCurrentProcessHandle())),
+        peak_working_set_(0) {}
+
+  void Start() {
+    sample_timer_.Start(
+        FROM_HERE, base::TimeDelta::FromMilliseconds(kMemorySampleIntervalMs),
+        this, &PlaybackProbe::SampleMemory);
+  }
+
+  void Stop() {
+    sample_timer_.Stop();
+    SampleMemory();
+  }
+
+  void OnPaint(const scoped_refptr<VideoFrame>& frame) {
+    YUVType yuv_type;
+    if (frame->format() == VideoFrame::YV12 ||
+        frame->format() == VideoFrame::I420) {
+      yuv_type = YV12;
+    } else if (frame->format() == VideoFrame::YV16) {
+      yuv_type = YV16;
+    } else {
+      return;
+    }
+
+    const gfx::Rect& rect = frame->visible_rect();
+    rgb_frame_.resize(rect.width() * rect.height() * 4);
+
+    base::TimeTicks start = ThreadNow();
+    ConvertYUVToRGB32(frame->data(VideoFrame::kYPlane),
+                      frame->data(VideoFrame::kUPlane),
+                      frame->data(VideoFrame::kVPlane),
+                      &rgb_frame_[0],
+                      rect.width(),
+                      rect.height(),
+                      frame->stride(VideoFrame::kYPlane),
+                      frame->stride(VideoFrame::kUPlane),
+                      rect.width() * 4,
+                      yuv_type);
+    convert_time_ += ThreadNow() - start;
+  }
+
+  base::TimeDelta convert_time() const { return convert_time_; }
+  size_t peak_working_set() const { return peak_working_set_; }
+
+ private:
+  void SampleMemory() {
+    peak_working_set_ = std::max(peak_working_set_,
+                                 process_metrics_->GetWorkingSetSize());
+  }
+
+  scoped_ptr<base::ProcessMetrics> process_metrics_;
+  base::RepeatingTimer<PlaybackProbe> sample_timer_;
+  std::vector<uint8> rgb_frame_;
+  base::TimeDelta convert_time_;
+  size_t peak_working_set_;
+
+  DISALLOW_COPY_AND_ASSIGN(PlaybackProbe);
+};
+
+static void OnDemuxerInitialized(PipelineStatus status) {
+  CHECK_EQ(status, PIPELINE_OK);
+  base::MessageLoop::current()->QuitWhenIdle();
+}
+
+static void OnStreamRead(bool* end_of_stream,
+                         DemuxerStream::Status status,
+                         const scoped_refptr<DecoderBuffer>& buffer) {
+  CHECK_EQ(status, DemuxerStream::kOk);
+  *end_of_stream = buffer->end_of_stream();
+  base::MessageLoop::current()->QuitWhenIdle();
+}
+
+class NullDemuxerHost : public DemuxerHost {
+ public:
+  NullDemuxerHost() {}
+  virtual ~NullDemuxerHost() {}
+
+  // DataSourceHost implementation.
+  virtual void SetTotalBytes(int64 total_bytes) OVERRIDE {}
+  virtual void AddBufferedByteRange(int64 start, int64 end) OVERRIDE {}
+  virtual void AddBufferedTimeRange(base::TimeDelta start,
+                                    base::TimeDelta end) OVERRIDE {}
+
+  // DemuxerHost implementation.
+  virtual void SetDuration(base::TimeDelta duration) OVERRIDE {}
+  virtual void OnDemuxerError(PipelineStatus error) OVERRIDE {}
+  virtual void AddTextStream(DemuxerStream* text_stream,
+                             const TextTrackConfig& config) OVERRIDE {}
+  virtual void RemoveTextStream(DemuxerStream* text_stream) OVERRIDE {}
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(NullDemuxerHost);
+};
+
+static void NeedKey(const std::string& type,
+                    const std::vector<uint8>& init_data) {}
+
+// Returns the process CPU time, in seconds, taken to demux all streams of
+// |filename| |iterations| times. Demuxing happens on FFmpegDemuxer's own thread
+// while this thread idles, so process CPU time is attributed to the demuxer.
+static double MeasureDemuxCpuSeconds(const std::string& filename,
+                                     int iterations) {
+  base::MessageLoop message_loop;
+  scoped_ptr<base::ProcessMetrics> metrics(
+      base::ProcessMetrics::CreateProcessMetrics(
+          base::GetCurrentProcessHandle()));
+  metrics->GetPlatformIndependentCPUUsage();
+  base::TimeTicks start = base::TimeTicks::HighResNow();
+
+  for (int i = 0; i < iterations; ++i) {
+    NullDemuxerHost host;
+    FileDataSource data_source;
+    CHECK(data_source.Initialize(GetTestDataFilePath(filename)));
+    FFmpegDemuxer demuxer(message_loop.message_loop_proxy(),
+                          &data_source,
+                          base::Bind(&NeedKey),
+                          new MediaLog());
+    demuxer.Initialize(&host, base::Bind(&OnDemuxerInitialized), false);
+    base::RunLoop().Run();
+
+    const DemuxerStream::Type kTypes[] = {
+      DemuxerStream::AUDIO, DemuxerStream::VIDEO
+    };
+    for (size_t j = 0; j < arraysize(kTypes); ++j) {
+      DemuxerStream* stream = demuxer.GetStream(kTypes[j]);
+      bool end_of_stream = false;
+      while (stream && !end_of_stream) {
+        stream->Read(base::Bind(&OnStreamRead, &end_of_stream));
+        base::RunLoop().Run();
+      }
+    }
+
+    demuxer.Stop(base::MessageLoop::QuitWhenIdleClosure());
+    base::RunLoop().Run();
+  }
+
+  return GetProcessCpuSeconds(metrics.get(),
+                              base::TimeTicks::HighResNow() - start);
+}
+
 static void RunPlaybackBenchmark(const std::string& filename,
                                  const std::string& name,
                                  int iterations,
                                  bool audio_only) {
   double time_seconds = 0.0;
+  int64 video_frames_decoded = 0;
+  int64 video_frames_dropped = 0;
+  base::TimeDelta main_thread_cpu_time;
+  base::TimeDelta convert_cpu_time;
+  base::TimeDelta audio_render_cpu_time;
+  size_t peak_working_set = 0;
 
   for (int i = 0; i < iterations; ++i) {
     PipelineIntegrationTestBase pipeline;
+    PlaybackProbe probe;
+    pipeline.set_paint_cb(
+        base::Bind(&PlaybackProbe::OnPaint, base::Unretained(&probe)));
 
     ASSERT_TRUE(pipeline.Start(GetTestDataFilePath(filename),
                                PIPELINE_OK,
                                PipelineIntegrationTestBase::kClockless));
 
+    probe.Start();
     base::TimeTicks start = base::TimeTicks::HighResNow();
+    base::TimeTicks cpu_start = ThreadNow();
     pipeline.Play();
 
     ASSERT_TRUE(pipeline.WaitUntilOnEnded());
 
     // Call Stop() to ensure that the rendering is complete.
     pipeline.Stop();
+    probe.Stop();
+
+    // Decoding, video rendering and frame conversion all happen on this
+    // thread.
+    main_thread_cpu_time += ThreadNow() - cpu_start;
+    convert_cpu_time += probe.convert_time();
+    audio_render_cpu_time += pipeline.GetAudioRenderCpuTime();
+    peak_working_set = std::max(peak_working_set, probe.peak_working_set());
+
+    PipelineStatistics stats = pipeline.GetStatistics();
+    video_frames_decoded += stats.video_frames_decoded;
+    video_frames_dropped += stats.video_frames_dropped;
 
     if (audio_only) {
       time_seconds += pipeline.GetAudioTime().InSecondsF();
@@ -45,6 +247,48 @@ static void RunPlaybackBenchmark(const std::string& filename,
                          iterations / time_seconds,
                          "runs/s",
                          true);
+
+  // Clockless playback renders as fast as the frames are decoded, so this is
+  // the decode throughput.
+  if (!audio_only) {
+    perf_test::PrintResult(name,
+                           "_decode",
+                           filename,
+                           video_frames_decoded / time_seconds,
+                           "frames/s",
+                           true);
+    perf_test::PrintResult(name,
+                           "_frames_dropped",
+                           filename,
+                           static_cast<double>(video_frames_dropped) /
+                               iterations,
+                           "frames",
+                           true);
+  }
+
+  // Per-stage CPU time, per run.
+  perf_test::PrintResult(
+      name, "_cpu_demux", filename,
+      1000 * MeasureDemuxCpuSeconds(filename, iterations) / iterations,
+      "ms", false);
+  if (base::TimeTicks::IsThreadNowSupported()) {
+    perf_test::PrintResult(
+        name, "_cpu_decode", filename,
+        (main_thread_cpu_time - convert_cpu_time).InMillisecondsF() /
+            iterations,
+        "ms", false);
+    if (!audio_only) {
+      perf_test::PrintResult(name, "_cpu_convert", filename,
+                             convert_cpu_time.InMillisecondsF() / iterations,
+                             "ms", false);
+    }
+    perf_test::PrintResult(name, "_cpu_audio_render", filename,
+                           audio_render_cpu_time.InMillisecondsF() / iterations,
+                           "ms", false);
+  }
+
+  perf_test::PrintResult(name, "_memory_high_water", filename,
+                         peak_working_set / 1024.0, "KB", false);
 }
 
 static void RunVideoPlaybackBenchmark(const std::string& filename,
@@ -62,20 +306,29 @@ TEST(PipelineIntegrationPerfTest, AudioPlaybackBenchmark) {
   RunAudioPlaybackBenchmark("sfx_s24le.wav", "clockless_playback");
   RunAudioPlaybackBenchmark("sfx_s16le.wav", "clockless_playback");
   RunAudioPlaybackBenchmark("sfx_u8.wav", "clockless_playback");
+  RunAudioPlaybackBenchmark("sfx.ogg", "clockless_playback");
+  RunAudioPlaybackBenchmark("bear-320x240-audio-only.webm",
+                            "clockless_playback");
 #if defined(USE_PROPRIETARY_CODECS)
   RunAudioPlaybackBenchmark("sfx.mp3", "clockless_playback");
 #endif
 }
 
 TEST(PipelineIntegrationPerfTest, VP8PlaybackBenchmark) {
-  RunVideoPlaybackBenchmark("bear-640x360.webm",
+  RunVideoPlaybackBenchmark("bear-320x240-video-only.webm",
                             "clockless_video_playback_vp8");
   RunVideoPlaybackBenchmark("bear-320x240.webm",
                             "clockless_video_playback_vp8");
+  RunVideoPlaybackBenchmark("bear-640x360.webm",
+                            "clockless_video_playback_vp8");
+  RunVideoPlaybackBenchmark("bear-vp8a.webm",
+                            "clockless_video_playback_vp8a");
 }
 
 TEST(PipelineIntegrationPerfTest, VP9PlaybackBenchmark) {
   RunVideoPlaybackBenchmark("bear-vp9.webm", "clockless_video_playback_vp9");
+  RunVideoPlaybackBenchmark("bear-vp9-opus.webm",
+                            "clockless_video_playback_vp9");
 }
 
 TEST(PipelineIntegrationPerfTest, TheoraPlaybackBenchmark) {
@@ -84,6 +337,8 @@ TEST(PipelineIntegrationPerfTest, TheoraPlaybackBenchmark) {
 
 #if defined(USE_PROPRIETARY_CODECS)
 TEST(PipelineIntegrationPerfTest, MP4PlaybackBenchmark) {
+  RunVideoPlaybackBenchmark("bear-640x360-av_frag.mp4",
+                            "clockless_video_playback_mp4");
   RunVideoPlaybackBenchmark("bear-1280x720.mp4",
                             "clockless_video_playback_mp4");
 }
@@ -294,6 +294,8 @@ void PipelineIntegrationTestBase::SetDecryptor(
 void PipelineIntegrationTestBase::OnVideoRendererPaint(
     const scoped_refptr<VideoFrame>& frame) {
   last_video_frame_format_ = frame->format();
+  if (!paint_cb_.is_null())
+    paint_cb_.Run(frame);
   if (!hashing_enabled_)
     return;
   frame->HashFrameForTesting(&md5_context_);
@@ -316,6 +318,15 @@ base::TimeDelta PipelineIntegrationTestBase::GetAudioTime() {
   return clockless_audio_sink_->render_time();
 }
 
+base::TimeDelta PipelineIntegrationTestBase::GetAudioRenderCpuTime() {
+  DCHECK(clockless_playback_);
+  return clockless_audio_sink_->render_cpu_time();
+}
+
+PipelineStatistics PipelineIntegrationTestBase::GetStatistics() const {
+  return pipeline_->GetStatistics();
+}
+
 base::TimeTicks DummyTickClock::NowTicks() {
   now_ += base::TimeDelta::FromSeconds(60);
   return now_;
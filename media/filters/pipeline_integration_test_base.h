@@ -94,6 +94,19 @@ class PipelineIntegrationTestBase {
   // Pipeline must have been started with clockless playback enabled.
   base::TimeDelta GetAudioTime();
 
+  // Returns the CPU time spent rendering the audio file. Pipeline must have
+  // been started with clockless playback enabled.
+  base::TimeDelta GetAudioRenderCpuTime();
+
+  // Runs |paint_cb| for every video frame painted. Used by benchmarks to add
+  // the work done downstream of the video renderer.
+  void set_paint_cb(const VideoRendererImpl::PaintCB& paint_cb) {
+    paint_cb_ = paint_cb;
+  }
+
+  // Returns the statistics of the pipeline, e.g. the number of frames decoded.
+  PipelineStatistics GetStatistics() const;
+
  protected:
   base::MessageLoop message_loop_;
   base::MD5Context md5_context_;
@@ -109,6 +122,7 @@ class PipelineIntegrationTestBase {
   Demuxer::NeedKeyCB need_key_cb_;
   VideoFrame::Format last_video_frame_format_;
   DummyTickClock dummy_clock_;
+  VideoRendererImpl::PaintCB paint_cb_;
 
   void OnStatusCallbackChecked(PipelineStatus expected_status,
                                PipelineStatus status);
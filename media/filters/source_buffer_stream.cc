@@ -327,6 +327,14 @@ static base::TimeDelta kSeekToStartFudgeRoom() {
 static int kDefaultAudioMemoryLimit = 12 * 1024 * 1024;
 static int kDefaultVideoMemoryLimit = 150 * 1024 * 1024;
 
+// Once a stream holds more than 1 / kPlayedDataLimitDivisor of its memory
+// limit, data played more than kPlayedDataToKeep ago is freed a little on
+// each append instead of all at once when the memory limit is reached.
+static const int kPlayedDataLimitDivisor = 2;
+static base::TimeDelta kPlayedDataToKeep() {
+  return base::TimeDelta::FromSeconds(30);
+}
+
 namespace media {
 
 SourceBufferStream::SourceBufferStream(const AudioDecoderConfig& audio_config,
@@ -554,7 +562,12 @@ bool SourceBufferStream::Append(
 
   SetSelectedRangeIfNeeded(next_buffer_timestamp);
 
-  GarbageCollectIfNeeded();
+  int bytes_appended = 0;
+  for (BufferQueue::const_iterator itr = buffers.begin();
+       itr != buffers.end(); ++itr) {
+    bytes_appended += (*itr)->data_size();
+  }
+  GarbageCollectIfNeeded(bytes_appended);
 
   DCHECK(IsRangeListSorted(ranges_));
   DCHECK(OnlySelectedRangeIsSeeked());
@@ -767,11 +780,13 @@ void SourceBufferStream::SetConfigIds(const BufferQueue& buffers) {
   }
 }
 
-void SourceBufferStream::GarbageCollectIfNeeded() {
-  // Compute size of |ranges_|.
-  int ranges_size = 0;
-  for (RangeList::iterator itr = ranges_.begin(); itr != ranges_.end(); ++itr)
-    ranges_size += (*itr)->size_in_bytes();
+void SourceBufferStream::GarbageCollectIfNeeded(int bytes_appended) {
+  int ranges_size = GetBufferedSize();
+
+  // Free twice as much played data as was appended so that streams which play
+  // for a long time, e.g. live streams, settle well below the memory limit.
+  if (ranges_size > memory_limit_ / kPlayedDataLimitDivisor)
+    ranges_size -= FreePlayedBuffers(2 * bytes_appended);
 
   // Return if we're under or at the memory limit.
   if (ranges_size <= memory_limit_)
@@ -819,6 +834,32 @@ int SourceBufferStream::FreeBuffersAfterLastAppended(int total_bytes_to_free) {
   return bytes_freed;
 }
 
+int SourceBufferStream::FreePlayedBuffers(int total_bytes_to_free) {
+  base::TimeDelta next_buffer_timestamp = GetNextBufferTimestamp();
+  if (ranges_.empty() || total_bytes_to_free <= 0 ||
+      next_buffer_timestamp == kNoTimestamp()) {
+    return 0;
+  }
+
+  base::TimeDelta remove_range_start = ranges_.front()->GetStartTimestamp();
+  base::TimeDelta remove_range_end =
+      next_buffer_timestamp - kPlayedDataToKeep();
+  if (last_appended_buffer_timestamp_ != kNoTimestamp() &&
+      last_appended_buffer_timestamp_ < remove_range_end) {
+    remove_range_end = last_appended_buffer_timestamp_;
+  }
+  if (remove_range_start >= remove_range_end)
+    return 0;
+
+  base::TimeDelta removal_end_timestamp;
+  int bytes_freed = GetRemovalRange(
+      remove_range_start, remove_range_end, total_bytes_to_free,
+      &removal_end_timestamp);
+  if (bytes_freed > 0)
+    Remove(remove_range_start, removal_end_timestamp, next_buffer_timestamp);
+  return bytes_freed;
+}
+
 int SourceBufferStream::GetRemovalRange(
     base::TimeDelta start_timestamp, base::TimeDelta end_timestamp,
     int total_bytes_to_free, base::TimeDelta* removal_end_timestamp) {
@@ -1272,6 +1313,15 @@ Ranges<base::TimeDelta> SourceBufferStream::GetBufferedTime() const {
   return ranges;
 }
 
+int SourceBufferStream::GetBufferedSize() const {
+  int ranges_size = 0;
+  for (RangeList::const_iterator itr = ranges_.begin(); itr != ranges_.end();
+       ++itr) {
+    ranges_size += (*itr)->size_in_bytes();
+  }
+  return ranges_size;
+}
+
 base::TimeDelta SourceBufferStream::GetBufferedDuration() const {
   if (ranges_.empty())
     return base::TimeDelta();
@@ -108,6 +108,9 @@ class MEDIA_EXPORT SourceBufferStream {
   // Returns a list of the buffered time ranges.
   Ranges<base::TimeDelta> GetBufferedTime() const;
 
+  // Returns the number of bytes of buffered data.
+  int GetBufferedSize() const;
+
   // Returns the duration of the buffered ranges, which is equivalent
   // to the end timestamp of the last buffered range. If no data is buffered
   // then base::TimeDelta() is returned.
@@ -146,7 +149,14 @@ class MEDIA_EXPORT SourceBufferStream {
   typedef std::list<SourceBufferRange*> RangeList;
 
   // Frees up space if the SourceBufferStream is taking up too much memory.
-  void GarbageCollectIfNeeded();
+  // |bytes_appended| is the size of the buffers just appended.
+  void GarbageCollectIfNeeded(int bytes_appended);
+
+  // Attempts to delete approximately |total_bytes_to_free| amount of data from
+  // the front of |ranges_|, leaving everything within kPlayedDataToKeep of the
+  // current playback position and the GOP last appended to. Returns the number
+  // of bytes freed.
+  int FreePlayedBuffers(int total_bytes_to_free);
 
   // Attempts to delete approximately |total_bytes_to_free| amount of data
   // |ranges_|, starting at the front of |ranges_| and moving linearly forward
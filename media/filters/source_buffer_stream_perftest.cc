@@ -0,0 +1,77 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/time/time.h"
+#include "media/base/decoder_buffer_slab.h"
+#include "media/base/media_log.h"
+#include "media/base/test_helpers.h"
+#include "media/filters/source_buffer_stream.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+
+namespace media {
+
+// Ten minutes of 2Mbps, 30fps video with a keyframe every two seconds,
+// appended a second at a time while playback follows ten seconds behind.
+static const int kFramesPerSecond = 30;
+static const int kFramesPerKeyframe = 60;
+static const int kFrameSize = 2 * 1024 * 1024 / 8 / kFramesPerSecond;
+static const int kSecondsToAppend = 10 * 60;
+static const int kPlaybackLagInSeconds = 10;
+
+static void LogFunc(const std::string& str) {}
+
+static void RunAppendBenchmark(const std::string& trace_name,
+                               bool use_slab_allocator) {
+  SourceBufferStream stream(TestVideoConfig::Normal(), base::Bind(&LogFunc));
+  DecoderBufferSlabAllocator allocator(1024 * 1024);
+  std::vector<uint8> data(kFrameSize, 0x11);
+  const base::TimeDelta frame_duration =
+      base::TimeDelta::FromSeconds(1) / kFramesPerSecond;
+
+  int max_buffered_size = 0;
+  int frame = 0;
+  stream.OnNewMediaSegment(base::TimeDelta());
+  stream.Seek(base::TimeDelta());
+  base::TimeTicks start = base::TimeTicks::HighResNow();
+  for (int second = 0; second < kSecondsToAppend; ++second) {
+    SourceBufferStream::BufferQueue buffers;
+    for (int i = 0; i < kFramesPerSecond; ++i, ++frame) {
+      scoped_refptr<StreamParserBuffer> buffer = StreamParserBuffer::CopyFrom(
+          &data[0], data.size(), NULL, 0, frame % kFramesPerKeyframe == 0,
+          DemuxerStream::VIDEO, 0,
+          use_slab_allocator ? &allocator : NULL);
+      buffer->set_timestamp(frame * frame_duration);
+      buffer->set_duration(frame_duration);
+      buffers.push_back(buffer);
+    }
+    ASSERT_TRUE(stream.Append(buffers));
+    max_buffered_size = std::max(max_buffered_size, stream.GetBufferedSize());
+
+    // Play a second of video once playback has fallen far enough behind.
+    if (second < kPlaybackLagInSeconds)
+      continue;
+    scoped_refptr<StreamParserBuffer> buffer;
+    for (int i = 0; i < kFramesPerSecond; ++i)
+      ASSERT_EQ(SourceBufferStream::kSuccess, stream.GetNextBuffer(&buffer));
+  }
+  double total_time_milliseconds =
+      (base::TimeTicks::HighResNow() - start).InMillisecondsF();
+
+  perf_test::PrintResult("append_throughput", "", trace_name,
+                         frame / total_time_milliseconds, "buffers/ms", true);
+  perf_test::PrintResult("max_buffered_size", "", trace_name,
+                         max_buffered_size / 1024.0, "KB", true);
+}
+
+TEST(SourceBufferStreamPerfTest, Append) {
+  RunAppendBenchmark("malloc", false);
+  RunAppendBenchmark("slab", true);
+}
+
+}  // namespace media
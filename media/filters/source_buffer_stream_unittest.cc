@@ -2644,6 +2644,41 @@ TEST_F(SourceBufferStreamTest, DISABLED_GarbageCollection_WaitingForKeyframe) {
   CheckExpectedRanges("{ [15,15) [20,28) }");
 }
 
+TEST_F(SourceBufferStreamTest, GarbageCollection_PlayedData) {
+  // One keyframe per second.
+  SetStreamInfo(1, 1);
+  SetMemoryLimit(100);
+
+  // Append 60 seconds of data and play past the first 50 of them.
+  NewSegmentAppend(0, 60, &kDataA);
+  Seek(50);
+  CheckExpectedRanges("{ [0,59) }");
+
+  // Each append frees twice its size of data played over 30 seconds ago.
+  AppendBuffers(60, 1, &kDataA);
+  CheckExpectedRanges("{ [2,60) }");
+  AppendBuffers(61, 2, &kDataA);
+  CheckExpectedRanges("{ [6,62) }");
+
+  // Data within 30 seconds of the playback position is kept.
+  AppendBuffers(63, 10, &kDataA);
+  CheckExpectedRanges("{ [20,72) }");
+  CheckExpectedBuffers(50, 72, &kDataA);
+  Seek(20);
+  CheckExpectedBuffers(20, 49, &kDataA);
+}
+
+TEST_F(SourceBufferStreamTest, GarbageCollection_PlayedDataUnderLimit) {
+  SetStreamInfo(1, 1);
+  SetMemoryLimit(200);
+
+  // Played data is kept while the stream holds less than half its limit.
+  NewSegmentAppend(0, 60, &kDataA);
+  Seek(50);
+  AppendBuffers(60, 10, &kDataA);
+  CheckExpectedRanges("{ [0,69) }");
+}
+
 // Test the performance of garbage collection.
 TEST_F(SourceBufferStreamTest, GarbageCollection_Performance) {
   // Force |keyframes_per_second_| to be equal to kDefaultFramesPerSecond.
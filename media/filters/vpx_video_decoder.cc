@@ -6,15 +6,20 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/callback_helpers.h"
 #include "base/command_line.h"
 #include "base/location.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
 #include "base/single_thread_task_runner.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/sys_byteorder.h"
+#include "base/synchronization/lock.h"
+#include "base/sys_info.h"
+#include "base/threading/thread.h"
 #include "media/base/bind_to_current_loop.h"
 #include "media/base/decoder_buffer.h"
 #include "media/base/demuxer_stream.h"
@@ -31,6 +36,7 @@
 extern "C" {
 #include "third_party/libvpx/source/libvpx/vpx/vpx_decoder.h"
 #include "third_party/libvpx/source/libvpx/vpx/vp8dx.h"
+#include "third_party/libvpx/source/libvpx/vpx/vpx_frame_buffer.h"
 }
 
 namespace media {
@@ -41,7 +47,11 @@ namespace media {
 static const int kDecodeThreads = 2;
 static const int kMaxDecodeThreads = 16;
 
-// Returns the number of threads.
+// Streams at least this wide are decoded on a thread of their own, so that a
+// slow frame does not hold up the media thread.
+static const int kDecodeThreadMinWidth = 1280;
+
+// Returns the number of threads, up to the number of cores.
 static int GetThreadCount(const VideoDecoderConfig& config) {
   // Refer to http://crbug.com/93932 for tsan suppressions on decoding.
   int decode_threads = kDecodeThreads;
@@ -53,13 +63,17 @@ static int GetThreadCount(const VideoDecoderConfig& config) {
       // For VP9 decode when using the default thread count, increase the number
       // of decode threads to equal the maximum number of tiles possible for
       // higher resolution streams.
-      if (config.coded_size().width() >= 2048)
+      if (config.coded_size().width() >= 4096)
+        decode_threads = 16;
+      else if (config.coded_size().width() >= 2048)
         decode_threads = 8;
       else if (config.coded_size().width() >= 1024)
         decode_threads = 4;
     }
 
-    return decode_threads;
+    return std::max(kDecodeThreads,
+                    std::min(decode_threads,
+                             base::SysInfo::NumberOfProcessors()));
   }
 
   decode_threads = std::max(decode_threads, 0);
@@ -67,6 +81,108 @@ static int GetThreadCount(const VideoDecoderConfig& config) {
   return decode_threads;
 }
 
+// Frame buffers that libvpx decodes VP9 into, and that the decoded
+// VideoFrames then wrap instead of copying the planes out. A buffer is reused
+// once libvpx no longer refers to it and the frames wrapping it are destroyed,
+// which may happen on any thread.
+class VpxVideoDecoder::MemoryPool
+    : public base::RefCountedThreadSafe<VpxVideoDecoder::MemoryPool> {
+ public:
+  MemoryPool() {}
+
+  // vpx_get_frame_buffer_cb_fn_t for the pool passed as |user_priv|. Sets |fb|
+  // to a buffer of at least |min_size| bytes. Returns 0 on success.
+  static int GetVP9FrameBuffer(void* user_priv,
+                               size_t min_size,
+                               vpx_codec_frame_buffer* fb);
+
+  // vpx_release_frame_buffer_cb_fn_t for the pool passed as |user_priv|.
+  static int ReleaseVP9FrameBuffer(void* user_priv,
+                                   vpx_codec_frame_buffer* fb);
+
+  // Returns a callback that keeps the buffer |fb_priv| from being reused until
+  // it is run, for the VideoFrame wrapping it to run on destruction.
+  base::Closure CreateFrameCallback(void* fb_priv);
+
+ private:
+  friend class base::RefCountedThreadSafe<VpxVideoDecoder::MemoryPool>;
+  ~MemoryPool() {}
+
+  struct VP9FrameBuffer {
+    VP9FrameBuffer() : ref_count(0) {}
+    std::vector<uint8> data;
+    // References held by libvpx and by VideoFrames.
+    int ref_count;
+  };
+
+  void Release(VP9FrameBuffer* frame_buffer);
+
+  base::Lock lock_;
+  ScopedVector<VP9FrameBuffer> frame_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryPool);
+};
+
+// static
+int VpxVideoDecoder::MemoryPool::GetVP9FrameBuffer(
+    void* user_priv,
+    size_t min_size,
+    vpx_codec_frame_buffer* fb) {
+  DCHECK(user_priv);
+  DCHECK(fb);
+  MemoryPool* pool = static_cast<MemoryPool*>(user_priv);
+  base::AutoLock auto_lock(pool->lock_);
+
+  VP9FrameBuffer* frame_buffer = NULL;
+  for (size_t i = 0; i < pool->frame_buffers_.size(); ++i) {
+    if (!pool->frame_buffers_[i]->ref_count) {
+      frame_buffer = pool->frame_buffers_[i];
+      break;
+    }
+  }
+  if (!frame_buffer) {
+    frame_buffer = new VP9FrameBuffer();
+    pool->frame_buffers_.push_back(frame_buffer);
+  }
+  if (frame_buffer->data.size() < min_size)
+    frame_buffer->data.resize(min_size);
+
+  frame_buffer->ref_count = 1;
+  fb->data = &frame_buffer->data[0];
+  fb->size = frame_buffer->data.size();
+  fb->priv = frame_buffer;
+  return 0;
+}
+
+// static
+int VpxVideoDecoder::MemoryPool::ReleaseVP9FrameBuffer(
+    void* user_priv,
+    vpx_codec_frame_buffer* fb) {
+  DCHECK(user_priv);
+  DCHECK(fb);
+  // libvpx releases buffers it never got when it fails to decode a frame.
+  if (!fb->priv)
+    return 0;
+  static_cast<MemoryPool*>(user_priv)->Release(
+      static_cast<VP9FrameBuffer*>(fb->priv));
+  return 0;
+}
+
+base::Closure VpxVideoDecoder::MemoryPool::CreateFrameCallback(void* fb_priv) {
+  VP9FrameBuffer* frame_buffer = static_cast<VP9FrameBuffer*>(fb_priv);
+  {
+    base::AutoLock auto_lock(lock_);
+    ++frame_buffer->ref_count;
+  }
+  return base::Bind(&MemoryPool::Release, this, frame_buffer);
+}
+
+void VpxVideoDecoder::MemoryPool::Release(VP9FrameBuffer* frame_buffer) {
+  base::AutoLock auto_lock(lock_);
+  DCHECK_GT(frame_buffer->ref_count, 0);
+  --frame_buffer->ref_count;
+}
+
 VpxVideoDecoder::VpxVideoDecoder(
     const scoped_refptr<base::SingleThreadTaskRunner>& task_runner)
     : task_runner_(task_runner),
@@ -148,10 +264,32 @@ bool VpxVideoDecoder::ConfigureDecoder(const VideoDecoderConfig& config) {
       return false;
   }
 
+  // Only the VP9 decoder can decode into external frame buffers.
+  if (config.codec() == kCodecVP9 && !vpx_codec_alpha_) {
+    memory_pool_ = new MemoryPool();
+    if (vpx_codec_set_frame_buffer_functions(
+            vpx_codec_,
+            &MemoryPool::GetVP9FrameBuffer,
+            &MemoryPool::ReleaseVP9FrameBuffer,
+            memory_pool_.get())) {
+      LOG(ERROR) << "Failed to configure external buffers.";
+      return false;
+    }
+  }
+
+  if (config.coded_size().width() >= kDecodeThreadMinWidth) {
+    decode_thread_.reset(new base::Thread("VpxVideoDecodeThread"));
+    if (!decode_thread_->Start())
+      decode_thread_.reset();
+  }
+
   return true;
 }
 
 void VpxVideoDecoder::CloseDecoder() {
+  // Waits for a decode in progress on |decode_thread_| to finish with the
+  // contexts before they are destroyed.
+  decode_thread_.reset();
   if (vpx_codec_) {
     vpx_codec_destroy(vpx_codec_);
     delete vpx_codec_;
@@ -162,6 +300,8 @@ void VpxVideoDecoder::CloseDecoder() {
     delete vpx_codec_alpha_;
     vpx_codec_alpha_ = NULL;
   }
+  // Frames still wrapping buffers from the pool keep it alive.
+  memory_pool_ = NULL;
 }
 
 void VpxVideoDecoder::Decode(const scoped_refptr<DecoderBuffer>& buffer,
@@ -213,6 +353,8 @@ void VpxVideoDecoder::Stop(const base::Closure& closure) {
       base::ResetAndReturn(&reset_cb_).Run();
   }
 
+  // Drops the result of a decode still running on |decode_thread_|.
+  weak_factory_.InvalidateWeakPtrs();
   state_ = kUninitialized;
 }
 
@@ -236,8 +378,47 @@ void VpxVideoDecoder::DecodeBuffer(const scoped_refptr<DecoderBuffer>& buffer) {
     return;
   }
 
+  if (decode_thread_) {
+    // |this| outlives the task, since CloseDecoder() joins the thread.
+    bool* success = new bool(false);
+    scoped_refptr<VideoFrame>* video_frame = new scoped_refptr<VideoFrame>();
+    decode_thread_->message_loop_proxy()->PostTaskAndReply(
+        FROM_HERE,
+        base::Bind(&VpxVideoDecoder::DecodeOnDecodeThread,
+                   base::Unretained(this), buffer, success, video_frame),
+        base::Bind(&VpxVideoDecoder::OnDecodeThreadDone, weak_this_,
+                   base::Owned(success), base::Owned(video_frame)));
+    return;
+  }
+
   scoped_refptr<VideoFrame> video_frame;
-  if (!VpxDecode(buffer, &video_frame)) {
+  bool success = VpxDecode(buffer, &video_frame);
+  DeliverFrame(success, video_frame);
+}
+
+void VpxVideoDecoder::DecodeOnDecodeThread(
+    const scoped_refptr<DecoderBuffer>& buffer,
+    bool* success,
+    scoped_refptr<VideoFrame>* video_frame) {
+  *success = VpxDecode(buffer, video_frame);
+}
+
+void VpxVideoDecoder::OnDecodeThreadDone(
+    bool* success,
+    scoped_refptr<VideoFrame>* video_frame) {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+  DeliverFrame(*success, *video_frame);
+
+  // Reset() waits for the decode to complete.
+  if (!reset_cb_.is_null())
+    DoReset();
+}
+
+void VpxVideoDecoder::DeliverFrame(
+    bool success,
+    const scoped_refptr<VideoFrame>& video_frame) {
+  DCHECK(!decode_cb_.is_null());
+  if (!success) {
     state_ = kError;
     base::ResetAndReturn(&decode_cb_).Run(kDecodeError, NULL);
     return;
@@ -342,6 +523,25 @@ void VpxVideoDecoder::CopyVpxImageTo(const vpx_image* vpx_image,
 
   gfx::Size size(vpx_image->d_w, vpx_image->d_h);
 
+  if (memory_pool_) {
+    // Wrap the buffer libvpx decoded into, instead of copying it.
+    DCHECK(!vpx_codec_alpha_);
+    *video_frame = VideoFrame::WrapExternalYuvData(
+        VideoFrame::YV12,
+        size,
+        gfx::Rect(size),
+        config_.natural_size(),
+        vpx_image->stride[VPX_PLANE_Y],
+        vpx_image->stride[VPX_PLANE_U],
+        vpx_image->stride[VPX_PLANE_V],
+        vpx_image->planes[VPX_PLANE_Y],
+        vpx_image->planes[VPX_PLANE_U],
+        vpx_image->planes[VPX_PLANE_V],
+        kNoTimestamp(),
+        memory_pool_->CreateFrameCallback(vpx_image->fb_priv));
+    return;
+  }
+
   *video_frame = frame_pool_.CreateFrame(
       vpx_codec_alpha_ ? VideoFrame::YV12A : VideoFrame::YV12,
       size,
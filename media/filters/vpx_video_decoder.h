@@ -6,6 +6,8 @@
 #define MEDIA_FILTERS_VPX_VIDEO_DECODER_H_
 
 #include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "media/base/demuxer_stream.h"
 #include "media/base/video_decoder.h"
@@ -18,6 +20,7 @@ struct vpx_image;
 
 namespace base {
 class SingleThreadTaskRunner;
+class Thread;
 }
 
 namespace media {
@@ -42,6 +45,8 @@ class MEDIA_EXPORT VpxVideoDecoder : public VideoDecoder {
   virtual bool HasAlpha() const OVERRIDE;
 
  private:
+  class MemoryPool;
+
   enum DecoderState {
     kUninitialized,
     kNormal,
@@ -57,6 +62,18 @@ class MEDIA_EXPORT VpxVideoDecoder : public VideoDecoder {
   void CloseDecoder();
 
   void DecodeBuffer(const scoped_refptr<DecoderBuffer>& buffer);
+
+  // Decodes |buffer| on |decode_thread_|, and delivers the result back on
+  // |task_runner_|.
+  void DecodeOnDecodeThread(const scoped_refptr<DecoderBuffer>& buffer,
+                            bool* success,
+                            scoped_refptr<VideoFrame>* video_frame);
+  void OnDecodeThreadDone(bool* success,
+                          scoped_refptr<VideoFrame>* video_frame);
+
+  // Runs |decode_cb_| with the result of VpxDecode().
+  void DeliverFrame(bool success, const scoped_refptr<VideoFrame>& video_frame);
+
   bool VpxDecode(const scoped_refptr<DecoderBuffer>& buffer,
                  scoped_refptr<VideoFrame>* video_frame);
 
@@ -81,6 +98,14 @@ class MEDIA_EXPORT VpxVideoDecoder : public VideoDecoder {
   vpx_codec_ctx* vpx_codec_;
   vpx_codec_ctx* vpx_codec_alpha_;
 
+  // Decodes large frames off the media thread. NULL for smaller streams,
+  // which are decoded on |task_runner_|.
+  scoped_ptr<base::Thread> decode_thread_;
+
+  // Buffers VP9 frames are decoded into and handed out without copying.
+  // NULL for VP8, whose frames are copied into |frame_pool_|.
+  scoped_refptr<MemoryPool> memory_pool_;
+
   VideoFramePool frame_pool_;
 
   DISALLOW_COPY_AND_ASSIGN(VpxVideoDecoder);
@@ -25,6 +25,10 @@ namespace mp4 {
 // TODO(xhwang): Figure out the init data type appropriately once it's spec'ed.
 static const char kMp4InitDataType[] = "video/mp4";
 
+// Sizes of the slabs which samples are packed into.
+static const int kAudioSlabSize = 64 * 1024;
+static const int kVideoSlabSize = 1024 * 1024;
+
 MP4StreamParser::MP4StreamParser(const std::set<int>& audio_object_types,
                                  bool has_sbr)
     : state_(kWaitingForInit),
@@ -37,7 +41,9 @@ MP4StreamParser::MP4StreamParser(const std::set<int>& audio_object_types,
       audio_object_types_(audio_object_types),
       has_sbr_(has_sbr),
       is_audio_track_encrypted_(false),
-      is_video_track_encrypted_(false) {
+      is_video_track_encrypted_(false),
+      audio_slab_allocator_(kAudioSlabSize),
+      video_slab_allocator_(kVideoSlabSize) {
 }
 
 MP4StreamParser::~MP4StreamParser() {}
@@ -505,8 +511,10 @@ bool MP4StreamParser::EnqueueSample(BufferQueue* audio_buffers,
   // type and allow multiple tracks for same media type, if applicable. See
   // https://crbug.com/341581.
   scoped_refptr<StreamParserBuffer> stream_buf =
-      StreamParserBuffer::CopyFrom(&frame_buf[0], frame_buf.size(),
-                                   runs_->is_keyframe(), buffer_type, 0);
+      StreamParserBuffer::CopyFrom(&frame_buf[0], frame_buf.size(), NULL, 0,
+                                   runs_->is_keyframe(), buffer_type, 0,
+                                   audio ? &audio_slab_allocator_
+                                         : &video_slab_allocator_);
 
   if (decrypt_config)
     stream_buf->set_decrypt_config(decrypt_config.Pass());
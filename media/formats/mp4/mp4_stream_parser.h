@@ -12,6 +12,7 @@
 #include "base/callback.h"
 #include "base/compiler_specific.h"
 #include "base/memory/scoped_ptr.h"
+#include "media/base/decoder_buffer_slab.h"
 #include "media/base/media_export.h"
 #include "media/base/stream_parser.h"
 #include "media/formats/common/offset_byte_queue.h"
@@ -112,6 +113,11 @@ class MEDIA_EXPORT MP4StreamParser : public StreamParser {
   bool is_audio_track_encrypted_;
   bool is_video_track_encrypted_;
 
+  // Pack the samples of each track into shared slabs, so that parsing a
+  // fragment doesn't allocate memory for each sample.
+  DecoderBufferSlabAllocator audio_slab_allocator_;
+  DecoderBufferSlabAllocator video_slab_allocator_;
+
   DISALLOW_COPY_AND_ASSIGN(MP4StreamParser);
 };
 
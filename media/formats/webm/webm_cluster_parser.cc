@@ -17,6 +17,11 @@
 
 namespace media {
 
+// Sizes of the slabs which frames are packed into.  A slab holds a few seconds
+// of typical audio or video, so little memory is held by partly freed slabs.
+static const int kAudioSlabSize = 64 * 1024;
+static const int kVideoSlabSize = 1024 * 1024;
+
 WebMClusterParser::WebMClusterParser(
     int64 timecode_scale, int audio_track_num, int video_track_num,
     const WebMTracksParser::TextTracks& text_tracks,
@@ -40,6 +45,8 @@ WebMClusterParser::WebMClusterParser(
       cluster_ended_(false),
       audio_(audio_track_num, false),
       video_(video_track_num, true),
+      audio_slab_allocator_(kAudioSlabSize),
+      video_slab_allocator_(kVideoSlabSize),
       log_cb_(log_cb) {
   for (WebMTracksParser::TextTracks::const_iterator it = text_tracks.begin();
        it != text_tracks.end();
@@ -349,7 +356,9 @@ bool WebMClusterParser::OnBlock(bool is_simple_block, int track_num,
     buffer = StreamParserBuffer::CopyFrom(
         data + data_offset, size - data_offset,
         additional, additional_size,
-        is_keyframe, buffer_type, track_num);
+        is_keyframe, buffer_type, track_num,
+        buffer_type == DemuxerStream::AUDIO ? &audio_slab_allocator_
+                                            : &video_slab_allocator_);
 
     if (decrypt_config)
       buffer->set_decrypt_config(decrypt_config.Pass());
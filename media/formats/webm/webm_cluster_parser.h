@@ -11,6 +11,7 @@
 #include <string>
 
 #include "base/memory/scoped_ptr.h"
+#include "media/base/decoder_buffer_slab.h"
 #include "media/base/media_export.h"
 #include "media/base/media_log.h"
 #include "media/base/stream_parser.h"
@@ -140,6 +141,12 @@ class MEDIA_EXPORT WebMClusterParser : public WebMParserClient {
   Track video_;
   TextTrackMap text_track_map_;
 
+  // Pack the frames of each track into shared slabs, so that parsing a cluster
+  // doesn't allocate memory for each frame.  Audio and video buffers are
+  // garbage collected separately, so they don't share slabs.
+  DecoderBufferSlabAllocator audio_slab_allocator_;
+  DecoderBufferSlabAllocator video_slab_allocator_;
+
   // Subset of |text_track_map_| maintained by GetTextBuffers(), and cleared by
   // ResetTextTracks(). Callers of GetTextBuffers() get a const-ref to this
   // member.
@@ -24,6 +24,13 @@ class WaiterList;
 // Its subclasses implement the three cases: local producer and consumer, local
 // producer and remote consumer, and remote producer and local consumer. This
 // class is thread-safe.
+//
+// TODO(vtl): Only |LocalDataPipe| exists so far, since |Channel| cannot yet
+// transport handles (see |Channel::OnReadMessageForDownstream()|). The remote
+// cases should keep the circular buffer and both indices in shared memory
+// mapped by each side, so that two-phase reads and writes go straight to the
+// shared buffer and only "data available"/"space available" notifications go
+// over the channel.
 class MOJO_SYSTEM_IMPL_EXPORT DataPipe :
     public base::RefCountedThreadSafe<DataPipe> {
  public:
@@ -6,6 +6,7 @@
 
 #include <errno.h>
 #include <string.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <algorithm>
@@ -30,7 +31,15 @@ namespace system {
 
 namespace {
 
+// The least free space we read into. The buffer starts out larger, so that a
+// single |read()| can pick up many small messages.
 const size_t kReadSize = 4096;
+const size_t kInitialReadBufferSize = 64 * 1024;
+
+// Queued messages are written with a single |writev()| of up to this many
+// messages and (unless the first message alone is larger) this many bytes.
+const size_t kMaxWriteBatchNumMessages = 64;
+const size_t kMaxWriteBatchNumBytes = 64 * 1024;
 
 class RawChannelPosix : public RawChannel,
                         public base::MessageLoopForIO::Watcher {
@@ -57,11 +66,12 @@ class RawChannelPosix : public RawChannel,
   // thread WITHOUT |write_lock_| held.
   void CallOnFatalError(Delegate::FatalError fatal_error);
 
-  // Writes the message at the front of |write_message_queue_|, starting at
-  // |write_message_offset_|. It removes and destroys if the write completes and
-  // otherwise updates |write_message_offset_|. Returns true on success. Must be
-  // called under |write_lock_|.
-  bool WriteFrontMessageNoLock();
+  // Writes messages from the front of |write_message_queue_| (the first one
+  // starting at |write_message_offset_|), in batches, until the queue is empty
+  // or the write would block. It removes and destroys the messages written
+  // completely and updates |write_message_offset_|. Returns true on success.
+  // Must be called under |write_lock_|.
+  bool WriteQueuedMessagesNoLock();
 
   // Cancels all pending writes and destroys the contents of
   // |write_message_queue_|. Should only be called if |write_stopped_| is false;
@@ -176,7 +186,7 @@ bool RawChannelPosix::WriteMessage(MessageInTransit* message) {
 
   write_message_queue_.push_front(message);
   DCHECK_EQ(write_message_offset_, 0u);
-  bool result = WriteFrontMessageNoLock();
+  bool result = WriteQueuedMessagesNoLock();
   DCHECK(result || write_message_queue_.empty());
 
   if (!result) {
@@ -212,26 +222,39 @@ void RawChannelPosix::OnFileCanReadWithoutBlocking(int fd) {
   // Currently, we copy data to ensure that this is zero at the beginning.
   size_t read_buffer_start = 0;
   for (;;) {
-    if (read_buffer_.size() - (read_buffer_start + read_buffer_num_valid_bytes_)
-            < kReadSize) {
+    // Make room for at least |kReadSize| bytes, or for the rest of the partial
+    // message at the start of the buffer if its header says it is larger (and
+    // the size is sane, so a bad header cannot make us allocate a lot).
+    size_t required_size = read_buffer_start + read_buffer_num_valid_bytes_ +
+                           kReadSize;
+    size_t message_size;
+    if (read_buffer_num_valid_bytes_ > 0 &&
+        MessageInTransit::GetNextMessageSize(&read_buffer_[read_buffer_start],
+                                             read_buffer_num_valid_bytes_,
+                                             &message_size) &&
+        message_size <= kMaxMessageNumBytes) {
+      required_size = std::max(required_size,
+                               read_buffer_start + message_size);
+    }
+    if (read_buffer_.size() < required_size) {
       // Use power-of-2 buffer sizes.
       // TODO(vtl): Make sure the buffer doesn't get too large (and enforce the
       // maximum message size to whatever extent necessary).
-      // TODO(vtl): We may often be able to peek at the header and get the real
-      // required extra space (which may be much bigger than |kReadSize|).
-      size_t new_size = std::max(read_buffer_.size(), kReadSize);
-      while (new_size <
-                 read_buffer_start + read_buffer_num_valid_bytes_ + kReadSize)
+      size_t new_size = std::max(read_buffer_.size(), kInitialReadBufferSize);
+      while (new_size < required_size)
         new_size *= 2;
 
       // TODO(vtl): It's suboptimal to zero out the fresh memory.
       read_buffer_.resize(new_size, 0);
     }
 
+    // Read as much as fits, which may be many messages.
+    size_t bytes_to_read = read_buffer_.size() -
+        (read_buffer_start + read_buffer_num_valid_bytes_);
     ssize_t bytes_read = HANDLE_EINTR(
         read(fd_.get().fd,
              &read_buffer_[read_buffer_start + read_buffer_num_valid_bytes_],
-             kReadSize));
+             bytes_to_read));
     if (bytes_read < 0) {
       if (errno != EAGAIN && errno != EWOULDBLOCK) {
         PLOG(ERROR) << "read";
@@ -249,14 +272,11 @@ void RawChannelPosix::OnFileCanReadWithoutBlocking(int fd) {
 
     read_buffer_num_valid_bytes_ += static_cast<size_t>(bytes_read);
 
-    // Dispatch all the messages that we can.
-    size_t message_size;
+    // Dispatch all the messages that we can, in place.
     // Note that we rely on short-circuit evaluation here:
     //   - |read_buffer_start| may be an invalid index into |read_buffer_| if
     //     |read_buffer_num_valid_bytes_| is zero.
     //   - |message_size| is only valid if |GetNextMessageSize()| returns true.
-    // TODO(vtl): Use |message_size| more intelligently (e.g., to request the
-    // next read).
     while (read_buffer_num_valid_bytes_ > 0 &&
            MessageInTransit::GetNextMessageSize(
                &read_buffer_[read_buffer_start], read_buffer_num_valid_bytes_,
@@ -290,8 +310,8 @@ void RawChannelPosix::OnFileCanReadWithoutBlocking(int fd) {
     if (did_dispatch_message)
       break;
 
-    // If we didn't max out |kReadSize|, stop reading for now.
-    if (static_cast<size_t>(bytes_read) < kReadSize)
+    // If we didn't fill the buffer, stop reading for now.
+    if (static_cast<size_t>(bytes_read) < bytes_to_read)
       break;
 
     // Else try to read some more....
@@ -321,7 +341,7 @@ void RawChannelPosix::OnFileCanWriteWithoutBlocking(int fd) {
       return;
     }
 
-    bool result = WriteFrontMessageNoLock();
+    bool result = WriteQueuedMessagesNoLock();
     DCHECK(result || write_message_queue_.empty());
 
     if (!result) {
@@ -351,42 +371,62 @@ void RawChannelPosix::CallOnFatalError(Delegate::FatalError fatal_error) {
   delegate()->OnFatalError(fatal_error);
 }
 
-bool RawChannelPosix::WriteFrontMessageNoLock() {
+bool RawChannelPosix::WriteQueuedMessagesNoLock() {
   write_lock_.AssertAcquired();
 
   DCHECK(!write_stopped_);
   DCHECK(!write_message_queue_.empty());
 
-  MessageInTransit* message = write_message_queue_.front();
-  DCHECK_LT(write_message_offset_, message->main_buffer_size());
-  size_t bytes_to_write = message->main_buffer_size() - write_message_offset_;
-  ssize_t bytes_written = HANDLE_EINTR(
-      write(fd_.get().fd,
-            static_cast<const char*>(message->main_buffer()) +
-                write_message_offset_,
-            bytes_to_write));
-  if (bytes_written < 0) {
-    if (errno != EAGAIN && errno != EWOULDBLOCK) {
-      PLOG(ERROR) << "write of size " << bytes_to_write;
-      CancelPendingWritesNoLock();
-      return false;
+  while (!write_message_queue_.empty()) {
+    // Gather a batch of messages from the front of the queue.
+    struct iovec iov[kMaxWriteBatchNumMessages];
+    size_t num_iovs = 0;
+    size_t bytes_to_write = 0;
+    for (std::deque<MessageInTransit*>::const_iterator it =
+             write_message_queue_.begin();
+         it != write_message_queue_.end() &&
+             num_iovs < kMaxWriteBatchNumMessages &&
+             bytes_to_write < kMaxWriteBatchNumBytes;
+         ++it) {
+      size_t offset = num_iovs == 0 ? write_message_offset_ : 0;
+      DCHECK_LT(offset, (*it)->main_buffer_size());
+      iov[num_iovs].iov_base = const_cast<char*>(
+          static_cast<const char*>((*it)->main_buffer()) + offset);
+      iov[num_iovs].iov_len = (*it)->main_buffer_size() - offset;
+      bytes_to_write += iov[num_iovs].iov_len;
+      num_iovs++;
     }
 
-    // We simply failed to write since we'd block. The logic is the same as if
-    // we got a partial write.
-    bytes_written = 0;
-  }
+    ssize_t bytes_written = HANDLE_EINTR(
+        writev(fd_.get().fd, iov, static_cast<int>(num_iovs)));
+    if (bytes_written < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        PLOG(ERROR) << "writev of size " << bytes_to_write;
+        CancelPendingWritesNoLock();
+        return false;
+      }
 
-  DCHECK_GE(bytes_written, 0);
-  if (static_cast<size_t>(bytes_written) < bytes_to_write) {
-    // Partial (or no) write.
-    write_message_offset_ += static_cast<size_t>(bytes_written);
-  } else {
-    // Complete write.
-    DCHECK_EQ(static_cast<size_t>(bytes_written), bytes_to_write);
-    write_message_queue_.pop_front();
-    write_message_offset_ = 0;
-    message->Destroy();
+      // We simply failed to write since we'd block. The logic is the same as
+      // if we got a partial write.
+      bytes_written = 0;
+    }
+
+    // Destroy the messages which were written completely.
+    DCHECK_GE(bytes_written, 0);
+    size_t bytes_left = static_cast<size_t>(bytes_written);
+    for (size_t i = 0; i < num_iovs && bytes_left >= iov[i].iov_len; i++) {
+      bytes_left -= iov[i].iov_len;
+      write_message_queue_.front()->Destroy();
+      write_message_queue_.pop_front();
+      write_message_offset_ = 0;
+    }
+    // The rest went into the message now at the front.
+    write_message_offset_ += bytes_left;
+
+    if (static_cast<size_t>(bytes_written) < bytes_to_write) {
+      // Partial (or no) write.
+      break;
+    }
   }
 
   return true;
@@ -0,0 +1,146 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This tests the throughput of |RawChannel| for many small messages, which is
+// dominated by the per-message system call overhead.
+
+#include "mojo/system/raw_channel.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/bind.h"
+#include "base/compiler_specific.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/test/perf_time_logger.h"
+#include "mojo/system/embedder/platform_channel_pair.h"
+#include "mojo/system/embedder/scoped_platform_handle.h"
+#include "mojo/system/message_in_transit.h"
+#include "mojo/system/test_utils.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace mojo {
+namespace system {
+namespace {
+
+void InitOnIOThread(RawChannel* raw_channel) {
+  CHECK(raw_channel->Init());
+}
+
+class NullRawChannelDelegate : public RawChannel::Delegate {
+ public:
+  NullRawChannelDelegate() {}
+  virtual ~NullRawChannelDelegate() {}
+
+  // |RawChannel::Delegate| implementation:
+  virtual void OnReadMessage(const MessageInTransit& /*message*/) OVERRIDE {
+    NOTREACHED();
+  }
+  virtual void OnFatalError(FatalError /*fatal_error*/) OVERRIDE {}
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(NullRawChannelDelegate);
+};
+
+class CountingRawChannelDelegate : public RawChannel::Delegate {
+ public:
+  explicit CountingRawChannelDelegate(size_t expected_count)
+      : done_event_(false, false),
+        expected_count_(expected_count),
+        count_(0) {}
+  virtual ~CountingRawChannelDelegate() {}
+
+  // |RawChannel::Delegate| implementation (called on the I/O thread):
+  virtual void OnReadMessage(const MessageInTransit& /*message*/) OVERRIDE {
+    if (++count_ == expected_count_)
+      done_event_.Signal();
+  }
+  virtual void OnFatalError(FatalError /*fatal_error*/) OVERRIDE {
+    NOTREACHED();
+  }
+
+  void Wait() {
+    done_event_.Wait();
+  }
+
+ private:
+  base::WaitableEvent done_event_;
+  const size_t expected_count_;
+  size_t count_;
+
+  DISALLOW_COPY_AND_ASSIGN(CountingRawChannelDelegate);
+};
+
+class RawChannelPosixPerfTest : public test::TestWithIOThreadBase {
+ public:
+  RawChannelPosixPerfTest() {}
+  virtual ~RawChannelPosixPerfTest() {}
+
+ protected:
+  // Writes |num_messages| messages of |num_bytes| bytes each from this thread
+  // through one |RawChannel| and times until the other one has read them all.
+  void TestWriteAndRead(size_t num_messages, uint32_t num_bytes) {
+    embedder::PlatformChannelPair channel_pair;
+    NullRawChannelDelegate writer_delegate;
+    scoped_ptr<RawChannel> writer_rc(
+        RawChannel::Create(channel_pair.PassServerHandle(),
+                           &writer_delegate,
+                           io_thread_message_loop()));
+    CountingRawChannelDelegate reader_delegate(num_messages);
+    scoped_ptr<RawChannel> reader_rc(
+        RawChannel::Create(channel_pair.PassClientHandle(),
+                           &reader_delegate,
+                           io_thread_message_loop()));
+    test::PostTaskAndWait(io_thread_task_runner(),
+                          FROM_HERE,
+                          base::Bind(&InitOnIOThread, writer_rc.get()));
+    test::PostTaskAndWait(io_thread_task_runner(),
+                          FROM_HERE,
+                          base::Bind(&InitOnIOThread, reader_rc.get()));
+
+    std::vector<char> bytes(num_bytes, 'x');
+    std::string test_name = base::StringPrintf(
+        "RawChannel_WriteAndRead_%ux_%ubytes",
+        static_cast<unsigned>(num_messages), static_cast<unsigned>(num_bytes));
+    {
+      base::PerfTimeLogger logger(test_name.c_str());
+      for (size_t i = 0; i < num_messages; i++) {
+        EXPECT_TRUE(writer_rc->WriteMessage(MessageInTransit::Create(
+            MessageInTransit::kTypeMessagePipeEndpoint,
+            MessageInTransit::kSubtypeMessagePipeEndpointData,
+            bytes.data(), num_bytes, 0)));
+      }
+      reader_delegate.Wait();
+    }
+
+    test::PostTaskAndWait(io_thread_task_runner(),
+                          FROM_HERE,
+                          base::Bind(&RawChannel::Shutdown,
+                                     base::Unretained(reader_rc.get())));
+    test::PostTaskAndWait(io_thread_task_runner(),
+                          FROM_HERE,
+                          base::Bind(&RawChannel::Shutdown,
+                                     base::Unretained(writer_rc.get())));
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(RawChannelPosixPerfTest);
+};
+
+TEST_F(RawChannelPosixPerfTest, ManySmallMessages) {
+  TestWriteAndRead(100000, 8);
+  TestWriteAndRead(100000, 64);
+  TestWriteAndRead(100000, 512);
+}
+
+}  // namespace
+}  // namespace system
+}  // namespace mojo
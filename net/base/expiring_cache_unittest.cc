@@ -254,6 +254,32 @@ TEST(ExpiringCacheTest, GetTruncatesExpiredEntries) {
   EXPECT_EQ(6U, cache.size());
 }
 
+TEST(ExpiringCacheTest, GetIncludingExpired) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  Cache cache(kMaxCacheEntries);
+
+  // Start at t=0.
+  base::TimeTicks now;
+  base::TimeTicks expiration;
+  EXPECT_FALSE(cache.GetIncludingExpired("test1", &expiration));
+
+  cache.Put("test1", "foo1", now, now + kTTL);
+  EXPECT_THAT(cache.GetIncludingExpired("test1", &expiration),
+              Pointee(StrEq("foo1")));
+  EXPECT_EQ(now + kTTL, expiration);
+
+  // Expired entries are returned, and are not removed.
+  now += kTTL;
+  EXPECT_THAT(cache.GetIncludingExpired("test1", &expiration),
+              Pointee(StrEq("foo1")));
+  EXPECT_EQ(1U, cache.size());
+
+  // Get() still removes them.
+  EXPECT_FALSE(cache.Get("test1", now));
+  EXPECT_EQ(0U, cache.size());
+}
+
 TEST(ExpiringCacheTest, CustomFunctor) {
   ExpiringCache<std::string, std::string, std::string, TestFunctor> cache(5);
 
@@ -9,6 +9,7 @@
 
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/slab_allocator.h"
 #include "base/pickle.h"
 #include "net/base/net_export.h"
 
@@ -70,7 +71,8 @@ namespace net {
 // and hence the buffer it was reading into must remain alive. Using
 // reference counting we can add a reference to the IOBuffer and make sure
 // it is not destroyed until after the synchronous operation has completed.
-class NET_EXPORT IOBuffer : public base::RefCountedThreadSafe<IOBuffer> {
+class NET_EXPORT IOBuffer
+    : public base::SlabAllocatedRefCountedThreadSafe<IOBuffer> {
  public:
   IOBuffer();
   explicit IOBuffer(int buffer_size);
@@ -663,6 +663,22 @@ EVENT_TYPE(CONNECT_JOB_SET_SOCKET)
 // Whether the connect job timed out.
 EVENT_TYPE(SOCKET_POOL_CONNECT_JOB_TIMED_OUT)
 
+// A TransportConnectJob started a connect() to one of the resolved
+// addresses. Several of them may be racing at once.
+//
+//   {
+//     "address": <String of the network address>,
+//   }
+EVENT_TYPE(TRANSPORT_CONNECT_JOB_START_ATTEMPT)
+
+// A connect() started by a TransportConnectJob finished:
+//
+//   {
+//     "address": <String of the network address>,
+//     "net_error": <Net integer error code, on error>,
+//   }
+EVENT_TYPE(TRANSPORT_CONNECT_JOB_ATTEMPT_COMPLETE)
+
 // ------------------------------------------------------------------------
 // ClientSocketPoolBaseHelper
 // ------------------------------------------------------------------------
@@ -935,6 +951,15 @@ EVENT_TYPE(HTTP_STREAM_JOB_BOUND_TO_REQUEST)
 //   }
 EVENT_TYPE(HTTP_STREAM_REQUEST_PROTO)
 
+// Logged when a Job chooses between an existing pipeline and an idle socket.
+// The event parameters are:
+//   {
+//      "pipeline_depth": <Requests in flight on the pipeline>,
+//      "idle_socket_count": <Idle sockets to the host>,
+//      "use_idle_socket": <True if the idle socket was chosen>,
+//   }
+EVENT_TYPE(HTTP_STREAM_JOB_PIPELINE_DECISION)
+
 // ------------------------------------------------------------------------
 // HttpNetworkTransaction
 // ------------------------------------------------------------------------
@@ -1295,6 +1320,15 @@ EVENT_TYPE(SPDY_STREAM_UPDATE_SEND_WINDOW)
 //   }
 EVENT_TYPE(SPDY_STREAM_UPDATE_RECV_WINDOW)
 
+// This event indicates that the priority of a stream has changed, e.g.
+// because the request was reprioritized while its stream was open.
+//   {
+//     "stream_id":    <The stream id>,
+//     "old_priority": <The previous priority>,
+//     "new_priority": <The new priority>,
+//   }
+EVENT_TYPE(SPDY_STREAM_PRIORITY_CHANGED)
+
 // This event indicates a stream error
 //   {
 //     "id":          <The stream id>,
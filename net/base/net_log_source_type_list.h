@@ -29,3 +29,4 @@ SOURCE_TYPE(FILESTREAM)
 SOURCE_TYPE(DNS_PROBER)
 SOURCE_TYPE(PROXY_CLIENT_SOCKET)
 SOURCE_TYPE(IPV6_REACHABILITY_CHECK)
+SOURCE_TYPE(DNS_TCP_CONNECTION)
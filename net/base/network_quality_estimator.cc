@@ -0,0 +1,192 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/network_quality_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "base/logging.h"
+#include "net/base/load_timing_info.h"
+#include "net/base/net_util.h"
+#include "url/gurl.h"
+
+namespace net {
+
+namespace {
+
+// Number of observations each estimate is computed over.
+const size_t kMaxObservations = 100;
+
+// Number of observations needed before an estimate is given.
+const size_t kMinObservations = 5;
+
+// Responses smaller than this are dominated by the round trip and say
+// little about throughput.
+const int64 kMinThroughputBytes = 32 * 1024;
+
+// Observers are notified when an estimate moves by more than this fraction.
+const double kSignificantChange = 0.2;
+
+template <typename T>
+bool GetPercentile(const std::deque<T>& observations, int percentile,
+                   T* value) {
+  DCHECK_GE(percentile, 0);
+  DCHECK_LE(percentile, 100);
+  if (observations.size() < kMinObservations)
+    return false;
+
+  std::vector<T> sorted(observations.begin(), observations.end());
+  typename std::vector<T>::iterator nth =
+      sorted.begin() + (sorted.size() - 1) * percentile / 100;
+  std::nth_element(sorted.begin(), nth, sorted.end());
+  *value = *nth;
+  return true;
+}
+
+bool IsSignificantChange(int64 old_value, int64 new_value) {
+  if (old_value == 0)
+    return new_value != 0;
+  return std::abs(static_cast<double>(new_value - old_value)) >
+         kSignificantChange * old_value;
+}
+
+// Requests to the local machine say nothing about the network.
+bool ShouldObserve(const GURL& url) {
+  return url.SchemeIsHTTPOrHTTPS() && !IsLocalhost(url.host());
+}
+
+}  // namespace
+
+NetworkQualityEstimator::NetworkQuality::NetworkQuality()
+    : downstream_throughput_kbps(0),
+      rtt_observations(0),
+      throughput_observations(0) {
+}
+
+NetworkQualityEstimator::NetworkQualityEstimator() {
+  NetworkChangeNotifier::AddConnectionTypeObserver(this);
+}
+
+NetworkQualityEstimator::~NetworkQualityEstimator() {
+  DCHECK(CalledOnValidThread());
+  NetworkChangeNotifier::RemoveConnectionTypeObserver(this);
+}
+
+void NetworkQualityEstimator::AddObserver(Observer* observer) {
+  DCHECK(CalledOnValidThread());
+  observers_.AddObserver(observer);
+}
+
+void NetworkQualityEstimator::RemoveObserver(Observer* observer) {
+  DCHECK(CalledOnValidThread());
+  observers_.RemoveObserver(observer);
+}
+
+bool NetworkQualityEstimator::GetRTTEstimate(int percentile,
+                                             base::TimeDelta* rtt) const {
+  DCHECK(CalledOnValidThread());
+  int64 rtt_ms = 0;
+  if (!GetPercentile(rtt_observations_, percentile, &rtt_ms))
+    return false;
+  *rtt = base::TimeDelta::FromMilliseconds(rtt_ms);
+  return true;
+}
+
+bool NetworkQualityEstimator::GetDownstreamThroughputEstimate(
+    int percentile,
+    int32* kbps) const {
+  DCHECK(CalledOnValidThread());
+  return GetPercentile(throughput_observations_, percentile, kbps);
+}
+
+NetworkQualityEstimator::NetworkQuality
+NetworkQualityEstimator::GetNetworkQuality() const {
+  NetworkQuality quality;
+  if (GetRTTEstimate(50, &quality.rtt))
+    quality.rtt_observations = rtt_observations_.size();
+  if (GetDownstreamThroughputEstimate(50,
+                                      &quality.downstream_throughput_kbps)) {
+    quality.throughput_observations = throughput_observations_.size();
+  }
+  return quality;
+}
+
+void NetworkQualityEstimator::NotifyHeadersReceived(
+    const GURL& url,
+    const LoadTimingInfo& load_timing_info) {
+  DCHECK(CalledOnValidThread());
+  if (!ShouldObserve(url) || load_timing_info.send_end.is_null() ||
+      load_timing_info.receive_headers_end.is_null()) {
+    return;
+  }
+
+  // The time from the last byte of the request to the first of the response
+  // is one round trip plus the time the server took.
+  AddRTTObservation(load_timing_info.receive_headers_end -
+                    load_timing_info.send_end);
+  MaybeNotifyObservers();
+}
+
+void NetworkQualityEstimator::NotifyRequestCompleted(
+    const GURL& url,
+    const LoadTimingInfo& load_timing_info,
+    int64 received_bytes) {
+  DCHECK(CalledOnValidThread());
+  if (!ShouldObserve(url) || received_bytes < kMinThroughputBytes ||
+      load_timing_info.receive_headers_end.is_null()) {
+    return;
+  }
+
+  const base::TimeDelta transfer_time =
+      base::TimeTicks::Now() - load_timing_info.receive_headers_end;
+  if (transfer_time <= base::TimeDelta())
+    return;
+
+  AddThroughputObservation(static_cast<int32>(
+      received_bytes * 8 / 1000 / transfer_time.InSecondsF()));
+  MaybeNotifyObservers();
+}
+
+void NetworkQualityEstimator::OnConnectionTypeChanged(
+    NetworkChangeNotifier::ConnectionType type) {
+  DCHECK(CalledOnValidThread());
+  rtt_observations_.clear();
+  throughput_observations_.clear();
+  last_notified_quality_ = NetworkQuality();
+}
+
+void NetworkQualityEstimator::AddRTTObservation(base::TimeDelta rtt) {
+  rtt_observations_.push_back(rtt.InMilliseconds());
+  if (rtt_observations_.size() > kMaxObservations)
+    rtt_observations_.pop_front();
+}
+
+void NetworkQualityEstimator::AddThroughputObservation(int32 kbps) {
+  throughput_observations_.push_back(kbps);
+  if (throughput_observations_.size() > kMaxObservations)
+    throughput_observations_.pop_front();
+}
+
+void NetworkQualityEstimator::MaybeNotifyObservers() {
+  const NetworkQuality quality = GetNetworkQuality();
+  const bool rtt_changed =
+      quality.rtt_observations &&
+      (!last_notified_quality_.rtt_observations ||
+       IsSignificantChange(last_notified_quality_.rtt.InMilliseconds(),
+                           quality.rtt.InMilliseconds()));
+  const bool throughput_changed =
+      quality.throughput_observations &&
+      (!last_notified_quality_.throughput_observations ||
+       IsSignificantChange(last_notified_quality_.downstream_throughput_kbps,
+                           quality.downstream_throughput_kbps));
+  if (!rtt_changed && !throughput_changed)
+    return;
+
+  last_notified_quality_ = quality;
+  FOR_EACH_OBSERVER(Observer, observers_, OnNetworkQualityChanged(quality));
+}
+
+}  // namespace net
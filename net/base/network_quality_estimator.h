@@ -0,0 +1,109 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_BASE_NETWORK_QUALITY_ESTIMATOR_H_
+#define NET_BASE_NETWORK_QUALITY_ESTIMATOR_H_
+
+#include <deque>
+
+#include "base/basictypes.h"
+#include "base/gtest_prod_util.h"
+#include "base/observer_list.h"
+#include "base/threading/non_thread_safe.h"
+#include "base/time/time.h"
+#include "net/base/net_export.h"
+#include "net/base/network_change_notifier.h"
+
+class GURL;
+
+namespace net {
+
+struct LoadTimingInfo;
+
+// Passively estimates the round trip time and downstream throughput of the
+// current network from the timing of the HTTP requests that go over it, so
+// that callers can adapt to the connection instead of assuming fixed
+// timeouts. Estimates are percentiles over the most recent observations, and
+// start over whenever the connection type changes. Lives on the IO thread.
+class NET_EXPORT NetworkQualityEstimator
+    : NON_EXPORTED_BASE(public base::NonThreadSafe),
+      public NetworkChangeNotifier::ConnectionTypeObserver {
+ public:
+  // The median estimates, and how many observations they are based on.
+  struct NET_EXPORT NetworkQuality {
+    NetworkQuality();
+
+    base::TimeDelta rtt;
+    int32 downstream_throughput_kbps;
+    size_t rtt_observations;
+    size_t throughput_observations;
+  };
+
+  class NET_EXPORT Observer {
+   public:
+    // Called when an estimate moves noticeably, or once enough observations
+    // have been made for it on a new connection.
+    virtual void OnNetworkQualityChanged(const NetworkQuality& quality) = 0;
+
+   protected:
+    virtual ~Observer() {}
+  };
+
+  NetworkQualityEstimator();
+  virtual ~NetworkQualityEstimator();
+
+  void AddObserver(Observer* observer);
+  void RemoveObserver(Observer* observer);
+
+  // Sets |*rtt| to the |percentile|th percentile of the observed round trip
+  // times. Returns false if there are too few observations.
+  bool GetRTTEstimate(int percentile, base::TimeDelta* rtt) const;
+
+  // Sets |*kbps| to the |percentile|th percentile of the observed downstream
+  // throughputs. Returns false if there are too few observations.
+  bool GetDownstreamThroughputEstimate(int percentile, int32* kbps) const;
+
+  // Returns the current median estimates.
+  NetworkQuality GetNetworkQuality() const;
+
+  // Called by URLRequestHttpJob when the response headers of a request that
+  // went to the network arrive, and when the request finishes.
+  void NotifyHeadersReceived(const GURL& url,
+                             const LoadTimingInfo& load_timing_info);
+  void NotifyRequestCompleted(const GURL& url,
+                              const LoadTimingInfo& load_timing_info,
+                              int64 received_bytes);
+
+  // NetworkChangeNotifier::ConnectionTypeObserver implementation.
+  virtual void OnConnectionTypeChanged(
+      NetworkChangeNotifier::ConnectionType type) OVERRIDE;
+
+ private:
+  FRIEND_TEST_ALL_PREFIXES(NetworkQualityEstimatorTest, Percentiles);
+  FRIEND_TEST_ALL_PREFIXES(NetworkQualityEstimatorTest, NotifiesObservers);
+  FRIEND_TEST_ALL_PREFIXES(NetworkQualityEstimatorTest,
+                           ConnectionChangeClearsObservations);
+
+  void AddRTTObservation(base::TimeDelta rtt);
+  void AddThroughputObservation(int32 kbps);
+
+  // Notifies the observers if the estimates moved enough since the last
+  // notification.
+  void MaybeNotifyObservers();
+
+  // The most recent observations, oldest first. RTTs are in milliseconds.
+  std::deque<int64> rtt_observations_;
+  std::deque<int32> throughput_observations_;
+
+  // The estimates observers were last told about.
+  NetworkQuality last_notified_quality_;
+
+  ObserverList<Observer> observers_;
+
+  DISALLOW_COPY_AND_ASSIGN(NetworkQualityEstimator);
+};
+
+}  // namespace net
+
+#endif  // NET_BASE_NETWORK_QUALITY_ESTIMATOR_H_
@@ -0,0 +1,140 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/base/network_quality_estimator.h"
+
+#include "base/basictypes.h"
+#include "base/time/time.h"
+#include "net/base/load_timing_info.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace net {
+
+namespace {
+
+class TestObserver : public NetworkQualityEstimator::Observer {
+ public:
+  TestObserver() : notifications_(0) {}
+
+  virtual void OnNetworkQualityChanged(
+      const NetworkQualityEstimator::NetworkQuality& quality) OVERRIDE {
+    ++notifications_;
+    last_quality_ = quality;
+  }
+
+  int notifications() const { return notifications_; }
+  const NetworkQualityEstimator::NetworkQuality& last_quality() const {
+    return last_quality_;
+  }
+
+ private:
+  int notifications_;
+  NetworkQualityEstimator::NetworkQuality last_quality_;
+
+  DISALLOW_COPY_AND_ASSIGN(TestObserver);
+};
+
+}  // namespace
+
+TEST(NetworkQualityEstimatorTest, Percentiles) {
+  NetworkQualityEstimator estimator;
+  base::TimeDelta rtt;
+  int32 kbps = 0;
+
+  // Too few observations.
+  for (int i = 1; i < 5; ++i)
+    estimator.AddRTTObservation(base::TimeDelta::FromMilliseconds(i * 10));
+  EXPECT_FALSE(estimator.GetRTTEstimate(50, &rtt));
+
+  for (int i = 5; i <= 100; ++i)
+    estimator.AddRTTObservation(base::TimeDelta::FromMilliseconds(i * 10));
+  ASSERT_TRUE(estimator.GetRTTEstimate(0, &rtt));
+  EXPECT_EQ(10, rtt.InMilliseconds());
+  ASSERT_TRUE(estimator.GetRTTEstimate(50, &rtt));
+  EXPECT_EQ(500, rtt.InMilliseconds());
+  ASSERT_TRUE(estimator.GetRTTEstimate(100, &rtt));
+  EXPECT_EQ(1000, rtt.InMilliseconds());
+
+  // Only the most recent observations count.
+  estimator.AddRTTObservation(base::TimeDelta::FromMilliseconds(2000));
+  ASSERT_TRUE(estimator.GetRTTEstimate(0, &rtt));
+  EXPECT_EQ(20, rtt.InMilliseconds());
+
+  for (int i = 0; i < 5; ++i)
+    estimator.AddThroughputObservation(1000);
+  ASSERT_TRUE(estimator.GetDownstreamThroughputEstimate(50, &kbps));
+  EXPECT_EQ(1000, kbps);
+}
+
+TEST(NetworkQualityEstimatorTest, NotifiesObservers) {
+  NetworkQualityEstimator estimator;
+  TestObserver observer;
+  estimator.AddObserver(&observer);
+
+  LoadTimingInfo load_timing_info;
+  load_timing_info.send_end = base::TimeTicks::Now();
+  load_timing_info.receive_headers_end =
+      load_timing_info.send_end + base::TimeDelta::FromMilliseconds(100);
+
+  // Requests to the local machine are ignored.
+  for (int i = 0; i < 10; ++i) {
+    estimator.NotifyHeadersReceived(GURL("http://localhost/"),
+                                    load_timing_info);
+  }
+  EXPECT_EQ(0, observer.notifications());
+
+  const GURL url("http://example.com/");
+  for (int i = 0; i < 10; ++i)
+    estimator.NotifyHeadersReceived(url, load_timing_info);
+  EXPECT_EQ(1, observer.notifications());
+  EXPECT_EQ(100, observer.last_quality().rtt.InMilliseconds());
+  EXPECT_EQ(5u, observer.last_quality().rtt_observations);
+
+  // A change within the threshold is not reported.
+  load_timing_info.receive_headers_end =
+      load_timing_info.send_end + base::TimeDelta::FromMilliseconds(110);
+  for (int i = 0; i < 20; ++i)
+    estimator.NotifyHeadersReceived(url, load_timing_info);
+  EXPECT_EQ(1, observer.notifications());
+
+  load_timing_info.receive_headers_end =
+      load_timing_info.send_end + base::TimeDelta::FromMilliseconds(500);
+  for (int i = 0; i < 40; ++i)
+    estimator.NotifyHeadersReceived(url, load_timing_info);
+  EXPECT_EQ(2, observer.notifications());
+  EXPECT_EQ(500, observer.last_quality().rtt.InMilliseconds());
+
+  estimator.RemoveObserver(&observer);
+}
+
+TEST(NetworkQualityEstimatorTest, ConnectionChangeClearsObservations) {
+  NetworkQualityEstimator estimator;
+  TestObserver observer;
+  estimator.AddObserver(&observer);
+
+  for (int i = 0; i < 5; ++i) {
+    estimator.AddRTTObservation(base::TimeDelta::FromMilliseconds(100));
+    estimator.AddThroughputObservation(1000);
+  }
+  estimator.MaybeNotifyObservers();
+  EXPECT_EQ(1, observer.notifications());
+
+  estimator.OnConnectionTypeChanged(NetworkChangeNotifier::CONNECTION_3G);
+  base::TimeDelta rtt;
+  int32 kbps = 0;
+  EXPECT_FALSE(estimator.GetRTTEstimate(50, &rtt));
+  EXPECT_FALSE(estimator.GetDownstreamThroughputEstimate(50, &kbps));
+
+  // The first estimates on the new connection are reported even if they
+  // match the old ones.
+  for (int i = 0; i < 5; ++i)
+    estimator.AddRTTObservation(base::TimeDelta::FromMilliseconds(100));
+  estimator.MaybeNotifyObservers();
+  EXPECT_EQ(2, observer.notifications());
+
+  estimator.RemoveObserver(&observer);
+}
+
+}  // namespace net
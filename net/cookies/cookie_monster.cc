@@ -142,6 +142,10 @@ const int kVlogGarbageCollection = 5;
 const int kVlogSetCookies = 7;
 const int kVlogGetCookies = 9;
 
+// Maximum number of cookie lines kept by GetCookiesWithOptions(). The cache
+// is emptied when it grows beyond this.
+const size_t kMaxCachedCookieLines = 1000;
+
 // Mozilla sorts on the path length (longest first), and then it
 // sorts by creation time (oldest first).
 // The RFC says the sort order for the domain attribute is undefined.
@@ -306,11 +310,24 @@ std::string BuildCookieLine(const CanonicalCookieVector& cookies) {
   return cookie_line;
 }
 
+// Returns the key under which the cookie line for a request to |url| with
+// |options| is cached. These are all the properties of the request which
+// CanonicalCookie::IncludeForRequestURL() looks at.
+std::string GetCookieLineCacheKey(const GURL& url,
+                                  const CookieOptions& options) {
+  std::string line_key(url.SchemeIsSecure() ? "s" : "-");
+  line_key += options.exclude_httponly() ? "h" : "-";
+  line_key += url.host();
+  line_key += url.path();
+  return line_key;
+}
+
 }  // namespace
 
 CookieMonster::CookieMonster(PersistentCookieStore* store,
                              CookieMonsterDelegate* delegate)
-    : initialized_(false),
+    : num_cached_cookie_lines_(0),
+      initialized_(false),
       loaded_(false),
       store_(store),
       last_access_threshold_(
@@ -326,7 +343,8 @@ CookieMonster::CookieMonster(PersistentCookieStore* store,
 CookieMonster::CookieMonster(PersistentCookieStore* store,
                              CookieMonsterDelegate* delegate,
                              int last_access_threshold_milliseconds)
-    : initialized_(false),
+    : num_cached_cookie_lines_(0),
+      initialized_(false),
       loaded_(false),
       store_(store),
       last_access_threshold_(base::TimeDelta::FromMilliseconds(
@@ -987,7 +1005,11 @@ void CookieMonster::DeleteCanonicalCookieAsync(
   scoped_refptr<DeleteCanonicalCookieTask> task =
       new DeleteCanonicalCookieTask(this, cookie, callback);
 
-  DoCookieTask(task);
+  // Only the cookies for the cookie's own domain key need to be loaded.
+  std::string host(cookie.Domain());
+  if (!host.empty() && host[0] == '.')
+    host.erase(0, 1);
+  DoCookieTaskForURL(task, GURL("http://" + host));
 }
 
 void CookieMonster::SetCookieWithOptionsAsync(
@@ -1316,11 +1338,17 @@ std::string CookieMonster::GetCookiesWithOptions(const GURL& url,
 
   TimeTicks start_time(TimeTicks::Now());
 
-  std::vector<CanonicalCookie*> cookies;
-  FindCookiesForHostAndDomain(url, options, true, &cookies);
-  std::sort(cookies.begin(), cookies.end(), CookieSorter);
+  const std::string key(GetKey(url.host()));
+  const std::string line_key(GetCookieLineCacheKey(url, options));
+  std::string cookie_line;
+  if (!GetCachedCookieLine(key, line_key, &cookie_line)) {
+    std::vector<CanonicalCookie*> cookies;
+    FindCookiesForHostAndDomain(url, options, true, &cookies);
+    std::sort(cookies.begin(), cookies.end(), CookieSorter);
 
-  std::string cookie_line = BuildCookieLine(cookies);
+    cookie_line = BuildCookieLine(cookies);
+    CacheCookieLine(key, line_key, cookie_line, cookies);
+  }
 
   histogram_time_get_->AddTime(TimeTicks::Now() - start_time);
 
@@ -1726,6 +1754,78 @@ void CookieMonster::FindCookiesForKey(const std::string& key,
   }
 }
 
+bool CookieMonster::GetCachedCookieLine(const std::string& key,
+                                        const std::string& line_key,
+                                        std::string* cookie_line) {
+  lock_.AssertAcquired();
+
+  std::map<std::string, CookieLineMap>::iterator domain_it =
+      cookie_line_cache_.find(key);
+  if (domain_it == cookie_line_cache_.end())
+    return false;
+  CookieLineMap::iterator it = domain_it->second.find(line_key);
+  if (it == domain_it->second.end())
+    return false;
+
+  const Time current_time(CurrentTime());
+  if (current_time >= it->second.valid_until) {
+    domain_it->second.erase(it);
+    --num_cached_cookie_lines_;
+    if (domain_it->second.empty())
+      cookie_line_cache_.erase(domain_it);
+    return false;
+  }
+
+  // Done by FindCookiesForHostAndDomain() on a cache miss.
+  RecordPeriodicStats(current_time);
+
+  *cookie_line = it->second.cookie_line;
+  return true;
+}
+
+void CookieMonster::CacheCookieLine(
+    const std::string& key,
+    const std::string& line_key,
+    const std::string& cookie_line,
+    const std::vector<CanonicalCookie*>& cookies) {
+  lock_.AssertAcquired();
+
+  // The line must be rebuilt once any of its cookies expires, or once
+  // FindCookiesForKey() would update a cookie's access time again.
+  Time valid_until = Time::Max();
+  for (std::vector<CanonicalCookie*>::const_iterator it = cookies.begin();
+       it != cookies.end(); ++it) {
+    valid_until = std::min(valid_until,
+                           (*it)->LastAccessDate() + last_access_threshold_);
+    if ((*it)->IsPersistent())
+      valid_until = std::min(valid_until, (*it)->ExpiryDate());
+  }
+
+  if (num_cached_cookie_lines_ >= kMaxCachedCookieLines) {
+    cookie_line_cache_.clear();
+    num_cached_cookie_lines_ = 0;
+  }
+
+  std::pair<CookieLineMap::iterator, bool> inserted =
+      cookie_line_cache_[key].insert(
+          std::make_pair(line_key, CachedCookieLine()));
+  if (inserted.second)
+    ++num_cached_cookie_lines_;
+  inserted.first->second.cookie_line = cookie_line;
+  inserted.first->second.valid_until = valid_until;
+}
+
+void CookieMonster::InvalidateCachedCookieLines(const std::string& key) {
+  lock_.AssertAcquired();
+
+  std::map<std::string, CookieLineMap>::iterator it =
+      cookie_line_cache_.find(key);
+  if (it == cookie_line_cache_.end())
+    return;
+  num_cached_cookie_lines_ -= it->second.size();
+  cookie_line_cache_.erase(it);
+}
+
 bool CookieMonster::DeleteAnyEquivalentCookie(const std::string& key,
                                               const CanonicalCookie& ecc,
                                               bool skip_httponly,
@@ -1768,6 +1868,7 @@ CookieMonster::CookieMap::iterator CookieMonster::InternalInsertCookie(
     store_->AddCookie(*cc);
   CookieMap::iterator inserted =
       cookies_.insert(CookieMap::value_type(key, cc));
+  InvalidateCachedCookieLines(key);
   if (delegate_.get()) {
     delegate_->OnCookieChanged(
         *cc, false, CookieMonsterDelegate::CHANGE_COOKIE_EXPLICIT);
@@ -1888,6 +1989,7 @@ void CookieMonster::InternalDeleteCookie(CookieMap::iterator it,
     if (mapping.notify)
       delegate_->OnCookieChanged(*cc, true, mapping.cause);
   }
+  InvalidateCachedCookieLines(it->first);
   cookies_.erase(it);
   delete cc;
 }
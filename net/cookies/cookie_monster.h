@@ -510,6 +510,24 @@ class NET_EXPORT CookieMonster : public CookieStore {
                          bool update_access_time,
                          std::vector<CanonicalCookie*>* cookies);
 
+  // Looks up the cookie line built by an earlier GetCookiesWithOptions() for
+  // the same request, cached under domain key |key| and |line_key|. Returns
+  // false if there is none, or if it may be out of date.
+  bool GetCachedCookieLine(const std::string& key,
+                           const std::string& line_key,
+                           std::string* cookie_line);
+
+  // Caches |cookie_line|, built from |cookies|, until one of |cookies|
+  // expires, or is due to have its access time updated.
+  void CacheCookieLine(const std::string& key,
+                       const std::string& line_key,
+                       const std::string& cookie_line,
+                       const std::vector<CanonicalCookie*>& cookies);
+
+  // Drops the cached cookie lines for domain key |key|. Must be called
+  // whenever a cookie with that key is added or removed.
+  void InvalidateCachedCookieLines(const std::string& key);
+
   // Delete any cookies that are equivalent to |ecc| (same path, domain, etc).
   // If |skip_httponly| is true, httponly cookies will not be deleted.  The
   // return value with be true if |skip_httponly| skipped an httponly cookie.
@@ -621,6 +639,21 @@ class NET_EXPORT CookieMonster : public CookieStore {
 
   CookieMap cookies_;
 
+  // A cookie line built by GetCookiesWithOptions(), which can be returned
+  // again for requests that include the same cookies until |valid_until|.
+  struct CachedCookieLine {
+    std::string cookie_line;
+    base::Time valid_until;
+  };
+  // Keyed by the scheme security, options and URL host and path which
+  // determine the cookies included in a request.
+  typedef std::map<std::string, CachedCookieLine> CookieLineMap;
+
+  // Cached cookie lines, keyed by the same domain keys as |cookies_|, so that
+  // they can be dropped when a cookie for the domain key changes.
+  std::map<std::string, CookieLineMap> cookie_line_cache_;
+  size_t num_cached_cookie_lines_;
+
   // Indicates whether the cookie store has been initialized. This happens
   // lazily in InitStoreIfNecessary().
   bool initialized_;
@@ -23,6 +23,9 @@ namespace {
 const int kNumCookies = 20000;
 const char kCookieLine[] = "A  = \"b=;\\\"\"  ;secure;;;";
 const char kGoogleURL[] = "http://www.google.izzle";
+// Number of paths on a single host with their own cookies; below the per-domain
+// cookie limit.
+const int kNumPaths = 100;
 
 int CountInString(const std::string& str, char c) {
   return std::count(str.begin(), str.end(), c);
@@ -182,6 +185,30 @@ TEST_F(CookieMonsterTest, TestAddCookieOnManyHosts) {
   timer3.Done();
 }
 
+TEST_F(CookieMonsterTest, TestQueryManyPaths) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+  std::vector<GURL> gurls;
+  SetCookieCallback setCookieCallback;
+  for (int i = 0; i < kNumPaths; ++i) {
+    gurls.push_back(GURL(base::StringPrintf("%s/p%03d/", kGoogleURL, i)));
+    setCookieCallback.SetCookie(
+        cm.get(), gurls.back(), base::StringPrintf("a%03d=b; path=/p%03d/",
+                                                   i, i));
+  }
+  setCookieCallback.SetCookie(cm.get(), GURL(kGoogleURL), "a=b");
+
+  // Repeatedly query every path, as when loading a page's subresources.
+  GetCookiesCallback getCookiesCallback;
+  base::PerfTimeLogger timer("Cookie_monster_query_many_paths");
+  for (int i = 0; i < kNumCookies / kNumPaths; ++i) {
+    for (std::vector<GURL>::const_iterator it = gurls.begin();
+         it != gurls.end(); ++it) {
+      getCookiesCallback.GetCookies(cm.get(), *it);
+    }
+  }
+  timer.Done();
+}
+
 TEST_F(CookieMonsterTest, TestDomainTree) {
   scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
   GetCookiesCallback getCookiesCallback;
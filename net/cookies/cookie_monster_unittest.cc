@@ -1058,7 +1058,8 @@ TEST_F(DeferredCookieTaskTest, DeferredDeleteCanonicalCookie) {
 
   MockDeleteCookieCallback delete_cookie_callback;
 
-  BeginWith(DeleteCanonicalCookieAction(
+  // Only the cookie's own domain key is loaded.
+  BeginWithForDomainKey("google.com", DeleteCanonicalCookieAction(
       &cookie_monster(), cookie, &delete_cookie_callback));
 
   WaitForLoadCall();
@@ -1239,6 +1240,40 @@ TEST_F(CookieMonsterTest, TestDeleteSingleCookie) {
   EXPECT_EQ("A=B; E=F", GetCookies(cm.get(), url_google_));
 }
 
+// Cookie lines reused across GetCookies() calls must reflect every change to
+// the cookies for the domain, and every property of the request.
+TEST_F(CookieMonsterTest, CachedCookieLines) {
+  scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
+  CookieOptions options;
+
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "A=B"));
+  EXPECT_EQ("A=B", GetCookies(cm.get(), url_google_));
+  EXPECT_EQ("A=B", GetCookies(cm.get(), url_google_));
+
+  // Cookies set on a parent domain share the domain key.
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "C=D; domain=.google.izzle"));
+  EXPECT_EQ("A=B; C=D", GetCookies(cm.get(), url_google_));
+
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_secure_, "E=F; secure"));
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "G=H; httponly"));
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_foo_, "I=J; path=/foo"));
+  EXPECT_EQ("A=B; C=D; G=H", GetCookies(cm.get(), url_google_));
+  EXPECT_EQ("A=B; C=D", GetCookiesWithOptions(cm.get(), url_google_, options));
+  EXPECT_EQ("A=B; C=D; E=F; G=H", GetCookies(cm.get(), url_google_secure_));
+  EXPECT_EQ("I=J; A=B; C=D; G=H", GetCookies(cm.get(), url_google_foo_));
+
+  // Overwriting a cookie replaces it.
+  EXPECT_TRUE(SetCookie(cm.get(), url_google_, "A=Z"));
+  EXPECT_EQ("C=D; G=H; A=Z", GetCookies(cm.get(), url_google_));
+
+  EXPECT_TRUE(FindAndDeleteCookie(cm.get(), url_google_.host(), "G"));
+  EXPECT_EQ("C=D; A=Z", GetCookies(cm.get(), url_google_));
+  EXPECT_EQ("C=D; A=Z", GetCookiesWithOptions(cm.get(), url_google_, options));
+
+  EXPECT_EQ(4, DeleteAll(cm.get()));
+  EXPECT_EQ("", GetCookies(cm.get(), url_google_));
+}
+
 TEST_F(CookieMonsterTest, SetCookieableSchemes) {
   scoped_refptr<CookieMonster> cm(new CookieMonster(NULL, NULL));
   scoped_refptr<CookieMonster> cm_foo(new CookieMonster(NULL, NULL));
@@ -49,6 +49,10 @@ const int kBaseTableLen = 64 * 1024;
 // Avoid trimming the cache for the first 5 minutes (10 timer ticks).
 const int kTrimDelay = 10;
 
+// Entries used again within this many seconds of their last move to the head
+// of the LRU lists are not moved again, unless they were modified.
+const int kRankUpdateIntervalSeconds = 30;
+
 int DesiredIndexTableLen(int32 storage_size) {
   if (storage_size <= k64kEntriesStore)
     return kBaseTableLen;
@@ -223,6 +227,10 @@ int BackendImpl::SyncInit() {
   if (!(user_flags_ & kNoRandom)) {
     // The unit test controls directly what to test.
     new_eviction_ = (cache_type_ == net::DISK_CACHE);
+    if (cache_type_ == net::DISK_CACHE) {
+      rankings_.set_rank_update_interval(
+          TimeDelta::FromSeconds(kRankUpdateIntervalSeconds));
+    }
   }
 
   if (!CheckIndex()) {
@@ -382,6 +390,10 @@ int BackendImpl::SyncDoomEntriesBetween(const base::Time initial_time,
   if (disabled_)
     return net::ERR_FAILED;
 
+  // The last used time of an entry may lag behind by up to the rank update
+  // interval, so anything that may have been used after |initial_time| goes.
+  const base::Time start_time = initial_time - rankings_.rank_update_interval();
+
   EntryImpl* node;
   void* iter = NULL;
   EntryImpl* next = OpenNextEntryImpl(&iter);
@@ -392,10 +404,10 @@ int BackendImpl::SyncDoomEntriesBetween(const base::Time initial_time,
     node = next;
     next = OpenNextEntryImpl(&iter);
 
-    if (node->GetLastUsed() >= initial_time &&
+    if (node->GetLastUsed() >= start_time &&
         node->GetLastUsed() < end_time) {
       node->DoomImpl();
-    } else if (node->GetLastUsed() < initial_time) {
+    } else if (node->GetLastUsed() < start_time) {
       if (next)
         next->Release();
       next = NULL;
@@ -415,6 +427,9 @@ int BackendImpl::SyncDoomEntriesSince(const base::Time initial_time) {
   if (disabled_)
     return net::ERR_FAILED;
 
+  // See SyncDoomEntriesBetween().
+  const base::Time start_time = initial_time - rankings_.rank_update_interval();
+
   stats_.OnEvent(Stats::DOOM_RECENT);
   for (;;) {
     void* iter = NULL;
@@ -422,7 +437,7 @@ int BackendImpl::SyncDoomEntriesSince(const base::Time initial_time) {
     if (!entry)
       return net::OK;
 
-    if (initial_time > entry->GetLastUsed()) {
+    if (start_time > entry->GetLastUsed()) {
       entry->Release();
       SyncEndEnumeration(iter);
       return net::OK;
@@ -1068,6 +1083,10 @@ void BackendImpl::SetNewEviction() {
   new_eviction_ = true;
 }
 
+void BackendImpl::SetRankUpdateInterval(base::TimeDelta interval) {
+  rankings_.set_rank_update_interval(interval);
+}
+
 void BackendImpl::SetFlags(uint32 flags) {
   user_flags_ |= flags;
 }
@@ -224,6 +224,10 @@ class NET_EXPORT_PRIVATE BackendImpl : public Backend {
   // Sets the eviction algorithm to version 2.
   void SetNewEviction();
 
+  // Sets the interval during which unmodified entries are not moved to the
+  // head of the LRU lists again. See Rankings::set_rank_update_interval().
+  void SetRankUpdateInterval(base::TimeDelta interval);
+
   // Sets an explicit set of BackendFlags.
   void SetFlags(uint32 flags);
 
@@ -4,6 +4,7 @@
 
 #include "base/basictypes.h"
 #include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "base/metrics/field_trial.h"
 #include "base/port.h"
 #include "base/strings/string_util.h"
@@ -1554,6 +1555,51 @@ TEST_F(DiskCacheBackendTest, MemoryOnlyDoomRecent) {
   BackendDoomRecent();
 }
 
+// Tests that entries used again shortly after their last move to the head of
+// the list stay where they are, and are still doomed by time.
+TEST_F(DiskCacheBackendTest, RankUpdateInterval) {
+  InitCache();
+  cache_impl_->SetRankUpdateInterval(base::TimeDelta::FromMinutes(5));
+
+  disk_cache::Entry *entry;
+  ASSERT_EQ(net::OK, CreateEntry("first", &entry));
+  entry->Close();
+  ASSERT_EQ(net::OK, CreateEntry("second", &entry));
+  entry->Close();
+  FlushQueueForTest();
+
+  AddDelay();
+  Time middle = Time::Now();
+
+  ASSERT_EQ(net::OK, OpenEntry("first", &entry));
+  entry->Close();
+  FlushQueueForTest();
+
+  void* iter = NULL;
+  ASSERT_EQ(net::OK, OpenNextEntry(&iter, &entry));
+  EXPECT_EQ("second", entry->GetKey());
+  entry->Close();
+  cache_->EndEnumeration(&iter);
+
+  // Modified entries are always moved.
+  ASSERT_EQ(net::OK, OpenEntry("first", &entry));
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(10));
+  memset(buffer->data(), 0, 10);
+  EXPECT_EQ(10, WriteData(entry, 0, 0, buffer.get(), 10, false));
+  entry->Close();
+  FlushQueueForTest();
+
+  iter = NULL;
+  ASSERT_EQ(net::OK, OpenNextEntry(&iter, &entry));
+  EXPECT_EQ("first", entry->GetKey());
+  entry->Close();
+  cache_->EndEnumeration(&iter);
+
+  // "second" was last used before |middle|, but its last used time may lag.
+  EXPECT_EQ(net::OK, DoomEntriesSince(middle));
+  EXPECT_EQ(0, cache_->GetEntryCount());
+}
+
 TEST_F(DiskCacheBackendTest, MemoryOnlyDoomEntriesSinceSparse) {
   SetMemoryOnlyMode();
   base::Time start;
@@ -3160,6 +3206,52 @@ TEST_F(DiskCacheBackendTest, TracingBackendBasics) {
   TracingBackendBasics();
 }
 
+TEST_F(DiskCacheBackendTest, TracingBackendWritesTrace) {
+  InitCache();
+  base::ScopedTempDir trace_dir;
+  ASSERT_TRUE(trace_dir.CreateUniqueTempDir());
+  const base::FilePath trace_path = trace_dir.path().AppendASCII("trace");
+  cache_.reset(new disk_cache::TracingCacheBackend(cache_.Pass(), trace_path));
+  cache_impl_ = NULL;
+
+  disk_cache::Entry* entry = NULL;
+  ASSERT_EQ(net::OK, CreateEntry("key", &entry));
+  const int kSize = 200;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer->data(), kSize, false);
+  EXPECT_EQ(kSize, WriteData(entry, 1, 10, buffer.get(), kSize, false));
+  entry->Close();
+
+  // Destroying the backend flushes the trace.
+  cache_.reset();
+
+  std::string trace;
+  ASSERT_TRUE(base::ReadFileToString(trace_path, &trace));
+  ASSERT_EQ(sizeof(disk_cache::CacheTraceHeader) +
+                3 * sizeof(disk_cache::CacheTraceRecord),
+            trace.size());
+  const disk_cache::CacheTraceHeader* header =
+      reinterpret_cast<const disk_cache::CacheTraceHeader*>(trace.data());
+  EXPECT_EQ(disk_cache::kCacheTraceMagic, header->magic);
+  EXPECT_EQ(disk_cache::kCacheTraceVersion, header->version);
+
+  const disk_cache::CacheTraceRecord* records =
+      reinterpret_cast<const disk_cache::CacheTraceRecord*>(header + 1);
+  const uint64 key_id = disk_cache::CacheTraceKeyId("key");
+  EXPECT_EQ(disk_cache::TRACE_OP_CREATE, records[0].operation);
+  EXPECT_EQ(net::OK, records[0].result);
+  EXPECT_EQ(disk_cache::TRACE_OP_WRITE, records[1].operation);
+  EXPECT_EQ(1, records[1].index);
+  EXPECT_EQ(10, records[1].offset);
+  EXPECT_EQ(kSize, records[1].length);
+  EXPECT_EQ(kSize, records[1].result);
+  EXPECT_EQ(disk_cache::TRACE_OP_CLOSE, records[2].operation);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(key_id, records[i].key_id);
+    EXPECT_LE(records[i].start_us, records[2].start_us);
+  }
+}
+
 // The Simple Cache backend requires a few guarantees from the filesystem like
 // atomic renaming of recently open files. Those guarantees are not provided in
 // general on Windows.
@@ -10,6 +10,7 @@
 #include "net/disk_cache/backend_impl.h"
 #include "net/disk_cache/cache_util.h"
 #include "net/disk_cache/disk_cache.h"
+#include "net/disk_cache/flash/flash_backend_impl.h"
 #include "net/disk_cache/mem_backend_impl.h"
 #include "net/disk_cache/simple/simple_backend_impl.h"
 
@@ -91,6 +92,13 @@ int CacheCreator::Run() {
     return simple_cache->Init(
         base::Bind(&CacheCreator::OnIOComplete, base::Unretained(this)));
   }
+  if (backend_type_ == net::CACHE_BACKEND_FLASH && type_ == net::DISK_CACHE) {
+    disk_cache::FlashBackendImpl* flash_cache =
+        new disk_cache::FlashBackendImpl(path_, max_bytes_, thread_.get());
+    created_cache_.reset(flash_cache);
+    return flash_cache->Init(
+        base::Bind(&CacheCreator::OnIOComplete, base::Unretained(this)));
+  }
   disk_cache::BackendImpl* new_cache =
       new disk_cache::BackendImpl(path_, thread_.get(), net_log_);
   created_cache_.reset(new_cache);
@@ -109,8 +117,8 @@ void CacheCreator::DoCallback(int result) {
 #ifndef USE_TRACING_CACHE_BACKEND
     *backend_ = created_cache_.Pass();
 #else
-    *backend_.reset(
-        new disk_cache::TracingCacheBackend(created_cache_.Pass()));
+    backend_->reset(new disk_cache::TracingCacheBackend(
+        created_cache_.Pass(), path_.AddExtension(FILE_PATH_LITERAL("trace"))));
 #endif
   } else {
     LOG(ERROR) << "Unable to create cache";
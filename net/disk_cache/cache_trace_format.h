@@ -0,0 +1,68 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// The on-disk format of the operation traces written by TracingCacheBackend
+// and consumed by net/tools/disk_cache_replay. A trace file is a
+// CacheTraceHeader followed by a flat array of CacheTraceRecords, one per
+// completed Backend or Entry operation, in completion order.
+//
+// Keys are never written to the trace. Each key is reduced to a 64 bit id,
+// which is enough for a replay to tell entries apart without leaking URLs.
+
+#ifndef NET_DISK_CACHE_CACHE_TRACE_FORMAT_H_
+#define NET_DISK_CACHE_CACHE_TRACE_FORMAT_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/hash.h"
+
+namespace disk_cache {
+
+const uint32 kCacheTraceMagic = 0xC4C3E7A1;
+const uint32 kCacheTraceVersion = 1;
+
+// The values are written to traces, so only append to this list.
+enum CacheTraceOperation {
+  TRACE_OP_OPEN = 0,
+  TRACE_OP_CREATE = 1,
+  TRACE_OP_DOOM_ENTRY = 2,
+  TRACE_OP_READ = 3,
+  TRACE_OP_WRITE = 4,
+  TRACE_OP_DOOM = 5,   // Entry::Doom().
+  TRACE_OP_CLOSE = 6,  // Entry::Close().
+  TRACE_OP_MAX
+};
+
+struct CacheTraceHeader {
+  uint32 magic;
+  uint32 version;
+  int64 creation_time;  // base::Time internal value.
+};
+COMPILE_ASSERT(sizeof(CacheTraceHeader) == 16, bad_CacheTraceHeader);
+
+struct CacheTraceRecord {
+  int64 start_us;      // Start of the operation, relative to the trace start.
+  uint32 duration_us;  // Time until the result was delivered.
+  uint8 operation;     // A CacheTraceOperation.
+  uint8 index;         // Stream index, for reads and writes.
+  uint8 truncate;      // Truncate flag, for writes.
+  uint8 reserved1;
+  uint64 key_id;       // See CacheTraceKeyId().
+  int32 offset;        // For reads and writes.
+  int32 length;        // Buffer length, for reads and writes.
+  int32 result;        // Net error code or number of bytes transferred.
+  int32 reserved2;
+};
+COMPILE_ASSERT(sizeof(CacheTraceRecord) == 40, bad_CacheTraceRecord);
+
+// Returns the id that stands for |key| in a trace.
+inline uint64 CacheTraceKeyId(const std::string& key) {
+  return (static_cast<uint64>(base::Hash(key)) << 32) |
+         static_cast<uint32>(key.size());
+}
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_CACHE_TRACE_FORMAT_H_
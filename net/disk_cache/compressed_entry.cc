@@ -0,0 +1,373 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/compressed_entry.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/metrics/histogram.h"
+#include "base/time/time.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "third_party/zlib/zlib.h"
+
+namespace {
+
+// Each frame starts with the number of bytes stored after the header. The top
+// bit is set when the data is stored without compression.
+const int kHeaderSize = sizeof(uint32);
+const uint32 kUncompressedFrame = 0x80000000;
+
+const int kMaxStoredFrameSize =
+    kHeaderSize + disk_cache::CompressedEntry::kFrameSize;
+
+bool ParseHeader(const char* data, int* stored_len, bool* compressed) {
+  uint32 header;
+  memcpy(&header, data, kHeaderSize);
+  *stored_len = static_cast<int>(header & ~kUncompressedFrame);
+  *compressed = !(header & kUncompressedFrame);
+  return *stored_len <= disk_cache::CompressedEntry::kFrameSize;
+}
+
+}  // namespace
+
+namespace disk_cache {
+
+CompressedEntry::ReadOperation::ReadOperation()
+    : frame(0),
+      offset(0),
+      buf_len(0) {
+}
+
+CompressedEntry::ReadOperation::~ReadOperation() {
+}
+
+// static
+CompressedEntry* CompressedEntry::Create(Entry* entry) {
+  CompressedEntry* compressed_entry = new CompressedEntry(entry);
+  compressed_entry->AddRef();
+  return compressed_entry;
+}
+
+void CompressedEntry::SetCompressed(bool compressed, int32 data_size) {
+  if (compressed == compressed_ && (!compressed || data_size == data_size_))
+    return;
+  compressed_ = compressed;
+  Reset(compressed ? data_size : 0);
+}
+
+void CompressedEntry::Doom() {
+  entry_->Doom();
+}
+
+void CompressedEntry::Close() {
+  if (compressed_ && written_ && data_size_) {
+    int64 stored_size = frame_offsets_.back() + pending_stored_len_;
+    UMA_HISTOGRAM_PERCENTAGE("DiskCache.CompressedEntry.Ratio",
+                             static_cast<int>(stored_size * 100 / data_size_));
+  }
+  entry_->Close();
+  entry_ = NULL;
+  Release();
+}
+
+std::string CompressedEntry::GetKey() const {
+  return entry_->GetKey();
+}
+
+base::Time CompressedEntry::GetLastUsed() const {
+  return entry_->GetLastUsed();
+}
+
+base::Time CompressedEntry::GetLastModified() const {
+  return entry_->GetLastModified();
+}
+
+int32 CompressedEntry::GetDataSize(int index) const {
+  if (compressed_ && index == kCompressedStream)
+    return data_size_;
+  return entry_->GetDataSize(index);
+}
+
+int CompressedEntry::ReadData(int index, int offset, IOBuffer* buf,
+                              int buf_len,
+                              const CompletionCallback& callback) {
+  if (!compressed_ || index != kCompressedStream)
+    return entry_->ReadData(index, offset, buf, buf_len, callback);
+
+  if (offset < 0 || buf_len < 0)
+    return net::ERR_INVALID_ARGUMENT;
+  if (offset >= data_size_ || !buf_len)
+    return 0;
+
+  buf_len = std::min(buf_len, data_size_ - offset);
+  int frame = offset / kFrameSize;
+  if (frame == frame_data_index_)
+    return CopyFromFrame(offset, buf, buf_len);
+
+  ReadOperation op;
+  op.frame = frame;
+  op.offset = offset;
+  op.buf = buf;
+  op.buf_len = buf_len;
+  op.callback = callback;
+  return ReadFrame(op);
+}
+
+int CompressedEntry::WriteData(int index, int offset, IOBuffer* buf,
+                               int buf_len,
+                               const CompletionCallback& callback,
+                               bool truncate) {
+  if (!compressed_ || index != kCompressedStream)
+    return entry_->WriteData(index, offset, buf, buf_len, callback, truncate);
+
+  if (offset < 0 || buf_len < 0)
+    return net::ERR_INVALID_ARGUMENT;
+  if (!offset)
+    Reset(0);
+  else if (offset != data_size_)
+    return net::ERR_INVALID_ARGUMENT;
+
+  written_ = true;
+  frame_data_index_ = -1;
+  if (buf_len)
+    pending_data_.append(buf->data(), buf_len);
+  data_size_ += buf_len;
+
+  // The last frame stored is always rewritten, together with any frame that
+  // is now complete.
+  int stored_offset = frame_offsets_.back();
+  std::string output;
+  size_t used = 0;
+  while (pending_data_.size() - used >= static_cast<size_t>(kFrameSize)) {
+    AppendFrame(pending_data_.data() + used, kFrameSize, &output);
+    frame_offsets_.push_back(stored_offset + static_cast<int>(output.size()));
+    used += kFrameSize;
+  }
+  pending_data_.erase(0, used);
+
+  pending_stored_len_ = 0;
+  if (!pending_data_.empty()) {
+    size_t frame_start = output.size();
+    AppendFrame(pending_data_.data(), static_cast<int>(pending_data_.size()),
+                &output);
+    pending_stored_len_ = static_cast<int>(output.size() - frame_start);
+  }
+
+  int stored_len = static_cast<int>(output.size());
+  scoped_refptr<net::StringIOBuffer> stored(new net::StringIOBuffer(output));
+  int rv = entry_->WriteData(
+      kCompressedStream, stored_offset, stored_len ? stored.get() : NULL,
+      stored_len,
+      base::Bind(&CompressedEntry::OnWriteComplete, this, buf_len, stored_len,
+                 callback),
+      true);
+  if (rv == net::ERR_IO_PENDING)
+    return rv;
+  if (rv != stored_len)
+    return rv < 0 ? rv : net::ERR_FAILED;
+  return buf_len;
+}
+
+int CompressedEntry::ReadSparseData(int64 offset, IOBuffer* buf, int buf_len,
+                                    const CompletionCallback& callback) {
+  return entry_->ReadSparseData(offset, buf, buf_len, callback);
+}
+
+int CompressedEntry::WriteSparseData(int64 offset, IOBuffer* buf, int buf_len,
+                                     const CompletionCallback& callback) {
+  return entry_->WriteSparseData(offset, buf, buf_len, callback);
+}
+
+int CompressedEntry::GetAvailableRange(int64 offset, int len, int64* start,
+                                       const CompletionCallback& callback) {
+  return entry_->GetAvailableRange(offset, len, start, callback);
+}
+
+bool CompressedEntry::CouldBeSparse() const {
+  return entry_->CouldBeSparse();
+}
+
+void CompressedEntry::CancelSparseIO() {
+  entry_->CancelSparseIO();
+}
+
+int CompressedEntry::ReadyForSparseIO(const CompletionCallback& callback) {
+  return entry_->ReadyForSparseIO(callback);
+}
+
+CompressedEntry::CompressedEntry(Entry* entry)
+    : entry_(entry),
+      compressed_(false),
+      data_size_(0),
+      pending_stored_len_(0),
+      frame_data_index_(-1),
+      written_(false) {
+  Reset(0);
+}
+
+CompressedEntry::~CompressedEntry() {
+  DCHECK(!entry_);
+}
+
+void CompressedEntry::Reset(int32 data_size) {
+  data_size_ = data_size;
+  frame_offsets_.assign(1, 0);
+  pending_data_.clear();
+  pending_stored_len_ = 0;
+  frame_data_index_ = -1;
+  frame_data_.clear();
+}
+
+int CompressedEntry::ReadFrame(const ReadOperation& op) {
+  // Pending operations may still be running after Close().
+  if (!entry_)
+    return net::ERR_FAILED;
+
+  while (static_cast<int>(frame_offsets_.size()) <= op.frame) {
+    int header_frame = static_cast<int>(frame_offsets_.size()) - 1;
+    scoped_refptr<IOBuffer> header(new IOBuffer(kHeaderSize));
+    int rv = entry_->ReadData(
+        kCompressedStream, frame_offsets_.back(), header.get(), kHeaderSize,
+        base::Bind(&CompressedEntry::OnFrameHeaderRead, this, op,
+                   header_frame, header));
+    if (rv == net::ERR_IO_PENDING)
+      return rv;
+    rv = AddFrame(header_frame, header.get(), rv);
+    if (rv != net::OK)
+      return rv;
+  }
+
+  scoped_refptr<IOBuffer> stored(new IOBuffer(kMaxStoredFrameSize));
+  int rv = entry_->ReadData(
+      kCompressedStream, frame_offsets_[op.frame], stored.get(),
+      kMaxStoredFrameSize,
+      base::Bind(&CompressedEntry::OnFrameRead, this, op, stored));
+  if (rv == net::ERR_IO_PENDING)
+    return rv;
+  return DecodeFrame(op, stored.get(), rv);
+}
+
+void CompressedEntry::OnFrameHeaderRead(const ReadOperation& op,
+                                        int header_frame,
+                                        scoped_refptr<IOBuffer> header,
+                                        int result) {
+  result = AddFrame(header_frame, header.get(), result);
+  if (result == net::OK)
+    result = ReadFrame(op);
+  if (result != net::ERR_IO_PENDING)
+    op.callback.Run(result);
+}
+
+void CompressedEntry::OnFrameRead(const ReadOperation& op,
+                                  scoped_refptr<IOBuffer> stored,
+                                  int result) {
+  op.callback.Run(DecodeFrame(op, stored.get(), result));
+}
+
+int CompressedEntry::AddFrame(int frame, IOBuffer* header, int result) {
+  if (result < 0)
+    return result;
+  int stored_len;
+  bool compressed;
+  if (result != kHeaderSize ||
+      !ParseHeader(header->data(), &stored_len, &compressed)) {
+    return net::ERR_FAILED;
+  }
+
+  // Another read may have found this frame already.
+  if (static_cast<int>(frame_offsets_.size()) == frame + 1) {
+    frame_offsets_.push_back(frame_offsets_.back() + kHeaderSize +
+                             stored_len);
+  }
+  return net::OK;
+}
+
+int CompressedEntry::DecodeFrame(const ReadOperation& op, IOBuffer* stored,
+                                 int result) {
+  if (result < 0)
+    return result;
+  int stored_len;
+  bool compressed;
+  if (result < kHeaderSize ||
+      !ParseHeader(stored->data(), &stored_len, &compressed) ||
+      kHeaderSize + stored_len > result) {
+    return net::ERR_FAILED;
+  }
+
+  int frame_len = std::min(kFrameSize, data_size_ - op.frame * kFrameSize);
+  const char* data = stored->data() + kHeaderSize;
+  frame_data_index_ = -1;
+  if (!compressed) {
+    if (stored_len != frame_len)
+      return net::ERR_FAILED;
+    frame_data_.assign(data, stored_len);
+  } else {
+    frame_data_.resize(frame_len);
+    uLongf len = frame_len;
+    base::TimeTicks start = base::TimeTicks::Now();
+    int rv = uncompress(reinterpret_cast<Bytef*>(&frame_data_[0]), &len,
+                        reinterpret_cast<const Bytef*>(data), stored_len);
+    UMA_HISTOGRAM_CUSTOM_COUNTS(
+        "DiskCache.CompressedEntry.DecompressTime",
+        (base::TimeTicks::Now() - start).InMicroseconds(), 1, 100000, 50);
+    if (rv != Z_OK || len != static_cast<uLongf>(frame_len))
+      return net::ERR_FAILED;
+  }
+  frame_data_index_ = op.frame;
+
+  if (static_cast<int>(frame_offsets_.size()) == op.frame + 1) {
+    frame_offsets_.push_back(frame_offsets_.back() + kHeaderSize +
+                             stored_len);
+  }
+  return CopyFromFrame(op.offset, op.buf.get(), op.buf_len);
+}
+
+int CompressedEntry::CopyFromFrame(int offset, IOBuffer* buf, int buf_len) {
+  DCHECK_GE(frame_data_index_, 0);
+  int start = offset - frame_data_index_ * kFrameSize;
+  int len = std::min(buf_len, static_cast<int>(frame_data_.size()) - start);
+  DCHECK_GT(len, 0);
+  memcpy(buf->data(), frame_data_.data() + start, len);
+  return len;
+}
+
+void CompressedEntry::AppendFrame(const char* data, int len,
+                                  std::string* output) {
+  size_t frame_start = output->size();
+  uLongf stored_len = compressBound(len);
+  output->resize(frame_start + kHeaderSize + stored_len);
+  char* stored = &(*output)[frame_start + kHeaderSize];
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  int rv = compress2(reinterpret_cast<Bytef*>(stored), &stored_len,
+                     reinterpret_cast<const Bytef*>(data), len, Z_BEST_SPEED);
+  UMA_HISTOGRAM_CUSTOM_COUNTS(
+      "DiskCache.CompressedEntry.CompressTime",
+      (base::TimeTicks::Now() - start).InMicroseconds(), 1, 100000, 50);
+
+  uint32 header = static_cast<uint32>(stored_len);
+  if (rv != Z_OK || stored_len >= static_cast<uLongf>(len)) {
+    memcpy(stored, data, len);
+    stored_len = len;
+    header = static_cast<uint32>(len) | kUncompressedFrame;
+  }
+  memcpy(&(*output)[frame_start], &header, kHeaderSize);
+  output->resize(frame_start + kHeaderSize + stored_len);
+}
+
+void CompressedEntry::OnWriteComplete(int buf_len, int stored_len,
+                                      const CompletionCallback& callback,
+                                      int result) {
+  if (result == stored_len)
+    result = buf_len;
+  else if (result >= 0)
+    result = net::ERR_FAILED;
+  callback.Run(result);
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,147 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_COMPRESSED_ENTRY_H_
+#define NET_DISK_CACHE_COMPRESSED_ENTRY_H_
+
+#include <string>
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "net/base/net_export.h"
+#include "net/disk_cache/disk_cache.h"
+
+namespace disk_cache {
+
+// Wraps an entry of any backend so that one of its streams can be stored
+// compressed with zlib. The stream is split in frames of kFrameSize bytes of
+// data, and every frame is compressed on its own, so reading from any offset
+// only decompresses the frame that holds it. Each frame is stored as a 32-bit
+// header followed by the compressed bytes, or by the original bytes when they
+// do not compress.
+//
+// Until SetCompressed() is called, or for any other stream, every call is
+// forwarded to the wrapped entry. A compressed stream can only be written
+// sequentially: each write has to start at offset 0 (which truncates the
+// stream) or where the last one ended. The size of the data has to be known
+// when an existing stream is opened, because the frames do not record it.
+class NET_EXPORT_PRIVATE CompressedEntry
+    : public Entry,
+      public base::RefCounted<CompressedEntry> {
+ public:
+  // The stream that may be compressed.
+  static const int kCompressedStream = 1;
+
+  // The amount of data stored on each frame.
+  static const int kFrameSize = 16 * 1024;
+
+  // Returns a new object that wraps |entry| and takes ownership of it. Both are
+  // released when Close() is called.
+  static CompressedEntry* Create(Entry* entry);
+
+  // Sets whether kCompressedStream is compressed. |data_size| is the size of
+  // the uncompressed data already stored, which is ignored for writers since
+  // they start by truncating the stream.
+  void SetCompressed(bool compressed, int32 data_size);
+  bool compressed() const { return compressed_; }
+
+  // Entry interface.
+  virtual void Doom() OVERRIDE;
+  virtual void Close() OVERRIDE;
+  virtual std::string GetKey() const OVERRIDE;
+  virtual base::Time GetLastUsed() const OVERRIDE;
+  virtual base::Time GetLastModified() const OVERRIDE;
+  virtual int32 GetDataSize(int index) const OVERRIDE;
+  virtual int ReadData(int index, int offset, IOBuffer* buf, int buf_len,
+                       const CompletionCallback& callback) OVERRIDE;
+  virtual int WriteData(int index, int offset, IOBuffer* buf, int buf_len,
+                        const CompletionCallback& callback,
+                        bool truncate) OVERRIDE;
+  virtual int ReadSparseData(int64 offset, IOBuffer* buf, int buf_len,
+                             const CompletionCallback& callback) OVERRIDE;
+  virtual int WriteSparseData(int64 offset, IOBuffer* buf, int buf_len,
+                              const CompletionCallback& callback) OVERRIDE;
+  virtual int GetAvailableRange(int64 offset, int len, int64* start,
+                                const CompletionCallback& callback) OVERRIDE;
+  virtual bool CouldBeSparse() const OVERRIDE;
+  virtual void CancelSparseIO() OVERRIDE;
+  virtual int ReadyForSparseIO(const CompletionCallback& callback) OVERRIDE;
+
+ private:
+  friend class base::RefCounted<CompressedEntry>;
+
+  explicit CompressedEntry(Entry* entry);
+  virtual ~CompressedEntry();
+
+  // Forgets everything known about the stored frames.
+  void Reset(int32 data_size);
+
+  // A ReadData() call on the compressed stream.
+  struct ReadOperation {
+    ReadOperation();
+    ~ReadOperation();
+
+    int frame;
+    int offset;
+    scoped_refptr<IOBuffer> buf;
+    int buf_len;
+    CompletionCallback callback;
+  };
+
+  // Reads the frame that holds the data requested by |op|, and copies the data
+  // from it. The position of the frame is found by reading the headers of the
+  // frames before it, if needed.
+  int ReadFrame(const ReadOperation& op);
+  void OnFrameHeaderRead(const ReadOperation& op, int header_frame,
+                         scoped_refptr<IOBuffer> header, int result);
+  void OnFrameRead(const ReadOperation& op, scoped_refptr<IOBuffer> stored,
+                   int result);
+
+  // Records the position of the frame after |frame|, given the |header| of
+  // |frame| and the |result| of reading it. Returns a net error code.
+  int AddFrame(int frame, IOBuffer* header, int result);
+
+  // Decompresses the frame read by |op| from |stored| into |frame_data_| and
+  // copies the requested data to the buffer of |op|. Returns the number of
+  // bytes copied or a net error code.
+  int DecodeFrame(const ReadOperation& op, IOBuffer* stored, int result);
+
+  // Copies data from |frame_data_| to |buf|.
+  int CopyFromFrame(int offset, IOBuffer* buf, int buf_len);
+
+  // Appends a frame holding |data| to |output|.
+  void AppendFrame(const char* data, int len, std::string* output);
+
+  void OnWriteComplete(int buf_len, int stored_len,
+                       const CompletionCallback& callback, int result);
+
+  Entry* entry_;
+  bool compressed_;
+
+  // Size of the uncompressed data.
+  int32 data_size_;
+
+  // Position of each frame that is known to be stored. The last one is the
+  // position of the first frame whose header has not been read yet, or of
+  // the frame being written.
+  std::vector<int> frame_offsets_;
+
+  // Data that belongs to the last, incomplete frame, and the number of bytes
+  // used to store it.
+  std::string pending_data_;
+  int pending_stored_len_;
+
+  // The last frame that was decompressed.
+  int frame_data_index_;
+  std::string frame_data_;
+
+  // Whether this object wrote to the stream since it was opened.
+  bool written_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompressedEntry);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_COMPRESSED_ENTRY_H_
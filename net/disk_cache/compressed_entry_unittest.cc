@@ -0,0 +1,144 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/compressed_entry.h"
+
+#include <algorithm>
+#include <string>
+
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/disk_cache/disk_cache_test_base.h"
+#include "net/disk_cache/disk_cache_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using disk_cache::CompressedEntry;
+
+namespace {
+
+// Returns |size| bytes of text that compresses well.
+std::string CreateText(int size) {
+  std::string text;
+  for (int i = 0; text.size() < static_cast<size_t>(size); ++i)
+    text += "Line " + std::string(1, 'a' + i % 26) + " of some text.\n";
+  text.resize(size);
+  return text;
+}
+
+}  // namespace
+
+class DiskCacheCompressedEntryTest : public DiskCacheTestWithCache {
+ protected:
+  void ReadWrite();
+
+  // Reads |len| bytes at |offset| from the compressed stream of |entry|.
+  std::string Read(disk_cache::Entry* entry, int offset, int len);
+};
+
+std::string DiskCacheCompressedEntryTest::Read(disk_cache::Entry* entry,
+                                               int offset, int len) {
+  std::string result;
+  while (len) {
+    scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(len));
+    int rv = ReadData(entry, CompressedEntry::kCompressedStream, offset,
+                      buf.get(), len);
+    if (rv <= 0)
+      break;
+    result.append(buf->data(), rv);
+    offset += rv;
+    len -= rv;
+  }
+  return result;
+}
+
+void DiskCacheCompressedEntryTest::ReadWrite() {
+  const int kSize = 2 * CompressedEntry::kFrameSize + 1000;
+  std::string text = CreateText(kSize);
+
+  disk_cache::Entry* raw_entry = NULL;
+  ASSERT_EQ(net::OK, CreateEntry("the key", &raw_entry));
+  CompressedEntry* entry = CompressedEntry::Create(raw_entry);
+  entry->SetCompressed(true, 0);
+
+  // Write in pieces that do not match the frames.
+  const int kPieceSize = 5000;
+  for (int offset = 0; offset < kSize; offset += kPieceSize) {
+    int len = std::min(kPieceSize, kSize - offset);
+    scoped_refptr<net::IOBuffer> buf(
+        new net::StringIOBuffer(text.substr(offset, len)));
+    EXPECT_EQ(len, WriteData(entry, CompressedEntry::kCompressedStream, offset,
+                             buf.get(), len, false));
+  }
+  EXPECT_EQ(kSize, entry->GetDataSize(CompressedEntry::kCompressedStream));
+
+  // Writes can only append to the stream.
+  scoped_refptr<net::IOBuffer> buf(new net::StringIOBuffer("x"));
+  EXPECT_EQ(net::ERR_INVALID_ARGUMENT,
+            WriteData(entry, CompressedEntry::kCompressedStream, 10, buf.get(),
+                      1, false));
+
+  // Other streams are not compressed.
+  EXPECT_EQ(1, WriteData(entry, 0, 0, buf.get(), 1, true));
+  EXPECT_EQ(1, entry->GetDataSize(0));
+  EXPECT_EQ(text, Read(entry, 0, kSize));
+  entry->Close();
+
+  // Read ranges of a new object, which has to find the frames on its own.
+  ASSERT_EQ(net::OK, OpenEntry("the key", &raw_entry));
+  EXPECT_GT(kSize / 2,
+            raw_entry->GetDataSize(CompressedEntry::kCompressedStream));
+  entry = CompressedEntry::Create(raw_entry);
+  entry->SetCompressed(true, kSize);
+  EXPECT_EQ(text.substr(kSize - 100), Read(entry, kSize - 100, 200));
+  EXPECT_EQ(text.substr(CompressedEntry::kFrameSize - 10, 20),
+            Read(entry, CompressedEntry::kFrameSize - 10, 20));
+  EXPECT_EQ(text.substr(10, 10), Read(entry, 10, 10));
+  EXPECT_EQ("", Read(entry, kSize, 10));
+
+  // Writing from the start replaces the stream.
+  buf = new net::StringIOBuffer(text.substr(0, 100));
+  EXPECT_EQ(100, WriteData(entry, CompressedEntry::kCompressedStream, 0,
+                           buf.get(), 100, true));
+  EXPECT_EQ(100, entry->GetDataSize(CompressedEntry::kCompressedStream));
+  EXPECT_EQ(text.substr(0, 100), Read(entry, 0, kSize));
+  entry->Close();
+}
+
+TEST_F(DiskCacheCompressedEntryTest, ReadWrite) {
+  InitCache();
+  ReadWrite();
+}
+
+TEST_F(DiskCacheCompressedEntryTest, MemoryOnlyReadWrite) {
+  SetMemoryOnlyMode();
+  InitCache();
+  ReadWrite();
+}
+
+TEST_F(DiskCacheCompressedEntryTest, SimpleCacheReadWrite) {
+  SetSimpleCacheMode();
+  InitCache();
+  ReadWrite();
+}
+
+// Tests that data that does not compress is stored as it is.
+TEST_F(DiskCacheCompressedEntryTest, IncompressibleData) {
+  InitCache();
+  const int kSize = CompressedEntry::kFrameSize + 100;
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buf->data(), kSize, false);
+
+  disk_cache::Entry* raw_entry = NULL;
+  ASSERT_EQ(net::OK, CreateEntry("the key", &raw_entry));
+  CompressedEntry* entry = CompressedEntry::Create(raw_entry);
+  entry->SetCompressed(true, 0);
+  EXPECT_EQ(kSize, WriteData(entry, CompressedEntry::kCompressedStream, 0,
+                             buf.get(), kSize, true));
+
+  // Each frame only adds its header.
+  EXPECT_EQ(kSize + 8,
+            raw_entry->GetDataSize(CompressedEntry::kCompressedStream));
+  EXPECT_EQ(std::string(buf->data(), kSize), Read(entry, 0, kSize));
+  entry->Close();
+}
@@ -9,6 +9,7 @@
 #include "base/bind_helpers.h"
 #include "base/hash.h"
 #include "base/strings/string_util.h"
+#include "base/test/perf_log.h"
 #include "base/test/perf_time_logger.h"
 #include "base/test/test_file_util.h"
 #include "base/threading/thread.h"
@@ -22,6 +23,8 @@
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/disk_cache_test_base.h"
 #include "net/disk_cache/disk_cache_test_util.h"
+#include "net/disk_cache/in_flight_backend_io.h"
+#include "net/disk_cache/simple/simple_backend_impl.h"
 #include "testing/gtest/include/gtest/gtest.h"
 #include "testing/platform_test.h"
 
@@ -39,8 +42,8 @@ const int kMaxSize = 16 * 1024 - 1;
 
 // Creates num_entries on the cache, and writes 200 bytes of metadata and up
 // to kMaxSize of data to each entry.
-bool TimeWrite(int num_entries, disk_cache::Backend* cache,
-              TestEntries* entries) {
+bool TimeWrite(const char* message, int num_entries,
+               disk_cache::Backend* cache, TestEntries* entries) {
   const int kSize1 = 200;
   scoped_refptr<net::IOBuffer> buffer1(new net::IOBuffer(kSize1));
   scoped_refptr<net::IOBuffer> buffer2(new net::IOBuffer(kMaxSize));
@@ -53,7 +56,7 @@ bool TimeWrite(int num_entries, disk_cache::Backend* cache,
   MessageLoopHelper helper;
   CallbackTest callback(&helper, true);
 
-  base::PerfTimeLogger timer("Write disk cache entries");
+  base::PerfTimeLogger timer(message);
 
   for (int i = 0; i < num_entries; i++) {
     TestEntry entry;
@@ -178,7 +181,8 @@ TEST_F(DiskCacheTest, CacheBackendPerformance) {
   TestEntries entries;
   int num_entries = 1000;
 
-  EXPECT_TRUE(TimeWrite(num_entries, cache.get(), &entries));
+  EXPECT_TRUE(TimeWrite("Write disk cache entries", num_entries, cache.get(),
+                        &entries));
 
   base::MessageLoop::current()->RunUntilIdle();
   cache.reset();
@@ -206,6 +210,135 @@ TEST_F(DiskCacheTest, CacheBackendPerformance) {
   base::MessageLoop::current()->RunUntilIdle();
 }
 
+// Writes many entries, as a cache that keeps taking in new resources does, to
+// a simple cache and to a flash cache, which writes whole segments at a time.
+TEST_F(DiskCacheTest, WriteHeavyBackendPerformance) {
+  base::Thread cache_thread("CacheThread");
+  ASSERT_TRUE(cache_thread.StartWithOptions(
+                  base::Thread::Options(base::MessageLoop::TYPE_IO, 0)));
+
+  const net::BackendType kBackendTypes[] = {
+    net::CACHE_BACKEND_SIMPLE,
+    net::CACHE_BACKEND_FLASH,
+  };
+  const char* const kMessages[] = {
+    "Write entries (simple cache)",
+    "Write entries (flash cache)",
+  };
+  const char* const kFlushMessages[] = {
+    "Finish writing entries (simple cache)",
+    "Finish writing entries (flash cache)",
+  };
+  const int kNumEntries = 3000;
+
+  for (size_t i = 0; i < arraysize(kBackendTypes); i++) {
+    ASSERT_TRUE(CleanupCacheDir());
+    net::TestCompletionCallback cb;
+    scoped_ptr<disk_cache::Backend> cache;
+    int rv = disk_cache::CreateCacheBackend(
+        net::DISK_CACHE, kBackendTypes[i], cache_path_, 0, false,
+        cache_thread.message_loop_proxy().get(), NULL, &cache, cb.callback());
+    ASSERT_EQ(net::OK, cb.GetResult(rv));
+
+    TestEntries entries;
+    EXPECT_TRUE(TimeWrite(kMessages[i], kNumEntries, cache.get(), &entries));
+
+    // Both backends finish their writes in the background.
+    base::PerfTimeLogger timer(kFlushMessages[i]);
+    base::MessageLoop::current()->RunUntilIdle();
+    cache.reset();
+    disk_cache::SimpleBackendImpl::FlushWorkerPoolForTesting();
+    cache_thread.message_loop_proxy()->PostTaskAndReply(
+        FROM_HERE, base::Bind(&base::DoNothing),
+        base::Bind(cb.callback(), net::OK));
+    EXPECT_EQ(net::OK, cb.WaitForResult());
+    timer.Done();
+  }
+}
+
+// Simulates the cache traffic of a page load with many subresources: all the
+// entries are opened, and then read, without waiting for each other. Reports
+// how many tasks the cache thread and the IO thread ran for all those
+// operations; operations posted or completed close together share a task.
+TEST_F(DiskCacheTest, PageLoadThreadWakeups) {
+  base::Thread cache_thread("CacheThread");
+  ASSERT_TRUE(cache_thread.StartWithOptions(
+                  base::Thread::Options(base::MessageLoop::TYPE_IO, 0)));
+
+  ASSERT_TRUE(CleanupCacheDir());
+  net::TestCompletionCallback cb;
+  scoped_ptr<disk_cache::Backend> cache;
+  int rv = disk_cache::CreateCacheBackend(
+      net::DISK_CACHE, net::CACHE_BACKEND_BLOCKFILE, cache_path_, 0, false,
+      cache_thread.message_loop_proxy().get(), NULL, &cache, cb.callback());
+  ASSERT_EQ(net::OK, cb.GetResult(rv));
+
+  const int kNumSubresources = 200;
+  const int kSize = 4096;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(buffer->data(), kSize, false);
+
+  std::vector<std::string> keys;
+  for (int i = 0; i < kNumSubresources; i++) {
+    keys.push_back(GenerateKey(true));
+    disk_cache::Entry* entry;
+    rv = cache->CreateEntry(keys.back(), &entry, cb.callback());
+    ASSERT_EQ(net::OK, cb.GetResult(rv));
+    rv = entry->WriteData(1, 0, buffer.get(), kSize, cb.callback(), false);
+    ASSERT_EQ(kSize, cb.GetResult(rv));
+    entry->Close();
+  }
+  base::MessageLoop::current()->RunUntilIdle();
+
+  base::WeakPtr<disk_cache::InFlightBackendIO> queue =
+      static_cast<disk_cache::BackendImpl*>(cache.get())->GetBackgroundQueue();
+  disk_cache::BackgroundIOQueue* operations = queue->operation_queue();
+  disk_cache::BackgroundIOQueue* completions = queue->completion_queue();
+  int operations_before = operations->operations_added();
+  int cache_tasks_before = operations->tasks_posted();
+  int io_tasks_before = completions->tasks_posted();
+
+  MessageLoopHelper helper;
+  CallbackTest callback(&helper, true);
+  int expected = 0;
+  std::vector<disk_cache::Entry*> entries(kNumSubresources);
+
+  base::PerfTimeLogger timer("Page load from the disk cache");
+  for (int i = 0; i < kNumSubresources; i++) {
+    rv = cache->OpenEntry(
+        keys[i], &entries[i],
+        base::Bind(&CallbackTest::Run, base::Unretained(&callback)));
+    ASSERT_EQ(net::ERR_IO_PENDING, rv);
+    expected++;
+  }
+  ASSERT_TRUE(helper.WaitUntilCacheIoFinished(expected));
+
+  for (int i = 0; i < kNumSubresources; i++) {
+    rv = entries[i]->ReadData(
+        1, 0, buffer.get(), kSize,
+        base::Bind(&CallbackTest::Run, base::Unretained(&callback)));
+    if (net::ERR_IO_PENDING == rv)
+      expected++;
+    else
+      ASSERT_EQ(kSize, rv);
+  }
+  ASSERT_TRUE(helper.WaitUntilCacheIoFinished(expected));
+  timer.Done();
+
+  int num_operations = operations->operations_added() - operations_before;
+  base::LogPerfResult("Page load cache operations", num_operations,
+                      "operations");
+  base::LogPerfResult("Page load cache thread wakeups",
+                      operations->tasks_posted() - cache_tasks_before,
+                      "tasks");
+  base::LogPerfResult("Page load IO thread wakeups",
+                      completions->tasks_posted() - io_tasks_before, "tasks");
+
+  for (int i = 0; i < kNumSubresources; i++)
+    entries[i]->Close();
+  base::MessageLoop::current()->RunUntilIdle();
+}
+
 // Creating and deleting "entries" on a block-file is something quite frequent
 // (after all, almost everything is stored on block files). The operation is
 // almost free when the file is empty, but can be expensive if the file gets
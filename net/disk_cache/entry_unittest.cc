@@ -6,6 +6,7 @@
 #include "base/bind.h"
 #include "base/bind_helpers.h"
 #include "base/file_util.h"
+#include "base/metrics/field_trial.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
 #include "base/threading/platform_thread.h"
@@ -3972,4 +3973,62 @@ TEST_F(DiskCacheEntryTest, SimpleCacheTruncateLargeSparseFile) {
   entry->Close();
 }
 
+// Tests that with mapped reads, stream 1 of a small entry is read without
+// waiting on the worker pool, until it is written to.
+TEST_F(DiskCacheEntryTest, SimpleCacheMappedReads) {
+  base::FieldTrialList field_trial_list(NULL);
+  base::FieldTrialList::CreateFieldTrial("SimpleCacheMappedReads", "Enabled");
+  SetSimpleCacheMode();
+  InitCache();
+
+  const char key[] = "the first key";
+  const int kSize = 1000;
+  scoped_refptr<net::IOBuffer> write_buffer(new net::IOBuffer(kSize));
+  scoped_refptr<net::IOBuffer> read_buffer(new net::IOBuffer(kSize));
+  CacheTestFillBuffer(write_buffer->data(), kSize, false);
+
+  disk_cache::Entry* entry = NULL;
+  ASSERT_EQ(net::OK, CreateEntry(key, &entry));
+  EXPECT_EQ(kSize, WriteData(entry, 1, 0, write_buffer.get(), kSize, false));
+  entry->Close();
+
+  ASSERT_EQ(net::OK, OpenEntry(key, &entry));
+  ScopedEntryPtr entry_closer(entry);
+  net::TestCompletionCallback cb;
+  EXPECT_EQ(kSize,
+            entry->ReadData(1, 0, read_buffer.get(), kSize, cb.callback()));
+  EXPECT_EQ(0, memcmp(write_buffer->data(), read_buffer->data(), kSize));
+  EXPECT_EQ(kSize / 2, entry->ReadData(1, kSize / 2, read_buffer.get(),
+                                       kSize, cb.callback()));
+  EXPECT_EQ(0, memcmp(write_buffer->data() + kSize / 2, read_buffer->data(),
+                      kSize / 2));
+
+  // Writing stream 1 drops the mapping; reads go to the files again.
+  CacheTestFillBuffer(write_buffer->data(), kSize, false);
+  EXPECT_EQ(kSize, WriteData(entry, 1, 0, write_buffer.get(), kSize, false));
+  EXPECT_EQ(kSize, ReadData(entry, 1, 0, read_buffer.get(), kSize));
+  EXPECT_EQ(0, memcmp(write_buffer->data(), read_buffer->data(), kSize));
+}
+
+// Tests that an entry whose stream 1 has a bad checksum is not mapped, and
+// fails to be read like it does with the worker pool.
+TEST_F(DiskCacheEntryTest, SimpleCacheMappedReadsBadChecksum) {
+  base::FieldTrialList field_trial_list(NULL);
+  base::FieldTrialList::CreateFieldTrial("SimpleCacheMappedReads", "Enabled");
+  SetSimpleCacheMode();
+  InitCache();
+
+  const char key[] = "the first key";
+  int size;
+  ASSERT_TRUE(SimpleCacheMakeBadChecksumEntry(key, &size));
+
+  disk_cache::Entry* entry = NULL;
+  ASSERT_EQ(net::OK, OpenEntry(key, &entry));
+  ScopedEntryPtr entry_closer(entry);
+  scoped_refptr<net::IOBuffer> read_buffer(new net::IOBuffer(size));
+  EXPECT_EQ(net::ERR_CACHE_CHECKSUM_MISMATCH,
+            ReadData(entry, 1, 0, read_buffer.get(), size));
+  DisableIntegrityCheck();
+}
+
 #endif  // defined(OS_POSIX)
@@ -0,0 +1,94 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/eviction_policy.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "base/compiler_specific.h"
+#include "base/logging.h"
+
+namespace {
+
+// Entries used within this many seconds are considered equally recent by the
+// size-aware policy, which keeps it from discarding large entries that were
+// just stored.
+const double kMinAgeSeconds = 60.0;
+
+// The size-aware policy measures the size of entries in units of this many
+// bytes.
+const double kSizeUnit = 1024.0;
+
+double GetAgeInSeconds(base::Time last_used, base::Time now) {
+  // The clock may have gone backwards since the entry was used.
+  return std::max(0.0, (now - last_used).InSecondsF());
+}
+
+class LRUPolicy : public disk_cache::EvictionPolicy {
+ public:
+  LRUPolicy() {}
+
+  virtual Type type() const OVERRIDE { return LRU; }
+
+  virtual double GetRetentionValue(
+      const disk_cache::EvictionCandidate& candidate,
+      base::Time now) const OVERRIDE {
+    return -GetAgeInSeconds(candidate.last_used, now);
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(LRUPolicy);
+};
+
+// A variant of Greedy-Dual-Size-Frequency where the inflation value that ages
+// the entries is replaced by the time since they were last used, as LRFU does.
+// The size only tempers the value by its square root, so that the byte hit
+// ratio does not suffer as much as with a plain GDSF.
+class SizeAwarePolicy : public disk_cache::EvictionPolicy {
+ public:
+  SizeAwarePolicy() {}
+
+  virtual Type type() const OVERRIDE { return SIZE_AWARE; }
+
+  virtual double GetRetentionValue(
+      const disk_cache::EvictionCandidate& candidate,
+      base::Time now) const OVERRIDE {
+    double age = GetAgeInSeconds(candidate.last_used, now) + kMinAgeSeconds;
+    double size = 1.0 + std::max<int64>(0, candidate.size) / kSizeUnit;
+    double hits = 1.0 + std::max(0, candidate.use_count);
+    return hits / (age * sqrt(size));
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(SizeAwarePolicy);
+};
+
+}  // namespace
+
+namespace disk_cache {
+
+EvictionCandidate::EvictionCandidate() : size(0), use_count(0) {
+}
+
+EvictionCandidate::EvictionCandidate(base::Time last_used,
+                                     int64 size,
+                                     int32 use_count)
+    : last_used(last_used), size(size), use_count(use_count) {
+}
+
+// static
+scoped_ptr<EvictionPolicy> EvictionPolicy::Create(Type type) {
+  switch (type) {
+    case LRU:
+      return scoped_ptr<EvictionPolicy>(new LRUPolicy());
+    case SIZE_AWARE:
+      return scoped_ptr<EvictionPolicy>(new SizeAwarePolicy());
+  }
+  NOTREACHED();
+  return scoped_ptr<EvictionPolicy>();
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,55 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_EVICTION_POLICY_H_
+#define NET_DISK_CACHE_EVICTION_POLICY_H_
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
+#include "net/base/net_export.h"
+
+namespace disk_cache {
+
+// What an eviction policy knows about an entry of the cache.
+struct NET_EXPORT_PRIVATE EvictionCandidate {
+  EvictionCandidate();
+  EvictionCandidate(base::Time last_used, int64 size, int32 use_count);
+
+  base::Time last_used;
+  int64 size;
+  // Number of times the entry was used after being stored, when the backend
+  // keeps track of it.
+  int32 use_count;
+};
+
+// An EvictionPolicy decides which entries a backend should get rid of first
+// when the cache is full.  Backends rank their entries by the value returned
+// by GetRetentionValue(), and evict the entries with the lowest values first.
+class NET_EXPORT_PRIVATE EvictionPolicy {
+ public:
+  enum Type {
+    // Least recently used entries go first.
+    LRU,
+    // Balances recency with the number of hits and the size of the entries,
+    // so that a single large entry does not push out many small ones that are
+    // used just as often.
+    SIZE_AWARE
+  };
+
+  virtual ~EvictionPolicy() {}
+
+  static scoped_ptr<EvictionPolicy> Create(Type type);
+
+  virtual Type type() const = 0;
+
+  // Returns how valuable |candidate| is at |now|; only the order of the values
+  // returned for the entries of a cache is meaningful.
+  virtual double GetRetentionValue(const EvictionCandidate& candidate,
+                                   base::Time now) const = 0;
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_EVICTION_POLICY_H_
@@ -0,0 +1,57 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/eviction_policy.h"
+
+#include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace disk_cache {
+
+TEST(DiskCacheEvictionPolicyTest, LRU) {
+  scoped_ptr<EvictionPolicy> policy(
+      EvictionPolicy::Create(EvictionPolicy::LRU));
+  EXPECT_EQ(EvictionPolicy::LRU, policy->type());
+
+  base::Time now = base::Time::Now();
+  EvictionCandidate old_small(now - base::TimeDelta::FromHours(2), 10, 5);
+  EvictionCandidate recent_large(now - base::TimeDelta::FromHours(1),
+                                 50 * 1024 * 1024, 0);
+  EXPECT_LT(policy->GetRetentionValue(old_small, now),
+            policy->GetRetentionValue(recent_large, now));
+
+  // Entries used in the future are as recent as they can be.
+  EvictionCandidate future(now + base::TimeDelta::FromHours(1), 10, 0);
+  EXPECT_EQ(policy->GetRetentionValue(EvictionCandidate(now, 10, 0), now),
+            policy->GetRetentionValue(future, now));
+}
+
+TEST(DiskCacheEvictionPolicyTest, SizeAware) {
+  scoped_ptr<EvictionPolicy> policy(
+      EvictionPolicy::Create(EvictionPolicy::SIZE_AWARE));
+  EXPECT_EQ(EvictionPolicy::SIZE_AWARE, policy->type());
+
+  base::Time now = base::Time::Now();
+  base::Time hour_ago = now - base::TimeDelta::FromHours(1);
+  base::Time two_hours_ago = now - base::TimeDelta::FromHours(2);
+
+  // A large entry goes before a small one that was used a little earlier.
+  EvictionCandidate old_small(two_hours_ago, 10 * 1024, 0);
+  EvictionCandidate recent_large(hour_ago, 50 * 1024 * 1024, 0);
+  EXPECT_LT(policy->GetRetentionValue(recent_large, now),
+            policy->GetRetentionValue(old_small, now));
+
+  // Hits make an entry more valuable.
+  EvictionCandidate used_large(hour_ago, 50 * 1024 * 1024, 100);
+  EXPECT_LT(policy->GetRetentionValue(recent_large, now),
+            policy->GetRetentionValue(used_large, now));
+
+  // Recency still matters for entries of the same size.
+  EvictionCandidate old_large(two_hours_ago, 50 * 1024 * 1024, 0);
+  EXPECT_LT(policy->GetRetentionValue(old_large, now),
+            policy->GetRetentionValue(recent_large, now));
+}
+
+}  // namespace disk_cache
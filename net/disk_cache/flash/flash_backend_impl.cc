@@ -0,0 +1,388 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/disk_cache/flash/flash_backend_impl.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task_runner_util.h"
+#include "net/base/net_errors.h"
+#include "net/disk_cache/cache_util.h"
+#include "net/disk_cache/flash/flash_entry_impl.h"
+#include "net/disk_cache/flash/format.h"
+#include "net/disk_cache/flash/log_store.h"
+
+namespace disk_cache {
+
+namespace {
+
+const base::FilePath::CharType kStorageFileName[] =
+    FILE_PATH_LITERAL("flash_cache");
+
+// Segments with open entries are not reused by the store, so it needs a few
+// more than the one being written to.
+const int32 kMinNumSegments = 8;
+
+int32 GetStorageSize(int max_bytes) {
+  if (max_bytes <= 0)
+    max_bytes = kDefaultCacheSize;
+  int32 num_segments = std::max(max_bytes / kFlashSegmentSize,
+                                kMinNumSegments);
+  return num_segments * kFlashSegmentSize;
+}
+
+bool InitStore(const base::FilePath& path,
+               scoped_refptr<SharedLogStore> store) {
+  if (!base::PathExists(path) && !base::CreateDirectory(path)) {
+    LOG(ERROR) << "Unable to create the flash cache directory";
+    return false;
+  }
+  return store->Init();
+}
+
+}  // namespace
+
+SharedLogStore::SharedLogStore(const base::FilePath& path,
+                               int32 size,
+                               base::MessageLoopProxy* cache_thread)
+    : store_(new LogStore(path, size)),
+      cache_thread_(cache_thread),
+      init_(false) {
+}
+
+bool SharedLogStore::Init() {
+  DCHECK(cache_thread_->BelongsToCurrentThread());
+  init_ = store_->Init();
+  return init_;
+}
+
+SharedLogStore::~SharedLogStore() {
+  cache_thread_->PostTask(FROM_HERE, base::Bind(&SharedLogStore::CloseStore,
+                                                base::Passed(&store_), init_));
+}
+
+// static
+void SharedLogStore::CloseStore(scoped_ptr<LogStore> store, bool init) {
+  if (init)
+    store->Close();
+}
+
+FlashBackendImpl::EntryMetadata::EntryMetadata() : id(-1), generation(0) {
+}
+
+FlashBackendImpl::OpenRequest::OpenRequest(Entry** entry,
+                                           const CompletionCallback& callback)
+    : entry(entry),
+      callback(callback) {
+}
+
+FlashBackendImpl::OpenRequest::~OpenRequest() {
+}
+
+FlashBackendImpl::FlashBackendImpl(const base::FilePath& path,
+                                   int max_bytes,
+                                   base::MessageLoopProxy* cache_thread)
+    : path_(path),
+      storage_size_(GetStorageSize(max_bytes)),
+      cache_thread_(cache_thread),
+      store_(new SharedLogStore(path.Append(kStorageFileName), storage_size_,
+                                cache_thread)),
+      init_(false),
+      next_generation_(1),
+      segment_keys_(storage_size_ / kFlashSegmentSize),
+      write_segment_(0) {
+}
+
+FlashBackendImpl::~FlashBackendImpl() {
+}
+
+int FlashBackendImpl::Init(const CompletionCallback& callback) {
+  PostTaskAndReplyWithResult(
+      cache_thread_.get(),
+      FROM_HERE,
+      base::Bind(&InitStore, path_, store_),
+      base::Bind(&FlashBackendImpl::OnInitComplete, AsWeakPtr(), callback));
+  return net::ERR_IO_PENDING;
+}
+
+void FlashBackendImpl::OnEntryDoomed(FlashEntryImpl* entry) {
+  ActiveEntryMap::iterator it = active_entries_.find(entry->key());
+  if (it == active_entries_.end() || it->second != entry)
+    return;
+  active_entries_.erase(it);
+  RemoveFromIndex(entry->key());
+}
+
+void FlashBackendImpl::OnEntryClosed(FlashEntryImpl* entry) {
+  ActiveEntryMap::iterator it = active_entries_.find(entry->key());
+  if (it == active_entries_.end() || it->second != entry)
+    return;
+  active_entries_.erase(it);
+
+  EntryMap::iterator index_entry = entries_.find(entry->key());
+  if (entry->is_new() && index_entry != entries_.end() &&
+      index_entry->second.generation == entry->generation()) {
+    index_entry->second.last_modified = entry->GetLastModified();
+  }
+}
+
+void FlashBackendImpl::OnEntrySaved(const std::string& key,
+                                    int64 generation,
+                                    int32 id) {
+  if (id != -1) {
+    // The store moved on to another segment, discarding what was on it.
+    int32 segment = id / kFlashSegmentSize;
+    if (segment != write_segment_) {
+      EvictSegment(segment);
+      write_segment_ = segment;
+    }
+  }
+
+  EntryMap::iterator it = entries_.find(key);
+  if (it == entries_.end() || it->second.generation != generation)
+    return;
+  if (id == -1) {
+    entries_.erase(it);
+    return;
+  }
+  it->second.id = id;
+  segment_keys_[id / kFlashSegmentSize].insert(key);
+}
+
+net::CacheType FlashBackendImpl::GetCacheType() const {
+  return net::DISK_CACHE;
+}
+
+int32 FlashBackendImpl::GetEntryCount() const {
+  return static_cast<int32>(entries_.size());
+}
+
+int FlashBackendImpl::OpenEntry(const std::string& key, Entry** entry,
+                                const CompletionCallback& callback) {
+  return OpenEntryInternal(key, true, entry, callback);
+}
+
+int FlashBackendImpl::CreateEntry(const std::string& key, Entry** entry,
+                                  const CompletionCallback& callback) {
+  DCHECK(init_);
+  if (entries_.find(key) != entries_.end())
+    return net::ERR_FAILED;
+
+  EntryMetadata& metadata = entries_[key];
+  metadata.generation = next_generation_++;
+  metadata.last_used = base::Time::Now();
+  metadata.last_modified = metadata.last_used;
+
+  FlashEntryImpl* flash_entry =
+      new FlashEntryImpl(key, metadata.generation, store_.get(),
+                         cache_thread_.get(), AsWeakPtr());
+  flash_entry->Init(CompletionCallback());
+  flash_entry->AddRef();
+  active_entries_[key] = flash_entry;
+  *entry = flash_entry;
+  return net::OK;
+}
+
+int FlashBackendImpl::DoomEntry(const std::string& key,
+                                const CompletionCallback& callback) {
+  ActiveEntryMap::iterator it = active_entries_.find(key);
+  if (it != active_entries_.end()) {
+    it->second->Doom();
+    return net::OK;
+  }
+  if (entries_.find(key) == entries_.end())
+    return net::ERR_FAILED;
+  RemoveFromIndex(key);
+  return net::OK;
+}
+
+int FlashBackendImpl::DoomAllEntries(const CompletionCallback& callback) {
+  return DoomEntriesBetween(base::Time(), base::Time(), callback);
+}
+
+int FlashBackendImpl::DoomEntriesBetween(base::Time initial_time,
+                                         base::Time end_time,
+                                         const CompletionCallback& callback) {
+  std::vector<std::string> keys;
+  for (EntryMap::const_iterator it = entries_.begin(); it != entries_.end();
+       ++it) {
+    if (it->second.last_used >= initial_time &&
+        (end_time.is_null() || it->second.last_used < end_time)) {
+      keys.push_back(it->first);
+    }
+  }
+  for (size_t i = 0; i < keys.size(); ++i)
+    DoomEntry(keys[i], CompletionCallback());
+  return net::OK;
+}
+
+int FlashBackendImpl::DoomEntriesSince(base::Time initial_time,
+                                       const CompletionCallback& callback) {
+  return DoomEntriesBetween(initial_time, base::Time(), callback);
+}
+
+int FlashBackendImpl::OpenNextEntry(void** iter, Entry** next_entry,
+                                    const CompletionCallback& callback) {
+  if (!*iter) {
+    std::vector<std::string>* keys = new std::vector<std::string>;
+    keys->reserve(entries_.size());
+    for (EntryMap::const_iterator it = entries_.begin(); it != entries_.end();
+         ++it) {
+      keys->push_back(it->first);
+    }
+    *iter = keys;
+  }
+
+  std::vector<std::string>* keys = static_cast<std::vector<std::string>*>(*iter);
+  while (!keys->empty()) {
+    std::string key = keys->back();
+    keys->pop_back();
+    int rv = OpenEntryInternal(
+        key, false, next_entry,
+        base::Bind(&FlashBackendImpl::CheckIterationReturnValue, AsWeakPtr(),
+                   iter, next_entry, callback));
+    if (rv != net::ERR_FAILED)
+      return rv;
+  }
+  EndEnumeration(iter);
+  return net::ERR_FAILED;
+}
+
+void FlashBackendImpl::EndEnumeration(void** iter) {
+  delete static_cast<std::vector<std::string>*>(*iter);
+  *iter = NULL;
+}
+
+void FlashBackendImpl::GetStats(
+    std::vector<std::pair<std::string, std::string> >* stats) {
+  stats->push_back(std::make_pair(std::string("Cache type"),
+                                  std::string("Flash Cache")));
+  stats->push_back(std::make_pair(std::string("Entries"),
+                                  base::IntToString(GetEntryCount())));
+  stats->push_back(std::make_pair(
+      std::string("Segments"),
+      base::IntToString(static_cast<int>(segment_keys_.size()))));
+}
+
+void FlashBackendImpl::OnExternalCacheHit(const std::string& key) {
+  EntryMap::iterator it = entries_.find(key);
+  if (it != entries_.end())
+    it->second.last_used = base::Time::Now();
+}
+
+void FlashBackendImpl::OnInitComplete(const CompletionCallback& callback,
+                                      bool result) {
+  init_ = result;
+  callback.Run(result ? net::OK : net::ERR_FAILED);
+}
+
+int FlashBackendImpl::OpenEntryInternal(const std::string& key,
+                                        bool update_last_used,
+                                        Entry** entry,
+                                        const CompletionCallback& callback) {
+  DCHECK(init_);
+  OpenRequestMap::iterator pending = pending_opens_.find(key);
+  if (pending != pending_opens_.end()) {
+    pending->second.push_back(OpenRequest(entry, callback));
+    return net::ERR_IO_PENDING;
+  }
+
+  EntryMap::iterator it = entries_.find(key);
+  if (it == entries_.end())
+    return net::ERR_FAILED;
+  EntryMetadata& metadata = it->second;
+  if (update_last_used)
+    metadata.last_used = base::Time::Now();
+
+  ActiveEntryMap::iterator active = active_entries_.find(key);
+  if (active != active_entries_.end()) {
+    active->second->set_last_used(metadata.last_used);
+    active->second->AddRef();
+    *entry = active->second;
+    return net::OK;
+  }
+
+  // The entry is not in the store yet.
+  if (metadata.id == -1)
+    return net::ERR_FAILED;
+
+  scoped_refptr<FlashEntryImpl> flash_entry(
+      new FlashEntryImpl(key, metadata.id, metadata.last_used,
+                         metadata.last_modified, store_.get(),
+                         cache_thread_.get(), AsWeakPtr()));
+  pending_opens_[key].push_back(OpenRequest(entry, callback));
+  return flash_entry->Init(base::Bind(&FlashBackendImpl::OnEntryOpened,
+                                      AsWeakPtr(), key, metadata.id,
+                                      flash_entry));
+}
+
+void FlashBackendImpl::OnEntryOpened(const std::string& key,
+                                     int32 id,
+                                     scoped_refptr<FlashEntryImpl> entry,
+                                     int result) {
+  OpenRequestMap::iterator pending = pending_opens_.find(key);
+  DCHECK(pending != pending_opens_.end());
+  std::vector<OpenRequest> requests;
+  requests.swap(pending->second);
+  pending_opens_.erase(pending);
+
+  // The entry may have been doomed or evicted while it was being opened.
+  EntryMap::iterator it = entries_.find(key);
+  bool in_index = it != entries_.end() && it->second.id == id;
+  if (result == net::OK && !in_index)
+    result = net::ERR_FAILED;
+
+  if (result != net::OK) {
+    if (in_index)
+      RemoveFromIndex(key);
+    for (size_t i = 0; i < requests.size(); ++i)
+      requests[i].callback.Run(result);
+    return;
+  }
+
+  active_entries_[key] = entry.get();
+  for (size_t i = 0; i < requests.size(); ++i) {
+    entry->AddRef();
+    *requests[i].entry = entry.get();
+  }
+  for (size_t i = 0; i < requests.size(); ++i)
+    requests[i].callback.Run(net::OK);
+}
+
+void FlashBackendImpl::CheckIterationReturnValue(
+    void** iter,
+    Entry** next_entry,
+    const CompletionCallback& callback,
+    int result) {
+  if (result == net::ERR_FAILED) {
+    result = OpenNextEntry(iter, next_entry, callback);
+    if (result == net::ERR_IO_PENDING)
+      return;
+  }
+  callback.Run(result);
+}
+
+void FlashBackendImpl::RemoveFromIndex(const std::string& key) {
+  EntryMap::iterator it = entries_.find(key);
+  if (it == entries_.end())
+    return;
+  if (it->second.id != -1)
+    segment_keys_[it->second.id / kFlashSegmentSize].erase(key);
+  entries_.erase(it);
+}
+
+void FlashBackendImpl::EvictSegment(int32 segment) {
+  KeySet& keys = segment_keys_[segment];
+  for (KeySet::const_iterator it = keys.begin(); it != keys.end(); ++it)
+    entries_.erase(*it);
+  keys.clear();
+}
+
+}  // namespace disk_cache
@@ -0,0 +1,191 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DISK_CACHE_FLASH_FLASH_BACKEND_IMPL_H_
+#define NET_DISK_CACHE_FLASH_FLASH_BACKEND_IMPL_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/compiler_specific.h"
+#include "base/containers/hash_tables.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "net/base/cache_type.h"
+#include "net/base/net_export.h"
+#include "net/disk_cache/disk_cache.h"
+
+namespace base {
+class MessageLoopProxy;
+}
+
+namespace disk_cache {
+
+class FlashEntryImpl;
+class LogStore;
+
+// Owns the LogStore of a FlashBackendImpl.  The store is used on the cache
+// thread, and it is shared by the backend and its entries so that it is closed
+// there after the last of them goes away, once the operations they posted are
+// done.
+class NET_EXPORT_PRIVATE SharedLogStore
+    : public base::RefCountedThreadSafe<SharedLogStore> {
+ public:
+  SharedLogStore(const base::FilePath& path, int32 size,
+                 base::MessageLoopProxy* cache_thread);
+
+  LogStore* store() { return store_.get(); }
+
+  // Initializes the store.  Must be called on the cache thread.
+  bool Init();
+
+ private:
+  friend class base::RefCountedThreadSafe<SharedLogStore>;
+  ~SharedLogStore();
+
+  static void CloseStore(scoped_ptr<LogStore> store, bool init);
+
+  scoped_ptr<LogStore> store_;
+  scoped_refptr<base::MessageLoopProxy> cache_thread_;
+  bool init_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedLogStore);
+};
+
+// FlashBackendImpl is a cache backend that appends entries to a LogStore, so
+// that the storage only sees large sequential writes of whole segments.  Every
+// entry is written once, when it is closed after being created; entries that
+// were saved to the store can be read but no longer modified, they have to be
+// doomed and created again.
+//
+// The index of entries is kept in memory, on the IO thread.  When the store
+// runs out of space it reuses its oldest segment that is not in use, and the
+// entries stored on that segment are evicted from the index.  The store does
+// not persist its segment metadata yet, so the cache starts empty every time.
+//
+// Sparse entries are not supported.
+class NET_EXPORT_PRIVATE FlashBackendImpl
+    : public Backend,
+      public base::SupportsWeakPtr<FlashBackendImpl> {
+ public:
+  FlashBackendImpl(const base::FilePath& path, int max_bytes,
+                   base::MessageLoopProxy* cache_thread);
+  virtual ~FlashBackendImpl();
+
+  int Init(const CompletionCallback& callback);
+
+  // |entry| has been doomed, so its key is available again.
+  void OnEntryDoomed(FlashEntryImpl* entry);
+
+  // |entry| is going away; if it is new it is about to be saved.
+  void OnEntryClosed(FlashEntryImpl* entry);
+
+  // The new entry for |key| that was created as |generation| was saved to
+  // the store as |id|, or could not be saved if |id| is -1.
+  void OnEntrySaved(const std::string& key, int64 generation, int32 id);
+
+  // Backend interface.
+  virtual net::CacheType GetCacheType() const OVERRIDE;
+  virtual int32 GetEntryCount() const OVERRIDE;
+  virtual int OpenEntry(const std::string& key, Entry** entry,
+                        const CompletionCallback& callback) OVERRIDE;
+  virtual int CreateEntry(const std::string& key, Entry** entry,
+                          const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomEntry(const std::string& key,
+                        const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomAllEntries(const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomEntriesBetween(base::Time initial_time,
+                                 base::Time end_time,
+                                 const CompletionCallback& callback) OVERRIDE;
+  virtual int DoomEntriesSince(base::Time initial_time,
+                               const CompletionCallback& callback) OVERRIDE;
+  virtual int OpenNextEntry(void** iter, Entry** next_entry,
+                            const CompletionCallback& callback) OVERRIDE;
+  virtual void EndEnumeration(void** iter) OVERRIDE;
+  virtual void GetStats(
+      std::vector<std::pair<std::string, std::string> >* stats) OVERRIDE;
+  virtual void OnExternalCacheHit(const std::string& key) OVERRIDE;
+
+ private:
+  struct EntryMetadata {
+    EntryMetadata();
+
+    // Location of the entry in the store, or -1 while it has not been saved.
+    int32 id;
+    // Tells apart the entries created under the same key.
+    int64 generation;
+    base::Time last_used;
+    base::Time last_modified;
+  };
+
+  struct OpenRequest {
+    OpenRequest(Entry** entry, const CompletionCallback& callback);
+    ~OpenRequest();
+
+    Entry** entry;
+    CompletionCallback callback;
+  };
+
+  typedef base::hash_map<std::string, EntryMetadata> EntryMap;
+  typedef base::hash_map<std::string, FlashEntryImpl*> ActiveEntryMap;
+  typedef base::hash_map<std::string, std::vector<OpenRequest> >
+      OpenRequestMap;
+  typedef base::hash_set<std::string> KeySet;
+
+  void OnInitComplete(const CompletionCallback& callback, bool result);
+
+  // Opens the entry for |key|; enumerations do not |update_last_used|.
+  int OpenEntryInternal(const std::string& key,
+                        bool update_last_used,
+                        Entry** entry,
+                        const CompletionCallback& callback);
+
+  // Called when the entry for |key|, saved as |id|, is ready or failed to open
+  // with |result|.
+  void OnEntryOpened(const std::string& key,
+                     int32 id,
+                     scoped_refptr<FlashEntryImpl> entry,
+                     int result);
+
+  // Continues the enumeration |iter| if the last entry failed to open.
+  void CheckIterationReturnValue(void** iter,
+                                 Entry** next_entry,
+                                 const CompletionCallback& callback,
+                                 int result);
+
+  // Removes |key| from the index.
+  void RemoveFromIndex(const std::string& key);
+
+  // Removes from the index the entries stored on |segment|, which the store is
+  // reusing.
+  void EvictSegment(int32 segment);
+
+  const base::FilePath path_;
+  int32 storage_size_;
+  scoped_refptr<base::MessageLoopProxy> cache_thread_;
+  scoped_refptr<SharedLogStore> store_;
+  bool init_;
+
+  EntryMap entries_;
+  ActiveEntryMap active_entries_;
+  OpenRequestMap pending_opens_;
+  int64 next_generation_;
+
+  // The keys of the saved entries, by the segment they are stored on.
+  std::vector<KeySet> segment_keys_;
+
+  // The segment the last saved entry went to; the store writes the segments in
+  // order.
+  int32 write_segment_;
+
+  DISALLOW_COPY_AND_ASSIGN(FlashBackendImpl);
+};
+
+}  // namespace disk_cache
+
+#endif  // NET_DISK_CACHE_FLASH_FLASH_BACKEND_IMPL_H_
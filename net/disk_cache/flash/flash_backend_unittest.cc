@@ -0,0 +1,256 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/location.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop/message_loop_proxy.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "net/base/cache_type.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/base/test_completion_callback.h"
+#include "net/disk_cache/disk_cache.h"
+#include "net/disk_cache/flash/flash_backend_impl.h"
+#include "net/disk_cache/flash/flash_cache_test_base.h"
+#include "net/disk_cache/flash/format.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace disk_cache {
+
+namespace {
+
+class FlashBackendTest : public FlashCacheTest {
+ protected:
+  FlashBackendTest() : cache_thread_("FlashCacheThread") {}
+
+  virtual void SetUp() OVERRIDE {
+    FlashCacheTest::SetUp();
+    ASSERT_TRUE(cache_thread_.StartWithOptions(
+        base::Thread::Options(base::MessageLoop::TYPE_IO, 0)));
+  }
+
+  virtual void TearDown() OVERRIDE {
+    cache_.reset();
+    FlushCacheThread();
+    FlashCacheTest::TearDown();
+  }
+
+  void InitCache(int max_bytes) {
+    net::TestCompletionCallback cb;
+    int rv = CreateCacheBackend(net::DISK_CACHE, net::CACHE_BACKEND_FLASH,
+                                path_, max_bytes, false,
+                                cache_thread_.message_loop_proxy().get(), NULL,
+                                &cache_, cb.callback());
+    ASSERT_EQ(net::OK, cb.GetResult(rv));
+  }
+
+  // Waits until the entries closed so far are saved.
+  void FlushCacheThread() {
+    net::TestCompletionCallback cb;
+    cache_thread_.message_loop_proxy()->PostTaskAndReply(
+        FROM_HERE, base::Bind(&base::DoNothing),
+        base::Bind(cb.callback(), net::OK));
+    EXPECT_EQ(net::OK, cb.WaitForResult());
+  }
+
+  // Creates and saves an entry for |key| with |size| bytes of data.
+  void WriteEntry(const std::string& key, int size, char value) {
+    Entry* entry = NULL;
+    net::TestCompletionCallback cb;
+    ASSERT_EQ(net::OK, cb.GetResult(cache_->CreateEntry(key, &entry,
+                                                        cb.callback())));
+    scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(size));
+    memset(buffer->data(), value, size);
+    EXPECT_EQ(size, entry->WriteData(1, 0, buffer.get(), size, cb.callback(),
+                                     true));
+    entry->Close();
+  }
+
+  int OpenEntry(const std::string& key, Entry** entry) {
+    net::TestCompletionCallback cb;
+    return cb.GetResult(cache_->OpenEntry(key, entry, cb.callback()));
+  }
+
+  base::Thread cache_thread_;
+  scoped_ptr<Backend> cache_;
+};
+
+}  // namespace
+
+TEST_F(FlashBackendTest, CreateAndOpenEntry) {
+  InitCache(0);
+  EXPECT_EQ(net::DISK_CACHE, cache_->GetCacheType());
+
+  const int kSize = 1000;
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  memset(buffer->data(), 'a', kSize);
+
+  Entry* entry = NULL;
+  net::TestCompletionCallback cb;
+  ASSERT_EQ(net::OK, cb.GetResult(cache_->CreateEntry("key", &entry,
+                                                      cb.callback())));
+  EXPECT_EQ(net::ERR_FAILED, cb.GetResult(cache_->CreateEntry("key", &entry,
+                                                              cb.callback())));
+  EXPECT_EQ(100, entry->WriteData(0, 0, buffer.get(), 100, cb.callback(),
+                                  true));
+  EXPECT_EQ(kSize, entry->WriteData(1, 0, buffer.get(), kSize, cb.callback(),
+                                    true));
+  EXPECT_EQ(kSize, entry->WriteData(1, kSize, buffer.get(), kSize,
+                                    cb.callback(), true));
+  // Only appending to a stream or writing it from the start is supported.
+  EXPECT_EQ(net::ERR_FAILED, entry->WriteData(1, 10, buffer.get(), kSize,
+                                              cb.callback(), true));
+  EXPECT_EQ(2 * kSize, entry->GetDataSize(1));
+  entry->Close();
+  EXPECT_EQ(1, cache_->GetEntryCount());
+
+  FlushCacheThread();
+  ASSERT_EQ(net::OK, OpenEntry("key", &entry));
+  EXPECT_EQ("key", entry->GetKey());
+  EXPECT_EQ(100, entry->GetDataSize(0));
+  EXPECT_EQ(2 * kSize, entry->GetDataSize(1));
+
+  scoped_refptr<net::IOBuffer> read_buffer(new net::IOBuffer(2 * kSize));
+  EXPECT_EQ(2 * kSize, cb.GetResult(entry->ReadData(
+      1, 0, read_buffer.get(), 2 * kSize, cb.callback())));
+  EXPECT_EQ(0, memcmp(buffer->data(), read_buffer->data(), kSize));
+  EXPECT_EQ(0, memcmp(buffer->data(), read_buffer->data() + kSize, kSize));
+  EXPECT_EQ(0, cb.GetResult(entry->ReadData(1, 2 * kSize, read_buffer.get(),
+                                            kSize, cb.callback())));
+
+  // Saved entries cannot be modified.
+  EXPECT_EQ(net::ERR_FAILED, entry->WriteData(0, 0, buffer.get(), 10,
+                                              cb.callback(), true));
+  EXPECT_FALSE(entry->CouldBeSparse());
+  entry->Close();
+
+  EXPECT_EQ(net::ERR_FAILED, OpenEntry("other key", &entry));
+}
+
+TEST_F(FlashBackendTest, OpenEntryTwice) {
+  InitCache(0);
+  WriteEntry("key", 100, 'a');
+  FlushCacheThread();
+
+  Entry* entry1 = NULL;
+  Entry* entry2 = NULL;
+  net::TestCompletionCallback cb1;
+  net::TestCompletionCallback cb2;
+  int rv1 = cache_->OpenEntry("key", &entry1, cb1.callback());
+  int rv2 = cache_->OpenEntry("key", &entry2, cb2.callback());
+  ASSERT_EQ(net::OK, cb1.GetResult(rv1));
+  ASSERT_EQ(net::OK, cb2.GetResult(rv2));
+  EXPECT_EQ(entry1, entry2);
+  entry1->Close();
+  entry2->Close();
+}
+
+TEST_F(FlashBackendTest, DoomEntry) {
+  InitCache(0);
+  WriteEntry("first", 100, 'a');
+  WriteEntry("second", 100, 'b');
+  FlushCacheThread();
+  EXPECT_EQ(2, cache_->GetEntryCount());
+
+  net::TestCompletionCallback cb;
+  EXPECT_EQ(net::OK, cb.GetResult(cache_->DoomEntry("first", cb.callback())));
+  EXPECT_EQ(1, cache_->GetEntryCount());
+  Entry* entry = NULL;
+  EXPECT_EQ(net::ERR_FAILED, OpenEntry("first", &entry));
+
+  // A new entry can be created under the key of a doomed one.
+  WriteEntry("first", 200, 'c');
+  ASSERT_EQ(net::OK, OpenEntry("second", &entry));
+  entry->Doom();
+  entry->Close();
+  FlushCacheThread();
+
+  EXPECT_EQ(1, cache_->GetEntryCount());
+  ASSERT_EQ(net::OK, OpenEntry("first", &entry));
+  EXPECT_EQ(200, entry->GetDataSize(1));
+  entry->Close();
+
+  EXPECT_EQ(net::OK, cb.GetResult(cache_->DoomAllEntries(cb.callback())));
+  EXPECT_EQ(0, cache_->GetEntryCount());
+}
+
+TEST_F(FlashBackendTest, DoomEntriesSince) {
+  InitCache(0);
+  WriteEntry("first", 100, 'a');
+  FlushCacheThread();
+
+  base::PlatformThread::Sleep(base::TimeDelta::FromMilliseconds(20));
+  base::Time middle = base::Time::Now();
+  WriteEntry("second", 100, 'b');
+  FlushCacheThread();
+
+  net::TestCompletionCallback cb;
+  EXPECT_EQ(net::OK, cb.GetResult(cache_->DoomEntriesSince(middle,
+                                                           cb.callback())));
+  EXPECT_EQ(1, cache_->GetEntryCount());
+  Entry* entry = NULL;
+  ASSERT_EQ(net::OK, OpenEntry("first", &entry));
+  entry->Close();
+}
+
+TEST_F(FlashBackendTest, Enumeration) {
+  InitCache(0);
+  WriteEntry("first", 100, 'a');
+  WriteEntry("second", 100, 'b');
+  WriteEntry("third", 100, 'c');
+  FlushCacheThread();
+
+  void* iter = NULL;
+  Entry* entry = NULL;
+  int count = 0;
+  net::TestCompletionCallback cb;
+  while (cb.GetResult(cache_->OpenNextEntry(&iter, &entry, cb.callback())) ==
+         net::OK) {
+    EXPECT_EQ(100, entry->GetDataSize(1));
+    entry->Close();
+    count++;
+  }
+  EXPECT_EQ(3, count);
+}
+
+// Tests that the entries on the segment the store reuses are evicted.
+TEST_F(FlashBackendTest, SegmentEviction) {
+  InitCache(1);
+
+  // Two of these fit in a segment.
+  const int kSize = kFlashSegmentFreeSpace / 2 - 1024;
+  const int kNumEntries = 2 * 8;
+  for (int i = 0; i < kNumEntries; ++i)
+    WriteEntry(base::StringPrintf("key%d", i), kSize, 'a' + i);
+  FlushCacheThread();
+  EXPECT_EQ(kNumEntries, cache_->GetEntryCount());
+
+  // This one goes to the first segment again.
+  WriteEntry("last", kSize, 'z');
+  FlushCacheThread();
+  EXPECT_EQ(kNumEntries - 1, cache_->GetEntryCount());
+
+  Entry* entry = NULL;
+  EXPECT_EQ(net::ERR_FAILED, OpenEntry("key0", &entry));
+  EXPECT_EQ(net::ERR_FAILED, OpenEntry("key1", &entry));
+  ASSERT_EQ(net::OK, OpenEntry("key2", &entry));
+  entry->Close();
+
+  ASSERT_EQ(net::OK, OpenEntry("last", &entry));
+  scoped_refptr<net::IOBuffer> buffer(new net::IOBuffer(kSize));
+  net::TestCompletionCallback cb;
+  EXPECT_EQ(kSize, cb.GetResult(entry->ReadData(1, 0, buffer.get(), kSize,
+                                                cb.callback())));
+  EXPECT_EQ('z', buffer->data()[kSize - 1]);
+  entry->Close();
+}
+
+}  // namespace disk_cache
@@ -2,32 +2,63 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/bind.h"
+#include "base/bind_helpers.h"
 #include "base/location.h"
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/task_runner_util.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
+#include "net/disk_cache/flash/flash_backend_impl.h"
 #include "net/disk_cache/flash/flash_entry_impl.h"
 #include "net/disk_cache/flash/internal_entry.h"
 
 namespace disk_cache {
 
+namespace {
+
+// The key of an entry is stored on the first stream of the LogStoreEntry, so
+// only the remaining streams are available to the user.
+const int kNumUserStreams = kFlashLogStoreEntryNumStreams - 1;
+
+}  // namespace
+
 FlashEntryImpl::FlashEntryImpl(const std::string& key,
-                               LogStore* store,
-                               base::MessageLoopProxy* cache_thread)
+                               int64 generation,
+                               SharedLogStore* store,
+                               base::MessageLoopProxy* cache_thread,
+                               const base::WeakPtr<FlashBackendImpl>& backend)
     : init_(false),
+      doomed_(false),
       key_(key),
-      new_internal_entry_(new InternalEntry(key, store)),
-      cache_thread_(cache_thread) {
+      generation_(generation),
+      last_used_(base::Time::Now()),
+      last_modified_(last_used_),
+      new_internal_entry_(new InternalEntry(key, store->store())),
+      store_(store),
+      cache_thread_(cache_thread),
+      backend_(backend) {
   memset(stream_sizes_, 0, sizeof(stream_sizes_));
 }
 
-FlashEntryImpl::FlashEntryImpl(int32 id,
-                               LogStore* store,
-                               base::MessageLoopProxy* cache_thread)
+FlashEntryImpl::FlashEntryImpl(const std::string& key,
+                               int32 id,
+                               base::Time last_used,
+                               base::Time last_modified,
+                               SharedLogStore* store,
+                               base::MessageLoopProxy* cache_thread,
+                               const base::WeakPtr<FlashBackendImpl>& backend)
     : init_(false),
-      old_internal_entry_(new InternalEntry(id, store)),
-      cache_thread_(cache_thread) {
+      doomed_(false),
+      key_(key),
+      generation_(0),
+      last_used_(last_used),
+      last_modified_(last_modified),
+      old_internal_entry_(new InternalEntry(id, store->store())),
+      store_(store),
+      cache_thread_(cache_thread),
+      backend_(backend) {
+  memset(stream_sizes_, 0, sizeof(stream_sizes_));
 }
 
 int FlashEntryImpl::Init(const CompletionCallback& callback) {
@@ -47,7 +78,18 @@ int FlashEntryImpl::Init(const CompletionCallback& callback) {
 
 void FlashEntryImpl::Doom() {
   DCHECK(init_);
-  NOTREACHED();
+  if (doomed_)
+    return;
+  doomed_ = true;
+  if (backend_.get())
+    backend_->OnEntryDoomed(this);
+
+  if (new_internal_entry_.get()) {
+    new_internal_entry_->Delete();
+  } else {
+    cache_thread_->PostTask(FROM_HERE,
+                            Bind(&InternalEntry::Delete, old_internal_entry_));
+  }
 }
 
 void FlashEntryImpl::Close() {
@@ -62,89 +104,145 @@ std::string FlashEntryImpl::GetKey() const {
 
 base::Time FlashEntryImpl::GetLastUsed() const {
   DCHECK(init_);
-  NOTREACHED();
-  return base::Time::Now();
+  return last_used_;
 }
 
 base::Time FlashEntryImpl::GetLastModified() const {
   DCHECK(init_);
-  NOTREACHED();
-  return base::Time::Now();
+  return last_modified_;
 }
 
 int32 FlashEntryImpl::GetDataSize(int index) const {
   DCHECK(init_);
-  return new_internal_entry_->GetDataSize(index);
+  if (new_internal_entry_.get())
+    return new_internal_entry_->GetDataSize(index);
+  if (index < 0 || index >= kNumUserStreams)
+    return 0;
+  return stream_sizes_[index];
 }
 
 int FlashEntryImpl::ReadData(int index, int offset, IOBuffer* buf, int buf_len,
                              const CompletionCallback& callback) {
   DCHECK(init_);
-  return new_internal_entry_->ReadData(index, offset, buf, buf_len, callback);
+  if (index < 0 || index >= kNumUserStreams || offset < 0 || buf_len < 0)
+    return net::ERR_INVALID_ARGUMENT;
+  if (new_internal_entry_.get())
+    return new_internal_entry_->ReadData(index, offset, buf, buf_len, callback);
+
+  if (offset >= stream_sizes_[index] || !buf_len)
+    return 0;
+  PostTaskAndReplyWithResult(cache_thread_.get(),
+                             FROM_HERE,
+                             Bind(&InternalEntry::ReadData,
+                                  old_internal_entry_,
+                                  index,
+                                  offset,
+                                  make_scoped_refptr(buf),
+                                  buf_len,
+                                  CompletionCallback()),
+                             callback);
+  return net::ERR_IO_PENDING;
 }
 
 int FlashEntryImpl::WriteData(int index, int offset, IOBuffer* buf, int buf_len,
                               const CompletionCallback& callback,
                               bool truncate) {
   DCHECK(init_);
+  if (index < 0 || index >= kNumUserStreams || offset < 0 || buf_len < 0)
+    return net::ERR_INVALID_ARGUMENT;
+
+  // An entry that is already in the store cannot be modified.
+  if (!new_internal_entry_.get())
+    return net::ERR_FAILED;
+
+  // Streams can only be appended to, or written again from the start.
+  int32 stream_size = GetDataSize(index);
+  if (offset && offset != stream_size)
+    return net::ERR_FAILED;
+  if (!offset && !truncate && buf_len < stream_size)
+    return net::ERR_FAILED;
+  if (GetEntrySize() + offset + buf_len - stream_size > kFlashSegmentFreeSpace)
+    return net::ERR_FAILED;
+
+  last_modified_ = base::Time::Now();
   return new_internal_entry_->WriteData(index, offset, buf, buf_len, callback);
 }
 
 int FlashEntryImpl::ReadSparseData(int64 offset, IOBuffer* buf, int buf_len,
                                    const CompletionCallback& callback) {
   DCHECK(init_);
-  NOTREACHED();
-  return net::ERR_FAILED;
+  return net::ERR_NOT_IMPLEMENTED;
 }
 
 int FlashEntryImpl::WriteSparseData(int64 offset, IOBuffer* buf, int buf_len,
                                     const CompletionCallback& callback) {
   DCHECK(init_);
-  NOTREACHED();
-  return net::ERR_FAILED;
+  return net::ERR_NOT_IMPLEMENTED;
 }
 
 int FlashEntryImpl::GetAvailableRange(int64 offset, int len, int64* start,
                                       const CompletionCallback& callback) {
   DCHECK(init_);
-  NOTREACHED();
-  return net::ERR_FAILED;
+  return net::ERR_NOT_IMPLEMENTED;
 }
 
 bool FlashEntryImpl::CouldBeSparse() const {
   DCHECK(init_);
-  NOTREACHED();
   return false;
 }
 
 void FlashEntryImpl::CancelSparseIO() {
   DCHECK(init_);
-  NOTREACHED();
 }
 
 int FlashEntryImpl::ReadyForSparseIO(const CompletionCallback& callback) {
   DCHECK(init_);
-  NOTREACHED();
-  return net::ERR_FAILED;
+  return net::ERR_NOT_IMPLEMENTED;
 }
 
 void FlashEntryImpl::OnInitComplete(
     scoped_ptr<KeyAndStreamSizes> key_and_stream_sizes) {
   DCHECK(!callback_.is_null());
-  if (!key_and_stream_sizes) {
-    callback_.Run(net::ERR_FAILED);
+  // The callback holds a reference to |this|.
+  CompletionCallback callback = callback_;
+  callback_.Reset();
+
+  // The segment the entry was on may have been reused by the store, in which
+  // case some other entry, or nothing at all, is found there now.
+  if (!key_and_stream_sizes || key_and_stream_sizes->key != key_) {
+    callback.Run(net::ERR_FAILED);
   } else {
-    key_ = key_and_stream_sizes->key;
     memcpy(stream_sizes_, key_and_stream_sizes->stream_sizes,
            sizeof(stream_sizes_));
     init_ = true;
-    callback_.Run(net::OK);
+    callback.Run(net::OK);
   }
 }
 
 FlashEntryImpl::~FlashEntryImpl() {
-  cache_thread_->PostTask(FROM_HERE,
-                          Bind(&InternalEntry::Close, new_internal_entry_));
+  if (backend_.get())
+    backend_->OnEntryClosed(this);
+
+  if (new_internal_entry_.get() && !doomed_) {
+    PostTaskAndReplyWithResult(cache_thread_.get(),
+                               FROM_HERE,
+                               Bind(&InternalEntry::Close, new_internal_entry_),
+                               Bind(&FlashBackendImpl::OnEntrySaved, backend_,
+                                    key_, generation_));
+  } else {
+    scoped_refptr<InternalEntry> internal_entry =
+        new_internal_entry_.get() ? new_internal_entry_ : old_internal_entry_;
+    cache_thread_->PostTask(
+        FROM_HERE,
+        Bind(base::IgnoreResult(&InternalEntry::Close), internal_entry));
+  }
+}
+
+int32 FlashEntryImpl::GetEntrySize() const {
+  int32 size = kFlashLogStoreEntryHeaderSize + static_cast<int32>(key_.size());
+  for (int i = 0; i < kNumUserStreams; ++i)
+    size += GetDataSize(i);
+  return size;
 }
 
 }  // namespace disk_cache
@@ -9,6 +9,8 @@
 
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "net/base/net_export.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/flash/internal_entry.h"
@@ -21,9 +23,10 @@ class MessageLoopProxy;
 
 namespace disk_cache {
 
+class FlashBackendImpl;
 class InternalEntry;
 class IOBuffer;
-class LogStore;
+class SharedLogStore;
 
 // We use split objects to minimize the context switches between the main thread
 // and the cache thread in the most common case of creating a new entry.
@@ -34,21 +37,37 @@ class LogStore;
 //
 // When an entry is not new, every asynchronous call is posted to the cache
 // thread, just as before; synchronous calls like GetKey() and GetDataSize() are
-// served from the main thread.
+// served from the main thread.  Such entries can only be read.
 class NET_EXPORT_PRIVATE FlashEntryImpl
     : public Entry,
       public base::RefCountedThreadSafe<FlashEntryImpl> {
   friend class base::RefCountedThreadSafe<FlashEntryImpl>;
  public:
+  // Creates a new entry for |key|, which |backend| knows as |generation|.
   FlashEntryImpl(const std::string& key,
-                 LogStore* store,
-                 base::MessageLoopProxy* cache_thread);
-  FlashEntryImpl(int32 id,
-                 LogStore* store,
-                 base::MessageLoopProxy* cache_thread);
+                 int64 generation,
+                 SharedLogStore* store,
+                 base::MessageLoopProxy* cache_thread,
+                 const base::WeakPtr<FlashBackendImpl>& backend);
+  // Opens the entry saved as |id|, which is expected to be stored under |key|.
+  FlashEntryImpl(const std::string& key,
+                 int32 id,
+                 base::Time last_used,
+                 base::Time last_modified,
+                 SharedLogStore* store,
+                 base::MessageLoopProxy* cache_thread,
+                 const base::WeakPtr<FlashBackendImpl>& backend);
 
   int Init(const CompletionCallback& callback);
 
+  const std::string& key() const { return key_; }
+  bool is_new() const { return new_internal_entry_.get() != NULL; }
+  bool doomed() const { return doomed_; }
+  int64 generation() const { return generation_; }
+
+  // Updates the time the entry was last used.
+  void set_last_used(base::Time last_used) { last_used_ = last_used; }
+
   // disk_cache::Entry interface.
   virtual void Doom() OVERRIDE;
   virtual void Close() OVERRIDE;
@@ -75,9 +94,16 @@ class NET_EXPORT_PRIVATE FlashEntryImpl
   void OnInitComplete(scoped_ptr<KeyAndStreamSizes> key_and_stream_sizes);
   virtual ~FlashEntryImpl();
 
+  // Returns the number of bytes the entry takes in the store.
+  int32 GetEntrySize() const;
+
   bool init_;
+  bool doomed_;
   std::string key_;
+  int64 generation_;
   int stream_sizes_[kFlashLogStoreEntryNumStreams];
+  base::Time last_used_;
+  base::Time last_modified_;
 
   // Used if |this| is an newly created entry.
   scoped_refptr<InternalEntry> new_internal_entry_;
@@ -88,7 +114,9 @@ class NET_EXPORT_PRIVATE FlashEntryImpl
   // Copy of the callback for asynchronous calls on |old_internal_entry_|.
   CompletionCallback callback_;
 
+  scoped_refptr<SharedLogStore> store_;
   scoped_refptr<base::MessageLoopProxy> cache_thread_;
+  base::WeakPtr<FlashBackendImpl> backend_;
 
   DISALLOW_COPY_AND_ASSIGN(FlashEntryImpl);
 };
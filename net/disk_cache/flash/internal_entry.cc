@@ -22,14 +22,18 @@ KeyAndStreamSizes::KeyAndStreamSizes() {
 
 InternalEntry::InternalEntry(const std::string& key, LogStore* store)
     : store_(store),
-      entry_(new LogStoreEntry(store_)) {
+      entry_(new LogStoreEntry(store_)),
+      deleted_(false),
+      closed_(false) {
   entry_->Init();
   WriteKey(entry_.get(), key);
 }
 
 InternalEntry::InternalEntry(int32 id, LogStore* store)
     : store_(store),
-      entry_(new LogStoreEntry(store_, id)) {
+      entry_(new LogStoreEntry(store_, id)),
+      deleted_(false),
+      closed_(false) {
 }
 
 InternalEntry::~InternalEntry() {
@@ -39,12 +43,16 @@ scoped_ptr<KeyAndStreamSizes> InternalEntry::Init() {
   scoped_ptr<KeyAndStreamSizes> null;
   if (entry_->IsNew())
     return null.Pass();
-  if (!entry_->Init())
+  if (!entry_->Init()) {
+    closed_ = true;
     return null.Pass();
+  }
 
   scoped_ptr<KeyAndStreamSizes> rv(new KeyAndStreamSizes);
-  if (!ReadKey(entry_.get(), &rv->key))
+  if (!ReadKey(entry_.get(), &rv->key)) {
+    Close();
     return null.Pass();
+  }
   for (int i = 0; i < kFlashLogStoreEntryNumStreams; ++i)
     rv->stream_sizes[i] = entry_->GetDataSize(i+1);
   return rv.Pass();
@@ -64,8 +72,18 @@ int InternalEntry::WriteData(int index, int offset, IOBuffer* buf, int buf_len,
   return entry_->WriteData(++index, offset, buf, buf_len);
 }
 
-void InternalEntry::Close() {
-  entry_->Close();
+void InternalEntry::Delete() {
+  entry_->Delete();
+  deleted_ = true;
+}
+
+int32 InternalEntry::Close() {
+  if (closed_)
+    return -1;
+  closed_ = true;
+  if (!entry_->Close() || deleted_)
+    return -1;
+  return entry_->id();
 }
 
 bool InternalEntry::WriteKey(LogStoreEntry* entry, const std::string& key) {
@@ -45,7 +45,14 @@ class NET_EXPORT_PRIVATE InternalEntry
                const net::CompletionCallback& callback);
   int WriteData(int index, int offset, net::IOBuffer* buf, int buf_len,
                 const net::CompletionCallback& callback);
-  void Close();
+
+  // Marks the entry for deletion, so that Close() does not save it.
+  void Delete();
+
+  // Closes the entry, saving it to the store if it is new.  Returns the id of
+  // the entry in the store, or -1 if it was deleted or could not be saved.
+  // Does nothing if an existing entry failed to initialize.
+  int32 Close();
 
  private:
   bool WriteKey(LogStoreEntry* entry, const std::string& key);
@@ -54,6 +61,8 @@ class NET_EXPORT_PRIVATE InternalEntry
 
   LogStore* store_;
   scoped_ptr<LogStoreEntry> entry_;
+  bool deleted_;
+  bool closed_;
 
   DISALLOW_COPY_AND_ASSIGN(InternalEntry);
 };
@@ -62,6 +62,10 @@ bool LogStore::CreateEntry(int32 size, int32* id) {
 
   // TODO(agayev): Avoid large entries from leaving the segments almost empty.
   if (!open_segments_[write_index_]->CanHold(size)) {
+    int32 next_index = GetNextSegmentIndex();
+    if (next_index == -1)
+      return false;
+
     if (!open_segments_[write_index_]->Close())
       return false;
 
@@ -71,7 +75,7 @@ bool LogStore::CreateEntry(int32 size, int32* id) {
       open_segments_[write_index_] = NULL;
     }
 
-    write_index_ = GetNextSegmentIndex();
+    write_index_ = next_index;
     scoped_ptr<Segment> segment(new Segment(write_index_, false, &storage_));
     if (!segment->Init())
       return false;
@@ -171,7 +175,8 @@ int32 LogStore::GetNextSegmentIndex() {
 
   while (InUse(next_index)) {
     next_index = (next_index + 1) % num_segments_;
-    DCHECK_NE(next_index, write_index_);
+    if (next_index == write_index_)
+      return -1;
   }
   return next_index;
 }
@@ -35,7 +35,9 @@ class NET_EXPORT_PRIVATE LogStore {
   bool Close();
 
   // Creates an entry of |size| bytes.  The id of the created entry is stored in
-  // |entry_id|.
+  // |entry_id|.  When the current segment is full, the oldest segment that is
+  // not in use is reused, which discards every entry stored on it; the segment
+  // an entry lives on is |entry_id| / kFlashSegmentSize.
   bool CreateEntry(int32 size, int32* entry_id);
 
   // Deletes |entry_id|; the client should keep track of |size| and provide it
@@ -63,6 +65,8 @@ class NET_EXPORT_PRIVATE LogStore {
   FRIEND_TEST_ALL_PREFIXES(FlashCacheTest, LogStoreInUseSegmentIsSkipped);
   FRIEND_TEST_ALL_PREFIXES(FlashCacheTest, LogStoreReadFromCurrentAfterClose);
 
+  // Returns the index of the oldest segment not in use, or -1 if every segment
+  // is in use.
   int32 GetNextSegmentIndex();
   bool InUse(int32 segment_index) const;
 
@@ -36,9 +36,19 @@ bool LogStoreEntry::Init() {
   COMPILE_ASSERT(sizeof(stream_sizes) == kFlashLogStoreEntryHeaderSize,
                  invalid_log_store_entry_header_size);
 
-  if (!store_->OpenEntry(id_) ||
-      !store_->ReadData(id_, stream_sizes, kFlashLogStoreEntryHeaderSize, 0)) {
+  if (!store_->OpenEntry(id_))
     return false;
+  if (!store_->ReadData(id_, stream_sizes, kFlashLogStoreEntryHeaderSize, 0)) {
+    store_->CloseEntry(id_);
+    return false;
+  }
+  int32 size = kFlashLogStoreEntryHeaderSize;
+  for (int i = 0; i < kFlashLogStoreEntryNumStreams; ++i) {
+    if (stream_sizes[i] < 0 || stream_sizes[i] > kFlashSegmentFreeSpace - size) {
+      store_->CloseEntry(id_);
+      return false;
+    }
+    size += stream_sizes[i];
   }
   for (int i = 0, offset = kFlashLogStoreEntryHeaderSize;
        i < kFlashLogStoreEntryNumStreams; ++i) {
@@ -18,6 +18,15 @@
 
 namespace disk_cache {
 
+namespace {
+
+// Runs on the background thread.
+void ExecuteBackendIO(BackgroundIO* operation) {
+  static_cast<BackendIO*>(operation)->ExecuteOperation();
+}
+
+}  // namespace
+
 BackendIO::BackendIO(InFlightIO* controller, BackendImpl* backend,
                      const net::CompletionCallback& callback)
     : BackgroundIO(controller),
@@ -334,7 +343,11 @@ InFlightBackendIO::InFlightBackendIO(BackendImpl* backend,
                     base::MessageLoopProxy* background_thread)
     : backend_(backend),
       background_thread_(background_thread),
+      operation_queue_(new BackgroundIOQueue(background_thread,
+                                             base::Bind(&ExecuteBackendIO))),
       ptr_factory_(this) {
+  // Operations executed by the same task are completed by the same task too.
+  operation_queue_->set_downstream_queue(completion_queue());
 }
 
 InFlightBackendIO::~InFlightBackendIO() {
@@ -513,8 +526,9 @@ void InFlightBackendIO::OnOperationComplete(BackgroundIO* operation,
 }
 
 void InFlightBackendIO::PostOperation(BackendIO* operation) {
-  background_thread_->PostTask(FROM_HERE,
-      base::Bind(&BackendIO::ExecuteOperation, operation));
+  // Operations posted while the background thread is busy are executed by a
+  // single task, in the order they were posted.
+  operation_queue_->Add(operation);
   OnOperationPosted(operation);
 }
 
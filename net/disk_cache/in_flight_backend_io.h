@@ -204,6 +204,9 @@ class InFlightBackendIO : public InFlightIO {
 
   base::WeakPtr<InFlightBackendIO> GetWeakPtr();
 
+  // The queue that hands posted operations to the background thread.
+  BackgroundIOQueue* operation_queue() { return operation_queue_.get(); }
+
  protected:
   virtual void OnOperationComplete(BackgroundIO* operation,
                                    bool cancel) OVERRIDE;
@@ -213,6 +216,7 @@ class InFlightBackendIO : public InFlightIO {
 
   BackendImpl* backend_;
   scoped_refptr<base::MessageLoopProxy> background_thread_;
+  scoped_refptr<BackgroundIOQueue> operation_queue_;
   base::WeakPtrFactory<InFlightBackendIO> ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(InFlightBackendIO);
@@ -33,8 +33,82 @@ BackgroundIO::~BackgroundIO() {
 
 // ---------------------------------------------------------------------------
 
+BackgroundIOQueue::BackgroundIOQueue(base::MessageLoopProxy* thread,
+                                     const Handler& handler)
+    : thread_(thread),
+      handler_(handler),
+      task_pending_(false),
+      pause_count_(0),
+      tasks_posted_(0),
+      operations_added_(0) {
+}
+
+void BackgroundIOQueue::Add(BackgroundIO* operation) {
+  base::AutoLock lock(lock_);
+  operations_.push_back(make_scoped_refptr(operation));
+  operations_added_++;
+  // The operations added until the task runs are handled by it as well.
+  if (!task_pending_ && !pause_count_)
+    PostTaskLocked();
+}
+
+void BackgroundIOQueue::Pause() {
+  base::AutoLock lock(lock_);
+  pause_count_++;
+}
+
+void BackgroundIOQueue::Resume() {
+  base::AutoLock lock(lock_);
+  DCHECK_GT(pause_count_, 0);
+  if (!--pause_count_ && !task_pending_ && !operations_.empty())
+    PostTaskLocked();
+}
+
+int BackgroundIOQueue::tasks_posted() const {
+  base::AutoLock lock(lock_);
+  return tasks_posted_;
+}
+
+int BackgroundIOQueue::operations_added() const {
+  base::AutoLock lock(lock_);
+  return operations_added_;
+}
+
+BackgroundIOQueue::~BackgroundIOQueue() {
+}
+
+void BackgroundIOQueue::PostTaskLocked() {
+  lock_.AssertAcquired();
+  task_pending_ = true;
+  tasks_posted_++;
+  thread_->PostTask(FROM_HERE,
+                    base::Bind(&BackgroundIOQueue::RunOperations, this));
+}
+
+void BackgroundIOQueue::RunOperations() {
+  Operations operations;
+  {
+    base::AutoLock lock(lock_);
+    operations.swap(operations_);
+    task_pending_ = false;
+  }
+
+  if (downstream_queue_.get())
+    downstream_queue_->Pause();
+  for (Operations::iterator it = operations.begin(); it != operations.end();
+       ++it) {
+    handler_.Run(it->get());
+  }
+  if (downstream_queue_.get())
+    downstream_queue_->Resume();
+}
+
+// ---------------------------------------------------------------------------
+
 InFlightIO::InFlightIO()
     : callback_thread_(base::MessageLoopProxy::current()),
+      completion_queue_(new BackgroundIOQueue(
+          callback_thread_.get(), base::Bind(&BackgroundIO::OnIOSignalled))),
       running_(false), single_thread_(false) {
 }
 
@@ -75,9 +149,7 @@ void InFlightIO::OnIOComplete(BackgroundIO* operation) {
   }
 #endif
 
-  callback_thread_->PostTask(FROM_HERE,
-                             base::Bind(&BackgroundIO::OnIOSignalled,
-                                        operation));
+  completion_queue_->Add(operation);
   operation->io_completed()->Signal();
 }
 
@@ -6,7 +6,10 @@
 #define NET_DISK_CACHE_IN_FLIGHT_IO_H_
 
 #include <set>
+#include <vector>
 
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/synchronization/lock.h"
 #include "base/synchronization/waitable_event.h"
@@ -65,6 +68,63 @@ class BackgroundIO : public base::RefCountedThreadSafe<BackgroundIO> {
   DISALLOW_COPY_AND_ASSIGN(BackgroundIO);
 };
 
+// This class hands operations over to another thread in groups. The first
+// operation added to the queue posts a single task to |thread|, and that task
+// runs |handler| on every operation added before it gets to run, in order.
+// So a burst of operations costs the other thread one wake up, not one per
+// operation.
+class BackgroundIOQueue : public base::RefCountedThreadSafe<BackgroundIOQueue> {
+ public:
+  typedef base::Callback<void(BackgroundIO*)> Handler;
+
+  BackgroundIOQueue(base::MessageLoopProxy* thread, const Handler& handler);
+
+  // Queues |operation| to have the handler run on it. May be called from any
+  // thread.
+  void Add(BackgroundIO* operation);
+
+  // While paused, operations are queued but no task is posted for them. Calls
+  // may nest; the last Resume() posts the task if anything was queued.
+  void Pause();
+  void Resume();
+
+  // Pauses |queue| while a task of this queue runs, so that the operations
+  // added to it by the handler are handed over together at the end.
+  void set_downstream_queue(BackgroundIOQueue* queue) {
+    downstream_queue_ = queue;
+  }
+
+  // Returns the number of tasks posted to the thread, and the number of
+  // operations they handled (or are about to).
+  int tasks_posted() const;
+  int operations_added() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<BackgroundIOQueue>;
+  typedef std::vector<scoped_refptr<BackgroundIO> > Operations;
+
+  ~BackgroundIOQueue();
+
+  // Posts the task that runs the queued operations. |lock_| must be held.
+  void PostTaskLocked();
+
+  // Runs on |thread_|.
+  void RunOperations();
+
+  scoped_refptr<base::MessageLoopProxy> thread_;
+  const Handler handler_;
+  scoped_refptr<BackgroundIOQueue> downstream_queue_;
+
+  mutable base::Lock lock_;  // Protects the members below.
+  Operations operations_;
+  bool task_pending_;
+  int pause_count_;
+  int tasks_posted_;
+  int operations_added_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackgroundIOQueue);
+};
+
 // This class keeps track of asynchronous IO operations. A single instance
 // of this class is meant to be used to start an asynchronous operation (using
 // PostXX, exposed by a derived class). This class will post the operation to a
@@ -79,14 +139,15 @@ class BackgroundIO : public base::RefCountedThreadSafe<BackgroundIO> {
 //    4.                                        DerivedBackgroundIO::XX()
 //    5.                                         IO operation completes
 //    6.                                       InFlightIO::OnIOComplete()
-//    7.                         <- PostTask <-
+//    7.                  <- BackgroundIOQueue <-
 //    8.  BackgroundIO::OnIOSignalled()
 //    9.  InFlightIO::InvokeCallback()
 //   10. DerivedInFlightIO::OnOperationComplete()
 //   11.       invoke callback
 //
 // Shutdown is a special case that is handled though WaitForPendingIO() instead
-// of just waiting for step 7.
+// of just waiting for step 7. Operations that complete close together share
+// the task of step 7.
 class InFlightIO {
  public:
   InFlightIO();
@@ -108,6 +169,10 @@ class InFlightIO {
   // the one performing the call.
   void InvokeCallback(BackgroundIO* operation, bool cancel_task);
 
+  // The queue that hands completed operations back to the thread that started
+  // them.
+  BackgroundIOQueue* completion_queue() { return completion_queue_.get(); }
+
  protected:
   // This method is called to signal the completion of the |operation|. |cancel|
   // is true if the operation is being cancelled. This method is called on the
@@ -124,6 +189,7 @@ class InFlightIO {
 
   IOList io_list_;  // List of pending, in-flight io operations.
   scoped_refptr<base::MessageLoopProxy> callback_thread_;
+  scoped_refptr<BackgroundIOQueue> completion_queue_;
 
   bool running_;  // True after the first posted operation completes.
   bool single_thread_;  // True if we only have one thread.
@@ -16,6 +16,7 @@
 #define CACHE_UMA_BACKEND_IMPL_OBJ backend_
 
 using base::Time;
+using base::TimeDelta;
 using base::TimeTicks;
 
 namespace disk_cache {
@@ -401,6 +402,14 @@ void Rankings::Remove(CacheRankingsBlock* node, List list, bool strict) {
 // but the net effect is just an assert on debug when attempting to remove the
 // entry. Otherwise we'll need reentrant transactions, which is an overkill.
 void Rankings::UpdateRank(CacheRankingsBlock* node, bool modified, List list) {
+  if (!modified && rank_update_interval_ > TimeDelta()) {
+    DCHECK(node->HasData());
+    TimeDelta age =
+        Time::Now() - Time::FromInternalValue(node->Data()->last_used);
+    if (age >= TimeDelta() && age < rank_update_interval_)
+      return;
+  }
+
   Addr& my_head = heads_[list];
   if (my_head.value() == node->address().value()) {
     UpdateTimes(node, modified);
@@ -10,6 +10,7 @@
 #include <list>
 
 #include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
 #include "net/disk_cache/addr.h"
 #include "net/disk_cache/mapped_file.h"
 #include "net/disk_cache/storage_block.h"
@@ -120,9 +121,20 @@ class Rankings {
   // performing the iteration), so it should be used with extra care.
   void Remove(CacheRankingsBlock* node, List list, bool strict);
 
-  // Moves a given entry to the head.
+  // Moves a given entry to the head. See set_rank_update_interval().
   void UpdateRank(CacheRankingsBlock* node, bool modified, List list);
 
+  // Entries that reached the head of their list less than |interval| ago are
+  // left in place by UpdateRank() when they are used again without being
+  // modified, which saves rewriting the nodes of the entry and its neighbours.
+  // Their last used time then lags behind by up to |interval|.
+  void set_rank_update_interval(base::TimeDelta interval) {
+    rank_update_interval_ = interval;
+  }
+  base::TimeDelta rank_update_interval() const {
+    return rank_update_interval_;
+  }
+
   // Iterates through the list.
   CacheRankingsBlock* GetNext(CacheRankingsBlock* node, List list);
   CacheRankingsBlock* GetPrev(CacheRankingsBlock* node, List list);
@@ -205,6 +217,7 @@ class Rankings {
   BackendImpl* backend_;
   LruData* control_data_;  // Data related to the LRU lists.
   IteratorList iterators_;
+  base::TimeDelta rank_update_interval_;
 
   DISALLOW_COPY_AND_ASSIGN(Rankings);
 };
@@ -79,6 +79,17 @@ void MaybeCreateSequencedWorkerPool() {
   }
 }
 
+// Mapping entries in memory is only tried on POSIX, and only when asked for.
+SimpleEntryImpl::ReadMode GetEntryReadMode() {
+#if defined(OS_POSIX)
+  if (base::FieldTrialList::FindFullName("SimpleCacheMappedReads") ==
+      "Enabled") {
+    return SimpleEntryImpl::MAPPED_READS;
+  }
+#endif
+  return SimpleEntryImpl::POOLED_READS;
+}
+
 bool g_fd_limit_histogram_has_been_populated = false;
 
 void MaybeHistogramFdLimit(net::CacheType cache_type) {
@@ -210,6 +221,7 @@ SimpleBackendImpl::SimpleBackendImpl(const FilePath& path,
           cache_type == net::DISK_CACHE ?
               SimpleEntryImpl::OPTIMISTIC_OPERATIONS :
               SimpleEntryImpl::NON_OPTIMISTIC_OPERATIONS),
+      entry_read_mode_(GetEntryReadMode()),
       net_log_(net_log) {
   MaybeHistogramFdLimit(cache_type_);
 }
@@ -518,7 +530,8 @@ scoped_refptr<SimpleEntryImpl> SimpleBackendImpl::CreateOrFindActiveEntry(
     DCHECK(!it->second.get());
   if (!it->second.get()) {
     SimpleEntryImpl* entry = new SimpleEntryImpl(
-        cache_type_, path_, entry_hash, entry_operations_mode_, this, net_log_);
+        cache_type_, path_, entry_hash, entry_operations_mode_,
+        entry_read_mode_, this, net_log_);
     entry->SetKey(key);
     it->second = entry->AsWeakPtr();
   }
@@ -553,7 +566,8 @@ int SimpleBackendImpl::OpenEntryFromHash(uint64 entry_hash,
   }
 
   scoped_refptr<SimpleEntryImpl> simple_entry = new SimpleEntryImpl(
-      cache_type_, path_, entry_hash, entry_operations_mode_, this, net_log_);
+      cache_type_, path_, entry_hash, entry_operations_mode_,
+      entry_read_mode_, this, net_log_);
   CompletionCallback backend_callback =
       base::Bind(&SimpleBackendImpl::OnEntryOpenedFromHash,
                  AsWeakPtr(), entry_hash, entry, simple_entry, callback);
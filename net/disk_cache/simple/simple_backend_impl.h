@@ -202,6 +202,7 @@ class NET_EXPORT_PRIVATE SimpleBackendImpl : public Backend,
 
   int orig_max_size_;
   const SimpleEntryImpl::OperationsMode entry_operations_mode_;
+  const SimpleEntryImpl::ReadMode entry_read_mode_;
 
   EntryMap active_entries_;
 
@@ -164,6 +164,7 @@ SimpleEntryImpl::SimpleEntryImpl(net::CacheType cache_type,
                                  const FilePath& path,
                                  const uint64 entry_hash,
                                  OperationsMode operations_mode,
+                                 ReadMode read_mode,
                                  SimpleBackendImpl* backend,
                                  net::NetLog* net_log)
     : backend_(backend->AsWeakPtr()),
@@ -181,7 +182,9 @@ SimpleEntryImpl::SimpleEntryImpl(net::CacheType cache_type,
       synchronous_entry_(NULL),
       net_log_(net::BoundNetLog::Make(
           net_log, net::NetLog::SOURCE_DISK_CACHE_ENTRY)),
-      stream_0_data_(new net::GrowableIOBuffer()) {
+      stream_0_data_(new net::GrowableIOBuffer()),
+      use_mapped_reads_(read_mode == MAPPED_READS),
+      mapped_stream_1_(NULL) {
   COMPILE_ASSERT(arraysize(data_size_) == arraysize(crc32s_end_offset_),
                  arrays_should_be_same_size);
   COMPILE_ASSERT(arraysize(data_size_) == arraysize(crc32s_),
@@ -365,7 +368,20 @@ int SimpleEntryImpl::ReadData(int stream_index,
     return 0;
   }
 
-  // TODO(clamy): return immediatly when reading from stream 0.
+  // Stream 0, and stream 1 when it is mapped, are read from memory right away
+  // if no operation is in the way.
+  if (pending_operations_.empty() && state_ == STATE_READY &&
+      (stream_index == 0 || (stream_index == 1 && mapped_stream_1_))) {
+    buf_len = std::min(buf_len, GetDataSize(stream_index) - offset);
+    int ret_value = stream_index == 0
+        ? ReadStream0Data(buf, offset, buf_len)
+        : ReadMappedStream1Data(buf, offset, buf_len);
+    if (net_log_.IsLoggingAllEvents()) {
+      net_log_.AddEvent(net::NetLog::TYPE_SIMPLE_CACHE_ENTRY_READ_END,
+          CreateNetLogReadWriteCompleteCallback(ret_value));
+    }
+    return ret_value;
+  }
 
   // TODO(felipeg): Optimization: Add support for truly parallel read
   // operations.
@@ -549,6 +565,7 @@ void SimpleEntryImpl::MakeUninitialized() {
   for (size_t i = 0; i < arraysize(crc_check_state_); ++i) {
     crc_check_state_[i] = CRC_CHECK_NEVER_READ_AT_ALL;
   }
+  mapped_stream_1_ = NULL;
 }
 
 void SimpleEntryImpl::ReturnEntryToCaller(Entry** out_entry) {
@@ -689,6 +706,7 @@ void SimpleEntryImpl::OpenEntryInternal(bool have_index,
                             path_,
                             entry_hash_,
                             have_index,
+                            use_mapped_reads_,
                             results.get());
   Closure reply = base::Bind(&SimpleEntryImpl::CreationOperationComplete,
                              this,
@@ -757,6 +775,7 @@ void SimpleEntryImpl::CloseInternal() {
       crc32s_to_write(new std::vector<CRCRecord>());
 
   net_log_.AddEvent(net::NetLog::TYPE_SIMPLE_CACHE_ENTRY_CLOSE_BEGIN);
+  mapped_stream_1_ = NULL;
 
   if (state_ == STATE_READY) {
     DCHECK(synchronous_entry_);
@@ -842,9 +861,12 @@ void SimpleEntryImpl::ReadDataInternal(int stream_index,
 
   buf_len = std::min(buf_len, GetDataSize(stream_index) - offset);
 
-  // Since stream 0 data is kept in memory, it is read immediately.
-  if (stream_index == 0) {
-    int ret_value = ReadStream0Data(buf, offset, buf_len);
+  // Since stream 0 data is kept in memory, it is read immediately. So is
+  // stream 1 when it is mapped.
+  if (stream_index == 0 || (stream_index == 1 && mapped_stream_1_)) {
+    int ret_value = stream_index == 0
+        ? ReadStream0Data(buf, offset, buf_len)
+        : ReadMappedStream1Data(buf, offset, buf_len);
     if (!callback.is_null()) {
       MessageLoopProxy::current()->PostTask(FROM_HERE,
                                             base::Bind(callback, ret_value));
@@ -938,6 +960,9 @@ void SimpleEntryImpl::WriteDataInternal(int stream_index,
   state_ = STATE_IO_PENDING;
   if (!doomed_ && backend_.get())
     backend_->index()->UseIfExists(entry_hash_);
+  // The synchronous entry unmaps stream 1 before writing to its file.
+  if (stream_index == 1)
+    mapped_stream_1_ = NULL;
 
   AdvanceCrc(buf, offset, buf_len, stream_index);
 
@@ -1119,6 +1144,13 @@ void SimpleEntryImpl::CreationOperationComplete(
     crc32s_[0] = in_results->stream_0_crc32;
     crc32s_end_offset_[0] = in_results->entry_stat.data_size(0);
   }
+  if (in_results->mapped_stream_1_data) {
+    mapped_stream_1_ = in_results->mapped_stream_1_data;
+    // The crc was checked when the stream was mapped.
+    crc_check_state_[1] = CRC_CHECK_DONE;
+    crc32s_[1] = in_results->mapped_stream_1_crc32;
+    crc32s_end_offset_[1] = in_results->entry_stat.data_size(1);
+  }
   if (key_.empty()) {
     SetKey(synchronous_entry_->key());
   } else {
@@ -1462,6 +1494,20 @@ int SimpleEntryImpl::ReadStream0Data(net::IOBuffer* buf,
   return buf_len;
 }
 
+int SimpleEntryImpl::ReadMappedStream1Data(net::IOBuffer* buf,
+                                           int offset,
+                                           int buf_len) {
+  DCHECK(mapped_stream_1_);
+  memcpy(buf->data(), mapped_stream_1_ + offset, buf_len);
+  UpdateDataFromEntryStat(
+      SimpleEntryStat(base::Time::Now(), last_modified_, data_size_,
+                      sparse_data_size_));
+  if (!doomed_ && backend_.get())
+    backend_->index()->UseIfExists(entry_hash_);
+  RecordReadResult(cache_type_, READ_RESULT_SUCCESS);
+  return buf_len;
+}
+
 int SimpleEntryImpl::SetStream0Data(net::IOBuffer* buf,
                                     int offset,
                                     int buf_len,
@@ -49,10 +49,19 @@ class NET_EXPORT_PRIVATE SimpleEntryImpl : public Entry,
     OPTIMISTIC_OPERATIONS,
   };
 
+  // With MAPPED_READS, small entries have their stream 1 mapped in memory
+  // when they are opened, and reads of it are served without a trip to the
+  // worker pool.
+  enum ReadMode {
+    POOLED_READS,
+    MAPPED_READS,
+  };
+
   SimpleEntryImpl(net::CacheType cache_type,
                   const base::FilePath& path,
                   uint64 entry_hash,
                   OperationsMode operations_mode,
+                  ReadMode read_mode,
                   SimpleBackendImpl* backend,
                   net::NetLog* net_log);
 
@@ -283,6 +292,9 @@ class NET_EXPORT_PRIVATE SimpleEntryImpl : public Entry,
   // Reads from the stream 0 data kept in memory.
   int ReadStream0Data(net::IOBuffer* buf, int offset, int buf_len);
 
+  // Reads from the stream 1 data mapped in memory by the synchronous entry.
+  int ReadMappedStream1Data(net::IOBuffer* buf, int offset, int buf_len);
+
   // Copies data from |buf| to the internal in-memory buffer for stream 0. If
   // |truncate| is set to true, the target buffer will be truncated at |offset|
   // + |buf_len| before being written.
@@ -365,6 +377,12 @@ class NET_EXPORT_PRIVATE SimpleEntryImpl : public Entry,
   // used to write HTTP headers, the memory consumption of keeping it in memory
   // is acceptable.
   scoped_refptr<net::GrowableIOBuffer> stream_0_data_;
+
+  // With MAPPED_READS, the stream 1 data mapped by |synchronous_entry_| when
+  // the entry was opened. It is dropped before any operation that writes
+  // stream 1 or closes the files is posted to the worker pool.
+  const bool use_mapped_reads_;
+  const char* mapped_stream_1_;
 };
 
 }  // namespace disk_cache
@@ -23,6 +23,7 @@
 #include "base/threading/worker_pool.h"
 #include "base/time/time.h"
 #include "net/base/net_errors.h"
+#include "net/disk_cache/eviction_policy.h"
 #include "net/disk_cache/simple/simple_entry_format.h"
 #include "net/disk_cache/simple/simple_histogram_macros.h"
 #include "net/disk_cache/simple/simple_index_delegate.h"
@@ -48,29 +49,9 @@ const uint32 kEvictionMarginDivisor = 20;
 
 const uint32 kBytesInKb = 1024;
 
-// Utility class used for timestamp comparisons in entry metadata while sorting.
-class CompareHashesForTimestamp {
-  typedef disk_cache::SimpleIndex SimpleIndex;
-  typedef disk_cache::SimpleIndex::EntrySet EntrySet;
- public:
-  explicit CompareHashesForTimestamp(const EntrySet& set);
-
-  bool operator()(uint64 hash1, uint64 hash2);
- private:
-  const EntrySet& entry_set_;
-};
-
-CompareHashesForTimestamp::CompareHashesForTimestamp(const EntrySet& set)
-  : entry_set_(set) {
-}
-
-bool CompareHashesForTimestamp::operator()(uint64 hash1, uint64 hash2) {
-  EntrySet::const_iterator it1 = entry_set_.find(hash1);
-  DCHECK(it1 != entry_set_.end());
-  EntrySet::const_iterator it2 = entry_set_.find(hash2);
-  DCHECK(it2 != entry_set_.end());
-  return it1->second.GetLastUsedTime() < it2->second.GetLastUsedTime();
-}
+// The whole index is written again once the journal holds as many records as
+// a quarter of its entries, which bounds the records replayed on load.
+const uint64 kJournalCheckpointDivisor = 4;
 
 }  // namespace
 
@@ -146,7 +127,10 @@ SimpleIndex::SimpleIndex(base::SingleThreadTaskRunner* io_thread,
       high_watermark_(0),
       low_watermark_(0),
       eviction_in_progress_(false),
+      eviction_policy_(EvictionPolicy::Create(EvictionPolicy::LRU)),
       initialized_(false),
+      journal_entry_count_(0),
+      checkpoint_required_(false),
       index_file_(index_file.Pass()),
       io_thread_(io_thread),
       // Creating the callback once so it is reused every time
@@ -185,6 +169,11 @@ void SimpleIndex::Initialize(base::Time cache_mtime) {
     }
   }
 
+  if (base::FieldTrialList::FindFullName("SimpleCacheEvictionPolicy") ==
+      "SizeAware") {
+    eviction_policy_ = EvictionPolicy::Create(EvictionPolicy::SIZE_AWARE);
+  }
+
 #if defined(OS_ANDROID)
   if (base::android::IsVMInitialized()) {
     activity_status_listener_.reset(new base::android::ActivityStatus::Listener(
@@ -266,6 +255,7 @@ void SimpleIndex::Insert(uint64 entry_hash) {
       entry_hash, EntryMetadata(base::Time::Now(), 0), &entries_set_);
   if (!initialized_)
     removed_entries_.erase(entry_hash);
+  changed_entries_.insert(entry_hash);
   PostponeWritingToDisk();
 }
 
@@ -279,6 +269,7 @@ void SimpleIndex::Remove(uint64 entry_hash) {
 
   if (!initialized_)
     removed_entries_.insert(entry_hash);
+  changed_entries_.insert(entry_hash);
   PostponeWritingToDisk();
 }
 
@@ -297,6 +288,7 @@ bool SimpleIndex::UseIfExists(uint64 entry_hash) {
     // If not initialized, always return true, forcing it to go to the disk.
     return !initialized_;
   it->second.SetLastUsedTime(base::Time::Now());
+  changed_entries_.insert(entry_hash);
   PostponeWritingToDisk();
   return true;
 }
@@ -305,7 +297,8 @@ void SimpleIndex::StartEvictionIfNeeded() {
   DCHECK(io_thread_checker_.CalledOnValidThread());
   if (eviction_in_progress_ || cache_size_ <= high_watermark_)
     return;
-  // Take all live key hashes from the index and sort them by time.
+  // Take all live key hashes from the index and sort them by how valuable the
+  // eviction policy considers them.
   eviction_in_progress_ = true;
   eviction_start_time_ = base::TimeTicks::Now();
   SIMPLE_CACHE_UMA(MEMORY_KB,
@@ -314,14 +307,23 @@ void SimpleIndex::StartEvictionIfNeeded() {
   SIMPLE_CACHE_UMA(MEMORY_KB,
                    "Eviction.MaxCacheSizeOnStart2", cache_type_,
                    max_size_ / kBytesInKb);
-  std::vector<uint64> entry_hashes;
-  entry_hashes.reserve(entries_set_.size());
+  // The index does not count hits, so the policy only weighs the recency and
+  // the size of the entries.
+  const base::Time now = base::Time::Now();
+  std::vector<std::pair<double, uint64> > ranked_hashes;
+  ranked_hashes.reserve(entries_set_.size());
   for (EntrySet::const_iterator it = entries_set_.begin(),
        end = entries_set_.end(); it != end; ++it) {
-    entry_hashes.push_back(it->first);
+    EvictionCandidate candidate(it->second.GetLastUsedTime(),
+                                it->second.GetEntrySize(), 0);
+    ranked_hashes.push_back(std::make_pair(
+        eviction_policy_->GetRetentionValue(candidate, now), it->first));
   }
-  std::sort(entry_hashes.begin(), entry_hashes.end(),
-            CompareHashesForTimestamp(entries_set_));
+  std::sort(ranked_hashes.begin(), ranked_hashes.end());
+  std::vector<uint64> entry_hashes;
+  entry_hashes.reserve(ranked_hashes.size());
+  for (size_t i = 0; i < ranked_hashes.size(); ++i)
+    entry_hashes.push_back(ranked_hashes[i].second);
 
   // Remove as many entries from the index to get below |low_watermark_|.
   std::vector<uint64>::iterator it = entry_hashes.begin();
@@ -357,6 +359,7 @@ bool SimpleIndex::UpdateEntrySize(uint64 entry_hash, int entry_size) {
     return false;
 
   UpdateEntryIteratorSize(&it, entry_size);
+  changed_entries_.insert(entry_hash);
   PostponeWritingToDisk();
   StartEvictionIfNeeded();
   return true;
@@ -437,11 +440,14 @@ void SimpleIndex::MergeInitializingSet(
   entries_set_.swap(*index_file_entries);
   cache_size_ = merged_cache_size;
   initialized_ = true;
+  journal_entry_count_ = load_result->journal_entry_count;
 
   // The actual IO is asynchronous, so calling WriteToDisk() shouldn't slow the
   // merge down much.
-  if (load_result->flush_required)
+  if (load_result->flush_required) {
+    checkpoint_required_ = true;
     WriteToDisk();
+  }
 
   SIMPLE_CACHE_UMA(CUSTOM_COUNTS,
                    "IndexInitializationWaiters", cache_type_,
@@ -491,8 +497,30 @@ void SimpleIndex::WriteToDisk() {
   }
   last_write_to_disk_ = start;
 
-  index_file_->WriteToDisk(entries_set_, cache_size_,
-                           start, app_on_background_);
+  const uint64 journal_entry_count =
+      journal_entry_count_ + changed_entries_.size();
+  if (checkpoint_required_ ||
+      journal_entry_count * kJournalCheckpointDivisor > entries_set_.size()) {
+    index_file_->WriteToDisk(entries_set_, cache_size_,
+                             start, app_on_background_);
+    journal_entry_count_ = 0;
+    checkpoint_required_ = false;
+  } else {
+    EntrySet changed_entries;
+    HashList removed_entries;
+    for (base::hash_set<uint64>::const_iterator it = changed_entries_.begin();
+         it != changed_entries_.end(); ++it) {
+      EntrySet::const_iterator found = entries_set_.find(*it);
+      if (found != entries_set_.end())
+        InsertInEntrySet(*it, found->second, &changed_entries);
+      else
+        removed_entries.push_back(*it);
+    }
+    index_file_->AppendToJournal(changed_entries, removed_entries,
+                                 start, app_on_background_);
+    journal_entry_count_ = journal_entry_count;
+  }
+  changed_entries_.clear();
 }
 
 }  // namespace disk_cache
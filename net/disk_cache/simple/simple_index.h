@@ -33,6 +33,7 @@ class PickleIterator;
 
 namespace disk_cache {
 
+class EvictionPolicy;
 class SimpleIndexDelegate;
 class SimpleIndexFile;
 struct SimpleIndexLoadResult;
@@ -137,6 +138,8 @@ class NET_EXPORT_PRIVATE SimpleIndex
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWriteQueued);
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWriteExecuted);
   FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWritePostponed);
+  FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, DiskWriteJournaled);
+  FRIEND_TEST_ALL_PREFIXES(SimpleIndexTest, SizeAwareEviction);
 
   void StartEvictionIfNeeded();
   void EvictionDone(int result);
@@ -166,12 +169,21 @@ class NET_EXPORT_PRIVATE SimpleIndex
   uint64 low_watermark_;
   bool eviction_in_progress_;
   base::TimeTicks eviction_start_time_;
+  scoped_ptr<EvictionPolicy> eviction_policy_;
 
   // This stores all the entry_hash of entries that are removed during
   // initialization.
   base::hash_set<uint64> removed_entries_;
   bool initialized_;
 
+  // The entries inserted, removed or updated since the index was last written
+  // to disk, which the next write appends to the journal.
+  base::hash_set<uint64> changed_entries_;
+  // Number of entry records in the journal since the last checkpoint, that is
+  // since the whole index was last written.
+  uint64 journal_entry_count_;
+  bool checkpoint_required_;
+
   scoped_ptr<SimpleIndexFile> index_file_;
 
   scoped_refptr<base::SingleThreadTaskRunner> io_thread_;
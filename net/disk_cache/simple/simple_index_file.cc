@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "base/file_util.h"
+#include "base/files/file.h"
 #include "base/files/memory_mapped_file.h"
 #include "base/hash.h"
 #include "base/logging.h"
@@ -125,7 +126,8 @@ void ProcessEntryFile(SimpleIndex::EntrySet* entries,
 }  // namespace
 
 SimpleIndexLoadResult::SimpleIndexLoadResult() : did_load(false),
-                                                 flush_required(false) {
+                                                 flush_required(false),
+                                                 journal_entry_count(0) {
 }
 
 SimpleIndexLoadResult::~SimpleIndexLoadResult() {
@@ -134,6 +136,7 @@ SimpleIndexLoadResult::~SimpleIndexLoadResult() {
 void SimpleIndexLoadResult::Reset() {
   did_load = false;
   flush_required = false;
+  journal_entry_count = 0;
   entries.clear();
 }
 
@@ -143,6 +146,8 @@ const char SimpleIndexFile::kIndexFileName[] = "the-real-index";
 const char SimpleIndexFile::kIndexDirectory[] = "index-dir";
 // static
 const char SimpleIndexFile::kTempIndexFileName[] = "temp-index";
+// static
+const char SimpleIndexFile::kJournalFileName[] = "index-journal";
 
 SimpleIndexFile::IndexMetadata::IndexMetadata()
     : magic_number_(kSimpleIndexMagicNumber),
@@ -175,6 +180,82 @@ bool SimpleIndexFile::SerializeFinalData(base::Time cache_modified,
   return true;
 }
 
+// static
+scoped_ptr<Pickle> SimpleIndexFile::SerializeJournalHeader(uint32 index_crc) {
+  scoped_ptr<Pickle> pickle(new Pickle(sizeof(SimpleIndexFile::PickleHeader)));
+  pickle->WriteUInt64(kSimpleIndexJournalMagicNumber);
+  pickle->WriteUInt32(kSimpleVersion);
+  pickle->WriteUInt32(index_crc);
+  pickle->headerT<PickleHeader>()->crc = CalculatePickleCRC(*pickle);
+  return pickle.Pass();
+}
+
+// static
+scoped_ptr<Pickle> SimpleIndexFile::SerializeJournalRecords(
+    const SimpleIndex::EntrySet& changed_entries,
+    const SimpleIndex::HashList& removed_entries) {
+  scoped_ptr<Pickle> pickle(new Pickle(sizeof(SimpleIndexFile::PickleHeader)));
+  pickle->WriteUInt64(changed_entries.size() + removed_entries.size());
+  for (SimpleIndex::EntrySet::const_iterator it = changed_entries.begin();
+       it != changed_entries.end(); ++it) {
+    pickle->WriteUInt64(it->first);
+    pickle->WriteBool(true);
+    it->second.Serialize(pickle.get());
+  }
+  for (SimpleIndex::HashList::const_iterator it = removed_entries.begin();
+       it != removed_entries.end(); ++it) {
+    pickle->WriteUInt64(*it);
+    pickle->WriteBool(false);
+  }
+  return pickle.Pass();
+}
+
+// static
+bool SimpleIndexFile::DeserializeJournalRecords(
+    const Pickle& pickle,
+    base::Time* out_cache_last_modified,
+    uint64* out_entry_count,
+    SimpleIndex::EntrySet* entries) {
+  if (!pickle.data() ||
+      pickle.headerT<PickleHeader>()->crc != CalculatePickleCRC(pickle)) {
+    return false;
+  }
+
+  // Validate the whole record before applying it, so that a bad record does
+  // not leave the entries half updated.
+  PickleIterator pickle_it(pickle);
+  uint64 entry_count;
+  if (!pickle_it.ReadUInt64(&entry_count) || entry_count > kMaxEntiresInIndex)
+    return false;
+  std::vector<std::pair<uint64, EntryMetadata> > changed_entries;
+  std::vector<uint64> removed_entries;
+  for (uint64 i = 0; i < entry_count; ++i) {
+    uint64 hash_key;
+    bool present;
+    if (!pickle_it.ReadUInt64(&hash_key) || !pickle_it.ReadBool(&present))
+      return false;
+    if (!present) {
+      removed_entries.push_back(hash_key);
+      continue;
+    }
+    EntryMetadata entry_metadata;
+    if (!entry_metadata.Deserialize(&pickle_it))
+      return false;
+    changed_entries.push_back(std::make_pair(hash_key, entry_metadata));
+  }
+  int64 cache_last_modified;
+  if (!pickle_it.ReadInt64(&cache_last_modified))
+    return false;
+
+  for (size_t i = 0; i < changed_entries.size(); ++i)
+    (*entries)[changed_entries[i].first] = changed_entries[i].second;
+  for (size_t i = 0; i < removed_entries.size(); ++i)
+    entries->erase(removed_entries[i]);
+  *out_cache_last_modified = base::Time::FromInternalValue(cache_last_modified);
+  *out_entry_count = entry_count;
+  return true;
+}
+
 bool SimpleIndexFile::IndexMetadata::Deserialize(PickleIterator* it) {
   DCHECK(it);
   return it->ReadUInt64(&magic_number_) &&
@@ -216,6 +297,18 @@ void SimpleIndexFile::SyncWriteToDisk(net::CacheType cache_type,
   bool result = base::ReplaceFile(temp_index_filename, index_filename, NULL);
   DCHECK(result);
 
+  // Start the journal of the new index file. If this fails, the journal left
+  // over belongs to the previous index file and is not replayed.
+  scoped_ptr<Pickle> journal_header =
+      SerializeJournalHeader(pickle->headerT<PickleHeader>()->crc);
+  const base::FilePath journal_filename =
+      index_filename.DirName().AppendASCII(kJournalFileName);
+  if (!WritePickleFile(journal_header.get(), journal_filename))
+    LOG(ERROR) << "Failed to start the index journal";
+
+  SIMPLE_CACHE_UMA(MEMORY_KB,
+                   "IndexWriteToDiskSize", cache_type, pickle->size() / 1024);
+
   if (app_on_background) {
     SIMPLE_CACHE_UMA(TIMES,
                      "IndexWriteToDiskTime.Background", cache_type,
@@ -227,6 +320,48 @@ void SimpleIndexFile::SyncWriteToDisk(net::CacheType cache_type,
   }
 }
 
+// static
+void SimpleIndexFile::SyncAppendToJournal(
+    net::CacheType cache_type,
+    const base::FilePath& cache_directory,
+    const base::FilePath& journal_filename,
+    scoped_ptr<Pickle> pickle,
+    const base::TimeTicks& start_time,
+    bool app_on_background) {
+  base::Time cache_dir_mtime;
+  if (!simple_util::GetMTime(cache_directory, &cache_dir_mtime)) {
+    LOG(ERROR) << "Could obtain information about cache age";
+    return;
+  }
+  SerializeFinalData(cache_dir_mtime, pickle.get());
+
+  // Without a journal the changes are lost, and the index file is found stale
+  // when it is next loaded.
+  base::File journal(journal_filename,
+                     base::File::FLAG_OPEN | base::File::FLAG_APPEND);
+  if (!journal.IsValid()) {
+    LOG(WARNING) << "Could not open the index journal";
+    return;
+  }
+  const int size = pickle->size();
+  if (journal.Write(0, static_cast<const char*>(pickle->data()), size) !=
+      size) {
+    LOG(ERROR) << "Failed to append to the index journal";
+    return;
+  }
+
+  SIMPLE_CACHE_UMA(COUNTS, "IndexJournalAppendSize", cache_type, size);
+  if (app_on_background) {
+    SIMPLE_CACHE_UMA(TIMES,
+                     "IndexJournalAppendTime.Background", cache_type,
+                     (base::TimeTicks::Now() - start_time));
+  } else {
+    SIMPLE_CACHE_UMA(TIMES,
+                     "IndexJournalAppendTime.Foreground", cache_type,
+                     (base::TimeTicks::Now() - start_time));
+  }
+}
+
 bool SimpleIndexFile::IndexMetadata::CheckIndexMetadata() {
   return number_of_entries_ <= kMaxEntiresInIndex &&
       magic_number_ == kSimpleIndexMagicNumber &&
@@ -245,7 +380,9 @@ SimpleIndexFile::SimpleIndexFile(
       index_file_(cache_directory_.AppendASCII(kIndexDirectory)
                       .AppendASCII(kIndexFileName)),
       temp_index_file_(cache_directory_.AppendASCII(kIndexDirectory)
-                           .AppendASCII(kTempIndexFileName)) {
+                           .AppendASCII(kTempIndexFileName)),
+      journal_file_(cache_directory_.AppendASCII(kIndexDirectory)
+                        .AppendASCII(kJournalFileName)) {
 }
 
 SimpleIndexFile::~SimpleIndexFile() {}
@@ -256,7 +393,7 @@ void SimpleIndexFile::LoadIndexEntries(base::Time cache_last_modified,
   base::Closure task = base::Bind(&SimpleIndexFile::SyncLoadIndexEntries,
                                   cache_type_,
                                   cache_last_modified, cache_directory_,
-                                  index_file_, out_result);
+                                  index_file_, journal_file_, out_result);
   worker_pool_->PostTaskAndReply(FROM_HERE, task, callback);
 }
 
@@ -277,16 +414,42 @@ void SimpleIndexFile::WriteToDisk(const SimpleIndex::EntrySet& entry_set,
       app_on_background));
 }
 
+void SimpleIndexFile::AppendToJournal(
+    const SimpleIndex::EntrySet& changed_entries,
+    const SimpleIndex::HashList& removed_entries,
+    const base::TimeTicks& start,
+    bool app_on_background) {
+  scoped_ptr<Pickle> pickle =
+      SerializeJournalRecords(changed_entries, removed_entries);
+  cache_thread_->PostTask(FROM_HERE, base::Bind(
+      &SimpleIndexFile::SyncAppendToJournal,
+      cache_type_,
+      cache_directory_,
+      journal_file_,
+      base::Passed(&pickle),
+      base::TimeTicks::Now(),
+      app_on_background));
+}
+
 // static
 void SimpleIndexFile::SyncLoadIndexEntries(
     net::CacheType cache_type,
     base::Time cache_last_modified,
     const base::FilePath& cache_directory,
     const base::FilePath& index_file_path,
+    const base::FilePath& journal_file_path,
     SimpleIndexLoadResult* out_result) {
+  const base::TimeTicks load_start = base::TimeTicks::Now();
+
   // Load the index and find its age.
   base::Time last_cache_seen_by_index;
-  SyncLoadFromDisk(index_file_path, &last_cache_seen_by_index, out_result);
+  uint32 index_crc = 0;
+  SyncLoadFromDisk(index_file_path, &last_cache_seen_by_index, &index_crc,
+                   out_result);
+  if (out_result->did_load) {
+    SyncReplayJournal(journal_file_path, index_crc, &last_cache_seen_by_index,
+                      out_result);
+  }
 
   // Consider the index loaded if it is fresh.
   const bool index_file_existed = base::PathExists(index_file_path);
@@ -304,6 +467,10 @@ void SimpleIndexFile::SyncLoadIndexEntries(
         UmaRecordIndexFileState(INDEX_STATE_FRESH, cache_type);
       }
       UmaRecordIndexInitMethod(INITIALIZE_METHOD_LOADED, cache_type);
+      SIMPLE_CACHE_UMA(MEDIUM_TIMES, "IndexLoadTime", cache_type,
+                       base::TimeTicks::Now() - load_start);
+      SIMPLE_CACHE_UMA(COUNTS, "IndexJournalEntriesReplayed", cache_type,
+                       out_result->journal_entry_count);
       return;
     }
     UmaRecordIndexFileState(INDEX_STATE_STALE, cache_type);
@@ -311,7 +478,8 @@ void SimpleIndexFile::SyncLoadIndexEntries(
 
   // Reconstruct the index by scanning the disk for entries.
   const base::TimeTicks start = base::TimeTicks::Now();
-  SyncRestoreFromDisk(cache_directory, index_file_path, out_result);
+  SyncRestoreFromDisk(cache_directory, index_file_path, journal_file_path,
+                      out_result);
   SIMPLE_CACHE_UMA(MEDIUM_TIMES, "IndexRestoreTime", cache_type,
                    base::TimeTicks::Now() - start);
   SIMPLE_CACHE_UMA(COUNTS, "IndexEntriesRestored", cache_type,
@@ -324,11 +492,14 @@ void SimpleIndexFile::SyncLoadIndexEntries(
                      "IndexCreatedEntryCount", cache_type,
                      out_result->entries.size());
   }
+  SIMPLE_CACHE_UMA(MEDIUM_TIMES, "IndexLoadTime", cache_type,
+                   base::TimeTicks::Now() - load_start);
 }
 
 // static
 void SimpleIndexFile::SyncLoadFromDisk(const base::FilePath& index_filename,
                                        base::Time* out_last_cache_seen_by_index,
+                                       uint32* out_index_crc,
                                        SimpleIndexLoadResult* out_result) {
   out_result->Reset();
 
@@ -345,8 +516,78 @@ void SimpleIndexFile::SyncLoadFromDisk(const base::FilePath& index_filename,
       out_last_cache_seen_by_index,
       out_result);
 
-  if (!out_result->did_load)
+  if (!out_result->did_load) {
     base::DeleteFile(index_filename, false);
+    return;
+  }
+  Pickle pickle(reinterpret_cast<const char*>(index_file_map.data()),
+                index_file_map.length());
+  *out_index_crc = pickle.headerT<PickleHeader>()->crc;
+}
+
+// static
+const char* SimpleIndexFile::FindNextPickle(const char* start,
+                                            const char* end) {
+  const size_t length = end - start;
+  if (length < sizeof(PickleHeader))
+    return NULL;
+  const PickleHeader* header = reinterpret_cast<const PickleHeader*>(start);
+  if (length - sizeof(PickleHeader) < header->payload_size)
+    return NULL;
+  return start + sizeof(PickleHeader) + header->payload_size;
+}
+
+// static
+void SimpleIndexFile::SyncReplayJournal(
+    const base::FilePath& journal_filename,
+    uint32 index_crc,
+    base::Time* out_last_cache_seen_by_index,
+    SimpleIndexLoadResult* out_result) {
+  // Whatever goes wrong, writing the index file again starts a good journal.
+  base::MemoryMappedFile journal_map;
+  if (!journal_map.Initialize(journal_filename)) {
+    out_result->flush_required = true;
+    return;
+  }
+  const char* data = reinterpret_cast<const char*>(journal_map.data());
+  const char* const end = data + journal_map.length();
+
+  const char* next = FindNextPickle(data, end);
+  if (!next) {
+    out_result->flush_required = true;
+    return;
+  }
+  Pickle header(data, static_cast<int>(next - data));
+  PickleIterator header_it(header);
+  uint64 magic_number;
+  uint32 version;
+  uint32 journal_index_crc;
+  if (!header.data() ||
+      header.headerT<PickleHeader>()->crc != CalculatePickleCRC(header) ||
+      !header_it.ReadUInt64(&magic_number) ||
+      !header_it.ReadUInt32(&version) ||
+      !header_it.ReadUInt32(&journal_index_crc) ||
+      magic_number != kSimpleIndexJournalMagicNumber ||
+      version != kSimpleVersion || journal_index_crc != index_crc) {
+    VLOG(1) << "Simple Index journal does not follow the index file.";
+    out_result->flush_required = true;
+    return;
+  }
+
+  for (data = next; data != end; data = next) {
+    next = FindNextPickle(data, end);
+    uint64 entry_count;
+    if (!next ||
+        !DeserializeJournalRecords(
+            Pickle(data, static_cast<int>(next - data)),
+            out_last_cache_seen_by_index, &entry_count, &out_result->entries)) {
+      // An append was cut short. The records before it are still good.
+      LOG(WARNING) << "Invalid record in Simple Index journal.";
+      out_result->flush_required = true;
+      return;
+    }
+    out_result->journal_entry_count += entry_count;
+  }
 }
 
 // static
@@ -432,9 +673,11 @@ void SimpleIndexFile::Deserialize(const char* data, int data_len,
 void SimpleIndexFile::SyncRestoreFromDisk(
     const base::FilePath& cache_directory,
     const base::FilePath& index_file_path,
+    const base::FilePath& journal_file_path,
     SimpleIndexLoadResult* out_result) {
   VLOG(1) << "Simple Cache Index is being restored from disk.";
   base::DeleteFile(index_file_path, /* recursive = */ false);
+  base::DeleteFile(journal_file_path, /* recursive = */ false);
   out_result->Reset();
   SimpleIndex::EntrySet* entries = &out_result->entries;
 
@@ -28,6 +28,7 @@ class TaskRunner;
 namespace disk_cache {
 
 const uint64 kSimpleIndexMagicNumber = GG_UINT64_C(0x656e74657220796f);
+const uint64 kSimpleIndexJournalMagicNumber = GG_UINT64_C(0x6a6f75726e616c73);
 
 struct NET_EXPORT_PRIVATE SimpleIndexLoadResult {
   SimpleIndexLoadResult();
@@ -37,6 +38,8 @@ struct NET_EXPORT_PRIVATE SimpleIndexLoadResult {
   bool did_load;
   SimpleIndex::EntrySet entries;
   bool flush_required;
+  // Number of entry records replayed from the journal.
+  uint64 journal_entry_count;
 };
 
 // Simple Index File format is a pickle serialized data of IndexMetadata and
@@ -46,6 +49,13 @@ struct NET_EXPORT_PRIVATE SimpleIndexLoadResult {
 // see SimpleIndexFile::Serialize() and SeeSimpleIndexFile::LoadFromDisk()
 // methods.
 //
+// Between two writes of the whole index file (checkpoints), the entries which
+// changed are appended to a journal file. The journal starts with a pickle
+// holding the crc of the checkpoint it follows, and each append is a pickle of
+// entry records followed by the cache modification time, like the index file.
+// Loading the index replays the journal over the checkpoint, so that the
+// directory only needs to be scanned when both are unusable.
+//
 // The non-static methods must run on the IO thread. All the real
 // work is done in the static methods, which are run on the cache thread
 // or in worker threads. Synchronization between methods is the
@@ -85,12 +95,19 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                                 const base::Closure& callback,
                                 SimpleIndexLoadResult* out_result);
 
-  // Write the specified set of entries to disk.
+  // Write the specified set of entries to disk, and start a new journal.
   virtual void WriteToDisk(const SimpleIndex::EntrySet& entry_set,
                            uint64 cache_size,
                            const base::TimeTicks& start,
                            bool app_on_background);
 
+  // Append the metadata of |changed_entries|, and the removal of
+  // |removed_entries|, to the journal of the last index file written.
+  virtual void AppendToJournal(const SimpleIndex::EntrySet& changed_entries,
+                               const SimpleIndex::HashList& removed_entries,
+                               const base::TimeTicks& start,
+                               bool app_on_background);
+
  private:
   friend class WrappedSimpleIndexFile;
 
@@ -106,13 +123,28 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                                    base::Time cache_last_modified,
                                    const base::FilePath& cache_directory,
                                    const base::FilePath& index_file_path,
+                                   const base::FilePath& journal_file_path,
                                    SimpleIndexLoadResult* out_result);
 
-  // Load the index file from disk returning an EntrySet.
+  // Load the index file from disk returning an EntrySet. The crc of the index
+  // file is returned in |out_index_crc|.
   static void SyncLoadFromDisk(const base::FilePath& index_filename,
                                base::Time* out_last_cache_seen_by_index,
+                               uint32* out_index_crc,
                                SimpleIndexLoadResult* out_result);
 
+  // Returns the end of the pickle written by this class that starts at
+  // |start|, or NULL if it does not end before |end|.
+  static const char* FindNextPickle(const char* start, const char* end);
+
+  // Applies the records of the journal that follows the index file of crc
+  // |index_crc| to the entries loaded from it. Requires a flush if the journal
+  // is missing, belongs to another index file or is cut short.
+  static void SyncReplayJournal(const base::FilePath& journal_filename,
+                                uint32 index_crc,
+                                base::Time* out_last_cache_seen_by_index,
+                                SimpleIndexLoadResult* out_result);
+
   // Returns a scoped_ptr for a newly allocated Pickle containing the serialized
   // data to be written to a file. Note: the pickle is not in a consistent state
   // immediately after calling this menthod, one needs to call
@@ -127,6 +159,24 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
   // worker thread.
   static bool SerializeFinalData(base::Time cache_modified, Pickle* pickle);
 
+  // Returns a newly allocated Pickle holding the first record of a journal,
+  // which ties it to the index file of crc |index_crc|.
+  static scoped_ptr<Pickle> SerializeJournalHeader(uint32 index_crc);
+
+  // Returns a newly allocated Pickle holding journal records for the given
+  // entries. Like Serialize(), it needs SerializeFinalData() before it can be
+  // written.
+  static scoped_ptr<Pickle> SerializeJournalRecords(
+      const SimpleIndex::EntrySet& changed_entries,
+      const SimpleIndex::HashList& removed_entries);
+
+  // Given the journal records in |pickle|, updates |entries| and returns the
+  // number of records in |out_entry_count|. Returns false on error.
+  static bool DeserializeJournalRecords(const Pickle& pickle,
+                                        base::Time* out_cache_last_modified,
+                                        uint64* out_entry_count,
+                                        SimpleIndex::EntrySet* entries);
+
   // Given the contents of an index file |data| of length |data_len|, returns
   // the corresponding EntrySet. Returns NULL on error.
   static void Deserialize(const char* data, int data_len,
@@ -142,7 +192,8 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
       const base::FilePath& cache_path,
       const EntryFileCallback& entry_file_callback);
 
-  // Writes the index file to disk atomically.
+  // Writes the index file to disk atomically, and starts its journal next to
+  // it.
   static void SyncWriteToDisk(net::CacheType cache_type,
                               const base::FilePath& cache_directory,
                               const base::FilePath& index_filename,
@@ -151,10 +202,19 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
                               const base::TimeTicks& start_time,
                               bool app_on_background);
 
+  // Appends the records in |pickle| to the journal, if there is one.
+  static void SyncAppendToJournal(net::CacheType cache_type,
+                                  const base::FilePath& cache_directory,
+                                  const base::FilePath& journal_filename,
+                                  scoped_ptr<Pickle> pickle,
+                                  const base::TimeTicks& start_time,
+                                  bool app_on_background);
+
   // Scan the index directory for entries, returning an EntrySet of all entries
   // found.
   static void SyncRestoreFromDisk(const base::FilePath& cache_directory,
                                   const base::FilePath& index_file_path,
+                                  const base::FilePath& journal_file_path,
                                   SimpleIndexLoadResult* out_result);
 
   // Determines if an index file is stale relative to the time of last
@@ -174,10 +234,12 @@ class NET_EXPORT_PRIVATE SimpleIndexFile {
   const base::FilePath cache_directory_;
   const base::FilePath index_file_;
   const base::FilePath temp_index_file_;
+  const base::FilePath journal_file_;
 
   static const char kIndexDirectory[];
   static const char kIndexFileName[];
   static const char kTempIndexFileName[];
+  static const char kJournalFileName[];
 
   DISALLOW_COPY_AND_ASSIGN(SimpleIndexFile);
 };
@@ -86,6 +86,10 @@ class WrappedSimpleIndexFile : public SimpleIndexFile {
     return index_file_;
   }
 
+  const base::FilePath& GetJournalFilePath() const {
+    return journal_file_;
+  }
+
   bool CreateIndexFileDirectory() const {
     return base::CreateDirectory(index_file_.DirName());
   }
@@ -263,6 +267,94 @@ TEST_F(SimpleIndexFileTest, LoadCorruptIndex) {
   EXPECT_TRUE(load_index_result.flush_required);
 }
 
+TEST_F(SimpleIndexFileTest, WriteJournalThenLoadIndex) {
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+
+  SimpleIndex::EntrySet entries;
+  static const uint64 kHashes[] = { 11, 22, 33 };
+  for (size_t i = 0; i < arraysize(kHashes); ++i) {
+    SimpleIndex::InsertInEntrySet(kHashes[i], EntryMetadata(Time(), kHashes[i]),
+                                  &entries);
+  }
+  SimpleIndex::EntrySet changed_entries;
+  SimpleIndex::InsertInEntrySet(11, EntryMetadata(Time(), 111),
+                                &changed_entries);
+  SimpleIndex::InsertInEntrySet(44, EntryMetadata(Time(), 44),
+                                &changed_entries);
+  const SimpleIndex::HashList removed_entries(1, 22);
+
+  {
+    WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+    simple_index_file.WriteToDisk(entries, 456U, base::TimeTicks(), false);
+    simple_index_file.AppendToJournal(changed_entries, removed_entries,
+                                      base::TimeTicks(), false);
+    base::RunLoop().RunUntilIdle();
+    EXPECT_TRUE(base::PathExists(simple_index_file.GetJournalFilePath()));
+  }
+
+  WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+  SimpleIndexLoadResult load_index_result;
+  simple_index_file.LoadIndexEntries(Time(), GetCallback(),
+                                     &load_index_result);
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_TRUE(callback_called());
+  EXPECT_TRUE(load_index_result.did_load);
+  EXPECT_FALSE(load_index_result.flush_required);
+  EXPECT_EQ(3U, load_index_result.journal_entry_count);
+
+  const SimpleIndex::EntrySet& loaded_entries = load_index_result.entries;
+  EXPECT_EQ(3U, loaded_entries.size());
+  EXPECT_EQ(0U, loaded_entries.count(22));
+  ASSERT_EQ(1U, loaded_entries.count(11));
+  EXPECT_EQ(111, loaded_entries.find(11)->second.GetEntrySize());
+  EXPECT_EQ(1U, loaded_entries.count(33));
+  EXPECT_EQ(1U, loaded_entries.count(44));
+}
+
+// Tests that a journal left over from a previous index file is not replayed.
+TEST_F(SimpleIndexFileTest, IgnoreJournalOfOtherIndex) {
+  base::ScopedTempDir cache_dir;
+  ASSERT_TRUE(cache_dir.CreateUniqueTempDir());
+
+  SimpleIndex::EntrySet entries;
+  SimpleIndex::InsertInEntrySet(11, EntryMetadata(Time(), 11), &entries);
+  SimpleIndex::EntrySet changed_entries;
+  SimpleIndex::InsertInEntrySet(44, EntryMetadata(Time(), 44),
+                                &changed_entries);
+
+  const base::FilePath old_journal = cache_dir.path().AppendASCII("journal");
+  {
+    WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+    simple_index_file.WriteToDisk(entries, 11U, base::TimeTicks(), false);
+    simple_index_file.AppendToJournal(changed_entries,
+                                      SimpleIndex::HashList(),
+                                      base::TimeTicks(), false);
+    base::RunLoop().RunUntilIdle();
+    ASSERT_TRUE(base::CopyFile(simple_index_file.GetJournalFilePath(),
+                               old_journal));
+
+    simple_index_file.WriteToDisk(entries, 12U, base::TimeTicks(), false);
+    base::RunLoop().RunUntilIdle();
+    ASSERT_TRUE(base::CopyFile(old_journal,
+                               simple_index_file.GetJournalFilePath()));
+  }
+
+  WrappedSimpleIndexFile simple_index_file(cache_dir.path());
+  SimpleIndexLoadResult load_index_result;
+  simple_index_file.LoadIndexEntries(Time(), GetCallback(),
+                                     &load_index_result);
+  base::RunLoop().RunUntilIdle();
+
+  ASSERT_TRUE(callback_called());
+  EXPECT_TRUE(load_index_result.did_load);
+  EXPECT_TRUE(load_index_result.flush_required);
+  EXPECT_EQ(0U, load_index_result.journal_entry_count);
+  EXPECT_EQ(1U, load_index_result.entries.size());
+  EXPECT_EQ(1U, load_index_result.entries.count(11));
+}
+
 // Tests that after an upgrade the backend has the index file put in place.
 TEST_F(SimpleIndexFileTest, SimpleCacheUpgrade) {
   base::ScopedTempDir cache_dir;
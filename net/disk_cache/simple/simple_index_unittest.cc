@@ -16,6 +16,7 @@
 #include "base/threading/platform_thread.h"
 #include "base/time/time.h"
 #include "net/base/cache_type.h"
+#include "net/disk_cache/eviction_policy.h"
 #include "net/disk_cache/simple/simple_index.h"
 #include "net/disk_cache/simple/simple_index_delegate.h"
 #include "net/disk_cache/simple/simple_index_file.h"
@@ -55,7 +56,8 @@ class MockSimpleIndexFile : public SimpleIndexFile,
       : SimpleIndexFile(NULL, NULL, net::DISK_CACHE, base::FilePath()),
         load_result_(NULL),
         load_index_entries_calls_(0),
-        disk_writes_(0) {}
+        disk_writes_(0),
+        journal_appends_(0) {}
 
   virtual void LoadIndexEntries(
       base::Time cache_last_modified,
@@ -74,6 +76,15 @@ class MockSimpleIndexFile : public SimpleIndexFile,
     disk_write_entry_set_ = entry_set;
   }
 
+  virtual void AppendToJournal(const SimpleIndex::EntrySet& changed_entries,
+                               const SimpleIndex::HashList& removed_entries,
+                               const base::TimeTicks& start,
+                               bool app_on_background) OVERRIDE {
+    journal_appends_++;
+    journal_changed_entries_ = changed_entries;
+    journal_removed_entries_ = removed_entries;
+  }
+
   void GetAndResetDiskWriteEntrySet(SimpleIndex::EntrySet* entry_set) {
     entry_set->swap(disk_write_entry_set_);
   }
@@ -82,6 +93,13 @@ class MockSimpleIndexFile : public SimpleIndexFile,
   SimpleIndexLoadResult* load_result() const { return load_result_; }
   int load_index_entries_calls() const { return load_index_entries_calls_; }
   int disk_writes() const { return disk_writes_; }
+  int journal_appends() const { return journal_appends_; }
+  const SimpleIndex::EntrySet& journal_changed_entries() const {
+    return journal_changed_entries_;
+  }
+  const SimpleIndex::HashList& journal_removed_entries() const {
+    return journal_removed_entries_;
+  }
 
  private:
   base::Closure load_callback_;
@@ -89,6 +107,9 @@ class MockSimpleIndexFile : public SimpleIndexFile,
   int load_index_entries_calls_;
   int disk_writes_;
   SimpleIndex::EntrySet disk_write_entry_set_;
+  int journal_appends_;
+  SimpleIndex::EntrySet journal_changed_entries_;
+  SimpleIndex::HashList journal_removed_entries_;
 };
 
 class SimpleIndexTest  : public testing::Test, public SimpleIndexDelegate {
@@ -549,6 +570,33 @@ TEST_F(SimpleIndexTest, BasicEviction) {
   ASSERT_EQ(2u, last_doom_entry_hashes().size());
 }
 
+// Confirm that the size-aware policy evicts a large entry before a small one
+// that was used a little earlier.
+TEST_F(SimpleIndexTest, SizeAwareEviction) {
+  index()->eviction_policy_ =
+      EvictionPolicy::Create(EvictionPolicy::SIZE_AWARE);
+  base::Time now(base::Time::Now());
+  index()->SetMaxSize(1000000);
+  InsertIntoIndexFileReturn(hashes_.at<1>(),
+                            now - base::TimeDelta::FromHours(2),
+                            10000u);
+  InsertIntoIndexFileReturn(hashes_.at<2>(),
+                            now - base::TimeDelta::FromHours(1),
+                            900000u);
+  ReturnIndexFile();
+
+  index()->Insert(hashes_.at<3>());
+  EXPECT_EQ(0, doom_entries_calls());
+  index()->UpdateEntrySize(hashes_.at<3>(), 45000);
+  EXPECT_EQ(1, doom_entries_calls());
+  EXPECT_EQ(2, index()->GetEntryCount());
+  EXPECT_TRUE(index()->Has(hashes_.at<1>()));
+  EXPECT_FALSE(index()->Has(hashes_.at<2>()));
+  EXPECT_TRUE(index()->Has(hashes_.at<3>()));
+  ASSERT_EQ(1u, last_doom_entry_hashes().size());
+  EXPECT_EQ(hashes_.at<2>(), last_doom_entry_hashes()[0]);
+}
+
 // Confirm all the operations queue a disk write at some point in the
 // future.
 TEST_F(SimpleIndexTest, DiskWriteQueued) {
@@ -626,4 +674,42 @@ TEST_F(SimpleIndexTest, DiskWritePostponed) {
   index()->write_to_disk_timer_.Stop();
 }
 
+// Confirm that writes of a few changes go to the journal, until it is big
+// enough for the whole index to be written again.
+TEST_F(SimpleIndexTest, DiskWriteJournaled) {
+  index()->SetMaxSize(100000);
+  const uint64 kNumEntries = 20;
+  for (uint64 hash = 1; hash <= kNumEntries; ++hash)
+    InsertIntoIndexFileReturn(hash, base::Time::Now(), 10);
+  ReturnIndexFile();
+
+  index()->UpdateEntrySize(1, 20);
+  index()->Remove(2);
+  index()->WriteToDisk();
+  EXPECT_EQ(0, index_file_->disk_writes());
+  ASSERT_EQ(1, index_file_->journal_appends());
+  ASSERT_EQ(1u, index_file_->journal_changed_entries().size());
+  EXPECT_EQ(20, index_file_->journal_changed_entries().find(1)->second
+                    .GetEntrySize());
+  ASSERT_EQ(1u, index_file_->journal_removed_entries().size());
+  EXPECT_EQ(2u, index_file_->journal_removed_entries()[0]);
+
+  // The journal now holds records for over a quarter of the entries.
+  for (uint64 hash = 3; hash <= 6; ++hash)
+    index()->UseIfExists(hash);
+  index()->WriteToDisk();
+  EXPECT_EQ(1, index_file_->disk_writes());
+  EXPECT_EQ(1, index_file_->journal_appends());
+  SimpleIndex::EntrySet entry_set;
+  index_file_->GetAndResetDiskWriteEntrySet(&entry_set);
+  EXPECT_EQ(kNumEntries - 1, entry_set.size());
+
+  // Then the journal starts over.
+  index()->UseIfExists(3);
+  index()->WriteToDisk();
+  EXPECT_EQ(1, index_file_->disk_writes());
+  EXPECT_EQ(2, index_file_->journal_appends());
+  index()->write_to_disk_timer_.Stop();
+}
+
 }  // namespace disk_cache
@@ -9,6 +9,10 @@
 #include <functional>
 #include <limits>
 
+#if defined(OS_POSIX)
+#include <sys/mman.h>
+#endif
+
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/file_util.h"
@@ -29,6 +33,10 @@ using base::Time;
 
 namespace {
 
+// Entry files bigger than this are not mapped in memory by MapStream1(), so
+// that the address space used for mappings stays modest.
+const int64 kMaxMappedFileSize = 256 * 1024;
+
 // Used in histograms, please only add entries at the end.
 enum OpenEntryResult {
   OPEN_ENTRY_SUCCESS = 0,
@@ -165,6 +173,8 @@ SimpleEntryCreationResults::SimpleEntryCreationResults(
     : sync_entry(NULL),
       entry_stat(entry_stat),
       stream_0_crc32(crc32(0, Z_NULL, 0)),
+      mapped_stream_1_data(NULL),
+      mapped_stream_1_crc32(crc32(0, Z_NULL, 0)),
       result(net::OK) {
 }
 
@@ -213,6 +223,7 @@ void SimpleSynchronousEntry::OpenEntry(
     const FilePath& path,
     const uint64 entry_hash,
     bool had_index,
+    bool map_stream_1,
     SimpleEntryCreationResults *out_results) {
   SimpleSynchronousEntry* sync_entry =
       new SimpleSynchronousEntry(cache_type, path, "", entry_hash);
@@ -228,6 +239,10 @@ void SimpleSynchronousEntry::OpenEntry(
     out_results->stream_0_data = NULL;
     return;
   }
+  if (map_stream_1) {
+    out_results->mapped_stream_1_data = sync_entry->MapStream1(
+        out_results->entry_stat, &out_results->mapped_stream_1_crc32);
+  }
   out_results->sync_entry = sync_entry;
 }
 
@@ -319,6 +334,11 @@ void SimpleSynchronousEntry::WriteData(const EntryOperationData& in_entry_op,
       key_, in_entry_op.offset, in_entry_op.index);
   bool extending_by_write = offset + buf_len > out_entry_stat->data_size(index);
 
+  // The entry stopped reading stream 1 from the mapping before posting the
+  // write.
+  if (file_index == 0)
+    UnmapFile0();
+
   if (empty_file_omitted_[file_index]) {
     // Don't create a new file if the entry has been doomed, to avoid it being
     // mixed up with a newly-created entry with the same key.
@@ -705,7 +725,9 @@ SimpleSynchronousEntry::SimpleSynchronousEntry(net::CacheType cache_type,
       entry_hash_(entry_hash),
       key_(key),
       have_open_files_(false),
-      initialized_(false) {
+      initialized_(false),
+      file_0_mapping_(NULL),
+      file_0_mapping_length_(0) {
   for (int i = 0; i < kSimpleEntryFileCount; ++i)
     empty_file_omitted_[i] = false;
 }
@@ -890,6 +912,7 @@ void SimpleSynchronousEntry::CloseFile(int index) {
 }
 
 void SimpleSynchronousEntry::CloseFiles() {
+  UnmapFile0();
   for (int i = 0; i < kSimpleEntryFileCount; ++i)
     CloseFile(i);
 }
@@ -1098,6 +1121,65 @@ int SimpleSynchronousEntry::ReadAndValidateStream0(
   return net::OK;
 }
 
+const char* SimpleSynchronousEntry::MapStream1(
+    const SimpleEntryStat& entry_stat,
+    uint32* out_crc32) {
+#if defined(OS_POSIX)
+  DCHECK(!file_0_mapping_);
+  const int stream_1_size = entry_stat.data_size(1);
+  const int64 file_size = entry_stat.GetFileSize(key_, 0);
+  if (stream_1_size == 0 || file_size > kMaxMappedFileSize)
+    return NULL;
+
+  void* mapping = mmap(NULL, file_size, PROT_READ, MAP_SHARED,
+                       files_[0].GetPlatformFile(), 0);
+  if (mapping == MAP_FAILED) {
+    DPLOG(WARNING) << "Could not map entry file.";
+    return NULL;
+  }
+  file_0_mapping_ = mapping;
+  file_0_mapping_length_ = file_size;
+
+  // Stream 1 is checked once here rather than as it is read, so that readers
+  // can be handed the data without further ado.
+  const char* stream_1_data = static_cast<const char*>(mapping) +
+                              entry_stat.GetOffsetInFile(key_, 0, 1);
+  uint32 read_crc32;
+  bool has_crc32;
+  int stream_size;
+  if (GetEOFRecordData(1, entry_stat, &has_crc32, &read_crc32,
+                       &stream_size) != net::OK ||
+      stream_size != stream_1_size) {
+    UnmapFile0();
+    return NULL;
+  }
+  *out_crc32 = crc32(crc32(0, Z_NULL, 0),
+                     reinterpret_cast<const Bytef*>(stream_1_data),
+                     stream_1_size);
+  if (has_crc32 && read_crc32 != *out_crc32) {
+    DVLOG(1) << "EOF record had bad crc.";
+    RecordCheckEOFResult(cache_type_, CHECK_EOF_RESULT_CRC_MISMATCH);
+    UnmapFile0();
+    return NULL;
+  }
+  RecordCheckEOFResult(cache_type_, CHECK_EOF_RESULT_SUCCESS);
+  return stream_1_data;
+#else
+  return NULL;
+#endif
+}
+
+void SimpleSynchronousEntry::UnmapFile0() {
+#if defined(OS_POSIX)
+  if (!file_0_mapping_)
+    return;
+  if (munmap(file_0_mapping_, file_0_mapping_length_) != 0)
+    DPLOG(WARNING) << "Could not unmap entry file.";
+  file_0_mapping_ = NULL;
+  file_0_mapping_length_ = 0;
+#endif
+}
+
 int SimpleSynchronousEntry::GetEOFRecordData(int index,
                                              const SimpleEntryStat& entry_stat,
                                              bool* out_has_crc32,
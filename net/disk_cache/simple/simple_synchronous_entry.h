@@ -78,6 +78,10 @@ struct SimpleEntryCreationResults {
   scoped_refptr<net::GrowableIOBuffer> stream_0_data;
   SimpleEntryStat entry_stat;
   uint32 stream_0_crc32;
+  // Set if stream 1 was mapped in memory on open, in which case it stays valid
+  // until stream 1 is written to or the entry is closed.
+  const char* mapped_stream_1_data;
+  uint32 mapped_stream_1_crc32;
   int result;
 };
 
@@ -116,6 +120,7 @@ class SimpleSynchronousEntry {
                         const base::FilePath& path,
                         uint64 entry_hash,
                         bool had_index,
+                        bool map_stream_1,
                         SimpleEntryCreationResults* out_results);
 
   static void CreateEntry(net::CacheType cache_type,
@@ -254,6 +259,12 @@ class SimpleSynchronousEntry {
       scoped_refptr<net::GrowableIOBuffer>* stream_0_data,
       uint32* out_stream_0_crc32) const;
 
+  // Maps the file of streams 0 and 1 in memory if it is small enough and
+  // checks the crc32 of stream 1, which it stores in |out_crc32|. Returns the
+  // start of stream 1 in the mapping, or NULL if it was not mapped.
+  const char* MapStream1(const SimpleEntryStat& entry_stat, uint32* out_crc32);
+  void UnmapFile0();
+
   int GetEOFRecordData(int index,
                        const SimpleEntryStat& entry_stat,
                        bool* out_has_crc32,
@@ -322,6 +333,10 @@ class SimpleSynchronousEntry {
   // was created to store it.
   bool empty_file_omitted_[kSimpleEntryFileCount];
 
+  // Mapping of files_[0] made by MapStream1(), if any.
+  void* file_0_mapping_;
+  size_t file_0_mapping_length_;
+
   typedef std::map<int64, SparseRange> SparseRangeOffsetMap;
   typedef SparseRangeOffsetMap::iterator SparseRangeIterator;
   SparseRangeOffsetMap sparse_ranges_;
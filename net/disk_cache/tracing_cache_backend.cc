@@ -4,8 +4,18 @@
 
 #include "net/disk_cache/tracing_cache_backend.h"
 
+#include "base/file_util.h"
+#include "base/logging.h"
+#include "base/threading/thread_restrictions.h"
 #include "net/base/net_errors.h"
 
+namespace {
+
+// Records are buffered and written out in batches of this many.
+const size_t kTraceFlushRecords = 1024;
+
+}  // namespace
+
 namespace disk_cache {
 
 // Proxies entry objects created by the real underlying backend. Backend users
@@ -53,6 +63,7 @@ class EntryProxy : public Entry, public base::RefCountedThreadSafe<EntryProxy> {
                        RwOpExtra extra, const CompletionCallback& cb,
                        int result);
   Entry* entry_;
+  const uint64 key_id_;
   base::WeakPtr<TracingCacheBackend> backend_;
 
   DISALLOW_COPY_AND_ASSIGN(EntryProxy);
@@ -60,16 +71,21 @@ class EntryProxy : public Entry, public base::RefCountedThreadSafe<EntryProxy> {
 
 EntryProxy::EntryProxy(Entry *entry, TracingCacheBackend* backend)
   : entry_(entry),
+    key_id_(CacheTraceKeyId(entry->GetKey())),
     backend_(backend->AsWeakPtr()) {
 }
 
 void EntryProxy::Doom() {
-  // TODO(pasko): Record the event.
+  RwOpExtra extra = { 0, 0, 0, false };
+  RecordEvent(base::TimeTicks::Now(), TracingCacheBackend::OP_DOOM, extra,
+              net::OK);
   entry_->Doom();
 }
 
 void EntryProxy::Close() {
-  // TODO(pasko): Record the event.
+  RwOpExtra extra = { 0, 0, 0, false };
+  RecordEvent(base::TimeTicks::Now(), TracingCacheBackend::OP_CLOSE, extra,
+              net::OK);
   entry_->Close();
   Release();
 }
@@ -158,7 +174,11 @@ int EntryProxy::ReadyForSparseIO(const CompletionCallback& callback) {
 
 void EntryProxy::RecordEvent(base::TimeTicks start_time, Operation op,
                              RwOpExtra extra, int result_to_record) {
-  // TODO(pasko): Implement.
+  if (!backend_.get())
+    return;
+  backend_->AppendTraceRecord(start_time, op, key_id_, extra.index,
+                              extra.offset, extra.buf_len, extra.truncate,
+                              result_to_record);
 }
 
 void EntryProxy::EntryOpComplete(base::TimeTicks start_time, Operation op,
@@ -180,7 +200,27 @@ TracingCacheBackend::TracingCacheBackend(scoped_ptr<Backend> backend)
   : backend_(backend.Pass()) {
 }
 
+TracingCacheBackend::TracingCacheBackend(scoped_ptr<Backend> backend,
+                                         const base::FilePath& trace_path)
+  : backend_(backend.Pass()),
+    trace_path_(trace_path),
+    trace_start_(base::TimeTicks::Now()) {
+  CacheTraceHeader header;
+  header.magic = kCacheTraceMagic;
+  header.version = kCacheTraceVersion;
+  header.creation_time = base::Time::Now().ToInternalValue();
+  // Tracing is a diagnostics-only configuration and the header is tiny.
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  if (file_util::WriteFile(trace_path_, reinterpret_cast<const char*>(&header),
+                           sizeof(header)) != sizeof(header)) {
+    LOG(WARNING) << "Unable to create cache trace "
+                 << trace_path_.LossyDisplayName();
+    trace_path_.clear();
+  }
+}
+
 TracingCacheBackend::~TracingCacheBackend() {
+  FlushTrace();
 }
 
 net::CacheType TracingCacheBackend::GetCacheType() const {
@@ -193,7 +233,46 @@ int32 TracingCacheBackend::GetEntryCount() const {
 
 void TracingCacheBackend::RecordEvent(base::TimeTicks start_time, Operation op,
                                       std::string key, Entry* entry, int rv) {
-  // TODO(pasko): Implement.
+  AppendTraceRecord(start_time, op, CacheTraceKeyId(key), 0, 0, 0, false, rv);
+}
+
+void TracingCacheBackend::AppendTraceRecord(base::TimeTicks start_time,
+                                            Operation op, uint64 key_id,
+                                            int index, int offset, int length,
+                                            bool truncate, int result) {
+  if (trace_path_.empty())
+    return;
+  CacheTraceRecord record = {};
+  record.start_us = (start_time - trace_start_).InMicroseconds();
+  record.duration_us = static_cast<uint32>(
+      (base::TimeTicks::Now() - start_time).InMicroseconds());
+  record.operation = static_cast<uint8>(op);
+  record.index = static_cast<uint8>(index);
+  record.truncate = truncate ? 1 : 0;
+  record.key_id = key_id;
+  record.offset = offset;
+  record.length = length;
+  record.result = result;
+  pending_records_.push_back(record);
+  if (pending_records_.size() >= kTraceFlushRecords)
+    FlushTrace();
+}
+
+void TracingCacheBackend::FlushTrace() {
+  if (trace_path_.empty() || pending_records_.empty())
+    return;
+  const int size =
+      static_cast<int>(pending_records_.size() * sizeof(CacheTraceRecord));
+  // Writes are batched, see kTraceFlushRecords.
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  if (file_util::AppendToFile(
+          trace_path_, reinterpret_cast<const char*>(&pending_records_[0]),
+          size) != size) {
+    LOG(WARNING) << "Unable to write cache trace "
+                 << trace_path_.LossyDisplayName();
+    trace_path_.clear();
+  }
+  pending_records_.clear();
 }
 
 EntryProxy* TracingCacheBackend::FindOrCreateEntryProxy(Entry* entry) {
@@ -5,7 +5,12 @@
 #ifndef NET_DISK_CACHE_TRACING_CACHE_BACKEND_H_
 #define NET_DISK_CACHE_TRACING_CACHE_BACKEND_H_
 
+#include <vector>
+
+#include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "net/disk_cache/cache_trace_format.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/disk_cache/stats.h"
 
@@ -15,11 +20,15 @@ class EntryProxy;
 
 // The TracingCacheBackend implements the Cache Backend interface. It intercepts
 // all backend operations from the IO thread and records the time from the start
-// of the operation until the result is delivered.
+// of the operation until the result is delivered. When constructed with a
+// trace path, the operations are also written there in the format described by
+// cache_trace_format.h, so that the workload can be replayed later.
 class NET_EXPORT TracingCacheBackend : public Backend,
     public base::SupportsWeakPtr<TracingCacheBackend> {
  public:
   explicit TracingCacheBackend(scoped_ptr<Backend> backend);
+  TracingCacheBackend(scoped_ptr<Backend> backend,
+                      const base::FilePath& trace_path);
 
   virtual net::CacheType GetCacheType() const OVERRIDE;
   virtual int32 GetEntryCount() const OVERRIDE;
@@ -44,11 +53,13 @@ class NET_EXPORT TracingCacheBackend : public Backend,
  private:
   friend class EntryProxy;
   enum Operation {
-    OP_OPEN,
-    OP_CREATE,
-    OP_DOOM_ENTRY,
-    OP_READ,
-    OP_WRITE
+    OP_OPEN = TRACE_OP_OPEN,
+    OP_CREATE = TRACE_OP_CREATE,
+    OP_DOOM_ENTRY = TRACE_OP_DOOM_ENTRY,
+    OP_READ = TRACE_OP_READ,
+    OP_WRITE = TRACE_OP_WRITE,
+    OP_DOOM = TRACE_OP_DOOM,
+    OP_CLOSE = TRACE_OP_CLOSE
   };
 
   virtual ~TracingCacheBackend();
@@ -60,6 +71,12 @@ class NET_EXPORT TracingCacheBackend : public Backend,
   void RecordEvent(base::TimeTicks start_time, Operation op, std::string key,
                    Entry* entry, int result);
 
+  // Appends a record to the trace, if one is being written.
+  void AppendTraceRecord(base::TimeTicks start_time, Operation op,
+                         uint64 key_id, int index, int offset, int length,
+                         bool truncate, int result);
+  void FlushTrace();
+
   void BackendOpComplete(base::TimeTicks start_time, Operation op,
                          std::string key, Entry** entry,
                          const CompletionCallback& callback, int result);
@@ -73,6 +90,10 @@ class NET_EXPORT TracingCacheBackend : public Backend,
   typedef std::map<Entry*, EntryProxy*> EntryToProxyMap;
   EntryToProxyMap open_entries_;
 
+  base::FilePath trace_path_;
+  base::TimeTicks trace_start_;
+  std::vector<CacheTraceRecord> pending_records_;
+
   DISALLOW_COPY_AND_ASSIGN(TracingCacheBackend);
 };
 
@@ -16,6 +16,7 @@
 #include "net/base/net_errors.h"
 #include "net/dns/dns_config_service.h"
 #include "net/dns/dns_socket_pool.h"
+#include "net/dns/dns_tcp_connection.h"
 #include "net/socket/stream_socket.h"
 #include "net/udp/datagram_client_socket.h"
 
@@ -93,6 +94,8 @@ DnsSession::DnsSession(const DnsConfig& config,
   for (size_t i = 0; i < config_.nameservers.size(); ++i) {
     server_stats_.push_back(new ServerStats(config_.timeout,
                                             rtt_buckets_.Pointer()));
+    tcp_connections_.push_back(
+        new DnsTCPConnection(socket_pool_.get(), i, net_log));
   }
 }
 
@@ -238,6 +241,11 @@ scoped_ptr<StreamSocket> DnsSession::CreateTCPSocket(
   return socket_pool_->CreateTCPSocket(server_index, source);
 }
 
+DnsTCPConnection* DnsSession::GetTCPConnection(unsigned server_index) {
+  DCHECK_LT(server_index, tcp_connections_.size());
+  return tcp_connections_[server_index];
+}
+
 // Release a socket.
 void DnsSession::FreeSocket(unsigned server_index,
                             scoped_ptr<DatagramClientSocket> socket) {
@@ -27,6 +27,7 @@ namespace net {
 
 class ClientSocketFactory;
 class DatagramClientSocket;
+class DnsTCPConnection;
 class NetLog;
 class StreamSocket;
 
@@ -106,6 +107,10 @@ class NET_EXPORT_PRIVATE DnsSession
   scoped_ptr<StreamSocket> CreateTCPSocket(unsigned server_index,
                                            const NetLog::Source& source);
 
+  // Returns the persistent TCP connection to the server, which is shared by
+  // all transactions in this session.
+  DnsTCPConnection* GetTCPConnection(unsigned server_index);
+
  private:
   friend class base::RefCounted<DnsSession>;
   ~DnsSession();
@@ -133,6 +138,10 @@ class NET_EXPORT_PRIVATE DnsSession
   // Track runtime statistics of each DNS server.
   ScopedVector<ServerStats> server_stats_;
 
+  // TCP connections to each DNS server. Declared after |socket_pool_|, which
+  // they use.
+  ScopedVector<DnsTCPConnection> tcp_connections_;
+
   // Buckets shared for all |ServerStats::rtt_histogram|.
   struct RttBuckets : public base::BucketRanges {
     RttBuckets();
@@ -0,0 +1,331 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/dns/dns_tcp_connection.h"
+
+#include <string.h>
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram.h"
+#include "net/base/big_endian.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/dns/dns_protocol.h"
+#include "net/dns/dns_socket_pool.h"
+#include "net/socket/stream_socket.h"
+
+namespace net {
+
+namespace {
+
+// Size of the length prefix of each message on a DNS TCP connection.
+const int kLengthSize = sizeof(uint16);
+
+// The connection is closed when no queries have been outstanding for this
+// long, to free up resources on the server.
+const int kIdleTimeoutSeconds = 10;
+
+}  // namespace
+
+DnsTCPConnection::PendingQuery::PendingQuery() : retried(false) {}
+
+DnsTCPConnection::PendingQuery::PendingQuery(IOBufferWithSize* framed_query,
+                                             const ResponseCallback& callback)
+    : framed_query(framed_query), callback(callback), retried(false) {}
+
+DnsTCPConnection::PendingQuery::~PendingQuery() {}
+
+DnsTCPConnection::DnsTCPConnection(DnsSocketPool* socket_pool,
+                                   unsigned server_index,
+                                   NetLog* net_log)
+    : socket_pool_(socket_pool),
+      server_index_(server_index),
+      net_log_(BoundNetLog::Make(net_log,
+                                 NetLog::SOURCE_DNS_TCP_CONNECTION)),
+      state_(STATE_DISCONNECTED),
+      received_response_(false),
+      write_pending_(false),
+      flush_scheduled_(false),
+      length_buffer_(new IOBufferWithSize(kLengthSize)),
+      weak_factory_(this) {
+  DCHECK(socket_pool_);
+}
+
+DnsTCPConnection::~DnsTCPConnection() {}
+
+bool DnsTCPConnection::HasPendingQuery(uint16 id) const {
+  return pending_queries_.count(id) > 0;
+}
+
+void DnsTCPConnection::Send(uint16 id,
+                            IOBufferWithSize* query,
+                            const ResponseCallback& callback) {
+  DCHECK(!HasPendingQuery(id));
+  DCHECK(!callback.is_null());
+
+  UMA_HISTOGRAM_BOOLEAN("AsyncDNS.TCPConnectionReused",
+                        state_ != STATE_DISCONNECTED);
+
+  scoped_refptr<IOBufferWithSize> framed_query(
+      new IOBufferWithSize(kLengthSize + query->size()));
+  WriteBigEndian<uint16>(framed_query->data(), query->size());
+  memcpy(framed_query->data() + kLengthSize, query->data(), query->size());
+
+  pending_queries_[id] = PendingQuery(framed_query.get(), callback);
+  write_queue_.push_back(framed_query);
+  idle_timer_.Stop();
+  ScheduleFlush();
+}
+
+void DnsTCPConnection::Cancel(uint16 id) {
+  // If the query has already been written, its response is dropped when it
+  // arrives.
+  pending_queries_.erase(id);
+  StartIdleTimerIfIdle();
+}
+
+void DnsTCPConnection::ScheduleFlush() {
+  if (flush_scheduled_)
+    return;
+  flush_scheduled_ = true;
+  // Flushing from a task batches the queries sent in the current task (such
+  // as the A and AAAA queries for a host) into a single write, and keeps
+  // callbacks from running within Send().
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE,
+      base::Bind(&DnsTCPConnection::Flush, weak_factory_.GetWeakPtr()));
+}
+
+void DnsTCPConnection::Flush() {
+  DCHECK(flush_scheduled_);
+  flush_scheduled_ = false;
+  switch (state_) {
+    case STATE_DISCONNECTED:
+      if (pending_queries_.empty()) {
+        // All queries were cancelled.
+        write_queue_.clear();
+      } else {
+        Connect();
+      }
+      break;
+    case STATE_CONNECTING:
+      // |write_queue_| is written once connected.
+      break;
+    case STATE_CONNECTED:
+      DoWrite();
+      break;
+  }
+}
+
+void DnsTCPConnection::Connect() {
+  DCHECK_EQ(STATE_DISCONNECTED, state_);
+  state_ = STATE_CONNECTING;
+  received_response_ = false;
+  socket_ = socket_pool_->CreateTCPSocket(server_index_, net_log_.source());
+  int rv = socket_->Connect(base::Bind(&DnsTCPConnection::OnConnectComplete,
+                                       base::Unretained(this)));
+  if (rv != ERR_IO_PENDING)
+    OnConnectComplete(rv);
+}
+
+void DnsTCPConnection::OnConnectComplete(int rv) {
+  DCHECK_EQ(STATE_CONNECTING, state_);
+  DCHECK_NE(ERR_IO_PENDING, rv);
+  if (rv < 0) {
+    OnConnectionError(rv);
+    return;
+  }
+  state_ = STATE_CONNECTED;
+  read_buffer_ =
+      new DrainableIOBuffer(length_buffer_.get(), length_buffer_->size());
+  if (!DoWrite())
+    return;
+  DoRead();
+}
+
+bool DnsTCPConnection::DoWrite() {
+  DCHECK_EQ(STATE_CONNECTED, state_);
+  while (!write_pending_) {
+    if (!write_buffer_.get()) {
+      if (write_queue_.empty())
+        return true;
+      // Coalesce all queued queries into a single write.
+      int size = 0;
+      for (size_t i = 0; i < write_queue_.size(); ++i)
+        size += write_queue_[i]->size();
+      scoped_refptr<IOBufferWithSize> buffer(new IOBufferWithSize(size));
+      int offset = 0;
+      for (size_t i = 0; i < write_queue_.size(); ++i) {
+        memcpy(buffer->data() + offset, write_queue_[i]->data(),
+               write_queue_[i]->size());
+        offset += write_queue_[i]->size();
+      }
+      write_queue_.clear();
+      write_buffer_ = new DrainableIOBuffer(buffer.get(), size);
+    }
+    int rv = socket_->Write(
+        write_buffer_.get(),
+        write_buffer_->BytesRemaining(),
+        base::Bind(&DnsTCPConnection::OnWriteComplete,
+                   base::Unretained(this)));
+    if (rv == ERR_IO_PENDING) {
+      write_pending_ = true;
+      return true;
+    }
+    if (!HandleWriteResult(rv))
+      return false;
+  }
+  return true;
+}
+
+bool DnsTCPConnection::HandleWriteResult(int rv) {
+  DCHECK_NE(ERR_IO_PENDING, rv);
+  if (rv < 0) {
+    OnConnectionError(rv);
+    return false;
+  }
+  write_buffer_->DidConsume(rv);
+  if (write_buffer_->BytesRemaining() == 0)
+    write_buffer_ = NULL;
+  return true;
+}
+
+void DnsTCPConnection::OnWriteComplete(int rv) {
+  DCHECK(write_pending_);
+  write_pending_ = false;
+  if (HandleWriteResult(rv))
+    DoWrite();
+}
+
+void DnsTCPConnection::DoRead() {
+  DCHECK_EQ(STATE_CONNECTED, state_);
+  // Keep a read outstanding even when idle, to notice when the server closes
+  // the connection.
+  int rv;
+  do {
+    rv = socket_->Read(
+        read_buffer_.get(),
+        read_buffer_->BytesRemaining(),
+        base::Bind(&DnsTCPConnection::OnReadComplete,
+                   base::Unretained(this)));
+  } while (rv != ERR_IO_PENDING && HandleReadResult(rv));
+}
+
+bool DnsTCPConnection::HandleReadResult(int rv) {
+  DCHECK_NE(ERR_IO_PENDING, rv);
+  if (rv == 0)
+    rv = ERR_CONNECTION_CLOSED;
+  if (rv < 0) {
+    OnConnectionError(rv);
+    return false;
+  }
+
+  read_buffer_->DidConsume(rv);
+  if (read_buffer_->BytesRemaining() > 0)
+    return true;
+
+  if (!response_buffer_.get()) {
+    // Read the length, now read the message.
+    uint16 response_length;
+    ReadBigEndian<uint16>(length_buffer_->data(), &response_length);
+    if (response_length < sizeof(dns_protocol::Header)) {
+      // Cannot tell which query this was for, or trust the rest of the stream.
+      OnConnectionError(ERR_DNS_MALFORMED_RESPONSE);
+      return false;
+    }
+    response_buffer_ = new IOBufferWithSize(response_length);
+    read_buffer_ = new DrainableIOBuffer(response_buffer_.get(),
+                                         response_length);
+    return true;
+  }
+
+  scoped_refptr<IOBufferWithSize> response;
+  response.swap(response_buffer_);
+  read_buffer_ =
+      new DrainableIOBuffer(length_buffer_.get(), length_buffer_->size());
+  received_response_ = true;
+
+  uint16 id;
+  ReadBigEndian<uint16>(response->data(), &id);
+  PendingQueryMap::iterator it = pending_queries_.find(id);
+  if (it == pending_queries_.end()) {
+    // The query was cancelled, most likely after timing out.
+    return true;
+  }
+  ResponseCallback callback = it->second.callback;
+  pending_queries_.erase(it);
+  StartIdleTimerIfIdle();
+
+  base::WeakPtr<DnsTCPConnection> weak_this = weak_factory_.GetWeakPtr();
+  callback.Run(OK, response.get());
+  return weak_this.get() != NULL;
+}
+
+void DnsTCPConnection::OnReadComplete(int rv) {
+  if (HandleReadResult(rv))
+    DoRead();
+}
+
+void DnsTCPConnection::OnConnectionError(int rv) {
+  DCHECK_LT(rv, 0);
+  // A connection which has worked before was most likely closed by the
+  // server for being idle, so its queries are resent once on a new one.
+  bool resend = received_response_;
+  Disconnect();
+
+  std::vector<uint16> failed_ids;
+  for (PendingQueryMap::iterator it = pending_queries_.begin();
+       it != pending_queries_.end(); ++it) {
+    if (resend && !it->second.retried) {
+      it->second.retried = true;
+      write_queue_.push_back(it->second.framed_query);
+    } else {
+      failed_ids.push_back(it->first);
+    }
+  }
+  if (!write_queue_.empty())
+    ScheduleFlush();
+
+  // Callbacks may cancel other queries, or delete |this|.
+  base::WeakPtr<DnsTCPConnection> weak_this = weak_factory_.GetWeakPtr();
+  for (size_t i = 0; i < failed_ids.size(); ++i) {
+    PendingQueryMap::iterator it = pending_queries_.find(failed_ids[i]);
+    if (it == pending_queries_.end())
+      continue;
+    ResponseCallback callback = it->second.callback;
+    pending_queries_.erase(it);
+    callback.Run(rv, NULL);
+    if (!weak_this.get())
+      return;
+  }
+}
+
+void DnsTCPConnection::Disconnect() {
+  idle_timer_.Stop();
+  socket_.reset();
+  state_ = STATE_DISCONNECTED;
+  write_queue_.clear();
+  write_buffer_ = NULL;
+  write_pending_ = false;
+  response_buffer_ = NULL;
+  read_buffer_ = NULL;
+}
+
+void DnsTCPConnection::StartIdleTimerIfIdle() {
+  if (state_ != STATE_CONNECTED || !pending_queries_.empty())
+    return;
+  idle_timer_.Start(FROM_HERE,
+                    base::TimeDelta::FromSeconds(kIdleTimeoutSeconds),
+                    this,
+                    &DnsTCPConnection::OnIdleTimeout);
+}
+
+void DnsTCPConnection::OnIdleTimeout() {
+  DCHECK(pending_queries_.empty());
+  Disconnect();
+}
+
+}  // namespace net
@@ -0,0 +1,141 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_DNS_DNS_TCP_CONNECTION_H_
+#define NET_DNS_DNS_TCP_CONNECTION_H_
+
+#include <map>
+#include <vector>
+
+#include "base/basictypes.h"
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
+#include "net/base/net_export.h"
+#include "net/base/net_log.h"
+
+namespace net {
+
+class DnsSocketPool;
+class DrainableIOBuffer;
+class IOBufferWithSize;
+class StreamSocket;
+
+// A persistent TCP connection to a single DNS server, shared by all
+// transactions that fall back to TCP. Queries are pipelined: several may be
+// outstanding at once, queries sent in the same task are written together,
+// and responses, which may arrive in any order, are matched to queries by
+// their ID. The connection is established on first use and closed after it
+// has been idle for a while, or when the server closes it.
+class NET_EXPORT_PRIVATE DnsTCPConnection {
+ public:
+  // Called with OK and the response message (without the length prefix), or
+  // with a network error if the connection failed. The response is only
+  // valid for the duration of the call.
+  typedef base::Callback<void(int, IOBufferWithSize*)> ResponseCallback;
+
+  // |socket_pool| must outlive the connection.
+  DnsTCPConnection(DnsSocketPool* socket_pool,
+                   unsigned server_index,
+                   NetLog* net_log);
+  ~DnsTCPConnection();
+
+  // Returns true if a query with |id| is outstanding, in which case another
+  // query with the same ID must not be sent.
+  bool HasPendingQuery(uint16 id) const;
+
+  // Queues |query| (a complete DNS message with ID |id|) to be sent. The
+  // query is written, and |callback| invoked, asynchronously.
+  void Send(uint16 id,
+            IOBufferWithSize* query,
+            const ResponseCallback& callback);
+
+  // Cancels the query with |id|. Its callback will not be invoked.
+  void Cancel(uint16 id);
+
+  const BoundNetLog& net_log() const { return net_log_; }
+
+ private:
+  enum State {
+    STATE_DISCONNECTED,
+    STATE_CONNECTING,
+    STATE_CONNECTED,
+  };
+
+  struct PendingQuery {
+    PendingQuery();
+    PendingQuery(IOBufferWithSize* framed_query,
+                 const ResponseCallback& callback);
+    ~PendingQuery();
+
+    // The query prefixed with its length, as written to the socket.
+    scoped_refptr<IOBufferWithSize> framed_query;
+    ResponseCallback callback;
+    // True if the query has already been resent after the connection failed.
+    bool retried;
+  };
+
+  typedef std::map<uint16, PendingQuery> PendingQueryMap;
+
+  // Schedules a task to connect or to write out |write_queue_|.
+  void ScheduleFlush();
+  void Flush();
+
+  void Connect();
+  void OnConnectComplete(int rv);
+
+  // Return false if the connection failed, in which case |this| may have been
+  // deleted.
+  bool DoWrite();
+  bool HandleWriteResult(int rv);
+  void OnWriteComplete(int rv);
+
+  void DoRead();
+  bool HandleReadResult(int rv);
+  void OnReadComplete(int rv);
+
+  // Closes the socket and fails the pending queries with |rv|, except for
+  // those which are resent on a new connection. May delete |this|.
+  void OnConnectionError(int rv);
+
+  void Disconnect();
+  void StartIdleTimerIfIdle();
+  void OnIdleTimeout();
+
+  DnsSocketPool* socket_pool_;
+  const unsigned server_index_;
+  BoundNetLog net_log_;
+
+  State state_;
+  scoped_ptr<StreamSocket> socket_;
+  // True once a response has been received on |socket_|, so that queries
+  // lost when the server closes the connection are worth resending.
+  bool received_response_;
+
+  PendingQueryMap pending_queries_;
+
+  // Framed queries waiting to be written.
+  std::vector<scoped_refptr<IOBufferWithSize> > write_queue_;
+  scoped_refptr<DrainableIOBuffer> write_buffer_;
+  bool write_pending_;
+  bool flush_scheduled_;
+
+  // Holds the length prefix of the next response.
+  scoped_refptr<IOBufferWithSize> length_buffer_;
+  // Holds the body of the response being read, if the length has been read.
+  scoped_refptr<IOBufferWithSize> response_buffer_;
+  scoped_refptr<DrainableIOBuffer> read_buffer_;
+
+  base::OneShotTimer<DnsTCPConnection> idle_timer_;
+
+  base::WeakPtrFactory<DnsTCPConnection> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(DnsTCPConnection);
+};
+
+}  // namespace net
+
+#endif  // NET_DNS_DNS_TCP_CONNECTION_H_
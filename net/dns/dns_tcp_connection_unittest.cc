@@ -0,0 +1,247 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/dns/dns_tcp_connection.h"
+
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "net/base/big_endian.h"
+#include "net/base/io_buffer.h"
+#include "net/base/ip_endpoint.h"
+#include "net/base/net_errors.h"
+#include "net/base/net_util.h"
+#include "net/dns/dns_protocol.h"
+#include "net/dns/dns_query.h"
+#include "net/dns/dns_socket_pool.h"
+#include "net/socket/socket_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+const char kQname1[] = "\x03www\x07" "example\x03" "com";
+const char kQname2[] = "\x04mail\x07" "example\x03" "com";
+
+// Records the result of a single query.
+class ResponseCollector {
+ public:
+  ResponseCollector() : result_(ERR_IO_PENDING), num_calls_(0) {}
+
+  DnsTCPConnection::ResponseCallback callback() {
+    return base::Bind(&ResponseCollector::OnResponse, base::Unretained(this));
+  }
+
+  int result() const { return result_; }
+  int num_calls() const { return num_calls_; }
+  const std::string& response() const { return response_; }
+
+ private:
+  void OnResponse(int rv, IOBufferWithSize* response) {
+    ++num_calls_;
+    result_ = rv;
+    if (response)
+      response_.assign(response->data(), response->size());
+  }
+
+  int result_;
+  int num_calls_;
+  std::string response_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResponseCollector);
+};
+
+class DnsTCPConnectionTest : public testing::Test {
+ protected:
+  DnsTCPConnectionTest()
+      : query1_(1, base::StringPiece(kQname1, sizeof(kQname1)),
+                dns_protocol::kTypeA),
+        query2_(2, base::StringPiece(kQname2, sizeof(kQname2)),
+                dns_protocol::kTypeAAAA) {
+    IPAddressNumber dns_ip;
+    EXPECT_TRUE(ParseIPLiteralToNumber("192.168.1.0", &dns_ip));
+    nameservers_.push_back(IPEndPoint(dns_ip, dns_protocol::kDefaultPort));
+    socket_pool_ = DnsSocketPool::CreateNull(&socket_factory_);
+    socket_pool_->Initialize(&nameservers_, NULL);
+    connection_.reset(new DnsTCPConnection(socket_pool_.get(), 0, NULL));
+
+    // The connection only looks at the ID of a response, so the queries
+    // double as their own responses.
+    framed_query1_ = Framed(query1_);
+    framed_query2_ = Framed(query2_);
+    framed_queries_ = framed_query1_ + framed_query2_;
+  }
+
+  // Returns the message in |query| prefixed with its length.
+  static std::string Framed(const DnsQuery& query) {
+    char length[sizeof(uint16)];
+    WriteBigEndian<uint16>(length, query.io_buffer()->size());
+    return std::string(length, sizeof(length)) +
+        std::string(query.io_buffer()->data(), query.io_buffer()->size());
+  }
+
+  static std::string Unframed(const DnsQuery& query) {
+    return std::string(query.io_buffer()->data(), query.io_buffer()->size());
+  }
+
+  void Send(const DnsQuery& query, ResponseCollector* collector) {
+    connection_->Send(query.id(), query.io_buffer(), collector->callback());
+  }
+
+  DnsQuery query1_;
+  DnsQuery query2_;
+  std::string framed_query1_;
+  std::string framed_query2_;
+  std::string framed_queries_;
+
+  MockClientSocketFactory socket_factory_;
+  std::vector<IPEndPoint> nameservers_;
+  scoped_ptr<DnsSocketPool> socket_pool_;
+  scoped_ptr<DnsTCPConnection> connection_;
+};
+
+// Queries sent together are written together, and their responses are matched
+// by ID regardless of order.
+TEST_F(DnsTCPConnectionTest, PipelinesQueries) {
+  MockWrite writes[] = {
+    MockWrite(SYNCHRONOUS, framed_queries_.data(), framed_queries_.size()),
+  };
+  MockRead reads[] = {
+    MockRead(ASYNC, framed_query2_.data(), framed_query2_.size()),
+    MockRead(ASYNC, framed_query1_.data(), framed_query1_.size()),
+    MockRead(ASYNC, ERR_IO_PENDING),
+  };
+  StaticSocketDataProvider data(reads, arraysize(reads),
+                                writes, arraysize(writes));
+  socket_factory_.AddSocketDataProvider(&data);
+
+  ResponseCollector collector1;
+  ResponseCollector collector2;
+  Send(query1_, &collector1);
+  Send(query2_, &collector2);
+  EXPECT_TRUE(connection_->HasPendingQuery(query1_.id()));
+  EXPECT_TRUE(connection_->HasPendingQuery(query2_.id()));
+  // Nothing happens until the posted flush runs.
+  EXPECT_EQ(0, collector1.num_calls());
+  EXPECT_EQ(0, collector2.num_calls());
+
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_TRUE(data.at_write_eof());
+  EXPECT_EQ(1, collector1.num_calls());
+  EXPECT_EQ(OK, collector1.result());
+  EXPECT_EQ(Unframed(query1_), collector1.response());
+  EXPECT_EQ(1, collector2.num_calls());
+  EXPECT_EQ(OK, collector2.result());
+  EXPECT_EQ(Unframed(query2_), collector2.response());
+  EXPECT_FALSE(connection_->HasPendingQuery(query1_.id()));
+  EXPECT_FALSE(connection_->HasPendingQuery(query2_.id()));
+}
+
+TEST_F(DnsTCPConnectionTest, CancelledQueryResponseIsDropped) {
+  MockWrite writes[] = {
+    MockWrite(SYNCHRONOUS, framed_queries_.data(), framed_queries_.size()),
+  };
+  MockRead reads[] = {
+    MockRead(ASYNC, framed_query1_.data(), framed_query1_.size()),
+    MockRead(ASYNC, framed_query2_.data(), framed_query2_.size()),
+    MockRead(ASYNC, ERR_IO_PENDING),
+  };
+  StaticSocketDataProvider data(reads, arraysize(reads),
+                                writes, arraysize(writes));
+  socket_factory_.AddSocketDataProvider(&data);
+
+  ResponseCollector collector1;
+  ResponseCollector collector2;
+  Send(query1_, &collector1);
+  Send(query2_, &collector2);
+  connection_->Cancel(query1_.id());
+  EXPECT_FALSE(connection_->HasPendingQuery(query1_.id()));
+
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_EQ(0, collector1.num_calls());
+  EXPECT_EQ(1, collector2.num_calls());
+  EXPECT_EQ(OK, collector2.result());
+}
+
+TEST_F(DnsTCPConnectionTest, ConnectFailureFailsQueries) {
+  StaticSocketDataProvider data;
+  data.set_connect_data(MockConnect(ASYNC, ERR_CONNECTION_REFUSED));
+  socket_factory_.AddSocketDataProvider(&data);
+
+  ResponseCollector collector1;
+  ResponseCollector collector2;
+  Send(query1_, &collector1);
+  Send(query2_, &collector2);
+
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_EQ(1, collector1.num_calls());
+  EXPECT_EQ(ERR_CONNECTION_REFUSED, collector1.result());
+  EXPECT_EQ(1, collector2.num_calls());
+  EXPECT_EQ(ERR_CONNECTION_REFUSED, collector2.result());
+}
+
+// A query lost because the server closed a connection which had been working
+// is resent on a new connection.
+TEST_F(DnsTCPConnectionTest, ResendsAfterServerClose) {
+  MockWrite writes1[] = {
+    MockWrite(SYNCHRONOUS, framed_queries_.data(), framed_queries_.size()),
+  };
+  MockRead reads1[] = {
+    MockRead(ASYNC, framed_query1_.data(), framed_query1_.size()),
+    MockRead(ASYNC, 0),  // EOF
+  };
+  StaticSocketDataProvider data1(reads1, arraysize(reads1),
+                                 writes1, arraysize(writes1));
+  socket_factory_.AddSocketDataProvider(&data1);
+
+  MockWrite writes2[] = {
+    MockWrite(SYNCHRONOUS, framed_query2_.data(), framed_query2_.size()),
+  };
+  MockRead reads2[] = {
+    MockRead(ASYNC, framed_query2_.data(), framed_query2_.size()),
+    MockRead(ASYNC, ERR_IO_PENDING),
+  };
+  StaticSocketDataProvider data2(reads2, arraysize(reads2),
+                                 writes2, arraysize(writes2));
+  socket_factory_.AddSocketDataProvider(&data2);
+
+  ResponseCollector collector1;
+  ResponseCollector collector2;
+  Send(query1_, &collector1);
+  Send(query2_, &collector2);
+
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_EQ(OK, collector1.result());
+  EXPECT_EQ(1, collector2.num_calls());
+  EXPECT_EQ(OK, collector2.result());
+  EXPECT_EQ(Unframed(query2_), collector2.response());
+  EXPECT_TRUE(data2.at_write_eof());
+}
+
+// A connection which fails before any response is received does not resend.
+TEST_F(DnsTCPConnectionTest, NoResendOnNewConnection) {
+  MockWrite writes[] = {
+    MockWrite(SYNCHRONOUS, framed_query1_.data(), framed_query1_.size()),
+  };
+  MockRead reads[] = {
+    MockRead(ASYNC, 0),  // EOF
+  };
+  StaticSocketDataProvider data(reads, arraysize(reads),
+                                writes, arraysize(writes));
+  socket_factory_.AddSocketDataProvider(&data);
+
+  ResponseCollector collector;
+  Send(query1_, &collector);
+
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_EQ(1, collector.num_calls());
+  EXPECT_EQ(ERR_CONNECTION_CLOSED, collector.result());
+}
+
+}  // namespace
+
+}  // namespace net
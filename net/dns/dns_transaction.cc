@@ -4,6 +4,8 @@
 
 #include "net/dns/dns_transaction.h"
 
+#include <string.h>
+
 #include <deque>
 #include <string>
 #include <vector>
@@ -32,7 +34,7 @@
 #include "net/dns/dns_query.h"
 #include "net/dns/dns_response.h"
 #include "net/dns/dns_session.h"
-#include "net/socket/stream_socket.h"
+#include "net/dns/dns_tcp_connection.h"
 #include "net/udp/datagram_client_socket.h"
 
 namespace net {
@@ -296,28 +298,28 @@ class DnsUDPAttempt : public DnsAttempt {
 class DnsTCPAttempt : public DnsAttempt {
  public:
   DnsTCPAttempt(unsigned server_index,
-                scoped_ptr<StreamSocket> socket,
+                DnsTCPConnection* connection,
                 scoped_ptr<DnsQuery> query)
       : DnsAttempt(server_index),
-        next_state_(STATE_NONE),
-        socket_(socket.Pass()),
-        query_(query.Pass()),
-        length_buffer_(new IOBufferWithSize(sizeof(uint16))),
-        response_length_(0) {}
+        connection_(connection),
+        query_(query.Pass()) {}
+
+  virtual ~DnsTCPAttempt() {
+    if (is_pending())
+      connection_->Cancel(query_->id());
+  }
 
   // DnsAttempt:
   virtual int Start(const CompletionCallback& callback) OVERRIDE {
-    DCHECK_EQ(STATE_NONE, next_state_);
+    DCHECK(callback_.is_null());
     callback_ = callback;
     start_time_ = base::TimeTicks::Now();
-    next_state_ = STATE_CONNECT_COMPLETE;
-    int rv = socket_->Connect(base::Bind(&DnsTCPAttempt::OnIOComplete,
-                                         base::Unretained(this)));
-    if (rv == ERR_IO_PENDING) {
-      set_result(rv);
-      return rv;
-    }
-    return DoLoop(rv);
+    connection_->Send(query_->id(),
+                      query_->io_buffer(),
+                      base::Bind(&DnsTCPAttempt::OnResponse,
+                                 base::Unretained(this)));
+    set_result(ERR_IO_PENDING);
+    return ERR_IO_PENDING;
   }
 
   virtual const DnsQuery* GetQuery() const OVERRIDE {
@@ -330,147 +332,21 @@ class DnsTCPAttempt : public DnsAttempt {
   }
 
   virtual const BoundNetLog& GetSocketNetLog() const OVERRIDE {
-    return socket_->NetLog();
+    return connection_->net_log();
   }
 
  private:
-  enum State {
-    STATE_CONNECT_COMPLETE,
-    STATE_SEND_LENGTH,
-    STATE_SEND_QUERY,
-    STATE_READ_LENGTH,
-    STATE_READ_RESPONSE,
-    STATE_NONE,
-  };
-
-  int DoLoop(int result) {
-    CHECK_NE(STATE_NONE, next_state_);
-    int rv = result;
-    do {
-      State state = next_state_;
-      next_state_ = STATE_NONE;
-      switch (state) {
-        case STATE_CONNECT_COMPLETE:
-          rv = DoConnectComplete(rv);
-          break;
-        case STATE_SEND_LENGTH:
-          rv = DoSendLength(rv);
-          break;
-        case STATE_SEND_QUERY:
-          rv = DoSendQuery(rv);
-          break;
-        case STATE_READ_LENGTH:
-          rv = DoReadLength(rv);
-          break;
-        case STATE_READ_RESPONSE:
-          rv = DoReadResponse(rv);
-          break;
-        default:
-          NOTREACHED();
-          break;
-      }
-    } while (rv != ERR_IO_PENDING && next_state_ != STATE_NONE);
-
-    set_result(rv);
-    if (rv == OK) {
-      DCHECK_EQ(STATE_NONE, next_state_);
-      DNS_HISTOGRAM("AsyncDNS.TCPAttemptSuccess",
-                    base::TimeTicks::Now() - start_time_);
-    } else if (rv != ERR_IO_PENDING) {
-      DNS_HISTOGRAM("AsyncDNS.TCPAttemptFail",
-                    base::TimeTicks::Now() - start_time_);
-    }
-    return rv;
-  }
-
-  int DoConnectComplete(int rv) {
-    DCHECK_NE(ERR_IO_PENDING, rv);
+  int ProcessResponse(int rv, IOBufferWithSize* data) {
     if (rv < 0)
       return rv;
 
-    WriteBigEndian<uint16>(length_buffer_->data(), query_->io_buffer()->size());
-    buffer_ =
-        new DrainableIOBuffer(length_buffer_.get(), length_buffer_->size());
-    next_state_ = STATE_SEND_LENGTH;
-    return OK;
-  }
-
-  int DoSendLength(int rv) {
-    DCHECK_NE(ERR_IO_PENDING, rv);
-    if (rv < 0)
-      return rv;
-
-    buffer_->DidConsume(rv);
-    if (buffer_->BytesRemaining() > 0) {
-      next_state_ = STATE_SEND_LENGTH;
-      return socket_->Write(
-          buffer_.get(),
-          buffer_->BytesRemaining(),
-          base::Bind(&DnsTCPAttempt::OnIOComplete, base::Unretained(this)));
-    }
-    buffer_ = new DrainableIOBuffer(query_->io_buffer(),
-                                    query_->io_buffer()->size());
-    next_state_ = STATE_SEND_QUERY;
-    return OK;
-  }
-
-  int DoSendQuery(int rv) {
-    DCHECK_NE(ERR_IO_PENDING, rv);
-    if (rv < 0)
-      return rv;
-
-    buffer_->DidConsume(rv);
-    if (buffer_->BytesRemaining() > 0) {
-      next_state_ = STATE_SEND_QUERY;
-      return socket_->Write(
-          buffer_.get(),
-          buffer_->BytesRemaining(),
-          base::Bind(&DnsTCPAttempt::OnIOComplete, base::Unretained(this)));
-    }
-    buffer_ =
-        new DrainableIOBuffer(length_buffer_.get(), length_buffer_->size());
-    next_state_ = STATE_READ_LENGTH;
-    return OK;
-  }
-
-  int DoReadLength(int rv) {
-    DCHECK_NE(ERR_IO_PENDING, rv);
-    if (rv < 0)
-      return rv;
-
-    buffer_->DidConsume(rv);
-    if (buffer_->BytesRemaining() > 0) {
-      next_state_ = STATE_READ_LENGTH;
-      return socket_->Read(
-          buffer_.get(),
-          buffer_->BytesRemaining(),
-          base::Bind(&DnsTCPAttempt::OnIOComplete, base::Unretained(this)));
-    }
-    ReadBigEndian<uint16>(length_buffer_->data(), &response_length_);
     // Check if advertised response is too short. (Optimization only.)
-    if (response_length_ < query_->io_buffer()->size())
+    if (data->size() < query_->io_buffer()->size())
       return ERR_DNS_MALFORMED_RESPONSE;
     // Allocate more space so that DnsResponse::InitParse sanity check passes.
-    response_.reset(new DnsResponse(response_length_ + 1));
-    buffer_ = new DrainableIOBuffer(response_->io_buffer(), response_length_);
-    next_state_ = STATE_READ_RESPONSE;
-    return OK;
-  }
-
-  int DoReadResponse(int rv) {
-    DCHECK_NE(ERR_IO_PENDING, rv);
-    if (rv < 0)
-      return rv;
-
-    buffer_->DidConsume(rv);
-    if (buffer_->BytesRemaining() > 0) {
-      next_state_ = STATE_READ_RESPONSE;
-      return socket_->Read(
-          buffer_.get(),
-          buffer_->BytesRemaining(),
-          base::Bind(&DnsTCPAttempt::OnIOComplete, base::Unretained(this)));
-    }
-    if (!response_->InitParse(buffer_->BytesConsumed(), *query_))
+    response_.reset(new DnsResponse(data->size() + 1));
+    memcpy(response_->io_buffer()->data(), data->data(), data->size());
+    if (!response_->InitParse(data->size(), *query_))
       return ERR_DNS_MALFORMED_RESPONSE;
     if (response_->flags() & dns_protocol::kFlagTC)
       return ERR_UNEXPECTED;
@@ -483,21 +359,25 @@ class DnsTCPAttempt : public DnsAttempt {
     return OK;
   }
 
-  void OnIOComplete(int rv) {
-    rv = DoLoop(rv);
-    if (rv != ERR_IO_PENDING)
-      callback_.Run(rv);
+  void OnResponse(int rv, IOBufferWithSize* data) {
+    rv = ProcessResponse(rv, data);
+    set_result(rv);
+    if (rv == OK) {
+      DNS_HISTOGRAM("AsyncDNS.TCPAttemptSuccess",
+                    base::TimeTicks::Now() - start_time_);
+    } else {
+      DNS_HISTOGRAM("AsyncDNS.TCPAttemptFail",
+                    base::TimeTicks::Now() - start_time_);
+    }
+    callback_.Run(rv);
   }
 
-  State next_state_;
   base::TimeTicks start_time_;
 
-  scoped_ptr<StreamSocket> socket_;
+  // Owned by the DnsSession, which outlives the transaction.
+  DnsTCPConnection* connection_;
   scoped_ptr<DnsQuery> query_;
-  scoped_refptr<IOBufferWithSize> length_buffer_;
-  scoped_refptr<DrainableIOBuffer> buffer_;
 
-  uint16 response_length_;
   scoped_ptr<DnsResponse> response_;
 
   CompletionCallback callback_;
@@ -512,7 +392,9 @@ class DnsTCPAttempt : public DnsAttempt {
 // The timeout for each DnsUDPAttempt is given by DnsSession::NextTimeout.
 // The first server to attempt on each query is given by
 // DnsSession::NextFirstServerIndex, and the order is round-robin afterwards.
-// Each server is attempted DnsConfig::attempts times.
+// Each server is attempted DnsConfig::attempts times. If a response is
+// truncated, the query is retried over the session's persistent TCP connection
+// to the same server.
 class DnsTransactionImpl : public DnsTransaction,
                            public base::NonThreadSafe,
                            public base::SupportsWeakPtr<DnsTransactionImpl> {
@@ -716,11 +598,13 @@ class DnsTransactionImpl : public DnsTransaction,
 
     unsigned server_index = previous_attempt->server_index();
 
-    scoped_ptr<StreamSocket> socket(
-        session_->CreateTCPSocket(server_index, net_log_.source()));
+    DnsTCPConnection* connection = session_->GetTCPConnection(server_index);
 
     // TODO(szym): Reuse the same id to help the server?
     uint16 id = session_->NextQueryId();
+    // Responses on the shared connection are matched to queries by ID.
+    while (connection->HasPendingQuery(id))
+      id = session_->NextQueryId();
     scoped_ptr<DnsQuery> query(
         previous_attempt->GetQuery()->CloneWithNewId(id));
 
@@ -730,7 +614,7 @@ class DnsTransactionImpl : public DnsTransaction,
 
     unsigned attempt_number = attempts_.size();
 
-    DnsTCPAttempt* attempt = new DnsTCPAttempt(server_index, socket.Pass(),
+    DnsTCPAttempt* attempt = new DnsTCPAttempt(server_index, connection,
                                                query.Pass());
 
     attempts_.push_back(attempt);
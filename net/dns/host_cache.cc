@@ -8,10 +8,23 @@
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/values.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
 
 namespace net {
 
+namespace {
+
+// Keys of the values describing an entry in GetAsListValue().
+const char kHostnameKey[] = "hostname";
+const char kAddressFamilyKey[] = "address_family";
+const char kFlagsKey[] = "flags";
+const char kExpirationKey[] = "expiration";
+const char kAddressesKey[] = "addresses";
+
+}  // namespace
+
 //-----------------------------------------------------------------------------
 
 HostCache::Entry::Entry(int error, const AddressList& addrlist,
@@ -34,7 +47,8 @@ HostCache::Entry::~Entry() {
 //-----------------------------------------------------------------------------
 
 HostCache::HostCache(size_t max_entries)
-    : entries_(max_entries) {
+    : entries_(max_entries),
+      delegate_(NULL) {
 }
 
 HostCache::~HostCache() {
@@ -49,6 +63,15 @@ const HostCache::Entry* HostCache::Lookup(const Key& key,
   return entries_.Get(key, now);
 }
 
+const HostCache::Entry* HostCache::LookupStale(const Key& key,
+                                               base::TimeTicks* expiration) {
+  DCHECK(CalledOnValidThread());
+  if (caching_is_disabled())
+    return NULL;
+
+  return entries_.GetIncludingExpired(key, expiration);
+}
+
 void HostCache::Set(const Key& key,
                     const Entry& entry,
                     base::TimeTicks now,
@@ -58,11 +81,102 @@ void HostCache::Set(const Key& key,
     return;
 
   entries_.Put(key, entry, now, now + ttl);
+  if (delegate_)
+    delegate_->ScheduleWrite();
 }
 
 void HostCache::clear() {
   DCHECK(CalledOnValidThread());
   entries_.Clear();
+  if (delegate_)
+    delegate_->ScheduleWrite();
+}
+
+void HostCache::set_persistence_delegate(PersistenceDelegate* delegate) {
+  DCHECK(CalledOnValidThread());
+  delegate_ = delegate;
+}
+
+void HostCache::GetAsListValue(base::ListValue* entry_list) const {
+  DCHECK(CalledOnValidThread());
+  DCHECK(entry_list);
+  entry_list->Clear();
+
+  // Expirations are stored as wall clock times, since TimeTicks do not carry
+  // over across restarts.
+  const base::TimeTicks now_ticks = base::TimeTicks::Now();
+  const base::Time now = base::Time::Now();
+  for (EntryMap::Iterator it(entries_); it.HasNext(); it.Advance()) {
+    const Key& key = it.key();
+    const Entry& entry = it.value();
+    // Failures are cheap to look up again, and are often transient.
+    if (entry.error != OK)
+      continue;
+
+    base::ListValue* addresses = new base::ListValue();
+    for (size_t i = 0; i < entry.addrlist.size(); ++i)
+      addresses->AppendString(entry.addrlist[i].ToStringWithoutPort());
+
+    base::DictionaryValue* entry_dict = new base::DictionaryValue();
+    entry_dict->SetString(kHostnameKey, key.hostname);
+    entry_dict->SetInteger(kAddressFamilyKey, key.address_family);
+    entry_dict->SetInteger(kFlagsKey, key.host_resolver_flags);
+    // base::Value has no 64-bit integer type.
+    const base::Time expiration = now + (it.expiration() - now_ticks);
+    entry_dict->SetString(kExpirationKey,
+                          base::Int64ToString(expiration.ToInternalValue()));
+    entry_dict->Set(kAddressesKey, addresses);
+    entry_list->Append(entry_dict);
+  }
+}
+
+bool HostCache::RestoreFromListValue(const base::ListValue& entry_list) {
+  DCHECK(CalledOnValidThread());
+  if (caching_is_disabled())
+    return true;
+
+  const base::TimeTicks now_ticks = base::TimeTicks::Now();
+  const base::Time now = base::Time::Now();
+  for (size_t i = 0; i < entry_list.GetSize(); ++i) {
+    const base::DictionaryValue* entry_dict = NULL;
+    std::string hostname;
+    int address_family;
+    int flags;
+    std::string expiration_string;
+    int64 expiration_value;
+    const base::ListValue* addresses = NULL;
+    if (!entry_list.GetDictionary(i, &entry_dict) ||
+        !entry_dict->GetString(kHostnameKey, &hostname) ||
+        !entry_dict->GetInteger(kAddressFamilyKey, &address_family) ||
+        address_family < 0 || address_family > ADDRESS_FAMILY_LAST ||
+        !entry_dict->GetInteger(kFlagsKey, &flags) ||
+        !entry_dict->GetString(kExpirationKey, &expiration_string) ||
+        !base::StringToInt64(expiration_string, &expiration_value) ||
+        !entry_dict->GetList(kAddressesKey, &addresses)) {
+      return false;
+    }
+
+    AddressList addrlist;
+    for (size_t j = 0; j < addresses->GetSize(); ++j) {
+      std::string address_string;
+      IPAddressNumber address;
+      if (!addresses->GetString(j, &address_string) ||
+          !ParseIPLiteralToNumber(address_string, &address)) {
+        return false;
+      }
+      addrlist.push_back(IPEndPoint(address, 0));
+    }
+
+    Key key(hostname, static_cast<AddressFamily>(address_family), flags);
+    base::TimeTicks existing_expiration;
+    if (entries_.GetIncludingExpired(key, &existing_expiration))
+      continue;
+
+    const base::TimeTicks expiration = now_ticks +
+        (base::Time::FromInternalValue(expiration_value) - now);
+    entries_.Put(key, Entry(OK, addrlist), now_ticks, expiration);
+  }
+  return true;
 }
 
 size_t HostCache::size() const {
@@ -17,6 +17,10 @@
 #include "net/base/expiring_cache.h"
 #include "net/base/net_export.h"
 
+namespace base {
+class ListValue;
+}
+
 namespace net {
 
 // Cache used by HostResolver to map hostnames to their resolved result.
@@ -73,6 +77,19 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
                         std::less<base::TimeTicks>,
                         EvictionHandler> EntryMap;
 
+  // Persists the cache across restarts. The delegate owns the storage, so
+  // that net/ does not depend on how or where the entries are kept.
+  class NET_EXPORT PersistenceDelegate {
+   public:
+    // Called when the contents of the cache have changed. The delegate should
+    // call GetAsListValue() and write out the result, typically after
+    // batching several changes.
+    virtual void ScheduleWrite() = 0;
+
+   protected:
+    virtual ~PersistenceDelegate() {}
+  };
+
   // Constructs a HostCache that stores up to |max_entries|.
   explicit HostCache(size_t max_entries);
 
@@ -82,6 +99,11 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // |now|. If there is no such entry, returns NULL.
   const Entry* Lookup(const Key& key, base::TimeTicks now);
 
+  // Like Lookup(), but also returns the entry for |key| if it has expired,
+  // without removing it. Sets |expiration| to the time the entry expires or
+  // expired. If there is no entry, returns NULL.
+  const Entry* LookupStale(const Key& key, base::TimeTicks* expiration);
+
   // Overwrites or creates an entry for |key|.
   // |entry| is the value to set, |now| is the current time
   // |ttl| is the "time to live".
@@ -93,6 +115,20 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // Empties the cache
   void clear();
 
+  // Sets the delegate which is told about changes to the cache. |delegate|
+  // must outlive the cache, or be reset to NULL first.
+  void set_persistence_delegate(PersistenceDelegate* delegate);
+
+  // Fills |entry_list| with the successful lookups in the cache, with their
+  // expiration as wall clock time, for the persistence delegate to store.
+  void GetAsListValue(base::ListValue* entry_list) const;
+
+  // Adds the entries in |entry_list|, as returned by GetAsListValue(),
+  // possibly in a previous run. Entries already in the cache are newer, so
+  // they are not overwritten. Returns false if |entry_list| is malformed, in
+  // which case some of the entries may have been added.
+  bool RestoreFromListValue(const base::ListValue& entry_list);
+
   // Returns the number of entries in the cache.
   size_t size() const;
 
@@ -116,6 +152,8 @@ class NET_EXPORT HostCache : NON_EXPORTED_BASE(public base::NonThreadSafe) {
   // a resolved result entry.
   EntryMap entries_;
 
+  PersistenceDelegate* delegate_;
+
   DISALLOW_COPY_AND_ASSIGN(HostCache);
 };
 
@@ -8,7 +8,9 @@
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
 #include "base/strings/stringprintf.h"
+#include "base/values.h"
 #include "net/base/net_errors.h"
+#include "net/base/net_util.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace net {
@@ -22,6 +24,26 @@ HostCache::Key Key(const std::string& hostname) {
   return HostCache::Key(hostname, ADDRESS_FAMILY_UNSPECIFIED, 0);
 }
 
+// Builds an AddressList holding the single IP literal |address|.
+AddressList AddressListFor(const std::string& address) {
+  IPAddressNumber ip;
+  EXPECT_TRUE(ParseIPLiteralToNumber(address, &ip));
+  return AddressList(IPEndPoint(ip, 0));
+}
+
+class CountingPersistenceDelegate : public HostCache::PersistenceDelegate {
+ public:
+  CountingPersistenceDelegate() : num_writes_(0) {}
+  virtual ~CountingPersistenceDelegate() {}
+
+  virtual void ScheduleWrite() OVERRIDE { ++num_writes_; }
+
+  int num_writes() const { return num_writes_; }
+
+ private:
+  int num_writes_;
+};
+
 }  // namespace
 
 TEST(HostCacheTest, Basic) {
@@ -296,6 +318,87 @@ TEST(HostCacheTest, Clear) {
   EXPECT_EQ(0u, cache.size());
 }
 
+TEST(HostCacheTest, LookupStale) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromSeconds(10);
+
+  HostCache cache(kMaxCacheEntries);
+
+  // Start at t=0.
+  base::TimeTicks now;
+
+  HostCache::Key key = Key("foobar.com");
+  HostCache::Entry entry = HostCache::Entry(OK, AddressList());
+  base::TimeTicks expiration;
+
+  EXPECT_FALSE(cache.LookupStale(key, &expiration));
+
+  cache.Set(key, entry, now, kTTL);
+  EXPECT_TRUE(cache.LookupStale(key, &expiration));
+  EXPECT_EQ(now + kTTL, expiration);
+
+  // Advance past the expiration. Lookup() no longer returns the entry, but
+  // LookupStale() does, without evicting it.
+  now += kTTL + base::TimeDelta::FromSeconds(1);
+  EXPECT_FALSE(cache.Lookup(key, now));
+  EXPECT_TRUE(cache.LookupStale(key, &expiration));
+  EXPECT_EQ(now - base::TimeDelta::FromSeconds(1), expiration);
+  EXPECT_EQ(1U, cache.size());
+}
+
+TEST(HostCacheTest, PersistenceRoundTrip) {
+  const base::TimeDelta kTTL = base::TimeDelta::FromHours(1);
+
+  CountingPersistenceDelegate delegate;
+  HostCache cache(kMaxCacheEntries);
+  cache.set_persistence_delegate(&delegate);
+
+  base::TimeTicks now = base::TimeTicks::Now();
+
+  cache.Set(Key("foobar1.com"),
+            HostCache::Entry(OK, AddressListFor("1.2.3.4")), now, kTTL);
+  cache.Set(Key("foobar2.com"),
+            HostCache::Entry(OK, AddressListFor("::1")), now, kTTL);
+  // Failed lookups are not persisted.
+  cache.Set(Key("foobar3.com"),
+            HostCache::Entry(ERR_NAME_NOT_RESOLVED, AddressList()), now, kTTL);
+  EXPECT_EQ(3, delegate.num_writes());
+
+  base::ListValue entry_list;
+  cache.GetAsListValue(&entry_list);
+  EXPECT_EQ(2U, entry_list.GetSize());
+
+  cache.clear();
+  EXPECT_EQ(4, delegate.num_writes());
+  cache.set_persistence_delegate(NULL);
+
+  // An entry which is already in the cache is newer than the persisted one,
+  // and is kept.
+  HostCache restored_cache(kMaxCacheEntries);
+  restored_cache.Set(Key("foobar2.com"),
+                     HostCache::Entry(OK, AddressListFor("5.6.7.8")),
+                     now, kTTL);
+  EXPECT_TRUE(restored_cache.RestoreFromListValue(entry_list));
+  EXPECT_EQ(2U, restored_cache.size());
+
+  const HostCache::Entry* entry =
+      restored_cache.Lookup(Key("foobar1.com"), now);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(OK, entry->error);
+  ASSERT_EQ(1U, entry->addrlist.size());
+  EXPECT_EQ("1.2.3.4", entry->addrlist[0].ToStringWithoutPort());
+
+  entry = restored_cache.Lookup(Key("foobar2.com"), now);
+  ASSERT_TRUE(entry);
+  ASSERT_EQ(1U, entry->addrlist.size());
+  EXPECT_EQ("5.6.7.8", entry->addrlist[0].ToStringWithoutPort());
+
+  // Malformed input is rejected.
+  base::ListValue bad_list;
+  bad_list.AppendString("foobar4.com");
+  EXPECT_FALSE(restored_cache.RestoreFromListValue(bad_list));
+  EXPECT_EQ(2U, restored_cache.size());
+}
+
 // Tests the less than and equal operators for HostCache::Key work.
 TEST(HostCacheTest, KeyComparators) {
   struct {
@@ -24,6 +24,10 @@ namespace {
 // that limit this to 6, so we're temporarily holding it at that level.
 const size_t kDefaultMaxProcTasks = 6u;
 
+// Of the default slots, this many are reserved for requests above IDLE
+// priority, so that speculative requests cannot hold up real ones.
+const size_t kDefaultReservedNonIdleSlots = 3u;
+
 PrioritizedDispatcher::Limits GetDispatcherLimits(
     const HostResolver::Options& options) {
   PrioritizedDispatcher::Limits limits(NUM_PRIORITIES,
@@ -33,8 +37,9 @@ PrioritizedDispatcher::Limits GetDispatcherLimits(
   if (limits.total_jobs != HostResolver::kDefaultParallelism)
     return limits;
 
-  // Default, without trial is no reserved slots.
+  // Default, without trial, is to keep some slots free of IDLE requests.
   limits.total_jobs = kDefaultMaxProcTasks;
+  limits.reserved_slots[LOWEST] = kDefaultReservedNonIdleSlots;
 
   // Parallelism is determined by the field trial.
   std::string group = base::FieldTrialList::FindFullName(
@@ -87,7 +92,8 @@ PrioritizedDispatcher::Limits GetDispatcherLimits(
 HostResolver::Options::Options()
     : max_concurrent_resolves(kDefaultParallelism),
       max_retry_attempts(kDefaultRetryAttempts),
-      enable_caching(true) {
+      enable_caching(true),
+      serve_stale(false) {
 }
 
 HostResolver::RequestInfo::RequestInfo(const HostPortPair& host_port_pair)
@@ -121,11 +127,13 @@ HostResolver::CreateSystemResolver(const Options& options, NetLog* net_log) {
   scoped_ptr<HostCache> cache;
   if (options.enable_caching)
     cache = HostCache::CreateDefaultCache();
-  return scoped_ptr<HostResolver>(new HostResolverImpl(
+  scoped_ptr<HostResolverImpl> resolver(new HostResolverImpl(
       cache.Pass(),
       GetDispatcherLimits(options),
       HostResolverImpl::ProcTaskParams(NULL, options.max_retry_attempts),
       net_log));
+  resolver->set_serve_stale(options.serve_stale);
+  return resolver.PassAs<HostResolver>();
 }
 
 // static
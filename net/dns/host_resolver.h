@@ -45,12 +45,15 @@ class NET_EXPORT HostResolver {
   // resolution. Pass HostResolver::kDefaultRetryAttempts to choose a default
   // value.
   // |enable_caching| controls whether a HostCache is used.
+  // |serve_stale| controls whether recently expired HostCache entries are
+  // served while they are refreshed in the background.
   struct NET_EXPORT Options {
     Options();
 
     size_t max_concurrent_resolves;
     size_t max_retry_attempts;
     bool enable_caching;
+    bool serve_stale;
   };
 
   // The parameters for doing a Resolve(). A hostname and port are
@@ -82,6 +85,8 @@ class NET_EXPORT HostResolver {
     bool allow_cached_response() const { return allow_cached_response_; }
     void set_allow_cached_response(bool b) { allow_cached_response_ = b; }
 
+    // Speculative requests prefetch a result into the cache. They always run
+    // at IDLE priority, whatever priority they are started with.
     bool is_speculative() const { return is_speculative_; }
     void set_is_speculative(bool b) { is_speculative_ = b; }
 
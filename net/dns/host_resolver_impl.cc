@@ -11,6 +11,7 @@
 #endif
 
 #include <cmath>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -240,6 +241,39 @@ void RecordTTL(base::TimeDelta ttl) {
                              base::TimeDelta::FromDays(1), 100);
 }
 
+// Expired cache entries are served while they are refreshed for at most this
+// long after they expire.
+const int64 kMaxStalenessHours = 24;
+
+// Returns true if |a| and |b| contain the same endpoints, in any order.
+bool HaveSameEndpoints(const AddressList& a, const AddressList& b) {
+  std::set<IPEndPoint> a_set(a.begin(), a.end());
+  std::set<IPEndPoint> b_set(b.begin(), b.end());
+  return a_set == b_set;
+}
+
+// Outcomes of speculative requests, recorded in DNS.PrefetchUsage. Do not
+// reorder, the values are used in UMA.
+enum PrefetchUsage {
+  // The prefetch was answered from the cache, or joined a running job.
+  PREFETCH_UNNEEDED,
+  // A request was answered from the cache entry written by a prefetch.
+  PREFETCH_HIT_CACHE,
+  // A request joined a job which was started by a prefetch.
+  PREFETCH_HIT_IN_FLIGHT,
+  // A prefetched result expired, or was prefetched again, before being used.
+  PREFETCH_WASTED,
+  PREFETCH_USAGE_MAX
+};
+
+void RecordPrefetchUsage(PrefetchUsage usage) {
+  UMA_HISTOGRAM_ENUMERATION("DNS.PrefetchUsage", usage, PREFETCH_USAGE_MAX);
+}
+
+// Maximum number of unused prefetched results which are tracked for
+// DNS.PrefetchUsage. Beyond that, the oldest is counted as wasted.
+const size_t kMaxUnusedPrefetches = 100;
+
 bool ConfigureAsyncDnsNoFallbackFieldTrial() {
   const bool kDefault = false;
 
@@ -1289,6 +1323,8 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
 
     // TODO(szym): Check if this is still needed.
     if (!req->info().is_speculative()) {
+      if (!had_non_speculative_request_ && !requests_.empty())
+        RecordPrefetchUsage(PREFETCH_HIT_IN_FLIGHT);
       had_non_speculative_request_ = true;
       if (proc_task_.get())
         proc_task_->set_had_non_speculative_request();
@@ -1686,8 +1722,11 @@ class HostResolverImpl::Job : public PrioritizedDispatcher::Job,
 
     bool did_complete = (entry.error != ERR_NETWORK_CHANGED) &&
                         (entry.error != ERR_HOST_RESOLVER_QUEUE_TOO_LARGE);
-    if (did_complete)
+    if (did_complete) {
       resolver_->CacheResult(key_, entry, ttl);
+      if (entry.error == OK && !had_non_speculative_request_)
+        resolver_->OnPrefetchCompleted(key_);
+    }
 
     // Complete all of the requests that were attached to the job.
     for (RequestsList::const_iterator it = requests_.begin();
@@ -1805,6 +1844,7 @@ HostResolverImpl::HostResolverImpl(
       probe_ipv6_support_(true),
       use_local_ipv6_(false),
       resolved_known_ipv6_hostname_(false),
+      serve_stale_(false),
       additional_resolver_flags_(0),
       fallback_to_proctask_(true) {
 
@@ -1883,6 +1923,7 @@ int HostResolverImpl::Resolve(const RequestInfo& info,
   Key key = GetEffectiveKeyForRequest(info, request_net_log);
 
   int rv = ResolveHelper(key, info, addresses, request_net_log);
+  UpdatePrefetchStats(key, info, rv);
   if (rv != ERR_DNS_CACHE_MISS) {
     LogFinishRequest(source_net_log, request_net_log, info, rv);
     RecordTotalTime(HaveDnsConfig(), info.is_speculative(), base::TimeDelta());
@@ -1892,6 +1933,11 @@ int HostResolverImpl::Resolve(const RequestInfo& info,
   // Next we need to attach our request to a "job". This job is responsible for
   // calling "getaddrinfo(hostname)" on a worker thread.
 
+  // Speculative requests run at the lowest priority, so that the dispatcher's
+  // reserved slots keep them from delaying real requests.
+  if (info.is_speculative())
+    priority = IDLE;
+
   JobMap::iterator jobit = jobs_.find(key);
   Job* job;
   if (jobit == jobs_.end()) {
@@ -1939,8 +1985,16 @@ int HostResolverImpl::ResolveHelper(const Key& key,
   int net_error = ERR_UNEXPECTED;
   if (ResolveAsIP(key, info, &net_error, addresses))
     return net_error;
-  if (ServeFromCache(key, info, &net_error, addresses)) {
+  bool stale = false;
+  if (ServeFromCache(key, info, &net_error, addresses, &stale)) {
     request_net_log.AddEvent(NetLog::TYPE_HOST_RESOLVER_IMPL_CACHE_HIT);
+    if (stale) {
+      // Refresh asynchronously, so that the stale result is returned first.
+      base::MessageLoopProxy::current()->PostTask(
+          FROM_HERE,
+          base::Bind(&HostResolverImpl::RefreshStaleEntry,
+                     weak_ptr_factory_.GetWeakPtr(), info, *addresses));
+    }
     return net_error;
   }
   // TODO(szym): Do not do this if nsswitch.conf instructs not to.
@@ -1968,6 +2022,7 @@ int HostResolverImpl::ResolveFromCache(const RequestInfo& info,
   Key key = GetEffectiveKeyForRequest(info, request_net_log);
 
   int rv = ResolveHelper(key, info, addresses, request_net_log);
+  UpdatePrefetchStats(key, info, rv);
   LogFinishRequest(source_net_log, request_net_log, info, rv);
   return rv;
 }
@@ -2050,14 +2105,34 @@ bool HostResolverImpl::ResolveAsIP(const Key& key,
 bool HostResolverImpl::ServeFromCache(const Key& key,
                                       const RequestInfo& info,
                                       int* net_error,
-                                      AddressList* addresses) {
+                                      AddressList* addresses,
+                                      bool* stale) {
   DCHECK(addresses);
   DCHECK(net_error);
+  DCHECK(stale);
+  *stale = false;
   if (!info.allow_cached_response() || !cache_.get())
     return false;
 
-  const HostCache::Entry* cache_entry = cache_->Lookup(
-      key, base::TimeTicks::Now());
+  base::TimeTicks now = base::TimeTicks::Now();
+  const HostCache::Entry* cache_entry = NULL;
+  if (serve_stale_) {
+    base::TimeTicks expiration;
+    cache_entry = cache_->LookupStale(key, &expiration);
+    if (cache_entry && now >= expiration) {
+      base::TimeDelta staleness = now - expiration;
+      if (cache_entry->error != OK ||
+          staleness > base::TimeDelta::FromHours(kMaxStalenessHours)) {
+        return false;
+      }
+      UMA_HISTOGRAM_CUSTOM_TIMES("DNS.StaleCacheHit", staleness,
+                                 base::TimeDelta::FromSeconds(1),
+                                 base::TimeDelta::FromDays(1), 100);
+      *stale = true;
+    }
+  } else {
+    cache_entry = cache_->Lookup(key, now);
+  }
   if (!cache_entry)
     return false;
 
@@ -2070,6 +2145,79 @@ bool HostResolverImpl::ServeFromCache(const Key& key,
   return true;
 }
 
+void HostResolverImpl::RefreshStaleEntry(const RequestInfo& info,
+                                         const AddressList& stale_addresses) {
+  RequestInfo refresh_info(info);
+  refresh_info.set_allow_cached_response(false);
+  refresh_info.set_is_speculative(true);
+  AddressList* addresses = new AddressList();
+  Resolve(refresh_info, IDLE, addresses,
+          base::Bind(&HostResolverImpl::OnStaleEntryRefreshed,
+                     weak_ptr_factory_.GetWeakPtr(),
+                     base::Owned(addresses), stale_addresses),
+          NULL, BoundNetLog());
+}
+
+void HostResolverImpl::OnStaleEntryRefreshed(
+    const AddressList* addresses,
+    const AddressList& stale_addresses,
+    int net_error) {
+  if (net_error != OK)
+    return;
+  UMA_HISTOGRAM_BOOLEAN("DNS.StaleCacheRefreshChangedAddresses",
+                        !HaveSameEndpoints(*addresses, stale_addresses));
+}
+
+void HostResolverImpl::UpdatePrefetchStats(const Key& key,
+                                           const RequestInfo& info,
+                                           int net_error) {
+  if (info.is_speculative()) {
+    if (net_error != ERR_DNS_CACHE_MISS || jobs_.count(key) > 0)
+      RecordPrefetchUsage(PREFETCH_UNNEEDED);
+    return;
+  }
+  if (!info.allow_cached_response())
+    return;
+
+  PrefetchMap::iterator it = unused_prefetches_.find(key);
+  if (it == unused_prefetches_.end())
+    return;
+  if (net_error == OK) {
+    RecordPrefetchUsage(PREFETCH_HIT_CACHE);
+    DNS_HISTOGRAM("DNS.PrefetchHitAge", base::TimeTicks::Now() - it->second);
+  } else {
+    // The entry expired before it was needed.
+    RecordPrefetchUsage(PREFETCH_WASTED);
+  }
+  unused_prefetches_.erase(it);
+}
+
+void HostResolverImpl::OnPrefetchCompleted(const Key& key) {
+  if (!cache_.get())
+    return;
+
+  const base::TimeTicks now = base::TimeTicks::Now();
+  std::pair<PrefetchMap::iterator, bool> result =
+      unused_prefetches_.insert(std::make_pair(key, now));
+  if (!result.second) {
+    // The previous prefetch of |key| was never used.
+    RecordPrefetchUsage(PREFETCH_WASTED);
+    result.first->second = now;
+    return;
+  }
+  if (unused_prefetches_.size() <= kMaxUnusedPrefetches)
+    return;
+
+  PrefetchMap::iterator oldest = unused_prefetches_.begin();
+  for (PrefetchMap::iterator it = unused_prefetches_.begin();
+       it != unused_prefetches_.end(); ++it) {
+    if (it->second < oldest->second)
+      oldest = it;
+  }
+  unused_prefetches_.erase(oldest);
+  RecordPrefetchUsage(PREFETCH_WASTED);
+}
+
 bool HostResolverImpl::ServeFromHosts(const Key& key,
                                       const RequestInfo& info,
                                       AddressList* addresses) {
@@ -2257,6 +2405,7 @@ void HostResolverImpl::OnIPAddressChanged() {
   probe_weak_ptr_factory_.InvalidateWeakPtrs();
   if (cache_.get())
     cache_->clear();
+  unused_prefetches_.clear();
 #if defined(OS_POSIX) && !defined(OS_MACOSX) && !defined(OS_ANDROID)
   new LoopbackProbeJob(probe_weak_ptr_factory_.GetWeakPtr());
 #endif
@@ -2295,6 +2444,7 @@ void HostResolverImpl::OnDNSChanged() {
   // resolv.conf changes so we don't need to do anything to clear that cache.
   if (cache_.get())
     cache_->clear();
+  unused_prefetches_.clear();
 
   // Life check to bail once |this| is deleted.
   base::WeakPtr<HostResolverImpl> self = weak_ptr_factory_.GetWeakPtr();
@@ -129,6 +129,11 @@ class NET_EXPORT HostResolverImpl
   // NetworkChangeNotifier.
   void SetDnsClient(scoped_ptr<DnsClient> dns_client);
 
+  // If |serve_stale| is true, cache entries which expired recently are served
+  // as cache hits, and a lookup to refresh them is started in the background.
+  // Only successful lookups are served once expired.
+  void set_serve_stale(bool serve_stale) { serve_stale_ = serve_stale; }
+
   // HostResolver methods:
   virtual int Resolve(const RequestInfo& info,
                       RequestPriority priority,
@@ -155,6 +160,7 @@ class NET_EXPORT HostResolverImpl
   class Request;
   typedef HostCache::Key Key;
   typedef std::map<Key, Job*> JobMap;
+  typedef std::map<Key, base::TimeTicks> PrefetchMap;
   typedef ScopedVector<Request> RequestsList;
 
   // Number of consecutive failures of DnsTask (with successful fallback to
@@ -179,11 +185,34 @@ class NET_EXPORT HostResolverImpl
 
   // If |key| is not found in cache returns false, otherwise returns
   // true, sets |net_error| to the cached error code and fills |addresses|
-  // if it is a positive entry.
+  // if it is a positive entry. Sets |stale| if the entry has expired and
+  // should be refreshed.
   bool ServeFromCache(const Key& key,
                       const RequestInfo& info,
                       int* net_error,
-                      AddressList* addresses);
+                      AddressList* addresses,
+                      bool* stale);
+
+  // Resolves |info| again, bypassing the cache, so that the stale entry which
+  // was served as |stale_addresses| is replaced.
+  void RefreshStaleEntry(const RequestInfo& info,
+                         const AddressList& stale_addresses);
+
+  // Called when the lookup started by RefreshStaleEntry() completes.
+  void OnStaleEntryRefreshed(const AddressList* addresses,
+                             const AddressList& stale_addresses,
+                             int net_error);
+
+  // Records in DNS.PrefetchUsage whether the cache lookup for |key| made by
+  // |info|, which returned |net_error|, made use of a prefetch, or, if |info|
+  // is speculative, whether it needs no lookup of its own.
+  void UpdatePrefetchStats(const Key& key,
+                           const RequestInfo& info,
+                           int net_error);
+
+  // Called when a job for |key| with only speculative requests has cached a
+  // successful result.
+  void OnPrefetchCompleted(const Key& key);
 
   // If we have a DnsClient with a valid DnsConfig, and |key| is found in the
   // HOSTS file, returns true and fills |addresses|. Otherwise returns false.
@@ -287,6 +316,13 @@ class NET_EXPORT HostResolverImpl
   // addresses using ADDRESS_FAMILY_UNSPECIFIED. Reset on IP address change.
   bool resolved_known_ipv6_hostname_;
 
+  // True if expired cache entries are served while they are refreshed.
+  bool serve_stale_;
+
+  // Keys whose results were prefetched into the cache but have not been
+  // requested since, with the time each prefetch completed.
+  PrefetchMap unused_prefetches_;
+
   // Any resolver flags that should be added to a request by default.
   HostResolverFlags additional_resolver_flags_;
 
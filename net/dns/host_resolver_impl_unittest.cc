@@ -549,6 +549,46 @@ TEST_F(HostResolverImplTest, AsynchronousLookup) {
   EXPECT_EQ("just.testing", proc_->GetCaptureList()[0].hostname);
 }
 
+// Tests that an expired cache entry is served when |serve_stale| is set, and
+// that the entry is refreshed in the background.
+TEST_F(HostResolverImplTest, ServeStaleCacheEntry) {
+  resolver_->set_serve_stale(true);
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.42");
+  proc_->SignalMultiple(2u);
+
+  Request* req = CreateRequest("just.testing", 80);
+  EXPECT_EQ(ERR_IO_PENDING, req->Resolve());
+  EXPECT_EQ(OK, req->WaitForResult());
+
+  // Expire the entry.
+  HostCache* cache = resolver_->GetHostCache();
+  ASSERT_EQ(1u, cache->size());
+  HostCache::EntryMap::Iterator it(cache->entries());
+  HostCache::Key key = it.key();
+  HostCache::Entry entry = it.value();
+  cache->Set(key, entry, base::TimeTicks::Now() - base::TimeDelta::FromHours(1),
+             base::TimeDelta::FromMinutes(1));
+
+  proc_->AddRuleForAllFamilies("just.testing", "192.168.1.43");
+
+  req = CreateRequest("just.testing", 80);
+  EXPECT_EQ(OK, req->Resolve());
+  EXPECT_TRUE(req->HasOneAddress("192.168.1.42", 80));
+
+  // Start the refresh, and wait for it by attaching a request to its job.
+  base::MessageLoop::current()->RunUntilIdle();
+  HostResolver::RequestInfo info(HostPortPair("just.testing", 80));
+  info.set_allow_cached_response(false);
+  req = CreateRequest(info, DEFAULT_PRIORITY);
+  EXPECT_EQ(ERR_IO_PENDING, req->Resolve());
+  EXPECT_EQ(OK, req->WaitForResult());
+  EXPECT_EQ(2u, proc_->GetCaptureList().size());
+
+  req = CreateRequest("just.testing", 80);
+  EXPECT_EQ(OK, req->ResolveFromCache());
+  EXPECT_TRUE(req->HasOneAddress("192.168.1.43", 80));
+}
+
 TEST_F(HostResolverImplTest, EmptyListMeansNameNotResolved) {
   proc_->AddRuleForAllFamilies("just.testing", "");
   proc_->SignalMultiple(1u);
@@ -1039,6 +1079,35 @@ TEST_F(HostResolverImplTest, HigherPriorityRequestsStartedFirst) {
   EXPECT_EQ("req6", capture_list[6].hostname);
 }
 
+// Speculative requests run at IDLE priority, behind all real requests.
+TEST_F(HostResolverImplTest, SpeculativeRequestsRunAtIdlePriority) {
+  CreateSerialResolver();
+
+  HostResolver::RequestInfo info(HostPortPair("prefetch", 80));
+  info.set_is_speculative(true);
+
+  CreateRequest("req0", 80, LOW);
+  CreateRequest(info, HIGHEST);
+  CreateRequest("req1", 80, LOWEST);
+
+  for (size_t i = 0; i < requests_.size(); ++i) {
+    EXPECT_EQ(ERR_IO_PENDING, requests_[i]->Resolve()) << i;
+  }
+
+  proc_->SignalMultiple(requests_.size());
+
+  for (size_t i = 0; i < requests_.size(); ++i) {
+    EXPECT_EQ(OK, requests_[i]->WaitForResult()) << i;
+  }
+
+  MockHostResolverProc::CaptureList capture_list = proc_->GetCaptureList();
+  ASSERT_EQ(3u, capture_list.size());
+
+  EXPECT_EQ("req0", capture_list[0].hostname);
+  EXPECT_EQ("req1", capture_list[1].hostname);
+  EXPECT_EQ("prefetch", capture_list[2].hostname);
+}
+
 // Try cancelling a job which has not started yet.
 TEST_F(HostResolverImplTest, CancelPendingRequest) {
   CreateSerialResolver();
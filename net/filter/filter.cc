@@ -9,6 +9,7 @@
 #include "net/base/io_buffer.h"
 #include "net/base/mime_util.h"
 #include "net/filter/gzip_filter.h"
+#include "net/filter/lzma_filter.h"
 #include "net/filter/sdch_filter.h"
 
 namespace {
@@ -18,6 +19,7 @@ const char kDeflate[]      = "deflate";
 const char kGZip[]         = "gzip";
 const char kXGZip[]        = "x-gzip";
 const char kSdch[]         = "sdch";
+const char kLzma[]         = "lzma";
 // compress and x-compress are currently not supported.  If we decide to support
 // them, we'll need the same mime type compatibility hack we have for gzip.  For
 // more information, see Firefox's nsHttpChannel::ProcessNormal.
@@ -35,6 +37,20 @@ const int kFilterBufSize = 32 * 1024;
 
 namespace net {
 
+// static
+const Filter::DecoderInfo Filter::kDecoders[] = {
+  { FILTER_TYPE_DEFLATE, kDeflate, &Filter::CreateGZipFilter },
+  { FILTER_TYPE_GZIP, kGZip, &Filter::CreateGZipFilter },
+  { FILTER_TYPE_GZIP, kXGZip, &Filter::CreateGZipFilter },
+  { FILTER_TYPE_GZIP_HELPING_SDCH, NULL, &Filter::CreateGZipFilter },
+  { FILTER_TYPE_SDCH, kSdch, &Filter::InitSdchFilter },
+  { FILTER_TYPE_SDCH_POSSIBLE, NULL, &Filter::InitSdchFilter },
+  { FILTER_TYPE_LZMA, kLzma, &Filter::InitLzmaFilter },
+};
+
+// static
+bool Filter::g_lzma_enabled_ = false;
+
 FilterContext::~FilterContext() {
 }
 
@@ -134,20 +150,20 @@ bool Filter::FlushStreamBuffer(int stream_data_len) {
 // static
 Filter::FilterType Filter::ConvertEncodingToType(
     const std::string& filter_type) {
-  FilterType type_id;
-  if (LowerCaseEqualsASCII(filter_type, kDeflate)) {
-    type_id = FILTER_TYPE_DEFLATE;
-  } else if (LowerCaseEqualsASCII(filter_type, kGZip) ||
-             LowerCaseEqualsASCII(filter_type, kXGZip)) {
-    type_id = FILTER_TYPE_GZIP;
-  } else if (LowerCaseEqualsASCII(filter_type, kSdch)) {
-    type_id = FILTER_TYPE_SDCH;
-  } else {
-    // Note we also consider "identity" and "uncompressed" UNSUPPORTED as
-    // filter should be disabled in such cases.
-    type_id = FILTER_TYPE_UNSUPPORTED;
+  for (size_t i = 0; i < arraysize(kDecoders); ++i) {
+    if (kDecoders[i].encoding &&
+        LowerCaseEqualsASCII(filter_type, kDecoders[i].encoding)) {
+      return kDecoders[i].type;
+    }
   }
-  return type_id;
+  // Note we also consider "identity" and "uncompressed" UNSUPPORTED as
+  // filter should be disabled in such cases.
+  return FILTER_TYPE_UNSUPPORTED;
+}
+
+// static
+void Filter::EnableLzmaSupport(bool enabled) {
+  g_lzma_enabled_ = enabled;
 }
 
 // static
@@ -346,36 +362,45 @@ Filter* Filter::InitGZipFilter(FilterType type_id, int buffer_size) {
   return gz_filter->InitDecoding(type_id) ? gz_filter.release() : NULL;
 }
 
+// static
+Filter* Filter::CreateGZipFilter(FilterType type_id,
+                                 const FilterContext& filter_context,
+                                 int buffer_size) {
+  return InitGZipFilter(type_id, buffer_size);
+}
+
 // static
 Filter* Filter::InitSdchFilter(FilterType type_id,
                                const FilterContext& filter_context,
                                int buffer_size) {
+  if (!SdchManager::Global() || !SdchManager::sdch_enabled())
+    return NULL;
   scoped_ptr<SdchFilter> sdch_filter(new SdchFilter(filter_context));
   sdch_filter->InitBuffer(buffer_size);
   return sdch_filter->InitDecoding(type_id) ? sdch_filter.release() : NULL;
 }
 
+// static
+Filter* Filter::InitLzmaFilter(FilterType type_id,
+                               const FilterContext& filter_context,
+                               int buffer_size) {
+  scoped_ptr<LzmaFilter> lzma_filter(new LzmaFilter());
+  lzma_filter->InitBuffer(buffer_size);
+  return lzma_filter->InitDecoding(type_id) ? lzma_filter.release() : NULL;
+}
+
 // static
 Filter* Filter::PrependNewFilter(FilterType type_id,
                                  const FilterContext& filter_context,
                                  int buffer_size,
                                  Filter* filter_list) {
   scoped_ptr<Filter> first_filter;  // Soon to be start of chain.
-  switch (type_id) {
-    case FILTER_TYPE_GZIP_HELPING_SDCH:
-    case FILTER_TYPE_DEFLATE:
-    case FILTER_TYPE_GZIP:
-      first_filter.reset(InitGZipFilter(type_id, buffer_size));
-      break;
-    case FILTER_TYPE_SDCH:
-    case FILTER_TYPE_SDCH_POSSIBLE:
-      if (SdchManager::Global() && SdchManager::sdch_enabled()) {
-        first_filter.reset(
-            InitSdchFilter(type_id, filter_context, buffer_size));
-      }
-      break;
-    default:
+  for (size_t i = 0; i < arraysize(kDecoders); ++i) {
+    if (kDecoders[i].type == type_id) {
+      first_filter.reset(
+          kDecoders[i].factory(type_id, filter_context, buffer_size));
       break;
+    }
   }
 
   if (!first_filter.get())
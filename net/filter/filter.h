@@ -125,6 +125,7 @@ class NET_EXPORT_PRIVATE Filter {
     FILTER_TYPE_GZIP_HELPING_SDCH,  // Gzip possible, but pass through allowed.
     FILTER_TYPE_SDCH,
     FILTER_TYPE_SDCH_POSSIBLE,  // Sdch possible, but pass through allowed.
+    FILTER_TYPE_LZMA,
     FILTER_TYPE_UNSUPPORTED,
   };
 
@@ -186,6 +187,11 @@ class NET_EXPORT_PRIVATE Filter {
   // FilterType.
   static FilterType ConvertEncodingToType(const std::string& filter_type);
 
+  // Controls whether "lzma" is advertised in Accept-Encoding. LZMA encoded
+  // content is decoded either way.
+  static void EnableLzmaSupport(bool enabled);
+  static bool lzma_enabled() { return g_lzma_enabled_; }
+
   // Given a array of encoding_types, try to do some error recovery adjustment
   // to the list.  This includes handling known bugs in the Apache server (where
   // redundant gzip encoding is specified), as well as issues regarding SDCH
@@ -198,6 +204,7 @@ class NET_EXPORT_PRIVATE Filter {
 
  protected:
   friend class GZipUnitTest;
+  friend class LzmaFilterTest;
   friend class SdchFilterChainingTest;
 
   Filter();
@@ -233,6 +240,24 @@ class NET_EXPORT_PRIVATE Filter {
   int stream_data_len_;
 
  private:
+  // Creates a fully initialized Filter of type |type_id|, or returns NULL.
+  typedef Filter* (*DecoderFactory)(FilterType type_id,
+                                    const FilterContext& filter_context,
+                                    int buffer_size);
+
+  // The registry of content decoders. Each filter type has an entry, which
+  // gives the decoder creating it and the Content-Encoding names selecting it.
+  // Supporting a new encoding only takes a new FilterType and entry.
+  struct DecoderInfo {
+    FilterType type;
+    // Lower case Content-Encoding name, or NULL for types which are only
+    // added by FixupEncodingTypes(). A type may have several entries to give
+    // it several names.
+    const char* encoding;
+    DecoderFactory factory;
+  };
+  static const DecoderInfo kDecoders[];
+
   // Allocates and initializes stream_buffer_ and stream_buffer_size_.
   void InitBuffer(int size);
 
@@ -246,12 +271,18 @@ class NET_EXPORT_PRIVATE Filter {
                                   int buffer_size,
                                   Filter* filter_list);
 
-  // Helper methods for PrependNewFilter. If initialization is successful,
-  // they return a fully initialized Filter. Otherwise, return NULL.
+  // Decoder factories for kDecoders. If initialization is successful, they
+  // return a fully initialized Filter. Otherwise, return NULL.
   static Filter* InitGZipFilter(FilterType type_id, int buffer_size);
+  static Filter* CreateGZipFilter(FilterType type_id,
+                                  const FilterContext& filter_context,
+                                  int buffer_size);
   static Filter* InitSdchFilter(FilterType type_id,
                                 const FilterContext& filter_context,
                                 int buffer_size);
+  static Filter* InitLzmaFilter(FilterType type_id,
+                                const FilterContext& filter_context,
+                                int buffer_size);
 
   // Helper function to empty our output into the next filter's input.
   void PushDataIntoNextFilter();
@@ -268,6 +299,8 @@ class NET_EXPORT_PRIVATE Filter {
   // chained filters.
   FilterStatus last_status_;
 
+  static bool g_lzma_enabled_;
+
   DISALLOW_COPY_AND_ASSIGN(Filter);
 };
 
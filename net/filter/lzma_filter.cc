@@ -0,0 +1,175 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/filter/lzma_filter.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "third_party/lzma_sdk/LzmaDec.h"
+
+namespace {
+
+// The decoder never needs a dictionary larger than the content, but the
+// LZMA SDK does not accept dictionaries smaller than this.
+const uint32 kMinDictionarySize = 1 << 12;
+
+void* LzmaAlloc(void* p, size_t size) {
+  return malloc(size);
+}
+
+void LzmaFree(void* p, void* address) {
+  free(address);
+}
+
+ISzAlloc g_lzma_alloc = { LzmaAlloc, LzmaFree };
+
+uint32 ReadLittleEndian32(const unsigned char* data) {
+  return data[0] | (data[1] << 8) | (data[2] << 16) |
+      (static_cast<uint32>(data[3]) << 24);
+}
+
+void WriteLittleEndian32(uint32 value, unsigned char* data) {
+  for (int i = 0; i < 4; ++i)
+    data[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+}  // namespace
+
+namespace net {
+
+struct LzmaFilter::Decoder {
+  CLzmaDec state;
+};
+
+LzmaFilter::LzmaFilter()
+    : decoding_status_(DECODING_UNINITIALIZED),
+      header_bytes_(0),
+      remaining_size_(0) {
+}
+
+LzmaFilter::~LzmaFilter() {
+  if (decoder_.get())
+    LzmaDec_Free(&decoder_->state, &g_lzma_alloc);
+}
+
+bool LzmaFilter::InitDecoding(Filter::FilterType filter_type) {
+  if (decoding_status_ != DECODING_UNINITIALIZED ||
+      filter_type != Filter::FILTER_TYPE_LZMA) {
+    return false;
+  }
+  decoding_status_ = DECODING_HEADER;
+  return true;
+}
+
+Filter::FilterStatus LzmaFilter::ReadFilteredData(char* dest_buffer,
+                                                  int* dest_len) {
+  if (!dest_buffer || !dest_len || *dest_len <= 0)
+    return Filter::FILTER_ERROR;
+
+  const int dest_buffer_capacity = *dest_len;
+  *dest_len = 0;
+
+  if (decoding_status_ == DECODING_DONE) {
+    // Drop anything following the end of the stream.
+    stream_data_len_ = 0;
+    next_stream_data_ = NULL;
+    return Filter::FILTER_DONE;
+  }
+
+  if (decoding_status_ == DECODING_HEADER) {
+    int header_len = std::min(kHeaderSize - header_bytes_, stream_data_len_);
+    memcpy(header_ + header_bytes_, next_stream_data_, header_len);
+    header_bytes_ += header_len;
+    next_stream_data_ += header_len;
+    stream_data_len_ -= header_len;
+    if (header_bytes_ < kHeaderSize) {
+      next_stream_data_ = NULL;
+      return Filter::FILTER_NEED_MORE_DATA;
+    }
+    if (!StartDecoding()) {
+      decoding_status_ = DECODING_ERROR;
+      return Filter::FILTER_ERROR;
+    }
+  }
+
+  if (decoding_status_ != DECODING_IN_PROGRESS)
+    return Filter::FILTER_ERROR;
+
+  // Unlike zlib, the decoder is also called without input, since it may
+  // still hold output which did not fit in the previous buffer.
+  SizeT output_len = dest_buffer_capacity;
+  if (remaining_size_ < output_len)
+    output_len = static_cast<SizeT>(remaining_size_);
+  SizeT input_len = stream_data_len_;
+  ELzmaStatus lzma_status;
+  SRes result = LzmaDec_DecodeToBuf(
+      &decoder_->state,
+      reinterpret_cast<Byte*>(dest_buffer), &output_len,
+      reinterpret_cast<const Byte*>(next_stream_data_), &input_len,
+      LZMA_FINISH_ANY, &lzma_status);
+  if (result != SZ_OK) {
+    decoding_status_ = DECODING_ERROR;
+    return Filter::FILTER_ERROR;
+  }
+
+  *dest_len = static_cast<int>(output_len);
+  if (remaining_size_ != kuint64max)
+    remaining_size_ -= output_len;
+  stream_data_len_ -= static_cast<int>(input_len);
+  next_stream_data_ = stream_data_len_ ? next_stream_data_ + input_len : NULL;
+
+  if (lzma_status == LZMA_STATUS_FINISHED_WITH_MARK || remaining_size_ == 0) {
+    // An end marker before the announced size means the content is corrupt.
+    if (remaining_size_ != 0 && remaining_size_ != kuint64max) {
+      decoding_status_ = DECODING_ERROR;
+      return Filter::FILTER_ERROR;
+    }
+    decoding_status_ = DECODING_DONE;
+    stream_data_len_ = 0;
+    next_stream_data_ = NULL;
+    return Filter::FILTER_DONE;
+  }
+
+  if (stream_data_len_ == 0)
+    return Filter::FILTER_NEED_MORE_DATA;
+  return Filter::FILTER_OK;
+}
+
+bool LzmaFilter::StartDecoding() {
+  DCHECK_EQ(kHeaderSize, header_bytes_);
+  COMPILE_ASSERT(kHeaderSize == LZMA_PROPS_SIZE + 8, header_size_mismatch);
+
+  remaining_size_ = 0;
+  for (int i = kHeaderSize - 1; i >= LZMA_PROPS_SIZE; --i)
+    remaining_size_ = (remaining_size_ << 8) | header_[i];
+
+  // The dictionary size is in bytes 1 to 4 of the properties. No match can
+  // reach back further than the start of the content, so when the size of
+  // the content is known the dictionary only needs to be that large.
+  uint32 dictionary_size = ReadLittleEndian32(&header_[1]);
+  if (remaining_size_ < dictionary_size) {
+    dictionary_size = std::max(static_cast<uint32>(remaining_size_),
+                               kMinDictionarySize);
+    WriteLittleEndian32(dictionary_size, &header_[1]);
+  }
+  if (dictionary_size > kMaxDictionarySize)
+    return false;
+
+  decoder_.reset(new Decoder);
+  LzmaDec_Construct(&decoder_->state);
+  if (LzmaDec_Allocate(&decoder_->state, header_, LZMA_PROPS_SIZE,
+                       &g_lzma_alloc) != SZ_OK) {
+    decoder_.reset();
+    return false;
+  }
+  LzmaDec_Init(&decoder_->state);
+  decoding_status_ = DECODING_IN_PROGRESS;
+  return true;
+}
+
+}  // namespace net
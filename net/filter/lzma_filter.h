@@ -0,0 +1,84 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// LzmaFilter applies "lzma" content decoding to a data stream. The content is
+// in the .lzma format of the LZMA SDK (also written by "xz --format=lzma"): a
+// 13 byte header holding the decoder properties and the uncompressed size,
+// followed by the compressed LZMA stream. LZMA compresses text considerably
+// better than deflate, and decodes quickly.
+//
+// Decoding is incremental. Each call decodes no more than fits in the
+// caller's buffer, so beyond that buffer memory use is bounded by the LZMA
+// dictionary, whose size is capped.
+//
+// LzmaFilter is a subclass of Filter. See the latter's header file filter.h
+// for sample usage.
+
+#ifndef NET_FILTER_LZMA_FILTER_H_
+#define NET_FILTER_LZMA_FILTER_H_
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "net/filter/filter.h"
+
+namespace net {
+
+class LzmaFilter : public Filter {
+ public:
+  // The size of the .lzma header: 5 bytes of properties, then the
+  // uncompressed size as a little endian 64 bit value.
+  static const int kHeaderSize = 13;
+
+  // Streams whose dictionary is larger than this are rejected rather than
+  // allocating the dictionary.
+  static const uint32 kMaxDictionarySize = 16 * 1024 * 1024;
+
+  virtual ~LzmaFilter();
+
+  // Initializes the filter. |filter_type| must be FILTER_TYPE_LZMA. Returns
+  // true on success. The filter can only be initialized once.
+  bool InitDecoding(Filter::FilterType filter_type);
+
+  // Decodes the pre-filter data and writes the output into |dest_buffer|.
+  // See Filter::ReadFilteredData().
+  virtual FilterStatus ReadFilteredData(char* dest_buffer,
+                                        int* dest_len) OVERRIDE;
+
+ private:
+  enum DecodingStatus {
+    DECODING_UNINITIALIZED,
+    DECODING_HEADER,
+    DECODING_IN_PROGRESS,
+    DECODING_DONE,
+    DECODING_ERROR
+  };
+
+  // Wraps the LZMA SDK decoder state, to keep its header out of this one.
+  struct Decoder;
+
+  // Only to be instantiated by Filter::Factory.
+  LzmaFilter();
+  friend class Filter;
+
+  // Sets up |decoder_| once the whole of |header_| has been received.
+  // Returns false if the header is invalid or the dictionary is too large.
+  bool StartDecoding();
+
+  DecodingStatus decoding_status_;
+
+  unsigned char header_[kHeaderSize];
+  int header_bytes_;
+
+  // The number of bytes still to be decoded, or kuint64max if the size was
+  // not given in the header and the stream ends with an end marker instead.
+  uint64 remaining_size_;
+
+  scoped_ptr<Decoder> decoder_;
+
+  DISALLOW_COPY_AND_ASSIGN(LzmaFilter);
+};
+
+}  // namespace net
+
+#endif  // NET_FILTER_LZMA_FILTER_H_
@@ -0,0 +1,227 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/file_util.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/path_service.h"
+#include "net/base/io_buffer.h"
+#include "net/filter/lzma_filter.h"
+#include "net/filter/mock_filter_context.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/platform_test.h"
+#include "third_party/lzma_sdk/LzmaEnc.h"
+
+namespace {
+
+const int kDefaultBufferSize = 4096;
+const int kSmallBufferSize = 128;
+
+void* LzmaAlloc(void* p, size_t size) {
+  return malloc(size);
+}
+
+void LzmaFree(void* p, void* address) {
+  free(address);
+}
+
+ISzAlloc g_lzma_alloc = { LzmaAlloc, LzmaFree };
+
+// Returns |source| in the .lzma format. If |write_end_mark| is true the
+// uncompressed size is left out of the header, and the stream ends with an
+// end marker instead.
+std::string EncodeLzma(const std::string& source, bool write_end_mark) {
+  CLzmaEncProps props;
+  LzmaEncProps_Init(&props);
+  props.dictSize = 1 << 16;
+
+  std::string encoded(net::LzmaFilter::kHeaderSize + source.size() * 2 + 1024,
+                      '\0');
+  unsigned char* header = reinterpret_cast<unsigned char*>(&encoded[0]);
+  SizeT props_size = LZMA_PROPS_SIZE;
+  SizeT encoded_size = encoded.size() - net::LzmaFilter::kHeaderSize;
+  SRes result = LzmaEncode(
+      header + net::LzmaFilter::kHeaderSize, &encoded_size,
+      reinterpret_cast<const Byte*>(source.data()), source.size(), &props,
+      header, &props_size, write_end_mark, NULL, &g_lzma_alloc, &g_lzma_alloc);
+  EXPECT_EQ(SZ_OK, result);
+
+  uint64 size = write_end_mark ? kuint64max : source.size();
+  for (int i = 0; i < 8; ++i)
+    header[LZMA_PROPS_SIZE + i] = static_cast<unsigned char>(size >> (8 * i));
+  encoded.resize(net::LzmaFilter::kHeaderSize + encoded_size);
+  return encoded;
+}
+
+}  // namespace
+
+namespace net {
+
+// These tests use the path service, which uses autoreleased objects on the
+// Mac, so this needs to be a PlatformTest.
+class LzmaFilterTest : public PlatformTest {
+ protected:
+  virtual void SetUp() {
+    PlatformTest::SetUp();
+
+    base::FilePath file_path;
+    PathService::Get(base::DIR_SOURCE_ROOT, &file_path);
+    file_path = file_path.AppendASCII("net");
+    file_path = file_path.AppendASCII("data");
+    file_path = file_path.AppendASCII("filter_unittests");
+    file_path = file_path.AppendASCII("google.txt");
+    ASSERT_TRUE(base::ReadFileToString(file_path, &source_));
+
+    encoded_ = EncodeLzma(source_, false);
+    encoded_with_end_mark_ = EncodeLzma(source_, true);
+    ASSERT_LT(encoded_.size(), source_.size());
+  }
+
+  void InitFilterWithBufferSize(int buffer_size) {
+    std::vector<Filter::FilterType> filter_types;
+    filter_types.push_back(Filter::FILTER_TYPE_LZMA);
+    filter_.reset(Filter::FactoryForTests(filter_types, filter_context_,
+                                          buffer_size));
+    ASSERT_TRUE(filter_.get());
+  }
+
+  // Feeds |encoded| to |filter_| in chunks of its stream buffer size, reading
+  // the output |output_buffer_size| bytes at a time. Returns the decoded data,
+  // or fails the test on a filter error.
+  std::string Decode(const std::string& encoded, int output_buffer_size) {
+    std::string decoded;
+    size_t encoded_pos = 0;
+    scoped_ptr<char[]> output(new char[output_buffer_size]);
+
+    Filter::FilterStatus code = Filter::FILTER_OK;
+    while (code != Filter::FILTER_DONE) {
+      int input_len = std::min(static_cast<int>(encoded.size() - encoded_pos),
+                               filter_->stream_buffer_size());
+      if (input_len > 0) {
+        memcpy(filter_->stream_buffer()->data(), encoded.data() + encoded_pos,
+               input_len);
+        filter_->FlushStreamBuffer(input_len);
+        encoded_pos += input_len;
+      }
+
+      while (true) {
+        int output_len = output_buffer_size;
+        code = filter_->ReadData(output.get(), &output_len);
+        EXPECT_NE(Filter::FILTER_ERROR, code);
+        if (code == Filter::FILTER_ERROR)
+          return decoded;
+        decoded.append(output.get(), output_len);
+        // Output which filled the buffer may have left more behind.
+        if (code == Filter::FILTER_DONE ||
+            (code == Filter::FILTER_NEED_MORE_DATA &&
+             output_len < output_buffer_size)) {
+          break;
+        }
+      }
+      if (code != Filter::FILTER_DONE && input_len == 0) {
+        ADD_FAILURE() << "Ran out of input";
+        return decoded;
+      }
+    }
+    return decoded;
+  }
+
+  // Feeds all of |encoded| to |filter_| at once, and returns the status of
+  // the first read which does not fill the output buffer.
+  Filter::FilterStatus DecodeAll(const std::string& encoded) {
+    memcpy(filter_->stream_buffer()->data(), encoded.data(), encoded.size());
+    filter_->FlushStreamBuffer(encoded.size());
+    char output[kDefaultBufferSize];
+    Filter::FilterStatus code;
+    int output_len;
+    do {
+      output_len = kDefaultBufferSize;
+      code = filter_->ReadData(output, &output_len);
+    } while (code != Filter::FILTER_ERROR && code != Filter::FILTER_DONE &&
+             output_len == kDefaultBufferSize);
+    return code;
+  }
+
+  std::string source_;
+  std::string encoded_;
+  std::string encoded_with_end_mark_;
+  scoped_ptr<Filter> filter_;
+
+ private:
+  MockFilterContext filter_context_;
+};
+
+TEST_F(LzmaFilterTest, ConvertEncodingToType) {
+  EXPECT_EQ(Filter::FILTER_TYPE_LZMA, Filter::ConvertEncodingToType("lzma"));
+  EXPECT_EQ(Filter::FILTER_TYPE_LZMA, Filter::ConvertEncodingToType("LZMA"));
+}
+
+TEST_F(LzmaFilterTest, Decode) {
+  InitFilterWithBufferSize(kDefaultBufferSize);
+  EXPECT_EQ(source_, Decode(encoded_, kDefaultBufferSize));
+}
+
+TEST_F(LzmaFilterTest, DecodeWithEndMark) {
+  InitFilterWithBufferSize(kDefaultBufferSize);
+  EXPECT_EQ(source_, Decode(encoded_with_end_mark_, kDefaultBufferSize));
+}
+
+// Tests decoding with input and output buffers smaller than the header and
+// than the content, so that decoding is resumed in every state.
+TEST_F(LzmaFilterTest, DecodeWithSmallBuffers) {
+  InitFilterWithBufferSize(kSmallBufferSize);
+  EXPECT_EQ(source_, Decode(encoded_, kSmallBufferSize));
+
+  InitFilterWithBufferSize(1);
+  EXPECT_EQ(source_, Decode(encoded_with_end_mark_, 1));
+
+  InitFilterWithBufferSize(5);
+  EXPECT_EQ(source_, Decode(encoded_, 7));
+}
+
+// Properties with lc + lp + pb out of range are rejected.
+TEST_F(LzmaFilterTest, DecodeCorruptedHeader) {
+  std::string corrupt = encoded_;
+  corrupt[0] = static_cast<char>(0xff);
+  InitFilterWithBufferSize(corrupt.size());
+  EXPECT_EQ(Filter::FILTER_ERROR, DecodeAll(corrupt));
+}
+
+// An end marker before the size given in the header is an error.
+TEST_F(LzmaFilterTest, DecodeWrongSize) {
+  std::string wrong_size = encoded_with_end_mark_;
+  uint64 size = source_.size() + 1;
+  for (int i = 0; i < 8; ++i)
+    wrong_size[LZMA_PROPS_SIZE + i] = static_cast<char>(size >> (8 * i));
+  InitFilterWithBufferSize(wrong_size.size());
+  EXPECT_EQ(Filter::FILTER_ERROR, DecodeAll(wrong_size));
+}
+
+// Streams needing too large a dictionary are rejected before allocating it.
+TEST_F(LzmaFilterTest, DictionaryTooLarge) {
+  std::string large_dictionary = encoded_with_end_mark_;
+  uint32 dictionary_size = LzmaFilter::kMaxDictionarySize * 2;
+  for (int i = 0; i < 4; ++i)
+    large_dictionary[1 + i] = static_cast<char>(dictionary_size >> (8 * i));
+  InitFilterWithBufferSize(large_dictionary.size());
+  EXPECT_EQ(Filter::FILTER_ERROR, DecodeAll(large_dictionary));
+}
+
+// When the size is known the dictionary is limited to it, so the same large
+// dictionary is fine.
+TEST_F(LzmaFilterTest, DictionaryLimitedToContentSize) {
+  std::string large_dictionary = encoded_;
+  uint32 dictionary_size = LzmaFilter::kMaxDictionarySize * 2;
+  for (int i = 0; i < 4; ++i)
+    large_dictionary[1 + i] = static_cast<char>(dictionary_size >> (8 * i));
+  InitFilterWithBufferSize(kDefaultBufferSize);
+  EXPECT_EQ(source_, Decode(large_dictionary, kDefaultBufferSize));
+}
+
+}  // namespace net
@@ -86,6 +86,11 @@ int DiskCacheBasedQuicServerInfo::WaitForDataReady(
   return ERR_IO_PENDING;
 }
 
+void DiskCacheBasedQuicServerInfo::CancelWaitForDataReadyCallback() {
+  DCHECK(CalledOnValidThread());
+  user_callback_.Reset();
+}
+
 bool DiskCacheBasedQuicServerInfo::IsDataReady() {
   return ready_;
 }
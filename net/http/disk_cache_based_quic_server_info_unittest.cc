@@ -50,6 +50,26 @@ TEST(DiskCacheBasedQuicServerInfo, DeleteInCallback) {
   EXPECT_EQ(net::OK, callback.GetResult(rv));
 }
 
+// Tests that a cancelled WaitForDataReady callback is not run, and that the
+// data still becomes ready.
+TEST(DiskCacheBasedQuicServerInfo, CancelWaitForDataReady) {
+  MockBlockingBackendFactory* factory = new MockBlockingBackendFactory();
+  MockHttpCache cache(factory);
+  scoped_ptr<net::QuicServerInfo> quic_server_info(
+      new net::DiskCacheBasedQuicServerInfo("https://www.verisign.com",
+                                            cache.http_cache()));
+  quic_server_info->Start();
+  net::TestCompletionCallback callback;
+  int rv = quic_server_info->WaitForDataReady(callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+  quic_server_info->CancelWaitForDataReadyCallback();
+
+  factory->FinishCreation();
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_FALSE(callback.have_result());
+  EXPECT_TRUE(quic_server_info->IsDataReady());
+}
+
 // Tests the basic logic of storing, retrieving and updating data.
 TEST(DiskCacheBasedQuicServerInfo, Update) {
   MockHttpCache cache;
@@ -17,12 +17,16 @@
 namespace net {
 
 HttpBasicState::HttpBasicState(ClientSocketHandle* connection, bool using_proxy)
-    : read_buf_(new GrowableIOBuffer()),
+    : read_buf_(HttpStreamParser::TakeReadBuffer()),
       connection_(connection),
       using_proxy_(using_proxy),
       request_info_(NULL) {}
 
-HttpBasicState::~HttpBasicState() {}
+HttpBasicState::~HttpBasicState() {
+  // The parser references |read_buf_| too.
+  parser_.reset();
+  HttpStreamParser::RecycleReadBuffer(read_buf_.get());
+}
 
 int HttpBasicState::Initialize(const HttpRequestInfo* request_info,
                                RequestPriority priority,
@@ -32,8 +32,10 @@
 #include "net/base/load_flags.h"
 #include "net/base/net_errors.h"
 #include "net/base/upload_data_stream.h"
+#include "net/disk_cache/compressed_entry.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/http/disk_cache_based_quic_server_info.h"
+#include "net/http/http_cache_memory_tier.h"
 #include "net/http/http_cache_transaction.h"
 #include "net/http/http_network_layer.h"
 #include "net/http/http_network_session.h"
@@ -45,6 +47,12 @@
 
 namespace {
 
+// The most entries that PreopenEntries() keeps open.
+const size_t kMaxPreopenedEntries = 100;
+
+// The time a pre-opened entry is kept open waiting for a transaction.
+const int kPreopenedEntryLifetimeSeconds = 30;
+
 // Adaptor to delete a file on a worker thread.
 void DeletePath(base::FilePath path) {
   base::DeleteFile(path, false);
@@ -93,9 +101,11 @@ int HttpCache::DefaultBackend::CreateBackend(
 
 HttpCache::ActiveEntry::ActiveEntry(disk_cache::Entry* entry)
     : disk_entry(entry),
+      compressed_entry(NULL),
       writer(NULL),
       will_process_pending_queue(false),
-      doomed(false) {
+      doomed(false),
+      writing_body(false) {
 }
 
 HttpCache::ActiveEntry::~ActiveEntry() {
@@ -105,6 +115,14 @@ HttpCache::ActiveEntry::~ActiveEntry() {
   }
 }
 
+disk_cache::CompressedEntry* HttpCache::ActiveEntry::GetCompressedEntry() {
+  if (!compressed_entry) {
+    compressed_entry = disk_cache::CompressedEntry::Create(disk_entry);
+    disk_entry = compressed_entry;
+  }
+  return compressed_entry;
+}
+
 //-----------------------------------------------------------------------------
 
 // This structure keeps track of work items that are attempting to create or
@@ -269,6 +287,70 @@ void HttpCache::MetadataWriter::OnIOComplete(int result) {
 
 //-----------------------------------------------------------------------------
 
+// This class opens an entry on behalf of HttpCache::PreopenEntries, and reads
+// its response headers so that the backend brings them into memory.
+class HttpCache::EntryPreopener {
+ public:
+  EntryPreopener(HttpCache* cache, const std::string& key)
+      : cache_(cache->AsWeakPtr()),
+        key_(key),
+        disk_entry_(NULL) {
+  }
+
+  ~EntryPreopener() {}
+
+  // Opens the entry from |backend|.
+  void Start(disk_cache::Backend* backend);
+
+ private:
+  void OnOpenComplete(int result);
+  void OnReadComplete(int result);
+
+  base::WeakPtr<HttpCache> cache_;
+  const std::string key_;
+  disk_cache::Entry* disk_entry_;
+  scoped_refptr<IOBuffer> buf_;
+  DISALLOW_COPY_AND_ASSIGN(EntryPreopener);
+};
+
+void HttpCache::EntryPreopener::Start(disk_cache::Backend* backend) {
+  int rv = backend->OpenEntry(
+      key_, &disk_entry_,
+      base::Bind(&EntryPreopener::OnOpenComplete, base::Unretained(this)));
+  if (rv != ERR_IO_PENDING)
+    OnOpenComplete(rv);
+}
+
+void HttpCache::EntryPreopener::OnOpenComplete(int result) {
+  if (result != OK) {
+    if (cache_.get())
+      cache_->OnEntryPreopened(key_, NULL);
+    delete this;
+    return;
+  }
+
+  int buf_len = disk_entry_->GetDataSize(kResponseInfoIndex);
+  buf_ = new IOBuffer(buf_len);
+  result = disk_entry_->ReadData(
+      kResponseInfoIndex, 0, buf_.get(), buf_len,
+      base::Bind(&EntryPreopener::OnReadComplete, base::Unretained(this)));
+  if (result != ERR_IO_PENDING)
+    OnReadComplete(result);
+}
+
+void HttpCache::EntryPreopener::OnReadComplete(int result) {
+  // The transaction parses the headers again, and a read failure will show up
+  // there as well, so the data is not needed.
+  if (cache_.get()) {
+    cache_->OnEntryPreopened(key_, disk_entry_);
+  } else {
+    disk_entry_->Close();
+  }
+  delete this;
+}
+
+//-----------------------------------------------------------------------------
+
 class HttpCache::QuicServerInfoFactoryAdaptor : public QuicServerInfoFactory {
  public:
   QuicServerInfoFactoryAdaptor(HttpCache* http_cache)
@@ -290,6 +372,8 @@ HttpCache::HttpCache(const net::HttpNetworkSession::Params& params,
       backend_factory_(backend_factory),
       building_backend_(false),
       mode_(NORMAL),
+      read_while_writing_(false),
+      compress_response_bodies_(false),
       quic_server_info_factory_(new QuicServerInfoFactoryAdaptor(this)),
       network_layer_(new HttpNetworkLayer(new HttpNetworkSession(params))) {
 }
@@ -301,6 +385,8 @@ HttpCache::HttpCache(HttpNetworkSession* session,
       backend_factory_(backend_factory),
       building_backend_(false),
       mode_(NORMAL),
+      read_while_writing_(false),
+      compress_response_bodies_(false),
       quic_server_info_factory_(new QuicServerInfoFactoryAdaptor(this)),
       network_layer_(new HttpNetworkLayer(session)) {
 }
@@ -312,6 +398,8 @@ HttpCache::HttpCache(HttpTransactionFactory* network_layer,
       backend_factory_(backend_factory),
       building_backend_(false),
       mode_(NORMAL),
+      read_while_writing_(false),
+      compress_response_bodies_(false),
       network_layer_(network_layer) {
 }
 
@@ -324,6 +412,7 @@ HttpCache::~HttpCache() {
     ActiveEntry* entry = active_entries_.begin()->second;
     entry->will_process_pending_queue = false;
     entry->pending_queue.clear();
+    entry->waiting_readers.clear();
     entry->readers.clear();
     entry->writer = NULL;
     DeactivateEntry(entry);
@@ -331,6 +420,8 @@ HttpCache::~HttpCache() {
 
   STLDeleteElements(&doomed_entries_);
 
+  DropPreopenedEntries();
+
   // Before deleting pending_ops_, we have to make sure that the disk cache is
   // done with said operations, or it will attempt to use deleted data.
   disk_cache_.reset();
@@ -397,6 +488,14 @@ void HttpCache::WriteMetadata(const GURL& url,
     CreateBackend(NULL, net::CompletionCallback());
   }
 
+  // The writer has to find the response on disk.
+  if (memory_tier_) {
+    HttpRequestInfo request_info;
+    request_info.url = url;
+    request_info.method = "GET";
+    memory_tier_->Remove(GenerateCacheKey(&request_info));
+  }
+
   HttpCache::Transaction* trans =
       new HttpCache::Transaction(priority, this);
   MetadataWriter* writer = new MetadataWriter(trans);
@@ -439,6 +538,43 @@ void HttpCache::InitializeInfiniteCache(const base::FilePath& path) {
   base::WorkerPool::PostTask(FROM_HERE, base::Bind(&DeletePath, path), true);
 }
 
+void HttpCache::EnableMemoryTier(int max_bytes) {
+  if (max_bytes <= 0) {
+    memory_tier_.reset();
+    return;
+  }
+  memory_tier_.reset(new HttpCacheMemoryTier(max_bytes));
+}
+
+void HttpCache::PreopenEntries(const std::vector<GURL>& urls) {
+  // The keys depend on the transactions in playback and record modes.
+  if (!disk_cache_.get() || mode_ != NORMAL)
+    return;
+
+  for (size_t i = 0; i < urls.size(); ++i) {
+    HttpRequestInfo request_info;
+    request_info.url = urls[i];
+    request_info.method = "GET";
+    std::string key = GenerateCacheKey(&request_info);
+
+    if (FindActiveEntry(key) || pending_ops_.count(key) ||
+        preopened_entries_.count(key) || pending_preopens_.count(key)) {
+      continue;
+    }
+
+    pending_preopens_.insert(key);
+    EntryPreopener* preopener = new EntryPreopener(this, key);
+    preopener->Start(disk_cache_.get());
+  }
+}
+
+void HttpCache::ClearInMemoryEntries() {
+  if (memory_tier_)
+    memory_tier_->Clear();
+  pending_preopens_.clear();
+  DropPreopenedEntries();
+}
+
 int HttpCache::CreateTransaction(RequestPriority priority,
                                  scoped_ptr<HttpTransaction>* trans) {
   // Do lazy initialization of disk cache if needed.
@@ -573,6 +709,10 @@ void HttpCache::DoomActiveEntry(const std::string& key) {
 }
 
 int HttpCache::DoomEntry(const std::string& key, Transaction* trans) {
+  if (memory_tier_)
+    memory_tier_->Remove(key);
+  DropPreopenedEntry(key);
+
   // Need to abandon the ActiveEntry, but any transaction attached to the entry
   // should not be impacted.  Dooming an entry only means that it will no
   // longer be returned by FindActiveEntry (and it will also be destroyed once
@@ -598,6 +738,10 @@ int HttpCache::DoomEntry(const std::string& key, Transaction* trans) {
 }
 
 int HttpCache::AsyncDoomEntry(const std::string& key, Transaction* trans) {
+  if (memory_tier_)
+    memory_tier_->Remove(key);
+  DropPreopenedEntry(key);
+
   WorkItem* item = new WorkItem(WI_DOOM_ENTRY, trans, NULL);
   PendingOp* pending_op = GetPendingOp(key);
   if (pending_op->writer) {
@@ -738,6 +882,14 @@ int HttpCache::OpenEntry(const std::string& key, ActiveEntry** entry,
     return OK;
   }
 
+  PreopenedEntriesMap::iterator preopened = preopened_entries_.find(key);
+  if (preopened != preopened_entries_.end() && !pending_ops_.count(key)) {
+    disk_cache::Entry* disk_entry = preopened->second.disk_entry;
+    preopened_entries_.erase(preopened);
+    *entry = ActivateEntry(disk_entry);
+    return OK;
+  }
+
   WorkItem* item = new WorkItem(WI_OPEN_ENTRY, trans, entry);
   PendingOp* pending_op = GetPendingOp(key);
   if (pending_op->writer) {
@@ -767,6 +919,10 @@ int HttpCache::CreateEntry(const std::string& key, ActiveEntry** entry,
     return ERR_CACHE_RACE;
   }
 
+  if (memory_tier_)
+    memory_tier_->Remove(key);
+  DropPreopenedEntry(key);
+
   WorkItem* item = new WorkItem(WI_CREATE_ENTRY, trans, entry);
   PendingOp* pending_op = GetPendingOp(key);
   if (pending_op->writer) {
@@ -810,6 +966,12 @@ int HttpCache::AddTransactionToEntry(ActiveEntry* entry, Transaction* trans) {
   // NOTE: If the transaction can only write, then the entry should not be in
   // use (since any existing entry should have already been doomed).
 
+  if (entry->writing_body && trans->CanReadWhileWriting()) {
+    // The transaction reads the body as it is written.
+    entry->readers.push_back(trans);
+    return OK;
+  }
+
   if (entry->writer || entry->will_process_pending_queue) {
     entry->pending_queue.push_back(trans);
     return ERR_IO_PENDING;
@@ -844,9 +1006,7 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
   if (entry->will_process_pending_queue && entry->readers.empty())
     return;
 
-  if (entry->writer) {
-    DCHECK(trans == entry->writer);
-
+  if (entry->writer == trans) {
     // Assume there was a failure.
     bool success = false;
     if (cancel) {
@@ -857,6 +1017,9 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
       // The previous operation may have deleted the entry.
       if (!trans->entry())
         return;
+      // The entry is kept to be resumed later, but the body is not complete.
+      if (success && trans->truncated())
+        FailConcurrentReaders(entry);
     }
     DoneWritingToEntry(entry, success);
   } else {
@@ -865,11 +1028,12 @@ void HttpCache::DoneWithEntry(ActiveEntry* entry, Transaction* trans,
 }
 
 void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
-  DCHECK(entry->readers.empty());
-
   entry->writer = NULL;
+  entry->writing_body = false;
 
   if (success) {
+    // The readers of the body can read the rest of it now.
+    NotifyWaitingReaders(entry);
     ProcessPendingQueue(entry);
   } else {
     DCHECK(!entry->will_process_pending_queue);
@@ -878,8 +1042,19 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
     TransactionList pending_queue;
     pending_queue.swap(entry->pending_queue);
 
-    entry->disk_entry->Doom();
-    DestroyEntry(entry);
+    if (entry->readers.empty()) {
+      entry->disk_entry->Doom();
+      DestroyEntry(entry);
+    } else {
+      // The readers of the body keep the entry until they are done with it.
+      FailConcurrentReaders(entry);
+      if (entry->doomed) {
+        entry->disk_entry->Doom();
+      } else {
+        int rv = DoomEntry(entry->disk_entry->GetKey(), NULL);
+        DCHECK_EQ(OK, rv);
+      }
+    }
 
     // We need to do something about these pending entries, which now need to
     // be added to a new entry.
@@ -892,13 +1067,16 @@ void HttpCache::DoneWritingToEntry(ActiveEntry* entry, bool success) {
 }
 
 void HttpCache::DoneReadingFromEntry(ActiveEntry* entry, Transaction* trans) {
-  DCHECK(!entry->writer);
-
   TransactionList::iterator it =
       std::find(entry->readers.begin(), entry->readers.end(), trans);
   DCHECK(it != entry->readers.end());
 
   entry->readers.erase(it);
+  entry->waiting_readers.remove(trans);
+
+  // The pending transactions still have to wait for the writer.
+  if (entry->writer)
+    return;
 
   ProcessPendingQueue(entry);
 }
@@ -916,6 +1094,61 @@ void HttpCache::ConvertWriterToReader(ActiveEntry* entry) {
   ProcessPendingQueue(entry);
 }
 
+void HttpCache::OnWritingBody(ActiveEntry* entry) {
+  DCHECK(entry->writer);
+  DCHECK(entry->readers.empty());
+  if (!read_while_writing_)
+    return;
+
+  entry->writing_body = true;
+
+  // Let in the pending transactions that can read the body as it is written.
+  // Any of them may add or remove pending transactions (or even finish the
+  // writer) from its callback, so we look at the queue again every time.
+  while (entry->writing_body) {
+    TransactionList::iterator it = entry->pending_queue.begin();
+    while (it != entry->pending_queue.end() && !(*it)->CanReadWhileWriting())
+      ++it;
+    if (it == entry->pending_queue.end())
+      break;
+
+    Transaction* trans = *it;
+    entry->pending_queue.erase(it);
+    entry->readers.push_back(trans);
+    trans->io_callback().Run(OK);
+  }
+}
+
+void HttpCache::WaitForBodyData(ActiveEntry* entry, Transaction* trans) {
+  DCHECK(entry->writing_body);
+  DCHECK(std::find(entry->readers.begin(), entry->readers.end(), trans) !=
+         entry->readers.end());
+  entry->waiting_readers.push_back(trans);
+}
+
+void HttpCache::NotifyWaitingReaders(ActiveEntry* entry) {
+  // The readers are notified asynchronously because we are in the middle of
+  // the writer's IO.  A reader that goes away in the meantime is removed from
+  // |entry| and its callback is not invoked.
+  TransactionList waiting_readers;
+  waiting_readers.swap(entry->waiting_readers);
+  for (TransactionList::iterator it = waiting_readers.begin();
+       it != waiting_readers.end(); ++it) {
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE, base::Bind((*it)->io_callback(), OK));
+  }
+}
+
+void HttpCache::FailConcurrentReaders(ActiveEntry* entry) {
+  // New readers have to wait for the writer.
+  entry->writing_body = false;
+  for (TransactionList::iterator it = entry->readers.begin();
+       it != entry->readers.end(); ++it) {
+    (*it)->OnWriterFailed();
+  }
+  NotifyWaitingReaders(entry);
+}
+
 LoadState HttpCache::GetLoadStateForPendingTransaction(
       const Transaction* trans) {
   ActiveEntriesMap::const_iterator i = active_entries_.find(trans->key());
@@ -1007,6 +1240,58 @@ void HttpCache::ProcessPendingQueue(ActiveEntry* entry) {
       base::Bind(&HttpCache::OnProcessPendingQueue, AsWeakPtr(), entry));
 }
 
+void HttpCache::OnEntryPreopened(const std::string& key,
+                                 disk_cache::Entry* disk_entry) {
+  // The entry may have been doomed or cleared, or a transaction may be using
+  // it already.
+  bool wanted = pending_preopens_.erase(key) > 0;
+  if (!disk_entry)
+    return;
+  if (!wanted || FindActiveEntry(key) || pending_ops_.count(key)) {
+    disk_entry->Close();
+    return;
+  }
+
+  if (preopened_entries_.size() >= kMaxPreopenedEntries) {
+    PreopenedEntriesMap::iterator oldest = preopened_entries_.begin();
+    for (PreopenedEntriesMap::iterator it = preopened_entries_.begin();
+         it != preopened_entries_.end(); ++it) {
+      if (it->second.open_time < oldest->second.open_time)
+        oldest = it;
+    }
+    oldest->second.disk_entry->Close();
+    preopened_entries_.erase(oldest);
+  }
+
+  if (preopened_entries_.empty()) {
+    base::MessageLoop::current()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&HttpCache::OnExpirePreopenedEntries, AsWeakPtr()),
+        base::TimeDelta::FromSeconds(kPreopenedEntryLifetimeSeconds));
+  }
+
+  PreopenedEntry& preopened = preopened_entries_[key];
+  preopened.disk_entry = disk_entry;
+  preopened.open_time = base::TimeTicks::Now();
+}
+
+void HttpCache::DropPreopenedEntry(const std::string& key) {
+  pending_preopens_.erase(key);
+  PreopenedEntriesMap::iterator it = preopened_entries_.find(key);
+  if (it == preopened_entries_.end())
+    return;
+  it->second.disk_entry->Close();
+  preopened_entries_.erase(it);
+}
+
+void HttpCache::DropPreopenedEntries() {
+  for (PreopenedEntriesMap::iterator it = preopened_entries_.begin();
+       it != preopened_entries_.end(); ++it) {
+    it->second.disk_entry->Close();
+  }
+  preopened_entries_.clear();
+}
+
 void HttpCache::OnProcessPendingQueue(ActiveEntry* entry) {
   entry->will_process_pending_queue = false;
   DCHECK(!entry->writer);
@@ -1031,6 +1316,31 @@ void HttpCache::OnProcessPendingQueue(ActiveEntry* entry) {
   }
 }
 
+void HttpCache::OnExpirePreopenedEntries() {
+  const base::TimeDelta lifetime =
+      base::TimeDelta::FromSeconds(kPreopenedEntryLifetimeSeconds);
+  base::TimeTicks now = base::TimeTicks::Now();
+  base::TimeTicks oldest_kept;
+  PreopenedEntriesMap::iterator it = preopened_entries_.begin();
+  while (it != preopened_entries_.end()) {
+    if (now - it->second.open_time >= lifetime) {
+      it->second.disk_entry->Close();
+      preopened_entries_.erase(it++);
+      continue;
+    }
+    if (oldest_kept.is_null() || it->second.open_time < oldest_kept)
+      oldest_kept = it->second.open_time;
+    ++it;
+  }
+
+  if (!preopened_entries_.empty()) {
+    base::MessageLoop::current()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&HttpCache::OnExpirePreopenedEntries, AsWeakPtr()),
+        oldest_kept + lifetime - now);
+  }
+}
+
 void HttpCache::OnIOComplete(int result, PendingOp* pending_op) {
   WorkItemOperation op = pending_op->writer->operation();
 
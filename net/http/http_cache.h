@@ -17,6 +17,7 @@
 #include <list>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "base/basictypes.h"
 #include "base/containers/hash_tables.h"
@@ -38,6 +39,7 @@ class GURL;
 
 namespace disk_cache {
 class Backend;
+class CompressedEntry;
 class Entry;
 }
 
@@ -45,6 +47,7 @@ namespace net {
 
 class CertVerifier;
 class HostResolver;
+class HttpCacheMemoryTier;
 class HttpAuthHandlerFactory;
 class HttpNetworkSession;
 class HttpResponseInfo;
@@ -174,6 +177,20 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   void set_mode(Mode value) { mode_ = value; }
   Mode mode() { return mode_; }
 
+  // When enabled, transactions that find an entry whose response body is still
+  // being written by another transaction read what has been written so far
+  // instead of waiting for the writer to finish.
+  void set_read_while_writing(bool value) { read_while_writing_ = value; }
+  bool read_while_writing() const { return read_while_writing_; }
+
+  // When enabled, the bodies of new responses with a compressible mime type
+  // and a known size are stored compressed. Entries stored that way can be
+  // read whether this is enabled or not.
+  void set_compress_response_bodies(bool value) {
+    compress_response_bodies_ = value;
+  }
+  bool compress_response_bodies() const { return compress_response_bodies_; }
+
   // Close currently active sockets so that fresh page loads will not use any
   // recycled connections.  For sockets currently in use, they may not close
   // immediately, but they will not be reusable. This is for debugging.
@@ -189,6 +206,24 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // Initializes the Infinite Cache, if selected by the field trial.
   void InitializeInfiniteCache(const base::FilePath& path);
 
+  // Keeps in memory up to |max_bytes| of the small responses that are read
+  // most often from the disk cache, and serves them from there when they are
+  // fresh.
+  void EnableMemoryTier(int max_bytes);
+
+  // Opens the cache entries for GET requests of |urls| and reads their
+  // response headers, so that the transactions that ask for them later do not
+  // have to wait for the disk.  This is only a hint: nothing is done if the
+  // backend is not ready, and the entries that are not used soon are closed.
+  void PreopenEntries(const std::vector<GURL>& urls);
+
+  // Drops the responses kept in memory and the pre-opened entries.  This must
+  // be called by code that dooms entries of the backend directly.
+  void ClearInMemoryEntries();
+
+  // Returns the memory tier, or NULL if it is not enabled.
+  HttpCacheMemoryTier* memory_tier() { return memory_tier_.get(); }
+
   // HttpTransactionFactory implementation:
   virtual int CreateTransaction(RequestPriority priority,
                                 scoped_ptr<HttpTransaction>* trans) OVERRIDE;
@@ -218,13 +253,21 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
  private:
   // Types --------------------------------------------------------------------
 
+  class EntryPreopener;
   class MetadataWriter;
   class QuicServerInfoFactoryAdaptor;
   class Transaction;
   class WorkItem;
+  friend class EntryPreopener;
   friend class Transaction;
   struct PendingOp;  // Info for an entry under construction.
 
+  // An entry opened by PreopenEntries() that no transaction has used yet.
+  struct PreopenedEntry {
+    disk_cache::Entry* disk_entry;
+    base::TimeTicks open_time;
+  };
+
   typedef std::list<Transaction*> TransactionList;
   typedef std::list<WorkItem*> WorkItemList;
 
@@ -232,18 +275,30 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
     explicit ActiveEntry(disk_cache::Entry* entry);
     ~ActiveEntry();
 
+    // Makes |disk_entry| the wrapper that can store the response body
+    // compressed, if it is not already, and returns it.
+    disk_cache::CompressedEntry* GetCompressedEntry();
+
     disk_cache::Entry* disk_entry;
+    // Same as |disk_entry| once GetCompressedEntry() has been called.
+    disk_cache::CompressedEntry* compressed_entry;
     Transaction*       writer;
     TransactionList    readers;
     TransactionList    pending_queue;
+    // Readers that have read everything |writer| has written so far.
+    TransactionList    waiting_readers;
     bool               will_process_pending_queue;
     bool               doomed;
+    // True while |writer| is writing the response body, and readers may read
+    // it at the same time.
+    bool               writing_body;
   };
 
   typedef base::hash_map<std::string, ActiveEntry*> ActiveEntriesMap;
   typedef base::hash_map<std::string, PendingOp*> PendingOpsMap;
   typedef std::set<ActiveEntry*> ActiveEntriesSet;
   typedef base::hash_map<std::string, int> PlaybackCacheMap;
+  typedef base::hash_map<std::string, PreopenedEntry> PreopenedEntriesMap;
 
   // Methods ------------------------------------------------------------------
 
@@ -340,6 +395,22 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // transactions can start reading from this entry.
   void ConvertWriterToReader(ActiveEntry* entry);
 
+  // Called by the writer of |entry| once the response headers are written and
+  // it starts writing the body.  If read_while_writing() is set, the pending
+  // transactions that can read the body as it is written become readers.
+  void OnWritingBody(ActiveEntry* entry);
+
+  // Makes |trans|, a reader of |entry|, wait until the writer appends more
+  // data to the body or finishes.  |trans| is notified via its IO callback.
+  void WaitForBodyData(ActiveEntry* entry, Transaction* trans);
+
+  // Notifies the readers that are waiting for the writer of |entry|.
+  void NotifyWaitingReaders(ActiveEntry* entry);
+
+  // Tells the readers of |entry| that its writer stopped before writing the
+  // whole body.
+  void FailConcurrentReaders(ActiveEntry* entry);
+
   // Returns the LoadState of the provided pending transaction.
   LoadState GetLoadStateForPendingTransaction(const Transaction* trans);
 
@@ -358,10 +429,24 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
   // Resumes processing the pending list of |entry|.
   void ProcessPendingQueue(ActiveEntry* entry);
 
+  // Called when the entry for |key| has been pre-opened.  |disk_entry| is NULL
+  // if the entry could not be opened.
+  void OnEntryPreopened(const std::string& key, disk_cache::Entry* disk_entry);
+
+  // Closes the pre-opened entry for |key|, and discards the result of any
+  // pre-open in progress for it.
+  void DropPreopenedEntry(const std::string& key);
+
+  // Closes all the pre-opened entries.
+  void DropPreopenedEntries();
+
   // Events (called via PostTask) ---------------------------------------------
 
   void OnProcessPendingQueue(ActiveEntry* entry);
 
+  // Closes the pre-opened entries that have not been used in time.
+  void OnExpirePreopenedEntries();
+
   // Callbacks ----------------------------------------------------------------
 
   // Processes BackendCallback notifications.
@@ -390,12 +475,18 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
 
   Mode mode_;
 
+  bool read_while_writing_;
+  bool compress_response_bodies_;
+
   const scoped_ptr<QuicServerInfoFactoryAdaptor> quic_server_info_factory_;
 
   scoped_ptr<HttpTransactionFactory> network_layer_;
 
   scoped_ptr<disk_cache::Backend> disk_cache_;
 
+  // Keeps the hottest responses of |disk_cache_|, if enabled.
+  scoped_ptr<HttpCacheMemoryTier> memory_tier_;
+
   // The set of active entries indexed by cache key.
   ActiveEntriesMap active_entries_;
 
@@ -407,6 +498,10 @@ class NET_EXPORT HttpCache : public HttpTransactionFactory,
 
   scoped_ptr<PlaybackCacheMap> playback_cache_map_;
 
+  // The keys being pre-opened, and the entries pre-opened but not used yet.
+  std::set<std::string> pending_preopens_;
+  PreopenedEntriesMap preopened_entries_;
+
   DISALLOW_COPY_AND_ASSIGN(HttpCache);
 };
 
@@ -0,0 +1,143 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_cache_memory_tier.h"
+
+#include "base/bind.h"
+#include "base/logging.h"
+#include "net/base/io_buffer.h"
+#include "net/http/http_response_headers.h"
+
+namespace {
+
+// A response is admitted when it is read from disk this many times.
+const int kAdmissionHitCount = 2;
+
+// Bounds the number of responses that are counted for admission.
+const size_t kMaxHitCounts = 1024;
+
+// No single response may take more than this fraction of the tier.
+const int kMaxResponseSizeDivisor = 16;
+
+int GetEntrySize(const std::string& key,
+                 const net::HttpCacheMemoryTier::Response* response) {
+  return static_cast<int>(key.size()) + response->GetSize();
+}
+
+}  // namespace
+
+namespace net {
+
+HttpCacheMemoryTier::Response::Response(const HttpResponseInfo& info,
+                                        const std::string& data)
+    : info_(info),
+      data_(data) {
+}
+
+int HttpCacheMemoryTier::Response::GetSize() const {
+  int size = sizeof(*this) + static_cast<int>(data_.size());
+  if (info_.headers.get())
+    size += static_cast<int>(info_.headers->raw_headers().size());
+  if (info_.metadata.get())
+    size += info_.metadata->size();
+  return size;
+}
+
+HttpCacheMemoryTier::Response::~Response() {
+}
+
+HttpCacheMemoryTier::HttpCacheMemoryTier(int max_bytes)
+    : max_bytes_(max_bytes),
+      size_(0),
+      generation_(0),
+      responses_(ResponseMap::NO_AUTO_EVICT),
+      hit_counts_(kMaxHitCounts),
+      memory_pressure_listener_(
+          base::Bind(&HttpCacheMemoryTier::OnMemoryPressure,
+                     base::Unretained(this))) {
+  DCHECK_GT(max_bytes_, 0);
+}
+
+HttpCacheMemoryTier::~HttpCacheMemoryTier() {
+}
+
+HttpCacheMemoryTier::Response* HttpCacheMemoryTier::Lookup(
+    const std::string& key) {
+  ResponseMap::iterator it = responses_.Get(key);
+  return it != responses_.end() ? it->second.get() : NULL;
+}
+
+bool HttpCacheMemoryTier::RecordHit(const std::string& key, int data_size) {
+  if (data_size < 0 || data_size > max_bytes_ / kMaxResponseSizeDivisor)
+    return false;
+
+  HitCountMap::iterator it = hit_counts_.Get(key);
+  if (it == hit_counts_.end())
+    it = hit_counts_.Put(key, 0);
+  return ++it->second >= kAdmissionHitCount;
+}
+
+void HttpCacheMemoryTier::Insert(const std::string& key,
+                                 int64 generation,
+                                 const HttpResponseInfo& info,
+                                 const std::string& data) {
+  if (generation != generation_)
+    return;
+
+  scoped_refptr<Response> response(new Response(info, data));
+  int response_size = GetEntrySize(key, response.get());
+  if (response_size > max_bytes_ / kMaxResponseSizeDivisor)
+    return;
+
+  ResponseMap::iterator old_response = responses_.Peek(key);
+  if (old_response != responses_.end())
+    EraseResponse(old_response);
+
+  HitCountMap::iterator hit_count = hit_counts_.Peek(key);
+  if (hit_count != hit_counts_.end())
+    hit_counts_.Erase(hit_count);
+
+  EvictToSize(max_bytes_ - response_size);
+  responses_.Put(key, response);
+  size_ += response_size;
+}
+
+void HttpCacheMemoryTier::Remove(const std::string& key) {
+  generation_++;
+  ResponseMap::iterator it = responses_.Peek(key);
+  if (it != responses_.end())
+    EraseResponse(it);
+}
+
+void HttpCacheMemoryTier::Clear() {
+  generation_++;
+  responses_.Clear();
+  hit_counts_.Clear();
+  size_ = 0;
+}
+
+void HttpCacheMemoryTier::EvictToSize(int max_size) {
+  while (size_ > max_size && !responses_.empty())
+    EraseResponse(--responses_.end());
+}
+
+void HttpCacheMemoryTier::EraseResponse(ResponseMap::iterator it) {
+  size_ -= GetEntrySize(it->first, it->second.get());
+  DCHECK_GE(size_, 0);
+  responses_.Erase(it);
+}
+
+void HttpCacheMemoryTier::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level) {
+  switch (memory_pressure_level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_MODERATE:
+      EvictToSize(size_ / 2);
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL:
+      Clear();
+      break;
+  }
+}
+
+}  // namespace net
@@ -0,0 +1,111 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_HTTP_HTTP_CACHE_MEMORY_TIER_H_
+#define NET_HTTP_HTTP_CACHE_MEMORY_TIER_H_
+
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/containers/mru_cache.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/ref_counted.h"
+#include "net/base/net_export.h"
+#include "net/http/http_response_info.h"
+
+namespace net {
+
+// HttpCacheMemoryTier keeps in memory copies of small responses that are read
+// often from the disk cache, so that the HttpCache can serve them without
+// going to disk.  The tier only holds complete responses, and it is up to the
+// HttpCache to remove a response whenever the stored one changes.
+//
+// A response is admitted once it has been read from disk a few times, and the
+// least recently used responses are evicted when the tier goes over its byte
+// budget, or when the system is under memory pressure.
+class NET_EXPORT_PRIVATE HttpCacheMemoryTier {
+ public:
+  // A response held by the tier.  It is reference counted so that it can be
+  // evicted while a transaction is still reading it.
+  class NET_EXPORT_PRIVATE Response : public base::RefCounted<Response> {
+   public:
+    Response(const HttpResponseInfo& info, const std::string& data);
+
+    const HttpResponseInfo& info() const { return info_; }
+    const std::string& data() const { return data_; }
+
+    // Returns the memory used by the response, approximately.
+    int GetSize() const;
+
+   private:
+    friend class base::RefCounted<Response>;
+    ~Response();
+
+    const HttpResponseInfo info_;
+    const std::string data_;
+
+    DISALLOW_COPY_AND_ASSIGN(Response);
+  };
+
+  explicit HttpCacheMemoryTier(int max_bytes);
+  ~HttpCacheMemoryTier();
+
+  // Returns the response stored for |key|, or NULL.
+  Response* Lookup(const std::string& key);
+
+  // Records that the response stored on disk for |key|, with |data_size| bytes
+  // of data, is being read.  Returns true if the response should be admitted,
+  // that is, passed to Insert() once it has been read completely.
+  bool RecordHit(const std::string& key, int data_size);
+
+  // Stores a response for |key|, unless some response was removed after the
+  // tier had the given |generation|, in which case the response may be stale.
+  void Insert(const std::string& key,
+              int64 generation,
+              const HttpResponseInfo& info,
+              const std::string& data);
+
+  // Removes the response for |key|, if any.
+  void Remove(const std::string& key);
+
+  // Removes all the responses.
+  void Clear();
+
+  // Returns a value that changes every time a response is removed.
+  int64 generation() const { return generation_; }
+
+  int max_bytes() const { return max_bytes_; }
+  int size() const { return size_; }
+  int entry_count() const { return static_cast<int>(responses_.size()); }
+
+ private:
+  typedef base::MRUCache<std::string, scoped_refptr<Response> > ResponseMap;
+  typedef base::MRUCache<std::string, int> HitCountMap;
+
+  // Evicts the least recently used responses until at most |max_size| bytes
+  // are used.
+  void EvictToSize(int max_size);
+
+  // Removes the response at |it| without changing the generation.
+  void EraseResponse(ResponseMap::iterator it);
+
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
+
+  const int max_bytes_;
+  int size_;
+  int64 generation_;
+  ResponseMap responses_;
+
+  // The number of times the responses that are not in the tier were read.
+  HitCountMap hit_counts_;
+
+  base::MemoryPressureListener memory_pressure_listener_;
+
+  DISALLOW_COPY_AND_ASSIGN(HttpCacheMemoryTier);
+};
+
+}  // namespace net
+
+#endif  // NET_HTTP_HTTP_CACHE_MEMORY_TIER_H_
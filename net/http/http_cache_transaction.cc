@@ -31,7 +31,9 @@
 #include "net/base/net_log.h"
 #include "net/base/upload_data_stream.h"
 #include "net/cert/cert_status_flags.h"
+#include "net/disk_cache/compressed_entry.h"
 #include "net/disk_cache/disk_cache.h"
+#include "net/http/http_cache_memory_tier.h"
 #include "net/http/http_network_session.h"
 #include "net/http/http_request_info.h"
 #include "net/http/http_response_headers.h"
@@ -117,6 +119,31 @@ void RecordVaryHeaderHistogram(const net::HttpResponseInfo* response) {
   UMA_HISTOGRAM_ENUMERATION("HttpCache.Vary", vary, VARY_MAX);
 }
 
+// Bodies smaller than this are not worth compressing.
+const int64 kMinCompressedBodySize = 4 * 1024;
+
+// Mime types that usually compress well. Any text/ type is included too.
+const char* const kCompressibleMimeTypes[] = {
+  "application/javascript",
+  "application/json",
+  "application/x-javascript",
+  "application/xml",
+  "image/svg+xml",
+};
+
+bool IsCompressibleMimeType(const std::string& mime_type) {
+  if (StartsWithASCII(mime_type, "text/", false) ||
+      EndsWith(mime_type, "+json", false) ||
+      EndsWith(mime_type, "+xml", false)) {
+    return true;
+  }
+  for (size_t i = 0; i < arraysize(kCompressibleMimeTypes); ++i) {
+    if (LowerCaseEqualsASCII(mime_type, kCompressibleMimeTypes[i]))
+      return true;
+  }
+  return false;
+}
+
 }  // namespace
 
 namespace net {
@@ -203,10 +230,14 @@ HttpCache::Transaction::Transaction(
       done_reading_(false),
       vary_mismatch_(false),
       couldnt_conditionalize_request_(false),
+      can_read_while_writing_(true),
+      writer_failed_(false),
       io_buf_len_(0),
       read_offset_(0),
       effective_load_flags_(0),
       write_len_(0),
+      admitting_to_memory_tier_(false),
+      memory_tier_generation_(0),
       weak_factory_(this),
       io_callback_(base::Bind(&Transaction::OnIOComplete,
                               weak_factory_.GetWeakPtr())),
@@ -249,6 +280,9 @@ int HttpCache::Transaction::WriteMetadata(IOBuffer* buf, int buf_len,
   if (!cache_.get() || !entry_)
     return ERR_UNEXPECTED;
 
+  if (cache_->memory_tier())
+    cache_->memory_tier()->Remove(cache_key_);
+
   // We don't need to track this operation for anything.
   // It could be possible to check if there is something already written and
   // avoid writing again (it should be the same, right?), but let's allow the
@@ -264,6 +298,10 @@ bool HttpCache::Transaction::AddTruncatedFlag() {
   if (partial_.get() && !truncated_)
     return true;
 
+  // A compressed body cannot be resumed from the middle.
+  if (response_.body_compressed_in_cache)
+    return false;
+
   if (!CanResume(true))
     return false;
 
@@ -278,6 +316,17 @@ bool HttpCache::Transaction::AddTruncatedFlag() {
   return true;
 }
 
+bool HttpCache::Transaction::CanReadWhileWriting() const {
+  // Range requests and validations have to wait for the writer.
+  return can_read_while_writing_ && (mode_ == READ || mode_ == READ_WRITE) &&
+         !partial_.get() && request_->method == "GET" &&
+         !(effective_load_flags_ & LOAD_VALIDATE_CACHE);
+}
+
+void HttpCache::Transaction::OnWriterFailed() {
+  writer_failed_ = true;
+}
+
 LoadState HttpCache::Transaction::GetWriterLoadState() const {
   if (network_trans_.get())
     return network_trans_->GetLoadState();
@@ -407,8 +456,12 @@ int HttpCache::Transaction::Read(IOBuffer* buf, int buf_len,
   }
 
   reading_ = true;
-  int rv;
+  if (memory_response_.get()) {
+    DCHECK_EQ(READ, mode_);
+    return ReadFromMemoryResponse(buf, buf_len);
+  }
 
+  int rv;
   switch (mode_) {
     case READ_WRITE:
       DCHECK(partial_.get());
@@ -449,6 +502,9 @@ void HttpCache::Transaction::StopCaching() {
   if (cache_.get() && entry_ && (mode_ & WRITE) && network_trans_.get() &&
       !is_sparse_ && !range_requested_) {
     mode_ = NONE;
+    // Nothing else will be written for the readers of the body.
+    if (entry_->writer == this)
+      cache_->FailConcurrentReaders(entry_);
   }
 }
 
@@ -853,6 +909,11 @@ int HttpCache::Transaction::DoGetBackendComplete(int result) {
   if (!(mode_ & READ) && effective_load_flags_ & LOAD_ONLY_FROM_CACHE)
     return ERR_CACHE_MISS;
 
+  if ((mode_ & READ_DATA) && ServeFromMemoryTier()) {
+    next_state_ = STATE_NONE;
+    return OK;
+  }
+
   if (mode_ == NONE) {
     if (partial_.get()) {
       partial_->RestoreHeaders(&custom_request_->extra_headers);
@@ -1356,6 +1417,15 @@ int HttpCache::Transaction::DoOverwriteCachedResponse() {
     return OK;
   }
 
+  // Decide how the body will be stored before the response info that records
+  // it is written.
+  response_.body_compressed_in_cache = ShouldCompressBody();
+  if (entry_ &&
+      (response_.body_compressed_in_cache || entry_->compressed_entry)) {
+    entry_->GetCompressedEntry()->SetCompressed(
+        response_.body_compressed_in_cache, 0);
+  }
+
   target_state_ = STATE_TRUNCATE_CACHED_DATA;
   next_state_ = truncated_ ? STATE_CACHE_WRITE_TRUNCATED_RESPONSE :
                              STATE_CACHE_WRITE_RESPONSE;
@@ -1403,6 +1473,13 @@ int HttpCache::Transaction::DoTruncateCachedMetadataComplete(int result) {
   }
 
   next_state_ = STATE_PARTIAL_HEADERS_RECEIVED;
+
+  // We are about to write the body, which other transactions may read as we go.
+  // A compressed body is only readable once it is complete.
+  if (entry_ && mode_ == WRITE && !partial_.get() && !truncated_ &&
+      !response_.body_compressed_in_cache) {
+    cache_->OnWritingBody(entry_);
+  }
   return OK;
 }
 
@@ -1449,6 +1526,17 @@ int HttpCache::Transaction::DoCacheReadResponseComplete(int result) {
     return OnCacheReadError(result, true);
   }
 
+  // A compressed body is always complete, so its size is the Content-Length.
+  if (response_.body_compressed_in_cache) {
+    int64 content_length = response_.headers->GetContentLength();
+    if (truncated_ || content_length <= 0 || content_length > kint32max)
+      return OnCacheReadError(ERR_CACHE_READ_FAILURE, true);
+    entry_->GetCompressedEntry()->SetCompressed(
+        true, static_cast<int32>(content_length));
+  } else if (entry_->compressed_entry) {
+    entry_->compressed_entry->SetCompressed(false, 0);
+  }
+
   // Some resources may have slipped in as truncated when they're not.
   int current_size = entry_->disk_entry->GetDataSize(kResponseContentIndex);
   if (response_.headers->GetContentLength() == current_size)
@@ -1565,6 +1653,21 @@ int HttpCache::Transaction::DoCacheReadData() {
   DCHECK(entry_);
   next_state_ = STATE_CACHE_READ_DATA_COMPLETE;
 
+  if (writer_failed_) {
+    // There is no point in reading what the writer left, as we cannot hand
+    // out the rest of it.
+    next_state_ = STATE_NONE;
+    return ERR_CACHE_READ_FAILURE;
+  }
+
+  if (!partial_.get() && entry_->writing_body &&
+      entry_->disk_entry->GetDataSize(kResponseContentIndex) <= read_offset_) {
+    // We have read everything that was written so far.
+    next_state_ = STATE_CACHE_READ_DATA;
+    cache_->WaitForBodyData(entry_, this);
+    return ERR_IO_PENDING;
+  }
+
   if (net_log_.IsLoggingAllEvents())
     net_log_.BeginEvent(NetLog::TYPE_HTTP_CACHE_READ_DATA);
   if (partial_.get()) {
@@ -1594,8 +1697,18 @@ int HttpCache::Transaction::DoCacheReadDataComplete(int result) {
   }
 
   if (result > 0) {
+    if (admitting_to_memory_tier_)
+      memory_tier_data_.append(read_buf_->data(), result);
     read_offset_ += result;
+  } else if (result == 0 && entry_->writing_body) {
+    // The writer has not appended more data yet.
+    next_state_ = STATE_CACHE_READ_DATA;
+    return OK;
   } else if (result == 0) {  // End of file.
+    if (writer_failed_)
+      return ERR_CACHE_READ_FAILURE;
+    if (admitting_to_memory_tier_)
+      FinishMemoryTierAdmission();
     RecordHistograms();
     cache_->DoneReadingFromEntry(entry_, this);
     entry_ = NULL;
@@ -1641,6 +1754,9 @@ int HttpCache::Transaction::DoCacheWriteDataComplete(int result) {
       done_reading_ = true;
   }
 
+  if (result > 0 && entry_)
+    cache_->NotifyWaitingReaders(entry_);
+
   if (partial_.get()) {
     // This may be the last request.
     if (!(result == 0 && !truncated_ &&
@@ -1809,6 +1925,7 @@ int HttpCache::Transaction::BeginCacheRead() {
   if (truncated_)
     return ERR_CACHE_MISS;
 
+  StartMemoryTierAdmission();
   if (entry_->disk_entry->GetDataSize(kMetadataIndex))
     next_state_ = STATE_CACHE_READ_METADATA;
 
@@ -1835,6 +1952,17 @@ int HttpCache::Transaction::BeginCacheValidation() {
     skip_validation = false;
   }
 
+  if (!skip_validation && entry_->writer != this) {
+    // We joined the entry while its body was being written, so we cannot
+    // validate it.  Wait for the writer like any other transaction.
+    can_read_while_writing_ = false;
+    writer_failed_ = false;
+    cache_->DoneReadingFromEntry(entry_, this);
+    entry_ = NULL;
+    next_state_ = STATE_INIT_ENTRY;
+    return OK;
+  }
+
   if (skip_validation) {
     UpdateTransactionPattern(PATTERN_ENTRY_USED);
     RecordOfflineStatus(effective_load_flags_, OFFLINE_STATUS_FRESH_CACHE);
@@ -2219,9 +2347,13 @@ int HttpCache::Transaction::SetupEntryForRead() {
       partial_.reset();
     }
   }
-  cache_->ConvertWriterToReader(entry_);
+  // A transaction that joined the entry while its body was being written is
+  // a reader already.
+  if (entry_->writer == this)
+    cache_->ConvertWriterToReader(entry_);
   mode_ = READ;
 
+  StartMemoryTierAdmission();
   if (entry_->disk_entry->GetDataSize(kMetadataIndex))
     next_state_ = STATE_CACHE_READ_METADATA;
   return OK;
@@ -2242,6 +2374,84 @@ int HttpCache::Transaction::ReadFromEntry(IOBuffer* data, int data_len) {
   return DoLoop(OK);
 }
 
+bool HttpCache::Transaction::ServeFromMemoryTier() {
+  HttpCacheMemoryTier* memory_tier = cache_->memory_tier();
+  if (!memory_tier || partial_.get() || request_->method != "GET" ||
+      cache_->mode() != NORMAL ||
+      (effective_load_flags_ & LOAD_VALIDATE_CACHE)) {
+    return false;
+  }
+
+  scoped_refptr<HttpCacheMemoryTier::Response> memory_response =
+      memory_tier->Lookup(cache_key_);
+  if (!memory_response.get())
+    return false;
+
+  // Responses that have to be validated go through the disk entry, which is
+  // updated by the validation.
+  const HttpResponseInfo& info = memory_response->info();
+  if (!(effective_load_flags_ & LOAD_PREFERRING_CACHE) &&
+      info.headers->RequiresValidation(info.request_time, info.response_time,
+                                       Time::Now())) {
+    memory_tier->Remove(cache_key_);
+    return false;
+  }
+
+  RecordOfflineStatus(effective_load_flags_, OFFLINE_STATUS_FRESH_CACHE);
+  response_ = info;
+  memory_response_ = memory_response;
+  mode_ = READ;
+  return true;
+}
+
+int HttpCache::Transaction::ReadFromMemoryResponse(IOBuffer* data,
+                                                   int data_len) {
+  const std::string& response_data = memory_response_->data();
+  int num_bytes = std::min(
+      static_cast<int>(response_data.size()) - read_offset_, data_len);
+  memcpy(data->data(), response_data.data() + read_offset_, num_bytes);
+  read_offset_ += num_bytes;
+  return num_bytes;
+}
+
+void HttpCache::Transaction::StartMemoryTierAdmission() {
+  HttpCacheMemoryTier* memory_tier = cache_->memory_tier();
+  if (!memory_tier || partial_.get() || truncated_ ||
+      request_->method != "GET" || cache_->mode() != NORMAL) {
+    return;
+  }
+
+  // The size of a body that is still being written is not known.
+  if (entry_->writing_body)
+    return;
+
+  // The memory tier only looks at the cache key, so it cannot hold responses
+  // that vary with the request.
+  if (response_.headers->response_code() != 200 ||
+      response_.headers->HasHeader("vary")) {
+    return;
+  }
+
+  int data_size = entry_->disk_entry->GetDataSize(kResponseContentIndex);
+  if (!memory_tier->RecordHit(cache_key_, data_size))
+    return;
+
+  admitting_to_memory_tier_ = true;
+  memory_tier_generation_ = memory_tier->generation();
+  memory_tier_data_.reserve(data_size);
+}
+
+void HttpCache::Transaction::FinishMemoryTierAdmission() {
+  DCHECK(admitting_to_memory_tier_);
+  admitting_to_memory_tier_ = false;
+  if (cache_->memory_tier() &&
+      static_cast<int>(memory_tier_data_.size()) == read_offset_) {
+    cache_->memory_tier()->Insert(cache_key_, memory_tier_generation_,
+                                  response_, memory_tier_data_);
+  }
+  memory_tier_data_.clear();
+}
+
 int HttpCache::Transaction::WriteToEntry(int index, int offset,
                                          IOBuffer* data, int data_len,
                                          const CompletionCallback& callback) {
@@ -2263,6 +2473,10 @@ int HttpCache::Transaction::WriteResponseInfoToEntry(bool truncated) {
   if (!entry_)
     return OK;
 
+  // The copy kept in memory, if any, is about to be out of date.
+  if (cache_->memory_tier())
+    cache_->memory_tier()->Remove(cache_key_);
+
   // Do not cache no-store content (unless we are record mode).  Do not cache
   // content with cert errors either.  This is to prevent not reporting net
   // errors when loading a resource from the cache.  When we load a page over
@@ -2433,6 +2647,27 @@ bool HttpCache::Transaction::CanResume(bool has_data) {
   return true;
 }
 
+bool HttpCache::Transaction::ShouldCompressBody() {
+  if (!entry_ || !cache_->compress_response_bodies() || partial_.get() ||
+      truncated_ || request_->method != "GET" || cache_->mode() != NORMAL) {
+    return false;
+  }
+
+  const HttpResponseHeaders* headers = response_.headers.get();
+  if (headers->response_code() != 200 ||
+      headers->HasHeader("content-encoding")) {
+    return false;
+  }
+
+  // The size of the body has to be known to read it back.
+  int64 content_length = headers->GetContentLength();
+  if (content_length < kMinCompressedBodySize || content_length > kint32max)
+    return false;
+
+  std::string mime_type;
+  return headers->GetMimeType(&mime_type) && IsCompressibleMimeType(mime_type);
+}
+
 void HttpCache::Transaction::UpdateTransactionPattern(
     TransactionPattern new_transaction_pattern) {
   if (transaction_pattern_ == PATTERN_NOT_COVERED)
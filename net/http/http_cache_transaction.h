@@ -15,6 +15,7 @@
 #include "net/base/net_log.h"
 #include "net/base/request_priority.h"
 #include "net/http/http_cache.h"
+#include "net/http/http_cache_memory_tier.h"
 #include "net/http/http_request_headers.h"
 #include "net/http/http_response_info.h"
 #include "net/http/http_transaction.h"
@@ -93,6 +94,17 @@ class HttpCache::Transaction : public HttpTransaction {
 
   HttpCache::ActiveEntry* entry() { return entry_; }
 
+  // Returns true if the stored response data is not complete.
+  bool truncated() const { return truncated_; }
+
+  // Returns true if this transaction can read the response body of its entry
+  // while another transaction is still writing it.
+  bool CanReadWhileWriting() const;
+
+  // Called when the writer of the entry stops before writing the whole body
+  // that this transaction is reading.
+  void OnWriterFailed();
+
   // Returns the LoadState of the writer transaction of a given ActiveEntry. In
   // other words, returns the LoadState of this transaction without asking the
   // http cache, because this transaction should be the one currently writing
@@ -327,6 +339,20 @@ class HttpCache::Transaction : public HttpTransaction {
   // Reads data from the cache entry.
   int ReadFromEntry(IOBuffer* data, int data_len);
 
+  // Takes the response from the memory tier of the cache if it keeps a fresh
+  // one for this request.  Returns true on success.
+  bool ServeFromMemoryTier();
+
+  // Reads data from |memory_response_|.  Always completes synchronously.
+  int ReadFromMemoryResponse(IOBuffer* data, int data_len);
+
+  // Called when we start reading the whole response from the cache entry, so
+  // that the memory tier may keep a copy once we are done.
+  void StartMemoryTierAdmission();
+
+  // Hands the response read from the cache entry to the memory tier.
+  void FinishMemoryTierAdmission();
+
   // Called to write data to the cache entry.  If the write fails, then the
   // cache entry is destroyed.  Future calls to this function will just do
   // nothing without side-effect.  Returns a network error code.
@@ -376,6 +402,9 @@ class HttpCache::Transaction : public HttpTransaction {
   // data is considered for the result.
   bool CanResume(bool has_data);
 
+  // Returns true if the body of |response_| should be stored compressed.
+  bool ShouldCompressBody();
+
   void UpdateTransactionPattern(TransactionPattern new_transaction_pattern);
   void RecordHistograms();
 
@@ -412,12 +441,20 @@ class HttpCache::Transaction : public HttpTransaction {
   bool done_reading_;  // All available data was read.
   bool vary_mismatch_;  // The request doesn't match the stored vary data.
   bool couldnt_conditionalize_request_;
+  bool can_read_while_writing_;  // We may join an entry as it is written.
+  bool writer_failed_;  // The body we are reading will not be completed.
   scoped_refptr<IOBuffer> read_buf_;
   int io_buf_len_;
   int read_offset_;
   int effective_load_flags_;
   int write_len_;
   scoped_ptr<PartialData> partial_;  // We are dealing with range requests.
+  // The response we are serving from the memory tier, if any.
+  scoped_refptr<HttpCacheMemoryTier::Response> memory_response_;
+  // We keep the data we read from the cache entry for the memory tier.
+  bool admitting_to_memory_tier_;
+  int64 memory_tier_generation_;
+  std::string memory_tier_data_;
   UploadProgress final_upload_progress_;
   base::WeakPtrFactory<Transaction> weak_factory_;
   CompletionCallback io_callback_;
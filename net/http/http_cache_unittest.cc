@@ -6,6 +6,7 @@
 
 #include "base/bind.h"
 #include "base/bind_helpers.h"
+#include "base/memory/memory_pressure_listener.h"
 #include "base/memory/scoped_vector.h"
 #include "base/message_loop/message_loop.h"
 #include "base/strings/string_util.h"
@@ -22,6 +23,7 @@
 #include "net/cert/cert_status_flags.h"
 #include "net/disk_cache/disk_cache.h"
 #include "net/http/http_byte_range.h"
+#include "net/http/http_cache_memory_tier.h"
 #include "net/http/http_request_headers.h"
 #include "net/http/http_request_info.h"
 #include "net/http/http_response_headers.h"
@@ -6393,3 +6395,320 @@ TEST(HttpCache, ReceivedBytesRange) {
 
   RemoveMockTransaction(&kRangeGET_TransactionOK);
 }
+
+// Runs |trans_info| |count| times, letting the cache release its entries after
+// every run.
+void RunTransactionTestRepeatedly(MockHttpCache* cache,
+                                  const MockTransaction& trans_info,
+                                  int count) {
+  for (int i = 0; i < count; ++i) {
+    RunTransactionTest(cache->http_cache(), trans_info);
+    base::MessageLoop::current()->RunUntilIdle();
+  }
+}
+
+// Tests that responses read often from the disk cache are served from memory.
+TEST(HttpCache, MemoryTier_ServesHotResponses) {
+  MockHttpCache cache;
+  cache.http_cache()->EnableMemoryTier(1024 * 1024);
+
+  // Write to the cache, then read the response from disk twice to admit it.
+  RunTransactionTestRepeatedly(&cache, kSimpleGET_Transaction, 2);
+  EXPECT_EQ(0, cache.http_cache()->memory_tier()->entry_count());
+  RunTransactionTestRepeatedly(&cache, kSimpleGET_Transaction, 1);
+  EXPECT_EQ(1, cache.http_cache()->memory_tier()->entry_count());
+  EXPECT_EQ(2, cache.disk_cache()->open_count());
+
+  // Now the disk cache is not used.
+  RunTransactionTestRepeatedly(&cache, kSimpleGET_Transaction, 2);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(2, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
+// Tests that the responses kept in memory are dropped when they are validated
+// or written again.
+TEST(HttpCache, MemoryTier_Invalidation) {
+  MockHttpCache cache;
+  cache.http_cache()->EnableMemoryTier(1024 * 1024);
+
+  RunTransactionTestRepeatedly(&cache, kSimpleGET_Transaction, 3);
+  EXPECT_EQ(1, cache.http_cache()->memory_tier()->entry_count());
+
+  MockTransaction transaction(kSimpleGET_Transaction);
+  transaction.load_flags |= net::LOAD_VALIDATE_CACHE;
+  RunTransactionTestRepeatedly(&cache, transaction, 1);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.http_cache()->memory_tier()->entry_count());
+
+  RunTransactionTestRepeatedly(&cache, kSimpleGET_Transaction, 2);
+  EXPECT_EQ(1, cache.http_cache()->memory_tier()->entry_count());
+
+  transaction.load_flags = net::LOAD_BYPASS_CACHE;
+  RunTransactionTestRepeatedly(&cache, transaction, 1);
+  EXPECT_EQ(3, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.http_cache()->memory_tier()->entry_count());
+}
+
+// Tests that responses that vary with the request are not kept in memory.
+TEST(HttpCache, MemoryTier_Vary) {
+  MockHttpCache cache;
+  cache.http_cache()->EnableMemoryTier(1024 * 1024);
+
+  ScopedMockTransaction transaction(kSimpleGET_Transaction);
+  transaction.request_headers = "Foo: bar\r\n";
+  transaction.response_headers = "Cache-Control: max-age=10000\n"
+                                 "Vary: Foo\n";
+  RunTransactionTestRepeatedly(&cache, transaction, 4);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(3, cache.disk_cache()->open_count());
+  EXPECT_EQ(0, cache.http_cache()->memory_tier()->entry_count());
+}
+
+// Tests that the memory tier is dropped under memory pressure.
+TEST(HttpCache, MemoryTier_MemoryPressure) {
+  MockHttpCache cache;
+  cache.http_cache()->EnableMemoryTier(1024 * 1024);
+
+  RunTransactionTestRepeatedly(&cache, kSimpleGET_Transaction, 3);
+  EXPECT_EQ(1, cache.http_cache()->memory_tier()->entry_count());
+
+  base::MemoryPressureListener::NotifyMemoryPressure(
+      base::MemoryPressureListener::MEMORY_PRESSURE_CRITICAL);
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_EQ(0, cache.http_cache()->memory_tier()->entry_count());
+  EXPECT_EQ(0, cache.http_cache()->memory_tier()->size());
+
+  RunTransactionTestRepeatedly(&cache, kSimpleGET_Transaction, 1);
+  EXPECT_EQ(3, cache.disk_cache()->open_count());
+}
+
+// Tests that readers get the response headers as soon as the writer has
+// written them, and then read the body as it is written.
+TEST(HttpCache, ReadWhileWriting_ManyReaders) {
+  MockHttpCache cache;
+  cache.http_cache()->set_read_while_writing(true);
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+
+  ScopedVector<Context> context_list;
+  const int kNumTransactions = 5;
+
+  for (int i = 0; i < kNumTransactions; ++i) {
+    context_list.push_back(new Context());
+    Context* c = context_list[i];
+
+    c->result = cache.CreateTransaction(&c->trans);
+    ASSERT_EQ(net::OK, c->result);
+
+    c->result = c->trans->Start(
+        &request, c->callback.callback(), net::BoundNetLog());
+  }
+
+  // The writer has received the headers but has not read the body yet, and
+  // every transaction is done starting.
+  base::MessageLoop::current()->RunUntilIdle();
+  for (int i = 0; i < kNumTransactions; ++i) {
+    Context* c = context_list[i];
+    if (c->result == net::ERR_IO_PENDING) {
+      ASSERT_TRUE(c->callback.have_result());
+      c->result = c->callback.WaitForResult();
+    }
+    EXPECT_EQ(net::OK, c->result);
+  }
+
+  // A reader that gets ahead of the writer waits for it.
+  const int kBufferSize = 10;
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(kBufferSize));
+  net::TestCompletionCallback callback;
+  int rv = context_list[1]->trans->Read(buf.get(), kBufferSize,
+                                        callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_FALSE(callback.have_result());
+
+  ReadAndVerifyTransaction(context_list[0]->trans.get(),
+                           kSimpleGET_Transaction);
+  EXPECT_EQ(kBufferSize, callback.WaitForResult());
+
+  std::string content;
+  EXPECT_EQ(net::OK, ReadTransaction(context_list[1]->trans.get(), &content));
+  EXPECT_EQ(kSimpleGET_Transaction.data,
+            std::string(buf->data(), kBufferSize) + content);
+
+  for (int i = 2; i < kNumTransactions; ++i) {
+    ReadAndVerifyTransaction(context_list[i]->trans.get(),
+                             kSimpleGET_Transaction);
+  }
+
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(0, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
+// Tests that readers of the body fail if the writer goes away before writing
+// all of it.
+TEST(HttpCache, ReadWhileWriting_WriterDeleted) {
+  MockHttpCache cache;
+  cache.http_cache()->set_read_while_writing(true);
+
+  MockHttpRequest request(kSimpleGET_Transaction);
+
+  Context writer;
+  Context reader;
+  ASSERT_EQ(net::OK, cache.CreateTransaction(&writer.trans));
+  ASSERT_EQ(net::OK, cache.CreateTransaction(&reader.trans));
+  writer.result = writer.trans->Start(&request, writer.callback.callback(),
+                                      net::BoundNetLog());
+  reader.result = reader.trans->Start(&request, reader.callback.callback(),
+                                      net::BoundNetLog());
+  EXPECT_EQ(net::OK, writer.callback.GetResult(writer.result));
+  EXPECT_EQ(net::OK, reader.callback.GetResult(reader.result));
+
+  const int kBufferSize = 10;
+  scoped_refptr<net::IOBuffer> buf(new net::IOBuffer(kBufferSize));
+  net::TestCompletionCallback callback;
+  int rv = writer.trans->Read(buf.get(), kBufferSize, callback.callback());
+  EXPECT_EQ(kBufferSize, callback.GetResult(rv));
+
+  rv = reader.trans->Read(buf.get(), kBufferSize, callback.callback());
+  EXPECT_EQ(kBufferSize, callback.GetResult(rv));
+  rv = reader.trans->Read(buf.get(), kBufferSize, callback.callback());
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+
+  writer.trans.reset();
+  EXPECT_EQ(net::ERR_CACHE_READ_FAILURE, callback.WaitForResult());
+  reader.trans.reset();
+
+  // The partial response is not used.
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+}
+
+// Tests that a reader that finds the response being written has to wait for
+// the writer if the response has to be validated.
+TEST(HttpCache, ReadWhileWriting_RequiresValidation) {
+  MockHttpCache cache;
+  cache.http_cache()->set_read_while_writing(true);
+
+  ScopedMockTransaction transaction(kSimpleGET_Transaction);
+  transaction.response_headers = "Cache-Control: max-age=0\n";
+  MockHttpRequest request(transaction);
+
+  Context writer;
+  Context reader;
+  ASSERT_EQ(net::OK, cache.CreateTransaction(&writer.trans));
+  ASSERT_EQ(net::OK, cache.CreateTransaction(&reader.trans));
+  writer.result = writer.trans->Start(&request, writer.callback.callback(),
+                                      net::BoundNetLog());
+  reader.result = reader.trans->Start(&request, reader.callback.callback(),
+                                      net::BoundNetLog());
+  EXPECT_EQ(net::OK, writer.callback.GetResult(writer.result));
+
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_FALSE(reader.callback.have_result());
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+
+  ReadAndVerifyTransaction(writer.trans.get(), transaction);
+  writer.trans.reset();
+
+  EXPECT_EQ(net::OK, reader.callback.WaitForResult());
+  ReadAndVerifyTransaction(reader.trans.get(), transaction);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+}
+
+// Tests that a transaction uses the entry opened by PreopenEntries().
+TEST(HttpCache, PreopenEntries) {
+  MockHttpCache cache;
+
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  base::MessageLoop::current()->RunUntilIdle();
+
+  std::vector<GURL> urls;
+  urls.push_back(GURL(kSimpleGET_Transaction.url));
+  urls.push_back(GURL(kTypicalGET_Transaction.url));
+  cache.http_cache()->PreopenEntries(urls);
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_EQ(1, cache.disk_cache()->open_count());
+
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(1, cache.disk_cache()->open_count());
+  EXPECT_EQ(1, cache.disk_cache()->create_count());
+}
+
+// Tests that a pre-opened entry is not used once it has been doomed.
+TEST(HttpCache, PreopenEntries_Doomed) {
+  MockHttpCache cache;
+
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  base::MessageLoop::current()->RunUntilIdle();
+
+  std::vector<GURL> urls(1, GURL(kSimpleGET_Transaction.url));
+  cache.http_cache()->PreopenEntries(urls);
+  base::MessageLoop::current()->RunUntilIdle();
+
+  MockTransaction transaction(kSimpleGET_Transaction);
+  transaction.load_flags |= net::LOAD_BYPASS_CACHE;
+  RunTransactionTest(cache.http_cache(), transaction);
+  base::MessageLoop::current()->RunUntilIdle();
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(2, cache.disk_cache()->create_count());
+
+  // The new entry is opened from the backend.
+  RunTransactionTest(cache.http_cache(), kSimpleGET_Transaction);
+  EXPECT_EQ(2, cache.network_layer()->transaction_count());
+  EXPECT_EQ(2, cache.disk_cache()->open_count());
+}
+
+// Tests that compressible response bodies are stored compressed, and can be
+// read back whether compression is enabled or not.
+TEST(HttpCache, CompressedBody) {
+  MockHttpCache cache;
+  cache.http_cache()->set_compress_response_bodies(true);
+
+  std::string body;
+  while (body.size() < 40000)
+    body += "<p>Some text that compresses well.</p>\n";
+  body.resize(40000);
+  ScopedMockTransaction transaction(kSimpleGET_Transaction);
+  transaction.response_headers = "Cache-Control: max-age=10000\n"
+                                 "Content-Type: text/html\n"
+                                 "Content-Length: 40000\n";
+  transaction.data = body.c_str();
+
+  RunTransactionTest(cache.http_cache(), transaction);
+  base::MessageLoop::current()->RunUntilIdle();
+
+  disk_cache::Entry* entry;
+  ASSERT_TRUE(cache.OpenBackendEntry(kSimpleGET_Transaction.url, &entry));
+  EXPECT_GT(20000, entry->GetDataSize(1));
+  entry->Close();
+
+  RunTransactionTest(cache.http_cache(), transaction);
+  cache.http_cache()->set_compress_response_bodies(false);
+  RunTransactionTest(cache.http_cache(), transaction);
+  EXPECT_EQ(1, cache.network_layer()->transaction_count());
+  EXPECT_EQ(2, cache.disk_cache()->open_count());
+}
+
+// Tests that response bodies that do not compress well are stored as they are.
+TEST(HttpCache, CompressedBody_NotCompressible) {
+  MockHttpCache cache;
+  cache.http_cache()->set_compress_response_bodies(true);
+
+  std::string body(40000, 'a');
+  ScopedMockTransaction transaction(kSimpleGET_Transaction);
+  transaction.response_headers = "Cache-Control: max-age=10000\n"
+                                 "Content-Type: image/png\n"
+                                 "Content-Length: 40000\n";
+  transaction.data = body.c_str();
+
+  RunTransactionTest(cache.http_cache(), transaction);
+  base::MessageLoop::current()->RunUntilIdle();
+
+  disk_cache::Entry* entry;
+  ASSERT_TRUE(cache.OpenBackendEntry(kSimpleGET_Transaction.url, &entry));
+  EXPECT_EQ(40000, entry->GetDataSize(1));
+  entry->Close();
+}
@@ -13,6 +13,7 @@
 #include "base/strings/string_util.h"
 #include "base/values.h"
 #include "net/http/http_auth_handler_factory.h"
+#include "net/http/http_preconnect_predictor.h"
 #include "net/http/http_response_body_drainer.h"
 #include "net/http/http_stream_factory_impl.h"
 #include "net/http/url_security_manager.h"
@@ -46,6 +47,7 @@ net::ClientSocketPoolManager* CreateSocketPoolManager(
       params.ssl_session_cache_shard,
       params.proxy_service,
       params.ssl_config_service,
+      params.http_server_properties,
       pool_type);
 }
 
@@ -84,11 +86,13 @@ HttpNetworkSession::Params::Params()
       enable_quic(false),
       enable_quic_https(false),
       enable_quic_port_selection(true),
+      enable_quic_connection_migration(false),
       quic_clock(NULL),
       quic_random(NULL),
       quic_max_packet_length(kDefaultMaxPacketSize),
       enable_user_alternate_protocol_ports(false),
-      quic_crypto_client_stream_factory(NULL) {
+      quic_crypto_client_stream_factory(NULL),
+      enable_learned_preconnect(false) {
   quic_supported_versions.push_back(QUIC_VERSION_13);
 }
 
@@ -121,7 +125,8 @@ HttpNetworkSession::HttpNetworkSession(const Params& params)
                                new QuicClock(),
                            params.quic_max_packet_length,
                            params.quic_supported_versions,
-                           params.enable_quic_port_selection),
+                           params.enable_quic_port_selection,
+                           params.enable_quic_connection_migration),
       spdy_session_pool_(params.host_resolver,
                          params.ssl_config_service,
                          params.http_server_properties,
@@ -142,6 +147,8 @@ HttpNetworkSession::HttpNetworkSession(const Params& params)
   DCHECK(proxy_service_);
   DCHECK(ssl_config_service_.get());
   CHECK(http_server_properties_);
+  if (params.enable_learned_preconnect)
+    preconnect_predictor_.reset(new HttpPreconnectPredictor(this));
 }
 
 HttpNetworkSession::~HttpNetworkSession() {
@@ -206,6 +213,8 @@ base::Value* HttpNetworkSession::QuicInfoToValue() const {
   dict->SetBoolean("quic_enabled_https", params_.enable_quic_https);
   dict->SetBoolean("enable_quic_port_selection",
                    params_.enable_quic_port_selection);
+  dict->SetBoolean("enable_quic_connection_migration",
+                   params_.enable_quic_connection_migration);
   dict->SetString("origin_to_force_quic_on",
                   params_.origin_to_force_quic_on.ToString());
   return dict;
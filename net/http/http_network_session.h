@@ -33,6 +33,7 @@ class ClientSocketPoolManager;
 class HostResolver;
 class HttpAuthHandlerFactory;
 class HttpNetworkSessionPeer;
+class HttpPreconnectPredictor;
 class HttpProxyClientSocketPool;
 class HttpResponseBodyDrainer;
 class HttpServerProperties;
@@ -91,6 +92,7 @@ class NET_EXPORT HttpNetworkSession
     bool enable_quic;
     bool enable_quic_https;
     bool enable_quic_port_selection;
+    bool enable_quic_connection_migration;
     HostPortPair origin_to_force_quic_on;
     QuicClock* quic_clock;  // Will be owned by QuicStreamFactory.
     QuicRandom* quic_random;
@@ -98,6 +100,9 @@ class NET_EXPORT HttpNetworkSession
     bool enable_user_alternate_protocol_ports;
     QuicCryptoClientStreamFactory* quic_crypto_client_stream_factory;
     QuicVersionVector quic_supported_versions;
+    // Whether to open the connections origins are expected to need as soon
+    // as a page load from them starts. See HttpPreconnectPredictor.
+    bool enable_learned_preconnect;
   };
 
   enum SocketPoolType {
@@ -143,6 +148,10 @@ class NET_EXPORT HttpNetworkSession
   base::WeakPtr<HttpServerProperties> http_server_properties() {
     return http_server_properties_;
   }
+  // Returns NULL unless Params::enable_learned_preconnect was set.
+  HttpPreconnectPredictor* preconnect_predictor() {
+    return preconnect_predictor_.get();
+  }
   HttpStreamFactory* http_stream_factory() {
     return http_stream_factory_.get();
   }
@@ -204,6 +213,7 @@ class NET_EXPORT HttpNetworkSession
   SpdySessionPool spdy_session_pool_;
   scoped_ptr<HttpStreamFactory> http_stream_factory_;
   scoped_ptr<HttpStreamFactory> http_stream_factory_for_websocket_;
+  scoped_ptr<HttpPreconnectPredictor> preconnect_predictor_;
   std::set<HttpResponseBodyDrainer*> response_drainers_;
 
   Params params_;
@@ -199,6 +199,13 @@ int HttpNetworkTransaction::Start(const HttpRequestInfo* request_info,
       (request_->privacy_mode == kPrivacyModeDisabled);
   server_ssl_config_.channel_id_enabled = channel_id_enabled;
 
+  HttpPreconnectPredictor* preconnect_predictor =
+      session_->preconnect_predictor();
+  if (preconnect_predictor && !websocket_handshake_stream_base_create_helper_) {
+    preconnect_request_ = preconnect_predictor->OnRequestStarted(
+        *request_, priority_, server_ssl_config_, proxy_ssl_config_);
+  }
+
   next_state_ = STATE_NOTIFY_BEFORE_CREATE_STREAM;
   int rv = DoLoop(OK);
   if (rv == ERR_IO_PENDING)
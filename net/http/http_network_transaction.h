@@ -15,6 +15,7 @@
 #include "net/base/net_log.h"
 #include "net/base/request_priority.h"
 #include "net/http/http_auth.h"
+#include "net/http/http_preconnect_predictor.h"
 #include "net/http/http_request_headers.h"
 #include "net/http/http_response_info.h"
 #include "net/http/http_stream_factory.h"
@@ -340,6 +341,9 @@ class NET_EXPORT_PRIVATE HttpNetworkTransaction
 
   BeforeNetworkStartCallback before_network_start_callback_;
 
+  // Lets the session's HttpPreconnectPredictor know when this request is done.
+  scoped_ptr<HttpPreconnectPredictor::Request> preconnect_request_;
+
   DISALLOW_COPY_AND_ASSIGN(HttpNetworkTransaction);
 };
 
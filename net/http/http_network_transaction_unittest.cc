@@ -9518,6 +9518,7 @@ TEST_P(HttpNetworkTransactionTest, MultiRoundAuth) {
       &transport_pool_histograms,
       session_deps_.host_resolver.get(),
       session_deps_.socket_factory.get(),
+      session_deps_.http_server_properties.GetWeakPtr(),
       session_deps_.net_log);
   scoped_ptr<MockClientSocketPoolManager> mock_pool_manager(
       new MockClientSocketPoolManager);
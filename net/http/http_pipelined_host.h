@@ -89,6 +89,10 @@ class NET_EXPORT_PRIVATE HttpPipelinedHost {
   // requests.
   virtual bool IsExistingPipelineAvailable() const = 0;
 
+  // Returns the number of requests already in flight on the pipeline that
+  // CreateStreamOnExistingPipeline() would use, or -1 if there is none.
+  virtual int GetDepthOfAvailablePipeline() const = 0;
+
   // Returns a Key that uniquely identifies this host.
   virtual const Key& GetKey() const = 0;
 
@@ -56,6 +56,13 @@ bool HttpPipelinedHostForced::IsExistingPipelineAvailable() const {
   return pipeline_.get() != NULL;
 }
 
+int HttpPipelinedHostForced::GetDepthOfAvailablePipeline() const {
+  if (!pipeline_.get()) {
+    return -1;
+  }
+  return pipeline_->depth();
+}
+
 const HttpPipelinedHost::Key& HttpPipelinedHostForced::GetKey() const {
   return key_;
 }
@@ -52,6 +52,8 @@ class NET_EXPORT_PRIVATE HttpPipelinedHostForced
 
   virtual bool IsExistingPipelineAvailable() const OVERRIDE;
 
+  virtual int GetDepthOfAvailablePipeline() const OVERRIDE;
+
   virtual const Key& GetKey() const OVERRIDE;
 
   virtual base::Value* PipelineInfoToValue() const OVERRIDE;
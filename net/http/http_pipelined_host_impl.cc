@@ -77,6 +77,18 @@ bool HttpPipelinedHostImpl::IsExistingPipelineAvailable() const {
   return false;
 }
 
+int HttpPipelinedHostImpl::GetDepthOfAvailablePipeline() const {
+  int depth = -1;
+  for (PipelineInfoMap::const_iterator it = pipelines_.begin();
+       it != pipelines_.end(); ++it) {
+    if (CanPipelineAcceptRequests(it->first) &&
+        (depth < 0 || it->first->depth() < depth)) {
+      depth = it->first->depth();
+    }
+  }
+  return depth;
+}
+
 const HttpPipelinedHost::Key& HttpPipelinedHostImpl::GetKey() const {
   return key_;
 }
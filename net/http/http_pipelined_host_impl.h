@@ -54,6 +54,8 @@ class NET_EXPORT_PRIVATE HttpPipelinedHostImpl
 
   virtual bool IsExistingPipelineAvailable() const OVERRIDE;
 
+  virtual int GetDepthOfAvailablePipeline() const OVERRIDE;
+
   // HttpPipelinedConnection::Delegate interface
 
   // Called when a pipelined connection completes a request. Adds a pending
@@ -129,6 +129,7 @@ TEST_F(HttpPipelinedHostImplTest, IgnoresFullPipeline) {
       HttpPipelinedHostImpl::max_pipeline_depth(), true, true);
 
   EXPECT_FALSE(host_->IsExistingPipelineAvailable());
+  EXPECT_EQ(-1, host_->GetDepthOfAvailablePipeline());
   EXPECT_EQ(NULL, host_->CreateStreamOnExistingPipeline());
 
   ClearTestPipeline(pipeline);
@@ -142,6 +143,7 @@ TEST_F(HttpPipelinedHostImplTest, PicksLeastLoadedPipeline) {
   MockPipeline* empty_pipeline = AddTestPipeline(0, true, true);
 
   EXPECT_TRUE(host_->IsExistingPipelineAvailable());
+  EXPECT_EQ(0, host_->GetDepthOfAvailablePipeline());
   EXPECT_CALL(*empty_pipeline, CreateNewStream())
       .Times(1)
       .WillOnce(ReturnNull());
@@ -91,6 +91,15 @@ bool HttpPipelinedHostPool::IsExistingPipelineAvailableForKey(
   return host->IsExistingPipelineAvailable();
 }
 
+int HttpPipelinedHostPool::GetDepthOfAvailablePipelineForKey(
+    const HttpPipelinedHost::Key& key) {
+  HttpPipelinedHost* host = GetPipelinedHost(key, false);
+  if (!host) {
+    return -1;
+  }
+  return host->GetDepthOfAvailablePipeline();
+}
+
 HttpPipelinedHost* HttpPipelinedHostPool::GetPipelinedHost(
     const HttpPipelinedHost::Key& key, bool create_if_not_found) {
   HostMap::iterator host_it = host_map_.find(key);
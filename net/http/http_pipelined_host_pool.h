@@ -69,6 +69,11 @@ class NET_EXPORT_PRIVATE HttpPipelinedHostPool
   // can accept new requests.
   bool IsExistingPipelineAvailableForKey(const HttpPipelinedHost::Key& key);
 
+  // Returns the number of requests in flight on the pipeline that
+  // CreateStreamOnExistingPipeline() would use for |key|, or -1 if there is
+  // none.
+  int GetDepthOfAvailablePipelineForKey(const HttpPipelinedHost::Key& key);
+
   // Callbacks for HttpPipelinedHost.
   virtual void OnHostIdle(HttpPipelinedHost* host) OVERRIDE;
 
@@ -59,6 +59,7 @@ class MockHost : public HttpPipelinedHost {
       NextProto protocol_negotiated));
   MOCK_METHOD0(CreateStreamOnExistingPipeline, HttpPipelinedStream*());
   MOCK_CONST_METHOD0(IsExistingPipelineAvailable, bool());
+  MOCK_CONST_METHOD0(GetDepthOfAvailablePipeline, int());
   MOCK_CONST_METHOD0(PipelineInfoToValue, base::Value*());
 
   virtual const Key& GetKey() const OVERRIDE { return key_; }
@@ -250,6 +251,12 @@ TEST_F(HttpPipelinedHostPoolTest, MultipleKeys) {
 
   EXPECT_FALSE(pool_->IsExistingPipelineAvailableForKey(key4));
 
+  EXPECT_CALL(*host1, GetDepthOfAvailablePipeline())
+      .Times(1)
+      .WillOnce(Return(2));
+  EXPECT_EQ(2, pool_->GetDepthOfAvailablePipelineForKey(key1));
+  EXPECT_EQ(-1, pool_->GetDepthOfAvailablePipelineForKey(key4));
+
   pool_->OnHostIdle(host1);
   pool_->OnHostIdle(host2);
   pool_->OnHostIdle(host3);
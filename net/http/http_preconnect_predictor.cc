@@ -0,0 +1,208 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_preconnect_predictor.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram.h"
+#include "net/base/load_flags.h"
+#include "net/http/http_network_session.h"
+#include "net/http/http_request_info.h"
+#include "net/http/http_server_properties.h"
+#include "net/http/http_stream_factory.h"
+#include "net/socket/client_socket_pool.h"
+#include "net/ssl/ssl_config_service.h"
+
+namespace net {
+
+HttpPreconnectPredictor::Request::Request(
+    const base::WeakPtr<HttpPreconnectPredictor>& predictor,
+    const HostPortPair& origin)
+    : predictor_(predictor),
+      origin_(origin) {
+}
+
+HttpPreconnectPredictor::Request::~Request() {
+  if (predictor_)
+    predictor_->OnRequestFinished(origin_);
+}
+
+HttpPreconnectPredictor::PageLoad::PageLoad()
+    : preconnected_sockets(0),
+      max_requests_in_flight(0) {
+}
+
+HttpPreconnectPredictor::HttpPreconnectPredictor(HttpNetworkSession* session)
+    : session_(session),
+      preconnected_sockets_(0),
+      hit_count_(0),
+      wasted_count_(0),
+      miss_count_(0),
+      weak_factory_(this) {
+  DCHECK(session_);
+}
+
+HttpPreconnectPredictor::~HttpPreconnectPredictor() {
+}
+
+scoped_ptr<HttpPreconnectPredictor::Request>
+HttpPreconnectPredictor::OnRequestStarted(const HttpRequestInfo& request_info,
+                                          RequestPriority priority,
+                                          const SSLConfig& server_ssl_config,
+                                          const SSLConfig& proxy_ssl_config) {
+  DCHECK(CalledOnValidThread());
+  if (!request_info.url.SchemeIsHTTPOrHTTPS())
+    return scoped_ptr<Request>();
+
+  HostPortPair origin = HostPortPair::FromURL(request_info.url);
+  if (request_info.load_flags & LOAD_MAIN_FRAME) {
+    StartPageLoad(origin, request_info, priority, server_ssl_config,
+                  proxy_ssl_config);
+  }
+
+  int in_flight = ++requests_in_flight_[origin];
+  PageLoadMap::iterator it = page_loads_.find(origin);
+  if (it != page_loads_.end() &&
+      in_flight > it->second.max_requests_in_flight) {
+    PageLoad& page_load = it->second;
+    if (in_flight == 2) {
+      page_load.time_to_first_request =
+          base::TimeTicks::Now() - page_load.start_time;
+    }
+    page_load.max_requests_in_flight = in_flight;
+  }
+
+  return scoped_ptr<Request>(new Request(weak_factory_.GetWeakPtr(), origin));
+}
+
+void HttpPreconnectPredictor::StartPageLoad(
+    const HostPortPair& origin,
+    const HttpRequestInfo& request_info,
+    RequestPriority priority,
+    const SSLConfig& server_ssl_config,
+    const SSLConfig& proxy_ssl_config) {
+  FinishPageLoad(origin);
+
+  PageLoad& page_load = page_loads_[origin];
+  page_load.start_time = base::TimeTicks::Now();
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&HttpPreconnectPredictor::OnPageLoadTimeout,
+                 weak_factory_.GetWeakPtr(), origin, page_load.start_time),
+      base::TimeDelta::FromSeconds(kPageLoadSeconds));
+
+  HttpServerProperties* http_server_properties =
+      session_->http_server_properties().get();
+  if (!http_server_properties || http_server_properties->SupportsSpdy(origin))
+    return;
+  const ConnectionHistory* history =
+      http_server_properties->GetConnectionHistory(origin);
+  if (!history || history->sockets_needed <= 1)
+    return;
+  // Sockets that would be closed for being idle before they are needed are
+  // not worth opening.
+  if (history->time_to_first_request >=
+          ClientSocketPool::unused_idle_socket_timeout()) {
+    return;
+  }
+
+  // The request that started the page load uses one of the sockets, so only
+  // the others count against the budget.
+  int num_sockets = std::min(history->sockets_needed, kMaxSocketsPerPageLoad);
+  num_sockets = std::min(num_sockets,
+                         1 + kMaxPreconnectedSockets - preconnected_sockets_);
+  if (num_sockets <= 1)
+    return;
+
+  HttpRequestInfo preconnect_info;
+  preconnect_info.url = request_info.url;
+  preconnect_info.method = "GET";
+  preconnect_info.load_flags = request_info.load_flags;
+  preconnect_info.privacy_mode = request_info.privacy_mode;
+  session_->http_stream_factory()->PreconnectStreams(
+      num_sockets, preconnect_info, priority, server_ssl_config,
+      proxy_ssl_config);
+
+  page_load.preconnected_sockets = num_sockets - 1;
+  preconnected_sockets_ += page_load.preconnected_sockets;
+}
+
+void HttpPreconnectPredictor::FinishPageLoad(const HostPortPair& origin) {
+  PageLoadMap::iterator it = page_loads_.find(origin);
+  if (it == page_loads_.end())
+    return;
+  PageLoad page_load = it->second;
+  page_loads_.erase(it);
+
+  preconnected_sockets_ -= page_load.preconnected_sockets;
+  DCHECK_GE(preconnected_sockets_, 0);
+
+  // The first request never waits for a preconnected socket.
+  int extra_sockets = std::max(page_load.max_requests_in_flight - 1, 0);
+  int used = std::min(page_load.preconnected_sockets, extra_sockets);
+  int unused = page_load.preconnected_sockets - used;
+  int missing = extra_sockets - used;
+  hit_count_ += used;
+  wasted_count_ += unused;
+  miss_count_ += missing;
+  UMA_HISTOGRAM_COUNTS_100("Net.LearnedPreconnect.UsedSockets", used);
+  UMA_HISTOGRAM_COUNTS_100("Net.LearnedPreconnect.UnusedSockets", unused);
+  UMA_HISTOGRAM_COUNTS_100("Net.LearnedPreconnect.MissingSockets", missing);
+
+  HttpServerProperties* http_server_properties =
+      session_->http_server_properties().get();
+  if (!http_server_properties)
+    return;
+
+  // SPDY servers need a single connection however many requests they get.
+  int sockets_needed = page_load.max_requests_in_flight;
+  if (http_server_properties->SupportsSpdy(origin))
+    sockets_needed = 1;
+
+  const ConnectionHistory* old_history =
+      http_server_properties->GetConnectionHistory(origin);
+  if (!old_history && sockets_needed <= 1)
+    return;
+
+  // Average with the previous page loads, so that a single unusual one does
+  // not change much.
+  ConnectionHistory history;
+  history.sockets_needed = sockets_needed;
+  history.time_to_first_request = page_load.time_to_first_request;
+  if (old_history) {
+    history.sockets_needed =
+        (old_history->sockets_needed + sockets_needed + 1) / 2;
+    if (old_history->sockets_needed > 1 && sockets_needed > 1) {
+      history.time_to_first_request =
+          (old_history->time_to_first_request +
+           page_load.time_to_first_request) / 2;
+    } else if (sockets_needed <= 1) {
+      history.time_to_first_request = old_history->time_to_first_request;
+    }
+  }
+  if (old_history && history.Equals(*old_history))
+    return;
+  http_server_properties->SetConnectionHistory(origin, history);
+}
+
+void HttpPreconnectPredictor::OnPageLoadTimeout(const HostPortPair& origin,
+                                                base::TimeTicks start_time) {
+  PageLoadMap::iterator it = page_loads_.find(origin);
+  if (it != page_loads_.end() && it->second.start_time == start_time)
+    FinishPageLoad(origin);
+}
+
+void HttpPreconnectPredictor::OnRequestFinished(const HostPortPair& origin) {
+  DCHECK(CalledOnValidThread());
+  RequestCountMap::iterator it = requests_in_flight_.find(origin);
+  DCHECK(it != requests_in_flight_.end());
+  if (--it->second == 0)
+    requests_in_flight_.erase(it);
+}
+
+}  // namespace net
@@ -0,0 +1,137 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_HTTP_HTTP_PRECONNECT_PREDICTOR_H_
+#define NET_HTTP_HTTP_PRECONNECT_PREDICTOR_H_
+
+#include <map>
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/threading/non_thread_safe.h"
+#include "base/time/time.h"
+#include "net/base/host_port_pair.h"
+#include "net/base/net_export.h"
+#include "net/base/request_priority.h"
+
+namespace net {
+
+class HttpNetworkSession;
+struct HttpRequestInfo;
+struct SSLConfig;
+
+// Learns how many connections each origin needs while one of its pages loads,
+// and opens that many connections as soon as the next page load from the
+// origin starts.
+//
+// A page load starts with a LOAD_MAIN_FRAME request, and is observed for
+// kPageLoadSeconds, or until the next page load from the same origin. The
+// largest number of requests to the origin in flight at once is the number
+// of connections it needed (one for SPDY servers), and it is saved with
+// HttpServerProperties together with the time it took for a second
+// connection to be needed. Connections are only opened ahead of time if they
+// would be used before the socket pools close them for being idle, and never
+// more than kMaxPreconnectedSockets are waiting to be used at once.
+class NET_EXPORT_PRIVATE HttpPreconnectPredictor
+    : NON_EXPORTED_BASE(public base::NonThreadSafe) {
+ public:
+  // Tracks a request from the time it starts until it is destroyed.
+  class NET_EXPORT_PRIVATE Request {
+   public:
+    ~Request();
+
+   private:
+    friend class HttpPreconnectPredictor;
+
+    Request(const base::WeakPtr<HttpPreconnectPredictor>& predictor,
+            const HostPortPair& origin);
+
+    base::WeakPtr<HttpPreconnectPredictor> predictor_;
+    const HostPortPair origin_;
+
+    DISALLOW_COPY_AND_ASSIGN(Request);
+  };
+
+  // The time a page load is observed for.
+  static const int kPageLoadSeconds = 30;
+
+  // The most connections that are opened ahead of time for a page load.
+  static const int kMaxSocketsPerPageLoad = 6;
+
+  // The most connections opened ahead of time for page loads that are still
+  // being observed.
+  static const int kMaxPreconnectedSockets = 16;
+
+  explicit HttpPreconnectPredictor(HttpNetworkSession* session);
+  ~HttpPreconnectPredictor();
+
+  // Called when a request starts. If it starts a page load, the connections
+  // the origin needed before are opened. The returned object has to be kept
+  // until the request is done.
+  scoped_ptr<Request> OnRequestStarted(const HttpRequestInfo& request_info,
+                                       RequestPriority priority,
+                                       const SSLConfig& server_ssl_config,
+                                       const SSLConfig& proxy_ssl_config);
+
+  // The number of connections opened ahead of time that were used, that were
+  // not used, and that were needed but not opened ahead of time, for the page
+  // loads observed so far.
+  int hit_count() const { return hit_count_; }
+  int wasted_count() const { return wasted_count_; }
+  int miss_count() const { return miss_count_; }
+
+ private:
+  struct PageLoad {
+    PageLoad();
+
+    base::TimeTicks start_time;
+    // The connections opened ahead of time.
+    int preconnected_sockets;
+    // The most requests that were in flight at once.
+    int max_requests_in_flight;
+    // The time until a second request was in flight, if any.
+    base::TimeDelta time_to_first_request;
+  };
+
+  typedef std::map<HostPortPair, PageLoad> PageLoadMap;
+  typedef std::map<HostPortPair, int> RequestCountMap;
+
+  // Starts observing a page load from |origin|, and opens the connections it
+  // is expected to need.
+  void StartPageLoad(const HostPortPair& origin,
+                     const HttpRequestInfo& request_info,
+                     RequestPriority priority,
+                     const SSLConfig& server_ssl_config,
+                     const SSLConfig& proxy_ssl_config);
+
+  // Records what the page load from |origin| needed.
+  void FinishPageLoad(const HostPortPair& origin);
+
+  void OnPageLoadTimeout(const HostPortPair& origin,
+                         base::TimeTicks start_time);
+
+  // Called when a Request is destroyed.
+  void OnRequestFinished(const HostPortPair& origin);
+
+  HttpNetworkSession* const session_;
+
+  RequestCountMap requests_in_flight_;
+  PageLoadMap page_loads_;
+
+  // The connections opened for the page loads in |page_loads_|.
+  int preconnected_sockets_;
+
+  int hit_count_;
+  int wasted_count_;
+  int miss_count_;
+
+  base::WeakPtrFactory<HttpPreconnectPredictor> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(HttpPreconnectPredictor);
+};
+
+}  // namespace net
+
+#endif  // NET_HTTP_HTTP_PRECONNECT_PREDICTOR_H_
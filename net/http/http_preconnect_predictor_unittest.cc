@@ -0,0 +1,213 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/http/http_preconnect_predictor.h"
+
+#include "base/memory/scoped_vector.h"
+#include "net/base/load_flags.h"
+#include "net/http/http_network_session.h"
+#include "net/http/http_network_session_peer.h"
+#include "net/http/http_request_info.h"
+#include "net/http/http_server_properties_impl.h"
+#include "net/http/http_stream_factory_impl.h"
+#include "net/proxy/proxy_service.h"
+#include "net/socket/client_socket_pool.h"
+#include "net/spdy/spdy_test_util_common.h"
+#include "net/ssl/ssl_config_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+// Records the preconnects instead of opening connections.
+class CapturePreconnectsHttpStreamFactory : public HttpStreamFactoryImpl {
+ public:
+  explicit CapturePreconnectsHttpStreamFactory(HttpNetworkSession* session)
+      : HttpStreamFactoryImpl(session, false),
+        num_preconnects_(0),
+        last_num_streams_(0) {}
+
+  virtual void PreconnectStreams(int num_streams,
+                                 const HttpRequestInfo& info,
+                                 RequestPriority priority,
+                                 const SSLConfig& server_ssl_config,
+                                 const SSLConfig& proxy_ssl_config) OVERRIDE {
+    ++num_preconnects_;
+    last_num_streams_ = num_streams;
+    last_url_ = info.url;
+  }
+
+  int num_preconnects() const { return num_preconnects_; }
+  int last_num_streams() const { return last_num_streams_; }
+  const GURL& last_url() const { return last_url_; }
+
+ private:
+  int num_preconnects_;
+  int last_num_streams_;
+  GURL last_url_;
+};
+
+class HttpPreconnectPredictorTest : public testing::Test {
+ protected:
+  HttpPreconnectPredictorTest()
+      : session_deps_(kProtoSPDY3, ProxyService::CreateDirect()),
+        session_(SpdySessionDependencies::SpdyCreateSession(&session_deps_)),
+        factory_(new CapturePreconnectsHttpStreamFactory(session_.get())),
+        predictor_(session_.get()) {
+    HttpNetworkSessionPeer peer(session_);
+    peer.SetHttpStreamFactory(scoped_ptr<HttpStreamFactory>(factory_));
+  }
+
+  // Starts a request for |url|, which is kept in |requests_| until
+  // FinishRequests() is called.
+  void StartRequest(const std::string& url, bool main_frame) {
+    HttpRequestInfo request_info;
+    request_info.method = "GET";
+    request_info.url = GURL(url);
+    if (main_frame)
+      request_info.load_flags = LOAD_MAIN_FRAME;
+    requests_.push_back(predictor_.OnRequestStarted(
+        request_info, DEFAULT_PRIORITY, SSLConfig(), SSLConfig()).release());
+  }
+
+  void FinishRequests() {
+    requests_.clear();
+  }
+
+  // Stores a history of |sockets_needed| connections for the origin of |url|.
+  void SetHistory(const std::string& url, int sockets_needed) {
+    ConnectionHistory history;
+    history.sockets_needed = sockets_needed;
+    history.time_to_first_request = base::TimeDelta::FromMilliseconds(100);
+    http_server_properties()->SetConnectionHistory(
+        HostPortPair::FromURL(GURL(url)), history);
+  }
+
+  HttpServerPropertiesImpl* http_server_properties() {
+    return &session_deps_.http_server_properties;
+  }
+
+  SpdySessionDependencies session_deps_;
+  scoped_refptr<HttpNetworkSession> session_;
+  CapturePreconnectsHttpStreamFactory* factory_;  // Owned by |session_|.
+  HttpPreconnectPredictor predictor_;
+  ScopedVector<HttpPreconnectPredictor::Request> requests_;
+};
+
+TEST_F(HttpPreconnectPredictorTest, LearnsSocketsNeeded) {
+  const HostPortPair origin("www.google.com", 80);
+
+  StartRequest("http://www.google.com/", true);
+  FinishRequests();
+  StartRequest("http://www.google.com/a.css", false);
+  StartRequest("http://www.google.com/b.js", false);
+  StartRequest("http://www.google.com/c.png", false);
+  FinishRequests();
+  EXPECT_EQ(0, factory_->num_preconnects());
+  EXPECT_EQ(NULL, http_server_properties()->GetConnectionHistory(origin));
+
+  // The next page load opens the connections the first one needed.
+  StartRequest("http://www.google.com/", true);
+  ASSERT_TRUE(http_server_properties()->GetConnectionHistory(origin));
+  EXPECT_EQ(3, http_server_properties()->GetConnectionHistory(origin)
+                   ->sockets_needed);
+  EXPECT_EQ(1, factory_->num_preconnects());
+  EXPECT_EQ(3, factory_->last_num_streams());
+  EXPECT_EQ(GURL("http://www.google.com/"), factory_->last_url());
+  EXPECT_EQ(2, predictor_.miss_count());
+  FinishRequests();
+
+  // Requests to other origins do not count.
+  StartRequest("http://www.example.com/a.png", false);
+  StartRequest("http://www.example.com/b.png", false);
+  StartRequest("http://www.google.com/a.css", false);
+  FinishRequests();
+
+  // The history is averaged with the new page load.
+  StartRequest("http://www.google.com/", true);
+  EXPECT_EQ(2, http_server_properties()->GetConnectionHistory(origin)
+                   ->sockets_needed);
+  EXPECT_EQ(2, predictor_.wasted_count());
+  EXPECT_EQ(2, factory_->num_preconnects());
+  EXPECT_EQ(2, factory_->last_num_streams());
+}
+
+TEST_F(HttpPreconnectPredictorTest, CountsHitsAndMisses) {
+  SetHistory("http://www.google.com/", 3);
+
+  StartRequest("http://www.google.com/", true);
+  EXPECT_EQ(3, factory_->last_num_streams());
+  StartRequest("http://www.google.com/a.css", false);
+  StartRequest("http://www.google.com/b.js", false);
+  StartRequest("http://www.google.com/c.png", false);
+  FinishRequests();
+
+  StartRequest("http://www.google.com/", true);
+  EXPECT_EQ(2, predictor_.hit_count());
+  EXPECT_EQ(0, predictor_.wasted_count());
+  EXPECT_EQ(1, predictor_.miss_count());
+}
+
+TEST_F(HttpPreconnectPredictorTest, LimitsPreconnectedSockets) {
+  SetHistory("http://a.com/", 10);
+  SetHistory("http://b.com/", 10);
+  SetHistory("http://c.com/", 10);
+  SetHistory("http://d.com/", 10);
+  SetHistory("http://e.com/", 10);
+
+  StartRequest("http://a.com/", true);
+  EXPECT_EQ(HttpPreconnectPredictor::kMaxSocketsPerPageLoad,
+            factory_->last_num_streams());
+  StartRequest("http://b.com/", true);
+  StartRequest("http://c.com/", true);
+  EXPECT_EQ(3, factory_->num_preconnects());
+
+  // Only one socket is left in the budget after three page loads.
+  StartRequest("http://d.com/", true);
+  EXPECT_EQ(4, factory_->num_preconnects());
+  EXPECT_EQ(2, factory_->last_num_streams());
+  StartRequest("http://e.com/", true);
+  EXPECT_EQ(4, factory_->num_preconnects());
+
+  // Finishing a page load gives its sockets back.
+  StartRequest("http://a.com/", true);
+  EXPECT_EQ(5, factory_->num_preconnects());
+  EXPECT_EQ(HttpPreconnectPredictor::kMaxSocketsPerPageLoad,
+            factory_->last_num_streams());
+}
+
+TEST_F(HttpPreconnectPredictorTest, NoPreconnectForSpdyServers) {
+  const HostPortPair origin("www.google.com", 443);
+  SetHistory("https://www.google.com/", 4);
+  http_server_properties()->SetSupportsSpdy(origin, true);
+
+  StartRequest("https://www.google.com/", true);
+  StartRequest("https://www.google.com/a.css", false);
+  StartRequest("https://www.google.com/b.js", false);
+  EXPECT_EQ(0, factory_->num_preconnects());
+  FinishRequests();
+
+  // The history learns that a single connection is enough.
+  StartRequest("https://www.google.com/", true);
+  EXPECT_EQ(3, http_server_properties()->GetConnectionHistory(origin)
+                   ->sockets_needed);
+}
+
+TEST_F(HttpPreconnectPredictorTest, NoPreconnectForIdleSockets) {
+  ConnectionHistory history;
+  history.sockets_needed = 4;
+  history.time_to_first_request =
+      ClientSocketPool::unused_idle_socket_timeout() +
+      base::TimeDelta::FromSeconds(1);
+  http_server_properties()->SetConnectionHistory(
+      HostPortPair("www.google.com", 80), history);
+
+  StartRequest("http://www.google.com/", true);
+  EXPECT_EQ(0, factory_->num_preconnects());
+}
+
+}  // namespace
+
+}  // namespace net
@@ -91,6 +91,9 @@ enum {
   // This bit is set if ssl_info has SCTs.
   RESPONSE_INFO_HAS_SIGNED_CERTIFICATE_TIMESTAMPS = 1 << 20,
 
+  // This bit is set if the HTTP cache stored the response body compressed.
+  RESPONSE_INFO_BODY_COMPRESSED_IN_CACHE = 1 << 21,
+
   // TODO(darin): Add other bits to indicate alternate request methods.
   // For now, we don't support storing those.
 };
@@ -103,6 +106,7 @@ HttpResponseInfo::HttpResponseInfo()
       was_npn_negotiated(false),
       was_fetched_via_proxy(false),
       did_use_http_auth(false),
+      body_compressed_in_cache(false),
       connection_info(CONNECTION_INFO_UNKNOWN) {
 }
 
@@ -114,6 +118,7 @@ HttpResponseInfo::HttpResponseInfo(const HttpResponseInfo& rhs)
       was_npn_negotiated(rhs.was_npn_negotiated),
       was_fetched_via_proxy(rhs.was_fetched_via_proxy),
       did_use_http_auth(rhs.did_use_http_auth),
+      body_compressed_in_cache(rhs.body_compressed_in_cache),
       socket_address(rhs.socket_address),
       npn_negotiated_protocol(rhs.npn_negotiated_protocol),
       connection_info(rhs.connection_info),
@@ -138,6 +143,7 @@ HttpResponseInfo& HttpResponseInfo::operator=(const HttpResponseInfo& rhs) {
   was_npn_negotiated = rhs.was_npn_negotiated;
   was_fetched_via_proxy = rhs.was_fetched_via_proxy;
   did_use_http_auth = rhs.did_use_http_auth;
+  body_compressed_in_cache = rhs.body_compressed_in_cache;
   socket_address = rhs.socket_address;
   npn_negotiated_protocol = rhs.npn_negotiated_protocol;
   connection_info = rhs.connection_info;
@@ -275,6 +281,9 @@ bool HttpResponseInfo::InitFromPickle(const Pickle& pickle,
 
   did_use_http_auth = (flags & RESPONSE_INFO_USE_HTTP_AUTHENTICATION) != 0;
 
+  body_compressed_in_cache =
+      (flags & RESPONSE_INFO_BODY_COMPRESSED_IN_CACHE) != 0;
+
   return true;
 }
 
@@ -308,6 +317,8 @@ void HttpResponseInfo::Persist(Pickle* pickle,
     flags |= RESPONSE_INFO_USE_HTTP_AUTHENTICATION;
   if (!ssl_info.signed_certificate_timestamps.empty())
     flags |= RESPONSE_INFO_HAS_SIGNED_CERTIFICATE_TIMESTAMPS;
+  if (body_compressed_in_cache)
+    flags |= RESPONSE_INFO_BODY_COMPRESSED_IN_CACHE;
 
   pickle->WriteInt(flags);
   pickle->WriteInt64(request_time.ToInternalValue());
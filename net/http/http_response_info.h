@@ -92,6 +92,10 @@ class NET_EXPORT HttpResponseInfo {
   // Whether the request use http proxy or server authentication.
   bool did_use_http_auth;
 
+  // True if the HTTP cache stores the body of this response compressed. This
+  // describes the cache entry only; the body is never compressed when read.
+  bool body_compressed_in_cache;
+
   // Remote address of the socket which fetched this resource.
   //
   // NOTE: If the response was served from the cache (was_cached is true),
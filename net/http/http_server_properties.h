@@ -10,6 +10,7 @@
 #include "base/basictypes.h"
 #include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
+#include "net/base/address_family.h"
 #include "net/base/host_port_pair.h"
 #include "net/base/net_export.h"
 #include "net/http/http_pipelined_host_capability.h"
@@ -62,10 +63,27 @@ struct NET_EXPORT PortAlternateProtocolPair {
   AlternateProtocol protocol;
 };
 
+// How many connections a server needed while a page from it was loaded.
+struct NET_EXPORT ConnectionHistory {
+  ConnectionHistory() : sockets_needed(0) {}
+
+  bool Equals(const ConnectionHistory& other) const {
+    return sockets_needed == other.sockets_needed &&
+        time_to_first_request == other.time_to_first_request;
+  }
+
+  // The number of requests to the server that were in flight at once.
+  int sockets_needed;
+  // The time from the start of the page load until more than one connection
+  // was needed.
+  base::TimeDelta time_to_first_request;
+};
+
 typedef std::map<HostPortPair, PortAlternateProtocolPair> AlternateProtocolMap;
 typedef std::map<HostPortPair, SettingsMap> SpdySettingsMap;
 typedef std::map<HostPortPair,
         HttpPipelinedHostCapability> PipelineCapabilityMap;
+typedef std::map<HostPortPair, ConnectionHistory> ConnectionHistoryMap;
 
 extern const char kAlternateProtocolHeader[];
 
@@ -74,6 +92,8 @@ extern const char kAlternateProtocolHeader[];
 // * SPDY support (based on NPN results)
 // * Alternate-Protocol support
 // * Spdy Settings (like CWND ID field)
+// * The address family that connects first
+// * The number of connections used to load pages from it
 class NET_EXPORT HttpServerProperties {
  public:
   struct NetworkStats {
@@ -144,6 +164,16 @@ class NET_EXPORT HttpServerProperties {
   virtual const NetworkStats* GetServerNetworkStats(
       const HostPortPair& host_port_pair) const = 0;
 
+  // Records the address family of the connection that won the last race
+  // between the IPv4 and IPv6 addresses of |host_port_pair|.
+  virtual void SetPreferredAddressFamily(const HostPortPair& host_port_pair,
+                                         AddressFamily address_family) = 0;
+
+  // Returns ADDRESS_FAMILY_UNSPECIFIED if no race to |host_port_pair| is
+  // known.
+  virtual AddressFamily GetPreferredAddressFamily(
+      const HostPortPair& host_port_pair) const = 0;
+
   virtual HttpPipelinedHostCapability GetPipelineCapability(
       const HostPortPair& origin) = 0;
 
@@ -155,6 +185,18 @@ class NET_EXPORT HttpServerProperties {
 
   virtual PipelineCapabilityMap GetPipelineCapabilityMap() const = 0;
 
+  // Returns the connections |origin| needed the last times a page was loaded
+  // from it, or NULL if that is not known.
+  virtual const ConnectionHistory* GetConnectionHistory(
+      const HostPortPair& origin) = 0;
+
+  virtual void SetConnectionHistory(const HostPortPair& origin,
+                                    const ConnectionHistory& history) = 0;
+
+  virtual void ClearConnectionHistory() = 0;
+
+  virtual ConnectionHistoryMap GetConnectionHistoryMap() const = 0;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(HttpServerProperties);
 };
@@ -21,6 +21,8 @@ static const int kDefaultNumHostsToRemember = 200;
 HttpServerPropertiesImpl::HttpServerPropertiesImpl()
     : pipeline_capability_map_(
         new CachedPipelineCapabilityMap(kDefaultNumHostsToRemember)),
+      preferred_address_family_map_(kDefaultNumHostsToRemember),
+      connection_history_map_(kDefaultNumHostsToRemember),
       weak_ptr_factory_(this) {
   canoncial_suffixes_.push_back(".c.youtube.com");
   canoncial_suffixes_.push_back(".googlevideo.com");
@@ -94,6 +96,16 @@ void HttpServerPropertiesImpl::InitializePipelineCapabilities(
   }
 }
 
+void HttpServerPropertiesImpl::InitializeConnectionHistory(
+    const ConnectionHistoryMap* connection_history_map) {
+  connection_history_map_.Clear();
+  for (ConnectionHistoryMap::const_iterator it =
+           connection_history_map->begin();
+       it != connection_history_map->end(); ++it) {
+    connection_history_map_.Put(it->first, it->second);
+  }
+}
+
 void HttpServerPropertiesImpl::SetNumPipelinedHostsToRemember(int max_size) {
   DCHECK(pipeline_capability_map_->empty());
   pipeline_capability_map_.reset(new CachedPipelineCapabilityMap(max_size));
@@ -150,6 +162,8 @@ void HttpServerPropertiesImpl::Clear() {
   alternate_protocol_map_.clear();
   spdy_settings_map_.clear();
   pipeline_capability_map_->Clear();
+  preferred_address_family_map_.Clear();
+  connection_history_map_.Clear();
 }
 
 bool HttpServerPropertiesImpl::SupportsSpdy(
@@ -326,6 +340,21 @@ HttpServerPropertiesImpl::GetServerNetworkStats(
   return &it->second;
 }
 
+void HttpServerPropertiesImpl::SetPreferredAddressFamily(
+    const HostPortPair& host_port_pair,
+    AddressFamily address_family) {
+  preferred_address_family_map_.Put(host_port_pair, address_family);
+}
+
+AddressFamily HttpServerPropertiesImpl::GetPreferredAddressFamily(
+    const HostPortPair& host_port_pair) const {
+  CachedAddressFamilyMap::const_iterator it =
+      preferred_address_family_map_.Peek(host_port_pair);
+  if (it == preferred_address_family_map_.end())
+    return ADDRESS_FAMILY_UNSPECIFIED;
+  return it->second;
+}
+
 HttpPipelinedHostCapability HttpServerPropertiesImpl::GetPipelineCapability(
     const HostPortPair& origin) {
   HttpPipelinedHostCapability capability = PIPELINE_UNKNOWN;
@@ -363,6 +392,35 @@ HttpServerPropertiesImpl::GetPipelineCapabilityMap() const {
   return result;
 }
 
+const ConnectionHistory* HttpServerPropertiesImpl::GetConnectionHistory(
+    const HostPortPair& origin) {
+  CachedConnectionHistoryMap::iterator it = connection_history_map_.Get(origin);
+  if (it == connection_history_map_.end())
+    return NULL;
+  return &it->second;
+}
+
+void HttpServerPropertiesImpl::SetConnectionHistory(
+    const HostPortPair& origin,
+    const ConnectionHistory& history) {
+  connection_history_map_.Put(origin, history);
+}
+
+void HttpServerPropertiesImpl::ClearConnectionHistory() {
+  connection_history_map_.Clear();
+}
+
+ConnectionHistoryMap
+HttpServerPropertiesImpl::GetConnectionHistoryMap() const {
+  ConnectionHistoryMap result;
+  CachedConnectionHistoryMap::const_iterator it;
+  for (it = connection_history_map_.begin();
+       it != connection_history_map_.end(); ++it) {
+    result[it->first] = it->second;
+  }
+  return result;
+}
+
 HttpServerPropertiesImpl::CanonicalHostMap::const_iterator
 HttpServerPropertiesImpl::GetCanonicalHost(HostPortPair server) const {
   for (size_t i = 0; i < canoncial_suffixes_.size(); ++i) {
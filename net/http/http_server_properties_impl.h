@@ -49,6 +49,11 @@ class NET_EXPORT HttpServerPropertiesImpl
   void InitializePipelineCapabilities(
       const PipelineCapabilityMap* pipeline_capability_map);
 
+  // Initializes |connection_history_map_| with the servers (host/port) from
+  // |connection_history_map|.
+  void InitializeConnectionHistory(
+      const ConnectionHistoryMap* connection_history_map);
+
   // Get the list of servers (host/port) that support SPDY.
   void GetSpdyServerList(base::ListValue* spdy_server_list) const;
 
@@ -133,6 +138,13 @@ class NET_EXPORT HttpServerPropertiesImpl
   virtual const NetworkStats* GetServerNetworkStats(
       const HostPortPair& host_port_pair) const OVERRIDE;
 
+  virtual void SetPreferredAddressFamily(
+      const HostPortPair& host_port_pair,
+      AddressFamily address_family) OVERRIDE;
+
+  virtual AddressFamily GetPreferredAddressFamily(
+      const HostPortPair& host_port_pair) const OVERRIDE;
+
   virtual HttpPipelinedHostCapability GetPipelineCapability(
       const HostPortPair& origin) OVERRIDE;
 
@@ -144,13 +156,28 @@ class NET_EXPORT HttpServerPropertiesImpl
 
   virtual PipelineCapabilityMap GetPipelineCapabilityMap() const OVERRIDE;
 
+  virtual const ConnectionHistory* GetConnectionHistory(
+      const HostPortPair& origin) OVERRIDE;
+
+  virtual void SetConnectionHistory(
+      const HostPortPair& origin,
+      const ConnectionHistory& history) OVERRIDE;
+
+  virtual void ClearConnectionHistory() OVERRIDE;
+
+  virtual ConnectionHistoryMap GetConnectionHistoryMap() const OVERRIDE;
+
  private:
   typedef base::MRUCache<
       HostPortPair, HttpPipelinedHostCapability> CachedPipelineCapabilityMap;
+  typedef base::MRUCache<
+      HostPortPair, ConnectionHistory> CachedConnectionHistoryMap;
   // |spdy_servers_table_| has flattened representation of servers (host/port
   // pair) that either support or not support SPDY protocol.
   typedef base::hash_map<std::string, bool> SpdyServerHostPortTable;
   typedef std::map<HostPortPair, NetworkStats> ServerNetworkStatsMap;
+  typedef base::MRUCache<
+      HostPortPair, AddressFamily> CachedAddressFamilyMap;
   typedef std::map<HostPortPair, HostPortPair> CanonicalHostMap;
   typedef std::vector<std::string> CanonicalSufficList;
 
@@ -163,6 +190,8 @@ class NET_EXPORT HttpServerPropertiesImpl
   SpdySettingsMap spdy_settings_map_;
   ServerNetworkStatsMap server_network_stats_map_;
   scoped_ptr<CachedPipelineCapabilityMap> pipeline_capability_map_;
+  CachedAddressFamilyMap preferred_address_family_map_;
+  CachedConnectionHistoryMap connection_history_map_;
   // Contains a map of servers which could share the same alternate protocol.
   // Map from a Canonical host/port (host is some postfix of host names) to an
   // actual origin, which has a plausible alternate protocol mapping.
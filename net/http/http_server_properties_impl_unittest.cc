@@ -433,6 +433,42 @@ TEST_F(SpdySettingsServerPropertiesTest, Clear) {
   EXPECT_EQ(0U, impl_.GetSpdySettings(spdy_server_docs).size());
 }
 
+typedef HttpServerPropertiesImplTest ConnectionHistoryServerPropertiesTest;
+
+TEST_F(ConnectionHistoryServerPropertiesTest, Basic) {
+  HostPortPair server("www.google.com", 80);
+  EXPECT_EQ(NULL, impl_.GetConnectionHistory(server));
+
+  ConnectionHistory history;
+  history.sockets_needed = 4;
+  history.time_to_first_request = base::TimeDelta::FromMilliseconds(150);
+  impl_.SetConnectionHistory(server, history);
+  const ConnectionHistory* history_ret = impl_.GetConnectionHistory(server);
+  ASSERT_TRUE(history_ret);
+  EXPECT_TRUE(history.Equals(*history_ret));
+  EXPECT_EQ(1U, impl_.GetConnectionHistoryMap().size());
+
+  impl_.Clear();
+  EXPECT_EQ(NULL, impl_.GetConnectionHistory(server));
+}
+
+TEST_F(ConnectionHistoryServerPropertiesTest, Initialize) {
+  HostPortPair server1("foo", 80);
+  HostPortPair server2("bar", 443);
+  ConnectionHistory history;
+  history.sockets_needed = 2;
+  impl_.SetConnectionHistory(server1, history);
+
+  ConnectionHistoryMap connection_history_map;
+  history.sockets_needed = 6;
+  connection_history_map[server2] = history;
+  impl_.InitializeConnectionHistory(&connection_history_map);
+
+  EXPECT_EQ(NULL, impl_.GetConnectionHistory(server1));
+  ASSERT_TRUE(impl_.GetConnectionHistory(server2));
+  EXPECT_EQ(6, impl_.GetConnectionHistory(server2)->sockets_needed);
+}
+
 }  // namespace
 
 }  // namespace net
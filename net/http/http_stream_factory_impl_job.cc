@@ -37,6 +37,7 @@
 #include "net/socket/socks_client_socket_pool.h"
 #include "net/socket/ssl_client_socket.h"
 #include "net/socket/ssl_client_socket_pool.h"
+#include "net/socket/transport_client_socket_pool.h"
 #include "net/spdy/spdy_http_stream.h"
 #include "net/spdy/spdy_session.h"
 #include "net/spdy/spdy_session_pool.h"
@@ -73,6 +74,20 @@ base::Value* NetLogHttpStreamProtoCallback(
   return dict;
 }
 
+// Returns parameters associated with the choice between an existing pipeline
+// and an idle socket.
+base::Value* NetLogHttpStreamPipelineDecisionCallback(
+    int pipeline_depth,
+    int idle_socket_count,
+    bool use_idle_socket,
+    NetLog::LogLevel /* log_level */) {
+  base::DictionaryValue* dict = new base::DictionaryValue();
+  dict->SetInteger("pipeline_depth", pipeline_depth);
+  dict->SetInteger("idle_socket_count", idle_socket_count);
+  dict->SetBoolean("use_idle_socket", use_idle_socket);
+  return dict;
+}
+
 HttpStreamFactoryImpl::Job::Job(HttpStreamFactoryImpl* stream_factory,
                                 HttpNetworkSession* session,
                                 const HttpRequestInfo& request_info,
@@ -107,6 +122,7 @@ HttpStreamFactoryImpl::Job::Job(HttpStreamFactoryImpl* stream_factory,
       num_streams_(0),
       spdy_session_direct_(false),
       existing_available_pipeline_(false),
+      use_idle_socket_over_pipeline_(false),
       ptr_factory_(this) {
   DCHECK(stream_factory);
   DCHECK(session);
@@ -802,6 +818,10 @@ int HttpStreamFactoryImpl::Job::DoInitConnection() {
     // between when a pipeline becomes available and when this job blocks.
     existing_available_pipeline_ = stream_factory_->http_pipelined_host_pool_.
         IsExistingPipelineAvailableForKey(*http_pipelining_key_.get());
+    if (existing_available_pipeline_ && ShouldUseIdleSocketOverPipeline()) {
+      existing_available_pipeline_ = false;
+      use_idle_socket_over_pipeline_ = true;
+    }
     if (existing_available_pipeline_) {
       return OK;
     } else {
@@ -1066,7 +1086,8 @@ int HttpStreamFactoryImpl::Job::DoCreateStream() {
     bool using_proxy = (proxy_info_.is_http() || proxy_info_.is_https()) &&
                        (request_info_.url.SchemeIs("http") ||
                         request_info_.url.SchemeIs("ftp"));
-    if (stream_factory_->http_pipelined_host_pool_.
+    if (!use_idle_socket_over_pipeline_ &&
+        stream_factory_->http_pipelined_host_pool_.
             IsExistingPipelineAvailableForKey(*http_pipelining_key_.get())) {
       DCHECK(!stream_factory_->for_websockets_);
       stream_.reset(stream_factory_->http_pipelined_host_pool_.
@@ -1482,4 +1503,29 @@ bool HttpStreamFactoryImpl::Job::IsRequestEligibleForPipelining() {
       *http_pipelining_key_.get());
 }
 
+bool HttpStreamFactoryImpl::Job::ShouldUseIdleSocketOverPipeline() {
+  // A forced pipeline is the only connection to the host.
+  if (session_->force_http_pipelining() || !proxy_info_.is_direct())
+    return false;
+
+  int pipeline_depth = stream_factory_->http_pipelined_host_pool_.
+      GetDepthOfAvailablePipelineForKey(*http_pipelining_key_.get());
+  std::string group_name = origin_.ToString();
+  if (request_info_.privacy_mode == kPrivacyModeEnabled)
+    group_name = "pm/" + group_name;
+  int idle_socket_count =
+      session_->GetTransportSocketPool(
+          HttpNetworkSession::NORMAL_SOCKET_POOL)->IdleSocketCountInGroup(
+              group_name);
+
+  // A request sent on a busy pipeline waits for every response ahead of it,
+  // while an idle socket can send it right away.
+  bool use_idle_socket = pipeline_depth > 0 && idle_socket_count > 0;
+  net_log_.AddEvent(
+      NetLog::TYPE_HTTP_STREAM_JOB_PIPELINE_DECISION,
+      base::Bind(&NetLogHttpStreamPipelineDecisionCallback,
+                 pipeline_depth, idle_socket_count, use_idle_socket));
+  return use_idle_socket;
+}
+
 }  // namespace net
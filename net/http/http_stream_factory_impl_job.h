@@ -218,6 +218,11 @@ class HttpStreamFactoryImpl::Job {
 
   bool IsRequestEligibleForPipelining();
 
+  // Returns true if the request should be sent on an idle socket rather than
+  // queued on the existing pipeline, which already has requests in flight.
+  // Logs the decision.
+  bool ShouldUseIdleSocketOverPipeline();
+
   // Record histograms of latency until Connect() completes.
   static void LogHttpConnectedMetrics(const ClientSocketHandle& handle);
 
@@ -324,6 +329,9 @@ class HttpStreamFactoryImpl::Job {
   // True if an existing pipeline can handle this job's request.
   bool existing_available_pipeline_;
 
+  // True if an idle socket was chosen over the existing pipeline.
+  bool use_idle_socket_over_pipeline_;
+
   base::WeakPtrFactory<Job> ptr_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(Job);
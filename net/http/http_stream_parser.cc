@@ -4,9 +4,14 @@
 
 #include "net/http/http_stream_parser.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/bind.h"
 #include "base/compiler_specific.h"
+#include "base/lazy_instance.h"
 #include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
 #include "base/values.h"
 #include "net/base/io_buffer.h"
 #include "net/base/ip_endpoint.h"
@@ -24,6 +29,40 @@ namespace {
 const size_t kMaxMergedHeaderAndBodySize = 1400;
 const size_t kRequestBodyBufferSize = 1 << 14;  // 16KB
 
+// The most read buffers kept for reuse.
+const size_t kMaxPooledReadBuffers = 32;
+
+// Keeps the read buffers of streams that are done, so that new streams do not
+// have to allocate them.
+class ReadBufferPool {
+ public:
+  scoped_refptr<net::GrowableIOBuffer> Take() {
+    base::AutoLock locked(lock_);
+    if (buffers_.empty())
+      return new net::GrowableIOBuffer();
+    scoped_refptr<net::GrowableIOBuffer> buffer = buffers_.back();
+    buffers_.pop_back();
+    return buffer;
+  }
+
+  void Recycle(net::GrowableIOBuffer* buffer) {
+    buffer->set_offset(0);
+    // Buffers that grew for large headers are not kept at their full size.
+    if (buffer->capacity() != net::HttpStreamParser::kHeaderBufInitialSize)
+      buffer->SetCapacity(net::HttpStreamParser::kHeaderBufInitialSize);
+    base::AutoLock locked(lock_);
+    if (buffers_.size() < kMaxPooledReadBuffers)
+      buffers_.push_back(buffer);
+  }
+
+ private:
+  base::Lock lock_;
+  std::vector<scoped_refptr<net::GrowableIOBuffer> > buffers_;
+};
+
+base::LazyInstance<ReadBufferPool>::Leaky g_read_buffer_pool =
+    LAZY_INSTANCE_INITIALIZER;
+
 std::string GetResponseHeaderLines(const net::HttpResponseHeaders& headers) {
   std::string raw_headers = headers.raw_headers();
   const char* null_separated_headers = raw_headers.c_str();
@@ -195,6 +234,17 @@ HttpStreamParser::HttpStreamParser(ClientSocketHandle* connection,
 HttpStreamParser::~HttpStreamParser() {
 }
 
+// static
+scoped_refptr<GrowableIOBuffer> HttpStreamParser::TakeReadBuffer() {
+  return g_read_buffer_pool.Get().Take();
+}
+
+// static
+void HttpStreamParser::RecycleReadBuffer(GrowableIOBuffer* buffer) {
+  if (buffer->HasOneRef())
+    g_read_buffer_pool.Get().Recycle(buffer);
+}
+
 int HttpStreamParser::SendRequest(const std::string& request_line,
                                   const HttpRequestHeaders& headers,
                                   HttpResponseInfo* response,
@@ -506,9 +556,13 @@ int HttpStreamParser::DoSendRequestReadingBody(int result) {
 int HttpStreamParser::DoReadHeaders() {
   io_state_ = STATE_READ_HEADERS_COMPLETE;
 
-  // Grow the read buffer if necessary.
-  if (read_buf_->RemainingCapacity() == 0)
-    read_buf_->SetCapacity(read_buf_->capacity() + kHeaderBufInitialSize);
+  // Grow the read buffer if necessary. Doubling it keeps the cost of copying
+  // the headers already read linear in their size.
+  if (read_buf_->RemainingCapacity() == 0) {
+    read_buf_->SetCapacity(
+        std::min(std::max(2 * read_buf_->capacity(), kHeaderBufInitialSize),
+                 kMaxHeaderBufSize));
+  }
 
   // http://crbug.com/16371: We're seeing |user_buf_->data()| return NULL.
   // See if the user is passing in an IOBuffer with a NULL |data_|.
@@ -639,12 +693,12 @@ int HttpStreamParser::DoReadBody() {
              bytes_from_buffer);
       read_buf_unused_offset_ += bytes_from_buffer;
       if (bytes_from_buffer == available) {
-        read_buf_->SetCapacity(0);
+        read_buf_->set_offset(0);
         read_buf_unused_offset_ = 0;
       }
       return bytes_from_buffer;
     } else {
-      read_buf_->SetCapacity(0);
+      read_buf_->set_offset(0);
       read_buf_unused_offset_ = 0;
     }
   }
@@ -101,9 +101,21 @@ class NET_EXPORT_PRIVATE HttpStreamParser {
       const std::string& request_headers,
       const UploadDataStream* request_body);
 
+  // Returns an empty buffer to be passed to the constructor, recycled from a
+  // stream that is done with it when possible.
+  static scoped_refptr<GrowableIOBuffer> TakeReadBuffer();
+
+  // Keeps |buffer| for a later TakeReadBuffer() call, unless something else
+  // still references it. Any data in it is dropped.
+  static void RecycleReadBuffer(GrowableIOBuffer* buffer);
+
   // The number of extra bytes required to encode a chunk.
   static const size_t kChunkHeaderFooterSize;
 
+  // The initial size of the header buffer. It is doubled each time it reaches
+  // capacity.
+  static const int kHeaderBufInitialSize = 4 * 1024;  // 4K
+
  private:
   class SeekableIOBuffer;
 
@@ -126,14 +138,11 @@ class NET_EXPORT_PRIVATE HttpStreamParser {
     STATE_DONE
   };
 
-  // The number of bytes by which the header buffer is grown when it reaches
-  // capacity.
-  static const int kHeaderBufInitialSize = 4 * 1024;  // 4K
-
   // |kMaxHeaderBufSize| is the number of bytes that the response headers can
   // grow to. If the body start is not found within this range of the
   // response, the transaction will fail with ERR_RESPONSE_HEADERS_TOO_BIG.
-  // Note: |kMaxHeaderBufSize| should be a multiple of |kHeaderBufInitialSize|.
+  // Note: |kMaxHeaderBufSize| should be |kHeaderBufInitialSize| times a power
+  // of two.
   static const int kMaxHeaderBufSize = kHeaderBufInitialSize * 64;  // 256K
 
   // The maximum sane buffer size.
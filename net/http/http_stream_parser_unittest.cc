@@ -804,6 +804,27 @@ TEST(HttpStreamParser, ReceivedBytesIncludesContinueHeader) {
   EXPECT_EQ(response_size, get_runner.parser()->received_bytes());
 }
 
+TEST(HttpStreamParser, RecycleReadBuffer) {
+  scoped_refptr<GrowableIOBuffer> buffer = HttpStreamParser::TakeReadBuffer();
+  buffer->SetCapacity(HttpStreamParser::kHeaderBufInitialSize * 4);
+  buffer->set_offset(10);
+  GrowableIOBuffer* raw_buffer = buffer.get();
+  HttpStreamParser::RecycleReadBuffer(buffer.get());
+  buffer = NULL;
+
+  // The buffer is reused empty, at its initial size.
+  buffer = HttpStreamParser::TakeReadBuffer();
+  EXPECT_EQ(raw_buffer, buffer.get());
+  EXPECT_EQ(0, buffer->offset());
+  EXPECT_EQ(HttpStreamParser::kHeaderBufInitialSize, buffer->capacity());
+
+  // Buffers that are still referenced elsewhere are not reused.
+  scoped_refptr<GrowableIOBuffer> other_reference = buffer;
+  HttpStreamParser::RecycleReadBuffer(buffer.get());
+  buffer = HttpStreamParser::TakeReadBuffer();
+  EXPECT_NE(raw_buffer, buffer.get());
+}
+
 }  // namespace
 
 }  // namespace net
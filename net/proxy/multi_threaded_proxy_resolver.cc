@@ -393,7 +393,8 @@ MultiThreadedProxyResolver::MultiThreadedProxyResolver(
     size_t max_num_threads)
     : ProxyResolver(resolver_factory->resolvers_expect_pac_bytes()),
       resolver_factory_(resolver_factory),
-      max_num_threads_(max_num_threads) {
+      max_num_threads_(max_num_threads),
+      num_prewarmed_threads_(0) {
   DCHECK_GE(max_num_threads, 1u);
 }
 
@@ -511,7 +512,10 @@ int MultiThreadedProxyResolver::SetPacScript(
   // Provision a new executor, and run the SetPacScript request. On completion
   // notification will be sent through |callback|.
   Executor* executor = AddNewExecutor();
-  executor->StartJob(new SetPacScriptJob(script_data, callback));
+  executor->StartJob(new SetPacScriptJob(
+      script_data,
+      base::Bind(&MultiThreadedProxyResolver::OnSetPacScriptComplete,
+                 base::Unretained(this), callback)));
   return ERR_IO_PENDING;
 }
 
@@ -580,4 +584,20 @@ void MultiThreadedProxyResolver::OnExecutorReady(Executor* executor) {
   executor->StartJob(job.get());
 }
 
+void MultiThreadedProxyResolver::OnSetPacScriptComplete(
+    const CompletionCallback& callback,
+    int result) {
+  DCHECK(CalledOnValidThread());
+  if (result == OK) {
+    // The script is known to work, so initialize the remaining threads now
+    // instead of while requests are waiting for them.
+    while (executors_.size() < num_prewarmed_threads_) {
+      Executor* executor = AddNewExecutor();
+      executor->StartJob(
+          new SetPacScriptJob(current_script_data_, CompletionCallback()));
+    }
+  }
+  callback.Run(result);
+}
+
 }  // namespace net
@@ -5,6 +5,7 @@
 #ifndef NET_PROXY_MULTI_THREADED_PROXY_RESOLVER_H_
 #define NET_PROXY_MULTI_THREADED_PROXY_RESOLVER_H_
 
+#include <algorithm>
 #include <deque>
 #include <vector>
 
@@ -48,6 +49,8 @@ class ProxyResolverFactory {
 // Threads are created lazily on demand, up to a maximum total. The advantage
 // of having a pool of threads, is faster performance. In particular, being
 // able to keep servicing PAC requests even if one blocks its execution.
+// Optionally some of the threads are instead created as soon as the script
+// has been set (see set_num_prewarmed_threads()).
 //
 // During initialization (SetPacScript), a single thread is spun up to test
 // the script. If this succeeds, we cache the input script, and will re-use
@@ -90,6 +93,15 @@ class NET_EXPORT_PRIVATE MultiThreadedProxyResolver
 
   virtual ~MultiThreadedProxyResolver();
 
+  // Sets the number of threads which are provisioned as soon as a PAC script
+  // has been set successfully, rather than once requests are queued waiting
+  // for one. Provisioning a thread means creating a new script context and
+  // running the PAC script in it, which is slow for large scripts. Capped at
+  // the maximum number of threads; zero (the default) disables prewarming.
+  void set_num_prewarmed_threads(size_t num_threads) {
+    num_prewarmed_threads_ = std::min(num_threads, max_num_threads_);
+  }
+
   // ProxyResolver implementation:
   virtual int GetProxyForURL(const GURL& url,
                              ProxyInfo* results,
@@ -131,8 +143,13 @@ class NET_EXPORT_PRIVATE MultiThreadedProxyResolver
   // Starts the next job from |pending_jobs_| if possible.
   void OnExecutorReady(Executor* executor);
 
+  // Completion of a user-initiated SetPacScript(). Prewarms threads if the
+  // script was set successfully, then runs |callback|.
+  void OnSetPacScriptComplete(const CompletionCallback& callback, int result);
+
   const scoped_ptr<ProxyResolverFactory> resolver_factory_;
   const size_t max_num_threads_;
+  size_t num_prewarmed_threads_;
   PendingJobsQueue pending_jobs_;
   ExecutorList executors_;
   scoped_refptr<ProxyResolverScriptData> current_script_data_;
@@ -783,6 +783,40 @@ TEST(MultiThreadedProxyResolverTest, OneThreadBlocked) {
   EXPECT_EQ(3, factory->resolvers()[1]->request_count());
 }
 
+// Tests that prewarmed threads are provisioned, and given the script, as soon
+// as SetPacScript() succeeds.
+TEST(MultiThreadedProxyResolverTest, PrewarmedThreads) {
+  const size_t kNumThreads = 3u;
+  BlockableProxyResolverFactory* factory = new BlockableProxyResolverFactory;
+  MultiThreadedProxyResolver resolver(factory, kNumThreads);
+  resolver.set_num_prewarmed_threads(kNumThreads);
+
+  TestCompletionCallback set_script_callback;
+  int rv = resolver.SetPacScript(
+      ProxyResolverScriptData::FromUTF8("pac script bytes"),
+      set_script_callback.callback());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, set_script_callback.WaitForResult());
+  // All of the threads have been provisioned without any request.
+  ASSERT_EQ(3u, factory->resolvers().size());
+
+  // Call SetPacScript again, solely to stop the current worker threads so that
+  // the values seen by their resolvers can be checked without racing.
+  TestCompletionCallback set_script_callback2;
+  rv = resolver.SetPacScript(ProxyResolverScriptData::FromUTF8("xyz"),
+                             set_script_callback2.callback());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, set_script_callback2.WaitForResult());
+  ASSERT_EQ(6u, factory->resolvers().size());
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(
+        ASCIIToUTF16("pac script bytes"),
+        factory->resolvers()[i]->last_script_data()->utf16()) << "i=" << i;
+    EXPECT_EQ(0, factory->resolvers()[i]->request_count());
+  }
+}
+
 }  // namespace
 
 }  // namespace net
@@ -14,6 +14,7 @@
 #include "base/message_loop/message_loop.h"
 #include "base/message_loop/message_loop_proxy.h"
 #include "base/strings/string_util.h"
+#include "base/strings/utf_string_conversions.h"
 #include "base/thread_task_runner_handle.h"
 #include "base/values.h"
 #include "net/base/completion_callback.h"
@@ -25,6 +26,7 @@
 #include "net/proxy/network_delegate_error_observer.h"
 #include "net/proxy/proxy_config_service_fixed.h"
 #include "net/proxy/proxy_resolver.h"
+#include "net/proxy/proxy_resolver_script_data.h"
 #include "net/proxy/proxy_script_decider.h"
 #include "net/proxy/proxy_script_fetcher.h"
 #include "net/url_request/url_request_context.h"
@@ -76,6 +78,84 @@ namespace {
 // sorts of problems.
 const int64 kDelayAfterNetworkChangesMs = 2000;
 
+// Results of PAC scripts which only look at the host are reused for this
+// long. The cache is also cleared whenever the proxy configuration is reset,
+// which includes network changes and PAC script changes.
+const int64 kPacResultCacheTimeToLiveSeconds = 5 * 60;
+
+// The PAC result cache is cleared when it reaches this many origins.
+const size_t kMaxPacResultCacheEntries = 1000;
+
+bool IsIdentifierChar(char c) {
+  return IsAsciiAlpha(c) || IsAsciiDigit(c) || c == '_' || c == '$';
+}
+
+// Returns the number of times |name| appears as a whole word in |script|.
+size_t CountIdentifier(const std::string& script, const std::string& name) {
+  size_t count = 0;
+  for (size_t pos = script.find(name); pos != std::string::npos;
+       pos = script.find(name, pos + 1)) {
+    size_t end = pos + name.size();
+    if ((pos == 0 || !IsIdentifierChar(script[pos - 1])) &&
+        (end == script.size() || !IsIdentifierChar(script[end]))) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+size_t SkipWhitespace(const std::string& script, size_t pos) {
+  while (pos < script.size() && IsAsciiWhitespace(script[pos]))
+    ++pos;
+  return pos;
+}
+
+// Returns true if the result of the PAC script |script| can only depend on
+// the host of the URL, and not on its path, query or the current time. This
+// is a conservative textual check: FindProxyForURL() must be declared exactly
+// once, its |url| parameter must never be referenced, and the script must not
+// use anything which could reach the parameter indirectly or vary over time.
+bool IsPacResultDeterminedByHost(const base::string16& script16) {
+  const std::string script = base::UTF16ToUTF8(script16);
+
+  static const char* const kDisallowedIdentifiers[] = {
+    "arguments", "eval", "Date", "dateRange", "timeRange", "weekdayRange",
+    "random",
+  };
+  for (size_t i = 0; i < arraysize(kDisallowedIdentifiers); ++i) {
+    if (CountIdentifier(script, kDisallowedIdentifiers[i]) > 0)
+      return false;
+  }
+
+  const std::string kFunctionName = "FindProxyForURL";
+  if (CountIdentifier(script, kFunctionName) != 1)
+    return false;
+  size_t pos = script.find(kFunctionName);
+  // Must be a function declaration: "function FindProxyForURL(".
+  const std::string kFunction = "function";
+  size_t before = pos;
+  while (before > 0 && IsAsciiWhitespace(script[before - 1]))
+    --before;
+  if (before == pos || before < kFunction.size() ||
+      script.compare(before - kFunction.size(), kFunction.size(),
+                     kFunction) != 0) {
+    return false;
+  }
+  pos = SkipWhitespace(script, pos + kFunctionName.size());
+  if (pos >= script.size() || script[pos] != '(')
+    return false;
+  pos = SkipWhitespace(script, pos + 1);
+  size_t param_end = pos;
+  while (param_end < script.size() && IsIdentifierChar(script[param_end]))
+    ++param_end;
+  if (param_end == pos) {
+    // No parameters.
+    return pos < script.size() && script[pos] == ')';
+  }
+  // The parameter is only allowed to appear in the declaration.
+  return CountIdentifier(script, script.substr(pos, param_end - pos)) == 1;
+}
+
 // This is the default policy for polling the PAC script.
 //
 // In response to a failure, the poll intervals are:
@@ -812,6 +892,10 @@ class ProxyService::PacRequest
   int QueryDidComplete(int result_code) {
     DCHECK(!was_cancelled());
 
+    // Cache the result before bad proxies are moved to the end of the list.
+    if (result_code == OK)
+      service_->CachePacResult(url_, *results_);
+
     // Note that DidFinishResolvingProxy might modify |results_|.
     int rv = service_->DidFinishResolvingProxy(results_, result_code, net_log_);
 
@@ -886,7 +970,8 @@ ProxyService::ProxyService(ProxyConfigService* config_service,
       net_log_(net_log),
       stall_proxy_auto_config_delay_(TimeDelta::FromMilliseconds(
           kDelayAfterNetworkChangesMs)),
-      quick_check_enabled_(true) {
+      quick_check_enabled_(true),
+      pac_result_cache_enabled_(false) {
   NetworkChangeNotifier::AddIPAddressObserver(this);
   NetworkChangeNotifier::AddDNSObserver(this);
   ResetConfigService(config_service);
@@ -1032,8 +1117,11 @@ int ProxyService::TryToCompleteSynchronously(const GURL& url,
   if (permanent_error_ != OK)
     return permanent_error_;
 
-  if (config_.HasAutomaticSettings())
-    return ERR_IO_PENDING;  // Must submit the request to the proxy resolver.
+  if (config_.HasAutomaticSettings()) {
+    // Must submit the request to the proxy resolver, unless the PAC script
+    // has already been run for this origin.
+    return GetCachedPacResult(url, result) ? OK : ERR_IO_PENDING;
+  }
 
   // Use the manual proxy settings.
   config_.proxy_rules().Apply(url, result);
@@ -1042,6 +1130,34 @@ int ProxyService::TryToCompleteSynchronously(const GURL& url,
   return OK;
 }
 
+bool ProxyService::GetCachedPacResult(const GURL& url, ProxyInfo* result) {
+  if (!pac_result_cache_enabled_)
+    return false;
+  PacResultCache::iterator it = pac_result_cache_.find(url.GetOrigin().spec());
+  if (it == pac_result_cache_.end())
+    return false;
+  if (it->second.expiration <= TimeTicks::Now()) {
+    pac_result_cache_.erase(it);
+    return false;
+  }
+  result->Use(it->second.info);
+  result->config_source_ = config_.source();
+  result->config_id_ = config_.id();
+  result->did_use_pac_script_ = true;
+  return true;
+}
+
+void ProxyService::CachePacResult(const GURL& url, const ProxyInfo& result) {
+  if (!pac_result_cache_enabled_)
+    return;
+  if (pac_result_cache_.size() >= kMaxPacResultCacheEntries)
+    pac_result_cache_.clear();
+  CachedPacResult& entry = pac_result_cache_[url.GetOrigin().spec()];
+  entry.info.Use(result);
+  entry.expiration = TimeTicks::Now() +
+      TimeDelta::FromSeconds(kPacResultCacheTimeToLiveSeconds);
+}
+
 ProxyService::~ProxyService() {
   NetworkChangeNotifier::RemoveIPAddressObserver(this);
   NetworkChangeNotifier::RemoveDNSObserver(this);
@@ -1139,6 +1255,12 @@ void ProxyService::OnInitProxyResolverComplete(int result) {
       NULL));
   script_poller_->set_quick_check_enabled(quick_check_enabled_);
 
+  ProxyResolverScriptData* script_data = init_proxy_resolver_->script_data();
+  pac_result_cache_enabled_ =
+      result == OK && script_data &&
+      script_data->type() == ProxyResolverScriptData::TYPE_SCRIPT_CONTENTS &&
+      IsPacResultDeterminedByHost(script_data->utf16());
+
   init_proxy_resolver_.reset();
 
   if (result != OK) {
@@ -1323,6 +1445,8 @@ ProxyService::State ProxyService::ResetProxyConfig(bool reset_fetched_config) {
 
   permanent_error_ = OK;
   proxy_retry_info_.clear();
+  pac_result_cache_enabled_ = false;
+  pac_result_cache_.clear();
   script_poller_.reset();
   init_proxy_resolver_.reset();
   SuspendAllPendingRequests();
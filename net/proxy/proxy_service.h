@@ -5,6 +5,7 @@
 #ifndef NET_PROXY_PROXY_SERVICE_H_
 #define NET_PROXY_PROXY_SERVICE_H_
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -314,6 +315,14 @@ class NET_EXPORT ProxyService : public NetworkChangeNotifier::IPAddressObserver,
   // which expects requests to finish in the order they were added.
   typedef std::vector<scoped_refptr<PacRequest> > PendingRequests;
 
+  // A result of the PAC script, shared by all URLs with the same origin.
+  struct CachedPacResult {
+    ProxyInfo info;
+    base::TimeTicks expiration;
+  };
+  // Keyed by origin.
+  typedef std::map<std::string, CachedPacResult> PacResultCache;
+
   enum State {
     STATE_NONE,
     STATE_WAITING_FOR_PROXY_CONFIG,
@@ -342,6 +351,14 @@ class NET_EXPORT ProxyService : public NetworkChangeNotifier::IPAddressObserver,
   // Completing synchronously means we don't need to query ProxyResolver.
   int TryToCompleteSynchronously(const GURL& url, ProxyInfo* result);
 
+  // Fills |result| and returns true if there is an unexpired result of the
+  // PAC script for the origin of |url|.
+  bool GetCachedPacResult(const GURL& url, ProxyInfo* result);
+
+  // Remembers the PAC script's |result| for the origin of |url|, if the
+  // script cannot base its decision on anything else.
+  void CachePacResult(const GURL& url, const ProxyInfo& result);
+
   // Cancels all of the requests sent to the ProxyResolver. These will be
   // restarted when calling SetReady().
   void SuspendAllPendingRequests();
@@ -447,6 +464,12 @@ class NET_EXPORT ProxyService : public NetworkChangeNotifier::IPAddressObserver,
   // Whether child ProxyScriptDeciders should use QuickCheck
   bool quick_check_enabled_;
 
+  // Whether the current PAC script only looks at the host of the URL, in
+  // which case its results are kept in |pac_result_cache_| and reused for
+  // other URLs with the same origin. Both are reset along with the config.
+  bool pac_result_cache_enabled_;
+  PacResultCache pac_result_cache_;
+
   DISALLOW_COPY_AND_ASSIGN(ProxyService);
 };
 
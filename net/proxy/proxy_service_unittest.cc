@@ -1538,6 +1538,113 @@ TEST_F(ProxyServiceTest, InitialPACScriptDownload) {
   EXPECT_LE(info3.proxy_resolve_start_time(), info3.proxy_resolve_end_time());
 }
 
+// Results of a PAC script which only looks at the host are reused for other
+// URLs with the same origin.
+TEST_F(ProxyServiceTest, CachesHostOnlyPacResults) {
+  const char kHostOnlyPacScript[] =
+      "function FindProxyForURL(url, host) {\n"
+      "  if (dnsDomainIs(host, \".example.com\"))\n"
+      "    return \"DIRECT\";\n"
+      "  return \"PROXY foopy:8080\";\n"
+      "}\n";
+
+  MockProxyConfigService* config_service =
+      new MockProxyConfigService("http://foopy/proxy.pac");
+
+  MockAsyncProxyResolverExpectsBytes* resolver =
+      new MockAsyncProxyResolverExpectsBytes;
+
+  ProxyService service(config_service, resolver, NULL);
+
+  MockProxyScriptFetcher* fetcher = new MockProxyScriptFetcher;
+  service.SetProxyScriptFetchers(fetcher,
+                                 new DoNothingDhcpProxyScriptFetcher());
+
+  ProxyInfo info1;
+  TestCompletionCallback callback1;
+  int rv = service.ResolveProxy(GURL("http://www.google.com/a"), &info1,
+                                callback1.callback(), NULL, BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+
+  fetcher->NotifyFetchCompletion(OK, kHostOnlyPacScript);
+  resolver->pending_set_pac_script_request()->CompleteNow(OK);
+
+  ASSERT_EQ(1u, resolver->pending_requests().size());
+  resolver->pending_requests()[0]->results()->UseNamedProxy("foopy:8080");
+  resolver->pending_requests()[0]->CompleteNow(OK);
+  EXPECT_EQ(OK, callback1.WaitForResult());
+  EXPECT_EQ("foopy:8080", info1.proxy_server().ToURI());
+
+  // Another path on the same origin completes synchronously.
+  ProxyInfo info2;
+  TestCompletionCallback callback2;
+  rv = service.ResolveProxy(GURL("http://www.google.com/b?q=1"), &info2,
+                            callback2.callback(), NULL, BoundNetLog());
+  EXPECT_EQ(OK, rv);
+  EXPECT_TRUE(resolver->pending_requests().empty());
+  EXPECT_EQ("foopy:8080", info2.proxy_server().ToURI());
+  EXPECT_TRUE(info2.did_use_pac_script());
+
+  // A different origin goes to the resolver.
+  ProxyInfo info3;
+  TestCompletionCallback callback3;
+  rv = service.ResolveProxy(GURL("https://www.google.com/a"), &info3,
+                            callback3.callback(), NULL, BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  ASSERT_EQ(1u, resolver->pending_requests().size());
+  resolver->pending_requests()[0]->results()->UseDirect();
+  resolver->pending_requests()[0]->CompleteNow(OK);
+  EXPECT_EQ(OK, callback3.WaitForResult());
+  EXPECT_TRUE(info3.is_direct());
+}
+
+// Results of a PAC script which looks at the whole URL are not reused.
+TEST_F(ProxyServiceTest, DoesNotCachePacResultsWhichDependOnURL) {
+  const char kURLPacScript[] =
+      "function FindProxyForURL(url, host) {\n"
+      "  if (shExpMatch(url, \"*/private/*\"))\n"
+      "    return \"DIRECT\";\n"
+      "  return \"PROXY foopy:8080\";\n"
+      "}\n";
+
+  MockProxyConfigService* config_service =
+      new MockProxyConfigService("http://foopy/proxy.pac");
+
+  MockAsyncProxyResolverExpectsBytes* resolver =
+      new MockAsyncProxyResolverExpectsBytes;
+
+  ProxyService service(config_service, resolver, NULL);
+
+  MockProxyScriptFetcher* fetcher = new MockProxyScriptFetcher;
+  service.SetProxyScriptFetchers(fetcher,
+                                 new DoNothingDhcpProxyScriptFetcher());
+
+  ProxyInfo info1;
+  TestCompletionCallback callback1;
+  int rv = service.ResolveProxy(GURL("http://www.google.com/a"), &info1,
+                                callback1.callback(), NULL, BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+
+  fetcher->NotifyFetchCompletion(OK, kURLPacScript);
+  resolver->pending_set_pac_script_request()->CompleteNow(OK);
+
+  ASSERT_EQ(1u, resolver->pending_requests().size());
+  resolver->pending_requests()[0]->results()->UseNamedProxy("foopy:8080");
+  resolver->pending_requests()[0]->CompleteNow(OK);
+  EXPECT_EQ(OK, callback1.WaitForResult());
+
+  ProxyInfo info2;
+  TestCompletionCallback callback2;
+  rv = service.ResolveProxy(GURL("http://www.google.com/private/b"), &info2,
+                            callback2.callback(), NULL, BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  ASSERT_EQ(1u, resolver->pending_requests().size());
+  resolver->pending_requests()[0]->results()->UseDirect();
+  resolver->pending_requests()[0]->CompleteNow(OK);
+  EXPECT_EQ(OK, callback2.WaitForResult());
+  EXPECT_TRUE(info2.is_direct());
+}
+
 // Test changing the ProxyScriptFetcher while PAC download is in progress.
 TEST_F(ProxyServiceTest, ChangeScriptFetcherWhilePACDownloadInProgress) {
   MockProxyConfigService* config_service =
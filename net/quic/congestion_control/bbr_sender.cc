@@ -0,0 +1,325 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/congestion_control/bbr_sender.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "base/logging.h"
+
+using std::make_pair;
+using std::max;
+
+namespace net {
+
+namespace {
+// The gain used in STARTUP to double the delivery rate each round trip.
+const float kHighGain = 2.885f;  // 2 / ln(2)
+// The gain used in PROBE_BW, which leaves room for delayed and stretch acks.
+const float kCongestionWindowGain = 2;
+const int64 kInitialCongestionWindow = 10;
+const QuicByteCount kMinimumCongestionWindow = 4 * kMaxPacketSize;
+// The number of round trips the maximum bandwidth filter covers.
+const int64 kBandwidthWindowRounds = 10;
+// STARTUP ends when the bandwidth has not grown by 25% in three round trips.
+const float kStartupGrowthTarget = 1.25f;
+const int kRoundsWithoutGrowthBeforeExit = 3;
+const int kMinRttExpirySeconds = 10;
+const int kProbeRttTimeMs = 200;
+// Constants used for RTT calculation.
+const int kInitialRttMs = 100;  // At a typical RTT 100 ms.
+const float kAlpha = 0.125f;
+const float kOneMinusAlpha = (1 - kAlpha);
+const float kBeta = 0.25f;
+const float kOneMinusBeta = (1 - kBeta);
+}  // namespace
+
+BbrSender::SentPacketState::SentPacketState()
+    : bytes(0),
+      delivered(0),
+      delivered_time(QuicTime::Zero()) {
+}
+
+BbrSender::SentPacketState::SentPacketState(QuicByteCount bytes,
+                                            QuicByteCount delivered,
+                                            QuicTime delivered_time)
+    : bytes(bytes),
+      delivered(delivered),
+      delivered_time(delivered_time) {
+}
+
+BbrSender::BbrSender(const QuicClock* clock)
+    : clock_(clock),
+      mode_(STARTUP),
+      bytes_in_flight_(0),
+      delivered_(0),
+      delivered_time_(QuicTime::Zero()),
+      round_count_(0),
+      largest_sent_sequence_number_(0),
+      current_round_end_(0),
+      full_bandwidth_(QuicBandwidth::Zero()),
+      rounds_without_bandwidth_growth_(0),
+      min_rtt_(QuicTime::Delta::Zero()),
+      min_rtt_timestamp_(QuicTime::Zero()),
+      probe_rtt_done_time_(QuicTime::Zero()),
+      initial_congestion_window_(kInitialCongestionWindow * kMaxPacketSize),
+      smoothed_rtt_(QuicTime::Delta::Zero()),
+      mean_deviation_(QuicTime::Delta::Zero()) {
+}
+
+BbrSender::~BbrSender() {}
+
+void BbrSender::SetFromConfig(const QuicConfig& config, bool is_server) {
+  if (is_server) {
+    // Set the initial window size.
+    initial_congestion_window_ =
+        config.server_initial_congestion_window() * kMaxPacketSize;
+  }
+}
+
+void BbrSender::OnIncomingQuicCongestionFeedbackFrame(
+    const QuicCongestionFeedbackFrame& /*feedback*/,
+    QuicTime /*feedback_receive_time*/) {
+  // The model is built from acks alone.
+}
+
+void BbrSender::OnPacketAcked(QuicPacketSequenceNumber acked_sequence_number,
+                              QuicByteCount /*acked_bytes*/) {
+  SentPacketStateMap::iterator it = sent_packets_.find(acked_sequence_number);
+  if (it == sent_packets_.end()) {
+    // Sent before this sender was in use, or already abandoned.
+    return;
+  }
+  const SentPacketState& state = it->second;
+  QuicTime now = clock_->Now();
+  DCHECK_GE(bytes_in_flight_, state.bytes);
+  bytes_in_flight_ -= state.bytes;
+  delivered_ += state.bytes;
+  delivered_time_ = now;
+
+  bool new_round = false;
+  if (acked_sequence_number > current_round_end_) {
+    ++round_count_;
+    current_round_end_ = largest_sent_sequence_number_;
+    new_round = true;
+  }
+
+  // The delivery rate is the data acked since this packet was sent, over the
+  // time it took to ack it.
+  QuicTime::Delta interval = now.Subtract(state.delivered_time);
+  if (!interval.IsZero()) {
+    UpdateBandwidth(QuicBandwidth::FromBytesAndTimeDelta(
+        delivered_ - state.delivered, interval));
+  }
+  sent_packets_.erase(it);
+
+  if (new_round) {
+    OnNewRound();
+  }
+  UpdateMode(now);
+}
+
+void BbrSender::OnPacketLost(QuicPacketSequenceNumber sequence_number,
+                             QuicTime /*ack_receive_time*/) {
+  // Loss is not a congestion signal for the model. The packet leaves the
+  // bytes in flight when it is abandoned.
+  DVLOG(1) << "Ignoring loss of packet " << sequence_number;
+}
+
+bool BbrSender::OnPacketSent(QuicTime sent_time,
+                             QuicPacketSequenceNumber sequence_number,
+                             QuicByteCount bytes,
+                             TransmissionType /*transmission_type*/,
+                             HasRetransmittableData is_retransmittable) {
+  // Only update bytes_in_flight_ for data packets.
+  if (is_retransmittable != HAS_RETRANSMITTABLE_DATA) {
+    return false;
+  }
+
+  if (bytes_in_flight_ == 0) {
+    // Don't count the time the connection was idle towards the next sample.
+    delivered_time_ = sent_time;
+  }
+  sent_packets_[sequence_number] =
+      SentPacketState(bytes, delivered_, delivered_time_);
+  bytes_in_flight_ += bytes;
+  largest_sent_sequence_number_ =
+      max(largest_sent_sequence_number_, sequence_number);
+  return true;
+}
+
+void BbrSender::OnRetransmissionTimeout(bool /*packets_retransmitted*/) {
+  bytes_in_flight_ = 0;
+  sent_packets_.clear();
+}
+
+void BbrSender::OnPacketAbandoned(QuicPacketSequenceNumber sequence_number,
+                                  QuicByteCount /*abandoned_bytes*/) {
+  SentPacketStateMap::iterator it = sent_packets_.find(sequence_number);
+  if (it == sent_packets_.end()) {
+    return;
+  }
+  DCHECK_GE(bytes_in_flight_, it->second.bytes);
+  bytes_in_flight_ -= it->second.bytes;
+  sent_packets_.erase(it);
+}
+
+QuicTime::Delta BbrSender::TimeUntilSend(
+    QuicTime /*now*/,
+    TransmissionType transmission_type,
+    HasRetransmittableData has_retransmittable_data,
+    IsHandshake handshake) {
+  if (transmission_type == TLP_RETRANSMISSION ||
+      has_retransmittable_data == NO_RETRANSMITTABLE_DATA ||
+      handshake == IS_HANDSHAKE) {
+    // Like TCP, always send acks, handshake packets and tail loss probes.
+    return QuicTime::Delta::Zero();
+  }
+  // DRAIN keeps the congestion window, but waits for the queue to empty.
+  QuicByteCount window = mode_ == DRAIN ?
+      TargetCongestionWindow(1) : GetCongestionWindow();
+  if (bytes_in_flight_ < window) {
+    return QuicTime::Delta::Zero();
+  }
+  return QuicTime::Delta::Infinite();
+}
+
+QuicBandwidth BbrSender::BandwidthEstimate() const {
+  if (bandwidth_samples_.empty()) {
+    return QuicBandwidth::Zero();
+  }
+  return bandwidth_samples_.front().second;
+}
+
+void BbrSender::UpdateRtt(QuicTime::Delta rtt) {
+  if (rtt.IsInfinite() || rtt.IsZero()) {
+    DVLOG(1) << "Ignoring rtt, because it's "
+             << (rtt.IsZero() ? "Zero" : "Infinite");
+    return;
+  }
+  // RTT can't be negative.
+  DCHECK_LT(0, rtt.ToMicroseconds());
+
+  if (min_rtt_.IsZero() || rtt <= min_rtt_) {
+    min_rtt_ = rtt;
+    min_rtt_timestamp_ = clock_->Now();
+  }
+
+  // First time call.
+  if (smoothed_rtt_.IsZero()) {
+    smoothed_rtt_ = rtt;
+    mean_deviation_ = QuicTime::Delta::FromMicroseconds(
+        rtt.ToMicroseconds() / 2);
+  } else {
+    mean_deviation_ = QuicTime::Delta::FromMicroseconds(
+        kOneMinusBeta * mean_deviation_.ToMicroseconds() +
+        kBeta *
+            std::abs(smoothed_rtt_.ToMicroseconds() - rtt.ToMicroseconds()));
+    smoothed_rtt_ = QuicTime::Delta::FromMicroseconds(
+        kOneMinusAlpha * smoothed_rtt_.ToMicroseconds() +
+        kAlpha * rtt.ToMicroseconds());
+  }
+}
+
+QuicTime::Delta BbrSender::SmoothedRtt() const {
+  if (smoothed_rtt_.IsZero()) {
+    return QuicTime::Delta::FromMilliseconds(kInitialRttMs);
+  }
+  return smoothed_rtt_;
+}
+
+QuicTime::Delta BbrSender::RetransmissionDelay() const {
+  return QuicTime::Delta::FromMicroseconds(
+      smoothed_rtt_.ToMicroseconds() + 4 * mean_deviation_.ToMicroseconds());
+}
+
+QuicByteCount BbrSender::GetCongestionWindow() const {
+  switch (mode_) {
+    case STARTUP:
+    case DRAIN:
+      return max(initial_congestion_window_,
+                 TargetCongestionWindow(kHighGain));
+    case PROBE_BW:
+      return TargetCongestionWindow(kCongestionWindowGain);
+    case PROBE_RTT:
+      return kMinimumCongestionWindow;
+  }
+  NOTREACHED();
+  return kMinimumCongestionWindow;
+}
+
+QuicByteCount BbrSender::TargetCongestionWindow(float gain) const {
+  QuicBandwidth bandwidth = BandwidthEstimate();
+  if (bandwidth.IsZero() || min_rtt_.IsZero()) {
+    return initial_congestion_window_;
+  }
+  QuicByteCount bdp = bandwidth.ToBytesPerPeriod(min_rtt_);
+  return max(kMinimumCongestionWindow,
+             static_cast<QuicByteCount>(gain * bdp));
+}
+
+void BbrSender::UpdateBandwidth(QuicBandwidth sample) {
+  while (!bandwidth_samples_.empty() &&
+         bandwidth_samples_.back().second <= sample) {
+    bandwidth_samples_.pop_back();
+  }
+  bandwidth_samples_.push_back(make_pair(round_count_, sample));
+  while (bandwidth_samples_.front().first + kBandwidthWindowRounds <=
+             round_count_) {
+    bandwidth_samples_.pop_front();
+  }
+}
+
+void BbrSender::OnNewRound() {
+  if (mode_ != STARTUP) {
+    return;
+  }
+  QuicBandwidth bandwidth = BandwidthEstimate();
+  if (bandwidth >= full_bandwidth_.Scale(kStartupGrowthTarget)) {
+    full_bandwidth_ = bandwidth;
+    rounds_without_bandwidth_growth_ = 0;
+    return;
+  }
+  if (++rounds_without_bandwidth_growth_ >= kRoundsWithoutGrowthBeforeExit) {
+    DVLOG(1) << "Leaving STARTUP at " << bandwidth.ToKBitsPerSecond()
+             << " kbps";
+    mode_ = DRAIN;
+  }
+}
+
+void BbrSender::UpdateMode(QuicTime now) {
+  if (mode_ == DRAIN && bytes_in_flight_ <= TargetCongestionWindow(1)) {
+    mode_ = PROBE_BW;
+  }
+
+  if (mode_ != PROBE_RTT && !min_rtt_.IsZero() &&
+      now > min_rtt_timestamp_.Add(
+          QuicTime::Delta::FromSeconds(kMinRttExpirySeconds))) {
+    DVLOG(1) << "Entering PROBE_RTT, min_rtt was "
+             << min_rtt_.ToMicroseconds() << "us";
+    mode_ = PROBE_RTT;
+    // Measure the minimum RTT again from scratch.
+    min_rtt_ = QuicTime::Delta::Zero();
+    probe_rtt_done_time_ = QuicTime::Zero();
+  }
+
+  if (mode_ != PROBE_RTT) {
+    return;
+  }
+  if (!probe_rtt_done_time_.IsInitialized()) {
+    if (bytes_in_flight_ <= kMinimumCongestionWindow) {
+      probe_rtt_done_time_ =
+          now.Add(QuicTime::Delta::FromMilliseconds(kProbeRttTimeMs));
+    }
+    return;
+  }
+  if (now >= probe_rtt_done_time_) {
+    min_rtt_timestamp_ = now;
+    mode_ = rounds_without_bandwidth_growth_ >= kRoundsWithoutGrowthBeforeExit ?
+        PROBE_BW : STARTUP;
+  }
+}
+
+}  // namespace net
@@ -0,0 +1,161 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// BBR-style send side congestion algorithm. Instead of reacting to loss, it
+// builds a model of the path from the bottleneck bandwidth and the minimum
+// RTT, and sizes the congestion window from their product.
+
+#ifndef NET_QUIC_CONGESTION_CONTROL_BBR_SENDER_H_
+#define NET_QUIC_CONGESTION_CONTROL_BBR_SENDER_H_
+
+#include <deque>
+#include <map>
+#include <utility>
+
+#include "base/basictypes.h"
+#include "base/compiler_specific.h"
+#include "net/base/net_export.h"
+#include "net/quic/congestion_control/send_algorithm_interface.h"
+#include "net/quic/quic_bandwidth.h"
+#include "net/quic/quic_protocol.h"
+#include "net/quic/quic_time.h"
+
+namespace net {
+
+namespace test {
+class BbrSenderPeer;
+}  // namespace test
+
+// The sender estimates the bottleneck bandwidth as the maximum delivery rate
+// seen over the last ten round trips, and the propagation delay as the
+// minimum RTT seen over the last ten seconds. Losses do not shrink the
+// congestion window, which is what makes it useful on lossy links.
+//
+// It goes through the following modes:
+//  STARTUP:   Doubles the delivery rate each round trip until the bandwidth
+//             estimate stops growing for three round trips.
+//  DRAIN:     Stops sending until the queue built in STARTUP has drained.
+//  PROBE_BW:  Keeps twice the bandwidth-delay product in flight.
+//  PROBE_RTT: When the minimum RTT has not been seen for ten seconds, keeps
+//             only a few packets in flight for 200ms to measure it again.
+//
+// It does not pace by itself; wrap it in a PacingSender.
+class NET_EXPORT_PRIVATE BbrSender : public SendAlgorithmInterface {
+ public:
+  enum Mode {
+    STARTUP,
+    DRAIN,
+    PROBE_BW,
+    PROBE_RTT,
+  };
+
+  explicit BbrSender(const QuicClock* clock);
+  virtual ~BbrSender();
+
+  // Start implementation of SendAlgorithmInterface.
+  virtual void SetFromConfig(const QuicConfig& config, bool is_server) OVERRIDE;
+  virtual void OnIncomingQuicCongestionFeedbackFrame(
+      const QuicCongestionFeedbackFrame& feedback,
+      QuicTime feedback_receive_time) OVERRIDE;
+  virtual void OnPacketAcked(QuicPacketSequenceNumber acked_sequence_number,
+                             QuicByteCount acked_bytes) OVERRIDE;
+  virtual void OnPacketLost(QuicPacketSequenceNumber sequence_number,
+                            QuicTime ack_receive_time) OVERRIDE;
+  virtual bool OnPacketSent(QuicTime sent_time,
+                            QuicPacketSequenceNumber sequence_number,
+                            QuicByteCount bytes,
+                            TransmissionType transmission_type,
+                            HasRetransmittableData is_retransmittable) OVERRIDE;
+  virtual void OnRetransmissionTimeout(bool packets_retransmitted) OVERRIDE;
+  virtual void OnPacketAbandoned(QuicPacketSequenceNumber sequence_number,
+                                 QuicByteCount abandoned_bytes) OVERRIDE;
+  virtual QuicTime::Delta TimeUntilSend(
+      QuicTime now,
+      TransmissionType transmission_type,
+      HasRetransmittableData has_retransmittable_data,
+      IsHandshake handshake) OVERRIDE;
+  virtual QuicBandwidth BandwidthEstimate() const OVERRIDE;
+  virtual void UpdateRtt(QuicTime::Delta rtt_sample) OVERRIDE;
+  virtual QuicTime::Delta SmoothedRtt() const OVERRIDE;
+  virtual QuicTime::Delta RetransmissionDelay() const OVERRIDE;
+  virtual QuicByteCount GetCongestionWindow() const OVERRIDE;
+  // End implementation of SendAlgorithmInterface.
+
+  Mode mode() const { return mode_; }
+
+  // Returns the minimum RTT seen recently, or zero before the first sample.
+  QuicTime::Delta min_rtt() const { return min_rtt_; }
+
+ private:
+  friend class test::BbrSenderPeer;
+
+  // The state of the connection when a packet was sent, used to compute the
+  // delivery rate when it is acked.
+  struct SentPacketState {
+    SentPacketState();
+    SentPacketState(QuicByteCount bytes,
+                    QuicByteCount delivered,
+                    QuicTime delivered_time);
+
+    QuicByteCount bytes;
+    QuicByteCount delivered;
+    QuicTime delivered_time;
+  };
+
+  typedef std::map<QuicPacketSequenceNumber, SentPacketState>
+      SentPacketStateMap;
+
+  // Returns the bandwidth-delay product, scaled by |gain|.
+  QuicByteCount TargetCongestionWindow(float gain) const;
+
+  // Adds a delivery rate sample to the windowed maximum filter.
+  void UpdateBandwidth(QuicBandwidth sample);
+
+  // Called when an ack starts a new round trip.
+  void OnNewRound();
+
+  // Moves between modes after an ack.
+  void UpdateMode(QuicTime now);
+
+  const QuicClock* clock_;
+  Mode mode_;
+
+  // Bytes in flight, aka bytes on the wire.
+  QuicByteCount bytes_in_flight_;
+  SentPacketStateMap sent_packets_;
+
+  // Total bytes acked, and when the last of them was acked.
+  QuicByteCount delivered_;
+  QuicTime delivered_time_;
+
+  // Round trips are counted by acks of packets sent after the round began.
+  int64 round_count_;
+  QuicPacketSequenceNumber largest_sent_sequence_number_;
+  QuicPacketSequenceNumber current_round_end_;
+
+  // Delivery rate samples that may still be the maximum, with the round they
+  // were taken in. Bandwidths are decreasing from front to back.
+  std::deque<std::pair<int64, QuicBandwidth> > bandwidth_samples_;
+
+  // Used to decide when STARTUP has found the bottleneck bandwidth.
+  QuicBandwidth full_bandwidth_;
+  int rounds_without_bandwidth_growth_;
+
+  QuicTime::Delta min_rtt_;
+  QuicTime min_rtt_timestamp_;
+  // When PROBE_RTT may end, or zero until few enough packets are in flight.
+  QuicTime probe_rtt_done_time_;
+
+  // Congestion window used until there is a bandwidth and RTT estimate.
+  QuicByteCount initial_congestion_window_;
+
+  QuicTime::Delta smoothed_rtt_;
+  QuicTime::Delta mean_deviation_;
+
+  DISALLOW_COPY_AND_ASSIGN(BbrSender);
+};
+
+}  // namespace net
+
+#endif  // NET_QUIC_CONGESTION_CONTROL_BBR_SENDER_H_
@@ -0,0 +1,258 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <deque>
+
+#include "base/logging.h"
+#include "net/quic/congestion_control/bbr_sender.h"
+#include "net/quic/congestion_control/tcp_cubic_sender.h"
+#include "net/quic/test_tools/mock_clock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace test {
+namespace {
+
+const QuicByteCount kPacketSize = kMaxPacketSize;
+const QuicTcpCongestionWindow kMaxCongestionWindowTCP = 10000;
+
+// Simulates a sender that always has data, sending through a bottleneck link
+// with a FIFO queue. Every |loss_interval|th packet is dropped after the
+// bottleneck, and the sender learns of the loss when its ack would have
+// arrived. Everything is driven by a MockClock, so runs are repeatable.
+class LinkSimulator {
+ public:
+  LinkSimulator(MockClock* clock,
+                SendAlgorithmInterface* sender,
+                QuicBandwidth bandwidth,
+                QuicTime::Delta rtt,
+                int loss_interval)
+      : clock_(clock),
+        sender_(sender),
+        bandwidth_(bandwidth),
+        rtt_(rtt),
+        loss_interval_(loss_interval),
+        link_free_time_(clock->Now()),
+        sequence_number_(1),
+        bytes_acked_(0),
+        goodput_start_time_(clock->Now()) {
+  }
+
+  // Sends and acks packets until |duration| has passed.
+  void Run(QuicTime::Delta duration) {
+    QuicTime end_time = clock_->Now().Add(duration);
+    while (clock_->Now() < end_time) {
+      SendAvailablePackets();
+      ASSERT_FALSE(in_flight_.empty());
+      QuicTime next_ack_time = in_flight_.front().ack_time;
+      if (next_ack_time > end_time) {
+        clock_->AdvanceTime(end_time.Subtract(clock_->Now()));
+        return;
+      }
+      clock_->AdvanceTime(next_ack_time.Subtract(clock_->Now()));
+      ProcessAcks();
+    }
+  }
+
+  // Returns the rate at which data was acked since the last call.
+  QuicBandwidth GoodputSinceLastCall() {
+    QuicTime now = clock_->Now();
+    QuicBandwidth goodput = QuicBandwidth::FromBytesAndTimeDelta(
+        bytes_acked_, now.Subtract(goodput_start_time_));
+    bytes_acked_ = 0;
+    goodput_start_time_ = now;
+    return goodput;
+  }
+
+  void ResetGoodput() {
+    bytes_acked_ = 0;
+    goodput_start_time_ = clock_->Now();
+  }
+
+ private:
+  struct SentPacket {
+    SentPacket(QuicPacketSequenceNumber sequence_number,
+               QuicTime sent_time,
+               QuicTime ack_time,
+               bool lost)
+        : sequence_number(sequence_number),
+          sent_time(sent_time),
+          ack_time(ack_time),
+          lost(lost) {
+    }
+
+    QuicPacketSequenceNumber sequence_number;
+    QuicTime sent_time;
+    QuicTime ack_time;
+    bool lost;
+  };
+
+  void SendAvailablePackets() {
+    QuicTime now = clock_->Now();
+    while (sender_->TimeUntilSend(now, NOT_RETRANSMISSION,
+                                  HAS_RETRANSMITTABLE_DATA,
+                                  NOT_HANDSHAKE).IsZero()) {
+      QuicPacketSequenceNumber sequence_number = sequence_number_++;
+      // The packet leaves the bottleneck once the packets ahead of it have.
+      QuicTime start = link_free_time_ > now ? link_free_time_ : now;
+      link_free_time_ = start.Add(bandwidth_.TransferTime(kPacketSize));
+      bool lost = loss_interval_ > 0 && sequence_number % loss_interval_ == 0;
+      sender_->OnPacketSent(now, sequence_number, kPacketSize,
+                            NOT_RETRANSMISSION, HAS_RETRANSMITTABLE_DATA);
+      in_flight_.push_back(
+          SentPacket(sequence_number, now, link_free_time_.Add(rtt_), lost));
+    }
+  }
+
+  void ProcessAcks() {
+    QuicTime now = clock_->Now();
+    while (!in_flight_.empty() && in_flight_.front().ack_time <= now) {
+      const SentPacket& packet = in_flight_.front();
+      if (packet.lost) {
+        sender_->OnPacketLost(packet.sequence_number, now);
+        sender_->OnPacketAbandoned(packet.sequence_number, kPacketSize);
+      } else {
+        sender_->UpdateRtt(now.Subtract(packet.sent_time));
+        sender_->OnPacketAcked(packet.sequence_number, kPacketSize);
+        bytes_acked_ += kPacketSize;
+      }
+      in_flight_.pop_front();
+    }
+  }
+
+  MockClock* clock_;
+  SendAlgorithmInterface* sender_;
+  const QuicBandwidth bandwidth_;
+  const QuicTime::Delta rtt_;
+  const int loss_interval_;
+  QuicTime link_free_time_;
+  QuicPacketSequenceNumber sequence_number_;
+  std::deque<SentPacket> in_flight_;
+  QuicByteCount bytes_acked_;
+  QuicTime goodput_start_time_;
+};
+
+class BbrSenderTest : public ::testing::Test {
+ protected:
+  BbrSenderTest()
+      : bandwidth_(QuicBandwidth::FromKBitsPerSecond(10000)),
+        rtt_(QuicTime::Delta::FromMilliseconds(100)) {
+    // Start at a non zero time.
+    clock_.AdvanceTime(QuicTime::Delta::FromMilliseconds(1));
+  }
+
+  QuicByteCount BandwidthDelayProduct() const {
+    return bandwidth_.ToBytesPerPeriod(rtt_);
+  }
+
+  MockClock clock_;
+  const QuicBandwidth bandwidth_;
+  const QuicTime::Delta rtt_;
+};
+
+TEST_F(BbrSenderTest, StartupFindsBottleneckBandwidth) {
+  BbrSender sender(&clock_);
+  EXPECT_EQ(BbrSender::STARTUP, sender.mode());
+  EXPECT_EQ(10 * kPacketSize, sender.GetCongestionWindow());
+
+  LinkSimulator link(&clock_, &sender, bandwidth_, rtt_, 0);
+  link.Run(QuicTime::Delta::FromSeconds(3));
+
+  EXPECT_EQ(BbrSender::PROBE_BW, sender.mode());
+  // The delivery rate can not exceed the bottleneck bandwidth, apart from
+  // rounding of the simulated transfer times.
+  EXPECT_LE(sender.BandwidthEstimate(), bandwidth_.Scale(1.01f));
+  EXPECT_GE(sender.BandwidthEstimate(), bandwidth_.Scale(0.95f));
+  // The minimum RTT includes the time to send one packet.
+  EXPECT_LE(rtt_, sender.min_rtt());
+  EXPECT_GE(rtt_.Add(QuicTime::Delta::FromMilliseconds(2)), sender.min_rtt());
+  EXPECT_NEAR(2 * BandwidthDelayProduct(), sender.GetCongestionWindow(),
+              0.05 * 2 * BandwidthDelayProduct());
+}
+
+TEST_F(BbrSenderTest, FillsLinkDespiteLoss) {
+  BbrSender sender(&clock_);
+  // Lose one packet in 20.
+  LinkSimulator link(&clock_, &sender, bandwidth_, rtt_, 20);
+  link.Run(QuicTime::Delta::FromSeconds(3));
+  EXPECT_EQ(BbrSender::PROBE_BW, sender.mode());
+
+  link.ResetGoodput();
+  link.Run(QuicTime::Delta::FromSeconds(5));
+  // All the delivered packets are goodput, so 95% of the link is the most
+  // that can be achieved.
+  EXPECT_GE(link.GoodputSinceLastCall(), bandwidth_.Scale(0.9f));
+}
+
+TEST_F(BbrSenderTest, OutperformsCubicWithLoss) {
+  BbrSender bbr_sender(&clock_);
+  LinkSimulator bbr_link(&clock_, &bbr_sender, bandwidth_, rtt_, 20);
+  bbr_link.ResetGoodput();
+  bbr_link.Run(QuicTime::Delta::FromSeconds(10));
+  QuicBandwidth bbr_goodput = bbr_link.GoodputSinceLastCall();
+
+  TcpCubicSender cubic_sender(&clock_, false, kMaxCongestionWindowTCP);
+  LinkSimulator cubic_link(&clock_, &cubic_sender, bandwidth_, rtt_, 20);
+  cubic_link.ResetGoodput();
+  cubic_link.Run(QuicTime::Delta::FromSeconds(10));
+  QuicBandwidth cubic_goodput = cubic_link.GoodputSinceLastCall();
+
+  EXPECT_GT(bbr_goodput, cubic_goodput.Scale(2));
+}
+
+TEST_F(BbrSenderTest, ProbesRttEveryTenSeconds) {
+  BbrSender sender(&clock_);
+  LinkSimulator link(&clock_, &sender, bandwidth_, rtt_, 0);
+  link.Run(QuicTime::Delta::FromSeconds(3));
+  EXPECT_EQ(BbrSender::PROBE_BW, sender.mode());
+
+  // The queue never fully drains in PROBE_BW, so the minimum RTT expires.
+  bool probed_rtt = false;
+  for (int i = 0; i < 10000 && !probed_rtt; ++i) {
+    link.Run(QuicTime::Delta::FromMilliseconds(10));
+    probed_rtt = sender.mode() == BbrSender::PROBE_RTT;
+  }
+  ASSERT_TRUE(probed_rtt);
+  EXPECT_EQ(4 * kPacketSize, sender.GetCongestionWindow());
+
+  link.Run(QuicTime::Delta::FromSeconds(1));
+  EXPECT_EQ(BbrSender::PROBE_BW, sender.mode());
+  EXPECT_LE(rtt_, sender.min_rtt());
+  EXPECT_GE(rtt_.Add(QuicTime::Delta::FromMilliseconds(2)), sender.min_rtt());
+}
+
+TEST_F(BbrSenderTest, AbandonedPacketsLeaveFlight) {
+  BbrSender sender(&clock_);
+  for (QuicPacketSequenceNumber i = 1; i <= 10; ++i) {
+    EXPECT_TRUE(sender.TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+                                     HAS_RETRANSMITTABLE_DATA,
+                                     NOT_HANDSHAKE).IsZero());
+    EXPECT_TRUE(sender.OnPacketSent(clock_.Now(), i, kPacketSize,
+                                    NOT_RETRANSMISSION,
+                                    HAS_RETRANSMITTABLE_DATA));
+  }
+  EXPECT_TRUE(sender.TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+                                   HAS_RETRANSMITTABLE_DATA,
+                                   NOT_HANDSHAKE).IsInfinite());
+  // Acks are never blocked.
+  EXPECT_FALSE(sender.OnPacketSent(clock_.Now(), 11, kPacketSize,
+                                   NOT_RETRANSMISSION,
+                                   NO_RETRANSMITTABLE_DATA));
+
+  // A loss does not shrink the window, and the packet leaves the bytes in
+  // flight once it is abandoned.
+  sender.OnPacketLost(1, clock_.Now());
+  EXPECT_EQ(10 * kPacketSize, sender.GetCongestionWindow());
+  sender.OnPacketAbandoned(1, kPacketSize);
+  EXPECT_TRUE(sender.TimeUntilSend(clock_.Now(), NOT_RETRANSMISSION,
+                                   HAS_RETRANSMITTABLE_DATA,
+                                   NOT_HANDSHAKE).IsZero());
+
+  // An ack for an unknown packet is ignored.
+  sender.OnPacketAcked(100, kPacketSize);
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
@@ -39,9 +39,18 @@ QuicData* NullEncrypter::EncryptPacket(
     StringPiece associated_data,
     StringPiece plaintext) {
   const size_t len = plaintext.size() + GetHashLength();
-  uint8* buffer = new uint8[len];
-  Encrypt(StringPiece(), associated_data, plaintext, buffer);
-  return new QuicData(reinterpret_cast<char*>(buffer), len, true);
+  char* buffer = new char[len];
+  EncryptPacketToBuffer(0, associated_data, plaintext, buffer);
+  return new QuicData(buffer, len, true);
+}
+
+bool NullEncrypter::EncryptPacketToBuffer(
+    QuicPacketSequenceNumber /*sequence_number*/,
+    StringPiece associated_data,
+    StringPiece plaintext,
+    char* output) {
+  return Encrypt(StringPiece(), associated_data, plaintext,
+                 reinterpret_cast<unsigned char*>(output));
 }
 
 size_t NullEncrypter::GetKeySize() const { return 0; }
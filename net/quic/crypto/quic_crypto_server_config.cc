@@ -1209,6 +1209,15 @@ void QuicCryptoServerConfig::AcquirePrimaryConfigChangedCb(
   primary_config_changed_cb_.reset(cb);
 }
 
+bool QuicCryptoServerConfig::HasValidSourceAddressToken(
+    const CryptoHandshakeMessage& client_hello,
+    const IPEndPoint& client_ip,
+    QuicWallTime now) const {
+  StringPiece srct;
+  return client_hello.GetStringPiece(kSourceAddressTokenTag, &srct) &&
+      ValidateSourceAddressToken(srct, client_ip, now);
+}
+
 string QuicCryptoServerConfig::NewSourceAddressToken(
     const IPEndPoint& ip,
     QuicRandom* rand,
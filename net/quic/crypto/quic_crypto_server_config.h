@@ -269,6 +269,13 @@ class NET_EXPORT_PRIVATE QuicCryptoServerConfig {
   // Set and take ownership of the callback to invoke on primary config changes.
   void AcquirePrimaryConfigChangedCb(PrimaryConfigChangedCallback* cb);
 
+  // HasValidSourceAddressToken returns true if |client_hello| carries a valid
+  // and timely source-address token for |client_ip| at |now|. It needs no
+  // per-connection state, so it may be called before a session exists.
+  bool HasValidSourceAddressToken(const CryptoHandshakeMessage& client_hello,
+                                  const IPEndPoint& client_ip,
+                                  QuicWallTime now) const;
+
  private:
   friend class test::QuicCryptoServerConfigPeer;
 
@@ -236,6 +236,29 @@ TEST(QuicCryptoServerConfigTest, SourceAddressTokens) {
   EXPECT_FALSE(peer.ValidateSourceAddressToken(token4, ip4, now));
 }
 
+TEST(QuicCryptoServerConfigTest, HasValidSourceAddressToken) {
+  QuicRandom* rand = QuicRandom::GetInstance();
+  QuicCryptoServerConfig server(QuicCryptoServerConfig::TESTING, rand);
+  IPAddressNumber ip;
+  CHECK(ParseIPLiteralToNumber("192.0.2.33", &ip));
+  IPEndPoint ip4 = IPEndPoint(ip, 1);
+  CHECK(ParseIPLiteralToNumber("192.0.2.34", &ip));
+  IPEndPoint other_ip4 = IPEndPoint(ip, 1);
+  MockClock clock;
+  clock.AdvanceTime(QuicTime::Delta::FromSeconds(1000000));
+  QuicCryptoServerConfigPeer peer(&server);
+  QuicWallTime now = clock.WallNow();
+
+  CryptoHandshakeMessage chlo;
+  chlo.set_tag(kCHLO);
+  EXPECT_FALSE(server.HasValidSourceAddressToken(chlo, ip4, now));
+
+  chlo.SetStringPiece(kSourceAddressTokenTag,
+                      peer.NewSourceAddressToken(ip4, rand, now));
+  EXPECT_TRUE(server.HasValidSourceAddressToken(chlo, ip4, now));
+  EXPECT_FALSE(server.HasValidSourceAddressToken(chlo, other_ip4, now));
+}
+
 class CryptoServerConfigsTest : public ::testing::Test {
  public:
   CryptoServerConfigsTest()
@@ -44,6 +44,11 @@ class NET_EXPORT_PRIVATE QuicServerInfo {
   // but, obviously, a callback will never be made.
   virtual int WaitForDataReady(const CompletionCallback& callback) = 0;
 
+  // Cancels the callback passed to a pending WaitForDataReady, so that it will
+  // not be called. The load itself continues, so the data may still be used
+  // once it is ready.
+  virtual void CancelWaitForDataReadyCallback() = 0;
+
   // Returns true if data is loaded from disk cache and ready (WaitForDataReady
   // doesn't have a pending callback).
   virtual bool IsDataReady() = 0;
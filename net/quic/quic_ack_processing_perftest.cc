@@ -0,0 +1,82 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "base/test/perf_time_logger.h"
+#include "net/quic/quic_received_packet_manager.h"
+#include "net/quic/quic_unacked_packet_map.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace test {
+namespace {
+
+// Enough packets to keep a 1Gbps link with a 100ms RTT busy.
+const QuicPacketSequenceNumber kPacketsInFlight = 10000;
+const QuicPacketSequenceNumber kNumPackets = 1000000;
+// Every kLossInterval'th packet is missing from the acks.
+const QuicPacketSequenceNumber kLossInterval = 100;
+
+TEST(QuicAckProcessingPerfTest, UnackedPacketMap) {
+  QuicUnackedPacketMap unacked_packets(false);
+  base::PerfTimeLogger timer("QuicUnackedPacketMap_send_and_ack");
+  for (QuicPacketSequenceNumber i = 1; i <= kNumPackets; ++i) {
+    unacked_packets.AddPacket(SerializedPacket(
+        i, PACKET_6BYTE_SEQUENCE_NUMBER, NULL, 0,
+        new RetransmittableFrames()));
+    unacked_packets.SetPending(i, QuicTime::Zero(), kDefaultMaxPacketSize);
+    if (i <= kPacketsInFlight) {
+      continue;
+    }
+    // Ack the oldest packet, and drop the lost packet before it.
+    QuicPacketSequenceNumber acked = i - kPacketsInFlight;
+    if (acked % kLossInterval == 0) {
+      unacked_packets.NackPacket(acked, 3);
+      unacked_packets.SetNotPending(acked);
+      continue;
+    }
+    unacked_packets.SetNotPending(acked);
+    unacked_packets.RemovePacket(acked);
+    if (acked % kLossInterval == 1 && acked > kLossInterval) {
+      unacked_packets.RemovePacket(acked - 1);
+    }
+    QuicUnackedPacketMap::const_iterator next =
+        unacked_packets.lower_bound(acked);
+    ASSERT_TRUE(next != unacked_packets.end());
+  }
+  timer.Done();
+  EXPECT_GE(kPacketsInFlight + 1, unacked_packets.GetNumUnackedPackets());
+}
+
+TEST(QuicAckProcessingPerfTest, ReceivedPacketManager) {
+  QuicReceivedPacketManager received_manager(kTCP);
+  base::PerfTimeLogger timer("QuicReceivedPacketManager_record_packets");
+  QuicPacketHeader header;
+  for (QuicPacketSequenceNumber i = 1; i <= kNumPackets; ++i) {
+    if (i % kLossInterval == 0) {
+      continue;
+    }
+    header.packet_sequence_number = i;
+    header.entropy_hash = static_cast<QuicPacketEntropyHash>(i);
+    received_manager.RecordPacketReceived(kDefaultMaxPacketSize, header,
+                                          QuicTime::Zero());
+    if (i % 2 == 0) {
+      ReceivedPacketInfo received_info;
+      received_manager.UpdateReceivedPacketInfo(&received_info,
+                                                QuicTime::Zero());
+    }
+    // The peer stops waiting for packets once they are well out of the window.
+    if (i > kPacketsInFlight && i % 1000 == 0) {
+      SentPacketInfo sent_info;
+      sent_info.least_unacked = i - kPacketsInFlight;
+      sent_info.entropy_hash =
+          received_manager.EntropyHash(sent_info.least_unacked - 1);
+      received_manager.UpdatePacketInformationSentByPeer(sent_info);
+    }
+  }
+  timer.Done();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace net
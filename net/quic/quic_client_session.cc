@@ -41,6 +41,12 @@ void RecordHandshakeState(HandshakeState state) {
 
 }  // namespace
 
+// static
+void QuicClientSession::RecordMigrationStatus(MigrationStatus status) {
+  UMA_HISTOGRAM_ENUMERATION("Net.QuicSession.ConnectionMigration", status,
+                            MIGRATION_STATUS_MAX);
+}
+
 QuicClientSession::StreamRequest::StreamRequest() : stream_(NULL) {}
 
 QuicClientSession::StreamRequest::~StreamRequest() {
@@ -97,6 +103,7 @@ QuicClientSession::QuicClientSession(
       writer_(writer.Pass()),
       read_buffer_(new IOBufferWithSize(kMaxPacketSize)),
       read_pending_(false),
+      migration_pending_(false),
       num_total_streams_(0),
       net_log_(BoundNetLog::Make(net_log, NetLog::SOURCE_QUIC_SESSION)),
       logger_(net_log_),
@@ -141,6 +148,19 @@ QuicClientSession::~QuicClientSession() {
   UMA_HISTOGRAM_COUNTS("Net.QuicSession.NumTotalStreams", num_total_streams_);
   UMA_HISTOGRAM_COUNTS("Net.QuicNumSentClientHellos",
                        crypto_stream_->num_sent_client_hellos());
+
+  // Weigh the packets FEC recovered against the bytes it cost.
+  const QuicConnectionStats& stats = connection()->GetStats();
+  UMA_HISTOGRAM_COUNTS("Net.QuicSession.PacketsRevived",
+                       stats.packets_revived);
+  if (stats.fec_packets_sent > 0 && stats.bytes_sent > 0) {
+    UMA_HISTOGRAM_COUNTS("Net.QuicSession.FecPacketsSent",
+                         stats.fec_packets_sent);
+    UMA_HISTOGRAM_PERCENTAGE(
+        "Net.QuicSession.FecOverheadPercent",
+        static_cast<int>(stats.fec_bytes_sent * 100 / stats.bytes_sent));
+  }
+
   if (!IsCryptoHandshakeConfirmed())
     return;
 
@@ -152,6 +172,9 @@ QuicClientSession::~QuicClientSession() {
   if (round_trip_handshakes < 0 || !stream_factory_)
     return;
 
+  UMA_HISTOGRAM_BOOLEAN("Net.QuicSession.ZeroRttHandshake",
+                        round_trip_handshakes == 0);
+
   bool port_selected = stream_factory_->enable_port_selection();
   SSLInfo ssl_info;
   if (!crypto_stream_->GetSSLInfo(&ssl_info) || !ssl_info.cert) {
@@ -406,6 +429,11 @@ void QuicClientSession::OnConnectionClosed(QuicErrorCode error,
     }
   }
 
+  if (migration_pending_) {
+    migration_pending_ = false;
+    RecordMigrationStatus(MIGRATION_STATUS_PATH_NOT_VALIDATED);
+  }
+
   UMA_HISTOGRAM_SPARSE_SLOWLY("Net.QuicSession.QuicVersion",
                               connection()->version());
   NotifyFactoryOfSessionGoingAway();
@@ -454,6 +482,24 @@ void QuicClientSession::StartReading() {
   }
 }
 
+void QuicClientSession::MigrateToSocket(
+    scoped_ptr<DatagramClientSocket> socket,
+    scoped_ptr<QuicDefaultPacketWriter> writer) {
+  DCHECK(connection()->connected());
+  // Closing the old socket cancels its pending read.
+  socket_->Close();
+  socket_ = socket.Pass();
+  writer_ = writer.Pass();
+  read_pending_ = false;
+
+  IPEndPoint local_address;
+  socket_->GetLocalAddress(&local_address);
+  migration_pending_ = true;
+  connection()->MigrateToPath(local_address, writer_.get());
+  if (connection()->connected())
+    StartReading();
+}
+
 void QuicClientSession::CloseSessionOnError(int error) {
   UMA_HISTOGRAM_SPARSE_SLOWLY("Net.QuicSession.CloseSessionOnError", -error);
   CloseSessionOnErrorInner(error, QUIC_INTERNAL_ERROR);
@@ -546,6 +592,10 @@ void QuicClientSession::OnReadComplete(int result) {
     NotifyFactoryOfSessionClosedLater();
     return;
   }
+  if (migration_pending_ && !connection()->path_validation_pending()) {
+    migration_pending_ = false;
+    RecordMigrationStatus(MIGRATION_STATUS_SUCCESS);
+  }
   StartReading();
 }
 
@@ -38,6 +38,18 @@ class QuicClientSessionPeer;
 
 class NET_EXPORT_PRIVATE QuicClientSession : public QuicSession {
  public:
+  // The outcome of moving a session to a new network.
+  // Note: these values must be kept in sync with the corresponding values in:
+  // tools/metrics/histograms/histograms.xml
+  enum MigrationStatus {
+    MIGRATION_STATUS_SUCCESS = 0,
+    MIGRATION_STATUS_NO_NEW_SOCKET = 1,
+    MIGRATION_STATUS_PATH_NOT_VALIDATED = 2,
+    MIGRATION_STATUS_MAX = 3
+  };
+
+  static void RecordMigrationStatus(MigrationStatus status);
+
   // An interface for observing events on a session.
   class NET_EXPORT_PRIVATE Observer {
    public:
@@ -143,6 +155,12 @@ class NET_EXPORT_PRIVATE QuicClientSession : public QuicSession {
   // and passing the data along to the QuicConnection.
   void StartReading();
 
+  // Moves the connection to |socket|, which must be connected to the same
+  // server, after the network changed. The old socket is closed, and the
+  // connection keeps its GUID and crypto state.
+  void MigrateToSocket(scoped_ptr<DatagramClientSocket> socket,
+                       scoped_ptr<QuicDefaultPacketWriter> writer);
+
   // Close the session because of |error| and notifies the factory
   // that this session has been closed, which will delete the session.
   void CloseSessionOnError(int error);
@@ -212,6 +230,8 @@ class NET_EXPORT_PRIVATE QuicClientSession : public QuicSession {
   ObserverSet observers_;
   StreamRequestQueue stream_requests_;
   bool read_pending_;
+  // True after MigrateToSocket() until the new path is validated.
+  bool migration_pending_;
   CompletionCallback callback_;
   size_t num_total_streams_;
   BoundNetLog net_log_;
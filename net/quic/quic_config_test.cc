@@ -69,6 +69,21 @@ TEST_F(QuicConfigTest, ToHandshakeMessageWithPacing) {
   EXPECT_EQ(kQBIC, out[1]);
 }
 
+TEST_F(QuicConfigTest, ToHandshakeMessageWithBbr) {
+  ValueRestore<bool> old_flag(&FLAGS_enable_quic_bbr, true);
+
+  config_.SetDefaults();
+  CryptoHandshakeMessage msg;
+  config_.ToHandshakeMessage(&msg);
+
+  const QuicTag* out;
+  size_t out_len;
+  EXPECT_EQ(QUIC_NO_ERROR, msg.GetTaglist(kCGST, &out, &out_len));
+  EXPECT_EQ(2u, out_len);
+  EXPECT_EQ(kTBBR, out[0]);
+  EXPECT_EQ(kQBIC, out[1]);
+}
+
 TEST_F(QuicConfigTest, ProcessClientHello) {
   QuicConfig client_config;
   QuicTagVector cgst;
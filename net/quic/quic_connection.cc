@@ -104,7 +104,7 @@ class SendAlarm : public QuicAlarm::Delegate {
   }
 
   virtual QuicTime OnAlarm() OVERRIDE {
-    connection_->WriteIfNotBlocked();
+    connection_->OnSendAlarm();
     // Never reschedule the alarm, since CanWrite does that.
     return QuicTime::Zero();
   }
@@ -113,6 +113,24 @@ class SendAlarm : public QuicAlarm::Delegate {
   QuicConnection* connection_;
 };
 
+// An alarm that is scheduled when the connection can still write and there
+// may be more data to send.
+class ResumeWritesAlarm : public QuicAlarm::Delegate {
+ public:
+  explicit ResumeWritesAlarm(QuicConnection* connection)
+      : connection_(connection) {
+  }
+
+  virtual QuicTime OnAlarm() OVERRIDE {
+    connection_->WriteIfNotBlocked();
+    // Never reschedule the alarm, since OnCanWrite does that.
+    return QuicTime::Zero();
+  }
+
+ private:
+  QuicConnection* connection_;
+};
+
 class TimeoutAlarm : public QuicAlarm::Delegate {
  public:
   explicit TimeoutAlarm(QuicConnection* connection)
@@ -186,7 +204,8 @@ QuicConnection::QuicConnection(QuicGuid guid,
       ack_alarm_(helper->CreateAlarm(new AckAlarm(this))),
       retransmission_alarm_(helper->CreateAlarm(new RetransmissionAlarm(this))),
       send_alarm_(helper->CreateAlarm(new SendAlarm(this))),
-      resume_writes_alarm_(helper->CreateAlarm(new SendAlarm(this))),
+      send_alarm_deadline_(QuicTime::Zero()),
+      resume_writes_alarm_(helper->CreateAlarm(new ResumeWritesAlarm(this))),
       timeout_alarm_(helper->CreateAlarm(new TimeoutAlarm(this))),
       debug_visitor_(NULL),
       packet_creator_(guid_, &framer_, random_generator_, is_server),
@@ -202,11 +221,13 @@ QuicConnection::QuicConnection(QuicGuid guid,
       version_negotiation_state_(START_NEGOTIATION),
       is_server_(is_server),
       connected_(true),
-      address_migrating_(false) {
+      address_migrating_(false),
+      path_validation_pending_(false) {
   if (!is_server_) {
     // Pacing will be enabled if the client negotiates it.
     sent_packet_manager_.MaybeEnablePacing();
   }
+  packet_generator_.set_adaptive_fec(FLAGS_enable_quic_adaptive_fec);
   DVLOG(1) << ENDPOINT << "Created connection with guid: " << guid;
   timeout_alarm_->Set(clock_->ApproximateNow().Add(idle_network_timeout_));
   framer_.set_visitor(this);
@@ -418,6 +439,15 @@ bool QuicConnection::OnPacketHeader(const QuicPacketHeader& header) {
     return false;
   }
 
+  if (address_migrating_ && !MaybeMigrateAddress(header)) {
+    return false;
+  }
+  if (path_validation_pending_) {
+    DVLOG(1) << ENDPOINT << "Validated path from "
+             << self_address_.ToString();
+    path_validation_pending_ = false;
+  }
+
   if (version_negotiation_state_ != NEGOTIATED_VERSION) {
     if (is_server_) {
       if (!header.public_header.version_flag) {
@@ -507,6 +537,8 @@ void QuicConnection::ProcessAckFrame(const QuicAckFrame& incoming_ack) {
   bool reset_retransmission_alarm =
       sent_packet_manager_.OnIncomingAck(incoming_ack.received_info,
                                          time_of_last_received_packet_);
+  // The ack may have declared packets lost.
+  packet_generator_.UpdateFecGroupSize(stats_);
   if (sent_packet_manager_.HasPendingRetransmissions()) {
     WriteIfNotBlocked();
   }
@@ -836,8 +868,7 @@ void QuicConnection::MaybeSendInResponseToPacket() {
     send_alarm_->Cancel();
     WriteIfNotBlocked();
   } else if (!delay.IsInfinite()) {
-    send_alarm_->Cancel();
-    send_alarm_->Set(time_of_last_received_packet_.Add(delay));
+    SetSendAlarm(time_of_last_received_packet_.Add(delay));
   }
 }
 
@@ -934,6 +965,8 @@ void QuicConnection::ProcessUdpPacket(const IPEndPoint& self_address,
   last_size_ = packet.length();
 
   address_migrating_ = false;
+  last_self_address_ = self_address;
+  last_peer_address_ = peer_address;
 
   if (peer_address_.address().empty()) {
     peer_address_ = peer_address;
@@ -1011,12 +1044,6 @@ void QuicConnection::WriteIfNotBlocked() {
 }
 
 bool QuicConnection::ProcessValidatedPacket() {
-  if (address_migrating_) {
-    SendConnectionCloseWithDetails(
-        QUIC_ERROR_MIGRATING_ADDRESS,
-        "Address migration is not yet a supported feature");
-    return false;
-  }
   time_of_last_received_packet_ = clock_->Now();
   DVLOG(1) << ENDPOINT << "time of last received packet: "
            << time_of_last_received_packet_.ToDebuggingValue();
@@ -1028,6 +1055,46 @@ bool QuicConnection::ProcessValidatedPacket() {
   return true;
 }
 
+bool QuicConnection::MaybeMigrateAddress(const QuicPacketHeader& header) {
+  if (!(last_peer_address_ == peer_address_) && !is_server_) {
+    SendConnectionCloseWithDetails(
+        QUIC_ERROR_MIGRATING_ADDRESS,
+        "Server address migration is not supported");
+    return false;
+  }
+  // The framer has already decrypted the packet. Only move once keys are
+  // established, and only for a packet newer than any received so far, so
+  // that an old packet replayed from another address can not redirect the
+  // connection.
+  if (encryption_level_ == ENCRYPTION_NONE ||
+      header.packet_sequence_number <=
+          received_packet_manager_.largest_observed()) {
+    DVLOG(1) << ENDPOINT << "Ignoring packet "
+             << header.packet_sequence_number << " from new address "
+             << last_peer_address_.ToString();
+    return false;
+  }
+  DVLOG(1) << ENDPOINT << "Peer moved from " << peer_address_.ToString()
+           << " to " << last_peer_address_.ToString();
+  self_address_ = last_self_address_;
+  peer_address_ = last_peer_address_;
+  ++stats_.address_migrations;
+  return true;
+}
+
+void QuicConnection::MigrateToPath(const IPEndPoint& self_address,
+                                   QuicPacketWriter* writer) {
+  DCHECK(!is_server_);
+  DVLOG(1) << ENDPOINT << "Migrating from " << self_address_.ToString()
+           << " to " << self_address.ToString();
+  writer_ = writer;
+  self_address_ = self_address;
+  path_validation_pending_ = true;
+  ++stats_.address_migrations;
+  // Packets in flight were most likely lost with the old network.
+  RetransmitUnackedPackets(ALL_PACKETS);
+}
+
 void QuicConnection::WriteQueuedPackets() {
   DCHECK(!writer_->IsWriteBlocked());
 
@@ -1134,14 +1201,39 @@ bool QuicConnection::CanWrite(TransmissionType transmission_type,
 
   // If the scheduler requires a delay, then we can not send this packet now.
   if (!delay.IsZero()) {
-    send_alarm_->Cancel();
-    send_alarm_->Set(now.Add(delay));
+    SetSendAlarm(now.Add(delay));
     DVLOG(1) << "Delaying sending.";
     return false;
   }
   return true;
 }
 
+void QuicConnection::SetSendAlarm(QuicTime deadline) {
+  // Every ack moves the pacing deadline a little, so leave the alarm alone
+  // unless the deadline moves by more than a pacing quantum.
+  const QuicTime::Delta quantum =
+      QuicTime::Delta::FromMicroseconds(kPacingQuantumUs);
+  if (send_alarm_->IsSet() &&
+      deadline.Subtract(quantum) <= send_alarm_deadline_ &&
+      send_alarm_deadline_ <= deadline.Add(quantum)) {
+    return;
+  }
+  send_alarm_->Cancel();
+  send_alarm_->Set(deadline);
+  send_alarm_deadline_ = deadline;
+  ++stats_.send_alarms_set;
+}
+
+void QuicConnection::OnSendAlarm() {
+  ++stats_.send_alarms_fired;
+  QuicTime now = clock_->Now();
+  if (now > send_alarm_deadline_) {
+    stats_.send_alarm_delay_us +=
+        now.Subtract(send_alarm_deadline_).ToMicroseconds();
+  }
+  WriteIfNotBlocked();
+}
+
 bool QuicConnection::WritePacket(QueuedPacket packet) {
   QuicPacketSequenceNumber sequence_number = packet.sequence_number;
   if (ShouldDiscardPacket(packet.encryption_level,
@@ -1351,6 +1443,10 @@ bool QuicConnection::OnSerializedPacket(
         set_encryption_level(encryption_level_);
   }
   sent_packet_manager_.OnSerializedPacket(serialized_packet);
+  if (serialized_packet.packet->is_fec_packet()) {
+    ++stats_.fec_packets_sent;
+    stats_.fec_bytes_sent += serialized_packet.packet->length();
+  }
   // The TransmissionType is NOT_RETRANSMISSION because all retransmissions
   // serialize packets and invoke SendOrQueuePacket directly.
   return SendOrQueuePacket(encryption_level_,
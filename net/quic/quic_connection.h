@@ -271,6 +271,10 @@ class NET_EXPORT_PRIVATE QuicConnection
   // If the socket is not blocked, writes queued packets.
   void WriteIfNotBlocked();
 
+  // Called when the pacing send alarm fires.  Records how late it fired in
+  // the connection stats and writes queued packets.
+  void OnSendAlarm();
+
   // Do any work which logically would be done in OnPacket but can not be
   // safely done until the packet is validated.  Returns true if the packet
   // can be handled, false otherwise.
@@ -329,10 +333,27 @@ class NET_EXPORT_PRIVATE QuicConnection
   }
   const IPEndPoint& self_address() const { return self_address_; }
   const IPEndPoint& peer_address() const { return peer_address_; }
+
+  // Moves a client connection to a new local address after the client has
+  // rebound its socket, for example because the default network changed.
+  // |writer| replaces the current writer and is not owned. The GUID and
+  // crypto state are kept, and packets still in flight on the old path are
+  // retransmitted on the new one. The path is validated once a packet from
+  // the server arrives on it, which shows the server has followed.
+  void MigrateToPath(const IPEndPoint& self_address, QuicPacketWriter* writer);
+
+  // Returns true after MigrateToPath() until the new path is validated.
+  bool path_validation_pending() const { return path_validation_pending_; }
   QuicGuid guid() const { return guid_; }
   const QuicClock* clock() const { return clock_; }
   QuicRandom* random_generator() const { return random_generator_; }
 
+  // Creates an alarm on the connection's helper, for the use of its streams.
+  // The caller owns the alarm.
+  QuicAlarm* CreateAlarm(QuicAlarm::Delegate* delegate) {
+    return helper_->CreateAlarm(delegate);
+  }
+
   QuicPacketCreator::Options* options() { return packet_creator_.options(); }
 
   bool connected() const { return connected_; }
@@ -509,6 +530,11 @@ class NET_EXPORT_PRIVATE QuicConnection
   // Sends a version negotiation packet to the peer.
   void SendVersionNegotiationPacket();
 
+  // Called for a new data packet that arrived on different addresses.
+  // Follows the peer to its new address, and returns false if the packet
+  // should be dropped.
+  bool MaybeMigrateAddress(const QuicPacketHeader& header);
+
   // Clears any accumulated frames from the last received packet.
   void ClearLastFrames();
 
@@ -567,6 +593,10 @@ class NET_EXPORT_PRIVATE QuicConnection
   // acks and pending writes if an ack opened the congestion window.
   void MaybeSendInResponseToPacket();
 
+  // Sets |send_alarm_| to fire at |deadline|, unless it is already set within
+  // a pacing quantum of |deadline|.
+  void SetSendAlarm(QuicTime deadline);
+
   // Gets the least unacked sequence number, which is the next sequence number
   // to be sent if there are no outstanding packets.
   QuicPacketSequenceNumber GetLeastUnacked() const;
@@ -648,6 +678,9 @@ class NET_EXPORT_PRIVATE QuicConnection
   // An alarm that is scheduled when the sent scheduler requires a
   // a delay before sending packets and fires when the packet may be sent.
   scoped_ptr<QuicAlarm> send_alarm_;
+  // The deadline |send_alarm_| was last set to.  QuicAlarm clears its own
+  // deadline before firing, so this is kept to measure pacing accuracy.
+  QuicTime send_alarm_deadline_;
   // An alarm that is scheduled when the connection can still write and there
   // may be more data to send.
   scoped_ptr<QuicAlarm> resume_writes_alarm_;
@@ -699,6 +732,13 @@ class NET_EXPORT_PRIVATE QuicConnection
   // Set to true if the udp packet headers have a new self or peer address.
   // This is checked later on validating a data or version negotiation packet.
   bool address_migrating_;
+  // The addresses of the packet being processed.
+  IPEndPoint last_self_address_;
+  IPEndPoint last_peer_address_;
+
+  // True if the client migrated to a new path, and has not yet received a
+  // packet on it.
+  bool path_validation_pending_;
 
   // If non-empty this contains the set of versions received in a
   // version negotiation packet.
@@ -19,11 +19,17 @@ QuicConnectionStats::QuicConnectionStats()
       packets_retransmitted(0),
       packets_spuriously_retransmitted(0),
       packets_lost(0),
+      fec_packets_sent(0),
+      fec_bytes_sent(0),
       packets_revived(0),
       packets_dropped(0),
       crypto_retransmit_count(0),
       tlp_count(0),
       rto_count(0),
+      address_migrations(0),
+      send_alarms_set(0),
+      send_alarms_fired(0),
+      send_alarm_delay_us(0),
       rtt(0),
       estimated_bandwidth(0) {
 }
@@ -42,11 +48,17 @@ ostream& operator<<(ostream& os, const QuicConnectionStats& s) {
      << ", packets_spuriously_retransmitted: "
      << s.packets_spuriously_retransmitted
      << ", packets lost: " << s.packets_lost
+     << ", fec packets sent: " << s.fec_packets_sent
+     << ", fec bytes sent: " << s.fec_bytes_sent
      << ", packets revived: " << s.packets_revived
      << ", packets dropped:" << s.packets_dropped
      << ", crypto retransmit count: " << s.crypto_retransmit_count
      << ", rto count: " << s.rto_count
      << ", tlp count: " << s.tlp_count
+     << ", address migrations: " << s.address_migrations
+     << ", send alarms set: " << s.send_alarms_set
+     << ", send alarms fired: " << s.send_alarms_fired
+     << ", send alarm delay(us): " << s.send_alarm_delay_us
      << ", rtt(us): " << s.rtt
      << ", estimated_bandwidth: " << s.estimated_bandwidth
      << "}\n";
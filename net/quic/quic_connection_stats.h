@@ -44,11 +44,23 @@ struct NET_EXPORT_PRIVATE QuicConnectionStats {
   uint32 packets_spuriously_retransmitted;
   uint32 packets_lost;
 
+  // FEC packets sent, and their size before encryption. This is the cost of
+  // the packets revived by the peer.
+  uint32 fec_packets_sent;
+  uint64 fec_bytes_sent;
   uint32 packets_revived;
   uint32 packets_dropped;  // duplicate or less than least unacked.
   uint32 crypto_retransmit_count;
   uint32 tlp_count;
   uint32 rto_count;
+  // Number of times the connection moved to a new self or peer address.
+  uint32 address_migrations;
+
+  // Number of times the pacing send alarm was set and fired, and the total
+  // time by which it fired after its deadline, in microseconds.
+  uint32 send_alarms_set;
+  uint32 send_alarms_fired;
+  uint64 send_alarm_delay_us;
 
   uint32 rtt;  // In microseconds
   uint64 estimated_bandwidth;
@@ -635,6 +635,16 @@ class QuicConnectionTest : public ::testing::TestWithParam<bool> {
     return encrypted->length();
   }
 
+  void ProcessDataPacketFrom(QuicPacketSequenceNumber number,
+                             const IPEndPoint& self_address,
+                             const IPEndPoint& peer_address) {
+    scoped_ptr<QuicPacket> packet(ConstructDataPacket(number, 0,
+                                                      !kEntropyFlag));
+    scoped_ptr<QuicEncryptedPacket> encrypted(framer_.EncryptPacket(
+        ENCRYPTION_NONE, number, *packet));
+    connection_.ProcessUdpPacket(self_address, peer_address, *encrypted);
+  }
+
   void ProcessClosePacket(QuicPacketSequenceNumber number,
                           QuicFecGroupNumber fec_group) {
     scoped_ptr<QuicPacket> packet(ConstructClosePacket(number, fec_group));
@@ -981,6 +991,79 @@ TEST_F(QuicConnectionTest, RejectPacketTooFarOut) {
       QuicConnectionPeer::GetConnectionClosePacket(&connection_) == NULL);
 }
 
+TEST_F(QuicConnectionTest, ClientClosesOnServerAddressChange) {
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  IPEndPoint self_address(Loopback4(), 1000);
+  EXPECT_CALL(visitor_, OnStreamFrames(_)).WillOnce(Return(true));
+  ProcessDataPacketFrom(1, self_address, IPEndPoint(Loopback4(), 443));
+
+  EXPECT_CALL(visitor_,
+              OnConnectionClosed(QUIC_ERROR_MIGRATING_ADDRESS, false));
+  ProcessDataPacketFrom(2, self_address, IPEndPoint(Loopback4(), 444));
+  EXPECT_FALSE(connection_.connected());
+}
+
+TEST_F(QuicConnectionTest, IgnoreNewAddressBeforeEncryption) {
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  IPEndPoint peer_address(Loopback4(), 443);
+  IPEndPoint self_address(Loopback4(), 1000);
+  EXPECT_CALL(visitor_, OnStreamFrames(_)).WillOnce(Return(true));
+  ProcessDataPacketFrom(1, self_address, peer_address);
+
+  ProcessDataPacketFrom(2, IPEndPoint(Loopback4(), 1001), peer_address);
+  EXPECT_TRUE(connection_.connected());
+  EXPECT_TRUE(self_address == connection_.self_address());
+  EXPECT_EQ(0u, connection_.GetStats().address_migrations);
+}
+
+TEST_F(QuicConnectionTest, FollowNewSelfAddress) {
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  connection_.SetEncrypter(ENCRYPTION_INITIAL, new NullEncrypter());
+  connection_.SetDefaultEncryptionLevel(ENCRYPTION_INITIAL);
+  IPEndPoint peer_address(Loopback4(), 443);
+  EXPECT_CALL(visitor_, OnStreamFrames(_)).WillOnce(Return(true));
+  ProcessDataPacketFrom(2, IPEndPoint(Loopback4(), 1000), peer_address);
+
+  // An older packet on a new address may be a replay, and is dropped.
+  IPEndPoint new_self_address(Loopback4(), 1001);
+  ProcessDataPacketFrom(1, new_self_address, peer_address);
+  EXPECT_EQ(0u, connection_.GetStats().address_migrations);
+
+  EXPECT_CALL(visitor_, OnStreamFrames(_)).WillOnce(Return(true));
+  ProcessDataPacketFrom(3, new_self_address, peer_address);
+  EXPECT_TRUE(connection_.connected());
+  EXPECT_TRUE(new_self_address == connection_.self_address());
+  EXPECT_EQ(1u, connection_.GetStats().address_migrations);
+}
+
+TEST_F(QuicConnectionTest, MigrateToPath) {
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  connection_.SetEncrypter(ENCRYPTION_INITIAL, new NullEncrypter());
+  connection_.SetDefaultEncryptionLevel(ENCRYPTION_INITIAL);
+  IPEndPoint peer_address(Loopback4(), 443);
+  EXPECT_CALL(visitor_, OnStreamFrames(_)).WillOnce(Return(true));
+  ProcessDataPacketFrom(1, IPEndPoint(Loopback4(), 1000), peer_address);
+  SendStreamDataToPeer(3, "foo", 0, !kFin, NULL);
+  EXPECT_FALSE(connection_.path_validation_pending());
+
+  // The packet in flight is retransmitted through the new writer.
+  TestPacketWriter new_writer;
+  IPEndPoint new_self_address(Loopback4(), 1001);
+  EXPECT_CALL(*send_algorithm_, OnPacketAbandoned(_, _)).Times(1);
+  connection_.MigrateToPath(new_self_address, &new_writer);
+  EXPECT_TRUE(connection_.path_validation_pending());
+  EXPECT_TRUE(new_self_address == connection_.self_address());
+  EXPECT_EQ(1u, new_writer.packets_write_attempts());
+  EXPECT_EQ(1u, connection_.GetStats().address_migrations);
+
+  // A packet from the server on the new path validates it.
+  EXPECT_CALL(visitor_, OnStreamFrames(_)).WillOnce(Return(true));
+  ProcessDataPacketFrom(2, new_self_address, peer_address);
+  EXPECT_TRUE(connection_.connected());
+  EXPECT_FALSE(connection_.path_validation_pending());
+  EXPECT_EQ(1u, connection_.GetStats().address_migrations);
+}
+
 TEST_F(QuicConnectionTest, TruncatedAck) {
   EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
   QuicPacketSequenceNumber num_packets = 256 * 2 + 1;
@@ -2509,6 +2592,44 @@ TEST_F(QuicConnectionTest, SendSchedulerDelayThenSend) {
   EXPECT_EQ(0u, connection_.NumQueuedPackets());
 }
 
+TEST_F(QuicConnectionTest, SendAlarmNotResetWithinPacingQuantum) {
+  EXPECT_CALL(visitor_, OnSuccessfulVersionNegotiation(_));
+  EXPECT_CALL(*send_algorithm_,
+              TimeUntilSend(_, NOT_RETRANSMISSION, _, _)).WillRepeatedly(
+                  testing::Return(QuicTime::Delta::FromMicroseconds(500)));
+  ProcessPacket(1);
+  ASSERT_TRUE(connection_.GetSendAlarm()->IsSet());
+  QuicTime deadline = connection_.GetSendAlarm()->deadline();
+  EXPECT_EQ(clock_.ApproximateNow().Add(
+                QuicTime::Delta::FromMicroseconds(500)), deadline);
+  uint32 alarms_set = connection_.GetStats().send_alarms_set;
+
+  // A packet received shortly after moves the pacing deadline by less than
+  // a quantum, so the alarm is left alone.
+  clock_.AdvanceTime(QuicTime::Delta::FromMicroseconds(200));
+  ProcessPacket(2);
+  EXPECT_EQ(deadline, connection_.GetSendAlarm()->deadline());
+  EXPECT_EQ(alarms_set, connection_.GetStats().send_alarms_set);
+
+  // A larger change reschedules the alarm.
+  EXPECT_CALL(*send_algorithm_,
+              TimeUntilSend(_, NOT_RETRANSMISSION, _, _)).WillRepeatedly(
+                  testing::Return(QuicTime::Delta::FromMilliseconds(5)));
+  ProcessPacket(3);
+  deadline = clock_.ApproximateNow().Add(QuicTime::Delta::FromMilliseconds(5));
+  EXPECT_EQ(deadline, connection_.GetSendAlarm()->deadline());
+  EXPECT_EQ(alarms_set + 1, connection_.GetStats().send_alarms_set);
+
+  // Firing the alarm late is recorded in the stats.
+  EXPECT_CALL(*send_algorithm_,
+              TimeUntilSend(_, NOT_RETRANSMISSION, _, _)).WillRepeatedly(
+                  testing::Return(QuicTime::Delta::Zero()));
+  clock_.AdvanceTime(QuicTime::Delta::FromMicroseconds(5100));
+  connection_.GetSendAlarm()->Fire();
+  EXPECT_EQ(1u, connection_.GetStats().send_alarms_fired);
+  EXPECT_EQ(100u, connection_.GetStats().send_alarm_delay_us);
+}
+
 TEST_F(QuicConnectionTest, SendSchedulerDelayThenRetransmit) {
   EXPECT_CALL(*send_algorithm_, TimeUntilSend(_, NOT_RETRANSMISSION, _, _))
       .WillRepeatedly(testing::Return(QuicTime::Delta::Zero()));
@@ -4,6 +4,7 @@
 
 #include "net/quic/quic_crypto_client_stream.h"
 
+#include "base/metrics/histogram.h"
 #include "net/base/completion_callback.h"
 #include "net/base/net_errors.h"
 #include "net/quic/crypto/crypto_protocol.h"
@@ -21,6 +22,40 @@ namespace net {
 
 namespace {
 
+// How long the handshake waits for the server config to be loaded from the
+// disk cache before it sends an inchoate client hello instead.
+const int64 kDiskCacheLoadTimeoutMs = 50;
+
+// Note: these values must be kept in sync with the corresponding values in:
+// tools/metrics/histograms/histograms.xml
+enum ServerInfoLoadResult {
+  SERVER_INFO_LOADED = 0,
+  SERVER_INFO_EMPTY = 1,
+  SERVER_INFO_LOAD_FAILED = 2,
+  SERVER_INFO_LOAD_TIMED_OUT = 3,
+  NUM_SERVER_INFO_LOAD_RESULTS = 4
+};
+
+void RecordServerInfoLoadResult(ServerInfoLoadResult result) {
+  UMA_HISTOGRAM_ENUMERATION("Net.QuicServerInfo.LoadResult", result,
+                            NUM_SERVER_INFO_LOAD_RESULTS);
+}
+
+class DiskCacheLoadAlarm : public QuicAlarm::Delegate {
+ public:
+  explicit DiskCacheLoadAlarm(QuicCryptoClientStream* stream)
+      : stream_(stream) {
+  }
+
+  virtual QuicTime OnAlarm() OVERRIDE {
+    stream_->OnDiskCacheLoadTimeout();
+    return QuicTime::Zero();
+  }
+
+ private:
+  QuicCryptoClientStream* stream_;
+};
+
 // Copies CertVerifyResult from |verify_details| to |cert_verify_result|.
 void CopyCertVerifyResult(
     const ProofVerifyDetails* verify_details,
@@ -83,6 +118,10 @@ QuicCryptoClientStream::~QuicCryptoClientStream() {
   if (proof_verify_callback_) {
     proof_verify_callback_->Cancel();
   }
+  if (next_state_ == STATE_LOAD_QUIC_SERVER_INFO_COMPLETE) {
+    crypto_config_->LookupOrCreate(server_hostname_)->quic_server_info()->
+        CancelWaitForDataReadyCallback();
+  }
 }
 
 void QuicCryptoClientStream::OnHandshakeMessage(
@@ -409,10 +448,24 @@ void QuicCryptoClientStream::DoHandshakeLoop(
 void QuicCryptoClientStream::OnIOComplete(int result) {
   DCHECK_EQ(STATE_LOAD_QUIC_SERVER_INFO_COMPLETE, next_state_);
   DCHECK_NE(ERR_IO_PENDING, result);
+  disk_cache_load_alarm_->Cancel();
   disk_cache_load_result_ = result;
   DoHandshakeLoop(NULL);
 }
 
+void QuicCryptoClientStream::OnDiskCacheLoadTimeout() {
+  if (next_state_ != STATE_LOAD_QUIC_SERVER_INFO_COMPLETE) {
+    return;
+  }
+  QuicCryptoClientConfig::CachedState* cached =
+      crypto_config_->LookupOrCreate(server_hostname_);
+  // The load carries on, so later connections can still use the data.
+  cached->quic_server_info()->CancelWaitForDataReadyCallback();
+  RecordServerInfoLoadResult(SERVER_INFO_LOAD_TIMED_OUT);
+  next_state_ = STATE_SEND_CHLO;
+  DoHandshakeLoop(NULL);
+}
+
 int QuicCryptoClientStream::DoLoadQuicServerInfo(
     QuicCryptoClientConfig::CachedState* cached) {
   next_state_ = STATE_SEND_CHLO;
@@ -438,7 +491,16 @@ int QuicCryptoClientStream::DoLoadQuicServerInfo(
 
   if (rv != ERR_IO_PENDING) {
     disk_cache_load_result_ = rv;
+    return rv;
+  }
+
+  if (!disk_cache_load_alarm_.get()) {
+    disk_cache_load_alarm_.reset(session()->connection()->CreateAlarm(
+        new DiskCacheLoadAlarm(this)));
   }
+  disk_cache_load_alarm_->Set(
+      session()->connection()->clock()->ApproximateNow().Add(
+          QuicTime::Delta::FromMilliseconds(kDiskCacheLoadTimeoutMs)));
   return rv;
 }
 
@@ -453,14 +515,20 @@ void QuicCryptoClientStream::DoLoadQuicServerInfoComplete(
     return;
   }
 
-  if (disk_cache_load_result_ != OK || !cached->LoadQuicServerInfo(
+  if (disk_cache_load_result_ != OK) {
+    RecordServerInfoLoadResult(SERVER_INFO_LOAD_FAILED);
+    return;
+  }
+  if (!cached->LoadQuicServerInfo(
           session()->connection()->clock()->WallNow())) {
     // It is ok to proceed to STATE_SEND_CHLO when we cannot load QuicServerInfo
     // from the disk cache.
     DCHECK(cached->IsEmpty());
     DVLOG(1) << "Empty server_config";
+    RecordServerInfoLoadResult(SERVER_INFO_EMPTY);
     return;
   }
+  RecordServerInfoLoadResult(SERVER_INFO_LOADED);
 
   ProofVerifier* verifier = crypto_config_->proof_verifier();
   if (!verifier) {
@@ -11,6 +11,7 @@
 #include "net/cert/x509_certificate.h"
 #include "net/quic/crypto/proof_verifier.h"
 #include "net/quic/crypto/quic_crypto_client_config.h"
+#include "net/quic/quic_alarm.h"
 #include "net/quic/quic_config.h"
 #include "net/quic/quic_crypto_stream.h"
 
@@ -50,6 +51,10 @@ class NET_EXPORT_PRIVATE QuicCryptoClientStream : public QuicCryptoStream {
 
   void OnIOComplete(int result);
 
+  // Called when the server config has not been loaded from the disk cache in
+  // time. The handshake goes ahead without it, taking an extra round trip.
+  void OnDiskCacheLoadTimeout();
+
  private:
   // ProofVerifierCallbackImpl is passed as the callback method to VerifyProof.
   // The ProofVerifier calls this class with the result of proof verification
@@ -132,6 +137,9 @@ class NET_EXPORT_PRIVATE QuicCryptoClientStream : public QuicCryptoStream {
   // It must not be used after STATE_LOAD_QUIC_SERVER_INFO_COMPLETE.
   int disk_cache_load_result_;
 
+  // Races the disk cache read against sending an inchoate client hello.
+  scoped_ptr<QuicAlarm> disk_cache_load_alarm_;
+
   DISALLOW_COPY_AND_ASSIGN(QuicCryptoClientStream);
 };
 
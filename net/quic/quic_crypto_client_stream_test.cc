@@ -10,6 +10,7 @@
 #include "net/quic/crypto/quic_encrypter.h"
 #include "net/quic/quic_protocol.h"
 #include "net/quic/test_tools/crypto_test_utils.h"
+#include "net/quic/test_tools/mock_quic_server_info.h"
 #include "net/quic/test_tools/quic_test_utils.h"
 #include "net/quic/test_tools/simple_quic_framer.h"
 #include "testing/gmock/include/gmock/gmock.h"
@@ -133,6 +134,46 @@ TEST_F(QuicCryptoClientStreamTest, ExpiredServerConfig) {
   ASSERT_EQ(1u, connection_->packets_.size());
 }
 
+TEST_F(QuicCryptoClientStreamTest, DiskCacheLoadTimeout) {
+  MockQuicServerInfoFactory server_info_factory;
+  crypto_config_.Create(kServerHostname, &server_info_factory);
+  MockQuicServerInfo* server_info = server_info_factory.last_server_info();
+
+  // The client hello waits for the disk cache.
+  EXPECT_TRUE(stream_->CryptoConnect());
+  EXPECT_TRUE(connection_->packets_.empty());
+  EXPECT_TRUE(server_info->has_pending_callback());
+
+  // When the load takes too long, an inchoate client hello is sent instead.
+  stream_->OnDiskCacheLoadTimeout();
+  EXPECT_FALSE(server_info->has_pending_callback());
+  EXPECT_EQ(1, stream_->num_sent_client_hellos());
+  EXPECT_EQ(1u, connection_->packets_.size());
+
+  // The load still completes, for later connections.
+  server_info->CompleteLoad();
+  EXPECT_TRUE(server_info->IsDataReady());
+  EXPECT_EQ(1, stream_->num_sent_client_hellos());
+}
+
+TEST_F(QuicCryptoClientStreamTest, DiskCacheLoadBeforeTimeout) {
+  MockQuicServerInfoFactory server_info_factory;
+  crypto_config_.Create(kServerHostname, &server_info_factory);
+  MockQuicServerInfo* server_info = server_info_factory.last_server_info();
+
+  EXPECT_TRUE(stream_->CryptoConnect());
+  EXPECT_TRUE(connection_->packets_.empty());
+
+  server_info->CompleteLoad();
+  EXPECT_EQ(1, stream_->num_sent_client_hellos());
+  EXPECT_EQ(1u, connection_->packets_.size());
+
+  // A timeout after the load is ignored.
+  stream_->OnDiskCacheLoadTimeout();
+  EXPECT_EQ(1, stream_->num_sent_client_hellos());
+  EXPECT_EQ(1u, connection_->packets_.size());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace net
@@ -4,15 +4,33 @@
 
 #include "net/quic/quic_packet_generator.h"
 
+#include <algorithm>
+
 #include "base/basictypes.h"
 #include "base/logging.h"
+#include "net/quic/quic_connection_stats.h"
 #include "net/quic/quic_fec_group.h"
 #include "net/quic/quic_utils.h"
 
 using base::StringPiece;
 
+// If true, QUIC connections protect headers and the tail of each write with
+// FEC, in groups sized from the observed loss rate.
+bool FLAGS_enable_quic_adaptive_fec = false;
+
 namespace net {
 
+namespace {
+
+// The loss rate is not trusted until this many packets have been sent.
+const uint32 kMinPacketsForLossRate = 10;
+// Below this loss rate, FEC costs more bandwidth than it saves in latency.
+const float kMinLossRateForFec = 0.01f;
+const size_t kMinFecGroupSize = 2;
+const size_t kMaxFecGroupSize = 20;
+
+}  // namespace
+
 class QuicAckNotifier;
 
 QuicPacketGenerator::QuicPacketGenerator(DelegateInterface* delegate,
@@ -23,7 +41,9 @@ QuicPacketGenerator::QuicPacketGenerator(DelegateInterface* delegate,
       packet_creator_(creator),
       batch_mode_(false),
       should_send_ack_(false),
-      should_send_feedback_(false) {
+      should_send_feedback_(false),
+      adaptive_fec_(false),
+      fec_group_size_(0) {
 }
 
 QuicPacketGenerator::~QuicPacketGenerator() {
@@ -96,6 +116,7 @@ QuicConsumedData QuicPacketGenerator::ConsumeData(QuicStreamId id,
   size_t data_size = data.TotalBufferSize();
   while (delegate_->ShouldGeneratePacket(NOT_RETRANSMISSION,
                                          HAS_RETRANSMITTABLE_DATA, handshake)) {
+    MaybeStartFecProtection(id, data.TotalBufferSize());
     QuicFrame frame;
     size_t bytes_consumed;
     if (notifier != NULL) {
@@ -181,6 +202,41 @@ void QuicPacketGenerator::SendQueuedFrames(bool flush) {
   }
 }
 
+void QuicPacketGenerator::UpdateFecGroupSize(
+    const QuicConnectionStats& stats) {
+  if (!adaptive_fec_ || stats.packets_sent < kMinPacketsForLossRate) {
+    return;
+  }
+  float loss_rate =
+      static_cast<float>(stats.packets_lost) / stats.packets_sent;
+  if (loss_rate < kMinLossRateForFec) {
+    fec_group_size_ = 0;
+    return;
+  }
+  // Aim for half a lost packet per group on average, so that most groups
+  // can recover their loss.
+  size_t group_size = stats.packets_sent / (2 * stats.packets_lost);
+  fec_group_size_ =
+      std::min(kMaxFecGroupSize, std::max(kMinFecGroupSize, group_size));
+}
+
+void QuicPacketGenerator::MaybeStartFecProtection(QuicStreamId id,
+                                                  size_t bytes_remaining) {
+  // An open group is left to close as usual. The packet header size depends
+  // on FEC, so it can only change before the first frame of a packet.
+  if (!adaptive_fec_ || packet_creator_->ShouldSendFec(true) ||
+      packet_creator_->HasPendingFrames()) {
+    return;
+  }
+  // Handshake packets change encryption level, so they are never protected.
+  bool protect = fec_group_size_ > 0 && id != kCryptoStreamId &&
+      (id == kHeadersStreamId ||
+       bytes_remaining <=
+           fec_group_size_ * packet_creator_->options()->max_packet_length);
+  packet_creator_->options()->max_packets_per_fec_group =
+      protect ? fec_group_size_ : 0;
+}
+
 bool QuicPacketGenerator::InBatchMode() {
   return batch_mode_;
 }
@@ -46,6 +46,11 @@
 // mode, we should probably set a timer so that several independent
 // operations can be grouped into the same FEC group.
 //
+// With adaptive FEC, the Generator chooses which packets to protect itself.
+// Only headers stream data and the last packets of each write are protected,
+// since those are the losses which cost a whole RTT to recover.  The group
+// size follows the loss rate, and FEC is off when there is little loss.
+//
 // When an FEC packet is generated, it will be send to the Delegate,
 // even if the Delegate has become unwritable after handling the
 // data packet immediately proceeding the FEC packet.
@@ -55,9 +60,12 @@
 
 #include "net/quic/quic_packet_creator.h"
 
+NET_EXPORT_PRIVATE extern bool FLAGS_enable_quic_adaptive_fec;
+
 namespace net {
 
 class QuicAckNotifier;
+struct QuicConnectionStats;
 
 class NET_EXPORT_PRIVATE QuicPacketGenerator {
  public:
@@ -127,7 +135,23 @@ class NET_EXPORT_PRIVATE QuicPacketGenerator {
     debug_delegate_ = debug_delegate;
   }
 
+  // If true, the generator decides which packets are FEC protected, and
+  // overrides the creator's max_packets_per_fec_group.
+  void set_adaptive_fec(bool adaptive_fec) { adaptive_fec_ = adaptive_fec; }
+
+  // Updates the FEC group size from the loss rate seen so far.
+  void UpdateFecGroupSize(const QuicConnectionStats& stats);
+
+  // The number of packets per FEC group with adaptive FEC, or 0 if the loss
+  // rate is too low for FEC to be worthwhile.
+  size_t fec_group_size() const { return fec_group_size_; }
+
  private:
+  // With adaptive FEC, starts protecting packets if the next packet is
+  // headers stream data, or is one of the last |fec_group_size_| packets
+  // of a write of |bytes_remaining| bytes.
+  void MaybeStartFecProtection(QuicStreamId id, size_t bytes_remaining);
+
   void SendQueuedFrames(bool flush);
 
   // Test to see if we have pending ack, feedback, or control frames.
@@ -162,6 +186,9 @@ class NET_EXPORT_PRIVATE QuicPacketGenerator {
   scoped_ptr<QuicAckFrame> pending_ack_frame_;
   scoped_ptr<QuicCongestionFeedbackFrame> pending_feedback_frame_;
 
+  bool adaptive_fec_;
+  size_t fec_group_size_;
+
   DISALLOW_COPY_AND_ASSIGN(QuicPacketGenerator);
 };
 
@@ -10,6 +10,7 @@
 #include "net/quic/crypto/null_encrypter.h"
 #include "net/quic/crypto/quic_decrypter.h"
 #include "net/quic/crypto/quic_encrypter.h"
+#include "net/quic/quic_connection_stats.h"
 #include "net/quic/quic_utils.h"
 #include "net/quic/test_tools/quic_test_utils.h"
 #include "net/quic/test_tools/simple_quic_framer.h"
@@ -485,6 +486,107 @@ TEST_F(QuicPacketGeneratorTest, ConsumeDataSendsFecAtEnd) {
   CheckPacketIsFec(packet3_, 1);
 }
 
+TEST_F(QuicPacketGeneratorTest, AdaptiveFecGroupSize) {
+  QuicConnectionStats stats;
+  stats.packets_sent = 100;
+  stats.packets_lost = 10;
+  // Without adaptive FEC the loss rate is ignored.
+  generator_.UpdateFecGroupSize(stats);
+  EXPECT_EQ(0u, generator_.fec_group_size());
+
+  generator_.set_adaptive_fec(true);
+  generator_.UpdateFecGroupSize(stats);
+  EXPECT_EQ(5u, generator_.fec_group_size());
+
+  // Heavy loss needs small groups, light loss allows large ones.
+  stats.packets_lost = 50;
+  generator_.UpdateFecGroupSize(stats);
+  EXPECT_EQ(2u, generator_.fec_group_size());
+  stats.packets_lost = 2;
+  generator_.UpdateFecGroupSize(stats);
+  EXPECT_EQ(20u, generator_.fec_group_size());
+
+  // FEC is turned off when there is little loss.
+  stats.packets_lost = 0;
+  generator_.UpdateFecGroupSize(stats);
+  EXPECT_EQ(0u, generator_.fec_group_size());
+
+  // Too few packets to estimate the loss rate.
+  stats.packets_sent = 5;
+  stats.packets_lost = 5;
+  generator_.UpdateFecGroupSize(stats);
+  EXPECT_EQ(0u, generator_.fec_group_size());
+}
+
+TEST_F(QuicPacketGeneratorTest, AdaptiveFecProtectsTailOfWrite) {
+  delegate_.SetCanWriteAnything();
+  generator_.set_adaptive_fec(true);
+  QuicConnectionStats stats;
+  stats.packets_sent = 100;
+  stats.packets_lost = 25;
+  generator_.UpdateFecGroupSize(stats);
+  ASSERT_EQ(2u, generator_.fec_group_size());
+
+  {
+    InSequence dummy;
+    EXPECT_CALL(delegate_, OnSerializedPacket(_)).WillOnce(
+        DoAll(SaveArg<0>(&packet_), Return(true)));
+    EXPECT_CALL(delegate_, OnSerializedPacket(_)).WillOnce(
+        DoAll(SaveArg<0>(&packet2_), Return(true)));
+    EXPECT_CALL(delegate_, OnSerializedPacket(_)).WillOnce(
+        DoAll(SaveArg<0>(&packet3_), Return(true)));
+    EXPECT_CALL(delegate_, OnSerializedPacket(_)).WillOnce(
+        DoAll(SaveArg<0>(&packet4_), Return(true)));
+    EXPECT_CALL(delegate_, OnSerializedPacket(_)).WillOnce(
+        DoAll(SaveArg<0>(&packet5_), Return(true)));
+  }
+
+  // Send enough data to create 4 packets: three full and one partial. Only
+  // the last two are protected.
+  size_t data_len = 3 * kDefaultMaxPacketSize + 100;
+  QuicConsumedData consumed =
+      generator_.ConsumeData(5, CreateData(data_len), 0, true, NULL);
+  EXPECT_EQ(data_len, consumed.bytes_consumed);
+  EXPECT_TRUE(consumed.fin_consumed);
+  EXPECT_FALSE(generator_.HasQueuedFrames());
+
+  PacketContents contents;
+  contents.num_stream_frames = 1;
+  CheckPacketContains(contents, packet_);
+  CheckPacketContains(contents, packet2_);
+  contents.fec_group = 3;
+  CheckPacketContains(contents, packet3_);
+  CheckPacketContains(contents, packet4_);
+  CheckPacketIsFec(packet5_, 3);
+}
+
+TEST_F(QuicPacketGeneratorTest, AdaptiveFecProtectsHeaders) {
+  delegate_.SetCanWriteAnything();
+  generator_.set_adaptive_fec(true);
+  QuicConnectionStats stats;
+  stats.packets_sent = 100;
+  stats.packets_lost = 10;
+  generator_.UpdateFecGroupSize(stats);
+
+  {
+    InSequence dummy;
+    EXPECT_CALL(delegate_, OnSerializedPacket(_)).WillOnce(
+        DoAll(SaveArg<0>(&packet_), Return(true)));
+    EXPECT_CALL(delegate_, OnSerializedPacket(_)).WillOnce(
+        DoAll(SaveArg<0>(&packet2_), Return(true)));
+  }
+
+  generator_.ConsumeData(kHeadersStreamId, MakeIOVector("headers"), 0, false,
+                         NULL);
+  EXPECT_FALSE(generator_.HasQueuedFrames());
+
+  PacketContents contents;
+  contents.num_stream_frames = 1;
+  contents.fec_group = 1;
+  CheckPacketContains(contents, packet_);
+  CheckPacketIsFec(packet2_, 1);
+}
+
 TEST_F(QuicPacketGeneratorTest, ConsumeData_FramesPreviouslyQueued) {
   // Set the packet size be enough for two stream frames with 0 stream offset,
   // but not enough for a stream frame of 0 offset and one with non-zero offset.
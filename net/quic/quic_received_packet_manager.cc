@@ -8,7 +8,6 @@
 #include "base/stl_util.h"
 #include "net/base/linked_hash_map.h"
 
-using std::make_pair;
 using std::max;
 using std::min;
 
@@ -27,7 +26,8 @@ const size_t kMaxPacketsAfterNewMissing = 4;
 
 QuicReceivedPacketManager::QuicReceivedPacketManager(
     CongestionFeedbackType congestion_type)
-    : packets_entropy_hash_(0),
+    : first_entropy_sequence_number_(0),
+      packets_entropy_hash_(0),
       largest_sequence_number_(0),
       peer_largest_observed_packet_(0),
       least_packet_awaited_by_peer_(1),
@@ -115,7 +115,19 @@ void QuicReceivedPacketManager::RecordPacketEntropyHash(
                << largest_sequence_number_;
     return;
   }
-  packets_entropy_.insert(make_pair(sequence_number, entropy_hash));
+  if (packets_entropy_.empty()) {
+    first_entropy_sequence_number_ = sequence_number;
+  }
+  while (sequence_number < first_entropy_sequence_number_) {
+    packets_entropy_.push_front(0);
+    --first_entropy_sequence_number_;
+  }
+  while (first_entropy_sequence_number_ + packets_entropy_.size() <=
+         sequence_number) {
+    packets_entropy_.push_back(0);
+  }
+  packets_entropy_[sequence_number - first_entropy_sequence_number_] =
+      entropy_hash;
   packets_entropy_hash_ ^= entropy_hash;
   DVLOG(2) << "setting cumulative received entropy hash to: "
            << static_cast<int>(packets_entropy_hash_)
@@ -136,22 +148,24 @@ QuicPacketEntropyHash QuicReceivedPacketManager::EntropyHash(
     return packets_entropy_hash_;
   }
 
-  ReceivedEntropyMap::const_iterator it =
-      packets_entropy_.upper_bound(sequence_number);
-  // When this map is empty we should only query entropy for
-  // received_info_.largest_observed, since no other entropy can be correctly
-  // calculated, because we're not storing the entropy for any prior packets.
+  // When no packet after |sequence_number| has been received we should only
+  // query entropy for received_info_.largest_observed, since no other entropy
+  // can be correctly calculated, because we're not storing the entropy for any
+  // prior packets.
   // TODO(rtenneti): add support for LOG_IF_EVERY_N_SEC to chromium.
-  // LOG_IF_EVERY_N_SEC(DFATAL, it == packets_entropy_.end(), 10)
-  LOG_IF(DFATAL, it == packets_entropy_.end())
+  // LOG_IF_EVERY_N_SEC(DFATAL, ..., 10)
+  QuicPacketSequenceNumber end_sequence_number =
+      first_entropy_sequence_number_ + packets_entropy_.size();
+  LOG_IF(DFATAL, sequence_number + 1 >= end_sequence_number)
       << "EntropyHash may be unknown. largest_received: "
       << received_info_.largest_observed
       << " sequence_number: " << sequence_number;
 
-  // TODO(satyamshekhar): Make this O(1).
   QuicPacketEntropyHash hash = packets_entropy_hash_;
-  for (; it != packets_entropy_.end(); ++it) {
-    hash ^= it->second;
+  for (QuicPacketSequenceNumber i =
+           max(sequence_number + 1, first_entropy_sequence_number_);
+       i < end_sequence_number; ++i) {
+    hash ^= packets_entropy_[i - first_entropy_sequence_number_];
   }
   return hash;
 }
@@ -168,17 +182,22 @@ void QuicReceivedPacketManager::RecalculateEntropyHash(
   }
   largest_sequence_number_ = peer_least_unacked;
   packets_entropy_hash_ = entropy_hash;
-  ReceivedEntropyMap::iterator it =
-      packets_entropy_.lower_bound(peer_least_unacked);
-  // TODO(satyamshekhar): Make this O(1).
-  for (; it != packets_entropy_.end(); ++it) {
-    packets_entropy_hash_ ^= it->second;
+  QuicPacketSequenceNumber end_sequence_number =
+      first_entropy_sequence_number_ + packets_entropy_.size();
+  for (QuicPacketSequenceNumber i =
+           max(peer_least_unacked, first_entropy_sequence_number_);
+       i < end_sequence_number; ++i) {
+    packets_entropy_hash_ ^=
+        packets_entropy_[i - first_entropy_sequence_number_];
   }
   // Discard entropies before least unacked.
-  packets_entropy_.erase(
-      packets_entropy_.begin(),
-      packets_entropy_.lower_bound(
-          min(peer_least_unacked, received_info_.largest_observed)));
+  QuicPacketSequenceNumber discard_before =
+      min(peer_least_unacked, received_info_.largest_observed);
+  while (!packets_entropy_.empty() &&
+         first_entropy_sequence_number_ < discard_before) {
+    packets_entropy_.pop_front();
+    ++first_entropy_sequence_number_;
+  }
 }
 
 void QuicReceivedPacketManager::UpdatePacketInformationReceivedByPeer(
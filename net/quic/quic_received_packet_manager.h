@@ -8,6 +8,8 @@
 #ifndef NET_QUIC_QUIC_RECEIVED_PACKET_MANAGER_H_
 #define NET_QUIC_QUIC_RECEIVED_PACKET_MANAGER_H_
 
+#include <deque>
+
 #include "net/quic/congestion_control/receive_algorithm_interface.h"
 #include "net/quic/quic_framer.h"
 #include "net/quic/quic_protocol.h"
@@ -74,6 +76,11 @@ class NET_EXPORT_PRIVATE QuicReceivedPacketManager :
   // packets of the largest observed.
   bool HasNewMissingPackets();
 
+  // Returns the largest sequence number received so far.
+  QuicPacketSequenceNumber largest_observed() const {
+    return received_info_.largest_observed;
+  }
+
   QuicPacketSequenceNumber peer_largest_observed_packet() {
     return peer_largest_observed_packet_;
   }
@@ -90,8 +97,7 @@ class NET_EXPORT_PRIVATE QuicReceivedPacketManager :
   friend class test::QuicConnectionPeer;
   friend class test::QuicReceivedPacketManagerPeer;
 
-  typedef std::map<QuicPacketSequenceNumber,
-                   QuicPacketEntropyHash> ReceivedEntropyMap;
+  typedef std::deque<QuicPacketEntropyHash> ReceivedEntropyHashes;
 
   // Record the received entropy hash against |sequence_number|.
   void RecordPacketEntropyHash(QuicPacketSequenceNumber sequence_number,
@@ -109,13 +115,13 @@ class NET_EXPORT_PRIVATE QuicReceivedPacketManager :
   // |least_unacked| unacked, false otherwise.
   bool DontWaitForPacketsBefore(QuicPacketSequenceNumber least_unacked);
 
-  // TODO(satyamshekhar): Can be optimized using an interval set like data
-  // structure.
-  // Map of received sequence numbers to their corresponding entropy.
-  // Every received packet has an entry, and packets without the entropy bit set
-  // have an entropy value of 0.
+  // Entropy of received packets, indexed by sequence number starting at
+  // |first_entropy_sequence_number_|.  Packets without the entropy bit set, and
+  // packets which have not been received, have an entropy value of 0.  The
+  // last entry is always a received packet.
   // TODO(ianswett): When the entropy flag is off, the entropy should not be 0.
-  ReceivedEntropyMap packets_entropy_;
+  ReceivedEntropyHashes packets_entropy_;
+  QuicPacketSequenceNumber first_entropy_sequence_number_;
 
   // Cumulative hash of entropy of all received packets.
   QuicPacketEntropyHash packets_entropy_hash_;
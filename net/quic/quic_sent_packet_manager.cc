@@ -6,6 +6,7 @@
 
 #include "base/logging.h"
 #include "base/stl_util.h"
+#include "net/quic/congestion_control/bbr_sender.h"
 #include "net/quic/congestion_control/pacing_sender.h"
 #include "net/quic/crypto/crypto_protocol.h"
 #include "net/quic/quic_ack_notifier_manager.h"
@@ -31,6 +32,10 @@ bool FLAGS_track_retransmission_history = false;
 // request pacing for the server to enable it.
 bool FLAGS_enable_quic_pacing = false;
 
+// If true, QUIC connections will offer the BBR-style send algorithm, and use
+// it when the peer offers it too.
+bool FLAGS_enable_quic_bbr = false;
+
 namespace net {
 namespace {
 static const int kDefaultRetransmissionTimeMs = 500;
@@ -81,7 +86,8 @@ QuicSentPacketManager::QuicSentPacketManager(bool is_server,
       consecutive_tlp_count_(0),
       consecutive_crypto_retransmission_count_(0),
       max_tail_loss_probes_(kDefaultMaxTailLossProbes),
-      using_pacing_(false) {
+      using_pacing_(false),
+      using_bbr_(false) {
 }
 
 QuicSentPacketManager::~QuicSentPacketManager() {
@@ -97,7 +103,9 @@ void QuicSentPacketManager::SetFromConfig(const QuicConfig& config) {
         QuicTime::Delta::FromMicroseconds(config.initial_round_trip_time_us());
     send_algorithm_->UpdateRtt(rtt_sample_);
   }
-  if (config.congestion_control() == kPACE) {
+  if (config.congestion_control() == kTBBR) {
+    MaybeEnableBbr();
+  } else if (config.congestion_control() == kPACE) {
     MaybeEnablePacing();
   }
   send_algorithm_->SetFromConfig(config, is_server_);
@@ -344,12 +352,7 @@ QuicSentPacketManager::MarkPacketHandled(
     ++all_transmissions_it;
   }
 
-  QuicUnackedPacketMap::const_iterator next_unacked = unacked_packets_.begin();
-  while (next_unacked != unacked_packets_.end() &&
-         next_unacked->first < sequence_number) {
-    ++next_unacked;
-  }
-  return next_unacked;
+  return unacked_packets_.lower_bound(sequence_number);
 }
 
 bool QuicSentPacketManager::IsUnacked(
@@ -767,7 +770,28 @@ void QuicSentPacketManager::MaybeEnablePacing() {
   using_pacing_ = true;
   send_algorithm_.reset(
       new PacingSender(send_algorithm_.release(),
-                       QuicTime::Delta::FromMicroseconds(1)));
+                       QuicTime::Delta::FromMicroseconds(kPacingQuantumUs)));
+}
+
+void QuicSentPacketManager::MaybeEnableBbr() {
+  if (!FLAGS_enable_quic_bbr) {
+    return;
+  }
+
+  if (using_bbr_) {
+    return;
+  }
+
+  // BBR replaces the current send algorithm, and always uses pacing. Packets
+  // sent before the switch are ignored by the new sender.
+  using_bbr_ = true;
+  using_pacing_ = true;
+  send_algorithm_.reset(
+      new PacingSender(new BbrSender(clock_),
+                       QuicTime::Delta::FromMicroseconds(kPacingQuantumUs)));
+  if (!rtt_sample_.IsInfinite()) {
+    send_algorithm_->UpdateRtt(rtt_sample_);
+  }
 }
 
 }  // namespace net
@@ -23,6 +23,7 @@
 
 NET_EXPORT_PRIVATE extern bool FLAGS_track_retransmission_history;
 NET_EXPORT_PRIVATE extern bool FLAGS_enable_quic_pacing;
+NET_EXPORT_PRIVATE extern bool FLAGS_enable_quic_bbr;
 
 namespace net {
 
@@ -165,6 +166,12 @@ class NET_EXPORT_PRIVATE QuicSentPacketManager {
 
   bool using_pacing() const { return using_pacing_; }
 
+  // Replaces the send algorithm with a paced BbrSender if it is not already
+  // in use, and if FLAGS_enable_quic_bbr is set.
+  void MaybeEnableBbr();
+
+  bool using_bbr() const { return using_bbr_; }
+
  private:
   friend class test::QuicConnectionPeer;
   friend class test::QuicSentPacketManagerPeer;
@@ -274,6 +281,7 @@ class NET_EXPORT_PRIVATE QuicSentPacketManager {
   // Maximum number of tail loss probes to send before firing an RTO.
   size_t max_tail_loss_probes_;
   bool using_pacing_;
+  bool using_bbr_;
 
   DISALLOW_COPY_AND_ASSIGN(QuicSentPacketManager);
 };
@@ -5,6 +5,7 @@
 #include "net/quic/quic_sent_packet_manager.h"
 
 #include "base/stl_util.h"
+#include "net/quic/crypto/crypto_protocol.h"
 #include "net/quic/test_tools/quic_sent_packet_manager_peer.h"
 #include "net/quic/test_tools/quic_test_utils.h"
 #include "testing/gmock/include/gmock/gmock.h"
@@ -1276,6 +1277,21 @@ TEST_F(QuicSentPacketManagerTest, GetTransmissionDelay) {
   }
 }
 
+TEST(QuicSentPacketManagerBbrTest, NegotiatedBbrReplacesSendAlgorithm) {
+  ValueRestore<bool> old_flag(&FLAGS_enable_quic_bbr, true);
+  MockClock clock;
+  QuicConnectionStats stats;
+  QuicSentPacketManager manager(true, &clock, &stats, kTCP);
+  QuicConfig config;
+  QuicTagVector cgst;
+  cgst.push_back(kTBBR);
+  config.set_congestion_control(cgst, kTBBR);
+
+  manager.SetFromConfig(config);
+  EXPECT_TRUE(manager.using_bbr());
+  EXPECT_TRUE(manager.using_pacing());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace net
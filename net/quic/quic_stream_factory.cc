@@ -282,7 +282,8 @@ QuicStreamFactory::QuicStreamFactory(
     QuicClock* clock,
     size_t max_packet_length,
     const QuicVersionVector& supported_versions,
-    bool enable_port_selection)
+    bool enable_port_selection,
+    bool enable_connection_migration)
     : require_confirmation_(true),
       host_resolver_(host_resolver),
       client_socket_factory_(client_socket_factory),
@@ -294,6 +295,7 @@ QuicStreamFactory::QuicStreamFactory(
       max_packet_length_(max_packet_length),
       supported_versions_(supported_versions),
       enable_port_selection_(enable_port_selection),
+      enable_connection_migration_(enable_connection_migration),
       port_seed_(random_generator_->RandUint64()),
       weak_factory_(this) {
   config_.SetDefaults();
@@ -484,6 +486,17 @@ void QuicStreamFactory::CloseAllSessions(int error) {
   DCHECK(all_sessions_.empty());
 }
 
+void QuicStreamFactory::PrefetchServerInfo(
+    const vector<HostPortPair>& servers) {
+  if (!quic_server_info_factory_)
+    return;
+  for (size_t i = 0; i < servers.size(); ++i) {
+    // Creating the crypto config starts the disk cache load.
+    GetOrCreateCryptoConfig(HostPortProxyPair(servers[i],
+                                              ProxyServer::Direct()));
+  }
+}
+
 base::Value* QuicStreamFactory::QuicStreamFactoryInfoToValue() const {
   base::ListValue* list = new base::ListValue();
 
@@ -501,8 +514,18 @@ base::Value* QuicStreamFactory::QuicStreamFactoryInfoToValue() const {
 }
 
 void QuicStreamFactory::OnIPAddressChanged() {
-  CloseAllSessions(ERR_NETWORK_CHANGED);
   require_confirmation_ = true;
+  if (!enable_connection_migration_) {
+    CloseAllSessions(ERR_NETWORK_CHANGED);
+    return;
+  }
+  // Sessions that can not migrate are closed, which removes them from
+  // |all_sessions_|, so iterate over a copy.
+  SessionSet sessions = all_sessions_;
+  for (SessionSet::iterator it = sessions.begin(); it != sessions.end();
+       ++it) {
+    MaybeMigrateSession(*it);
+  }
 }
 
 void QuicStreamFactory::OnCertAdded(const X509Certificate* cert) {
@@ -536,37 +559,10 @@ int QuicStreamFactory::CreateSession(
     QuicClientSession** session) {
   QuicGuid guid = random_generator_->RandUint64();
   IPEndPoint addr = *address_list.begin();
-  scoped_refptr<PortSuggester> port_suggester =
-      new PortSuggester(host_port_proxy_pair.first, port_seed_);
-  DatagramSocket::BindType bind_type = enable_port_selection_ ?
-      DatagramSocket::RANDOM_BIND :  // Use our callback.
-      DatagramSocket::DEFAULT_BIND;  // Use OS to randomize.
-  scoped_ptr<DatagramClientSocket> socket(
-      client_socket_factory_->CreateDatagramClientSocket(
-          bind_type,
-          base::Bind(&PortSuggester::SuggestPort, port_suggester),
-          net_log.net_log(), net_log.source()));
-  int rv = socket->Connect(addr);
+  scoped_ptr<DatagramClientSocket> socket;
+  int rv = CreateSocket(host_port_proxy_pair.first, addr, net_log, &socket);
   if (rv != OK)
     return rv;
-  UMA_HISTOGRAM_COUNTS("Net.QuicEphemeralPortsSuggested",
-                       port_suggester->call_count());
-  if (enable_port_selection_) {
-    DCHECK_LE(1u, port_suggester->call_count());
-  } else {
-    DCHECK_EQ(0u, port_suggester->call_count());
-  }
-
-  // We should adaptively set this buffer size, but for now, we'll use a size
-  // that is more than large enough for a full receive window, and yet
-  // does not consume "too much" memory.  If we see bursty packet loss, we may
-  // revisit this setting and test for its impact.
-  const int32 kSocketBufferSize(TcpReceiver::kReceiveWindowTCP);
-  socket->SetReceiveBufferSize(kSocketBufferSize);
-  // Set a buffer large enough to contain the initial CWND's worth of packet
-  // to work around the problem with CHLO packets being sent out with the
-  // wrong encryption level, when the send buffer is full.
-  socket->SetSendBufferSize(kMaxPacketSize * 20); // Support 20 packets.
 
   scoped_ptr<QuicDefaultPacketWriter> writer(
       new QuicDefaultPacketWriter(socket.get()));
@@ -610,6 +606,71 @@ int QuicStreamFactory::CreateSession(
   return OK;
 }
 
+int QuicStreamFactory::CreateSocket(
+    const HostPortPair& server,
+    const IPEndPoint& addr,
+    const BoundNetLog& net_log,
+    scoped_ptr<DatagramClientSocket>* socket) {
+  scoped_refptr<PortSuggester> port_suggester =
+      new PortSuggester(server, port_seed_);
+  DatagramSocket::BindType bind_type = enable_port_selection_ ?
+      DatagramSocket::RANDOM_BIND :  // Use our callback.
+      DatagramSocket::DEFAULT_BIND;  // Use OS to randomize.
+  *socket = client_socket_factory_->CreateDatagramClientSocket(
+      bind_type,
+      base::Bind(&PortSuggester::SuggestPort, port_suggester),
+      net_log.net_log(), net_log.source());
+  int rv = (*socket)->Connect(addr);
+  if (rv != OK)
+    return rv;
+  UMA_HISTOGRAM_COUNTS("Net.QuicEphemeralPortsSuggested",
+                       port_suggester->call_count());
+  if (enable_port_selection_) {
+    DCHECK_LE(1u, port_suggester->call_count());
+  } else {
+    DCHECK_EQ(0u, port_suggester->call_count());
+  }
+
+  // We should adaptively set this buffer size, but for now, we'll use a size
+  // that is more than large enough for a full receive window, and yet
+  // does not consume "too much" memory.  If we see bursty packet loss, we may
+  // revisit this setting and test for its impact.
+  const int32 kSocketBufferSize(TcpReceiver::kReceiveWindowTCP);
+  (*socket)->SetReceiveBufferSize(kSocketBufferSize);
+  // Set a buffer large enough to contain the initial CWND's worth of packet
+  // to work around the problem with CHLO packets being sent out with the
+  // wrong encryption level, when the send buffer is full.
+  (*socket)->SetSendBufferSize(kMaxPacketSize * 20); // Support 20 packets.
+  return OK;
+}
+
+void QuicStreamFactory::MaybeMigrateSession(QuicClientSession* session) {
+  SessionAliasMap::const_iterator aliases = session_aliases_.find(session);
+  // Only active sessions which have finished the handshake keep enough state
+  // to continue on a new path.
+  if (aliases == session_aliases_.end() ||
+      !session->IsCryptoHandshakeConfirmed()) {
+    session->CloseSessionOnError(ERR_NETWORK_CHANGED);
+    return;
+  }
+
+  scoped_ptr<DatagramClientSocket> socket;
+  int rv = CreateSocket(aliases->second.begin()->first,
+                        session->connection()->peer_address(),
+                        session->net_log(), &socket);
+  if (rv != OK) {
+    QuicClientSession::RecordMigrationStatus(
+        QuicClientSession::MIGRATION_STATUS_NO_NEW_SOCKET);
+    session->CloseSessionOnError(ERR_NETWORK_CHANGED);
+    return;
+  }
+
+  scoped_ptr<QuicDefaultPacketWriter> writer(
+      new QuicDefaultPacketWriter(socket.get()));
+  writer->SetConnection(session->connection());
+  session->MigrateToSocket(socket.Pass(), writer.Pass());
+}
+
 bool QuicStreamFactory::HasActiveJob(
     const HostPortProxyPair& host_port_proxy_pair) {
   return ContainsKey(active_jobs_, host_port_proxy_pair);
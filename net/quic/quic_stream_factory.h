@@ -26,6 +26,7 @@ namespace net {
 
 class CertVerifier;
 class ClientSocketFactory;
+class DatagramClientSocket;
 class HostResolver;
 class HttpServerProperties;
 class QuicClock;
@@ -94,7 +95,8 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
       QuicClock* clock,
       size_t max_packet_length,
       const QuicVersionVector& supported_versions,
-      bool enable_port_selection);
+      bool enable_port_selection,
+      bool enable_connection_migration);
   virtual ~QuicStreamFactory();
 
   // Creates a new QuicHttpStream to |host_port_proxy_pair| which will be
@@ -133,12 +135,19 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
   // Closes all current sessions.
   void CloseAllSessions(int error);
 
+  // Starts loading the server configs of |servers| from the disk cache, so
+  // that the first connections to them after startup can skip the extra
+  // round trip of an inchoate client hello. Meant to be called at startup
+  // with the servers that are used most.
+  void PrefetchServerInfo(const std::vector<HostPortPair>& servers);
+
   base::Value* QuicStreamFactoryInfoToValue() const;
 
   // NetworkChangeNotifier::IPAddressObserver methods:
 
-  // Until the servers support roaming, close all connections when the local
-  // IP address changes.
+  // When the local IP address changes, sessions with a confirmed handshake
+  // move to a new socket if connection migration is enabled. All other
+  // sessions are closed.
   virtual void OnIPAddressChanged() OVERRIDE;
 
   // CertDatabase::Observer methods:
@@ -157,6 +166,10 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
 
   bool enable_port_selection() const { return enable_port_selection_; }
 
+  bool enable_connection_migration() const {
+    return enable_connection_migration_;
+  }
+
  private:
   class Job;
   friend class test::QuicStreamFactoryPeer;
@@ -186,6 +199,14 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
                     QuicClientSession** session);
   void ActivateSession(const HostPortProxyPair& host_port_proxy_pair,
                        QuicClientSession* session);
+  // Creates a UDP socket for |server| connected to |addr|.
+  int CreateSocket(const HostPortPair& server,
+                   const IPEndPoint& addr,
+                   const BoundNetLog& net_log,
+                   scoped_ptr<DatagramClientSocket>* socket);
+  // Moves |session| to a new socket after the local IP address changed, or
+  // closes it if it can not be moved.
+  void MaybeMigrateSession(QuicClientSession* session);
 
   QuicCryptoClientConfig* GetOrCreateCryptoConfig(
       const HostPortProxyPair& host_port_proxy_pair);
@@ -250,6 +271,10 @@ class NET_EXPORT_PRIVATE QuicStreamFactory
   // connection.
   bool enable_port_selection_;
 
+  // If true, sessions move to a new socket when the local IP address
+  // changes, instead of being closed.
+  bool enable_connection_migration_;
+
   // Each profile will (probably) have a unique port_seed_ value.  This value is
   // used to help seed a pseudo-random number generator (PortSuggester) so that
   // we consistently (within this profile) suggest the same ephemeral port when
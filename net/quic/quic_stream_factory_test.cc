@@ -18,6 +18,7 @@
 #include "net/quic/quic_http_stream.h"
 #include "net/quic/test_tools/mock_clock.h"
 #include "net/quic/test_tools/mock_crypto_client_stream_factory.h"
+#include "net/quic/test_tools/mock_quic_server_info.h"
 #include "net/quic/test_tools/mock_random.h"
 #include "net/quic/test_tools/quic_test_packet_maker.h"
 #include "net/quic/test_tools/quic_test_utils.h"
@@ -67,6 +68,17 @@ class QuicStreamFactoryPeer {
     }
     return false;
   }
+
+  static void SetQuicServerInfoFactory(
+      QuicStreamFactory* factory,
+      QuicServerInfoFactory* quic_server_info_factory) {
+    factory->quic_server_info_factory_ = quic_server_info_factory;
+  }
+
+  static void SetEnableConnectionMigration(QuicStreamFactory* factory,
+                                           bool enable_connection_migration) {
+    factory->enable_connection_migration_ = enable_connection_migration;
+  }
 };
 
 class QuicStreamFactoryTest : public ::testing::TestWithParam<QuicVersion> {
@@ -80,7 +92,7 @@ class QuicStreamFactoryTest : public ::testing::TestWithParam<QuicVersion> {
                  NULL,  // quic_server_info_factory
                  &crypto_client_stream_factory_,
                  &random_generator_, clock_, kDefaultMaxPacketSize,
-                 SupportedVersions(GetParam()), true),
+                 SupportedVersions(GetParam()), true, false),
         host_port_proxy_pair_(HostPortPair(kDefaultServerHostName,
                                            kDefaultServerPort),
                               ProxyServer::Direct()),
@@ -805,6 +817,65 @@ TEST_P(QuicStreamFactoryTest, OnIPAddressChanged) {
   EXPECT_TRUE(socket_data2.at_write_eof());
 }
 
+TEST_P(QuicStreamFactoryTest, OnIPAddressChangedMigratesSessions) {
+  QuicStreamFactoryPeer::SetEnableConnectionMigration(&factory_, true);
+  MockRead reads[] = {
+    MockRead(ASYNC, 0, 0)  // EOF
+  };
+  DeterministicSocketData socket_data(reads, arraysize(reads), NULL, 0);
+  socket_factory_.AddSocketDataProvider(&socket_data);
+  socket_data.StopAfter(1);
+
+  // The stream is reset on the new socket.
+  MockRead reads2[] = {
+    MockRead(ASYNC, 0, 0)  // EOF
+  };
+  scoped_ptr<QuicEncryptedPacket> rst(ConstructRstPacket());
+  std::vector<MockWrite> writes2;
+  if (GetParam() > QUIC_VERSION_13)
+    writes2.push_back(MockWrite(ASYNC, rst->data(), rst->length(), 1));
+  DeterministicSocketData socket_data2(reads2, arraysize(reads2),
+                                       writes2.empty() ? NULL : &writes2[0],
+                                       writes2.size());
+  socket_factory_.AddSocketDataProvider(&socket_data2);
+  socket_data2.StopAfter(1);
+
+  QuicStreamRequest request(&factory_);
+  EXPECT_EQ(ERR_IO_PENDING,
+            request.Request(host_port_proxy_pair_,
+                            is_https_,
+                            "GET",
+                            cert_verifier_.get(),
+                            net_log_,
+                            callback_.callback()));
+
+  EXPECT_EQ(OK, callback_.WaitForResult());
+  scoped_ptr<QuicHttpStream> stream = request.ReleaseStream();
+  HttpRequestInfo request_info;
+  EXPECT_EQ(OK, stream->InitializeStream(&request_info,
+                                         DEFAULT_PRIORITY,
+                                         net_log_, CompletionCallback()));
+  QuicClientSession* session = QuicStreamFactoryPeer::GetActiveSession(
+      &factory_, host_port_proxy_pair_);
+
+  // Change the IP address and verify that the session moved to a new socket
+  // without disturbing the stream.
+  factory_.OnIPAddressChanged();
+  EXPECT_TRUE(factory_.require_confirmation());
+  EXPECT_EQ(2u, socket_factory_.udp_client_sockets().size());
+  EXPECT_TRUE(QuicStreamFactoryPeer::IsLiveSession(&factory_, session));
+  EXPECT_EQ(session, QuicStreamFactoryPeer::GetActiveSession(
+      &factory_, host_port_proxy_pair_));
+  EXPECT_TRUE(session->connection()->path_validation_pending());
+  EXPECT_EQ(ERR_IO_PENDING,
+            stream->ReadResponseHeaders(callback_.callback()));
+
+  stream.reset();  // Will reset stream 3.
+
+  EXPECT_TRUE(socket_data2.at_read_eof());
+  EXPECT_TRUE(socket_data2.at_write_eof());
+}
+
 TEST_P(QuicStreamFactoryTest, OnCertAdded) {
   MockRead reads[] = {
     MockRead(ASYNC, 0, 0)  // EOF
@@ -1018,5 +1089,34 @@ TEST_P(QuicStreamFactoryTest, CryptoConfigWhenProofIsInvalid) {
   }
 }
 
+TEST_P(QuicStreamFactoryTest, PrefetchServerInfo) {
+  // Without a QuicServerInfoFactory there is nothing to prefetch.
+  vector<HostPortPair> servers;
+  servers.push_back(host_port_proxy_pair_.first);
+  factory_.PrefetchServerInfo(servers);
+
+  MockQuicServerInfoFactory server_info_factory;
+  QuicStreamFactoryPeer::SetQuicServerInfoFactory(&factory_,
+                                                  &server_info_factory);
+  servers.push_back(HostPortPair("mail.google.com", 443));
+  factory_.PrefetchServerInfo(servers);
+  EXPECT_EQ(2, server_info_factory.num_created());
+  ASSERT_TRUE(server_info_factory.last_server_info());
+  EXPECT_TRUE(server_info_factory.last_server_info()->started());
+
+  // The crypto config for the second server now has its disk load running.
+  HostPortProxyPair host_port_proxy_pair(servers[1], ProxyServer::Direct());
+  QuicCryptoClientConfig* crypto_config =
+      QuicStreamFactoryPeer::GetOrCreateCryptoConfig(&factory_,
+                                                     host_port_proxy_pair);
+  EXPECT_EQ(server_info_factory.last_server_info(),
+            crypto_config->LookupOrCreate(servers[1].host())->
+                quic_server_info());
+
+  // Prefetching again does not start another load.
+  factory_.PrefetchServerInfo(servers);
+  EXPECT_EQ(2, server_info_factory.num_created());
+}
+
 }  // namespace test
 }  // namespace net
@@ -5,11 +5,10 @@
 #include "net/quic/quic_unacked_packet_map.h"
 
 #include "base/logging.h"
-#include "base/stl_util.h"
 #include "net/quic/quic_connection_stats.h"
-#include "net/quic/quic_utils_chromium.h"
 
 using std::max;
+using std::min;
 
 namespace net {
 
@@ -53,8 +52,44 @@ QuicUnackedPacketMap::TransmissionInfo::TransmissionInfo(
   all_transmissions->insert(sequence_number);
 }
 
+QuicUnackedPacketMap::const_iterator::const_iterator(
+    const QuicUnackedPacketMap* map,
+    QuicPacketSequenceNumber sequence_number)
+    : map_(map),
+      sequence_number_(sequence_number) {
+}
+
+const QuicUnackedPacketMap::value_type&
+QuicUnackedPacketMap::const_iterator::operator*() const {
+  DCHECK(map_->FindPacket(sequence_number_) != NULL);
+  return map_->unacked_packets_[sequence_number_ - map_->least_unacked_];
+}
+
+const QuicUnackedPacketMap::value_type*
+QuicUnackedPacketMap::const_iterator::operator->() const {
+  return &**this;
+}
+
+QuicUnackedPacketMap::const_iterator&
+QuicUnackedPacketMap::const_iterator::operator++() {
+  *this = map_->lower_bound(sequence_number_ + 1);
+  return *this;
+}
+
+bool QuicUnackedPacketMap::const_iterator::operator==(
+    const const_iterator& other) const {
+  return map_ == other.map_ && sequence_number_ == other.sequence_number_;
+}
+
+bool QuicUnackedPacketMap::const_iterator::operator!=(
+    const const_iterator& other) const {
+  return !(*this == other);
+}
+
 QuicUnackedPacketMap::QuicUnackedPacketMap(bool is_server)
     : largest_sent_packet_(0),
+      least_unacked_(0),
+      num_unacked_packets_(0),
       bytes_in_flight_(0),
       is_server_(is_server) {
 }
@@ -62,6 +97,9 @@ QuicUnackedPacketMap::QuicUnackedPacketMap(bool is_server)
 QuicUnackedPacketMap::~QuicUnackedPacketMap() {
   for (UnackedPacketMap::iterator it = unacked_packets_.begin();
        it != unacked_packets_.end(); ++it) {
+    if (it->second.all_transmissions == NULL) {
+      continue;
+    }
     delete it->second.retransmittable_frames;
     // Only delete all_transmissions once, for the newest packet.
     if (it->first == *it->second.all_transmissions->rbegin()) {
@@ -74,31 +112,42 @@ QuicUnackedPacketMap::~QuicUnackedPacketMap() {
 // sent in order and the connection tracks RetransmittableFrames for longer.
 void QuicUnackedPacketMap::AddPacket(
     const SerializedPacket& serialized_packet) {
+  QuicPacketSequenceNumber sequence_number = serialized_packet.sequence_number;
   if (!unacked_packets_.empty()) {
-    bool is_old_packet = unacked_packets_.rbegin()->first >=
-        serialized_packet.sequence_number;
+    bool is_old_packet = unacked_packets_.back().first >= sequence_number;
     LOG_IF(DFATAL, is_old_packet) << "Old packet serialized: "
-                                  << serialized_packet.sequence_number
+                                  << sequence_number
                                   << " vs: "
-                                  << unacked_packets_.rbegin()->first;
+                                  << unacked_packets_.back().first;
+    if (is_old_packet) {
+      return;
+    }
+  } else {
+    least_unacked_ = sequence_number;
   }
 
-  unacked_packets_[serialized_packet.sequence_number] =
+  // Sequence numbers which were never added, like acks, get empty slots.
+  while (least_unacked_ + unacked_packets_.size() < sequence_number) {
+    unacked_packets_.push_back(std::make_pair(
+        least_unacked_ + unacked_packets_.size(), TransmissionInfo()));
+  }
+  unacked_packets_.push_back(std::make_pair(
+      sequence_number,
       TransmissionInfo(serialized_packet.retransmittable_frames,
-                       serialized_packet.sequence_number,
-                       serialized_packet.sequence_number_length);
+                       sequence_number,
+                       serialized_packet.sequence_number_length)));
+  ++num_unacked_packets_;
 }
 
 void QuicUnackedPacketMap::OnRetransmittedPacket(
     QuicPacketSequenceNumber old_sequence_number,
     QuicPacketSequenceNumber new_sequence_number) {
-  DCHECK(ContainsKey(unacked_packets_, old_sequence_number));
+  DCHECK(IsUnacked(old_sequence_number));
   DCHECK(unacked_packets_.empty() ||
-         unacked_packets_.rbegin()->first < new_sequence_number);
+         unacked_packets_.back().first < new_sequence_number);
 
   // TODO(ianswett): Discard and lose the packet lazily instead of immediately.
-  TransmissionInfo* transmission_info =
-      FindOrNull(unacked_packets_, old_sequence_number);
+  TransmissionInfo* transmission_info = FindPacket(old_sequence_number);
   RetransmittableFrames* frames = transmission_info->retransmittable_frames;
   LOG_IF(DFATAL, frames == NULL) << "Attempt to retransmit packet with no "
                                  << "retransmittable frames: "
@@ -107,16 +156,26 @@ void QuicUnackedPacketMap::OnRetransmittedPacket(
   // We keep the old packet in the unacked packet list until it, or one of
   // the retransmissions of it are acked.
   transmission_info->retransmittable_frames = NULL;
-  unacked_packets_[new_sequence_number] =
+  QuicSequenceNumberLength sequence_number_length =
+      transmission_info->sequence_number_length;
+  SequenceNumberSet* all_transmissions = transmission_info->all_transmissions;
+  // Growing the deque invalidates |transmission_info|.
+  while (least_unacked_ + unacked_packets_.size() < new_sequence_number) {
+    unacked_packets_.push_back(std::make_pair(
+        least_unacked_ + unacked_packets_.size(), TransmissionInfo()));
+  }
+  unacked_packets_.push_back(std::make_pair(
+      new_sequence_number,
       TransmissionInfo(frames,
                        new_sequence_number,
-                       transmission_info->sequence_number_length,
-                       transmission_info->all_transmissions);
+                       sequence_number_length,
+                       all_transmissions)));
+  ++num_unacked_packets_;
 }
 
 void QuicUnackedPacketMap::ClearPreviousRetransmissions(size_t num_to_clear) {
-  UnackedPacketMap::iterator it = unacked_packets_.begin();
-  while (it != unacked_packets_.end() && num_to_clear > 0) {
+  const_iterator it = begin();
+  while (it != end() && num_to_clear > 0) {
     QuicPacketSequenceNumber sequence_number = it->first;
     // If this is a pending packet, or has retransmittable data, then there is
     // no point in clearing out any further packets, because they would not
@@ -133,8 +192,7 @@ void QuicUnackedPacketMap::ClearPreviousRetransmissions(size_t num_to_clear) {
 
 bool QuicUnackedPacketMap::HasRetransmittableFrames(
     QuicPacketSequenceNumber sequence_number) const {
-  const TransmissionInfo* transmission_info =
-      FindOrNull(unacked_packets_, sequence_number);
+  const TransmissionInfo* transmission_info = FindPacket(sequence_number);
   if (transmission_info == NULL) {
     return false;
   }
@@ -144,45 +202,46 @@ bool QuicUnackedPacketMap::HasRetransmittableFrames(
 
 void QuicUnackedPacketMap::NackPacket(QuicPacketSequenceNumber sequence_number,
                                       size_t min_nacks) {
-  UnackedPacketMap::iterator it = unacked_packets_.find(sequence_number);
-  if (it == unacked_packets_.end()) {
+  TransmissionInfo* transmission_info = FindPacket(sequence_number);
+  if (transmission_info == NULL) {
     LOG(DFATAL) << "NackPacket called for packet that is not unacked: "
                 << sequence_number;
     return;
   }
 
-  it->second.nack_count = max(min_nacks, it->second.nack_count + 1);
+  transmission_info->nack_count =
+      max(min_nacks, transmission_info->nack_count + 1);
 }
 
 void QuicUnackedPacketMap::RemovePacket(
     QuicPacketSequenceNumber sequence_number) {
   DVLOG(1) << __FUNCTION__ << " " << sequence_number;
-  UnackedPacketMap::iterator it = unacked_packets_.find(sequence_number);
-  if (it == unacked_packets_.end()) {
+  TransmissionInfo* transmission_info = FindPacket(sequence_number);
+  if (transmission_info == NULL) {
     LOG(DFATAL) << "packet is not unacked: " << sequence_number;
     return;
   }
-  const TransmissionInfo& transmission_info = it->second;
-  transmission_info.all_transmissions->erase(sequence_number);
-  if (transmission_info.all_transmissions->empty()) {
-    delete transmission_info.all_transmissions;
+  transmission_info->all_transmissions->erase(sequence_number);
+  if (transmission_info->all_transmissions->empty()) {
+    delete transmission_info->all_transmissions;
   }
-  if (transmission_info.retransmittable_frames != NULL) {
-    delete transmission_info.retransmittable_frames;
+  if (transmission_info->retransmittable_frames != NULL) {
+    delete transmission_info->retransmittable_frames;
   }
-  unacked_packets_.erase(it);
+  *transmission_info = TransmissionInfo();
+  --num_unacked_packets_;
+  RemoveLeadingEmptySlots();
 }
 
 void QuicUnackedPacketMap::NeuterPacket(
     QuicPacketSequenceNumber sequence_number) {
-  DVLOG(1) << __FUNCTION__ << " " << sequence_number << " pending? "
-           << unacked_packets_[sequence_number].pending;
-  UnackedPacketMap::iterator it = unacked_packets_.find(sequence_number);
-  if (it == unacked_packets_.end()) {
+  TransmissionInfo* transmission_info = FindPacket(sequence_number);
+  if (transmission_info == NULL) {
     LOG(DFATAL) << "packet is not unacked: " << sequence_number;
     return;
   }
-  TransmissionInfo* transmission_info = &it->second;
+  DVLOG(1) << __FUNCTION__ << " " << sequence_number << " pending? "
+           << transmission_info->pending;
   if (transmission_info->all_transmissions->size() > 1) {
     transmission_info->all_transmissions->erase(sequence_number);
     transmission_info->all_transmissions = new SequenceNumberSet();
@@ -196,28 +255,32 @@ void QuicUnackedPacketMap::NeuterPacket(
 
 bool QuicUnackedPacketMap::IsUnacked(
     QuicPacketSequenceNumber sequence_number) const {
-  return ContainsKey(unacked_packets_, sequence_number);
+  return FindPacket(sequence_number) != NULL;
 }
 
 bool QuicUnackedPacketMap::IsPending(
     QuicPacketSequenceNumber sequence_number) const {
-  const TransmissionInfo* transmission_info =
-      FindOrNull(unacked_packets_, sequence_number);
+  const TransmissionInfo* transmission_info = FindPacket(sequence_number);
   return transmission_info != NULL && transmission_info->pending;
 }
 
 void QuicUnackedPacketMap::SetNotPending(
     QuicPacketSequenceNumber sequence_number) {
-  if (unacked_packets_[sequence_number].pending) {
-    LOG_IF(DFATAL,
-           bytes_in_flight_ < unacked_packets_[sequence_number].bytes_sent);
-    bytes_in_flight_ -= unacked_packets_[sequence_number].bytes_sent;
-    unacked_packets_[sequence_number].pending = false;
+  TransmissionInfo* transmission_info = FindPacket(sequence_number);
+  if (transmission_info == NULL) {
+    LOG(DFATAL) << "SetNotPending called for packet that is not unacked: "
+                << sequence_number;
+    return;
+  }
+  if (transmission_info->pending) {
+    LOG_IF(DFATAL, bytes_in_flight_ < transmission_info->bytes_sent);
+    bytes_in_flight_ -= transmission_info->bytes_sent;
+    transmission_info->pending = false;
   }
 }
 
 bool QuicUnackedPacketMap::HasUnackedPackets() const {
-  return !unacked_packets_.empty();
+  return num_unacked_packets_ > 0;
 }
 
 bool QuicUnackedPacketMap::HasPendingPackets() const {
@@ -233,7 +296,9 @@ bool QuicUnackedPacketMap::HasPendingPackets() const {
 const QuicUnackedPacketMap::TransmissionInfo&
     QuicUnackedPacketMap::GetTransmissionInfo(
         QuicPacketSequenceNumber sequence_number) const {
-  return unacked_packets_.find(sequence_number)->second;
+  const TransmissionInfo* transmission_info = FindPacket(sequence_number);
+  DCHECK(transmission_info != NULL);
+  return *transmission_info;
 }
 
 QuicTime QuicUnackedPacketMap::GetLastPacketSentTime() const {
@@ -263,7 +328,7 @@ QuicTime QuicUnackedPacketMap::GetFirstPendingPacketSentTime() const {
 }
 
 size_t QuicUnackedPacketMap::GetNumUnackedPackets() const {
-  return unacked_packets_.size();
+  return num_unacked_packets_;
 }
 
 bool QuicUnackedPacketMap::HasMultiplePendingPackets() const {
@@ -308,13 +373,12 @@ QuicUnackedPacketMap::GetLeastUnackedSentPacket() const {
     return 0;
   }
 
-  return unacked_packets_.begin()->first;
+  return least_unacked_;
 }
 
 SequenceNumberSet QuicUnackedPacketMap::GetUnackedPackets() const {
   SequenceNumberSet unacked_packets;
-  for (UnackedPacketMap::const_iterator it = unacked_packets_.begin();
-       it != unacked_packets_.end(); ++it) {
+  for (const_iterator it = begin(); it != end(); ++it) {
     unacked_packets.insert(it->first);
   }
   return unacked_packets;
@@ -324,19 +388,68 @@ void QuicUnackedPacketMap::SetPending(QuicPacketSequenceNumber sequence_number,
                                       QuicTime sent_time,
                                       QuicByteCount bytes_sent) {
   DCHECK_LT(0u, sequence_number);
-  UnackedPacketMap::iterator it = unacked_packets_.find(sequence_number);
-  if (it == unacked_packets_.end()) {
+  TransmissionInfo* transmission_info = FindPacket(sequence_number);
+  if (transmission_info == NULL) {
     LOG(DFATAL) << "OnPacketSent called for packet that is not unacked: "
                 << sequence_number;
     return;
   }
-  DCHECK(!it->second.pending);
+  DCHECK(!transmission_info->pending);
 
   largest_sent_packet_ = max(sequence_number, largest_sent_packet_);
   bytes_in_flight_ += bytes_sent;
-  it->second.sent_time = sent_time;
-  it->second.bytes_sent = bytes_sent;
-  it->second.pending = true;
+  transmission_info->sent_time = sent_time;
+  transmission_info->bytes_sent = bytes_sent;
+  transmission_info->pending = true;
+}
+
+QuicUnackedPacketMap::const_iterator QuicUnackedPacketMap::begin() const {
+  // The front slot is never empty.
+  return const_iterator(this, least_unacked_);
+}
+
+QuicUnackedPacketMap::const_iterator QuicUnackedPacketMap::end() const {
+  return const_iterator(this, least_unacked_ + unacked_packets_.size());
+}
+
+QuicUnackedPacketMap::const_iterator QuicUnackedPacketMap::lower_bound(
+    QuicPacketSequenceNumber sequence_number) const {
+  QuicPacketSequenceNumber end_sequence_number =
+      least_unacked_ + unacked_packets_.size();
+  sequence_number = max(sequence_number, least_unacked_);
+  while (sequence_number < end_sequence_number &&
+         unacked_packets_[sequence_number - least_unacked_].second
+             .all_transmissions == NULL) {
+    ++sequence_number;
+  }
+  return const_iterator(this, min(sequence_number, end_sequence_number));
+}
+
+QuicUnackedPacketMap::TransmissionInfo* QuicUnackedPacketMap::FindPacket(
+    QuicPacketSequenceNumber sequence_number) {
+  return const_cast<TransmissionInfo*>(
+      const_cast<const QuicUnackedPacketMap*>(this)->FindPacket(
+          sequence_number));
+}
+
+const QuicUnackedPacketMap::TransmissionInfo* QuicUnackedPacketMap::FindPacket(
+    QuicPacketSequenceNumber sequence_number) const {
+  if (sequence_number < least_unacked_ ||
+      sequence_number - least_unacked_ >= unacked_packets_.size()) {
+    return NULL;
+  }
+  const TransmissionInfo* transmission_info =
+      &unacked_packets_[sequence_number - least_unacked_].second;
+  return transmission_info->all_transmissions == NULL ?
+      NULL : transmission_info;
+}
+
+void QuicUnackedPacketMap::RemoveLeadingEmptySlots() {
+  while (!unacked_packets_.empty() &&
+         unacked_packets_.front().second.all_transmissions == NULL) {
+    unacked_packets_.pop_front();
+    ++least_unacked_;
+  }
 }
 
 }  // namespace net
@@ -5,7 +5,9 @@
 #ifndef NET_QUIC_QUIC_UNACKED_PACKET_MAP_H_
 #define NET_QUIC_QUIC_UNACKED_PACKET_MAP_H_
 
-#include "net/base/linked_hash_map.h"
+#include <deque>
+#include <utility>
+
 #include "net/quic/quic_protocol.h"
 
 namespace net {
@@ -13,6 +15,11 @@ namespace net {
 // Class which tracks unacked packets, including those packets which are
 // currently pending, and the relationship between packets which
 // contain the same data (via retransmissions)
+//
+// Packets are stored in a deque indexed by sequence number, starting at the
+// least unacked packet, so lookups are constant time and iteration is in
+// sequence number order.  Removed packets leave an empty slot until all the
+// packets before them are removed too.
 class NET_EXPORT_PRIVATE QuicUnackedPacketMap {
  public:
   struct NET_EXPORT_PRIVATE TransmissionInfo {
@@ -46,6 +53,26 @@ class NET_EXPORT_PRIVATE QuicUnackedPacketMap {
     bool pending;
   };
 
+  typedef std::pair<QuicPacketSequenceNumber, TransmissionInfo> value_type;
+
+  // Iterates over the unacked packets in increasing sequence number order.
+  // Removing a packet only invalidates iterators pointing to that packet.
+  class NET_EXPORT_PRIVATE const_iterator {
+   public:
+    const_iterator(const QuicUnackedPacketMap* map,
+                   QuicPacketSequenceNumber sequence_number);
+
+    const value_type& operator*() const;
+    const value_type* operator->() const;
+    const_iterator& operator++();
+    bool operator==(const const_iterator& other) const;
+    bool operator!=(const const_iterator& other) const;
+
+   private:
+    const QuicUnackedPacketMap* map_;
+    QuicPacketSequenceNumber sequence_number_;
+  };
+
   explicit QuicUnackedPacketMap(bool is_server);
   ~QuicUnackedPacketMap();
 
@@ -116,13 +143,12 @@ class NET_EXPORT_PRIVATE QuicUnackedPacketMap {
   // in the ack frame for new acks.
   void ClearPreviousRetransmissions(size_t num_to_clear);
 
-  typedef linked_hash_map<QuicPacketSequenceNumber,
-                          TransmissionInfo> UnackedPacketMap;
+  const_iterator begin() const;
+  const_iterator end() const;
 
-  typedef UnackedPacketMap::const_iterator const_iterator;
-
-  const_iterator begin() const { return unacked_packets_.begin(); }
-  const_iterator end() const { return unacked_packets_.end(); }
+  // Returns an iterator to the first unacked packet with a sequence number of
+  // at least |sequence_number|.
+  const_iterator lower_bound(QuicPacketSequenceNumber sequence_number) const;
 
   // Returns true if there are unacked packets that are pending.
   bool HasPendingPackets() const;
@@ -154,6 +180,18 @@ class NET_EXPORT_PRIVATE QuicUnackedPacketMap {
   void NeuterPacket(QuicPacketSequenceNumber sequence_number);
 
  private:
+  friend class const_iterator;
+
+  typedef std::deque<value_type> UnackedPacketMap;
+
+  // Returns the packet |sequence_number|, or NULL if it is not unacked.
+  TransmissionInfo* FindPacket(QuicPacketSequenceNumber sequence_number);
+  const TransmissionInfo* FindPacket(
+      QuicPacketSequenceNumber sequence_number) const;
+
+  // Drops the slots of removed packets from the front of |unacked_packets_|.
+  void RemoveLeadingEmptySlots();
+
   QuicPacketSequenceNumber largest_sent_packet_;
 
   // Newly serialized retransmittable and fec packets are added to this map,
@@ -164,7 +202,11 @@ class NET_EXPORT_PRIVATE QuicUnackedPacketMap {
   // If the old packet is acked before the new packet, then the old entry will
   // be removed from the map and the new entry's retransmittable frames will be
   // set to NULL.
+  // The slot of a packet which is not unacked has a NULL all_transmissions.
   UnackedPacketMap unacked_packets_;
+  // The sequence number of the front of |unacked_packets_|.
+  QuicPacketSequenceNumber least_unacked_;
+  size_t num_unacked_packets_;
 
   size_t bytes_in_flight_;
 
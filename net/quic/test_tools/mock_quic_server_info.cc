@@ -0,0 +1,71 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/quic/test_tools/mock_quic_server_info.h"
+
+#include "base/callback_helpers.h"
+#include "net/base/net_errors.h"
+
+namespace net {
+
+MockQuicServerInfo::MockQuicServerInfo(const std::string& hostname)
+    : QuicServerInfo(hostname),
+      started_(false),
+      ready_(false) {
+}
+
+MockQuicServerInfo::~MockQuicServerInfo() {
+  DCHECK(callback_.is_null());
+}
+
+void MockQuicServerInfo::Start() {
+  started_ = true;
+}
+
+int MockQuicServerInfo::WaitForDataReady(const CompletionCallback& callback) {
+  DCHECK(started_);
+  if (ready_)
+    return OK;
+  if (!callback.is_null()) {
+    if (!callback_.is_null())
+      return ERR_INVALID_ARGUMENT;
+    callback_ = callback;
+  }
+  return ERR_IO_PENDING;
+}
+
+void MockQuicServerInfo::CancelWaitForDataReadyCallback() {
+  callback_.Reset();
+}
+
+bool MockQuicServerInfo::IsDataReady() {
+  return ready_;
+}
+
+void MockQuicServerInfo::Persist() {
+  CHECK(ready_);
+}
+
+void MockQuicServerInfo::CompleteLoad() {
+  ready_ = true;
+  if (!callback_.is_null())
+    base::ResetAndReturn(&callback_).Run(OK);
+}
+
+MockQuicServerInfoFactory::MockQuicServerInfoFactory()
+    : num_created_(0),
+      last_server_info_(NULL) {
+}
+
+MockQuicServerInfoFactory::~MockQuicServerInfoFactory() {
+}
+
+QuicServerInfo* MockQuicServerInfoFactory::GetForHost(
+    const std::string& hostname) {
+  ++num_created_;
+  last_server_info_ = new MockQuicServerInfo(hostname);
+  return last_server_info_;
+}
+
+}  // namespace net
@@ -0,0 +1,57 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_QUIC_TEST_TOOLS_MOCK_QUIC_SERVER_INFO_H_
+#define NET_QUIC_TEST_TOOLS_MOCK_QUIC_SERVER_INFO_H_
+
+#include <string>
+
+#include "net/quic/crypto/quic_server_info.h"
+
+namespace net {
+
+// A QuicServerInfo whose load completes when the test says so.
+class MockQuicServerInfo : public QuicServerInfo {
+ public:
+  explicit MockQuicServerInfo(const std::string& hostname);
+  virtual ~MockQuicServerInfo();
+
+  virtual void Start() OVERRIDE;
+  virtual int WaitForDataReady(const CompletionCallback& callback) OVERRIDE;
+  virtual void CancelWaitForDataReadyCallback() OVERRIDE;
+  virtual bool IsDataReady() OVERRIDE;
+  virtual void Persist() OVERRIDE;
+
+  // Completes the load, and runs the pending WaitForDataReady callback.
+  void CompleteLoad();
+
+  bool started() const { return started_; }
+
+  bool has_pending_callback() const { return !callback_.is_null(); }
+
+ private:
+  bool started_;
+  bool ready_;
+  CompletionCallback callback_;
+};
+
+class MockQuicServerInfoFactory : public QuicServerInfoFactory {
+ public:
+  MockQuicServerInfoFactory();
+  virtual ~MockQuicServerInfoFactory();
+
+  virtual QuicServerInfo* GetForHost(const std::string& hostname) OVERRIDE;
+
+  int num_created() const { return num_created_; }
+
+  MockQuicServerInfo* last_server_info() const { return last_server_info_; }
+
+ private:
+  int num_created_;
+  MockQuicServerInfo* last_server_info_;
+};
+
+}  // namespace net
+
+#endif  // NET_QUIC_TEST_TOOLS_MOCK_QUIC_SERVER_INFO_H_
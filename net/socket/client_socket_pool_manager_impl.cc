@@ -44,6 +44,7 @@ ClientSocketPoolManagerImpl::ClientSocketPoolManagerImpl(
     const std::string& ssl_session_cache_shard,
     ProxyService* proxy_service,
     SSLConfigService* ssl_config_service,
+    const base::WeakPtr<HttpServerProperties>& http_server_properties,
     HttpNetworkSession::SocketPoolType pool_type)
     : net_log_(net_log),
       socket_factory_(socket_factory),
@@ -55,6 +56,7 @@ ClientSocketPoolManagerImpl::ClientSocketPoolManagerImpl(
       ssl_session_cache_shard_(ssl_session_cache_shard),
       proxy_service_(proxy_service),
       ssl_config_service_(ssl_config_service),
+      http_server_properties_(http_server_properties),
       pool_type_(pool_type),
       transport_pool_histograms_("TCP"),
       transport_socket_pool_(new TransportClientSocketPool(
@@ -62,6 +64,7 @@ ClientSocketPoolManagerImpl::ClientSocketPoolManagerImpl(
           &transport_pool_histograms_,
           host_resolver,
           socket_factory_,
+          http_server_properties,
           net_log)),
       ssl_pool_histograms_("SSL2"),
       ssl_socket_pool_(new SSLClientSocketPool(
@@ -221,6 +224,7 @@ SOCKSClientSocketPool* ClientSocketPoolManagerImpl::GetSocketPoolForSOCKSProxy(
                   &transport_for_socks_pool_histograms_,
                   host_resolver_,
                   socket_factory_,
+                  http_server_properties_,
                   net_log_)));
   DCHECK(tcp_ret.second);
 
@@ -263,6 +267,7 @@ ClientSocketPoolManagerImpl::GetSocketPoolForHTTPProxy(
                   &transport_for_http_proxy_pool_histograms_,
                   host_resolver_,
                   socket_factory_,
+                  http_server_properties_,
                   net_log_)));
   DCHECK(tcp_http_ret.second);
 
@@ -276,6 +281,7 @@ ClientSocketPoolManagerImpl::GetSocketPoolForHTTPProxy(
                   &transport_for_https_proxy_pool_histograms_,
                   host_resolver_,
                   socket_factory_,
+                  http_server_properties_,
                   net_log_)));
   DCHECK(tcp_https_ret.second);
 
@@ -67,6 +67,8 @@ class ClientSocketPoolManagerImpl : public base::NonThreadSafe,
                               const std::string& ssl_session_cache_shard,
                               ProxyService* proxy_service,
                               SSLConfigService* ssl_config_service,
+                              const base::WeakPtr<HttpServerProperties>&
+                                  http_server_properties,
                               HttpNetworkSession::SocketPoolType pool_type);
   virtual ~ClientSocketPoolManagerImpl();
 
@@ -114,6 +116,7 @@ class ClientSocketPoolManagerImpl : public base::NonThreadSafe,
   const std::string ssl_session_cache_shard_;
   ProxyService* const proxy_service_;
   const scoped_refptr<SSLConfigService> ssl_config_service_;
+  const base::WeakPtr<HttpServerProperties> http_server_properties_;
   const HttpNetworkSession::SocketPoolType pool_type_;
 
   // Note: this ordering is important.
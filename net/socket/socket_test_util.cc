@@ -1735,7 +1735,8 @@ MockTransportClientSocketPool::MockTransportClientSocketPool(
     ClientSocketPoolHistograms* histograms,
     ClientSocketFactory* socket_factory)
     : TransportClientSocketPool(max_sockets, max_sockets_per_group, histograms,
-                                NULL, NULL, NULL),
+                                NULL, NULL,
+                                base::WeakPtr<HttpServerProperties>(), NULL),
       client_socket_factory_(socket_factory),
       last_request_priority_(DEFAULT_PRIORITY),
       release_count_(0),
@@ -18,6 +18,7 @@ namespace net {
 
 class CertVerifier;
 class CTVerifier;
+class PersistentSSLSessionStore;
 class ServerBoundCertService;
 class SSLCertRequestInfo;
 struct SSLConfig;
@@ -112,6 +113,11 @@ class NET_EXPORT SSLClientSocket : public SSLSocket {
   // sessions.
   static void ClearSessionCache();
 
+  // Sets the store that TLS sessions are saved to, so that they can be
+  // resumed after a restart, or NULL to stop saving them. Only supported
+  // with OpenSSL.
+  static void SetPersistentSessionStore(PersistentSSLSessionStore* store);
+
   virtual bool set_was_npn_negotiated(bool negotiated);
 
   virtual bool was_spdy_negotiated() const;
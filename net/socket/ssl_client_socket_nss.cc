@@ -1651,6 +1651,11 @@ void SSLClientSocketNSS::Core::HandshakeSucceeded() {
   } else {
     nss_handshake_state_.resumed_handshake = false;
   }
+  UMA_HISTOGRAM_BOOLEAN("Net.SSLSessionResumed",
+                        nss_handshake_state_.resumed_handshake);
+  // False Start saves a round trip on full handshakes only.
+  if (!nss_handshake_state_.resumed_handshake)
+    UMA_HISTOGRAM_BOOLEAN("Net.SSLFalseStarted", false_started_);
 
   RecordChannelIDSupportOnNSSTaskRunner();
   UpdateServerCert();
@@ -2811,6 +2816,12 @@ void SSLClientSocket::ClearSessionCache() {
   SSL_ClearSessionCache();
 }
 
+// static
+void SSLClientSocket::SetPersistentSessionStore(
+    PersistentSSLSessionStore* store) {
+  // NSS has no way to export its sessions, so they only live in memory.
+}
+
 bool SSLClientSocketNSS::GetSSLInfo(SSLInfo* ssl_info) {
   EnterFunction("");
   ssl_info->Reset();
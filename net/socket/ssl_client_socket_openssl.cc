@@ -336,6 +336,13 @@ void SSLClientSocket::ClearSessionCache() {
   OpenSSLClientKeyStore::GetInstance()->Flush();
 }
 
+// static
+void SSLClientSocket::SetPersistentSessionStore(
+    PersistentSSLSessionStore* store) {
+  SSLClientSocketOpenSSL::SSLContext::GetInstance()->session_cache()
+      ->SetPersistentStore(store);
+}
+
 SSLClientSocketOpenSSL::SSLClientSocketOpenSSL(
     scoped_ptr<ClientSocketHandle> transport_socket,
     const HostPortPair& host_and_port,
@@ -358,6 +365,7 @@ SSLClientSocketOpenSSL::SSLClientSocketOpenSSL(
       ssl_config_(ssl_config),
       ssl_session_cache_shard_(context.ssl_session_cache_shard),
       trying_cached_session_(false),
+      trying_persisted_session_(false),
       next_handshake_state_(STATE_NONE),
       npn_status_(kNextProtoUnsupported),
       channel_id_request_return_value_(ERR_UNEXPECTED),
@@ -661,6 +669,9 @@ bool SSLClientSocketOpenSSL::Init() {
 
   trying_cached_session_ = context->session_cache()->SetSSLSessionWithKey(
       ssl_, GetSocketSessionCacheKey(*this));
+  trying_persisted_session_ =
+      trying_cached_session_ &&
+      context->session_cache()->IsPersistedSession(ssl_);
 
   BIO* ssl_bio = NULL;
   // 0 => use default buffer sizes.
@@ -818,10 +829,14 @@ int SSLClientSocketOpenSSL::DoHandshake() {
       }
     }
   } else if (rv == 1) {
+    bool resumed = !!SSL_session_reused(ssl_);
     if (trying_cached_session_ && logging::DEBUG_MODE) {
       DVLOG(2) << "Result of session reuse for " << host_and_port_.ToString()
-               << " is: " << (SSL_session_reused(ssl_) ? "Success" : "Fail");
+               << " is: " << (resumed ? "Success" : "Fail");
     }
+    UMA_HISTOGRAM_BOOLEAN("Net.SSLSessionResumed", resumed);
+    if (trying_persisted_session_)
+      UMA_HISTOGRAM_BOOLEAN("Net.SSLPersistedSessionResumed", resumed);
     // SSL handshake is completed.  Let's verify the certificate.
     const bool got_cert = !!UpdateServerCert();
     DCHECK(got_cert);
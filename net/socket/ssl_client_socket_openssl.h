@@ -200,6 +200,8 @@ class SSLClientSocketOpenSSL : public SSLClientSocket {
 
   // Used for session cache diagnostics.
   bool trying_cached_session_;
+  // True if the cached session was read back from the persistent store.
+  bool trying_persisted_session_;
 
   enum State {
     STATE_NONE,
@@ -13,7 +13,10 @@
 #include "base/containers/hash_tables.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted.h"
 #include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "net/ssl/persistent_ssl_session_store.h"
 
 namespace net {
 
@@ -54,6 +57,11 @@ static int GetSSLSessionExIndex() {
   return s_ssl_context_ex_instance.Get().session_index();
 }
 
+// Values of the EX_DATA of a session that has been marked as good, and of one
+// that was read back from the persistent store.
+void* const kSessionIsGood = reinterpret_cast<void*>(1);
+void* const kSessionIsPersisted = reinterpret_cast<void*>(2);
+
 // Helper struct used to store session IDs in a SessionIdIndex container
 // (see definition below). To save memory each entry only holds a pointer
 // to the session ID buffer, which must outlive the entry itself. On the
@@ -176,7 +184,7 @@ class SSLSessionCacheOpenSSLImpl {
 
   // Destroy this instance. Must happen before |ctx_| is destroyed.
   ~SSLSessionCacheOpenSSLImpl() {
-    Flush();
+    FlushMemory();
     SSL_CTX_set_ex_data(ctx_, GetSSLContextExIndex(), NULL);
     SSL_CTX_sess_set_new_cb(ctx_, NULL);
     SSL_CTX_sess_set_remove_cb(ctx_, NULL);
@@ -215,8 +223,11 @@ class SSLSessionCacheOpenSSLImpl {
     }
 
     KeyIndex::iterator it = key_index_.find(cache_key);
-    if (it == key_index_.end())
-      return false;
+    if (it == key_index_.end()) {
+      it = RestoreSessionLocked(cache_key);
+      if (it == key_index_.end())
+        return false;
+    }
 
     SSL_SESSION* session = *it->second;
     DCHECK(session);
@@ -241,21 +252,49 @@ class SSLSessionCacheOpenSSLImpl {
     if (!session)
       return;
 
+    // Resumed sessions were already marked, and saved if needed.
+    if (SSL_SESSION_get_ex_data(session, GetSSLSessionExIndex()))
+      return;
+
     // Mark the session as good, allowing it to be used for future connections.
-    SSL_SESSION_set_ex_data(
-        session, GetSSLSessionExIndex(), reinterpret_cast<void*>(1));
+    SSL_SESSION_set_ex_data(session, GetSSLSessionExIndex(), kSessionIsGood);
+
+    scoped_refptr<PersistentSSLSessionStore> store;
+    {
+      base::AutoLock locked(lock_);
+      store = store_;
+    }
+    if (!store.get() || session->session_id_length == 0)
+      return;
+
+    int length = i2d_SSL_SESSION(session, NULL);
+    if (length <= 0)
+      return;
+    std::string data(length, '\0');
+    unsigned char* p = reinterpret_cast<unsigned char*>(&data[0]);
+    if (i2d_SSL_SESSION(session, &p) != length)
+      return;
+    store->Save(config_.key_func(ssl), data,
+                base::Time::FromTimeT(session->time + session->timeout));
   }
 
-  // Flush all entries from the cache.
+  bool IsPersistedSession(SSL* ssl) {
+    SSL_SESSION* session = SSL_get_session(ssl);
+    return session && SSL_SESSION_get_ex_data(session, GetSSLSessionExIndex()) ==
+                          kSessionIsPersisted;
+  }
+
+  // Flush all entries from the cache and the persistent store.
   void Flush() {
+    FlushMemory();
     base::AutoLock lock(lock_);
-    id_index_.clear();
-    key_index_.clear();
-    while (!ordering_.empty()) {
-      SSL_SESSION* session = ordering_.front();
-      ordering_.pop_front();
-      SSL_SESSION_free(session);
-    }
+    if (store_.get())
+      store_->Clear();
+  }
+
+  void SetPersistentStore(PersistentSSLSessionStore* store) {
+    base::AutoLock lock(lock_);
+    store_ = store;
   }
 
  private:
@@ -266,6 +305,18 @@ class SSLSessionCacheOpenSSLImpl {
   // Type for a dictionary from SessionId values to key index nodes.
   typedef base::hash_map<SessionId, KeyIndex::iterator> SessionIdIndex;
 
+  // Flush all entries from the cache, leaving the persistent store alone.
+  void FlushMemory() {
+    base::AutoLock lock(lock_);
+    id_index_.clear();
+    key_index_.clear();
+    while (!ordering_.empty()) {
+      SSL_SESSION* session = ordering_.front();
+      ordering_.pop_front();
+      SSL_SESSION_free(session);
+    }
+  }
+
   // Return the key associated with a given session, or the empty string if
   // none exist. This shall only be used for debugging.
   std::string SessionKey(SSL_SESSION* session) {
@@ -376,14 +427,46 @@ class SSLSessionCacheOpenSSLImpl {
     return 1;
   }
 
-  // Add |session| to the cache in association with |cache_key|. If a session
-  // already exists, it is replaced with the new one. This assumes that the
-  // caller already incremented the session's reference count.
+  // Called by OpenSSL when a new |session| was created for |ssl|.
   void OnSessionAdded(SSL* ssl, SSL_SESSION* session) {
     base::AutoLock locked(lock_);
     DCHECK(ssl);
+    AddSessionLocked(config_.key_func(ssl), session);
+  }
+
+  // Reads the session saved for |cache_key| in the persistent store, if any,
+  // and adds it to the cache as a good session. Returns the entry of
+  // |key_index_| for it, or key_index_.end(). Lock must be held.
+  KeyIndex::iterator RestoreSessionLocked(const std::string& cache_key) {
+    lock_.AssertAcquired();
+    std::string data;
+    if (!store_.get() || !store_->Get(cache_key, &data))
+      return key_index_.end();
+
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+    SSL_SESSION* session = d2i_SSL_SESSION(NULL, &p, data.size());
+    if (!session)
+      return key_index_.end();
+    if (session->session_id_length == 0 ||
+        id_index_.find(SessionId(session)) != id_index_.end()) {
+      SSL_SESSION_free(session);
+      return key_index_.end();
+    }
+
+    DVLOG(2) << "Restore session " << session << " for " << cache_key;
+    SSL_SESSION_set_ex_data(session, GetSSLSessionExIndex(),
+                            kSessionIsPersisted);
+    AddSessionLocked(cache_key, session);
+    return key_index_.find(cache_key);
+  }
+
+  // Add |session| to the cache in association with |cache_key|. If a session
+  // already exists, it is replaced with the new one. This assumes that the
+  // caller already incremented the session's reference count. Lock must be
+  // held.
+  void AddSessionLocked(const std::string& cache_key, SSL_SESSION* session) {
+    lock_.AssertAcquired();
     DCHECK_GT(session->session_id_length, 0U);
-    std::string cache_key = config_.key_func(ssl);
     KeyIndex::iterator it = key_index_.find(cache_key);
     if (it == key_index_.end()) {
       DVLOG(2) << "Add session " << session << " for " << cache_key;
@@ -476,6 +559,9 @@ class SSLSessionCacheOpenSSLImpl {
   SessionIdIndex id_index_;
 
   size_t expiration_check_;
+
+  // Sessions are saved to, and restored from, this store if it is set.
+  scoped_refptr<PersistentSSLSessionStore> store_;
 };
 
 SSLSessionCacheOpenSSL::~SSLSessionCacheOpenSSL() { delete impl_; }
@@ -503,6 +589,15 @@ void SSLSessionCacheOpenSSL::MarkSSLSessionAsGood(SSL* ssl) {
   return impl_->MarkSSLSessionAsGood(ssl);
 }
 
+bool SSLSessionCacheOpenSSL::IsPersistedSession(SSL* ssl) {
+  return impl_->IsPersistedSession(ssl);
+}
+
 void SSLSessionCacheOpenSSL::Flush() { impl_->Flush(); }
 
+void SSLSessionCacheOpenSSL::SetPersistentStore(
+    PersistentSSLSessionStore* store) {
+  impl_->SetPersistentStore(store);
+}
+
 }  // namespace net
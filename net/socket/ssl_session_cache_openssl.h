@@ -16,6 +16,7 @@ typedef struct ssl_st SSL;
 
 namespace net {
 
+class PersistentSSLSessionStore;
 class SSLSessionCacheOpenSSLImpl;
 
 // A class used to implement a custom cache of SSL_SESSION objects.
@@ -44,6 +45,10 @@ class SSLSessionCacheOpenSSLImpl;
 //  - Clients can call Flush() to remove all sessions from the cache, this is
 //    useful when the system's certificate store has changed.
 //
+//  - Clients can call SetPersistentStore() to keep sessions across restarts.
+//    Sessions are saved to the store once they are marked as good, and are
+//    read back from it when there is none in memory for a key.
+//
 // This class is thread-safe. There shouldn't be any issue with multiple
 // SSL connections being performed in parallel in multiple threads.
 class NET_EXPORT SSLSessionCacheOpenSSL {
@@ -121,10 +126,19 @@ class NET_EXPORT SSLSessionCacheOpenSSL {
   // only validated sessions are resumed.
   void MarkSSLSessionAsGood(SSL* ssl);
 
-  // Flush removes all entries from the cache. This is typically called when
-  // the system's certificate store has changed.
+  // Returns true if the session associated with |ssl| was read back from the
+  // persistent store.
+  bool IsPersistedSession(SSL* ssl);
+
+  // Flush removes all entries from the cache, and from the persistent store if
+  // there is one. This is typically called when the system's certificate store
+  // has changed.
   void Flush();
 
+  // Sets the store sessions are saved to, or NULL to stop saving them. The
+  // store is kept until Reset() is called.
+  void SetPersistentStore(PersistentSSLSessionStore* store);
+
   // TODO(digit): Move to client code.
   static const int kDefaultTimeoutSeconds = 60 * 60;
   static const size_t kMaxEntries = 1024;
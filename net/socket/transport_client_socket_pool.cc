@@ -6,6 +6,7 @@
 
 #include <algorithm>
 
+#include "base/bind.h"
 #include "base/compiler_specific.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
@@ -18,6 +19,7 @@
 #include "net/base/ip_endpoint.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_log.h"
+#include "net/http/http_server_properties.h"
 #include "net/socket/client_socket_factory.h"
 #include "net/socket/client_socket_handle.h"
 #include "net/socket/client_socket_pool_base.h"
@@ -31,10 +33,12 @@ namespace net {
 // TODO(willchan): Base this off RTT instead of statically setting it. Note we
 // choose a timeout that is different from the backup connect job timer so they
 // don't synchronize.
-const int TransportConnectJob::kIPv6FallbackTimerInMs = 300;
+const int TransportConnectJob::kConnectAttemptDelayInMs = 300;
 
 namespace {
 
+int g_connect_attempt_delay_ms = TransportConnectJob::kConnectAttemptDelayInMs;
+
 // Returns true iff all addresses in |list| are in the IPv6 family.
 bool AddressListOnlyContainsIPv6(const AddressList& list) {
   DCHECK(!list.empty());
@@ -46,6 +50,30 @@ bool AddressListOnlyContainsIPv6(const AddressList& list) {
   return true;
 }
 
+// Returns true iff |list| has addresses of both the IPv4 and IPv6 families.
+bool AddressListHasBothFamilies(const AddressList& list) {
+  bool has_ipv4 = false;
+  bool has_ipv6 = false;
+  for (AddressList::const_iterator iter = list.begin(); iter != list.end();
+       ++iter) {
+    if (iter->GetFamily() == ADDRESS_FAMILY_IPV4)
+      has_ipv4 = true;
+    else if (iter->GetFamily() == ADDRESS_FAMILY_IPV6)
+      has_ipv6 = true;
+  }
+  return has_ipv4 && has_ipv6;
+}
+
+base::Value* NetLogConnectAttemptCallback(const IPEndPoint* address,
+                                          int net_error,
+                                          NetLog::LogLevel /* log_level */) {
+  base::DictionaryValue* dict = new base::DictionaryValue();
+  dict->SetString("address", address->ToString());
+  if (net_error != OK)
+    dict->SetInteger("net_error", net_error);
+  return dict;
+}
+
 }  // namespace
 
 // This lock protects |g_last_connect_time|.
@@ -88,6 +116,7 @@ TransportConnectJob::TransportConnectJob(
     base::TimeDelta timeout_duration,
     ClientSocketFactory* client_socket_factory,
     HostResolver* host_resolver,
+    const base::WeakPtr<HttpServerProperties>& http_server_properties,
     Delegate* delegate,
     NetLog* net_log)
     : ConnectJob(group_name, timeout_duration, priority, delegate,
@@ -95,7 +124,11 @@ TransportConnectJob::TransportConnectJob(
       params_(params),
       client_socket_factory_(client_socket_factory),
       resolver_(host_resolver),
+      http_server_properties_(http_server_properties),
       next_state_(STATE_NONE),
+      pending_attempts_(0),
+      last_attempt_error_(ERR_FAILED),
+      winner_(0),
       interval_between_connects_(CONNECT_INTERVAL_GT_20MS) {
 }
 
@@ -129,6 +162,45 @@ void TransportConnectJob::MakeAddressListStartWithIPv4(AddressList* list) {
   }
 }
 
+// static
+void TransportConnectJob::InterleaveAddressFamilies(AddressFamily first_family,
+                                                    AddressList* list) {
+  AddressList first;
+  AddressList second;
+  for (AddressList::const_iterator i = list->begin(); i != list->end(); ++i) {
+    if (i->GetFamily() == first_family)
+      first.push_back(*i);
+    else
+      second.push_back(*i);
+  }
+
+  size_t size = list->size();
+  list->clear();
+  for (size_t i = 0; list->size() < size; ++i) {
+    if (i < first.size())
+      list->push_back(first[i]);
+    if (i < second.size())
+      list->push_back(second[i]);
+  }
+}
+
+// static
+base::TimeDelta TransportConnectJob::connect_attempt_delay() {
+  return base::TimeDelta::FromMilliseconds(g_connect_attempt_delay_ms);
+}
+
+// static
+void TransportConnectJob::set_connect_attempt_delay(base::TimeDelta delay) {
+  DCHECK_GT(delay.InMilliseconds(), 0);
+  g_connect_attempt_delay_ms = delay.InMilliseconds();
+}
+
+TransportConnectJob::ConnectAttempt::ConnectAttempt(const IPEndPoint& address)
+    : address(address) {
+}
+
+TransportConnectJob::ConnectAttempt::~ConnectAttempt() {}
+
 void TransportConnectJob::OnIOComplete(int result) {
   int rv = DoLoop(result);
   if (rv != ERR_IO_PENDING)
@@ -216,173 +288,200 @@ int TransportConnectJob::DoTransportConnect() {
       interval_between_connects_ = CONNECT_INTERVAL_GT_20MS;
   }
 
-  next_state_ = STATE_TRANSPORT_CONNECT_COMPLETE;
-  transport_socket_ = client_socket_factory_->CreateTransportClientSocket(
-        addresses_, net_log().net_log(), net_log().source());
-  int rv = transport_socket_->Connect(
-      base::Bind(&TransportConnectJob::OnIOComplete, base::Unretained(this)));
-  if (rv == ERR_IO_PENDING &&
-      addresses_.front().GetFamily() == ADDRESS_FAMILY_IPV6 &&
-      !AddressListOnlyContainsIPv6(addresses_)) {
-    fallback_timer_.Start(FROM_HERE,
-        base::TimeDelta::FromMilliseconds(kIPv6FallbackTimerInMs),
-        this, &TransportConnectJob::DoIPv6FallbackTransportConnect);
+  AddressFamily first_family = addresses_.front().GetFamily();
+  if (http_server_properties_ && AddressListHasBothFamilies(addresses_)) {
+    AddressFamily preferred_family =
+        http_server_properties_->GetPreferredAddressFamily(
+            params_->destination().host_port_pair());
+    if (preferred_family != ADDRESS_FAMILY_UNSPECIFIED)
+      first_family = preferred_family;
   }
-  return rv;
+  InterleaveAddressFamilies(first_family, &addresses_);
+
+  next_state_ = STATE_TRANSPORT_CONNECT_COMPLETE;
+  return StartConnectAttempts();
 }
 
 int TransportConnectJob::DoTransportConnectComplete(int result) {
+  attempt_timer_.Stop();
   if (result == OK) {
-    bool is_ipv4 = addresses_.front().GetFamily() == ADDRESS_FAMILY_IPV4;
-    DCHECK(!connect_timing_.connect_start.is_null());
-    DCHECK(!connect_timing_.dns_start.is_null());
-    base::TimeTicks now = base::TimeTicks::Now();
-    base::TimeDelta total_duration = now - connect_timing_.dns_start;
-    UMA_HISTOGRAM_CUSTOM_TIMES(
-        "Net.DNS_Resolution_And_TCP_Connection_Latency2",
-        total_duration,
-        base::TimeDelta::FromMilliseconds(1),
-        base::TimeDelta::FromMinutes(10),
-        100);
-
-    base::TimeDelta connect_duration = now - connect_timing_.connect_start;
-    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency",
-        connect_duration,
-        base::TimeDelta::FromMilliseconds(1),
-        base::TimeDelta::FromMinutes(10),
-        100);
-
-    switch (interval_between_connects_) {
-      case CONNECT_INTERVAL_LE_10MS:
-        UMA_HISTOGRAM_CUSTOM_TIMES(
-            "Net.TCP_Connection_Latency_Interval_LessThanOrEqual_10ms",
-            connect_duration,
-            base::TimeDelta::FromMilliseconds(1),
-            base::TimeDelta::FromMinutes(10),
-            100);
-        break;
-      case CONNECT_INTERVAL_LE_20MS:
-        UMA_HISTOGRAM_CUSTOM_TIMES(
-            "Net.TCP_Connection_Latency_Interval_LessThanOrEqual_20ms",
-            connect_duration,
-            base::TimeDelta::FromMilliseconds(1),
-            base::TimeDelta::FromMinutes(10),
-            100);
-        break;
-      case CONNECT_INTERVAL_GT_20MS:
-        UMA_HISTOGRAM_CUSTOM_TIMES(
-            "Net.TCP_Connection_Latency_Interval_GreaterThan_20ms",
-            connect_duration,
-            base::TimeDelta::FromMilliseconds(1),
-            base::TimeDelta::FromMinutes(10),
-            100);
-        break;
-      default:
-        NOTREACHED();
-        break;
+    DCHECK_LT(winner_, attempts_.size());
+    ConnectAttempt* winner = attempts_[winner_];
+    RecordConnectLatency(*winner);
+
+    bool raced = AddressListHasBothFamilies(addresses_);
+    UMA_HISTOGRAM_COUNTS_100("Net.TCP_Connection_Race.Attempts",
+                             attempts_.size());
+    if (raced) {
+      UMA_HISTOGRAM_BOOLEAN(
+          "Net.TCP_Connection_Race.FirstFamilyWins",
+          winner->address.GetFamily() == addresses_.front().GetFamily());
+      if (http_server_properties_) {
+        http_server_properties_->SetPreferredAddressFamily(
+            params_->destination().host_port_pair(),
+            winner->address.GetFamily());
+      }
     }
+    SetSocket(winner->socket.Pass());
+  }
+  // Cancel the other attempts.
+  attempts_.clear();
+  pending_attempts_ = 0;
+
+  return result;
+}
 
-    if (is_ipv4) {
-      UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv4_No_Race",
-                                 connect_duration,
-                                 base::TimeDelta::FromMilliseconds(1),
-                                 base::TimeDelta::FromMinutes(10),
-                                 100);
-    } else {
-      if (AddressListOnlyContainsIPv6(addresses_)) {
-        UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv6_Solo",
-                                   connect_duration,
-                                   base::TimeDelta::FromMilliseconds(1),
-                                   base::TimeDelta::FromMinutes(10),
-                                   100);
-      } else {
-        UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv6_Raceable",
-                                   connect_duration,
-                                   base::TimeDelta::FromMilliseconds(1),
-                                   base::TimeDelta::FromMinutes(10),
-                                   100);
+int TransportConnectJob::StartConnectAttempts() {
+  while (attempts_.size() < addresses_.size()) {
+    size_t index = attempts_.size();
+    ConnectAttempt* attempt = new ConnectAttempt(addresses_[index]);
+    attempts_.push_back(attempt);
+
+    net_log().AddEvent(
+        NetLog::TYPE_TRANSPORT_CONNECT_JOB_START_ATTEMPT,
+        base::Bind(&NetLogConnectAttemptCallback, &attempt->address, OK));
+    attempt->socket = client_socket_factory_->CreateTransportClientSocket(
+        AddressList(attempt->address), net_log().net_log(),
+        net_log().source());
+    attempt->start_time = base::TimeTicks::Now();
+    int rv = attempt->socket->Connect(
+        base::Bind(&TransportConnectJob::OnConnectAttemptComplete,
+                   base::Unretained(this), index));
+    if (rv == ERR_IO_PENDING) {
+      ++pending_attempts_;
+      if (attempts_.size() < addresses_.size()) {
+        attempt_timer_.Start(FROM_HERE, connect_attempt_delay(), this,
+                             &TransportConnectJob::OnConnectAttemptTimer);
       }
+      return ERR_IO_PENDING;
     }
-    SetSocket(transport_socket_.Pass());
-    fallback_timer_.Stop();
-  } else {
-    // Be a bit paranoid and kill off the fallback members to prevent reuse.
-    fallback_transport_socket_.reset();
-    fallback_addresses_.reset();
+    if (OnConnectAttemptResult(index, rv) == OK)
+      return OK;
   }
 
-  return result;
+  if (pending_attempts_ > 0)
+    return ERR_IO_PENDING;
+  return last_attempt_error_;
 }
 
-void TransportConnectJob::DoIPv6FallbackTransportConnect() {
-  // The timer should only fire while we're waiting for the main connect to
-  // succeed.
-  if (next_state_ != STATE_TRANSPORT_CONNECT_COMPLETE) {
-    NOTREACHED();
-    return;
+int TransportConnectJob::OnConnectAttemptResult(size_t index, int result) {
+  net_log().AddEvent(
+      NetLog::TYPE_TRANSPORT_CONNECT_JOB_ATTEMPT_COMPLETE,
+      base::Bind(&NetLogConnectAttemptCallback, &attempts_[index]->address,
+                 result));
+  if (result == OK) {
+    winner_ = index;
+  } else {
+    attempts_[index]->socket.reset();
+    last_attempt_error_ = result;
   }
+  return result;
+}
 
-  DCHECK(!fallback_transport_socket_.get());
-  DCHECK(!fallback_addresses_.get());
-
-  fallback_addresses_.reset(new AddressList(addresses_));
-  MakeAddressListStartWithIPv4(fallback_addresses_.get());
-  fallback_transport_socket_ =
-      client_socket_factory_->CreateTransportClientSocket(
-          *fallback_addresses_, net_log().net_log(), net_log().source());
-  fallback_connect_start_time_ = base::TimeTicks::Now();
-  int rv = fallback_transport_socket_->Connect(
-      base::Bind(
-          &TransportConnectJob::DoIPv6FallbackTransportConnectComplete,
-          base::Unretained(this)));
-  if (rv != ERR_IO_PENDING)
-    DoIPv6FallbackTransportConnectComplete(rv);
+void TransportConnectJob::OnConnectAttemptComplete(size_t index, int result) {
+  DCHECK_EQ(STATE_TRANSPORT_CONNECT_COMPLETE, next_state_);
+  DCHECK_NE(ERR_IO_PENDING, result);
+  --pending_attempts_;
+
+  int rv = OnConnectAttemptResult(index, result);
+  if (rv != OK) {
+    // Move on to the next address without waiting for the timer.
+    attempt_timer_.Stop();
+    rv = StartConnectAttempts();
+    if (rv == ERR_IO_PENDING)
+      return;
+  }
+  OnIOComplete(rv);  // Deletes |this|
 }
 
-void TransportConnectJob::DoIPv6FallbackTransportConnectComplete(int result) {
-  // This should only happen when we're waiting for the main connect to succeed.
+void TransportConnectJob::OnConnectAttemptTimer() {
+  // The timer should only fire while we're waiting for an attempt to succeed.
   if (next_state_ != STATE_TRANSPORT_CONNECT_COMPLETE) {
     NOTREACHED();
     return;
   }
 
-  DCHECK_NE(ERR_IO_PENDING, result);
-  DCHECK(fallback_transport_socket_.get());
-  DCHECK(fallback_addresses_.get());
+  int rv = StartConnectAttempts();
+  if (rv != ERR_IO_PENDING)
+    OnIOComplete(rv);  // Deletes |this|
+}
 
-  if (result == OK) {
-    DCHECK(!fallback_connect_start_time_.is_null());
-    DCHECK(!connect_timing_.dns_start.is_null());
-    base::TimeTicks now = base::TimeTicks::Now();
-    base::TimeDelta total_duration = now - connect_timing_.dns_start;
-    UMA_HISTOGRAM_CUSTOM_TIMES(
-        "Net.DNS_Resolution_And_TCP_Connection_Latency2",
-        total_duration,
-        base::TimeDelta::FromMilliseconds(1),
-        base::TimeDelta::FromMinutes(10),
-        100);
-
-    base::TimeDelta connect_duration = now - fallback_connect_start_time_;
-    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency",
-        connect_duration,
-        base::TimeDelta::FromMilliseconds(1),
-        base::TimeDelta::FromMinutes(10),
-        100);
+void TransportConnectJob::RecordConnectLatency(const ConnectAttempt& winner) {
+  DCHECK(!winner.start_time.is_null());
+  DCHECK(!connect_timing_.dns_start.is_null());
+  base::TimeTicks now = base::TimeTicks::Now();
+  base::TimeDelta total_duration = now - connect_timing_.dns_start;
+  UMA_HISTOGRAM_CUSTOM_TIMES(
+      "Net.DNS_Resolution_And_TCP_Connection_Latency2",
+      total_duration,
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromMinutes(10),
+      100);
+
+  base::TimeDelta connect_duration = now - winner.start_time;
+  UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency",
+      connect_duration,
+      base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromMinutes(10),
+      100);
+
+  switch (interval_between_connects_) {
+    case CONNECT_INTERVAL_LE_10MS:
+      UMA_HISTOGRAM_CUSTOM_TIMES(
+          "Net.TCP_Connection_Latency_Interval_LessThanOrEqual_10ms",
+          connect_duration,
+          base::TimeDelta::FromMilliseconds(1),
+          base::TimeDelta::FromMinutes(10),
+          100);
+      break;
+    case CONNECT_INTERVAL_LE_20MS:
+      UMA_HISTOGRAM_CUSTOM_TIMES(
+          "Net.TCP_Connection_Latency_Interval_LessThanOrEqual_20ms",
+          connect_duration,
+          base::TimeDelta::FromMilliseconds(1),
+          base::TimeDelta::FromMinutes(10),
+          100);
+      break;
+    case CONNECT_INTERVAL_GT_20MS:
+      UMA_HISTOGRAM_CUSTOM_TIMES(
+          "Net.TCP_Connection_Latency_Interval_GreaterThan_20ms",
+          connect_duration,
+          base::TimeDelta::FromMilliseconds(1),
+          base::TimeDelta::FromMinutes(10),
+          100);
+      break;
+    default:
+      NOTREACHED();
+      break;
+  }
 
+  bool first_is_ipv4 = addresses_.front().GetFamily() == ADDRESS_FAMILY_IPV4;
+  bool winner_is_ipv4 = winner.address.GetFamily() == ADDRESS_FAMILY_IPV4;
+  if (winner_is_ipv4 && !first_is_ipv4) {
     UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv4_Wins_Race",
-        connect_duration,
-        base::TimeDelta::FromMilliseconds(1),
-        base::TimeDelta::FromMinutes(10),
-        100);
-    SetSocket(fallback_transport_socket_.Pass());
-    next_state_ = STATE_NONE;
-    transport_socket_.reset();
+                               connect_duration,
+                               base::TimeDelta::FromMilliseconds(1),
+                               base::TimeDelta::FromMinutes(10),
+                               100);
+  } else if (winner_is_ipv4) {
+    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv4_No_Race",
+                               connect_duration,
+                               base::TimeDelta::FromMilliseconds(1),
+                               base::TimeDelta::FromMinutes(10),
+                               100);
+  } else if (AddressListOnlyContainsIPv6(addresses_)) {
+    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv6_Solo",
+                               connect_duration,
+                               base::TimeDelta::FromMilliseconds(1),
+                               base::TimeDelta::FromMinutes(10),
+                               100);
   } else {
-    // Be a bit paranoid and kill off the fallback members to prevent reuse.
-    fallback_transport_socket_.reset();
-    fallback_addresses_.reset();
+    UMA_HISTOGRAM_CUSTOM_TIMES("Net.TCP_Connection_Latency_IPv6_Raceable",
+                               connect_duration,
+                               base::TimeDelta::FromMilliseconds(1),
+                               base::TimeDelta::FromMinutes(10),
+                               100);
   }
-  NotifyDelegateOfCompletion(result);  // Deletes |this|
 }
 
 int TransportConnectJob::ConnectInternal() {
@@ -402,6 +501,7 @@ scoped_ptr<ConnectJob>
                               ConnectionTimeout(),
                               client_socket_factory_,
                               host_resolver_,
+                              http_server_properties_,
                               delegate,
                               net_log_));
 }
@@ -418,12 +518,15 @@ TransportClientSocketPool::TransportClientSocketPool(
     ClientSocketPoolHistograms* histograms,
     HostResolver* host_resolver,
     ClientSocketFactory* client_socket_factory,
+    const base::WeakPtr<HttpServerProperties>& http_server_properties,
     NetLog* net_log)
     : base_(NULL, max_sockets, max_sockets_per_group, histograms,
             ClientSocketPool::unused_idle_socket_timeout(),
             ClientSocketPool::used_idle_socket_timeout(),
             new TransportConnectJobFactory(client_socket_factory,
-                                           host_resolver, net_log)) {
+                                           host_resolver,
+                                           http_server_properties,
+                                           net_log)) {
   base_.EnableConnectBackupJobs();
 }
 
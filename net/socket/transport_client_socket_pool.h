@@ -10,9 +10,13 @@
 #include "base/basictypes.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
 #include "base/timer/timer.h"
+#include "net/base/address_family.h"
 #include "net/base/host_port_pair.h"
+#include "net/base/ip_endpoint.h"
 #include "net/dns/host_resolver.h"
 #include "net/dns/single_request_host_resolver.h"
 #include "net/socket/client_socket_pool.h"
@@ -22,6 +26,7 @@
 namespace net {
 
 class ClientSocketFactory;
+class HttpServerProperties;
 
 typedef base::Callback<int(const AddressList&, const BoundNetLog& net_log)>
 OnHostResolutionCallback;
@@ -56,23 +61,30 @@ class NET_EXPORT_PRIVATE TransportSocketParams
 };
 
 // TransportConnectJob handles the host resolution necessary for socket creation
-// and the transport (likely TCP) connect. TransportConnectJob also has fallback
-// logic for IPv6 connect() timeouts (which may happen due to networks / routers
-// with broken IPv6 support). Those timeouts take 20s, so rather than make the
-// user wait 20s for the timeout to fire, we use a fallback timer
-// (kIPv6FallbackTimerInMs) and start a connect() to a IPv4 address if the timer
-// fires. Then we race the IPv4 connect() against the IPv6 connect() (which has
-// a headstart) and return the one that completes first to the socket pool.
+// and the transport (likely TCP) connect. Rather than trying the resolved
+// addresses one after the other, it races them: a connect() is started to the
+// first address, and if it has not finished after connect_attempt_delay(), or
+// as soon as it fails, a connect() to the next address is started, and so on.
+// The first one to connect is returned to the socket pool. This avoids
+// waiting for the connect() timeouts of networks / routers with broken IPv6
+// support, which take 20s.
+//
+// The addresses are reordered to alternate between the IPv6 and IPv4 families,
+// starting with the family that won the last race to the same server, as
+// remembered by HttpServerProperties, or with the family of the first
+// resolved address.
 class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
  public:
-  TransportConnectJob(const std::string& group_name,
-                      RequestPriority priority,
-                      const scoped_refptr<TransportSocketParams>& params,
-                      base::TimeDelta timeout_duration,
-                      ClientSocketFactory* client_socket_factory,
-                      HostResolver* host_resolver,
-                      Delegate* delegate,
-                      NetLog* net_log);
+  TransportConnectJob(
+      const std::string& group_name,
+      RequestPriority priority,
+      const scoped_refptr<TransportSocketParams>& params,
+      base::TimeDelta timeout_duration,
+      ClientSocketFactory* client_socket_factory,
+      HostResolver* host_resolver,
+      const base::WeakPtr<HttpServerProperties>& http_server_properties,
+      Delegate* delegate,
+      NetLog* net_log);
   virtual ~TransportConnectJob();
 
   // ConnectJob methods.
@@ -82,7 +94,16 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   // WARNING: this method should only be used to implement the prefer-IPv4 hack.
   static void MakeAddressListStartWithIPv4(AddressList* addrlist);
 
-  static const int kIPv6FallbackTimerInMs;
+  // Reorders |addrlist| so that the address families alternate, starting with
+  // |first_family|, while the addresses of each family keep their order.
+  static void InterleaveAddressFamilies(AddressFamily first_family,
+                                        AddressList* addrlist);
+
+  // The time to wait for a connect() before starting the next one.
+  static base::TimeDelta connect_attempt_delay();
+  static void set_connect_attempt_delay(base::TimeDelta delay);
+
+  static const int kConnectAttemptDelayInMs;
 
  private:
   enum State {
@@ -99,6 +120,16 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
     CONNECT_INTERVAL_GT_20MS,
   };
 
+  // A connect() to one of the addresses.
+  struct ConnectAttempt {
+    explicit ConnectAttempt(const IPEndPoint& address);
+    ~ConnectAttempt();
+
+    const IPEndPoint address;
+    scoped_ptr<StreamSocket> socket;
+    base::TimeTicks start_time;
+  };
+
   void OnIOComplete(int result);
 
   // Runs the state transition loop.
@@ -110,8 +141,17 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   int DoTransportConnectComplete(int result);
 
   // Not part of the state machine.
-  void DoIPv6FallbackTransportConnect();
-  void DoIPv6FallbackTransportConnectComplete(int result);
+  // Starts connect attempts until one of them is pending or connects. Returns
+  // OK if an attempt connected, ERR_IO_PENDING if some are pending, or the
+  // error of the last attempt once all of them failed.
+  int StartConnectAttempts();
+  // Records the |result| of the attempt at |index|. Returns |result|.
+  int OnConnectAttemptResult(size_t index, int result);
+  void OnConnectAttemptComplete(size_t index, int result);
+  void OnConnectAttemptTimer();
+
+  // Records the histograms of a successful connect.
+  void RecordConnectLatency(const ConnectAttempt& winner);
 
   // Begins the host resolution and the TCP connect.  Returns OK on success
   // and ERR_IO_PENDING if it cannot immediately service the request.
@@ -121,15 +161,18 @@ class NET_EXPORT_PRIVATE TransportConnectJob : public ConnectJob {
   scoped_refptr<TransportSocketParams> params_;
   ClientSocketFactory* const client_socket_factory_;
   SingleRequestHostResolver resolver_;
+  const base::WeakPtr<HttpServerProperties> http_server_properties_;
   AddressList addresses_;
   State next_state_;
 
-  scoped_ptr<StreamSocket> transport_socket_;
-
-  scoped_ptr<StreamSocket> fallback_transport_socket_;
-  scoped_ptr<AddressList> fallback_addresses_;
-  base::TimeTicks fallback_connect_start_time_;
-  base::OneShotTimer<TransportConnectJob> fallback_timer_;
+  // The attempts started so far, in the order of |addresses_|. The sockets of
+  // the attempts that failed are deleted.
+  ScopedVector<ConnectAttempt> attempts_;
+  int pending_attempts_;
+  int last_attempt_error_;
+  // The attempt that connected.
+  size_t winner_;
+  base::OneShotTimer<TransportConnectJob> attempt_timer_;
 
   // Track the interval between this connect and previous connect.
   ConnectInterval interval_between_connects_;
@@ -147,6 +190,7 @@ class NET_EXPORT_PRIVATE TransportClientSocketPool : public ClientSocketPool {
       ClientSocketPoolHistograms* histograms,
       HostResolver* host_resolver,
       ClientSocketFactory* client_socket_factory,
+      const base::WeakPtr<HttpServerProperties>& http_server_properties,
       NetLog* net_log);
 
   virtual ~TransportClientSocketPool();
@@ -193,11 +237,14 @@ class NET_EXPORT_PRIVATE TransportClientSocketPool : public ClientSocketPool {
   class TransportConnectJobFactory
       : public PoolBase::ConnectJobFactory {
    public:
-    TransportConnectJobFactory(ClientSocketFactory* client_socket_factory,
-                         HostResolver* host_resolver,
-                         NetLog* net_log)
+    TransportConnectJobFactory(
+        ClientSocketFactory* client_socket_factory,
+        HostResolver* host_resolver,
+        const base::WeakPtr<HttpServerProperties>& http_server_properties,
+        NetLog* net_log)
         : client_socket_factory_(client_socket_factory),
           host_resolver_(host_resolver),
+          http_server_properties_(http_server_properties),
           net_log_(net_log) {}
 
     virtual ~TransportConnectJobFactory() {}
@@ -214,6 +261,7 @@ class NET_EXPORT_PRIVATE TransportClientSocketPool : public ClientSocketPool {
    private:
     ClientSocketFactory* const client_socket_factory_;
     HostResolver* const host_resolver_;
+    const base::WeakPtr<HttpServerProperties> http_server_properties_;
     NetLog* net_log_;
 
     DISALLOW_COPY_AND_ASSIGN(TransportConnectJobFactory);
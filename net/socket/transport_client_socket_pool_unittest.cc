@@ -19,6 +19,7 @@
 #include "net/base/net_util.h"
 #include "net/base/test_completion_callback.h"
 #include "net/dns/mock_host_resolver.h"
+#include "net/http/http_server_properties_impl.h"
 #include "net/socket/client_socket_factory.h"
 #include "net/socket/client_socket_handle.h"
 #include "net/socket/client_socket_pool_histograms.h"
@@ -458,6 +459,7 @@ class TransportClientSocketPoolTest : public testing::Test {
               histograms_.get(),
               host_resolver_.get(),
               &client_socket_factory_,
+              http_server_properties_.GetWeakPtr(),
               NULL) {
   }
 
@@ -495,6 +497,7 @@ class TransportClientSocketPoolTest : public testing::Test {
   scoped_ptr<ClientSocketPoolHistograms> histograms_;
   scoped_ptr<MockHostResolver> host_resolver_;
   MockClientSocketFactory client_socket_factory_;
+  HttpServerPropertiesImpl http_server_properties_;
   TransportClientSocketPool pool_;
   ClientSocketPoolTest test_base_;
 
@@ -572,6 +575,52 @@ TEST(TransportConnectJobTest, MakeAddrListStartWithIPv4) {
   EXPECT_EQ(ADDRESS_FAMILY_IPV6, addrlist[3].GetFamily());
 }
 
+TEST(TransportConnectJobTest, InterleaveAddressFamilies) {
+  IPAddressNumber ip_number;
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.1", &ip_number));
+  IPEndPoint addrlist_v4_1(ip_number, 80);
+  ASSERT_TRUE(ParseIPLiteralToNumber("192.168.1.2", &ip_number));
+  IPEndPoint addrlist_v4_2(ip_number, 80);
+  ASSERT_TRUE(ParseIPLiteralToNumber("2001:4860:b006::64", &ip_number));
+  IPEndPoint addrlist_v6_1(ip_number, 80);
+  ASSERT_TRUE(ParseIPLiteralToNumber("2001:4860:b006::66", &ip_number));
+  IPEndPoint addrlist_v6_2(ip_number, 80);
+
+  AddressList addrlist;
+
+  // Test 1: IPv6, IPv6, IPv4, IPv4.  Expect the families to alternate.
+  addrlist.push_back(addrlist_v6_1);
+  addrlist.push_back(addrlist_v6_2);
+  addrlist.push_back(addrlist_v4_1);
+  addrlist.push_back(addrlist_v4_2);
+  TransportConnectJob::InterleaveAddressFamilies(ADDRESS_FAMILY_IPV6,
+                                                 &addrlist);
+  ASSERT_EQ(4u, addrlist.size());
+  EXPECT_TRUE(addrlist_v6_1 == addrlist[0]);
+  EXPECT_TRUE(addrlist_v4_1 == addrlist[1]);
+  EXPECT_TRUE(addrlist_v6_2 == addrlist[2]);
+  EXPECT_TRUE(addrlist_v4_2 == addrlist[3]);
+
+  // Test 2: Same list, starting with IPv4.
+  TransportConnectJob::InterleaveAddressFamilies(ADDRESS_FAMILY_IPV4,
+                                                 &addrlist);
+  ASSERT_EQ(4u, addrlist.size());
+  EXPECT_TRUE(addrlist_v4_1 == addrlist[0]);
+  EXPECT_TRUE(addrlist_v6_1 == addrlist[1]);
+  EXPECT_TRUE(addrlist_v4_2 == addrlist[2]);
+  EXPECT_TRUE(addrlist_v6_2 == addrlist[3]);
+
+  // Test 3: IPv4 only.  Expect no change.
+  addrlist.clear();
+  addrlist.push_back(addrlist_v4_1);
+  addrlist.push_back(addrlist_v4_2);
+  TransportConnectJob::InterleaveAddressFamilies(ADDRESS_FAMILY_IPV6,
+                                                 &addrlist);
+  ASSERT_EQ(2u, addrlist.size());
+  EXPECT_TRUE(addrlist_v4_1 == addrlist[0]);
+  EXPECT_TRUE(addrlist_v4_2 == addrlist[1]);
+}
+
 TEST_F(TransportClientSocketPoolTest, Basic) {
   TestCompletionCallback callback;
   ClientSocketHandle handle;
@@ -1226,6 +1275,7 @@ TEST_F(TransportClientSocketPoolTest, IPv6FallbackSocketIPv4FinishesFirst) {
                                  histograms_.get(),
                                  host_resolver_.get(),
                                  &client_socket_factory_,
+                                 http_server_properties_.GetWeakPtr(),
                                  NULL);
 
   MockClientSocketFactory::ClientSocketType case_types[] = {
@@ -1269,6 +1319,7 @@ TEST_F(TransportClientSocketPoolTest, IPv6FallbackSocketIPv6FinishesFirst) {
                                  histograms_.get(),
                                  host_resolver_.get(),
                                  &client_socket_factory_,
+                                 http_server_properties_.GetWeakPtr(),
                                  NULL);
 
   MockClientSocketFactory::ClientSocketType case_types[] = {
@@ -1279,8 +1330,9 @@ TEST_F(TransportClientSocketPoolTest, IPv6FallbackSocketIPv6FinishesFirst) {
   };
 
   client_socket_factory_.set_client_socket_types(case_types, 2);
-  client_socket_factory_.set_delay(base::TimeDelta::FromMilliseconds(
-      TransportConnectJob::kIPv6FallbackTimerInMs + 50));
+  client_socket_factory_.set_delay(
+      TransportConnectJob::connect_attempt_delay() +
+      base::TimeDelta::FromMilliseconds(50));
 
   // Resolve an AddressList with a IPv6 address first and then a IPv4 address.
   host_resolver_->rules()
@@ -1311,6 +1363,7 @@ TEST_F(TransportClientSocketPoolTest, IPv6NoIPv4AddressesToFallbackTo) {
                                  histograms_.get(),
                                  host_resolver_.get(),
                                  &client_socket_factory_,
+                                 http_server_properties_.GetWeakPtr(),
                                  NULL);
 
   client_socket_factory_.set_client_socket_type(
@@ -1345,6 +1398,7 @@ TEST_F(TransportClientSocketPoolTest, IPv4HasNoFallback) {
                                  histograms_.get(),
                                  host_resolver_.get(),
                                  &client_socket_factory_,
+                                 http_server_properties_.GetWeakPtr(),
                                  NULL);
 
   client_socket_factory_.set_client_socket_type(
@@ -1370,6 +1424,134 @@ TEST_F(TransportClientSocketPoolTest, IPv4HasNoFallback) {
   EXPECT_EQ(1, client_socket_factory_.allocation_count());
 }
 
+// Test that a failed connect moves on to the next address right away.
+TEST_F(TransportClientSocketPoolTest, FailedAttemptStartsNextAttempt) {
+  // Create a pool without backup jobs.
+  ClientSocketPoolBaseHelper::set_connect_backup_jobs_enabled(false);
+  TransportClientSocketPool pool(kMaxSockets,
+                                 kMaxSocketsPerGroup,
+                                 histograms_.get(),
+                                 host_resolver_.get(),
+                                 &client_socket_factory_,
+                                 http_server_properties_.GetWeakPtr(),
+                                 NULL);
+
+  MockClientSocketFactory::ClientSocketType case_types[] = {
+    MockClientSocketFactory::MOCK_PENDING_FAILING_CLIENT_SOCKET,
+    MockClientSocketFactory::MOCK_FAILING_CLIENT_SOCKET,
+    MockClientSocketFactory::MOCK_PENDING_CLIENT_SOCKET
+  };
+
+  client_socket_factory_.set_client_socket_types(case_types, 3);
+
+  host_resolver_->rules()
+      ->AddIPLiteralRule("*", "1.1.1.1,2.2.2.2,3.3.3.3", std::string());
+
+  TestCompletionCallback callback;
+  ClientSocketHandle handle;
+  int rv = handle.Init("a", params_, LOW, callback.callback(), &pool,
+                       BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+
+  EXPECT_EQ(OK, callback.WaitForResult());
+  EXPECT_TRUE(handle.socket());
+  EXPECT_EQ(3, client_socket_factory_.allocation_count());
+}
+
+// Test that a connect is started to each address in turn while the earlier
+// ones stall.
+TEST_F(TransportClientSocketPoolTest, StaggeredAttempts) {
+  base::TimeDelta connect_attempt_delay =
+      TransportConnectJob::connect_attempt_delay();
+  TransportConnectJob::set_connect_attempt_delay(
+      base::TimeDelta::FromMilliseconds(10));
+
+  // Create a pool without backup jobs.
+  ClientSocketPoolBaseHelper::set_connect_backup_jobs_enabled(false);
+  TransportClientSocketPool pool(kMaxSockets,
+                                 kMaxSocketsPerGroup,
+                                 histograms_.get(),
+                                 host_resolver_.get(),
+                                 &client_socket_factory_,
+                                 http_server_properties_.GetWeakPtr(),
+                                 NULL);
+
+  MockClientSocketFactory::ClientSocketType case_types[] = {
+    MockClientSocketFactory::MOCK_STALLED_CLIENT_SOCKET,
+    MockClientSocketFactory::MOCK_STALLED_CLIENT_SOCKET,
+    MockClientSocketFactory::MOCK_PENDING_CLIENT_SOCKET
+  };
+
+  client_socket_factory_.set_client_socket_types(case_types, 3);
+
+  host_resolver_->rules()
+      ->AddIPLiteralRule("*", "1.1.1.1,2.2.2.2,3.3.3.3", std::string());
+
+  TestCompletionCallback callback;
+  ClientSocketHandle handle;
+  int rv = handle.Init("a", params_, LOW, callback.callback(), &pool,
+                       BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+
+  EXPECT_EQ(OK, callback.WaitForResult());
+  EXPECT_TRUE(handle.socket());
+  EXPECT_EQ(3, client_socket_factory_.allocation_count());
+
+  TransportConnectJob::set_connect_attempt_delay(connect_attempt_delay);
+}
+
+// Test that the family that won a race is tried first by the next connect.
+TEST_F(TransportClientSocketPoolTest, RemembersWinningFamily) {
+  // Create a pool without backup jobs.
+  ClientSocketPoolBaseHelper::set_connect_backup_jobs_enabled(false);
+  TransportClientSocketPool pool(kMaxSockets,
+                                 kMaxSocketsPerGroup,
+                                 histograms_.get(),
+                                 host_resolver_.get(),
+                                 &client_socket_factory_,
+                                 http_server_properties_.GetWeakPtr(),
+                                 NULL);
+
+  MockClientSocketFactory::ClientSocketType case_types[] = {
+    // This is the IPv6 socket.
+    MockClientSocketFactory::MOCK_STALLED_CLIENT_SOCKET,
+    // This is the IPv4 socket.
+    MockClientSocketFactory::MOCK_PENDING_CLIENT_SOCKET,
+    // This is the socket of the second connect.
+    MockClientSocketFactory::MOCK_CLIENT_SOCKET
+  };
+
+  client_socket_factory_.set_client_socket_types(case_types, 3);
+
+  // Resolve an AddressList with a IPv6 address first and then a IPv4 address.
+  host_resolver_->rules()
+      ->AddIPLiteralRule("*", "2:abcd::3:4:ff,2.2.2.2", std::string());
+
+  const HostPortPair host_port_pair("www.google.com", 80);
+  EXPECT_EQ(ADDRESS_FAMILY_UNSPECIFIED,
+            http_server_properties_.GetPreferredAddressFamily(host_port_pair));
+
+  TestCompletionCallback callback;
+  ClientSocketHandle handle;
+  int rv = handle.Init("a", params_, LOW, callback.callback(), &pool,
+                       BoundNetLog());
+  EXPECT_EQ(ERR_IO_PENDING, rv);
+  EXPECT_EQ(OK, callback.WaitForResult());
+  EXPECT_EQ(2, client_socket_factory_.allocation_count());
+  EXPECT_EQ(ADDRESS_FAMILY_IPV4,
+            http_server_properties_.GetPreferredAddressFamily(host_port_pair));
+
+  // The second connect starts with the IPv4 address, and does not race.
+  ClientSocketHandle handle2;
+  rv = handle2.Init("b", params_, LOW, callback.callback(), &pool,
+                    BoundNetLog());
+  EXPECT_EQ(OK, callback.GetResult(rv));
+  IPEndPoint endpoint;
+  handle2.socket()->GetLocalAddress(&endpoint);
+  EXPECT_EQ(kIPv4AddressSize, endpoint.address().size());
+  EXPECT_EQ(3, client_socket_factory_.allocation_count());
+}
+
 }  // namespace
 
 }  // namespace net
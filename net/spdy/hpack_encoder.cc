@@ -21,6 +21,16 @@ bool HpackEncoder::EncodeHeaderSet(const std::map<string, string>& header_set,
   HpackOutputStream output_stream(max_string_literal_size_);
   for (std::map<string, string>::const_iterator it = header_set.begin();
        it != header_set.end(); ++it) {
+    // Refer to the name by index when the tables have it, which saves
+    // its bytes and lets the decoder skip the string copy.
+    uint32 name_index = context_.GetIndexOfName(it->first);
+    if (name_index > 0) {
+      if (!output_stream.AppendLiteralHeaderNoIndexingWithIndexedName(
+              name_index, it->second)) {
+        return false;
+      }
+      continue;
+    }
     // TODO(akalin): Clarify in the spec that encoding with the name
     // as a literal is OK even if the name already exists in the
     // header table.
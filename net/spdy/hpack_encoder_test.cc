@@ -39,6 +39,22 @@ TEST(HpackEncoderTest, Basic) {
             "\x40\x05name3\x06value3", encoded_header_set2);
 }
 
+// Test that names in the static table are referred to by index.
+TEST(HpackEncoderTest, StaticTableName) {
+  HpackEncoder encoder(kuint32max);
+
+  std::map<string, string> header_set;
+  header_set[":path"] = "/foo";
+  header_set["cookie"] = "a=b";
+  header_set["name1"] = "value1";
+
+  string encoded_header_set;
+  EXPECT_TRUE(encoder.EncodeHeaderSet(header_set, &encoded_header_set));
+  EXPECT_EQ("\x44\x04/foo"
+            "\x5f\x03" "a=b"
+            "\x40\x05name1\x06value1", encoded_header_set);
+}
+
 // Test that trying to encode a header set with a too-long header
 // field will fail.
 TEST(HpackEncoderTest, HeaderTooLarge) {
@@ -6,6 +6,8 @@
 
 #include <cstddef>
 
+#include "base/containers/hash_tables.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "net/spdy/hpack_entry.h"
@@ -98,6 +100,32 @@ const StaticEntry kStaticTable[] = {
 
 const size_t kStaticEntryCount = arraysize(kStaticTable);
 
+// Maps each name of the static table to the position of its first
+// entry, starting from 1. The keys point into kStaticTable.
+class StaticNameIndex {
+ public:
+  StaticNameIndex() {
+    for (size_t i = kStaticEntryCount; i > 0; --i) {
+      const StaticEntry& entry = kStaticTable[i - 1];
+      positions_[StringPiece(entry.name, entry.name_len)] =
+          static_cast<uint32>(i);
+    }
+  }
+
+  // Returns 0 if no entry has the given name.
+  uint32 GetPosition(StringPiece name) const {
+    base::hash_map<StringPiece, uint32>::const_iterator it =
+        positions_.find(name);
+    return (it == positions_.end()) ? 0 : it->second;
+  }
+
+ private:
+  base::hash_map<StringPiece, uint32> positions_;
+};
+
+base::LazyInstance<StaticNameIndex>::Leaky g_static_name_index =
+    LAZY_INSTANCE_INITIALIZER;
+
 }  // namespace
 
 const uint32 HpackEncodingContext::kUntouched = HpackEntry::kUntouched;
@@ -136,6 +164,19 @@ StringPiece HpackEncodingContext::GetValueAt(uint32 index) const {
   return header_table_.GetEntry(index).value();
 }
 
+uint32 HpackEncodingContext::GetIndexOfName(StringPiece name) const {
+  // The header table is bounded by its maximum size, and is usually
+  // much smaller than the static table.
+  for (uint32 i = 1; i <= header_table_.GetEntryCount(); ++i) {
+    if (header_table_.GetEntry(i).name() == name)
+      return i;
+  }
+  uint32 position = g_static_name_index.Get().GetPosition(name);
+  if (position == 0)
+    return 0;
+  return header_table_.GetEntryCount() + position;
+}
+
 bool HpackEncodingContext::IsReferencedAt(uint32 index) const {
   CHECK_GE(index, 1u);
   CHECK_LE(index, GetEntryCount());
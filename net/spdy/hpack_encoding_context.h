@@ -53,6 +53,12 @@ class NET_EXPORT_PRIVATE HpackEncodingContext {
 
   base::StringPiece GetValueAt(uint32 index) const;
 
+  // Returns the index of the first entry with the given name, or 0
+  // if there is none. Static entries are looked up through a hash
+  // index, built on first use, instead of by scanning the static
+  // table.
+  uint32 GetIndexOfName(base::StringPiece name) const;
+
   bool IsReferencedAt(uint32 index) const;
 
   uint32 GetTouchCountAt(uint32 index) const;
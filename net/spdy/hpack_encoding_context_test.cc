@@ -157,6 +157,27 @@ TEST(HpackEncodingContextTest, LiteralHeaderIncrementalIndexingDoesNotFit) {
   EXPECT_EQ(0u, encoding_context.GetMutableEntryCount());
 }
 
+// Names are found in both the header table and the static table,
+// and the first matching entry wins.
+TEST(HpackEncodingContextTest, GetIndexOfName) {
+  HpackEncodingContext encoding_context;
+
+  EXPECT_EQ(1u, encoding_context.GetIndexOfName(":authority"));
+  EXPECT_EQ(2u, encoding_context.GetIndexOfName(":method"));
+  EXPECT_EQ(4u, encoding_context.GetIndexOfName(":path"));
+  EXPECT_EQ(0u, encoding_context.GetIndexOfName("name"));
+
+  uint32 index = 0;
+  std::vector<uint32> removed_referenced_indices;
+  EXPECT_TRUE(
+      encoding_context.ProcessLiteralHeaderWithIncrementalIndexing(
+          "name", "value", &index, &removed_referenced_indices));
+  EXPECT_EQ(1u, index);
+
+  EXPECT_EQ(1u, encoding_context.GetIndexOfName("name"));
+  EXPECT_EQ(3u, encoding_context.GetIndexOfName(":method"));
+}
+
 }  // namespace
 
 }  // namespace net
@@ -39,6 +39,13 @@ class NET_EXPORT_PRIVATE HpackOutputStream {
   bool AppendLiteralHeaderNoIndexingWithName(base::StringPiece name,
                                              base::StringPiece value);
 
+  // Corresponds to 4.3.1 (first form). |name_index| is the index of
+  // an entry whose name is used. Returns whether or not the append
+  // was successful; if the append was unsuccessful, no other member
+  // function may be called.
+  bool AppendLiteralHeaderNoIndexingWithIndexedName(uint32 name_index,
+                                                    base::StringPiece value);
+
   // Moves the internal buffer to the given string and clears all
   // internal state.
   void TakeString(std::string* output);
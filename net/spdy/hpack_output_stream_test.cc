@@ -288,6 +288,18 @@ TEST(HpackOutputStreamTest, AppendLiteralHeaderNoIndexingWithName) {
   EXPECT_EQ("\x40\x04name\x05value", str);
 }
 
+// Test that encoding a literal header without indexing with an
+// indexed name encodes the index and the value.
+TEST(HpackOutputStreamTest, AppendLiteralHeaderNoIndexingWithIndexedName) {
+  HpackOutputStream output_stream(kuint32max);
+  EXPECT_TRUE(
+      output_stream.AppendLiteralHeaderNoIndexingWithIndexedName(4, "/"));
+
+  string str;
+  output_stream.TakeString(&str);
+  EXPECT_EQ("\x44\x01/", str);
+}
+
 // Test that trying to encode a header with a too-long header name or
 // value will fail.
 TEST(HpackOutputStreamTest, AppendLiteralHeaderNoIndexingWithNameTooLong) {
@@ -537,8 +537,11 @@ void SpdyHttpStream::Drain(HttpNetworkSession* session) {
 }
 
 void SpdyHttpStream::SetPriority(RequestPriority priority) {
-  // TODO(akalin): Plumb this through to |stream_request_| and
-  // |stream_|.
+  if (stream_.get()) {
+    stream_->SetPriority(priority);
+  } else {
+    stream_request_.SetPriority(priority);
+  }
 }
 
 }  // namespace net
@@ -365,6 +365,16 @@ void SpdyStreamRequest::CancelRequest() {
   weak_ptr_factory_.InvalidateWeakPtrs();
 }
 
+void SpdyStreamRequest::SetPriority(RequestPriority priority) {
+  CHECK_GE(priority, MINIMUM_PRIORITY);
+  CHECK_LE(priority, MAXIMUM_PRIORITY);
+  if (!session_ || priority == priority_)
+    return;
+  session_->ChangeStreamRequestPriority(weak_ptr_factory_.GetWeakPtr(),
+                                        priority);
+  priority_ = priority;
+}
+
 base::WeakPtr<SpdyStream> SpdyStreamRequest::ReleaseStream() {
   DCHECK(!session_);
   base::WeakPtr<SpdyStream> stream = stream_;
@@ -425,6 +435,17 @@ SpdySession::PushedStreamInfo::PushedStreamInfo(
 
 SpdySession::PushedStreamInfo::~PushedStreamInfo() {}
 
+SpdySession::InFlightWrite::InFlightWrite(
+    SpdyFrameType frame_type,
+    scoped_ptr<SpdyBuffer> buffer,
+    const base::WeakPtr<SpdyStream>& stream)
+    : frame_type(frame_type),
+      buffer(buffer.Pass()),
+      frame_size(this->buffer->GetRemainingSize()),
+      stream(stream) {}
+
+SpdySession::InFlightWrite::~InFlightWrite() {}
+
 SpdySession::SpdySession(
     const SpdySessionKey& spdy_session_key,
     const base::WeakPtr<HttpServerProperties>& http_server_properties,
@@ -446,8 +467,6 @@ SpdySession::SpdySession(
       http_server_properties_(http_server_properties),
       read_buffer_(new IOBuffer(kReadBufferSize)),
       stream_hi_water_mark_(kFirstStreamId),
-      in_flight_write_frame_type_(DATA),
-      in_flight_write_frame_size_(0),
       is_secure_(false),
       certificate_error_code_(OK),
       availability_state_(STATE_AVAILABLE),
@@ -464,6 +483,8 @@ SpdySession::SpdySession(
       streams_pushed_count_(0),
       streams_pushed_and_claimed_count_(0),
       streams_abandoned_count_(0),
+      frames_sent_count_(0),
+      socket_writes_count_(0),
       total_bytes_received_(0),
       sent_settings_(false),
       received_settings_(false),
@@ -482,6 +503,7 @@ SpdySession::SpdySession(
       session_send_window_size_(0),
       session_recv_window_size_(0),
       session_unacked_recv_window_bytes_(0),
+      session_max_recv_window_size_(0),
       net_log_(BoundNetLog::Make(net_log, NetLog::SOURCE_SPDY_SESSION)),
       verify_domain_authentication_(verify_domain_authentication),
       enable_sending_initial_data_(enable_sending_initial_data),
@@ -561,6 +583,7 @@ Error SpdySession::InitializeWithSocket(
     flow_control_state_ = FLOW_CONTROL_STREAM_AND_SESSION;
     session_send_window_size_ = kSpdySessionInitialWindowSize;
     session_recv_window_size_ = kSpdySessionInitialWindowSize;
+    session_max_recv_window_size_ = kSpdySessionInitialWindowSize;
   } else if (protocol_ >= kProtoSPDY3) {
     flow_control_state_ = FLOW_CONTROL_STREAM;
   } else {
@@ -781,6 +804,23 @@ void SpdySession::CancelStreamRequest(
   }
 }
 
+void SpdySession::ChangeStreamRequestPriority(
+    const base::WeakPtr<SpdyStreamRequest>& request,
+    RequestPriority priority) {
+  DCHECK(request);
+  PendingStreamRequestQueue* queue =
+      &pending_create_stream_queues_[request->priority()];
+  PendingStreamRequestQueue::iterator it =
+      std::find_if(queue->begin(), queue->end(), RequestEquals(request));
+  // The request may already be removed if there's a
+  // CompleteStreamRequest() in flight, in which case the stream is
+  // created with the new priority.
+  if (it == queue->end())
+    return;
+  queue->erase(it);
+  pending_create_stream_queues_[priority].push_back(request);
+}
+
 base::WeakPtr<SpdyStreamRequest> SpdySession::GetNextPendingStreamRequest() {
   for (int j = MAXIMUM_PRIORITY; j >= MINIMUM_PRIORITY; --j) {
     if (pending_create_stream_queues_[j].empty())
@@ -1347,74 +1387,117 @@ int SpdySession::DoWrite() {
   DCHECK_NE(availability_state_, STATE_CLOSED);
 
   DCHECK(buffered_spdy_framer_);
-  if (in_flight_write_) {
-    DCHECK_GT(in_flight_write_->GetRemainingSize(), 0u);
+  if (!in_flight_writes_.empty()) {
+    DCHECK_GT(in_flight_writes_.front()->buffer->GetRemainingSize(), 0u);
   } else {
-    // Grab the next frame to send.
-    SpdyFrameType frame_type = DATA;
-    scoped_ptr<SpdyBufferProducer> producer;
-    base::WeakPtr<SpdyStream> stream;
-    if (!write_queue_.Dequeue(&frame_type, &producer, &stream)) {
+    // Grab the next frames to send, in priority order, until there is
+    // enough data for a large write.
+    size_t write_size = 0;
+    do {
+      scoped_ptr<InFlightWrite> write;
+      int rv = DequeueWrite(&write);
+      if (rv != OK)
+        return rv;
+      if (!write)
+        break;
+      write_size += write->frame_size;
+      in_flight_writes_.push_back(write.release());
+    } while (write_size < kMaxCoalescedWriteSize);
+
+    if (in_flight_writes_.empty()) {
       write_state_ = WRITE_STATE_IDLE;
       return ERR_IO_PENDING;
     }
 
-    if (stream.get())
-      DCHECK(!stream->IsClosed());
-
-    // Activate the stream only when sending the SYN_STREAM frame to
-    // guarantee monotonically-increasing stream IDs.
-    if (frame_type == SYN_STREAM) {
-      if (stream.get() && stream->stream_id() == 0) {
-        scoped_ptr<SpdyStream> owned_stream =
-            ActivateCreatedStream(stream.get());
-        InsertActivatedStream(owned_stream.Pass());
-      } else {
-        NOTREACHED();
-        return ERR_UNEXPECTED;
+    frames_sent_count_ += in_flight_writes_.size();
+    UMA_HISTOGRAM_COUNTS_100("Net.SpdyFramesPerWrite",
+                             in_flight_writes_.size());
+
+    if (in_flight_writes_.size() > 1) {
+      scoped_refptr<IOBuffer> data(new IOBuffer(write_size));
+      size_t offset = 0;
+      for (ScopedVector<InFlightWrite>::const_iterator it =
+               in_flight_writes_.begin();
+           it != in_flight_writes_.end(); ++it) {
+        const SpdyBuffer* buffer = (*it)->buffer.get();
+        memcpy(data->data() + offset, buffer->GetRemainingData(),
+               buffer->GetRemainingSize());
+        offset += buffer->GetRemainingSize();
       }
+      in_flight_write_buffer_ = new DrainableIOBuffer(data.get(), write_size);
     }
-
-    in_flight_write_ = producer->ProduceBuffer();
-    if (!in_flight_write_) {
-      NOTREACHED();
-      return ERR_UNEXPECTED;
-    }
-    in_flight_write_frame_type_ = frame_type;
-    in_flight_write_frame_size_ = in_flight_write_->GetRemainingSize();
-    DCHECK_GE(in_flight_write_frame_size_,
-              buffered_spdy_framer_->GetFrameMinimumSize());
-    in_flight_write_stream_ = stream;
   }
 
   write_state_ = WRITE_STATE_DO_WRITE_COMPLETE;
+  ++socket_writes_count_;
+
+  if (in_flight_write_buffer_.get()) {
+    return connection_->socket()->Write(
+        in_flight_write_buffer_.get(),
+        in_flight_write_buffer_->BytesRemaining(),
+        base::Bind(&SpdySession::PumpWriteLoop,
+                   weak_factory_.GetWeakPtr(), WRITE_STATE_DO_WRITE_COMPLETE));
+  }
 
   // Explicitly store in a scoped_refptr<IOBuffer> to avoid problems
   // with Socket implementations that don't store their IOBuffer
   // argument in a scoped_refptr<IOBuffer> (see crbug.com/232345).
+  SpdyBuffer* buffer = in_flight_writes_.front()->buffer.get();
   scoped_refptr<IOBuffer> write_io_buffer =
-      in_flight_write_->GetIOBufferForRemainingData();
+      buffer->GetIOBufferForRemainingData();
   return connection_->socket()->Write(
       write_io_buffer.get(),
-      in_flight_write_->GetRemainingSize(),
+      buffer->GetRemainingSize(),
       base::Bind(&SpdySession::PumpWriteLoop,
                  weak_factory_.GetWeakPtr(), WRITE_STATE_DO_WRITE_COMPLETE));
 }
 
+int SpdySession::DequeueWrite(scoped_ptr<InFlightWrite>* write) {
+  SpdyFrameType frame_type = DATA;
+  scoped_ptr<SpdyBufferProducer> producer;
+  base::WeakPtr<SpdyStream> stream;
+  if (!write_queue_.Dequeue(&frame_type, &producer, &stream))
+    return OK;
+
+  if (stream.get())
+    DCHECK(!stream->IsClosed());
+
+  // Activate the stream only when sending the SYN_STREAM frame to
+  // guarantee monotonically-increasing stream IDs.
+  if (frame_type == SYN_STREAM) {
+    if (stream.get() && stream->stream_id() == 0) {
+      scoped_ptr<SpdyStream> owned_stream =
+          ActivateCreatedStream(stream.get());
+      InsertActivatedStream(owned_stream.Pass());
+    } else {
+      NOTREACHED();
+      return ERR_UNEXPECTED;
+    }
+  }
+
+  scoped_ptr<SpdyBuffer> buffer = producer->ProduceBuffer();
+  if (!buffer) {
+    NOTREACHED();
+    return ERR_UNEXPECTED;
+  }
+  DCHECK_GE(buffer->GetRemainingSize(),
+            buffered_spdy_framer_->GetFrameMinimumSize());
+  write->reset(new InFlightWrite(frame_type, buffer.Pass(), stream));
+  return OK;
+}
+
 int SpdySession::DoWriteComplete(int result) {
   CHECK(in_io_loop_);
   DCHECK_NE(availability_state_, STATE_CLOSED);
   DCHECK_NE(result, ERR_IO_PENDING);
-  DCHECK_GT(in_flight_write_->GetRemainingSize(), 0u);
+  DCHECK(!in_flight_writes_.empty());
 
   last_activity_time_ = time_func_();
 
   if (result < 0) {
     DCHECK_NE(result, ERR_IO_PENDING);
-    in_flight_write_.reset();
-    in_flight_write_frame_type_ = DATA;
-    in_flight_write_frame_size_ = 0;
-    in_flight_write_stream_.reset();
+    in_flight_writes_.clear();
+    in_flight_write_buffer_ = NULL;
     CloseSessionResult close_session_result =
         DoCloseSession(static_cast<Error>(result), "Write error");
     DCHECK_EQ(close_session_result, SESSION_CLOSED_BUT_NOT_REMOVED);
@@ -1423,31 +1506,48 @@ int SpdySession::DoWriteComplete(int result) {
     return result;
   }
 
-  // It should not be possible to have written more bytes than our
-  // in_flight_write_.
-  DCHECK_LE(static_cast<size_t>(result),
-            in_flight_write_->GetRemainingSize());
-
   if (result > 0) {
-    in_flight_write_->Consume(static_cast<size_t>(result));
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Net.SpdyBytesPerSocketWrite", result,
+                                1, 64 * 1024, 50);
+    if (in_flight_write_buffer_.get()) {
+      // It should not be possible to have written more bytes than our
+      // in-flight writes.
+      DCHECK_LE(result, in_flight_write_buffer_->BytesRemaining());
+      in_flight_write_buffer_->DidConsume(result);
+    } else {
+      DCHECK_LE(static_cast<size_t>(result),
+                in_flight_writes_.front()->buffer->GetRemainingSize());
+    }
+
+    size_t remaining = static_cast<size_t>(result);
+    while (remaining > 0 && !in_flight_writes_.empty()) {
+      InFlightWrite* write = in_flight_writes_.front();
+      size_t consumed =
+          std::min(remaining, write->buffer->GetRemainingSize());
+      write->buffer->Consume(consumed);
+      remaining -= consumed;
+
+      // We only notify the stream when we've fully written the frame.
+      if (write->buffer->GetRemainingSize() > 0)
+        break;
+
+      // Cleanup the write which just completed, before notifying the
+      // stream, which may delete itself.
+      scoped_ptr<InFlightWrite> completed_write(write);
+      in_flight_writes_.weak_erase(in_flight_writes_.begin());
 
-    // We only notify the stream when we've fully written the pending frame.
-    if (in_flight_write_->GetRemainingSize() == 0) {
       // It is possible that the stream was cancelled while we were
       // writing to the socket.
-      if (in_flight_write_stream_.get()) {
-        DCHECK_GT(in_flight_write_frame_size_, 0u);
-        in_flight_write_stream_->OnFrameWriteComplete(
-            in_flight_write_frame_type_,
-            in_flight_write_frame_size_);
+      if (completed_write->stream.get()) {
+        DCHECK_GT(completed_write->frame_size, 0u);
+        completed_write->stream->OnFrameWriteComplete(
+            completed_write->frame_type,
+            completed_write->frame_size);
       }
-
-      // Cleanup the write which just completed.
-      in_flight_write_.reset();
-      in_flight_write_frame_type_ = DATA;
-      in_flight_write_frame_size_ = 0;
-      in_flight_write_stream_.reset();
     }
+    DCHECK_EQ(0u, remaining);
+    if (in_flight_writes_.empty())
+      in_flight_write_buffer_ = NULL;
   }
 
   write_state_ = WRITE_STATE_DO_WRITE;
@@ -1664,6 +1764,8 @@ base::Value* SpdySession::GetInfoAsValue() const {
   dict->SetInteger("streams_abandoned_count", streams_abandoned_count_);
   DCHECK(buffered_spdy_framer_.get());
   dict->SetInteger("frames_received", buffered_spdy_framer_->frames_received());
+  dict->SetInteger("frames_sent", frames_sent_count_);
+  dict->SetInteger("socket_writes", socket_writes_count_);
 
   dict->SetBoolean("sent_settings", sent_settings_);
   dict->SetBoolean("received_settings", received_settings_);
@@ -1735,7 +1837,7 @@ void SpdySession::EnqueueWrite(RequestPriority priority,
   write_queue_.Enqueue(priority, frame_type, producer.Pass(), stream);
   if (write_state_ == WRITE_STATE_IDLE) {
     DCHECK(was_idle);
-    DCHECK(!in_flight_write_);
+    DCHECK(in_flight_writes_.empty());
     write_state_ = WRITE_STATE_DO_WRITE;
     base::MessageLoop::current()->PostTask(
         FROM_HERE,
@@ -1773,12 +1875,14 @@ void SpdySession::InsertActivatedStream(scoped_ptr<SpdyStream> stream) {
 }
 
 void SpdySession::DeleteStream(scoped_ptr<SpdyStream> stream, int status) {
-  if (in_flight_write_stream_.get() == stream.get()) {
-    // If we're deleting the stream for the in-flight write, we still
-    // need to let the write complete, so we clear
-    // |in_flight_write_stream_| and let the write finish on its own
-    // without notifying |in_flight_write_stream_|.
-    in_flight_write_stream_.reset();
+  for (ScopedVector<InFlightWrite>::iterator it = in_flight_writes_.begin();
+       it != in_flight_writes_.end(); ++it) {
+    if ((*it)->stream.get() == stream.get()) {
+      // If we're deleting the stream for an in-flight write, we still
+      // need to let the write complete, so we clear its stream and let
+      // the write finish on its own without notifying the stream.
+      (*it)->stream.reset();
+    }
   }
 
   write_queue_.RemovePendingWritesForStream(stream->GetWeakPtr());
@@ -2421,7 +2525,8 @@ void SpdySession::OnPing(SpdyPingId unique_id) {
 
   // We will record RTT in histogram when there are no more client sent
   // pings_in_flight_.
-  RecordPingRTTHistogram(time_func_() - last_ping_sent_time_);
+  last_ping_rtt_ = time_func_() - last_ping_sent_time_;
+  RecordPingRTTHistogram(last_ping_rtt_);
 }
 
 void SpdySession::OnWindowUpdate(SpdyStreamId stream_id,
@@ -2507,6 +2612,53 @@ void SpdySession::SendStreamWindowUpdate(SpdyStreamId stream_id,
       stream_id, delta_window_size, it->second.stream->priority());
 }
 
+void SpdySession::OnStreamPriorityChanged(
+    const base::WeakPtr<SpdyStream>& stream,
+    RequestPriority old_priority) {
+  DCHECK(stream.get());
+  RequestPriority new_priority = stream->priority();
+  write_queue_.ChangePriorityOfWritesForStream(
+      stream, old_priority, new_priority);
+
+  // A send-stalled stream is resumed in the order of its new priority.
+  SpdyStreamId stream_id = stream->stream_id();
+  if (stream_id == 0)
+    return;
+  std::deque<SpdyStreamId>* old_queue =
+      &stream_send_unstall_queue_[old_priority];
+  size_t old_size = old_queue->size();
+  old_queue->erase(std::remove(old_queue->begin(), old_queue->end(), stream_id),
+                   old_queue->end());
+  if (old_queue->size() < old_size)
+    stream_send_unstall_queue_[new_priority].push_back(stream_id);
+}
+
+int32 SpdySession::AutoTuneRecvWindowSize(
+    int32 window_size,
+    base::TimeTicks* last_update_time) {
+  base::TimeTicks now = time_func_();
+  base::TimeTicks previous_update_time = *last_update_time;
+  *last_update_time = now;
+  if (last_ping_rtt_ == base::TimeDelta() || previous_update_time.is_null() ||
+      window_size >= kMaxAutoTunedRecvWindowSize) {
+    return window_size;
+  }
+  if (now - previous_update_time >= 2 * last_ping_rtt_)
+    return window_size;
+  return std::min(kMaxAutoTunedRecvWindowSize / 2, window_size) * 2;
+}
+
+void SpdySession::OnStreamRecvWindowSizeGrown(int32 window_size) {
+  if (flow_control_state_ != FLOW_CONTROL_STREAM_AND_SESSION ||
+      availability_state_ == STATE_CLOSED ||
+      window_size <= session_max_recv_window_size_) {
+    return;
+  }
+  int32 delta_window_size = window_size - session_max_recv_window_size_;
+  session_max_recv_window_size_ = window_size;
+  IncreaseRecvWindowSize(delta_window_size);
+}
+
 void SpdySession::SendInitialData() {
   DCHECK(enable_sending_initial_data_);
   DCHECK_NE(availability_state_, STATE_CLOSED);
@@ -2546,6 +2698,7 @@ void SpdySession::SendInitialData() {
     // This condition implies that |kDefaultInitialRecvWindowSize| -
     // |session_recv_window_size_| doesn't overflow.
     DCHECK_GT(session_recv_window_size_, 0);
+    session_max_recv_window_size_ = kDefaultInitialRecvWindowSize;
     IncreaseRecvWindowSize(
         kDefaultInitialRecvWindowSize - session_recv_window_size_);
   }
@@ -14,6 +14,7 @@
 #include "base/gtest_prod_util.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
 #include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
 #include "net/base/io_buffer.h"
@@ -58,9 +59,18 @@ const int kMaxConcurrentPushedStreams = 1000;
 // yielding.
 const int kMaxReadBytesWithoutYielding = 32 * 1024;
 
+// Frames waiting to be written are written to the socket together until they
+// add up to this many bytes, so that they go out in few TLS records.
+const size_t kMaxCoalescedWriteSize = 16 * 1024;
+
 // The initial receive window size for both streams and sessions.
 const int32 kDefaultInitialRecvWindowSize = 10 * 1024 * 1024;  // 10MB
 
+// Receive windows that limit the transfer rate are grown up to this
+// size, which bounds the data a server can make us buffer for a stream
+// or a session.
+const int32 kMaxAutoTunedRecvWindowSize = 32 * 1024 * 1024;  // 32MB
+
 class BoundNetLog;
 struct LoadTimingInfo;
 class SpdyStream;
@@ -149,6 +159,11 @@ class NET_EXPORT_PRIVATE SpdyStreamRequest {
   // repeatedly.
   void CancelRequest();
 
+  // Changes the priority of a pending request, so that it is queued
+  // at the new priority. Has no effect on a request that isn't
+  // pending.
+  void SetPriority(RequestPriority priority);
+
   // Transfers the created stream (guaranteed to not be NULL) to the
   // caller. Must be called at most once after StartRequest() returns
   // OK or |callback| is called with OK. The caller must immediately
@@ -338,6 +353,11 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   void SendStreamWindowUpdate(SpdyStreamId stream_id,
                               uint32 delta_window_size);
 
+  // Called by a stream whose priority changed from |old_priority| to
+  // |stream->priority()|, to requeue its pending writes.
+  void OnStreamPriorityChanged(const base::WeakPtr<SpdyStream>& stream,
+                               RequestPriority old_priority);
+
   // Whether the stream is closed, i.e. it has stopped processing data
   // and is about to be destroyed.
   //
@@ -420,6 +440,20 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
     return stream_initial_recv_window_size_;
   }
 
+  // Called before a WINDOW_UPDATE frame is sent for a receive window
+  // of |window_size|, the last one having been sent at
+  // |*last_update_time|, which is set to now. Returns the window size
+  // to use from now on: if the updates are less than two round trips
+  // apart, the window limits the transfer rate, so it is doubled, up to
+  // kMaxAutoTunedRecvWindowSize. The window is left alone until a
+  // round trip has been measured with a PING.
+  int32 AutoTuneRecvWindowSize(int32 window_size,
+                               base::TimeTicks* last_update_time);
+
+  // Called by a stream whose receive window grew to |window_size|, so
+  // that the session receive window is at least as large.
+  void OnStreamRecvWindowSizeGrown(int32 window_size);
+
   // Returns true if no stream in the session can send data due to
   // session flow control.
   bool IsSendStalled() const {
@@ -483,6 +517,7 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   FRIEND_TEST_ALL_PREFIXES(SpdySessionTest, ClearSettings);
   FRIEND_TEST_ALL_PREFIXES(SpdySessionTest, AdjustRecvWindowSize);
   FRIEND_TEST_ALL_PREFIXES(SpdySessionTest, AdjustSendWindowSize);
+  FRIEND_TEST_ALL_PREFIXES(SpdySessionTest, AutoTuneRecvWindowSize);
   FRIEND_TEST_ALL_PREFIXES(SpdySessionTest, SessionFlowControlInactiveStream);
   FRIEND_TEST_ALL_PREFIXES(SpdySessionTest, SessionFlowControlNoReceiveLeaks);
   FRIEND_TEST_ALL_PREFIXES(SpdySessionTest, SessionFlowControlNoSendLeaks);
@@ -513,6 +548,22 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
 
   typedef std::set<SpdyStream*> CreatedStreamSet;
 
+  // A frame that is being written to the socket.
+  struct InFlightWrite {
+    InFlightWrite(SpdyFrameType frame_type,
+                  scoped_ptr<SpdyBuffer> buffer,
+                  const base::WeakPtr<SpdyStream>& stream);
+    ~InFlightWrite();
+
+    SpdyFrameType frame_type;
+    scoped_ptr<SpdyBuffer> buffer;
+    // The size of the whole frame.
+    size_t frame_size;
+    // The stream to notify when the frame has been written to the socket
+    // completely.
+    base::WeakPtr<SpdyStream> stream;
+  };
+
   enum AvailabilityState {
     // The session is available in its socket pool and can be used
     // freely.
@@ -573,6 +624,12 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   // creation queue.
   void CancelStreamRequest(const base::WeakPtr<SpdyStreamRequest>& request);
 
+  // Called by SpdyStreamRequest to move |request| to the stream
+  // creation queue for |priority|.
+  void ChangeStreamRequestPriority(
+      const base::WeakPtr<SpdyStreamRequest>& request,
+      RequestPriority priority);
+
   // Returns the next pending stream request to process, or NULL if
   // there is none.
   base::WeakPtr<SpdyStreamRequest> GetNextPendingStreamRequest();
@@ -639,6 +696,11 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   int DoWrite();
   int DoWriteComplete(int result);
 
+  // Dequeues the next frame to write into |write|, or leaves it NULL if the
+  // write queue is empty. Returns OK, or an error if the frame could not be
+  // produced.
+  int DequeueWrite(scoped_ptr<InFlightWrite>* write);
+
   // TODO(akalin): Rename the Send* and Write* functions below to
   // Enqueue*.
 
@@ -980,17 +1042,13 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   // The write queue.
   SpdyWriteQueue write_queue_;
 
-  // Data for the frame we are currently sending.
+  // Data for the frames we are currently sending.
 
-  // The buffer we're currently writing.
-  scoped_ptr<SpdyBuffer> in_flight_write_;
-  // The type of the frame in |in_flight_write_|.
-  SpdyFrameType in_flight_write_frame_type_;
-  // The size of the frame in |in_flight_write_|.
-  size_t in_flight_write_frame_size_;
-  // The stream to notify when |in_flight_write_| has been written to
-  // the socket completely.
-  base::WeakPtr<SpdyStream> in_flight_write_stream_;
+  // The frames we're currently writing, in order.
+  ScopedVector<InFlightWrite> in_flight_writes_;
+  // A copy of the remaining data of |in_flight_writes_| when there is more
+  // than one, so that they are written to the socket together.
+  scoped_refptr<DrainableIOBuffer> in_flight_write_buffer_;
 
   // Flag if we're using an SSL connection for this SpdySession.
   bool is_secure_;
@@ -1021,6 +1079,8 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   int streams_pushed_count_;
   int streams_pushed_and_claimed_count_;
   int streams_abandoned_count_;
+  int frames_sent_count_;
+  int socket_writes_count_;
 
   // |total_bytes_received_| keeps track of all the bytes read by the
   // SpdySession. It is used by the |Net.SpdySettingsCwnd...| histograms.
@@ -1040,6 +1100,10 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   // This is the last time we have sent a PING.
   base::TimeTicks last_ping_sent_time_;
 
+  // The round trip time measured by the last PING, or zero if none has
+  // been answered yet.
+  base::TimeDelta last_ping_rtt_;
+
   // This is the last time we had activity in the session.
   base::TimeTicks last_activity_time_;
 
@@ -1077,6 +1141,10 @@ class NET_EXPORT SpdySession : public BufferedSpdyFramerVisitorInterface,
   int32 session_send_window_size_;
   int32 session_recv_window_size_;
   int32 session_unacked_recv_window_bytes_;
+  // The receive window size announced to the server, which is grown by
+  // AutoTuneRecvWindowSize().
+  int32 session_max_recv_window_size_;
+  base::TimeTicks session_last_window_update_time_;
 
   // A queue of stream IDs that have been send-stalled at some point
   // in the past.
@@ -154,7 +154,9 @@ class NET_EXPORT SpdySessionPool
   typedef std::vector<base::WeakPtr<SpdySession> > WeakSessionList;
   typedef std::map<SpdySessionKey, base::WeakPtr<SpdySession> >
       AvailableSessionMap;
-  typedef std::map<IPEndPoint, SpdySessionKey> AliasMap;
+  // Several sessions may be connected to the same address, e.g. with
+  // different privacy modes or certificates, so all are kept.
+  typedef std::multimap<IPEndPoint, SpdySessionKey> AliasMap;
 
   // Returns true iff |session| is in |available_sessions_|.
   bool IsSessionAvailable(const base::WeakPtr<SpdySession>& session) const;
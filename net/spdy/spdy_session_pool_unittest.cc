@@ -493,6 +493,63 @@ TEST_P(SpdySessionPoolTest, IPPoolingCloseIdleSessions) {
   RunIPPoolingTest(SPDY_POOL_CLOSE_IDLE_SESSIONS);
 }
 
+// When several sessions are connected to the same address, any of them
+// that matches should be pooled with, not only the last one created.
+TEST_P(SpdySessionPoolTest, IPPoolingSeveralSessionsPerAddress) {
+  const int kTestPort = 80;
+  session_deps_.host_resolver->set_synchronous_mode(true);
+  session_deps_.host_resolver->rules()->AddIPLiteralRule(
+      "www.foo.com", "192.0.2.33", std::string());
+  session_deps_.host_resolver->rules()->AddIPLiteralRule(
+      "js.foo.com", "192.0.2.33", std::string());
+
+  // Populate the HostResolver cache for js.foo.com.
+  HostResolver::RequestInfo info(HostPortPair("js.foo.com", kTestPort));
+  AddressList addresses;
+  session_deps_.host_resolver->Resolve(info,
+                                       DEFAULT_PRIORITY,
+                                       &addresses,
+                                       CompletionCallback(),
+                                       NULL,
+                                       BoundNetLog());
+
+  MockConnect connect_data(SYNCHRONOUS, OK);
+  MockRead reads[] = {
+    MockRead(SYNCHRONOUS, ERR_IO_PENDING)  // Stall forever.
+  };
+  StaticSocketDataProvider data(reads, arraysize(reads), NULL, 0);
+  data.set_connect_data(connect_data);
+  session_deps_.socket_factory->AddSocketDataProvider(&data);
+  StaticSocketDataProvider data2(reads, arraysize(reads), NULL, 0);
+  data2.set_connect_data(connect_data);
+  session_deps_.socket_factory->AddSocketDataProvider(&data2);
+
+  CreateNetworkSession();
+
+  SpdySessionKey key(HostPortPair("www.foo.com", kTestPort),
+                     ProxyServer::Direct(), kPrivacyModeDisabled);
+  base::WeakPtr<SpdySession> session =
+      CreateInsecureSpdySession(http_session_, key, BoundNetLog());
+
+  // A second session to the same address, which can't be pooled with
+  // because of its privacy mode.
+  SpdySessionKey private_key(HostPortPair("www.foo.com", kTestPort),
+                             ProxyServer::Direct(), kPrivacyModeEnabled);
+  base::WeakPtr<SpdySession> private_session =
+      CreateInsecureSpdySession(http_session_, private_key, BoundNetLog());
+  EXPECT_NE(session.get(), private_session.get());
+
+  SpdySessionKey js_key(HostPortPair("js.foo.com", kTestPort),
+                        ProxyServer::Direct(), kPrivacyModeDisabled);
+  base::WeakPtr<SpdySession> js_session =
+      spdy_session_pool_->FindAvailableSession(js_key, BoundNetLog());
+  EXPECT_EQ(session.get(), js_session.get());
+
+  spdy_session_pool_->CloseCurrentSessions(ERR_ABORTED);
+  EXPECT_FALSE(HasSpdySession(spdy_session_pool_, key));
+  EXPECT_FALSE(HasSpdySession(spdy_session_pool_, js_key));
+}
+
 }  // namespace
 
 }  // namespace net
@@ -8,6 +8,7 @@
 #include "base/callback.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/run_loop.h"
+#include "base/values.h"
 #include "net/base/io_buffer.h"
 #include "net/base/ip_endpoint.h"
 #include "net/base/net_log_unittest.h"
@@ -1245,6 +1246,70 @@ TEST_P(SpdySessionTest, CancelPendingCreateStream) {
   base::MessageLoop::current()->RunUntilIdle();
 }
 
+// Changing the priority of a pending stream request should move it to
+// the queue for its new priority, so that it gets the next stream.
+TEST_P(SpdySessionTest, ChangePendingCreateStreamPriority) {
+  session_deps_.host_resolver->set_synchronous_mode(true);
+
+  MockRead reads[] = {
+    MockRead(SYNCHRONOUS, ERR_IO_PENDING)  // Stall forever.
+  };
+
+  StaticSocketDataProvider data(reads, arraysize(reads), NULL, 0);
+  MockConnect connect_data(SYNCHRONOUS, OK);
+
+  data.set_connect_data(connect_data);
+  session_deps_.socket_factory->AddSocketDataProvider(&data);
+
+  CreateNetworkSession();
+
+  base::WeakPtr<SpdySession> session =
+      CreateInsecureSpdySession(http_session_, key_, BoundNetLog());
+
+  // Leave room for only one more stream to be created.
+  for (size_t i = 0; i < kInitialMaxConcurrentStreams - 1; ++i) {
+    base::WeakPtr<SpdyStream> spdy_stream =
+        CreateStreamSynchronously(SPDY_BIDIRECTIONAL_STREAM,
+                                  session, test_url_, MEDIUM, BoundNetLog());
+    ASSERT_TRUE(spdy_stream != NULL);
+  }
+
+  base::WeakPtr<SpdyStream> spdy_stream1 =
+      CreateStreamSynchronously(SPDY_BIDIRECTIONAL_STREAM,
+                                session, test_url_, MEDIUM, BoundNetLog());
+  ASSERT_TRUE(spdy_stream1.get() != NULL);
+
+  TestCompletionCallback callback2;
+  SpdyStreamRequest request2;
+  ASSERT_EQ(ERR_IO_PENDING,
+            request2.StartRequest(
+                SPDY_BIDIRECTIONAL_STREAM, session, test_url_, LOWEST,
+                BoundNetLog(), callback2.callback()));
+
+  TestCompletionCallback callback3;
+  SpdyStreamRequest request3;
+  ASSERT_EQ(ERR_IO_PENDING,
+            request3.StartRequest(
+                SPDY_BIDIRECTIONAL_STREAM, session, test_url_, LOWEST,
+                BoundNetLog(), callback3.callback()));
+  EXPECT_EQ(2u, session->pending_create_stream_queue_size(LOWEST));
+
+  request3.SetPriority(HIGHEST);
+  EXPECT_EQ(1u, session->pending_create_stream_queue_size(LOWEST));
+  EXPECT_EQ(1u, session->pending_create_stream_queue_size(HIGHEST));
+
+  // Release the first stream. The reprioritized request goes first.
+  spdy_stream1->Cancel();
+  EXPECT_EQ(NULL, spdy_stream1.get());
+  EXPECT_EQ(OK, callback3.WaitForResult());
+  EXPECT_FALSE(callback2.have_result());
+  EXPECT_EQ(1u, session->pending_create_stream_queue_size(LOWEST));
+
+  base::WeakPtr<SpdyStream> stream3 = request3.ReleaseStream();
+  ASSERT_TRUE(stream3.get() != NULL);
+  EXPECT_EQ(HIGHEST, stream3->priority());
+}
+
 TEST_P(SpdySessionTest, SendInitialDataOnNewSession) {
   session_deps_.host_resolver->set_synchronous_mode(true);
 
@@ -1506,6 +1571,83 @@ TEST_P(SpdySessionTest, OutOfOrderSynStreams) {
   EXPECT_EQ(1u, delegate_highest.stream_id());
 }
 
+// Tests that frames queued at the same time are written to the socket
+// together.
+TEST_P(SpdySessionTest, CoalesceWrites) {
+  MockConnect connect_data(SYNCHRONOUS, OK);
+  scoped_ptr<SpdyFrame> req1(
+      spdy_util_.ConstructSpdyGet(NULL, 0, false, 1, MEDIUM, true));
+  scoped_ptr<SpdyFrame> req2(
+      spdy_util_.ConstructSpdyGet(NULL, 0, false, 3, MEDIUM, true));
+  const SpdyFrame* requests[] = { req1.get(), req2.get() };
+  char combined_requests[1000];
+  int combined_requests_len = CombineFrames(requests, arraysize(requests),
+                                            combined_requests,
+                                            arraysize(combined_requests));
+  MockWrite writes[] = {
+    MockWrite(ASYNC, combined_requests, combined_requests_len, 0),
+  };
+
+  MockRead reads[] = {
+    MockRead(ASYNC, 0, 1)  // EOF
+  };
+
+  session_deps_.host_resolver->set_synchronous_mode(true);
+
+  DeterministicSocketData data(reads, arraysize(reads),
+                               writes, arraysize(writes));
+  data.set_connect_data(connect_data);
+  session_deps_.deterministic_socket_factory->AddSocketDataProvider(&data);
+
+  CreateDeterministicNetworkSession();
+
+  base::WeakPtr<SpdySession> session =
+      CreateInsecureSpdySession(http_session_, key_, BoundNetLog());
+
+  GURL url(kDefaultURL);
+
+  base::WeakPtr<SpdyStream> spdy_stream1 =
+      CreateStreamSynchronously(SPDY_REQUEST_RESPONSE_STREAM,
+                                session, url, MEDIUM, BoundNetLog());
+  ASSERT_TRUE(spdy_stream1);
+  test::StreamDelegateDoNothing delegate1(spdy_stream1);
+  spdy_stream1->SetDelegate(&delegate1);
+
+  base::WeakPtr<SpdyStream> spdy_stream2 =
+      CreateStreamSynchronously(SPDY_REQUEST_RESPONSE_STREAM,
+                                session, url, MEDIUM, BoundNetLog());
+  ASSERT_TRUE(spdy_stream2);
+  test::StreamDelegateDoNothing delegate2(spdy_stream2);
+  spdy_stream2->SetDelegate(&delegate2);
+
+  scoped_ptr<SpdyHeaderBlock> headers1(
+      spdy_util_.ConstructGetHeaderBlock(url.spec()));
+  spdy_stream1->SendRequestHeaders(headers1.Pass(), NO_MORE_DATA_TO_SEND);
+  scoped_ptr<SpdyHeaderBlock> headers2(
+      spdy_util_.ConstructGetHeaderBlock(url.spec()));
+  spdy_stream2->SendRequestHeaders(headers2.Pass(), NO_MORE_DATA_TO_SEND);
+
+  data.RunFor(1);
+
+  EXPECT_EQ(1u, spdy_stream1->stream_id());
+  EXPECT_EQ(3u, spdy_stream2->stream_id());
+  scoped_ptr<base::Value> info(session->GetInfoAsValue());
+  base::DictionaryValue* dict = NULL;
+  ASSERT_TRUE(info->GetAsDictionary(&dict));
+  int frames_sent = 0;
+  int socket_writes = 0;
+  EXPECT_TRUE(dict->GetInteger("frames_sent", &frames_sent));
+  EXPECT_TRUE(dict->GetInteger("socket_writes", &socket_writes));
+  EXPECT_EQ(2, frames_sent);
+  EXPECT_EQ(1, socket_writes);
+
+  data.RunFor(1);
+
+  EXPECT_FALSE(spdy_stream1);
+  EXPECT_FALSE(spdy_stream2);
+  EXPECT_TRUE(session == NULL);
+}
+
 TEST_P(SpdySessionTest, CancelStream) {
   MockConnect connect_data(SYNCHRONOUS, OK);
   // Request 1, at HIGHEST priority, will be cancelled before it writes data.
@@ -3091,6 +3233,52 @@ TEST_P(SpdySessionTest, UpdateStreamsSendWindowSize) {
   EXPECT_EQ(NULL, spdy_stream2.get());
 }
 
+// Receive windows should only grow once a round trip time has been
+// measured, and while WINDOW_UPDATE frames are less than two round
+// trips apart.
+TEST_P(SpdySessionTest, AutoTuneRecvWindowSize) {
+  session_deps_.host_resolver->set_synchronous_mode(true);
+  session_deps_.time_func = TheNearFuture;
+
+  MockRead reads[] = {
+    MockRead(SYNCHRONOUS, ERR_IO_PENDING)  // Stall forever.
+  };
+  StaticSocketDataProvider data(reads, arraysize(reads), NULL, 0);
+  MockConnect connect_data(SYNCHRONOUS, OK);
+  data.set_connect_data(connect_data);
+  session_deps_.socket_factory->AddSocketDataProvider(&data);
+
+  CreateNetworkSession();
+  base::WeakPtr<SpdySession> session =
+      CreateInsecureSpdySession(http_session_, key_, BoundNetLog());
+
+  const int32 window_size = 1024 * 1024;
+  base::TimeTicks last_update_time;
+  EXPECT_EQ(window_size,
+            session->AutoTuneRecvWindowSize(window_size, &last_update_time));
+  EXPECT_FALSE(last_update_time.is_null());
+  EXPECT_EQ(window_size,
+            session->AutoTuneRecvWindowSize(window_size, &last_update_time));
+
+  // Back-to-back updates mean that the window limits the transfer rate.
+  session->last_ping_rtt_ = base::TimeDelta::FromMilliseconds(100);
+  EXPECT_EQ(2 * window_size,
+            session->AutoTuneRecvWindowSize(window_size, &last_update_time));
+
+  // Updates that are far apart don't.
+  g_time_delta = base::TimeDelta::FromSeconds(1);
+  EXPECT_EQ(window_size,
+            session->AutoTuneRecvWindowSize(window_size, &last_update_time));
+
+  // The window never grows past the limit.
+  EXPECT_EQ(kMaxAutoTunedRecvWindowSize,
+            session->AutoTuneRecvWindowSize(kMaxAutoTunedRecvWindowSize - 1,
+                                            &last_update_time));
+  EXPECT_EQ(kMaxAutoTunedRecvWindowSize,
+            session->AutoTuneRecvWindowSize(kMaxAutoTunedRecvWindowSize,
+                                            &last_update_time));
+}
+
 // The tests below are only for SPDY/3.1 and above.
 
 // SpdySession::{Increase,Decrease}RecvWindowSize should properly
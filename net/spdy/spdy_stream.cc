@@ -42,6 +42,18 @@ base::Value* NetLogSpdyStreamWindowUpdateCallback(
   return dict;
 }
 
+base::Value* NetLogSpdyStreamPriorityCallback(
+    SpdyStreamId stream_id,
+    RequestPriority old_priority,
+    RequestPriority new_priority,
+    NetLog::LogLevel /* log_level */) {
+  base::DictionaryValue* dict = new base::DictionaryValue();
+  dict->SetInteger("stream_id", static_cast<int>(stream_id));
+  dict->SetString("old_priority", RequestPriorityToString(old_priority));
+  dict->SetString("new_priority", RequestPriorityToString(new_priority));
+  return dict;
+}
+
 bool ContainsUppercaseAscii(const std::string& str) {
   for (std::string::const_iterator i(str.begin()); i != str.end(); ++i) {
     if (*i >= 'A' && *i <= 'Z') {
@@ -93,6 +105,7 @@ SpdyStream::SpdyStream(SpdyStreamType type,
       send_window_size_(initial_send_window_size),
       recv_window_size_(initial_recv_window_size),
       unacked_recv_window_bytes_(0),
+      max_recv_window_size_(initial_recv_window_size),
       session_(session),
       delegate_(NULL),
       pending_send_status_(MORE_DATA_TO_SEND),
@@ -329,8 +342,25 @@ void SpdyStream::IncreaseRecvWindowSize(int32 delta_window_size) {
                  stream_id_, delta_window_size, recv_window_size_));
 
   unacked_recv_window_bytes_ += delta_window_size;
-  if (unacked_recv_window_bytes_ >
-      session_->stream_initial_recv_window_size() / 2) {
+  if (unacked_recv_window_bytes_ > max_recv_window_size_ / 2) {
+    int32 new_max_recv_window_size = session_->AutoTuneRecvWindowSize(
+        max_recv_window_size_, &last_window_update_time_);
+    if (new_max_recv_window_size > max_recv_window_size_) {
+      int32 growth = new_max_recv_window_size - max_recv_window_size_;
+      max_recv_window_size_ = new_max_recv_window_size;
+      recv_window_size_ += growth;
+      unacked_recv_window_bytes_ += growth;
+      net_log_.AddEvent(
+          NetLog::TYPE_SPDY_STREAM_UPDATE_RECV_WINDOW,
+          base::Bind(&NetLogSpdyStreamWindowUpdateCallback,
+                     stream_id_, growth, recv_window_size_));
+      session_->OnStreamRecvWindowSizeGrown(max_recv_window_size_);
+    }
+    if (!window_limited_start_time_.is_null()) {
+      window_limited_time_ +=
+          base::TimeTicks::Now() - window_limited_start_time_;
+      window_limited_start_time_ = base::TimeTicks();
+    }
     session_->SendStreamWindowUpdate(
         stream_id_, static_cast<uint32>(unacked_recv_window_bytes_));
     unacked_recv_window_bytes_ = 0;
@@ -359,6 +389,12 @@ void SpdyStream::DecreaseRecvWindowSize(int32 delta_window_size) {
       NetLog::TYPE_SPDY_STREAM_UPDATE_RECV_WINDOW,
       base::Bind(&NetLogSpdyStreamWindowUpdateCallback,
                  stream_id_, -delta_window_size, recv_window_size_));
+
+  // The server can't send more until the next WINDOW_UPDATE frame.
+  if (recv_window_size_ == unacked_recv_window_bytes_ &&
+      window_limited_start_time_.is_null()) {
+    window_limited_start_time_ = base::TimeTicks::Now();
+  }
 }
 
 int SpdyStream::GetPeerAddress(IPEndPoint* address) const {
@@ -381,6 +417,21 @@ void SpdyStream::SetRequestTime(base::Time t) {
   request_time_ = t;
 }
 
+void SpdyStream::SetPriority(RequestPriority priority) {
+  CHECK_GE(priority, MINIMUM_PRIORITY);
+  CHECK_LE(priority, MAXIMUM_PRIORITY);
+  if (priority == priority_)
+    return;
+
+  RequestPriority old_priority = priority_;
+  priority_ = priority;
+  net_log_.AddEvent(
+      NetLog::TYPE_SPDY_STREAM_PRIORITY_CHANGED,
+      base::Bind(&NetLogSpdyStreamPriorityCallback,
+                 stream_id_, old_priority, priority_));
+  session_->OnStreamPriorityChanged(GetWeakPtr(), old_priority);
+}
+
 int SpdyStream::OnInitialResponseHeadersReceived(
     const SpdyHeaderBlock& initial_response_headers,
     base::Time response_time,
@@ -768,6 +819,16 @@ void SpdyStream::UpdateHistograms() {
 
   UMA_HISTOGRAM_COUNTS("Net.SpdySendBytes", send_bytes_);
   UMA_HISTOGRAM_COUNTS("Net.SpdyRecvBytes", recv_bytes_);
+
+  // Only streams that sent a WINDOW_UPDATE frame used their receive
+  // window at all.
+  if (!last_window_update_time_.is_null()) {
+    UMA_HISTOGRAM_TIMES("Net.SpdyStreamRecvWindowLimitedTime",
+                        window_limited_time_);
+    UMA_HISTOGRAM_CUSTOM_COUNTS("Net.SpdyStreamMaxRecvWindowSize",
+                                max_recv_window_size_ / 1024,
+                                1, kMaxAutoTunedRecvWindowSize / 1024, 50);
+  }
 }
 
 void SpdyStream::QueueNextDataFrame() {
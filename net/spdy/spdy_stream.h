@@ -284,6 +284,12 @@ class NET_EXPORT_PRIVATE SpdyStream {
   base::Time GetRequestTime() const;
   void SetRequestTime(base::Time t);
 
+  // Changes the priority of this stream. Pending writes for it are
+  // moved to the new priority. If the SYN_STREAM frame hasn't been
+  // sent yet, it carries the new priority; otherwise, the server is
+  // not told, since SPDY/3 has no way to reprioritize a stream.
+  void SetPriority(RequestPriority priority);
+
   // Called at most once by the SpdySession when the initial response
   // headers have been received for this stream, i.e., a SYN_REPLY (or
   // SYN_STREAM for push streams) frame has been received. This is the
@@ -492,13 +498,21 @@ class NET_EXPORT_PRIVATE SpdyStream {
 
   SpdyStreamId stream_id_;
   const GURL url_;
-  const RequestPriority priority_;
+  RequestPriority priority_;
 
   // Flow control variables.
   bool send_stalled_by_flow_control_;
   int32 send_window_size_;
   int32 recv_window_size_;
   int32 unacked_recv_window_bytes_;
+  // The receive window size announced to the server, which is grown by
+  // SpdySession::AutoTuneRecvWindowSize().
+  int32 max_recv_window_size_;
+  base::TimeTicks last_window_update_time_;
+  // When the server last ran out of receive window, or null if it
+  // hasn't since the last WINDOW_UPDATE frame.
+  base::TimeTicks window_limited_start_time_;
+  base::TimeDelta window_limited_time_;
 
   ScopedBandwidthMetrics metrics_;
 
@@ -105,6 +105,34 @@ void SpdyWriteQueue::RemovePendingWritesForStream(
   queue->erase(out_it, queue->end());
 }
 
+void SpdyWriteQueue::ChangePriorityOfWritesForStream(
+    const base::WeakPtr<SpdyStream>& stream,
+    RequestPriority old_priority,
+    RequestPriority new_priority) {
+  DCHECK(stream.get());
+  CHECK_GE(old_priority, MINIMUM_PRIORITY);
+  CHECK_LE(old_priority, MAXIMUM_PRIORITY);
+  CHECK_GE(new_priority, MINIMUM_PRIORITY);
+  CHECK_LE(new_priority, MAXIMUM_PRIORITY);
+  if (old_priority == new_priority)
+    return;
+
+  // Move the writes, preserving FIFO-ness in both queues.
+  std::deque<PendingWrite>* old_queue = &queue_[old_priority];
+  std::deque<PendingWrite>* new_queue = &queue_[new_priority];
+  std::deque<PendingWrite>::iterator out_it = old_queue->begin();
+  for (std::deque<PendingWrite>::const_iterator it = old_queue->begin();
+       it != old_queue->end(); ++it) {
+    if (it->stream.get() == stream.get()) {
+      new_queue->push_back(*it);
+    } else {
+      *out_it = *it;
+      ++out_it;
+    }
+  }
+  old_queue->erase(out_it, old_queue->end());
+}
+
 void SpdyWriteQueue::RemovePendingWritesForStreamsAfter(
     SpdyStreamId last_good_stream_id) {
   for (int i = MINIMUM_PRIORITY; i <= MAXIMUM_PRIORITY; ++i) {
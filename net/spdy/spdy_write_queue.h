@@ -53,6 +53,14 @@ class NET_EXPORT_PRIVATE SpdyWriteQueue {
   // non-NULL.
   void RemovePendingWritesForStream(const base::WeakPtr<SpdyStream>& stream);
 
+  // Moves all pending writes for the given stream, which must be
+  // non-NULL, from |old_priority| to |new_priority|, which should be
+  // the stream's new priority. They keep their relative order and go
+  // after the writes already queued at |new_priority|.
+  void ChangePriorityOfWritesForStream(const base::WeakPtr<SpdyStream>& stream,
+                                       RequestPriority old_priority,
+                                       RequestPriority new_priority);
+
   // Removes all pending writes for streams after |last_good_stream_id|
   // and streams with no stream id.
   void RemovePendingWritesForStreamsAfter(SpdyStreamId last_good_stream_id);
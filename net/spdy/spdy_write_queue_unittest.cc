@@ -184,6 +184,40 @@ TEST_F(SpdyWriteQueueTest, RemovePendingWritesForStream) {
   EXPECT_FALSE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
 }
 
+// Enqueue writes for two streams at the same priority, then move the
+// writes of the second one to a higher priority. They should be
+// dequeued first, still in FIFO order.
+TEST_F(SpdyWriteQueueTest, ChangePriorityOfWritesForStream) {
+  SpdyWriteQueue write_queue;
+
+  scoped_ptr<SpdyStream> stream1(MakeTestStream(LOWEST));
+  scoped_ptr<SpdyStream> stream2(MakeTestStream(LOWEST));
+
+  for (int i = 0; i < 10; ++i) {
+    base::WeakPtr<SpdyStream> stream =
+        (((i % 2) == 0) ? stream1 : stream2)->GetWeakPtr();
+    write_queue.Enqueue(LOWEST, SYN_STREAM, IntToProducer(i), stream);
+  }
+
+  write_queue.ChangePriorityOfWritesForStream(stream2->GetWeakPtr(),
+                                              LOWEST, HIGHEST);
+
+  for (int i = 0; i < 10; ++i) {
+    SpdyFrameType frame_type = DATA;
+    scoped_ptr<SpdyBufferProducer> frame_producer;
+    base::WeakPtr<SpdyStream> stream;
+    ASSERT_TRUE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
+    int expected = (i < 5) ? (2 * i + 1) : (2 * (i - 5));
+    EXPECT_EQ(expected, ProducerToInt(frame_producer.Pass()));
+    EXPECT_EQ((i < 5) ? stream2.get() : stream1.get(), stream.get());
+  }
+
+  SpdyFrameType frame_type = DATA;
+  scoped_ptr<SpdyBufferProducer> frame_producer;
+  base::WeakPtr<SpdyStream> stream;
+  EXPECT_FALSE(write_queue.Dequeue(&frame_type, &frame_producer, &stream));
+}
+
 // Enqueue a bunch of writes and then call
 // RemovePendingWritesForStreamsAfter(). No dequeued write should be for
 // those streams without a stream id, or with a stream_id after that
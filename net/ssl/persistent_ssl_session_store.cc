@@ -0,0 +1,270 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/ssl/persistent_ssl_session_store.h"
+
+#include "base/bind.h"
+#include "base/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/metrics/histogram.h"
+#include "base/pickle.h"
+#include "base/sequenced_task_runner.h"
+#include "crypto/encryptor.h"
+#include "crypto/hmac.h"
+#include "crypto/random.h"
+#include "crypto/symmetric_key.h"
+
+namespace net {
+
+namespace {
+
+// Version of the serialized sessions. Files with another version are ignored.
+const int kVersion = 1;
+
+const size_t kIVSize = 16;
+const size_t kKeySize = 32;
+const size_t kMACSize = 32;
+
+// Derives a key for a single purpose, named by |label|, from |secret|.
+std::string DeriveKey(const std::string& secret, const char* label) {
+  crypto::HMAC hmac(crypto::HMAC::SHA256);
+  unsigned char key[kKeySize];
+  if (!hmac.Init(secret) || !hmac.Sign(label, key, sizeof(key)))
+    return std::string();
+  return std::string(reinterpret_cast<const char*>(key), sizeof(key));
+}
+
+}  // namespace
+
+PersistentSSLSessionStore::PersistentSSLSessionStore(
+    const base::FilePath& path,
+    const std::string& secret,
+    const scoped_refptr<base::SequencedTaskRunner>& background_task_runner)
+    : path_(path),
+      encryption_key_(DeriveKey(secret, "ssl session store encryption")),
+      mac_key_(DeriveKey(secret, "ssl session store authentication")),
+      background_task_runner_(background_task_runner),
+      loaded_(false),
+      dirty_(false),
+      commit_pending_(false) {
+  DCHECK(!secret.empty());
+}
+
+PersistentSSLSessionStore::~PersistentSSLSessionStore() {
+}
+
+void PersistentSSLSessionStore::Init() {
+  background_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&PersistentSSLSessionStore::LoadOnBackgroundThread, this));
+}
+
+bool PersistentSSLSessionStore::Get(const std::string& key,
+                                    std::string* data) {
+  base::AutoLock locked(lock_);
+  SessionMap::const_iterator it = sessions_.find(key);
+  if (it == sessions_.end() || it->second.expiration <= base::Time::Now())
+    return false;
+  *data = it->second.data;
+  return true;
+}
+
+void PersistentSSLSessionStore::Save(const std::string& key,
+                                     const std::string& data,
+                                     base::Time expiration) {
+  base::AutoLock locked(lock_);
+  Session& session = sessions_[key];
+  session.data = data;
+  session.expiration = expiration;
+  ShrinkLocked();
+  ScheduleCommitLocked();
+}
+
+void PersistentSSLSessionStore::Remove(const std::string& key) {
+  base::AutoLock locked(lock_);
+  if (sessions_.erase(key))
+    ScheduleCommitLocked();
+}
+
+void PersistentSSLSessionStore::Clear() {
+  base::AutoLock locked(lock_);
+  sessions_.clear();
+  ScheduleCommitLocked();
+}
+
+size_t PersistentSSLSessionStore::size() {
+  base::AutoLock locked(lock_);
+  return sessions_.size();
+}
+
+void PersistentSSLSessionStore::LoadOnBackgroundThread() {
+  DCHECK(background_task_runner_->RunsTasksOnCurrentThread());
+
+  SessionMap loaded_sessions;
+  std::string contents;
+  std::string plaintext;
+  if (base::ReadFileToString(path_, &contents) &&
+      Decrypt(contents, &plaintext)) {
+    Pickle pickle(plaintext.data(), plaintext.size());
+    PickleIterator iter(pickle);
+    int version;
+    int count;
+    if (iter.ReadInt(&version) && version == kVersion &&
+        iter.ReadLength(&count)) {
+      base::Time now = base::Time::Now();
+      for (int i = 0; i < count; ++i) {
+        std::string key;
+        Session session;
+        int64 expiration;
+        if (!iter.ReadString(&key) || !iter.ReadString(&session.data) ||
+            !iter.ReadInt64(&expiration)) {
+          loaded_sessions.clear();
+          break;
+        }
+        session.expiration = base::Time::FromInternalValue(expiration);
+        if (session.expiration > now)
+          loaded_sessions[key] = session;
+      }
+    }
+  }
+  UMA_HISTOGRAM_COUNTS_10000("Net.SSLSessionStore.LoadedSessions",
+                             loaded_sessions.size());
+
+  base::AutoLock locked(lock_);
+  // Sessions saved while the file was being read are newer.
+  for (SessionMap::const_iterator it = loaded_sessions.begin();
+       it != loaded_sessions.end(); ++it) {
+    sessions_.insert(*it);
+  }
+  ShrinkLocked();
+  loaded_ = true;
+  if (dirty_) {
+    dirty_ = false;
+    ScheduleCommitLocked();
+  }
+}
+
+void PersistentSSLSessionStore::ScheduleCommitLocked() {
+  lock_.AssertAcquired();
+  if (!loaded_) {
+    dirty_ = true;
+    return;
+  }
+  if (commit_pending_)
+    return;
+  commit_pending_ = true;
+  background_task_runner_->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&PersistentSSLSessionStore::Commit, this),
+      base::TimeDelta::FromMilliseconds(kCommitDelayMs));
+}
+
+void PersistentSSLSessionStore::Commit() {
+  DCHECK(background_task_runner_->RunsTasksOnCurrentThread());
+
+  Pickle pickle;
+  {
+    base::AutoLock locked(lock_);
+    commit_pending_ = false;
+
+    base::Time now = base::Time::Now();
+    SessionMap::iterator it = sessions_.begin();
+    while (it != sessions_.end()) {
+      if (it->second.expiration <= now)
+        sessions_.erase(it++);
+      else
+        ++it;
+    }
+    if (sessions_.empty()) {
+      base::DeleteFile(path_, false);
+      return;
+    }
+
+    pickle.WriteInt(kVersion);
+    pickle.WriteInt(static_cast<int>(sessions_.size()));
+    for (it = sessions_.begin(); it != sessions_.end(); ++it) {
+      pickle.WriteString(it->first);
+      pickle.WriteString(it->second.data);
+      pickle.WriteInt64(it->second.expiration.ToInternalValue());
+    }
+  }
+
+  std::string contents;
+  if (!Encrypt(std::string(static_cast<const char*>(pickle.data()),
+                           pickle.size()),
+               &contents)) {
+    return;
+  }
+  base::ImportantFileWriter::WriteFileAtomically(path_, contents);
+}
+
+void PersistentSSLSessionStore::ShrinkLocked() {
+  lock_.AssertAcquired();
+  while (sessions_.size() > kMaxSessions) {
+    SessionMap::iterator first_to_expire = sessions_.begin();
+    for (SessionMap::iterator it = sessions_.begin(); it != sessions_.end();
+         ++it) {
+      if (it->second.expiration < first_to_expire->second.expiration)
+        first_to_expire = it;
+    }
+    sessions_.erase(first_to_expire);
+  }
+}
+
+bool PersistentSSLSessionStore::Encrypt(const std::string& plaintext,
+                                        std::string* output) const {
+  scoped_ptr<crypto::SymmetricKey> key(
+      crypto::SymmetricKey::Import(crypto::SymmetricKey::AES,
+                                   encryption_key_));
+  if (!key)
+    return false;
+
+  char iv[kIVSize];
+  crypto::RandBytes(iv, sizeof(iv));
+  crypto::Encryptor encryptor;
+  std::string ciphertext;
+  if (!encryptor.Init(key.get(), crypto::Encryptor::CBC,
+                      base::StringPiece(iv, sizeof(iv))) ||
+      !encryptor.Encrypt(plaintext, &ciphertext)) {
+    return false;
+  }
+
+  output->assign(iv, sizeof(iv));
+  output->append(ciphertext);
+
+  crypto::HMAC hmac(crypto::HMAC::SHA256);
+  unsigned char mac[kMACSize];
+  if (!hmac.Init(mac_key_) || !hmac.Sign(*output, mac, sizeof(mac)))
+    return false;
+  output->append(reinterpret_cast<const char*>(mac), sizeof(mac));
+  return true;
+}
+
+bool PersistentSSLSessionStore::Decrypt(const std::string& input,
+                                        std::string* plaintext) const {
+  // CBC adds at least one block of padding.
+  if (input.size() < kIVSize + kIVSize + kMACSize)
+    return false;
+
+  base::StringPiece signed_data(input.data(), input.size() - kMACSize);
+  base::StringPiece mac(input.data() + signed_data.size(), kMACSize);
+  crypto::HMAC hmac(crypto::HMAC::SHA256);
+  if (!hmac.Init(mac_key_) || !hmac.Verify(signed_data, mac))
+    return false;
+
+  scoped_ptr<crypto::SymmetricKey> key(
+      crypto::SymmetricKey::Import(crypto::SymmetricKey::AES,
+                                   encryption_key_));
+  if (!key)
+    return false;
+  crypto::Encryptor encryptor;
+  return encryptor.Init(key.get(), crypto::Encryptor::CBC,
+                        signed_data.substr(0, kIVSize)) &&
+         encryptor.Decrypt(signed_data.substr(kIVSize), plaintext);
+}
+
+}  // namespace net
@@ -0,0 +1,110 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_SSL_PERSISTENT_SSL_SESSION_STORE_H_
+#define NET_SSL_PERSISTENT_SSL_SESSION_STORE_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "net/base/net_export.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace net {
+
+// Keeps serialized TLS sessions in a file, so that connections can resume
+// them instead of doing a full handshake after a restart.
+//
+// The file is encrypted with AES-CBC and authenticated with HMAC-SHA256,
+// using keys derived from a secret the embedder ties to the profile. A file
+// that was changed, or that was written with another secret, is ignored.
+//
+// All methods can be called on any thread. The file is read and written on
+// the background task runner, and writes are delayed by kCommitDelayMs so
+// that sessions saved together are written at once.
+class NET_EXPORT PersistentSSLSessionStore
+    : public base::RefCountedThreadSafe<PersistentSSLSessionStore> {
+ public:
+  // The most sessions kept. The ones that expire first are dropped.
+  static const size_t kMaxSessions = 1024;
+
+  static const int kCommitDelayMs = 1000;
+
+  PersistentSSLSessionStore(
+      const base::FilePath& path,
+      const std::string& secret,
+      const scoped_refptr<base::SequencedTaskRunner>& background_task_runner);
+
+  // Starts reading the file. Sessions are not found until it has been read.
+  void Init();
+
+  // Returns true and sets |*data| to the session saved for |key|, if it has
+  // not expired.
+  bool Get(const std::string& key, std::string* data);
+
+  // Saves the serialized session |data| for |key|, replacing any other one.
+  void Save(const std::string& key,
+            const std::string& data,
+            base::Time expiration);
+
+  void Remove(const std::string& key);
+
+  // Removes all the sessions.
+  void Clear();
+
+  size_t size();
+
+ private:
+  friend class base::RefCountedThreadSafe<PersistentSSLSessionStore>;
+
+  struct Session {
+    std::string data;
+    base::Time expiration;
+  };
+  typedef std::map<std::string, Session> SessionMap;
+
+  ~PersistentSSLSessionStore();
+
+  void LoadOnBackgroundThread();
+
+  // Posts a commit unless one is pending. |lock_| must be held.
+  void ScheduleCommitLocked();
+
+  // Writes |sessions_| to the file. Runs on the background task runner.
+  void Commit();
+
+  // Drops the sessions that expire first until there are at most
+  // kMaxSessions. |lock_| must be held.
+  void ShrinkLocked();
+
+  bool Encrypt(const std::string& plaintext, std::string* output) const;
+  bool Decrypt(const std::string& input, std::string* plaintext) const;
+
+  const base::FilePath path_;
+  std::string encryption_key_;
+  std::string mac_key_;
+  scoped_refptr<base::SequencedTaskRunner> background_task_runner_;
+
+  base::Lock lock_;  // Protects the members below.
+  SessionMap sessions_;
+  // Sessions are only written once the file has been read, so that the ones
+  // in it are not lost.
+  bool loaded_;
+  bool dirty_;
+  bool commit_pending_;
+
+  DISALLOW_COPY_AND_ASSIGN(PersistentSSLSessionStore);
+};
+
+}  // namespace net
+
+#endif  // NET_SSL_PERSISTENT_SSL_SESSION_STORE_H_
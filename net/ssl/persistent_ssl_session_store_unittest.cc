@@ -0,0 +1,146 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/ssl/persistent_ssl_session_store.h"
+
+#include "base/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/test/test_simple_task_runner.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+
+namespace {
+
+class PersistentSSLSessionStoreTest : public testing::Test {
+ protected:
+  PersistentSSLSessionStoreTest()
+      : task_runner_(new base::TestSimpleTaskRunner()) {}
+
+  virtual void SetUp() OVERRIDE {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    path_ = temp_dir_.path().AppendASCII("SSL Sessions");
+  }
+
+  // Creates a store for |path_| and reads the file.
+  scoped_refptr<PersistentSSLSessionStore> CreateStore(
+      const std::string& secret) {
+    scoped_refptr<PersistentSSLSessionStore> store(
+        new PersistentSSLSessionStore(path_, secret, task_runner_));
+    store->Init();
+    task_runner_->RunPendingTasks();
+    return store;
+  }
+
+  base::Time Later() {
+    return base::Time::Now() + base::TimeDelta::FromHours(1);
+  }
+
+  base::ScopedTempDir temp_dir_;
+  base::FilePath path_;
+  scoped_refptr<base::TestSimpleTaskRunner> task_runner_;
+};
+
+TEST_F(PersistentSSLSessionStoreTest, SaveAndLoad) {
+  scoped_refptr<PersistentSSLSessionStore> store = CreateStore("secret");
+  store->Save("www.google.com:443/", "session 1", Later());
+  store->Save("mail.google.com:443/", "session 2", Later());
+  store->Save("www.google.com:443/", "session 3", Later());
+  EXPECT_EQ(2u, store->size());
+  EXPECT_FALSE(base::PathExists(path_));
+
+  // The sessions are written at once.
+  EXPECT_EQ(1u, task_runner_->GetPendingTasks().size());
+  task_runner_->RunPendingTasks();
+  ASSERT_TRUE(base::PathExists(path_));
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(path_, &contents));
+  EXPECT_EQ(std::string::npos, contents.find("session"));
+
+  store = CreateStore("secret");
+  std::string data;
+  EXPECT_TRUE(store->Get("www.google.com:443/", &data));
+  EXPECT_EQ("session 3", data);
+  EXPECT_TRUE(store->Get("mail.google.com:443/", &data));
+  EXPECT_EQ("session 2", data);
+  EXPECT_FALSE(store->Get("www.example.com:443/", &data));
+}
+
+TEST_F(PersistentSSLSessionStoreTest, WrongSecret) {
+  scoped_refptr<PersistentSSLSessionStore> store = CreateStore("secret");
+  store->Save("www.google.com:443/", "session", Later());
+  task_runner_->RunPendingTasks();
+
+  store = CreateStore("another secret");
+  std::string data;
+  EXPECT_FALSE(store->Get("www.google.com:443/", &data));
+  EXPECT_EQ(0u, store->size());
+}
+
+TEST_F(PersistentSSLSessionStoreTest, CorruptFile) {
+  scoped_refptr<PersistentSSLSessionStore> store = CreateStore("secret");
+  store->Save("www.google.com:443/", "session", Later());
+  task_runner_->RunPendingTasks();
+
+  std::string contents;
+  ASSERT_TRUE(base::ReadFileToString(path_, &contents));
+  contents[contents.size() / 2] ^= 1;
+  ASSERT_EQ(static_cast<int>(contents.size()),
+            file_util::WriteFile(path_, contents.data(), contents.size()));
+
+  store = CreateStore("secret");
+  EXPECT_EQ(0u, store->size());
+}
+
+TEST_F(PersistentSSLSessionStoreTest, ExpiredSessions) {
+  scoped_refptr<PersistentSSLSessionStore> store = CreateStore("secret");
+  store->Save("www.google.com:443/", "session 1", base::Time::Now());
+  store->Save("mail.google.com:443/", "session 2", Later());
+  std::string data;
+  EXPECT_FALSE(store->Get("www.google.com:443/", &data));
+  task_runner_->RunPendingTasks();
+
+  store = CreateStore("secret");
+  EXPECT_EQ(1u, store->size());
+  EXPECT_TRUE(store->Get("mail.google.com:443/", &data));
+}
+
+// Tests that sessions saved before the file is read are kept, and replace the
+// ones in the file.
+TEST_F(PersistentSSLSessionStoreTest, SaveBeforeLoad) {
+  scoped_refptr<PersistentSSLSessionStore> store = CreateStore("secret");
+  store->Save("www.google.com:443/", "old session", Later());
+  store->Save("mail.google.com:443/", "session", Later());
+  task_runner_->RunPendingTasks();
+
+  store = new PersistentSSLSessionStore(path_, "secret", task_runner_);
+  store->Init();
+  store->Save("www.google.com:443/", "new session", Later());
+  task_runner_->RunPendingTasks();
+  std::string data;
+  EXPECT_TRUE(store->Get("www.google.com:443/", &data));
+  EXPECT_EQ("new session", data);
+  task_runner_->RunPendingTasks();
+
+  store = CreateStore("secret");
+  EXPECT_TRUE(store->Get("www.google.com:443/", &data));
+  EXPECT_EQ("new session", data);
+  EXPECT_TRUE(store->Get("mail.google.com:443/", &data));
+}
+
+TEST_F(PersistentSSLSessionStoreTest, Clear) {
+  scoped_refptr<PersistentSSLSessionStore> store = CreateStore("secret");
+  store->Save("www.google.com:443/", "session", Later());
+  task_runner_->RunPendingTasks();
+  ASSERT_TRUE(base::PathExists(path_));
+
+  store->Clear();
+  EXPECT_EQ(0u, store->size());
+  task_runner_->RunPendingTasks();
+  EXPECT_FALSE(base::PathExists(path_));
+}
+
+}  // namespace
+
+}  // namespace net
@@ -0,0 +1,234 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Replays a trace of cache requests against the eviction policies of the disk
+// cache and reports the object and byte hit ratios that each of them gets.
+//
+// Every line of the trace describes a request as
+//   <seconds since the start of the trace> <key> <size in bytes>
+// A request for a key that is not in the simulated cache is a miss, and the
+// response is stored.  A request with a new size for a key that is already
+// stored counts as a miss that replaces the entry.
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/containers/hash_tables.h"
+#include "base/files/file_path.h"
+#include "base/format_macros.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "net/disk_cache/eviction_policy.h"
+
+namespace disk_cache {
+namespace {
+
+const char kTraceSwitch[] = "trace";
+const char kMaxSizeSwitch[] = "max-size";
+
+// Like SimpleIndex, the simulated cache starts evicting when it goes over 95%
+// of its size, and stops once it is under 90%.
+const int64 kEvictionMarginDivisor = 20;
+
+struct Request {
+  Request() : seconds(0), size(0) {}
+
+  double seconds;
+  std::string key;
+  int64 size;
+};
+
+struct Results {
+  Results() : requests(0), hits(0), requested_bytes(0), hit_bytes(0),
+              evictions(0) {}
+
+  int64 requests;
+  int64 hits;
+  int64 requested_bytes;
+  int64 hit_bytes;
+  int64 evictions;
+};
+
+class SimulatedCache {
+ public:
+  SimulatedCache(scoped_ptr<EvictionPolicy> policy, int64 max_size)
+      : policy_(policy.Pass()),
+        high_watermark_(max_size - max_size / kEvictionMarginDivisor),
+        low_watermark_(max_size - 2 * (max_size / kEvictionMarginDivisor)),
+        size_(0) {}
+
+  const EvictionPolicy* policy() const { return policy_.get(); }
+  const Results& results() const { return results_; }
+
+  void Replay(const Request& request, base::Time now) {
+    results_.requests++;
+    results_.requested_bytes += request.size;
+
+    EntryMap::iterator it = entries_.find(request.key);
+    if (it != entries_.end() && it->second.size == request.size) {
+      results_.hits++;
+      results_.hit_bytes += request.size;
+      it->second.last_used = now;
+      it->second.use_count++;
+      return;
+    }
+
+    if (it != entries_.end()) {
+      size_ -= it->second.size;
+      entries_.erase(it);
+    }
+    // Entries that could never fit are not stored.
+    if (request.size > high_watermark_)
+      return;
+    entries_[request.key] = EvictionCandidate(now, request.size, 0);
+    size_ += request.size;
+    if (size_ > high_watermark_)
+      Evict(now);
+  }
+
+ private:
+  typedef base::hash_map<std::string, EvictionCandidate> EntryMap;
+
+  void Evict(base::Time now) {
+    std::vector<std::pair<double, std::string> > ranked_keys;
+    ranked_keys.reserve(entries_.size());
+    for (EntryMap::const_iterator it = entries_.begin(); it != entries_.end();
+         ++it) {
+      ranked_keys.push_back(std::make_pair(
+          policy_->GetRetentionValue(it->second, now), it->first));
+    }
+    std::sort(ranked_keys.begin(), ranked_keys.end());
+
+    for (size_t i = 0; i < ranked_keys.size() && size_ > low_watermark_; ++i) {
+      EntryMap::iterator it = entries_.find(ranked_keys[i].second);
+      size_ -= it->second.size;
+      entries_.erase(it);
+      results_.evictions++;
+    }
+  }
+
+  scoped_ptr<EvictionPolicy> policy_;
+  const int64 high_watermark_;
+  const int64 low_watermark_;
+  int64 size_;
+  EntryMap entries_;
+  Results results_;
+
+  DISALLOW_COPY_AND_ASSIGN(SimulatedCache);
+};
+
+const char* GetPolicyName(EvictionPolicy::Type type) {
+  switch (type) {
+    case EvictionPolicy::LRU:
+      return "lru";
+    case EvictionPolicy::SIZE_AWARE:
+      return "size_aware";
+  }
+  return "unknown";
+}
+
+double GetRatio(int64 part, int64 total) {
+  return total ? 100.0 * part / total : 0.0;
+}
+
+void PrintUsage(std::ostream* stream) {
+  *stream << "Usage: disk_cache_eviction_simulator "
+          << "--trace=<trace_path> --max-size=<bytes>" << std::endl
+          << "  with each line of the trace being" << std::endl
+          << "  <seconds> <key> <size>" << std::endl;
+}
+
+bool Main(int argc, char** argv) {
+  base::AtExitManager at_exit_manager;
+  CommandLine::Init(argc, argv);
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  if (command_line.HasSwitch("help")) {
+    PrintUsage(&std::cout);
+    return true;
+  }
+  int64 max_size = 0;
+  if (!command_line.HasSwitch(kTraceSwitch) ||
+      !base::StringToInt64(command_line.GetSwitchValueASCII(kMaxSizeSwitch),
+                           &max_size) ||
+      max_size <= 0) {
+    PrintUsage(&std::cerr);
+    return false;
+  }
+
+  const base::FilePath trace_path =
+      command_line.GetSwitchValuePath(kTraceSwitch);
+  std::ifstream trace(trace_path.value().c_str());
+  if (!trace.is_open()) {
+    std::cerr << "Could not open " << trace_path.value() << std::endl;
+    return false;
+  }
+
+  const EvictionPolicy::Type kTypes[] = {
+    EvictionPolicy::LRU,
+    EvictionPolicy::SIZE_AWARE
+  };
+  ScopedVector<SimulatedCache> caches;
+  for (size_t i = 0; i < arraysize(kTypes); ++i) {
+    caches.push_back(
+        new SimulatedCache(EvictionPolicy::Create(kTypes[i]), max_size));
+  }
+
+  // The trace is relative to an arbitrary start time.
+  const base::Time start = base::Time::Now();
+  Request request;
+  int64 line_number = 0;
+  bool result = true;
+  while (trace >> request.seconds >> request.key >> request.size) {
+    line_number++;
+    if (request.size < 0 || request.seconds < 0) {
+      std::cerr << "Invalid request on line " << line_number << std::endl;
+      result = false;
+      break;
+    }
+    base::Time now = start + base::TimeDelta::FromMicroseconds(
+        static_cast<int64>(request.seconds * base::Time::kMicrosecondsPerSecond));
+    for (size_t i = 0; i < caches.size(); ++i)
+      caches[i]->Replay(request, now);
+  }
+  if (result && !trace.eof()) {
+    std::cerr << "Could not parse line " << line_number + 1 << std::endl;
+    result = false;
+  }
+
+  if (result) {
+    std::cout << base::StringPrintf("%-12s %10s %10s %10s %12s",
+                                    "policy", "requests", "hit %",
+                                    "byte hit %", "evictions")
+              << std::endl;
+    for (size_t i = 0; i < caches.size(); ++i) {
+      const Results& results = caches[i]->results();
+      std::cout << base::StringPrintf(
+                       "%-12s %10" PRId64 " %10.2f %10.2f %12" PRId64,
+                       GetPolicyName(caches[i]->policy()->type()),
+                       results.requests,
+                       GetRatio(results.hits, results.requests),
+                       GetRatio(results.hit_bytes, results.requested_bytes),
+                       results.evictions)
+                << std::endl;
+    }
+  }
+
+  return result;
+}
+
+}  // namespace
+}  // namespace disk_cache
+
+int main(int argc, char** argv) {
+  return !disk_cache::Main(argc, argv);
+}
@@ -0,0 +1,530 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Replays a trace recorded by TracingCacheBackend against a fresh instance of
+// any of the cache backends, issuing every operation at the time it was issued
+// in the recorded session (optionally sped up), and reports throughput,
+// per-operation latency percentiles and I/O volume. Running the same trace
+// against several backends compares them on real traffic rather than on a
+// synthetic workload.
+//
+// Entries are replayed by key id: the keys themselves are not in the trace.
+// Entry operations that were issued while their entry was still being opened
+// wait for the open to finish; operations on an entry the replay failed to
+// open are counted as skipped.
+
+#include <string.h>
+
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/file_util.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/message_loop/message_loop.h"
+#include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/thread.h"
+#include "base/time/time.h"
+#include "net/base/cache_type.h"
+#include "net/base/io_buffer.h"
+#include "net/base/net_errors.h"
+#include "net/disk_cache/cache_trace_format.h"
+#include "net/disk_cache/disk_cache.h"
+
+namespace disk_cache {
+namespace {
+
+const char kBlockFileBackendType[] = "block_file";
+const char kSimpleBackendType[] = "simple";
+const char kMemoryBackendType[] = "memory";
+
+// When replaying as fast as possible, this many records are issued before
+// yielding to the message loop so that completions get to run.
+const size_t kUnthrottledBatchSize = 64;
+
+const char* const kOperationNames[] = {
+  "open", "create", "doom_entry", "read", "write", "doom", "close",
+};
+COMPILE_ASSERT(arraysize(kOperationNames) == TRACE_OP_MAX,
+               operation_names_mismatch);
+
+bool StartsEarlier(const CacheTraceRecord& a, const CacheTraceRecord& b) {
+  return a.start_us < b.start_us;
+}
+
+bool ReadTrace(const base::FilePath& path,
+               std::vector<CacheTraceRecord>* records) {
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents)) {
+    LOG(ERROR) << "Unable to read " << path.LossyDisplayName();
+    return false;
+  }
+  if (contents.size() < sizeof(CacheTraceHeader)) {
+    LOG(ERROR) << "Trace too short";
+    return false;
+  }
+  CacheTraceHeader header;
+  memcpy(&header, contents.data(), sizeof(header));
+  if (header.magic != kCacheTraceMagic ||
+      header.version != kCacheTraceVersion) {
+    LOG(ERROR) << "Not a cache trace, or an unsupported version";
+    return false;
+  }
+  // A trace cut short by a crash may end with a partial record; drop it.
+  const size_t count =
+      (contents.size() - sizeof(header)) / sizeof(CacheTraceRecord);
+  records->resize(count);
+  if (count) {
+    memcpy(&(*records)[0], contents.data() + sizeof(header),
+           count * sizeof(CacheTraceRecord));
+  }
+  // Records are written as operations complete; replay them as they started.
+  std::stable_sort(records->begin(), records->end(), &StartsEarlier);
+  return true;
+}
+
+int64 Percentile(std::vector<int64>* values, int percentile) {
+  if (values->empty())
+    return 0;
+  const size_t index =
+      std::min(values->size() - 1, values->size() * percentile / 100);
+  std::nth_element(values->begin(), values->begin() + index, values->end());
+  return (*values)[index];
+}
+
+class TraceReplayer {
+ public:
+  TraceReplayer(Backend* backend,
+                const std::vector<CacheTraceRecord>& records,
+                double speed);
+  ~TraceReplayer();
+
+  // Replays the whole trace, returning once every operation has completed.
+  void Run();
+
+  void PrintResults(std::ostream* stream);
+
+ private:
+  struct KeyState {
+    KeyState() : pending_opens(0) {}
+
+    std::vector<Entry*> handles;
+    int pending_opens;
+    std::deque<size_t> deferred;  // Records waiting for an open.
+  };
+
+  struct OperationStats {
+    OperationStats() : failures(0), diverged(0) {}
+
+    std::vector<int64> recorded_us;
+    std::vector<int64> replayed_us;
+    int failures;
+    // Operations whose success differs from the recorded run, e.g. an open
+    // that hit in production but missed in the replay.
+    int diverged;
+  };
+
+  void IssueDueRecords();
+  void Issue(size_t i);
+  void IssueEntryOperation(size_t i);
+  void DrainDeferred(KeyState* state);
+
+  void OnOpenComplete(size_t i, base::TimeTicks start, Entry** entry,
+                      int result);
+  void OnOperationComplete(size_t i, base::TimeTicks start,
+                           scoped_refptr<net::IOBuffer> buffer, int result);
+  void RecordResult(size_t i, base::TimeTicks start, int result);
+  void MaybeFinish();
+
+  Backend* backend_;
+  const std::vector<CacheTraceRecord>& records_;
+  const double speed_;
+  scoped_refptr<net::IOBuffer> write_buffer_;
+  std::string write_data_;
+
+  std::map<uint64, KeyState> keys_;
+  size_t next_record_;
+  int outstanding_;
+  base::RunLoop run_loop_;
+  base::TimeTicks replay_start_;
+  base::TimeTicks replay_end_;
+
+  OperationStats stats_[TRACE_OP_MAX];
+  std::vector<int64> issue_lag_us_;
+  int skipped_;
+  int64 bytes_read_;
+  int64 bytes_written_;
+
+  DISALLOW_COPY_AND_ASSIGN(TraceReplayer);
+};
+
+TraceReplayer::TraceReplayer(Backend* backend,
+                             const std::vector<CacheTraceRecord>& records,
+                             double speed)
+    : backend_(backend),
+      records_(records),
+      speed_(speed),
+      next_record_(0),
+      outstanding_(0),
+      skipped_(0),
+      bytes_read_(0),
+      bytes_written_(0) {
+  int max_write = 1;
+  for (size_t i = 0; i < records_.size(); ++i) {
+    if (records_[i].operation == TRACE_OP_WRITE)
+      max_write = std::max(max_write, records_[i].length);
+  }
+  write_data_.assign(max_write, 'x');
+  write_buffer_ = new net::WrappedIOBuffer(write_data_.data());
+}
+
+TraceReplayer::~TraceReplayer() {
+  for (std::map<uint64, KeyState>::iterator it = keys_.begin();
+       it != keys_.end(); ++it) {
+    for (size_t i = 0; i < it->second.handles.size(); ++i)
+      it->second.handles[i]->Close();
+  }
+}
+
+void TraceReplayer::Run() {
+  replay_start_ = base::TimeTicks::Now();
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE, base::Bind(&TraceReplayer::IssueDueRecords,
+                            base::Unretained(this)));
+  run_loop_.Run();
+}
+
+void TraceReplayer::IssueDueRecords() {
+  const base::TimeTicks now = base::TimeTicks::Now();
+  const int64 elapsed_us = (now - replay_start_).InMicroseconds();
+  size_t issued = 0;
+  while (next_record_ < records_.size()) {
+    const CacheTraceRecord& record = records_[next_record_];
+    if (speed_ > 0) {
+      const int64 due_us = static_cast<int64>(record.start_us / speed_);
+      if (due_us > elapsed_us) {
+        base::MessageLoop::current()->PostDelayedTask(
+            FROM_HERE,
+            base::Bind(&TraceReplayer::IssueDueRecords,
+                       base::Unretained(this)),
+            base::TimeDelta::FromMicroseconds(due_us - elapsed_us));
+        return;
+      }
+      issue_lag_us_.push_back(elapsed_us - due_us);
+    } else if (issued == kUnthrottledBatchSize) {
+      base::MessageLoop::current()->PostTask(
+          FROM_HERE, base::Bind(&TraceReplayer::IssueDueRecords,
+                                base::Unretained(this)));
+      return;
+    }
+    Issue(next_record_++);
+    ++issued;
+  }
+  MaybeFinish();
+}
+
+void TraceReplayer::Issue(size_t i) {
+  const CacheTraceRecord& record = records_[i];
+  if (record.operation >= TRACE_OP_MAX) {
+    ++skipped_;
+    return;
+  }
+  KeyState* state = &keys_[record.key_id];
+  const std::string key = base::Uint64ToString(record.key_id);
+  const base::TimeTicks start = base::TimeTicks::Now();
+  switch (record.operation) {
+    case TRACE_OP_OPEN:
+    case TRACE_OP_CREATE: {
+      ++state->pending_opens;
+      ++outstanding_;
+      Entry** entry = new Entry*(NULL);
+      const net::CompletionCallback callback =
+          base::Bind(&TraceReplayer::OnOpenComplete, base::Unretained(this),
+                     i, start, base::Owned(entry));
+      const int rv = record.operation == TRACE_OP_OPEN ?
+          backend_->OpenEntry(key, entry, callback) :
+          backend_->CreateEntry(key, entry, callback);
+      if (rv != net::ERR_IO_PENDING)
+        callback.Run(rv);
+      return;
+    }
+    case TRACE_OP_DOOM_ENTRY: {
+      ++outstanding_;
+      const net::CompletionCallback callback =
+          base::Bind(&TraceReplayer::OnOperationComplete,
+                     base::Unretained(this), i, start,
+                     scoped_refptr<net::IOBuffer>());
+      const int rv = backend_->DoomEntry(key, callback);
+      if (rv != net::ERR_IO_PENDING)
+        callback.Run(rv);
+      return;
+    }
+    default:
+      if (state->handles.empty() && state->pending_opens) {
+        state->deferred.push_back(i);
+        return;
+      }
+      IssueEntryOperation(i);
+  }
+}
+
+void TraceReplayer::IssueEntryOperation(size_t i) {
+  const CacheTraceRecord& record = records_[i];
+  KeyState* state = &keys_[record.key_id];
+  if (state->handles.empty()) {
+    ++skipped_;
+    return;
+  }
+  Entry* entry = state->handles.back();
+  const base::TimeTicks start = base::TimeTicks::Now();
+  switch (record.operation) {
+    case TRACE_OP_READ:
+    case TRACE_OP_WRITE: {
+      ++outstanding_;
+      scoped_refptr<net::IOBuffer> buffer = write_buffer_;
+      if (record.operation == TRACE_OP_READ)
+        buffer = new net::IOBuffer(std::max(record.length, 1));
+      const net::CompletionCallback callback =
+          base::Bind(&TraceReplayer::OnOperationComplete,
+                     base::Unretained(this), i, start, buffer);
+      const int rv = record.operation == TRACE_OP_READ ?
+          entry->ReadData(record.index, record.offset, buffer.get(),
+                          record.length, callback) :
+          entry->WriteData(record.index, record.offset, buffer.get(),
+                           record.length, callback, record.truncate != 0);
+      if (rv != net::ERR_IO_PENDING)
+        callback.Run(rv);
+      return;
+    }
+    case TRACE_OP_DOOM:
+      entry->Doom();
+      RecordResult(i, start, net::OK);
+      return;
+    case TRACE_OP_CLOSE:
+      state->handles.pop_back();
+      entry->Close();
+      RecordResult(i, start, net::OK);
+      return;
+    default:
+      NOTREACHED();
+  }
+}
+
+void TraceReplayer::DrainDeferred(KeyState* state) {
+  while (!state->deferred.empty()) {
+    const size_t i = state->deferred.front();
+    state->deferred.pop_front();
+    IssueEntryOperation(i);
+  }
+}
+
+void TraceReplayer::OnOpenComplete(size_t i, base::TimeTicks start,
+                                   Entry** entry, int result) {
+  KeyState* state = &keys_[records_[i].key_id];
+  --state->pending_opens;
+  if (result == net::OK)
+    state->handles.push_back(*entry);
+  if (!state->handles.empty() || !state->pending_opens)
+    DrainDeferred(state);
+  RecordResult(i, start, result);
+  --outstanding_;
+  MaybeFinish();
+}
+
+void TraceReplayer::OnOperationComplete(size_t i, base::TimeTicks start,
+                                        scoped_refptr<net::IOBuffer> buffer,
+                                        int result) {
+  RecordResult(i, start, result);
+  --outstanding_;
+  MaybeFinish();
+}
+
+void TraceReplayer::RecordResult(size_t i, base::TimeTicks start,
+                                 int result) {
+  const CacheTraceRecord& record = records_[i];
+  OperationStats* stats = &stats_[record.operation];
+  stats->recorded_us.push_back(record.duration_us);
+  stats->replayed_us.push_back(
+      (base::TimeTicks::Now() - start).InMicroseconds());
+  if (result < 0)
+    ++stats->failures;
+  if ((result < 0) != (record.result < 0))
+    ++stats->diverged;
+  if (result > 0 && record.operation == TRACE_OP_READ)
+    bytes_read_ += result;
+  if (result > 0 && record.operation == TRACE_OP_WRITE)
+    bytes_written_ += result;
+}
+
+void TraceReplayer::MaybeFinish() {
+  if (next_record_ < records_.size() || outstanding_)
+    return;
+  if (replay_end_.is_null()) {
+    replay_end_ = base::TimeTicks::Now();
+    run_loop_.Quit();
+  }
+}
+
+void TraceReplayer::PrintResults(std::ostream* stream) {
+  const double seconds =
+      std::max((replay_end_ - replay_start_).InSecondsF(), 1e-6);
+  const size_t replayed = records_.size() - skipped_;
+  *stream << base::StringPrintf(
+      "Replayed %d operations in %.3f s (%.0f ops/s), skipped %d\n",
+      static_cast<int>(replayed), seconds, replayed / seconds, skipped_);
+  *stream << base::StringPrintf(
+      "Read %.1f MB, wrote %.1f MB (%.1f MB/s)\n",
+      bytes_read_ / (1024.0 * 1024.0), bytes_written_ / (1024.0 * 1024.0),
+      (bytes_read_ + bytes_written_) / (1024.0 * 1024.0) / seconds);
+  if (!issue_lag_us_.empty()) {
+    *stream << "Issue lag (us): p50 " << Percentile(&issue_lag_us_, 50)
+            << " p99 " << Percentile(&issue_lag_us_, 99) << " max "
+            << Percentile(&issue_lag_us_, 100) << "\n";
+  }
+  *stream << base::StringPrintf(
+      "\n%-11s %8s %7s %8s %9s %8s %8s %8s %8s\n", "operation", "count",
+      "failed", "diverged", "rec_p50", "p50", "p90", "p99", "max");
+  for (int op = 0; op < TRACE_OP_MAX; ++op) {
+    OperationStats* stats = &stats_[op];
+    if (stats->replayed_us.empty())
+      continue;
+    *stream << base::StringPrintf(
+        "%-11s %8d %7d %8d %9d %8d %8d %8d %8d\n", kOperationNames[op],
+        static_cast<int>(stats->replayed_us.size()), stats->failures,
+        stats->diverged,
+        static_cast<int>(Percentile(&stats->recorded_us, 50)),
+        static_cast<int>(Percentile(&stats->replayed_us, 50)),
+        static_cast<int>(Percentile(&stats->replayed_us, 90)),
+        static_cast<int>(Percentile(&stats->replayed_us, 99)),
+        static_cast<int>(Percentile(&stats->replayed_us, 100)));
+  }
+  *stream << "Latencies in microseconds; rec_p50 is the recorded median."
+          << std::endl;
+}
+
+void SetResultOnCompletion(base::RunLoop* run_loop, int* result,
+                           int net_error) {
+  *result = net_error;
+  run_loop->Quit();
+}
+
+scoped_ptr<Backend> CreateBackend(const std::string& type,
+                                  const base::FilePath& path,
+                                  int max_bytes,
+                                  base::Thread* cache_thread) {
+  scoped_ptr<Backend> backend;
+  net::CacheType cache_type = net::DISK_CACHE;
+  net::BackendType backend_type = net::CACHE_BACKEND_BLOCKFILE;
+  if (type == kMemoryBackendType)
+    cache_type = net::MEMORY_CACHE;
+  else if (type == kSimpleBackendType)
+    backend_type = net::CACHE_BACKEND_SIMPLE;
+  else if (type != kBlockFileBackendType)
+    return backend.Pass();
+
+  int result = net::ERR_FAILED;
+  base::RunLoop run_loop;
+  const net::CompletionCallback callback = base::Bind(
+      &SetResultOnCompletion, base::Unretained(&run_loop),
+      base::Unretained(&result));
+  const int rv = CreateCacheBackend(
+      cache_type, backend_type, path, max_bytes, true,
+      cache_thread->message_loop_proxy().get(), NULL, &backend, callback);
+  if (rv != net::ERR_IO_PENDING)
+    callback.Run(rv);
+  else
+    run_loop.Run();
+  if (result != net::OK) {
+    LOG(ERROR) << "Could not initialize the " << type << " backend";
+    backend.reset();
+  }
+  return backend.Pass();
+}
+
+void PrintUsage(std::ostream* stream) {
+  *stream << "Usage: disk_cache_replay --trace=<trace_file> "
+          << "--backend=<backend_type> [--cache-path=<dir>] "
+          << "[--max-bytes=<bytes>] [--speed=<factor>]" << std::endl
+          << "  <backend_type>='block_file'|'simple'|'memory'" << std::endl
+          << "  --cache-path is required by the on-disk backends and should "
+          << "point to an empty directory." << std::endl
+          << "  --speed scales the recorded timing; 0 replays as fast as "
+          << "possible (default 1)." << std::endl;
+}
+
+bool Main(int argc, char** argv) {
+  base::AtExitManager at_exit_manager;
+  base::MessageLoopForIO message_loop;
+  CommandLine::Init(argc, argv);
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+  if (command_line.HasSwitch("help")) {
+    PrintUsage(&std::cout);
+    return true;
+  }
+  const std::string type = command_line.GetSwitchValueASCII("backend");
+  const base::FilePath cache_path =
+      command_line.GetSwitchValuePath("cache-path");
+  if (!command_line.HasSwitch("trace") || type.empty() ||
+      (type != kMemoryBackendType && cache_path.empty())) {
+    PrintUsage(&std::cerr);
+    return false;
+  }
+  int max_bytes = 0;
+  if (command_line.HasSwitch("max-bytes") &&
+      !base::StringToInt(command_line.GetSwitchValueASCII("max-bytes"),
+                         &max_bytes)) {
+    PrintUsage(&std::cerr);
+    return false;
+  }
+  double speed = 1.0;
+  if (command_line.HasSwitch("speed") &&
+      (!base::StringToDouble(command_line.GetSwitchValueASCII("speed"),
+                             &speed) || speed < 0)) {
+    PrintUsage(&std::cerr);
+    return false;
+  }
+
+  std::vector<CacheTraceRecord> records;
+  if (!ReadTrace(command_line.GetSwitchValuePath("trace"), &records))
+    return false;
+
+  base::Thread cache_thread("CacheThread");
+  if (!cache_thread.StartWithOptions(
+          base::Thread::Options(base::MessageLoop::TYPE_IO, 0)))
+    return false;
+
+  scoped_ptr<Backend> backend =
+      CreateBackend(type, cache_path, max_bytes, &cache_thread);
+  if (!backend) {
+    PrintUsage(&std::cerr);
+    return false;
+  }
+
+  {
+    TraceReplayer replayer(backend.get(), records, speed);
+    replayer.Run();
+    replayer.PrintResults(&std::cout);
+  }
+  backend.reset();
+  base::RunLoop().RunUntilIdle();
+  return true;
+}
+
+}  // namespace
+}  // namespace disk_cache
+
+int main(int argc, char** argv) {
+  return !disk_cache::Main(argc, argv);
+}
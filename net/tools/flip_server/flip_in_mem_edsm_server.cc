@@ -13,7 +13,9 @@
 
 #include "base/command_line.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
 #include "base/synchronization/lock.h"
+#include "base/sys_info.h"
 #include "base/timer/timer.h"
 #include "net/tools/balsa/split.h"
 #include "net/tools/flip_server/acceptor_thread.h"
@@ -43,6 +45,11 @@ int32 FLAGS_accept_backlog_size = 1024;
 //  SO_REUSEPORT);
 bool FLAGS_reuseport = false;
 
+// The number of acceptor threads started for each listen ip:port. Each
+//  thread gets its own listening socket, so values above 1 turn on
+//  reuseport and leave it to the kernel to spread connections across them);
+int32 FLAGS_workers = 1;
+
 // Flag to force spdy, even if NPN is not negotiated.
 bool FLAGS_force_spdy = false;
 
@@ -198,6 +205,13 @@ int main(int argc, char** argv) {
         "\t--ssl-session-expiry=<seconds> (default is 300)\n"
         "\t--ssl-disable-compression\n"
         "\t--idle-timeout=<seconds> (default is 300)\n"
+        "\t--reuseport\n"
+        "\t  * Sets SO_REUSEPORT on the listening sockets.\n"
+        "\t--workers=<count|auto> (default is 1)\n"
+        "\t  * Runs this many acceptor threads per listen ip:port, each"
+        " with its own\n"
+        "\t    SO_REUSEPORT listening socket. auto starts one per CPU"
+        " core.\n"
         "\t--pidfile=<filepath> (default /var/run/flip-server.pid)\n"
         "\t--help\n");
     exit(0);
@@ -263,6 +277,21 @@ int main(int argc, char** argv) {
   if (cl.HasSwitch("force_spdy"))
     net::SMConnection::set_force_spdy(true);
 
+  if (cl.HasSwitch("reuseport"))
+    FLAGS_reuseport = true;
+
+  if (cl.HasSwitch("workers")) {
+    std::string workers = cl.GetSwitchValueASCII("workers");
+    if (workers == "auto")
+      FLAGS_workers = base::SysInfo::NumberOfProcessors();
+    else
+      FLAGS_workers = atoi(workers.c_str());
+    if (FLAGS_workers < 1)
+      LOG(FATAL) << "Invalid number of workers: " << workers;
+  }
+  if (FLAGS_workers > 1)
+    FLAGS_reuseport = true;
+
   logging::LoggingSettings settings;
   settings.logging_dest = g_proxy_config.log_destination_;
   settings.log_file = g_proxy_config.log_filename_.c_str();
@@ -282,6 +311,7 @@ int main(int argc, char** argv) {
   LOG(INFO) << "Accepts per wake        : " << FLAGS_accepts_per_wake;
   LOG(INFO) << "Disable nagle           : " << (FLAGS_disable_nagle ? "true"
                                                                     : "false");
+  LOG(INFO) << "Workers per listener    : " << FLAGS_workers;
   LOG(INFO) << "Reuseport               : " << (FLAGS_reuseport ? "true"
                                                                 : "false");
   LOG(INFO) << "Force SPDY              : " << (FLAGS_force_spdy ? "true"
@@ -305,76 +335,86 @@ int main(int argc, char** argv) {
     std::vector<std::string> valueArgs = split(value, ',');
     CHECK_EQ((unsigned int)9, valueArgs.size());
     int spdy_only = atoi(valueArgs[8].c_str());
-    // If wait_for_iface is enabled, then this call will block
-    // indefinitely until the interface is raised.
-    g_proxy_config.AddAcceptor(net::FLIP_HANDLER_PROXY,
-                               valueArgs[0],
-                               valueArgs[1],
-                               valueArgs[2],
-                               valueArgs[3],
-                               valueArgs[4],
-                               valueArgs[5],
-                               valueArgs[6],
-                               valueArgs[7],
-                               spdy_only,
-                               FLAGS_accept_backlog_size,
-                               FLAGS_disable_nagle,
-                               FLAGS_accepts_per_wake,
-                               FLAGS_reuseport,
-                               wait_for_iface,
-                               NULL);
+    for (int worker = 0; worker < FLAGS_workers; ++worker) {
+      // If wait_for_iface is enabled, then this call will block
+      // indefinitely until the interface is raised.
+      g_proxy_config.AddAcceptor(net::FLIP_HANDLER_PROXY,
+                                 valueArgs[0],
+                                 valueArgs[1],
+                                 valueArgs[2],
+                                 valueArgs[3],
+                                 valueArgs[4],
+                                 valueArgs[5],
+                                 valueArgs[6],
+                                 valueArgs[7],
+                                 spdy_only,
+                                 FLAGS_accept_backlog_size,
+                                 FLAGS_disable_nagle,
+                                 FLAGS_accepts_per_wake,
+                                 FLAGS_reuseport,
+                                 wait_for_iface,
+                                 NULL);
+    }
   }
 
+  // MemoryCache is not threadsafe, so every server acceptor thread gets its
+  // own copy.
+  ScopedVector<net::MemoryCache> memory_caches;
+
   // Spdy Server Acceptor
-  net::MemoryCache spdy_memory_cache;
   if (cl.HasSwitch("spdy-server")) {
-    spdy_memory_cache.AddFiles();
     std::string value = cl.GetSwitchValueASCII("spdy-server");
     std::vector<std::string> valueArgs = split(value, ',');
     while (valueArgs.size() < 4)
       valueArgs.push_back(std::string());
-    g_proxy_config.AddAcceptor(net::FLIP_HANDLER_SPDY_SERVER,
-                               valueArgs[0],
-                               valueArgs[1],
-                               valueArgs[2],
-                               valueArgs[3],
-                               std::string(),
-                               std::string(),
-                               std::string(),
-                               std::string(),
-                               0,
-                               FLAGS_accept_backlog_size,
-                               FLAGS_disable_nagle,
-                               FLAGS_accepts_per_wake,
-                               FLAGS_reuseport,
-                               wait_for_iface,
-                               &spdy_memory_cache);
+    for (int worker = 0; worker < FLAGS_workers; ++worker) {
+      memory_caches.push_back(new net::MemoryCache);
+      memory_caches.back()->AddFiles();
+      g_proxy_config.AddAcceptor(net::FLIP_HANDLER_SPDY_SERVER,
+                                 valueArgs[0],
+                                 valueArgs[1],
+                                 valueArgs[2],
+                                 valueArgs[3],
+                                 std::string(),
+                                 std::string(),
+                                 std::string(),
+                                 std::string(),
+                                 0,
+                                 FLAGS_accept_backlog_size,
+                                 FLAGS_disable_nagle,
+                                 FLAGS_accepts_per_wake,
+                                 FLAGS_reuseport,
+                                 wait_for_iface,
+                                 memory_caches.back());
+    }
   }
 
   // Spdy Server Acceptor
-  net::MemoryCache http_memory_cache;
   if (cl.HasSwitch("http-server")) {
-    http_memory_cache.AddFiles();
     std::string value = cl.GetSwitchValueASCII("http-server");
     std::vector<std::string> valueArgs = split(value, ',');
     while (valueArgs.size() < 4)
       valueArgs.push_back(std::string());
-    g_proxy_config.AddAcceptor(net::FLIP_HANDLER_HTTP_SERVER,
-                               valueArgs[0],
-                               valueArgs[1],
-                               valueArgs[2],
-                               valueArgs[3],
-                               std::string(),
-                               std::string(),
-                               std::string(),
-                               std::string(),
-                               0,
-                               FLAGS_accept_backlog_size,
-                               FLAGS_disable_nagle,
-                               FLAGS_accepts_per_wake,
-                               FLAGS_reuseport,
-                               wait_for_iface,
-                               &http_memory_cache);
+    for (int worker = 0; worker < FLAGS_workers; ++worker) {
+      memory_caches.push_back(new net::MemoryCache);
+      memory_caches.back()->AddFiles();
+      g_proxy_config.AddAcceptor(net::FLIP_HANDLER_HTTP_SERVER,
+                                 valueArgs[0],
+                                 valueArgs[1],
+                                 valueArgs[2],
+                                 valueArgs[3],
+                                 std::string(),
+                                 std::string(),
+                                 std::string(),
+                                 std::string(),
+                                 0,
+                                 FLAGS_accept_backlog_size,
+                                 FLAGS_disable_nagle,
+                                 FLAGS_accepts_per_wake,
+                                 FLAGS_reuseport,
+                                 wait_for_iface,
+                                 memory_caches.back());
+    }
   }
 
   std::vector<net::SMAcceptorThread*> sm_worker_threads_;
@@ -384,13 +424,9 @@ int main(int argc, char** argv) {
 
     sm_worker_threads_.push_back(new net::SMAcceptorThread(
         acceptor, (net::MemoryCache*)acceptor->memory_cache_));
-    // Note that spdy_memory_cache is not threadsafe, it is merely
-    // thread compatible. Thus, if ever we are to spawn multiple threads,
-    // we either must make the MemoryCache threadsafe, or use
-    // a separate MemoryCache for each thread.
-    //
-    // The latter is what is currently being done as we spawn
-    // a separate thread for each http and spdy server acceptor.
+    // Note that MemoryCache is not threadsafe, it is merely thread
+    // compatible. Thus each http and spdy server acceptor, including each
+    // worker for the same listen ip:port, has its own MemoryCache.
 
     sm_worker_threads_.back()->InitWorker();
     sm_worker_threads_.back()->Start();
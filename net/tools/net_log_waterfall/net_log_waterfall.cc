@@ -0,0 +1,499 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// This utility reads net-logs written by NetLogLogger (for example with
+// --log-net-log) and reconstructs the LoadTimingInfo-style waterfall of every
+// URL request in them: DNS, connect, SSL, cache, send and time to first byte,
+// plus whether the socket was reused. It prints statistics aggregated over
+// all given captures, and can compare them against a baseline set of
+// captures to attribute a regression to a phase.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/basictypes.h"
+#include "base/command_line.h"
+#include "base/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+
+namespace {
+
+const char kUsage[] =
+    "Usage: %s [--requests] [--baseline=<log>[,<log>...]] <log> [<log>...]\n"
+    "  Prints per-phase request timing statistics for the given net-logs.\n"
+    "  --requests  Also prints the waterfall of every request.\n"
+    "  --baseline  Compares the given net-logs against these ones.\n";
+
+// The phases of a request, in waterfall order. DNS, connect and SSL are only
+// known for requests that did not reuse a socket.
+enum Phase {
+  PHASE_DNS,
+  PHASE_CONNECT,
+  PHASE_SSL,
+  PHASE_CACHE,
+  PHASE_SEND,
+  PHASE_TTFB,
+  PHASE_TOTAL,
+  PHASE_COUNT,
+};
+
+const char* const kPhaseNames[] = {
+  "dns", "connect", "ssl", "cache", "send", "ttfb", "total",
+};
+
+COMPILE_ASSERT(arraysize(kPhaseNames) == PHASE_COUNT, phase_names_mismatch);
+
+// The timing reconstructed for one URL request. Durations are in
+// milliseconds, or -1 if the phase didn't happen.
+struct RequestTiming {
+  RequestTiming() : start_ms(0), socket_reused(false) {
+    std::fill(durations, durations + PHASE_COUNT, -1);
+  }
+
+  std::string url;
+  int64 start_ms;
+  int64 durations[PHASE_COUNT];
+  bool socket_reused;
+};
+
+// One entry of a net-log. |params| points into the capture's parsed JSON.
+struct Entry {
+  int type;
+  int phase;
+  int64 time_ms;
+  const base::DictionaryValue* params;
+};
+
+typedef std::vector<Entry> EntryList;
+
+// A parsed net-log, with its entries grouped by source.
+class Capture {
+ public:
+  Capture()
+      : url_request_source_type_(-1),
+        phase_none_(-1),
+        phase_begin_(-1),
+        phase_end_(-1) {}
+
+  bool Load(const base::FilePath& path);
+
+  // Appends the timing of every complete URL request in the capture.
+  void GetRequestTimings(std::vector<RequestTiming>* timings) const;
+
+ private:
+  typedef std::map<int, EntryList> SourceMap;
+
+  bool ParseConstants(const base::DictionaryValue* constants);
+  bool ParseEntry(const base::DictionaryValue* dict);
+
+  int EventType(const std::string& name) const;
+
+  // Returns the entries of source |id|, or NULL if there are none.
+  const EntryList* GetEntries(int id) const;
+
+  // Returns the time of the first entry of |type| with |phase|, or -1.
+  int64 FindTime(const EntryList& entries, int type, int phase) const;
+
+  // Returns the first entry of |type| with |phase|, or NULL.
+  const Entry* FindEntry(const EntryList& entries, int type, int phase) const;
+
+  // Returns the total time spent in events of any type in |types|, or -1 if
+  // none of them completed.
+  int64 Duration(const EntryList& entries, const std::vector<int>& types) const;
+  int64 Duration(const EntryList& entries, int type) const;
+
+  // Returns the id of the source referred to by |entry|'s params, or -1.
+  static int GetSourceDependency(const Entry* entry);
+
+  scoped_ptr<base::Value> root_;
+  std::map<std::string, int> event_types_;
+  std::vector<int> cache_event_types_;
+  int url_request_source_type_;
+  int phase_none_;
+  int phase_begin_;
+  int phase_end_;
+  SourceMap sources_;
+  std::set<int> url_request_ids_;
+};
+
+bool Capture::Load(const base::FilePath& path) {
+  std::string json;
+  if (!base::ReadFileToString(path, &json)) {
+    fprintf(stderr, "Failed to read %s\n", path.value().c_str());
+    return false;
+  }
+
+  root_.reset(base::JSONReader::Read(json));
+  if (!root_) {
+    // The log may have been cut off mid-write. NetLogLogger writes one entry
+    // per line, so drop the last line and close the JSON ourselves.
+    size_t last_line = json.find_last_of('\n');
+    if (last_line != std::string::npos) {
+      json.resize(last_line);
+      base::TrimString(json, ",\n", &json);
+      json += "]}";
+      root_.reset(base::JSONReader::Read(json));
+    }
+  }
+
+  base::DictionaryValue* dict = NULL;
+  base::DictionaryValue* constants = NULL;
+  base::ListValue* events = NULL;
+  if (!root_ || !root_->GetAsDictionary(&dict) ||
+      !dict->GetDictionary("constants", &constants) ||
+      !dict->GetList("events", &events) || !ParseConstants(constants)) {
+    fprintf(stderr, "%s is not a net-log\n", path.value().c_str());
+    return false;
+  }
+
+  for (size_t i = 0; i < events->GetSize(); ++i) {
+    base::DictionaryValue* event = NULL;
+    if (!events->GetDictionary(i, &event) || !ParseEntry(event)) {
+      fprintf(stderr, "%s has an invalid entry at index %d\n",
+              path.value().c_str(), static_cast<int>(i));
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Capture::ParseConstants(const base::DictionaryValue* constants) {
+  const base::DictionaryValue* event_types = NULL;
+  const base::DictionaryValue* source_types = NULL;
+  const base::DictionaryValue* phases = NULL;
+  if (!constants->GetDictionary("logEventTypes", &event_types) ||
+      !constants->GetDictionary("logSourceType", &source_types) ||
+      !constants->GetDictionary("logEventPhase", &phases) ||
+      !source_types->GetInteger("URL_REQUEST", &url_request_source_type_) ||
+      !phases->GetInteger("PHASE_NONE", &phase_none_) ||
+      !phases->GetInteger("PHASE_BEGIN", &phase_begin_) ||
+      !phases->GetInteger("PHASE_END", &phase_end_)) {
+    return false;
+  }
+
+  for (base::DictionaryValue::Iterator it(*event_types); !it.IsAtEnd();
+       it.Advance()) {
+    int type = 0;
+    if (!it.value().GetAsInteger(&type))
+      return false;
+    event_types_[it.key()] = type;
+    if (StartsWithASCII(it.key(), "HTTP_CACHE_", true))
+      cache_event_types_.push_back(type);
+  }
+  return true;
+}
+
+bool Capture::ParseEntry(const base::DictionaryValue* dict) {
+  Entry entry;
+  std::string time;
+  int source_id = 0;
+  if (!dict->GetInteger("type", &entry.type) ||
+      !dict->GetInteger("phase", &entry.phase) ||
+      !dict->GetString("time", &time) ||
+      !base::StringToInt64(time, &entry.time_ms) ||
+      !dict->GetInteger("source.id", &source_id)) {
+    return false;
+  }
+  entry.params = NULL;
+  dict->GetDictionary("params", &entry.params);
+  sources_[source_id].push_back(entry);
+
+  int source_type = 0;
+  if (dict->GetInteger("source.type", &source_type) &&
+      source_type == url_request_source_type_) {
+    url_request_ids_.insert(source_id);
+  }
+  return true;
+}
+
+int Capture::EventType(const std::string& name) const {
+  std::map<std::string, int>::const_iterator it = event_types_.find(name);
+  return it == event_types_.end() ? -1 : it->second;
+}
+
+const EntryList* Capture::GetEntries(int id) const {
+  SourceMap::const_iterator it = sources_.find(id);
+  return it == sources_.end() ? NULL : &it->second;
+}
+
+int64 Capture::FindTime(const EntryList& entries, int type, int phase) const {
+  const Entry* entry = FindEntry(entries, type, phase);
+  return entry ? entry->time_ms : -1;
+}
+
+const Entry* Capture::FindEntry(const EntryList& entries,
+                                int type,
+                                int phase) const {
+  for (EntryList::const_iterator it = entries.begin(); it != entries.end();
+       ++it) {
+    if (it->type == type && it->phase == phase)
+      return &*it;
+  }
+  return NULL;
+}
+
+int64 Capture::Duration(const EntryList& entries,
+                        const std::vector<int>& types) const {
+  int64 total = -1;
+  std::map<int, int64> begin_times;
+  for (EntryList::const_iterator it = entries.begin(); it != entries.end();
+       ++it) {
+    if (std::find(types.begin(), types.end(), it->type) == types.end())
+      continue;
+    if (it->phase == phase_begin_) {
+      begin_times[it->type] = it->time_ms;
+    } else if (it->phase == phase_end_ && begin_times.count(it->type)) {
+      total = std::max<int64>(total, 0) + it->time_ms - begin_times[it->type];
+      begin_times.erase(it->type);
+    }
+  }
+  return total;
+}
+
+int64 Capture::Duration(const EntryList& entries, int type) const {
+  return Duration(entries, std::vector<int>(1, type));
+}
+
+// static
+int Capture::GetSourceDependency(const Entry* entry) {
+  int id = -1;
+  if (!entry || !entry->params ||
+      !entry->params->GetInteger("source_dependency.id", &id)) {
+    return -1;
+  }
+  return id;
+}
+
+void Capture::GetRequestTimings(std::vector<RequestTiming>* timings) const {
+  const int request_alive = EventType("REQUEST_ALIVE");
+  const int start_job = EventType("URL_REQUEST_START_JOB");
+  const int bound_to_socket = EventType("SOCKET_POOL_BOUND_TO_SOCKET");
+  const int reused_socket = EventType("SOCKET_POOL_REUSED_AN_EXISTING_SOCKET");
+  const int socket_alive = EventType("SOCKET_ALIVE");
+  const int host_resolver_request = EventType("HOST_RESOLVER_IMPL_REQUEST");
+  const int tcp_connect = EventType("TCP_CONNECT");
+  const int ssl_connect = EventType("SSL_CONNECT");
+  const int send_request = EventType("HTTP_TRANSACTION_SEND_REQUEST");
+  const int read_headers = EventType("HTTP_TRANSACTION_READ_HEADERS");
+
+  for (std::set<int>::const_iterator id = url_request_ids_.begin();
+       id != url_request_ids_.end(); ++id) {
+    const EntryList& entries = *GetEntries(*id);
+    RequestTiming timing;
+    timing.start_ms = FindTime(entries, request_alive, phase_begin_);
+    int64 end_ms = FindTime(entries, request_alive, phase_end_);
+    if (timing.start_ms < 0 || end_ms < 0)
+      continue;
+    timing.durations[PHASE_TOTAL] = end_ms - timing.start_ms;
+
+    const Entry* job = FindEntry(entries, start_job, phase_begin_);
+    if (job && job->params)
+      job->params->GetString("url", &timing.url);
+
+    timing.durations[PHASE_CACHE] = Duration(entries, cache_event_types_);
+    timing.durations[PHASE_SEND] = Duration(entries, send_request);
+    int64 send_start = FindTime(entries, send_request, phase_begin_);
+    int64 headers_end = FindTime(entries, read_headers, phase_end_);
+    if (send_start >= 0 && headers_end >= send_start)
+      timing.durations[PHASE_TTFB] = headers_end - send_start;
+
+    // As in LoadTimingInfo, connection setup is only attributed to the
+    // request that caused it.
+    timing.socket_reused =
+        FindEntry(entries, reused_socket, phase_none_) != NULL;
+    const EntryList* socket = GetEntries(GetSourceDependency(
+        FindEntry(entries, bound_to_socket, phase_none_)));
+    if (!timing.socket_reused && socket) {
+      timing.durations[PHASE_CONNECT] = Duration(*socket, tcp_connect);
+      timing.durations[PHASE_SSL] = Duration(*socket, ssl_connect);
+      const EntryList* connect_job = GetEntries(GetSourceDependency(
+          FindEntry(*socket, socket_alive, phase_begin_)));
+      if (connect_job) {
+        timing.durations[PHASE_DNS] =
+            Duration(*connect_job, host_resolver_request);
+      }
+    }
+
+    timings->push_back(timing);
+  }
+}
+
+// Collects the samples of one phase across requests.
+class PhaseStats {
+ public:
+  void Add(int64 sample) { samples_.push_back(sample); }
+
+  size_t count() const { return samples_.size(); }
+
+  double Mean() const {
+    if (samples_.empty())
+      return 0;
+    double sum = 0;
+    for (size_t i = 0; i < samples_.size(); ++i)
+      sum += samples_[i];
+    return sum / samples_.size();
+  }
+
+  // Returns the sample below which |percent| of the samples fall.
+  int64 Percentile(int percent) {
+    if (samples_.empty())
+      return 0;
+    std::sort(samples_.begin(), samples_.end());
+    size_t index = (samples_.size() - 1) * percent / 100;
+    return samples_[index];
+  }
+
+ private:
+  std::vector<int64> samples_;
+};
+
+// Statistics over every request of a set of captures.
+struct Summary {
+  Summary() : requests(0), reused_sockets(0) {}
+
+  void Add(const RequestTiming& timing) {
+    ++requests;
+    if (timing.socket_reused)
+      ++reused_sockets;
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+      if (timing.durations[i] >= 0)
+        phases[i].Add(timing.durations[i]);
+    }
+  }
+
+  int requests;
+  int reused_sockets;
+  PhaseStats phases[PHASE_COUNT];
+};
+
+void PrintRequests(const std::vector<RequestTiming>& timings) {
+  if (timings.empty())
+    return;
+  int64 first_start = timings[0].start_ms;
+  for (size_t i = 1; i < timings.size(); ++i)
+    first_start = std::min(first_start, timings[i].start_ms);
+
+  printf("%8s", "start");
+  for (int i = 0; i < PHASE_COUNT; ++i)
+    printf(" %7s", kPhaseNames[i]);
+  printf(" reused url\n");
+  for (size_t i = 0; i < timings.size(); ++i) {
+    const RequestTiming& timing = timings[i];
+    printf("%8d", static_cast<int>(timing.start_ms - first_start));
+    for (int j = 0; j < PHASE_COUNT; ++j) {
+      if (timing.durations[j] >= 0)
+        printf(" %7d", static_cast<int>(timing.durations[j]));
+      else
+        printf(" %7s", "-");
+    }
+    printf(" %6s %s\n", timing.socket_reused ? "yes" : "no",
+           timing.url.c_str());
+  }
+  printf("\n");
+}
+
+void PrintSummary(Summary* summary) {
+  printf("%d requests, %d on reused sockets\n", summary->requests,
+         summary->reused_sockets);
+  printf("%-8s %7s %9s %7s %7s %7s\n", "phase", "count", "mean", "median",
+         "p90", "p99");
+  for (int i = 0; i < PHASE_COUNT; ++i) {
+    PhaseStats& stats = summary->phases[i];
+    printf("%-8s %7d %9.1f %7d %7d %7d\n", kPhaseNames[i],
+           static_cast<int>(stats.count()), stats.Mean(),
+           static_cast<int>(stats.Percentile(50)),
+           static_cast<int>(stats.Percentile(90)),
+           static_cast<int>(stats.Percentile(99)));
+  }
+}
+
+void PrintDiff(Summary* baseline, Summary* current) {
+  printf("requests: %d -> %d, on reused sockets: %d -> %d\n",
+         baseline->requests, current->requests, baseline->reused_sockets,
+         current->reused_sockets);
+  printf("%-8s %9s %9s %9s %7s %7s %7s\n", "phase", "mean", "mean",
+         "delta", "median", "median", "delta");
+  for (int i = 0; i < PHASE_COUNT; ++i) {
+    PhaseStats& before = baseline->phases[i];
+    PhaseStats& after = current->phases[i];
+    int64 median_before = before.Percentile(50);
+    int64 median_after = after.Percentile(50);
+    printf("%-8s %9.1f %9.1f %+9.1f %7d %7d %+7d\n", kPhaseNames[i],
+           before.Mean(), after.Mean(), after.Mean() - before.Mean(),
+           static_cast<int>(median_before), static_cast<int>(median_after),
+           static_cast<int>(median_after - median_before));
+  }
+}
+
+// Loads every capture in |paths| and adds its requests to |summary|. If
+// |print_requests| is true, also prints each capture's requests.
+bool Summarize(const std::vector<base::FilePath>& paths,
+               bool print_requests,
+               Summary* summary) {
+  for (size_t i = 0; i < paths.size(); ++i) {
+    Capture capture;
+    if (!capture.Load(paths[i]))
+      return false;
+    std::vector<RequestTiming> timings;
+    capture.GetRequestTimings(&timings);
+    if (print_requests) {
+      printf("%s:\n", paths[i].value().c_str());
+      PrintRequests(timings);
+    }
+    for (size_t j = 0; j < timings.size(); ++j)
+      summary->Add(timings[j]);
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::AtExitManager at_exit_manager;
+  CommandLine::Init(argc, argv);
+  const CommandLine& command_line = *CommandLine::ForCurrentProcess();
+
+  std::vector<base::FilePath> paths;
+  CommandLine::StringVector args = command_line.GetArgs();
+  for (size_t i = 0; i < args.size(); ++i)
+    paths.push_back(base::FilePath(args[i]));
+  if (paths.empty()) {
+    fprintf(stderr, kUsage, argv[0]);
+    return 1;
+  }
+  bool print_requests = command_line.HasSwitch("requests");
+
+  Summary current;
+  if (!Summarize(paths, print_requests, &current))
+    return 1;
+
+  if (!command_line.HasSwitch("baseline")) {
+    PrintSummary(&current);
+    return 0;
+  }
+
+  std::vector<std::string> baseline_args;
+  base::SplitString(command_line.GetSwitchValueASCII("baseline"), ',',
+                    &baseline_args);
+  std::vector<base::FilePath> baseline_paths;
+  for (size_t i = 0; i < baseline_args.size(); ++i)
+    baseline_paths.push_back(base::FilePath::FromUTF8Unsafe(baseline_args[i]));
+
+  Summary baseline;
+  if (!Summarize(baseline_paths, false, &baseline))
+    return 1;
+  PrintDiff(&baseline, &current);
+  return 0;
+}
@@ -889,10 +889,11 @@ TEST_P(EndToEndTest, ConnectionMigration) {
   QuicConnectionPeer::SetWriter(client_->client()->session()->connection(),
                                 writer.get());
 
-  client_->SendSynchronousRequest("/bar");
-
-  EXPECT_EQ(QUIC_STREAM_CONNECTION_ERROR, client_->stream_error());
-  EXPECT_EQ(QUIC_ERROR_MIGRATING_ADDRESS, client_->connection_error());
+  // The server follows the client to its new address. The client socket is
+  // bound to any address, so it still receives the response.
+  EXPECT_EQ(kBarResponseBody, client_->SendSynchronousRequest("/bar"));
+  EXPECT_EQ(200u, client_->response_headers()->parsed_response_code());
+  EXPECT_EQ(QUIC_NO_ERROR, client_->connection_error());
 }
 
 }  // namespace
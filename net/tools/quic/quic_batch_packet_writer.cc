@@ -0,0 +1,108 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_batch_packet_writer.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include "base/logging.h"
+
+namespace net {
+namespace tools {
+
+QuicBatchPacketWriter::QuicBatchPacketWriter(int fd)
+    : fd_(fd),
+      write_blocked_(false),
+      num_packets_(0) {
+  for (size_t i = 0; i < arraysize(packets_); ++i) {
+    packets_[i].buffer = buffers_[i];
+  }
+}
+
+QuicBatchPacketWriter::~QuicBatchPacketWriter() {}
+
+WriteResult QuicBatchPacketWriter::WritePacket(
+    const char* buffer, size_t buf_len,
+    const net::IPAddressNumber& self_address,
+    const net::IPEndPoint& peer_address) {
+  DCHECK(!IsWriteBlocked());
+  if (buf_len > kMaxPacketSize) {
+    // Only tests write oversized packets. Keep them in order with the batch.
+    Flush();
+    if (write_blocked_) {
+      return WriteResult(WRITE_STATUS_BLOCKED, EAGAIN);
+    }
+    WriteResult result = QuicSocketUtils::WritePacket(
+        fd_, buffer, buf_len, self_address, peer_address);
+    if (result.status == WRITE_STATUS_BLOCKED) {
+      write_blocked_ = true;
+    }
+    return result;
+  }
+
+  if (num_packets_ == arraysize(packets_)) {
+    Flush();
+    if (num_packets_ == arraysize(packets_)) {
+      return WriteResult(WRITE_STATUS_BLOCKED, EAGAIN);
+    }
+  }
+
+  QuicSocketUtils::Packet* packet = &packets_[num_packets_++];
+  memcpy(packet->buffer, buffer, buf_len);
+  packet->length = buf_len;
+  packet->self_address = self_address;
+  packet->peer_address = peer_address;
+  return WriteResult(WRITE_STATUS_OK, buf_len);
+}
+
+bool QuicBatchPacketWriter::IsWriteBlockedDataBuffered() const {
+  // A packet is either in the batch, in which case it was reported written,
+  // or it was refused with WRITE_STATUS_BLOCKED and must be written again.
+  return false;
+}
+
+bool QuicBatchPacketWriter::IsWriteBlocked() const {
+  return write_blocked_;
+}
+
+void QuicBatchPacketWriter::SetWritable() {
+  write_blocked_ = false;
+}
+
+void QuicBatchPacketWriter::Flush() {
+  if (write_blocked_) {
+    return;
+  }
+
+  size_t num_sent = 0;
+  while (num_sent < num_packets_) {
+    WriteResult result = QuicSocketUtils::WritePackets(
+        fd_, packets_ + num_sent, num_packets_ - num_sent);
+    if (result.status == WRITE_STATUS_OK) {
+      num_sent += result.bytes_written;
+    } else if (result.status == WRITE_STATUS_BLOCKED) {
+      write_blocked_ = true;
+      break;
+    } else {
+      // The packet was already reported written, so drop it and let QUIC
+      // recover it as a lost packet.
+      DVLOG(1) << "Dropping packet: " << strerror(result.error_code);
+      ++num_sent;
+    }
+  }
+
+  // Move the unsent packets to the front of the batch.
+  for (size_t i = num_sent; i < num_packets_; ++i) {
+    QuicSocketUtils::Packet* packet = &packets_[i - num_sent];
+    memcpy(packet->buffer, packets_[i].buffer, packets_[i].length);
+    packet->length = packets_[i].length;
+    packet->self_address = packets_[i].self_address;
+    packet->peer_address = packets_[i].peer_address;
+  }
+  num_packets_ -= num_sent;
+}
+
+}  // namespace tools
+}  // namespace net
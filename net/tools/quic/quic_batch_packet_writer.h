@@ -0,0 +1,59 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef NET_TOOLS_QUIC_QUIC_BATCH_PACKET_WRITER_H_
+#define NET_TOOLS_QUIC_QUIC_BATCH_PACKET_WRITER_H_
+
+#include "base/basictypes.h"
+#include "net/base/ip_endpoint.h"
+#include "net/quic/quic_packet_writer.h"
+#include "net/quic/quic_protocol.h"
+#include "net/tools/quic/quic_socket_utils.h"
+
+namespace net {
+
+struct WriteResult;
+
+namespace tools {
+
+// Packet writer which copies packets into a batch and sends the batch with a
+// single sendmmsg call, either when it is full or when Flush() is called.
+// The owner calls Flush() at the end of each event loop iteration.
+//
+// Packets are reported as written once they are in the batch. If the socket
+// is blocked when the batch is sent, the unsent packets stay in the batch
+// and the writer reports IsWriteBlocked() until SetWritable() is called.
+class QuicBatchPacketWriter : public QuicPacketWriter {
+ public:
+  explicit QuicBatchPacketWriter(int fd);
+  virtual ~QuicBatchPacketWriter();
+
+  // QuicPacketWriter
+  virtual WriteResult WritePacket(
+      const char* buffer, size_t buf_len,
+      const net::IPAddressNumber& self_address,
+      const net::IPEndPoint& peer_address) OVERRIDE;
+  virtual bool IsWriteBlockedDataBuffered() const OVERRIDE;
+  virtual bool IsWriteBlocked() const OVERRIDE;
+  virtual void SetWritable() OVERRIDE;
+
+  // Sends the packets in the batch, unless the socket is blocked.
+  void Flush();
+
+  size_t num_buffered_packets() const { return num_packets_; }
+
+ private:
+  int fd_;
+  bool write_blocked_;
+  char buffers_[QuicSocketUtils::kMaxPacketsPerMmsgCall][kMaxPacketSize];
+  QuicSocketUtils::Packet packets_[QuicSocketUtils::kMaxPacketsPerMmsgCall];
+  size_t num_packets_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicBatchPacketWriter);
+};
+
+}  // namespace tools
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_BATCH_PACKET_WRITER_H_
@@ -0,0 +1,111 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_batch_packet_writer.h"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "base/strings/string_number_conversions.h"
+#include "net/base/net_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace tools {
+namespace test {
+namespace {
+
+class QuicBatchPacketWriterTest : public ::testing::Test {
+ protected:
+  QuicBatchPacketWriterTest() : receiver_fd_(-1), sender_fd_(-1) {}
+
+  virtual void SetUp() {
+    IPAddressNumber loopback;
+    ASSERT_TRUE(ParseIPLiteralToNumber("127.0.0.1", &loopback));
+    receiver_fd_ = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
+    ASSERT_LE(0, receiver_fd_);
+    ASSERT_EQ(0, QuicSocketUtils::SetGetAddressInfo(receiver_fd_, AF_INET));
+    SockaddrStorage storage;
+    ASSERT_TRUE(IPEndPoint(loopback, 0).ToSockAddr(storage.addr,
+                                                   &storage.addr_len));
+    ASSERT_EQ(0, bind(receiver_fd_, storage.addr, storage.addr_len));
+    SockaddrStorage bound;
+    ASSERT_EQ(0, getsockname(receiver_fd_, bound.addr, &bound.addr_len));
+    ASSERT_TRUE(receiver_address_.FromSockAddr(bound.addr, bound.addr_len));
+
+    sender_fd_ = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, IPPROTO_UDP);
+    ASSERT_LE(0, sender_fd_);
+  }
+
+  virtual void TearDown() {
+    close(receiver_fd_);
+    close(sender_fd_);
+  }
+
+  WriteResult Write(QuicBatchPacketWriter* writer, const std::string& data) {
+    return writer->WritePacket(data.data(), data.size(), IPAddressNumber(),
+                               receiver_address_);
+  }
+
+  // Reads the packets sent to the receiver into |packets_|.
+  int Read() {
+    for (size_t i = 0; i < arraysize(packets_); ++i) {
+      packets_[i].buffer = buffers_[i];
+      packets_[i].length = arraysize(buffers_[i]);
+    }
+    return QuicSocketUtils::ReadPackets(receiver_fd_, packets_,
+                                        arraysize(packets_), NULL);
+  }
+
+  std::string ReceivedData(int i) {
+    return std::string(packets_[i].buffer, packets_[i].length);
+  }
+
+  int receiver_fd_;
+  int sender_fd_;
+  IPEndPoint receiver_address_;
+  char buffers_[QuicSocketUtils::kMaxPacketsPerMmsgCall][kMaxPacketSize];
+  QuicSocketUtils::Packet packets_[QuicSocketUtils::kMaxPacketsPerMmsgCall];
+};
+
+TEST_F(QuicBatchPacketWriterTest, SendsOnFlush) {
+  QuicBatchPacketWriter writer(sender_fd_);
+  WriteResult result = Write(&writer, "a");
+  EXPECT_EQ(WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(1, result.bytes_written);
+  result = Write(&writer, "bc");
+  EXPECT_EQ(WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(2, result.bytes_written);
+  EXPECT_EQ(2u, writer.num_buffered_packets());
+  EXPECT_EQ(-1, Read());
+
+  writer.Flush();
+  EXPECT_EQ(0u, writer.num_buffered_packets());
+  ASSERT_EQ(2, Read());
+  EXPECT_EQ("a", ReceivedData(0));
+  EXPECT_EQ("bc", ReceivedData(1));
+  EXPECT_EQ(receiver_address_.address(), packets_[0].self_address);
+}
+
+TEST_F(QuicBatchPacketWriterTest, SendsWhenFull) {
+  QuicBatchPacketWriter writer(sender_fd_);
+  for (size_t i = 0; i <= QuicSocketUtils::kMaxPacketsPerMmsgCall; ++i) {
+    EXPECT_EQ(WRITE_STATUS_OK, Write(&writer, base::Uint64ToString(i)).status);
+  }
+  EXPECT_EQ(1u, writer.num_buffered_packets());
+  ASSERT_EQ(static_cast<int>(QuicSocketUtils::kMaxPacketsPerMmsgCall),
+            Read());
+  EXPECT_EQ("0", ReceivedData(0));
+
+  writer.Flush();
+  ASSERT_EQ(1, Read());
+  EXPECT_EQ(base::Uint64ToString(QuicSocketUtils::kMaxPacketsPerMmsgCall),
+            ReceivedData(0));
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace tools
+}  // namespace net
@@ -42,6 +42,7 @@ QuicClient::QuicClient(IPEndPoint server_address,
       initialized_(false),
       packets_dropped_(0),
       overflow_supported_(false),
+      use_recvmmsg_(true),
       supported_versions_(supported_versions),
       print_response_(print_response) {
   config_.SetDefaults();
@@ -60,6 +61,7 @@ QuicClient::QuicClient(IPEndPoint server_address,
       initialized_(false),
       packets_dropped_(0),
       overflow_supported_(false),
+      use_recvmmsg_(true),
       supported_versions_(supported_versions),
       print_response_(false) {
 }
@@ -235,7 +237,8 @@ void QuicClient::OnEvent(int fd, EpollEvent* event) {
   DCHECK_EQ(fd, fd_);
 
   if (event->in_events & EPOLLIN) {
-    while (connected() && ReadAndProcessPacket()) {
+    while (connected() &&
+           (use_recvmmsg_ ? ReadAndProcessPackets() : ReadAndProcessPacket())) {
     }
   }
   if (connected() && (event->in_events & EPOLLOUT)) {
@@ -318,5 +321,35 @@ bool QuicClient::ReadAndProcessPacket() {
   return true;
 }
 
+bool QuicClient::ReadAndProcessPackets() {
+  // Allocate some extra space so we can send an error if the server goes over
+  // the limit.
+  char buf[QuicSocketUtils::kMaxPacketsPerMmsgCall][2 * kMaxPacketSize];
+  QuicSocketUtils::Packet packets[QuicSocketUtils::kMaxPacketsPerMmsgCall];
+  for (size_t i = 0; i < arraysize(packets); ++i) {
+    packets[i].buffer = buf[i];
+    packets[i].length = arraysize(buf[i]);
+  }
+
+  int packets_read = QuicSocketUtils::ReadPackets(
+      fd_, packets, arraysize(packets),
+      overflow_supported_ ? &packets_dropped_ : NULL);
+  if (packets_read < 0) {
+    if (errno == ENOSYS) {
+      use_recvmmsg_ = false;
+      return ReadAndProcessPacket();
+    }
+    return false;
+  }
+
+  for (int i = 0; i < packets_read && connected(); ++i) {
+    QuicEncryptedPacket packet(packets[i].buffer, packets[i].length, false);
+    IPEndPoint client_address(packets[i].self_address, client_address_.port());
+    session_->connection()->ProcessUdpPacket(
+        client_address, packets[i].peer_address, packet);
+  }
+  return true;
+}
+
 }  // namespace tools
 }  // namespace net
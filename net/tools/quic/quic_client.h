@@ -178,6 +178,10 @@ class QuicClient : public EpollCallbackInterface,
   // Read a UDP packet and hand it to the framer.
   bool ReadAndProcessPacket();
 
+  // Read up to QuicSocketUtils::kMaxPacketsPerMmsgCall UDP packets with one
+  // recvmmsg call and hand them to the framer.
+  bool ReadAndProcessPackets();
+
   // Address of the server.
   const IPEndPoint server_address_;
 
@@ -225,6 +229,9 @@ class QuicClient : public EpollCallbackInterface,
   // because the socket would otherwise overflow.
   bool overflow_supported_;
 
+  // If true, use recvmmsg for reading. Cleared if the kernel lacks it.
+  bool use_recvmmsg_;
+
   // This vector contains QUIC versions which we currently support.
   // This should be ordered such that the highest supported version is the first
   // element, with subsequent elements in descending order (versions can be
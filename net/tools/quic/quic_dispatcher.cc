@@ -9,9 +9,13 @@
 #include "base/debug/stack_trace.h"
 #include "base/logging.h"
 #include "base/stl_util.h"
+#include "net/quic/crypto/crypto_framer.h"
+#include "net/quic/crypto/crypto_handshake_message.h"
+#include "net/quic/crypto/crypto_protocol.h"
+#include "net/quic/crypto/quic_crypto_server_config.h"
 #include "net/quic/quic_blocked_writer_interface.h"
 #include "net/quic/quic_utils.h"
-#include "net/tools/quic/quic_default_packet_writer.h"
+#include "net/tools/quic/quic_batch_packet_writer.h"
 #include "net/tools/quic/quic_epoll_connection_helper.h"
 #include "net/tools/quic/quic_packet_writer_wrapper.h"
 #include "net/tools/quic/quic_socket_utils.h"
@@ -23,6 +27,101 @@ namespace tools {
 using base::StringPiece;
 using std::make_pair;
 
+namespace {
+
+// Once there are this many sessions, new sessions are only created for
+// client hellos which carry a valid source-address token.
+const size_t kDefaultMaxSessionsWithoutToken = 50000;
+
+// Parses the client hello out of the first packet of a connection, without
+// creating any connection state.
+class ChloExtractor : public QuicFramerVisitorInterface {
+ public:
+  ChloExtractor() {}
+
+  // Returns the client hello in |packet|, or NULL if |packet| does not start
+  // a client hello.  The caller takes ownership of the result.
+  static CryptoHandshakeMessage* Extract(const QuicEncryptedPacket& packet,
+                                         const QuicVersionVector& versions,
+                                         QuicVersion version) {
+    ChloExtractor extractor;
+    QuicFramer framer(versions, QuicTime::Zero(), true);
+    framer.set_version(version);
+    framer.set_visitor(&extractor);
+    framer.ProcessPacket(packet);
+    return extractor.chlo_.release();
+  }
+
+  // QuicFramerVisitorInterface implementation
+  virtual void OnError(QuicFramer* framer) OVERRIDE {}
+  virtual bool OnProtocolVersionMismatch(QuicVersion version) OVERRIDE {
+    return false;
+  }
+  virtual void OnPacket() OVERRIDE {}
+  virtual void OnPublicResetPacket(
+      const QuicPublicResetPacket& /*packet*/) OVERRIDE {}
+  virtual void OnVersionNegotiationPacket(
+      const QuicVersionNegotiationPacket& /*packet*/) OVERRIDE {}
+  virtual void OnRevivedPacket() OVERRIDE {}
+  virtual bool OnUnauthenticatedPublicHeader(
+      const QuicPacketPublicHeader& /*header*/) OVERRIDE {
+    return true;
+  }
+  virtual bool OnUnauthenticatedHeader(
+      const QuicPacketHeader& /*header*/) OVERRIDE {
+    return true;
+  }
+  virtual bool OnPacketHeader(const QuicPacketHeader& /*header*/) OVERRIDE {
+    return true;
+  }
+  virtual void OnFecProtectedPayload(StringPiece /*payload*/) OVERRIDE {}
+  virtual bool OnStreamFrame(const QuicStreamFrame& frame) OVERRIDE {
+    if (frame.stream_id != kCryptoStreamId || frame.offset != 0) {
+      return true;
+    }
+    scoped_ptr<string> data(frame.GetDataAsString());
+    chlo_.reset(CryptoFramer::ParseMessage(*data));
+    if (chlo_.get() != NULL && chlo_->tag() != kCHLO) {
+      chlo_.reset();
+    }
+    // Nothing else in the packet is needed.
+    return false;
+  }
+  virtual bool OnAckFrame(const QuicAckFrame& /*frame*/) OVERRIDE {
+    return true;
+  }
+  virtual bool OnCongestionFeedbackFrame(
+      const QuicCongestionFeedbackFrame& /*frame*/) OVERRIDE {
+    return true;
+  }
+  virtual bool OnRstStreamFrame(const QuicRstStreamFrame& /*frame*/) OVERRIDE {
+    return true;
+  }
+  virtual bool OnConnectionCloseFrame(
+      const QuicConnectionCloseFrame & /*frame*/) OVERRIDE {
+    return true;
+  }
+  virtual bool OnGoAwayFrame(const QuicGoAwayFrame& /*frame*/) OVERRIDE {
+    return true;
+  }
+  virtual bool OnWindowUpdateFrame(const QuicWindowUpdateFrame& /*frame*/)
+      OVERRIDE {
+    return true;
+  }
+  virtual bool OnBlockedFrame(const QuicBlockedFrame& /*frame*/) OVERRIDE {
+    return true;
+  }
+  virtual void OnFecData(const QuicFecData& /*fec*/) OVERRIDE {}
+  virtual void OnPacketComplete() OVERRIDE {}
+
+ private:
+  scoped_ptr<CryptoHandshakeMessage> chlo_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChloExtractor);
+};
+
+}  // namespace
+
 class DeleteSessionsAlarm : public EpollAlarm {
  public:
   explicit DeleteSessionsAlarm(QuicDispatcher* dispatcher)
@@ -137,9 +236,11 @@ QuicDispatcher::QuicDispatcher(const QuicConfig& config,
                                EpollServer* epoll_server)
     : config_(config),
       crypto_config_(crypto_config),
+      max_sessions_without_token_(kDefaultMaxSessionsWithoutToken),
       delete_sessions_alarm_(new DeleteSessionsAlarm(this)),
       epoll_server_(epoll_server),
       helper_(new QuicEpollConnectionHelper(epoll_server_)),
+      batch_writer_(NULL),
       supported_versions_(supported_versions),
       current_packet_(NULL),
       framer_(supported_versions, /*unused*/ QuicTime::Zero(), true),
@@ -192,6 +293,12 @@ bool QuicDispatcher::OnUnauthenticatedPublicHeader(
     // session for it.  All initial packets for a new connection are required to
     // have the flag set.  Otherwise it may be a stray packet.
     if (header.version_flag) {
+      if (!ShouldCreateSession(header)) {
+        // Drop the packet without keeping any state for it.
+        DVLOG(1) << "Dropping packet without a valid source-address token "
+                 << "for " << guid;
+        return false;
+      }
       session = CreateQuicSession(guid, current_server_address_,
                                   current_client_address_);
     }
@@ -275,6 +382,12 @@ bool QuicDispatcher::HasPendingWrites() const {
   return !write_blocked_list_.empty();
 }
 
+void QuicDispatcher::FlushWrites() {
+  if (batch_writer_ != NULL) {
+    batch_writer_->Flush();
+  }
+}
+
 void QuicDispatcher::Shutdown() {
   while (!session_map_.empty()) {
     QuicSession* session = session_map_.begin()->second;
@@ -283,6 +396,7 @@ void QuicDispatcher::Shutdown() {
     DCHECK(session_map_.empty() || session_map_.begin()->second != session);
   }
   DeleteSessions();
+  FlushWrites();
 }
 
 void QuicDispatcher::OnConnectionClosed(QuicGuid guid, QuicErrorCode error) {
@@ -312,7 +426,9 @@ void QuicDispatcher::OnWriteBlocked(QuicBlockedWriterInterface* writer) {
 }
 
 QuicPacketWriter* QuicDispatcher::CreateWriter(int fd) {
-  return new QuicDefaultPacketWriter(fd);
+  DCHECK(batch_writer_ == NULL);
+  batch_writer_ = new QuicBatchPacketWriter(fd);
+  return batch_writer_;
 }
 
 QuicPacketWriterWrapper* QuicDispatcher::CreateWriterWrapper(
@@ -341,6 +457,8 @@ QuicConnection* QuicDispatcher::CreateQuicConnection(
 }
 
 void QuicDispatcher::set_writer(QuicPacketWriter* writer) {
+  FlushWrites();
+  batch_writer_ = NULL;
   writer_->set_writer(writer);
 }
 
@@ -361,5 +479,20 @@ bool QuicDispatcher::HandlePacketForTimeWait(
   return true;
 }
 
+bool QuicDispatcher::ShouldCreateSession(
+    const QuicPacketPublicHeader& header) {
+  if (session_map_.size() < max_sessions_without_token_) {
+    return true;
+  }
+  if (!framer_.IsSupportedVersion(header.versions.front())) {
+    return false;
+  }
+  scoped_ptr<CryptoHandshakeMessage> chlo(ChloExtractor::Extract(
+      *current_packet_, supported_versions_, header.versions.front()));
+  return chlo.get() != NULL &&
+      crypto_config_.HasValidSourceAddressToken(
+          *chlo, current_client_address_, helper_->GetClock()->WallNow());
+}
+
 }  // namespace tools
 }  // namespace net
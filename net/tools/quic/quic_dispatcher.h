@@ -43,6 +43,7 @@ class QuicSession;
 
 namespace tools {
 
+class QuicBatchPacketWriter;
 class QuicPacketWriterWrapper;
 
 namespace test {
@@ -81,6 +82,10 @@ class QuicDispatcher : public QuicServerSessionVisitor {
   // Returns true if there's anything in the blocked writer list.
   virtual bool HasPendingWrites() const;
 
+  // Sends the packets batched since the last call. Called at the end of each
+  // event loop iteration.
+  void FlushWrites();
+
   // Sends ConnectionClose frames to all connected clients.
   void Shutdown();
 
@@ -101,8 +106,8 @@ class QuicDispatcher : public QuicServerSessionVisitor {
   WriteBlockedList* write_blocked_list() { return &write_blocked_list_; }
 
  protected:
-  // Instantiates a new low-level packet writer. Caller takes ownership of the
-  // returned object.
+  // Instantiates a new low-level packet writer, which batches writes until
+  // FlushWrites() is called. Caller takes ownership of the returned object.
   QuicPacketWriter* CreateWriter(int fd);
 
   // Instantiates a new top-level writer wrapper. Takes ownership of |writer|.
@@ -165,6 +170,12 @@ class QuicDispatcher : public QuicServerSessionVisitor {
 
   bool HandlePacketForTimeWait(const QuicPacketPublicHeader& header);
 
+  // Returns true if a new session should be created for the packet currently
+  // being dispatched.  Once there are |max_sessions_without_token_| sessions,
+  // the client hello in the packet must carry a valid source-address token,
+  // so that a flood of spoofed packets can not create sessions.
+  bool ShouldCreateSession(const QuicPacketPublicHeader& header);
+
   const QuicConfig& config_;
 
   const QuicCryptoServerConfig& crypto_config_;
@@ -174,6 +185,10 @@ class QuicDispatcher : public QuicServerSessionVisitor {
 
   SessionMap session_map_;
 
+  // The number of sessions above which new sessions are only created for
+  // clients which have proved ownership of their address.
+  size_t max_sessions_without_token_;
+
   // Entity that manages guids in time wait state.
   scoped_ptr<QuicTimeWaitListManager> time_wait_list_manager_;
 
@@ -193,6 +208,10 @@ class QuicDispatcher : public QuicServerSessionVisitor {
   // connections.
   scoped_ptr<QuicPacketWriterWrapper> writer_;
 
+  // The writer created by CreateWriter(), owned by |writer_| or by a wrapper
+  // inside it. NULL once set_writer() replaces it.
+  QuicBatchPacketWriter* batch_writer_;
+
   // This vector contains QUIC versions which we currently support.
   // This should be ordered such that the highest supported version is the first
   // element, with subsequent elements in descending order (versions can be
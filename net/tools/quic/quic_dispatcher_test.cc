@@ -200,6 +200,28 @@ TEST_F(QuicDispatcherTest, Shutdown) {
   dispatcher_.Shutdown();
 }
 
+TEST_F(QuicDispatcherTest, NoSessionWithoutTokenOverLimit) {
+  IPEndPoint addr(net::test::Loopback4(), 1);
+  QuicDispatcherPeer::SetMaxSessionsWithoutToken(&dispatcher_, 1);
+
+  EXPECT_CALL(dispatcher_, CreateQuicSession(1, _, addr))
+      .WillOnce(testing::Return(CreateSession(
+          &dispatcher_, 1, addr, &session1_)));
+  ProcessPacket(addr, 1, true, "foo");
+
+  // Once the limit is reached, a packet which does not carry a client hello
+  // with a valid source-address token creates no session, and the guid is
+  // not added to the time wait list.
+  EXPECT_CALL(dispatcher_, CreateQuicSession(2, _, _)).Times(0);
+  CryptoHandshakeMessage chlo;
+  chlo.set_tag(kCHLO);
+  ProcessPacket(addr, 2, true,
+                chlo.GetSerialized().AsStringPiece().as_string());
+  EXPECT_EQ(1u, dispatcher_.session_map().size());
+  EXPECT_FALSE(QuicDispatcherPeer::GetTimeWaitListManager(&dispatcher_)->
+      IsGuidInTimeWait(2));
+}
+
 class MockTimeWaitListManager : public QuicTimeWaitListManager {
  public:
   MockTimeWaitListManager(QuicPacketWriter* writer,
@@ -25,19 +25,28 @@ class QuicEpollAlarm : public QuicAlarm {
                  QuicAlarm::Delegate* delegate)
       : QuicAlarm(delegate),
         epoll_server_(epoll_server),
-        epoll_alarm_impl_(this) {}
+        epoll_alarm_impl_(this),
+        registered_time_us_(0) {}
 
  protected:
+  // QUIC connections cancel and re-set their retransmission and ack alarms
+  // for nearly every packet, usually pushing the deadline back. Rather than
+  // paying for an alarm map removal and insertion each time, the epoll alarm
+  // is left registered on Cancel() and kept on Set() as long as it goes off
+  // no later than the new deadline. When it goes off early it is simply
+  // re-registered for the current deadline.
   virtual void SetImpl() OVERRIDE {
     DCHECK(deadline().IsInitialized());
-    epoll_server_->RegisterAlarm(
-        deadline().Subtract(QuicTime::Zero()).ToMicroseconds(),
-        &epoll_alarm_impl_);
+    int64 deadline_us = deadline().Subtract(QuicTime::Zero()).ToMicroseconds();
+    if (epoll_alarm_impl_.registered() && registered_time_us_ <= deadline_us)
+      return;
+    epoll_alarm_impl_.UnregisterIfRegistered();
+    registered_time_us_ = deadline_us;
+    epoll_server_->RegisterAlarm(deadline_us, &epoll_alarm_impl_);
   }
 
   virtual void CancelImpl() OVERRIDE {
     DCHECK(!deadline().IsInitialized());
-    epoll_alarm_impl_.UnregisterIfRegistered();
   }
 
  private:
@@ -47,17 +56,35 @@ class QuicEpollAlarm : public QuicAlarm {
 
     virtual int64 OnAlarm() OVERRIDE {
       EpollAlarm::OnAlarm();
-      alarm_->Fire();
-      // Fire will take care of registering the alarm, if needed.
-      return 0;
+      return alarm_->OnEpollAlarm();
     }
 
    private:
     QuicEpollAlarm* alarm_;
   };
 
+  // Returns the time to re-register the epoll alarm at, or 0 if it should
+  // stay unregistered.
+  int64 OnEpollAlarm() {
+    if (!deadline().IsInitialized())
+      return 0;
+
+    int64 deadline_us = deadline().Subtract(QuicTime::Zero()).ToMicroseconds();
+    if (deadline_us > registered_time_us_) {
+      registered_time_us_ = deadline_us;
+      return deadline_us;
+    }
+
+    // Fire will take care of registering the alarm, if needed.
+    Fire();
+    return 0;
+  }
+
   EpollServer* epoll_server_;
   EpollAlarmImpl epoll_alarm_impl_;
+
+  // The time |epoll_alarm_impl_| was last registered to go off at.
+  int64 registered_time_us_;
 };
 
 }  // namespace
@@ -103,6 +103,51 @@ TEST_F(QuicEpollConnectionHelperTest, CreateAlarmAndReset) {
   EXPECT_TRUE(delegate->fired());
 }
 
+TEST_F(QuicEpollConnectionHelperTest, CreateAlarmAndResetEarlier) {
+  TestDelegate* delegate = new TestDelegate();
+  scoped_ptr<QuicAlarm> alarm(helper_.CreateAlarm(delegate));
+
+  const QuicClock* clock = helper_.GetClock();
+  QuicTime start = clock->Now();
+  QuicTime::Delta delta = QuicTime::Delta::FromMicroseconds(3);
+  alarm->Set(clock->Now().Add(delta));
+  alarm->Cancel();
+  QuicTime::Delta new_delta = QuicTime::Delta::FromMicroseconds(1);
+  alarm->Set(clock->Now().Add(new_delta));
+  EXPECT_EQ(1u, epoll_server_.NumberOfAlarms());
+
+  epoll_server_.AdvanceByExactlyAndCallCallbacks(new_delta.ToMicroseconds());
+  EXPECT_EQ(start.Add(new_delta), clock->Now());
+  EXPECT_TRUE(delegate->fired());
+  EXPECT_EQ(0u, epoll_server_.NumberOfAlarms());
+}
+
+TEST_F(QuicEpollConnectionHelperTest, CancelKeepsEpollAlarmUntilItGoesOff) {
+  TestDelegate* delegate = new TestDelegate();
+  scoped_ptr<QuicAlarm> alarm(helper_.CreateAlarm(delegate));
+
+  const QuicClock* clock = helper_.GetClock();
+  QuicTime::Delta delta = QuicTime::Delta::FromMicroseconds(1);
+  alarm->Set(clock->Now().Add(delta));
+  alarm->Cancel();
+  EXPECT_EQ(1u, epoll_server_.NumberOfAlarms());
+
+  epoll_server_.AdvanceByExactlyAndCallCallbacks(delta.ToMicroseconds());
+  EXPECT_FALSE(delegate->fired());
+  EXPECT_EQ(0u, epoll_server_.NumberOfAlarms());
+}
+
+TEST_F(QuicEpollConnectionHelperTest, DeletingAlarmUnregistersIt) {
+  TestDelegate* delegate = new TestDelegate();
+  scoped_ptr<QuicAlarm> alarm(helper_.CreateAlarm(delegate));
+
+  const QuicClock* clock = helper_.GetClock();
+  alarm->Set(clock->Now().Add(QuicTime::Delta::FromMicroseconds(1)));
+  alarm->Cancel();
+  alarm.reset();
+  EXPECT_EQ(0u, epoll_server_.NumberOfAlarms());
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace tools
@@ -0,0 +1,113 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_multi_worker_server.h"
+
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/simple_thread.h"
+#include "net/quic/crypto/crypto_server_config_protobuf.h"
+#include "net/quic/crypto/quic_crypto_server_config.h"
+#include "net/quic/crypto/quic_random.h"
+#include "net/quic/quic_clock.h"
+#include "net/tools/quic/quic_server.h"
+
+namespace net {
+namespace tools {
+
+// Runs the event loop of one QuicServer until Quit() is called.
+class QuicMultiWorkerServer::Worker : public base::SimpleThread {
+ public:
+  Worker(const QuicConfig& config,
+         const QuicVersionVector& supported_versions,
+         size_t index)
+      : SimpleThread(base::StringPrintf("quic_worker_%d",
+                                        static_cast<int>(index))),
+        quit_(true, false),
+        server_(config, supported_versions) {
+    server_.set_reuse_port(true);
+  }
+
+  virtual ~Worker() {}
+
+  virtual void Run() OVERRIDE {
+    while (!quit_.IsSignaled()) {
+      server_.WaitForEvents();
+    }
+    server_.Shutdown();
+  }
+
+  void Quit() { quit_.Signal(); }
+
+  QuicServer* server() { return &server_; }
+
+ private:
+  base::WaitableEvent quit_;
+  QuicServer server_;
+
+  DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+QuicMultiWorkerServer::QuicMultiWorkerServer(
+    const QuicConfig& config,
+    const QuicVersionVector& supported_versions,
+    size_t num_workers)
+    : port_(0),
+      started_(false) {
+  DCHECK_GT(num_workers, 0u);
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.push_back(new Worker(config, supported_versions, i));
+  }
+}
+
+QuicMultiWorkerServer::~QuicMultiWorkerServer() {
+  Shutdown();
+}
+
+bool QuicMultiWorkerServer::Listen(const IPEndPoint& address) {
+  DCHECK(!started_);
+
+  QuicClock clock;
+  scoped_ptr<QuicServerConfigProtobuf> server_config(
+      QuicCryptoServerConfig::GenerateConfig(
+          QuicRandom::GetInstance(), &clock,
+          QuicCryptoServerConfig::ConfigOptions()));
+  server_config->set_primary_time(clock.WallNow().ToUNIXSeconds());
+
+  IPEndPoint worker_address = address;
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    QuicServer* server = workers_[i]->server();
+    if (!server->SetPrimaryConfig(server_config.get()) ||
+        !server->Listen(worker_address)) {
+      return false;
+    }
+    // The other workers must share the port the kernel picked.
+    worker_address = IPEndPoint(address.address(), server->port());
+  }
+  port_ = worker_address.port();
+
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i]->Start();
+  }
+  started_ = true;
+  return true;
+}
+
+void QuicMultiWorkerServer::Shutdown() {
+  if (!started_) {
+    return;
+  }
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i]->Quit();
+  }
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    workers_[i]->Join();
+  }
+  started_ = false;
+}
+
+}  // namespace tools
+}  // namespace net
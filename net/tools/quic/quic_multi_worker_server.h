@@ -0,0 +1,60 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// Runs several QuicServers on one port, each on its own thread.
+
+#ifndef NET_TOOLS_QUIC_QUIC_MULTI_WORKER_SERVER_H_
+#define NET_TOOLS_QUIC_QUIC_MULTI_WORKER_SERVER_H_
+
+#include "base/basictypes.h"
+#include "base/memory/scoped_vector.h"
+#include "net/base/ip_endpoint.h"
+#include "net/quic/quic_config.h"
+#include "net/quic/quic_protocol.h"
+
+namespace net {
+namespace tools {
+
+// Each worker owns a QuicServer, and so its own socket, EpollServer,
+// dispatcher and time wait list. The sockets are bound with SO_REUSEPORT,
+// and the kernel picks a socket for each client by hashing its address, so
+// all the packets of a connection reach the same worker as long as the
+// client's address does not change.
+//
+// The workers share one primary server config and source address token
+// secret, so a client that reconnects from another port, and lands on
+// another worker, can still resume with a 0-RTT handshake. The strike
+// registers are per worker.
+class QuicMultiWorkerServer {
+ public:
+  QuicMultiWorkerServer(const QuicConfig& config,
+                        const QuicVersionVector& supported_versions,
+                        size_t num_workers);
+  ~QuicMultiWorkerServer();
+
+  // Starts the workers listening on |address|. If its port is 0, they all
+  // listen on the port the kernel picks for the first one.
+  bool Listen(const IPEndPoint& address);
+
+  // Stops the workers and waits for them to shut down their servers.
+  void Shutdown();
+
+  int port() const { return port_; }
+
+  size_t num_workers() const { return workers_.size(); }
+
+ private:
+  class Worker;
+
+  ScopedVector<Worker> workers_;
+  int port_;
+  bool started_;
+
+  DISALLOW_COPY_AND_ASSIGN(QuicMultiWorkerServer);
+};
+
+}  // namespace tools
+}  // namespace net
+
+#endif  // NET_TOOLS_QUIC_QUIC_MULTI_WORKER_SERVER_H_
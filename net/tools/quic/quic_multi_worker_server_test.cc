@@ -0,0 +1,45 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "net/tools/quic/quic_multi_worker_server.h"
+
+#include "net/base/net_util.h"
+#include "net/tools/quic/quic_server.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace net {
+namespace tools {
+namespace test {
+namespace {
+
+IPEndPoint Loopback(int port) {
+  IPAddressNumber ip;
+  CHECK(ParseIPLiteralToNumber("127.0.0.1", &ip));
+  return IPEndPoint(ip, port);
+}
+
+TEST(QuicMultiWorkerServerTest, WorkersShareThePort) {
+  QuicConfig config;
+  config.SetDefaults();
+  QuicMultiWorkerServer server(config, QuicSupportedVersions(), 3);
+  ASSERT_TRUE(server.Listen(Loopback(0)));
+  EXPECT_NE(0, server.port());
+  EXPECT_EQ(3u, server.num_workers());
+
+  // Another server can only join the port with SO_REUSEPORT.
+  QuicServer other_server;
+  EXPECT_FALSE(other_server.Listen(Loopback(server.port())));
+
+  QuicServer reuse_port_server;
+  reuse_port_server.set_reuse_port(true);
+  EXPECT_TRUE(reuse_port_server.Listen(Loopback(server.port())));
+  reuse_port_server.Shutdown();
+
+  server.Shutdown();
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace tools
+}  // namespace net
@@ -21,12 +21,14 @@
 #include "net/tools/quic/quic_in_memory_cache.h"
 #include "net/tools/quic/quic_socket_utils.h"
 
-#define MMSG_MORE 0
-
 #ifndef SO_RXQ_OVFL
 #define SO_RXQ_OVFL 40
 #endif
 
+#ifndef SO_REUSEPORT
+#define SO_REUSEPORT 15
+#endif
+
 const int kEpollFlags = EPOLLIN | EPOLLOUT | EPOLLET;
 static const char kSourceAddressTokenSecret[] = "secret";
 
@@ -39,6 +41,7 @@ QuicServer::QuicServer()
       packets_dropped_(0),
       overflow_supported_(false),
       use_recvmmsg_(false),
+      reuse_port_(false),
       crypto_config_(kSourceAddressTokenSecret, QuicRandom::GetInstance()),
       supported_versions_(QuicSupportedVersions()) {
   // Use hardcoded crypto parameters for now.
@@ -56,6 +59,7 @@ QuicServer::QuicServer(const QuicConfig& config,
       packets_dropped_(0),
       overflow_supported_(false),
       use_recvmmsg_(false),
+      reuse_port_(false),
       config_(config),
       crypto_config_(kSourceAddressTokenSecret, QuicRandom::GetInstance()),
       supported_versions_(supported_versions) {
@@ -63,9 +67,7 @@ QuicServer::QuicServer(const QuicConfig& config,
 }
 
 void QuicServer::Initialize() {
-#if MMSG_MORE
   use_recvmmsg_ = true;
-#endif
   epoll_server_.set_timeout_in_us(50 * 1000);
   // Initialize the in memory cache now.
   QuicInMemoryCache::GetInstance();
@@ -81,6 +83,12 @@ void QuicServer::Initialize() {
 QuicServer::~QuicServer() {
 }
 
+bool QuicServer::SetPrimaryConfig(QuicServerConfigProtobuf* protobuf) {
+  QuicEpollClock clock(&epoll_server_);
+  std::vector<QuicServerConfigProtobuf*> protobufs(1, protobuf);
+  return crypto_config_.SetConfigs(protobufs, clock.WallNow());
+}
+
 bool QuicServer::Listen(const IPEndPoint& address) {
   port_ = address.port();
   int address_family = address.GetSockAddrFamily();
@@ -121,6 +129,16 @@ bool QuicServer::Listen(const IPEndPoint& address) {
     return false;
   }
 
+  if (reuse_port_) {
+    int reuse_port = 1;
+    rc = setsockopt(fd_, SOL_SOCKET, SO_REUSEPORT,
+                    &reuse_port, sizeof(reuse_port));
+    if (rc < 0) {
+      LOG(ERROR) << "SO_REUSEPORT not supported: " << strerror(errno);
+      return false;
+    }
+  }
+
   sockaddr_storage raw_addr;
   socklen_t raw_addr_len = sizeof(raw_addr);
   CHECK(address.ToSockAddr(reinterpret_cast<sockaddr*>(&raw_addr),
@@ -156,6 +174,8 @@ bool QuicServer::Listen(const IPEndPoint& address) {
 
 void QuicServer::WaitForEvents() {
   epoll_server_.WaitForEventsAndExecuteCallbacks();
+  // Send everything written while handling the events and alarms at once.
+  dispatcher_->FlushWrites();
 }
 
 void QuicServer::Shutdown() {
@@ -175,9 +195,20 @@ void QuicServer::OnEvent(int fd, EpollEvent* event) {
     DVLOG(1) << "EPOLLIN";
     bool read = true;
     while (read) {
+      if (use_recvmmsg_) {
+        int packets_read = ReadAndDispatchPackets(
+            fd_, port_, dispatcher_.get(),
+            overflow_supported_ ? &packets_dropped_ : NULL);
+        if (packets_read < 0 && errno == ENOSYS) {
+          use_recvmmsg_ = false;
+          continue;
+        }
+        read = packets_read > 0;
+      } else {
         read = ReadAndDispatchSinglePacket(
             fd_, port_, dispatcher_.get(),
             overflow_supported_ ? &packets_dropped_ : NULL);
+      }
     }
   }
   if (event->in_events & EPOLLOUT) {
@@ -218,5 +249,29 @@ bool QuicServer::ReadAndDispatchSinglePacket(int fd,
   return true;
 }
 
+/* static */
+int QuicServer::ReadAndDispatchPackets(int fd,
+                                       int port,
+                                       QuicDispatcher* dispatcher,
+                                       uint32* packets_dropped) {
+  // Allocate some extra space so we can send an error if the client goes over
+  // the limit.
+  char buf[QuicSocketUtils::kMaxPacketsPerMmsgCall][2 * kMaxPacketSize];
+  QuicSocketUtils::Packet packets[QuicSocketUtils::kMaxPacketsPerMmsgCall];
+  for (size_t i = 0; i < arraysize(packets); ++i) {
+    packets[i].buffer = buf[i];
+    packets[i].length = arraysize(buf[i]);
+  }
+
+  int packets_read = QuicSocketUtils::ReadPackets(
+      fd, packets, arraysize(packets), packets_dropped);
+  for (int i = 0; i < packets_read; ++i) {
+    QuicEncryptedPacket packet(packets[i].buffer, packets[i].length, false);
+    IPEndPoint server_address(packets[i].self_address, port);
+    dispatcher->ProcessPacket(server_address, packets[i].peer_address, packet);
+  }
+  return packets_read;
+}
+
 }  // namespace tools
 }  // namespace net
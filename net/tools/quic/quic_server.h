@@ -19,6 +19,8 @@
 
 namespace net {
 
+class QuicServerConfigProtobuf;
+
 namespace tools {
 
 namespace test {
@@ -62,12 +64,29 @@ class QuicServer : public EpollCallbackInterface {
                                           QuicDispatcher* dispatcher,
                                           uint32* packets_dropped);
 
+  // Like ReadAndDispatchSinglePacket(), but reads up to
+  // QuicSocketUtils::kMaxPacketsPerMmsgCall packets with one recvmmsg call.
+  // Returns the number of packets read, or -1 if none were read, in which
+  // case errno is ENOSYS if the kernel does not support recvmmsg.
+  static int ReadAndDispatchPackets(int fd, int port,
+                                    QuicDispatcher* dispatcher,
+                                    uint32* packets_dropped);
+
   virtual void OnShutdown(EpollServer* eps, int fd) OVERRIDE {}
 
   void SetStrikeRegisterNoStartupPeriod() {
     crypto_config_.set_strike_register_no_startup_period();
   }
 
+  // Binds the socket with SO_REUSEPORT, so that several servers can listen on
+  // the same port. Must be called before Listen().
+  void set_reuse_port(bool reuse_port) { reuse_port_ = reuse_port; }
+
+  // Makes |protobuf| the primary server config. Servers that share a config
+  // accept each other's cached server configs, so clients can do 0-RTT
+  // handshakes with any of them. Returns false if |protobuf| is invalid.
+  bool SetPrimaryConfig(QuicServerConfigProtobuf* protobuf);
+
   bool overflow_supported() { return overflow_supported_; }
 
   uint32 packets_dropped() { return packets_dropped_; }
@@ -103,6 +122,9 @@ class QuicServer : public EpollCallbackInterface {
   // If true, use recvmmsg for reading.
   bool use_recvmmsg_;
 
+  // If true, the socket is bound with SO_REUSEPORT.
+  bool reuse_port_;
+
   // config_ contains non-crypto parameters that are negotiated in the crypto
   // handshake.
   QuicConfig config_;
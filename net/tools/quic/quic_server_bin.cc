@@ -5,6 +5,8 @@
 // A binary wrapper for QuicServer.  It listens forever on --port
 // (default 6121) until it's killed or ctrl-cd to death.
 
+#include <unistd.h>
+
 #include <iostream>
 
 #include "base/at_exit.h"
@@ -14,12 +16,16 @@
 #include "base/strings/string_number_conversions.h"
 #include "net/base/ip_endpoint.h"
 #include "net/tools/quic/quic_in_memory_cache.h"
+#include "net/tools/quic/quic_multi_worker_server.h"
 #include "net/tools/quic/quic_server.h"
 
 // The port the quic server will listen on.
 
 int32 FLAGS_port = 6121;
 
+// The number of server threads. Each listens on the port with SO_REUSEPORT.
+int32 FLAGS_num_workers = 1;
+
 int main(int argc, char *argv[]) {
   CommandLine::Init(argc, argv);
   CommandLine* line = CommandLine::ForCurrentProcess();
@@ -35,6 +41,7 @@ int main(int argc, char *argv[]) {
         "Options:\n"
         "-h, --help                  show this help message and exit\n"
         "--port=<port>               specify the port to listen on\n"
+        "--num_workers=<n>           run n server threads sharing the port\n"
         "--quic_in_memory_cache_dir  directory containing response data\n"
         "                            to load\n";
     std::cout << help_str;
@@ -53,11 +60,36 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  if (line->HasSwitch("num_workers")) {
+    int num_workers;
+    if (base::StringToInt(line->GetSwitchValueASCII("num_workers"),
+                          &num_workers) && num_workers > 0) {
+      FLAGS_num_workers = num_workers;
+    }
+  }
+
   base::AtExitManager exit_manager;
 
   net::IPAddressNumber ip;
   CHECK(net::ParseIPLiteralToNumber("::", &ip));
 
+  if (FLAGS_num_workers > 1) {
+    net::QuicConfig config;
+    config.SetDefaults();
+    config.set_initial_round_trip_time_us(net::kMaxInitialRoundTripTimeUs, 0);
+    config.set_server_initial_congestion_window(net::kMaxInitialWindow,
+                                                net::kDefaultInitialWindow);
+    net::tools::QuicMultiWorkerServer server(
+        config, net::QuicSupportedVersions(), FLAGS_num_workers);
+    if (!server.Listen(net::IPEndPoint(ip, FLAGS_port))) {
+      return 1;
+    }
+    // The workers run until the process is killed.
+    while (1) {
+      pause();
+    }
+  }
+
   net::tools::QuicServer server;
 
   if (!server.Listen(net::IPEndPoint(ip, FLAGS_port))) {
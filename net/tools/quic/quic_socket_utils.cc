@@ -22,6 +22,126 @@
 namespace net {
 namespace tools {
 
+namespace {
+
+const size_t kSpaceForOverflowAndIp =
+    CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(in6_pktinfo));
+
+const size_t kSpaceForIpv4 = CMSG_SPACE(sizeof(in_pktinfo));
+const size_t kSpaceForIpv6 = CMSG_SPACE(sizeof(in6_pktinfo));
+// kSpaceForIp should be big enough to hold both IPv4 and IPv6 packet info.
+const size_t kSpaceForIp =
+    (kSpaceForIpv4 < kSpaceForIpv6) ? kSpaceForIpv6 : kSpaceForIpv4;
+
+// Sets up |hdr| to read a packet into |buffer|, and its addresses into
+// |raw_address| and |cbuf|, which must be kSpaceForOverflowAndIp long.
+void InitReadMsghdr(char* buffer, size_t buf_len, char* cbuf, iovec* iov,
+                    sockaddr_storage* raw_address, msghdr* hdr) {
+  memset(cbuf, 0, kSpaceForOverflowAndIp);
+  iov->iov_base = buffer;
+  iov->iov_len = buf_len;
+
+  hdr->msg_name = raw_address;
+  hdr->msg_namelen = sizeof(sockaddr_storage);
+  hdr->msg_iov = iov;
+  hdr->msg_iovlen = 1;
+  hdr->msg_flags = 0;
+
+  struct cmsghdr *cmsg = (struct cmsghdr *) cbuf;
+  cmsg->cmsg_len = kSpaceForOverflowAndIp;
+  hdr->msg_control = cmsg;
+  hdr->msg_controllen = kSpaceForOverflowAndIp;
+}
+
+// Extracts the dropped packet count and the addresses of a packet read with
+// a msghdr set up by InitReadMsghdr().
+void GetPacketInfoFromMsghdr(msghdr* hdr,
+                             const sockaddr_storage& raw_address,
+                             uint32* dropped_packets,
+                             IPAddressNumber* self_address,
+                             IPEndPoint* peer_address) {
+  if (dropped_packets != NULL) {
+    QuicSocketUtils::GetOverflowFromMsghdr(hdr, dropped_packets);
+  }
+  if (self_address != NULL) {
+    *self_address = QuicSocketUtils::GetAddressFromMsghdr(hdr);
+  }
+
+  if (raw_address.ss_family == AF_INET) {
+    CHECK(peer_address->FromSockAddr(
+        reinterpret_cast<const sockaddr*>(&raw_address),
+        sizeof(struct sockaddr_in)));
+  } else if (raw_address.ss_family == AF_INET6) {
+    CHECK(peer_address->FromSockAddr(
+        reinterpret_cast<const sockaddr*>(&raw_address),
+        sizeof(struct sockaddr_in6)));
+  }
+}
+
+// Sets up |hdr| to write |buffer| from |self_address| to |peer_address|.
+// |cbuf| must be kSpaceForIp long.
+void InitWriteMsghdr(const char* buffer,
+                     size_t buf_len,
+                     const IPAddressNumber& self_address,
+                     const IPEndPoint& peer_address,
+                     char* cbuf,
+                     iovec* iov,
+                     sockaddr_storage* raw_address,
+                     msghdr* hdr) {
+  socklen_t address_len = sizeof(*raw_address);
+  CHECK(peer_address.ToSockAddr(
+      reinterpret_cast<struct sockaddr*>(raw_address),
+      &address_len));
+  iov->iov_base = const_cast<char*>(buffer);
+  iov->iov_len = buf_len;
+
+  hdr->msg_name = raw_address;
+  hdr->msg_namelen = address_len;
+  hdr->msg_iov = iov;
+  hdr->msg_iovlen = 1;
+  hdr->msg_flags = 0;
+
+  if (self_address.empty()) {
+    hdr->msg_control = 0;
+    hdr->msg_controllen = 0;
+  } else if (GetAddressFamily(self_address) == ADDRESS_FAMILY_IPV4) {
+    hdr->msg_control = cbuf;
+    hdr->msg_controllen = kSpaceForIp;
+    cmsghdr* cmsg = CMSG_FIRSTHDR(hdr);
+
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+    cmsg->cmsg_level = IPPROTO_IP;
+    cmsg->cmsg_type = IP_PKTINFO;
+    in_pktinfo* pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
+    memset(pktinfo, 0, sizeof(in_pktinfo));
+    pktinfo->ipi_ifindex = 0;
+    memcpy(&pktinfo->ipi_spec_dst, &self_address[0], self_address.size());
+    hdr->msg_controllen = cmsg->cmsg_len;
+  } else {
+    hdr->msg_control = cbuf;
+    hdr->msg_controllen = kSpaceForIp;
+    cmsghdr* cmsg = CMSG_FIRSTHDR(hdr);
+
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
+    cmsg->cmsg_level = IPPROTO_IPV6;
+    cmsg->cmsg_type = IPV6_PKTINFO;
+    in6_pktinfo* pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
+    memset(pktinfo, 0, sizeof(in6_pktinfo));
+    memcpy(&pktinfo->ipi6_addr, &self_address[0], self_address.size());
+    hdr->msg_controllen = cmsg->cmsg_len;
+  }
+}
+
+}  // namespace
+
+// static
+const size_t QuicSocketUtils::kMaxPacketsPerMmsgCall;
+
+QuicSocketUtils::Packet::Packet()
+    : buffer(NULL),
+      length(0) {
+}
+
 // static
 IPAddressNumber QuicSocketUtils::GetAddressFromMsghdr(struct msghdr *hdr) {
   if (hdr->msg_controllen > 0) {
@@ -85,25 +205,11 @@ int QuicSocketUtils::ReadPacket(int fd, char* buffer, size_t buf_len,
                                 IPAddressNumber* self_address,
                                 IPEndPoint* peer_address) {
   CHECK(peer_address != NULL);
-  const int kSpaceForOverflowAndIp =
-      CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(in6_pktinfo));
   char cbuf[kSpaceForOverflowAndIp];
-  memset(cbuf, 0, arraysize(cbuf));
-
-  iovec iov = {buffer, buf_len};
-  struct sockaddr_storage raw_address;
+  iovec iov;
+  sockaddr_storage raw_address;
   msghdr hdr;
-
-  hdr.msg_name = &raw_address;
-  hdr.msg_namelen = sizeof(sockaddr_storage);
-  hdr.msg_iov = &iov;
-  hdr.msg_iovlen = 1;
-  hdr.msg_flags = 0;
-
-  struct cmsghdr *cmsg = (struct cmsghdr *) cbuf;
-  cmsg->cmsg_len = arraysize(cbuf);
-  hdr.msg_control = cmsg;
-  hdr.msg_controllen = arraysize(cbuf);
+  InitReadMsghdr(buffer, buf_len, cbuf, &iov, &raw_address, &hdr);
 
   int bytes_read = recvmsg(fd, &hdr, 0);
 
@@ -116,24 +222,41 @@ int QuicSocketUtils::ReadPacket(int fd, char* buffer, size_t buf_len,
     return -1;
   }
 
-  if (dropped_packets != NULL) {
-    GetOverflowFromMsghdr(&hdr, dropped_packets);
-  }
-  if (self_address != NULL) {
-    *self_address = QuicSocketUtils::GetAddressFromMsghdr(&hdr);
+  GetPacketInfoFromMsghdr(&hdr, raw_address, dropped_packets, self_address,
+                          peer_address);
+  return bytes_read;
+}
+
+// static
+int QuicSocketUtils::ReadPackets(int fd, Packet* packets, size_t num_packets,
+                                 uint32* dropped_packets) {
+  DCHECK_LE(num_packets, kMaxPacketsPerMmsgCall);
+  char cbufs[kMaxPacketsPerMmsgCall][kSpaceForOverflowAndIp];
+  iovec iovs[kMaxPacketsPerMmsgCall];
+  sockaddr_storage raw_addresses[kMaxPacketsPerMmsgCall];
+  mmsghdr hdrs[kMaxPacketsPerMmsgCall];
+  for (size_t i = 0; i < num_packets; ++i) {
+    InitReadMsghdr(packets[i].buffer, packets[i].length, cbufs[i], &iovs[i],
+                   &raw_addresses[i], &hdrs[i].msg_hdr);
+    hdrs[i].msg_len = 0;
   }
 
-  if (raw_address.ss_family == AF_INET) {
-    CHECK(peer_address->FromSockAddr(
-        reinterpret_cast<const sockaddr*>(&raw_address),
-        sizeof(struct sockaddr_in)));
-  } else if (raw_address.ss_family == AF_INET6) {
-    CHECK(peer_address->FromSockAddr(
-        reinterpret_cast<const sockaddr*>(&raw_address),
-        sizeof(struct sockaddr_in6)));
+  int packets_read = recvmmsg(fd, hdrs, num_packets, 0, NULL);
+  if (packets_read <= 0) {
+    if (packets_read < 0 && errno != EAGAIN && errno != ENOSYS) {
+      LOG(ERROR) << "Error reading " << strerror(errno);
+    }
+    return -1;
   }
 
-  return bytes_read;
+  for (int i = 0; i < packets_read; ++i) {
+    packets[i].length = hdrs[i].msg_len;
+    // The overflow count is cumulative, so the last packet's is the latest.
+    GetPacketInfoFromMsghdr(&hdrs[i].msg_hdr, raw_addresses[i],
+                            dropped_packets, &packets[i].self_address,
+                            &packets[i].peer_address);
+  }
+  return packets_read;
 }
 
 // static
@@ -143,57 +266,38 @@ WriteResult QuicSocketUtils::WritePacket(int fd,
                                          const IPAddressNumber& self_address,
                                          const IPEndPoint& peer_address) {
   sockaddr_storage raw_address;
-  socklen_t address_len = sizeof(raw_address);
-  CHECK(peer_address.ToSockAddr(
-      reinterpret_cast<struct sockaddr*>(&raw_address),
-      &address_len));
-  iovec iov = {const_cast<char*>(buffer), buf_len};
-
-  msghdr hdr;
-  hdr.msg_name = &raw_address;
-  hdr.msg_namelen = address_len;
-  hdr.msg_iov = &iov;
-  hdr.msg_iovlen = 1;
-  hdr.msg_flags = 0;
-
-  const int kSpaceForIpv4 = CMSG_SPACE(sizeof(in_pktinfo));
-  const int kSpaceForIpv6 = CMSG_SPACE(sizeof(in6_pktinfo));
-  // kSpaceForIp should be big enough to hold both IPv4 and IPv6 packet info.
-  const int kSpaceForIp =
-      (kSpaceForIpv4 < kSpaceForIpv6) ? kSpaceForIpv6 : kSpaceForIpv4;
+  iovec iov;
   char cbuf[kSpaceForIp];
-  if (self_address.empty()) {
-    hdr.msg_control = 0;
-    hdr.msg_controllen = 0;
-  } else if (GetAddressFamily(self_address) == ADDRESS_FAMILY_IPV4) {
-    hdr.msg_control = cbuf;
-    hdr.msg_controllen = kSpaceForIp;
-    cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+  msghdr hdr;
+  InitWriteMsghdr(buffer, buf_len, self_address, peer_address, cbuf, &iov,
+                  &raw_address, &hdr);
 
-    cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
-    cmsg->cmsg_level = IPPROTO_IP;
-    cmsg->cmsg_type = IP_PKTINFO;
-    in_pktinfo* pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
-    memset(pktinfo, 0, sizeof(in_pktinfo));
-    pktinfo->ipi_ifindex = 0;
-    memcpy(&pktinfo->ipi_spec_dst, &self_address[0], self_address.size());
-    hdr.msg_controllen = cmsg->cmsg_len;
-  } else {
-    hdr.msg_control = cbuf;
-    hdr.msg_controllen = kSpaceForIp;
-    cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+  int rc = sendmsg(fd, &hdr, 0);
+  if (rc >= 0) {
+    return WriteResult(WRITE_STATUS_OK, rc);
+  }
+  return WriteResult((errno == EAGAIN || errno == EWOULDBLOCK) ?
+      WRITE_STATUS_BLOCKED : WRITE_STATUS_ERROR, errno);
+}
 
-    cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
-    cmsg->cmsg_level = IPPROTO_IPV6;
-    cmsg->cmsg_type = IPV6_PKTINFO;
-    in6_pktinfo* pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
-    memset(pktinfo, 0, sizeof(in6_pktinfo));
-    memcpy(&pktinfo->ipi6_addr, &self_address[0], self_address.size());
-    hdr.msg_controllen = cmsg->cmsg_len;
+// static
+WriteResult QuicSocketUtils::WritePackets(int fd,
+                                          const Packet* packets,
+                                          size_t num_packets) {
+  DCHECK_LE(num_packets, kMaxPacketsPerMmsgCall);
+  sockaddr_storage raw_addresses[kMaxPacketsPerMmsgCall];
+  iovec iovs[kMaxPacketsPerMmsgCall];
+  char cbufs[kMaxPacketsPerMmsgCall][kSpaceForIp];
+  mmsghdr hdrs[kMaxPacketsPerMmsgCall];
+  for (size_t i = 0; i < num_packets; ++i) {
+    InitWriteMsghdr(packets[i].buffer, packets[i].length,
+                    packets[i].self_address, packets[i].peer_address,
+                    cbufs[i], &iovs[i], &raw_addresses[i], &hdrs[i].msg_hdr);
+    hdrs[i].msg_len = 0;
   }
 
-  int rc = sendmsg(fd, &hdr, 0);
-  if (rc >= 0) {
+  int rc = sendmmsg(fd, hdrs, num_packets, 0);
+  if (rc > 0) {
     return WriteResult(WRITE_STATUS_OK, rc);
   }
   return WriteResult((errno == EAGAIN || errno == EWOULDBLOCK) ?
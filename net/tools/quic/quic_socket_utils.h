@@ -19,6 +19,23 @@ namespace tools {
 
 class QuicSocketUtils {
  public:
+  // The most packets read or written by one ReadPackets() or WritePackets()
+  // call.
+  static const size_t kMaxPacketsPerMmsgCall = 16;
+
+  // A packet for ReadPackets() and WritePackets().
+  struct Packet {
+    Packet();
+
+    char* buffer;
+    // For reads, the size of |buffer| before the call and the number of bytes
+    // read after it. For writes, the number of bytes to write.
+    size_t length;
+    // The address the packet was sent to, or is sent from.
+    IPAddressNumber self_address;
+    IPEndPoint peer_address;
+  };
+
   // If the msghdr contains IP_PKTINFO or IPV6_PKTINFO, this will return the
   // IPAddressNumber in that header.  Returns an uninitialized IPAddress on
   // failure.
@@ -47,6 +64,15 @@ class QuicSocketUtils {
                         IPAddressNumber* self_address,
                         IPEndPoint* peer_address);
 
+  // Reads up to |num_packets| packets with a single recvmmsg call, filling in
+  // |packets| in order.  Returns the number of packets read, or -1 if none
+  // were read, in which case errno is ENOSYS if the kernel lacks recvmmsg.
+  // |num_packets| must be at most kMaxPacketsPerMmsgCall.
+  //
+  // If dropped_packets is non-null, it is set as by ReadPacket().
+  static int ReadPackets(int fd, Packet* packets, size_t num_packets,
+                         uint32* dropped_packets);
+
   // Writes buf_len to the socket. If writing is successful, sets the result's
   // status to WRITE_STATUS_OK and sets bytes_written.  Otherwise sets the
   // result's status to WRITE_STATUS_BLOCKED or WRITE_STATUS_ERROR and sets
@@ -54,6 +80,14 @@ class QuicSocketUtils {
   static WriteResult WritePacket(int fd, const char* buffer, size_t buf_len,
                                  const IPAddressNumber& self_address,
                                  const IPEndPoint& peer_address);
+
+  // Writes up to |num_packets| packets with a single sendmmsg call.  If any
+  // packet is written, sets the result's status to WRITE_STATUS_OK and
+  // bytes_written to the number of packets written.  Otherwise returns the
+  // same errors as WritePacket().  |num_packets| must be at most
+  // kMaxPacketsPerMmsgCall.
+  static WriteResult WritePackets(int fd, const Packet* packets,
+                                  size_t num_packets);
 };
 
 }  // namespace tools
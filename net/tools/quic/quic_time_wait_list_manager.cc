@@ -115,8 +115,11 @@ void QuicTimeWaitListManager::AddGuidToTimeWait(
     delete it->second.close_packet;
     guid_map_.erase(it);
   }
-  GuidData data(num_packets, version, clock_.ApproximateNow(), close_packet);
+  QuicTime now = clock_.ApproximateNow();
+  GuidData data(version, now, close_packet);
+  data.num_packets = num_packets;
   guid_map_.insert(make_pair(guid, data));
+  guid_expiry_queue_.push_back(make_pair(guid, now));
 }
 
 bool QuicTimeWaitListManager::IsGuidInTimeWait(QuicGuid guid) const {
@@ -231,8 +234,8 @@ bool QuicTimeWaitListManager::WriteToWire(QueuedPacket* queued_packet) {
 void QuicTimeWaitListManager::SetGuidCleanUpAlarm() {
   guid_clean_up_alarm_->UnregisterIfRegistered();
   int64 next_alarm_interval;
-  if (!guid_map_.empty()) {
-    QuicTime oldest_guid = guid_map_.begin()->second.time_added;
+  if (!guid_expiry_queue_.empty()) {
+    QuicTime oldest_guid = guid_expiry_queue_.front().second;
     QuicTime now = clock_.ApproximateNow();
     if (now.Subtract(oldest_guid) < kTimeWaitPeriod_) {
       next_alarm_interval = oldest_guid.Add(kTimeWaitPeriod_)
@@ -253,15 +256,19 @@ void QuicTimeWaitListManager::SetGuidCleanUpAlarm() {
 
 void QuicTimeWaitListManager::CleanUpOldGuids() {
   QuicTime now = clock_.ApproximateNow();
-  while (!guid_map_.empty()) {
-    GuidMap::iterator it = guid_map_.begin();
-    QuicTime oldest_guid = it->second.time_added;
-    if (now.Subtract(oldest_guid) < kTimeWaitPeriod_) {
+  while (!guid_expiry_queue_.empty()) {
+    const GuidAddition& oldest = guid_expiry_queue_.front();
+    if (now.Subtract(oldest.second) < kTimeWaitPeriod_) {
       break;
     }
-    // This guid has lived its age, retire it now.
-    delete it->second.close_packet;
-    guid_map_.erase(it);
+    // This guid has lived its age, retire it now, unless it was added again
+    // since.
+    GuidMap::iterator it = guid_map_.find(oldest.first);
+    if (it != guid_map_.end() && it->second.time_added == oldest.second) {
+      delete it->second.close_packet;
+      guid_map_.erase(it);
+    }
+    guid_expiry_queue_.pop_front();
   }
   SetGuidCleanUpAlarm();
 }
@@ -9,11 +9,11 @@
 #define NET_TOOLS_QUIC_QUIC_TIME_WAIT_LIST_MANAGER_H_
 
 #include <deque>
+#include <utility>
 
 #include "base/basictypes.h"
 #include "base/containers/hash_tables.h"
 #include "base/strings/string_piece.h"
-#include "net/base/linked_hash_map.h"
 #include "net/quic/quic_blocked_writer_interface.h"
 #include "net/quic/quic_framer.h"
 #include "net/quic/quic_packet_writer.h"
@@ -115,26 +115,34 @@ class QuicTimeWaitListManager : public QuicBlockedWriterInterface {
   // Register the alarm with the epoll server to wake up at appropriate time.
   void SetGuidCleanUpAlarm();
 
-  // A map from a recently closed guid to the number of packets received after
-  // the termination of the connection bound to the guid.
+  // The state kept for a recently closed guid.  Most guids in time wait were
+  // never established (or were rejected) and have no close packet, so this is
+  // kept small: public resets are built on demand from the shared framer code
+  // rather than stored per guid.
   struct GuidData {
-    GuidData(int num_packets_,
-             QuicVersion version_,
+    GuidData(QuicVersion version_,
              QuicTime time_added_,
              QuicEncryptedPacket* close_packet)
-        : num_packets(num_packets_),
+        : num_packets(0),
           version(version_),
           time_added(time_added_),
           close_packet(close_packet) {}
+    // The number of packets received after the termination of the connection
+    // bound to the guid.
     int num_packets;
     QuicVersion version;
     QuicTime time_added;
     QuicEncryptedPacket* close_packet;
   };
 
-  // linked_hash_map allows lookup by Guid and traversal in add order.
-  typedef linked_hash_map<QuicGuid, GuidData> GuidMap;
+  // A guid and the time it was added to the list, in the order of addition.
+  // A guid which is re-added has a stale entry with an older time, which is
+  // ignored when it expires.
+  typedef std::pair<QuicGuid, QuicTime> GuidAddition;
+
+  typedef base::hash_map<QuicGuid, GuidData> GuidMap;
   GuidMap guid_map_;
+  std::deque<GuidAddition> guid_expiry_queue_;
 
   // Pending public reset packets that need to be sent out to the client
   // when we are given a chance to write by the dispatcher.
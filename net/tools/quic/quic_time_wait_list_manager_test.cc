@@ -392,6 +392,28 @@ TEST_F(QuicTimeWaitListManagerTest, AddGuidTwice) {
   EXPECT_FALSE(IsGuidInTimeWait(guid_));
 }
 
+TEST_F(QuicTimeWaitListManagerTest, ReaddedGuidExpiresFromLastAddition) {
+  const QuicTime::Delta time_wait_period =
+      QuicTimeWaitListManagerPeer::time_wait_period(&time_wait_list_manager_);
+  epoll_server_.set_now_in_usec(0);
+  AddGuid(guid_);
+  const int64 kReaddTimeUs = 100;
+  epoll_server_.set_now_in_usec(kReaddTimeUs);
+  AddGuid(guid_);
+
+  // The first addition has expired, but the second has not.
+  epoll_server_.set_now_in_usec(time_wait_period.ToMicroseconds() + 1);
+  EXPECT_CALL(epoll_server_, RegisterAlarm(_, _));
+  time_wait_list_manager_.CleanUpOldGuids();
+  EXPECT_TRUE(IsGuidInTimeWait(guid_));
+
+  epoll_server_.set_now_in_usec(
+      time_wait_period.ToMicroseconds() + kReaddTimeUs);
+  EXPECT_CALL(epoll_server_, RegisterAlarm(_, _));
+  time_wait_list_manager_.CleanUpOldGuids();
+  EXPECT_FALSE(IsGuidInTimeWait(guid_));
+}
+
 TEST_F(QuicTimeWaitListManagerTest, GuidsOrderedByTime) {
   // Simple randomization: the values of guids are swapped based on the current
   // seconds on the clock. If the container is broken, the test will be 50%
@@ -31,12 +31,24 @@ QuicPacketWriterWrapper* QuicDispatcherPeer::GetWriter(
   return dispatcher->writer_.get();
 }
 
+// static
+QuicTimeWaitListManager* QuicDispatcherPeer::GetTimeWaitListManager(
+    QuicDispatcher* dispatcher) {
+  return dispatcher->time_wait_list_manager_.get();
+}
+
 // static
 QuicEpollConnectionHelper* QuicDispatcherPeer::GetHelper(
     QuicDispatcher* dispatcher) {
   return dispatcher->helper_.get();
 }
 
+// static
+void QuicDispatcherPeer::SetMaxSessionsWithoutToken(QuicDispatcher* dispatcher,
+                                                    size_t max_sessions) {
+  dispatcher->max_sessions_without_token_ = max_sessions;
+}
+
 }  // namespace test
 }  // namespace tools
 }  // namespace net
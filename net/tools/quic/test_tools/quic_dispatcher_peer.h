@@ -27,7 +27,13 @@ class QuicDispatcherPeer {
 
   static QuicPacketWriterWrapper* GetWriter(QuicDispatcher* dispatcher);
 
+  static QuicTimeWaitListManager* GetTimeWaitListManager(
+      QuicDispatcher* dispatcher);
+
   static QuicEpollConnectionHelper* GetHelper(QuicDispatcher* dispatcher);
+
+  static void SetMaxSessionsWithoutToken(QuicDispatcher* dispatcher,
+                                         size_t max_sessions);
 };
 
 }  // namespace test
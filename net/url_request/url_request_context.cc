@@ -31,6 +31,7 @@ URLRequestContext::URLRequestContext()
       http_transaction_factory_(NULL),
       job_factory_(NULL),
       throttler_manager_(NULL),
+      network_quality_estimator_(NULL),
       url_requests_(new std::set<const URLRequest*>) {
 }
 
@@ -56,6 +57,7 @@ void URLRequestContext::CopyFrom(const URLRequestContext* other) {
   set_http_transaction_factory(other->http_transaction_factory_);
   set_job_factory(other->job_factory_);
   set_throttler_manager(other->throttler_manager_);
+  set_network_quality_estimator(other->network_quality_estimator_);
   set_http_user_agent_settings(other->http_user_agent_settings_);
 }
 
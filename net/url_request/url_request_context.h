@@ -36,6 +36,7 @@ class HttpAuthHandlerFactory;
 class HttpTransactionFactory;
 class HttpUserAgentSettings;
 class NetworkDelegate;
+class NetworkQualityEstimator;
 class ServerBoundCertService;
 class ProxyService;
 class URLRequest;
@@ -180,6 +181,15 @@ class NET_EXPORT URLRequestContext
     throttler_manager_ = throttler_manager;
   }
 
+  // May be NULL.
+  NetworkQualityEstimator* network_quality_estimator() const {
+    return network_quality_estimator_;
+  }
+  void set_network_quality_estimator(
+      NetworkQualityEstimator* network_quality_estimator) {
+    network_quality_estimator_ = network_quality_estimator;
+  }
+
   // Gets the URLRequest objects that hold a reference to this
   // URLRequestContext.
   std::set<const URLRequest*>* url_requests() const {
@@ -223,6 +233,7 @@ class NET_EXPORT URLRequestContext
   HttpTransactionFactory* http_transaction_factory_;
   const URLRequestJobFactory* job_factory_;
   URLRequestThrottlerManager* throttler_manager_;
+  NetworkQualityEstimator* network_quality_estimator_;
 
   // ---------------------------------------------------------------------------
   // Important: When adding any new members below, consider whether they need to
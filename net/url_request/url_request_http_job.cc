@@ -18,10 +18,12 @@
 #include "base/time/time.h"
 #include "net/base/host_port_pair.h"
 #include "net/base/load_flags.h"
+#include "net/base/load_timing_info.h"
 #include "net/base/mime_util.h"
 #include "net/base/net_errors.h"
 #include "net/base/net_util.h"
 #include "net/base/network_delegate.h"
+#include "net/base/network_quality_estimator.h"
 #include "net/base/sdch_manager.h"
 #include "net/cert/cert_status_flags.h"
 #include "net/cookies/cookie_monster.h"
@@ -301,6 +303,14 @@ void URLRequestHttpJob::NotifyHeadersComplete() {
                                           &response_adapter);
   }
 
+  NetworkQualityEstimator* estimator =
+      request_->context()->network_quality_estimator();
+  if (!is_cached_content_ && estimator) {
+    LoadTimingInfo load_timing_info;
+    GetLoadTimingInfo(&load_timing_info);
+    estimator->NotifyHeadersReceived(request_info_.url, load_timing_info);
+  }
+
   // The ordering of these calls is not important.
   ProcessStrictTransportSecurityHeader();
   ProcessPublicKeyPinsHeader();
@@ -495,14 +505,17 @@ void URLRequestHttpJob::AddExtraHeaders() {
     // easier to filter and analyze the streams to assure that a proxy has not
     // damaged these headers.  Some proxies deliberately corrupt Accept-Encoding
     // headers.
+    // Tell the server what compression formats we support.
+    std::string accept_encoding = "gzip,deflate";
+    if (Filter::lzma_enabled())
+      accept_encoding += ",lzma";
     if (!advertise_sdch) {
-      // Tell the server what compression formats we support (other than SDCH).
       request_info_.extra_headers.SetHeader(
-          HttpRequestHeaders::kAcceptEncoding, "gzip,deflate");
+          HttpRequestHeaders::kAcceptEncoding, accept_encoding);
     } else {
       // Include SDCH in acceptable list.
       request_info_.extra_headers.SetHeader(
-          HttpRequestHeaders::kAcceptEncoding, "gzip,deflate,sdch");
+          HttpRequestHeaders::kAcceptEncoding, accept_encoding + ",sdch");
       if (!avail_dictionaries.empty()) {
         request_info_.extra_headers.SetHeader(
             kAvailDictionaryHeader,
@@ -1457,6 +1470,15 @@ void URLRequestHttpJob::DoneWithRequest(CompletionCause reason) {
   if (reason == FINISHED) {
     request_->set_received_response_content_length(prefilter_bytes_read());
     RecordCompressionHistograms();
+
+    NetworkQualityEstimator* estimator =
+        request_->context()->network_quality_estimator();
+    if (!is_cached_content_ && estimator) {
+      LoadTimingInfo load_timing_info;
+      GetLoadTimingInfo(&load_timing_info);
+      estimator->NotifyRequestCompleted(request_info_.url, load_timing_info,
+                                        GetTotalReceivedBytes());
+    }
   }
 }
 
@@ -149,6 +149,10 @@ void URLRequestThrottlerEntry::DetachManager() {
   manager_ = NULL;
 }
 
+int URLRequestThrottlerEntry::GetFailureCount() const {
+  return GetBackoffEntry()->failure_count();
+}
+
 bool URLRequestThrottlerEntry::ShouldRejectRequest(
     const URLRequest& request) const {
   bool reject_request = false;
@@ -91,6 +91,9 @@ class NET_EXPORT URLRequestThrottlerEntry
   // Causes this entry to NULL its manager pointer.
   void DetachManager();
 
+  // Returns the number of consecutive failures counted towards back-off.
+  int GetFailureCount() const;
+
   // Implementation of URLRequestThrottlerEntryInterface.
   virtual bool ShouldRejectRequest(const URLRequest& request) const OVERRIDE;
   virtual int64 ReserveSendingTimeForNextRequest(
@@ -4,21 +4,39 @@
 
 #include "net/url_request/url_request_throttler_manager.h"
 
+#include <algorithm>
+#include <map>
+
 #include "base/logging.h"
 #include "base/metrics/field_trial.h"
 #include "base/metrics/histogram.h"
 #include "base/strings/string_util.h"
+#include "base/values.h"
 #include "net/base/net_log.h"
 #include "net/base/net_util.h"
 
 namespace net {
 
+namespace {
+
+// Back-off state of the entries of one origin, for GetInfoAsValue().
+struct OriginBackoffInfo {
+  OriginBackoffInfo()
+      : num_entries(0), num_entries_backing_off(0), max_failure_count(0) {}
+
+  int num_entries;
+  int num_entries_backing_off;
+  int max_failure_count;
+  base::TimeTicks release_time;
+};
+
+}  // namespace
+
 const unsigned int URLRequestThrottlerManager::kMaximumNumberOfEntries = 1500;
-const unsigned int URLRequestThrottlerManager::kRequestsBetweenCollecting = 200;
+const unsigned int URLRequestThrottlerManager::kEntriesCheckedPerRequest = 8;
 
 URLRequestThrottlerManager::URLRequestThrottlerManager()
-    : requests_since_last_gc_(0),
-      enable_thread_checks_(false),
+    : enable_thread_checks_(false),
       logged_for_localhost_disabled_(false),
       registered_from_thread_(base::kInvalidThreadId) {
   url_id_replacements_.ClearPassword();
@@ -46,6 +64,7 @@ URLRequestThrottlerManager::~URLRequestThrottlerManager() {
 
   // Delete all entries.
   url_entries_.clear();
+  url_id_queue_.clear();
 }
 
 scoped_refptr<URLRequestThrottlerEntryInterface>
@@ -55,11 +74,11 @@ scoped_refptr<URLRequestThrottlerEntryInterface>
   // Normalize the url.
   std::string url_id = GetIdFromUrl(url);
 
-  // Periodically garbage collect old entries.
-  GarbageCollectEntriesIfNecessary();
+  // Garbage collect some of the old entries.
+  GarbageCollectSomeEntries();
 
   // Find the entry in the map or create a new NULL entry.
-  scoped_refptr<URLRequestThrottlerEntry>& entry = url_entries_[url_id];
+  scoped_refptr<URLRequestThrottlerEntry>& entry = FindOrInsertEntry(url_id);
 
   // If the entry exists but could be garbage collected at this point, we
   // start with a fresh entry so that we possibly back off a bit less
@@ -119,10 +138,10 @@ void URLRequestThrottlerManager::OverrideEntryForTests(
   // Normalize the url.
   std::string url_id = GetIdFromUrl(url);
 
-  // Periodically garbage collect old entries.
-  GarbageCollectEntriesIfNecessary();
+  // Garbage collect some of the old entries.
+  GarbageCollectSomeEntries();
 
-  url_entries_[url_id] = entry;
+  FindOrInsertEntry(url_id) = entry;
 }
 
 void URLRequestThrottlerManager::EraseEntryForTests(const GURL& url) {
@@ -149,6 +168,43 @@ NetLog* URLRequestThrottlerManager::net_log() const {
   return net_log_.net_log();
 }
 
+base::Value* URLRequestThrottlerManager::GetInfoAsValue() const {
+  DCHECK(!enable_thread_checks_ || CalledOnValidThread());
+
+  std::map<std::string, OriginBackoffInfo> origins;
+  const base::TimeTicks now = base::TimeTicks::Now();
+  for (UrlEntryMap::const_iterator it = url_entries_.begin();
+       it != url_entries_.end(); ++it) {
+    const URLRequestThrottlerEntry* entry = it->second.get();
+    if (!entry || entry->GetFailureCount() == 0)
+      continue;
+    OriginBackoffInfo& info = origins[GURL(it->first).GetOrigin().spec()];
+    ++info.num_entries;
+    info.max_failure_count =
+        std::max(info.max_failure_count, entry->GetFailureCount());
+    base::TimeTicks release_time = entry->GetExponentialBackoffReleaseTime();
+    if (release_time > now)
+      ++info.num_entries_backing_off;
+    info.release_time = std::max(info.release_time, release_time);
+  }
+
+  base::ListValue* list = new base::ListValue();
+  for (std::map<std::string, OriginBackoffInfo>::const_iterator it =
+           origins.begin(); it != origins.end(); ++it) {
+    const OriginBackoffInfo& info = it->second;
+    base::DictionaryValue* dict = new base::DictionaryValue();
+    dict->SetString("origin", it->first);
+    dict->SetInteger("num_entries", info.num_entries);
+    dict->SetInteger("num_entries_backing_off", info.num_entries_backing_off);
+    dict->SetInteger("max_failure_count", info.max_failure_count);
+    int64 release_after_ms = (info.release_time - now).InMilliseconds();
+    dict->SetInteger("release_after_ms",
+                     static_cast<int>(std::max<int64>(0, release_after_ms)));
+    list->Append(dict);
+  }
+  return list;
+}
+
 void URLRequestThrottlerManager::OnIPAddressChanged() {
   OnNetworkChange();
 }
@@ -162,17 +218,59 @@ std::string URLRequestThrottlerManager::GetIdFromUrl(const GURL& url) const {
   if (!url.is_valid())
     return url.possibly_invalid_spec();
 
+  // A valid standard URL is canonical, so its ID can be cut out of its spec,
+  // without building a new GURL: everything up to the end of the path, less
+  // any username and password.
+  if (url.IsStandard()) {
+    const std::string& spec = url.spec();
+    const url_parse::Parsed& parsed = url.parsed_for_possibly_invalid_spec();
+    const url_parse::Component& last =
+        parsed.path.is_valid() ? parsed.path :
+        parsed.port.is_valid() ? parsed.port : parsed.host;
+    if (parsed.host.is_valid() && last.is_valid()) {
+      std::string id(spec, 0, parsed.scheme.end());
+      id.append("://");
+      id.append(spec, parsed.host.begin, last.end() - parsed.host.begin);
+      return StringToLowerASCII(id);
+    }
+  }
+
   GURL id = url.ReplaceComponents(url_id_replacements_);
   return StringToLowerASCII(id.spec()).c_str();
 }
 
-void URLRequestThrottlerManager::GarbageCollectEntriesIfNecessary() {
-  requests_since_last_gc_++;
-  if (requests_since_last_gc_ < kRequestsBetweenCollecting)
-    return;
-  requests_since_last_gc_ = 0;
+scoped_refptr<URLRequestThrottlerEntry>&
+    URLRequestThrottlerManager::FindOrInsertEntry(const std::string& url_id) {
+  std::pair<UrlEntryMap::iterator, bool> result = url_entries_.insert(
+      std::make_pair(url_id, scoped_refptr<URLRequestThrottlerEntry>()));
+  if (result.second)
+    url_id_queue_.push_back(url_id);
+  return result.first->second;
+}
 
-  GarbageCollectEntries();
+void URLRequestThrottlerManager::GarbageCollectSomeEntries() {
+  for (unsigned int i = 0;
+       i < kEntriesCheckedPerRequest && !url_id_queue_.empty(); ++i) {
+    std::string url_id;
+    url_id.swap(url_id_queue_.front());
+    url_id_queue_.pop_front();
+    UrlEntryMap::iterator it = url_entries_.find(url_id);
+    if (it == url_entries_.end())
+      continue;
+    if (!it->second.get() || it->second->IsEntryOutdated()) {
+      url_entries_.erase(it);
+      continue;
+    }
+    // Check it again once the rest of the queue has been checked.
+    url_id_queue_.push_back(url_id);
+  }
+
+  // In case something broke we want to make sure not to grow indefinitely.
+  while (url_entries_.size() > kMaximumNumberOfEntries) {
+    DCHECK(!url_id_queue_.empty());
+    url_entries_.erase(url_id_queue_.front());
+    url_id_queue_.pop_front();
+  }
 }
 
 void URLRequestThrottlerManager::GarbageCollectEntries() {
@@ -187,7 +285,8 @@ void URLRequestThrottlerManager::GarbageCollectEntries() {
 
   // In case something broke we want to make sure not to grow indefinitely.
   while (url_entries_.size() > kMaximumNumberOfEntries) {
-    url_entries_.erase(url_entries_.begin());
+    url_entries_.erase(url_id_queue_.front());
+    url_id_queue_.pop_front();
   }
 }
 
@@ -197,7 +296,7 @@ void URLRequestThrottlerManager::OnNetworkChange() {
   // inconsistent with new entries for the same URLs, but since what we
   // want is a clean slate for the new connection type, this is OK.
   url_entries_.clear();
-  requests_since_last_gc_ = 0;
+  url_id_queue_.clear();
 }
 
 }  // namespace net
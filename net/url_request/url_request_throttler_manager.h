@@ -5,11 +5,12 @@
 #ifndef NET_URL_REQUEST_URL_REQUEST_THROTTLER_MANAGER_H_
 #define NET_URL_REQUEST_URL_REQUEST_THROTTLER_MANAGER_H_
 
-#include <map>
+#include <deque>
 #include <set>
 #include <string>
 
 #include "base/basictypes.h"
+#include "base/containers/hash_tables.h"
 #include "base/memory/ref_counted.h"
 #include "base/threading/non_thread_safe.h"
 #include "base/threading/platform_thread.h"
@@ -18,6 +19,10 @@
 #include "net/url_request/url_request_throttler_entry.h"
 #include "url/gurl.h"
 
+namespace base {
+class Value;
+}
+
 namespace net {
 
 class BoundNetLog;
@@ -27,11 +32,12 @@ class NetLog;
 // in order to supervise traffic. URL requests for HTTP contents should
 // register their URLs in this manager on each request.
 //
-// URLRequestThrottlerManager maintains a map of URL IDs to URL request
-// throttler entries. It creates URL request throttler entries when new URLs
-// are registered, and does garbage collection from time to time in order to
-// clean out outdated entries. URL ID consists of lowercased scheme, host, port
-// and path. All URLs converted to the same ID will share the same entry.
+// URLRequestThrottlerManager maintains a hash table of URL IDs to URL request
+// throttler entries, bounded in size. It creates URL request throttler entries
+// when new URLs are registered, and checks a few of the oldest entries on each
+// request in order to clean out outdated entries. URL ID consists of
+// lowercased scheme, host, port and path. All URLs converted to the same ID
+// will share the same entry.
 class NET_EXPORT URLRequestThrottlerManager
     : NON_EXPORTED_BASE(public base::NonThreadSafe),
       public NetworkChangeNotifier::IPAddressObserver,
@@ -77,6 +83,10 @@ class NET_EXPORT URLRequestThrottlerManager
   void set_net_log(NetLog* net_log);
   NetLog* net_log() const;
 
+  // Returns a list describing the back-off state of each origin with entries
+  // which have seen failures, for net-internals. The caller takes ownership.
+  base::Value* GetInfoAsValue() const;
+
   // IPAddressObserver interface.
   virtual void OnIPAddressChanged() OVERRIDE;
 
@@ -91,12 +101,14 @@ class NET_EXPORT URLRequestThrottlerManager
   // transformation.
   std::string GetIdFromUrl(const GURL& url) const;
 
-  // Method that ensures the map gets cleaned from time to time. The period at
-  // which garbage collecting happens is adjustable with the
-  // kRequestBetweenCollecting constant.
-  void GarbageCollectEntriesIfNecessary();
+  // Method that ensures the map gets cleaned a little on each request, without
+  // going through all of it at once. It checks the kEntriesCheckedPerRequest
+  // oldest entries, erases those which are outdated and moves the others to
+  // the back of the queue, and then erases the oldest entries while there are
+  // too many.
+  void GarbageCollectSomeEntries();
 
-  // Method that does the actual work of garbage collecting.
+  // Method that garbage collects all outdated entries at once.
   void GarbageCollectEntries();
 
   // When we switch from online to offline or change IP addresses, we
@@ -114,29 +126,37 @@ class NET_EXPORT URLRequestThrottlerManager
  private:
   // From each URL we generate an ID composed of the scheme, host, port and path
   // that allows us to uniquely map an entry to it.
-  typedef std::map<std::string, scoped_refptr<URLRequestThrottlerEntry> >
+  typedef base::hash_map<std::string, scoped_refptr<URLRequestThrottlerEntry> >
       UrlEntryMap;
 
+  // IDs of the entries in the map, roughly oldest first. It may also hold IDs
+  // of entries which have since been erased, which are dropped when reached.
+  typedef std::deque<std::string> UrlIdQueue;
+
   // We maintain a set of hosts that have opted out of exponential
   // back-off throttling.
   typedef std::set<std::string> OptOutHosts;
 
   // Maximum number of entries that we are willing to collect in our map.
   static const unsigned int kMaximumNumberOfEntries;
-  // Number of requests that will be made between garbage collection.
-  static const unsigned int kRequestsBetweenCollecting;
+  // Number of entries checked for garbage collection on each request.
+  static const unsigned int kEntriesCheckedPerRequest;
+
+  // Returns the entry for |url_id| in the map, inserting a NULL entry if there
+  // is none.
+  scoped_refptr<URLRequestThrottlerEntry>& FindOrInsertEntry(
+      const std::string& url_id);
 
   // Map that contains a list of URL ID and their matching
   // URLRequestThrottlerEntry.
   UrlEntryMap url_entries_;
 
+  // Order in which GarbageCollectSomeEntries() goes through |url_entries_|.
+  UrlIdQueue url_id_queue_;
+
   // Set of hosts that have opted out.
   OptOutHosts opt_out_hosts_;
 
-  // This keeps track of how many requests have been made. Used with
-  // GarbageCollectEntries.
-  unsigned int requests_since_last_gc_;
-
   // Valid after construction.
   GURL::Replacements url_id_replacements_;
 
@@ -112,6 +112,9 @@ int WebSocketBasicStream::ReadFrames(ScopedVector<WebSocketFrame>* frames,
 
   // Run until socket stops giving us data or we get some frames.
   while (true) {
+    // Frames from the last read may still refer to |read_buffer_|.
+    if (!read_buffer_->HasOneRef())
+      read_buffer_ = new IOBufferWithSize(kReadBufferSize);
     // base::Unretained(this) here is safe because net::Socket guarantees not to
     // call any callbacks after Disconnect(), which we call from the
     // destructor. The caller of ReadFrames() is required to keep |frames|
@@ -245,7 +248,7 @@ int WebSocketBasicStream::HandleReadResult(
   if (result == 0)
     return ERR_CONNECTION_CLOSED;
   ScopedVector<WebSocketFrameChunk> frame_chunks;
-  if (!parser_.Decode(read_buffer_->data(), result, &frame_chunks))
+  if (!parser_.Decode(read_buffer_.get(), result, &frame_chunks))
     return WebSocketErrorToNetError(parser_.websocket_error());
   if (frame_chunks.empty())
     return ERR_IO_PENDING;
@@ -9,10 +9,21 @@
 #include "base/basictypes.h"
 #include "base/logging.h"
 #include "base/rand_util.h"
+#include "build/build_config.h"
 #include "net/base/big_endian.h"
 #include "net/base/io_buffer.h"
 #include "net/base/net_errors.h"
 
+#if defined(ARCH_CPU_X86_FAMILY) && \
+    (defined(__SSE2__) || defined(_M_X64) || \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define WEBSOCKET_MASK_USE_SSE2
+#include <emmintrin.h>
+#elif defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+#define WEBSOCKET_MASK_USE_NEON
+#include <arm_neon.h>
+#endif
+
 namespace {
 
 const uint8 kFinalBit = 0x80;
@@ -37,6 +48,37 @@ inline void MaskWebSocketFramePayloadByBytes(
   }
 }
 
+// Masks [|begin|, |end|) with |realigned_mask|, 16 bytes at a time, using
+// SIMD instructions where available. |realigned_mask| must be the mask for
+// the byte at |begin|. Returns the end of the masked data, which is less than
+// 16 bytes before |end|.
+inline char* MaskWebSocketFramePayloadByVectors(
+    const char* realigned_mask,
+    char* const begin,
+    char* const end) {
+  char* masked = begin;
+#if defined(WEBSOCKET_MASK_USE_SSE2) || defined(WEBSOCKET_MASK_USE_NEON)
+  static const int kVectorSize = 16;
+  uint32 mask_word;
+  memcpy(&mask_word, realigned_mask, sizeof(mask_word));
+#if defined(WEBSOCKET_MASK_USE_SSE2)
+  const __m128i vector_mask = _mm_set1_epi32(static_cast<int>(mask_word));
+  for (; end - masked >= kVectorSize; masked += kVectorSize) {
+    __m128i* const vector = reinterpret_cast<__m128i*>(masked);
+    _mm_storeu_si128(vector,
+                     _mm_xor_si128(_mm_loadu_si128(vector), vector_mask));
+  }
+#else
+  const uint8x16_t vector_mask = vreinterpretq_u8_u32(vdupq_n_u32(mask_word));
+  for (; end - masked >= kVectorSize; masked += kVectorSize) {
+    uint8_t* const vector = reinterpret_cast<uint8_t*>(masked);
+    vst1q_u8(vector, veorq_u8(vld1q_u8(vector), vector_mask));
+  }
+#endif
+#endif  // defined(WEBSOCKET_MASK_USE_SSE2) || defined(WEBSOCKET_MASK_USE_NEON)
+  return masked;
+}
+
 }  // Unnamed namespace.
 
 namespace net {
@@ -218,8 +260,14 @@ void MaskWebSocketFramePayload(const WebSocketMaskingKey& masking_key,
            kMaskingKeyLength);
   }
 
-  // The main loop.
-  for (char* merged = aligned_begin; merged != aligned_end;
+  // The main loop. Most of the buffer is masked with vector instructions
+  // where they are available, and the rest one word at a time. The data is
+  // word aligned, and the mask repeats every kMaskingKeyLength bytes, so
+  // |realigned_mask| is the mask at the start of every vector and word.
+  char* const vectors_end =
+      MaskWebSocketFramePayloadByVectors(realigned_mask, aligned_begin,
+                                         aligned_end);
+  for (char* merged = vectors_end; merged != aligned_end;
        merged += kPackedMaskKeySize) {
     // This is not quite standard-compliant C++. However, the standard-compliant
     // equivalent (using memcpy()) compiles to slower code using g++. In
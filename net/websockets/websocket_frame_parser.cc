@@ -29,13 +29,42 @@ const uint64 kMaxPayloadLengthWithoutExtendedLengthField = 125;
 const uint64 kPayloadLengthWithTwoByteExtendedLengthField = 126;
 const uint64 kPayloadLengthWithEightByteExtendedLengthField = 127;
 
+const size_t kMaximumFrameHeaderSize =
+    net::WebSocketFrameHeader::kBaseHeaderSize +
+    net::WebSocketFrameHeader::kMaximumExtendedLengthSize +
+    net::WebSocketFrameHeader::kMaskingKeyLength;
+
+// Payload chunks at least this large refer to the buffer passed to Decode()
+// instead of being copied. Smaller ones are cheap to copy, and not worth
+// keeping the whole buffer alive for.
+const size_t kMinPayloadSliceSize = 4096;
+
+// An IOBufferWithSize which refers to part of another IOBuffer, and keeps it
+// alive.
+class IOBufferSlice : public net::IOBufferWithSize {
+ public:
+  IOBufferSlice(net::IOBuffer* buffer, char* data, int size)
+      : net::IOBufferWithSize(data, size),
+        buffer_(buffer) {}
+
+ private:
+  virtual ~IOBufferSlice() {
+    // |data_| belongs to |buffer_|, so remove it before the base class
+    // destructor tries to delete[] it.
+    data_ = NULL;
+  }
+
+  scoped_refptr<net::IOBuffer> buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(IOBufferSlice);
+};
+
 }  // Unnamed namespace.
 
 namespace net {
 
 WebSocketFrameParser::WebSocketFrameParser()
-    : current_read_pos_(0),
-      frame_offset_(0),
+    : frame_offset_(0),
       websocket_error_(kWebSocketNormalClosure) {
   std::fill(masking_key_.key,
             masking_key_.key + WebSocketFrameHeader::kMaskingKeyLength,
@@ -48,66 +77,99 @@ bool WebSocketFrameParser::Decode(
     const char* data,
     size_t length,
     ScopedVector<WebSocketFrameChunk>* frame_chunks) {
+  return DecodeInternal(NULL, data, length, frame_chunks);
+}
+
+bool WebSocketFrameParser::Decode(
+    IOBuffer* buffer,
+    size_t length,
+    ScopedVector<WebSocketFrameChunk>* frame_chunks) {
+  return DecodeInternal(buffer, buffer->data(), length, frame_chunks);
+}
+
+bool WebSocketFrameParser::DecodeInternal(
+    IOBuffer* buffer,
+    const char* data,
+    size_t length,
+    ScopedVector<WebSocketFrameChunk>* frame_chunks) {
   if (websocket_error_ != kWebSocketNormalClosure)
     return false;
   if (!length)
     return true;
 
-  // TODO(yutak): Remove copy.
-  buffer_.insert(buffer_.end(), data, data + length);
-
-  while (current_read_pos_ < buffer_.size()) {
+  const char* current = data;
+  const char* const end = data + length;
+  while (current != end) {
     bool first_chunk = false;
     if (!current_frame_header_.get()) {
-      DecodeFrameHeader();
+      current += DecodeFrameHeader(current, end);
       if (websocket_error_ != kWebSocketNormalClosure)
         return false;
-      // If frame header is incomplete, then carry over the remaining
-      // data to the next round of Decode().
-      if (!current_frame_header_.get())
+      // If frame header is incomplete, then the remaining data has been
+      // carried over to the next round of Decode().
+      if (!current_frame_header_.get()) {
+        DCHECK(current == end);
         break;
+      }
       first_chunk = true;
     }
 
     scoped_ptr<WebSocketFrameChunk> frame_chunk =
-        DecodeFramePayload(first_chunk);
+        DecodeFramePayload(first_chunk, buffer, &current, end);
     DCHECK(frame_chunk.get());
     frame_chunks->push_back(frame_chunk.release());
 
     if (current_frame_header_.get()) {
-      DCHECK(current_read_pos_ == buffer_.size());
+      DCHECK(current == end);
       break;
     }
   }
 
-  // Drain unnecessary data. TODO(yutak): Remove copy. (but how?)
-  buffer_.erase(buffer_.begin(), buffer_.begin() + current_read_pos_);
-  current_read_pos_ = 0;
-
   // Sanity check: the size of carried-over data should not exceed
   // the maximum possible length of a frame header.
-  static const size_t kMaximumFrameHeaderSize =
-      WebSocketFrameHeader::kBaseHeaderSize +
-      WebSocketFrameHeader::kMaximumExtendedLengthSize +
-      WebSocketFrameHeader::kMaskingKeyLength;
   DCHECK_LT(buffer_.size(), kMaximumFrameHeaderSize);
 
   return true;
 }
 
-void WebSocketFrameParser::DecodeFrameHeader() {
+size_t WebSocketFrameParser::DecodeFrameHeader(const char* data,
+                                               const char* end) {
+  DCHECK(!current_frame_header_.get());
+
+  if (buffer_.empty()) {
+    size_t header_size = ParseFrameHeader(data, end);
+    if (header_size || websocket_error_ != kWebSocketNormalClosure)
+      return header_size;
+    // Carry over the incomplete header.
+    buffer_.assign(data, end);
+    return end - data;
+  }
+
+  // Complete the carried-over header with as much of |data| as a header
+  // could need.
+  const size_t carried_over_size = buffer_.size();
+  const size_t appended_size = std::min<size_t>(
+      end - data, kMaximumFrameHeaderSize - carried_over_size);
+  buffer_.insert(buffer_.end(), data, data + appended_size);
+  size_t header_size =
+      ParseFrameHeader(&buffer_.front(), &buffer_.front() + buffer_.size());
+  if (!header_size)
+    return websocket_error_ != kWebSocketNormalClosure ? 0 : appended_size;
+  DCHECK_GT(header_size, carried_over_size);
+  buffer_.clear();
+  return header_size - carried_over_size;
+}
+
+size_t WebSocketFrameParser::ParseFrameHeader(const char* start,
+                                              const char* end) {
   typedef WebSocketFrameHeader::OpCode OpCode;
   static const int kMaskingKeyLength = WebSocketFrameHeader::kMaskingKeyLength;
 
-  DCHECK(!current_frame_header_.get());
-
-  const char* start = &buffer_.front() + current_read_pos_;
   const char* current = start;
-  const char* end = &buffer_.front() + buffer_.size();
 
   // Header needs 2 bytes at minimum.
   if (end - current < 2)
-    return;
+    return 0;
 
   uint8 first_byte = *current++;
   uint8 second_byte = *current++;
@@ -122,7 +184,7 @@ void WebSocketFrameParser::DecodeFrameHeader() {
   uint64 payload_length = second_byte & kPayloadLengthMask;
   if (payload_length == kPayloadLengthWithTwoByteExtendedLengthField) {
     if (end - current < 2)
-      return;
+      return 0;
     uint16 payload_length_16;
     ReadBigEndian(current, &payload_length_16);
     current += 2;
@@ -131,7 +193,7 @@ void WebSocketFrameParser::DecodeFrameHeader() {
       websocket_error_ = kWebSocketErrorProtocolError;
   } else if (payload_length == kPayloadLengthWithEightByteExtendedLengthField) {
     if (end - current < 8)
-      return;
+      return 0;
     ReadBigEndian(current, &payload_length);
     current += 8;
     if (payload_length <= kuint16max ||
@@ -143,15 +205,14 @@ void WebSocketFrameParser::DecodeFrameHeader() {
   }
   if (websocket_error_ != kWebSocketNormalClosure) {
     buffer_.clear();
-    current_read_pos_ = 0;
     current_frame_header_.reset();
     frame_offset_ = 0;
-    return;
+    return 0;
   }
 
   if (masked) {
     if (end - current < kMaskingKeyLength)
-      return;
+      return 0;
     std::copy(current, current + kMaskingKeyLength, masking_key_.key);
     current += kMaskingKeyLength;
   } else {
@@ -165,16 +226,17 @@ void WebSocketFrameParser::DecodeFrameHeader() {
   current_frame_header_->reserved3 = reserved3;
   current_frame_header_->masked = masked;
   current_frame_header_->payload_length = payload_length;
-  current_read_pos_ += current - start;
   DCHECK_EQ(0u, frame_offset_);
+  return current - start;
 }
 
 scoped_ptr<WebSocketFrameChunk> WebSocketFrameParser::DecodeFramePayload(
-    bool first_chunk) {
-  const char* current = &buffer_.front() + current_read_pos_;
-  const char* end = &buffer_.front() + buffer_.size();
+    bool first_chunk,
+    IOBuffer* buffer,
+    const char** current,
+    const char* end) {
   uint64 next_size = std::min<uint64>(
-      end - current, current_frame_header_->payload_length - frame_offset_);
+      end - *current, current_frame_header_->payload_length - frame_offset_);
   // This check must pass because |payload_length| is already checked to be
   // less than std::numeric_limits<int>::max() when the header is parsed.
   DCHECK_LE(next_size, static_cast<uint64>(kint32max));
@@ -185,9 +247,16 @@ scoped_ptr<WebSocketFrameChunk> WebSocketFrameParser::DecodeFramePayload(
   }
   frame_chunk->final_chunk = false;
   if (next_size) {
-    frame_chunk->data = new IOBufferWithSize(static_cast<int>(next_size));
+    if (buffer && next_size >= kMinPayloadSliceSize) {
+      // |*current| points into |buffer|, which the caller lets us modify.
+      frame_chunk->data = new IOBufferSlice(buffer,
+                                            const_cast<char*>(*current),
+                                            static_cast<int>(next_size));
+    } else {
+      frame_chunk->data = new IOBufferWithSize(static_cast<int>(next_size));
+      memcpy(frame_chunk->data->data(), *current, next_size);
+    }
     char* io_data = frame_chunk->data->data();
-    memcpy(io_data, current, next_size);
     if (current_frame_header_->masked) {
       // The masking function is its own inverse, so we use the same function to
       // unmask as to mask.
@@ -195,7 +264,7 @@ scoped_ptr<WebSocketFrameChunk> WebSocketFrameParser::DecodeFramePayload(
           masking_key_, frame_offset_, io_data, next_size);
     }
 
-    current_read_pos_ += next_size;
+    *current += next_size;
     frame_offset_ += next_size;
   }
 
@@ -17,6 +17,8 @@
 
 namespace net {
 
+class IOBuffer;
+
 // Parses WebSocket frames from byte stream.
 //
 // Specification of WebSocket frame format is available at
@@ -40,6 +42,15 @@ class NET_EXPORT WebSocketFrameParser {
               size_t length,
               ScopedVector<WebSocketFrameChunk>* frame_chunks);
 
+  // Same as above, but decodes the first |length| bytes of |buffer|, and
+  // large payload chunks refer to |buffer| instead of being copied out of it.
+  // Masked payload is unmasked in place. The caller must not reuse |buffer|
+  // while any of the chunks still refers to it, which is the case unless
+  // |buffer| HasOneRef().
+  bool Decode(IOBuffer* buffer,
+              size_t length,
+              ScopedVector<WebSocketFrameChunk>* frame_chunks);
+
   // Returns kWebSocketNormalClosure if the parser has not failed to decode
   // WebSocket frames. Otherwise returns WebSocketError which is defined in
   // websocket_errors.h. We can convert net::WebSocketError to net::Error by
@@ -47,28 +58,43 @@ class NET_EXPORT WebSocketFrameParser {
   WebSocketError websocket_error() const { return websocket_error_; }
 
  private:
-  // Tries to decode a frame header from |current_read_pos_|.
-  // If successful, this function updates |current_read_pos_|,
-  // |current_frame_header_|, and |masking_key_| (if available).
-  // This function may set |failed_| to true if it observes a corrupt frame.
-  // If there is not enough data in the remaining buffer to parse a frame
-  // header, this function returns without doing anything.
-  void DecodeFrameHeader();
-
-  // Decodes frame payload and creates a WebSocketFrameChunk object.
-  // This function updates |current_read_pos_| and |frame_offset_| after
-  // parsing. This function returns a frame object even if no payload data is
-  // available at this moment, so the receiver could make use of frame header
-  // information. If the end of frame is reached, this function clears
-  // |current_frame_header_|, |frame_offset_| and |masking_key_|.
-  scoped_ptr<WebSocketFrameChunk> DecodeFramePayload(bool first_chunk);
-
-  // Internal buffer to store the data to parse.
+  // Implements both versions of Decode(). |buffer| is NULL if |data| needs to
+  // be copied, and otherwise holds |data|.
+  bool DecodeInternal(IOBuffer* buffer,
+                      const char* data,
+                      size_t length,
+                      ScopedVector<WebSocketFrameChunk>* frame_chunks);
+
+  // Tries to decode a frame header from the start of [|data|, |end|),
+  // preceded by any part of the header carried over in |buffer_|. Returns
+  // the number of bytes of |data| consumed. If successful, this function sets
+  // |current_frame_header_| and |masking_key_| (if available). Otherwise, if
+  // there is not enough data for a whole frame header, the data is carried
+  // over in |buffer_| to the next call. This function may set
+  // |websocket_error_| if it observes a corrupt frame.
+  size_t DecodeFrameHeader(const char* data, const char* end);
+
+  // Parses a frame header at the start of [|start|, |end|). Returns the size
+  // of the header, or 0 if the header is incomplete or invalid.
+  size_t ParseFrameHeader(const char* start, const char* end);
+
+  // Decodes frame payload at |*current| and creates a WebSocketFrameChunk
+  // object. If |buffer| is non-NULL, it holds |*current|, and the chunk may
+  // refer to it instead of copying the payload. This function advances
+  // |*current| and updates |frame_offset_| after parsing. This function
+  // returns a frame object even if no payload data is available at this
+  // moment, so the receiver could make use of frame header information. If the
+  // end of frame is reached, this function clears |current_frame_header_|,
+  // |frame_offset_| and |masking_key_|.
+  scoped_ptr<WebSocketFrameChunk> DecodeFramePayload(bool first_chunk,
+                                                     IOBuffer* buffer,
+                                                     const char** current,
+                                                     const char* end);
+
+  // Holds the beginning of a frame header which was split between calls to
+  // Decode().
   std::vector<char> buffer_;
 
-  // Position in |buffer_| where the next round of parsing starts.
-  size_t current_read_pos_;
-
   // Frame header and masking key of the current frame.
   // |masking_key_| is filled with zeros if the current frame is not masked.
   scoped_ptr<WebSocketFrameHeader> current_frame_header_;
@@ -380,7 +380,8 @@ class WebSocketFrameTestMaskBenchmark : public testing::Test {
         iterations_;
     LOG(INFO) << "Payload size " << size
               << base::StringPrintf(" took %.03f microseconds per iteration",
-                                    total_time_ms);
+                                    total_time_ms)
+              << base::StringPrintf(" (%.01f MB/s)", size / total_time_ms);
   }
 
  private:
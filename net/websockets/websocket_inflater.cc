@@ -245,7 +245,12 @@ void WebSocketInflater::InputQueue::Push(const char* data, size_t size) {
   while (num_copied_bytes < size) {
     DCHECK(IsEmpty() || tail_of_last_buffer_ == capacity_);
 
-    buffers_.push_back(new IOBufferWithSize(capacity_));
+    if (spare_buffer_) {
+      buffers_.push_back(spare_buffer_);
+      spare_buffer_ = NULL;
+    } else {
+      buffers_.push_back(new IOBufferWithSize(capacity_));
+    }
     tail_of_last_buffer_ = 0;
     num_copied_bytes +=
         PushToLastBuffer(&data[num_copied_bytes], size - num_copied_bytes);
@@ -258,10 +263,12 @@ void WebSocketInflater::InputQueue::Consume(size_t size) {
 
   head_of_first_buffer_ += size;
   if (head_of_first_buffer_ == capacity_) {
+    spare_buffer_ = buffers_.front();
     buffers_.pop_front();
     head_of_first_buffer_ = 0;
   }
   if (buffers_.size() == 1 && head_of_first_buffer_ == tail_of_last_buffer_) {
+    spare_buffer_ = buffers_.front();
     buffers_.pop_front();
     head_of_first_buffer_ = 0;
     tail_of_last_buffer_ = 0;
@@ -112,6 +112,9 @@ class NET_EXPORT_PRIVATE WebSocketInflater {
     size_t head_of_first_buffer_;
     size_t tail_of_last_buffer_;
     std::deque<scoped_refptr<IOBufferWithSize> > buffers_;
+    // The last buffer to be consumed, kept for reuse so that input which is
+    // repeatedly choked and drained does not allocate a buffer each time.
+    scoped_refptr<IOBufferWithSize> spare_buffer_;
   };
 
   int InflateWithFlush(const char* next_in, size_t avail_in);
@@ -1664,6 +1664,18 @@ IPC_MESSAGE_CONTROL1(PpapiPluginMsg_URLLoader_ReceivedResponse,
 // appended.
 IPC_MESSAGE_CONTROL0(PpapiPluginMsg_URLLoader_SendData)
 
+// Push notification that sets up a ppapi::SharedMemoryRing through which later
+// load data may be sent. The shared memory handle is passed in the reply
+// params.
+IPC_MESSAGE_CONTROL1(PpapiPluginMsg_URLLoader_InitDataRing,
+                     uint32_t /* shm_size */)
+
+// Push notification with load data that was written to the data ring set up
+// by PpapiPluginMsg_URLLoader_InitDataRing. Ordered like SendData.
+IPC_MESSAGE_CONTROL2(PpapiPluginMsg_URLLoader_SendDataInRing,
+                     uint32_t /* position */,
+                     uint32_t /* size */)
+
 // Push notification indicating that all data has been sent, either via
 // SendData or by streaming it to a file. Note that since this is a push
 // notification, we don't use the result field of the ResourceMessageReply.
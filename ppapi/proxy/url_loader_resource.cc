@@ -14,6 +14,7 @@
 #include "ppapi/proxy/url_request_info_resource.h"
 #include "ppapi/proxy/url_response_info_resource.h"
 #include "ppapi/shared_impl/ppapi_globals.h"
+#include "ppapi/shared_impl/shared_memory_ring.h"
 #include "ppapi/shared_impl/url_response_info_data.h"
 #include "ppapi/thunk/enter.h"
 #include "ppapi/thunk/resource_creation_api.h"
@@ -245,6 +246,12 @@ void URLLoaderResource::OnReplyReceived(
     PPAPI_DISPATCH_PLUGIN_RESOURCE_CALL(
         PpapiPluginMsg_URLLoader_ReceivedResponse,
         OnPluginMsgReceivedResponse)
+    PPAPI_DISPATCH_PLUGIN_RESOURCE_CALL(
+        PpapiPluginMsg_URLLoader_InitDataRing,
+        OnPluginMsgInitDataRing)
+    PPAPI_DISPATCH_PLUGIN_RESOURCE_CALL(
+        PpapiPluginMsg_URLLoader_SendDataInRing,
+        OnPluginMsgSendDataInRing)
     PPAPI_DISPATCH_PLUGIN_RESOURCE_CALL(
         PpapiPluginMsg_URLLoader_FinishedLoading,
         OnPluginMsgFinishedLoading)
@@ -272,9 +279,47 @@ void URLLoaderResource::OnPluginMsgSendData(
     return;
   }
 
+  AppendData(data, data_length);
+  DidAppendData();
+}
+
+void URLLoaderResource::OnPluginMsgInitDataRing(
+    const ResourceMessageReplyParams& params,
+    uint32_t shm_size) {
+  base::SharedMemoryHandle shm_handle = base::SharedMemory::NULLHandle();
+  if (!params.TakeSharedMemoryHandleAtIndex(0, &shm_handle)) {
+    NOTREACHED() << "Expecting shared memory handle";
+    return;
+  }
+  scoped_ptr<SharedMemoryRing> ring(new SharedMemoryRing);
+  if (ring->Init(scoped_ptr<base::SharedMemory>(
+                     new base::SharedMemory(shm_handle, false)),
+                 shm_size)) {
+    data_ring_ = ring.Pass();
+  }
+}
+
+void URLLoaderResource::OnPluginMsgSendDataInRing(
+    const ResourceMessageReplyParams& params,
+    uint32_t position,
+    uint32_t size) {
+  const char* data = data_ring_ ? data_ring_->GetChunk(position, size) : NULL;
+  if (!data) {
+    NOTREACHED() << "Expecting data in the data ring";
+    return;
+  }
+
+  AppendData(data, size);
+  data_ring_->Release(position, size);
+  DidAppendData();
+}
+
+void URLLoaderResource::AppendData(const char* data, size_t size) {
   mode_ = MODE_STREAMING_DATA;
-  buffer_.insert(buffer_.end(), data, data + data_length);
+  buffer_.insert(buffer_.end(), data, data + size);
+}
 
+void URLLoaderResource::DidAppendData() {
   // To avoid letting the network stack download an entire stream all at once,
   // defer loading when we have enough buffer.
   // Check for this before we run the callback, even though that could move
@@ -9,6 +9,7 @@
 
 #include "base/basictypes.h"
 #include "base/compiler_specific.h"
+#include "base/memory/scoped_ptr.h"
 #include "ppapi/c/trusted/ppb_url_loader_trusted.h"
 #include "ppapi/proxy/plugin_resource.h"
 #include "ppapi/proxy/ppapi_proxy_export.h"
@@ -16,6 +17,9 @@
 #include "ppapi/thunk/ppb_url_loader_api.h"
 
 namespace ppapi {
+
+class SharedMemoryRing;
+
 namespace proxy {
 
 class URLResponseInfoResource;
@@ -90,6 +94,11 @@ class PPAPI_PROXY_EXPORT URLLoaderResource
                                    const URLResponseInfoData& data);
   void OnPluginMsgSendData(const ResourceMessageReplyParams& params,
                            const IPC::Message& message);
+  void OnPluginMsgInitDataRing(const ResourceMessageReplyParams& params,
+                               uint32_t shm_size);
+  void OnPluginMsgSendDataInRing(const ResourceMessageReplyParams& params,
+                                 uint32_t position,
+                                 uint32_t size);
   void OnPluginMsgFinishedLoading(const ResourceMessageReplyParams& params,
                                   int32_t result);
   void OnPluginMsgUpdateProgress(const ResourceMessageReplyParams& params,
@@ -114,6 +123,11 @@ class PPAPI_PROXY_EXPORT URLLoaderResource
   // necessary. This does not issue any callbacks.
   void SaveResponseInfo(const URLResponseInfoData& data);
 
+  // Appends load data received from the renderer to |buffer_|. Call
+  // DidAppendData() afterwards; it may run the plugin's callback.
+  void AppendData(const char* data, size_t size);
+  void DidAppendData();
+
   size_t FillUserBuffer();
 
   Mode mode_;
@@ -124,6 +138,11 @@ class PPAPI_PROXY_EXPORT URLLoaderResource
   PP_URLLoaderTrusted_StatusCallback status_callback_;
 
   std::deque<char> buffer_;
+
+  // Shared memory through which the renderer sends large chunks of load data,
+  // if it set one up.
+  scoped_ptr<SharedMemoryRing> data_ring_;
+
   int64_t bytes_sent_;
   int64_t total_bytes_to_be_sent_;
   int64_t bytes_received_;
@@ -0,0 +1,103 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "ppapi/shared_impl/shared_memory_ring.h"
+
+#include <string.h>
+
+#include "base/logging.h"
+
+namespace ppapi {
+
+namespace {
+
+// Keeps the data, which starts after the header, cache line aligned.
+const uint32_t kHeaderSize = 64;
+
+bool IsPowerOfTwo(uint32_t value) {
+  return value && !(value & (value - 1));
+}
+
+}  // namespace
+
+SharedMemoryRing::SharedMemoryRing()
+    : header_(NULL),
+      data_(NULL),
+      capacity_(0),
+      write_position_(0) {
+  COMPILE_ASSERT(sizeof(Header) <= kHeaderSize, header_too_large);
+}
+
+SharedMemoryRing::~SharedMemoryRing() {
+}
+
+// static
+uint32_t SharedMemoryRing::GetSharedMemorySize(uint32_t capacity) {
+  DCHECK(IsPowerOfTwo(capacity));
+  return kHeaderSize + capacity;
+}
+
+bool SharedMemoryRing::Init(scoped_ptr<base::SharedMemory> shm,
+                            uint32_t size) {
+  DCHECK(shm);
+  DCHECK(!shm_);
+  if (size <= kHeaderSize || !IsPowerOfTwo(size - kHeaderSize))
+    return false;
+
+  shm_ = shm.Pass();
+  if (!shm_->Map(size))
+    return false;
+
+  char* memory = static_cast<char*>(shm_->memory());
+  header_ = reinterpret_cast<Header*>(memory);
+  data_ = memory + kHeaderSize;
+  capacity_ = size - kHeaderSize;
+  return true;
+}
+
+bool SharedMemoryRing::Write(const char* data,
+                             uint32_t size,
+                             uint32_t* position) {
+  if (!data_ || size == 0)
+    return false;
+
+  // The reader's release position lives in memory the other process can
+  // write, so don't trust it to be sane.
+  uint32_t read_position =
+      static_cast<uint32_t>(base::subtle::Acquire_Load(&header_->read_position));
+  uint32_t used = write_position_ - read_position;
+  if (used > capacity_)
+    return false;
+
+  uint32_t offset = write_position_ & (capacity_ - 1);
+  uint32_t padding = size > capacity_ - offset ? capacity_ - offset : 0;
+  uint32_t available = capacity_ - used;
+  if (size > available || padding > available - size)
+    return false;
+
+  uint32_t start = write_position_ + padding;
+  memcpy(data_ + (start & (capacity_ - 1)), data, size);
+  write_position_ = start + size;
+  *position = start;
+  return true;
+}
+
+const char* SharedMemoryRing::GetChunk(uint32_t position,
+                                       uint32_t size) const {
+  if (!data_ || size == 0 || size > capacity_)
+    return NULL;
+  uint32_t offset = position & (capacity_ - 1);
+  if (size > capacity_ - offset)
+    return NULL;
+  return data_ + offset;
+}
+
+void SharedMemoryRing::Release(uint32_t position, uint32_t size) {
+  DCHECK(data_);
+  base::subtle::Release_Store(&header_->read_position,
+                              static_cast<base::subtle::Atomic32>(
+                                  position + size));
+}
+
+}  // namespace ppapi
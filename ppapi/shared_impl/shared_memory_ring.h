@@ -0,0 +1,85 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef PPAPI_SHARED_IMPL_SHARED_MEMORY_RING_H_
+#define PPAPI_SHARED_IMPL_SHARED_MEMORY_RING_H_
+
+#include "base/atomicops.h"
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
+#include "ppapi/shared_impl/ppapi_shared_export.h"
+
+namespace ppapi {
+
+// A single-writer, single-reader ring of bytes in memory shared between the
+// renderer process and a plugin process, used to move bulk data without
+// serializing it into IPC messages.
+//
+// An example:
+//  1. The writer calls |Write()| to copy a chunk into the ring.
+//  2. The writer sends the chunk's position and size via an IPC message.
+//  3. The reader receives the message and calls |GetChunk()| to get at the
+//     data.
+//  4. When the chunk has been consumed, the reader calls |Release()|.
+//
+// The reader publishes its release position in the shared memory itself, so
+// no message needs to travel back to the writer. Chunks must be released in
+// the order they were written. Each chunk is stored contiguously; a chunk
+// that doesn't fit before the end of the ring starts at the beginning.
+class PPAPI_SHARED_EXPORT SharedMemoryRing {
+ public:
+  SharedMemoryRing();
+  ~SharedMemoryRing();
+
+  // Returns the size of the shared memory needed for a ring that can hold
+  // |capacity| bytes of data. |capacity| must be a power of two.
+  static uint32_t GetSharedMemorySize(uint32_t capacity);
+
+  // Maps |shm|, which must be |size| bytes as returned by
+  // |GetSharedMemorySize()|. Returns false if |size| is invalid or mapping
+  // fails.
+  bool Init(scoped_ptr<base::SharedMemory> shm, uint32_t size);
+
+  uint32_t capacity() const { return capacity_; }
+
+  // Writer side. Copies |size| bytes of |data| into the ring and returns its
+  // position in |position|. Returns false if there's currently no room for
+  // the chunk, in which case the caller should fall back to sending the data
+  // some other way.
+  bool Write(const char* data, uint32_t size, uint32_t* position);
+
+  // Reader side. Returns the chunk of |size| bytes at |position|, or NULL if
+  // it doesn't describe a chunk inside the ring.
+  const char* GetChunk(uint32_t position, uint32_t size) const;
+
+  // Reader side. Gives the space up to the end of the chunk at |position| back
+  // to the writer.
+  void Release(uint32_t position, uint32_t size);
+
+ private:
+  struct Header {
+    // The position up to which the reader has released chunks. Written by
+    // the reader only.
+    base::subtle::Atomic32 read_position;
+  };
+
+  // A memory block shared between renderer process and plugin process.
+  scoped_ptr<base::SharedMemory> shm_;
+
+  Header* header_;
+  char* data_;
+  uint32_t capacity_;
+
+  // The position the next chunk will be written at. Positions grow forever
+  // (wrapping around at 2^32); a position's offset in |data_| is taken modulo
+  // |capacity_|.
+  uint32_t write_position_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedMemoryRing);
+};
+
+}  // namespace ppapi
+
+#endif  // PPAPI_SHARED_IMPL_SHARED_MEMORY_RING_H_
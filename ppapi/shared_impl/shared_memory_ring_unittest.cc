@@ -0,0 +1,98 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/shared_memory.h"
+#include "base/process/process_handle.h"
+#include "ppapi/shared_impl/shared_memory_ring.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace ppapi {
+
+namespace {
+
+const uint32_t kCapacity = 16;
+
+class SharedMemoryRingTest : public testing::Test {
+ protected:
+  virtual void SetUp() OVERRIDE {
+    uint32_t size = SharedMemoryRing::GetSharedMemorySize(kCapacity);
+    scoped_ptr<base::SharedMemory> writer_shm(new base::SharedMemory());
+    ASSERT_TRUE(writer_shm->CreateAnonymous(size));
+    base::SharedMemoryHandle handle;
+    ASSERT_TRUE(writer_shm->ShareToProcess(base::GetCurrentProcessHandle(),
+                                           &handle));
+    ASSERT_TRUE(writer_.Init(writer_shm.Pass(), size));
+    ASSERT_TRUE(reader_.Init(
+        scoped_ptr<base::SharedMemory>(new base::SharedMemory(handle, false)),
+        size));
+  }
+
+  // Reads the chunk at |position| and releases it.
+  std::string ReadAndRelease(uint32_t position, uint32_t size) {
+    const char* data = reader_.GetChunk(position, size);
+    if (!data)
+      return std::string();
+    std::string result(data, size);
+    reader_.Release(position, size);
+    return result;
+  }
+
+  SharedMemoryRing writer_;
+  SharedMemoryRing reader_;
+};
+
+}  // namespace
+
+TEST_F(SharedMemoryRingTest, WriteAndRead) {
+  EXPECT_EQ(kCapacity, writer_.capacity());
+  uint32_t first = 0;
+  uint32_t second = 0;
+  ASSERT_TRUE(writer_.Write("abcdef", 6, &first));
+  ASSERT_TRUE(writer_.Write("ghij", 4, &second));
+  EXPECT_EQ("abcdef", ReadAndRelease(first, 6));
+  EXPECT_EQ("ghij", ReadAndRelease(second, 4));
+}
+
+TEST_F(SharedMemoryRingTest, FullUntilReleased) {
+  uint32_t first = 0;
+  uint32_t second = 0;
+  ASSERT_TRUE(writer_.Write("0123456789", 10, &first));
+  EXPECT_FALSE(writer_.Write("abcdefgh", 8, &second));
+  EXPECT_FALSE(writer_.Write(std::string(kCapacity + 1, 'x').data(),
+                             kCapacity + 1, &second));
+
+  EXPECT_EQ("0123456789", ReadAndRelease(first, 10));
+  ASSERT_TRUE(writer_.Write("abcdefgh", 8, &second));
+  EXPECT_EQ("abcdefgh", ReadAndRelease(second, 8));
+}
+
+TEST_F(SharedMemoryRingTest, ChunksDoNotStraddleTheEnd) {
+  uint32_t position = 0;
+  for (int i = 0; i < 10; ++i) {
+    std::string chunk(7, static_cast<char>('a' + i));
+    ASSERT_TRUE(writer_.Write(chunk.data(), chunk.size(), &position));
+    EXPECT_LE((position % kCapacity) + chunk.size(), kCapacity);
+    EXPECT_EQ(chunk, ReadAndRelease(position, chunk.size()));
+  }
+}
+
+TEST_F(SharedMemoryRingTest, RejectsBadChunks) {
+  EXPECT_EQ(NULL, reader_.GetChunk(0, 0));
+  EXPECT_EQ(NULL, reader_.GetChunk(0, kCapacity + 1));
+  EXPECT_EQ(NULL, reader_.GetChunk(kCapacity - 2, 4));
+  EXPECT_TRUE(reader_.GetChunk(kCapacity, kCapacity) != NULL);
+}
+
+TEST_F(SharedMemoryRingTest, IgnoresBogusReleasePosition) {
+  // A release position ahead of anything written must not let the writer
+  // think it has more than |kCapacity| bytes of room.
+  reader_.Release(1000, 0);
+  uint32_t position = 0;
+  EXPECT_FALSE(writer_.Write("abc", 3, &position));
+}
+
+}  // namespace ppapi
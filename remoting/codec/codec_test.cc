@@ -8,6 +8,7 @@
 #include "base/bind.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/time/time.h"
 #include "media/base/video_frame.h"
 #include "remoting/codec/codec_test.h"
 #include "remoting/codec/video_decoder.h"
@@ -24,6 +25,10 @@ namespace {
 
 const int kBytesPerPixel = 4;
 
+// Frames encoded, and the time spent, by MeasureVideoEncoderFpsWithSize().
+const int kMaxFramesToMeasure = 20;
+const int kMaxMeasureTimeMs = 2000;
+
 // Some sample rects for testing.
 std::vector<std::vector<DesktopRect> > MakeTestRectLists(DesktopSize size) {
   std::vector<std::vector<DesktopRect> > rect_lists;
@@ -381,4 +386,36 @@ void TestVideoEncoderDecoderGradient(VideoEncoder* encoder,
                                      max_error_limit, mean_error_limit);
 }
 
+float MeasureVideoEncoderFpsWithSize(VideoEncoder* encoder,
+                                     const DesktopSize& size) {
+  // Alternate between two different random frames so that every frame has
+  // to be encoded in full.
+  scoped_ptr<webrtc::DesktopFrame> frames[2];
+  for (int i = 0; i < 2; ++i) {
+    frames[i].reset(new webrtc::BasicDesktopFrame(size));
+    srand(i);
+    int memory_size = size.height() * frames[i]->stride();
+    for (int j = 0; j < memory_size; ++j)
+      frames[i]->data()[j] = rand() % 256;
+    frames[i]->mutable_updated_region()->SetRect(DesktopRect::MakeSize(size));
+  }
+
+  // Encode one frame first so that encoder initialization isn't measured.
+  encoder->Encode(*frames[1]);
+
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  base::TimeDelta elapsed;
+  int frame_count = 0;
+  while (frame_count < kMaxFramesToMeasure &&
+         elapsed.InMilliseconds() < kMaxMeasureTimeMs) {
+    scoped_ptr<VideoPacket> packet =
+        encoder->Encode(*frames[frame_count % 2]);
+    EXPECT_TRUE(packet);
+    ++frame_count;
+    elapsed = base::TimeTicks::Now() - start_time;
+  }
+
+  return frame_count / elapsed.InSecondsF();
+}
+
 }  // namespace remoting
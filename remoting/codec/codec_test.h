@@ -40,6 +40,11 @@ void TestVideoEncoderDecoderGradient(VideoEncoder* encoder,
                                      double max_error_limit,
                                      double mean_error_limit);
 
+// Returns the number of frames of |size| that |encoder| encodes per second,
+// with every frame fully updated.
+float MeasureVideoEncoderFpsWithSize(VideoEncoder* encoder,
+                                     const webrtc::DesktopSize& size);
+
 }  // namespace remoting
 
 #endif  // REMOTING_CODEC_CODEC_TEST_H_
@@ -4,6 +4,8 @@
 
 #include "remoting/codec/video_encoder_vpx.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/logging.h"
 #include "base/sys_info.h"
@@ -29,6 +31,36 @@ namespace {
 // map for the encoder.
 const int kMacroBlockSize = 16;
 
+// Number of pixels worth giving an encoder thread of its own.  A 1080p frame
+// gets two threads, as before; larger and multi-monitor frames get more.
+const int kPixelsPerEncoderThread = 1920 * 1080 / 2;
+
+// Returns the number of threads to encode frames of |size| with.
+int GetEncoderThreadCount(const webrtc::DesktopSize& size) {
+  // Going to multiple threads on low end windows systems can really hurt
+  // performance.
+  // http://crbug.com/99179
+  int processors = base::SysInfo::NumberOfProcessors();
+  if (processors <= 2)
+    return 1;
+
+  // Use at most half of the cores so capture and the network stay responsive.
+  int threads = size.width() * size.height() / kPixelsPerEncoderThread;
+  return std::max(2, std::min(threads, processors / 2));
+}
+
+// Returns the VP8 token partition setting matching |threads|, so that each
+// thread can pack its macroblock rows into a partition of its own.
+vp8e_token_partitions GetTokenPartitions(int threads) {
+  if (threads >= 8)
+    return VP8_EIGHT_TOKENPARTITION;
+  if (threads >= 4)
+    return VP8_FOUR_TOKENPARTITION;
+  if (threads >= 2)
+    return VP8_TWO_TOKENPARTITION;
+  return VP8_ONE_TOKENPARTITION;
+}
+
 ScopedVpxCodec CreateVP8Codec(const webrtc::DesktopSize& size) {
   ScopedVpxCodec codec(new vpx_codec_ctx_t);
 
@@ -51,11 +83,9 @@ ScopedVpxCodec CreateVP8Codec(const webrtc::DesktopSize& size) {
   // encoding.
   config.g_profile = 2;
 
-  // Using 2 threads gives a great boost in performance for most systems with
-  // adequate processing power. NB: Going to multiple threads on low end
-  // windows systems can really hurt performance.
-  // http://crbug.com/99179
-  config.g_threads = (base::SysInfo::NumberOfProcessors() > 2) ? 2 : 1;
+  // Using multiple threads gives a great boost in performance for most
+  // systems with adequate processing power.
+  config.g_threads = GetEncoderThreadCount(size);
   config.rc_min_quantizer = 20;
   config.rc_max_quantizer = 30;
   config.g_timebase.num = 1;
@@ -74,6 +104,11 @@ ScopedVpxCodec CreateVP8Codec(const webrtc::DesktopSize& size) {
   if (vpx_codec_control(codec.get(), VP8E_SET_NOISE_SENSITIVITY, 0))
     return ScopedVpxCodec();
 
+  if (vpx_codec_control(codec.get(), VP8E_SET_TOKEN_PARTITIONS,
+                        GetTokenPartitions(config.g_threads))) {
+    return ScopedVpxCodec();
+  }
+
   return codec.Pass();
 }
 
@@ -7,6 +7,7 @@
 #include <limits>
 #include <vector>
 
+#include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
 #include "remoting/codec/codec_test.h"
 #include "remoting/proto/video.pb.h"
@@ -63,4 +64,22 @@ TEST(VideoEncoderVpxTest, TestDpiPropagation) {
   EXPECT_EQ(packet->format().y_dpi(), 97);
 }
 
+// Logs the encode rate for a few common host sizes, to track the effect of
+// encoder threading and speed settings.
+TEST(VideoEncoderVpxTest, MeasureEncodeFps) {
+  const webrtc::DesktopSize kSizes[] = {
+    webrtc::DesktopSize(1280, 720),
+    webrtc::DesktopSize(1920, 1080),
+    webrtc::DesktopSize(3840, 1080),
+  };
+
+  for (size_t i = 0; i < arraysize(kSizes); ++i) {
+    scoped_ptr<VideoEncoderVpx> encoder(VideoEncoderVpx::CreateForVP8());
+    float fps = MeasureVideoEncoderFpsWithSize(encoder.get(), kSizes[i]);
+    LOG(INFO) << kSizes[i].width() << "x" << kSizes[i].height() << ": "
+              << fps << " fps";
+    EXPECT_GT(fps, 0);
+  }
+}
+
 }  // namespace remoting
@@ -31,6 +31,10 @@ namespace remoting {
 // TODO(hclam): Move this value to CaptureScheduler.
 static const int kMaxPendingFrames = 2;
 
+// Minimum interval between the empty keep-alive packets sent while the screen
+// is not changing.
+static const int kKeepAlivePacketIntervalMs = 500;
+
 VideoScheduler::VideoScheduler(
     scoped_refptr<base::SingleThreadTaskRunner> capture_task_runner,
     scoped_refptr<base::SingleThreadTaskRunner> encode_task_runner,
@@ -280,14 +284,26 @@ void VideoScheduler::EncodeFrame(
     int64 sequence_number) {
   DCHECK(encode_task_runner_->BelongsToCurrentThread());
 
-  // If there is nothing to encode then send an empty keep-alive packet.
+  // If there is nothing to encode then send an empty keep-alive packet, unless
+  // a packet was sent recently enough to keep the network active.  This keeps
+  // a static desktop from generating a packet for every captured frame.
   if (!frame || frame->updated_region().is_empty()) {
+    capture_task_runner_->DeleteSoon(FROM_HERE, frame.release());
+
+    base::TimeTicks now = base::TimeTicks::Now();
+    if (now - last_packet_time_ <
+        base::TimeDelta::FromMilliseconds(kKeepAlivePacketIntervalMs)) {
+      capture_task_runner_->PostTask(
+          FROM_HERE, base::Bind(&VideoScheduler::FrameCaptureCompleted, this));
+      return;
+    }
+    last_packet_time_ = now;
+
     scoped_ptr<VideoPacket> packet(new VideoPacket());
     packet->set_client_sequence_number(sequence_number);
     network_task_runner_->PostTask(
         FROM_HERE, base::Bind(&VideoScheduler::SendVideoPacket, this,
                               base::Passed(&packet)));
-    capture_task_runner_->DeleteSoon(FROM_HERE, frame.release());
     return;
   }
 
@@ -301,6 +317,7 @@ void VideoScheduler::EncodeFrame(
 
   scheduler_.RecordEncodeTime(
       base::TimeDelta::FromMilliseconds(packet->encode_time_ms()));
+  last_packet_time_ = base::TimeTicks::Now();
   network_task_runner_->PostTask(
       FROM_HERE, base::Bind(&VideoScheduler::SendVideoPacket, this,
                             base::Passed(&packet)));
@@ -190,6 +190,10 @@ class VideoScheduler : public base::RefCountedThreadSafe<VideoScheduler>,
   // This is a number updated by client to trace performance.
   int64 sequence_number_;
 
+  // Time at which the last video packet was passed to the network thread.
+  // Always accessed on the encode thread.
+  base::TimeTicks last_packet_time_;
+
   // An object to schedule capturing.
   CaptureScheduler scheduler_;
 
@@ -20,6 +20,7 @@
 #include <time.h>
 #include <unistd.h>
 
+#include "base/basictypes.h"
 #include "base/compiler_specific.h"
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
@@ -36,6 +37,67 @@ namespace {
 
 const int kExpectedExitCode = 100;
 
+// System calls that dominate what sandboxed processes, renderers in
+// particular, spend their time on. They get a much larger weight than other
+// system calls, so that the jump table resolves them in fewer comparisons.
+const int kHotSyscalls[] = {
+#if defined(__NR_futex)
+  __NR_futex,
+#endif
+#if defined(__NR_read)
+  __NR_read,
+#endif
+#if defined(__NR_write)
+  __NR_write,
+#endif
+#if defined(__NR_epoll_wait)
+  __NR_epoll_wait,
+#endif
+#if defined(__NR_poll)
+  __NR_poll,
+#endif
+#if defined(__NR_recvmsg)
+  __NR_recvmsg,
+#endif
+#if defined(__NR_sendmsg)
+  __NR_sendmsg,
+#endif
+#if defined(__NR_gettimeofday)
+  __NR_gettimeofday,
+#endif
+#if defined(__NR_clock_gettime)
+  __NR_clock_gettime,
+#endif
+#if defined(__NR_madvise)
+  __NR_madvise,
+#endif
+#if defined(__NR_mmap)
+  __NR_mmap,
+#endif
+#if defined(__NR_mmap2)
+  __NR_mmap2,
+#endif
+#if defined(__NR_munmap)
+  __NR_munmap,
+#endif
+#if defined(__NR_mprotect)
+  __NR_mprotect,
+#endif
+};
+const uint64_t kHotSyscallWeight = 256;
+
+// Returns the relative frequency with which we expect |sysnum| to be made.
+// Numbers outside of the valid system call range are never expected.
+uint64_t SyscallWeight(uint32_t sysnum) {
+  if (!SyscallIterator::IsValid(sysnum))
+    return 0;
+  for (size_t i = 0; i < arraysize(kHotSyscalls); ++i) {
+    if (static_cast<uint32_t>(kHotSyscalls[i]) == sysnum)
+      return kHotSyscallWeight;
+  }
+  return 1;
+}
+
 int popcount(uint32_t x) {
   return __builtin_popcount(x);
 }
@@ -738,6 +800,7 @@ void SandboxBPF::FindRanges(Ranges* ranges) {
   // and then verifying that the rest of the number range (both positive and
   // negative) all return the same ErrorCode.
   uint32_t old_sysnum = 0;
+  uint64_t old_weight = 0;
   ErrorCode old_err = policy_->EvaluateSyscall(this, old_sysnum);
   ErrorCode invalid_err = policy_->EvaluateSyscall(this, MIN_SYSCALL - 1);
 
@@ -752,10 +815,14 @@ void SandboxBPF::FindRanges(Ranges* ranges) {
       SANDBOX_DIE("Invalid seccomp policy");
     }
     if (!err.Equals(old_err) || iter.Done()) {
-      ranges->push_back(Range(old_sysnum, sysnum - 1, old_err));
+      ranges->push_back(Range(old_sysnum, sysnum - 1, old_err, old_weight));
       old_sysnum = sysnum;
+      old_weight = 0;
       old_err = err;
     }
+    // Valid system calls are enumerated one by one, so every one of them is
+    // weighed exactly once.
+    old_weight += SyscallWeight(sysnum);
   }
 }
 
@@ -774,11 +841,25 @@ Instruction* SandboxBPF::AssembleJumpTable(CodeGen* gen,
     return RetExpression(gen, start->err);
   }
 
-  // Pick the range object that is located at the mid point of our list.
+  // Pick the range object at which the cumulative weight of the list crosses
+  // its midpoint, so that each half is about as likely to be taken as the
+  // other. Hot system calls then sit close to the root of the search tree.
+  // If no range carries any weight, fall back to the mid point of the list.
   // We compare our system call number against the lowest valid system call
   // number in this range object. If our number is lower, it is outside of
   // this range object. If it is greater or equal, it might be inside.
+  uint64_t total_weight = 0;
+  for (Ranges::const_iterator it = start; it != stop; ++it)
+    total_weight += it->weight;
   Ranges::const_iterator mid = start + (stop - start) / 2;
+  if (total_weight > 0) {
+    uint64_t lower_weight = start->weight;
+    mid = start + 1;
+    while (mid + 1 < stop && 2 * (lower_weight + mid->weight) <= total_weight) {
+      lower_weight += mid->weight;
+      ++mid;
+    }
+  }
 
   // Sub-divide the list of ranges and continue recursively.
   Instruction* jf = AssembleJumpTable(gen, start, mid);
@@ -198,10 +198,13 @@ class SandboxBPF {
   friend class ErrorCode;
 
   struct Range {
-    Range(uint32_t f, uint32_t t, const ErrorCode& e)
-        : from(f), to(t), err(e) {}
+    Range(uint32_t f, uint32_t t, const ErrorCode& e, uint64_t w)
+        : from(f), to(t), err(e), weight(w) {}
     uint32_t from, to;
     ErrorCode err;
+    // How often system calls in this range are expected to be made, relative
+    // to the other ranges. Used to shape the jump table.
+    uint64_t weight;
   };
   typedef std::vector<Range> Ranges;
   typedef std::map<uint32_t, ErrorCode> ErrMap;
@@ -238,11 +241,13 @@ class SandboxBPF {
   // Finds all the ranges of system calls that need to be handled. Ranges are
   // sorted in ascending order of system call numbers. There are no gaps in the
   // ranges. System calls with identical ErrorCodes are coalesced into a single
-  // range.
+  // range, whose weight is the sum of the weights of its system calls.
   void FindRanges(Ranges* ranges);
 
   // Returns a BPF program snippet that implements a jump table for the
   // given range of system call numbers. This function runs recursively.
+  // The binary search is weight-balanced rather than count-balanced, so
+  // heavily weighted (i.e. hot) ranges need fewer comparisons to reach.
   Instruction* AssembleJumpTable(CodeGen* gen,
                                  Ranges::const_iterator start,
                                  Ranges::const_iterator stop);
@@ -384,6 +384,27 @@ void BGRAConvolve2D(const unsigned char* source_data,
                     int output_byte_row_stride,
                     unsigned char* output,
                     bool use_simd_if_possible) {
+  BGRAConvolve2DRows(source_data, source_byte_row_stride, source_has_alpha,
+                     filter_x, filter_y, 0, filter_y.num_values(),
+                     output_byte_row_stride, output, use_simd_if_possible);
+}
+
+void BGRAConvolve2DRows(const unsigned char* source_data,
+                        int source_byte_row_stride,
+                        bool source_has_alpha,
+                        const ConvolutionFilter1D& filter_x,
+                        const ConvolutionFilter1D& filter_y,
+                        int first_output_row,
+                        int end_output_row,
+                        int output_byte_row_stride,
+                        unsigned char* output,
+                        bool use_simd_if_possible) {
+  SkASSERT(0 <= first_output_row);
+  SkASSERT(first_output_row <= end_output_row);
+  SkASSERT(end_output_row <= filter_y.num_values());
+  if (first_output_row == end_output_row)
+    return;
+
   ConvolveProcs simd;
   simd.extra_horizontal_reads = 0;
   simd.convolve_vertically = NULL;
@@ -397,12 +418,14 @@ void BGRAConvolve2D(const unsigned char* source_data,
 
   // The next row in the input that we will generate a horizontally
   // convolved row for. If the filter doesn't start at the beginning of the
-  // image (this is the case when we are only resizing a subset), then we
-  // don't want to generate any output rows before that. Compute the starting
-  // row for convolution as the first pixel for the first vertical filter.
+  // image (this is the case when we are only resizing a subset, or only
+  // producing a band of output rows), then we don't want to generate any
+  // output rows before that. Compute the starting row for convolution as the
+  // first pixel for the first vertical filter.
   int filter_offset, filter_length;
   const ConvolutionFilter1D::Fixed* filter_values =
-      filter_y.FilterForValue(0, &filter_offset, &filter_length);
+      filter_y.FilterForValue(first_output_row, &filter_offset,
+                              &filter_length);
   int next_x_row = filter_offset;
 
   // We loop over each row in the input doing a horizontal convolution. This
@@ -446,7 +469,7 @@ void BGRAConvolve2D(const unsigned char* source_data,
   filter_y.FilterForValue(num_output_rows - 1, &last_filter_offset,
                           &last_filter_length);
 
-  for (int out_y = 0; out_y < num_output_rows; out_y++) {
+  for (int out_y = first_output_row; out_y < end_output_row; out_y++) {
     filter_values = filter_y.FilterForValue(out_y,
                                             &filter_offset, &filter_length);
 
@@ -191,6 +191,22 @@ SK_API void BGRAConvolve2D(const unsigned char* source_data,
                            unsigned char* output,
                            bool use_simd_if_possible);
 
+// Same as BGRAConvolve2D, but only computes the output rows in the range
+// [|first_output_row|, |end_output_row|). |output| still points at the start
+// of the whole destination image. Only the source rows needed by those output
+// rows are read, so disjoint row ranges of the same image can be convolved
+// concurrently.
+SK_API void BGRAConvolve2DRows(const unsigned char* source_data,
+                               int source_byte_row_stride,
+                               bool source_has_alpha,
+                               const ConvolutionFilter1D& xfilter,
+                               const ConvolutionFilter1D& yfilter,
+                               int first_output_row,
+                               int end_output_row,
+                               int output_byte_row_stride,
+                               unsigned char* output,
+                               bool use_simd_if_possible);
+
 // Does a 1D convolution of the given source image along the X dimension on
 // a single channel of the bitmap.
 //
@@ -13,7 +13,9 @@
 #include "base/containers/stack_container.h"
 #include "base/debug/trace_event.h"
 #include "base/logging.h"
+#include "base/memory/scoped_vector.h"
 #include "base/metrics/histogram.h"
+#include "base/threading/simple_thread.h"
 #include "base/time/time.h"
 #include "build/build_config.h"
 #include "skia/ext/convolver.h"
@@ -25,6 +27,10 @@ namespace skia {
 
 namespace {
 
+// Destinations smaller than this many rows per thread aren't worth the cost of
+// starting another thread.
+const int kMinRowsPerThread = 64;
+
 // Returns the ceiling/floor as an integer.
 inline int CeilInt(float val) {
   return static_cast<int>(ceil(val));
@@ -334,6 +340,49 @@ ImageOperations::ResizeMethod ResizeMethodToAlgorithmMethod(
 
 }  // namespace
 
+// Convolves one band of output rows. Used to spread a resize across threads.
+class ConvolveBandTask : public base::DelegateSimpleThread::Delegate {
+ public:
+  ConvolveBandTask(const unsigned char* source_data,
+                   int source_byte_row_stride,
+                   bool source_has_alpha,
+                   const ConvolutionFilter1D& filter_x,
+                   const ConvolutionFilter1D& filter_y,
+                   int first_output_row,
+                   int end_output_row,
+                   int output_byte_row_stride,
+                   unsigned char* output)
+      : source_data_(source_data),
+        source_byte_row_stride_(source_byte_row_stride),
+        source_has_alpha_(source_has_alpha),
+        filter_x_(filter_x),
+        filter_y_(filter_y),
+        first_output_row_(first_output_row),
+        end_output_row_(end_output_row),
+        output_byte_row_stride_(output_byte_row_stride),
+        output_(output) {}
+
+  virtual void Run() OVERRIDE {
+    BGRAConvolve2DRows(source_data_, source_byte_row_stride_,
+                       source_has_alpha_, filter_x_, filter_y_,
+                       first_output_row_, end_output_row_,
+                       output_byte_row_stride_, output_, true);
+  }
+
+ private:
+  const unsigned char* source_data_;
+  int source_byte_row_stride_;
+  bool source_has_alpha_;
+  const ConvolutionFilter1D& filter_x_;
+  const ConvolutionFilter1D& filter_y_;
+  int first_output_row_;
+  int end_output_row_;
+  int output_byte_row_stride_;
+  unsigned char* output_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConvolveBandTask);
+};
+
 // Resize ----------------------------------------------------------------------
 
 // static
@@ -347,8 +396,23 @@ SkBitmap ImageOperations::Resize(const SkBitmap& source,
                           dest_subset, allocator);
   } else {
     return ResizeBasic(source, method, dest_width, dest_height, dest_subset,
-                       allocator);
+                       1, allocator);
+  }
+}
+
+// static
+SkBitmap ImageOperations::ResizeWithThreads(const SkBitmap& source,
+                                            ResizeMethod method,
+                                            int dest_width, int dest_height,
+                                            int max_threads,
+                                            SkBitmap::Allocator* allocator) {
+  SkIRect dest_subset = { 0, 0, dest_width, dest_height };
+  if (method == ImageOperations::RESIZE_SUBPIXEL) {
+    return ResizeSubpixel(source, dest_width, dest_height,
+                          dest_subset, allocator);
   }
+  return ResizeBasic(source, method, dest_width, dest_height, dest_subset,
+                     max_threads, allocator);
 }
 
 // static
@@ -386,7 +450,7 @@ SkBitmap ImageOperations::ResizeSubpixel(const SkBitmap& source,
                      dest_subset.fLeft + dest_subset.width() * w,
                      dest_subset.fTop + dest_subset.height() * h };
   SkBitmap img = ResizeBasic(source, ImageOperations::RESIZE_LANCZOS3, width,
-                             height, subset, allocator);
+                             height, subset, 1, allocator);
   const int row_words = img.rowBytes() / 4;
   if (w == 1 && h == 1)
     return img;
@@ -466,6 +530,7 @@ SkBitmap ImageOperations::ResizeBasic(const SkBitmap& source,
                                       ResizeMethod method,
                                       int dest_width, int dest_height,
                                       const SkIRect& dest_subset,
+                                      int max_threads,
                                       SkBitmap::Allocator* allocator) {
   TRACE_EVENT2("skia", "ImageOperations::ResizeBasic",
                "src_pixels", source.width()*source.height(),
@@ -515,11 +580,38 @@ SkBitmap ImageOperations::ResizeBasic(const SkBitmap& source,
   if (!result.readyToDraw())
     return SkBitmap();
 
-  BGRAConvolve2D(source_subset, static_cast<int>(source.rowBytes()),
-                 !source.isOpaque(), filter.x_filter(), filter.y_filter(),
-                 static_cast<int>(result.rowBytes()),
-                 static_cast<unsigned char*>(result.getPixels()),
-                 true);
+  int num_threads = std::min(max_threads,
+                             dest_subset.height() / kMinRowsPerThread);
+  if (num_threads <= 1) {
+    BGRAConvolve2D(source_subset, static_cast<int>(source.rowBytes()),
+                   !source.isOpaque(), filter.x_filter(), filter.y_filter(),
+                   static_cast<int>(result.rowBytes()),
+                   static_cast<unsigned char*>(result.getPixels()),
+                   true);
+  } else {
+    // Split the output into equal bands of rows. The first band is convolved
+    // on this thread while the others run on worker threads.
+    ScopedVector<ConvolveBandTask> tasks;
+    for (int i = 0; i < num_threads; ++i) {
+      int first_row = dest_subset.height() * i / num_threads;
+      int end_row = dest_subset.height() * (i + 1) / num_threads;
+      tasks.push_back(new ConvolveBandTask(
+          source_subset, static_cast<int>(source.rowBytes()),
+          !source.isOpaque(), filter.x_filter(), filter.y_filter(),
+          first_row, end_row, static_cast<int>(result.rowBytes()),
+          static_cast<unsigned char*>(result.getPixels())));
+    }
+
+    ScopedVector<base::DelegateSimpleThread> threads;
+    for (int i = 1; i < num_threads; ++i) {
+      threads.push_back(
+          new base::DelegateSimpleThread(tasks[i], "ImageResizeWorker"));
+      threads.back()->Start();
+    }
+    tasks[0]->Run();
+    for (size_t i = 0; i < threads.size(); ++i)
+      threads[i]->Join();
+  }
 
   base::TimeDelta delta = base::TimeTicks::Now() - resize_start;
   UMA_HISTOGRAM_TIMES("Image.ResampleMS", delta);
@@ -111,14 +111,28 @@ class SK_API ImageOperations {
                          int dest_width, int dest_height,
                          SkBitmap::Allocator* allocator = NULL);
 
+  // Same as the entire-bitmap Resize above, but splits the destination into
+  // bands of rows that are convolved concurrently on up to |max_threads|
+  // threads, one of which is the calling thread. Worthwhile for large bitmaps
+  // only. This joins the worker threads before returning, so it must not be
+  // called on threads that disallow blocking, like the browser UI and IO
+  // threads. RESIZE_SUBPIXEL always runs on the calling thread only.
+  static SkBitmap ResizeWithThreads(const SkBitmap& source,
+                                    ResizeMethod method,
+                                    int dest_width, int dest_height,
+                                    int max_threads,
+                                    SkBitmap::Allocator* allocator = NULL);
+
  private:
   ImageOperations();  // Class for scoping only.
 
-  // Supports all methods except RESIZE_SUBPIXEL.
+  // Supports all methods except RESIZE_SUBPIXEL. Convolves on up to
+  // |max_threads| threads.
   static SkBitmap ResizeBasic(const SkBitmap& source,
                               ResizeMethod method,
                               int dest_width, int dest_height,
                               const SkIRect& dest_subset,
+                              int max_threads,
                               SkBitmap::Allocator* allocator = NULL);
 
   // Subpixel renderer.
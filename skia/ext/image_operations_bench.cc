@@ -141,6 +141,7 @@ class Benchmark {
 
   Benchmark()
       : num_iterations_(kDefaultNumberIterations),
+        max_threads_(1),
         method_(kDefaultResizeMethod) {}
 
   // Returns true if command line parsing was successful, false otherwise.
@@ -151,7 +152,11 @@ class Benchmark {
 
   static void Usage();
  private:
+  // Runs the benchmark resizing on up to |num_threads| threads.
+  void RunWithThreads(const SkBitmap& source, int num_threads) const;
+
   int num_iterations_;
+  int max_threads_;
   skia::ImageOperations::ResizeMethod method_;
   Dimensions source_;
   Dimensions dest_;
@@ -165,10 +170,11 @@ const skia::ImageOperations::ResizeMethod Benchmark::kDefaultResizeMethod =
 // argument management
 void Benchmark::Usage() {
   printf("image_operations_bench -source wxh -destination wxh "
-         "[-iterations i] [-method m] [-help]\n"
+         "[-iterations i] [-threads t] [-method m] [-help]\n"
          "  -source wxh: specify source width and height\n"
          "  -destination wxh: specify destination width and height\n"
          "  -iter i: perform i iterations (default:%d)\n"
+         "  -threads t: report throughput for 1 to t threads (default:1)\n"
          "  -method m: use method m (default:%s), which can be:",
          Benchmark::kDefaultNumberIterations,
          MethodToString(Benchmark::kDefaultResizeMethod));
@@ -198,6 +204,10 @@ bool Benchmark::ParseArgs(const CommandLine* command_line) {
       if (base::StringToInt(value, &num_iterations_) == false) {
         fNeedHelp = true;
       }
+    } else if (s == "threads") {
+      if (base::StringToInt(value, &max_threads_) == false) {
+        fNeedHelp = true;
+      }
     } else if (s == "method") {
       if (!StringToMethod(value, &method_)) {
         printf("Invalid method '%s' specified\n", value.c_str());
@@ -212,6 +222,10 @@ bool Benchmark::ParseArgs(const CommandLine* command_line) {
     printf("Invalid number of iterations: %d\n", num_iterations_);
     fNeedHelp = true;
   }
+  if (max_threads_ <= 0) {
+    printf("Invalid number of threads: %d\n", max_threads_);
+    fNeedHelp = true;
+  }
   if (!source_.IsValid()) {
     printf("Invalid source dimensions specified\n");
     fNeedHelp = true;
@@ -234,14 +248,23 @@ bool Benchmark::Run() const {
   source.allocPixels();
   source.eraseARGB(0, 0, 0, 0);
 
+  for (int num_threads = 1; num_threads <= max_threads_; ++num_threads)
+    RunWithThreads(source, num_threads);
+
+  return true;
+}
+
+void Benchmark::RunWithThreads(const SkBitmap& source, int num_threads) const {
   SkBitmap dest;
 
   const base::TimeTicks start = base::TimeTicks::Now();
 
   for (int i = 0; i < num_iterations_; ++i) {
-    dest = skia::ImageOperations::Resize(source,
-                                         method_,
-                                         dest_.width(), dest_.height());
+    dest = skia::ImageOperations::ResizeWithThreads(source,
+                                                    method_,
+                                                    dest_.width(),
+                                                    dest_.height(),
+                                                    num_threads);
   }
 
   const int64 elapsed_us = (base::TimeTicks::Now() - start).InMicroseconds();
@@ -249,12 +272,11 @@ bool Benchmark::Run() const {
   const uint64 num_bytes = static_cast<uint64>(num_iterations_) *
       (GetBitmapSize(&source) + GetBitmapSize(&dest));
 
-  printf("%" PRIu64 " MB/s,\telapsed = %" PRIu64 " source=%d dest=%d\n",
+  printf("%" PRIu64 " MB/s,\telapsed = %" PRIu64 " source=%d dest=%d "
+         "threads=%d\n",
          static_cast<uint64>(elapsed_us == 0 ? 0 : num_bytes / elapsed_us),
          static_cast<uint64>(elapsed_us),
-         GetBitmapSize(&source), GetBitmapSize(&dest));
-
-  return true;
+         GetBitmapSize(&source), GetBitmapSize(&dest), num_threads);
 }
 
 // A small class to automatically call Reset on the global command line to
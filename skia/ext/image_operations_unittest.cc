@@ -729,3 +729,31 @@ TEST(ImageOperations, ScaleUp) {
     }
   }
 }
+
+// Resizing on several threads must give exactly the same result as resizing
+// on one.
+TEST(ImageOperations, ResizeWithThreadsMatchesResize) {
+  const int src_w = 500;
+  const int src_h = 700;
+  const int dst_w = 300;
+  const int dst_h = 400;
+  SkBitmap src;
+  FillDataToBitmap(src_w, src_h, &src);
+
+  SkBitmap expected = skia::ImageOperations::Resize(
+      src, skia::ImageOperations::RESIZE_LANCZOS3, dst_w, dst_h);
+  SkBitmap threaded = skia::ImageOperations::ResizeWithThreads(
+      src, skia::ImageOperations::RESIZE_LANCZOS3, dst_w, dst_h, 4);
+
+  ASSERT_EQ(dst_w, threaded.width());
+  ASSERT_EQ(dst_h, threaded.height());
+
+  SkAutoLockPixels expected_lock(expected);
+  SkAutoLockPixels threaded_lock(threaded);
+  for (int y = 0; y < dst_h; ++y) {
+    for (int x = 0; x < dst_w; ++x) {
+      ASSERT_EQ(*expected.getAddr32(x, y), *threaded.getAddr32(x, y))
+          << "Pixel (" << x << ", " << y << ") differs";
+    }
+  }
+}
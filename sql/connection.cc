@@ -6,10 +6,16 @@
 
 #include <string.h>
 
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/debug/trace_event.h"
 #include "base/files/file_path.h"
 #include "base/file_util.h"
+#include "base/format_macros.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/message_loop/message_loop.h"
 #include "base/metrics/histogram.h"
 #include "base/metrics/sparse_histogram.h"
 #include "base/strings/string_split.h"
@@ -31,6 +37,9 @@ namespace {
 // TODO(shess): Better story on this.  http://crbug.com/56559
 const int kBusyTimeoutSeconds = 1;
 
+// In WAL mode, checkpoint once no commit has happened for this long.
+const int kCheckpointIdleSeconds = 5;
+
 class ScopedBusyTimeout {
  public:
   explicit ScopedBusyTimeout(sqlite3* db)
@@ -141,6 +150,12 @@ int GetSqlite3File(sqlite3* db, sqlite3_file** file) {
   return rc;
 }
 
+// Orders statement profiles by descending total time.
+bool MoreExpensive(const sql::Connection::StatementProfile& a,
+                   const sql::Connection::StatementProfile& b) {
+  return a.total_time > b.total_time;
+}
+
 }  // namespace
 
 namespace sql {
@@ -173,6 +188,23 @@ bool StatementID::operator<(const StatementID& other) const {
   return strcmp(str_, other.str_) < 0;
 }
 
+std::string StatementID::ToString() const {
+  if (number_ < 0)
+    return str_;
+  return base::StringPrintf("%s:%d", str_, number_);
+}
+
+Connection::StatementProfile::StatementProfile()
+    : executions(0),
+      rows(0),
+      page_reads(0),
+      fullscan_steps(0),
+      sorts(0) {
+}
+
+Connection::StatementProfile::~StatementProfile() {
+}
+
 Connection::StatementRef::StatementRef(Connection* connection,
                                        sqlite3_stmt* stmt,
                                        bool was_valid)
@@ -216,10 +248,16 @@ Connection::Connection()
       cache_size_(0),
       exclusive_locking_(false),
       restrict_to_user_(false),
+      use_wal_(false),
+      mmap_size_(0),
+      temp_store_(TEMP_STORE_DEFAULT),
       transaction_nesting_(0),
       needs_rollback_(false),
       in_memory_(false),
-      poisoned_(false) {
+      poisoned_(false),
+      checkpoint_pending_(false),
+      profiling_enabled_(false),
+      weak_factory_(this) {
 }
 
 Connection::~Connection() {
@@ -268,6 +306,11 @@ void Connection::CloseInternal(bool forced) {
   // Release cached statements.
   statement_cache_.clear();
 
+  // A pending checkpoint would otherwise run against the next database
+  // opened on this connection.
+  weak_factory_.InvalidateWeakPtrs();
+  checkpoint_pending_ = false;
+
   // With cached statements released, in-use statements will remain.
   // Closing the database while statements are in use is an API
   // violation, except for forced close (which happens from within a
@@ -441,12 +484,19 @@ bool Connection::Raze() {
   // page_size" can be used to query such a database.
   ScopedWritableSchema writable_schema(db_);
 
+  // sqlite3_backup cannot write into a WAL database if the page sizes
+  // differ, so use the rollback journal for the duration.
+  if (use_wal_)
+    SetJournalMode(false);
+
   const char* kMain = "main";
   int rc = BackupDatabase(null_db.db_, db_, kMain);
   UMA_HISTOGRAM_SPARSE_SLOWLY("Sqlite.RazeDatabase",rc);
 
   // The destination database was locked.
   if (rc == SQLITE_BUSY) {
+    if (use_wal_)
+      SetJournalMode(true);
     return false;
   }
 
@@ -486,6 +536,9 @@ bool Connection::Raze() {
     return false;
   }
 
+  if (use_wal_)
+    SetJournalMode(true);
+
   return true;
 }
 
@@ -552,13 +605,16 @@ bool Connection::Delete(const base::FilePath& path) {
 
   base::FilePath journal_path(path.value() + FILE_PATH_LITERAL("-journal"));
   base::FilePath wal_path(path.value() + FILE_PATH_LITERAL("-wal"));
+  base::FilePath shm_path(path.value() + FILE_PATH_LITERAL("-shm"));
 
   base::DeleteFile(journal_path, false);
   base::DeleteFile(wal_path, false);
+  base::DeleteFile(shm_path, false);
   base::DeleteFile(path, false);
 
   return !base::PathExists(journal_path) &&
       !base::PathExists(wal_path) &&
+      !base::PathExists(shm_path) &&
       !base::PathExists(path);
 }
 
@@ -618,7 +674,13 @@ bool Connection::CommitTransaction() {
   }
 
   Statement commit(GetCachedStatement(SQL_FROM_HERE, "COMMIT"));
-  return commit.Run();
+  const base::TimeTicks before = base::TimeTicks::Now();
+  if (!commit.Run())
+    return false;
+  AddTimeHistogram("Sqlite.CommitTime", base::TimeTicks::Now() - before);
+
+  ScheduleCheckpoint();
+  return true;
 }
 
 void Connection::RollbackAllTransactions() {
@@ -708,8 +770,11 @@ scoped_refptr<Connection::StatementRef> Connection::GetCachedStatement(
   }
 
   scoped_refptr<StatementRef> statement = GetUniqueStatement(sql);
-  if (statement->is_valid())
+  if (statement->is_valid()) {
+    if (profiling_enabled_)
+      statement->set_profile_name(id.ToString());
     statement_cache_[id] = statement;  // Only cache valid statements.
+  }
   return statement;
 }
 
@@ -917,8 +982,10 @@ bool Connection::OpenInternal(const std::string& file_name,
       // be fatal unless the file doesn't exist.
       base::FilePath journal_path(file_name + FILE_PATH_LITERAL("-journal"));
       base::FilePath wal_path(file_name + FILE_PATH_LITERAL("-wal"));
+      base::FilePath shm_path(file_name + FILE_PATH_LITERAL("-shm"));
       base::SetPosixFilePermissions(journal_path, mode);
       base::SetPosixFilePermissions(wal_path, mode);
+      base::SetPosixFilePermissions(shm_path, mode);
     }
   }
 #endif  // defined(OS_POSIX)
@@ -969,15 +1036,9 @@ bool Connection::OpenInternal(const std::string& file_name,
     ignore_result(Execute("PRAGMA locking_mode=EXCLUSIVE"));
   }
 
-  // http://www.sqlite.org/pragma.html#pragma_journal_mode
-  // DELETE (default) - delete -journal file to commit.
-  // TRUNCATE - truncate -journal file to commit.
-  // PERSIST - zero out header of -journal file to commit.
-  // journal_size_limit provides size to trim to in PERSIST.
-  // TODO(shess): Figure out if PERSIST and journal_size_limit really
-  // matter.  In theory, it keeps pages pre-allocated, so if
-  // transactions usually fit, it should be faster.
-  ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
+  // journal_size_limit provides size to trim to in PERSIST, and the
+  // size the -wal file is trimmed to after a checkpoint in WAL mode.
+  SetJournalMode(use_wal_);
   ignore_result(Execute("PRAGMA journal_size_limit = 16384"));
 
   const base::TimeDelta kBusyTimeout =
@@ -1000,6 +1061,19 @@ bool Connection::OpenInternal(const std::string& file_name,
     ignore_result(ExecuteWithTimeout(sql.c_str(), kBusyTimeout));
   }
 
+  // Builds of SQLite which predate memory-mapped I/O ignore this.
+  if (mmap_size_ != 0) {
+    const std::string sql = base::StringPrintf(
+        "PRAGMA mmap_size=%" PRId64, mmap_size_);
+    ignore_result(ExecuteWithTimeout(sql.c_str(), kBusyTimeout));
+  }
+
+  if (temp_store_ != TEMP_STORE_DEFAULT) {
+    ignore_result(Execute(temp_store_ == TEMP_STORE_MEMORY ?
+                          "PRAGMA temp_store = MEMORY" :
+                          "PRAGMA temp_store = FILE"));
+  }
+
   if (!ExecuteWithTimeout("PRAGMA secure_delete=ON", kBusyTimeout)) {
     bool was_poisoned = poisoned_;
     Close();
@@ -1017,6 +1091,157 @@ void Connection::DoRollback() {
   needs_rollback_ = false;
 }
 
+void Connection::EnableStatementProfiling(base::TimeDelta slow_threshold) {
+  profiling_enabled_ = true;
+  slow_statement_threshold_ = slow_threshold;
+}
+
+void Connection::DisableStatementProfiling() {
+  profiling_enabled_ = false;
+}
+
+Connection::StatementProfiles Connection::GetStatementProfiles() const {
+  StatementProfiles profiles;
+  for (StatementProfileMap::const_iterator i = statement_profiles_.begin();
+       i != statement_profiles_.end(); ++i) {
+    profiles.push_back(i->second);
+  }
+  std::sort(profiles.begin(), profiles.end(), MoreExpensive);
+  return profiles;
+}
+
+void Connection::ResetStatementProfiles() {
+  statement_profiles_.clear();
+}
+
+int Connection::ProfiledStep(StatementRef* ref) {
+  sqlite3_stmt* stmt = ref->stmt();
+  const std::string name =
+      ref->profile_name().empty() ? sqlite3_sql(stmt) : ref->profile_name();
+  TRACE_EVENT1("sql", "Statement::Step", "statement",
+               TRACE_STR_COPY(name.c_str()));
+
+  // Cache misses are counted per connection, which is fine as steps
+  // on one connection do not interleave.
+  int misses_before = 0;
+  int misses_after = 0;
+#if defined(SQLITE_DBSTATUS_CACHE_MISS)
+  int unused = 0;
+  sqlite3_db_status(db_, SQLITE_DBSTATUS_CACHE_MISS, &misses_before,
+                    &unused, 0);
+#endif
+
+  const base::TimeTicks before = base::TimeTicks::Now();
+  int rc = sqlite3_step(stmt);
+  const base::TimeDelta elapsed = base::TimeTicks::Now() - before;
+
+#if defined(SQLITE_DBSTATUS_CACHE_MISS)
+  sqlite3_db_status(db_, SQLITE_DBSTATUS_CACHE_MISS, &misses_after,
+                    &unused, 0);
+#endif
+
+  StatementProfile& profile = statement_profiles_[name];
+  profile.name = name;
+  profile.total_time += elapsed;
+  profile.max_step_time = std::max(profile.max_step_time, elapsed);
+  profile.page_reads += misses_after - misses_before;
+  if (rc == SQLITE_ROW) {
+    ++profile.rows;
+  } else {
+    ++profile.executions;
+    profile.fullscan_steps +=
+        sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+    profile.sorts += sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_SORT, 1);
+  }
+
+  if (elapsed >= slow_statement_threshold_) {
+    LOG(WARNING) << histogram_tag_ << " slow sql statement ("
+                 << elapsed.InMilliseconds() << "ms): " << name;
+    TRACE_EVENT_COPY_INSTANT2("sql", "SlowStatement", TRACE_EVENT_SCOPE_THREAD,
+                              "statement", name,
+                              "ms", elapsed.InMilliseconds());
+  }
+  return rc;
+}
+
+bool Connection::Checkpoint() {
+  AssertIOAllowed();
+
+  if (!db_) {
+    DLOG_IF(FATAL, !poisoned_) << "Cannot checkpoint null db";
+    return false;
+  }
+
+  if (!use_wal_)
+    return true;
+
+  const base::TimeTicks before = base::TimeTicks::Now();
+  int rc = sqlite3_wal_checkpoint(db_, NULL);
+  if (rc != SQLITE_OK) {
+    UMA_HISTOGRAM_SPARSE_SLOWLY("Sqlite.CheckpointFailure", rc);
+    return false;
+  }
+  AddTimeHistogram("Sqlite.CheckpointTime", base::TimeTicks::Now() - before);
+  return true;
+}
+
+void Connection::ScheduleCheckpoint() {
+  if (!use_wal_)
+    return;
+
+  last_commit_time_ = base::TimeTicks::Now();
+  if (checkpoint_pending_ || !base::MessageLoop::current())
+    return;
+
+  checkpoint_pending_ = true;
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&Connection::CheckpointIfIdle, weak_factory_.GetWeakPtr()),
+      base::TimeDelta::FromSeconds(kCheckpointIdleSeconds));
+}
+
+void Connection::CheckpointIfIdle() {
+  checkpoint_pending_ = false;
+
+  // The next commit will schedule another attempt.
+  if (!db_ || transaction_nesting_ > 0)
+    return;
+
+  // Commits arrived since this was posted, wait for them to settle.
+  const base::TimeDelta idle_delay =
+      base::TimeDelta::FromSeconds(kCheckpointIdleSeconds);
+  const base::TimeDelta idle = base::TimeTicks::Now() - last_commit_time_;
+  if (idle < idle_delay) {
+    checkpoint_pending_ = true;
+    base::MessageLoop::current()->PostDelayedTask(
+        FROM_HERE,
+        base::Bind(&Connection::CheckpointIfIdle, weak_factory_.GetWeakPtr()),
+        idle_delay - idle);
+    return;
+  }
+
+  ignore_result(Checkpoint());
+}
+
+void Connection::SetJournalMode(bool wal) {
+  // http://www.sqlite.org/pragma.html#pragma_journal_mode
+  // DELETE (default) - delete -journal file to commit.
+  // TRUNCATE - truncate -journal file to commit.
+  // PERSIST - zero out header of -journal file to commit.
+  // WAL - append to -wal file to commit, checkpoint later.
+  // TODO(shess): Figure out if PERSIST and journal_size_limit really
+  // matter.  In theory, it keeps pages pre-allocated, so if
+  // transactions usually fit, it should be faster.
+  if (wal) {
+    // In WAL mode, NORMAL only syncs at checkpoint, which cannot
+    // corrupt the database but may lose the last few commits.
+    ignore_result(Execute("PRAGMA journal_mode = WAL"));
+    ignore_result(Execute("PRAGMA synchronous = NORMAL"));
+  } else {
+    ignore_result(Execute("PRAGMA journal_mode = PERSIST"));
+  }
+}
+
 void Connection::StatementRefCreated(StatementRef* ref) {
   DCHECK(open_statements_.find(ref) == open_statements_.end());
   open_statements_.insert(ref);
@@ -1048,6 +1273,28 @@ void Connection::AddTaggedHistogram(const std::string& name,
     histogram->Add(sample);
 }
 
+void Connection::AddTimeHistogram(const std::string& name,
+                                  base::TimeDelta sample) const {
+  base::HistogramBase* histogram =
+      base::Histogram::FactoryTimeGet(
+          name, base::TimeDelta::FromMilliseconds(1),
+          base::TimeDelta::FromSeconds(10), 50,
+          base::HistogramBase::kUmaTargetedHistogramFlag);
+  if (histogram)
+    histogram->AddTime(sample);
+
+  if (histogram_tag_.empty())
+    return;
+
+  histogram =
+      base::Histogram::FactoryTimeGet(
+          name + "." + histogram_tag_, base::TimeDelta::FromMilliseconds(1),
+          base::TimeDelta::FromSeconds(10), 50,
+          base::HistogramBase::kUmaTargetedHistogramFlag);
+  if (histogram)
+    histogram->AddTime(sample);
+}
+
 int Connection::OnSqliteError(int err, sql::Statement *stmt, const char* sql) {
   UMA_HISTOGRAM_SPARSE_SLOWLY("Sqlite.Error", err);
   AddTaggedHistogram("Sqlite.Error", err);
@@ -15,6 +15,7 @@
 #include "base/compiler_specific.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "base/threading/thread_restrictions.h"
 #include "base/time/time.h"
 #include "sql/sql_export.h"
@@ -70,6 +71,10 @@ class StatementID {
   // We need this to insert into our map.
   bool operator<(const StatementID& other) const;
 
+  // Returns "file:line", or the user-defined name.  Used to label
+  // statement profiles.
+  std::string ToString() const;
+
  private:
   int number_;
   const char* str_;
@@ -123,6 +128,35 @@ class SQL_EXPORT Connection {
   // other platforms.
   void set_restrict_to_user() { restrict_to_user_ = true; }
 
+  // Call to use write-ahead logging instead of a rollback journal.  In
+  // WAL mode commits append to the -wal file and only need to sync it,
+  // readers do not block writers, and "PRAGMA synchronous" is lowered
+  // to NORMAL (a power loss may lose the most recent commits but will
+  // not corrupt the database).  The WAL is folded back into the
+  // database by Checkpoint(), which is scheduled automatically once
+  // the connection has been idle for a while after a commit, provided
+  // the connection lives on a thread with a MessageLoop.  Has no
+  // effect for in-memory or temporary databases.
+  //
+  // This must be called before Open() to have an effect.
+  void set_write_ahead_logging() { use_wal_ = true; }
+
+  // Sets the maximum number of bytes of the database file which SQLite
+  // will access through memory-mapped I/O rather than read() calls.
+  // Zero (the default) leaves SQLite's compiled-in default in place.
+  // This must be called before Open() to have an effect.
+  void set_mmap_size(int64 mmap_size) { mmap_size_ = mmap_size; }
+
+  // Where SQLite keeps temporary tables and indices (used, for
+  // instance, by large ORDER BY or GROUP BY queries).  This must be
+  // called before Open() to have an effect.
+  enum TempStore {
+    TEMP_STORE_DEFAULT,
+    TEMP_STORE_FILE,
+    TEMP_STORE_MEMORY,
+  };
+  void set_temp_store(TempStore temp_store) { temp_store_ = temp_store; }
+
   // Set an error-handling callback.  On errors, the error number (and
   // statement, if available) will be passed to the callback.
   //
@@ -150,6 +184,57 @@ class SQL_EXPORT Connection {
   // histogram is recorded.
   void AddTaggedHistogram(const std::string& name, size_t sample) const;
 
+  // Record a timing UMA histogram sample under |name|, and also under
+  // |name|+"."+|histogram_tag_| if |histogram_tag_| is not empty.
+  void AddTimeHistogram(const std::string& name,
+                        base::TimeDelta sample) const;
+
+  // Statement profiling -------------------------------------------------------
+
+  // Cumulative cost of one statement.  Statements from
+  // GetCachedStatement() are identified by their StatementID, others
+  // by their SQL text.  Execute() bypasses Statement and is not
+  // profiled.
+  struct SQL_EXPORT StatementProfile {
+    StatementProfile();
+    ~StatementProfile();
+
+    std::string name;
+
+    // Number of times the statement ran to completion (or error).
+    int64 executions;
+
+    // Number of rows returned by Step().
+    int64 rows;
+
+    // Pages read from disk rather than from the page cache.  Zero if
+    // the SQLite build does not track cache misses.
+    int64 page_reads;
+
+    // Rows visited by full table scans and sorts done without an
+    // index.  Non-zero values often indicate a missing index.
+    int64 fullscan_steps;
+    int64 sorts;
+
+    // Time spent in sqlite3_step(), in total and for the slowest step.
+    base::TimeDelta total_time;
+    base::TimeDelta max_step_time;
+  };
+  typedef std::vector<StatementProfile> StatementProfiles;
+
+  // Start accumulating StatementProfile data for statements run on
+  // this connection.  Steps which take longer than |slow_threshold|
+  // are logged and emitted as "sql" trace events, as is every step
+  // while the "sql" trace category is enabled.  Profiling costs a few
+  // clock reads per step, so it is meant for diagnostics.
+  void EnableStatementProfiling(base::TimeDelta slow_threshold);
+  void DisableStatementProfiling();
+  bool statement_profiling_enabled() const { return profiling_enabled_; }
+
+  // Returns the accumulated profiles, most expensive first.
+  StatementProfiles GetStatementProfiles() const;
+  void ResetStatementProfiles();
+
   // Run "PRAGMA integrity_check" and post each line of
   // results into |messages|.  Returns the success of running the
   // statement - per the SQLite documentation, if no errors are found the
@@ -206,6 +291,12 @@ class SQL_EXPORT Connection {
   // usage by half.
   void TrimMemory(bool aggressively);
 
+  // Copy the contents of the write-ahead log back into the database
+  // file, without blocking readers or writers.  Returns true if the
+  // checkpoint ran (or if the database is not in WAL mode).  This is
+  // normally done automatically, see set_write_ahead_logging().
+  bool Checkpoint();
+
   // Raze the database to the ground.  This approximates creating a
   // fresh database from scratch, within the constraints of SQLite's
   // locking protocol (locks and open handles can make doing this with
@@ -488,6 +579,10 @@ class SQL_EXPORT Connection {
     // this will return NULL.
     sqlite3_stmt* stmt() const { return stmt_; }
 
+    // Label for statement profiles, empty to use the SQL text.
+    void set_profile_name(const std::string& name) { profile_name_ = name; }
+    const std::string& profile_name() const { return profile_name_; }
+
     // Destroys the compiled statement and marks it NULL. The statement will
     // no longer be active.  |forced| is used to indicate if orderly-shutdown
     // checks should apply (see Connection::RazeAndClose()).
@@ -505,6 +600,7 @@ class SQL_EXPORT Connection {
     Connection* connection_;
     sqlite3_stmt* stmt_;
     bool was_valid_;
+    std::string profile_name_;
 
     DISALLOW_COPY_AND_ASSIGN(StatementRef);
   };
@@ -514,6 +610,21 @@ class SQL_EXPORT Connection {
   // internally in the transaction management code.
   void DoRollback();
 
+  // Called after a successful commit.  In WAL mode, arranges for
+  // CheckpointIfIdle() to run once the connection goes idle.
+  void ScheduleCheckpoint();
+  void CheckpointIfIdle();
+
+  // Switches the journal mode of an open database between WAL (if
+  // |use_wal_|) and the rollback journal used otherwise.  Raze() and
+  // Recovery leave WAL mode around sqlite3_backup, which cannot write
+  // to a WAL database with a different page size.
+  void SetJournalMode(bool wal);
+
+  // sqlite3_step() |ref|'s statement, accumulating its profile.  Used
+  // by Statement while profiling is enabled.
+  int ProfiledStep(StatementRef* ref);
+
   // Called by a StatementRef when it's being created or destroyed. See
   // open_statements_ below.
   void StatementRefCreated(StatementRef* ref);
@@ -557,6 +668,9 @@ class SQL_EXPORT Connection {
   int cache_size_;
   bool exclusive_locking_;
   bool restrict_to_user_;
+  bool use_wal_;
+  int64 mmap_size_;
+  TempStore temp_store_;
 
   // All cached statements. Keeping a reference to these statements means that
   // they'll remain active.
@@ -593,6 +707,19 @@ class SQL_EXPORT Connection {
   // Tag for auxiliary histograms.
   std::string histogram_tag_;
 
+  // Time of the most recent commit, and whether a CheckpointIfIdle()
+  // task is pending.  Only used in WAL mode.
+  base::TimeTicks last_commit_time_;
+  bool checkpoint_pending_;
+
+  // Statement profiling state, keyed by StatementProfile::name.
+  bool profiling_enabled_;
+  base::TimeDelta slow_statement_threshold_;
+  typedef std::map<std::string, StatementProfile> StatementProfileMap;
+  StatementProfileMap statement_profiles_;
+
+  base::WeakPtrFactory<Connection> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(Connection);
 };
 
@@ -663,6 +663,98 @@ TEST_F(SQLConnectionTest, Delete) {
   EXPECT_FALSE(base::PathExists(journal));
 }
 
+TEST_F(SQLConnectionTest, WriteAheadLog) {
+  db().Close();
+  db().set_write_ahead_logging();
+  ASSERT_TRUE(db().Open(db_path()));
+
+  {
+    sql::Statement s(db().GetUniqueStatement("PRAGMA journal_mode"));
+    ASSERT_TRUE(s.Step());
+    EXPECT_EQ("wal", s.ColumnString(0));
+  }
+
+  ASSERT_TRUE(db().BeginTransaction());
+  ASSERT_TRUE(db().Execute("CREATE TABLE x (x)"));
+  ASSERT_TRUE(db().Execute("INSERT INTO x VALUES (1)"));
+  ASSERT_TRUE(db().CommitTransaction());
+
+  base::FilePath wal(db_path().value() + FILE_PATH_LITERAL("-wal"));
+  EXPECT_TRUE(base::PathExists(wal));
+  EXPECT_TRUE(db().Checkpoint());
+
+  // Raze() must work around sqlite3_backup's WAL restrictions, and
+  // leave the database in WAL mode.
+  ASSERT_TRUE(db().Raze());
+  EXPECT_EQ(0, SqliteMasterCount(&db()));
+  {
+    sql::Statement s(db().GetUniqueStatement("PRAGMA journal_mode"));
+    ASSERT_TRUE(s.Step());
+    EXPECT_EQ("wal", s.ColumnString(0));
+  }
+
+  ASSERT_TRUE(db().Execute("CREATE TABLE y (y)"));
+  db().Close();
+
+  ASSERT_TRUE(sql::Connection::Delete(db_path()));
+  EXPECT_FALSE(base::PathExists(wal));
+}
+
+TEST_F(SQLConnectionTest, StatementProfiling) {
+  ASSERT_TRUE(db().Execute("CREATE TABLE foo (a, b)"));
+  db().EnableStatementProfiling(base::TimeDelta::FromSeconds(60));
+
+  const sql::StatementID kInsertId = SQL_FROM_HERE;
+  for (int i = 0; i < 3; ++i) {
+    sql::Statement s(db().GetCachedStatement(
+        kInsertId, "INSERT INTO foo (a, b) VALUES (?, ?)"));
+    s.BindInt(0, i);
+    s.BindInt(1, i);
+    ASSERT_TRUE(s.Run());
+  }
+
+  const char kSelectSql[] = "SELECT a FROM foo WHERE b > 0";
+  {
+    sql::Statement s(db().GetUniqueStatement(kSelectSql));
+    while (s.Step()) {
+    }
+  }
+
+  sql::Connection::StatementProfiles profiles = db().GetStatementProfiles();
+  ASSERT_EQ(2u, profiles.size());
+  for (size_t i = 0; i < profiles.size(); ++i) {
+    const sql::Connection::StatementProfile& profile = profiles[i];
+    if (profile.name == kInsertId.ToString()) {
+      EXPECT_EQ(3, profile.executions);
+      EXPECT_EQ(0, profile.rows);
+    } else {
+      EXPECT_EQ(kSelectSql, profile.name);
+      EXPECT_EQ(1, profile.executions);
+      EXPECT_EQ(2, profile.rows);
+      EXPECT_LT(0, profile.fullscan_steps);
+    }
+  }
+  if (profiles.size() > 1)
+    EXPECT_GE(profiles[0].total_time, profiles[1].total_time);
+
+  db().DisableStatementProfiling();
+  db().ResetStatementProfiles();
+  ASSERT_TRUE(db().Execute("DELETE FROM foo"));
+  EXPECT_TRUE(db().GetStatementProfiles().empty());
+}
+
+TEST_F(SQLConnectionTest, MmapSizeAndTempStore) {
+  db().Close();
+  db().set_mmap_size(1024 * 1024);
+  db().set_temp_store(sql::Connection::TEMP_STORE_MEMORY);
+  ASSERT_TRUE(db().Open(db_path()));
+
+  // 2 is MEMORY.
+  sql::Statement s(db().GetUniqueStatement("PRAGMA temp_store"));
+  ASSERT_TRUE(s.Step());
+  EXPECT_EQ(2, s.ColumnInt(0));
+}
+
 #if defined(OS_POSIX)
 // Test that set_restrict_to_user() trims database permissions so that
 // only the owner (and root) can read.
@@ -178,6 +178,12 @@ bool Recovery::Init(const base::FilePath& db_path) {
   ignore_result(db_->Execute("PRAGMA locking_mode=NORMAL"));
   ignore_result(db_->Execute("SELECT COUNT(*) FROM sqlite_master"));
 
+  // In WAL mode, fold the log into the database file so that the
+  // recover virtual table sees the most recent data.  This is best
+  // effort, the database may well be too broken to checkpoint.
+  if (db_->use_wal_)
+    ignore_result(db_->Checkpoint());
+
   // TODO(shess): If this is a common failure case, it might be
   // possible to fall back to a memory database.  But it probably
   // implies that the SQLite tmpdir logic is busted, which could cause
@@ -259,6 +265,12 @@ bool Recovery::Backup() {
   // For now, this code attempts a best effort and records histograms
   // to inform future development.
 
+  // sqlite3_backup cannot write into a WAL database if the page sizes
+  // differ.  The handle is poisoned after this, and WAL mode is
+  // restored when it is next opened.
+  if (db_->use_wal_)
+    db_->SetJournalMode(false);
+
   // Backup the original db from the recovered db.
   const char* kMain = "main";
   sqlite3_backup* backup = sqlite3_backup_init(db_->db_, kMain,
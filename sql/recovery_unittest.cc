@@ -153,6 +153,31 @@ TEST_F(SQLRecoveryTest, RecoverBasic) {
             ExecuteWithResults(&db(), kXSql, "|", "\n"));
 }
 
+// Recovery must be able to replace a database which is in WAL mode.
+TEST_F(SQLRecoveryTest, RecoverWriteAheadLog) {
+  db().Close();
+  db().set_write_ahead_logging();
+  ASSERT_TRUE(db().Open(db_path()));
+
+  const char kCreateSql[] = "CREATE TABLE x (t TEXT)";
+  ASSERT_TRUE(db().Execute(kCreateSql));
+  ASSERT_TRUE(db().Execute("INSERT INTO x VALUES ('This is a test')"));
+
+  {
+    scoped_ptr<sql::Recovery> recovery = sql::Recovery::Begin(&db(), db_path());
+    ASSERT_TRUE(recovery.get());
+    ASSERT_TRUE(recovery->db()->Execute(kCreateSql));
+    ASSERT_TRUE(
+        recovery->db()->Execute("INSERT INTO x VALUES ('That was a test')"));
+    ASSERT_TRUE(sql::Recovery::Recovered(recovery.Pass()));
+  }
+  EXPECT_FALSE(db().is_open());
+  ASSERT_TRUE(Reopen());
+  ASSERT_EQ("That was a test",
+            ExecuteWithResults(&db(), "SELECT * FROM x", "|", "\n"));
+  ASSERT_EQ("wal", ExecuteWithResults(&db(), "PRAGMA journal_mode", "|", "\n"));
+}
+
 // The recovery virtual table is only supported for Chromium's SQLite.
 #if !defined(USE_SYSTEM_SQLITE)
 
@@ -58,7 +58,7 @@ bool Statement::Run() {
     return false;
 
   stepped_ = true;
-  return CheckError(sqlite3_step(ref_->stmt())) == SQLITE_DONE;
+  return CheckError(StepInternal()) == SQLITE_DONE;
 }
 
 bool Statement::Step() {
@@ -67,7 +67,14 @@ bool Statement::Step() {
     return false;
 
   stepped_ = true;
-  return CheckError(sqlite3_step(ref_->stmt())) == SQLITE_ROW;
+  return CheckError(StepInternal()) == SQLITE_ROW;
+}
+
+int Statement::StepInternal() {
+  Connection* connection = ref_->connection();
+  if (connection && connection->statement_profiling_enabled())
+    return connection->ProfiledStep(ref_.get());
+  return sqlite3_step(ref_->stmt());
 }
 
 void Statement::Reset(bool clear_bound_vars) {
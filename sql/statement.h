@@ -155,6 +155,9 @@ class SQL_EXPORT Statement {
   // enhanced in the future to do the notification.
   int CheckError(int err);
 
+  // Steps the statement, through the connection's profiler if enabled.
+  int StepInternal();
+
   // Contraction for checking an error code against SQLITE_OK. Does not set the
   // succeeded flag.
   bool CheckOk(int err) const;
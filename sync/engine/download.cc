@@ -90,7 +90,9 @@ SyncerError ExecuteDownloadUpdates(
     sync_pb::ClientToServerMessage* msg) {
   sync_pb::ClientToServerResponse update_response;
   StatusController* status = session->mutable_status_controller();
-  bool need_encryption_key = ShouldRequestEncryptionKey(session->context());
+  // Reuse the decision InitDownloadUpdatesContext() recorded in |msg| rather
+  // than taking another directory read transaction for every batch.
+  bool need_encryption_key = msg->get_updates().need_encryption_key();
 
   if (session->context()->debug_info_getter()) {
     sync_pb::DebugInfo* debug_info = msg->mutable_debug_info();
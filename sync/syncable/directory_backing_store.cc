@@ -98,15 +98,30 @@ scoped_ptr<EntryKernel> UnpackEntry(sql::Statement* statement) {
                 statement->ColumnString(i));
   }
   for ( ; i < PROTO_FIELDS_END; ++i) {
+    const void* blob = statement->ColumnBlob(i);
+    const int blob_length = statement->ColumnByteLength(i);
+    if (!blob_length)
+      continue;
+
+    // For synced entries the local and server specifics are usually
+    // identical, and copying the already parsed message is cheaper than
+    // parsing it again.
+    if (i > PROTO_FIELDS_BEGIN &&
+        blob_length == statement->ColumnByteLength(i - 1) &&
+        memcmp(blob, statement->ColumnBlob(i - 1), blob_length) == 0) {
+      kernel->mutable_ref(static_cast<ProtoField>(i)).CopyFrom(
+          kernel->ref(static_cast<ProtoField>(i - 1)));
+      continue;
+    }
     kernel->mutable_ref(static_cast<ProtoField>(i)).ParseFromArray(
-        statement->ColumnBlob(i), statement->ColumnByteLength(i));
+        blob, blob_length);
   }
   for ( ; i < UNIQUE_POSITION_FIELDS_END; ++i) {
-    std::string temp;
-    statement->ColumnBlobAsString(i, &temp);
-
+    // Parse straight from the column rather than through a temporary
+    // string; this runs twice for every entry at startup.
     sync_pb::UniquePosition proto;
-    if (!proto.ParseFromString(temp)) {
+    if (!proto.ParseFromArray(statement->ColumnBlob(i),
+                              statement->ColumnByteLength(i))) {
       DVLOG(1) << "Unpacked invalid position.  Assuming the DB is corrupt";
       return scoped_ptr<EntryKernel>();
     }
@@ -218,10 +233,11 @@ bool DirectoryBackingStore::SaveChanges(
     return false;
 
   PrepareSaveEntryStatement(METAS_TABLE, &save_meta_statment_);
+  PrepareUpdateMetaStatement();
   for (EntryKernelSet::const_iterator i = snapshot.dirty_metas.begin();
        i != snapshot.dirty_metas.end(); ++i) {
     DCHECK((*i)->is_dirty());
-    if (!SaveEntryToDB(&save_meta_statment_, **i))
+    if (!UpdateEntryToDB(**i))
       return false;
   }
 
@@ -598,6 +614,20 @@ bool DirectoryBackingStore::SaveEntryToDB(sql::Statement* save_statement,
   return save_statement->Run();
 }
 
+bool DirectoryBackingStore::UpdateEntryToDB(const EntryKernel& entry) {
+  // Most dirty entries already have a row. INSERT OR REPLACE would delete
+  // that row and append a new one, rewriting the metahandle index and
+  // usually a second table page; an UPDATE rewrites the row where it is.
+  update_meta_statement_.Reset(true);
+  BindFields(entry, &update_meta_statement_);
+  if (!update_meta_statement_.Run())
+    return false;
+  if (db_->GetLastChangeCount() > 0)
+    return true;
+
+  return SaveEntryToDB(&save_meta_statment_, entry);
+}
+
 bool DirectoryBackingStore::DropDeletedEntries() {
   if (!db_->Execute("DELETE FROM metas "
                     "WHERE is_del > 0 "
@@ -1500,5 +1530,28 @@ void DirectoryBackingStore::PrepareSaveEntryStatement(
       base::StringPrintf(query.c_str(), "metas").c_str()));
 }
 
+void DirectoryBackingStore::PrepareUpdateMetaStatement() {
+  if (update_meta_statement_.is_valid())
+    return;
+
+  // Parameters are numbered so that BindFields(), which binds every column
+  // in order, can be used as is: ?1 is the metahandle, which is only used to
+  // find the row and is left out of the SET list so that its index is not
+  // touched.
+  DCHECK_EQ(static_cast<int>(META_HANDLE), static_cast<int>(BEGIN_FIELDS));
+  string query;
+  query.reserve(kUpdateStatementBufferSize);
+  query.append("UPDATE metas SET ");
+  const char* separator = "";
+  for (int i = BEGIN_FIELDS + 1; i < FIELD_COUNT; ++i) {
+    query.append(separator);
+    separator = ", ";
+    query.append(ColumnName(i));
+    query.append(base::StringPrintf(" = ?%d", i + 1));
+  }
+  query.append(" WHERE metahandle = ?1");
+  update_meta_statement_.Assign(db_->GetUniqueStatement(query.c_str()));
+}
+
 }  // namespace syncable
 }  // namespace syncer
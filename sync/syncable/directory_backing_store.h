@@ -104,6 +104,8 @@ class SYNC_EXPORT_PRIVATE DirectoryBackingStore : public base::NonThreadSafe {
   static bool SaveEntryToDB(sql::Statement* save_statement,
                             const EntryKernel& entry);
   bool SaveNewEntryToDB(const EntryKernel& entry);
+  // Updates the existing metas row for |entry| in place, or inserts it if
+  // there is none.
   bool UpdateEntryToDB(const EntryKernel& entry);
 
   // Close save_dbhandle_.  Broken out for testing.
@@ -173,6 +175,7 @@ class SYNC_EXPORT_PRIVATE DirectoryBackingStore : public base::NonThreadSafe {
 
   scoped_ptr<sql::Connection> db_;
   sql::Statement save_meta_statment_;
+  sql::Statement update_meta_statement_;
   sql::Statement save_delete_journal_statment_;
   std::string dir_name_;
 
@@ -185,6 +188,9 @@ class SYNC_EXPORT_PRIVATE DirectoryBackingStore : public base::NonThreadSafe {
   void PrepareSaveEntryStatement(EntryTable table,
                                  sql::Statement* save_statement);
 
+  // Prepares |update_meta_statement_|.
+  void PrepareUpdateMetaStatement();
+
   DISALLOW_COPY_AND_ASSIGN(DirectoryBackingStore);
 };
 
@@ -799,6 +799,10 @@ void ChromiumEnv::Schedule(void (*function)(void*), void* arg) {
 
 void ChromiumEnv::BGThread() {
   base::PlatformThread::SetName(name_.c_str());
+  // Compactions are deferrable; keep them from competing with
+  // foreground reads and writes.
+  base::PlatformThread::SetThreadPriority(
+      base::PlatformThread::CurrentHandle(), base::kThreadPriority_Background);
 
   while (true) {
     // Wait until there is an item that is ready to run
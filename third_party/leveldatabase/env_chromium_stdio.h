@@ -54,6 +54,13 @@ class ChromiumEnvStdio : public ChromiumEnv {
   virtual leveldb::Status NewLogger(const std::string& fname,
                                     leveldb::Logger** result);
 
+  // Table files are memory-mapped while fewer than a fixed number of
+  // mappings are live (64-bit builds only, to bound address space use).
+  // Returns true if the caller may map one more file, in which case it
+  // must call ReleaseMmap() when unmapping it.
+  bool AcquireMmap();
+  void ReleaseMmap();
+
  protected:
   virtual base::File::Error GetDirectoryEntries(
       const base::FilePath& dir_param,
@@ -66,6 +73,9 @@ class ChromiumEnvStdio : public ChromiumEnv {
     reinterpret_cast<ChromiumEnvStdio*>(arg)->BGThread();
   }
   void RecordOpenFilesLimit(const std::string& type);
+
+  base::Lock mmap_lock_;
+  int mmaps_available_;
 };
 
 }  // namespace leveldb_env
@@ -7,6 +7,7 @@
 #include "base/files/file_enumerator.h"
 #include "base/files/file_path.h"
 #include "base/files/scoped_temp_dir.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/test/test_suite.h"
 #include "env_chromium_stdio.h"
 #if defined(OS_WIN)
@@ -255,4 +256,30 @@ TEST(ChromiumEnv, GetChildrenPriorResults) {
   EXPECT_EQ(1, result.size());
 }
 
+TEST(ChromiumEnv, RandomAccessTableFile) {
+  base::ScopedTempDir scoped_temp_dir;
+  ASSERT_TRUE(scoped_temp_dir.CreateUniqueTempDir());
+  base::FilePath table_path = scoped_temp_dir.path().Append(FPL("000005.ldb"));
+  const char kContents[] = "0123456789";
+  ASSERT_EQ(static_cast<int>(sizeof(kContents) - 1),
+            base::WriteFile(table_path, kContents, sizeof(kContents) - 1));
+
+  ChromiumEnvStdio env;
+  RandomAccessFile* raw_file = NULL;
+  Status status =
+      env.NewRandomAccessFile(table_path.AsUTF8Unsafe(), &raw_file);
+  ASSERT_TRUE(status.ok());
+  scoped_ptr<RandomAccessFile> file(raw_file);
+
+  char scratch[10];
+  Slice result;
+  EXPECT_TRUE(file->Read(2, 4, &result, scratch).ok());
+  EXPECT_EQ("2345", result.ToString());
+
+  // Reads past the end never return data from beyond the end.
+  status = file->Read(8, 4, &result, scratch);
+  if (status.ok())
+    EXPECT_EQ("89", result.ToString());
+}
+
 int main(int argc, char** argv) { return base::TestSuite(argc, argv).Run(); }
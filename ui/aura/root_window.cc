@@ -29,6 +29,7 @@
 #include "ui/compositor/layer.h"
 #include "ui/compositor/layer_animator.h"
 #include "ui/events/event.h"
+#include "ui/events/event_switches.h"
 #include "ui/events/gestures/gesture_recognizer.h"
 #include "ui/events/gestures/gesture_types.h"
 #include "ui/gfx/screen.h"
@@ -44,6 +45,10 @@ namespace {
 const char kRootWindowForAcceleratedWidget[] =
     "__AURA_ROOT_WINDOW_ACCELERATED_WIDGET__";
 
+// The longest a frame-aligned hold on pointer moves lasts when the compositor
+// doesn't draw anything, about one frame at 60Hz.
+const int kMaxFrameHoldMs = 17;
+
 // Returns true if |target| has a non-client (frame) component at |location|,
 // in window coordinates.
 bool IsNonClientLocation(Window* target, const gfx::Point& location) {
@@ -78,16 +83,6 @@ WindowTreeHost* CreateHost(WindowEventDispatcher* dispatcher,
   return host;
 }
 
-bool IsEventCandidateForHold(const ui::Event& event) {
-  if (event.type() == ui::ET_TOUCH_MOVED)
-    return true;
-  if (event.type() == ui::ET_MOUSE_DRAGGED)
-    return true;
-  if (event.IsMouseEvent() && (event.flags() & ui::EF_IS_SYNTHESIZED))
-    return true;
-  return false;
-}
-
 }  // namespace
 
 WindowEventDispatcher::CreateParams::CreateParams(
@@ -110,6 +105,10 @@ WindowEventDispatcher::WindowEventDispatcher(const CreateParams& params)
       synthesize_mouse_move_(false),
       move_hold_count_(0),
       dispatching_held_event_(false),
+      align_pointer_moves_to_frames_(
+          CommandLine::ForCurrentProcess()->HasSwitch(
+              switches::kEnableFrameAlignedPointerMoves)),
+      holding_pointer_moves_for_frame_(false),
       repost_event_factory_(this),
       held_event_factory_(this) {
   window()->set_dispatcher(this);
@@ -121,12 +120,16 @@ WindowEventDispatcher::WindowEventDispatcher(const CreateParams& params)
                                kRootWindowForAcceleratedWidget,
                                this));
   ui::GestureRecognizer::Get()->AddGestureEventHelper(this);
+  if (host_->compositor())
+    host_->compositor()->AddObserver(this);
 }
 
 WindowEventDispatcher::~WindowEventDispatcher() {
   TRACE_EVENT0("shutdown", "WindowEventDispatcher::Destructor");
 
   ui::GestureRecognizer::Get()->RemoveGestureEventHelper(this);
+  if (host_->compositor())
+    host_->compositor()->RemoveObserver(this);
 
   // An observer may have been added by an animation on the
   // WindowEventDispatcher.
@@ -338,6 +341,13 @@ void WindowEventDispatcher::ReleasePointerMoves() {
   TRACE_EVENT_ASYNC_END0("ui", "WindowEventDispatcher::HoldPointerMoves", this);
 }
 
+void WindowEventDispatcher::SetAlignPointerMovesToFramesForTesting(
+    bool align) {
+  align_pointer_moves_to_frames_ = align;
+  if (!align)
+    ReleasePointerMovesForFrame();
+}
+
 gfx::Point WindowEventDispatcher::GetLastMouseLocationInRoot() const {
   gfx::Point location = Env::GetInstance()->last_mouse_location();
   client::ScreenPositionClient* client =
@@ -516,6 +526,29 @@ void WindowEventDispatcher::ReleaseNativeCapture() {
   host_->ReleaseCapture();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// WindowEventDispatcher, ui::CompositorObserver implementation:
+
+void WindowEventDispatcher::OnCompositingDidCommit(
+    ui::Compositor* compositor) {
+}
+
+void WindowEventDispatcher::OnCompositingStarted(ui::Compositor* compositor,
+                                                 base::TimeTicks start_time) {
+}
+
+void WindowEventDispatcher::OnCompositingEnded(ui::Compositor* compositor) {
+  ReleasePointerMovesForFrame();
+}
+
+void WindowEventDispatcher::OnCompositingAborted(ui::Compositor* compositor) {
+  ReleasePointerMovesForFrame();
+}
+
+void WindowEventDispatcher::OnCompositingLockStateChanged(
+    ui::Compositor* compositor) {
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // WindowEventDispatcher, ui::EventProcessor implementation:
 ui::EventTarget* WindowEventDispatcher::GetRootTarget() {
@@ -778,6 +811,40 @@ ui::EventDispatchDetails WindowEventDispatcher::SynthesizeMouseMoveEvent() {
   return OnEventFromSource(&event);
 }
 
+void WindowEventDispatcher::HoldPointerMovesUntilNextFrame() {
+  if (!align_pointer_moves_to_frames_ || holding_pointer_moves_for_frame_)
+    return;
+  holding_pointer_moves_for_frame_ = true;
+  // Unlike HoldPointerMoves(), don't invalidate |held_event_factory_|: this is
+  // called while a move is dispatched, and a pending synthesized mouse move
+  // must still be delivered.
+  ++move_hold_count_;
+  frame_hold_timer_.Start(
+      FROM_HERE, base::TimeDelta::FromMilliseconds(kMaxFrameHoldMs),
+      this, &WindowEventDispatcher::ReleasePointerMovesForFrame);
+}
+
+void WindowEventDispatcher::ReleasePointerMovesForFrame() {
+  if (!holding_pointer_moves_for_frame_)
+    return;
+  holding_pointer_moves_for_frame_ = false;
+  frame_hold_timer_.Stop();
+  ReleasePointerMoves();
+}
+
+bool WindowEventDispatcher::IsEventCandidateForHold(
+    const ui::Event& event) const {
+  if (event.type() == ui::ET_TOUCH_MOVED)
+    return true;
+  if (event.type() == ui::ET_MOUSE_DRAGGED)
+    return true;
+  if (event.type() == ui::ET_MOUSE_MOVED && align_pointer_moves_to_frames_)
+    return true;
+  if (event.IsMouseEvent() && (event.flags() & ui::EF_IS_SYNTHESIZED))
+    return true;
+  return false;
+}
+
 void WindowEventDispatcher::PreDispatchLocatedEvent(Window* target,
                                                     ui::LocatedEvent* event) {
   int flags = event->flags();
@@ -821,6 +888,14 @@ void WindowEventDispatcher::PreDispatchMouseEvent(Window* target,
     }
   }
 
+  // Coalesce the moves that arrive before the compositor has drawn the effect
+  // of this one.
+  if ((event->type() == ui::ET_MOUSE_MOVED ||
+       event->type() == ui::ET_MOUSE_DRAGGED) &&
+      !(event->flags() & ui::EF_IS_SYNTHESIZED)) {
+    HoldPointerMovesUntilNextFrame();
+  }
+
   const int kMouseButtonFlagMask = ui::EF_LEFT_MOUSE_BUTTON |
                                    ui::EF_MIDDLE_MOUSE_BUTTON |
                                    ui::EF_RIGHT_MOUSE_BUTTON;
@@ -13,12 +13,14 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/message_loop/message_loop.h"
+#include "base/timer/timer.h"
 #include "ui/aura/aura_export.h"
 #include "ui/aura/client/capture_delegate.h"
 #include "ui/aura/window_tree_host.h"
 #include "ui/aura/window_tree_host_delegate.h"
 #include "ui/base/cursor/cursor.h"
 #include "ui/compositor/compositor.h"
+#include "ui/compositor/compositor_observer.h"
 #include "ui/compositor/layer_animation_observer.h"
 #include "ui/events/event_constants.h"
 #include "ui/events/event_processor.h"
@@ -54,6 +56,7 @@ class WindowTargeter;
 class AURA_EXPORT WindowEventDispatcher : public ui::EventProcessor,
                                           public ui::GestureEventHelper,
                                           public ui::LayerAnimationObserver,
+                                          public ui::CompositorObserver,
                                           public client::CaptureDelegate,
                                           public WindowTreeHostDelegate {
  public:
@@ -168,6 +171,13 @@ class AURA_EXPORT WindowEventDispatcher : public ui::EventProcessor,
   void HoldPointerMoves();
   void ReleasePointerMoves();
 
+  // Enables or disables frame-aligned pointer moves, which are normally
+  // controlled by switches::kEnableFrameAlignedPointerMoves. When enabled,
+  // each dispatched mouse move holds further pointer moves until the
+  // compositor finishes its next frame, so that moves from high-frequency
+  // mice are coalesced to at most one per frame.
+  void SetAlignPointerMovesToFramesForTesting(bool align);
+
   // Gets the last location seen in a mouse event in this root window's
   // coordinates. This may return a point outside the root window's bounds.
   gfx::Point GetLastMouseLocationInRoot() const;
@@ -248,6 +258,15 @@ class AURA_EXPORT WindowEventDispatcher : public ui::EventProcessor,
   virtual void OnLayerAnimationAborted(
       ui::LayerAnimationSequence* animation) OVERRIDE;
 
+  // Overridden from ui::CompositorObserver:
+  virtual void OnCompositingDidCommit(ui::Compositor* compositor) OVERRIDE;
+  virtual void OnCompositingStarted(ui::Compositor* compositor,
+                                    base::TimeTicks start_time) OVERRIDE;
+  virtual void OnCompositingEnded(ui::Compositor* compositor) OVERRIDE;
+  virtual void OnCompositingAborted(ui::Compositor* compositor) OVERRIDE;
+  virtual void OnCompositingLockStateChanged(
+      ui::Compositor* compositor) OVERRIDE;
+
   // Overridden from aura::WindowTreeHostDelegate:
   virtual void OnHostCancelMode() OVERRIDE;
   virtual void OnHostActivated() OVERRIDE;
@@ -280,6 +299,14 @@ class AURA_EXPORT WindowEventDispatcher : public ui::EventProcessor,
   // is no a pending task.
   void PostMouseMoveEventAfterWindowChange();
 
+  // Holds pointer moves until the compositor's next frame ends, or until
+  // about a frame's time has passed if nothing is drawn. Does nothing unless
+  // |align_pointer_moves_to_frames_| is set or a frame hold is already active.
+  void HoldPointerMovesUntilNextFrame();
+  void ReleasePointerMovesForFrame();
+
+  bool IsEventCandidateForHold(const ui::Event& event) const;
+
   void PreDispatchLocatedEvent(Window* target, ui::LocatedEvent* event);
   void PreDispatchMouseEvent(Window* target, ui::MouseEvent* event);
   void PreDispatchTouchEvent(Window* target, ui::TouchEvent* event);
@@ -313,6 +340,14 @@ class AURA_EXPORT WindowEventDispatcher : public ui::EventProcessor,
   // Set when dispatching a held event.
   bool dispatching_held_event_;
 
+  // Whether mouse moves are coalesced per compositor frame, and whether the
+  // hold taken by HoldPointerMovesUntilNextFrame() is outstanding.
+  bool align_pointer_moves_to_frames_;
+  bool holding_pointer_moves_for_frame_;
+
+  // Releases the frame hold if the compositor doesn't draw a frame.
+  base::OneShotTimer<WindowEventDispatcher> frame_hold_timer_;
+
   scoped_ptr<ui::ViewProp> prop_;
 
   // Used to schedule reposting an event.
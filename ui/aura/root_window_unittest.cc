@@ -691,6 +691,52 @@ TEST_F(WindowEventDispatcherTest, MouseMovesHeld) {
   filter->Reset();
 }
 
+TEST_F(WindowEventDispatcherTest, MouseMovesAlignedToFrames) {
+  EventFilterRecorder* filter = new EventFilterRecorder;
+  root_window()->SetEventFilter(filter);  // passes ownership
+
+  test::TestWindowDelegate delegate;
+  scoped_ptr<aura::Window> window(CreateTestWindowWithDelegate(
+      &delegate, 1, gfx::Rect(0, 0, 100, 100), root_window()));
+
+  dispatcher()->SetAlignPointerMovesToFramesForTesting(true);
+
+  // The first move is dispatched immediately.
+  ui::MouseEvent mouse_move_event(ui::ET_MOUSE_MOVED, gfx::Point(1, 1),
+                                  gfx::Point(1, 1), 0, 0);
+  DispatchEventUsingWindowDispatcher(&mouse_move_event);
+  ASSERT_FALSE(filter->events().empty());
+  EXPECT_EQ(ui::ET_MOUSE_MOVED, filter->events().back());
+  filter->Reset();
+
+  // Moves before the next frame are coalesced.
+  ui::MouseEvent mouse_move_event2(ui::ET_MOUSE_MOVED, gfx::Point(5, 5),
+                                   gfx::Point(5, 5), 0, 0);
+  ui::MouseEvent mouse_move_event3(ui::ET_MOUSE_MOVED, gfx::Point(9, 9),
+                                   gfx::Point(9, 9), 0, 0);
+  DispatchEventUsingWindowDispatcher(&mouse_move_event2);
+  DispatchEventUsingWindowDispatcher(&mouse_move_event3);
+  EXPECT_TRUE(filter->events().empty());
+
+  // The latest move is dispatched once the frame ends.
+  static_cast<ui::CompositorObserver*>(dispatcher())->OnCompositingEnded(
+      dispatcher()->host()->compositor());
+  RunAllPendingInMessageLoop();
+  EXPECT_EQ("MOUSE_MOVED", EventTypesToString(filter->events()));
+  EXPECT_EQ(gfx::Point(9, 9), filter->mouse_location(0));
+  filter->Reset();
+
+  // Other events flush the held move first.
+  DispatchEventUsingWindowDispatcher(&mouse_move_event2);
+  ui::MouseEvent mouse_pressed_event(ui::ET_MOUSE_PRESSED, gfx::Point(5, 5),
+                                     gfx::Point(5, 5), 0, 0);
+  DispatchEventUsingWindowDispatcher(&mouse_pressed_event);
+  EXPECT_EQ("MOUSE_MOVED MOUSE_PRESSED",
+            EventTypesToString(filter->events()));
+
+  dispatcher()->SetAlignPointerMovesToFramesForTesting(false);
+}
+
 TEST_F(WindowEventDispatcherTest, TouchMovesHeld) {
   EventFilterRecorder* filter = new EventFilterRecorder;
   root_window()->SetEventFilter(filter);  // passes ownership
@@ -6,6 +6,10 @@
 
 namespace switches {
 
+// Coalesce mouse moves so that at most one is dispatched per compositor frame.
+const char kEnableFrameAlignedPointerMoves[] =
+    "enable-frame-aligned-pointer-moves";
+
 // Enable scroll prediction for scroll update events.
 const char kEnableScrollPrediction[] = "enable-scroll-prediction";
 
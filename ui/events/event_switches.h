@@ -10,6 +10,7 @@
 
 namespace switches {
 
+EVENTS_BASE_EXPORT extern const char kEnableFrameAlignedPointerMoves[];
 EVENTS_BASE_EXPORT extern const char kEnableScrollPrediction[];
 EVENTS_BASE_EXPORT extern const char kTouchEvents[];
 EVENTS_BASE_EXPORT extern const char kTouchEventsAuto[];
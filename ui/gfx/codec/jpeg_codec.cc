@@ -457,9 +457,18 @@ class DecompressDestroyer {
 
 }  // namespace
 
+// static
 bool JPEGCodec::Decode(const unsigned char* input, size_t input_size,
                        ColorFormat format, std::vector<unsigned char>* output,
                        int* w, int* h) {
+  return DecodeScaled(input, input_size, format, 0, 0, output, w, h);
+}
+
+// static
+bool JPEGCodec::DecodeScaled(const unsigned char* input, size_t input_size,
+                             ColorFormat format, int min_width, int min_height,
+                             std::vector<unsigned char>* output,
+                             int* w, int* h) {
   jpeg_decompress_struct cinfo;
   DecompressDestroyer destroyer;
   destroyer.SetManagedObject(&cinfo);
@@ -542,6 +551,22 @@ bool JPEGCodec::Decode(const unsigned char* input, size_t input_size,
   cinfo.output_components = 3;
 #endif
 
+  // Pick the smallest DCT scaling libjpeg supports that still covers the
+  // requested size. libjpeg rounds the scaled dimensions up.
+  cinfo.scale_num = 1;
+  cinfo.scale_denom = 1;
+  if (min_width > 0 && min_height > 0) {
+    while (cinfo.scale_denom < 8) {
+      unsigned int denom = cinfo.scale_denom * 2;
+      if ((cinfo.image_width + denom - 1) / denom <
+              static_cast<unsigned int>(min_width) ||
+          (cinfo.image_height + denom - 1) / denom <
+              static_cast<unsigned int>(min_height))
+        break;
+      cinfo.scale_denom = denom;
+    }
+  }
+
   jpeg_calc_output_dimensions(&cinfo);
   *w = cinfo.output_width;
   *h = cinfo.output_height;
@@ -613,10 +638,19 @@ bool JPEGCodec::Decode(const unsigned char* input, size_t input_size,
 
 // static
 SkBitmap* JPEGCodec::Decode(const unsigned char* input, size_t input_size) {
+  return DecodeScaled(input, input_size, 0, 0);
+}
+
+// static
+SkBitmap* JPEGCodec::DecodeScaled(const unsigned char* input,
+                                  size_t input_size,
+                                  int min_width, int min_height) {
   int w, h;
   std::vector<unsigned char> data_vector;
-  if (!Decode(input, input_size, FORMAT_SkBitmap, &data_vector, &w, &h))
+  if (!DecodeScaled(input, input_size, FORMAT_SkBitmap, min_width, min_height,
+                    &data_vector, &w, &h)) {
     return NULL;
+  }
 
   // Skia only handles 32 bit images.
   int data_length = w * h * 4;
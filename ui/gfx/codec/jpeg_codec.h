@@ -72,6 +72,21 @@ class GFX_EXPORT JPEGCodec {
   // successful, a SkBitmap is created and returned. It is up to the caller
   // to delete the returned bitmap.
   static SkBitmap* Decode(const unsigned char* input, size_t input_size);
+
+  // Same as the Decode above, but lets libjpeg scale the image down by 1/2,
+  // 1/4 or 1/8 while decoding, using the largest reduction that still leaves
+  // the output at least |min_width| x |min_height|. Scaling in the DCT domain
+  // is much cheaper than decoding at full size and resizing afterwards, and
+  // never allocates the full size image. The actual output dimensions are
+  // returned in *w and *h. If |min_width| or |min_height| is 0, the image is
+  // decoded at full size.
+  static bool DecodeScaled(const unsigned char* input, size_t input_size,
+                           ColorFormat format, int min_width, int min_height,
+                           std::vector<unsigned char>* output, int* w, int* h);
+
+  // Same as the SkBitmap Decode above, scaling down like DecodeScaled.
+  static SkBitmap* DecodeScaled(const unsigned char* input, size_t input_size,
+                                int min_width, int min_height);
 };
 
 }  // namespace gfx
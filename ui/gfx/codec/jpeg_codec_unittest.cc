@@ -197,6 +197,41 @@ TEST(JPEGCodec, DecodeCorrupted) {
                                  &outw, &outh));
 }
 
+TEST(JPEGCodec, DecodeScaled) {
+  int w = 160, h = 120;
+
+  std::vector<unsigned char> original;
+  MakeRGBImage(w, h, &original);
+
+  std::vector<unsigned char> encoded;
+  EXPECT_TRUE(JPEGCodec::Encode(&original[0], JPEGCodec::FORMAT_RGB, w, h,
+                                w * 3, jpeg_quality, &encoded));
+
+  // 1/4 scale is the smallest that still covers the requested size.
+  std::vector<unsigned char> decoded;
+  int outw, outh;
+  EXPECT_TRUE(JPEGCodec::DecodeScaled(&encoded[0], encoded.size(),
+                                      JPEGCodec::FORMAT_RGB, 35, 30, &decoded,
+                                      &outw, &outh));
+  EXPECT_EQ(40, outw);
+  EXPECT_EQ(30, outh);
+  EXPECT_EQ(static_cast<size_t>(outw * outh * 3), decoded.size());
+
+  // Requesting more than the full size decodes at full size.
+  EXPECT_TRUE(JPEGCodec::DecodeScaled(&encoded[0], encoded.size(),
+                                      JPEGCodec::FORMAT_RGB, 200, 200,
+                                      &decoded, &outw, &outh));
+  EXPECT_EQ(w, outw);
+  EXPECT_EQ(h, outh);
+
+  // 0 disables scaling.
+  EXPECT_TRUE(JPEGCodec::DecodeScaled(&encoded[0], encoded.size(),
+                                      JPEGCodec::FORMAT_RGB, 0, 0, &decoded,
+                                      &outw, &outh));
+  EXPECT_EQ(w, outw);
+  EXPECT_EQ(h, outh);
+}
+
 // Test that we can decode JPEG images without invalid-read errors on valgrind.
 // This test decodes a 1x1 JPEG image and writes the decoded RGB (or RGBA) pixel
 // to the output buffer without OOB reads.
@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 
+#include "base/debug/trace_event.h"
 #include "base/i18n/break_iterator.h"
 #include "base/logging.h"
 #include "third_party/skia/include/core/SkTypeface.h"
@@ -301,6 +302,7 @@ void RenderTextPango::ResetLayout() {
 
 void RenderTextPango::EnsureLayout() {
   if (layout_ == NULL) {
+    TRACE_EVENT0("ui", "RenderTextPango::EnsureLayout");
     cairo_surface_t* surface =
         cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 0, 0);
     CHECK_EQ(CAIRO_STATUS_SUCCESS, cairo_surface_status(surface));
@@ -8,7 +8,10 @@
 
 #include "base/i18n/break_iterator.h"
 #include "base/i18n/char_iterator.h"
+#include "base/containers/mru_cache.h"
+#include "base/debug/trace_event.h"
 #include "base/i18n/rtl.h"
+#include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
@@ -37,6 +40,9 @@ const size_t kMaxRuns = 10000;
 // The maximum number of glyphs per run; ScriptShape fails on larger values.
 const size_t kMaxGlyphs = 65535;
 
+// The number of shaped runs kept in |g_shaped_run_cache|; arbitrary value.
+const size_t kMaxCachedShapedRuns = 512;
+
 // Callback to |EnumEnhMetaFile()| to intercept font creation.
 int CALLBACK MetaFileEnumProc(HDC hdc,
                               HANDLETABLE* table,
@@ -264,6 +270,99 @@ bool IsUnusualBlockCode(const UBlockCode block_code) {
          block_code == UBLOCK_MISCELLANEOUS_SYMBOLS;
 }
 
+// The shaping and placement results of a TextRun, including the font chosen
+// by font fallback.
+struct ShapedRun {
+  Font font;
+  SCRIPT_ANALYSIS script_analysis;
+  std::vector<WORD> glyphs;
+  std::vector<WORD> logical_clusters;
+  std::vector<SCRIPT_VISATTR> visible_attributes;
+  std::vector<int> advance_widths;
+  std::vector<GOFFSET> offsets;
+  ABC abc_widths;
+};
+
+// Shaped runs shared by all RenderTextWin instances, keyed by
+// GetShapedRunKey(). The same strings are laid out over and over by tabs,
+// omnibox suggestions and bookmark buttons, and shaping (with font fallback
+// in particular) dominates their layout time. Only used on the UI thread,
+// like |RenderTextWin::cached_hdc_|.
+class ShapedRunCache : public base::MRUCache<std::string, ShapedRun> {
+ public:
+  ShapedRunCache() : base::MRUCache<std::string, ShapedRun>(
+      kMaxCachedShapedRuns) {}
+};
+
+base::LazyInstance<ShapedRunCache>::Leaky g_shaped_run_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+// Returns the key identifying |run| in |g_shaped_run_cache|. This must be
+// computed before the run is shaped, since shaping may change its font and
+// script analysis. |text| is the layout text.
+std::string GetShapedRunKey(const internal::TextRun& run,
+                            const base::string16& text) {
+  std::string key = run.font.GetFontName();
+  key.push_back('\0');
+  const int font_info[] = { run.font.GetFontSize(), run.font_style };
+  key.append(reinterpret_cast<const char*>(font_info), sizeof(font_info));
+  key.append(reinterpret_cast<const char*>(&run.script_analysis),
+             sizeof(run.script_analysis));
+  key.append(reinterpret_cast<const char*>(&text[run.range.start()]),
+             run.range.length() * sizeof(base::char16));
+  return key;
+}
+
+// Saves the shaping and placement results of |run|.
+ShapedRun SaveShapedRun(const internal::TextRun& run) {
+  ShapedRun shaped;
+  shaped.font = run.font;
+  shaped.script_analysis = run.script_analysis;
+  shaped.glyphs.assign(run.glyphs.get(), run.glyphs.get() + run.glyph_count);
+  shaped.logical_clusters.assign(
+      run.logical_clusters.get(),
+      run.logical_clusters.get() + run.range.length());
+  shaped.visible_attributes.assign(
+      run.visible_attributes.get(),
+      run.visible_attributes.get() + run.glyph_count);
+  if (run.glyph_count > 0) {
+    shaped.advance_widths.assign(run.advance_widths.get(),
+                                 run.advance_widths.get() + run.glyph_count);
+    shaped.offsets.assign(run.offsets.get(),
+                          run.offsets.get() + run.glyph_count);
+  }
+  shaped.abc_widths = run.abc_widths;
+  return shaped;
+}
+
+// Copies the saved results in |shaped| into |run|, as if it had been shaped
+// and placed. The run's SCRIPT_CACHE is rebuilt lazily by Uniscribe.
+void RestoreShapedRun(const ShapedRun& shaped, internal::TextRun* run) {
+  const int glyph_count = static_cast<int>(shaped.glyphs.size());
+  if (run->font.GetNativeFont() != shaped.font.GetNativeFont())
+    ScriptFreeCache(&run->script_cache);
+  run->font = shaped.font;
+  run->script_analysis = shaped.script_analysis;
+  run->glyph_count = glyph_count;
+  run->glyphs.reset(new WORD[glyph_count]);
+  std::copy(shaped.glyphs.begin(), shaped.glyphs.end(), run->glyphs.get());
+  run->logical_clusters.reset(new WORD[shaped.logical_clusters.size()]);
+  std::copy(shaped.logical_clusters.begin(), shaped.logical_clusters.end(),
+            run->logical_clusters.get());
+  run->visible_attributes.reset(new SCRIPT_VISATTR[glyph_count]);
+  std::copy(shaped.visible_attributes.begin(), shaped.visible_attributes.end(),
+            run->visible_attributes.get());
+  if (glyph_count > 0) {
+    run->advance_widths.reset(new int[glyph_count]);
+    std::copy(shaped.advance_widths.begin(), shaped.advance_widths.end(),
+              run->advance_widths.get());
+    run->offsets.reset(new GOFFSET[glyph_count]);
+    std::copy(shaped.offsets.begin(), shaped.offsets.end(),
+              run->offsets.get());
+  }
+  run->abc_widths = shaped.abc_widths;
+}
+
 }  // namespace
 
 namespace internal {
@@ -754,6 +853,7 @@ void RenderTextWin::ResetLayout() {
 
 void RenderTextWin::EnsureLayout() {
   if (needs_layout_) {
+    TRACE_EVENT0("ui", "RenderTextWin::EnsureLayout");
     // TODO(msw): Skip complex processing if ScriptIsComplex returns false.
     ItemizeLogicalText();
     if (!runs_.empty())
@@ -997,28 +1097,36 @@ void RenderTextWin::LayoutVisualText() {
   // ensures that the text baseline does not shift.
   int ascent = font_list().GetBaseline();
   int descent = font_list().GetHeight() - font_list().GetBaseline();
+  ShapedRunCache* shaped_run_cache = g_shaped_run_cache.Pointer();
   for (size_t i = 0; i < runs_.size(); ++i) {
     internal::TextRun* run = runs_[i];
-    LayoutTextRun(run);
+    const std::string key = GetShapedRunKey(*run, GetLayoutText());
+    ShapedRunCache::iterator cached = shaped_run_cache->Get(key);
+    if (cached != shaped_run_cache->end()) {
+      RestoreShapedRun(cached->second, run);
+    } else {
+      LayoutTextRun(run);
+
+      if (run->glyph_count > 0) {
+        run->advance_widths.reset(new int[run->glyph_count]);
+        run->offsets.reset(new GOFFSET[run->glyph_count]);
+        hr = ScriptPlace(cached_hdc_,
+                         &run->script_cache,
+                         run->glyphs.get(),
+                         run->glyph_count,
+                         run->visible_attributes.get(),
+                         &(run->script_analysis),
+                         run->advance_widths.get(),
+                         run->offsets.get(),
+                         &(run->abc_widths));
+        DCHECK(SUCCEEDED(hr));
+      }
+      shaped_run_cache->Put(key, SaveShapedRun(*run));
+    }
 
     ascent = std::max(ascent, run->font.GetBaseline());
     descent = std::max(descent,
                        run->font.GetHeight() - run->font.GetBaseline());
-
-    if (run->glyph_count > 0) {
-      run->advance_widths.reset(new int[run->glyph_count]);
-      run->offsets.reset(new GOFFSET[run->glyph_count]);
-      hr = ScriptPlace(cached_hdc_,
-                       &run->script_cache,
-                       run->glyphs.get(),
-                       run->glyph_count,
-                       run->visible_attributes.get(),
-                       &(run->script_analysis),
-                       run->advance_widths.get(),
-                       run->offsets.get(),
-                       &(run->abc_widths));
-      DCHECK(SUCCEEDED(hr));
-    }
   }
 
   // Build the array of bidirectional embedding levels.
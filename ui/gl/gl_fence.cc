@@ -66,6 +66,11 @@ class GLFenceARBSync: public gfx::GLFence {
     glClientWaitSync(sync_, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
   }
 
+  virtual void ServerWait() OVERRIDE {
+    if (sync_)
+      glWaitSync(sync_, 0, GL_TIMEOUT_IGNORED);
+  }
+
  private:
   virtual ~GLFenceARBSync() {
     glDeleteSync(sync_);
@@ -96,6 +101,15 @@ class EGLFenceSync : public gfx::GLFence {
     eglClientWaitSyncKHR(display_, sync_, flags, time);
   }
 
+  virtual void ServerWait() OVERRIDE {
+    if (!gfx::g_driver_egl.ext.b_EGL_KHR_wait_sync) {
+      ClientWait();
+      return;
+    }
+    EGLint flags = 0;
+    eglWaitSyncKHR(display_, sync_, flags);
+  }
+
  private:
   virtual ~EGLFenceSync() {
     eglDestroySyncKHR(display_, sync_);
@@ -129,4 +143,19 @@ GLFence* GLFence::Create() {
   return NULL;
 }
 
+// static
+bool GLFence::IsServerWaitSupportedAcrossContexts() {
+#if !defined(OS_MACOSX)
+  // EGL sync objects belong to the display rather than to a share group.
+  return gfx::g_driver_egl.ext.b_EGL_KHR_fence_sync &&
+         gfx::g_driver_egl.ext.b_EGL_KHR_wait_sync;
+#else
+  return false;
+#endif
+}
+
+void GLFence::ServerWait() {
+  ClientWait();
+}
+
 }  // namespace gfx
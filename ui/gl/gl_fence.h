@@ -16,9 +16,19 @@ class GL_EXPORT GLFence {
   virtual ~GLFence();
 
   static GLFence* Create();
+
+  // Returns true if the fences returned by Create() can be waited on by the
+  // GPU from any context, including contexts in other share groups.
+  static bool IsServerWaitSupportedAcrossContexts();
+
   virtual bool HasCompleted() = 0;
   virtual void ClientWait() = 0;
 
+  // Makes the GPU wait for the fence before executing the commands issued to
+  // the current context after this call, without blocking the CPU. Fences the
+  // GPU cannot wait on are waited on with ClientWait().
+  virtual void ServerWait();
+
  protected:
   static bool IsContextLost();
 
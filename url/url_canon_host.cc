@@ -339,6 +339,37 @@ void DoHost(const CHAR* spec,
 
 }  // namespace
 
+bool IsCanonicalHost(const char* spec, const url_parse::Component& host) {
+  if (host.len <= 0)
+    return false;
+
+  // Only plain host names and IPv4 addresses: the lookup table maps each
+  // canonical character to itself, and IPv6 literals are left to DoHost.
+  bool maybe_ipv4 = true;
+  int end = host.end();
+  for (int i = host.begin; i < end; i++) {
+    unsigned char ch = static_cast<unsigned char>(spec[i]);
+    if (ch >= 0x80 || kHostCharLookup[ch] != ch || ch == '[' || ch == ']' ||
+        ch == ':')
+      return false;
+    if (!IsIPv4Char(ch))
+      maybe_ipv4 = false;
+  }
+  if (!maybe_ipv4)
+    return true;
+
+  // Host names which look like IPv4 addresses are rewritten unless they are
+  // already in dotted-quad form.
+  RawCanonOutput<64> canon_ip;
+  CanonHostInfo host_info;
+  CanonicalizeIPAddress(spec, host, &canon_ip, &host_info);
+  if (host_info.family == CanonHostInfo::BROKEN)
+    return false;
+  return !host_info.IsIPAddress() ||
+         (canon_ip.length() == host.len &&
+          !strncmp(canon_ip.data(), &spec[host.begin], host.len));
+}
+
 bool CanonicalizeHost(const char* spec,
                       const url_parse::Component& host,
                       CanonOutput* output,
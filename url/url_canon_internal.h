@@ -405,6 +405,14 @@ bool CanonicalizePartialPath(const base::char16* spec,
                              int path_begin_in_output,
                              CanonOutput* output);
 
+// Implemented in url_canon_host.cc and url_canon_path.cc respectively, these
+// are used by the fast path for already-canonical standard URLs. They return
+// true if canonicalizing the given 8-bit component would succeed and
+// reproduce it unchanged. They may return false for some canonical
+// components, in which case the full canonicalizer is run.
+bool IsCanonicalHost(const char* spec, const url_parse::Component& host);
+bool IsCanonicalPath(const char* spec, const url_parse::Component& path);
+
 #ifndef WIN32
 
 // Implementations of Windows' int-to-string conversions
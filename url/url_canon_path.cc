@@ -333,6 +333,43 @@ bool CanonicalizePath(const base::char16* spec,
   return DoPath<base::char16, base::char16>(spec, path, output, out_path);
 }
 
+bool IsCanonicalPath(const char* spec, const url_parse::Component& path) {
+  if (path.len <= 0 || spec[path.begin] != '/')
+    return false;
+
+  int end = path.end();
+  for (int i = path.begin; i < end; i++) {
+    unsigned char ch = static_cast<unsigned char>(spec[i]);
+    if (!(kPathCharLookup[ch] & SPECIAL))
+      continue;
+
+    if (ch == '.') {
+      // A dot is only rewritten when it is a "." or ".." directory, which can
+      // only happen right after a slash, since we reject backslashes and
+      // escaped dots below.
+      if (spec[i - 1] != '/')
+        continue;
+      int after_dot = i + 1;
+      if (after_dot < end && spec[after_dot] == '.')
+        after_dot++;
+      if (after_dot == end || spec[after_dot] == '/')
+        return false;
+    } else if (ch == '%') {
+      // Escapes are kept as-is unless they are of characters which are
+      // unescaped, dots, or invalid.
+      unsigned char unescaped_value;
+      if (!DecodeEscaped(spec, &i, end, &unescaped_value) ||
+          unescaped_value == '.' ||
+          (kPathCharLookup[unescaped_value] & (UNESCAPE | INVALID_BIT)))
+        return false;
+    } else {
+      // Characters which are escaped, invalid, or backslashes.
+      return false;
+    }
+  }
+  return true;
+}
+
 bool CanonicalizePartialPath(const char* spec,
                              const url_parse::Component& path,
                              int path_begin_in_output,
@@ -0,0 +1,87 @@
+// Copyright 2014 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Measures GURL construction from standard URLs which are already canonical,
+// as most URLs coming back from the renderer or the cache are, and which take
+// the fast path in CanonicalizeStandardURL(). The same URLs with an upper case
+// scheme and host, which have to be rebuilt component by component, serve as
+// the baseline.
+
+#include <string>
+#include <vector>
+
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_test.h"
+#include "url/gurl.h"
+
+namespace {
+
+const int kNumURLs = 1000;
+const int kRounds = 100;
+
+// Typical standard URLs, with IP hosts, ports, queries, refs and escapes.
+const char* const kURLFormats[] = {
+  "http://www.example.com/",
+  "http://www.example.com/foo/bar%d.html",
+  "https://www.google.com/search?q=%d&ie=utf-8&oe=utf-8",
+  "http://192.168.0.1/index%d.html",
+  "http://cdn.example.com:8080/static/js/app-%d.js?v=1",
+  "https://en.wikipedia.org/wiki/Page_%d#References",
+  "ws://chat.example.com/socket/%d",
+  "http://www.example.com/a%%20b/c%%3Fd/%d",
+};
+
+std::vector<std::string> MakeURLs() {
+  std::vector<std::string> urls;
+  for (int i = 0; i < kNumURLs; ++i) {
+    urls.push_back(base::StringPrintf(
+        kURLFormats[i % arraysize(kURLFormats)], i));
+  }
+  return urls;
+}
+
+// Upper cases everything up to the path, which the canonicalizer lower cases.
+std::string UpperCaseAuthority(const std::string& url) {
+  size_t path = url.find('/', url.find("//") + 2);
+  return StringToUpperASCII(url.substr(0, path)) + url.substr(path);
+}
+
+void RunGURLConstruction(const std::string& trace,
+                         const std::vector<std::string>& specs,
+                         const std::vector<std::string>& canonical) {
+  size_t num_chars = 0;
+  for (size_t i = 0; i < specs.size(); ++i)
+    num_chars += specs[i].size();
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  for (int round = 0; round < kRounds; ++round) {
+    for (size_t i = 0; i < specs.size(); ++i) {
+      GURL url(specs[i]);
+      EXPECT_TRUE(url.is_valid());
+    }
+  }
+  base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+  perf_test::PrintResult("gurl_construction", "", trace,
+                         elapsed.InMicroseconds() * 1000.0 /
+                             (num_chars * kRounds),
+                         "ns/char", true);
+
+  for (size_t i = 0; i < specs.size(); ++i)
+    EXPECT_EQ(canonical[i], GURL(specs[i]).spec());
+}
+
+}  // namespace
+
+TEST(URLCanonPerfTest, StandardURLs) {
+  std::vector<std::string> canonical = MakeURLs();
+  std::vector<std::string> upper_case;
+  for (size_t i = 0; i < canonical.size(); ++i)
+    upper_case.push_back(UpperCaseAuthority(canonical[i]));
+
+  RunGURLConstruction("baseline", upper_case, canonical);
+  RunGURLConstruction("canonical", canonical, canonical);
+}
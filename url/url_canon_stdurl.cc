@@ -89,6 +89,91 @@ bool DoCanonicalizeStandardURL(const URLComponentSource<CHAR>& source,
   return success;
 }
 
+// Returns true if |spec| is an ASCII standard URL without user info which is
+// already canonical, so that DoCanonicalizeStandardURL would succeed and
+// reproduce it unchanged with the same components. This is the common case
+// for URLs which have been canonicalized before, such as those coming back
+// from the renderer or the cache, and checking is much cheaper than
+// rebuilding the URL component by component.
+//
+// This may return false for some canonical URLs (for example, those with user
+// info or IPv6 hosts), which just take the slow path.
+bool IsCanonicalStandardURL(const char* spec,
+                            int spec_len,
+                            const url_parse::Parsed& parsed) {
+  // Scheme: lower case, starting at the beginning of the spec, followed by
+  // "://" and the host.
+  const url_parse::Component& scheme = parsed.scheme;
+  if (scheme.begin != 0 || scheme.len <= 0 ||
+      scheme.len + 3 > spec_len || spec[0] < 'a' || spec[0] > 'z')
+    return false;
+  for (int i = 0; i < scheme.len; i++) {
+    if (CanonicalSchemeChar(static_cast<unsigned char>(spec[i])) != spec[i])
+      return false;
+  }
+  int cur = scheme.end();
+  if (spec[cur] != ':' || spec[cur + 1] != '/' || spec[cur + 2] != '/')
+    return false;
+  cur += 3;
+
+  if (parsed.username.is_valid() || parsed.password.is_valid() ||
+      parsed.host.begin != cur || !IsCanonicalHost(spec, parsed.host))
+    return false;
+  cur = parsed.host.end();
+
+  // Port: present only if it is not the default, without leading zeros.
+  if (parsed.port.is_valid()) {
+    const url_parse::Component& port = parsed.port;
+    if (port.begin != cur + 1 || spec[cur] != ':' || port.len <= 0 ||
+        spec[port.begin] == '0')
+      return false;
+    int port_num = url_parse::ParsePort(spec, port);
+    if (port_num < 0 ||
+        port_num == DefaultPortForScheme(spec, scheme.len))
+      return false;
+    cur = port.end();
+  }
+
+  if (parsed.path.begin != cur || !IsCanonicalPath(spec, parsed.path))
+    return false;
+  cur = parsed.path.end();
+
+  if (parsed.query.is_valid()) {
+    const url_parse::Component& query = parsed.query;
+    if (query.begin != cur + 1 || spec[cur] != '?')
+      return false;
+    for (int i = query.begin; i < query.end(); i++) {
+      unsigned char ch = static_cast<unsigned char>(spec[i]);
+      if (ch >= 0x80 || !IsQueryChar(ch))
+        return false;
+    }
+    cur = query.end();
+  }
+
+  if (parsed.ref.is_valid()) {
+    const url_parse::Component& ref = parsed.ref;
+    if (ref.begin != cur + 1 || spec[cur] != '#')
+      return false;
+    for (int i = ref.begin; i < ref.end(); i++) {
+      unsigned char ch = static_cast<unsigned char>(spec[i]);
+      if (ch < 0x20 || ch >= 0x80)
+        return false;
+    }
+    cur = ref.end();
+  }
+
+  return cur == spec_len;
+}
+
+// Returns |component| moved to |offset| in the output, or an invalid component
+// if it is not present, as the canonicalizer would.
+url_parse::Component OffsetComponent(const url_parse::Component& component,
+                                     int offset) {
+  if (!component.is_valid())
+    return url_parse::Component();
+  return url_parse::Component(component.begin + offset, component.len);
+}
+
 }  // namespace
 
 
@@ -129,6 +214,21 @@ bool CanonicalizeStandardURL(const char* spec,
                              CharsetConverter* query_converter,
                              CanonOutput* output,
                              url_parse::Parsed* new_parsed) {
+  if (IsCanonicalStandardURL(spec, spec_len, parsed)) {
+    // The query is ASCII, so |query_converter| would not be used either.
+    int offset = output->length();
+    output->Append(spec, spec_len);
+    new_parsed->scheme = OffsetComponent(parsed.scheme, offset);
+    new_parsed->username.reset();
+    new_parsed->password.reset();
+    new_parsed->host = OffsetComponent(parsed.host, offset);
+    new_parsed->port = OffsetComponent(parsed.port, offset);
+    new_parsed->path = OffsetComponent(parsed.path, offset);
+    new_parsed->query = OffsetComponent(parsed.query, offset);
+    new_parsed->ref = OffsetComponent(parsed.ref, offset);
+    return true;
+  }
+
   return DoCanonicalizeStandardURL<char, unsigned char>(
       URLComponentSource<char>(spec), parsed, query_converter,
       output, new_parsed);
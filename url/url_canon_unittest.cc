@@ -1421,6 +1421,85 @@ TEST(URLCanonTest, CanonicalizeStandardURL) {
   }
 }
 
+// 8-bit standard URLs which are already canonical are copied rather than
+// rebuilt. The 16-bit canonicalizer always rebuilds the URL, so the results
+// must match it for URLs which are canonical and for those which only nearly
+// are.
+TEST(URLCanonTest, CanonicalizeStandardURLFastPath) {
+  const char* cases[] = {
+      // Already canonical.
+    "http://www.google.com/",
+    "http://www.google.com/foo/bar.html?q=1&r=2#ref",
+    "https://www.google.com:8443/a/.b/..c/d.?e#f g",
+    "http://192.168.0.1/a%20b/c%3Fd%2f",
+    "ws://foo_bar-baz.example.com/socket",
+    "http://www.google.com/?",
+    "http://www.google.com/#",
+      // Not canonical.
+    "HTTP://www.google.com/",
+    "http://WWW.google.com/",
+    "http:/www.google.com/",
+    "http:\\www.google.com/",
+    "http://user@www.google.com/",
+    "http://www.google.com",
+    "http://www.google.com:80/",
+    "https://www.google.com:443/",
+    "http://www.google.com:080/",
+    "http://www.google.com:/",
+    "http://www.google.com:99999/",
+    "http://192.168.1/",
+    "http://0x7f.0.0.1/",
+    "http://1.2.3.256/",
+    "http://[::1]/",
+    "http://www.google.com/./",
+    "http://www.google.com/a/..",
+    "http://www.google.com/a/%2e/",
+    "http://www.google.com/%41",
+    "http://www.google.com/%7e",
+    "http://www.google.com/a b",
+    "http://www.google.com/a\\b",
+    "http://www.google.com/a%zz",
+    "http://www.google.com/?a b",
+    "http://www.google.com/?a\"b",
+    "http://www.google.com/#a\x01",
+    "http://www.goo%67le.com/",
+    "http://www.goo gle.com/",
+  };
+
+  for (size_t i = 0; i < ARRAYSIZE(cases); i++) {
+    int url_len = static_cast<int>(strlen(cases[i]));
+    url_parse::Parsed parsed;
+    url_parse::ParseStandardURL(cases[i], url_len, &parsed);
+    url_parse::Parsed out_parsed;
+    std::string out_str;
+    url_canon::StdStringCanonOutput output(&out_str);
+    bool success = url_canon::CanonicalizeStandardURL(
+        cases[i], url_len, parsed, NULL, &output, &out_parsed);
+    output.Complete();
+
+    base::string16 input16(ConvertUTF8ToUTF16(cases[i]));
+    url_parse::Parsed parsed16;
+    url_parse::ParseStandardURL(input16.c_str(), url_len, &parsed16);
+    url_parse::Parsed out_parsed16;
+    std::string out_str16;
+    url_canon::StdStringCanonOutput output16(&out_str16);
+    bool success16 = url_canon::CanonicalizeStandardURL(
+        input16.c_str(), url_len, parsed16, NULL, &output16, &out_parsed16);
+    output16.Complete();
+
+    EXPECT_EQ(success16, success) << cases[i];
+    EXPECT_EQ(out_str16, out_str) << cases[i];
+    EXPECT_TRUE(out_parsed16.scheme == out_parsed.scheme) << cases[i];
+    EXPECT_TRUE(out_parsed16.username == out_parsed.username) << cases[i];
+    EXPECT_TRUE(out_parsed16.password == out_parsed.password) << cases[i];
+    EXPECT_TRUE(out_parsed16.host == out_parsed.host) << cases[i];
+    EXPECT_TRUE(out_parsed16.port == out_parsed.port) << cases[i];
+    EXPECT_TRUE(out_parsed16.path == out_parsed.path) << cases[i];
+    EXPECT_TRUE(out_parsed16.query == out_parsed.query) << cases[i];
+    EXPECT_TRUE(out_parsed16.ref == out_parsed.ref) << cases[i];
+  }
+}
+
 // The codepath here is the same as for regular canonicalization, so we just
 // need to test that things are replaced or not correctly.
 TEST(URLCanonTest, ReplaceStandardURL) {
@@ -28,6 +28,10 @@ void AppCacheHistograms::CountCorruptionDetected() {
   UMA_HISTOGRAM_BOOLEAN("appcache.CorruptionDetected", true);
 }
 
+void AppCacheHistograms::CountResponseDeduplicated() {
+  UMA_HISTOGRAM_BOOLEAN("appcache.UpdateResponseDeduplicated", true);
+}
+
 void AppCacheHistograms::CountUpdateJobResult(
     AppCacheUpdateJob::ResultType result,
     const GURL& origin_url) {
@@ -31,6 +31,7 @@ class AppCacheHistograms {
     NUM_CHECK_RESPONSE_RESULT_TYPES
   };
   static void CountCheckResponseResult(CheckResponseResultType result);
+  static void CountResponseDeduplicated();
 
   static void AddTaskQueueTimeSample(const base::TimeDelta& duration);
   static void AddTaskRunTimeSample(const base::TimeDelta& duration);
@@ -113,7 +113,12 @@ AppCacheUpdateJob::URLFetcher::URLFetcher(const GURL& url,
       buffer_(new net::IOBuffer(kBufferSize)),
       request_(job->service_->request_context()
                    ->CreateRequest(url, net::DEFAULT_PRIORITY, this)),
-      result_(UPDATE_OK) {}
+      result_(UPDATE_OK),
+      response_body_size_(0),
+      existing_response_body_size_(0),
+      response_matches_existing_(false) {
+  base::MD5Init(&response_hash_);
+}
 
 AppCacheUpdateJob::URLFetcher::~URLFetcher() {
 }
@@ -267,6 +272,11 @@ bool AppCacheUpdateJob::URLFetcher::ConsumeResponseData(int bytes_read) {
     case URL_FETCH:
     case MASTER_ENTRY_FETCH:
       DCHECK(response_writer_.get());
+      if (existing_entry_.has_response_id()) {
+        base::MD5Update(&response_hash_,
+                        base::StringPiece(buffer_->data(), bytes_read));
+        response_body_size_ += bytes_read;
+      }
       response_writer_->WriteData(
           buffer_.get(),
           bytes_read,
@@ -286,6 +296,63 @@ void AppCacheUpdateJob::URLFetcher::OnResponseCompleted() {
     return;
   }
 
+  if (MaybeCompareWithExistingResponse())
+    return;  // Continues asynchronously in OnExistingResponseDataRead.
+
+  NotifyFetchCompleted();
+}
+
+// A resource that failed validation may still come back with the same
+// bytes, e.g. when the server does not honor conditional requests or the
+// manifest was bumped without touching the resource. Rather than storing
+// a second copy, read back the existing response and compare digests.
+bool AppCacheUpdateJob::URLFetcher::MaybeCompareWithExistingResponse() {
+  if (fetch_type_ != URL_FETCH || result_ != UPDATE_OK ||
+      !existing_entry_.has_response_id() || !response_writer_ ||
+      request_->GetResponseCode() / 100 != 2) {
+    return false;
+  }
+  base::MD5Init(&existing_response_hash_);
+  existing_response_reader_.reset(
+      job_->storage_->CreateResponseReader(job_->manifest_url_,
+                                           job_->group_->group_id(),
+                                           existing_entry_.response_id()));
+  existing_response_reader_->ReadData(
+      buffer_.get(),
+      kBufferSize,
+      base::Bind(&URLFetcher::OnExistingResponseDataRead,
+                 base::Unretained(this)));
+  return true;
+}
+
+void AppCacheUpdateJob::URLFetcher::OnExistingResponseDataRead(int result) {
+  if (result > 0) {
+    existing_response_body_size_ += result;
+    if (existing_response_body_size_ <= response_body_size_) {
+      base::MD5Update(&existing_response_hash_,
+                      base::StringPiece(buffer_->data(), result));
+      existing_response_reader_->ReadData(
+          buffer_.get(),
+          kBufferSize,
+          base::Bind(&URLFetcher::OnExistingResponseDataRead,
+                     base::Unretained(this)));  // read more
+      return;
+    }
+    // The existing body is larger, no need to read the rest of it.
+  } else if (result == 0 &&
+             existing_response_body_size_ == response_body_size_) {
+    base::MD5Digest digest;
+    base::MD5Digest existing_digest;
+    base::MD5Final(&digest, &response_hash_);
+    base::MD5Final(&existing_digest, &existing_response_hash_);
+    response_matches_existing_ =
+        memcmp(digest.a, existing_digest.a, sizeof(digest.a)) == 0;
+  }
+  existing_response_reader_.reset();
+  NotifyFetchCompleted();
+}
+
+void AppCacheUpdateJob::URLFetcher::NotifyFetchCompleted() {
   switch (fetch_type_) {
     case MANIFEST_FETCH:
       job_->HandleManifestFetchCompleted(this);
@@ -579,7 +646,17 @@ void AppCacheUpdateJob::HandleUrlFetchCompleted(URLFetcher* fetcher) {
       ? request->GetResponseCode() : -1;
   AppCacheEntry& entry = url_file_list_.find(url)->second;
 
-  if (response_code / 100 == 2) {
+  if (response_code / 100 == 2 && fetcher->response_matches_existing()) {
+    // The body is unchanged, keep the existing response and discard the
+    // copy that was just written.
+    DCHECK(fetcher->response_writer());
+    duplicate_response_ids_.push_back(
+        fetcher->response_writer()->response_id());
+    entry.set_response_id(fetcher->existing_entry().response_id());
+    entry.set_response_size(fetcher->existing_entry().response_size());
+    inprogress_cache_->AddOrModifyEntry(url, entry);
+    AppCacheHistograms::CountResponseDeduplicated();
+  } else if (response_code / 100 == 2) {
     // Associate storage with the new entry.
     DCHECK(fetcher->response_writer());
     entry.set_response_id(fetcher->response_writer()->response_id());
@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "base/gtest_prod_util.h"
+#include "base/md5.h"
 #include "base/memory/ref_counted.h"
 #include "net/base/completion_callback.h"
 #include "net/http/http_response_headers.h"
@@ -127,6 +128,13 @@ class WEBKIT_STORAGE_BROWSER_EXPORT AppCacheUpdateJob
     }
     ResultType result() const { return result_; }
 
+    // True if the fetched response body is byte-for-byte identical to the
+    // body of |existing_entry|, in which case the existing response can be
+    // kept and the newly written one discarded.
+    bool response_matches_existing() const {
+      return response_matches_existing_;
+    }
+
    private:
     // URLRequest::Delegate overrides
     virtual void OnReceivedRedirect(net::URLRequest* request,
@@ -142,6 +150,9 @@ class WEBKIT_STORAGE_BROWSER_EXPORT AppCacheUpdateJob
     bool ConsumeResponseData(int bytes_read);
     void OnResponseCompleted();
     bool MaybeRetryRequest();
+    bool MaybeCompareWithExistingResponse();
+    void OnExistingResponseDataRead(int result);
+    void NotifyFetchCompleted();
 
     GURL url_;
     AppCacheUpdateJob* job_;
@@ -154,6 +165,14 @@ class WEBKIT_STORAGE_BROWSER_EXPORT AppCacheUpdateJob
     std::string manifest_data_;
     ResultType result_;
     scoped_ptr<AppCacheResponseWriter> response_writer_;
+    // Running digests of the fetched body and of the existing entry's body,
+    // used to detect unchanged resources that were served with a 200.
+    base::MD5Context response_hash_;
+    base::MD5Context existing_response_hash_;
+    int64 response_body_size_;
+    int64 existing_response_body_size_;
+    scoped_ptr<AppCacheResponseReader> existing_response_reader_;
+    bool response_matches_existing_;
   };  // class URLFetcher
 
   AppCacheResponseWriter* CreateResponseWriter();
@@ -1312,6 +1312,82 @@ class AppCacheUpdateJobTest : public testing::Test,
     // Start update after data write completes asynchronously.
   }
 
+  void UpgradeDeduplicateUnchangedResponseTest() {
+    ASSERT_TRUE(base::MessageLoopForIO::IsCurrent());
+
+    MakeService();
+    group_ = new AppCacheGroup(
+        service_->storage(), MockHttpServer::GetMockUrl("files/manifest1"),
+        service_->storage()->NewGroupId());
+    AppCacheUpdateJob* update =
+        new AppCacheUpdateJob(service_.get(), group_.get());
+    group_->update_job_ = update;
+
+    AppCache* cache = MakeCacheForGroup(service_->storage()->NewCacheId(), 42);
+    MockFrontend* frontend = MakeMockFrontend();
+    AppCacheHost* host = MakeHost(1, frontend);
+    host->AssociateCompleteCache(cache);
+
+    // Give the newest cache an entry that is in storage.
+    response_writer_.reset(
+        service_->storage()->CreateResponseWriter(group_->manifest_url(),
+                                                  group_->group_id()));
+    cache->AddEntry(MockHttpServer::GetMockUrl("files/explicit1"),
+                    AppCacheEntry(AppCacheEntry::EXPLICIT,
+                                  response_writer_->response_id()));
+
+    // Set up checks for when update job finishes. The entry must be
+    // refetched, but the body is unchanged so the stored response is kept.
+    do_checks_after_update_finished_ = true;
+    expect_group_obsolete_ = false;
+    expect_group_has_cache_ = true;
+    expect_old_cache_ = cache;
+    expect_response_ids_.insert(
+        std::map<GURL, int64>::value_type(
+            MockHttpServer::GetMockUrl("files/explicit1"),
+            response_writer_->response_id()));
+    tested_manifest_ = MANIFEST1;
+    MockFrontend::HostIds ids(1, host->host_id());
+    frontend->AddExpectedEvent(ids, CHECKING_EVENT);
+    frontend->AddExpectedEvent(ids, DOWNLOADING_EVENT);
+    frontend->AddExpectedEvent(ids, PROGRESS_EVENT);
+    frontend->AddExpectedEvent(ids, PROGRESS_EVENT);
+    frontend->AddExpectedEvent(ids, PROGRESS_EVENT);  // final
+    frontend->AddExpectedEvent(ids, UPDATE_READY_EVENT);
+
+    // Seed storage with an expired response whose body matches what the
+    // server will return.
+    const char data[] =
+        "HTTP/1.1 200 OK\0"
+        "Expires: Thu, 01 Dec 1994 16:00:00 GMT\0"
+        "\0";
+    net::HttpResponseHeaders* headers =
+        new net::HttpResponseHeaders(std::string(data, arraysize(data)));
+    net::HttpResponseInfo* response_info = new net::HttpResponseInfo();
+    response_info->request_time = base::Time::Now();
+    response_info->response_time = base::Time::Now();
+    response_info->headers = headers;  // adds ref to headers
+    scoped_refptr<HttpResponseInfoIOBuffer> io_buffer(
+        new HttpResponseInfoIOBuffer(response_info));  // adds ref to info
+    response_writer_->WriteInfo(
+        io_buffer.get(),
+        base::Bind(&AppCacheUpdateJobTest::WriteBodyAfterSeedingInfo,
+                   base::Unretained(this)));
+
+    // Start update after data write completes asynchronously.
+  }
+
+  void WriteBodyAfterSeedingInfo(int result) {
+    ASSERT_GT(result, 0);
+    const std::string body("explicit1");
+    scoped_refptr<net::IOBuffer> io_buffer(new net::StringIOBuffer(body));
+    response_writer_->WriteData(
+        io_buffer.get(),
+        body.length(),
+        base::Bind(&AppCacheUpdateJobTest::StartUpdateAfterSeedingStorageData,
+                   base::Unretained(this)));
+  }
+
   void UpgradeLoadFromNewestCacheVaryHeaderTest() {
     ASSERT_TRUE(base::MessageLoopForIO::IsCurrent());
 
@@ -3543,6 +3619,11 @@ TEST_F(AppCacheUpdateJobTest, UpgradeNoLoadFromNewestCache) {
   RunTestOnIOThread(&AppCacheUpdateJobTest::UpgradeNoLoadFromNewestCacheTest);
 }
 
+TEST_F(AppCacheUpdateJobTest, UpgradeDeduplicateUnchangedResponse) {
+  RunTestOnIOThread(
+      &AppCacheUpdateJobTest::UpgradeDeduplicateUnchangedResponseTest);
+}
+
 TEST_F(AppCacheUpdateJobTest, UpgradeLoadFromNewestCacheVaryHeader) {
   RunTestOnIOThread(
       &AppCacheUpdateJobTest::UpgradeLoadFromNewestCacheVaryHeaderTest);
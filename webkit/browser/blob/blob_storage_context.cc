@@ -4,10 +4,13 @@
 
 #include "webkit/browser/blob/blob_storage_context.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/location.h"
 #include "base/logging.h"
 #include "base/message_loop/message_loop_proxy.h"
+#include "base/sys_info.h"
 #include "url/gurl.h"
 #include "webkit/browser/blob/blob_data_handle.h"
 #include "webkit/common/blob/blob_data.h"
@@ -32,9 +35,16 @@ GURL ClearBlobUrlRef(const GURL& url) {
   return GURL(url.spec().substr(0, hash_pos));
 }
 
-// TODO(michaeln): use base::SysInfo::AmountOfPhysicalMemoryMB() in some
-// way to come up with a better limit.
-static const int64 kMaxMemoryUsage = 500 * 1024 * 1024;  // Half a gig.
+// Blob data may use up to a fifth of physical memory, clamped so that
+// low-memory devices keep some headroom and large machines can hold the
+// multi-gigabyte blobs that media editing apps create.
+const int64 kMinMaxMemoryUsage = 100 * 1024 * 1024;
+const int64 kMaxMaxMemoryUsage = 2048LL * 1024 * 1024;
+
+int64 ComputeMaxMemoryUsage() {
+  int64 limit = base::SysInfo::AmountOfPhysicalMemory() / 5;
+  return std::max(kMinMaxMemoryUsage, std::min(kMaxMaxMemoryUsage, limit));
+}
 
 }  // namespace
 
@@ -51,7 +61,8 @@ BlobStorageContext::BlobMapEntry::~BlobMapEntry() {
 }
 
 BlobStorageContext::BlobStorageContext()
-    : memory_usage_(0) {
+    : memory_usage_(0),
+      max_memory_usage_(ComputeMaxMemoryUsage()) {
 }
 
 BlobStorageContext::~BlobStorageContext() {
@@ -278,7 +289,7 @@ bool BlobStorageContext::AppendBytesItem(
     DCHECK(false);
     return false;
   }
-  if (memory_usage_ + length > kMaxMemoryUsage)
+  if (memory_usage_ + length > max_memory_usage_)
     return false;
   target_blob_data->AppendData(bytes, static_cast<size_t>(length));
   memory_usage_ += length;
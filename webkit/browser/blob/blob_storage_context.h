@@ -47,6 +47,11 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
   bool RegisterPublicBlobURL(const GURL& url, const std::string& uuid);
   void RevokePublicBlobURL(const GURL& url);
 
+  int64 memory_usage() const { return memory_usage_; }
+  void set_max_memory_usage_for_testing(int64 max_memory_usage) {
+    max_memory_usage_ = max_memory_usage;
+  }
+
  private:
   friend class BlobDataHandle;
   friend class BlobStorageHost;
@@ -106,6 +111,9 @@ class WEBKIT_STORAGE_BROWSER_EXPORT BlobStorageContext
   // items of TYPE_FILE.
   int64 memory_usage_;
 
+  // The budget for |memory_usage_|, scaled to the amount of physical memory.
+  int64 max_memory_usage_;
+
   DISALLOW_COPY_AND_ASSIGN(BlobStorageContext);
 };
 
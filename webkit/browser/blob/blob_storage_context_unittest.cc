@@ -131,6 +131,38 @@ TEST(BlobStorageContextTest, CompoundBlobs) {
   EXPECT_TRUE(*(blob_data_handle->data()) == *canonicalized_blob_data2.get());
 }
 
+TEST(BlobStorageContextTest, ExceedMemoryLimit) {
+  const std::string kId1("id1");
+  const std::string kId2("id2");
+
+  base::MessageLoop fake_io_message_loop;
+
+  scoped_refptr<BlobData> blob_data1(new BlobData(kId1));
+  blob_data1->AppendData("12345");
+  scoped_refptr<BlobData> blob_data2(new BlobData(kId2));
+  blob_data2->AppendData("12345678");
+
+  BlobStorageContext context;
+  context.set_max_memory_usage_for_testing(10);
+
+  scoped_ptr<BlobDataHandle> blob_data_handle1 =
+      context.AddFinishedBlob(blob_data1.get());
+  ASSERT_TRUE(blob_data_handle1.get());
+  EXPECT_EQ(5, context.memory_usage());
+
+  // The second blob does not fit alongside the first and is dropped.
+  EXPECT_FALSE(context.AddFinishedBlob(blob_data2.get()).get());
+  EXPECT_EQ(5, context.memory_usage());
+
+  // Releasing the first blob frees its share of the budget.
+  blob_data_handle1.reset();
+  EXPECT_EQ(0, context.memory_usage());
+  scoped_ptr<BlobDataHandle> blob_data_handle2 =
+      context.AddFinishedBlob(blob_data2.get());
+  ASSERT_TRUE(blob_data_handle2.get());
+  EXPECT_EQ(8, context.memory_usage());
+}
+
 TEST(BlobStorageContextTest, PublicBlobUrls) {
   BlobStorageContext context;
   BlobStorageHost host(&context);
@@ -4,6 +4,8 @@
 
 #include "webkit/browser/fileapi/copy_or_move_operation_delegate.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/files/file_path.h"
 #include "net/base/io_buffer.h"
@@ -351,8 +353,10 @@ class SnapshotCopyOrMoveImpl
   DISALLOW_COPY_AND_ASSIGN(SnapshotCopyOrMoveImpl);
 };
 
-// The size of buffer for StreamCopyHelper.
-const int kReadBufferSize = 32768;
+// The size of each of the two buffers StreamCopyHelper alternates between.
+// Up to kMaxInflightOperations files are copied at once, so this bounds the
+// copy buffers to a few megabytes.
+const int kReadBufferSize = 256 * 1024;
 
 // To avoid too many progress callbacks, it should be called less
 // frequently than 50ms.
@@ -544,6 +548,10 @@ CopyOrMoveOperationDelegate::StreamCopyHelper::StreamCopyHelper(
       need_flush_(need_flush),
       file_progress_callback_(file_progress_callback),
       io_buffer_(new net::IOBufferWithSize(buffer_size)),
+      spare_io_buffer_(new net::IOBufferWithSize(buffer_size)),
+      read_in_flight_(false),
+      write_in_flight_(false),
+      eof_(false),
       num_copied_bytes_(0),
       previous_flush_offset_(0),
       min_progress_callback_invocation_span_(
@@ -557,73 +565,98 @@ CopyOrMoveOperationDelegate::StreamCopyHelper::~StreamCopyHelper() {
 
 void CopyOrMoveOperationDelegate::StreamCopyHelper::Run(
     const StatusCallback& callback) {
+  DCHECK(callback_.is_null());
+  callback_ = callback;
   file_progress_callback_.Run(0);
   last_progress_callback_invocation_time_ = base::Time::Now();
-  Read(callback);
+  Read();
 }
 
 void CopyOrMoveOperationDelegate::StreamCopyHelper::Cancel() {
   cancel_requested_ = true;
 }
 
-void CopyOrMoveOperationDelegate::StreamCopyHelper::Read(
-    const StatusCallback& callback) {
+void CopyOrMoveOperationDelegate::StreamCopyHelper::Read() {
+  DCHECK(!read_in_flight_);
+  read_in_flight_ = true;
   int result = reader_->Read(
       io_buffer_.get(), io_buffer_->size(),
-      base::Bind(&StreamCopyHelper::DidRead,
-                 weak_factory_.GetWeakPtr(), callback));
+      base::Bind(&StreamCopyHelper::DidRead, weak_factory_.GetWeakPtr()));
   if (result != net::ERR_IO_PENDING)
-    DidRead(callback, result);
+    DidRead(result);
 }
 
-void CopyOrMoveOperationDelegate::StreamCopyHelper::DidRead(
-    const StatusCallback& callback, int result) {
+void CopyOrMoveOperationDelegate::StreamCopyHelper::DidRead(int result) {
+  read_in_flight_ = false;
   if (cancel_requested_) {
-    callback.Run(base::File::FILE_ERROR_ABORT);
+    Finish(base::File::FILE_ERROR_ABORT);
     return;
   }
 
   if (result < 0) {
-    callback.Run(NetErrorToFileError(result));
+    Finish(NetErrorToFileError(result));
     return;
   }
 
   if (result == 0) {
-    // Here is the EOF.
-    if (need_flush_)
-      Flush(callback, true /* is_eof */);
-    else
-      callback.Run(base::File::FILE_OK);
+    // Here is the EOF. Wait for the last write to land before finishing.
+    eof_ = true;
+    if (!write_in_flight_)
+      FinishWriting();
     return;
   }
 
-  Write(callback, new net::DrainableIOBuffer(io_buffer_.get(), result));
+  // Hand the filled buffer over to the writer and read the next chunk into
+  // the other one, so reading and writing overlap.
+  DCHECK(!pending_write_.get());
+  pending_write_ = new net::DrainableIOBuffer(io_buffer_.get(), result);
+  std::swap(io_buffer_, spare_io_buffer_);
+  if (!write_in_flight_)
+    WritePending();
+}
+
+void CopyOrMoveOperationDelegate::StreamCopyHelper::WritePending() {
+  DCHECK(pending_write_.get() && !write_in_flight_);
+  scoped_refptr<net::DrainableIOBuffer> buffer;
+  buffer.swap(pending_write_);
+
+  // Claim the writer first so that a read completing synchronously stashes
+  // its chunk instead of writing it out of order.
+  write_in_flight_ = true;
+
+  // |io_buffer_| is not referenced by any write, so the next read can
+  // proceed in parallel.
+  if (!read_in_flight_ && !eof_) {
+    base::WeakPtr<StreamCopyHelper> alive = weak_factory_.GetWeakPtr();
+    Read();
+    if (!alive)
+      return;  // The read failed synchronously and the copy is finished.
+  }
+  Write(buffer);
 }
 
 void CopyOrMoveOperationDelegate::StreamCopyHelper::Write(
-    const StatusCallback& callback,
     scoped_refptr<net::DrainableIOBuffer> buffer) {
   DCHECK_GT(buffer->BytesRemaining(), 0);
-
+  DCHECK(write_in_flight_);
   int result = writer_->Write(
       buffer.get(), buffer->BytesRemaining(),
       base::Bind(&StreamCopyHelper::DidWrite,
-                 weak_factory_.GetWeakPtr(), callback, buffer));
+                 weak_factory_.GetWeakPtr(), buffer));
   if (result != net::ERR_IO_PENDING)
-    DidWrite(callback, buffer, result);
+    DidWrite(buffer, result);
 }
 
 void CopyOrMoveOperationDelegate::StreamCopyHelper::DidWrite(
-    const StatusCallback& callback,
     scoped_refptr<net::DrainableIOBuffer> buffer,
     int result) {
   if (cancel_requested_) {
-    callback.Run(base::File::FILE_ERROR_ABORT);
+    Finish(base::File::FILE_ERROR_ABORT);
     return;
   }
 
   if (result < 0) {
-    callback.Run(NetErrorToFileError(result));
+    Finish(NetErrorToFileError(result));
     return;
   }
 
@@ -639,39 +672,69 @@ void CopyOrMoveOperationDelegate::StreamCopyHelper::DidWrite(
   }
 
   if (buffer->BytesRemaining() > 0) {
-    Write(callback, buffer);
+    Write(buffer);
     return;
   }
 
+  write_in_flight_ = false;
   if (need_flush_ &&
       (num_copied_bytes_ - previous_flush_offset_) > kFlushIntervalInBytes) {
-    Flush(callback, false /* not is_eof */);
+    Flush(false /* not is_eof */);
   } else {
-    Read(callback);
+    DidFinishWrite();
   }
 }
 
-void CopyOrMoveOperationDelegate::StreamCopyHelper::Flush(
-    const StatusCallback& callback, bool is_eof) {
+void CopyOrMoveOperationDelegate::StreamCopyHelper::DidFinishWrite() {
+  if (pending_write_.get())
+    WritePending();
+  else if (eof_)
+    FinishWriting();
+  else if (!read_in_flight_)
+    Read();
+}
+
+void CopyOrMoveOperationDelegate::StreamCopyHelper::FinishWriting() {
+  DCHECK(eof_ && !write_in_flight_ && !pending_write_.get());
+  if (need_flush_)
+    Flush(true /* is_eof */);
+  else
+    Finish(base::File::FILE_OK);
+}
+
+void CopyOrMoveOperationDelegate::StreamCopyHelper::Flush(bool is_eof) {
+  // A flush occupies the writer just like a write does.
+  DCHECK(!write_in_flight_);
+  write_in_flight_ = true;
   int result = writer_->Flush(
       base::Bind(&StreamCopyHelper::DidFlush,
-                 weak_factory_.GetWeakPtr(), callback, is_eof));
+                 weak_factory_.GetWeakPtr(), is_eof));
   if (result != net::ERR_IO_PENDING)
-    DidFlush(callback, is_eof, result);
+    DidFlush(is_eof, result);
 }
 
 void CopyOrMoveOperationDelegate::StreamCopyHelper::DidFlush(
-    const StatusCallback& callback, bool is_eof, int result) {
+    bool is_eof, int result) {
+  write_in_flight_ = false;
   if (cancel_requested_) {
-    callback.Run(base::File::FILE_ERROR_ABORT);
+    Finish(base::File::FILE_ERROR_ABORT);
     return;
   }
 
   previous_flush_offset_ = num_copied_bytes_;
   if (is_eof)
-    callback.Run(NetErrorToFileError(result));
+    Finish(NetErrorToFileError(result));
   else
-    Read(callback);
+    DidFinishWrite();
+}
+
+void CopyOrMoveOperationDelegate::StreamCopyHelper::Finish(
+    base::File::Error error) {
+  // Drop the completion of whichever operation is still in flight.
+  weak_factory_.InvalidateWeakPtrs();
+  StatusCallback callback = callback_;
+  callback_.Reset();
+  callback.Run(error);
 }
 
 CopyOrMoveOperationDelegate::CopyOrMoveOperationDelegate(
@@ -62,25 +62,37 @@ class CopyOrMoveOperationDelegate
     void Cancel();
 
    private:
-    // Reads the content from the |reader_|.
-    void Read(const StatusCallback& callback);
-    void DidRead(const StatusCallback& callback, int result);
+    // Reads the next chunk from the |reader_| into |io_buffer_|. The read of
+    // one chunk overlaps with the write of the previous one.
+    void Read();
+    void DidRead(int result);
+
+    // Writes the chunk held in |pending_write_| to |writer_|.
+    void WritePending();
 
     // Writes the content in |buffer| to |writer_|.
-    void Write(const StatusCallback& callback,
-               scoped_refptr<net::DrainableIOBuffer> buffer);
-    void DidWrite(const StatusCallback& callback,
-                  scoped_refptr<net::DrainableIOBuffer> buffer, int result);
+    void Write(scoped_refptr<net::DrainableIOBuffer> buffer);
+    void DidWrite(scoped_refptr<net::DrainableIOBuffer> buffer, int result);
+    void DidFinishWrite();
+    void FinishWriting();
 
     // Flushes the written content in |writer_|.
-    void Flush(const StatusCallback& callback, bool is_eof);
-    void DidFlush(const StatusCallback& callback, bool is_eof, int result);
+    void Flush(bool is_eof);
+    void DidFlush(bool is_eof, int result);
+
+    void Finish(base::File::Error error);
 
     scoped_ptr<webkit_blob::FileStreamReader> reader_;
     scoped_ptr<FileStreamWriter> writer_;
     const bool need_flush_;
     FileSystemOperation::CopyFileProgressCallback file_progress_callback_;
+    StatusCallback callback_;
     scoped_refptr<net::IOBufferWithSize> io_buffer_;
+    scoped_refptr<net::IOBufferWithSize> spare_io_buffer_;
+    scoped_refptr<net::DrainableIOBuffer> pending_write_;
+    bool read_in_flight_;
+    bool write_in_flight_;
+    bool eof_;
     int64 num_copied_bytes_;
     int64 previous_flush_offset_;
     base::Time last_progress_callback_invocation_time_;